@@ -33,6 +33,8 @@
 #include <openssl/err.h>
 #include <openssl/x509.h>
 
+#include <unistd.h>
+
 #include "server.h"
 #include "settings.h"
 
@@ -90,11 +92,22 @@ bool Master::init() {
 	if ( !Application::init() )
 		return false;
 
+	if ( global.interface.ioBackend == "io_uring" ) {
+		if ( !Wired::DeviceGroup::setDefaultBackend(Wired::DeviceGroup::IOURingBackend) )
+			SEISCOMP_WARNING("io_uring backend is not supported by this build, using native");
+	}
+	else if ( global.interface.ioBackend != "native" ) {
+		SEISCOMP_ERROR("interface.ioBackend: invalid value '%s', expected native or io_uring",
+		               global.interface.ioBackend.c_str());
+		return false;
+	}
+
 	_server = new Broker::Server;
 
 	for ( auto &queue : global.queues ) {
 		auto q_item = _server->addQueue(queue.name,
-		                                queue.maxPayloadSize);
+		                                queue.maxPayloadSize,
+		                                queue.dispatchThreads);
 		if ( !q_item ) {
 			SEISCOMP_ERROR("Failed to add queue: %s", queue.name.c_str());
 			return false;
@@ -107,6 +120,38 @@ bool Master::init() {
 		SEISCOMP_INFO("+ Q %s", queue.name.c_str());
 
 		auto q = q_item->queue;
+		q->setLatencyStatisticsEnabled(queue.latencyStatistics);
+
+		if ( !queue.messageLog.directory.empty() ) {
+			if ( !q->setMessageLog(queue.messageLog.directory,
+			                       static_cast<size_t>(queue.messageLog.segmentSize) * 1024 * 1024,
+			                       queue.messageLog.segments) ) {
+				SEISCOMP_ERROR("Failed to open message log of queue %s: %s",
+				               queue.name.c_str(), queue.messageLog.directory.c_str());
+				return false;
+			}
+
+			SEISCOMP_INFO("  + L %s", queue.messageLog.directory.c_str());
+		}
+
+		if ( queue.clientLimits.maxBytes || queue.clientLimits.maxMessages ) {
+			Broker::Queue::ClientLimits limits;
+			if ( !limits.policy.fromString(queue.clientLimits.policy) ) {
+				SEISCOMP_ERROR("queues.%s.clientLimits.policy: invalid value '%s', "
+				               "expected drop-oldest, disconnect or status-only",
+				               queue.name.c_str(), queue.clientLimits.policy.c_str());
+				return false;
+			}
+
+			limits.maxPendingBytes = static_cast<size_t>(queue.clientLimits.maxBytes) * 1024;
+			limits.maxPendingMessages = queue.clientLimits.maxMessages;
+			q->setClientLimits(limits);
+
+			SEISCOMP_INFO("  + C %s, %u KiB, %u messages",
+			              limits.policy.toString(),
+			              queue.clientLimits.maxBytes,
+			              queue.clientLimits.maxMessages);
+		}
 
 		if ( queue.groups.empty() ) {
 			queue.groups = global.defaultGroups;
@@ -239,6 +284,18 @@ bool Master::run() {
 		              global.interface.ssl.bind.port);
 	}
 
+	if ( !global.interface.local.path.empty() ) {
+		Wired::SocketPtr socket = new Wired::Socket;
+		Broker::WebsocketEndpoint *endpoint = new Broker::WebsocketEndpoint(_server.get(), socket.get(), global.interface.local.acl);
+		if ( !_server->addLocalEndpoint(global.interface.local.path, endpoint) ) {
+			delete endpoint;
+			SEISCOMP_ERROR("Failed to bind to %s", global.interface.local.path.c_str());
+			return false;
+		}
+
+		SEISCOMP_INFO("Bound locally to %s", global.interface.local.path.c_str());
+	}
+
 	if ( !_server->init() ) {
 		SEISCOMP_ERROR("Initialization failed");
 		return false;
@@ -260,6 +317,9 @@ void Master::done() {
 		_server = NULL;
 	}
 
+	if ( !global.interface.local.path.empty() )
+		unlink(global.interface.local.path.c_str());
+
 	Application::done();
 }
 
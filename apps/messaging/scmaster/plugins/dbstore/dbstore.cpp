@@ -79,6 +79,15 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 				                 configPrefix.c_str());
 			}
 
+			if ( _settings.batchSize > 1 ) {
+				// Let the queue pass pending messages in batches which are
+				// written in one transaction
+				setBatchLimits(static_cast<size_t>(_settings.batchSize),
+				               _settings.batchLatency);
+				SEISCOMP_INFO("Writing up to %d messages per transaction",
+				              _settings.batchSize);
+			}
+
 			SEISCOMP_DEBUG("Checking database '%s' and trying to connect", _settings.driver.c_str());
 
 			_db = IO::DatabaseInterface::Create(_settings.driver.c_str());
@@ -139,67 +148,44 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 				return true;
 			}
 
-			// int error = 0;
-			for ( auto it = msg->iter(); *it; ++it ) {
-				auto notifier = DataModel::Notifier::Cast(*it);
-				if ( notifier && notifier->object() ) {
-					bool result = false;
-					while ( !result ) {
-						switch ( notifier->operation() ) {
-							case DataModel::OP_ADD: {
-								++_statistics.addedObjects;
-								DataModel::DatabaseObjectWriter writer(*_dbArchive.get());
-								result = writer(notifier->object(), notifier->parentID());
-							}
-								break;
-							case DataModel::OP_REMOVE:
-								++_statistics.removedObjects;
-								result = _dbArchive->remove(notifier->object(), notifier->parentID());
-								break;
-							case DataModel::OP_UPDATE:
-								++_statistics.updatedObjects;
-								result = _dbArchive->update(notifier->object(), notifier->parentID());
-								break;
-							default:
-								break;
-						}
-
-						if ( !result ) {
-							if ( !_db->isConnected() ) {
-								SEISCOMP_ERROR("Lost connection to database: %s", _settings.write.c_str());
-								while ( !connect() );
-								if ( !_operational ) {
-									SEISCOMP_INFO("Stopping dbstore");
-									break;
-								}
-								else {
-									SEISCOMP_INFO("Reconnected to database: %s", _settings.write.c_str());
-								}
-							}
-							else {
-								SEISCOMP_WARNING(
-									"Error handling message from %s to %s",
-									tmsg->sender.c_str(), tmsg->target.c_str()
-								);
-
-								// If no client connection error occurred -> go ahead because
-								// wrong queries cannot be fixed here
-								++_statistics.errors;
-								result = true;
-							}
-						}
+			if ( !batching() ) {
+				size_t next = 0;
+				while ( !store(msg, tmsg->sender, tmsg->target, next) ) {
+					if ( !reconnect() ) {
+						break;
 					}
 				}
+
+				// For now we return true otherwise the master will stop because
+				// e.g. an erroneous module sends the same notifier twice or more
+				return true;
+			}
+
+			if ( !_transaction ) {
+				beginTransaction();
+			}
+
+			_batch.push_back({msg, tmsg->sender, tmsg->target});
+
+			size_t next = 0;
+			if ( !store(msg, tmsg->sender, tmsg->target, next) ) {
+				replay();
+			}
+
+			if ( _batch.size() >= static_cast<size_t>(_settings.batchSize) ) {
+				commitTransaction();
 			}
 
-			// For now we return true otherwise the master will stop because
-			// e.g. an erroneous module sends the same notifier twice or more
-			//return (error < 0) ? false : true;
 			return true;
 		}
 
+		void flush() override {
+			commitTransaction();
+		}
+
 		bool close() override {
 			if ( _db && _db->isConnected() ) {
+				commitTransaction();
 				_db->disconnect();
 			}
 			_operational = false;
@@ -227,11 +213,215 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 				   << "&dbupdates=" << au
 				   << "&dbdeletes=" << ar
 				   << "&dberrors=" << ae;
+
+				if ( batching() ) {
+					// Average batch size and commit time tell whether the
+					// database keeps up with the queue
+					size_t batches = _statistics.batches;
+					os << "&dbbatches=" << (batches / elapsed)
+					   << "&dbbatchsize=" << (batches ? double(_statistics.batchedMessages) / batches : 0.0)
+					   << "&dbcommittime=" << (batches ? _statistics.commitTime / batches : 0.0)
+					   << "&dbmaxcommittime=" << _statistics.maxCommitTime;
+
+					_statistics.batches =
+					_statistics.batchedMessages = 0;
+					_statistics.commitTime =
+					_statistics.maxCommitTime = 0;
+				}
 			}
 		}
 
 
 	private:
+		enum WriteResult {
+			Stored,
+			Failed,
+			ConnectionLost
+		};
+
+		bool batching() const {
+			return _settings.batchSize > 1;
+		}
+
+		/**
+		 * @brief Writes a single notifier. In batch mode each notifier is
+		 *        enclosed in a savepoint to keep the transaction usable if
+		 *        the notifier cannot be written.
+		 */
+		WriteResult write(DataModel::Notifier *notifier) {
+			if ( _transaction ) {
+				_db->execute("savepoint dbstore");
+			}
+
+			bool result = false;
+
+			switch ( notifier->operation() ) {
+				case DataModel::OP_ADD: {
+					++_statistics.addedObjects;
+					DataModel::DatabaseObjectWriter writer(*_dbArchive.get());
+					result = writer(notifier->object(), notifier->parentID());
+				}
+					break;
+				case DataModel::OP_REMOVE:
+					++_statistics.removedObjects;
+					result = _dbArchive->remove(notifier->object(), notifier->parentID());
+					break;
+				case DataModel::OP_UPDATE:
+					++_statistics.updatedObjects;
+					result = _dbArchive->update(notifier->object(), notifier->parentID());
+					break;
+				default:
+					break;
+			}
+
+			if ( result ) {
+				if ( _transaction ) {
+					_db->execute("release savepoint dbstore");
+				}
+				return Stored;
+			}
+
+			if ( !_db->isConnected() ) {
+				return ConnectionLost;
+			}
+
+			// A transaction which cannot be rolled back to the savepoint
+			// has been lost, e.g. due to a silent reconnect
+			if ( _transaction && !_db->execute("rollback to savepoint dbstore") ) {
+				return ConnectionLost;
+			}
+
+			return Failed;
+		}
+
+		/**
+		 * @brief Writes the notifiers of a message starting at a given index.
+		 * @param next The index of the first notifier to write. If the
+		 *             connection has been lost it is set to the index of
+		 *             the notifier to retry.
+		 * @return false if the connection has been lost, true otherwise
+		 */
+		bool store(Core::Message *msg, const string &sender,
+		           const string &target, size_t &next) {
+			size_t index = 0;
+			for ( auto it = msg->iter(); *it; ++it, ++index ) {
+				if ( index < next ) {
+					continue;
+				}
+
+				auto notifier = DataModel::Notifier::Cast(*it);
+				if ( !notifier || !notifier->object() ) {
+					continue;
+				}
+
+				switch ( write(notifier) ) {
+					case ConnectionLost:
+						SEISCOMP_ERROR("Lost connection to database: %s", _settings.write.c_str());
+						next = index;
+						return false;
+					case Failed:
+						SEISCOMP_WARNING("Error handling message from %s to %s",
+						                 sender.c_str(), target.c_str());
+						// If no client connection error occurred -> go ahead because
+						// wrong queries cannot be fixed here
+						++_statistics.errors;
+						break;
+					default:
+						break;
+				}
+			}
+
+			return true;
+		}
+
+		bool reconnect() {
+			while ( _operational && !connect() );
+
+			if ( !_operational ) {
+				SEISCOMP_INFO("Stopping dbstore");
+				return false;
+			}
+
+			SEISCOMP_INFO("Reconnected to database: %s", _settings.write.c_str());
+			return true;
+		}
+
+		void beginTransaction() {
+			_db->start();
+			_transaction = true;
+		}
+
+		void dropBatch() {
+			if ( !_batch.empty() ) {
+				SEISCOMP_ERROR("Dropped %d messages which have not been written "
+				               "to the database", static_cast<int>(_batch.size()));
+				_statistics.errors += _batch.size();
+			}
+
+			_batch.clear();
+			_transaction = false;
+		}
+
+		/**
+		 * @brief Writes all messages of the current batch again after the
+		 *        connection and thus the open transaction has been lost.
+		 * @return Success flag. On failure the batch is dropped.
+		 */
+		bool replay() {
+			for ( int attempt = 0; attempt < 3; ++attempt ) {
+				_transaction = false;
+				if ( !reconnect() ) {
+					break;
+				}
+
+				beginTransaction();
+
+				bool result = true;
+				for ( auto &item : _batch ) {
+					size_t next = 0;
+					if ( !store(item.msg.get(), item.sender, item.target, next) ) {
+						result = false;
+						break;
+					}
+				}
+
+				if ( result ) {
+					return true;
+				}
+			}
+
+			dropBatch();
+			return false;
+		}
+
+		void commitTransaction() {
+			if ( !_transaction ) {
+				return;
+			}
+
+			Util::StopWatch stopWatch;
+
+			_db->commit();
+			while ( !_db->isConnected() ) {
+				SEISCOMP_ERROR("Lost connection to database while committing: %s",
+				               _settings.write.c_str());
+				if ( !replay() ) {
+					return;
+				}
+
+				_db->commit();
+			}
+
+			double commitTime = (double)stopWatch.elapsed();
+			++_statistics.batches;
+			_statistics.batchedMessages += _batch.size();
+			_statistics.commitTime += commitTime;
+			_statistics.maxCommitTime = max(_statistics.maxCommitTime, commitTime);
+
+			_batch.clear();
+			_transaction = false;
+		}
+
 		bool connect(int retries = 10) {
 			int counter = 0;
 			while ( _operational && !_db->connect(_settings.write.c_str()) ) {
@@ -257,6 +447,9 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 				return false;
 			}
 
+			// In batch mode all writes share the transaction of the batch
+			_dbArchive->setImplicitTransactions(!batching());
+
 			if ( _dbArchive->hasError() ) {
 				return false;
 			}
@@ -293,6 +486,8 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 			string read;
 			bool   proxy{false};
 			bool   strictVersionMatch{true};
+			int    batchSize{1};
+			double batchLatency{0.1};
 
 			void accept(ConfigSettingsLinker &linker) {
 				linker
@@ -300,26 +495,44 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 				& ConfigSettingsLinker::cfg(write, "write")
 				& ConfigSettingsLinker::cfg(read, "read")
 				& ConfigSettingsLinker::cfg(proxy, "proxy")
-				& ConfigSettingsLinker::cfg(strictVersionMatch, "strictVersionMatch");
+				& ConfigSettingsLinker::cfg(strictVersionMatch, "strictVersionMatch")
+				& ConfigSettingsLinker::cfg(batchSize, "batchSize")
+				& ConfigSettingsLinker::cfg(batchLatency, "batchLatency");
 			}
 		};
 
 		struct Statistics {
 			Statistics()
 			: addedObjects(0), updatedObjects(0)
-			, removedObjects(0), errors(0) {}
+			, removedObjects(0), errors(0)
+			, batches(0), batchedMessages(0)
+			, commitTime(0), maxCommitTime(0) {}
 
 			size_t addedObjects;
 			size_t updatedObjects;
 			size_t removedObjects;
 			size_t errors;
+			size_t batches;
+			size_t batchedMessages;
+			double commitTime;
+			double maxCommitTime;
 		};
 
+		struct BatchItem {
+			Core::MessagePtr msg;
+			string           sender;
+			string           target;
+		};
+
+		using Batch = vector<BatchItem>;
+
 		Settings                      _settings;
 		IO::DatabaseInterfacePtr      _db;
 		DataModel::DatabaseArchivePtr _dbArchive;
 		bool                          _operational{false};
 		bool                          _firstMessage{true};
+		bool                          _transaction{false};
+		Batch                         _batch;
 
 		mutable Util::StopWatch       _stopWatch;
 		mutable Statistics            _statistics;
@@ -26,6 +26,7 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/broker/protocol.h>
 #include <seiscomp/broker/queue.h>
+#include <seiscomp/broker/messagedispatcher.h>
 #include <seiscomp/broker/utils/utils.h>
 #include <seiscomp/datamodel/version.h>
 
@@ -68,6 +69,7 @@ enum ErrorCodes {
 	ERR_WS_CMD_UNKNOWN,
 	ERR_NAME_TOO_LONG,
 	ERR_CLIENT_INACTIVITY,
+	ERR_CLIENT_TOO_SLOW,
 	ERR_QUEUE_ERRORS,
 	ERR_QUANTITY
 };
@@ -96,6 +98,7 @@ string ErrorStrings[ERR_QUANTITY + Seiscomp::Messaging::Broker::Queue::Result::Q
 	"400 Unknown command",
 	"407 Clientname exceeds 128 characters",
 	"408 Inactivity",
+	"429 Client too slow",
 	/* Start of queue error strings */
 	"200 QUEUE_OK",
 	"500 Internal queue error",
@@ -122,6 +125,27 @@ const std::string &str(int code) {
 }
 
 
+/**
+ * @brief Grants exclusive access to the queue if the client is served by
+ *        a dispatcher thread. Otherwise the client runs in the thread of
+ *        the queue worker and nothing needs to be locked.
+ */
+class QueueLock {
+	public:
+		QueueLock(Messaging::Broker::ClientDispatcher *dispatcher)
+		: _dispatcher(dispatcher) {
+			if ( _dispatcher ) _dispatcher->lockQueue();
+		}
+
+		~QueueLock() {
+			if ( _dispatcher ) _dispatcher->unlockQueue();
+		}
+
+	private:
+		Messaging::Broker::ClientDispatcher *_dispatcher;
+};
+
+
 struct FrameHeaderName {
 	FrameHeaderName(const char *s) : name(s) {}
 	const char *name;
@@ -226,6 +250,7 @@ namespace Protocols {
 BrokerHandler::~BrokerHandler() {
 	if ( _queue ) {
 		SEISCOMP_DEBUG("%s: disconnect on close", name().c_str());
+		QueueLock lock(_dispatcher);
 		_queue->disconnect(this);
 		_continueWithSeqNo = None;
 	}
@@ -297,7 +322,7 @@ void BrokerHandler::handleFrame(Websocket::Frame &frame) {
 	else if ( !strncmp(content, SCMP_PROTO_CMD_UNSUBSCRIBE, line_length) )
 		commandUNSUBSCRIBE(eol + 1, block_length);
 	else if ( !strncmp(content, SCMP_PROTO_CMD_SEND, line_length) )
-		commandSEND(eol + 1, block_length);
+		commandSEND(eol + 1, block_length, frame.data);
 	else if ( !strncmp(content, SCMP_PROTO_CMD_STATE, line_length) )
 		commandSTATE(eol + 1, block_length, true);
 	else {
@@ -329,7 +354,18 @@ void BrokerHandler::outboxFlushed() {
 		return;
 
 	// If there aren't any more messages, allow real-time
-	msg = _queue->getMessage(*_continueWithSeqNo, this);
+	Broker::MessagePtr copy;
+	{
+		QueueLock lock(_dispatcher);
+		msg = _queue->getMessage(*_continueWithSeqNo, this);
+		// Messages of the queue must not leave the lock if running in a
+		// dispatcher thread, send a private copy instead.
+		if ( msg && _dispatcher ) {
+			copy = msg->clone();
+			msg = copy.get();
+		}
+	}
+
 	if ( msg ) {
 		--_messageBacklog;
 		_continueWithSeqNo = msg->sequenceNumber+1;
@@ -337,7 +373,10 @@ void BrokerHandler::outboxFlushed() {
 	}
 	else {
 		_continueWithSeqNo = Core::None;
+		_messageBacklog = 0;
 	}
+
+	updatePending();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -376,9 +415,17 @@ size_t BrokerHandler::publish(Broker::Client *sender, Broker::Message *msg) {
 	if ( discardSelf() && msg->selfDiscard && this == sender )
 		return 0;
 
+	// Either scheduled for removal or downgraded to state of health
+	if ( _tooSlow )
+		return 0;
+
+	if ( _statusOnly && (msg->type != Broker::Message::Type::Status) )
+		return 0;
+
 	if ( msg->sequenceNumber != INVALID_SEQUENCE_NUMBER ) {
 		if ( _continueWithSeqNo ) {
 			++_messageBacklog;
+			checkLimits(msg);
 			return 0;
 		}
 		else if ( _session->bufferdOutgoingBytes() ) {
@@ -387,11 +434,16 @@ size_t BrokerHandler::publish(Broker::Client *sender, Broker::Message *msg) {
 			// bytes
 			_continueWithSeqNo = msg->sequenceNumber;
 			++_messageBacklog;
+			checkLimits(msg);
 			return 0;
 		}
 	}
+	else if ( checkLimits(msg) )
+		return 0;
 
-	return sendMessage(msg);
+	size_t bytes = sendMessage(msg);
+	updatePending();
+	return bytes;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -506,7 +558,68 @@ void BrokerHandler::ack() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BrokerHandler::dispose() {
-	replyWithError(str(ERR_CLIENT_INACTIVITY));
+	replyWithError(str(_tooSlow ? ERR_CLIENT_TOO_SLOW : ERR_CLIENT_INACTIVITY));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BrokerHandler::checkLimits(Broker::Message *msg) {
+	updatePending();
+
+	const Broker::Queue::ClientLimits &limits = _queue->clientLimits();
+	bool exceeded =
+		(limits.maxPendingBytes && (_pendingBytes > limits.maxPendingBytes)) ||
+		(limits.maxPendingMessages && (_pendingMessages > limits.maxPendingMessages));
+
+	if ( !exceeded )
+		return false;
+
+	switch ( limits.policy ) {
+		case Broker::Queue::DropOldest:
+			if ( msg->sequenceNumber != INVALID_SEQUENCE_NUMBER ) {
+				// Skip the backlog and continue with the current message
+				// once the output buffer has drained
+				if ( _messageBacklog > 1 )
+					_droppedMessages += _messageBacklog - 1;
+				_continueWithSeqNo = msg->sequenceNumber;
+				_messageBacklog = 1;
+			}
+			else
+				++_droppedMessages;
+			updatePending();
+			return true;
+
+		case Broker::Queue::StatusOnly:
+			SEISCOMP_WARNING("%s: output limits exceeded, deliver state of "
+			                 "health messages only", name().c_str());
+			if ( _messageBacklog > 0 )
+				_droppedMessages += _messageBacklog;
+			_statusOnly = true;
+			_continueWithSeqNo = None;
+			_messageBacklog = 0;
+			updatePending();
+			return msg->type != Broker::Message::Type::Status;
+
+		default:
+			SEISCOMP_WARNING("%s: output limits exceeded, disconnect",
+			                 name().c_str());
+			// The queue disposes the client in its next timeout
+			_tooSlow = true;
+			return true;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BrokerHandler::updatePending() {
+	_pendingMessages = _messageBacklog > 0 ? static_cast<size_t>(_messageBacklog) : 0;
+	_pendingBytes = _session->bufferdOutgoingBytes();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -567,10 +680,35 @@ size_t BrokerHandler::sendMessage(Broker::Message *msg) {
 		Websocket::Frame::finalizeBuffer(msg->encodingWebSocket.get(), frameType);
 	}
 
-	_session->send(msg->encodingWebSocket.get());
+	Buffer *frame = msg->encodingWebSocket.get();
+
+	// Compress the frame once per window size and share it among all
+	// clients which negotiated the same
+	Websocket::PerMessageDeflate *deflate = _session->websocketDeflate();
+	if ( deflate && (frame->data.size() >= Websocket::PerMessageDeflate::MinMessageSize) ) {
+		int windowBits = deflate->serverMaxWindowBits();
+		BufferPtr &compressed = msg->encodingWebSocketDeflate[windowBits];
+
+		if ( !compressed ) {
+			BufferPtr tmp = new Buffer;
+			if ( Websocket::PerMessageDeflate::compress(tmp->data, frame->data.data(),
+			                                            frame->data.size(), windowBits) ) {
+				Websocket::Frame::Type frameType =
+					static_cast<Websocket::Frame::Type>(frame->header[0] & 0x0F);
+				Websocket::Frame::finalizeBuffer(tmp.get(), frameType,
+				                                 Websocket::NoStatus, true);
+				compressed = tmp;
+			}
+		}
+
+		if ( compressed )
+			frame = compressed.get();
+	}
+
+	_session->send(frame);
 
-	size_t frameLength = msg->encodingWebSocket->data.size();
-	frameLength += msg->encodingWebSocket->header.size();
+	size_t frameLength = frame->data.size();
+	frameLength += frame->header.size();
 	_bytesSent += frameLength;
 
 	/*
@@ -600,6 +738,7 @@ void BrokerHandler::replyWithError(const char *msg, size_t len) {
 	if ( _queue ) {
 		SEISCOMP_DEBUG("%s: disconnect on error: %s", name().c_str(),
 		               string(msg, msg + len).c_str());
+		QueueLock lock(_dispatcher);
 		_queue->disconnect(this);
 		_continueWithSeqNo = None;
 	}
@@ -776,6 +915,14 @@ void BrokerHandler::commandCONNECT(char *frame, size_t len) {
 			os << availGroups[i];
 		}
 
+		os << "\n"
+		   << SCMP_PROTO_REPLY_CONNECT_HEADER_ENCODINGS ":";
+
+		for ( int i = 0; i < Broker::ContentEncoding::Quantity; ++i ) {
+			if ( i ) os << ",";
+			os << Broker::ContentEncoding(Broker::EContentEncoding(i)).toString();
+		}
+
 		os << "\n";
 
 		size_t i = 0;
@@ -850,7 +997,10 @@ void BrokerHandler::commandDISCONNECT(char *frame, size_t len) {
 	}
 
 	SEISCOMP_DEBUG("%s requests disconnect", name().c_str());
-	_queue->disconnect(this);
+	{
+		QueueLock lock(_dispatcher);
+		_queue->disconnect(this);
+	}
 	_continueWithSeqNo = None;
 
 	BufferPtr resp = new Buffer;
@@ -889,6 +1039,8 @@ void BrokerHandler::commandSUBSCRIBE(char *frame, size_t len) {
 	FrameHeaders headers(frame, len);
 	const char *groupList = nullptr;
 	size_t groupListLen = 0;
+	Broker::SubscriptionFilter filter;
+	bool hasFilter = false;
 
 	while ( headers.next() ) {
 		if ( !headers.name_len ) break;
@@ -902,6 +1054,18 @@ void BrokerHandler::commandSUBSCRIBE(char *frame, size_t len) {
 			groupList = headers.val_start;
 			groupListLen = headers.val_len;
 		}
+		else if ( headers.nameEquals(SCMP_PROTO_CMD_SUBSCRIBE_HEADER_TYPES) ) {
+			Broker::SubscriptionFilter::parseList(filter.types, headers.val_start, headers.val_len);
+			if ( (filter.types.size() == 1) && (filter.types[0] == "*") )
+				filter.types.clear();
+			hasFilter = true;
+		}
+		else if ( headers.nameEquals(SCMP_PROTO_CMD_SUBSCRIBE_HEADER_PARENTS) ) {
+			Broker::SubscriptionFilter::parseList(filter.parentIDs, headers.val_start, headers.val_len);
+			if ( (filter.parentIDs.size() == 1) && (filter.parentIDs[0] == "*") )
+				filter.parentIDs.clear();
+			hasFilter = true;
+		}
 	}
 
 	if ( headers.empty() ) {
@@ -920,7 +1084,17 @@ void BrokerHandler::commandSUBSCRIBE(char *frame, size_t len) {
 		trim(group, group_len);
 		if ( group_len == 0 ) continue;
 		string groupName(group, group_len);
-		Broker::Queue::Result r = _queue->subscribe(this, groupName);
+		Broker::Queue::Result r;
+		{
+			QueueLock lock(_dispatcher);
+			r = _queue->subscribe(this, groupName);
+			// A filter can be updated for an existing subscription
+			if ( hasFilter && (r == Broker::Queue::GroupAlreadySubscribed) )
+				r = Broker::Queue::Success;
+
+			if ( !r && hasFilter )
+				r = _queue->setFilter(this, groupName, filter);
+		}
 		if ( r ) {
 			replyWithError(str(ERR_QUEUE_ERRORS + r));
 			return;
@@ -973,7 +1147,11 @@ void BrokerHandler::commandUNSUBSCRIBE(char *frame, size_t len) {
 		trim(group, group_len);
 		if ( group_len == 0 ) continue;
 		string groupName(group, group_len);
-		Broker::Queue::Result r = _queue->unsubscribe(this, groupName);
+		Broker::Queue::Result r;
+		{
+			QueueLock lock(_dispatcher);
+			r = _queue->unsubscribe(this, groupName);
+		}
 		if ( r ) {
 			replyWithError(str(ERR_QUEUE_ERRORS + r));
 			return;
@@ -986,7 +1164,7 @@ void BrokerHandler::commandUNSUBSCRIBE(char *frame, size_t len) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void BrokerHandler::commandSEND(char *frame, size_t len) {
+void BrokerHandler::commandSEND(char *frame, size_t len, std::string &buffer) {
 	if ( !_queue ) {
 		replyWithError(str(ERR_NOT_CONNECTED));
 		return;
@@ -1083,7 +1261,16 @@ void BrokerHandler::commandSEND(char *frame, size_t len) {
 		return;
 	}
 
-	msg->payload.assign(headers.getptr(), payloadLength);
+	// The payload is the tail of the frame buffer. The buffer is handed
+	// over to the message and the headers are cut off which moves the
+	// payload within the buffer without allocating another one.
+	size_t payloadOffset = static_cast<size_t>(headers.getptr() - buffer.data());
+	if ( payloadOffset + payloadLength == buffer.size() ) {
+		msg->payload.swap(buffer);
+		msg->payload.erase(0, payloadOffset);
+	}
+	else
+		msg->payload.assign(headers.getptr(), payloadLength);
 
 	if ( msg->target.empty() ) {
 		replyWithError(str(ERR_INVALID_FRAME));
@@ -1091,7 +1278,11 @@ void BrokerHandler::commandSEND(char *frame, size_t len) {
 		return;
 	}
 
-	Broker::Queue::Result r = _queue->push(this, msg, len);
+	Broker::Queue::Result r;
+	{
+		QueueLock lock(_dispatcher);
+		r = _queue->push(this, msg, len);
+	}
 	if ( r != Broker::Queue::Success ) {
 		delete msg;
 		replyWithError(str(ERR_QUEUE_ERRORS + r));
@@ -1167,7 +1358,11 @@ void BrokerHandler::commandSTATE(char *frame, size_t len, bool service) {
 
 	msg->payload.assign(headers.getptr(), payloadLength);
 
-	Broker::Queue::Result r = _queue->push(this, msg, len);
+	Broker::Queue::Result r;
+	{
+		QueueLock lock(_dispatcher);
+		r = _queue->push(this, msg, len);
+	}
 	if ( r != Broker::Queue::Success ) {
 		delete msg;
 		replyWithError(str(ERR_QUEUE_ERRORS + r));
@@ -52,6 +52,7 @@ class BrokerHandler : public WebsocketHandler, Broker::Client {
 		void close() override;
 
 		Broker::Queue *queue() const override { return _queue; }
+		Broker::Client *client() override { return this; }
 
 	// ----------------------------------------------------------------------
 	//  Subscriber interface
@@ -73,11 +74,18 @@ class BrokerHandler : public WebsocketHandler, Broker::Client {
 		void commandDISCONNECT(char *frame, size_t len);
 		void commandSUBSCRIBE(char *frame, size_t len);
 		void commandUNSUBSCRIBE(char *frame, size_t len);
-		void commandSEND(char *frame, size_t len);
+		//! The frame buffer owns frame and len. Its memory is handed over
+		//! to the message payload.
+		void commandSEND(char *frame, size_t len, std::string &buffer);
 		void commandSTATE(char *frame, size_t len, bool service);
 
 		size_t sendMessage(Broker::Message *msg);
 
+		//! Updates the pending counters and applies the queue's client
+		//! limits. Returns true if the message must not be sent.
+		bool checkLimits(Broker::Message *msg);
+		void updatePending();
+
 		void replyWithError(const char *msg, size_t len);
 		void replyWithError(const std::string &msg);
 
@@ -85,6 +93,7 @@ class BrokerHandler : public WebsocketHandler, Broker::Client {
 		OPT(Broker::SequenceNumber) _continueWithSeqNo;
 		int                         _bytesSent{0};
 		int                         _messageBacklog{0};
+		bool                        _statusOnly{false};
 		std::string                 _requestQueue;
 };
 
@@ -55,6 +55,7 @@ namespace Protocols {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 WebsocketSession::WebsocketSession(Socket *sock, Broker::Server *server)
 : HttpSession(sock, server) {
+	setWebsocketDeflateEnabled(global.http.websocketCompression);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -121,6 +122,7 @@ void WebsocketSession::upgradeToWebsocket(const char *protocol,
 	Util::encodeBase64(key, sha1, SHA_DIGEST_LENGTH);
 	send(key.data(), key.size());
 	send("\r\n");
+	negotiateWebsocketExtensions();
 	handler->addUpgradeHeader();
 	send("\r\n");
 	flush();
@@ -68,6 +68,7 @@ class WebsocketHandler : public Seiscomp::Core::BaseObject {
 		virtual void close() = 0;
 
 		virtual Broker::Queue *queue() const { return nullptr; }
+		virtual Broker::Client *client() { return nullptr; }
 
 	protected:
 		WebsocketSession *_session;
@@ -119,6 +120,7 @@ class WebsocketSession : public HttpSession {
 		using HttpSession::finishReading;
 
 		Broker::Queue *queue() const { return _handler ? _handler->queue() : nullptr; }
+		Broker::Client *client() const { return _handler ? _handler->client() : nullptr; }
 
 
 	// ----------------------------------------------------------------------
@@ -84,6 +84,51 @@ void Client::setAcknowledgeWindow(SequenceNumber numberOfMessages) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Client::setSubscribed(int groupId, bool subscribed) {
+	size_t word = static_cast<size_t>(groupId) >> 6;
+	uint64_t bit = uint64_t(1) << (groupId & 63);
+
+	if ( subscribed ) {
+		if ( word >= _subscriptions.size() )
+			_subscriptions.resize(word + 1, 0);
+		_subscriptions[word] |= bit;
+	}
+	else if ( word < _subscriptions.size() )
+		_subscriptions[word] &= ~bit;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const SubscriptionFilter *Client::filter(const Group *group) const {
+	for ( auto &&item : _filters ) {
+		if ( item.first == group )
+			return &item.second;
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Client::accepts(const Group *group, Message *msg) const {
+	if ( _filters.empty() )
+		return true;
+
+	const SubscriptionFilter *f = filter(group);
+	return !f || f->accepts(msg);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
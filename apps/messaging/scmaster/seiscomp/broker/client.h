@@ -26,9 +26,13 @@
 
 
 #include <seiscomp/wired/devices/socket.h>
+#include <atomic>
 #include <string>
+#include <vector>
 
+#include <seiscomp/broker/filter.h>
 #include <seiscomp/broker/message.h>
+#include <seiscomp/broker/statistics.h>
 
 
 namespace Seiscomp {
@@ -39,6 +43,7 @@ namespace Broker {
 class Message;
 class Group;
 class Queue;
+class ClientDispatcher;
 
 
 /**
@@ -90,6 +95,31 @@ class SC_BROKER_API Client {
 		 */
 		const Core::Time &created() const;
 
+		/**
+		 * @brief Sets the dispatcher that serves this client in another
+		 *        thread than the queue. The queue forwards all calls
+		 *        to publish, ack and dispose to the dispatcher if set.
+		 *
+		 * This must be called with exclusive access to the queue.
+		 * @param dispatcher The dispatcher instance which is not managed
+		 *                   by the client.
+		 */
+		void setDispatcher(ClientDispatcher *dispatcher);
+		ClientDispatcher *dispatcher() const;
+
+		/**
+		 * @brief Returns the number of messages which are queued for this
+		 *        client but not yet sent. This is maintained by the
+		 *        implementation and can be read from any thread.
+		 */
+		size_t pendingMessages() const { return _pendingMessages; }
+
+		//! Returns the number of bytes buffered for sending to this client.
+		size_t pendingBytes() const { return _pendingBytes; }
+
+		//! Returns the number of messages dropped due to the client limits.
+		size_t droppedMessages() const { return _droppedMessages; }
+
 
 	// ----------------------------------------------------------------------
 	//  Subscriber interface
@@ -114,6 +144,29 @@ class SC_BROKER_API Client {
 		 */
 		void setAcknowledgeWindow(SequenceNumber numberOfMessages);
 
+		/**
+		 * @brief Returns whether the client is subscribed to a group.
+		 * @param groupId The id of the group assigned by the queue
+		 * @return true if subscribed, false otherwise
+		 */
+		bool isSubscribed(int groupId) const;
+
+		/**
+		 * @brief Returns the subscription filter set for a group.
+		 * @param group The group
+		 * @return The filter or nullptr if not filtered
+		 */
+		const SubscriptionFilter *filter(const Group *group) const;
+
+		/**
+		 * @brief Checks whether a message of a group passes the
+		 *        subscription filter of this client.
+		 * @param group The group
+		 * @param msg The message
+		 * @return true if the message should be sent, false otherwise
+		 */
+		bool accepts(const Group *group, Message *msg) const;
+
 		/**
 		 * @brief Returns the IP address connected to the client socket.
 		 *        If the underlying transport does not implement IP socket
@@ -165,27 +218,47 @@ class SC_BROKER_API Client {
 	//  Protected members
 	// ----------------------------------------------------------------------
 	protected:
-		Queue          *_queue{nullptr};
-		Core::Time      _created;
-		Core::Time      _lastSOHReceived;
-		std::string     _name;
-		bool            _wantsMembershipInformation{false};
-		bool            _discardSelf{false};
-		SequenceNumber  _sequenceNumber{0};
-		SequenceNumber  _acknowledgeWindow{20};
-		SequenceNumber  _acknowledgeCounter{20};
-		Core::Time      _ackInitiated;
-		int             _inactivityCounter{0}; // The number of seconds
-		                                       // of inactivity
+		Queue            *_queue{nullptr};
+		ClientDispatcher *_dispatcher{nullptr};
+		Core::Time        _created;
+		Core::Time        _lastSOHReceived;
+		std::string       _name;
+		bool              _wantsMembershipInformation{false};
+		bool              _discardSelf{false};
+		SequenceNumber    _sequenceNumber{0};
+		SequenceNumber    _acknowledgeWindow{20};
+		SequenceNumber    _acknowledgeCounter{20};
+		Core::Time        _ackInitiated;
+		int               _inactivityCounter{0}; // The number of seconds
+		                                         // of inactivity
+		std::atomic<size_t> _pendingMessages{0};
+		std::atomic<size_t> _pendingBytes{0};
+		std::atomic<size_t> _droppedMessages{0};
+		// Set by the implementation if the client exceeded its limits and
+		// shall be disconnected by the queue
+		std::atomic<bool>   _tooSlow{false};
 
 
 	// ----------------------------------------------------------------------
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
+		void setSubscribed(int groupId, bool subscribed);
+
+
+	private:
+		using Filters = std::vector<std::pair<const Group*, SubscriptionFilter>>;
+		using Subscriptions = std::vector<uint64_t>;
+
+		Filters         _filters;
+		// One bit per group id, maintained by Group
+		Subscriptions   _subscriptions;
+		Latency         _latency;
+
 		// Local client heap to additional user data stored by e.g. plugins
 		char            _heap[MaxLocalHeapSize];
 
+	friend class Group;
 	friend class Queue;
 };
 
@@ -198,6 +271,12 @@ inline bool Client::discardSelf() const {
 	return _discardSelf;
 }
 
+inline bool Client::isSubscribed(int groupId) const {
+	size_t word = static_cast<size_t>(groupId) >> 6;
+	return (word < _subscriptions.size())
+	    && (_subscriptions[word] & (uint64_t(1) << (groupId & 63)));
+}
+
 inline void *Client::memory(int offset) {
 	return _heap + offset;
 }
@@ -210,6 +289,14 @@ inline const Core::Time &Client::created() const {
 	return _created;
 }
 
+inline void Client::setDispatcher(ClientDispatcher *dispatcher) {
+	_dispatcher = dispatcher;
+}
+
+inline ClientDispatcher *Client::dispatcher() const {
+	return _dispatcher;
+}
+
 
 }
 }
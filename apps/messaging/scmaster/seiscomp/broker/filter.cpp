@@ -0,0 +1,80 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/broker/filter.h>
+#include <seiscomp/core/strings.h>
+
+#include <algorithm>
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SubscriptionFilter::parseList(std::vector<std::string> &values,
+                                   const char *str, size_t len) {
+	values.clear();
+
+	const char *tok;
+	size_t tokLen;
+	while ( (tok = Core::tokenize2(str, ",", len, tokLen)) ) {
+		Core::trim(tok, tokLen);
+		if ( !tokLen ) continue;
+		values.emplace_back(tok, tokLen);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SubscriptionFilter::accepts(Message *msg) const {
+	if ( empty() )
+		return true;
+
+	if ( !msg->indexContent() )
+		return true;
+
+	for ( auto &&item : msg->content ) {
+		if ( !types.empty() &&
+		     (find(types.begin(), types.end(), item.first) == types.end()) )
+			continue;
+
+		if ( !parentIDs.empty() &&
+		     (find(parentIDs.begin(), parentIDs.end(), item.second) == parentIDs.end()) )
+			continue;
+
+		return true;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
+}
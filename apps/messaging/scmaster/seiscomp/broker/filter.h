@@ -0,0 +1,92 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_BROKER_FILTER_H__
+#define SEISCOMP_BROKER_FILTER_H__
+
+
+#include <seiscomp/broker/api.h>
+#include <seiscomp/broker/message.h>
+
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+/**
+ * @brief The SubscriptionFilter class describes the content a client wants
+ *        to receive from a particular group.
+ *
+ * A notifier message passes the filter if at least one of its notifiers
+ * matches. A notifier matches if its object class name is part of types and
+ * its parent publicID is part of parentIDs. Empty lists match everything.
+ * Messages which do not carry notifiers always pass. Messages are delivered
+ * as they are, matching messages are not reduced to the matching notifiers.
+ */
+class SC_BROKER_API SubscriptionFilter {
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns whether the filter does not restrict anything.
+		bool empty() const;
+
+		/**
+		 * @brief Parses a comma separated list into a list of values.
+		 * @param values The output list which is cleared before
+		 * @param str The input string
+		 * @param len The length of the input string
+		 */
+		static void parseList(std::vector<std::string> &values,
+		                      const char *str, size_t len);
+
+		/**
+		 * @brief Checks whether a message passes the filter. The content
+		 *        of the message is indexed if not done yet.
+		 * @param msg The message
+		 * @return true if the message passes, false otherwise.
+		 */
+		bool accepts(Message *msg) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Public members
+	// ----------------------------------------------------------------------
+	public:
+		std::vector<std::string> types;
+		std::vector<std::string> parentIDs;
+};
+
+
+inline bool SubscriptionFilter::empty() const {
+	return types.empty() && parentIDs.empty();
+}
+
+
+}
+}
+}
+
+
+#endif
@@ -69,6 +69,8 @@ bool Group::addMember(Client *client) {
 
 	if ( ret > 0 ) {
 		SEISCOMP_DEBUG("Add %s to %s", client->name().c_str(), _name.c_str());
+		if ( _id >= 0 )
+			client->setSubscribed(_id, true);
 		return true;
 	}
 
@@ -88,6 +90,8 @@ bool Group::removeMember(Client *client) {
 
 	SEISCOMP_DEBUG("Remove %s from %s", client->name().c_str(), _name.c_str());
 	_members.erase(it);
+	if ( _id >= 0 )
+		client->setSubscribed(_id, false);
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -97,6 +101,8 @@ bool Group::removeMember(Client *client) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Group::hasMember(const Client *client) const {
+	if ( _id >= 0 )
+		return client->isSubscribed(_id);
 	return _members.contains(client);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -104,6 +110,20 @@ bool Group::hasMember(const Client *client) const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Group::clearMembers() {
+	if ( _id >= 0 ) {
+		for ( auto client : _members )
+			client->setSubscribed(_id, false);
+	}
+
+	_members.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
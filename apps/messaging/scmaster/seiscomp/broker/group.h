@@ -49,9 +49,10 @@ DEFINE_SMARTPOINTER(Group);
  *
  * Each group can have members. A member is a client. This class is nothing
  * else than a manager of members in an efficient way. It implements a very
- * fast hashset (KHash) of its members which makes member tests very fast and
- * does not make it necessary to manage additional complicated lookup
- * structures.
+ * fast hashset (KHash) of its members to iterate over them. Once a group
+ * has been added to a queue it receives an integer id and membership is
+ * additionally stored as bit in the subscription set of each client which
+ * makes member tests a single bit test.
  */
 class SC_BROKER_API Group : public Core::BaseObject {
 	// ----------------------------------------------------------------------
@@ -79,6 +80,10 @@ class SC_BROKER_API Group : public Core::BaseObject {
 		//! Returns the name of the group.
 		const std::string &name() const;
 
+		//! Returns the id assigned by the queue or -1 if not yet added
+		//! to a queue.
+		int id() const;
+
 		//! Returns the number of members.
 		size_t memberCount() const;
 
@@ -100,7 +105,7 @@ class SC_BROKER_API Group : public Core::BaseObject {
 		bool hasMember(const Client *client) const;
 
 		//! Removes all members.
-		void clearMembers() { _members.clear(); }
+		void clearMembers();
 
 		const Members &members() const;
 
@@ -110,10 +115,13 @@ class SC_BROKER_API Group : public Core::BaseObject {
 	// ----------------------------------------------------------------------
 	private:
 		std::string _name;
+		int         _id{-1};
 		Members     _members;
+		size_t      _filteredMembers{0};
 		mutable Tx  _txMessages;
 		mutable Tx  _txBytes;
 		mutable Tx  _txPayload;
+		Latency     _latency;
 
 
 	friend class Queue;
@@ -124,6 +132,10 @@ inline const std::string &Group::name() const {
 	return _name;
 }
 
+inline int Group::id() const {
+	return _id;
+}
+
 inline const Group::Members &Group::members() const {
 	return _members;
 }
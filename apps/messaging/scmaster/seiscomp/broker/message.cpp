@@ -29,6 +29,8 @@
 #include <seiscomp/io/archive/jsonarchive.h>
 #include <seiscomp/io/archive/bsonarchive.h>
 #include <seiscomp/io/streams/filter/lz4.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/messaging/protocol.h>
 
 #include <boost/iostreams/stream.hpp>
 #include <boost/iostreams/categories.hpp>
@@ -37,6 +39,7 @@
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <algorithm>
 #include <iostream>
 
 #include "message.h"
@@ -58,6 +61,14 @@ namespace Broker {
 namespace {
 
 
+const ext::boost::iostreams::lz4_dictionary &messageDictionary() {
+	static const ext::boost::iostreams::lz4_dictionary dict(
+		Client::Protocol::CompressionDictionary(), 1
+	);
+	return dict;
+}
+
+
 class ImportXMLArchive : public IO::XMLArchive {
 	public:
 		ImportXMLArchive(std::streambuf* buf, bool isReading = true,
@@ -91,6 +102,9 @@ inline Core::Version parse(Core::BaseObjectPtr &obj, const string &blob,
 		case LZ4:
 			filtered_buf.push(ext::boost::iostreams::lz4_decompressor());
 			break;
+		case LZ4Dictionary:
+			filtered_buf.push(ext::boost::iostreams::lz4_decompressor(128, &messageDictionary()));
+			break;
 		default:
 			throw runtime_error("Invalid encoding type");
 	}
@@ -126,6 +140,9 @@ inline bool write(std::string &blob, const Core::BaseObject *obj,
 		case LZ4:
 			filtered_buf.push(ext::boost::iostreams::lz4_compressor());
 			break;
+		case LZ4Dictionary:
+			filtered_buf.push(ext::boost::iostreams::lz4_compressor(128, &messageDictionary()));
+			break;
 		default:
 			return false;
 	}
@@ -150,6 +167,8 @@ Message::Message()
 : type(Type::Unspecified)
 , selfDiscard(true)
 , processed(false)
+, contentIndexed(false)
+, hasNotifiers(false)
 , sequenceNumber(INVALID_SEQUENCE_NUMBER)
 , _internalGroupPtr(NULL)
 {}
@@ -255,6 +274,73 @@ bool Message::encode() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Message *Message::clone() const {
+	Message *msg = new Message;
+	msg->sender = sender;
+	msg->target = target;
+	msg->encoding = encoding;
+	msg->mimeType = mimeType;
+	msg->payload = payload;
+	msg->schemaVersion = schemaVersion;
+	msg->timestamp = timestamp;
+	msg->received = received;
+	msg->type = type;
+	msg->selfDiscard = selfDiscard;
+	msg->processed = processed;
+	msg->sequenceNumber = sequenceNumber;
+	msg->content = content;
+	msg->contentIndexed = contentIndexed;
+	msg->hasNotifiers = hasNotifiers;
+	msg->_internalGroupPtr = _internalGroupPtr;
+
+	if ( encodingWebSocket ) {
+		msg->encodingWebSocket = new Wired::Buffer;
+		msg->encodingWebSocket->header = encodingWebSocket->header;
+		msg->encodingWebSocket->data = encodingWebSocket->data;
+	}
+
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Message::indexContent() {
+	if ( contentIndexed )
+		return hasNotifiers;
+
+	contentIndexed = true;
+
+	bool wasDecoded = object.get() != nullptr;
+	if ( !decode() )
+		return false;
+
+	auto nmsg = DataModel::NotifierMessage::Cast(object);
+	if ( nmsg ) {
+		hasNotifiers = true;
+
+		for ( auto &&n : *nmsg ) {
+			if ( !n->object() ) continue;
+
+			auto item = make_pair(string(n->object()->className()), n->parentID());
+			if ( find(content.begin(), content.end(), item) == content.end() )
+				content.push_back(std::move(item));
+		}
+	}
+
+	if ( !wasDecoded )
+		object = nullptr;
+
+	return hasNotifiers;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
@@ -25,7 +25,11 @@
 #define GEMPA_BROKER_MESSAGE_H__
 
 
+#include <chrono>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 #include <stdint.h>
 
 #include <seiscomp/core/enumeration.h>
@@ -52,13 +56,15 @@ MAKEENUM(
 		Identity,
 		Deflate,
 		GZip,
-		LZ4
+		LZ4,
+		LZ4Dictionary
 	),
 	ENAMES(
 		"identity",
 		"deflate",
 		"gzip",
-		"lz4"
+		"lz4",
+		"lz4-dict"
 	)
 );
 
@@ -122,6 +128,28 @@ class SC_BROKER_API Message : public Seiscomp::Core::BaseObject {
 		 */
 		bool encode();
 
+		/**
+		 * @brief Creates a copy of the message which does not share any
+		 *        reference counted members with this instance.
+		 *
+		 * The decoded object is not copied and a cached websocket encoding
+		 * is copied deeply. Compressed websocket encodings are not copied. The copy can be handed over to another thread
+		 * without synchronising the reference counts of shared objects.
+		 * @return The copy which is not managed by a smart pointer
+		 */
+		Message *clone() const;
+
+		/**
+		 * @brief Collects the class names and parent publicIDs of all
+		 *        notifiers of the payload into content. This is done only
+		 *        once, further calls return immediately.
+		 *
+		 * If the message has not been decoded before then the decoded
+		 * object is released afterwards to not keep it in memory.
+		 * @return true if the payload is a notifier message, false otherwise.
+		 */
+		bool indexContent();
+
 
 	// ----------------------------------------------------------------------
 	//  Members
@@ -142,16 +170,28 @@ class SC_BROKER_API Message : public Seiscomp::Core::BaseObject {
 		Core::BaseObjectPtr           object;      //!< The decoded object
 		Core::Version                 schemaVersion; //!< The schema version of the payload after decoding
 		Seiscomp::Core::Time          timestamp;   //!< The received time
+		/** Monotonic receipt time, only set if latency statistics are enabled */
+		std::chrono::steady_clock::time_point received;
 		Type                          type; //!< The message type
 		bool                          selfDiscard; //!< Whether self discard should be checked or not
 		bool                          processed;
 		/** The assigned sequence number */
 		SequenceNumber                sequenceNumber;
 
+		/** Pairs of class name and parent publicID, see indexContent */
+		std::vector<std::pair<std::string, std::string>> content;
+		bool                          contentIndexed; //!< Whether content is valid
+		bool                          hasNotifiers; //!< Whether the payload is a notifier message
+
 		/** Cached encoded version for different protocols */
 		Wired::BufferPtr              encodingWebSocket;
+		/** Cached permessage-deflate encodings of encodingWebSocket by
+		    server window bits. Without context takeover the compressed
+		    frame only depends on the window size and is shared by all
+		    clients which negotiated the same one. */
+		std::map<int, Wired::BufferPtr> encodingWebSocketDeflate;
 
-		/** Cache of the target group */
+		/** The target group, resolved once when the message is pushed */
 		Group                         *_internalGroupPtr;
 };
 
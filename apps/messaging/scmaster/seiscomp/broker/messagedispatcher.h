@@ -86,6 +86,70 @@ class SC_BROKER_API MessageDispatcher {
 };
 
 
+/**
+ * @brief The ClientDispatcher class forwards messages to clients which are
+ *        served by another thread than the queue.
+ *
+ * If a client has a dispatcher assigned then the queue does not call
+ * Client::publish, Client::ack or Client::dispose directly. It hands the
+ * request over to the dispatcher which executes it in the thread the client
+ * lives in. Requests are delivered in the order they have been issued which
+ * preserves the message order per group and client.
+ *
+ * All calls of the dispatcher interface are issued while the caller holds
+ * exclusive access to the queue.
+ */
+class SC_BROKER_API ClientDispatcher {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! C'tor
+		ClientDispatcher() {}
+
+		//! D'tor
+		virtual ~ClientDispatcher() {}
+
+
+	// ----------------------------------------------------------------------
+	//  Dispatcher interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Schedules a message for a set of clients.
+		 * @param msg The message which is not shared with any other thread
+		 *            and which is managed by the dispatcher from now on.
+		 *            It is a copy created with Message::clone().
+		 * @param clients The list of receiving clients
+		 * @param count The number of clients in the list
+		 */
+		virtual void publish(Message *msg, Client *const *clients, size_t count) = 0;
+
+		//! Schedules an acknowledgement to be sent to the client
+		virtual void ack(Client *client) = 0;
+
+		//! Schedules the disposal of client resources
+		virtual void dispose(Client *client) = 0;
+
+		/**
+		 * @brief Removes all pending requests of a client. This is called
+		 *        when the client disconnects from the queue.
+		 * @param client The client
+		 */
+		virtual void remove(Client *client) = 0;
+
+		/**
+		 * @brief Acquires exclusive access to the queue. Clients served by
+		 *        the dispatcher must call this before they access the
+		 *        queue, e.g. to push messages or to subscribe to groups.
+		 */
+		virtual void lockQueue() = 0;
+
+		//! Releases the lock acquired with lockQueue().
+		virtual void unlockQueue() = 0;
+};
+
+
 }
 }
 }
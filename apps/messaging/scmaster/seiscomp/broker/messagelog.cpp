@@ -0,0 +1,524 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT MASTER
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/system.h>
+#include <seiscomp/utils/files.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "messagelog.h"
+
+
+namespace fs = boost::filesystem;
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+namespace {
+
+
+/*
+ * Record layout:
+ *  uint32 record size including this header, written last
+ *  uint64 sequence number
+ *  int64  timestamp seconds
+ *  int32  timestamp microseconds
+ *  uint16 sender length
+ *  uint16 target length
+ *  uint16 encoding length
+ *  uint16 mime type length
+ *  uint32 payload length
+ *  followed by sender, target, encoding, mime type and payload
+ */
+const size_t RecordHeaderSize = 36;
+const char *SegmentExtension = ".seg";
+
+
+template <typename T>
+inline T get(const char *data) {
+	T v;
+	memcpy(&v, data, sizeof(T));
+	return v;
+}
+
+
+template <typename T>
+inline void put(char *data, T v) {
+	memcpy(data, &v, sizeof(T));
+}
+
+
+std::string segmentPath(const std::string &directory, SequenceNumber first) {
+	char name[32];
+	snprintf(name, sizeof(name), "%020llu",
+	         static_cast<unsigned long long>(first));
+	return directory + "/" + name + SegmentExtension;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MessageLog::MessageLog()
+: _segmentSize(0)
+, _maxSegments(0) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MessageLog::~MessageLog() {
+	close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MessageLog::open(const std::string &directory, size_t segmentSize,
+                      size_t maxSegments) {
+	close();
+
+	if ( directory.empty() || segmentSize <= RecordHeaderSize || !maxSegments )
+		return false;
+
+	if ( !Util::pathExists(directory) && !Util::createPath(directory) ) {
+		SEISCOMP_ERROR("Message log: unable to create %s", directory.c_str());
+		return false;
+	}
+
+	std::vector<SequenceNumber> firsts;
+
+	try {
+		fs::directory_iterator it = fs::directory_iterator(SC_FS_PATH(directory));
+		fs::directory_iterator fsDirEnd;
+
+		for ( ; it != fsDirEnd; ++it ) {
+			std::string filename = SC_FS_IT_LEAF(it);
+			size_t extPos = filename.size() - strlen(SegmentExtension);
+			if ( (filename.size() <= strlen(SegmentExtension))
+			  || filename.compare(extPos, std::string::npos, SegmentExtension) )
+				continue;
+
+			SequenceNumber first;
+			if ( !Core::fromString(first, filename.substr(0, extPos)) )
+				continue;
+
+			firsts.push_back(first);
+		}
+	}
+	catch ( std::exception &e ) {
+		SEISCOMP_ERROR("Message log: %s", e.what());
+		return false;
+	}
+
+	std::sort(firsts.begin(), firsts.end());
+
+	_directory = directory;
+	_segmentSize = segmentSize;
+	_maxSegments = maxSegments;
+
+	for ( auto first : firsts ) {
+		Segment segment;
+		segment.first = first;
+		segment.path = segmentPath(_directory, first);
+
+		if ( !mapSegment(segment, false) ) {
+			SEISCOMP_WARNING("Message log: unable to read %s, removing it",
+			                 segment.path.c_str());
+			unlink(segment.path.c_str());
+			continue;
+		}
+
+		scanSegment(segment);
+
+		// Only consecutive segments are kept
+		if ( !_segments.empty() && (first != lastSequenceNumber() + 1) )
+			clear();
+
+		if ( segment.offsets.empty() ) {
+			unmapSegment(segment);
+			unlink(segment.path.c_str());
+			continue;
+		}
+
+		_segments.push_back(segment);
+	}
+
+	while ( _segments.size() > _maxSegments )
+		removeOldestSegment();
+
+	if ( !empty() ) {
+		SEISCOMP_INFO("Message log: restored sequence numbers %llu - %llu from %s",
+		              static_cast<unsigned long long>(firstSequenceNumber()),
+		              static_cast<unsigned long long>(lastSequenceNumber()),
+		              _directory.c_str());
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MessageLog::close() {
+	for ( auto &segment : _segments )
+		unmapSegment(segment);
+
+	_segments.clear();
+	_directory = std::string();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MessageLog::append(const Message *msg) {
+	if ( !isOpen() ) return false;
+
+	if ( (msg->sender.size() > 0xffff) || (msg->target.size() > 0xffff)
+	  || (msg->encoding.size() > 0xffff) || (msg->mimeType.size() > 0xffff) )
+		return false;
+
+	size_t recordSize = RecordHeaderSize
+	                  + msg->sender.size() + msg->target.size()
+	                  + msg->encoding.size() + msg->mimeType.size()
+	                  + msg->payload.size();
+
+	if ( recordSize > _segmentSize ) {
+		SEISCOMP_WARNING("Message log: message #%llu with %zu bytes exceeds "
+		                 "the segment size", static_cast<unsigned long long>(msg->sequenceNumber),
+		                 recordSize);
+		// A gap in the log is not allowed
+		clear();
+		return false;
+	}
+
+	if ( !empty() && (msg->sequenceNumber != lastSequenceNumber() + 1) ) {
+		SEISCOMP_DEBUG("Message log: sequence number does not continue the log, "
+		               "clearing it");
+		clear();
+	}
+
+	if ( _segments.empty()
+	  || (_segments.back().used + recordSize > _segments.back().size) ) {
+		if ( !addSegment(msg->sequenceNumber) )
+			return false;
+	}
+
+	Segment &segment = _segments.back();
+	char *data = segment.data + segment.used;
+	char *p = data + RecordHeaderSize;
+
+	put<uint64_t>(data + 4, msg->sequenceNumber);
+	put<int64_t>(data + 12, msg->timestamp.seconds());
+	put<int32_t>(data + 20, static_cast<int32_t>(msg->timestamp.microseconds()));
+	put<uint16_t>(data + 24, static_cast<uint16_t>(msg->sender.size()));
+	put<uint16_t>(data + 26, static_cast<uint16_t>(msg->target.size()));
+	put<uint16_t>(data + 28, static_cast<uint16_t>(msg->encoding.size()));
+	put<uint16_t>(data + 30, static_cast<uint16_t>(msg->mimeType.size()));
+	put<uint32_t>(data + 32, static_cast<uint32_t>(msg->payload.size()));
+
+	memcpy(p, msg->sender.data(), msg->sender.size()); p += msg->sender.size();
+	memcpy(p, msg->target.data(), msg->target.size()); p += msg->target.size();
+	memcpy(p, msg->encoding.data(), msg->encoding.size()); p += msg->encoding.size();
+	memcpy(p, msg->mimeType.data(), msg->mimeType.size()); p += msg->mimeType.size();
+	memcpy(p, msg->payload.data(), msg->payload.size());
+
+	// The size marks the record as complete
+	put<uint32_t>(data, static_cast<uint32_t>(recordSize));
+
+	segment.offsets.push_back(static_cast<uint32_t>(segment.used));
+	segment.used += recordSize;
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MessageLog::empty() const {
+	return _segments.empty() || _segments.back().offsets.empty();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SequenceNumber MessageLog::firstSequenceNumber() const {
+	return _segments.front().first;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SequenceNumber MessageLog::lastSequenceNumber() const {
+	return _segments.back().first + _segments.back().offsets.size() - 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MessageLog::read(SequenceNumber sequenceNumber, Record &record) const {
+	if ( empty() ) return false;
+	if ( (sequenceNumber < firstSequenceNumber())
+	  || (sequenceNumber > lastSequenceNumber()) )
+		return false;
+
+	// Find the last segment starting before or with the sequence number
+	auto it = std::upper_bound(
+		_segments.begin(), _segments.end(), sequenceNumber,
+		[](SequenceNumber seqNo, const Segment &segment) {
+			return seqNo < segment.first;
+		}
+	);
+
+	if ( it == _segments.begin() ) return false;
+	--it;
+
+	SequenceNumber idx = sequenceNumber - it->first;
+	if ( idx >= it->offsets.size() ) return false;
+
+	const char *data = it->data + it->offsets[idx];
+	const char *p = data + RecordHeaderSize;
+
+	record.sequenceNumber = get<uint64_t>(data + 4);
+	record.timestamp = Core::Time(static_cast<long>(get<int64_t>(data + 12)),
+	                              static_cast<long>(get<int32_t>(data + 20)));
+	record.senderLength = get<uint16_t>(data + 24);
+	record.targetLength = get<uint16_t>(data + 26);
+	record.encodingLength = get<uint16_t>(data + 28);
+	record.mimeTypeLength = get<uint16_t>(data + 30);
+	record.payloadLength = get<uint32_t>(data + 32);
+
+	record.sender = p; p += record.senderLength;
+	record.target = p; p += record.targetLength;
+	record.encoding = p; p += record.encodingLength;
+	record.mimeType = p; p += record.mimeTypeLength;
+	record.payload = p;
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Message *MessageLog::createMessage(const Record &record) {
+	Message *msg = new Message;
+	msg->sender.assign(record.sender, record.senderLength);
+	msg->target.assign(record.target, record.targetLength);
+	msg->encoding.assign(record.encoding, record.encodingLength);
+	msg->mimeType.assign(record.mimeType, record.mimeTypeLength);
+	msg->payload.assign(record.payload, record.payloadLength);
+	msg->timestamp = record.timestamp;
+	msg->type = Message::Type::Regular;
+	msg->processed = true;
+	msg->sequenceNumber = record.sequenceNumber;
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MessageLog::mapSegment(Segment &segment, bool create) {
+	int fd = ::open(segment.path.c_str(), O_RDWR | (create ? O_CREAT | O_TRUNC : 0), 0644);
+	if ( fd < 0 ) {
+		SEISCOMP_ERROR("Message log: %s: %s", segment.path.c_str(), strerror(errno));
+		return false;
+	}
+
+	if ( create ) {
+		if ( ftruncate(fd, static_cast<off_t>(_segmentSize)) != 0 ) {
+			SEISCOMP_ERROR("Message log: %s: %s", segment.path.c_str(), strerror(errno));
+			::close(fd);
+			return false;
+		}
+
+		segment.size = _segmentSize;
+	}
+	else {
+		struct stat st;
+		if ( (fstat(fd, &st) != 0) || (st.st_size <= 0) ) {
+			::close(fd);
+			return false;
+		}
+
+		segment.size = static_cast<size_t>(st.st_size);
+	}
+
+	void *data = mmap(nullptr, segment.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	// The mapping keeps the file referenced
+	::close(fd);
+
+	if ( data == MAP_FAILED ) {
+		SEISCOMP_ERROR("Message log: mmap %s: %s", segment.path.c_str(), strerror(errno));
+		segment.size = 0;
+		return false;
+	}
+
+	segment.data = static_cast<char*>(data);
+	segment.used = 0;
+	segment.offsets.clear();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MessageLog::scanSegment(Segment &segment) {
+	size_t offset = 0;
+
+	while ( offset + RecordHeaderSize <= segment.size ) {
+		const char *data = segment.data + offset;
+		size_t recordSize = get<uint32_t>(data);
+
+		// An incomplete or unused record terminates the segment
+		if ( (recordSize < RecordHeaderSize) || (offset + recordSize > segment.size) )
+			break;
+
+		if ( get<uint64_t>(data + 4) != segment.first + segment.offsets.size() )
+			break;
+
+		size_t contentSize = RecordHeaderSize
+		                   + get<uint16_t>(data + 24) + get<uint16_t>(data + 26)
+		                   + get<uint16_t>(data + 28) + get<uint16_t>(data + 30)
+		                   + get<uint32_t>(data + 32);
+		if ( contentSize != recordSize )
+			break;
+
+		segment.offsets.push_back(static_cast<uint32_t>(offset));
+		offset += recordSize;
+	}
+
+	segment.used = offset;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MessageLog::unmapSegment(Segment &segment) {
+	if ( segment.data ) {
+		msync(segment.data, segment.size, MS_ASYNC);
+		munmap(segment.data, segment.size);
+		segment.data = nullptr;
+	}
+
+	segment.size = segment.used = 0;
+	segment.offsets.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MessageLog::addSegment(SequenceNumber first) {
+	// Let the kernel write back the completed segment
+	if ( !_segments.empty() )
+		msync(_segments.back().data, _segments.back().size, MS_ASYNC);
+
+	Segment segment;
+	segment.first = first;
+	segment.path = segmentPath(_directory, first);
+
+	if ( !mapSegment(segment, true) )
+		return false;
+
+	_segments.push_back(segment);
+
+	while ( _segments.size() > _maxSegments )
+		removeOldestSegment();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MessageLog::removeOldestSegment() {
+	Segment &segment = _segments.front();
+	unmapSegment(segment);
+	unlink(segment.path.c_str());
+	_segments.pop_front();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MessageLog::clear() {
+	while ( !_segments.empty() )
+		removeOldestSegment();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
+}
@@ -0,0 +1,178 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_BROKER_MESSAGELOG_H__
+#define SEISCOMP_BROKER_MESSAGELOG_H__
+
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/broker/api.h>
+#include <seiscomp/broker/message.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+/**
+ * @brief The MessageLog class implements an append-only log of published
+ *        messages on disk.
+ *
+ * The log consists of segment files of fixed size which are memory mapped.
+ * Each segment holds records of consecutive sequence numbers and is named
+ * after its first sequence number. If the number of segments exceeds the
+ * configured limit then the oldest segment is removed. Opening an existing
+ * directory restores the index of all valid records so that the sequence
+ * numbers continue after a restart.
+ *
+ * Records are written in host byte order, the log is not meant to be
+ * exchanged between hosts.
+ */
+class SC_BROKER_API MessageLog {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! A record view into the mapped segment. The pointers are valid
+		//! until the next call to append or close.
+		struct Record {
+			SequenceNumber  sequenceNumber;
+			Core::Time      timestamp;
+			const char     *sender;
+			size_t          senderLength;
+			const char     *target;
+			size_t          targetLength;
+			const char     *encoding;
+			size_t          encodingLength;
+			const char     *mimeType;
+			size_t          mimeTypeLength;
+			const char     *payload;
+			size_t          payloadLength;
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		MessageLog();
+		~MessageLog();
+
+		MessageLog(const MessageLog &) = delete;
+		MessageLog &operator=(const MessageLog &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Opens a log directory and reads all existing segments.
+		 * @param directory The directory which is created if it does not
+		 *                  exist.
+		 * @param segmentSize The size of a segment file in bytes
+		 * @param maxSegments The maximum number of segments to keep
+		 * @return Success flag
+		 */
+		bool open(const std::string &directory, size_t segmentSize,
+		          size_t maxSegments);
+
+		//! Unmaps and closes all segments.
+		void close();
+
+		bool isOpen() const { return !_directory.empty(); }
+
+		/**
+		 * @brief Appends a regular message to the log. If the sequence
+		 *        number does not follow the last logged sequence number
+		 *        then the log is cleared before.
+		 * @param msg The message
+		 * @return Success flag
+		 */
+		bool append(const Message *msg);
+
+		//! Returns whether the log does not contain any record.
+		bool empty() const;
+
+		//! The first logged sequence number, only valid if not empty.
+		SequenceNumber firstSequenceNumber() const;
+
+		//! The last logged sequence number, only valid if not empty.
+		SequenceNumber lastSequenceNumber() const;
+
+		/**
+		 * @brief Reads a particular record.
+		 * @param sequenceNumber The sequence number of the record
+		 * @param record The output record
+		 * @return false if the sequence number is not part of the log
+		 */
+		bool read(SequenceNumber sequenceNumber, Record &record) const;
+
+		/**
+		 * @brief Creates a new message from a record.
+		 * @param record The record
+		 * @return The message which is not managed by a smart pointer
+		 */
+		static Message *createMessage(const Record &record);
+
+
+	// ----------------------------------------------------------------------
+	//  Private interface
+	// ----------------------------------------------------------------------
+	private:
+		struct Segment {
+			SequenceNumber        first{0};
+			std::string           path;
+			char                 *data{nullptr};
+			size_t                size{0};
+			size_t                used{0};
+			std::vector<uint32_t> offsets;
+		};
+
+		bool mapSegment(Segment &segment, bool create);
+		void scanSegment(Segment &segment);
+		void unmapSegment(Segment &segment);
+		bool addSegment(SequenceNumber first);
+		void removeOldestSegment();
+		void clear();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		std::string         _directory;
+		size_t              _segmentSize;
+		size_t              _maxSegments;
+		std::deque<Segment> _segments;
+};
+
+
+}
+}
+}
+
+
+#endif
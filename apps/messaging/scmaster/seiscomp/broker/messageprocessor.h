@@ -95,6 +95,15 @@ class SC_BROKER_API MessageProcessor : public Processor {
 
 		virtual bool process(Message *msg) = 0;
 
+		/**
+		 * @brief Called after a batch of messages has been passed to
+		 *        process() and before those messages are forwarded to
+		 *        clients. Processors which group work across messages,
+		 *        e.g. into a single database transaction, must complete it
+		 *        here. The default implementation does nothing.
+		 */
+		virtual void flush();
+
 
 	// ----------------------------------------------------------------------
 	//  Public interface
@@ -114,6 +123,21 @@ class SC_BROKER_API MessageProcessor : public Processor {
 		 */
 		bool isConnectionProcessingEnabled() const { return _mode & Connections; }
 
+		/**
+		 * @brief Returns the maximum number of messages the processor
+		 *        wants to receive before flush() is called.
+		 * @return The number of messages, 1 disables batching
+		 */
+		size_t maxBatchSize() const { return _maxBatchSize; }
+
+		/**
+		 * @brief Returns the maximum time in seconds a batch collects
+		 *        messages before flush() is called and the messages are
+		 *        forwarded.
+		 * @return The latency in seconds
+		 */
+		double maxBatchLatency() const { return _maxBatchLatency; }
+
 
 	// ----------------------------------------------------------------------
 	//  Protected methods
@@ -121,12 +145,23 @@ class SC_BROKER_API MessageProcessor : public Processor {
 	protected:
 		void setMode(int mode);
 
+		/**
+		 * @brief Requests that the queue passes pending messages in
+		 *        batches of at most maxSize messages to process() and
+		 *        calls flush() after each batch.
+		 * @param maxSize The maximum number of messages per batch
+		 * @param maxLatency The maximum time in seconds to collect a batch
+		 */
+		void setBatchLimits(size_t maxSize, double maxLatency);
+
 
 	// ----------------------------------------------------------------------
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
-		int _mode;
+		int    _mode;
+		size_t _maxBatchSize;
+		double _maxBatchLatency;
 };
 
 
@@ -96,14 +96,24 @@ namespace Protocol {
  * ```
  * SUBSCRIBE
  * Groups: [list of groups]
+ * Types: [list of class names, optional]
+ * Parents: [list of parent publicIDs, optional]
  *
  * ^@
  * ```
  * Subscribes to a specific group which must exist on the server. In response
  * either an **ENTER** or **ERROR** frame will be received.
+ *
+ * If Types or Parents are given then only notifier messages with at least
+ * one notifier matching the object class name and the parent publicID are
+ * delivered from those groups. A list of "*" matches everything. If a group
+ * is already subscribed then only its filter is updated and no response is
+ * sent.
  */
 #define SCMP_PROTO_CMD_SUBSCRIBE      "SUBSCRIBE"
 #define SCMP_PROTO_CMD_SUBSCRIBE_HEADER_GROUPS        "Groups"
+#define SCMP_PROTO_CMD_SUBSCRIBE_HEADER_TYPES         "Types"
+#define SCMP_PROTO_CMD_SUBSCRIBE_HEADER_PARENTS       "Parents"
 
 /**
  * ```
@@ -177,13 +187,15 @@ namespace Protocol {
  *                 [32 byte hex NaCL public server key]
  *                 [16 byte hex encrypted buffer: "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00"]
  * Groups: [list of available groups]
+ * Encodings: [list of supported content encodings]
  *
  * ^@
  * ```
  *
  * In return to a **CONNECT** frame the server responds with a **CONNECTED**
- * frame. It reports the client name in use for this connection and a list of
- * available groups.
+ * frame. It reports the client name in use for this connection, a list of
+ * available groups and the content encodings the server is able to decode.
+ * Encodings which are not listed should not be used for sending.
  */
 #define SCMP_PROTO_REPLY_CONNECT      "CONNECTED"
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_VERSION        "Version"
@@ -192,6 +204,7 @@ namespace Protocol {
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_CLIENT_NAME    SCMP_PROTO_CMD_CONNECT_HEADER_CLIENT_NAME
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_ACK_WINDOW     SCMP_PROTO_CMD_CONNECT_HEADER_ACK_WINDOW
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_GROUPS         "Groups"
+#define SCMP_PROTO_REPLY_CONNECT_HEADER_ENCODINGS      "Encodings"
 
 /**
  * The probably most important part of the protocol is receiving a message from
@@ -42,6 +42,7 @@
 #include <boost/iostreams/device/back_inserter.hpp>
 
 #include <stdio.h>
+#include <chrono>
 #include <iomanip>
 
 
@@ -61,6 +62,12 @@ namespace {
 
 System::HostInfo HostInfo;
 
+
+//! Returns the elapsed time since a point in time in microseconds
+inline double microseconds(const chrono::steady_clock::time_point &since) {
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - since).count();
+}
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -73,6 +80,8 @@ Queue::Queue(const std::string &name, uint64_t maxPayloadSize)
 , _processedMessageDispatcher(nullptr)
 , _sequenceNumber(0)
 , _messageProcessor(nullptr)
+, _maxBatchSize(1)
+, _maxBatchLatency(0)
 , _allocatedClientHeap(0)
 , _sohInterval(12)
 , _inactivityLimit(36)
@@ -137,7 +146,12 @@ Queue::Result Queue::addGroup(const std::string &name) {
 	if ( _groups.find(name) != _groups.end() )
 		return GroupNameNotUnique;
 
-	_groups[name] = new Group(name.c_str());
+	GroupPtr group = new Group(name.c_str());
+	// Groups are never removed, the id is the index in the order of
+	// creation and addresses the subscription bit of each client
+	group->_id = static_cast<int>(_groupNames.size());
+	_groups[name] = group;
+	_groupIndex.insert(group->name().c_str(), group.get());
 	_groupNames.push_back(name);
 	return Success;
 }
@@ -146,6 +160,16 @@ Queue::Result Queue::addGroup(const std::string &name) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Group *Queue::findGroup(const std::string &name) const {
+	auto it = _groupIndex.find(name);
+	return it != _groupIndex.end() ? it.value() : nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 const char *Queue::senderName() const {
 	return MASTER_NAME;
@@ -166,6 +190,9 @@ void Queue::setMessageDispatcher(MessageDispatcher *dispatcher) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Queue::Result Queue::push(Client *sender, Message *msg, int packetSize) {
+	if ( _latencyStatistics )
+		msg->received = chrono::steady_clock::now();
+
 	flushProcessedMessages();
 
 	/*
@@ -174,19 +201,22 @@ Queue::Result Queue::push(Client *sender, Message *msg, int packetSize) {
 	               msg->target.c_str());
 	*/
 
-	// Check if the target exists
-	Groups::iterator git = _groups.find(msg->target);
-	if ( git == _groups.end() ) {
+	// Check if the target exists. The group is resolved once and carried
+	// with the message.
+	Group *group = findGroup(msg->target);
+	if ( !group ) {
 		Clients::iterator cit = _clients.find(msg->target);
 		if ( cit == _clients.end() )
 			return GroupDoesNotExist;
 	}
 	else {
-		++git->second->_txMessages.received;
-		git->second->_txBytes.received += packetSize;
-		git->second->_txPayload.received += msg->payload.size();
+		++group->_txMessages.received;
+		group->_txBytes.received += packetSize;
+		group->_txPayload.received += msg->payload.size();
 	}
 
+	msg->_internalGroupPtr = group;
+
 	++_txMessages.received;
 	_txBytes.received += packetSize;
 	_txPayload.received += msg->payload.size();
@@ -284,6 +314,8 @@ bool Queue::publish(Client *sender, Message *msg) {
 		++_sequenceNumber;
 		msg->sequenceNumber = _sequenceNumber;
 		_messages.push_back(msg);
+		if ( _messageLog.isOpen() )
+			_messageLog.append(msg);
 	}
 
 	//NOTIFY(0, publish, sender, msg);
@@ -296,7 +328,7 @@ bool Queue::publish(Client *sender, Message *msg) {
 			--sender->_acknowledgeCounter;
 			if ( sender->_acknowledgeCounter == 0 ) {
 				sender->_acknowledgeCounter = sender->_acknowledgeWindow;
-				sender->ack();
+				ack(sender);
 				sender->_ackInitiated = Core::Time();
 			}
 			else if ( !sender->_ackInitiated )
@@ -304,32 +336,68 @@ bool Queue::publish(Client *sender, Message *msg) {
 		}
 	}
 
-	auto git = _groups.find(msg->target);
-	if ( git == _groups.end() ) {
+	// The payload might be cleared by the clients after sending, save the
+	// length for the statistics.
+	size_t lengthPayload = msg->payload.size();
+
+	bool measure = _latencyStatistics
+	            && (msg->received != chrono::steady_clock::time_point());
+	if ( measure )
+		_processedLatency.add(microseconds(msg->received));
+
+	Group *group = msg->_internalGroupPtr;
+	if ( !group )
+		group = findGroup(msg->target);
+
+	if ( !group ) {
 		// Peer to peer
 		auto cit = _clients.find(msg->target);
 		if ( cit == _clients.end() )
 			return false;
 
-		cit.value()->publish(sender, msg);
+		deliver(sender, msg, cit.value(), lengthPayload);
+		flushDispatchBatches(msg);
+
+		if ( measure ) {
+			double us = microseconds(msg->received);
+			cit.value()->_latency.add(us);
+			_sentLatency.add(us);
+		}
 
 		++_txMessages.sent;
-		_txPayload.sent += msg->payload.size();
+		_txPayload.sent += lengthPayload;
 	}
 	else {
 		// Distribute to members
-		auto group = git->second.get();
 		msg->_internalGroupPtr = group;
 
+		// Index the content once for all filtering members
+		if ( group->_filteredMembers )
+			msg->indexContent();
+
 		for ( auto client : group->_members ) {
-			client->publish(sender, msg);
+			if ( group->_filteredMembers && !client->accepts(group, msg) )
+				continue;
+
+			deliver(sender, msg, client, lengthPayload);
+			if ( measure )
+				client->_latency.add(microseconds(msg->received));
+
 			// Each message sent to a member of a particular group is tagged
 			// as sent.
-			++git->second->_txMessages.sent;
-			git->second->_txBytes.sent += msg->payload.size();
+			++group->_txMessages.sent;
+			group->_txBytes.sent += lengthPayload;
 
 			++_txMessages.sent;
-			_txPayload.sent += msg->payload.size();
+			_txPayload.sent += lengthPayload;
+		}
+
+		flushDispatchBatches(msg);
+
+		if ( measure ) {
+			double us = microseconds(msg->received);
+			group->_latency.add(us);
+			_sentLatency.add(us);
 		}
 	}
 
@@ -340,15 +408,71 @@ bool Queue::publish(Client *sender, Message *msg) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t Queue::deliver(Client *sender, Message *msg, Client *client,
+                      size_t lengthPayload) {
+	if ( !client->_dispatcher )
+		return client->publish(sender, msg);
+
+	// The dispatcher does not forward the sender, check self discarding
+	// here.
+	if ( (client == sender) && client->discardSelf() && msg->selfDiscard )
+		return 0;
+
+	for ( auto &batch : _dispatchBatches ) {
+		if ( batch.dispatcher == client->_dispatcher ) {
+			batch.clients.push_back(client);
+			return lengthPayload;
+		}
+	}
+
+	_dispatchBatches.push_back(DispatchBatch());
+	_dispatchBatches.back().dispatcher = client->_dispatcher;
+	_dispatchBatches.back().clients.push_back(client);
+
+	return lengthPayload;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Queue::flushDispatchBatches(const Message *msg) {
+	for ( auto &batch : _dispatchBatches ) {
+		if ( batch.clients.empty() ) continue;
+		// Each dispatcher gets its own copy of the message to keep the
+		// reference counts of the message and its encoding cache within
+		// one thread.
+		batch.dispatcher->publish(msg->clone(), batch.clients.data(),
+		                          batch.clients.size());
+		batch.clients.clear();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Queue::ack(Client *client) {
+	if ( client->_dispatcher )
+		client->_dispatcher->ack(client);
+	else
+		client->ack();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Queue::Result Queue::subscribe(Client *client, const std::string &groupName) {
-	Groups::iterator it = _groups.find(groupName);
-	if ( it == _groups.end() )
+	Group *group = findGroup(groupName);
+	if ( !group )
 		// GROUP NOT FOUND
 		return GroupDoesNotExist;
 
-	Group *group = it->second.get();
-
 	if ( !group->addMember(client) )
 		return GroupAlreadySubscribed;
 
@@ -375,16 +499,16 @@ Queue::Result Queue::subscribe(Client *client, const std::string &groupName) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Queue::Result Queue::unsubscribe(Client *client, const std::string &groupName) {
-	Groups::iterator it = _groups.find(groupName);
-	if ( it == _groups.end() )
+	Group *group = findGroup(groupName);
+	if ( !group )
 		// GROUP NOT FOUND
 		return GroupDoesNotExist;
 
-	Group *group = it->second.get();
-
 	if ( !group->removeMember(client) )
 		return GroupNotSubscribed;
 
+	removeFilter(client, group);
+
 	Message msg;
 
 	msg.sender = senderName();
@@ -406,11 +530,88 @@ Queue::Result Queue::unsubscribe(Client *client, const std::string &groupName) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Queue::Result Queue::setFilter(Client *client, const std::string &groupName,
+                               const SubscriptionFilter &filter) {
+	Group *group = findGroup(groupName);
+	if ( !group )
+		return GroupDoesNotExist;
+
+	if ( !group->hasMember(client) )
+		return GroupNotSubscribed;
+
+	removeFilter(client, group);
+
+	if ( !filter.empty() ) {
+		client->_filters.emplace_back(group, filter);
+		++group->_filteredMembers;
+	}
+
+	return Success;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Queue::removeFilter(Client *client, Group *group) {
+	for ( auto it = client->_filters.begin(); it != client->_filters.end(); ++it ) {
+		if ( it->first == group ) {
+			client->_filters.erase(it);
+			--group->_filteredMembers;
+			return;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Queue::setMessageLog(const std::string &directory, size_t segmentSize,
+                          size_t maxSegments) {
+	if ( _messageProcessor ) {
+		SEISCOMP_ERROR("[queue/%s] message log must be set before activation",
+		               _name.c_str());
+		return false;
+	}
+
+	if ( !_messageLog.open(directory, segmentSize, maxSegments) )
+		return false;
+
+	// Continue with the logged sequence numbers
+	if ( !_messageLog.empty() && (_messageLog.lastSequenceNumber() > _sequenceNumber) )
+		_sequenceNumber = _messageLog.lastSequenceNumber();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Message *Queue::getMessage(SequenceNumber sequenceNumber,
                            const Client *client) const {
 	SequenceNumber firstSeqNo, lastSeqNo, idx;
 
+	if ( _messageLog.isOpen() && !_messageLog.empty() ) {
+		// Messages older than the ring are read from the log
+		SequenceNumber lastLogged = _messageLog.lastSequenceNumber();
+		if ( !_messages.empty() && (_messages.front()->sequenceNumber <= lastLogged) )
+			lastLogged = _messages.front()->sequenceNumber - 1;
+
+		if ( (sequenceNumber <= lastLogged)
+		  && (lastLogged >= _messageLog.firstSequenceNumber()) ) {
+			Message *msg = getLoggedMessage(sequenceNumber, lastLogged, client);
+			if ( msg )
+				return msg;
+			sequenceNumber = lastLogged + 1;
+		}
+	}
+
 	if ( _messages.empty() )
 		return nullptr;
 
@@ -434,7 +635,8 @@ Message *Queue::getMessage(SequenceNumber sequenceNumber,
 	while ( idx < _messages.size() ) {
 		Message *msg = _messages[idx].get();
 		// If the messages target group has client as member, return it
-		if ( msg->_internalGroupPtr->hasMember(client) ) {
+		if ( msg->_internalGroupPtr->hasMember(client)
+		  && client->accepts(msg->_internalGroupPtr, msg) ) {
 			// Update statistics
 			++msg->_internalGroupPtr->_txMessages.sent;
 			msg->_internalGroupPtr->_txBytes.sent += msg->payload.size();
@@ -459,6 +661,51 @@ Message *Queue::getMessage(SequenceNumber sequenceNumber,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Message *Queue::getLoggedMessage(SequenceNumber sequenceNumber,
+                                 SequenceNumber lastSequenceNumber,
+                                 const Client *client) const {
+	MessageLog::Record record;
+
+	if ( sequenceNumber < _messageLog.firstSequenceNumber() )
+		sequenceNumber = _messageLog.firstSequenceNumber();
+
+	for ( ; sequenceNumber <= lastSequenceNumber; ++sequenceNumber ) {
+		if ( !_messageLog.read(sequenceNumber, record) )
+			break;
+
+		Group *group = findGroup(string(record.target, record.targetLength));
+		if ( group ) {
+			if ( !group->hasMember(client) )
+				continue;
+		}
+		else if ( client->name().compare(0, string::npos, record.target, record.targetLength) )
+			continue;
+
+		_loggedMessage = MessageLog::createMessage(record);
+		_loggedMessage->_internalGroupPtr = group;
+
+		if ( group && !client->accepts(group, _loggedMessage.get()) )
+			continue;
+
+		if ( group ) {
+			++group->_txMessages.sent;
+			group->_txBytes.sent += record.payloadLength;
+		}
+
+		++_txMessages.sent;
+		_txBytes.sent += record.payloadLength;
+
+		return _loggedMessage.get();
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Queue::Result Queue::connect(Client *client,
                              const KeyCStrValues inParams, int inParamCount,
@@ -476,7 +723,7 @@ Queue::Result Queue::connect(Client *client,
 			}
 
 			if ( !_clients.contains(client->_name)
-			  && _groups.find(client->_name) == _groups.end() )
+			  && !findGroup(client->_name) )
 				break;
 
 			client->_name.clear();
@@ -493,7 +740,7 @@ Queue::Result Queue::connect(Client *client,
 		return ClientNameNotUnique;
 	}
 
-	if ( _groups.find(client->_name) != _groups.end() ) {
+	if ( findGroup(client->_name) ) {
 		SEISCOMP_ERROR("Client name '%s' not unique: taken by a group",
 		               client->_name.c_str());
 		return ClientNameNotUnique;
@@ -525,6 +772,7 @@ Queue::Result Queue::disconnect(Client *client) {
 	Seiscomp::Core::Time now = Seiscomp::Core::Time::GMT();
 	for ( auto group : _groups ) {
 		if ( !group.second->removeMember(client) ) continue;
+		removeFilter(client, group.second.get());
 
 		// Notify all remaining clients about the membership change
 		Message msg;
@@ -549,6 +797,10 @@ Queue::Result Queue::disconnect(Client *client) {
 			(*cit)->dropConnection(client);
 	}
 
+	if ( client->_dispatcher )
+		// Drop all scheduled requests for this client
+		client->_dispatcher->remove(client);
+
 	_clients.erase(_clients.find(client->_name.c_str()));
 	client->_queue = nullptr;
 
@@ -612,6 +864,7 @@ void Queue::returnToSender(Message *msg, BaseObject *obj) {
 
 	// Reset other attributes
 	msg->encodingWebSocket = nullptr;
+	msg->encodingWebSocketDeflate.clear();
 	msg->_internalGroupPtr = nullptr;
 
 	// Disable self discarding as the sender has changed
@@ -627,6 +880,7 @@ void Queue::returnToSender(Message *msg, BaseObject *obj) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Queue::processingLoop() {
 	ProcessingTask task;
+	vector<ProcessingTask> batch;
 
 	SEISCOMP_DEBUG("[queue] worker is running");
 
@@ -635,12 +889,44 @@ void Queue::processingLoop() {
 	while ( true ) {
 		task = _tasks.pop();
 		process(task);
-		taskReady(task);
+
+		if ( _maxBatchSize <= 1 ) {
+			taskReady(task);
+			continue;
+		}
+
+		// Pass already pending tasks as one batch to the processors and
+		// forward them after the processors have been flushed
+		auto deadline = chrono::steady_clock::now()
+		              + chrono::duration_cast<chrono::steady_clock::duration>(
+		                    chrono::duration<double>(_maxBatchLatency));
+
+		batch.push_back(task);
+		while ( batch.size() < _maxBatchSize
+		     && chrono::steady_clock::now() < deadline
+		     && _tasks.pop(task) ) {
+			batch.push_back(task);
+			process(task);
+		}
+
+		flushProcessors();
+
+		for ( auto &item : batch ) {
+			taskReady(item);
+		}
+
+		batch.clear();
 	}
 
 	}
 	catch ( std::exception & ) {
-		// Queue closed
+		// Queue closed, the pending batch will not be forwarded anymore
+		if ( !batch.empty() ) {
+			flushProcessors();
+			for ( auto &item : batch ) {
+				delete item.second;
+			}
+		}
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -662,6 +948,17 @@ void Queue::process(ProcessingTask &task) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Queue::flushProcessors() {
+	for ( auto &proc : _messageProcessors ) {
+		proc->flush();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Queue::taskReady(const ProcessingTask &task) {
 	if ( _processedMessageDispatcher ) {
@@ -687,6 +984,31 @@ void Queue::activate() {
 		return;
 	}
 
+	// The largest batch requested by any processor and the shortest
+	// latency define the batches of the processing thread
+	_maxBatchSize = 1;
+	_maxBatchLatency = 0;
+
+	for ( auto &proc : _messageProcessors ) {
+		if ( proc->maxBatchSize() <= 1 ) {
+			continue;
+		}
+
+		if ( (_maxBatchSize <= 1) || (proc->maxBatchLatency() < _maxBatchLatency) ) {
+			_maxBatchLatency = proc->maxBatchLatency();
+		}
+
+		_maxBatchSize = max(_maxBatchSize, proc->maxBatchSize());
+	}
+
+	if ( _maxBatchSize > 1 ) {
+		// Let the task queue hold at least one batch
+		_tasks.resize(max<int>(10, static_cast<int>(_maxBatchSize)));
+		SEISCOMP_INFO("[queue] processing messages in batches of up to %d "
+		              "within %.3fs", static_cast<int>(_maxBatchSize),
+		              _maxBatchLatency);
+	}
+
 	// Start the processing thread
 	_messageProcessor = new thread(bind(&Queue::processingLoop, this));
 }
@@ -743,6 +1065,8 @@ void Queue::shutdown() {
 
 	// Clear message ring
 	_messages.clear();
+	_loggedMessage = nullptr;
+	_messageLog.close();
 
 	// Reset sequence number counter
 	_sequenceNumber = 0;
@@ -777,17 +1101,32 @@ void Queue::timeout() {
 			Core::TimeSpan dt = now - client->_ackInitiated;
 			if ( dt.seconds() > 0 ) {
 				client->_acknowledgeCounter = client->_acknowledgeWindow;
-				client->ack();
+				ack(client);
 				client->_ackInitiated = Core::Time();
 			}
 		}
 
+		if ( client->_tooSlow ) {
+			// Clients cannot be removed while a message is distributed,
+			// the implementation only flags them
+			SEISCOMP_WARNING("Remove client %s which exceeded its output limits",
+			                 client->_name.c_str());
+			if ( client->_dispatcher )
+				client->_dispatcher->dispose(client);
+			else
+				client->dispose();
+			continue;
+		}
+
 		++client->_inactivityCounter;
 		if ( client->_inactivityCounter > _inactivityLimit ) {
 			// The implementation will remove itself from the queue
 			SEISCOMP_INFO("Remove client %s due to inactivity",
 			              client->_name.c_str());
-			client->dispose();
+			if ( client->_dispatcher )
+				client->_dispatcher->dispose(client);
+			else
+				client->dispose();
 		}
 	}
 
@@ -820,31 +1159,43 @@ void Queue::timeout() {
 			   << Status::Tag(Status::MessageQueueSize).toString() << "=" << _tasks.size() << "&"
 			   << Status::Tag(Status::Uptime).toString() << "=" << Core::toString(floor(double(now - _created)*100 + 0.5)*0.01);
 
+			if ( _latencyStatistics ) {
+				// The 99th percentiles in milliseconds of the current
+				// statistics interval
+				Latency processed = _processedLatency, sent = _sentLatency;
+				processed.update();
+				sent.update();
+				os << "&processedlatency=" << processed.p99 * 1E-3
+				   << "&sentlatency=" << sent.p99 * 1E-3;
+			}
+
 			for ( auto &&item : _processors )
 				item->getInfo(now, os);
 		}
 
 		double lengthPayload = sohMessage.payload.size();
 
-		auto git = _groups.find(sohMessage.target);
-		if ( git != _groups.end() ) {
+		Group *group = findGroup(sohMessage.target);
+		if ( group ) {
 			// Distribute to members
-			Group *group = git->second.get();
 			sohMessage._internalGroupPtr = group;
 
 			Group::Members::iterator mit;
 			for ( mit = group->_members.begin(); mit != group->_members.end(); ++mit ) {
-				double lengthMessage = (*mit)->publish(nullptr, &sohMessage);
+				double lengthMessage = deliver(nullptr, &sohMessage, *mit,
+				                               static_cast<size_t>(lengthPayload));
 				// Each message sent to a member of a particular group is tagged
 				// as sent.
-				++git->second->_txMessages.sent;
-				git->second->_txPayload.sent += lengthPayload;
-				git->second->_txBytes.sent += lengthMessage;
+				++group->_txMessages.sent;
+				group->_txPayload.sent += lengthPayload;
+				group->_txBytes.sent += lengthMessage;
 
 				++_txMessages.sent;
 				_txPayload.sent += lengthPayload;
 				_txBytes.sent += lengthMessage;
 			}
+
+			flushDispatchBatches(&sohMessage);
 		}
 	}
 }
@@ -869,14 +1220,43 @@ void Queue::getStatisticsSnapshot(QueueStatistics &stats, bool reset) {
 		stats.groups[idx].messages = it->second->_txMessages;
 		stats.groups[idx].bytes = it->second->_txBytes;
 		stats.groups[idx].payload = it->second->_txPayload;
-		if ( reset )
+		stats.groups[idx].latency = it->second->_latency;
+		stats.groups[idx].latency.update();
+		if ( reset ) {
 			it->second->_txMessages =
 			it->second->_txBytes =
 			it->second->_txPayload = Tx();
+			it->second->_latency.clear();
+		}
 	}
 
-	if ( reset )
+	stats.processedLatency = _processedLatency;
+	stats.processedLatency.update();
+	stats.sentLatency = _sentLatency;
+	stats.sentLatency.update();
+
+	if ( reset ) {
 		_txMessages = _txBytes = _txPayload = Tx();
+		_processedLatency.clear();
+		_sentLatency.clear();
+	}
+
+	stats.clients.clear();
+	for ( auto it = _clients.begin(); it != _clients.end(); ++it ) {
+		Client *client = it.value();
+		if ( !client ) continue;
+
+		stats.clients.emplace_back();
+		ClientStatistics &cs = stats.clients.back();
+		cs.name = client->name();
+		cs.pendingMessages = client->pendingMessages();
+		cs.pendingBytes = client->pendingBytes();
+		cs.droppedMessages = client->droppedMessages();
+		cs.latency = client->_latency;
+		cs.latency.update();
+		if ( reset )
+			client->_latency.clear();
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -28,10 +28,12 @@
 #include <seiscomp/core/enumeration.h>
 #include <seiscomp/core/message.h>
 
+#include <seiscomp/broker/filter.h>
 #include <seiscomp/broker/messageprocessor.h>
 #include <seiscomp/broker/hashset.h>
 #include <seiscomp/broker/group.h>
 #include <seiscomp/broker/message.h>
+#include <seiscomp/broker/messagelog.h>
 #include <seiscomp/broker/statistics.h>
 
 #include <seiscomp/broker/utils/utils.h>
@@ -47,6 +49,7 @@ namespace Broker {
 
 
 class Client;
+class ClientDispatcher;
 class MessageDispatcher;
 
 DEFINE_SMARTPOINTER(MessageProcessor);
@@ -108,6 +111,30 @@ class SC_BROKER_API Queue {
 			)
 		);
 
+		MAKEENUM(
+			SlowClientPolicy,
+			EVALUES(
+				DropOldest,
+				Disconnect,
+				StatusOnly
+			),
+			ENAMES(
+				"drop-oldest",
+				"disconnect",
+				"status-only"
+			)
+		);
+
+		//! The output limits of each client of the queue
+		struct ClientLimits {
+			//! The maximum number of bytes buffered for sending, 0 = unlimited
+			size_t           maxPendingBytes{0};
+			//! The maximum number of messages queued, 0 = unlimited
+			size_t           maxPendingMessages{0};
+			//! What to do with a client exceeding one of the limits
+			SlowClientPolicy policy{Disconnect};
+		};
+
 		const std::string StatusGroup = "STATUS_GROUP";
 
 
@@ -171,6 +198,21 @@ class SC_BROKER_API Queue {
 		 */
 		void setMessageDispatcher(MessageDispatcher *dispatcher);
 
+		/**
+		 * @brief Enables the disk based message log which keeps published
+		 *        messages beyond the in-memory ring. Reconnecting clients
+		 *        can continue from older sequence numbers and the sequence
+		 *        numbers continue after a restart.
+		 *
+		 * This must be called before the queue is activated.
+		 * @param directory The log directory
+		 * @param segmentSize The size of a segment file in bytes
+		 * @param maxSegments The maximum number of segments to keep
+		 * @return Success flag
+		 */
+		bool setMessageLog(const std::string &directory, size_t segmentSize,
+		                   size_t maxSegments);
+
 		/**
 		 * @brief Subscribe a client to a particular group
 		 * @param client The client
@@ -187,6 +229,18 @@ class SC_BROKER_API Queue {
 		 */
 		Result unsubscribe(Client *client, const std::string &group);
 
+		/**
+		 * @brief Sets the content filter of a client for a group it is
+		 *        subscribed to. Messages of that group which do not pass
+		 *        the filter are not delivered to the client.
+		 * @param client The client
+		 * @param group The name of the group
+		 * @param filter The filter, an empty filter removes it
+		 * @return The result code
+		 */
+		Result setFilter(Client *client, const std::string &group,
+		                 const SubscriptionFilter &filter);
+
 		/**
 		 * @brief Returns a buffered message after a particular sequence number
 		 * @param sequenceNumber The sequence number to continue with.
@@ -312,12 +366,37 @@ class SC_BROKER_API Queue {
 	public:
 		uint64_t maxPayloadSize() const;
 
+		/**
+		 * @brief Sets the output limits which apply to each client. The
+		 *        limits are checked by the client implementations.
+		 * @param limits The limits
+		 */
+		void setClientLimits(const ClientLimits &limits);
+		const ClientLimits &clientLimits() const;
+
+		/**
+		 * @brief Enables latency histograms of the processing and the
+		 *        dispatch stage which are part of the statistics. If
+		 *        disabled then no clock is read on the message path.
+		 * @param enable The enable flag
+		 */
+		void setLatencyStatisticsEnabled(bool enable);
+
 
 	// ----------------------------------------------------------------------
 	//  Private interface
 	// ----------------------------------------------------------------------
 	private:
 		using ProcessingTask = std::pair<Client*,Message*>;
+
+		/**
+		 * @brief Returns a group by name.
+		 * @param name The group name
+		 * @return The group or nullptr if it does not exist
+		 */
+		Group *findGroup(const std::string &name) const;
+
+		void removeFilter(Client *client, Group *group);
 		using TaskQueue = Utils::BlockingDequeue<ProcessingTask>;
 
 		/**
@@ -332,6 +411,46 @@ class SC_BROKER_API Queue {
 		 */
 		bool publish(Client *sender, Message *msg);
 
+		/**
+		 * @brief Returns a message from the message log after a particular
+		 *        sequence number.
+		 * @param sequenceNumber The first sequence number to check
+		 * @param lastSequenceNumber The last sequence number to check
+		 * @param client The client instance to filter subscriptions for
+		 * @return A message pointer which is valid until the next call or
+		 *         NULL if no message is available
+		 */
+		Message *getLoggedMessage(SequenceNumber sequenceNumber,
+		                          SequenceNumber lastSequenceNumber,
+		                          const Client *client) const;
+
+		/**
+		 * @brief Publishes a message to a single client. If the client is
+		 *        served by a dispatcher then the client is added to the
+		 *        dispatch batch of its dispatcher.
+		 * @param sender The sender instance
+		 * @param msg The message
+		 * @param client The receiving client
+		 * @param lengthPayload The payload length of the message
+		 * @return The number of bytes sent or scheduled
+		 */
+		size_t deliver(Client *sender, Message *msg, Client *client,
+		               size_t lengthPayload);
+
+		/**
+		 * @brief Hands a message over to all dispatchers which have clients
+		 *        collected with deliver() and clears the batches.
+		 * @param msg The message
+		 */
+		void flushDispatchBatches(const Message *msg);
+
+		/**
+		 * @brief Sends an acknowledgement to a client either directly or
+		 *        through its dispatcher
+		 * @param client The client
+		 */
+		void ack(Client *client);
+
 		/**
 		 * @brief Pops all messages from the processing queue and publishes them.
 		 *
@@ -350,6 +469,11 @@ class SC_BROKER_API Queue {
 		 */
 		void process(ProcessingTask &task);
 
+		/**
+		 * @brief Lets all message processors complete the current batch.
+		 */
+		void flushProcessors();
+
 		/**
 		 * @brief Called from the processing thread informing the queue that
 		 *        the message is processed and can be forwarded to clients.
@@ -369,10 +493,18 @@ class SC_BROKER_API Queue {
 	// ----------------------------------------------------------------------
 	private:
 		using Groups = std::map<std::string, GroupPtr>;
+		using GroupIndex = KHashMap<const char*, Group*>;
 		using MessageRing = circular_buffer<MessagePtr>;
 		using ClientNames = KHashSet<const char*>;
 		using Clients = KHashMap<const char*, Client*>;
 
+		struct DispatchBatch {
+			ClientDispatcher     *dispatcher{nullptr};
+			std::vector<Client*>  clients;
+		};
+
+		using DispatchBatches = std::vector<DispatchBatch>;
+
 		std::string          _name;
 		MessageProcessors    _processors;
 		MessageProcessors    _connectionProcessors;
@@ -380,10 +512,16 @@ class SC_BROKER_API Queue {
 		MessageDispatcher   *_processedMessageDispatcher;
 		SequenceNumber       _sequenceNumber;
 		Groups               _groups;
+		GroupIndex           _groupIndex;
 		StringList           _groupNames;
 		MessageRing          _messages;
+		MessageLog           _messageLog;
+		mutable MessagePtr   _loggedMessage;
 		Clients              _clients;
+		DispatchBatches      _dispatchBatches;
 		std::thread         *_messageProcessor;
+		size_t               _maxBatchSize;
+		double               _maxBatchLatency;
 		TaskQueue            _tasks;
 		TaskQueue            _results;
 		Core::Time           _created;
@@ -392,6 +530,10 @@ class SC_BROKER_API Queue {
 		int                  _sohInterval;
 		int                  _inactivityLimit;
 		uint64_t             _maxPayloadSize;
+		ClientLimits         _clientLimits;
+		bool                 _latencyStatistics{false};
+		Latency              _processedLatency;
+		Latency              _sentLatency;
 		mutable Tx           _txMessages;
 		mutable Tx           _txBytes;
 		mutable Tx           _txPayload;
@@ -410,6 +552,18 @@ inline uint64_t Queue::maxPayloadSize() const {
 	return _maxPayloadSize;
 }
 
+inline void Queue::setClientLimits(const ClientLimits &limits) {
+	_clientLimits = limits;
+}
+
+inline const Queue::ClientLimits &Queue::clientLimits() const {
+	return _clientLimits;
+}
+
+inline void Queue::setLatencyStatisticsEnabled(bool enable) {
+	_latencyStatistics = enable;
+}
+
 
 }
 }
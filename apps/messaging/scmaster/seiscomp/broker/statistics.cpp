@@ -23,12 +23,58 @@
 
 #include <seiscomp/broker/statistics.h>
 
+#include <algorithm>
+
 
 namespace Seiscomp {
 namespace Messaging {
 namespace Broker {
 
 
+namespace {
+
+
+double percentile(const double *buckets, double count, double p) {
+	double threshold = count * p;
+	double sum = 0;
+	double limit = 1;
+
+	for ( int i = 0; i < Latency::Buckets; ++i, limit *= 2 ) {
+		sum += buckets[i];
+		if ( sum >= threshold )
+			return limit;
+	}
+
+	return limit;
+}
+
+
+}
+
+
+void Latency::update() {
+	if ( count <= 0 ) {
+		p50 = p90 = p99 = 0;
+		return;
+	}
+
+	// Bucket bounds must not exceed the observed maximum
+	p50 = std::min(percentile(buckets, count, 0.50), max);
+	p90 = std::min(percentile(buckets, count, 0.90), max);
+	p99 = std::min(percentile(buckets, count, 0.99), max);
+}
+
+
+Latency &Latency::operator+=(const Latency &other) {
+	for ( int i = 0; i < Buckets; ++i )
+		buckets[i] += other.buckets[i];
+	count += other.count;
+	if ( other.max > max ) max = other.max;
+	update();
+	return *this;
+}
+
+
 QueueStatistics &QueueStatistics::operator+=(const QueueStatistics &stats) {
 	if ( name.empty() )
 		name = stats.name;
@@ -39,6 +85,8 @@ QueueStatistics &QueueStatistics::operator+=(const QueueStatistics &stats) {
 	messages += stats.messages;
 	bytes += stats.bytes;
 	payload += stats.payload;
+	processedLatency += stats.processedLatency;
+	sentLatency += stats.sentLatency;
 
 	groups.resize(stats.groups.size());
 	for ( size_t i = 0; i < stats.groups.size(); ++i ) {
@@ -51,8 +99,12 @@ QueueStatistics &QueueStatistics::operator+=(const QueueStatistics &stats) {
 		groups[i].messages += stats.groups[i].messages;
 		groups[i].bytes += stats.groups[i].bytes;
 		groups[i].payload += stats.groups[i].payload;
+		groups[i].latency += stats.groups[i].latency;
 	}
 
+	// Queue depths are not cumulative, keep the latest snapshot
+	clients = stats.clients;
+
 	return *this;
 }
 
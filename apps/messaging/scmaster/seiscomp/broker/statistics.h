@@ -60,11 +60,62 @@ struct SC_BROKER_API Tx : Core::BaseObject {
 };
 
 
+/**
+ * @brief Latency histogram with logarithmic buckets in microseconds.
+ *
+ * The first bucket holds latencies below 1us, bucket i holds latencies
+ * below 2^i us. The percentiles are the upper bounds of the bucket which
+ * contains them and are only valid after update() has been called.
+ */
+struct SC_BROKER_API Latency : Core::BaseObject {
+	enum Constants {
+		Buckets = 28
+	};
+
+	double count{0}; //!< Number of samples
+	double p50{0};   //!< Median in microseconds
+	double p90{0};   //!< 90th percentile in microseconds
+	double p99{0};   //!< 99th percentile in microseconds
+	double max{0};   //!< Maximum in microseconds
+	double buckets[Buckets] = {};
+
+	//! Adds a sample in microseconds
+	void add(double us) {
+		size_t idx = 0;
+		for ( double limit = 1; (us >= limit) && (idx < Buckets-1); limit *= 2 )
+			++idx;
+		++buckets[idx];
+		++count;
+		if ( us > max ) max = us;
+	}
+
+	//! Updates the percentiles from the buckets
+	void update();
+
+	void clear() {
+		*this = Latency();
+	}
+
+	Latency &operator+=(const Latency &other);
+
+	DECLARE_SERIALIZATION {
+		ar
+		& NAMED_OBJECT("count", count)
+		& NAMED_OBJECT("p50", p50)
+		& NAMED_OBJECT("p90", p90)
+		& NAMED_OBJECT("p99", p99)
+		& NAMED_OBJECT("max", max)
+		;
+	}
+};
+
+
 struct GroupStatistics : Core::BaseObject {
 	std::string name;
 	Tx          messages;
 	Tx          bytes;
 	Tx          payload;
+	Latency     latency; //!< Receipt until handed over to the members
 
 	DECLARE_SERIALIZATION {
 		ar
@@ -72,6 +123,27 @@ struct GroupStatistics : Core::BaseObject {
 		& NAMED_OBJECT_HINT("messages", messages, Archive::STATIC_TYPE)
 		& NAMED_OBJECT_HINT("bytes", bytes, Archive::STATIC_TYPE)
 		& NAMED_OBJECT_HINT("payload", payload, Archive::STATIC_TYPE)
+		& NAMED_OBJECT_HINT("latency", latency, Archive::STATIC_TYPE)
+		;
+	}
+};
+
+
+//! The output queue depth of a client at the time of the snapshot
+struct ClientStatistics : Core::BaseObject {
+	std::string name;
+	double      pendingMessages{0};
+	double      pendingBytes{0};
+	double      droppedMessages{0};
+	Latency     latency; //!< Receipt until handed over to the client
+
+	DECLARE_SERIALIZATION {
+		ar
+		& NAMED_OBJECT("name", name)
+		& NAMED_OBJECT("pendingMessages", pendingMessages)
+		& NAMED_OBJECT("pendingBytes", pendingBytes)
+		& NAMED_OBJECT("droppedMessages", droppedMessages)
+		& NAMED_OBJECT_HINT("latency", latency, Archive::STATIC_TYPE)
 		;
 	}
 };
@@ -80,11 +152,15 @@ struct GroupStatistics : Core::BaseObject {
 DEFINE_SMARTPOINTER(QueueStatistics);
 struct SC_BROKER_API QueueStatistics : Core::BaseObject {
 	typedef std::vector<GroupStatistics> Groups;
+	typedef std::vector<ClientStatistics> Clients;
 	std::string name;
 	Groups      groups;
+	Clients     clients;
 	Tx          messages;
 	Tx          bytes;
 	Tx          payload;
+	Latency     processedLatency; //!< Receipt until processed by the plugins
+	Latency     sentLatency; //!< Receipt until handed over to all receivers
 
 	QueueStatistics &operator+=(const QueueStatistics &stats);
 
@@ -94,7 +170,10 @@ struct SC_BROKER_API QueueStatistics : Core::BaseObject {
 		& NAMED_OBJECT_HINT("messages", messages, Archive::STATIC_TYPE)
 		& NAMED_OBJECT_HINT("bytes", bytes, Archive::STATIC_TYPE)
 		& NAMED_OBJECT_HINT("payload", payload, Archive::STATIC_TYPE)
+		& NAMED_OBJECT_HINT("processedLatency", processedLatency, Archive::STATIC_TYPE)
+		& NAMED_OBJECT_HINT("sentLatency", sentLatency, Archive::STATIC_TYPE)
 		& NAMED_OBJECT_HINT("groups", groups, Archive::STATIC_TYPE)
+		& NAMED_OBJECT_HINT("clients", clients, Archive::STATIC_TYPE)
 		;
 	}
 };
@@ -26,6 +26,7 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/io/archive/jsonarchive.h>
 
+#include <algorithm>
 #include <iostream>
 #include <functional>
 
@@ -143,6 +144,140 @@ void QueueWorker::messageAvailable(Queue *q) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DispatchWorker::DispatchWorker(QueueWorker *worker)
+: _worker(worker) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DispatchWorker::idle() {
+	if ( !interrupted() )
+		return;
+
+	{
+		lock_guard<mutex> l(_tasksMutex);
+		_processing.swap(_tasks);
+	}
+
+	while ( !_processing.empty() ) {
+		// Pop the task before executing it. A client might disconnect
+		// during execution which removes its pending tasks.
+		Task task = _processing.front();
+		_processing.pop_front();
+
+		switch ( task.type ) {
+			case Task::Publish:
+				task.client->publish(nullptr, task.msg.get());
+				break;
+			case Task::Ack:
+				task.client->ack();
+				break;
+			case Task::Dispose:
+				task.client->dispose();
+				break;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DispatchWorker::publish(Message *msg, Client *const *clients, size_t count) {
+	if ( !count ) {
+		delete msg;
+		return;
+	}
+
+	{
+		// The reference count of the message is only modified with the
+		// lock held until it is processed in this thread.
+		lock_guard<mutex> l(_tasksMutex);
+		for ( size_t i = 0; i < count; ++i )
+			_tasks.push_back(Task(Task::Publish, clients[i], msg));
+	}
+
+	interrupt();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DispatchWorker::ack(Client *client) {
+	{
+		lock_guard<mutex> l(_tasksMutex);
+		_tasks.push_back(Task(Task::Ack, client));
+	}
+
+	interrupt();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DispatchWorker::dispose(Client *client) {
+	{
+		lock_guard<mutex> l(_tasksMutex);
+		_tasks.push_back(Task(Task::Dispose, client));
+	}
+
+	interrupt();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DispatchWorker::remove(Client *client) {
+	// Clients disconnect from within this thread, so it is safe to clean
+	// the list of tasks being processed as well.
+	auto isClient = [client](const Task &task) {
+		return task.client == client;
+	};
+
+	_processing.erase(
+		remove_if(_processing.begin(), _processing.end(), isClient),
+		_processing.end()
+	);
+
+	lock_guard<mutex> l(_tasksMutex);
+	_tasks.erase(
+		remove_if(_tasks.begin(), _tasks.end(), isClient),
+		_tasks.end()
+	);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DispatchWorker::lockQueue() {
+	_worker->lock();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DispatchWorker::unlockQueue() {
+	_worker->unlock();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Server::Server() {
 	// Queue one hour of statistics
@@ -158,6 +293,8 @@ Server::Server() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Server::~Server() {
 	for ( auto &item : _queues ) {
+		for ( auto &dispatcher : item.second.dispatchers )
+			delete dispatcher.worker;
 		delete item.second.worker;
 		delete item.second.queue;
 	}
@@ -172,7 +309,8 @@ Server::~Server() {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-Server::QueueItem *Server::addQueue(const std::string &name, uint64_t maxPayloadSize) {
+Server::QueueItem *Server::addQueue(const std::string &name, uint64_t maxPayloadSize,
+                                    size_t dispatchThreads) {
 	if ( _queues.find(name) != _queues.end() )
 		return nullptr;
 
@@ -184,6 +322,12 @@ Server::QueueItem *Server::addQueue(const std::string &name, uint64_t maxPayload
 	item.thread = nullptr;
 	item.queue->setMessageDispatcher(item.worker);
 
+	item.dispatchers.resize(dispatchThreads);
+	for ( auto &dispatcher : item.dispatchers ) {
+		dispatcher.worker = new DispatchWorker(item.worker);
+		dispatcher.worker->setTriggerMode(Wired::DeviceGroup::LevelTriggered);
+	}
+
 	return &item;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -321,6 +465,13 @@ bool Server::init() {
 			return false;
 
 		item.thread = new thread(bind(&QueueWorker::run, item.worker));
+
+		for ( auto &dispatcher : item.dispatchers ) {
+			if ( !dispatcher.worker->setup() )
+				return false;
+
+			dispatcher.thread = new thread(bind(&DispatchWorker::run, dispatcher.worker));
+		}
 	}
 
 	createStatisticsSnapshot();
@@ -339,6 +490,19 @@ void Server::shutdown() {
 	for ( auto it = _queues.begin(); it != _queues.end(); ++it ) {
 		SEISCOMP_DEBUG("Shutdown sequence for queue %s", it->first.c_str());
 		QueueItem &item = it->second;
+
+		// The dispatchers disconnect their clients from the queue and
+		// need the queue worker up to that point.
+		for ( auto &dispatcher : item.dispatchers ) {
+			SEISCOMP_DEBUG("* Shutdown dispatcher");
+			dispatcher.worker->shutdown();
+			if ( dispatcher.thread ) {
+				dispatcher.thread->join();
+				delete dispatcher.thread;
+				dispatcher.thread = nullptr;
+			}
+		}
+
 		SEISCOMP_DEBUG("* Shutdown worker");
 		item.worker->shutdown();
 		SEISCOMP_DEBUG("* Wait for thread");
@@ -412,7 +576,25 @@ void Server::sessionTagged(Wired::Session *session) {
 		if ( it == _queues.end() )
 			return;
 
-		if ( it->second.worker ) {
+		QueueItem &item = it->second;
+		Client *client = ws->client();
+
+		// Clients requesting membership information are notified by the
+		// queue directly and stay in the queue worker thread.
+		if ( client && !item.dispatchers.empty()
+		  && !client->wantsMembershipInformation() ) {
+			DispatchWorker *dispatcher = item.dispatchers[item.nextDispatcher].worker;
+			item.nextDispatcher = (item.nextDispatcher + 1) % item.dispatchers.size();
+
+			item.worker->lock();
+			client->setDispatcher(dispatcher);
+			item.worker->unlock();
+
+			// Move session to the dispatcher which serves it from now on
+			moveTo(dispatcher, session);
+			dispatcher->interrupt();
+		}
+		else if ( item.worker ) {
 			// Move session to the corresponding queue worker
 			moveTo(it->second.worker, session);
 			it->second.worker->interrupt();
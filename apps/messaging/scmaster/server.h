@@ -96,6 +96,73 @@ class QueueWorker : public Wired::Reactor, public MessageDispatcher {
 
 
 
+/**
+ * @brief The DispatchWorker class serves a subset of the clients of a queue
+ *        in its own thread.
+ *
+ * The worker owns the sessions of its clients and thus reads from and writes
+ * to their sockets in parallel to the queue worker and other dispatch
+ * workers. Clients access the queue with the lock of the queue worker held.
+ * Messages published by the queue are scheduled and sent to the clients in
+ * the order they arrive.
+ */
+class DispatchWorker : public Wired::Reactor, public ClientDispatcher {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		DispatchWorker(QueueWorker *worker);
+
+
+	// ----------------------------------------------------------------------
+	//  Reactor interface
+	// ----------------------------------------------------------------------
+	public:
+		virtual void idle();
+
+
+	// ----------------------------------------------------------------------
+	//  ClientDispatcher interface
+	// ----------------------------------------------------------------------
+	public:
+		virtual void publish(Message *msg, Client *const *clients, size_t count);
+		virtual void ack(Client *client);
+		virtual void dispose(Client *client);
+		virtual void remove(Client *client);
+		virtual void lockQueue();
+		virtual void unlockQueue();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Task {
+			enum Type {
+				Publish,
+				Ack,
+				Dispose
+			};
+
+			Task() = default;
+			Task(Type t, Client *c, Message *m = nullptr)
+			: type(t), client(c), msg(m) {}
+
+			Type        type{Publish};
+			Client     *client{nullptr};
+			MessagePtr  msg;
+		};
+
+		using Tasks = std::deque<Task>;
+
+		QueueWorker *_worker;
+		std::mutex   _tasksMutex;
+		Tasks        _tasks;
+		Tasks        _processing;
+};
+
+
+
 DEFINE_SMARTPOINTER(Server);
 class Server : public Wired::Server {
 	// ----------------------------------------------------------------------
@@ -112,12 +179,21 @@ class Server : public Wired::Server {
 	//  Public interface
 	// ----------------------------------------------------------------------
 	public:
+		struct DispatchItem {
+			DispatchWorker *worker{nullptr};
+			std::thread    *thread{nullptr};
+		};
+
+		using DispatchItems = std::vector<DispatchItem>;
+
 		struct QueueItem {
 			Queue          *queue{nullptr};
 			Wired::IPACL    acl;
 			std::string     dbURL;
 			QueueWorker    *worker{nullptr};
 			std::thread    *thread{nullptr};
+			DispatchItems   dispatchers;
+			size_t          nextDispatcher{0};
 		};
 
 		struct DatabaseItem {
@@ -125,7 +201,17 @@ class Server : public Wired::Server {
 			std::thread    *thread{nullptr};
 		};
 
-		QueueItem *addQueue(const std::string &name, uint64_t maxPayloadSize);
+		/**
+		 * @brief Adds a new queue.
+		 * @param name The unique name of the queue
+		 * @param maxPayloadSize The maximum payload size of a message
+		 * @param dispatchThreads The number of threads serving the clients
+		 *                        of the queue. If zero then all clients
+		 *                        are served by the queue thread.
+		 * @return The queue item or nullptr if the name is not unique
+		 */
+		QueueItem *addQueue(const std::string &name, uint64_t maxPayloadSize,
+		                    size_t dispatchThreads = 0);
 		Queue *getQueue(const std::string &name,
 		                const Wired::Socket::IPAddress &remoteAddress) const;
 		const QueueItem *getQueue(const std::string &name) const;
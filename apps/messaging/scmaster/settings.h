@@ -55,14 +55,42 @@ struct Settings : Seiscomp::System::Application::AbstractSettings {
 	std::vector<std::string> defaultGroups;
 
 	struct Queue {
-		Queue() : maxPayloadSize(DEFAULT_MAX_WS_PAYLOAD_SIZE) {}
+		Queue() : maxPayloadSize(DEFAULT_MAX_WS_PAYLOAD_SIZE), dispatchThreads(0) {}
 		std::string              name;
 		std::vector<std::string> groups;
 		Seiscomp::Wired::IPACL   acl; // Default 0.0.0.0/0
 		std::vector<std::string> plugins;
 		unsigned int             maxPayloadSize;
+		unsigned int             dispatchThreads;
+		bool                     latencyStatistics{false};
 		std::vector<std::string> messageProcessors;
 
+		struct MessageLog {
+			std::string  directory;
+			unsigned int segmentSize{64}; // MiB
+			unsigned int segments{16};
+
+			void accept(Seiscomp::System::Application::SettingsLinker &linker) {
+				linker
+				& cfgAsPath(directory, "directory")
+				& cfg(segmentSize, "segmentSize")
+				& cfg(segments, "segments");
+			}
+		} messageLog;
+
+		struct ClientLimits {
+			unsigned int maxBytes{0}; // KiB
+			unsigned int maxMessages{0};
+			std::string  policy{"disconnect"};
+
+			void accept(Seiscomp::System::Application::SettingsLinker &linker) {
+				linker
+				& cfg(maxBytes, "maxBytes")
+				& cfg(maxMessages, "maxMessages")
+				& cfg(policy, "policy");
+			}
+		} clientLimits;
+
 		struct DB {
 			std::string driver;
 			std::string parameters;
@@ -79,6 +107,10 @@ struct Settings : Seiscomp::System::Application::AbstractSettings {
 			& cfg(acl, "acl")
 			& cfg(plugins, "plugins")
 			& cfg(maxPayloadSize, "maxPayloadSize")
+			& cfg(dispatchThreads, "dispatchThreads")
+			& cfg(latencyStatistics, "latencyStatistics")
+			& cfg(messageLog, "messageLog")
+			& cfg(clientLimits, "clientLimits")
 			& cfg(messageProcessors, "processors.messages")
 			& cfg(dbstore, "processors.messages.dbstore");
 		}
@@ -89,11 +121,12 @@ struct Settings : Seiscomp::System::Application::AbstractSettings {
 	struct Interface {
 		Interface()
 		: bind(Seiscomp::Wired::Socket::IPAddress(0,0,0,0), 18180)
-		, socketPortReuse(true) {}
+		, socketPortReuse(true), ioBackend("native") {}
 
 		BindAddress            bind;
 		Seiscomp::Wired::IPACL acl; // Default empty
 		bool                   socketPortReuse;
+		std::string            ioBackend;
 
 		struct SSL {
 			SSL() {}
@@ -117,30 +150,46 @@ struct Settings : Seiscomp::System::Application::AbstractSettings {
 			}
 		} ssl;
 
+		struct Local {
+			// The path of the local socket, empty to disable it
+			std::string            path;
+			// Local clients are reported as 127.0.0.1 and not restricted
+			Seiscomp::Wired::IPACL acl;
+
+			void accept(Seiscomp::System::Application::SettingsLinker &linker) {
+				linker
+				& cfgAsPath(path, "path");
+			}
+		} local;
+
 		void accept(Seiscomp::System::Application::SettingsLinker &linker) {
 			linker
 			& cfg(bind, "bind")
 			& cli(bind, "Wired", "bind", "The non encrypted bind address in format [ip:]port")
 			& cfg(acl, "acl")
 			& cfg(socketPortReuse, "socketPortReuse")
-			& cfg(ssl, "ssl");
+			& cfg(ioBackend, "ioBackend")
+			& cfg(ssl, "ssl")
+			& cfg(local, "local");
 		}
 	} interface;
 
 	struct HTTP {
 		HTTP()
 		: filebase(Seiscomp::Environment::Instance()->absolutePath("@DATADIR@/scmaster/http/"))
-		, staticPath("/"), brokerPath("/") {}
+		, staticPath("/"), brokerPath("/"), websocketCompression(false) {}
 
 		std::string filebase;
 		std::string staticPath;
 		std::string brokerPath;
+		bool        websocketCompression;
 
 		void accept(Seiscomp::System::Application::SettingsLinker &linker) {
 			linker
 			& cfgAsPath(filebase, "filebase")
 			& cfg(staticPath, "staticPath")
-			& cfg(brokerPath, "brokerPath");
+			& cfg(brokerPath, "brokerPath")
+			& cfg(websocketCompression, "websocketCompression");
 		}
 	} http;
 
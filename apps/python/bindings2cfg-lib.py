@@ -48,6 +48,12 @@ def collect(idset, paramSetID):
 
 
 def sync(paramSet, params):
+    """
+    Synchronizes the parameters of an existing parameter set with the
+    generated parameters. Only parameters which differ are touched and
+    generate notifiers. Returns the number of changes.
+    """
+    changes = 0
     obsoleteParams = []
     seenParams = {}
     i = 0
@@ -60,18 +66,21 @@ def sync(paramSet, params):
                     f"- {p.publicID()}:{p.name()} / duplicate parameter name\n"
                 )
                 p.detach()
+                changes += 1
                 continue
             seenParams[p.name()] = 1
             val = params[p.name()]
             if val != p.value():
                 p.setValue(val)
                 p.update()
+                changes += 1
         else:
             obsoleteParams.append(p)
         i = i + 1
 
     for p in obsoleteParams:
         p.detach()
+        changes += 1
 
     for key, val in list(params.items()):
         if key in seenParams:
@@ -80,6 +89,9 @@ def sync(paramSet, params):
         p.setName(key)
         p.setValue(val)
         paramSet.add(p)
+        changes += 1
+
+    return changes
 
 
 class ConfigDBUpdater(seiscomp.client.Application):
@@ -376,7 +388,7 @@ Synchronize bindings configuration from key directory to a processing system
 
             for s in obsoleteSetups:
                 print(
-                    f"- {configMod.name()}/{cs.networkCode()}/{cs.stationCode()}/{setup.name()} "
+                    f"- {configMod.name()}/{cs.networkCode()}/{cs.stationCode()}/{s.name()} "
                     "/ obsolete station setup",
                     file=sys.stderr,
                 )
@@ -430,7 +442,13 @@ Synchronize bindings configuration from key directory to a processing system
                     paramSet.update()
 
                 # Synchronize existing parameterset with the new parameters
-                sync(paramSet, params)
+                changes = sync(paramSet, params)
+                if changes > 0:
+                    print(
+                        f"* {configMod.name()}/{cs.networkCode()}/{cs.stationCode()}/"
+                        f"{setup.name()} / {changes} parameter change(s)",
+                        file=sys.stderr,
+                    )
 
                 if setup.name() == "default":
                     globalSet = paramSet.publicID()
@@ -0,0 +1,215 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/logging/binary.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+using namespace Seiscomp;
+using namespace std;
+
+
+struct Location {
+	int    level{0};
+	int    line{0};
+	string channel;
+	string component;
+	string file;
+	string function;
+};
+
+
+class Reader {
+	public:
+		Reader(const char *data, size_t size) : _p(data), _end(data + size) {}
+
+		bool atEnd() const { return _p >= _end; }
+		size_t left() const { return _end - _p; }
+
+		template <typename T>
+		bool get(T &value) {
+			if ( left() < sizeof(T) ) return false;
+			memcpy(&value, _p, sizeof(T));
+			_p += sizeof(T);
+			return true;
+		}
+
+		bool get(string &value, size_t len) {
+			if ( left() < len ) return false;
+			value.assign(_p, len);
+			_p += len;
+			return true;
+		}
+
+		bool getString(string &value) {
+			uint16_t len;
+			return get(len) && get(value, len);
+		}
+
+	private:
+		const char *_p;
+		const char *_end;
+};
+
+
+void printTime(int64_t us, bool utc) {
+	time_t secs = static_cast<time_t>(us / 1000000);
+	tm t = utc ? *gmtime(&secs) : *localtime(&secs);
+	char buf[64];
+	strftime(buf, sizeof(buf), "%Y/%m/%d %H:%M:%S", &t);
+	char frac[16];
+	snprintf(frac, sizeof(frac), ".%06d", static_cast<int>(us % 1000000));
+	cout << buf << frac;
+}
+
+
+bool decode(const char *filename, bool utc, bool context) {
+	ifstream ifs(filename, ios_base::in | ios_base::binary);
+	if ( !ifs.is_open() ) {
+		cerr << filename << ": could not open file" << endl;
+		return false;
+	}
+
+	string data((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+
+	Logging::BinaryOutput::FileHeader header;
+	if ( data.size() < sizeof(header) ) {
+		cerr << filename << ": file too small" << endl;
+		return false;
+	}
+
+	memcpy(&header, data.data(), sizeof(header));
+	if ( memcmp(header.magic, Logging::BinaryOutput::Magic, sizeof(header.magic)) ) {
+		cerr << filename << ": not a binary log file" << endl;
+		return false;
+	}
+
+	if ( header.version != Logging::BinaryOutput::Version ) {
+		cerr << filename << ": unsupported version " << header.version << endl;
+		return false;
+	}
+
+	size_t used = min(static_cast<size_t>(header.used), data.size());
+	Reader file(data.data() + sizeof(header), used - sizeof(header));
+	vector<Location> locations;
+
+	while ( !file.atEnd() ) {
+		uint32_t size;
+		uint8_t type;
+		if ( !file.get(size) || size < 5 || file.left() < size - 4 ) {
+			cerr << filename << ": truncated record" << endl;
+			return false;
+		}
+
+		string payload;
+		file.get(payload, size - 4);
+		Reader rec(payload.data(), payload.size());
+		rec.get(type);
+
+		if ( type == Logging::BinaryOutput::LocationRecord ) {
+			uint32_t id, line;
+			uint8_t level;
+			Location loc;
+			if ( !rec.get(id) || !rec.get(level) || !rec.get(line)
+			  || !rec.getString(loc.channel) || !rec.getString(loc.component)
+			  || !rec.getString(loc.file) || !rec.getString(loc.function) ) {
+				cerr << filename << ": invalid location record" << endl;
+				return false;
+			}
+
+			loc.level = level;
+			loc.line = static_cast<int>(line);
+			if ( id >= locations.size() ) locations.resize(id + 1);
+			locations[id] = loc;
+		}
+		else if ( type == Logging::BinaryOutput::MessageRecord ) {
+			uint32_t id, len;
+			int64_t time;
+			string msg;
+			if ( !rec.get(id) || !rec.get(time) || !rec.get(len) || !rec.get(msg, len) ) {
+				cerr << filename << ": invalid message record" << endl;
+				return false;
+			}
+
+			printTime(time, utc);
+
+			if ( id < locations.size() ) {
+				const Location &loc = locations[id];
+				cout << " [" << loc.channel << "/" << loc.component << "] ";
+				if ( context ) {
+					cout << "(" << loc.file << ':' << loc.line << ") ";
+				}
+			}
+			else {
+				cout << " [unknown] ";
+			}
+
+			cout << msg << '\n';
+		}
+		// Unknown record types are skipped
+	}
+
+	return true;
+}
+
+
+int main(int argc, char **argv) {
+	bool utc = false;
+	bool context = false;
+	vector<const char*> files;
+
+	for ( int i = 1; i < argc; ++i ) {
+		if ( !strcmp(argv[i], "-h") || !strcmp(argv[i], "--help") ) {
+			files.clear();
+			break;
+		}
+		else if ( !strcmp(argv[i], "-u") || !strcmp(argv[i], "--utc") )
+			utc = true;
+		else if ( !strcmp(argv[i], "-c") || !strcmp(argv[i], "--context") )
+			context = true;
+		else
+			files.push_back(argv[i]);
+	}
+
+	if ( files.empty() ) {
+		cout << "Usage:" << endl << "  sclogdecode [-u] [-c] file [file ...]" << endl
+		     << endl << "Render binary log files as text" << endl
+		     << endl << "Options:" << endl
+		     << "  -u, --utc      Print times in UTC instead of local time" << endl
+		     << "  -c, --context  Print source file and line number" << endl
+		     << endl;
+		return EXIT_FAILURE;
+	}
+
+	for ( auto file : files ) {
+		if ( !decode(file, utc, context) )
+			return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
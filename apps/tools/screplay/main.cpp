@@ -0,0 +1,293 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT Replay
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/client/streamapplication.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/math/filter.h>
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+typedef chrono::steady_clock Clock;
+
+
+class Replay : public Client::StreamApplication {
+	public:
+		Replay(int argc, char **argv) : Client::StreamApplication(argc, argv) {
+			setMessagingEnabled(false);
+			setDatabaseEnabled(false, false);
+			setLoadInventoryEnabled(false);
+			setPrimaryMessagingGroup("PICK");
+			setRecordDatatype(Array::DOUBLE);
+			setLatencyStatisticsEnabled(true);
+			bindSettings(&_settings);
+		}
+
+
+	protected:
+		struct Settings : AbstractSettings {
+			double      speed{1.0};
+			std::string filter{"RMHP(10)>>ITAPER(30)>>BW(4,0.7,2)>>STALTA(2,80)"};
+			double      triggerOn{3.0};
+			double      triggerOff{1.5};
+			bool        send{false};
+
+			void accept(SettingsLinker &linker) override {
+				linker
+				& cli(
+					speed, "Replay", "speed",
+					"Replay speed relative to real time, 0 replays as fast "
+					"as possible",
+					true
+				)
+				& cli(
+					filter, "Replay", "filter",
+					"The filter applied to each stream, its output is "
+					"compared against the trigger thresholds",
+					true
+				)
+				& cli(triggerOn, "Replay", "trigger-on", "The trigger on threshold", true)
+				& cli(triggerOff, "Replay", "trigger-off", "The trigger off threshold", true)
+				& cli(
+					send, "Replay", "send",
+					"Sends the created picks to the messaging",
+					false, true
+				);
+			}
+		};
+
+		struct Stream {
+			Math::Filtering::InPlaceFilter<double> *filter{nullptr};
+			double                                  fsamp{0};
+			Core::Time                              lastEndTime;
+			bool                                    triggered{false};
+
+			Stream() = default;
+			Stream(const Stream &) = delete;
+			~Stream() { delete filter; }
+		};
+
+
+	protected:
+		bool validateParameters() override {
+			if ( !Client::StreamApplication::validateParameters() ) {
+				return false;
+			}
+
+			if ( _settings.speed < 0 ) {
+				cerr << "Speed must not be negative" << endl;
+				return false;
+			}
+
+			if ( _settings.send ) {
+				setMessagingEnabled(true);
+			}
+
+			string error;
+			Math::Filtering::InPlaceFilter<double> *filter =
+				Math::Filtering::InPlaceFilter<double>::Create(_settings.filter, &error);
+			if ( !filter ) {
+				cerr << "Invalid filter: " << error << endl;
+				return false;
+			}
+
+			delete filter;
+			return true;
+		}
+
+		bool run() override {
+			_startTime = Clock::now();
+			return Client::StreamApplication::run();
+		}
+
+		// Called in the acquisition thread
+		bool storeRecord(Record *rec) override {
+			if ( _settings.speed > 0 ) {
+				if ( !_firstRecordTime ) {
+					_firstRecordTime = rec->startTime();
+					_replayStart = Clock::now();
+				}
+				else {
+					double offset = (rec->startTime() - *_firstRecordTime).length() / _settings.speed;
+					this_thread::sleep_until(
+						_replayStart + chrono::duration_cast<Clock::duration>(chrono::duration<double>(offset))
+					);
+				}
+			}
+
+			{
+				lock_guard<mutex> lock(_stampsMutex);
+				_stamps.push_back(Clock::now());
+			}
+
+			return Client::StreamApplication::storeRecord(rec);
+		}
+
+		void handleRecord(Record *rec) override {
+			RecordPtr tmp(rec);
+			Clock::time_point now = Clock::now();
+
+			{
+				lock_guard<mutex> lock(_stampsMutex);
+				if ( !_stamps.empty() ) {
+					push("queue", now - _stamps.front());
+					_stamps.pop_front();
+				}
+			}
+
+			const DoubleArray *data = DoubleArray::ConstCast(rec->data());
+			if ( !data || !data->size() ) {
+				return;
+			}
+
+			++_records;
+			_samples += data->size();
+
+			Stream &stream = _streams[rec->streamID()];
+			if ( !stream.filter || stream.fsamp != rec->samplingFrequency() ||
+			     (stream.lastEndTime.valid() &&
+			      fabs((rec->startTime() - stream.lastEndTime).length()) > 0.5 / rec->samplingFrequency()) ) {
+				delete stream.filter;
+				stream.filter = Math::Filtering::InPlaceFilter<double>::Create(_settings.filter);
+				stream.filter->setSamplingFrequency(rec->samplingFrequency());
+				stream.fsamp = rec->samplingFrequency();
+				stream.triggered = false;
+			}
+
+			stream.lastEndTime = rec->endTime();
+
+			// The filter works inplace, the record data must not change
+			DoubleArray filtered(*data);
+
+			Clock::time_point start = Clock::now();
+			stream.filter->apply(filtered.size(), filtered.typedData());
+			push("filter", Clock::now() - start);
+
+			start = Clock::now();
+			for ( int i = 0; i < filtered.size(); ++i ) {
+				double value = filtered[i];
+				if ( !stream.triggered ) {
+					if ( value < _settings.triggerOn ) {
+						continue;
+					}
+
+					stream.triggered = true;
+					emitPick(rec, rec->startTime() + Core::TimeSpan(i / rec->samplingFrequency()));
+					++_picks;
+				}
+				else if ( value < _settings.triggerOff ) {
+					stream.triggered = false;
+				}
+			}
+			push("pick", Clock::now() - start);
+		}
+
+		void done() override {
+			double elapsed = chrono::duration<double>(Clock::now() - _startTime).count();
+
+			cout << "Replayed " << _records << " records with " << _samples
+			     << " samples of " << _streams.size() << " streams in "
+			     << fixed << setprecision(3) << elapsed << " s" << endl;
+			if ( elapsed > 0 ) {
+				cout << "Throughput: " << setprecision(1) << _records / elapsed
+				     << " records/s, " << _samples / elapsed << " samples/s" << endl;
+			}
+			cout << "Created " << _picks << " picks" << endl;
+
+			if ( latencyMonitor() ) {
+				latencyMonitor()->dump(cout);
+			}
+
+			_streams.clear();
+			Client::StreamApplication::done();
+		}
+
+
+	private:
+		void push(const char *stage, Clock::duration d) {
+			if ( latencyMonitor() ) {
+				latencyMonitor()->push(stage, chrono::duration<double>(d).count());
+			}
+		}
+
+		void emitPick(const Record *rec, const Core::Time &time) {
+			DataModel::PickPtr pick = DataModel::Pick::Create();
+			pick->setTime(DataModel::TimeQuantity(time));
+			pick->setWaveformID(
+				DataModel::WaveformStreamID(
+					rec->networkCode(), rec->stationCode(),
+					rec->locationCode(), rec->channelCode(), ""
+				)
+			);
+			pick->setFilterID(_settings.filter);
+			pick->setEvaluationMode(DataModel::EvaluationMode(DataModel::AUTOMATIC));
+
+			SEISCOMP_DEBUG("Pick %s at %s", rec->streamID().c_str(), time.iso().c_str());
+
+			if ( !_settings.send || !connection() ) {
+				return;
+			}
+
+			DataModel::NotifierMessagePtr msg = new DataModel::NotifierMessage;
+			msg->attach(new DataModel::Notifier("EventParameters", DataModel::OP_ADD, pick.get()));
+			send(primaryMessagingGroup(), msg.get());
+		}
+
+
+	private:
+		Settings                         _settings;
+		map<string, Stream>              _streams;
+		mutex                            _stampsMutex;
+		deque<Clock::time_point>         _stamps;
+		OPT(Core::Time)                  _firstRecordTime;
+		Clock::time_point                _replayStart;
+		Clock::time_point                _startTime;
+		size_t                           _records{0};
+		size_t                           _samples{0};
+		size_t                           _picks{0};
+};
+
+
+}
+
+
+int main(int argc, char **argv) {
+	Replay app(argc, argv);
+	return app();
+}
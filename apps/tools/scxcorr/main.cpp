@@ -0,0 +1,478 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT XCorr
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/client/application.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/datamodel/databasequery.h>
+#include <seiscomp/datamodel/event.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/io/recordinput.h>
+#include <seiscomp/math/filter.h>
+#include <seiscomp/math/geo.h>
+#include <seiscomp/processing/crosscorrelation.h>
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <set>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+// The data fetched before and after each window to let the filter settle
+const double FilterMargin = 10.0;
+
+
+class XCorr : public Client::Application {
+	public:
+		XCorr(int argc, char **argv) : Client::Application(argc, argv) {
+			setMessagingEnabled(false);
+			setDatabaseEnabled(true, false);
+			setLoadInventoryEnabled(false);
+			bindSettings(&_settings);
+		}
+
+
+	protected:
+		struct Settings : AbstractSettings {
+			std::string begin;
+			std::string end;
+			std::string events;
+			std::string phases{"P,S"};
+			double      pre{1.0};
+			double      post{2.0};
+			std::string filter{"BW(3,1,10)"};
+			double      maxDelay{0.5};
+			double      minCoefficient{0.7};
+			int         upsampling{8};
+			int         threads{0};
+			double      maxDistance{0};
+			std::string cacheDir;
+			bool        noCache{false};
+			std::string output{"-"};
+
+			void accept(SettingsLinker &linker) override {
+				linker
+				& cli(begin, "Events", "begin", "The start time of the events")
+				& cli(end, "Events", "end", "The end time of the events")
+				& cli(
+					events, "Events", "event,E",
+					"A comma separated list of event IDs, overrides the "
+					"time range"
+				)
+				& cli(
+					maxDistance, "Events", "max-distance",
+					"The maximum distance of two events in km to be "
+					"correlated, 0 disables the limit",
+					true
+				)
+				& cli(phases, "Correlation", "phases", "The phases to correlate", true)
+				& cli(pre, "Correlation", "pre", "The window length before the pick in seconds", true)
+				& cli(post, "Correlation", "post", "The window length after the pick in seconds", true)
+				& cli(filter, "Correlation", "filter", "The filter applied to the waveforms", true)
+				& cli(
+					maxDelay, "Correlation", "max-delay",
+					"The maximum delay of a phase relative to its pick in "
+					"seconds",
+					true
+				)
+				& cli(
+					minCoefficient, "Correlation", "min-coefficient",
+					"The minimum correlation coefficient of a result",
+					true
+				)
+				& cli(
+					upsampling, "Correlation", "upsampling",
+					"The interpolation factor of the correlation function",
+					true
+				)
+				& cli(
+					threads, "Correlation", "threads",
+					"The number of threads, 0 uses all cores",
+					true
+				)
+				& cli(
+					cacheDir, "Records", "cache-dir",
+					"The directory of the waveform cache"
+				)
+				& cli(
+					noCache, "Records", "no-cache",
+					"Reads the waveforms directly from the record stream",
+					false, true
+				)
+				& cli(output, "Output", "output,o", "The output file, '-' is stdout", true);
+			}
+		};
+
+		struct EventInfo {
+			std::string id;
+			Core::Time  time;
+			double      latitude;
+			double      longitude;
+		};
+
+		struct Request {
+			size_t                      event;
+			std::string                 streamID;
+			std::string                 phase;
+			Core::Time                  pickTime;
+			DataModel::WaveformStreamID waveformID;
+			Core::TimeWindow            timeWindow;
+		};
+
+
+	protected:
+		bool validateParameters() override {
+			if ( !Client::Application::validateParameters() ) {
+				return false;
+			}
+
+			if ( _settings.events.empty() ) {
+				if ( !Core::fromString(_begin, _settings.begin) ||
+				     !Core::fromString(_end, _settings.end) ) {
+					cerr << "Either --event or a valid --begin and --end are required" << endl;
+					return false;
+				}
+			}
+
+			if ( _settings.pre < 0 || _settings.post <= 0 ) {
+				cerr << "Invalid window: pre must not be negative and post must be positive" << endl;
+				return false;
+			}
+
+			Core::split(_phases, _settings.phases, ",");
+			if ( _phases.empty() ) {
+				cerr << "No phases given" << endl;
+				return false;
+			}
+
+			string error;
+			std::unique_ptr<Math::Filtering::InPlaceFilter<double>> filter(
+				Math::Filtering::InPlaceFilter<double>::Create(_settings.filter, &error)
+			);
+			if ( !filter ) {
+				cerr << "Invalid filter: " << error << endl;
+				return false;
+			}
+
+			return true;
+		}
+
+		bool run() override {
+			if ( !loadEvents() ) {
+				return false;
+			}
+
+			SEISCOMP_INFO("Loaded %zu events with %zu picks",
+			              _events.size(), _requests.size());
+
+			if ( !loadWaveforms() ) {
+				return false;
+			}
+
+			SEISCOMP_INFO("Correlating %zu windows", _correlator.windowCount());
+
+			_correlator.setMaximumDelay(_settings.maxDelay);
+			_correlator.setMinimumCoefficient(_settings.minCoefficient);
+			_correlator.setUpsampling(_settings.upsampling);
+			_correlator.setThreads(_settings.threads);
+
+			if ( _settings.maxDistance > 0 ) {
+				_correlator.setPairFilter([this](const Processing::CrossCorrelator::Window &w1,
+				                                 const Processing::CrossCorrelator::Window &w2) {
+					// Called concurrently, the index must not be modified
+					const EventInfo &e1 = _events[_eventIndex.at(w1.eventID)];
+					const EventInfo &e2 = _events[_eventIndex.at(w2.eventID)];
+					double dist = Math::Geo::delta(e1.latitude, e1.longitude,
+					                               e2.latitude, e2.longitude);
+					return Math::Geo::deg2km(dist) <= _settings.maxDistance;
+				});
+			}
+
+			_correlator.compute();
+
+			SEISCOMP_INFO("Measured %zu differential times", _correlator.results().size());
+
+			return writeResults();
+		}
+
+
+	private:
+		bool loadEvents() {
+			vector<DataModel::EventPtr> events;
+
+			if ( !_settings.events.empty() ) {
+				vector<string> ids;
+				Core::split(ids, _settings.events, ",");
+				for ( const string &id : ids ) {
+					DataModel::EventPtr event = DataModel::Event::Cast(
+						query()->getObject(DataModel::Event::TypeInfo(), id)
+					);
+					if ( !event ) {
+						SEISCOMP_WARNING("Event %s not found", id.c_str());
+						continue;
+					}
+
+					events.push_back(event);
+				}
+			}
+			else {
+				// The iterator must be finished before the next query
+				DataModel::DatabaseIterator it = query()->getEvents(_begin, _end);
+				for ( ; *it; ++it ) {
+					DataModel::EventPtr event = DataModel::Event::Cast(*it);
+					if ( event ) events.push_back(event);
+				}
+			}
+
+			set<string> phases(_phases.begin(), _phases.end());
+
+			for ( const DataModel::EventPtr &event : events ) {
+				DataModel::OriginPtr origin = DataModel::Origin::Cast(
+					query()->getObject(DataModel::Origin::TypeInfo(), event->preferredOriginID())
+				);
+				if ( !origin ) {
+					SEISCOMP_WARNING("%s: preferred origin not found", event->publicID().c_str());
+					continue;
+				}
+
+				query()->loadArrivals(origin.get());
+
+				map<string, DataModel::PickPtr> picks;
+				DataModel::DatabaseIterator it = query()->getPicks(origin->publicID());
+				for ( ; *it; ++it ) {
+					DataModel::Pick *pick = DataModel::Pick::Cast(*it);
+					if ( pick ) picks[pick->publicID()] = pick;
+				}
+
+				EventInfo info;
+				info.id = event->publicID();
+				info.time = origin->time().value();
+				info.latitude = origin->latitude().value();
+				info.longitude = origin->longitude().value();
+
+				_eventIndex[info.id] = _events.size();
+				_events.push_back(info);
+
+				for ( size_t i = 0; i < origin->arrivalCount(); ++i ) {
+					DataModel::Arrival *arrival = origin->arrival(i);
+					if ( !phases.count(arrival->phase().code()) ) continue;
+
+					auto pit = picks.find(arrival->pickID());
+					if ( pit == picks.end() ) continue;
+
+					const DataModel::Pick *pick = pit->second.get();
+					const DataModel::WaveformStreamID &wid = pick->waveformID();
+
+					Request req;
+					req.event = _events.size()-1;
+					req.streamID = wid.networkCode() + "." + wid.stationCode() + "." +
+					               wid.locationCode() + "." + wid.channelCode();
+					req.phase = arrival->phase().code();
+					req.pickTime = pick->time().value();
+					req.waveformID = wid;
+					req.timeWindow = Core::TimeWindow(
+						req.pickTime - Core::TimeSpan(_settings.pre + FilterMargin),
+						req.pickTime + Core::TimeSpan(_settings.post + FilterMargin)
+					);
+					_requests.push_back(req);
+				}
+			}
+
+			return true;
+		}
+
+		bool loadWaveforms() {
+			string url = recordStreamURL();
+			if ( !_settings.noCache && url.compare(0, 8, "cache://") ) {
+				// scheme://source becomes cache://scheme/source
+				size_t pos = url.find("://");
+				if ( pos == string::npos ) {
+					cerr << "Invalid record stream URL: " << url << endl;
+					return false;
+				}
+
+				url = "cache://" + url.substr(0, pos) + "/" + url.substr(pos+3);
+				if ( !_settings.cacheDir.empty() ) {
+					url += "??dir=" + _settings.cacheDir;
+				}
+			}
+
+			IO::RecordStreamPtr rs = IO::RecordStream::Open(url.c_str());
+			if ( !rs ) {
+				SEISCOMP_ERROR("Failed to open record stream %s", url.c_str());
+				return false;
+			}
+
+			vector<std::unique_ptr<TimeWindowBuffer>> buffers;
+			map<string, vector<size_t>> streams;
+
+			for ( size_t i = 0; i < _requests.size(); ++i ) {
+				const Request &req = _requests[i];
+				rs->addStream(req.waveformID.networkCode(), req.waveformID.stationCode(),
+				              req.waveformID.locationCode(), req.waveformID.channelCode(),
+				              req.timeWindow.startTime(), req.timeWindow.endTime());
+				buffers.emplace_back(new TimeWindowBuffer(req.timeWindow));
+				streams[req.streamID].push_back(i);
+			}
+
+			IO::RecordInput input(rs.get(), Array::DOUBLE, Record::DATA_ONLY);
+			for ( IO::RecordIterator it = input.begin(); it != input.end(); ++it ) {
+				RecordPtr rec = *it;
+				if ( !rec ) continue;
+
+				auto sit = streams.find(rec->streamID());
+				if ( sit == streams.end() ) continue;
+
+				for ( size_t idx : sit->second ) {
+					buffers[idx]->feed(rec.get());
+				}
+
+				if ( isExitRequested() ) {
+					return false;
+				}
+			}
+
+			for ( size_t i = 0; i < _requests.size(); ++i ) {
+				const Request &req = _requests[i];
+
+				GenericRecordPtr seq = buffers[i]->contiguousRecord<double>();
+				buffers[i].reset();
+				if ( !seq || !seq->data() ) {
+					SEISCOMP_DEBUG("%s: no data for %s", _events[req.event].id.c_str(),
+					               req.streamID.c_str());
+					continue;
+				}
+
+				DoubleArray *data = DoubleArray::Cast(seq->data());
+				double fsamp = seq->samplingFrequency();
+
+				std::unique_ptr<Math::Filtering::InPlaceFilter<double>> filter(
+					Math::Filtering::InPlaceFilter<double>::Create(_settings.filter)
+				);
+				filter->setSamplingFrequency(fsamp);
+				filter->apply(data->size(), data->typedData());
+
+				int offset = static_cast<int>(round(
+					(double)(req.pickTime - Core::TimeSpan(_settings.pre) - seq->startTime()) * fsamp
+				));
+				int length = static_cast<int>(round((_settings.pre + _settings.post) * fsamp));
+
+				// At least half of the margin is required to let the filter
+				// settle
+				if ( offset < 0.5 * FilterMargin * fsamp || offset + length > data->size() ) {
+					SEISCOMP_DEBUG("%s: incomplete data for %s", _events[req.event].id.c_str(),
+					               req.streamID.c_str());
+					continue;
+				}
+
+				Processing::CrossCorrelator::Window window;
+				window.eventID = _events[req.event].id;
+				window.streamID = req.streamID;
+				window.phase = req.phase;
+				window.reference = req.pickTime;
+				window.startTime = seq->startTime() + Core::TimeSpan(offset / fsamp);
+				window.samplingFrequency = fsamp;
+				window.data.setData(length, data->typedData() + offset);
+
+				int index = _correlator.add(window);
+				if ( index >= 0 ) {
+					_windowStations.resize(index+1);
+					_windowStations[index] = req.waveformID.stationCode();
+				}
+			}
+
+			return true;
+		}
+
+		bool writeResults() {
+			FILE *fp = stdout;
+			if ( _settings.output != "-" ) {
+				fp = fopen(_settings.output.c_str(), "w");
+				if ( !fp ) {
+					SEISCOMP_ERROR("Failed to open %s", _settings.output.c_str());
+					return false;
+				}
+			}
+
+			// The results grouped by event pair in the order of the events
+			typedef pair<size_t, size_t> EventPair;
+			map<EventPair, vector<const Processing::CrossCorrelator::Result*>> pairs;
+			for ( const auto &r : _correlator.results() ) {
+				pairs[EventPair(_eventIndex[_correlator.window(r.first).eventID],
+				                _eventIndex[_correlator.window(r.second).eventID])].push_back(&r);
+			}
+
+			for ( const auto &item : pairs ) {
+				const EventInfo &e1 = _events[item.first.first];
+				const EventInfo &e2 = _events[item.first.second];
+				fprintf(fp, "# %s %s 0.0\n", e1.id.c_str(), e2.id.c_str());
+
+				for ( const auto *r : item.second ) {
+					const auto &w1 = _correlator.window(r->first);
+					const auto &w2 = _correlator.window(r->second);
+					// The differential travel time of the phase
+					double dt = (double)(w1.reference - e1.time) -
+					            ((double)(w2.reference - e2.time) + r->delay);
+					fprintf(fp, "%-7s %9.4f %6.4f %s\n", _windowStations[r->first].c_str(),
+					        dt, r->coefficient, w1.phase.c_str());
+				}
+			}
+
+			if ( fp != stdout ) {
+				fclose(fp);
+			}
+
+			return true;
+		}
+
+
+	private:
+		Settings                         _settings;
+		Core::Time                       _begin;
+		Core::Time                       _end;
+		vector<string>                   _phases;
+		vector<EventInfo>                _events;
+		map<string, size_t>              _eventIndex;
+		vector<Request>                  _requests;
+		vector<string>                   _windowStations;
+		Processing::CrossCorrelator      _correlator;
+};
+
+
+}
+
+
+int main(int argc, char **argv) {
+	XCorr app(argc, argv);
+	return app();
+}
@@ -27,6 +27,7 @@
 #include <seiscomp/utils/files.h>
 
 #include "app.h"
+#include "planner.h"
 #include "settings.h"
 
 
@@ -60,6 +61,8 @@ bool Application::init() {
 	global.dcid = agencyID();
 
 	_server.setTriggerMode(Wired::DeviceGroup::LevelTriggered);
+	if ( global.workers > 0 )
+		_server.setWorkerCount(static_cast<size_t>(global.workers));
 
 	Wired::IPACL globalAllow, globalDeny;
 
@@ -71,6 +74,15 @@ bool Application::init() {
 		_server.addEndpoint(Wired::Socket::IPAddress(), global.fdsnws.port, false,
 		                    new FDSNWSListener(globalAllow, globalDeny));
 
+	if ( global.fdsnws.port > 0 && global.fdsnws.passthrough &&
+	     global.sdsBackend.empty() && global.fdsnws.readers > 0 )
+		SegmentReader::Instance().start(static_cast<size_t>(global.fdsnws.readers));
+
+	if ( global.fdsnws.port > 0 && global.sdsBackend.empty() &&
+	     global.fdsnws.availabilityInterval > 0 )
+		_availabilityUpdater.start(global.fdsnws.availabilityInterval,
+		                           global.fdsnws.pyramidLevels);
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -103,6 +115,8 @@ void Application::done() {
 	SEISCOMP_INFO("Shutdown server");
 	_server.shutdown();
 	_server.clear();
+	SegmentReader::Instance().stop();
+	_availabilityUpdater.stop();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
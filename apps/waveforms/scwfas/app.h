@@ -24,6 +24,7 @@
 #include <seiscomp/client/application.h>
 #include <seiscomp/wired/ipacl.h>
 
+#include "availability.h"
 #include "server.h"
 #include "session.h"
 #include "version.h"
@@ -50,7 +51,8 @@ class Application : public Seiscomp::Client::Application {
 		}
 
 	private:
-		Server _server;
+		Server              _server;
+		AvailabilityUpdater _availabilityUpdater;
 };
 
 
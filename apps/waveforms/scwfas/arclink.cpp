@@ -264,7 +264,7 @@ void ArclinkSession::handleInbox(const char *src_data, size_t data_len) {
 				}
 
 				size_t id;
-				if ( !fromString(id, std::string(data, len)) ) {
+				if ( !fromChars(id, std::string_view(data, len)) ) {
 					sendError("invalid request id");
 					return;
 				}
@@ -292,10 +292,8 @@ void ArclinkSession::handleInbox(const char *src_data, size_t data_len) {
 					return;
 				}
 
-				string tmp;
-				tmp.assign(data, len);
 				size_t id;
-				if ( !fromString(id, tmp) ) {
+				if ( !fromChars(id, std::string_view(data, len)) ) {
 					sendError("PURGE: invalid ID format");
 					return;
 				}
@@ -0,0 +1,142 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * Author: Jan Becker                                                      *
+ * Email: jabe@gempa.de                                                    *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include "availability.h"
+#include "settings.h"
+
+#define SEISCOMP_COMPONENT WFAS
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/io/recordstream/pyramid.h>
+#include <seiscomp/io/recordstream/sdsavailability.h>
+#include <seiscomp/system/environment.h>
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace Applications {
+namespace Wfas {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+vector<string> archiveRoots() {
+	string src = global.filebase;
+	size_t pos = src.find('?');
+	if ( pos != string::npos )
+		src.erase(pos);
+
+	vector<string> roots;
+	if ( src.empty() )
+		roots.push_back(Environment::Instance()->installDir() + "/var/lib/archive");
+	else
+		Core::split(roots, src.c_str(), ",");
+
+	for ( string &root : roots )
+		root = Environment::Instance()->absolutePath(root);
+
+	return roots;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AvailabilityUpdater::~AvailabilityUpdater() {
+	stop();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AvailabilityUpdater::start(int interval, const vector<int> &pyramidLevels) {
+	stop();
+
+	_interval = interval;
+	_pyramidLevels = pyramidLevels;
+	_stopped = false;
+	_thread = thread(&AvailabilityUpdater::run, this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AvailabilityUpdater::stop() {
+	{
+		lock_guard<mutex> l(_mutex);
+		_stopped = true;
+	}
+
+	_wakeup.notify_all();
+	if ( _thread.joinable() )
+		_thread.join();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AvailabilityUpdater::run() {
+	vector<string> roots = archiveRoots();
+	unique_lock<mutex> l(_mutex);
+
+	while ( !_stopped ) {
+		l.unlock();
+
+		for ( const string &root : roots ) {
+			RecordStream::SDSAvailability index(root);
+			bool loaded = index.load();
+
+			size_t changed = index.update();
+			SEISCOMP_DEBUG("%s: %zu day files changed", root.c_str(), changed);
+
+			if ( (changed > 0 || !loaded) && !index.save() )
+				SEISCOMP_WARNING("%s: failed to write availability index",
+				                 root.c_str());
+
+			if ( !_pyramidLevels.empty() ) {
+				RecordStream::DecimationPyramid pyramid(root, _pyramidLevels);
+				changed = pyramid.update();
+				SEISCOMP_DEBUG("%s: %zu day files decimated", root.c_str(), changed);
+			}
+		}
+
+		l.lock();
+		_wakeup.wait_for(l, chrono::seconds(_interval),
+		                 [this]() { return _stopped; });
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * Author: Jan Becker                                                      *
+ * Email: jabe@gempa.de                                                    *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_APPS_SCWSAS_AVAILABILITY_H__
+#define SEISCOMP_APPS_SCWSAS_AVAILABILITY_H__
+
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Applications {
+namespace Wfas {
+
+
+//! Returns the absolute archive roots of the configured filebase
+std::vector<std::string> archiveRoots();
+
+
+/**
+ * @brief The AvailabilityUpdater brings the availability index and
+ *        optionally the decimation levels of each archive root up to date
+ *        in a fixed interval.
+ */
+class AvailabilityUpdater {
+	public:
+		~AvailabilityUpdater();
+
+	public:
+		/**
+		 * @brief Starts the update thread, the first update is run
+		 *        immediately.
+		 * @param interval The update interval in seconds
+		 * @param pyramidLevels The decimation levels to update along with
+		 *                      the index, none if empty
+		 */
+		void start(int interval, const std::vector<int> &pyramidLevels = {});
+		void stop();
+
+	private:
+		void run();
+
+	private:
+		std::thread             _thread;
+		std::mutex              _mutex;
+		std::condition_variable _wakeup;
+		int                     _interval{0};
+		std::vector<int>        _pyramidLevels;
+		bool                    _stopped{false};
+};
+
+
+}
+}
+}
+
+
+#endif
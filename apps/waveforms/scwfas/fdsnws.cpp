@@ -21,6 +21,8 @@
  ***************************************************************************/
 
 #include "session.h"
+#include "availability.h"
+#include "planner.h"
 #include "settings.h"
 #include "version.h"
 #include "strings.h"
@@ -32,9 +34,14 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/client/inventory.h>
 #include <seiscomp/io/recordstream/sdsarchive.h>
+#include <seiscomp/io/recordstream/sdsavailability.h>
+#include <seiscomp/datamodel/dataextent.h>
+#include <seiscomp/datamodel/datasegment.h>
 #include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/wired/buffers/file.h>
 #include <seiscomp/wired/protocols/http.h>
 
+#include <algorithm>
 #include <iostream>
 #include <ctype.h>
 #include <cerrno>
@@ -125,16 +132,42 @@ char * toUpper(char *str) {
 } // ns anonymous
 
 
+// The size of the chunks if a segment cannot be sent with sendfile
+const size_t PassthroughChunkSize = 65536;
+
+
+/**
+ * Sends the records of a request as chunked response. If the stream is an
+ * SDS archive and passthrough is enabled, then the byte ranges of the day
+ * files are sent without decoding records. The session sends them with
+ * sendfile if supported by the socket, otherwise they are read in chunks.
+ * If the SegmentReader is running, the byte ranges of the request lines
+ * are looked up on its threads ahead of the response.
+ */
 DEFINE_SMARTPOINTER(ArchiveBuffer);
-struct ArchiveBuffer : Wired::Buffer {
+struct ArchiveBuffer : Wired::FileBuffer {
 	ArchiveBuffer(IO::RecordStream *in,
 	              Array::DataType dt = Array::DOUBLE,
 	              Record::Hint h = Record::SAVE_RAW)
 	: stream(in), input(in, dt, h) {
 		format = Wired::Buffer::Octetts;
+		if ( global.fdsnws.passthrough )
+			sds = dynamic_cast<RecordStream::SDSArchive*>(in);
+		if ( sds && SegmentReader::Instance().isRunning() )
+			planner.reset(new SegmentPlanner(static_cast<size_t>(global.fdsnws.readahead)));
+	}
+
+	void addStream(const RequestItem &item) {
+		stream->addStream(item.net, item.sta, item.loc, item.cha,
+		                  item.startTime, item.endTime);
+		if ( planner )
+			planner->add(item);
 	}
 
 	virtual bool updateBuffer() {
+		if ( sds )
+			return updateSegment();
+
 		if ( !stream )
 			return false;
 
@@ -189,6 +222,64 @@ struct ArchiveBuffer : Wired::Buffer {
 		return string::npos;
 	}
 
+	bool updateSegment() {
+		data.clear();
+		header.clear();
+
+		if ( fp ) {
+			// Continue the segment if it has not been sent with sendfile
+			off_t offset = ftello(fp);
+			if ( offset >= 0 && offset < fplen ) {
+				data.resize(min(static_cast<size_t>(fplen - offset), PassthroughChunkSize));
+				data.resize(fread(&data[0], 1, data.size(), fp));
+				if ( !data.empty() )
+					return true;
+
+				// The file has been truncated, the response cannot be
+				// completed
+				SEISCOMP_ERROR("%s: read error", segment.path.c_str());
+				fclose(fp);
+				fp = nullptr;
+				return false;
+			}
+
+			fclose(fp);
+			fp = nullptr;
+
+			// Terminate the chunk of the segment
+			header = "\r\n";
+		}
+
+		if ( !stream )
+			return false;
+
+		while ( pending || nextSegment() ) {
+			pending = false;
+
+			fp = fopen(segment.path.c_str(), "rb");
+			if ( !fp || fseeko(fp, segment.offset, SEEK_SET) != 0 ) {
+				SEISCOMP_WARNING("%s: %s", segment.path.c_str(), strerror(errno));
+				if ( fp ) {
+					fclose(fp);
+					fp = nullptr;
+				}
+				continue;
+			}
+
+			fplen = segment.offset + segment.length;
+
+			char tmp[20]; tmp[0] = '\0';
+			sprintf(tmp, "%zX\r\n", segment.length);
+			header += tmp;
+			return true;
+		}
+
+		// End of stream: close transfer block
+		stream = NULL;
+		header += "0\r\n\r\n";
+		return true;
+	}
+
 	/**
 	 * @brief Checks whether the stream has any record or not.
 	 *
@@ -201,6 +292,12 @@ struct ArchiveBuffer : Wired::Buffer {
 		if ( !stream )
 			return false;
 
+		if ( sds ) {
+			if ( !pending )
+				pending = nextSegment();
+			return pending;
+		}
+
 		try {
 			while ( !buffered ) {
 				RecordPtr rec = input.next();
@@ -220,9 +317,18 @@ struct ArchiveBuffer : Wired::Buffer {
 		return buffered != NULL;
 	}
 
+	bool nextSegment() {
+		return planner ? planner->next(segment) : sds->nextSegment(segment);
+	}
+
 	IO::RecordStreamPtr stream;
 	IO::RecordInput     input;
 	IO::MSeedRecordPtr  buffered;
+
+	RecordStream::SDSArchive              *sds{nullptr};
+	RecordStream::SDSArchive::FileSegment  segment;
+	bool                                   pending{false};
+	std::unique_ptr<SegmentPlanner>        planner;
 };
 
 
@@ -239,6 +345,8 @@ class FDSNWSSession : public Wired::HttpSession {
 
 	private:
 		ArchiveBuffer *createStreamBuffer();
+		bool handleAvailabilityRequest(Wired::HttpRequest &req,
+		                               Wired::URLPath &path);
 		void sendError(const string &path, const string &options,
 		               Wired::HttpStatus status, const char *msg = NULL);
 };
@@ -353,6 +461,9 @@ bool FDSNWSSession::handleGETRequest(Wired::HttpRequest &req) {
 		return true;
 	}
 
+	if ( path == "availability" )
+		return handleAvailabilityRequest(req, path);
+
 	if ( path != "dataselect" ) {
 		sendError(req.path, options, Wired::HTTP_404);
 		return true;
@@ -380,10 +491,9 @@ bool FDSNWSSession::handleGETRequest(Wired::HttpRequest &req) {
 		return true;
 	}
 	else if ( path == "application.wadl" ) {
-		static string wadl;
-
-		if ( wadl.empty() )
-			wadl = wadlDataselectPre + global.fdsnws.baseUrl + wadlDataselectPost;
+		// Sessions might be served by different threads, initialize the
+		// static only once
+		static string wadl = wadlDataselectPre + global.fdsnws.baseUrl + wadlDataselectPost;
 
 		sendResponse(wadl, Wired::HTTP_200, "text/plain");
 		return true;
@@ -403,31 +513,25 @@ bool FDSNWSSession::handleGETRequest(Wired::HttpRequest &req) {
 
 			if ( opts == Wired::URLOptionName("net") ||
 			     opts == Wired::URLOptionName("network")) {
-				vector<string> toks;
-				Core::split(toks, toUpper(opts.val), ",");
-				networks.insert(toks.begin(), toks.end());
+				for ( string_view tok : Core::Tokens(toUpper(opts.val), ",") )
+					networks.emplace(tok);
 			}
 			else if ( opts == Wired::URLOptionName("sta") ||
 			          opts == Wired::URLOptionName("station")) {
-				vector<string> toks;
-				Core::split(toks, toUpper(opts.val), ",");
-				stations.insert(toks.begin(), toks.end());
+				for ( string_view tok : Core::Tokens(toUpper(opts.val), ",") )
+					stations.emplace(tok);
 			}
 			else if ( opts == Wired::URLOptionName("loc") ||
 			          opts == Wired::URLOptionName("location")) {
-				vector<string> toks;
-				// Do not compress since empty location codes are valid
-				Core::split(toks, toUpper(opts.val), ",", false);
-				// Replace -- by empty location code
-				for ( vector<string>::const_iterator it = toks.begin();
-				      it != toks.end(); ++it )
-					locations.insert(*it == "--" ? string("") : *it);
+				// Do not compress since empty location codes are valid and
+				// replace -- by an empty location code
+				for ( string_view tok : Core::Tokens(toUpper(opts.val), ",", false) )
+					locations.emplace(tok == "--" ? string_view() : tok);
 			}
 			else if ( opts == Wired::URLOptionName("cha") ||
 			          opts == Wired::URLOptionName("channel")) {
-				vector<string> toks;
-				Core::split(toks, toUpper(opts.val), ",");
-				channels.insert(toks.begin(), toks.end());
+				for ( string_view tok : Core::Tokens(toUpper(opts.val), ",") )
+					channels.emplace(tok);
 			}
 			else if ( opts == Wired::URLOptionName("start") ||
 			          opts == Wired::URLOptionName("starttime")) {
@@ -511,9 +615,14 @@ bool FDSNWSSession::handleGETRequest(Wired::HttpRequest &req) {
 						               endTime.toString("%Y,%m,%d,%H,%M,%S").c_str(),
 						               net->c_str(), sta->c_str(),
 						               loc->c_str(), cha->c_str());
-						buf->stream->addStream(net->c_str(), sta->c_str(),
-						                       loc->c_str(), cha->c_str(),
-						                       startTime, endTime);
+						RequestItem item;
+						item.net = *net;
+						item.sta = *sta;
+						item.loc = *loc;
+						item.cha = *cha;
+						item.startTime = startTime;
+						item.endTime = endTime;
+						buf->addStream(item);
 					}
 				}
 			}
@@ -536,6 +645,192 @@ bool FDSNWSSession::handleGETRequest(Wired::HttpRequest &req) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool FDSNWSSession::handleAvailabilityRequest(Wired::HttpRequest &req,
+                                              Wired::URLPath &path) {
+	if ( !path.next() || path != "1" || !path.next() ) {
+		sendError(req.path, req.options, Wired::HTTP_404);
+		return true;
+	}
+
+	if ( path == "version" ) {
+		static string version = "scwfas v" SCWFAS_VERSION_NAME;
+
+		sendResponse(version, Wired::HTTP_200, "text/plain");
+		return true;
+	}
+
+	bool extent;
+	if ( path == "extent" )
+		extent = true;
+	else if ( path == "query" )
+		extent = false;
+	else {
+		sendError(req.path, req.options, Wired::HTTP_404);
+		return true;
+	}
+
+	string options = req.options;
+	Wired::URLInsituOptions opts(req.options);
+	Core::Time startTime, endTime;
+	set<string> networks, stations, locations, channels;
+	bool noData404 = false;
+
+	while ( opts.next() ) {
+		opts.val_len = Wired::HttpSession::urldecode(opts.val, opts.val_len);
+
+		if ( opts == Wired::URLOptionName("net") ||
+		     opts == Wired::URLOptionName("network")) {
+			for ( string_view tok : Core::Tokens(toUpper(opts.val), ",") )
+				networks.emplace(tok);
+		}
+		else if ( opts == Wired::URLOptionName("sta") ||
+		          opts == Wired::URLOptionName("station")) {
+			for ( string_view tok : Core::Tokens(toUpper(opts.val), ",") )
+				stations.emplace(tok);
+		}
+		else if ( opts == Wired::URLOptionName("loc") ||
+		          opts == Wired::URLOptionName("location")) {
+			for ( string_view tok : Core::Tokens(toUpper(opts.val), ",", false) )
+				locations.emplace(tok == "--" ? string_view() : tok);
+		}
+		else if ( opts == Wired::URLOptionName("cha") ||
+		          opts == Wired::URLOptionName("channel")) {
+			for ( string_view tok : Core::Tokens(toUpper(opts.val), ",") )
+				channels.emplace(tok);
+		}
+		else if ( opts == Wired::URLOptionName("start") ||
+		          opts == Wired::URLOptionName("starttime")) {
+			if ( !parseFDSNWSTime(startTime, opts.val) ) {
+				sendError(req.path, options, Wired::HTTP_400, "Invalid start time");
+				return true;
+			}
+		}
+		else if ( opts == Wired::URLOptionName("end") ||
+		          opts == Wired::URLOptionName("endtime")) {
+			if ( !parseFDSNWSTime(endTime, opts.val) ) {
+				sendError(req.path, options, Wired::HTTP_400, "Invalid end time");
+				return true;
+			}
+		}
+		else if ( opts == Wired::URLOptionName("format") ) {
+			if ( opts.val_len != 4 || strncasecmp(opts.val, "text", 4) ) {
+				sendError(req.path, options, Wired::HTTP_400, "Only the text format is supported");
+				return true;
+			}
+		}
+		else if ( opts == Wired::URLOptionName("nodata") ) {
+			if ( opts.val_len == 3 && !strncasecmp(opts.val, "404", 3) )
+				noData404 = true;
+			else if ( opts.val_len != 3 || strncasecmp(opts.val, "204", 3) ) {
+				sendError(req.path, options, Wired::HTTP_400, "Invalid nodata value");
+				return true;
+			}
+		}
+	}
+
+	if ( startTime.valid() && endTime.valid() && startTime > endTime ) {
+		sendError(req.path, options, Wired::HTTP_400, "Start time larger than endtime");
+		return true;
+	}
+
+	if ( networks.empty() ) networks.insert("*");
+	if ( stations.empty() ) stations.insert("*");
+	if ( locations.empty() ) locations.insert("*");
+	if ( channels.empty() ) channels.insert("*");
+
+	vector<string> patterns;
+	for ( const string &net : networks )
+		for ( const string &sta : stations )
+			for ( const string &loc : locations )
+				for ( const string &cha : channels )
+					patterns.push_back(net + "." + sta + "." + loc + "." + cha);
+
+	const char *timeFormat = "%FT%T.%fZ";
+	stringstream ss;
+	bool hasData = false;
+
+	if ( extent )
+		ss << "#Network Station Location Channel Quality SampleRate Earliest Latest Updated TimeSpans Restriction" << endl;
+	else
+		ss << "#Network Station Location Channel Quality SampleRate Earliest Latest" << endl;
+
+	for ( const string &root : archiveRoots() ) {
+		auto index = RecordStream::SDSAvailability::Open(root);
+		if ( !index ) continue;
+
+		DataModel::DataAvailabilityPtr availability = index->dataAvailability(patterns);
+
+		for ( size_t i = 0; i < availability->dataExtentCount(); ++i ) {
+			DataModel::DataExtent *ext = availability->dataExtent(i);
+			const DataModel::WaveformStreamID &wid = ext->waveformID();
+			string prefix = wid.networkCode() + " " + wid.stationCode() + " " +
+			                (wid.locationCode().empty() ? string("--") : wid.locationCode()) +
+			                " " + wid.channelCode();
+
+			// Extents are reported per quality and sample rate
+			struct Span {
+				Core::Time earliest;
+				Core::Time latest;
+				Core::Time updated;
+				size_t     count{0};
+			};
+			map<pair<string, double>, Span> spans;
+
+			for ( size_t j = 0; j < ext->dataSegmentCount(); ++j ) {
+				DataModel::DataSegment *seg = ext->dataSegment(j);
+				if ( (endTime.valid() && seg->start() > endTime)
+				  || (startTime.valid() && seg->end() <= startTime) )
+					continue;
+
+				Core::Time start = seg->start(), end = seg->end();
+				if ( startTime.valid() && start < startTime ) start = startTime;
+				if ( endTime.valid() && end > endTime ) end = endTime;
+
+				if ( !extent ) {
+					ss << prefix << " " << seg->quality() << " "
+					   << seg->sampleRate() << " "
+					   << start.toString(timeFormat) << " "
+					   << end.toString(timeFormat) << endl;
+					hasData = true;
+					continue;
+				}
+
+				Span &span = spans[make_pair(seg->quality(), seg->sampleRate())];
+				if ( !span.count || start < span.earliest ) span.earliest = start;
+				if ( !span.count || end > span.latest ) span.latest = end;
+				if ( !span.count || seg->updated() > span.updated ) span.updated = seg->updated();
+				++span.count;
+			}
+
+			for ( const auto &item : spans ) {
+				ss << prefix << " " << item.first.first << " "
+				   << item.first.second << " "
+				   << item.second.earliest.toString(timeFormat) << " "
+				   << item.second.latest.toString(timeFormat) << " "
+				   << item.second.updated.toString(timeFormat) << " "
+				   << item.second.count << " OPEN" << endl;
+				hasData = true;
+			}
+		}
+	}
+
+	if ( !hasData ) {
+		if ( noData404 )
+			sendError(req.path, options, Wired::HTTP_404);
+		else
+			sendResponse(Wired::HTTP_204);
+	}
+	else
+		sendResponse(ss.str(), Wired::HTTP_200, "text/plain");
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool FDSNWSSession::handlePOSTRequest(Wired::HttpRequest &req) {
 	Wired::URLPath path(req.path);
@@ -694,8 +989,7 @@ bool FDSNWSSession::handlePOSTRequest(Wired::HttpRequest &req) {
 		               item->endTime.toString("%Y,%m,%d,%H,%M,%S").c_str(),
 		               item->net.c_str(), item->sta.c_str(),
 		               item->loc.c_str(), item->cha.c_str());
-		buf->stream->addStream(item->net, item->sta, item->loc, item->cha,
-		                       item->startTime, item->endTime);
+		buf->addStream(*item);
 	}
 
 	if ( !buf->hasData() ) {
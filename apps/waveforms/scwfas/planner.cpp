@@ -0,0 +1,275 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * Author: Jan Becker                                                      *
+ * Email: jabe@gempa.de                                                    *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include "planner.h"
+#include "settings.h"
+
+#define SEISCOMP_COMPONENT WFAS
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace Applications {
+namespace Wfas {
+
+
+namespace {
+
+
+// Advises the kernel to read the segment into the page cache while the
+// previous lines are sent
+void readAhead(const SegmentJob::Segment &segment) {
+#ifdef POSIX_FADV_WILLNEED
+	int fd = open(segment.path.c_str(), O_RDONLY);
+	if ( fd < 0 ) return;
+	posix_fadvise(fd, segment.offset, segment.length, POSIX_FADV_WILLNEED);
+	close(fd);
+#endif
+}
+
+
+}
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SegmentReader &SegmentReader::Instance() {
+	static SegmentReader instance;
+	return instance;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SegmentReader::~SegmentReader() {
+	stop();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentReader::start(size_t threads) {
+	stop();
+
+	_stopped = false;
+	for ( size_t i = 0; i < threads; ++i )
+		_threads.emplace_back(&SegmentReader::work, this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentReader::stop() {
+	{
+		lock_guard<mutex> l(_mutex);
+		_stopped = true;
+		_queue.clear();
+	}
+
+	_jobAvailable.notify_all();
+	_jobDone.notify_all();
+
+	for ( auto &t : _threads )
+		t.join();
+	_threads.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentReader::submit(const SegmentJobPtr &job) {
+	{
+		lock_guard<mutex> l(_mutex);
+		_queue.push_back(job);
+	}
+
+	_jobAvailable.notify_one();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentReader::cancel(const SegmentJobPtr &job) {
+	lock_guard<mutex> l(_mutex);
+	job->cancelled = true;
+	auto it = find(_queue.begin(), _queue.end(), job);
+	if ( it != _queue.end() )
+		_queue.erase(it);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentReader::wait(const SegmentJob &job) {
+	unique_lock<mutex> l(_mutex);
+	_jobDone.wait(l, [this, &job]() { return job.done || _stopped; });
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentReader::work() {
+	unique_lock<mutex> l(_mutex);
+
+	while ( true ) {
+		_jobAvailable.wait(l, [this]() { return _stopped || !_queue.empty(); });
+		if ( _stopped ) break;
+
+		SegmentJobPtr job = _queue.front();
+		_queue.pop_front();
+
+		l.unlock();
+		process(*job);
+		l.lock();
+
+		job->done = true;
+		_jobDone.notify_all();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentReader::process(SegmentJob &job) {
+	RecordStream::SDSArchive archive;
+
+	if ( !archive.setSource(global.filebase) ) {
+		SEISCOMP_ERROR("Failed to open archive %s", global.filebase.c_str());
+		return;
+	}
+
+	archive.addStream(job.item.net, job.item.sta, job.item.loc, job.item.cha,
+	                  job.item.startTime, job.item.endTime);
+
+	SegmentJob::Segment segment;
+	while ( !job.cancelled && archive.nextSegment(segment) ) {
+		readAhead(segment);
+		job.segments.push_back(segment);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SegmentPlanner::SegmentPlanner(size_t readahead)
+: _readahead(max(readahead, static_cast<size_t>(1))) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SegmentPlanner::~SegmentPlanner() {
+	// The response has been aborted, do not resolve the remaining lines
+	for ( auto &job : _running )
+		SegmentReader::Instance().cancel(job);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentPlanner::add(const RequestItem &item) {
+	_waiting.push_back(make_shared<SegmentJob>(item));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SegmentPlanner::schedule() {
+	while ( _running.size() < _readahead && !_waiting.empty() ) {
+		SegmentReader::Instance().submit(_waiting.front());
+		_running.push_back(_waiting.front());
+		_waiting.pop_front();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SegmentPlanner::next(SegmentJob::Segment &segment) {
+	while ( true ) {
+		if ( _current ) {
+			while ( _index < _current->segments.size() ) {
+				const SegmentJob::Segment &seg = _current->segments[_index++];
+				// Overlapping lines resolve to the same segments
+				if ( !_segments.insert(seg.path + ":" + Core::toString(seg.offset)).second )
+					continue;
+
+				segment = seg;
+				return true;
+			}
+
+			_current = nullptr;
+		}
+
+		schedule();
+		if ( _running.empty() )
+			return false;
+
+		_current = _running.front();
+		_running.pop_front();
+		_index = 0;
+
+		// Refill the slot of the current line before waiting for it
+		schedule();
+		SegmentReader::Instance().wait(*_current);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
+}
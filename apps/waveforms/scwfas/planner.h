@@ -0,0 +1,152 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * Author: Jan Becker                                                      *
+ * Email: jabe@gempa.de                                                    *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_APPS_SCWSAS_PLANNER_H__
+#define SEISCOMP_APPS_SCWSAS_PLANNER_H__
+
+
+#include <seiscomp/io/recordstream/sdsarchive.h>
+
+#include "session.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Applications {
+namespace Wfas {
+
+
+/**
+ * @brief A job resolves the day file segments of a single request line.
+ *
+ * The segments are collected by a worker of the SegmentReader and the
+ * kernel is advised to read them ahead of the response.
+ */
+struct SegmentJob {
+	SegmentJob(const RequestItem &item) : item(item) {}
+
+	typedef RecordStream::SDSArchive::FileSegment Segment;
+
+	RequestItem          item;
+	std::vector<Segment> segments;
+	bool                 done{false};
+	std::atomic<bool>    cancelled{false};
+};
+
+typedef std::shared_ptr<SegmentJob> SegmentJobPtr;
+
+
+/**
+ * @brief The SegmentReader is the process wide pool of threads which
+ *        resolve request lines for all sessions.
+ *
+ * Jobs are processed in submission order. As each request only keeps a
+ * limited number of jobs in flight, the lines of concurrent requests
+ * interleave and a large request does not starve the others.
+ */
+class SegmentReader {
+	public:
+		static SegmentReader &Instance();
+
+	public:
+		//! Starts the given number of threads
+		void start(size_t threads);
+
+		//! Stops all threads, pending jobs are discarded
+		void stop();
+
+		bool isRunning() const { return !_threads.empty(); }
+
+		void submit(const SegmentJobPtr &job);
+
+		//! Removes the job from the queue if it has not been started yet
+		void cancel(const SegmentJobPtr &job);
+
+		//! Blocks until the job has been completed
+		void wait(const SegmentJob &job);
+
+	private:
+		SegmentReader() = default;
+		~SegmentReader();
+
+		void work();
+		void process(SegmentJob &job);
+
+	private:
+		std::vector<std::thread>  _threads;
+		std::deque<SegmentJobPtr> _queue;
+		std::mutex                _mutex;
+		std::condition_variable   _jobAvailable;
+		std::condition_variable   _jobDone;
+		bool                      _stopped{false};
+};
+
+
+/**
+ * @brief The SegmentPlanner resolves the segments of all lines of a request
+ *        on the SegmentReader and returns them in request order.
+ */
+class SegmentPlanner {
+	public:
+		//! Keeps at most readahead lines on the SegmentReader
+		explicit SegmentPlanner(size_t readahead);
+		~SegmentPlanner();
+
+	public:
+		void add(const RequestItem &item);
+
+		/**
+		 * @brief Returns the next segment. Segments which have been
+		 *        returned already for a previous line are skipped.
+		 * @param segment The output segment
+		 * @return false if all lines have been processed
+		 */
+		bool next(SegmentJob::Segment &segment);
+
+	private:
+		void schedule();
+
+	private:
+		size_t                    _readahead;
+		std::deque<SegmentJobPtr> _waiting;
+		std::deque<SegmentJobPtr> _running;
+		SegmentJobPtr             _current;
+		size_t                    _index{0};
+		std::set<std::string>     _segments;
+};
+
+
+}
+}
+}
+
+
+#endif
@@ -28,6 +28,8 @@
 #include <seiscomp/system/application.h>
 #include <seiscomp/system/environment.h>
 
+#include <vector>
+
 
 namespace Seiscomp {
 namespace Applications {
@@ -38,6 +40,7 @@ namespace Wfas {
 struct Settings : System::Application::AbstractSettings {
 	Settings() {
 		filebase = Environment::Instance()->installDir() + "/var/lib/archive";
+		workers = 0;
 	}
 
 	struct Arclink {
@@ -62,11 +65,20 @@ struct Settings : System::Application::AbstractSettings {
 			port = 8080;
 			baseUrl = "http://localhost:8080/fdsnws";
 			maxTimeWindow = 0;
+			passthrough = true;
+			readers = 4;
+			readahead = 4;
+			availabilityInterval = 600;
 		}
 
 		int         port;
 		std::string baseUrl;
 		int         maxTimeWindow;
+		bool        passthrough;
+		int         readers;
+		int         readahead;
+		int         availabilityInterval;
+		std::vector<int> pyramidLevels;
 
 		void accept(System::Application::SettingsLinker &linker) {
 			linker
@@ -78,20 +90,27 @@ struct Settings : System::Application::AbstractSettings {
 			& cli(baseUrl, "Server", "fdsnws-baseurl",
 			      "The base URL for the FDSNWS service",
 			      true)
-			& cfg(maxTimeWindow, "maxTimeWindow");
+			& cfg(maxTimeWindow, "maxTimeWindow")
+			& cfg(passthrough, "passthrough")
+			& cfg(readers, "readers")
+			& cfg(readahead, "readahead")
+			& cfg(availabilityInterval, "availabilityInterval")
+			& cfg(pyramidLevels, "pyramidLevels");
 		}
 	} fdsnws;
 
 	std::string sdsBackend;
 	std::string dcid;
 	std::string filebase;
+	int         workers;
 
 	virtual void accept(System::Application::SettingsLinker &linker) {
 		linker
 		& cfg(arclink, "arclink")
 		& cfg(fdsnws, "fdsnws")
 		& cfg(sdsBackend, "handlerSDS")
-		& cfgAsPath(filebase, "filebase");
+		& cfgAsPath(filebase, "filebase")
+		& cfg(workers, "workers");
 	}
 };
 
@@ -0,0 +1,60 @@
+/*
+ * NAME
+ *	tttables -- Shareable travel-time table sets
+
+ * FILE
+ *	tttables.h
+
+ * SYNOPSIS
+ *	Interface to travel-time table sets which are read once and are
+ *	not modified afterwards.
+
+ * DESCRIPTION
+ *	The table set returned by read_tttables() is independent of the
+ *	tables maintained by setup_tttables() and locate_event().  It can
+ *	be used from multiple threads concurrently as long as it is not
+ *	freed.  Travel-time interpolation with tttables_compute_ttime() is
+ *	reentrant.  locate_event_tables() still uses the station list and
+ *	the locator internals which are global and must be serialized by
+ *	the caller.
+
+ * NOTES
+ *	Station corrections (cor_level > 0) are not supported by
+ *	locate_event_tables().
+ */
+
+
+#ifndef TTTABLES_H
+#define TTTABLES_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef struct tttables TTTables;
+
+
+/* Reads the default phase set of the tables with prefix dir. Returns
+ * NULL and the locate_event() compatible error code in err on failure. */
+TTTables *read_tttables(const char *dir, int verbose, int *err);
+void      free_tttables(TTTables *tables);
+
+int         tttables_num_phases(const TTTables *tables);
+const char *tttables_phase_type(const TTTables *tables, int phase_id);
+int         tttables_find_phase(const TTTables *tables, const char *phase);
+
+/* Same as compute_ttime() but with a phase index as returned by
+ * tttables_find_phase(). */
+double tttables_compute_ttime(const TTTables *tables, double distance,
+                              double depth, int phase_id, int extrapolate,
+                              double *rdtdd, double *rdtdh, int *errorflag);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
@@ -64,12 +64,12 @@ int *iext, *ibad;
     int i__1, i__2;
 
     /* Local variables */
-    static int imin, imax, nuse;
+    int imin, imax, nuse;
     extern /* Subroutine */ int brack_();
-    static int ileft;
-    static float fh[6];
-    static int nh;
-    static float xh[6];
+    int ileft;
+    float fh[6];
+    int nh;
+    float xh[6];
     extern /* Subroutine */ int fixhol_(), quaint_();
 
 /* K.S. 1-Dec-97, changed 'undefined' to 'none' */
@@ -54,13 +54,13 @@ int *iext;
 
     /* Local variables */
     extern /* Subroutine */ int brack_();
-    static int ileft;
-    static float fpdev, f1, f2, f3;
-    static int i1, i2, i3, i4;
-    static float f4, x1, x2, x3, x4, fpdev2, fpdev3, h12, h23, h34, s12, s23,
+    int ileft;
+    float fpdev, f1, f2, f3;
+    int i1, i2, i3, i4;
+    float f4, x1, x2, x3, x4, fpdev2, fpdev3, h12, h23, h34, s12, s23,
 	    s34;
     extern /* Subroutine */ int hermit_();
-    static float fp2, fp3, fac;
+    float fp2, fp3, fac;
 
 /* K.S. 1-Dec-97, changed 'undefined' to 'none' */
 /*     ---- On entry ---- */
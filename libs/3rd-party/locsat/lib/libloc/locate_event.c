@@ -111,6 +111,15 @@
  *		double	distance, depth;
  *		char	*phase;
  *	----------------------------------------------------------------
+ *	read_tttables:
+ *		Read a travel-time table set which is owned by the caller
+ *		and independent of the tables of setup_tttables.
+ *		See tttables.h.
+ *	----------------------------------------------------------------
+ *	locate_event_tables:
+ *		Same as locate_event but with a table set returned by
+ *		read_tttables.
+ *	----------------------------------------------------------------
 
  * DIAGNOSTICS
  *	See golocate_error_table[] character string for global-type errors
@@ -152,6 +161,7 @@
 #include "db_origerr.h"
 #include "loc_params.h"
 #include "utils.h"
+#include "tttables.h"
 /* #include "sysdefs.h" */
 #include "css/trim.h"
 
@@ -211,19 +221,22 @@ static char	SccsId[] = "@(#)locate_event.c	44.3	10/31/91 Copyright 1990 Science
 #define MAXTBZ          50
 
 
-static char	  *dir;
-static char	  *phase_type;
-static char  **phase_type_ptr;
-static int     num_phase_types;
-static int     maxtbd = MAXTBD;
-static int     maxtbz = MAXTBZ;
-static float  *tbd;
-static float  *tbz;
-static float  *tbtt;
-static int     first_table_read = TRUE;
-static int    *ntbd;
-static int    *ntbz;
-static int     len_dir;
+struct tttables {
+	char   *dir;
+	char   *phase_type;     /* Size [num_phase_types][len_n_p_t] */
+	char  **phase_type_ptr;
+	int     num_phase_types;
+	int     maxtbd;
+	int     maxtbz;
+	float  *tbd;
+	float  *tbz;
+	float  *tbtt;
+	int    *ntbd;
+	int    *ntbz;
+};
+
+/* The tables maintained by setup_tttables */
+static TTTables *tables = NULL;
 static int     len_n_p_t = 9;
 
 static char   *net;
@@ -375,144 +388,173 @@ int setup_sites(char *new_net, Site *new_sites, int new_num_sta) {
 }
 
 
-static int
-setup_tttables(const char *new_dir, const char **new_phase_types,
-               int new_num_phase_types, int verbose) {
-	int i, ierr, num_type;
+static TTTables *
+read_tables(const char *new_dir, const char **new_phase_types,
+            int new_num_phase_types, int verbose, int *err) {
+	TTTables *tt;
+	int i, ierr;
 	char *dummy_ptr;
 	int malloc_err = 0;
 
-	/* First determine whether it is necessary to read in new tables */
-
 	if (new_num_phase_types == 0 || ! new_phase_types)
 	{
 		fprintf (stderr,"Error setup_tttables: Null phase_type list");
-		return (TTerror1);
+		*err = TTerror1;
+		return (NULL);
 	}
 
-	if ( !first_table_read )  {
-		if ( STREQ(new_dir, dir) && lstcmp((const char**)phase_type_ptr,
-		     num_phase_types, new_phase_types, new_num_phase_types) )
-			return (NOERROR);
-
-		/* Free up previous space, and then, read new tables */
-
-		UFREE(phase_type);
-		UFREE(phase_type_ptr);
-		UFREE(dir);
-		UFREE(tbd);
-		UFREE(tbz);
-		UFREE(tbtt);
-		UFREE(ntbd);
-		UFREE(ntbz);
+	if (!(tt = UALLOC(TTTables, 1)))
+	{
+		printf ("Insufficient memory for travel-time tables (file locate_event.c)\n");
+		*err = ERROR;
+		return (NULL);
 	}
 
-	first_table_read = FALSE;
-	dir = STRALLOC(new_dir);	/* Grab the dir to keep */
-	len_dir = strlen(dir);
-	num_phase_types = new_num_phase_types;	/* How many wave types */
+	bzero((char *)tt, sizeof(TTTables));
+	tt->dir = STRALLOC(new_dir);	/* Grab the dir to keep */
+	tt->num_phase_types = new_num_phase_types;	/* How many wave types */
+	tt->maxtbd = MAXTBD;
+	tt->maxtbz = MAXTBZ;
 
 	/* Grab all of the wave id's */
 
-	phase_type = (char *)malloc((unsigned)(num_phase_types * len_n_p_t) * (sizeof(char)));
-	phase_type_ptr = (char **)malloc ((unsigned) num_phase_types * sizeof(char *));
-	bzero((char *)phase_type, (num_phase_types*len_n_p_t) * (sizeof(char)));
-	bzero((char *)phase_type_ptr, num_phase_types * sizeof(char *));
+	tt->phase_type = (char *)malloc((unsigned)(tt->num_phase_types * len_n_p_t) * (sizeof(char)));
+	tt->phase_type_ptr = (char **)malloc ((unsigned) tt->num_phase_types * sizeof(char *));
+	bzero((char *)tt->phase_type, (tt->num_phase_types*len_n_p_t) * (sizeof(char)));
+	bzero((char *)tt->phase_type_ptr, tt->num_phase_types * sizeof(char *));
 
-	for (i = 0; i < num_phase_types; i++)
+	for (i = 0; i < tt->num_phase_types; i++)
 	{
-		dummy_ptr = phase_type + i*len_n_p_t;
+		dummy_ptr = tt->phase_type + i*len_n_p_t;
 		strcpy (dummy_ptr, new_phase_types[i]);
-		phase_type_ptr[i] = dummy_ptr;
+		tt->phase_type_ptr[i] = dummy_ptr;
 	}
 
-	malloc_err = 0;
-	ntbd = ntbz = (int *)NULL;
-	tbd = tbz = tbtt = (float *)NULL;
-
-	if (!(ntbd = UALLOC(int, num_phase_types)))
+	if (!(tt->ntbd = UALLOC(int, tt->num_phase_types)))
 		malloc_err++;
 
-	else if (! (ntbz = UALLOC(int, num_phase_types)))
+	else if (! (tt->ntbz = UALLOC(int, tt->num_phase_types)))
 		malloc_err++;
 
-	else if (! (tbd = UALLOC(float, maxtbd*num_phase_types)))
+	else if (! (tt->tbd = UALLOC(float, tt->maxtbd*tt->num_phase_types)))
 		malloc_err++;
 
-	else if (! (tbz = UALLOC(float, maxtbz*num_phase_types)))
+	else if (! (tt->tbz = UALLOC(float, tt->maxtbz*tt->num_phase_types)))
 		malloc_err++;
 
-	else if (! (tbtt = UALLOC(float, maxtbd*maxtbz*num_phase_types)))
+	else if (! (tt->tbtt = UALLOC(float, tt->maxtbd*tt->maxtbz*tt->num_phase_types)))
 		malloc_err++;
 
 	if (malloc_err)
 	{
 		printf ("Insufficient memory for travel-time tables (file locate_event.c)\n");
-		UFREE(ntbd);
-		UFREE(ntbz);
-		UFREE(tbd);
-		UFREE(tbz);
-		UFREE(tbtt);
-		return (ERROR);
+		free_tttables(tt);
+		*err = ERROR;
+		return (NULL);
 	}
 
 	/* Read the travel-time tables */
 
-	rdtttab(dir, phase_type_ptr, num_phase_types, maxtbd, maxtbz,
-	        ntbd, ntbz, tbd, tbz, tbtt, &ierr, verbose);
+	rdtttab(tt->dir, tt->phase_type_ptr, tt->num_phase_types, tt->maxtbd,
+	        tt->maxtbz, tt->ntbd, tt->ntbz, tt->tbd, tt->tbz, tt->tbtt,
+	        &ierr, verbose);
 
 	if (ierr == 0)
 	{
-		if (sta_cor_level > 0)
-		{
-			num_type = 1;
-			cortyp = (char *) malloc((unsigned) num_type * 9
-					  * sizeof(char));
-			dummy_ptr = cortyp + (num_type-1)*9;
-			strcpy (dummy_ptr, "TT");
-			FPAD(dummy_ptr, 9);
-			rdcortab_ (dir, cortyp, &num_type, sta_id, phase_type,
-				   &num_sta, &num_phase_types, &ierr, len_dir,
-				   2, len_sta_id, len_n_p_t);
-			if (ierr > 1)
-				fprintf (stdout, "Problems with sta. corr. tables\n");
-		}
-		return (NOERROR);
+		*err = NOERROR;
+		return (tt);
 	}
 
+	free_tttables(tt);
+
+	if (ierr == 1)
+	{
+		fprintf (stderr, "setup_tttables: Error opening travel-time tables");
+		*err = TTerror2;
+	}
+	else if (ierr == 2)
+	{
+		fprintf (stderr, "setup_tttables: Error reading travel-time tables: Unexpected E-O-F");
+		*err = TTerror3;
+	}
+	else if (ierr == 3)
+	{
+		fprintf (stderr, "setup_tttables: Error reading travel time tables, too many distance or depth samples");
+		*err = TTerror4;
+	}
 	else
 	{
-		UFREE(phase_type);
-		UFREE(phase_type_ptr);
-		UFREE(dir);
-		UFREE(tbd);
-		UFREE(tbz);
-		UFREE(tbtt);
-		UFREE(ntbd);
-		UFREE(ntbz);
-		first_table_read = TRUE;
-
-		if (ierr == 1)
-		{
-			fprintf (stderr, "setup_tttables: Error opening travel-time tables");
-			return (TTerror2);
-		}
-		else if (ierr == 2)
-		{
-			fprintf (stderr, "setup_tttables: Error reading travel-time tables: Unexpected E-O-F");
-			return (TTerror3);
-		}
-		else if (ierr == 3)
-		{
-			fprintf (stderr, "setup_tttables: Error reading travel time tables, too many distance or depth samples");
-			return (TTerror4);
-		}
-		else
-		{
-			fprintf (stderr, "setup_tttables: Unknown error reading travel-time tables");
-			return (TTerror5);
-		}
+		fprintf (stderr, "setup_tttables: Unknown error reading travel-time tables");
+		*err = TTerror5;
+	}
+
+	return (NULL);
+}
+
+
+static int
+setup_tttables(const char *new_dir, const char **new_phase_types,
+               int new_num_phase_types, int verbose) {
+	int ierr, num_type;
+	char *dummy_ptr;
+
+	/* First determine whether it is necessary to read in new tables */
+
+	if ( tables )  {
+		if ( STREQ(new_dir, tables->dir) && lstcmp((const char**)tables->phase_type_ptr,
+		     tables->num_phase_types, new_phase_types, new_num_phase_types) )
+			return (NOERROR);
+
+		/* Free up previous space, and then, read new tables */
+
+		free_tttables(tables);
+		tables = NULL;
 	}
+
+	tables = read_tables(new_dir, new_phase_types, new_num_phase_types,
+	                     verbose, &ierr);
+	if (!tables)
+		return (ierr);
+
+	if (sta_cor_level > 0)
+	{
+		num_type = 1;
+		cortyp = (char *) malloc((unsigned) num_type * 9
+				  * sizeof(char));
+		dummy_ptr = cortyp + (num_type-1)*9;
+		strcpy (dummy_ptr, "TT");
+		FPAD(dummy_ptr, 9);
+		rdcortab_ (tables->dir, cortyp, &num_type, sta_id, tables->phase_type,
+			   &num_sta, &tables->num_phase_types, &ierr,
+			   strlen(tables->dir), 2, len_sta_id, len_n_p_t);
+		if (ierr > 1)
+			fprintf (stdout, "Problems with sta. corr. tables\n");
+	}
+
+	return (NOERROR);
+}
+
+
+TTTables *read_tttables(const char *dir, int verbose, int *err) {
+	return read_tables(dir, default_phases,
+	                   (sizeof default_phases) / sizeof(const char*),
+	                   verbose, err);
+}
+
+
+void free_tttables(TTTables *tt) {
+	if (!tt)
+		return;
+
+	UFREE(tt->phase_type);
+	UFREE(tt->phase_type_ptr);
+	UFREE(tt->dir);
+	UFREE(tt->tbd);
+	UFREE(tt->tbz);
+	UFREE(tt->tbtt);
+	UFREE(tt->ntbd);
+	UFREE(tt->ntbz);
+	UFREE(tt);
 }
 
 
@@ -522,13 +564,11 @@ int setup_tttables_dir(const char *new_dir, int verbose) {
 }
 
 
-int locate_event(char *network, Site *sites, int num_sites, Arrival *arrival,
-                 Assoc *assoc, Origin *origin, Origerr *origerr,
-                 Locator_params *locator_params, Locator_errors *locator_errors,
-                 int num_obs) {
+static int locate(const TTTables *tt, Arrival *arrival, Assoc *assoc,
+                  Origin *origin, Origerr *origerr,
+                  Locator_params *locator_params,
+                  Locator_errors *locator_errors, int num_obs) {
 
-	int   loc_err;
-	char  *new_dir;
 
 	char	*user;
 	char	*data_sta_id, *data_phase_type, *data_type, *data_defining;
@@ -574,29 +614,6 @@ int locate_event(char *network, Site *sites, int num_sites, Arrival *arrival,
 	int     error_found = FALSE;
 
 
-	/* Read site (station) information */
-
-	if ((loc_err = setup_sites (network, sites, num_sites)) != 0)
-	{
-		fprintf (stderr,"locate_event: Aborting location process");
-		return (loc_err);
-	}
-
-	/* Check if travel-time tables have been read */
-
-	/*
-	if (first_table_read)
-	{
-	*/
-		new_dir		    = locator_params->prefix;
-		sta_cor_level	    = locator_params->cor_level;
-
-		if ((loc_err = setup_tttables_dir (new_dir, locator_params->verbose == 'y')) != 0)
-			return (loc_err);
-	/*
-	}
-	*/
-
 	/* Check input */
 
 	if ((num_obs == 0) || (! arrival))
@@ -803,8 +820,9 @@ int locate_event(char *network, Site *sites, int num_sites, Arrival *arrival,
 	locsat0_(data_sta_id, data_phase_type, data_type, data_defining,
 		 obs_data, data_std_err, data_arrival_id_index, &num_data,
 		 sta_id, sta_lat, sta_lon, sta_elev, sta_cor, &num_sta,
-		 phase_type, &num_phase_types, &maxtbd, &maxtbz, ntbd, ntbz,
-		 tbd, tbz, tbtt, &lat_init, &lon_init, &depth_init,
+		 tt->phase_type, (int *)&tt->num_phase_types,
+		 (int *)&tt->maxtbd, (int *)&tt->maxtbz, tt->ntbd, tt->ntbz,
+		 tt->tbd, tt->tbz, tt->tbtt, &lat_init, &lon_init, &depth_init,
 		 &est_std_error, &num_dof, &conf_level, &azimuth_wt, &damp,
 		 &max_iterations, &verbose, &fix_depth, outfile_name, &luout,
 		 &lat, &lon, &depth, &torg, &sighat, &snssd, &ndf,
@@ -1027,17 +1045,79 @@ int locate_event(char *network, Site *sites, int num_sites, Arrival *arrival,
 
 
 
+int locate_event(char *network, Site *sites, int num_sites, Arrival *arrival,
+                 Assoc *assoc, Origin *origin, Origerr *origerr,
+                 Locator_params *locator_params, Locator_errors *locator_errors,
+                 int num_obs) {
+	int   loc_err;
+
+	/* Read site (station) information */
+
+	if ((loc_err = setup_sites (network, sites, num_sites)) != 0)
+	{
+		fprintf (stderr,"locate_event: Aborting location process");
+		return (loc_err);
+	}
+
+	/* Check if travel-time tables have been read */
+
+	sta_cor_level = locator_params->cor_level;
+
+	if ((loc_err = setup_tttables_dir (locator_params->prefix, locator_params->verbose == 'y')) != 0)
+		return (loc_err);
+
+	return locate(tables, arrival, assoc, origin, origerr, locator_params,
+	              locator_errors, num_obs);
+}
+
+
+int locate_event_tables(const TTTables *tt, char *network, Site *sites,
+                        int num_sites, Arrival *arrival, Assoc *assoc,
+                        Origin *origin, Origerr *origerr,
+                        Locator_params *locator_params,
+                        Locator_errors *locator_errors, int num_obs) {
+	int   loc_err;
+
+	if (!tt)
+	{
+		fprintf (stderr,"locate_event_tables: No travel-time tables");
+		return (TTerror2);
+	}
+
+	if ((loc_err = setup_sites (network, sites, num_sites)) != 0)
+	{
+		fprintf (stderr,"locate_event_tables: Aborting location process");
+		return (loc_err);
+	}
+
+	return locate(tt, arrival, assoc, origin, origerr, locator_params,
+	              locator_errors, num_obs);
+}
+
+
 int num_phases() {
-	return num_phase_types;
+	return tables ? tables->num_phase_types : 0;
 }
 
 
 char **phase_types() {
-	return phase_type_ptr;
+	return tables ? tables->phase_type_ptr : NULL;
 }
 
 
-int find_phase(const char *phase) {
+int tttables_num_phases(const TTTables *tt) {
+	return tt->num_phase_types;
+}
+
+
+const char *tttables_phase_type(const TTTables *tt, int phase_id) {
+	if (phase_id < 0 || phase_id >= tt->num_phase_types)
+		return NULL;
+	return tt->phase_type_ptr[phase_id];
+}
+
+
+int tttables_find_phase(const TTTables *tt, const char *phase) {
 	int i;
 
 	if (!phase || !*phase)
@@ -1046,41 +1126,62 @@ int find_phase(const char *phase) {
 	if (len_n_p_t <= 0 || strlen(phase) >= len_n_p_t)
 		return ERR;
 
-	for (i = 0; i < num_phase_types; i++)
-		if (phase_type_ptr[i] &&
-		    !strncmp (phase, phase_type_ptr[i], len_n_p_t))
+	for (i = 0; i < tt->num_phase_types; i++)
+		if (tt->phase_type_ptr[i] &&
+		    !strncmp (phase, tt->phase_type_ptr[i], len_n_p_t))
 			break;
 
-	if (i < num_phase_types)
+	if (i < tt->num_phase_types)
 		return i;
 	else
 		return ERR;
 }
 
 
+int find_phase(const char *phase) {
+	if (!tables)
+		return ERR;
+
+	return tttables_find_phase(tables, phase);
+}
+
+
 double compute_ttime(double distance, double depth, const char *phase, int extrapolate,
                      double *rdtdd,  double *rdtdh, int *errorflag) {
+	int phase_id;
+
+	phase_id = find_phase(phase);
+	if (phase_id < 0)
+		return -1.0;
+
+	return tttables_compute_ttime(tables, distance, depth, phase_id,
+	                              extrapolate, rdtdd, rdtdh, errorflag);
+}
+
+
+double tttables_compute_ttime(const TTTables *tt, double distance,
+                              double depth, int phase_id, int extrapolate,
+                              double *rdtdd, double *rdtdh, int *errorflag) {
 	int ileft, jz, nz;
+	int maxtbd = tt->maxtbd, maxtbz = tt->maxtbz;
 	float zfoc = depth;
 	float bad_sample = -1.0;
 	float tcal; /* Travel time to return */
 	float delta, dtddel, dtdz, dcross;
 	int iext, jext, ibad; /* Errors from holint2_ */
-	int phase_id;
 
-	phase_id = find_phase(phase);
-	if (phase_id < 0)
+	if (phase_id < 0 || phase_id >= tt->num_phase_types)
 		return -1.0;
 
-	if (ntbz[phase_id] <= 0)
+	if (tt->ntbz[phase_id] <= 0)
 		return -1.0;
 
 	delta = distance;
 
-	brack_(&ntbz[phase_id], &tbz[phase_id * maxtbz], &zfoc, &ileft);
+	brack_(&tt->ntbz[phase_id], &tt->tbz[phase_id * maxtbz], &zfoc, &ileft);
 
 	jz = ((ileft - 1) > 1) ? (ileft - 1) : 1;
-	nz = (((ileft + 2) < ntbz[phase_id]) ? (ileft + 2) : ntbz[phase_id]) - jz + 1;
+	nz = (((ileft + 2) < tt->ntbz[phase_id]) ? (ileft + 2) : tt->ntbz[phase_id]) - jz + 1;
 
 	/*
 	 * Indexing into two and three dimensional arrays:
@@ -1092,9 +1193,9 @@ double compute_ttime(double distance, double depth, const char *phase, int extra
 	 *
 	 */
 
-	holint2_(&phase_id, &extrapolate, &ntbd[phase_id], &nz,
-	         &tbd[phase_id * maxtbd], &tbz[phase_id * maxtbz + jz - 1],
-	         &tbtt[(phase_id * maxtbz * maxtbd) + ((jz - 1) * maxtbd)],
+	holint2_(&phase_id, &extrapolate, &tt->ntbd[phase_id], &nz,
+	         &tt->tbd[phase_id * maxtbd], &tt->tbz[phase_id * maxtbz + jz - 1],
+	         &tt->tbtt[(phase_id * maxtbz * maxtbd) + ((jz - 1) * maxtbd)],
 	         &maxtbd, &bad_sample, &delta, &zfoc, &tcal, &dtddel, &dtdz,
 	         &dcross, &iext, &jext, &ibad);
 
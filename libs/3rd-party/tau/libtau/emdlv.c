@@ -3,6 +3,8 @@
 #include <string.h>
 #include <math.h>
 
+#include "tau.h"
+
 /*
 Replaces the routine with the same name and its entry, emdld, in the
 IASPEI91 package.  This version allows introduction of other models
@@ -18,7 +20,7 @@ assumed.  Limit is 200 layers and a maximum of 30 discontinuities.
 */
 
 
-#define NMAX  200
+#define NMAX  jvel
 #define NPMAX 30
 
 #define True  1
@@ -29,7 +31,8 @@ static float zin[NMAX], vpin[NMAX], vsin[NMAX], rd[NPMAX];
 static int nz = 0;
 
 
-int emdlv(float r, float *vp, float *vs) {
+static int interpolate(int nz, const float *zin, const float *vpin,
+                       const float *vsin, float r, float *vp, float *vs) {
 	float depth = 6371.0 - r;
 	int ldep = False;
 	int i = 0;
@@ -65,7 +68,8 @@ int emdlv(float r, float *vp, float *vs) {
 }
 
 
-int emdld(int *n, float *cpr, const char *name, const char *path) {
+static int load(int *pnz, float *zin, float *vpin, float *vsin, float *rd,
+                int *n, float *cpr, const char *name, const char *path) {
 	FILE *fp;
 	char *line = NULL;
 	size_t len;
@@ -92,10 +96,10 @@ int emdld(int *n, float *cpr, const char *name, const char *path) {
 	getline(&line, &len, fp);
 	getline(&line, &len, fp);
 
-	while ( getline(&line, &len, fp) > 0 ) {
+	while ( lc < NMAX && getline(&line, &len, fp) > 0 ) {
 		if ( sscanf(line, "%f %f %f", zin+lc, vpin+lc, vsin+lc) == 3 ) {
 			++lc;
-			nz = lc;
+			*pnz = lc;
 		}
 	}
 
@@ -104,8 +108,8 @@ int emdld(int *n, float *cpr, const char *name, const char *path) {
 
 	/* now for the discontinuities */
 	np = 0;
-	i = nz-2;
-	while ( i >= 1 ) {
+	i = *pnz-2;
+	while ( i >= 1 && np < NPMAX-1 ) {
 		if ( zin[i] == zin[i+1] ) {
 			rd[np] = 6371.0 - zin[i];
 			++np;
@@ -123,3 +127,28 @@ int emdld(int *n, float *cpr, const char *name, const char *path) {
 
 	return 0;
 }
+
+
+int emdlv(float r, float *vp, float *vs) {
+	return interpolate(nz, zin, vpin, vsin, r, vp, vs);
+}
+
+
+int emdld(int *n, float *cpr, const char *name, const char *path) {
+	return load(&nz, zin, vpin, vsin, rd, n, cpr, name, path);
+}
+
+
+/* Same as emdlv but uses the model loaded into a handle with emdldh */
+int emdlvh(const libtau *h, float r, float *vp, float *vs) {
+	return interpolate(h->nz, h->zin, h->vpin, h->vsin, r, vp, vs);
+}
+
+
+/* Same as emdld but loads the model into a handle and not into the
+   global state used by emdlv */
+int emdldh(libtau *h, const char *name, const char *path) {
+	float tmp[NPMAX];
+	h->nz = 0;
+	return load(&h->nz, h->zin, h->vpin, h->vsin, tmp, &h->np, h->rd, name, path);
+}
@@ -22,7 +22,8 @@ static char *xindex(char *a, char *b);
 static void spfit(libtau *h, int jb, int intt);
 void tauint(double, double, double, double, double, double*, double*);
 void tauspl(int, int, double*, double*, double*, double*, double*, double*);
-int emdld(int*, float*, const char*, const char*);
+int emdldh(libtau*, const char*, const char*);
+static void tblread(const libtau *h, long offset, double *buf, int n);
 
 
 int tabin(libtau *h, const char *model) {
@@ -39,6 +40,10 @@ fp10 = fopen("ttim1.lis", "wb");
 	h->deplim = 1.1;
 	h->D = 0;
 	h->fpin = NULL;
+	h->tbl = NULL;
+	h->tbllen = 0;
+	h->owner = 1;
+	h->nz = 0;
 
 	if(model == NULL)
 	{
@@ -106,6 +111,25 @@ fp10 = fopen("ttim1.lis", "wb");
 		return(-2);
 	}
 
+	/* Keep the whole table in memory to not depend on the file position
+	   which would prevent sharing the table between handles */
+	if(fseek(h->fpin, 0, SEEK_END) == 0) h->tbllen = ftell(h->fpin);
+	if(h->tbllen <= 0 || fseek(h->fpin, 0, SEEK_SET) != 0 ||
+	   (h->tbl = (char *)malloc(h->tbllen)) == NULL ||
+	   fread(h->tbl, 1, h->tbllen, h->fpin) != (size_t)h->tbllen)
+	{
+		fclose(h->fpin);
+		h->fpin = NULL;
+		free(h->tbl);
+		h->tbl = NULL;
+		h->tbllen = 0;
+		free(modl);
+		return(-2);
+	}
+
+	fclose(h->fpin);
+	h->fpin = NULL;
+
 	h->v[0].pu[h->ku[0]] = h->v[0].pm[0];
 	h->v[1].pu[h->ku[1]] = h->v[1].pm[0];
 
@@ -188,11 +212,40 @@ fp10 = fopen("ttim1.lis", "wb");
 
 	free(modl);
 
-	emdld(&h->np, h->rd, model, "");
+	emdldh(h, model, "");
 
 	return(0);
 }
 
+/* Initializes dst as a copy of src without reading the tables again. The
+   table read by depcor is shared and must outlive dst. */
+int tabcopy(libtau *dst, const libtau *src) {
+	int i, j;
+
+	memcpy(dst, src, sizeof(libtau));
+
+	/* The phase codes of both depth structures refer to the first one */
+	for ( j = 0; j < 2; j++ )
+		for ( i = 0; i < jbrn; i++ )
+			dst->depths[j].phcd[i] = dst->depths[0].phcd_buf+i*10;
+
+	dst->fpin = NULL;
+	dst->owner = 0;
+
+	if ( src->allocated ) {
+		for ( i = 0; i < jseg; i++ ) {
+			dst->phlst[i] = (char *)malloc(10);
+			memcpy(dst->phlst[i], src->phlst[i], 10);
+		}
+		for ( i = 0; i < jbrn; i++ ) {
+			dst->segcd[i] = (char *)malloc(10);
+			memcpy(dst->segcd[i], src->segcd[i], 10);
+		}
+	}
+
+	return 0;
+}
+
 int tabout(libtau *h) {
 	int i;
 
@@ -202,8 +255,18 @@ int tabout(libtau *h) {
 		h->allocated = 0;
 	}
 
+	if ( h->owner && h->tbl ) {
+		free(h->tbl);
+		h->tbl = NULL;
+		h->tbllen = 0;
+	}
+
 	if(h->fpin)
-		return fclose(h->fpin);
+	{
+		i = fclose(h->fpin);
+		h->fpin = NULL;
+		return i;
+	}
 
 	return 0;
 }
@@ -406,6 +469,19 @@ void brnset(libtau *h, const char *branch)
 	}
 }
 
+static void tblread(const libtau *h, long offset, double *buf, int n) {
+	long avail = h->tbllen - offset;
+	long len = (long)n * 8;
+
+	if ( offset < 0 || avail < 0 ) avail = 0;
+	if ( len > avail ) {
+		memset(buf, 0, len);
+		len = avail;
+	}
+
+	if ( len > 0 ) memcpy(buf, h->tbl + offset, len);
+}
+
 static void depcor(libtau *h, int nph) {
 	int i, j, k, l, k1, k2, ks, ms, mu, is, iph, lp; 
 	char noend, noext, do_integral, shallow;
@@ -482,8 +558,7 @@ static void depcor(libtau *h, int nph) {
 fprintf(fp10, "first read ks= %d\n", ks);
 printf("loc = %d\n",v[nph].loc[ks]);
 */
-			fseek(h->fpin, h->v[nph].loc[ks], 0);
-			fread(tup, 8, h->ku[nph]+h->km[nph], h->fpin);
+			tblread(h, h->v[nph].loc[ks], tup, h->ku[nph]+h->km[nph]);
 			/* 
 			 * Move the depth correction values to a less
 			 * temporary area.
@@ -526,8 +601,7 @@ printf("loc = %d\n",v[nph].loc[ks]);
 /*
 fprintf(fp10, "second read ks= %d\n", ks);
 */
-			fseek(h->fpin, h->v[nph].loc[ks], 0);
-			fread(tup, 8, h->ku[nph]+h->km[nph], h->fpin);
+			tblread(h, h->v[nph].loc[ks], tup, h->ku[nph]+h->km[nph]);
 			/* 
 			 * Move the depth correction values to a less
 			 * temporary area.
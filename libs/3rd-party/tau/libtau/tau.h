@@ -61,6 +61,16 @@ typedef struct {
 
 	char *phlst[jseg], *segcd[jbrn], phtmp[10];
 	int allocated;
+
+	/* The content of the .tbl file which is read by depcor. It is owned
+	   by the handle created with tabin and shared by its copies. */
+	char *tbl;
+	long tbllen;
+	int owner;
+
+	/* The velocity model used by emdlvh */
+	int nz;
+	float zin[jvel], vpin[jvel], vsin[jvel];
 } libtau;
 
 
@@ -68,7 +78,9 @@ void brnset(libtau *h, const char *branch);
 void depset(libtau *h, float zs);
 void trtm(libtau *, float delta, int *pn, float *tt, float *ray_p, float *dtdd, float *dtdh, float *dddp, char **phnm);
 int emdlv(float r, float *vp, float *vs);
+int emdlvh(const libtau *h, float r, float *vp, float *vs);
 int tabin(libtau *h, const char *);
+int tabcopy(libtau *dst, const libtau *src);
 int tabout(libtau *h);
 
 # endif
@@ -20,6 +20,7 @@
 #define jxsm	jbrn
 #define jbrnu	jbrn
 #define jbrna	jbrn
+#define jvel	200
 /*
  * A few derived parameters are also needed.
  */
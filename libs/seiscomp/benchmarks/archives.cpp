@@ -0,0 +1,213 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/datamodel/amplitude.h>
+#include <seiscomp/datamodel/arrival.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/io/archive/binarchive.h>
+#include <seiscomp/io/archive/jsonarchive.h>
+
+#include "benchmark.h"
+
+#include <sstream>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Creates a notifier message as sent by a picker and a locator
+NotifierMessagePtr createMessage() {
+	NotifierMessagePtr msg = new NotifierMessage;
+	Core::Time t(2024, 3, 1, 12, 0, 0, 123400);
+
+	CreationInfo ci;
+	ci.setAgencyID("GFZ");
+	ci.setAuthor("scautopick@host");
+	ci.setCreationTime(t);
+
+	PickPtr pick = Pick::Create("Pick/20240301120000.123456.GE.UGM..BHZ");
+	pick->setTime(TimeQuantity(t, 0.05));
+	pick->setWaveformID(WaveformStreamID("GE", "UGM", "", "BHZ", ""));
+	pick->setPhaseHint(Phase("P"));
+	pick->setEvaluationMode(EvaluationMode(AUTOMATIC));
+	pick->setCreationInfo(ci);
+	msg->attach(new Notifier("EventParameters", OP_ADD, pick.get()));
+
+	AmplitudePtr amp = Amplitude::Create("Amplitude/20240301120001.234567.GE.UGM..BHZ.mb");
+	amp->setType("mb");
+	amp->setAmplitude(RealQuantity(123.45));
+	amp->setPickID(pick->publicID());
+	amp->setWaveformID(pick->waveformID());
+	amp->setCreationInfo(ci);
+	msg->attach(new Notifier("EventParameters", OP_ADD, amp.get()));
+
+	OriginPtr org = Origin::Create("Origin/20240301120100.345678.123456");
+	org->setTime(TimeQuantity(t));
+	org->setLatitude(RealQuantity(-7.9));
+	org->setLongitude(RealQuantity(110.5));
+	org->setCreationInfo(ci);
+
+	for ( int i = 0; i < 20; ++i ) {
+		ArrivalPtr arr = new Arrival;
+		arr->setPickID(pick->publicID() + Core::toString(i));
+		arr->setPhase(Phase("P"));
+		arr->setDistance(i * 0.5);
+		arr->setAzimuth(i * 10.0);
+		arr->setTimeResidual(0.1);
+		arr->setWeight(1.0);
+		org->add(arr.get());
+	}
+
+	msg->attach(new Notifier("EventParameters", OP_ADD, org.get()));
+
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encodeBinary(Core::Message *msg) {
+	string blob;
+	IO::VBinaryArchive ar;
+	ar.create(blob);
+	ar << msg;
+	ar.close();
+	return blob;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encodeJSON(Core::Message *msg) {
+	ostringstream os;
+	IO::JSONArchive ar;
+	ar.create(&os);
+	ar << msg;
+	ar.close();
+	return os.str();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Archives, BinaryEncode) {
+	NotifierMessagePtr msg = createMessage();
+	size_t bytes = 0;
+
+	while ( ctx.running() ) {
+		bytes = encodeBinary(msg.get()).size();
+		Benchmark::keep(bytes);
+	}
+
+	ctx.setItemsPerIteration(1);
+	ctx.setBytesPerIteration(bytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Archives, BinaryDecode) {
+	NotifierMessagePtr msg = createMessage();
+	string blob = encodeBinary(msg.get());
+
+	// Decoded objects are not registered to not clash with the originals
+	PublicObject::SetRegistrationEnabled(false);
+
+	while ( ctx.running() ) {
+		Core::Message *decoded = nullptr;
+		IO::VBinaryArchive ar;
+		if ( ar.open(blob.data(), blob.size()) )
+			ar >> decoded;
+		Core::MessagePtr keeper(decoded);
+		Benchmark::keep(decoded);
+	}
+
+	PublicObject::SetRegistrationEnabled(true);
+
+	ctx.setItemsPerIteration(1);
+	ctx.setBytesPerIteration(blob.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Archives, JSONEncode) {
+	NotifierMessagePtr msg = createMessage();
+	size_t bytes = 0;
+
+	while ( ctx.running() ) {
+		bytes = encodeJSON(msg.get()).size();
+		Benchmark::keep(bytes);
+	}
+
+	ctx.setItemsPerIteration(1);
+	ctx.setBytesPerIteration(bytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Archives, JSONDecode) {
+	NotifierMessagePtr msg = createMessage();
+	string blob = encodeJSON(msg.get());
+
+	PublicObject::SetRegistrationEnabled(false);
+
+	while ( ctx.running() ) {
+		Core::Message *decoded = nullptr;
+		IO::JSONArchive ar;
+		if ( ar.from(blob.c_str()) )
+			ar >> decoded;
+		Core::MessagePtr keeper(decoded);
+		Benchmark::keep(decoded);
+	}
+
+	PublicObject::SetRegistrationEnabled(true);
+
+	ctx.setItemsPerIteration(1);
+	ctx.setBytesPerIteration(blob.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,141 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace Seiscomp {
+namespace Benchmark {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Context::Context(uint64_t iterations)
+: _iterations(iterations), _remaining(iterations) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double Context::elapsed() const {
+	return std::chrono::duration<double, std::nano>(_stop - _start).count();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::vector<Definition> &Registry() {
+	static std::vector<Definition> registry;
+	return registry;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Register(const char *group, const char *name, Function function) {
+	auto &registry = Registry();
+	Definition def{group, name, function};
+	// Keep the registry sorted to get a stable order independent of the
+	// link order of the translation units
+	auto it = std::upper_bound(registry.begin(), registry.end(), def,
+	                           [](const Definition &a, const Definition &b) {
+		return a.fullName() < b.fullName();
+	});
+	registry.insert(it, def);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Run(const Definition &def, const Options &options) {
+	Result result;
+	result.group = def.group;
+	result.name = def.name;
+
+	double minTime = options.minTime * 1E9;
+	uint64_t iterations = 1;
+
+	// Calibrate the number of iterations
+	while ( true ) {
+		Context ctx(iterations);
+		def.function(ctx);
+
+		if ( !ctx.skipped().empty() ) {
+			result.skipped = ctx.skipped();
+			return result;
+		}
+
+		double elapsed = ctx.elapsed();
+		if ( elapsed >= minTime || iterations >= (uint64_t(1) << 40) )
+			break;
+
+		// Extrapolate with some headroom but grow at most by a factor
+		// of 100 to be robust against a noisy first measurement
+		double factor = elapsed > 0 ? 1.4 * minTime / elapsed : 100;
+		factor = std::min(std::max(factor, 2.0), 100.0);
+		iterations = uint64_t(std::ceil(iterations * factor));
+	}
+
+	std::vector<double> times;
+	int repetitions = std::max(options.repetitions, 1);
+
+	for ( int i = 0; i < repetitions; ++i ) {
+		Context ctx(iterations);
+		def.function(ctx);
+		times.push_back(ctx.elapsed() / iterations);
+		result.itemsPerIteration = ctx.itemsPerIteration();
+		result.bytesPerIteration = ctx.bytesPerIteration();
+	}
+
+	std::sort(times.begin(), times.end());
+
+	result.iterations = iterations;
+	result.minimum = times.front();
+	result.median = (times.size() % 2) ?
+	                times[times.size() / 2] :
+	                (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+
+	double sum = 0;
+	for ( auto t : times ) sum += t;
+	result.mean = sum / times.size();
+
+	double dev = 0;
+	for ( auto t : times ) dev += (t - result.mean) * (t - result.mean);
+	result.stddev = times.size() > 1 ? std::sqrt(dev / (times.size() - 1)) : 0;
+
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
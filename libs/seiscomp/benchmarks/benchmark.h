@@ -0,0 +1,171 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_BENCHMARKS_BENCHMARK_H
+#define SEISCOMP_BENCHMARKS_BENCHMARK_H
+
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Benchmark {
+
+
+/**
+ * @brief The Context class drives the iterations of a benchmark and
+ *        collects its metadata.
+ *
+ * A benchmark is a function which prepares its input and then loops while
+ * running() returns true. Only the time spent in the loop is measured.
+ * @code
+ * SC_BENCHMARK(Math, Delazi) {
+ *     double d, a, b;
+ *     while ( ctx.running() )
+ *         Math::Geo::delazi(0, 0, 10, 10, &d, &a, &b);
+ * }
+ * @endcode
+ */
+class Context {
+	public:
+		explicit Context(uint64_t iterations);
+
+	public:
+		//! Returns true as long as iterations are left. The first call
+		//! starts the clock, the last call stops it.
+		bool running() {
+			if ( _remaining ) {
+				if ( _remaining-- == _iterations )
+					_start = std::chrono::steady_clock::now();
+				return true;
+			}
+
+			_stop = std::chrono::steady_clock::now();
+			return false;
+		}
+
+		//! Sets the number of items processed per iteration, e.g. samples
+		//! or messages. It is used to report the throughput.
+		void setItemsPerIteration(uint64_t items) { _items = items; }
+
+		//! Sets the number of bytes processed per iteration
+		void setBytesPerIteration(uint64_t bytes) { _bytes = bytes; }
+
+		//! Marks the benchmark as skipped, e.g. if required data files are
+		//! not available. The benchmark function should return afterwards.
+		void skip(const std::string &reason) { _skipped = reason; }
+
+		uint64_t iterations() const { return _iterations; }
+		uint64_t itemsPerIteration() const { return _items; }
+		uint64_t bytesPerIteration() const { return _bytes; }
+		const std::string &skipped() const { return _skipped; }
+
+		//! The elapsed time of the loop in nanoseconds
+		double elapsed() const;
+
+	private:
+		uint64_t                              _iterations;
+		uint64_t                              _remaining;
+		uint64_t                              _items{0};
+		uint64_t                              _bytes{0};
+		std::string                           _skipped;
+		std::chrono::steady_clock::time_point _start;
+		std::chrono::steady_clock::time_point _stop;
+};
+
+
+using Function = std::function<void (Context &)>;
+
+
+struct Definition {
+	std::string group;
+	std::string name;
+	Function    function;
+
+	std::string fullName() const { return group + "/" + name; }
+};
+
+
+//! The result of all repetitions of a benchmark
+struct Result {
+	std::string group;
+	std::string name;
+	std::string skipped;
+	uint64_t    iterations{0};
+	uint64_t    itemsPerIteration{0};
+	uint64_t    bytesPerIteration{0};
+	double      minimum{0};  //!< Time per iteration in ns
+	double      median{0};   //!< Time per iteration in ns
+	double      mean{0};     //!< Time per iteration in ns
+	double      stddev{0};   //!< Standard deviation of the time in ns
+};
+
+
+struct Options {
+	//! The minimum duration of a single repetition in seconds
+	double      minTime{0.2};
+	//! The number of repetitions
+	int         repetitions{5};
+	//! Only benchmarks whose full name contains the filter are run
+	std::string filter;
+};
+
+
+//! Returns all registered benchmarks sorted by group and name
+std::vector<Definition> &Registry();
+
+bool Register(const char *group, const char *name, Function function);
+
+//! Runs a single benchmark. The number of iterations is calibrated so that
+//! a repetition takes at least options.minTime seconds.
+Result Run(const Definition &def, const Options &options);
+
+
+/**
+ * @brief Prevents the compiler from optimizing away the computation of
+ *        a value which is otherwise unused.
+ */
+template <typename T>
+inline void keep(const T &value) {
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const T *sink;
+	sink = &value;
+#endif
+}
+
+
+}
+}
+
+
+#define SC_BENCHMARK(GROUP, NAME) \
+	static void __sc_benchmark_##GROUP##_##NAME(Seiscomp::Benchmark::Context &ctx); \
+	[[maybe_unused]] static bool __sc_benchmark_##GROUP##_##NAME##_registered = \
+		Seiscomp::Benchmark::Register(#GROUP, #NAME, __sc_benchmark_##GROUP##_##NAME); \
+	static void __sc_benchmark_##GROUP##_##NAME(Seiscomp::Benchmark::Context &ctx)
+
+
+#endif
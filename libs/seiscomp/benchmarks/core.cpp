@@ -0,0 +1,133 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/datetime.h>
+
+#include "benchmark.h"
+
+#include <string>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+const size_t TimeCount = 1000;
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Pick times spread over several years with varying fractions
+vector<Core::Time> createTimes() {
+	vector<Core::Time> times(TimeCount);
+	for ( size_t i = 0; i < TimeCount; ++i )
+		times[i] = Core::Time(1500000000L + long(i) * 123457L, long(i * 7919 % 1000000));
+	return times;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Time, ToISO) {
+	vector<Core::Time> times = createTimes();
+
+	while ( ctx.running() ) {
+		for ( const auto &time : times ) {
+			string str = time.iso();
+			Benchmark::keep(str);
+		}
+	}
+
+	ctx.setItemsPerIteration(times.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! A format without fast path for comparison
+SC_BENCHMARK(Time, ToString) {
+	vector<Core::Time> times = createTimes();
+
+	while ( ctx.running() ) {
+		for ( const auto &time : times ) {
+			string str = time.toString("%Y-%m-%dT%H:%M:%S.%fZ");
+			Benchmark::keep(str);
+		}
+	}
+
+	ctx.setItemsPerIteration(times.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Time, FromISO) {
+	vector<string> strings;
+	for ( const auto &time : createTimes() )
+		strings.push_back(time.iso());
+
+	while ( ctx.running() ) {
+		for ( const auto &str : strings ) {
+			Core::Time time;
+			time.fromString(str);
+			Benchmark::keep(time);
+		}
+	}
+
+	ctx.setItemsPerIteration(strings.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! A format without fast path for comparison
+SC_BENCHMARK(Time, FromString) {
+	vector<string> strings;
+	for ( const auto &time : createTimes() )
+		strings.push_back(time.toString("%Y-%m-%dT%H:%M:%S.%f"));
+
+	while ( ctx.running() ) {
+		for ( const auto &str : strings ) {
+			Core::Time time;
+			time.fromString(str.c_str(), "%Y-%m-%dT%H:%M:%S.%f");
+			Benchmark::keep(time);
+		}
+	}
+
+	ctx.setItemsPerIteration(strings.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,260 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/datamodel/inventory.h>
+#include <seiscomp/datamodel/objectarena.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/io/archive/binarchive.h>
+
+#include "benchmark.h"
+
+#include <thread>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Creates an inventory with 20 networks of 50 stations with three
+//! channels each
+InventoryPtr createInventory() {
+	InventoryPtr inv = new Inventory;
+	Core::Time start(2010, 1, 1);
+
+	for ( int n = 0; n < 20; ++n ) {
+		string net = "N" + Core::toString(n);
+		NetworkPtr network = Network::Create("Network/" + net);
+		network->setCode(net);
+		network->setStart(start);
+		inv->add(network.get());
+
+		for ( int s = 0; s < 50; ++s ) {
+			string sta = "S" + Core::toString(s);
+			StationPtr station = Station::Create("Station/" + net + "/" + sta);
+			station->setCode(sta);
+			station->setStart(start);
+			station->setLatitude(n);
+			station->setLongitude(s);
+			network->add(station.get());
+
+			SensorLocationPtr loc = SensorLocation::Create("SensorLocation/" + net + "/" + sta + "/00");
+			loc->setCode("00");
+			loc->setStart(start);
+			station->add(loc.get());
+
+			for ( const char *cha : { "HHZ", "HHN", "HHE" } ) {
+				StreamPtr stream = Stream::Create("Stream/" + net + "/" + sta + "/00/" + cha);
+				stream->setCode(cha);
+				stream->setStart(start);
+				stream->setSampleRateNumerator(100);
+				stream->setSampleRateDenominator(1);
+				loc->add(stream.get());
+			}
+		}
+	}
+
+	return inv;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Encodes the inventory and returns the number of public objects
+size_t encodeInventory(string &blob) {
+	// Decoding registers all public objects of the inventory, the original
+	// is released first to not clash with the decoded copies
+	InventoryPtr inv = createInventory();
+	size_t objects = PublicObject::ObjectCount();
+	IO::VBinaryArchive ar;
+	ar.create(blob);
+	ar << inv;
+	ar.close();
+	return objects;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+InventoryPtr decodeInventory(const string &blob) {
+	InventoryPtr inv;
+	IO::VBinaryArchive ar;
+	if ( ar.open(blob.data(), blob.size()) )
+		ar >> inv;
+	return inv;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <bool Arena>
+void releaseInventories(Benchmark::Context &ctx) {
+	// All inventories are decoded before the clock starts, each iteration
+	// releases one of them. The copies are not registered to not clash
+	// with each other.
+	string blob;
+	size_t objects = encodeInventory(blob);
+
+	PublicObject::SetRegistrationEnabled(false);
+	vector<InventoryPtr> inventories;
+	for ( uint64_t i = 0; i < ctx.iterations(); ++i ) {
+		if ( Arena ) {
+			ObjectArena::Scope arena;
+			inventories.push_back(decodeInventory(blob));
+		}
+		else
+			inventories.push_back(decodeInventory(blob));
+	}
+	PublicObject::SetRegistrationEnabled(true);
+
+	while ( ctx.running() )
+		inventories.pop_back();
+
+	ctx.setItemsPerIteration(objects);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(DataModel, InventoryLoad) {
+	string blob;
+	size_t objects = encodeInventory(blob);
+
+	while ( ctx.running() ) {
+		InventoryPtr inv = decodeInventory(blob);
+		Benchmark::keep(inv.get());
+	}
+
+	ctx.setItemsPerIteration(objects);
+	ctx.setBytesPerIteration(blob.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(DataModel, InventoryLoadArena) {
+	string blob;
+	size_t objects = encodeInventory(blob);
+
+	while ( ctx.running() ) {
+		ObjectArena::Scope arena;
+		InventoryPtr inv = decodeInventory(blob);
+		Benchmark::keep(inv.get());
+	}
+
+	ctx.setItemsPerIteration(objects);
+	ctx.setBytesPerIteration(blob.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(DataModel, InventoryRelease) {
+	releaseInventories<false>(ctx);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(DataModel, InventoryReleaseArena) {
+	releaseInventories<true>(ctx);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(DataModel, PublicObjectFind) {
+	InventoryPtr inv = createInventory();
+	vector<string> ids;
+
+	for ( size_t n = 0; n < inv->networkCount(); ++n ) {
+		Network *net = inv->network(n);
+		for ( size_t s = 0; s < net->stationCount(); ++s )
+			ids.push_back(net->station(s)->publicID());
+	}
+
+	while ( ctx.running() ) {
+		for ( const string &id : ids )
+			Benchmark::keep(PublicObject::Find(id));
+	}
+
+	ctx.setItemsPerIteration(ids.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(DataModel, PublicObjectRegisterParallel) {
+	// Each thread creates and destroys its own objects which stresses
+	// the locking of the registry
+	const size_t objectsPerThread = 1000;
+	size_t threadCount = max(2u, thread::hardware_concurrency());
+
+	while ( ctx.running() ) {
+		vector<thread> threads;
+		for ( size_t t = 0; t < threadCount; ++t ) {
+			threads.emplace_back([t, objectsPerThread]() {
+				vector<PublicObjectPtr> objects;
+				objects.reserve(objectsPerThread);
+				string prefix = "Pick/" + Core::toString(t) + "/";
+				for ( size_t i = 0; i < objectsPerThread; ++i ) {
+					objects.push_back(Pick::Create(prefix + Core::toString(i)));
+					Benchmark::keep(PublicObject::Find(objects.back()->publicID()));
+				}
+			});
+		}
+
+		for ( auto &t : threads ) t.join();
+	}
+
+	ctx.setItemsPerIteration(threadCount * objectsPerThread);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
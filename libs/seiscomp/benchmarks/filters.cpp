@@ -0,0 +1,184 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/math/filter.h>
+#include <seiscomp/math/mean.h>
+#include <seiscomp/math/filter/butterworth.h>
+#include <seiscomp/math/filter/median.h>
+#include <seiscomp/math/filter/minmax.h>
+#include <seiscomp/math/filter/stalta.h>
+
+#include "benchmark.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Math;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+const double SamplingFrequency = 100.0;
+const size_t TraceLength = 10000;
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+vector<T> createTrace() {
+	vector<T> trace(TraceLength);
+	uint32_t seed = 4711;
+	for ( size_t i = 0; i < trace.size(); ++i ) {
+		seed = seed * 1103515245 + 12345;
+		double t = i / SamplingFrequency;
+		trace[i] = T(100 * sin(t * 2 * M_PI * 1.5) + ((seed >> 16) % 200) * 0.1 - 10);
+	}
+	return trace;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Applies the filter to a fresh copy of the trace in each iteration. The
+//! filter state is continued as in real time processing.
+template <typename T>
+void run(Benchmark::Context &ctx, Filtering::InPlaceFilter<T> &filter) {
+	const vector<T> trace = createTrace<T>();
+	vector<T> data(trace.size());
+	filter.setSamplingFrequency(SamplingFrequency);
+
+	while ( ctx.running() ) {
+		copy(trace.begin(), trace.end(), data.begin());
+		filter.apply(int(data.size()), data.data());
+		Benchmark::keep(data[data.size() / 2]);
+	}
+
+	ctx.setItemsPerIteration(trace.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Filters, ButterworthBandpassDouble) {
+	Filtering::IIR::ButterworthBandpass<double> filter(3, 0.7, 2.0);
+	run(ctx, filter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Filters, ButterworthBandpassFloat) {
+	Filtering::IIR::ButterworthBandpass<float> filter(3, 0.7, 2.0);
+	run(ctx, filter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Filters, STALTA) {
+	Filtering::STALTA<double> filter(2, 50);
+	run(ctx, filter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Filters, PickerChain) {
+	// The default filter chain of scautopick
+	unique_ptr<Filtering::InPlaceFilter<double>> filter(
+		Filtering::InPlaceFilter<double>::Create("RMHP(10)>>ITAPER(30)>>BW(4,0.7,2)>>STALTA(2,80)")
+	);
+
+	if ( !filter ) {
+		ctx.skip("filter chain not available");
+		return;
+	}
+
+	run(ctx, *filter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Filters, Median1s) {
+	Filtering::Median<double> filter(1.0);
+	run(ctx, filter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Filters, Max1s) {
+	Filtering::Max<double> filter(1.0);
+	run(ctx, filter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Statistics, Median) {
+	const vector<double> trace = createTrace<double>();
+
+	while ( ctx.running() )
+		Benchmark::keep(Statistics::median(trace));
+
+	ctx.setItemsPerIteration(trace.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Statistics, Rms) {
+	const vector<double> trace = createTrace<double>();
+
+	while ( ctx.running() )
+		Benchmark::keep(Statistics::rms(trace));
+
+	ctx.setItemsPerIteration(trace.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,289 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/version.h>
+
+#include "benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+using namespace std;
+using namespace Seiscomp;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void usage(const char *prog) {
+	cerr << "Usage: " << prog << " [options]" << endl
+	     << endl
+	     << "Runs microbenchmarks of the core libraries." << endl
+	     << endl
+	     << "Options:" << endl
+	     << "  -l, --list              List available benchmarks and exit" << endl
+	     << "  -f, --filter TEXT       Only run benchmarks whose name contains TEXT" << endl
+	     << "  -r, --repetitions N     Number of repetitions, default 5" << endl
+	     << "  -t, --min-time SECONDS  Minimum duration of a repetition, default 0.2" << endl
+	     << "      --format FORMAT     Output format: console, csv or json" << endl
+	     << "  -o, --output FILE       Write results to FILE instead of stdout" << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string jsonString(const string &str) {
+	string out = "\"";
+	for ( char c : str ) {
+		switch ( c ) {
+			case '"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			default: out += c; break;
+		}
+	}
+	out += '"';
+	return out;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double itemsPerSecond(const Benchmark::Result &res) {
+	return res.median > 0 ? res.itemsPerIteration * 1E9 / res.median : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double bytesPerSecond(const Benchmark::Result &res) {
+	return res.median > 0 ? res.bytesPerIteration * 1E9 / res.median : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printConsoleHeader(ostream &os) {
+	os << left << setw(40) << "Benchmark"
+	   << right << setw(14) << "Median ns" << setw(14) << "Min ns"
+	   << setw(10) << "Stddev" << setw(14) << "Iterations"
+	   << setw(16) << "Items/s" << endl
+	   << string(108, '-') << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printConsole(ostream &os, const Benchmark::Result &res) {
+	os << left << setw(40) << (res.group + "/" + res.name) << right;
+	if ( !res.skipped.empty() ) {
+		os << "  skipped: " << res.skipped << endl;
+		return;
+	}
+
+	os << fixed << setprecision(1)
+	   << setw(14) << res.median << setw(14) << res.minimum
+	   << setw(10) << res.stddev << setw(14) << res.iterations;
+
+	if ( res.itemsPerIteration )
+		os << setw(16) << setprecision(0) << itemsPerSecond(res);
+
+	os << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printCSVHeader(ostream &os) {
+	os << "group,name,iterations,median_ns,min_ns,mean_ns,stddev_ns,"
+	      "items_per_second,bytes_per_second,skipped" << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printCSV(ostream &os, const Benchmark::Result &res) {
+	os << res.group << ',' << res.name << ',' << res.iterations << ','
+	   << fixed << setprecision(3)
+	   << res.median << ',' << res.minimum << ',' << res.mean << ','
+	   << res.stddev << ',' << setprecision(0)
+	   << itemsPerSecond(res) << ',' << bytesPerSecond(res) << ','
+	   << res.skipped << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printJSON(ostream &os, const vector<Benchmark::Result> &results,
+               const Benchmark::Options &options) {
+	os << "{" << endl
+	   << "  \"context\": {" << endl
+	   << "    \"version\": " << jsonString(Core::CurrentVersion.toString()) << "," << endl
+	   << "    \"date\": " << jsonString(Core::Time::UTC().iso()) << "," << endl
+	   << "    \"repetitions\": " << options.repetitions << "," << endl
+	   << "    \"min_time\": " << options.minTime << endl
+	   << "  }," << endl
+	   << "  \"benchmarks\": [";
+
+	bool first = true;
+	for ( const auto &res : results ) {
+		os << (first ? "" : ",") << endl
+		   << "    {\"group\": " << jsonString(res.group)
+		   << ", \"name\": " << jsonString(res.name);
+		first = false;
+
+		if ( !res.skipped.empty() ) {
+			os << ", \"skipped\": " << jsonString(res.skipped) << "}";
+			continue;
+		}
+
+		os << fixed << setprecision(3)
+		   << ", \"iterations\": " << res.iterations
+		   << ", \"median_ns\": " << res.median
+		   << ", \"min_ns\": " << res.minimum
+		   << ", \"mean_ns\": " << res.mean
+		   << ", \"stddev_ns\": " << res.stddev
+		   << setprecision(0)
+		   << ", \"items_per_second\": " << itemsPerSecond(res)
+		   << ", \"bytes_per_second\": " << bytesPerSecond(res) << "}";
+	}
+
+	os << endl << "  ]" << endl << "}" << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int main(int argc, char **argv) {
+	Benchmark::Options options;
+	string format = "console";
+	string output;
+	bool list = false;
+
+	for ( int i = 1; i < argc; ++i ) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if ( arg == "-h" || arg == "--help" ) {
+			usage(argv[0]);
+			return EXIT_SUCCESS;
+		}
+		else if ( arg == "-l" || arg == "--list" )
+			list = true;
+		else if ( (arg == "-f" || arg == "--filter") && hasValue )
+			options.filter = argv[++i];
+		else if ( (arg == "-r" || arg == "--repetitions") && hasValue )
+			options.repetitions = atoi(argv[++i]);
+		else if ( (arg == "-t" || arg == "--min-time") && hasValue )
+			options.minTime = atof(argv[++i]);
+		else if ( arg == "--format" && hasValue )
+			format = argv[++i];
+		else if ( (arg == "-o" || arg == "--output") && hasValue )
+			output = argv[++i];
+		else {
+			cerr << "Invalid argument: " << arg << endl;
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if ( format != "console" && format != "csv" && format != "json" ) {
+		cerr << "Invalid format: " << format << endl;
+		return EXIT_FAILURE;
+	}
+
+	if ( list ) {
+		for ( const auto &def : Benchmark::Registry() )
+			cout << def.fullName() << endl;
+		return EXIT_SUCCESS;
+	}
+
+	ofstream ofs;
+	if ( !output.empty() ) {
+		ofs.open(output.c_str());
+		if ( !ofs.is_open() ) {
+			cerr << "Failed to open output file: " << output << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	ostream &os = output.empty() ? cout : ofs;
+	vector<Benchmark::Result> results;
+
+	if ( format == "console" )
+		printConsoleHeader(os);
+	else if ( format == "csv" )
+		printCSVHeader(os);
+
+	for ( const auto &def : Benchmark::Registry() ) {
+		if ( !options.filter.empty() &&
+		     def.fullName().find(options.filter) == string::npos )
+			continue;
+
+		Benchmark::Result res = Benchmark::Run(def, options);
+
+		if ( format == "console" )
+			printConsole(os, res);
+		else if ( format == "csv" )
+			printCSV(os, res);
+		else
+			results.push_back(res);
+
+		// Show progress on the console if results go to a file
+		if ( !output.empty() && format != "console" )
+			printConsole(cerr, res);
+	}
+
+	if ( format == "json" )
+		printJSON(os, results, options);
+
+	return EXIT_SUCCESS;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
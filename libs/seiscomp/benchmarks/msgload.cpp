@@ -0,0 +1,764 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/version.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/messaging/protocol.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Client;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+using Clock = chrono::steady_clock;
+
+
+struct Options {
+	string         address{"localhost/playback"};
+	vector<string> groups{"PICK"};
+	int            publishers{1};
+	int            subscribers{1};
+	uint64_t       count{10000};
+	double         rate{0};
+	size_t         size{1000};
+	int            batch{0};
+	double         drainTime{5};
+	bool           transient{false};
+	bool           decode{false};
+	string         format{"console"};
+	string         output;
+
+	Protocol::ContentEncoding encoding{Protocol::Identity};
+	Protocol::ContentType     contentType{Protocol::Binary};
+};
+
+
+/**
+ * A publisher records the send time of each message. The broker keeps
+ * the order of the messages of one sender, the n-th message of a
+ * publisher received by a subscriber is therefore its n-th sent message
+ * and the send time can be looked up without adding it to the payload.
+ */
+struct Publisher {
+	string                        name;
+	string                        group;
+	unique_ptr<atomic<int64_t>[]> sendTimes;
+	uint64_t                      sent{0};
+	uint64_t                      failed{0};
+	uint64_t                      bytesSent{0};
+	Clock::time_point             finished;
+	string                        error;
+};
+
+
+struct Subscriber {
+	string            name;
+	vector<uint32_t>  latencies; // In microseconds
+	vector<uint64_t>  receivedFrom;
+	uint64_t          received{0};
+	uint64_t          unknown{0};
+	uint64_t          decodingErrors{0};
+	uint64_t          bytesReceived{0};
+	Clock::time_point lastReceived;
+	string            error;
+};
+
+
+struct Report {
+	double   duration{0};
+	uint64_t sent{0};
+	uint64_t failed{0};
+	uint64_t expected{0};
+	uint64_t received{0};
+	uint64_t dropped{0};
+	uint64_t decodingErrors{0};
+	uint64_t bytesSent{0};
+	uint64_t bytesReceived{0};
+	size_t   payloadSize{0};
+	double   latencyMean{0};
+	double   latencyMax{0};
+	vector<pair<double, double>> percentiles; // In milliseconds
+};
+
+
+atomic<bool> publishing{true};
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void usage(const char *prog) {
+	cerr << "Usage: " << prog << " [options]" << endl
+	     << endl
+	     << "Generates publisher and subscriber load against a running messaging" << endl
+	     << "broker and reports the end-to-end latency, throughput and drops." << endl
+	     << "Use a queue without processors, e.g. playback, not production." << endl
+	     << endl
+	     << "Options:" << endl
+	     << "  -H, --host URL          Broker URL, default localhost/playback" << endl
+	     << "  -g, --groups LIST       Comma separated groups the publishers send to" << endl
+	     << "                          round-robin, default PICK. Subscribers" << endl
+	     << "                          subscribe to all groups." << endl
+	     << "  -p, --publishers N      Number of publishing clients, default 1" << endl
+	     << "  -s, --subscribers N     Number of subscribing clients, default 1" << endl
+	     << "  -n, --count N           Messages per publisher, default 10000" << endl
+	     << "  -r, --rate N            Messages per second and publisher, default" << endl
+	     << "                          0 (unlimited)" << endl
+	     << "  -b, --size BYTES        Minimum encoded message size, default 1000" << endl
+	     << "  -e, --encoding NAME     identity, deflate, gzip, lz4 or lz4-dict" << endl
+	     << "  -c, --content-type NAME binary, json, bson or xml" << endl
+	     << "      --batch N           Send N messages per batch" << endl
+	     << "      --transient         Send transient instead of regular messages" << endl
+	     << "      --decode            Decode each received message" << endl
+	     << "      --drain SECONDS     Time to wait for outstanding messages after" << endl
+	     << "                          publishing, default 5" << endl
+	     << "      --format FORMAT     Output format: console, csv or json" << endl
+	     << "  -o, --output FILE       Write results to FILE instead of stdout" << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool parseContentType(Protocol::ContentType &type, const string &name) {
+	static const map<string, Protocol::ContentType> aliases = {
+		{"binary", Protocol::Binary},
+		{"json", Protocol::JSON},
+		{"bson", Protocol::BSON},
+		{"xml", Protocol::XML}
+	};
+
+	auto it = aliases.find(name);
+	if ( it != aliases.end() ) {
+		type = it->second;
+		return true;
+	}
+
+	// Also accept the MIME type
+	return type.fromString(name);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ProtocolPtr connectClient(const Options &options, const string &name,
+                          string &error) {
+	string scheme = "scmp";
+	string address = options.address;
+	size_t pos = address.find("://");
+	if ( pos != string::npos ) {
+		scheme = address.substr(0, pos);
+		address.erase(0, pos + 3);
+	}
+
+	ProtocolPtr proto = ProtocolFactory::Create(scheme.c_str());
+	if ( !proto ) {
+		error = "unknown protocol: " + scheme;
+		return nullptr;
+	}
+
+	Result r = proto->connect(address, 5000, name);
+	if ( !r ) {
+		error = string(r.toString()) + ": " + proto->lastErrorMessage();
+		return nullptr;
+	}
+
+	return proto;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * Creates a notifier message with as many picks as required to reach the
+ * requested size with the configured content type and encoding.
+ */
+bool createPayload(string &payload, const Options &options,
+                   int schemaVersion) {
+	DataModel::PublicObject::SetRegistrationEnabled(false);
+
+	DataModel::NotifierMessagePtr msg = new DataModel::NotifierMessage;
+	Core::Time time = Core::Time::UTC();
+	int index = 0;
+
+	do {
+		DataModel::PickPtr pick = DataModel::Pick::Create(
+			"msgload.Pick." + Core::toString(index)
+		);
+		pick->setTime(DataModel::TimeQuantity(time + Core::TimeSpan(index, 0)));
+		pick->setWaveformID(DataModel::WaveformStreamID("XX", "LOAD", "", "HHZ", ""));
+		pick->setPhaseHint(DataModel::Phase("P"));
+		pick->setEvaluationMode(DataModel::EvaluationMode(DataModel::AUTOMATIC));
+		msg->attach(new DataModel::Notifier("EventParameters", DataModel::OP_ADD, pick.get()));
+		++index;
+
+		if ( !Protocol::encode(payload, msg.get(), options.encoding,
+		                       options.contentType, schemaVersion) ) {
+			DataModel::PublicObject::SetRegistrationEnabled(true);
+			return false;
+		}
+	}
+	while ( payload.size() < options.size );
+
+	DataModel::PublicObject::SetRegistrationEnabled(true);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void publish(Protocol *proto, Publisher *pub, const Options *options,
+             const string *payload, Clock::time_point start) {
+	Protocol::MessageType type = options->transient ?
+	                             Protocol::Transient : Protocol::Regular;
+	chrono::nanoseconds interval(0);
+	if ( options->rate > 0 )
+		interval = chrono::nanoseconds(int64_t(1E9 / options->rate));
+
+	for ( uint64_t i = 0; i < options->count; ++i ) {
+		if ( interval.count() > 0 )
+			this_thread::sleep_until(start + interval * i);
+
+		if ( options->batch > 0 && i % options->batch == 0 )
+			proto->beginBatch();
+
+		// The time is stored before sending because a subscriber might
+		// receive the message before send returns
+		pub->sendTimes[pub->sent].store(
+			chrono::duration_cast<chrono::microseconds>(Clock::now().time_since_epoch()).count(),
+			memory_order_release
+		);
+
+		Result r = proto->sendData(pub->group, payload->data(), payload->size(),
+		                           type, options->encoding, options->contentType);
+		if ( r ) {
+			++pub->sent;
+			pub->bytesSent += payload->size();
+		}
+		else {
+			++pub->failed;
+			if ( !proto->isConnected() ) {
+				pub->error = string(r.toString()) + ": " + proto->lastErrorMessage();
+				break;
+			}
+		}
+
+		if ( options->batch > 0 && (i+1) % options->batch == 0 )
+			proto->endBatch();
+	}
+
+	if ( options->batch > 0 )
+		proto->endBatch();
+
+	// Wait for all messages to be acknowledged
+	proto->syncOutbox();
+	pub->finished = Clock::now();
+	proto->disconnect();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void subscribe(Protocol *proto, Subscriber *sub, const Options *options,
+               const vector<Publisher> *publishers) {
+	map<string, size_t> index;
+	for ( size_t i = 0; i < publishers->size(); ++i )
+		index[(*publishers)[i].name] = i;
+
+	sub->receivedFrom.assign(publishers->size(), 0);
+	uint64_t expected = options->count * publishers->size();
+	sub->latencies.reserve(expected);
+
+	Clock::time_point idleSince;
+	bool drain = false;
+
+	proto->setTimeout(100);
+
+	while ( sub->received < expected ) {
+		Result r;
+		PacketPtr p = proto->recv(&r);
+		if ( !p ) {
+			if ( r.code() != TimeoutError ) {
+				sub->error = string(r.toString()) + ": " + proto->lastErrorMessage();
+				break;
+			}
+
+			if ( publishing )
+				continue;
+
+			if ( !drain ) {
+				drain = true;
+				idleSince = Clock::now();
+			}
+			else if ( chrono::duration<double>(Clock::now() - idleSince).count() > options->drainTime )
+				break;
+
+			continue;
+		}
+
+		if ( p->type != Packet::Data )
+			continue;
+
+		Clock::time_point received = Clock::now();
+		int64_t now = chrono::duration_cast<chrono::microseconds>(received.time_since_epoch()).count();
+
+		drain = false;
+
+		auto it = index.find(p->sender);
+		if ( it == index.end() ) {
+			++sub->unknown;
+			continue;
+		}
+
+		const Publisher &pub = (*publishers)[it->second];
+		uint64_t &n = sub->receivedFrom[it->second];
+		if ( n < options->count ) {
+			int64_t sent = pub.sendTimes[n].load(memory_order_acquire);
+			sub->latencies.push_back(uint32_t(max(now - sent, int64_t(0))));
+		}
+
+		++n;
+		++sub->received;
+		sub->lastReceived = received;
+		sub->bytesReceived += p->payload.size();
+
+		if ( options->decode ) {
+			Protocol::ContentEncoding encoding;
+			Protocol::ContentType type;
+			Core::Message *msg = nullptr;
+			if ( encoding.fromString(p->headerContentEncoding)
+			  && type.fromString(p->headerContentType) )
+				msg = Protocol::decode(p->payload, encoding, type);
+
+			if ( msg )
+				delete msg;
+			else
+				++sub->decodingErrors;
+		}
+	}
+
+	proto->disconnect();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Report createReport(const vector<Publisher> &publishers,
+                    vector<Subscriber> &subscribers, double duration,
+                    size_t payloadSize, const Options &options) {
+	Report report;
+	report.duration = duration;
+	report.payloadSize = payloadSize;
+
+	for ( const auto &pub : publishers ) {
+		report.sent += pub.sent;
+		report.failed += pub.failed;
+		report.bytesSent += pub.bytesSent;
+	}
+
+	vector<uint32_t> latencies;
+
+	for ( auto &sub : subscribers ) {
+		report.received += sub.received;
+		report.decodingErrors += sub.decodingErrors;
+		report.bytesReceived += sub.bytesReceived;
+
+		for ( size_t i = 0; i < publishers.size(); ++i ) {
+			if ( sub.receivedFrom.size() > i && sub.receivedFrom[i] < publishers[i].sent )
+				report.dropped += publishers[i].sent - sub.receivedFrom[i];
+		}
+
+		latencies.insert(latencies.end(), sub.latencies.begin(), sub.latencies.end());
+		vector<uint32_t>().swap(sub.latencies);
+	}
+
+	report.expected = report.sent * subscribers.size();
+
+	if ( latencies.empty() )
+		return report;
+
+	sort(latencies.begin(), latencies.end());
+
+	double sum = 0;
+	for ( uint32_t l : latencies )
+		sum += l;
+
+	report.latencyMean = sum / latencies.size() * 1E-3;
+	report.latencyMax = latencies.back() * 1E-3;
+
+	for ( double p : {50.0, 90.0, 99.0, 99.9} ) {
+		size_t idx = min(latencies.size() - 1, size_t(p / 100 * latencies.size()));
+		report.percentiles.emplace_back(p, latencies[idx] * 1E-3);
+	}
+
+	return report;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string jsonString(const string &str) {
+	string out = "\"";
+	for ( char c : str ) {
+		switch ( c ) {
+			case '"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			default: out += c; break;
+		}
+	}
+	out += '"';
+	return out;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printConsole(ostream &os, const Report &report, const Options &options) {
+	os << fixed << setprecision(1)
+	   << "Broker:          " << options.address << endl
+	   << "Clients:         " << options.publishers << " publishers, "
+	   << options.subscribers << " subscribers" << endl
+	   << "Payload:         " << report.payloadSize << " bytes, "
+	   << options.contentType.toString() << ", " << options.encoding.toString() << endl
+	   << "Duration:        " << setprecision(3) << report.duration << " s" << endl
+	   << setprecision(0)
+	   << "Sent:            " << report.sent << " (" << report.sent / report.duration
+	   << " msg/s, " << report.bytesSent / report.duration << " B/s)" << endl
+	   << "Send failures:   " << report.failed << endl
+	   << "Received:        " << report.received << " of " << report.expected
+	   << " (" << report.received / report.duration << " msg/s, "
+	   << report.bytesReceived / report.duration << " B/s)" << endl
+	   << "Dropped:         " << report.dropped << endl;
+
+	if ( options.decode )
+		os << "Decoding errors: " << report.decodingErrors << endl;
+
+	os << setprecision(3)
+	   << "Latency mean:    " << report.latencyMean << " ms" << endl;
+	for ( const auto &p : report.percentiles )
+		os << "Latency p" << left << setw(7) << p.first << right
+		   << p.second << " ms" << endl;
+	os << "Latency max:     " << report.latencyMax << " ms" << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printCSV(ostream &os, const Report &report, const Options &options) {
+	os << "publishers,subscribers,payload_bytes,content_type,encoding,"
+	      "duration_s,sent,failed,received,expected,dropped,"
+	      "sent_per_second,received_per_second,latency_mean_ms";
+	for ( const auto &p : report.percentiles )
+		os << ",latency_p" << p.first << "_ms";
+	os << ",latency_max_ms" << endl;
+
+	os << options.publishers << ',' << options.subscribers << ','
+	   << report.payloadSize << ',' << options.contentType.toString() << ','
+	   << options.encoding.toString() << ','
+	   << fixed << setprecision(3) << report.duration << ','
+	   << report.sent << ',' << report.failed << ',' << report.received << ','
+	   << report.expected << ',' << report.dropped << ','
+	   << setprecision(0) << report.sent / report.duration << ','
+	   << report.received / report.duration << ','
+	   << setprecision(3) << report.latencyMean;
+	for ( const auto &p : report.percentiles )
+		os << ',' << p.second;
+	os << ',' << report.latencyMax << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void printJSON(ostream &os, const Report &report, const Options &options) {
+	os << "{" << endl
+	   << "  \"context\": {" << endl
+	   << "    \"version\": " << jsonString(Core::CurrentVersion.toString()) << "," << endl
+	   << "    \"date\": " << jsonString(Core::Time::UTC().iso()) << "," << endl
+	   << "    \"broker\": " << jsonString(options.address) << "," << endl
+	   << "    \"publishers\": " << options.publishers << "," << endl
+	   << "    \"subscribers\": " << options.subscribers << "," << endl
+	   << "    \"rate\": " << options.rate << "," << endl
+	   << "    \"payload_bytes\": " << report.payloadSize << "," << endl
+	   << "    \"content_type\": " << jsonString(options.contentType.toString()) << "," << endl
+	   << "    \"encoding\": " << jsonString(options.encoding.toString()) << endl
+	   << "  }," << endl
+	   << fixed << setprecision(3)
+	   << "  \"duration_s\": " << report.duration << "," << endl
+	   << "  \"sent\": " << report.sent << "," << endl
+	   << "  \"failed\": " << report.failed << "," << endl
+	   << "  \"received\": " << report.received << "," << endl
+	   << "  \"expected\": " << report.expected << "," << endl
+	   << "  \"dropped\": " << report.dropped << "," << endl
+	   << "  \"decoding_errors\": " << report.decodingErrors << "," << endl
+	   << setprecision(0)
+	   << "  \"sent_per_second\": " << report.sent / report.duration << "," << endl
+	   << "  \"received_per_second\": " << report.received / report.duration << "," << endl
+	   << setprecision(3)
+	   << "  \"latency_ms\": {\"mean\": " << report.latencyMean;
+	for ( const auto &p : report.percentiles )
+		os << ", \"p" << setprecision(1) << p.first << "\": "
+		   << setprecision(3) << p.second;
+	os << ", \"max\": " << report.latencyMax << "}" << endl
+	   << "}" << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int main(int argc, char **argv) {
+	Options options;
+
+	for ( int i = 1; i < argc; ++i ) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if ( arg == "-h" || arg == "--help" ) {
+			usage(argv[0]);
+			return 0;
+		}
+		else if ( arg == "--transient" )
+			options.transient = true;
+		else if ( arg == "--decode" )
+			options.decode = true;
+		else if ( !hasValue ) {
+			usage(argv[0]);
+			return 1;
+		}
+		else if ( arg == "-H" || arg == "--host" )
+			options.address = argv[++i];
+		else if ( arg == "-g" || arg == "--groups" ) {
+			options.groups.clear();
+			Core::split(options.groups, argv[++i], ",");
+		}
+		else if ( arg == "-p" || arg == "--publishers" )
+			options.publishers = atoi(argv[++i]);
+		else if ( arg == "-s" || arg == "--subscribers" )
+			options.subscribers = atoi(argv[++i]);
+		else if ( arg == "-n" || arg == "--count" )
+			options.count = strtoull(argv[++i], nullptr, 10);
+		else if ( arg == "-r" || arg == "--rate" )
+			options.rate = atof(argv[++i]);
+		else if ( arg == "-b" || arg == "--size" )
+			options.size = strtoull(argv[++i], nullptr, 10);
+		else if ( arg == "--batch" )
+			options.batch = atoi(argv[++i]);
+		else if ( arg == "--drain" )
+			options.drainTime = atof(argv[++i]);
+		else if ( arg == "--format" )
+			options.format = argv[++i];
+		else if ( arg == "-o" || arg == "--output" )
+			options.output = argv[++i];
+		else if ( arg == "-e" || arg == "--encoding" ) {
+			if ( !options.encoding.fromString(argv[++i]) ) {
+				cerr << "Unknown encoding: " << argv[i] << endl;
+				return 1;
+			}
+		}
+		else if ( arg == "-c" || arg == "--content-type" ) {
+			if ( !parseContentType(options.contentType, argv[++i]) ) {
+				cerr << "Unknown content type: " << argv[i] << endl;
+				return 1;
+			}
+		}
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if ( options.publishers < 1 || options.subscribers < 0 || options.count < 1
+	  || options.groups.empty() ) {
+		cerr << "Invalid options, at least one publisher, one message and "
+		        "one group are required" << endl;
+		return 1;
+	}
+
+	if ( options.format != "console" && options.format != "csv" && options.format != "json" ) {
+		cerr << "Unknown format: " << options.format << endl;
+		return 1;
+	}
+
+	string prefix = "msgload-" + Core::toString(getpid()) + "-";
+	string error;
+
+	// Subscribers are connected first to not miss the first messages
+	vector<ProtocolPtr> subscriberConnections;
+	vector<Subscriber> subscribers(options.subscribers);
+	for ( int i = 0; i < options.subscribers; ++i ) {
+		subscribers[i].name = prefix + "s" + Core::toString(i);
+		ProtocolPtr proto = connectClient(options, subscribers[i].name, error);
+		if ( !proto ) {
+			cerr << "Failed to connect subscriber " << i << ": " << error << endl;
+			return 1;
+		}
+
+		for ( const auto &group : options.groups ) {
+			Result r = proto->subscribe(group);
+			if ( !r ) {
+				cerr << "Failed to subscribe to " << group << ": "
+				     << r.toString() << endl;
+				return 1;
+			}
+		}
+
+		subscriberConnections.push_back(proto);
+	}
+
+	vector<ProtocolPtr> publisherConnections;
+	vector<Publisher> publishers(options.publishers);
+	for ( int i = 0; i < options.publishers; ++i ) {
+		publishers[i].name = prefix + "p" + Core::toString(i);
+		publishers[i].group = options.groups[i % options.groups.size()];
+		publishers[i].sendTimes.reset(new atomic<int64_t>[options.count]);
+		ProtocolPtr proto = connectClient(options, publishers[i].name, error);
+		if ( !proto ) {
+			cerr << "Failed to connect publisher " << i << ": " << error << endl;
+			return 1;
+		}
+
+		if ( !proto->supportsEncoding(options.encoding) ) {
+			cerr << "The broker does not support the encoding "
+			     << options.encoding.toString() << endl;
+			return 1;
+		}
+
+		publisherConnections.push_back(proto);
+	}
+
+	string payload;
+	if ( !createPayload(payload, options,
+	                    publisherConnections[0]->schemaVersion().packed) ) {
+		cerr << "Failed to encode the payload" << endl;
+		return 1;
+	}
+
+	Clock::time_point start = Clock::now();
+
+	vector<thread> threads;
+	for ( int i = 0; i < options.subscribers; ++i )
+		threads.emplace_back(subscribe, subscriberConnections[i].get(),
+		                     &subscribers[i], &options, &publishers);
+
+	vector<thread> publisherThreads;
+	for ( int i = 0; i < options.publishers; ++i )
+		publisherThreads.emplace_back(publish, publisherConnections[i].get(),
+		                              &publishers[i], &options, &payload, start);
+
+	for ( auto &t : publisherThreads )
+		t.join();
+
+	publishing = false;
+
+	for ( auto &t : threads )
+		t.join();
+
+	// The time waited for outstanding messages is not part of the test
+	Clock::time_point end = start;
+	for ( const auto &pub : publishers )
+		end = max(end, pub.finished);
+	for ( const auto &sub : subscribers )
+		end = max(end, sub.lastReceived);
+
+	double duration = chrono::duration<double>(end - start).count();
+
+	for ( const auto &pub : publishers ) {
+		if ( !pub.error.empty() )
+			cerr << "Publisher " << pub.name << " failed: " << pub.error << endl;
+	}
+
+	for ( const auto &sub : subscribers ) {
+		if ( !sub.error.empty() )
+			cerr << "Subscriber " << sub.name << " failed: " << sub.error << endl;
+		if ( sub.unknown )
+			cerr << "Subscriber " << sub.name << " received " << sub.unknown
+			     << " messages of other clients" << endl;
+	}
+
+	Report report = createReport(publishers, subscribers, duration,
+	                             payload.size(), options);
+
+	ofstream ofs;
+	if ( !options.output.empty() ) {
+		ofs.open(options.output.c_str());
+		if ( !ofs.is_open() ) {
+			cerr << "Could not open " << options.output << " for writing" << endl;
+			return 1;
+		}
+	}
+
+	ostream &os = options.output.empty() ? cout : ofs;
+
+	if ( options.format == "csv" )
+		printCSV(os, report, options);
+	else if ( options.format == "json" )
+		printJSON(os, report, options);
+	else
+		printConsole(os, report, options);
+
+	return report.dropped || report.failed ? 2 : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,192 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/io/records/mseedrecord.h>
+
+#include "benchmark.h"
+
+#include <cmath>
+#include <sstream>
+
+
+using namespace std;
+using namespace Seiscomp;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Creates an integer record with a deterministic signal which compresses
+//! similar to real broadband data
+GenericRecordPtr createRecord(const Core::Time &startTime, int samples,
+                              int offset = 0) {
+	GenericRecordPtr rec = new GenericRecord("XX", "BENCH", "", "HHZ",
+	                                         startTime, 100.0, -1, Array::INT);
+	IntArrayPtr data = new IntArray(samples);
+	uint32_t seed = 12345 + offset;
+	for ( int i = 0; i < samples; ++i ) {
+		seed = seed * 1103515245 + 12345;
+		double t = (offset + i) * 0.01;
+		data->set(i, int(1000 * sin(t * 2 * M_PI * 0.2) + ((seed >> 16) % 64) - 32));
+	}
+
+	rec->setData(data.get());
+	rec->dataUpdated();
+	return rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encode(const Record *rec, int reclen) {
+	IO::MSeedRecord mseed(*rec, reclen);
+	ostringstream os;
+	mseed.write(os);
+	return os.str();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void feedSequence(RecordSequence &seq, const vector<GenericRecordPtr> &records) {
+	for ( const auto &rec : records )
+		seq.feed(rec.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+vector<GenericRecordPtr> createSequence(int count, int samples) {
+	vector<GenericRecordPtr> records;
+	Core::Time startTime(2024, 1, 1);
+	for ( int i = 0; i < count; ++i )
+		records.push_back(createRecord(startTime + Core::TimeSpan(i * samples * 0.01),
+		                               samples, i * samples));
+	return records;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Records, MSeedEncode512) {
+	GenericRecordPtr rec = createRecord(Core::Time(2024, 1, 1), 400);
+
+	while ( ctx.running() )
+		Benchmark::keep(encode(rec.get(), 512));
+
+	ctx.setItemsPerIteration(rec->sampleCount());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Records, MSeedDecode512) {
+	GenericRecordPtr rec = createRecord(Core::Time(2024, 1, 1), 400);
+	string blob = encode(rec.get(), 512);
+	size_t samples = 0;
+
+	while ( ctx.running() ) {
+		istringstream is(blob);
+		IO::MSeedRecord mseed(Array::INT);
+		mseed.read(is);
+		// Force the decompression of the samples
+		samples = mseed.data()->size();
+		Benchmark::keep(samples);
+	}
+
+	ctx.setItemsPerIteration(samples);
+	ctx.setBytesPerIteration(blob.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Records, RingBufferFeed) {
+	auto records = createSequence(1000, 100);
+
+	while ( ctx.running() ) {
+		RingBuffer seq(Core::TimeSpan(600.0));
+		feedSequence(seq, records);
+		Benchmark::keep(seq.size());
+	}
+
+	ctx.setItemsPerIteration(records.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Records, TimeWindowBufferFeed) {
+	auto records = createSequence(1000, 100);
+	Core::TimeWindow tw(records.front()->startTime() + Core::TimeSpan(100.0),
+	                    records.back()->endTime() - Core::TimeSpan(100.0));
+
+	while ( ctx.running() ) {
+		TimeWindowBuffer seq(tw);
+		feedSequence(seq, records);
+		Benchmark::keep(seq.size());
+	}
+
+	ctx.setItemsPerIteration(records.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Records, ContiguousRecord) {
+	auto records = createSequence(600, 100);
+	RingBuffer seq(0);
+	feedSequence(seq, records);
+	size_t samples = 0;
+
+	while ( ctx.running() ) {
+		GenericRecordPtr rec = seq.contiguousRecord<double>();
+		samples = rec->sampleCount();
+		Benchmark::keep(samples);
+	}
+
+	ctx.setItemsPerIteration(samples);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,165 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/geo/feature.h>
+#include <seiscomp/math/geo.h>
+#include <seiscomp/seismology/regions/polygon.h>
+#include <seiscomp/seismology/ttt/libtau.h>
+
+#include "benchmark.h"
+
+#include <memory>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+const size_t StationCount = 1000;
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! A deterministic global distribution of station coordinates
+void createStations(vector<double> &lats, vector<double> &lons) {
+	lats.resize(StationCount);
+	lons.resize(StationCount);
+	for ( size_t i = 0; i < StationCount; ++i ) {
+		lats[i] = -80.0 + (i * 37 % 160);
+		lons[i] = -180.0 + (i * 73 % 360) + 0.5;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Seismology, Delazi) {
+	vector<double> lats, lons;
+	createStations(lats, lons);
+
+	while ( ctx.running() ) {
+		for ( size_t i = 0; i < StationCount; ++i ) {
+			double dist, azi, baz;
+			Math::Geo::delazi(-7.9, 110.5, lats[i], lons[i], &dist, &azi, &baz);
+			Benchmark::keep(dist);
+		}
+	}
+
+	ctx.setItemsPerIteration(StationCount);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Seismology, DelaziBatch) {
+	vector<double> lats, lons;
+	createStations(lats, lons);
+	vector<double> dist(StationCount), azi(StationCount), baz(StationCount);
+
+	while ( ctx.running() ) {
+		Math::Geo::delazi(-7.9, 110.5, StationCount, lats.data(), lons.data(),
+		                  dist.data(), azi.data(), baz.data());
+		Benchmark::keep(dist[0]);
+	}
+
+	ctx.setItemsPerIteration(StationCount);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Seismology, LibTauCompute) {
+	TTT::LibTau ttt;
+	vector<double> lats, lons;
+	createStations(lats, lons);
+
+	try {
+		ttt.setModel("iasp91");
+		delete ttt.compute(-7.9, 110.5, 10.0, lats[0], lons[0], 0.0);
+	}
+	catch ( std::exception &e ) {
+		ctx.skip(e.what());
+		return;
+	}
+
+	size_t i = 0;
+	while ( ctx.running() ) {
+		// Keep the source depth as a locator does for all arrivals of an
+		// origin
+		unique_ptr<TravelTimeList> ttlist(
+			ttt.compute(-7.9, 110.5, 10.0, lats[i], lons[i], 0.0)
+		);
+		Benchmark::keep(ttlist->size());
+		if ( ++i == StationCount ) i = 0;
+	}
+
+	ctx.setItemsPerIteration(1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SC_BENCHMARK(Seismology, PolyRegionsFindRegion) {
+	// A synthetic set of 648 10x10 degree regions with 40 vertices each
+	// which mimics the number of Flinn-Engdahl like polygons
+	Geo::PolyRegions regions;
+	for ( int lat = -90; lat < 90; lat += 10 ) {
+		for ( int lon = -180; lon < 180; lon += 10 ) {
+			auto *feature = new Geo::GeoFeature(Core::toString(lat) + "/" + Core::toString(lon),
+			                                    nullptr, 1);
+			for ( int k = 0; k < 10; ++k ) feature->addVertex(lat, lon + k);
+			for ( int k = 0; k < 10; ++k ) feature->addVertex(lat + k, lon + 10);
+			for ( int k = 0; k < 10; ++k ) feature->addVertex(lat + 10, lon + 10 - k);
+			for ( int k = 0; k < 10; ++k ) feature->addVertex(lat + 10 - k, lon);
+			feature->setClosedPolygon(true);
+			feature->updateBoundingBox();
+			regions.addRegion(feature);
+		}
+	}
+
+	vector<double> lats, lons;
+	createStations(lats, lons);
+
+	while ( ctx.running() ) {
+		for ( size_t i = 0; i < StationCount; ++i )
+			Benchmark::keep(regions.findRegion(lats[i] + 0.25, lons[i] + 0.25));
+	}
+
+	ctx.setItemsPerIteration(StationCount);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -24,6 +24,7 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/core/interruptible.h>
 #include <seiscomp/core/system.h>
+#include <seiscomp/core/waveformmemory.h>
 
 #include <seiscomp/logging/fd.h>
 #include <seiscomp/logging/filerotator.h>
@@ -32,6 +33,7 @@
 #endif
 
 #include <seiscomp/system/pluginregistry.h>
+#include <seiscomp/system/threads.h>
 
 #include <seiscomp/math/geo.h>
 
@@ -62,10 +64,12 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <future>
 #include <sstream>
 
 #include <signal.h>
@@ -92,6 +96,51 @@ using namespace Seiscomp::IO;
 namespace {
 
 
+// The number of packets which can be received ahead of delivery per
+// decode thread
+const size_t PendingPacketsPerDecodeThread = 4;
+
+
+// Loads the bindings from an XML file or from the database with a connection
+// of its own. It runs concurrently to the startup of the application and
+// must not access it.
+bool loadBindings(const string &configDB, const string &databaseURI,
+                  const string &moduleName) {
+	// Notifiers are enabled per thread
+	DataModel::Notifier::Disable();
+
+	try {
+		if ( !configDB.empty() && configDB.find("://") == string::npos ) {
+			ConfigDB::Instance()->load(configDB.c_str());
+		}
+		else if ( configDB.find("file://") == 0 ) {
+			ConfigDB::Instance()->load(configDB.substr(7).c_str());
+		}
+		else {
+			const string &uri = configDB.empty() ? databaseURI : configDB;
+			IO::DatabaseInterfacePtr db = IO::DatabaseInterface::Open(uri.c_str());
+			if ( !db ) {
+				SEISCOMP_WARNING("Database connection to load the bindings failed");
+				return false;
+			}
+
+			DataModel::DatabaseQueryPtr query = new DataModel::DatabaseQuery(db.get());
+			if ( configDB.empty() && !moduleName.empty() )
+				ConfigDB::Instance()->load(query.get(), moduleName);
+			else
+				ConfigDB::Instance()->load(query.get());
+		}
+	}
+	catch ( std::exception &e ) {
+		SEISCOMP_ERROR("%s", e.what());
+		return false;
+	}
+
+	SEISCOMP_INFO("Finished loading configuration module");
+	return true;
+}
+
+
 struct AppResolver : public Util::VariableResolver {
 	AppResolver(const std::string& name)
 	 : _name(name) {}
@@ -151,6 +200,11 @@ void mapSchemaParameters(ParamMap &map, System::SchemaParameters *params,
 }
 
 
+// The start of the handler running in the current thread
+thread_local bool handlerActive = false;
+thread_local chrono::steady_clock::time_point handlerStart;
+
+
 } // private namespace
 
 
@@ -250,8 +304,10 @@ void Application::AppSettings::Messaging::accept(SettingsLinker &linker) {
 	& cfg(primaryGroup, "primaryGroup")
 	& cfg(subscriptions, "subscriptions")
 	& cfg(contentType, "encoding")
+	& cfg(compression, "compression")
 	& cfg(timeout, "timeout")
 	& cfg(certificate, "certificate")
+	& cfg(decodeThreads, "decodeThreads")
 
 	& cli(
 		user, "Messaging", "user,u",
@@ -294,6 +350,9 @@ void Application::AppSettings::Client::accept(SettingsLinker &linker) {
 	& cfg(autoShutdown, "autoShutdown")
 	& cfg(shutdownMasterModule, "shutdownMasterModule")
 	& cfg(shutdownMasterUsername, "shutdownMasterUsername")
+	& cfg(latencyStatistics, "latencyStatistics")
+	& cfg(metrics, "metrics")
+	& cfg(parallelStartup, "parallelStartup")
 
 	& cli(
 		startStopMessages, "Messaging", "start-stop-msg",
@@ -313,6 +372,18 @@ void Application::AppSettings::Client::accept(SettingsLinker &linker) {
 		shutdownMasterUsername, "Generic", "shutdown-master-username",
 		"Triggers shutdown if the user name of the received messages match.",
 		false
+	)
+	& cli(
+		latencyStatistics, "Generic", "latency-stats",
+		"Collects latency statistics of the handlers and sent messages and "
+		"logs them at shutdown.",
+		true
+	)
+	& cli(
+		metrics, "Generic", "metrics",
+		"Publishes the internal counters and timers with the client "
+		"status information.",
+		true
 	);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -355,7 +426,9 @@ void Application::AppSettings::Inventory::accept(SettingsLinker &linker) {
 	& cfg(netTypeAllowlist, "whitelist.nettype")
 	& cfg(netTypeBlocklist, "blacklist.nettype")
 	& cfg(staTypeAllowlist, "whitelist.statype")
-	& cfg(staTypeBlocklist, "blacklist.statype");
+	& cfg(staTypeBlocklist, "blacklist.statype")
+	& cfg(loadResponsesOnDemand, "loadResponsesOnDemand")
+	& cfg(snapshot, "snapshot");
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -365,6 +438,11 @@ void Application::AppSettings::Inventory::accept(SettingsLinker &linker) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::AppSettings::RecordStream::accept(SettingsLinker &linker) {
 	linker
+	& cfg(publish, "publish")
+	& cfg(publishSize, "publishSize")
+	& cfg(memoryBudget, "memoryBudget")
+	& cfgAsPath(spillDirectory, "spillDirectory")
+
 	& cliSwitch(
 		showDrivers, "Records", "record-driver-list",
 		"List all supported record stream drivers."
@@ -380,6 +458,10 @@ void Application::AppSettings::RecordStream::accept(SettingsLinker &linker) {
 	& cli(
 		fileType, "Records", "record-type",
 		"Specify a type for the records being read."
+	)
+	& cli(
+		publish, "Records", "record-publish",
+		"Publish the received records to the given shared memory segment."
 	);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -490,6 +572,7 @@ Application::Application(int argc, char** argv)
 Application::~Application() {
 	if ( _inputMonitor ) delete _inputMonitor;
 	if ( _outputMonitor ) delete _outputMonitor;
+	if ( _latencyMonitor ) delete _latencyMonitor;
 
 	if ( _instance == this )
 		_instance = nullptr;
@@ -629,6 +712,42 @@ bool Application::isAutoShutdownEnabled() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::setLatencyStatisticsEnabled(bool enable) {
+	_settings.client.latencyStatistics = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::isLatencyStatisticsEnabled() const {
+	return _settings.client.latencyStatistics;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::setMetricsEnabled(bool enable) {
+	_settings.client.metrics = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::isMetricsEnabled() const {
+	return _settings.client.metrics;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::setRecordStreamEnabled(bool enable) {
 	_settings.recordstream.enable = enable;
@@ -1023,6 +1142,8 @@ void Application::disableTimer() {
 bool Application::handlePreFork() {
 	_inputMonitor = new ObjectMonitor(_settings.objectLogTimeWindow);
 	_outputMonitor = new ObjectMonitor(_settings.objectLogTimeWindow);
+	if ( _settings.client.latencyStatistics )
+		_latencyMonitor = new LatencyMonitor;
 
 	_queue.resize(10);
 
@@ -1084,6 +1205,65 @@ bool Application::init() {
 		}
 	}
 
+	if ( _settings.recordstream.memoryBudget < 0 ) {
+		SEISCOMP_ERROR("Invalid recordstream.memoryBudget: %d",
+		               _settings.recordstream.memoryBudget);
+		return false;
+	}
+
+	if ( !_settings.recordstream.spillDirectory.empty()
+	  && !WaveformMemory::Instance().setSpillDirectory(_settings.recordstream.spillDirectory) ) {
+		SEISCOMP_ERROR("Unable to use recordstream.spillDirectory %s",
+		               _settings.recordstream.spillDirectory.c_str());
+		return false;
+	}
+
+	WaveformMemory::Instance().setBudget(static_cast<size_t>(_settings.recordstream.memoryBudget) * 1024 * 1024);
+
+	// With parallel startup the database connection and the bindings are
+	// set up in a thread of their own while connecting to the messaging. If
+	// a concurrent step fails, it is repeated sequentially later.
+	std::future<IO::DatabaseInterfacePtr> databaseTask;
+	std::future<bool> bindingsTask;
+	bool concurrentBindings = false;
+
+	if ( _settings.client.parallelStartup ) {
+		bool openDatabase = _settings.database.enable && !_database
+		                 && !_settings.database.URI.empty();
+		bool loadConfig = _settings.enableLoadConfigModule
+		               && (!_settings.database.configDB.empty() || openDatabase);
+
+		if ( openDatabase || loadConfig ) {
+			SEISCOMP_INFO("Connect to database and load bindings concurrently");
+
+			auto database = std::make_shared<std::promise<IO::DatabaseInterfacePtr>>();
+			if ( openDatabase ) {
+				databaseTask = database->get_future();
+			}
+
+			// Create the instance in this thread
+			if ( loadConfig ) {
+				ConfigDB::Instance();
+				concurrentBindings = true;
+			}
+
+			string uri = _settings.database.URI;
+			string configDB = _settings.database.configDB;
+			string moduleName = _settings.configModuleName;
+
+			// The connections are opened one after another, database
+			// drivers are not necessarily safe to be initialized
+			// concurrently
+			bindingsTask = std::async(std::launch::async, [=]() {
+				if ( openDatabase ) {
+					database->set_value(IO::DatabaseInterface::Open(uri.c_str()));
+				}
+
+				return loadConfig ? loadBindings(configDB, uri, moduleName) : false;
+			});
+		}
+	}
+
 	if ( isLoadRegionsEnabled() ) {
 		showMessage("Reading custom regions");
 		Regions::load();
@@ -1129,7 +1309,20 @@ bool Application::init() {
 	if ( _settings.database.enable && !_database ) {
 		SEISCOMP_INFO("Connect to database");
 		showMessage("Initialize database");
-		if ( !initDatabase() ) {
+
+		if ( databaseTask.valid() ) {
+			IO::DatabaseInterfacePtr db = databaseTask.get();
+			if ( db ) {
+				SEISCOMP_INFO("Connected successfully");
+				setDatabase(db.get());
+				if ( _query->hasError() ) {
+					SEISCOMP_ERROR("%s", _query->errorMsg().c_str());
+					setDatabase(nullptr);
+				}
+			}
+		}
+
+		if ( !_database && !initDatabase() ) {
 			if ( !handleInitializationError(DATABASE) )
 				return false;
 		}
@@ -1156,7 +1349,13 @@ bool Application::init() {
 		return false;
 	}
 
-	if ( !reloadBindings() ) {
+	bool bindingsLoaded = false;
+	if ( concurrentBindings ) {
+		_configModule = nullptr;
+		bindingsLoaded = bindingsTask.get() && selectConfigModule();
+	}
+
+	if ( !bindingsLoaded && !reloadBindings() ) {
 		if ( !handleInitializationError(CONFIGMODULE) ) {
 			return false;
 		}
@@ -1219,10 +1418,19 @@ bool Application::reloadInventory() {
 		}
 		else if ( _database ) {
 			if ( _query ) {
-				SEISCOMP_INFO("Loading complete inventory");
 				showMessage("Loading inventory");
-				Inventory::Instance()->load(_query.get());
-				SEISCOMP_INFO("Finished loading complete inventory");
+				if ( !loadInventorySnapshot() ) {
+					if ( _settings.inventory.loadResponsesOnDemand ) {
+						SEISCOMP_INFO("Loading inventory, instruments on demand");
+					}
+					else {
+						SEISCOMP_INFO("Loading complete inventory");
+					}
+					Inventory::Instance()->load(_query.get(),
+					                            !_settings.inventory.loadResponsesOnDemand);
+					SEISCOMP_INFO("Finished loading inventory");
+					saveInventorySnapshot();
+				}
 			}
 			else {
 				SEISCOMP_ERROR("No database query object");
@@ -1298,16 +1506,27 @@ bool Application::reloadBindings() {
 			return false;
 		}
 
-		DataModel::Config* config = ConfigDB::Instance()->config();
-		if ( !config ) {
-			return false;
-		}
+		return selectConfigModule();
+	}
 
-		for ( size_t i = 0; i < config->configModuleCount(); ++i ) {
-			if ( config->configModule(i)->name() == _settings.configModuleName ) {
-				_configModule = config->configModule(i);
-				break;
-			}
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::selectConfigModule() {
+	DataModel::Config* config = ConfigDB::Instance()->config();
+	if ( !config ) {
+		return false;
+	}
+
+	for ( size_t i = 0; i < config->configModuleCount(); ++i ) {
+		if ( config->configModule(i)->name() == _settings.configModuleName ) {
+			_configModule = config->configModule(i);
+			break;
 		}
 	}
 
@@ -1347,7 +1566,16 @@ bool Application::run() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Application::processEvent() {
 	try {
-		Notification evt = _queue.pop();
+		// Drain all queued notifications with one wake-up and process
+		// them one by one with subsequent calls
+		if ( _nextNotification >= _pendingNotifications.size() ) {
+			_pendingNotifications.clear();
+			_nextNotification = 0;
+			_queue.popAll(_pendingNotifications);
+		}
+
+		Notification evt = _pendingNotifications[_nextNotification++];
+		_pendingNotificationCount = _pendingNotifications.size() - _nextNotification;
 		BaseObjectPtr obj = evt.object;
 		switch ( evt.type ) {
 			case Notification::Object:
@@ -1444,7 +1672,9 @@ bool Application::dispatch(Core::BaseObject* obj) {
 			}
 		}
 
+		handlerStarted();
 		handleMessage(msg);
+		handlerFinished("handleMessage");
 		return true;
 	}
 	else {
@@ -1481,6 +1711,15 @@ void Application::idle() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::done() {
+	if ( _latencyMonitor ) {
+		std::ostringstream os;
+		_latencyMonitor->dump(os);
+		std::string line;
+		std::istringstream is(os.str());
+		while ( getline(is, line) )
+			SEISCOMP_INFO("Latency %s", line.c_str());
+	}
+
 	if ( _connection && _connection->isConnected() ) {
 		if ( _settings.client.startStopMessages ) {
 			ApplicationStatusMessage stat(name(), _settings.messaging.user, FINISHED);
@@ -1490,6 +1729,7 @@ void Application::done() {
 	}
 
 	_queue.close();
+	stopDecodeThreads();
 
 	if ( _sohTimer.isActive() ) {
 		SEISCOMP_INFO("Disable soh timer");
@@ -1707,6 +1947,24 @@ bool Application::initMessaging() {
 		return false;
 	}
 
+	if ( !_settings.messaging.compression.empty() ) {
+		Protocol::ContentEncoding encoding;
+		if ( !encoding.fromString(_settings.messaging.compression) ) {
+			SEISCOMP_ERROR("Invalid message compression: %s",
+			               _settings.messaging.compression.c_str());
+			return false;
+		}
+
+		if ( !_connection->protocol()->supportsEncoding(encoding) ) {
+			SEISCOMP_WARNING("Message compression %s is not supported by the "
+			                 "server, falling back to %s", encoding.toString(),
+			                 Protocol::ContentEncoding(Protocol::Deflate).toString());
+			encoding = Protocol::Deflate;
+		}
+
+		_connection->setContentEncoding(encoding);
+	}
+
 	if ( _settings.client.startStopMessages ) {
 		SEISCOMP_DEBUG("Send START message to group %s",
 		               Protocol::STATUS_GROUP.c_str());
@@ -1796,7 +2054,185 @@ void Application::runMessageThread() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::startMessageThread() {
-	_messageThread = new thread(bind(&Application::runMessageThread, this));
+	startDecodeThreads();
+	_messageThread = new thread(System::startThread("messaging", bind(&Application::runMessageThread, this)));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::startDecodeThreads() {
+	if ( !_settings.messaging.decodeThreads || !_decodeThreads.empty() )
+		return;
+
+	SEISCOMP_INFO("Starting %d message decode threads",
+	              _settings.messaging.decodeThreads);
+
+	_decodeClosed = false;
+	_maxPendingPackets = _settings.messaging.decodeThreads * PendingPacketsPerDecodeThread;
+
+	for ( unsigned int i = 0; i < _settings.messaging.decodeThreads; ++i )
+		_decodeThreads.emplace_back(System::startThread("decode", bind(&Application::runDecodeThread, this)));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::stopDecodeThreads() {
+	if ( _decodeThreads.empty() ) return;
+
+	{
+		lock_guard<mutex> lk(_decodeMutex);
+		_decodeClosed = true;
+	}
+
+	_decodeInputAvailable.notify_all();
+	_decodeSlotAvailable.notify_all();
+
+	for ( auto &t : _decodeThreads )
+		t.join();
+
+	_decodeThreads.clear();
+
+	// Release everything which has not been delivered
+	lock_guard<mutex> lk(_decodeMutex);
+	for ( DecodeJob *job : _decodeOrder ) {
+		delete job->packet;
+		delete job->msg;
+		delete job;
+	}
+
+	_decodeOrder.clear();
+	_decodeInput.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::runDecodeThread() {
+	while ( true ) {
+		DecodeJob *job;
+
+		{
+			unique_lock<mutex> lk(_decodeMutex);
+			_decodeInputAvailable.wait(lk, [this]() {
+				return _decodeClosed || !_decodeInput.empty();
+			});
+
+			if ( _decodeClosed ) return;
+
+			job = _decodeInput.front();
+			_decodeInput.pop_front();
+		}
+
+		// The job is still referenced by _decodeOrder and is only released
+		// after this thread has been joined
+		Core::Message *msg = Connection::decode(job->packet);
+
+		lock_guard<mutex> lk(_decodeMutex);
+		job->msg = msg;
+		job->done = true;
+		deliverDecoded();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::decodePacket(Packet *pkt) {
+	DecodeJob *job = new DecodeJob;
+	job->packet = pkt;
+	// Only data packets carry a message
+	job->done = pkt->type != Packet::Data;
+
+	unique_lock<mutex> lk(_decodeMutex);
+	_decodeSlotAvailable.wait(lk, [this]() {
+		return _decodeClosed || _decodeOrder.size() < _maxPendingPackets;
+	});
+
+	if ( _decodeClosed ) {
+		delete pkt;
+		delete job;
+		return false;
+	}
+
+	_decodeOrder.push_back(job);
+
+	if ( job->done )
+		return deliverDecoded();
+
+	_decodeInput.push_back(job);
+	_decodeInputAvailable.notify_one();
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::pushNotification(int type) {
+	if ( !_maxPendingPackets )
+		return _queue.push(type);
+
+	DecodeJob *job = new DecodeJob;
+	job->notification = type;
+	job->done = true;
+
+	lock_guard<mutex> lk(_decodeMutex);
+	if ( _decodeClosed ) {
+		delete job;
+		return false;
+	}
+
+	_decodeOrder.push_back(job);
+	return deliverDecoded();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::deliverDecoded() {
+	// Pushing while holding the lock keeps the order of concurrently
+	// finished jobs and blocks the decode threads and the message thread
+	// if the main loop lags behind
+	while ( !_decodeOrder.empty() && _decodeOrder.front()->done ) {
+		DecodeJob *job = _decodeOrder.front();
+		_decodeOrder.pop_front();
+		_decodeSlotAvailable.notify_one();
+
+		bool ok = true;
+
+		if ( job->packet ) {
+			if ( !_queue.push(job->packet) ) {
+				delete job->packet;
+				delete job->msg;
+				ok = false;
+			}
+			else if ( job->msg && !_queue.push(job->msg) ) {
+				delete job->msg;
+				ok = false;
+			}
+		}
+		else
+			ok = _queue.push(job->notification);
+
+		delete job;
+
+		if ( !ok ) return false;
+	}
+
+	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1978,6 +2414,64 @@ bool Application::loadConfig(const std::string &configDB) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::loadInventorySnapshot() {
+	_inventorySnapshotMarker = string();
+
+	// Snapshots always contain the complete inventory
+	if ( _settings.inventory.snapshot.empty() ||
+	     _settings.inventory.loadResponsesOnDemand || !_query ) {
+		return false;
+	}
+
+	_inventorySnapshotMarker = Inventory::Instance()->modificationMarker(_query.get());
+	if ( _inventorySnapshotMarker.empty() ) {
+		SEISCOMP_WARNING("Unable to query the inventory modification marker, "
+		                 "ignoring snapshot");
+		return false;
+	}
+
+	string filename = Environment::Instance()->absolutePath(_settings.inventory.snapshot);
+	if ( !Inventory::Instance()->loadSnapshot(filename, _inventorySnapshotMarker) ) {
+		SEISCOMP_DEBUG("Inventory snapshot %s is missing or outdated",
+		               filename.c_str());
+		return false;
+	}
+
+	SEISCOMP_INFO("Loaded inventory from snapshot %s", filename.c_str());
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::saveInventorySnapshot() {
+	if ( _inventorySnapshotMarker.empty() ) {
+		return;
+	}
+
+	string filename = Environment::Instance()->absolutePath(_settings.inventory.snapshot);
+	string path = filename.substr(0, filename.find_last_of('/') + 1);
+	if ( !path.empty() && !Util::pathExists(path) && !Util::createPath(path) ) {
+		SEISCOMP_WARNING("Unable to create inventory snapshot directory %s",
+		                 path.c_str());
+		return;
+	}
+
+	if ( !Inventory::Instance()->saveSnapshot(filename, _inventorySnapshotMarker) ) {
+		SEISCOMP_WARNING("Unable to write inventory snapshot %s", filename.c_str());
+		return;
+	}
+
+	SEISCOMP_DEBUG("Wrote inventory snapshot %s", filename.c_str());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Application::loadInventory(const std::string &inventoryDB) {
 	SEISCOMP_INFO("Loading complete inventory from %s", inventoryDB.c_str());
@@ -2030,6 +2524,70 @@ void Application::logObject(ObjectMonitor::Log *log, const Core::Time &timestamp
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::send(const std::string &targetGroup, Core::Message *msg) {
+	if ( !_connection ) {
+		return false;
+	}
+
+	if ( !_connection->send(targetGroup, msg) ) {
+		return false;
+	}
+
+	if ( _latencyMonitor && handlerActive ) {
+		_latencyMonitor->push(
+			"send:" + targetGroup,
+			chrono::duration<double>(chrono::steady_clock::now() - handlerStart).count()
+		);
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor *Application::latencyMonitor() const {
+	return _latencyMonitor;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::handlerStarted() {
+	if ( !_latencyMonitor ) {
+		return;
+	}
+
+	handlerActive = true;
+	handlerStart = chrono::steady_clock::now();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::handlerFinished(const char *name) {
+	if ( !_latencyMonitor || !handlerActive ) {
+		return;
+	}
+
+	handlerActive = false;
+	_latencyMonitor->push(
+		name,
+		chrono::duration<double>(chrono::steady_clock::now() - handlerStart).count()
+	);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Application::readMessages() {
 	if ( !_connection ) {
@@ -2043,8 +2601,19 @@ bool Application::readMessages() {
 	// in a segfault.
 	Packet *pkt = nullptr;
 	Result result;
-	Message *msg = _connection->recv(&pkt, &result);
+	Message *msg = nullptr;
+
+	if ( _maxPendingPackets )
+		pkt = _connection->recvPacket(&result);
+	else
+		msg = _connection->recv(&pkt, &result);
+
 	if ( pkt ) {
+		// The decode threads push the packet and its message in the order
+		// the packets have been received
+		if ( _maxPendingPackets )
+			return decodePacket(pkt);
+
 		if ( msg ) {
 			if ( !_queue.push(pkt) ) {
 				delete pkt;
@@ -2091,7 +2660,7 @@ bool Application::readMessages() {
 		}
 
 		SEISCOMP_WARNING("Connection lost, trying to reconnect");
-		if ( !_queue.push(Notification::Disconnect) ) {
+		if ( !pushNotification(Notification::Disconnect) ) {
 			return false;
 		}
 
@@ -2113,7 +2682,7 @@ bool Application::readMessages() {
 						}
 					}
 				}
-				_queue.push(Notification::Reconnect);
+				pushNotification(Notification::Reconnect);
 				break;
 			}
 			else {
@@ -2233,6 +2802,53 @@ void Application::monitorLog(const Core::Time &now, std::ostream &os) {
 			os << ",last:" << it->test->last().iso();
 		os << /*"utime:" << now.iso() <<*/ ")&";
 	}
+
+	if ( _settings.client.metrics ) {
+		if ( first ) {
+			os << "&";
+		}
+
+		monitorMetrics(now, os);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::monitorMetrics(const Core::Time &now, std::ostream &os) {
+	// Include the drained batch which is still waiting to be processed
+	Core::Metrics::gauge("client.queue").set(_queue.size() + _pendingNotificationCount);
+
+	// Rates and mean durations are reported for the period since the
+	// last call
+	double period = _metricsTime.valid() ? double(now - _metricsTime) : 0.0;
+	_metricsTime = now;
+
+	for ( const auto &sample : Core::Metrics::snapshot(true) ) {
+		Core::Metrics::Sample &last = _metricsHistory[sample.name + char('0' + sample.type)];
+
+		switch ( sample.type ) {
+			case Core::Metrics::Sample::CounterType:
+				os << "counter(name:" << sample.name << ",cnt:" << sample.value;
+				if ( period > 0 )
+					os << ",avg:" << (sample.value - last.value) / period;
+				os << ")&";
+				break;
+			case Core::Metrics::Sample::GaugeType:
+				os << "gauge(name:" << sample.name << ",val:" << sample.value << ")&";
+				break;
+			case Core::Metrics::Sample::TimerType:
+				os << "timer(name:" << sample.name << ",cnt:" << sample.value;
+				if ( sample.value > last.value )
+					os << ",avg:" << (sample.total - last.total) * 1000 / (sample.value - last.value);
+				os << ",max:" << sample.maximum * 1000 << ")&";
+				break;
+		}
+
+		last = sample;
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -25,6 +25,7 @@
 #include <seiscomp/system/application.h>
 
 #include <seiscomp/core/message.h>
+#include <seiscomp/core/metrics.h>
 
 #include <seiscomp/client/queue.h>
 #include <seiscomp/client/monitor.h>
@@ -42,8 +43,12 @@
 #include <seiscomp/utils/timer.h>
 #include <seiscomp/utils/stringfirewall.h>
 
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <set>
 #include <thread>
+#include <atomic>
 #include <mutex>
 
 
@@ -319,6 +324,19 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 		void setAutoShutdownEnabled(bool enable);
 		bool isAutoShutdownEnabled() const;
 
+		//! Enables/disables the collection of latency statistics of the
+		//! handlers and of messages sent with send(). The statistics are
+		//! logged when the application shuts down. Default = false
+		void setLatencyStatisticsEnabled(bool enable);
+		bool isLatencyStatisticsEnabled() const;
+
+		//! Enables/disables publishing the metrics registry (see
+		//! Core::Metrics) with the client status information. Stream
+		//! applications additionally count the records per stream if
+		//! enabled. Default = false
+		void setMetricsEnabled(bool enable);
+		bool isMetricsEnabled() const;
+
 		//! Enables recordstream URL option, default = true
 		void setRecordStreamEnabled(bool enable);
 		bool isRecordStreamEnabled() const;
@@ -432,6 +450,31 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 		void logObject(ObjectLog *log, const Core::Time &timestamp,
 		               size_t count = 1);
 
+		/**
+		 * @brief Sends a message to a group with the application's
+		 *        connection. If latency statistics are enabled and the
+		 *        message is sent from within a handler then the time since
+		 *        the handler has been called is added to the histogram
+		 *        "send:<group>".
+		 * @param targetGroup The target group
+		 * @param msg The message
+		 * @return Success flag
+		 */
+		bool send(const std::string &targetGroup, Core::Message *msg);
+
+		/**
+		 * @brief Returns the latency statistics collected so far.
+		 *
+		 * The application adds the histograms "handleMessage" and, for
+		 * stream applications, "handleRecord" with the duration of the
+		 * handlers and "recordDelay" with the delay of the end time of a
+		 * record to the dispatch time. Derived classes may add their own
+		 * stages.
+		 * @return The monitor or nullptr if latency statistics are not
+		 *         enabled.
+		 */
+		LatencyMonitor *latencyMonitor() const;
+
 		/**
 		 * Reloads the application inventory from either an XML file or
 		 * the database.
@@ -610,17 +653,51 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 		bool initMessaging();
 
 		bool loadConfig(const std::string &configDB);
+		bool selectConfigModule();
 		bool loadInventory(const std::string &inventoryDB);
+		bool loadInventorySnapshot();
+		void saveInventorySnapshot();
 
 		void startMessageThread();
 		void runMessageThread();
 
+		void startDecodeThreads();
+		void stopDecodeThreads();
+		void runDecodeThread();
+
+		//! Passes a packet received by the message thread to the decode
+		//! threads
+		bool decodePacket(Packet *pkt);
+
+		//! Queues a notification of the message thread after all packets
+		//! which are still being decoded
+		bool pushNotification(int type);
+
+		//! Pushes all decoded jobs at the front of the decode order to the
+		//! notification queue. Must be called with _decodeMutex held.
+		bool deliverDecoded();
+
 		bool processEvent();
 
 		void timeout();
 		void stateOfHealthTimeout();
 
 		void monitorLog(const Core::Time &timestamp, std::ostream &os);
+		void monitorMetrics(const Core::Time &timestamp, std::ostream &os);
+
+
+	// ----------------------------------------------------------------------
+	//  Protected functions
+	// ----------------------------------------------------------------------
+	protected:
+		//! Marks the begin of a handler call in the current thread. Messages
+		//! sent until handlerFinished is called are measured relative to
+		//! this time.
+		void handlerStarted();
+
+		//! Marks the end of a handler call and adds its duration to the
+		//! histogram of the given name.
+		void handlerFinished(const char *name);
 
 
 	// ----------------------------------------------------------------------
@@ -690,6 +767,8 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 				StringVector netTypeBlocklist;
 				StringVector staTypeAllowlist;
 				StringVector staTypeBlocklist;
+				bool         loadResponsesOnDemand{false};
+				std::string  snapshot;
 			}                    inventory;
 
 			// Messaging
@@ -703,8 +782,10 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 				std::string  URL{"localhost/production"};
 				std::string  primaryGroup{Protocol::LISTENER_GROUP};
 				std::string  contentType;
+				std::string  compression;
 				unsigned int timeout{3};
 				std::string  certificate;
+				unsigned int decodeThreads{0};
 
 				StringVector subscriptions;
 
@@ -717,6 +798,9 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 				bool        autoShutdown{false};
 				std::string shutdownMasterModule;
 				std::string shutdownMasterUsername;
+				bool        latencyStatistics{false};
+				bool        metrics{false};
+				bool        parallelStartup{false};
 			}                    client;
 
 			struct RecordStream {
@@ -728,6 +812,10 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 				std::string URI;
 				std::string file;
 				std::string fileType;
+				std::string publish;
+				int         publishSize{64};
+				int         memoryBudget{0};
+				std::string spillDirectory;
 			}                    recordstream;
 
 			struct Processing {
@@ -754,12 +842,39 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 
 		ObjectMonitor               *_inputMonitor;
 		ObjectMonitor               *_outputMonitor;
+		LatencyMonitor              *_latencyMonitor{nullptr};
+		std::map<std::string, Core::Metrics::Sample> _metricsHistory;
+		Core::Time                   _metricsTime;
 
 		ThreadedQueue<Notification>  _queue;
+		std::vector<Notification>    _pendingNotifications;
+		size_t                       _nextNotification{0};
+		// The number of drained but not yet processed notifications,
+		// read by the state of health thread
+		std::atomic<size_t>          _pendingNotificationCount{0};
 		std::thread                 *_messageThread;
 
+		// Packets are decoded concurrently by the decode threads and
+		// delivered in the order they have been received
+		struct DecodeJob {
+			Packet        *packet{nullptr};
+			Core::Message *msg{nullptr};
+			int            notification{Notification::Object};
+			bool           done{false};
+		};
+
+		std::vector<std::thread>     _decodeThreads;
+		size_t                       _maxPendingPackets{0};
+		std::deque<DecodeJob*>       _decodeOrder;
+		std::deque<DecodeJob*>       _decodeInput;
+		std::mutex                   _decodeMutex;
+		std::condition_variable      _decodeInputAvailable;
+		std::condition_variable      _decodeSlotAvailable;
+		bool                         _decodeClosed{false};
+
 		ConnectionPtr                _connection;
 		IO::DatabaseInterfacePtr     _database;
+		std::string                  _inventorySnapshotMarker;
 		Util::Timer                  _userTimer;
 		Util::Timer                  _sohTimer;
 		Core::Time                   _sohLastUpdate;
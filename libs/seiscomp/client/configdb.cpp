@@ -22,7 +22,9 @@
 #include <seiscomp/io/archive/xmlarchive.h>
 #include <seiscomp/datamodel/parameter.h>
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
 
 namespace Seiscomp {
@@ -76,86 +78,116 @@ void ConfigDB::Reset() {
 #define _T(name) reader->driver()->convertColumnName(name)
 
 
+namespace {
+
+
+// Maximum number of ids in an "in (...)" list of a single query
+const size_t MaxIdsPerQuery = 500;
+
+
+template <typename T>
+std::string idList(const std::vector<T> &ids, size_t from, size_t to) {
+	std::ostringstream os;
+	for ( size_t i = from; i < to; ++i ) {
+		if ( i > from ) os << ",";
+		os << ids[i];
+	}
+	return os.str();
+}
+
+
+std::string quoted(Seiscomp::DataModel::DatabaseReader *reader, const std::string &value) {
+	return "'" + reader->toString(value) + "'";
+}
+
+
+}
+
+
 Seiscomp::DataModel::DatabaseIterator ConfigDB::getConfigObjects(Seiscomp::DataModel::DatabaseReader* reader,
 	const Seiscomp::Core::RTTI& classType,
-	const OPT(std::string)& moduleName,
+	const std::string& moduleOids,
 	const OPT(std::string)& networkCode,
 	const OPT(std::string)& stationCode,
 	const OPT(std::string)& setupName,
 	const std::set<std::string>& parameterNames) {
 
+	// The objects are selected through the station configurations of the
+	// requested modules whose database ids are known already. This avoids
+	// joining ConfigModule with a disjunction which forces the database
+	// to scan the whole configuration.
 	std::ostringstream query;
 
 	if ( classType.isTypeOf(Seiscomp::DataModel::ConfigStation::TypeInfo()) ) {
-		query << "SELECT DISTINCT PublicObject." << _T("publicID") << ",ConfigStation.* FROM ConfigStation LEFT JOIN PublicObject USING (_oid)";
-		query << " LEFT JOIN Setup ON Setup._parent_oid=ConfigStation._oid";
-		query << " LEFT JOIN PublicObject AS PParameterSet ON PParameterSet." << _T("publicID") << "=Setup." << _T("parameterSetID");
-		query << " LEFT JOIN ConfigModule ON (ConfigModule._oid=ConfigStation._parent_oid OR ConfigModule." << _T("parameterSetID") << "=PParameterSet." << _T("publicID") << ")";
-		if ( parameterNames.size() > 0) {
-			query << " LEFT JOIN ParameterSet ON ParameterSet._oid=PParameterSet._oid";
-			query << " LEFT JOIN Parameter ON Parameter._parent_oid=ParameterSet._oid";
+		query << "SELECT DISTINCT PublicObject." << _T("publicID") << ",ConfigStation.* FROM ConfigStation JOIN PublicObject USING (_oid)";
+		if ( setupName || !parameterNames.empty() )
+			query << " JOIN Setup ON Setup._parent_oid=ConfigStation._oid";
+		if ( !parameterNames.empty() ) {
+			query << " JOIN PublicObject AS PParameterSet ON PParameterSet." << _T("publicID") << "=Setup." << _T("parameterSetID");
+			query << " JOIN Parameter ON Parameter._parent_oid=PParameterSet._oid";
 		}
-
 	}
 	else if ( classType.isTypeOf(Seiscomp::DataModel::Setup::TypeInfo()) ) {
-		query << "SELECT DISTINCT Setup.* FROM Setup ";
-		query << " LEFT JOIN PublicObject AS PParameterSet ON PParameterSet." << _T("publicID") << "=Setup." << _T("parameterSetID");
-		query << " LEFT JOIN ConfigStation ON ConfigStation._oid=Setup._parent_oid";
-		query << " LEFT JOIN ConfigModule ON (ConfigModule._oid=ConfigStation._parent_oid OR ConfigModule." << _T("parameterSetID") << "=PParameterSet." << _T("publicID") << ")";
-		if ( parameterNames.size() > 0) {
-			query << " LEFT JOIN ParameterSet ON ParameterSet._oid=PParameterSet._oid";
-			query << " LEFT JOIN Parameter ON Parameter._parent_oid=ParameterSet._oid";
+		query << "SELECT DISTINCT Setup.* FROM Setup";
+		query << " JOIN ConfigStation ON ConfigStation._oid=Setup._parent_oid";
+		if ( !parameterNames.empty() ) {
+			query << " JOIN PublicObject AS PParameterSet ON PParameterSet." << _T("publicID") << "=Setup." << _T("parameterSetID");
+			query << " JOIN Parameter ON Parameter._parent_oid=PParameterSet._oid";
 		}
 	}
 	else if ( classType.isTypeOf(Seiscomp::DataModel::ParameterSet::TypeInfo()) ) {
-		query << "SELECT DISTINCT PublicObject." << _T("publicID") << ",ParameterSet.* FROM ParameterSet LEFT JOIN PublicObject USING (_oid)";
-		query << " LEFT JOIN Setup ON Setup." << _T("parameterSetID") << "=PublicObject." << _T("publicID");
-		query << " LEFT JOIN ConfigStation ON ConfigStation._oid=Setup._parent_oid";
-		query << " LEFT JOIN ConfigModule ON (ConfigModule._oid=ConfigStation._parent_oid OR ConfigModule." << _T("parameterSetID") << "=PublicObject." << _T("publicID") << ")";
-		query << " LEFT JOIN Parameter ON Parameter._parent_oid=ParameterSet._oid";
+		query << "SELECT DISTINCT PublicObject." << _T("publicID") << ",ParameterSet.* FROM ParameterSet JOIN PublicObject USING (_oid)";
+		query << " JOIN Setup ON Setup." << _T("parameterSetID") << "=PublicObject." << _T("publicID");
+		query << " JOIN ConfigStation ON ConfigStation._oid=Setup._parent_oid";
+		if ( !parameterNames.empty() )
+			query << " JOIN Parameter ON Parameter._parent_oid=ParameterSet._oid";
 	}
-	else if ( classType.isTypeOf(Seiscomp::DataModel::Parameter::TypeInfo()) ) {
-		query << "SELECT DISTINCT PublicObject." << _T("publicID") << ",Parameter.* FROM Parameter LEFT JOIN PublicObject USING (_oid)";
-		query << " LEFT JOIN ParameterSet ON ParameterSet._oid=Parameter._parent_oid ";
-		query << " LEFT JOIN PublicObject AS PParameterSet ON PParameterSet._oid=ParameterSet._oid ";
-		query << " LEFT JOIN Setup ON Setup." << _T("parameterSetID") << "=PParameterSet." << _T("publicID");
-		query << " LEFT JOIN ConfigStation ON ConfigStation._oid=Setup._parent_oid ";
-		query << " LEFT JOIN ConfigModule ON (ConfigModule._oid=ConfigStation._parent_oid OR ConfigModule." << _T("parameterSetID") << "=PParameterSet." << _T("publicID") << ")";
+	else
+		return Seiscomp::DataModel::DatabaseIterator();
+
+	query << " WHERE ConfigStation._parent_oid IN (" << moduleOids << ")";
+
+	if ( networkCode )
+		query << " AND ConfigStation." << _T("networkCode") << "=" << quoted(reader, *networkCode);
+	if ( stationCode )
+		query << " AND ConfigStation." << _T("stationCode") << "=" << quoted(reader, *stationCode);
+	if ( setupName )
+		query << " AND Setup." << _T("name") << "=" << quoted(reader, *setupName);
+	if ( !parameterNames.empty() ) {
+		query << " AND Parameter." << _T("name") << " IN (";
+		for ( auto it = parameterNames.begin(); it != parameterNames.end(); ++it ) {
+			if ( it != parameterNames.begin() ) query << ",";
+			query << quoted(reader, *it);
+		}
+		query << ")";
 	}
 
-	bool first = true;
+	return reader->getObjectIterator(query.str(), classType);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-	if ( moduleName ) {
-		if ( first ) { query << " WHERE "; first = false; }
-		else query << " AND ";
-		query << "ConfigModule." << _T("name") << "='" << *moduleName << "' ";
-	}
-	if ( networkCode ) {
-		if ( first ) { query << " WHERE "; first = false; }
-		else query << " AND ";
-		query << "ConfigStation." << _T("networkCode") << "='" << *networkCode << "' ";
-	}
-	if ( stationCode ) {
-		if ( first ) { query << " WHERE "; first = false; }
-		else query << " AND ";
-		query << "ConfigStation." << _T("stationCode") << "='" << *stationCode << "' ";
-	}
-	if ( setupName ) {
-		if ( first ) { query << " WHERE "; first = false; }
-		else query << " AND ";
-		query << "Setup." << _T("name") << "='" << *setupName << "' ";
-	}
-	if ( parameterNames.size() != 0 ) {
-		if ( first ) { query << " WHERE "; }
-		else query << " AND ";
-		std::set<std::string>::const_iterator it = parameterNames.begin();
-		query << "(Parameter." << _T("name") << "='" << *it << "'";
-		while(++it != parameterNames.end())
-			query << " OR Parameter." << _T("name") << "='" << *it << "'";
-		query << ") ";
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ConfigDB::addParameterSets(Seiscomp::DataModel::DatabaseIterator &it,
+                                std::vector<IO::DatabaseInterface::OID> &oids) {
+	for ( Seiscomp::DataModel::ObjectPtr obj; (obj = *it); ++it ) {
+		Seiscomp::DataModel::ParameterSetPtr parameterSet = Seiscomp::DataModel::ParameterSet::Cast(obj);
+		if ( parameterSet ) {
+			Seiscomp::DataModel::ParameterSetPtr existing = _config->findParameterSet(parameterSet->publicID());
+			if (existing) {
+				_parameterSets.insert(std::make_pair(it.oid(), existing));
+			}
+			else {
+				_parameterSets.insert(std::make_pair(it.oid(), parameterSet));
+				_config->add(parameterSet.get());
+			}
+			oids.push_back(it.oid());
+		}
 	}
 
-	return reader->getObjectIterator(query.str(), classType);
+	it.close();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -173,6 +205,7 @@ void ConfigDB::load(Seiscomp::DataModel::DatabaseReader* reader,
 	if ( !reader ) return;
 
 	Seiscomp::DataModel::DatabaseIterator it;
+	std::vector<IO::DatabaseInterface::OID> moduleOids;
 
 	it = reader->getObjects(_config.get(), Seiscomp::DataModel::ConfigModule::TypeInfo());
 	for ( Seiscomp::DataModel::ObjectPtr obj; (obj = *it); ++it ) {
@@ -188,15 +221,18 @@ void ConfigDB::load(Seiscomp::DataModel::DatabaseReader* reader,
 					_configModules.insert(std::make_pair(it.oid(), configModule));
 					_config->add(configModule.get());
 				}
+				moduleOids.push_back(it.oid());
 			}
 		}
 	}
 
 	it.close();
 
-	if ( _configModules.empty() ) return;
+	if ( moduleOids.empty() ) return;
 
-	it = getConfigObjects(reader, Seiscomp::DataModel::ConfigStation::TypeInfo(), moduleName,
+	std::string moduleOidList = idList(moduleOids, 0, moduleOids.size());
+
+	it = getConfigObjects(reader, Seiscomp::DataModel::ConfigStation::TypeInfo(), moduleOidList,
 		networkCode, stationCode, setupName, parameterNames);
 
 	for ( Seiscomp::DataModel::ObjectPtr obj; (obj = *it); ++it ) {
@@ -222,10 +258,7 @@ void ConfigDB::load(Seiscomp::DataModel::DatabaseReader* reader,
 
 	it.close();
 
-	//if ( parameterNames.size() == 0 )
-	//	return;
-
-	it = getConfigObjects(reader, Seiscomp::DataModel::Setup::TypeInfo(), moduleName,
+	it = getConfigObjects(reader, Seiscomp::DataModel::Setup::TypeInfo(), moduleOidList,
 		networkCode, stationCode, setupName, parameterNames);
 
 	for ( Seiscomp::DataModel::ObjectPtr obj; (obj = *it); ++it ) {
@@ -245,45 +278,85 @@ void ConfigDB::load(Seiscomp::DataModel::DatabaseReader* reader,
 
 	it.close();
 
-	it = getConfigObjects(reader, Seiscomp::DataModel::ParameterSet::TypeInfo(), moduleName,
-		networkCode, stationCode, setupName, parameterNames);
+	std::vector<IO::DatabaseInterface::OID> parameterSetOids;
 
-	for ( Seiscomp::DataModel::ObjectPtr obj; (obj = *it); ++it ) {
-		Seiscomp::DataModel::ParameterSetPtr parameterSet = Seiscomp::DataModel::ParameterSet::Cast(obj);
-		if ( parameterSet ) {
-//			std::cout << "_oid=" << it.oid() << ", _parent_oid=" << it.parentOid() << ", " << parameterSet->publicID() << std::endl;
-			Seiscomp::DataModel::ParameterSetPtr existing = _config->findParameterSet(parameterSet->publicID());
-			if (existing) {
-				_parameterSets.insert(std::make_pair(it.oid(), existing));
-			}
-			else {
-				_parameterSets.insert(std::make_pair(it.oid(), parameterSet));
-				_config->add(parameterSet.get());
+	it = getConfigObjects(reader, Seiscomp::DataModel::ParameterSet::TypeInfo(), moduleOidList,
+		networkCode, stationCode, setupName, parameterNames);
+	addParameterSets(it, parameterSetOids);
+
+	// Complete the parameter set chains: read the parameter sets of the
+	// modules and all base parameter sets which have not been read yet.
+	// Usually a single round is required.
+	for ( bool firstRound = true; ; firstRound = false ) {
+		std::set<std::string> missing;
+
+		if ( firstRound ) {
+			for ( auto oid : moduleOids ) {
+				const std::string &id = _configModules[oid]->parameterSetID();
+				if ( !id.empty() && !_config->findParameterSet(id) )
+					missing.insert(id);
 			}
 		}
-	}
 
-	it.close();
+		for ( auto &item : _parameterSets ) {
+			const std::string &id = item.second->baseID();
+			if ( !id.empty() && !_config->findParameterSet(id) )
+				missing.insert(id);
+		}
 
-	it = getConfigObjects(reader, Seiscomp::DataModel::Parameter::TypeInfo(), moduleName,
-		networkCode, stationCode, setupName, parameterNames);
+		if ( missing.empty() ) break;
 
-	for ( Seiscomp::DataModel::ObjectPtr obj; (obj = *it); ++it ) {
-		Seiscomp::DataModel::ParameterPtr parameter = Seiscomp::DataModel::Parameter::Cast(obj);
-		if ( parameter ) {
-//			std::cout << "_oid=" << it.oid() << ", _parent_oid=" << it.parentOid() << ", " << parameter->name() << std::endl;
-			std::map<int, Seiscomp::DataModel::ParameterSetPtr>::iterator p = _parameterSets.find(it.parentOid());
-			if ( p != _parameterSets.end() )	{
-				if ( !p->second->findParameter(parameter->publicID()) )
-					p->second->add(parameter.get());
+		std::vector<std::string> ids(missing.begin(), missing.end());
+		size_t count = parameterSetOids.size();
+
+		for ( size_t i = 0; i < ids.size(); i += MaxIdsPerQuery ) {
+			std::vector<std::string> chunk(ids.begin() + i,
+			                               ids.begin() + std::min(ids.size(), i + MaxIdsPerQuery));
+			it = reader->getObjectsByPublicIDs(Seiscomp::DataModel::ParameterSet::TypeInfo(), chunk);
+			addParameterSets(it, parameterSetOids);
+		}
+
+		// Referenced parameter sets which do not exist
+		if ( parameterSetOids.size() == count ) break;
+	}
+
+	// Read the parameters of all collected parameter sets by their
+	// database ids
+	for ( size_t i = 0; i < parameterSetOids.size(); i += MaxIdsPerQuery ) {
+		std::ostringstream query;
+		query << "SELECT PublicObject." << _T("publicID") << ",Parameter.* FROM Parameter JOIN PublicObject USING (_oid)"
+		      << " WHERE Parameter._parent_oid IN ("
+		      << idList(parameterSetOids, i, std::min(parameterSetOids.size(), i + MaxIdsPerQuery))
+		      << ")";
+
+		if ( !parameterNames.empty() ) {
+			query << " AND Parameter." << _T("name") << " IN (";
+			for ( auto pit = parameterNames.begin(); pit != parameterNames.end(); ++pit ) {
+				if ( pit != parameterNames.begin() ) query << ",";
+				query << quoted(reader, *pit);
 			}
-			else {
-				std::cout << "cannot find parent object" << it.parentOid() << std::endl;
+			query << ")";
+		}
+
+		it = reader->getObjectIterator(query.str(), Seiscomp::DataModel::Parameter::TypeInfo());
+
+		for ( Seiscomp::DataModel::ObjectPtr obj; (obj = *it); ++it ) {
+			Seiscomp::DataModel::ParameterPtr parameter = Seiscomp::DataModel::Parameter::Cast(obj);
+			if ( parameter ) {
+//				std::cout << "_oid=" << it.oid() << ", _parent_oid=" << it.parentOid() << ", " << parameter->name() << std::endl;
+				std::map<int, Seiscomp::DataModel::ParameterSetPtr>::iterator p = _parameterSets.find(it.parentOid());
+				if ( p != _parameterSets.end() )	{
+					if ( !p->second->findParameter(parameter->publicID()) )
+						p->second->add(parameter.get());
+				}
+				else {
+					std::cout << "cannot find parent object" << it.parentOid() << std::endl;
+				}
 			}
 		}
-	}
 
-	it.close();
+		it.close();
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -31,6 +31,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -65,11 +66,16 @@ class SC_SYSTEM_CLIENT_API ConfigDB {
 
 	DataModel::DatabaseIterator getConfigObjects(DataModel::DatabaseReader* reader,
 		const Core::RTTI& classType,
-		const OPT(std::string)& moduleName,
+		const std::string& moduleOids,
 		const OPT(std::string)& networkCode,
 		const OPT(std::string)& stationCode,
 		const OPT(std::string)& setupName,
 		const std::set<std::string>& parameterNames);
+
+	//! Adds the parameter sets read by the iterator and collects their
+	//! database ids
+	void addParameterSets(DataModel::DatabaseIterator &it,
+		std::vector<IO::DatabaseInterface::OID> &oids);
 };
 
 
@@ -20,10 +20,17 @@
 
 #include <seiscomp/client/inventory.h>
 #include <seiscomp/io/archive/xmlarchive.h>
+#include <seiscomp/io/archive/binarchive.h>
 #include <seiscomp/datamodel/responsefap.h>
 #include <seiscomp/datamodel/inventory_package.h>
+#include <seiscomp/processing/response.h>
 
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <limits>
 #include <set>
+#include <sstream>
 #include <iostream>
 
 
@@ -81,6 +88,9 @@ Inventory* Inventory::Instance() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Inventory::Reset(){
 	_instance._inventory = nullptr;
+	_instance._instrumentReader = nullptr;
+	_instance._missingInstruments.clear();
+	_instance.resetIndex();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -100,6 +110,9 @@ void Inventory::load(const char *filename) {
 		throw Core::GeneralException(std::string(filename) + " does not have inventory information");
 
 	ar.close();
+	_instrumentReader = nullptr;
+	_missingInstruments.clear();
+	resetIndex();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -107,7 +120,7 @@ void Inventory::load(const char *filename) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void Inventory::load(DataModel::DatabaseReader* reader) {
+void Inventory::load(DataModel::DatabaseReader* reader, bool instruments) {
 	if ( !reader ) return;
 
 	//_inventory = reader->loadInventory();
@@ -176,6 +189,20 @@ void Inventory::load(DataModel::DatabaseReader* reader) {
 
 	it.close();
 
+	if ( instruments )
+		readInstruments(reader);
+	else
+		_instrumentReader = reader;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Inventory::readInstruments(DataModel::DatabaseReader *reader) {
+	DataModel::DatabaseIterator it;
+
 	// Read sensors
 	std::map<int, DataModel::SensorPtr> sensors;
 	it = reader->getObjects(_inventory.get(), DataModel::Sensor::TypeInfo());
@@ -308,6 +335,10 @@ void Inventory::loadStations(DataModel::DatabaseReader* reader) {
 	if ( !reader ) return;
 
 	_inventory = new DataModel::Inventory();
+	_instrumentReader = nullptr;
+	_missingInstruments.clear();
+	resetIndex();
+
 	DataModel::DatabaseIterator it;
 
 	// Read networks
@@ -512,6 +543,229 @@ int Inventory::filter(const Util::StringFirewall *networkTypeFW,
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Inventory::setInventory(DataModel::Inventory *inv) {
 	_inventory = inv;
+	_instrumentReader = nullptr;
+	_missingInstruments.clear();
+	resetIndex();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string Inventory::modificationMarker(DataModel::DatabaseReader *reader) const {
+	static const char *tables[] = {
+		"Network", "Station", "SensorLocation", "Stream", "AuxStream",
+		"StationGroup", "StationReference", "AuxDevice", "AuxSource",
+		"Sensor", "SensorCalibration", "Datalogger", "DataloggerCalibration",
+		"Decimation", "ResponsePAZ", "ResponseFIR", "ResponsePolynomial",
+		"ResponseFAP", "ResponseIIR"
+	};
+
+	// Comments share a table with all other objects and only those
+	// attached to inventory objects are taken into account
+	static const char *commentParents[] = {
+		"Network", "Station", "SensorLocation", "Stream"
+	};
+
+	if ( !reader || !reader->driver() ) return std::string();
+
+	IO::DatabaseInterface *db = reader->driver();
+	std::string marker = reader->version().toString();
+
+	auto append = [db, &marker](const std::string &query) {
+		if ( !db->beginQuery(query.c_str()) ) return false;
+
+		if ( db->fetchRow() ) {
+			marker += ';';
+			marker += db->getRowFieldString(0);
+			marker += ',';
+			marker += db->getRowFieldString(1);
+		}
+
+		db->endQuery();
+		return true;
+	};
+
+	for ( const char *table : tables ) {
+		if ( !strcmp(table, "ResponseFAP") && !reader->supportsVersion<0,8>() )
+			continue;
+		if ( !strcmp(table, "ResponseIIR") && !reader->supportsVersion<0,10>() )
+			continue;
+
+		if ( !append(std::string("select count(*), max(_last_modified) from ") + table) )
+			return std::string();
+	}
+
+	for ( const char *parent : commentParents ) {
+		if ( !append(std::string("select count(*), max(Comment._last_modified) "
+		                         "from Comment, ") + parent +
+		             " where Comment._parent_oid = " + parent + "._oid") )
+			return std::string();
+	}
+
+	return marker;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Inventory::loadSnapshot(const std::string &filename, const std::string &marker) {
+	IO::VBinaryArchive ar;
+
+	if ( marker.empty() || !ar.open(filename.c_str()) )
+		return false;
+
+	std::string snapshotMarker;
+	ar.read(snapshotMarker);
+	if ( !ar.success() || snapshotMarker != marker )
+		return false;
+
+	DataModel::InventoryPtr inv;
+	ar >> inv;
+	if ( !inv || !ar.success() )
+		return false;
+
+	ar.close();
+
+	_inventory = inv;
+	_instrumentReader = nullptr;
+	_missingInstruments.clear();
+	resetIndex();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Inventory::saveSnapshot(const std::string &filename, const std::string &marker) const {
+	if ( !_inventory || marker.empty() ) return false;
+
+	// A snapshot without instruments would hide them from later loads
+	if ( _instrumentReader ) return false;
+
+	std::string tmpFilename = filename + ".tmp" + std::to_string(getpid());
+
+	IO::VBinaryArchive ar;
+	if ( !ar.create(tmpFilename.c_str()) )
+		return false;
+
+	std::string snapshotMarker = marker;
+	ar.write(snapshotMarker);
+	DataModel::InventoryPtr inv = _inventory;
+	ar << inv;
+	ar.close();
+
+	if ( !ar.success() || rename(tmpFilename.c_str(), filename.c_str()) != 0 ) {
+		unlink(tmpFilename.c_str());
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Inventory::loadInstruments(const DataModel::Stream *stream) {
+	if ( !stream || !_instrumentReader || !_inventory ) return false;
+
+	DataModel::Sensor *sensor = DataModel::Sensor::Cast(
+		fetchInstrument(DataModel::Sensor::TypeInfo(), stream->sensor())
+	);
+	if ( sensor )
+		fetchResponse(sensor->response());
+
+	DataModel::Datalogger *datalogger = DataModel::Datalogger::Cast(
+		fetchInstrument(DataModel::Datalogger::TypeInfo(), stream->datalogger())
+	);
+	if ( datalogger ) {
+		for ( size_t i = 0; i < datalogger->decimationCount(); ++i ) {
+			DataModel::Decimation *deci = datalogger->decimation(i);
+			std::string chain;
+
+			try { chain = deci->analogueFilterChain().content(); }
+			catch ( ... ) {}
+
+			try { chain += " " + deci->digitalFilterChain().content(); }
+			catch ( ... ) {}
+
+			std::istringstream iss(chain);
+			std::string publicID;
+			while ( iss >> publicID )
+				fetchResponse(publicID);
+		}
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DataModel::PublicObject *Inventory::fetchInstrument(const Core::RTTI &type,
+                                                    const std::string &publicID) {
+	if ( publicID.empty() ) return nullptr;
+
+	DataModel::PublicObject *obj = DataModel::PublicObject::Find(publicID);
+	if ( obj ) return obj;
+
+	if ( _missingInstruments.find(publicID) != _missingInstruments.end() )
+		return nullptr;
+
+	// Loads the object including its calibrations and decimations
+	DataModel::PublicObjectPtr po = _instrumentReader->loadObject(type, publicID);
+	if ( !po || !po->attachTo(_inventory.get()) ) {
+		_missingInstruments.insert(publicID);
+		return nullptr;
+	}
+
+	return po.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Inventory::fetchResponse(const std::string &publicID) {
+	if ( publicID.empty() || DataModel::PublicObject::Find(publicID) )
+		return;
+
+	if ( _missingInstruments.find(publicID) != _missingInstruments.end() )
+		return;
+
+	// The response type is not known from the reference
+	std::vector<const Core::RTTI*> types = {
+		&DataModel::ResponsePAZ::TypeInfo(),
+		&DataModel::ResponseFIR::TypeInfo(),
+		&DataModel::ResponsePolynomial::TypeInfo()
+	};
+
+	if ( _instrumentReader->supportsVersion<0,8>() )
+		types.push_back(&DataModel::ResponseFAP::TypeInfo());
+
+	if ( _instrumentReader->supportsVersion<0,10>() )
+		types.push_back(&DataModel::ResponseIIR::TypeInfo());
+
+	for ( const Core::RTTI *type : types ) {
+		DataModel::PublicObjectPtr po = _instrumentReader->loadObject(*type, publicID);
+		if ( po ) {
+			po->attachTo(_inventory.get());
+			return;
+		}
+	}
+
+	_missingInstruments.insert(publicID);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -544,6 +798,9 @@ DataModel::Station* Inventory::getStation(const std::string &networkCode,
                                           const std::string &stationCode,
                                           const Core::Time &time,
                                           DataModel::InventoryError *error) const {
+	if ( _index )
+		return _index->getStation(networkCode, stationCode, time, error);
+
 	return DataModel::getStation(_inventory.get(), networkCode, stationCode, time, error);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -558,6 +815,10 @@ Inventory::getSensorLocation(const std::string &networkCode,
                              const std::string &locationCode,
                              const Core::Time &time,
                              DataModel::InventoryError *error) const {
+	if ( _index )
+		return _index->getSensorLocation(networkCode, stationCode,
+		                                 locationCode, time, error);
+
 	return DataModel::getSensorLocation(_inventory.get(), networkCode, stationCode,
 	                                    locationCode, time, error);
 }
@@ -598,6 +859,10 @@ Inventory::getStream(const std::string &networkCode,
                      const std::string &channelCode,
                      const Core::Time &time,
                      DataModel::InventoryError *error) const {
+	if ( _index )
+		return _index->getStream(networkCode, stationCode, locationCode,
+		                         channelCode, time, error);
+
 	return DataModel::getStream(_inventory.get(), networkCode, stationCode,
 	                            locationCode, channelCode, time, error);
 }
@@ -653,8 +918,83 @@ int Inventory::getAllStations(StationList& stationList,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Math::Geo::UnitVectors &
+Inventory::stationVectors(const StationList &stations) {
+	std::vector<double> coordinates(stations.size()*2);
+
+	for ( size_t i = 0; i < stations.size(); ++i ) {
+		try {
+			coordinates[i*2] = stations[i]->latitude();
+			coordinates[i*2+1] = stations[i]->longitude();
+		}
+		catch ( ... ) {
+			coordinates[i*2] = coordinates[i*2+1] = std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+
+	// Compare the bit patterns to also match stations without coordinates
+	if ( stations == _vectorStations && coordinates.size() == _vectorCoordinates.size()
+	  && !memcmp(coordinates.data(), _vectorCoordinates.data(),
+	             coordinates.size() * sizeof(double)) )
+		return _stationVectors;
+
+	_stationVectors.clear();
+	_stationVectors.reserve(stations.size());
+	for ( size_t i = 0; i < stations.size(); ++i )
+		_stationVectors.push_back(coordinates[i*2], coordinates[i*2+1]);
+
+	_vectorStations = stations;
+	_vectorCoordinates.swap(coordinates);
+
+	return _stationVectors;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t Inventory::getSensorLocations(DataModel::InventoryIndex::SensorLocationDistances &result,
+                                     double lat, double lon, double radius,
+                                     const Core::Time &time) const {
+	if ( !_index ) {
+		result.clear();
+		return 0;
+	}
+
+	return _index->getSensorLocations(result, lat, lon, radius, time);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t Inventory::getNearestSensorLocations(DataModel::InventoryIndex::SensorLocationDistances &result,
+                                            double lat, double lon, size_t count,
+                                            const Core::Time &time,
+                                            double maxDistance) const {
+	if ( !_index ) {
+		result.clear();
+		return 0;
+	}
+
+	return _index->getNearestSensorLocations(result, lat, lon, count,
+	                                         time, maxDistance);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DataModel::Station* Inventory::getStation(const DataModel::Pick* pick) const {
+	if ( _index && pick )
+		return _index->getStation(pick->waveformID().networkCode(),
+		                          pick->waveformID().stationCode(),
+		                          pick->time().value());
+
 	return DataModel::getStation(_inventory.get(), pick);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -664,6 +1004,12 @@ DataModel::Station* Inventory::getStation(const DataModel::Pick* pick) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DataModel::SensorLocation* Inventory::getSensorLocation(const DataModel::Pick *pick) const {
+	if ( _index && pick )
+		return _index->getSensorLocation(pick->waveformID().networkCode(),
+		                                 pick->waveformID().stationCode(),
+		                                 pick->waveformID().locationCode(),
+		                                 pick->time().value());
+
 	return DataModel::getSensorLocation(_inventory.get(), pick);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -673,6 +1019,13 @@ DataModel::SensorLocation* Inventory::getSensorLocation(const DataModel::Pick *p
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DataModel::Stream* Inventory::getStream(const DataModel::Pick *pick) const {
+	if ( _index && pick )
+		return _index->getStream(pick->waveformID().networkCode(),
+		                         pick->waveformID().stationCode(),
+		                         pick->waveformID().locationCode(),
+		                         pick->waveformID().channelCode(),
+		                         pick->time().value());
+
 	return DataModel::getStream(_inventory.get(), pick);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -719,6 +1072,32 @@ double Inventory::getGain(const std::string& networkCode,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Inventory::resetIndex() {
+	_vectorStations.clear();
+	_vectorCoordinates.clear();
+	_stationVectors.clear();
+
+	// A new inventory may reuse the public IDs of responses
+	Processing::Response::clearCache();
+
+	// The index is created on demand and not with the static instance
+	// to not depend on the initialization order of the observer registry
+	if ( !_inventory ) {
+		_index.reset();
+		return;
+	}
+
+	if ( !_index )
+		_index.reset(new DataModel::InventoryIndex);
+
+	_index->setInventory(_inventory.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DataModel::Inventory* Inventory::inventory() {
 	return _inventory.get();
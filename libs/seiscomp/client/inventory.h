@@ -25,11 +25,14 @@
 #include <seiscomp/datamodel/inventory.h>
 #include <seiscomp/datamodel/pick.h>
 #include <seiscomp/datamodel/databasereader.h>
+#include <seiscomp/datamodel/inventoryindex.h>
 #include <seiscomp/datamodel/utils.h>
 #include <seiscomp/utils/stringfirewall.h>
+#include <seiscomp/math/geo.h>
 #include <seiscomp/client.h>
 
 #include <map>
+#include <memory>
 #include <set>
 
 
@@ -67,14 +70,64 @@ class SC_SYSTEM_CLIENT_API Inventory {
 		static void Reset();
 
 		void load(const char *filename);
-		void load(DataModel::DatabaseReader*);
+
+		/**
+		 * @brief Loads the inventory from a database.
+		 * @param reader The database reader
+		 * @param instruments Whether sensors, dataloggers and responses
+		 *                    are loaded as well. If false then the reader
+		 *                    is kept and they are loaded on demand with
+		 *                    loadInstruments.
+		 */
+		void load(DataModel::DatabaseReader *reader, bool instruments = true);
 		void setInventory(DataModel::Inventory*);
 
+		/**
+		 * @brief Returns a marker which changes with every modification
+		 *        of the inventory tables in a database. It is composed of
+		 *        the number of rows and the latest modification time of
+		 *        each table and is cheap to compute compared to loading
+		 *        the inventory.
+		 * @param reader The database reader
+		 * @return The marker or an empty string if it could not be queried
+		 */
+		std::string modificationMarker(DataModel::DatabaseReader *reader) const;
+
+		/**
+		 * @brief Loads the inventory from a binary snapshot if it has been
+		 *        written with the same modification marker.
+		 * @param filename The snapshot file
+		 * @param marker The current modification marker of the database
+		 * @return true if the snapshot is valid and has been loaded
+		 */
+		bool loadSnapshot(const std::string &filename, const std::string &marker);
+
+		/**
+		 * @brief Writes the current inventory as binary snapshot. The file
+		 *        is replaced atomically so that concurrently starting
+		 *        applications never read a partial snapshot.
+		 * @param filename The snapshot file
+		 * @param marker The modification marker the inventory corresponds to
+		 * @return true on success
+		 */
+		bool saveSnapshot(const std::string &filename, const std::string &marker) const;
+
 		int filter(const Util::StringFirewall *networkTypeFW,
 		           const Util::StringFirewall *stationTypeFW);
 
 		void loadStations(DataModel::DatabaseReader*);
 
+		/**
+		 * @brief Loads the sensor, the datalogger and their responses
+		 *        referenced by a stream if the inventory has been loaded
+		 *        without instruments and they are not yet available.
+		 *        Objects which could not be found are not requested again.
+		 * @param stream The stream
+		 * @return false if instruments are not loaded on demand, true
+		 *         otherwise
+		 */
+		bool loadInstruments(const DataModel::Stream *stream);
+
 		//! Returns the station location for a network- and stationcode and
 		//! a time. If the station has not been found a ValueException will
 		//! be thrown.
@@ -137,14 +190,56 @@ class SC_SYSTEM_CLIENT_API Inventory {
 		//! Returns all defined stations for the given time
 		int getAllStations(StationList&, const Core::Time&);
 
+		//! Returns the cartesian unit vectors of the given stations in the
+		//! same order, e.g. of the list returned by getAllStations. This
+		//! allows to compute the distances of all stations to an origin
+		//! with Math::Geo::UnitVectors::delta. The vectors are kept and
+		//! only recomputed if the stations or their coordinates change.
+		//! Stations without coordinates result in NaN distances.
+		const Math::Geo::UnitVectors &stationVectors(const StationList &stations);
+
+		//! Returns all sensor locations within radius degrees of a point
+		//! which are active at the given time sorted by their distance,
+		//! see DataModel::InventoryIndex::getSensorLocations.
+		size_t getSensorLocations(DataModel::InventoryIndex::SensorLocationDistances &result,
+		                          double lat, double lon, double radius,
+		                          const Core::Time &) const;
+
+		//! Returns the count nearest sensor locations of a point which are
+		//! active at the given time sorted by their distance, see
+		//! DataModel::InventoryIndex::getNearestSensorLocations.
+		size_t getNearestSensorLocations(DataModel::InventoryIndex::SensorLocationDistances &result,
+		                                 double lat, double lon, size_t count,
+		                                 const Core::Time &,
+		                                 double maxDistance = 180) const;
+
 		DataModel::Inventory* inventory();
 
 
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		void resetIndex();
+		void readInstruments(DataModel::DatabaseReader *reader);
+		DataModel::PublicObject *fetchInstrument(const Core::RTTI &type,
+		                                         const std::string &publicID);
+		void fetchResponse(const std::string &publicID);
+
+
 	// ----------------------------------------------------------------------
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
+		typedef std::unique_ptr<DataModel::InventoryIndex> InventoryIndexPtr;
+
 		DataModel::InventoryPtr _inventory;
+		InventoryIndexPtr       _index;
+		StationList             _vectorStations;
+		std::vector<double>     _vectorCoordinates;
+		Math::Geo::UnitVectors  _stationVectors;
+		DataModel::DatabaseReaderPtr _instrumentReader;
+		std::set<std::string>   _missingInstruments;
 		static Inventory        _instance;
 };
 
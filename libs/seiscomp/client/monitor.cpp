@@ -19,6 +19,9 @@
 
 
 #include <seiscomp/client/monitor.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
 
 
@@ -26,6 +29,41 @@ namespace Seiscomp {
 namespace Client {
 
 
+namespace {
+
+
+const int LatencySubBins = 8;
+const int LatencyExponents = 33;
+
+
+size_t latencyBin(double seconds) {
+	double us = seconds * 1E6;
+	if ( !(us >= 1) ) return 0;
+
+	int exp;
+	// frexp returns a mantissa in [0.5,1)
+	double mantissa = frexp(us, &exp);
+	--exp;
+	if ( exp >= LatencyExponents )
+		return 1 + LatencyExponents * LatencySubBins - 1;
+
+	int sub = static_cast<int>((mantissa * 2 - 1) * LatencySubBins);
+	return 1 + exp * LatencySubBins + sub;
+}
+
+
+double latencyBinUpperBound(size_t bin) {
+	if ( !bin ) return 1E-6;
+	--bin;
+	int exp = int(bin / LatencySubBins);
+	int sub = int(bin % LatencySubBins);
+	return ldexp(1.0 + double(sub + 1) / LatencySubBins, exp) * 1E-6;
+}
+
+
+}
+
+
 RunningAverage::RunningAverage(int timeSpanInSeconds) {
 	_timeSpan = timeSpanInSeconds;
 	if ( _timeSpan < 1 ) _timeSpan = 1;
@@ -184,5 +222,86 @@ size_t ObjectMonitor::size() const {
 }
 
 
+LatencyHistogram::LatencyHistogram()
+: _bins(1 + LatencyExponents * LatencySubBins, 0)
+, _count(0), _sum(0), _maximum(0) {}
+
+
+void LatencyHistogram::push(double seconds) {
+	if ( !(seconds > 0) ) seconds = 0;
+	++_bins[latencyBin(seconds)];
+	++_count;
+	_sum += seconds;
+	if ( seconds > _maximum ) _maximum = seconds;
+}
+
+
+void LatencyHistogram::reset() {
+	std::fill(_bins.begin(), _bins.end(), 0);
+	_count = 0;
+	_sum = 0;
+	_maximum = 0;
+}
+
+
+double LatencyHistogram::mean() const {
+	return _count ? _sum / _count : 0;
+}
+
+
+double LatencyHistogram::percentile(double p) const {
+	if ( !_count ) return 0;
+
+	size_t rank = static_cast<size_t>(ceil(p * 0.01 * _count));
+	if ( rank < 1 ) rank = 1;
+
+	size_t cumulated = 0;
+	for ( size_t i = 0; i < _bins.size(); ++i ) {
+		cumulated += _bins[i];
+		if ( cumulated >= rank )
+			return std::min(latencyBinUpperBound(i), _maximum);
+	}
+
+	return _maximum;
+}
+
+
+void LatencyMonitor::push(const std::string &name, double seconds) {
+	std::lock_guard<std::mutex> l(_mutex);
+	_histograms[name].push(seconds);
+}
+
+
+LatencyMonitor::Histograms LatencyMonitor::histograms() const {
+	std::lock_guard<std::mutex> l(_mutex);
+	return _histograms;
+}
+
+
+void LatencyMonitor::reset() {
+	std::lock_guard<std::mutex> l(_mutex);
+	_histograms.clear();
+}
+
+
+void LatencyMonitor::dump(std::ostream &os) const {
+	std::lock_guard<std::mutex> l(_mutex);
+	std::ios::fmtflags flags = os.flags();
+
+	os << std::fixed << std::setprecision(3);
+	for ( const auto &item : _histograms ) {
+		const LatencyHistogram &h = item.second;
+		os << item.first << ": count=" << h.count()
+		   << " mean=" << h.mean() * 1E3
+		   << " p50=" << h.percentile(50) * 1E3
+		   << " p90=" << h.percentile(90) * 1E3
+		   << " p99=" << h.percentile(99) * 1E3
+		   << " max=" << h.maximum() * 1E3 << " ms" << std::endl;
+	}
+
+	os.flags(flags);
+}
+
+
 }
 }
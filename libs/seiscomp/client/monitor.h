@@ -26,6 +26,9 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
+#include <mutex>
+#include <ostream>
 
 
 namespace Seiscomp {
@@ -107,6 +110,85 @@ class SC_SYSTEM_CLIENT_API ObjectMonitor {
 };
 
 
+/**
+ * @brief The LatencyHistogram class aggregates durations in log-linear bins
+ *        and allows to estimate percentiles with bounded memory.
+ *
+ * Each power of two of microseconds is divided into eight bins which
+ * gives a relative error of less than 10% for all percentiles. Durations
+ * up to about 70 minutes are recorded, longer durations are added to the
+ * last bin.
+ */
+class SC_SYSTEM_CLIENT_API LatencyHistogram {
+	public:
+		LatencyHistogram();
+
+
+	public:
+		//! Adds a duration in seconds, negative values are clipped to 0
+		void push(double seconds);
+
+		//! Removes all values
+		void reset();
+
+		size_t count() const { return _count; }
+
+		//! Returns the mean duration in seconds
+		double mean() const;
+
+		//! Returns the maximum duration in seconds
+		double maximum() const { return _maximum; }
+
+		/**
+		 * @brief Returns an estimate of a percentile in seconds. The
+		 *        estimate is the upper bound of the bin which holds the
+		 *        percentile but not larger than the maximum.
+		 * @param p The percentile in the range [0,100]
+		 */
+		double percentile(double p) const;
+
+
+	private:
+		std::vector<size_t> _bins;
+		size_t              _count;
+		double              _sum;
+		double              _maximum;
+};
+
+
+/**
+ * @brief The LatencyMonitor class collects named latency histograms. It is
+ *        thread-safe.
+ */
+class SC_SYSTEM_CLIENT_API LatencyMonitor {
+	public:
+		typedef std::map<std::string, LatencyHistogram> Histograms;
+
+
+	public:
+		//! Adds a duration in seconds to the histogram of the given name
+		void push(const std::string &name, double seconds);
+
+		//! Returns a copy of all histograms
+		Histograms histograms() const;
+
+		//! Removes all histograms
+		void reset();
+
+		/**
+		 * @brief Writes one line per histogram with the number of values,
+		 *        mean, 50th, 90th, 99th percentile and maximum in
+		 *        milliseconds.
+		 */
+		void dump(std::ostream &os) const;
+
+
+	private:
+		mutable std::mutex _mutex;
+		Histograms         _histograms;
+};
+
+
 }
 }
 
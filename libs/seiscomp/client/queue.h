@@ -112,6 +112,25 @@ class ThreadedQueue {
 		 */
 		T pop();
 
+		/**
+		 * @brief Pops all queued items at once. If the queue is empty then
+		 *        it blocks until a producer pushed an item. A single
+		 *        consumer can drain many items per wake-up and lock.
+		 * @param items The vector the popped items are appended to.
+		 * @param max The maximum number of items to pop, 0 for no limit.
+		 * @return The number of popped items.
+		 */
+		size_t popAll(std::vector<T> &items, size_t max = 0);
+
+		/**
+		 * @brief Removes all queued items without blocking, also if the
+		 *        queue has been closed. This allows to release items
+		 *        which are not pointers before the queue is reset.
+		 * @param items The vector the removed items are appended to.
+		 * @return The number of removed items.
+		 */
+		size_t drain(std::vector<T> &items);
+
 		/**
 		 * @brief Close the queue and cause all subsequent calls to push and
 		 *        pop to fail.
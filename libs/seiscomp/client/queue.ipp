@@ -132,7 +132,7 @@ bool ThreadedQueue<T>::push(T v) {
 	_buffer[_end] = v;
 	_end = (_end+1) % _buffer.size();
 	++_buffered;
-	_notEmpty.notify_all();
+	_notEmpty.notify_one();
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -162,7 +162,7 @@ bool ThreadedQueue<T>::pushUnique(T v) {
 	_buffer[_end] = v;
 	_end = (_end+1) % _buffer.size();
 	++_buffered;
-	_notEmpty.notify_all();
+	_notEmpty.notify_one();
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -198,7 +198,7 @@ T ThreadedQueue<T>::pop() {
 	_buffer[_begin] = QueueHelper<T, std::is_pointer<T>::value>::defaultValue();
 	_begin = (_begin+1) % _buffer.size();
 	--_buffered;
-	_notFull.notify_all();
+	_notFull.notify_one();
 	return v;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -206,6 +206,57 @@ T ThreadedQueue<T>::pop() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+size_t ThreadedQueue<T>::popAll(std::vector<T> &items, size_t max) {
+	lock lk(_monitor);
+	while (_buffered == 0 && !_closed) {
+		_notEmpty.wait(lk);
+	}
+	if ( _closed )
+		throw QueueClosedException();
+
+	size_t n = _buffered;
+	if ( max && n > max ) n = max;
+
+	items.reserve(items.size() + n);
+	for ( size_t i = 0; i < n; ++i ) {
+		items.push_back(_buffer[_begin]);
+		_buffer[_begin] = QueueHelper<T, std::is_pointer<T>::value>::defaultValue();
+		_begin = (_begin+1) % _buffer.size();
+	}
+
+	_buffered -= n;
+	_notFull.notify_all();
+	return n;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+size_t ThreadedQueue<T>::drain(std::vector<T> &items) {
+	lock lk(_monitor);
+
+	size_t n = _buffered;
+	items.reserve(items.size() + n);
+	for ( size_t i = 0; i < n; ++i ) {
+		items.push_back(_buffer[_begin]);
+		_buffer[_begin] = QueueHelper<T, std::is_pointer<T>::value>::defaultValue();
+		_begin = (_begin+1) % _buffer.size();
+	}
+
+	_buffered = 0;
+	_notFull.notify_all();
+	return n;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 void ThreadedQueue<T>::close() {
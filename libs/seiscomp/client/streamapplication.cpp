@@ -21,8 +21,12 @@
 #define SEISCOMP_COMPONENT StreamApplication
 
 #include <seiscomp/logging/log.h>
-#include <seiscomp/io/recordinput.h>
+#include <seiscomp/core/recordpool.h>
 #include <seiscomp/client/streamapplication.h>
+#include <seiscomp/system/threads.h>
+#ifndef WIN32
+#include <seiscomp/io/recordstream/shm.h>
+#endif
 
 #include <functional>
 
@@ -42,6 +46,7 @@ StreamApplication::StreamApplication(int argc, char **argv)
 	_closeOnAcquisitionFinished = true;
 	_recordInputHint = Record::DATA_ONLY;
 	_recordDatatype = Array::FLOAT;
+	_recordBatchSize = 64;
 	_logRecords = nullptr;
 	_receivedRecords = 0;
 }
@@ -96,6 +101,18 @@ bool StreamApplication::init() {
 		return false;
 	}
 
+	if ( !_settings.recordstream.publish.empty() ) {
+		if ( _settings.recordstream.publishSize <= 0 ) {
+			SEISCOMP_ERROR("Invalid recordstream.publishSize: %d",
+			               _settings.recordstream.publishSize);
+			return false;
+		}
+
+		if ( !setSharedMemoryPublisher(_settings.recordstream.publish,
+		                               static_cast<size_t>(_settings.recordstream.publishSize) * 1024 * 1024) )
+			return false;
+	}
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -126,6 +143,9 @@ void StreamApplication::done() {
 	waitForRecordThread();
 
 	_recordStream = nullptr;
+#ifndef WIN32
+	_publisher = nullptr;
+#endif
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -148,7 +168,27 @@ bool StreamApplication::dispatch(Core::BaseObject* obj) {
 	if ( Client::Application::dispatch(obj) ) return true;
 	Record *rec = Record::Cast(obj);
 	if ( rec ) {
+		if ( latencyMonitor() ) {
+			try {
+				latencyMonitor()->push(
+					"recordDelay",
+					(Core::Time::UTC() - rec->endTime()).length()
+				);
+			}
+			catch ( ... ) {}
+		}
+
+		if ( isMetricsEnabled() ) {
+			Core::Metrics::Counter *&counter = _recordCounters[rec->streamID()];
+			if ( !counter ) {
+				counter = &Core::Metrics::counter("records." + rec->streamID());
+			}
+			counter->add();
+		}
+
+		handlerStarted();
 		handleRecord(rec);
+		handlerFinished("handleRecord");
 		return true;
 	}
 
@@ -206,9 +246,56 @@ void StreamApplication::setRecordDatatype(Array::DataType datatype) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void StreamApplication::setRecordPoolCapacity(size_t capacity) {
+	RecordPool::setCapacity(capacity);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void StreamApplication::setRecordBatchSize(size_t size) {
+	_recordBatchSize = size ? size : 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool StreamApplication::setSharedMemoryPublisher(const std::string &name,
+                                                 size_t capacity) {
+#ifndef WIN32
+	if ( name.empty() ) {
+		_publisher = nullptr;
+		return true;
+	}
+
+	std::unique_ptr<RecordStream::SharedMemoryPublisher> publisher(
+		new RecordStream::SharedMemoryPublisher
+	);
+
+	if ( !publisher->open(name, capacity) )
+		return false;
+
+	_publisher = std::move(publisher);
+	return true;
+#else
+	if ( name.empty() ) return true;
+	SEISCOMP_ERROR("Publishing records to shared memory is not supported on this platform");
+	return false;
+#endif
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void StreamApplication::startRecordThread() {
-	_recordThread = new std::thread(std::bind(&StreamApplication::readRecords, this, true));
+	_recordThread = new std::thread(System::startThread("records", std::bind(&StreamApplication::readRecords, this, true)));
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -335,26 +422,44 @@ void StreamApplication::closeStream() {
 void StreamApplication::readRecords(bool sendEndNotification) {
 	SEISCOMP_INFO("Starting record acquisition");
 
-	IO::RecordInput recInput(_recordStream.get(), _recordDatatype, _recordInputHint);
+	_recordStream->setDataType(_recordDatatype);
+	_recordStream->setDataHint(_recordInputHint);
+
+	std::vector<Record*> records;
+
 	try {
-		for ( IO::RecordIterator it = recInput.begin(); it != recInput.end(); ++it ) {
-			Record* rec = *it;
-			if ( rec ) {
+		while ( _recordStream->nextBatch(records, _recordBatchSize) ) {
+			size_t valid = 0;
+
+			for ( size_t i = 0; i < records.size(); ++i ) {
+				Record *rec = records[i];
 				try {
 					rec->endTime();
-					if ( !storeRecord(rec) ) {
-						delete rec;
-						return;
-					}
-					++_receivedRecords;
+					records[valid++] = rec;
 				}
 				catch ( ... ) {
-					delete rec;
 					SEISCOMP_ERROR("Skipping invalid record for %s.%s.%s.%s (fsamp: %0.2f, nsamp: %d)",
 					               rec->networkCode().c_str(), rec->stationCode().c_str(), rec->locationCode().c_str(),
 					               rec->channelCode().c_str(), rec->samplingFrequency(), rec->sampleCount());
+					delete rec;
 				}
 			}
+
+			records.resize(valid);
+
+#ifndef WIN32
+			if ( _publisher ) {
+				for ( auto rec : records )
+					_publisher->publish(rec);
+			}
+#endif
+
+			if ( !records.empty() ) {
+				if ( !storeRecords(records) ) return;
+				_receivedRecords += valid;
+			}
+
+			records.clear();
 		}
 	}
 	catch ( Core::OperationInterrupted& e ) {
@@ -364,6 +469,10 @@ void StreamApplication::readRecords(bool sendEndNotification) {
 		SEISCOMP_ERROR("Exception in acquisition: '%s'", e.what());
 	}
 
+	// Records of an interrupted batch
+	for ( auto rec : records )
+		delete rec;
+
 	if ( sendEndNotification )
 		sendNotification(Notification::AcquisitionFinished);
 
@@ -396,4 +505,23 @@ bool StreamApplication::storeRecord(Record *rec) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool StreamApplication::storeRecords(std::vector<Record*> &records) {
+	for ( size_t i = 0; i < records.size(); ++i ) {
+		if ( !storeRecord(records[i]) ) {
+			// The records which have not been stored are still owned here
+			for ( ; i < records.size(); ++i )
+				delete records[i];
+			records.clear();
+			return false;
+		}
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
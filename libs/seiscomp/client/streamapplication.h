@@ -26,10 +26,19 @@
 #include <seiscomp/core/record.h>
 #include <seiscomp/io/recordstream.h>
 
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 
 
 namespace Seiscomp {
+
+namespace RecordStream {
+
+class SharedMemoryPublisher;
+
+}
+
 namespace Client {
 
 
@@ -82,6 +91,28 @@ class SC_SYSTEM_CLIENT_API StreamApplication : public Application {
 		//! Returns the data type of the internal record sample buffer
 		Array::DataType recordDataType() const { return _recordDatatype; }
 
+		//! Enables recycling of record objects and their sample arrays
+		//! once the last reference to a record is released. The capacity
+		//! is the number of records and arrays kept for reuse, 0 (the
+		//! default) disables the pool. This reduces the allocator load of
+		//! applications which receive many records per second.
+		//! The pool is process wide, see Seiscomp::RecordPool.
+		void setRecordPoolCapacity(size_t capacity);
+
+		//! Sets the maximum number of records which are read from the
+		//! record stream at once, see IO::RecordStream::nextBatch.
+		//! The default is 64.
+		void setRecordBatchSize(size_t size);
+
+		//! Publishes all received records to the POSIX shared memory
+		//! segment with the given name so that co-located processes can
+		//! read them with the record stream shm://name instead of opening
+		//! their own upstream connections. The capacity of the ring buffer
+		//! is given in bytes. An empty name disables publishing. This
+		//! method has to be called before the acquisition is started.
+		//! It is called by init() if recordstream.publish is configured.
+		bool setSharedMemoryPublisher(const std::string &name, size_t capacity);
+
 		void startRecordThread();
 		void waitForRecordThread();
 		bool isRecordThreadActive() const;
@@ -113,6 +144,13 @@ class SC_SYSTEM_CLIENT_API StreamApplication : public Application {
 		//! to this method.
 		virtual bool storeRecord(Record *rec);
 
+		//! This method gets called with the batch of records returned
+		//! by the record stream in the recordstream thread.
+		//! The default implementation calls storeRecord for each record.
+		//! The records are not managed and ownership is transferred
+		//! to this method.
+		virtual bool storeRecords(std::vector<Record*> &records);
+
 		//! This method gets called when a record has been popped from
 		//! the event queue in the main thread. The ownership of the
 		//! pointer is transferred to this method. An empty function
@@ -128,10 +166,16 @@ class SC_SYSTEM_CLIENT_API StreamApplication : public Application {
 		bool                _closeOnAcquisitionFinished;
 		Record::Hint        _recordInputHint;
 		Array::DataType     _recordDatatype;
+		size_t              _recordBatchSize;
 		IO::RecordStreamPtr _recordStream;
+#ifndef WIN32
+		std::unique_ptr<RecordStream::SharedMemoryPublisher> _publisher;
+#endif
 		std::thread        *_recordThread;
 		size_t              _receivedRecords;
 		ObjectLog          *_logRecords;
+
+		std::unordered_map<std::string, Core::Metrics::Counter*> _recordCounters;
 };
 
 
@@ -0,0 +1,157 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SC_CORE_ARRAYVIEW_H
+#define SC_CORE_ARRAYVIEW_H
+
+
+#include <seiscomp/core/typedarray.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace Seiscomp {
+
+
+/**
+ * @brief A non-owning, read-only window into the samples of a TypedArray.
+ *
+ * The view references a contiguous range of an existing array without
+ * taking a reference to it. Creating, copying and slicing views never
+ * copies samples which makes it suitable to pass sub windows of buffered
+ * data to processing routines. Because the view does not touch the
+ * reference count it can be used for arrays on the stack or arrays which
+ * are members of other objects as well.
+ *
+ * The caller must keep the referenced array alive and must not resize it
+ * while a view to it exists.
+ */
+template <typename T>
+class ArrayView {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		typedef T Type;
+		typedef const T *const_iterator;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! Constructs an empty view
+		ArrayView() = default;
+
+		//! Constructs a view of the whole array
+		explicit ArrayView(const TypedArray<T> *array)
+		: _array(array)
+		, _data(array ? array->typedData() : nullptr)
+		, _size(array ? static_cast<size_t>(array->size()) : 0) {}
+
+		//! Constructs a view of the samples [from, to) of the array. The
+		//! indexes are clipped to the bounds of the array.
+		ArrayView(const TypedArray<T> *array, int from, int to)
+		: ArrayView(array) {
+			*this = slice(from, to);
+		}
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the referenced array or nullptr
+		const TypedArray<T> *array() const { return _array; }
+
+		//! Returns the offset of the first sample with respect to the
+		//! referenced array
+		size_t offset() const { return _array ? _data - _array->typedData() : 0; }
+
+		const T *data() const { return _data; }
+		size_t size() const { return _size; }
+		bool empty() const { return _size == 0; }
+
+		const T &operator[](size_t index) const { return _data[index]; }
+		const T &front() const { return _data[0]; }
+		const T &back() const { return _data[_size-1]; }
+
+		const_iterator begin() const { return _data; }
+		const_iterator end() const { return _data + _size; }
+
+		//! Returns the view of the samples [from, to) of this view. The
+		//! indexes are clipped to the bounds of this view.
+		ArrayView slice(int from, int to) const {
+			ArrayView v(*this);
+			from = std::max(0, std::min(from, static_cast<int>(_size)));
+			to = std::max(from, std::min(to, static_cast<int>(_size)));
+			v._data = _data + from;
+			v._size = static_cast<size_t>(to - from);
+			return v;
+		}
+
+		//! Returns an owning copy of the viewed samples
+		TypedArray<T> *copy() const {
+			return new TypedArray<T>(static_cast<int>(_size), _data);
+		}
+
+		//! Returns the median value of the viewed samples, computed as in
+		//! NumericArray::median.
+		T median() const {
+			if ( empty() ) return T();
+			std::vector<T> vec(begin(), end());
+			std::nth_element(vec.begin(), vec.begin() + vec.size()/2, vec.end());
+			return vec[vec.size()/2];
+		}
+
+		//! Returns the rms of the viewed samples using an offset if given,
+		//! computed as in NumericArray::rms.
+		T rms(T offset = 0) const {
+			T fi, r = 0;
+			for ( size_t i = 0; i < _size; ++i ) {
+				fi = _data[i] - offset;
+				r += fi*fi;
+			}
+			return static_cast<T>(_size ? sqrt(r/_size) : 0);
+		}
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		const TypedArray<T> *_array{nullptr};
+		const T             *_data{nullptr};
+		size_t               _size{0};
+};
+
+
+typedef ArrayView<float> FloatArrayView;
+typedef ArrayView<double> DoubleArrayView;
+typedef ArrayView<std::int32_t> Int32ArrayView;
+
+
+}
+
+
+#endif
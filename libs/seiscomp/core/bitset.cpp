@@ -20,6 +20,8 @@
 
 #include <seiscomp/core/bitset.h>
 
+#include <algorithm>
+
 
 namespace Seiscomp {
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -34,5 +36,24 @@ IMPLEMENT_SC_CLASS(BitSet, "BitSet");
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BitSet &BitSet::orRange(size_t pos, const BitSet &other, size_t from, size_t count) {
+	if ( from >= other.size() ) return *this;
+
+	size_t to = std::min(other.size(), from + count);
+	if ( _impl.size() < pos + to - from )
+		_impl.resize(pos + to - from, false);
+
+	size_t i = from > 0 ? other._impl.find_next(from - 1) : other._impl.find_first();
+	for ( ; i < to; i = other._impl.find_next(i) )
+		_impl.set(pos + i - from);
+
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
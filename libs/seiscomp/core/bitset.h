@@ -202,6 +202,11 @@ class SC_SYSTEM_CORE_API BitSet : public Seiscomp::Core::BaseObject {
 		//! or npos if no such index exists.
 		size_t findNext(size_t pos) const;
 
+		//! Bitwise-ORs count bits of other starting at from into this
+		//! bitset starting at pos. This bitset is grown if required. Blocks
+		//! of other without set bits are skipped as a whole.
+		BitSet &orRange(size_t pos, const BitSet &other, size_t from, size_t count);
+
 		//! Returns the boost::dynamic_bitset implementation instance
 		const ImplType &impl() const;
 
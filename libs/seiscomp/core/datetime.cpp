@@ -203,6 +203,174 @@ const char *timeFormats[] = {
 };
 
 
+// Days since 1970-01-01 of a proleptic Gregorian date. Days beyond the
+// end of the month are carried over like timegm does.
+inline long daysFromCivil(long y, int m, int d) {
+	y -= m <= 2;
+	const long era = (y >= 0 ? y : y-399) / 400;
+	const long yoe = y - era * 400;
+	const long doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d-1;
+	const long doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+
+inline void civilFromDays(long z, long &y, int &m, int &d) {
+	z += 719468;
+	const long era = (z >= 0 ? z : z - 146096) / 146097;
+	const long doe = z - era * 146097;
+	const long yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+	const long doy = doe - (365*yoe + yoe/4 - yoe/100);
+	const long mp = (5*doy + 2)/153;
+	d = int(doy - (153*mp+2)/5 + 1);
+	m = int(mp < 10 ? mp+3 : mp-9);
+	y = yoe + era * 400 + (m <= 2);
+}
+
+
+// The layout of the ISO formats with a fast path:
+// %F<sep>%T[.%[width]f][Z] with sep being 'T' or ' '
+struct ISOFormat {
+	char sep;
+	bool fraction;
+	int  width; // -1 if not given
+	bool zulu;
+};
+
+
+bool parseISOFormat(const char *fmt, ISOFormat &f) {
+	if ( fmt[0] != '%' || fmt[1] != 'F' ) return false;
+	if ( fmt[2] != 'T' && fmt[2] != ' ' ) return false;
+	f.sep = fmt[2];
+	if ( fmt[3] != '%' || fmt[4] != 'T' ) return false;
+	fmt += 5;
+
+	f.fraction = false;
+	f.width = -1;
+	if ( fmt[0] == '.' && fmt[1] == '%' ) {
+		fmt += 2;
+		if ( *fmt >= '0' && *fmt <= '6' ) f.width = *fmt++ - '0';
+		if ( *fmt != 'f' ) return false;
+		++fmt;
+		f.fraction = true;
+	}
+
+	f.zulu = *fmt == 'Z';
+	if ( f.zulu ) ++fmt;
+
+	return *fmt == '\0';
+}
+
+
+inline char *writeDigits(char *out, long value, int digits) {
+	for ( int i = digits-1; i >= 0; --i ) {
+		out[i] = char('0' + value % 10);
+		value /= 10;
+	}
+	return out + digits;
+}
+
+
+// Formats a time as toString does with strftime, returns false if the
+// year is out of the four digit range
+bool formatISO(char *out, long secs, long usecs, const ISOFormat &f) {
+	long days = secs / 86400;
+	long rem = secs % 86400;
+	if ( rem < 0 ) {
+		rem += 86400;
+		--days;
+	}
+
+	long year;
+	int month, day;
+	civilFromDays(days, year, month, day);
+	if ( year < 1000 || year > 9999 ) return false;
+
+	out = writeDigits(out, year, 4);
+	*out++ = '-';
+	out = writeDigits(out, month, 2);
+	*out++ = '-';
+	out = writeDigits(out, day, 2);
+	*out++ = f.sep;
+	out = writeDigits(out, rem / 3600, 2);
+	*out++ = ':';
+	out = writeDigits(out, rem / 60 % 60, 2);
+	*out++ = ':';
+	out = writeDigits(out, rem % 60, 2);
+
+	if ( f.fraction ) {
+		*out++ = '.';
+		if ( usecs > 0 ) {
+			char number[6];
+			writeDigits(number, usecs, 6);
+			int numberOfDigits = f.width;
+			if ( numberOfDigits == -1 ) {
+				numberOfDigits = 6;
+				while ( number[numberOfDigits-1] == '0' ) --numberOfDigits;
+			}
+			memcpy(out, number, numberOfDigits);
+			out += numberOfDigits;
+		}
+		else {
+			int numberOfDigits = f.width == -1 ? 4 : f.width;
+			memset(out, '0', numberOfDigits);
+			out += numberOfDigits;
+		}
+	}
+
+	if ( f.zulu ) *out++ = 'Z';
+	*out = '\0';
+	return true;
+}
+
+
+inline bool readDigits(const char *&str, int digits, int &value) {
+	value = 0;
+	for ( int i = 0; i < digits; ++i, ++str ) {
+		if ( *str < '0' || *str > '9' ) return false;
+		value = value * 10 + (*str - '0');
+	}
+	return true;
+}
+
+
+// Parses the strict layout of an ISO format, i.e. four digit years and
+// two digit fields in range. Everything else is left to strptime.
+bool parseISO(const char *str, const ISOFormat &f, long &secs, long &usecs) {
+	int year, month, day, hour, min, sec;
+
+	if ( !readDigits(str, 4, year) || *str++ != '-' ) return false;
+	if ( !readDigits(str, 2, month) || *str++ != '-' ) return false;
+	if ( !readDigits(str, 2, day) || *str++ != f.sep ) return false;
+	if ( !readDigits(str, 2, hour) || *str++ != ':' ) return false;
+	if ( !readDigits(str, 2, min) || *str++ != ':' ) return false;
+	if ( !readDigits(str, 2, sec) ) return false;
+
+	if ( month < 1 || month > 12 || day < 1 || day > 31 ||
+	     hour > 23 || min > 59 || sec > 59 )
+		return false;
+
+	usecs = 0;
+	if ( f.fraction ) {
+		if ( *str++ != '.' ) return false;
+		if ( *str < '0' || *str > '9' ) return false;
+
+		// Only the first six digits are significant
+		int multiplier = 100000;
+		for ( ; *str >= '0' && *str <= '9'; ++str ) {
+			usecs += (*str - '0') * multiplier;
+			multiplier /= 10;
+		}
+	}
+
+	if ( f.zulu && *str++ != 'Z' ) return false;
+	if ( *str != '\0' ) return false;
+
+	secs = daysFromCivil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec;
+	return true;
+}
+
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -998,6 +1166,11 @@ std::string Time::toString(const char* fmt) const {
 		usecs += MICROS;
 	}
 
+	// The ISO formats are written without gmtime and strftime
+	ISOFormat iso;
+	if ( parseISOFormat(fmt, iso) && formatISO(data, secs, usecs, iso) )
+		return data;
+
 	tm t;
 	gmtime_r(&secs, &t);
 	const char *f = fmt, *last = fmt;
@@ -1094,6 +1267,18 @@ bool Time::fromString(const char* str, const char* fmt) {
 	char tmpFmt[BUFFER_SIZE];
 	long usec = 0;
 
+	// The ISO formats are parsed without strptime and timegm if the
+	// string is in the canonical layout
+	ISOFormat iso;
+	if ( parseISOFormat(fmt, iso) && iso.width == -1 ) {
+		long secs;
+		if ( parseISO(str, iso, secs, usec) ) {
+			*this = (time_t)secs;
+			setUSecs(usec);
+			return true;
+		}
+	}
+
 	const char* microSeconds = strstr(fmt, "%f");
 	if ( microSeconds != nullptr ) {
 		const char* start = str;
@@ -1204,6 +1389,18 @@ bool Time::fromString(const char* str, const char* fmt) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Time::fromString(const char* str) {
+	// A string in canonical layout matches only one of the ISO formats,
+	// so the fast paths can be tried before all formats are parsed
+	for ( size_t i = 0; i < sizeof(timeFormats) / sizeof(const char*); ++i ) {
+		ISOFormat iso;
+		long secs, usecs;
+		if ( parseISOFormat(timeFormats[i], iso) && parseISO(str, iso, secs, usecs) ) {
+			*this = (time_t)secs;
+			setUSecs(usecs);
+			return true;
+		}
+	}
+
 	for ( size_t i = 0; i < sizeof(timeFormats) / sizeof(const char*); ++i ) {
 		if ( fromString(str, timeFormats[i]) ) {
 			return true;
@@ -22,9 +22,12 @@
 #define SEISCOMP_CORE_FACTORY_H
 
 
+#include <functional>
 #include <map>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include "metaobject.h"
 #include "rtti.h"
@@ -60,8 +63,15 @@ class ClassFactoryInterface {
 	public:
 		//! The type that represents the root class of the hierarchie.
 		using RootType = ROOT_TYPE;
-		using ClassPool = std::map<std::string, ClassFactoryInterface<ROOT_TYPE>*>;
-		using ClassNames = std::map<const RTTI*, std::string>;
+		//! The pool is keyed by views of the class names which are owned by
+		//! the RTTI objects of the registered factories.
+		using ClassPool = std::unordered_map<std::string_view, ClassFactoryInterface<ROOT_TYPE>*>;
+		using ClassNames = std::unordered_map<const RTTI*, std::string>;
+		//! Maps the address of a registered class name to its factory.
+		//! Static types pass the name returned by T::ClassName() which is
+		//! the same string the factory has been registered with and can be
+		//! resolved without hashing the name.
+		using InternedNames = std::unordered_map<const char*, ClassFactoryInterface<ROOT_TYPE>*>;
 
 	
 	// ----------------------------------------------------------------------
@@ -120,6 +130,7 @@ class ClassFactoryInterface {
 	private:
 		static ClassPool &Classes();
 		static ClassNames &Names();
+		static InternedNames &Interned();
 
 		//! Adds a factory to the classpool
 		//! \return whether the factory has been added or not
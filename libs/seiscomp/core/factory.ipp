@@ -19,6 +19,8 @@
 
 #include <seiscomp/core/exceptions.h>
 
+#include <cstring>
+
 namespace Seiscomp {
 namespace Core {
 namespace Generic {
@@ -77,6 +79,11 @@ bool ClassFactoryInterface<ROOT_TYPE>::IsTypeOf(const char *baseName, const char
 		return false;
 	}
 
+	// Archives mostly check objects against their own static type
+	if ( baseName == derivedName || !strcmp(baseName, derivedName) ) {
+		return true;
+	}
+
 	ClassFactoryInterface<ROOT_TYPE> *baseFactory = FindByClassName(baseName);
 	if ( !baseFactory ) {
 		return false;
@@ -127,6 +134,11 @@ ClassFactoryInterface<ROOT_TYPE> *ClassFactoryInterface<ROOT_TYPE>::FindByClassN
 	if ( !className )
 		return nullptr;
 
+	// Static types look up the string their factory was registered with
+	typename InternedNames::iterator iit = Interned().find(className);
+	if ( iit != Interned().end() )
+		return (*iit).second;
+
 	typename ClassPool::iterator it = Classes().find(className);
 	if ( it == Classes().end() )
 		return nullptr;
@@ -200,6 +212,17 @@ typename ClassFactoryInterface<ROOT_TYPE>::ClassNames &ClassFactoryInterface<ROO
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename ROOT_TYPE>
+typename ClassFactoryInterface<ROOT_TYPE>::InternedNames &ClassFactoryInterface<ROOT_TYPE>::Interned() {
+	static typename ClassFactoryInterface<ROOT_TYPE>::InternedNames* interned = new typename ClassFactoryInterface<ROOT_TYPE>::InternedNames;
+	return *interned;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename ROOT_TYPE>
 bool ClassFactoryInterface<ROOT_TYPE>::RegisterFactory(ClassFactoryInterface<ROOT_TYPE> *factory, bool reregister) {
@@ -214,7 +237,16 @@ bool ClassFactoryInterface<ROOT_TYPE>::RegisterFactory(ClassFactoryInterface<ROO
 		}
 	}
 
-	Classes()[factory->className()] = factory;
+	// The key refers to the name owned by the factory, replace it along
+	// with a reregistered factory
+	typename ClassPool::iterator it = Classes().find(factory->className());
+	if ( it != Classes().end() ) {
+		Interned().erase((*it).second->className());
+		Classes().erase(it);
+	}
+
+	Classes().emplace(factory->className(), factory);
+	Interned()[factory->className()] = factory;
 	Names()[factory->typeInfo()] = factory->className();
 	
 	return true;
@@ -237,6 +269,7 @@ bool ClassFactoryInterface<ROOT_TYPE>::UnregisterFactory(ClassFactoryInterface<R
 		return false;
 	}
 
+	Interned().erase((*it).second->className());
 	Classes().erase(it);
 
 	typename ClassNames::iterator it_names = Names().find(factory->typeInfo());
@@ -21,7 +21,10 @@
 #ifndef SEISCOMP_CORE_INTERFACEFACTORY_H
 #define SEISCOMP_CORE_INTERFACEFACTORY_H
 
+#include <seiscomp/core.h>
+
 #include <map>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -34,6 +37,31 @@ namespace Generic {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * @brief Function called if a requested service is not registered. It is
+ *        used to load plugins on demand.
+ * @param serviceName The name of the missing service or nullptr if all
+ *                    services are requested, e.g. to list them.
+ * @return True if new services may have been registered
+ */
+typedef bool (*ServiceResolver)(const char *serviceName);
+
+//! Installs the global service resolver, nullptr removes it
+SC_SYSTEM_CORE_API void setServiceResolver(ServiceResolver resolver);
+
+//! Calls the installed service resolver, returns false if none is installed
+SC_SYSTEM_CORE_API bool resolveService(const char *serviceName);
+
+//! Returns the mutex which guards the service pools of all factories.
+//! It is recursive because resolving a service registers new factories.
+SC_SYSTEM_CORE_API std::recursive_mutex &serviceMutex();
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 /** \brief Template based service factory interface
 
@@ -41,6 +69,9 @@ namespace Generic {
 	\code
 	InterfaceFactory::Create(servicename);
 	\endcode
+
+	If a service is not registered the service resolver is asked to
+	provide it, e.g. by loading a plugin, before the lookup fails.
  */
 template <typename T>
 class InterfaceFactoryInterface {
@@ -77,6 +108,8 @@ class InterfaceFactoryInterface {
 		static bool RegisterFactory(InterfaceFactoryInterface *factory);
 		static bool UnregisterFactory(InterfaceFactoryInterface *factory);
 
+		static InterfaceFactoryInterface *Lookup(const char *serviceName);
+
 		static ServicePool &Pool();
 
 	private:
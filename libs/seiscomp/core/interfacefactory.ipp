@@ -76,6 +76,8 @@ T* InterfaceFactoryInterface<T>::Create(const std::string &serviceName) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 unsigned int InterfaceFactoryInterface<T>::ServiceCount() {
+	std::lock_guard<std::recursive_mutex> lock(serviceMutex());
+	resolveService(nullptr);
 	return Pool().size();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -87,6 +89,7 @@ unsigned int InterfaceFactoryInterface<T>::ServiceCount() {
 template <typename T>
 typename InterfaceFactoryInterface<T>::ServiceNames*
 InterfaceFactoryInterface<T>::Services() {
+	std::lock_guard<std::recursive_mutex> lock(serviceMutex());
 	if ( ServiceCount() == 0 ) return nullptr;
 
 	ServiceNames* names = new ServiceNames;
@@ -104,13 +107,12 @@ InterfaceFactoryInterface<T>::Services() {
 template <typename T>
 InterfaceFactoryInterface<T>*
 InterfaceFactoryInterface<T>::Find(const char *serviceName) {
-	for ( typename ServicePool::iterator it = Pool().begin(); it != Pool().end(); ++it ) {
-		if ( !strcmp((*it)->serviceName().c_str(), serviceName) ) {
-			return *it;
-		}
-	}
+	std::lock_guard<std::recursive_mutex> lock(serviceMutex());
+	InterfaceFactoryInterface *factory = Lookup(serviceName);
+	if ( factory == nullptr && resolveService(serviceName) )
+		factory = Lookup(serviceName);
 
-	return nullptr;
+	return factory;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -121,13 +123,7 @@ InterfaceFactoryInterface<T>::Find(const char *serviceName) {
 template <typename T>
 InterfaceFactoryInterface<T>*
 InterfaceFactoryInterface<T>::Find(const std::string &serviceName) {
-	for ( typename ServicePool::iterator it = Pool().begin(); it != Pool().end(); ++it ) {
-		if ( (*it)->serviceName() == serviceName ) {
-			return *it;
-		}
-	}
-
-	return nullptr;
+	return Find(serviceName.c_str());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -150,7 +146,8 @@ bool InterfaceFactoryInterface<T>::RegisterFactory(InterfaceFactoryInterface *fa
 	if ( factory == nullptr )
 		return false;
 
-	if ( Find(factory->serviceName()) != nullptr )
+	std::lock_guard<std::recursive_mutex> lock(serviceMutex());
+	if ( Lookup(factory->serviceName().c_str()) != nullptr )
 		return false;
 
 	Pool().push_back(factory);
@@ -164,6 +161,7 @@ bool InterfaceFactoryInterface<T>::RegisterFactory(InterfaceFactoryInterface *fa
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 bool InterfaceFactoryInterface<T>::UnregisterFactory(InterfaceFactoryInterface *factory) {
+	std::lock_guard<std::recursive_mutex> lock(serviceMutex());
 	for ( typename ServicePool::iterator it = Pool().begin(); it != Pool().end(); ++it ) {
 		if ( *it == factory ) {
 			Pool().erase(it);
@@ -178,6 +176,23 @@ bool InterfaceFactoryInterface<T>::UnregisterFactory(InterfaceFactoryInterface *
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+InterfaceFactoryInterface<T>*
+InterfaceFactoryInterface<T>::Lookup(const char *serviceName) {
+	for ( typename ServicePool::iterator it = Pool().begin(); it != Pool().end(); ++it ) {
+		if ( !strcmp((*it)->serviceName().c_str(), serviceName) ) {
+			return *it;
+		}
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 typename InterfaceFactoryInterface<T>::ServicePool &InterfaceFactoryInterface<T>::Pool() {
@@ -0,0 +1,175 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/metrics.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+
+namespace Seiscomp {
+namespace Core {
+namespace Metrics {
+
+
+namespace {
+
+
+// Durations are stored in nanoseconds to use integer atomics
+constexpr double NanosecondsPerSecond = 1E9;
+
+
+struct Registry {
+	std::mutex                                         mutex;
+	std::map<std::string, std::unique_ptr<Counter>>    counters;
+	std::map<std::string, std::unique_ptr<Gauge>>      gauges;
+	std::map<std::string, std::unique_ptr<Timer>>      timers;
+};
+
+
+Registry &registry() {
+	// Never destroyed so that metrics can be updated during static
+	// destruction
+	static Registry *instance = new Registry;
+	return *instance;
+}
+
+
+template <typename T>
+T &lookup(std::map<std::string, std::unique_ptr<T>> &map, const std::string &name) {
+	Registry &reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	auto &entry = map[name];
+	if ( !entry ) {
+		entry.reset(new T);
+	}
+	return *entry;
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Timer::record(double seconds) {
+	int64_t ns = static_cast<int64_t>(seconds * NanosecondsPerSecond);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_total.fetch_add(ns, std::memory_order_relaxed);
+
+	int64_t current = _maximum.load(std::memory_order_relaxed);
+	while ( ns > current &&
+	        !_maximum.compare_exchange_weak(current, ns, std::memory_order_relaxed) );
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double Timer::total() const {
+	return _total.load(std::memory_order_relaxed) / NanosecondsPerSecond;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double Timer::maximum() const {
+	return _maximum.load(std::memory_order_relaxed) / NanosecondsPerSecond;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double Timer::takeMaximum() {
+	return _maximum.exchange(0, std::memory_order_relaxed) / NanosecondsPerSecond;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Counter &counter(const std::string &name) {
+	return lookup(registry().counters, name);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Gauge &gauge(const std::string &name) {
+	return lookup(registry().gauges, name);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Timer &timer(const std::string &name) {
+	return lookup(registry().timers, name);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::vector<Sample> snapshot(bool resetMaximum) {
+	Registry &reg = registry();
+	std::vector<Sample> samples;
+
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	samples.reserve(reg.counters.size() + reg.gauges.size() + reg.timers.size());
+
+	for ( auto &item : reg.counters ) {
+		samples.push_back({item.first, Sample::CounterType, item.second->value(), 0, 0});
+	}
+
+	for ( auto &item : reg.gauges ) {
+		samples.push_back({item.first, Sample::GaugeType, item.second->value(), 0, 0});
+	}
+
+	for ( auto &item : reg.timers ) {
+		Timer &t = *item.second;
+		samples.push_back({
+			item.first, Sample::TimerType, t.count(), t.total(),
+			resetMaximum ? t.takeMaximum() : t.maximum()
+		});
+	}
+
+	return samples;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_CORE_METRICS_H
+#define SEISCOMP_CORE_METRICS_H
+
+
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Core {
+namespace Metrics {
+
+
+/**
+ * @brief A monotonic counter, e.g. the number of processed records.
+ *
+ * All metrics are lock-free and can be updated from any thread. Instances
+ * are created with Metrics::counter and live until the program exits, so
+ * callers can keep a reference, e.g. in a function local static.
+ */
+class SC_SYSTEM_CORE_API Counter {
+	public:
+		void add(int64_t n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+		Counter &operator++() { add(); return *this; }
+		int64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<int64_t> _value{0};
+};
+
+
+//! A gauge which holds the last set value, e.g. a queue depth.
+class SC_SYSTEM_CORE_API Gauge {
+	public:
+		void set(int64_t value) { _value.store(value, std::memory_order_relaxed); }
+		int64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<int64_t> _value{0};
+};
+
+
+//! A timer which accumulates the number and the duration of events.
+class SC_SYSTEM_CORE_API Timer {
+	public:
+		void record(double seconds);
+
+		//! The number of recorded events
+		int64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+		//! The accumulated duration in seconds
+		double total() const;
+
+		//! The maximum duration in seconds since the last reset
+		double maximum() const;
+
+		//! Returns the maximum duration and resets it
+		double takeMaximum();
+
+	private:
+		std::atomic<int64_t>  _count{0};
+		std::atomic<int64_t>  _total{0};
+		std::atomic<int64_t>  _maximum{0};
+};
+
+
+//! Records the lifetime of the object in a timer.
+class ScopedTimer {
+	public:
+		explicit ScopedTimer(Timer &timer)
+		: _timer(timer), _start(std::chrono::steady_clock::now()) {}
+
+		~ScopedTimer() {
+			_timer.record(
+				std::chrono::duration<double>(
+					std::chrono::steady_clock::now() - _start
+				).count()
+			);
+		}
+
+		ScopedTimer(const ScopedTimer &) = delete;
+		ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+	private:
+		Timer                                 &_timer;
+		std::chrono::steady_clock::time_point  _start;
+};
+
+
+/**
+ * @brief Returns the counter with the given name and creates it if it
+ *        does not exist yet. Names are usually dot separated, e.g.
+ *        "records.GE.UGM..BHZ".
+ */
+SC_SYSTEM_CORE_API Counter &counter(const std::string &name);
+
+//! Returns the gauge with the given name, see counter.
+SC_SYSTEM_CORE_API Gauge &gauge(const std::string &name);
+
+//! Returns the timer with the given name, see counter.
+SC_SYSTEM_CORE_API Timer &timer(const std::string &name);
+
+
+struct Sample {
+	enum Type {
+		CounterType,
+		GaugeType,
+		TimerType
+	};
+
+	std::string name;
+	Type        type;
+	//! The counter or gauge value or the number of timer events
+	int64_t     value;
+	//! The accumulated timer duration in seconds
+	double      total;
+	//! The maximum timer duration in seconds
+	double      maximum;
+};
+
+
+/**
+ * @brief Returns the current values of all metrics ordered by type and
+ *        name.
+ * @param resetMaximum Whether to reset the maximum of the timers. This
+ *                     should only be done by a single consumer which
+ *                     reports the metrics periodically.
+ */
+SC_SYSTEM_CORE_API std::vector<Sample> snapshot(bool resetMaximum = false);
+
+
+}
+}
+}
+
+
+#endif
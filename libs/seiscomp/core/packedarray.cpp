@@ -0,0 +1,209 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/core/packedarray.h>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace Seiscomp {
+
+
+namespace {
+
+
+inline uint32_t zigzag(uint32_t delta) {
+	return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+}
+
+
+inline uint32_t unzigzag(uint32_t value) {
+	return (value >> 1) ^ (0u - (value & 1));
+}
+
+
+inline uint8_t bitWidth(uint32_t value) {
+	uint8_t bits = 0;
+	while ( value ) {
+		++bits;
+		value >>= 1;
+	}
+	return bits;
+}
+
+
+}
+
+
+const int PackedIntArray::BlockSize;
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PackedIntArray::PackedIntArray(const int32_t *data, int count) {
+	assign(data, count);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PackedIntArray::assign(const int32_t *data, int count) {
+	clear();
+	if ( count <= 0 ) return;
+
+	_size = count;
+	_blocks.reserve((count + BlockSize - 1) / BlockSize);
+
+	uint32_t deltas[BlockSize];
+
+	for ( int start = 0; start < count; start += BlockSize ) {
+		int n = std::min(BlockSize, count - start);
+		const int32_t *samples = data + start;
+
+		// Differences wrap around, the decoder wraps back
+		uint32_t maxDelta = 0;
+		for ( int i = 1; i < n; ++i ) {
+			deltas[i] = zigzag(static_cast<uint32_t>(samples[i]) - static_cast<uint32_t>(samples[i-1]));
+			maxDelta |= deltas[i];
+		}
+
+		Block block;
+		block.offset = static_cast<uint32_t>(_words.size());
+		block.first = samples[0];
+		block.bits = bitWidth(maxDelta);
+		_blocks.push_back(block);
+
+		if ( !block.bits ) continue;
+
+		uint64_t acc = 0;
+		int filled = 0;
+
+		for ( int i = 1; i < n; ++i ) {
+			acc |= static_cast<uint64_t>(deltas[i]) << filled;
+			filled += block.bits;
+			if ( filled >= 32 ) {
+				_words.push_back(static_cast<uint32_t>(acc));
+				acc >>= 32;
+				filled -= 32;
+			}
+		}
+
+		if ( filled > 0 )
+			_words.push_back(static_cast<uint32_t>(acc));
+	}
+
+	_words.shrink_to_fit();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PackedIntArray::clear() {
+	_blocks.clear();
+	_words.clear();
+	_size = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t PackedIntArray::byteSize() const {
+	return _blocks.capacity() * sizeof(Block) + _words.capacity() * sizeof(uint32_t);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int PackedIntArray::decodeBlock(int index, int32_t *out) const {
+	const Block &block = _blocks[index];
+	int n = std::min(BlockSize, _size - index * BlockSize);
+	uint32_t value = static_cast<uint32_t>(block.first);
+
+	out[0] = block.first;
+
+	if ( !block.bits ) {
+		std::fill(out + 1, out + n, block.first);
+		return n;
+	}
+
+	const uint32_t *words = _words.data() + block.offset;
+	const uint64_t mask = (uint64_t(1) << block.bits) - 1;
+	uint64_t acc = 0;
+	int available = 0;
+
+	for ( int i = 1; i < n; ++i ) {
+		if ( available < block.bits ) {
+			acc |= static_cast<uint64_t>(*words++) << available;
+			available += 32;
+		}
+
+		value += unzigzag(static_cast<uint32_t>(acc & mask));
+		acc >>= block.bits;
+		available -= block.bits;
+		out[i] = static_cast<int32_t>(value);
+	}
+
+	return n;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PackedIntArray::decode(int from, int to, int32_t *out) const {
+	int32_t buffer[BlockSize];
+
+	while ( from < to ) {
+		int block = from / BlockSize;
+		int offset = from - block * BlockSize;
+
+		// Decode full blocks directly into the output
+		if ( !offset && to - from >= BlockSize ) {
+			int n = decodeBlock(block, out);
+			out += n;
+			from += n;
+			continue;
+		}
+
+		int n = decodeBlock(block, buffer);
+		int count = std::min(n - offset, to - from);
+		memcpy(out, buffer + offset, count * sizeof(int32_t));
+		out += count;
+		from += count;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
@@ -0,0 +1,138 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_CORE_PACKEDARRAY_H
+#define SEISCOMP_CORE_PACKEDARRAY_H
+
+
+#include <seiscomp/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+
+namespace Seiscomp {
+
+
+/**
+ * @brief The PackedIntArray class stores 32 bit integer samples compressed
+ *        in memory.
+ *
+ * The samples are split into blocks of BlockSize samples. Each block
+ * stores its first sample and the zigzag encoded differences of the
+ * following samples with as many bits as the largest difference of the
+ * block requires. Seismic data with a moderate dynamic range therefore
+ * needs only a fraction of the memory of an IntArray or DoubleArray.
+ *
+ * Blocks are independent of each other and can be decoded randomly,
+ * decoding a range of samples only touches the blocks which overlap
+ * with the range.
+ */
+class SC_SYSTEM_CORE_API PackedIntArray {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! The number of samples per block
+		static const int BlockSize = 128;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		PackedIntArray() = default;
+		PackedIntArray(const int32_t *data, int count);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Replaces the content with the given samples
+		void assign(const int32_t *data, int count);
+
+		//! Drops all samples
+		void clear();
+
+		//! Returns the number of samples
+		int size() const { return _size; }
+
+		//! Returns the number of blocks
+		int blockCount() const { return static_cast<int>(_blocks.size()); }
+
+		//! Returns the number of bytes used to store the samples
+		size_t byteSize() const;
+
+		//! Decodes the samples of a block. The output buffer must have
+		//! room for BlockSize samples.
+		//! @return The number of samples of the block
+		int decodeBlock(int block, int32_t *out) const;
+
+		//! Decodes the samples in [from, to) to the output buffer which
+		//! must have room for to-from samples.
+		void decode(int from, int to, int32_t *out) const;
+
+		//! Decodes the samples in [from, to) and converts them to T
+		template <typename T>
+		void decode(int from, int to, T *out) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Block {
+			uint32_t offset;
+			int32_t  first;
+			uint8_t  bits;
+		};
+
+		std::vector<Block>    _blocks;
+		std::vector<uint32_t> _words;
+		int                   _size{0};
+};
+
+
+template <typename T>
+void PackedIntArray::decode(int from, int to, T *out) const {
+	int32_t buffer[BlockSize];
+
+	while ( from < to ) {
+		int block = from / BlockSize;
+		int n = decodeBlock(block, buffer);
+		int offset = from - block * BlockSize;
+		int count = std::min(n - offset, to - from);
+
+		for ( int i = 0; i < count; ++i )
+			out[i] = static_cast<T>(buffer[offset + i]);
+
+		out += count;
+		from += count;
+	}
+}
+
+
+}
+
+
+#endif
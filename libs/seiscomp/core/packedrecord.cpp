@@ -0,0 +1,353 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/core/packedrecord.h>
+#include <seiscomp/core/typedarray.h>
+
+#include <cmath>
+#include <vector>
+
+
+using namespace Seiscomp;
+
+
+IMPLEMENT_SC_CLASS_DERIVED(PackedRecord, Record, "PackedRecord");
+REGISTER_RECORD(PackedRecord, "packed");
+
+
+namespace {
+
+
+template <typename T>
+bool toIntegers(std::vector<int32_t> &out, const T *data, int count) {
+	out.resize(count);
+
+	for ( int i = 0; i < count; ++i ) {
+		T v = data[i];
+		// Fails for NaN as well
+		if ( !(v >= -2147483648.0 && v <= 2147483647.0) || std::floor(v) != v )
+			return false;
+		out[i] = static_cast<int32_t>(v);
+	}
+
+	return true;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PackedRecord::PackedRecord(Array::DataType dt)
+: Record(dt, SAVE_RAW) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PackedRecord::PackedRecord(const PackedRecord &rec)
+: Record(rec)
+, _packed(rec._packed)
+, _samples(rec._samples ? rec._samples->clone() : nullptr)
+, _clipRuns(rec._clipRuns) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PackedRecord::~PackedRecord() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PackedRecord *PackedRecord::Create(const Record *rec, bool allowFloat32) {
+	if ( rec == nullptr ) return nullptr;
+
+	const Array *data = rec->data();
+	if ( data == nullptr || data->size() == 0 ) return nullptr;
+
+	PackedRecord *packed = new PackedRecord(rec->dataType());
+	static_cast<Record&>(*packed) = *rec;
+	packed->_hint = SAVE_RAW;
+
+	// Not packable or not worth it
+	if ( !packed->pack(data, allowFloat32)
+	  || packed->byteSize() >= static_cast<size_t>(data->size() * data->elementSize()) ) {
+		delete packed;
+		return nullptr;
+	}
+
+	if ( rec->clipMask() )
+		packed->_clipRuns.assign(*rec->clipMask());
+
+	return packed;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PackedRecord::pack(const Array *data, bool allowFloat32) {
+	std::vector<int32_t> samples;
+
+	_packed.clear();
+	_samples = nullptr;
+	_data = nullptr;
+	_nsamp = data->size();
+
+	switch ( data->dataType() ) {
+		case Array::INT:
+			_packed.assign(static_cast<const IntArray*>(data)->typedData(), data->size());
+			return true;
+
+		case Array::FLOAT:
+			if ( toIntegers(samples, static_cast<const FloatArray*>(data)->typedData(), data->size()) ) {
+				_packed.assign(samples.data(), data->size());
+				return true;
+			}
+			return false;
+
+		case Array::DOUBLE:
+			if ( toIntegers(samples, static_cast<const DoubleArray*>(data)->typedData(), data->size()) ) {
+				_packed.assign(samples.data(), data->size());
+				return true;
+			}
+
+			if ( allowFloat32 ) {
+				_samples = data->copy(Array::FLOAT);
+				return true;
+			}
+			return false;
+
+		default:
+			return false;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PackedRecord::isPacked() const {
+	return _packed.size() > 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t PackedRecord::byteSize() const {
+	if ( _samples )
+		return static_cast<size_t>(_samples->size() * _samples->elementSize());
+	return _packed.byteSize();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+bool PackedRecord::decodeRange(int from, int to, T *out) const {
+	if ( from < 0 || to > _nsamp || from > to ) return false;
+
+	if ( _samples ) {
+		if ( _samples->dataType() == Array::FLOAT ) {
+			const float *samples = static_cast<const FloatArray*>(_samples.get())->typedData();
+			for ( int i = from; i < to; ++i )
+				*out++ = static_cast<T>(samples[i]);
+			return true;
+		}
+		else if ( _samples->dataType() == Array::DOUBLE ) {
+			const double *samples = static_cast<const DoubleArray*>(_samples.get())->typedData();
+			for ( int i = from; i < to; ++i )
+				*out++ = static_cast<T>(samples[i]);
+			return true;
+		}
+
+		return false;
+	}
+
+	_packed.decode(from, to, out);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PackedRecord::decode(int from, int to, int *out) const {
+	return decodeRange(from, to, out);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PackedRecord::decode(int from, int to, float *out) const {
+	return decodeRange(from, to, out);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PackedRecord::decode(int from, int to, double *out) const {
+	return decodeRange(from, to, out);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Array *PackedRecord::unpack() const {
+	if ( _samples ) return _samples->clone();
+	if ( _packed.size() == 0 ) return nullptr;
+
+	IntArray *data = new IntArray(_packed.size());
+	_packed.decode(0, _packed.size(), data->typedData());
+	return data;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Array *PackedRecord::data() const {
+	if ( !_data ) {
+		ArrayPtr data = unpack();
+		if ( data && data->dataType() != _datatype ) {
+			ArrayPtr converted = data->copy(_datatype);
+			if ( converted ) data = converted;
+		}
+		_data = data;
+	}
+
+	return _data.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Array *PackedRecord::raw() const {
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const BitSet *PackedRecord::clipMask() const {
+	if ( !_clipMask && _clipRuns.any() )
+		_clipMask = _clipRuns.toBitSet();
+
+	return _clipMask.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const RunLengthBitSet &PackedRecord::clipRuns() const {
+	return _clipRuns;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *PackedRecord::copy() const {
+	return new PackedRecord(*this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PackedRecord::saveSpace() const {
+	_data = nullptr;
+	_clipMask = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PackedRecord::read(std::istream &) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PackedRecord::write(std::ostream &) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PackedRecord::serialize(Archive &ar) {
+	Record::serialize(ar);
+
+	if ( ar.isReading() ) {
+		ArrayPtr data;
+		ar & NAMED_OBJECT_HINT("data", data, Archive::XML_ELEMENT);
+
+		_packed.clear();
+		_samples = nullptr;
+		_data = nullptr;
+		_nsamp = 0;
+
+		// Keep samples which cannot be packed as they are
+		if ( data && !pack(data.get(), false) ) {
+			_samples = data;
+			_nsamp = data->size();
+		}
+	}
+	else {
+		ArrayPtr data = unpack();
+		ar & NAMED_OBJECT_HINT("data", data, Archive::XML_ELEMENT);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,148 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_CORE_PACKEDRECORD_H
+#define SEISCOMP_CORE_PACKEDRECORD_H
+
+
+#include <seiscomp/core/record.h>
+#include <seiscomp/core/bitset.h>
+#include <seiscomp/core/packedarray.h>
+#include <seiscomp/core/runlengthbitset.h>
+
+
+namespace Seiscomp {
+
+
+DEFINE_SMARTPOINTER(PackedRecord);
+
+/**
+ * @brief The PackedRecord class keeps the samples of a record compressed
+ *        in memory.
+ *
+ * Integer samples, which includes floating point samples without a
+ * fractional part as produced by most digitizers, are stored in a
+ * PackedIntArray. Other floating point samples are stored with single
+ * precision if allowed. The samples are decoded with the first call to
+ * data() and released again with saveSpace(). Use decode() to read a range
+ * of samples without decoding the whole record. The clip mask is stored
+ * as runs of clipped samples and dropped if no sample is clipped.
+ */
+class SC_SYSTEM_CORE_API PackedRecord : public Record {
+	DECLARE_SC_CLASS(PackedRecord);
+	DECLARE_SERIALIZATION;
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! Default Constructor
+		PackedRecord(Array::DataType dt = Array::DOUBLE);
+
+		//! Copy Constructor
+		PackedRecord(const PackedRecord &rec);
+
+		//! Destructor
+		~PackedRecord() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Creates a packed copy of a record.
+		 * @param rec The record to be copied.
+		 * @param allowFloat32 Whether floating point samples which cannot
+		 *                     be stored as integers may lose precision
+		 *                     and are stored as float.
+		 * @return The packed record or nullptr if the record has no
+		 *         samples or they cannot be stored with less memory.
+		 */
+		static PackedRecord *Create(const Record *rec, bool allowFloat32 = false);
+
+		//! Returns whether the samples are stored as packed integers
+		bool isPacked() const;
+
+		//! Returns the number of bytes used to store the samples,
+		//! without decoded samples.
+		size_t byteSize() const;
+
+		//! Decodes the samples in [from, to) to the output buffer which
+		//! must have room for to-from samples. Only the blocks which
+		//! overlap with the range are decoded.
+		//! @return false if the range is invalid
+		bool decode(int from, int to, int *out) const;
+		bool decode(int from, int to, float *out) const;
+		bool decode(int from, int to, double *out) const;
+
+		//! Returns the decoded samples of the data type of the record.
+		//! They are kept until saveSpace() is called.
+		const Array *data() const override;
+
+		//! Returns nullptr, the original data is not kept
+		const Array *raw() const override;
+
+		//! Returns the clip mask expanded from the stored runs or nullptr
+		//! if no sample is clipped. It is kept until saveSpace() is called.
+		const BitSet *clipMask() const override;
+
+		//! Returns the runs of clipped samples
+		const RunLengthBitSet &clipRuns() const;
+
+		Record *copy() const override;
+
+		//! Releases the decoded samples and the expanded clip mask
+		void saveSpace() const override;
+
+		void read(std::istream &in) override;
+		void write(std::ostream &out) override;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		bool pack(const Array *data, bool allowFloat32);
+
+		template <typename T>
+		bool decodeRange(int from, int to, T *out) const;
+
+		//! Returns a newly decoded array of the stored type
+		Array *unpack() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		PackedIntArray    _packed;
+		ArrayPtr          _samples;
+		RunLengthBitSet   _clipRuns;
+		mutable ArrayPtr  _data;
+		mutable BitSetPtr _clipMask;
+};
+
+
+}
+
+
+#endif
@@ -22,6 +22,7 @@
 #include <math.h>
 #include <string.h>
 #include <seiscomp/core/record.h>
+#include <seiscomp/core/recordpool.h>
 #include <seiscomp/core/exceptions.h>
 #include <seiscomp/core/interfacefactory.ipp>
 
@@ -41,7 +42,8 @@ Record::Record(Array::DataType datatype, Hint h)
 : _net(""), _sta(""), _loc(""), _cha("")
 , _stime(Core::Time(0,0)), _datatype(datatype)
 , _hint(h), _nsamp(0), _fsamp(0), _timequal(-1)
-, _authenticationStatus(NOT_SIGNED) {}
+, _authenticationStatus(NOT_SIGNED)
+, _streamKey(0) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -54,7 +56,8 @@ Record::Record(Array::DataType datatype, Hint h,
 : _net(net), _sta(sta), _loc(loc), _cha(cha)
 , _stime(stime), _datatype(datatype)
 , _hint(h), _nsamp(nsamp), _fsamp(fsamp), _timequal(tqual)
-, _authenticationStatus(NOT_SIGNED) {}
+, _authenticationStatus(NOT_SIGNED)
+, _streamKey(0) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -68,7 +71,8 @@ Record::Record(const Record &rec)
 , _hint(rec._hint), _nsamp(rec.sampleCount())
 , _fsamp(rec.samplingFrequency()), _timequal(rec.timingQuality())
 , _authenticationStatus(rec._authenticationStatus)
-, _authority(rec._authority) {}
+, _authority(rec._authority)
+, _streamKey(rec._streamKey.load(std::memory_order_relaxed)) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -81,6 +85,24 @@ Record::~Record () {}
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void *Record::operator new(size_t size) {
+	return RecordPool::allocate(size);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Record::operator delete(void *ptr, size_t size) {
+	RecordPool::release(ptr, size);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Record& Record::operator=(const Record &rec) {
 	if ( &rec != this ) {
@@ -96,6 +118,8 @@ Record& Record::operator=(const Record &rec) {
 		_timequal = rec.timingQuality();
 		_authenticationStatus = rec._authenticationStatus;
 		_authority = rec._authority;
+		_streamKey.store(rec._streamKey.load(std::memory_order_relaxed),
+		                 std::memory_order_relaxed);
 	}
 
 	return *this;
@@ -117,6 +141,7 @@ const std::string &Record::networkCode() const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Record::setNetworkCode(std::string net) {
 	_net = net;
+	_streamKey.store(0, std::memory_order_relaxed);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -135,6 +160,7 @@ const std::string &Record::stationCode() const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Record::setStationCode(std::string sta) {
 	_sta = sta;
+	_streamKey.store(0, std::memory_order_relaxed);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -153,6 +179,7 @@ const std::string &Record::locationCode() const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Record::setLocationCode(std::string loc) {
 	_loc = loc;
+	_streamKey.store(0, std::memory_order_relaxed);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -171,6 +198,7 @@ const std::string &Record::channelCode() const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Record::setChannelCode(std::string cha) {
 	_cha = cha;
+	_streamKey.store(0, std::memory_order_relaxed);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -265,6 +293,22 @@ std::string Record::streamID() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+StreamKey Record::streamKey() const {
+	uint64_t id = _streamKey.load(std::memory_order_relaxed);
+	if ( !id ) {
+		// Concurrent callers intern the same codes and store the same id
+		id = StreamKey::Intern(_net, _sta, _loc, _cha).id();
+		_streamKey.store(id, std::memory_order_relaxed);
+	}
+
+	return StreamKey(id);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Array::DataType Record::dataType() const {
 	return _datatype;
@@ -22,6 +22,7 @@
 #define SEISCOMP_CORE_RECORD_H
 
 
+#include <atomic>
 #include <string>
 #include <time.h>
 #include <iostream>
@@ -31,6 +32,7 @@
 #include <seiscomp/core/timewindow.h>
 #include <seiscomp/core/array.h>
 #include <seiscomp/core/exceptions.h>
+#include <seiscomp/core/streamkey.h>
 
 
 
@@ -52,8 +54,14 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 	public:
 		//! Specifies the memory storage flags.
 		enum Hint {
+			//! Only the header attributes are populated, samples are not
+			//! available
 			META_ONLY,
+			//! The samples are decoded immediately and the raw record is
+			//! not kept
 			DATA_ONLY,
+			//! The raw record is kept and the samples are decoded on the
+			//! first call to data()
 			SAVE_RAW,
 			H_QUANTITY
 		};
@@ -92,6 +100,11 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 	public:
 		//! Assignment operator
 		Record &operator=(const Record &rec);
+
+		//! Records are allocated through the RecordPool which recycles
+		//! the memory of released records if enabled
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
 	
 
 	// ----------------------------------------------------------------------
@@ -149,6 +162,12 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 		//! Returns the so called stream ID: <net>.<sta>.<loc>.<cha>
 		std::string streamID() const;
 
+		//! Returns the interned key of the stream codes. The key is
+		//! registered with the first call and cached until one of the
+		//! codes changes. Use it instead of streamID() as key of
+		//! containers.
+		StreamKey streamKey() const;
+
 		//! Returns the data type specified for the data sample requests
 		Array::DataType dataType() const;
 
@@ -228,6 +247,10 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 		int             _timequal;
 		Authentication  _authenticationStatus;
 		std::string     _authority;
+
+		//! The cached stream key id, 0 if not yet interned. Derived
+		//! classes which assign the codes directly must reset it.
+		mutable std::atomic<uint64_t> _streamKey;
 };
 
 
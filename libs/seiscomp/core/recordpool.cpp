@@ -0,0 +1,180 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/core/recordpool.h>
+#include <seiscomp/core/arrayfactory.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace Seiscomp {
+
+
+namespace {
+
+
+struct Bucket {
+	size_t              size;
+	std::vector<void*>  blocks;
+};
+
+
+std::atomic<size_t>   poolCapacity(0);
+std::mutex            poolMutex;
+std::vector<Bucket>   poolBuckets;
+std::vector<ArrayPtr> poolArrays[Array::DT_QUANTITY];
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordPool::setCapacity(size_t capacity) {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	poolCapacity = capacity;
+
+	for ( auto &bucket : poolBuckets ) {
+		while ( bucket.blocks.size() > capacity ) {
+			::operator delete(bucket.blocks.back());
+			bucket.blocks.pop_back();
+		}
+	}
+
+	for ( auto &arrays : poolArrays ) {
+		if ( arrays.size() > capacity )
+			arrays.resize(capacity);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t RecordPool::capacity() {
+	return poolCapacity;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void *RecordPool::allocate(size_t size) {
+	if ( poolCapacity ) {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		for ( auto &bucket : poolBuckets ) {
+			if ( bucket.size != size ) continue;
+			if ( bucket.blocks.empty() ) break;
+
+			void *ptr = bucket.blocks.back();
+			bucket.blocks.pop_back();
+			return ptr;
+		}
+	}
+
+	return ::operator new(size);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordPool::release(void *ptr, size_t size) {
+	if ( !ptr ) return;
+
+	if ( poolCapacity ) {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		Bucket *target = nullptr;
+
+		for ( auto &bucket : poolBuckets ) {
+			if ( bucket.size == size ) {
+				target = &bucket;
+				break;
+			}
+		}
+
+		if ( !target ) {
+			poolBuckets.push_back(Bucket{size, {}});
+			target = &poolBuckets.back();
+		}
+
+		if ( target->blocks.size() < poolCapacity ) {
+			target->blocks.push_back(ptr);
+			return;
+		}
+	}
+
+	::operator delete(ptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ArrayPtr RecordPool::createArray(Array::DataType type) {
+	if ( poolCapacity && (type >= 0) && (type < Array::DT_QUANTITY) ) {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		auto &arrays = poolArrays[type];
+		if ( !arrays.empty() ) {
+			ArrayPtr array = arrays.back();
+			arrays.pop_back();
+			return array;
+		}
+	}
+
+	return ArrayFactory::Create(type, type, 0, nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordPool::recycle(ArrayPtr &array) {
+	if ( poolCapacity && array && (array->referenceCount() == 1) ) {
+		Array::DataType type = array->dataType();
+		if ( (type >= 0) && (type < Array::DT_QUANTITY) ) {
+			array->clear();
+
+			std::lock_guard<std::mutex> lock(poolMutex);
+			auto &arrays = poolArrays[type];
+			if ( arrays.size() < poolCapacity ) {
+				arrays.push_back(array);
+				array = nullptr;
+				return;
+			}
+		}
+	}
+
+	array = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
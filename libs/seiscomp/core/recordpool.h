@@ -0,0 +1,85 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_CORE_RECORDPOOL_H
+#define SEISCOMP_CORE_RECORDPOOL_H
+
+
+#include <seiscomp/core/array.h>
+
+#include <cstddef>
+
+
+namespace Seiscomp {
+
+
+/**
+ * @brief Recycles the memory of records and their sample arrays.
+ *
+ * Realtime applications create and release a record object plus its
+ * sample array for each received record. If the pool is enabled the
+ * memory of released records is kept and handed out again to the
+ * next record of the same size. Decoders can ask for sample arrays
+ * which were released together with their records, the arrays keep
+ * their capacity and usually do not need to reallocate their buffers.
+ *
+ * The pool is disabled by default. All functions are thread-safe as
+ * records are usually created in the acquisition thread and released
+ * in the main thread.
+ */
+class SC_SYSTEM_CORE_API RecordPool {
+	public:
+		/**
+		 * @brief Sets the maximum number of cached records per object size
+		 *        and of cached arrays per data type.
+		 * @param capacity The capacity. 0 disables the pool and releases
+		 *                 all cached memory.
+		 */
+		static void setCapacity(size_t capacity);
+
+		//! Returns the configured capacity, 0 if disabled
+		static size_t capacity();
+
+		//! Allocates memory for a record, used by Record::operator new
+		static void *allocate(size_t size);
+
+		//! Releases the memory of a record, used by Record::operator delete
+		static void release(void *ptr, size_t size);
+
+		/**
+		 * @brief Returns an empty array of the given data type. If
+		 *        available a recycled array is returned.
+		 */
+		static ArrayPtr createArray(Array::DataType type);
+
+		/**
+		 * @brief Hands an array over to the pool if the pool is enabled and
+		 *        the array is not referenced elsewhere. The passed pointer
+		 *        is reset in any case.
+		 */
+		static void recycle(ArrayPtr &array);
+};
+
+
+}
+
+
+#endif
@@ -20,6 +20,7 @@
 
 #define SEISCOMP_COMPONENT Core
 
+#include <algorithm>
 #include <iostream>
 #include <math.h>
 
@@ -27,8 +28,10 @@
 #include <seiscomp/core/arrayfactory.h>
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/packedrecord.h>
 #include <seiscomp/core/timewindow.h>
 #include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/waveformmemory.h>
 #include <seiscomp/logging/log.h>
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -59,15 +62,163 @@ int round(double val) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence::RecordSequence(double tolerance)
-: _tolerance(tolerance)
-{}
+: _tolerance(tolerance) {
+	WaveformMemory::Instance().add(this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence::RecordSequence(const RecordSequence &other)
+: std::deque<RecordCPtr>(other)
+, _tolerance(other._tolerance)
+, _packRecords(other._packRecords) {
+	WaveformMemory::Instance().add(this);
+	updateMemoryUsage();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence::~RecordSequence() {
+	WaveformMemory::Instance().remove(this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence &RecordSequence::operator=(const RecordSequence &other) {
+	if ( this != &other ) {
+		std::deque<RecordCPtr>::operator=(other);
+		_tolerance = other._tolerance;
+		_packRecords = other._packRecords;
+		updateMemoryUsage();
+	}
+
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::updateMemoryUsage() {
+	size_t bytes = 0;
+	for ( const RecordCPtr &rec : *this )
+		bytes += WaveformMemory::MemoryUsage(rec.get());
+
+	changeMemoryUsage(static_cast<int64_t>(bytes) - static_cast<int64_t>(_memoryUsage));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::setEvictable(bool enable) {
+	_evictable = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RecordSequence::restore() {
+	return WaveformMemory::Instance().restore(this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::push_back(const RecordCPtr &rec) {
+	std::deque<RecordCPtr>::push_back(rec);
+	recordInserted(rec.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::push_front(const RecordCPtr &rec) {
+	std::deque<RecordCPtr>::push_front(rec);
+	recordInserted(rec.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::pop_back() {
+	changeMemoryUsage(-static_cast<int64_t>(WaveformMemory::MemoryUsage(back().get())));
+	std::deque<RecordCPtr>::pop_back();
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-RecordSequence::~RecordSequence() {}
+void RecordSequence::pop_front() {
+	changeMemoryUsage(-static_cast<int64_t>(WaveformMemory::MemoryUsage(front().get())));
+	std::deque<RecordCPtr>::pop_front();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::clear() {
+	std::deque<RecordCPtr>::clear();
+	changeMemoryUsage(-static_cast<int64_t>(_memoryUsage));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::recordInserted(const Record *rec) {
+	changeMemoryUsage(static_cast<int64_t>(WaveformMemory::MemoryUsage(rec)));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::changeMemoryUsage(int64_t delta) {
+	if ( !delta ) return;
+
+	// Never account more than was added, e.g. if the records have been
+	// modified without accounting
+	if ( delta < 0 && static_cast<size_t>(-delta) > _memoryUsage )
+		delta = -static_cast<int64_t>(_memoryUsage);
+
+	_memoryUsage += delta;
+	WaveformMemory::Instance().changed(this, delta);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::releaseRecords() {
+	std::deque<RecordCPtr>::clear();
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -162,11 +313,12 @@ RecordSequence::Range RecordSequence::amplitudeRange(const Core::TimeWindow *tw)
 
 	for ( const_iterator it = begin(); it != end(); ++it) {
 		const Record *rec = it->get();
-		const Array *data = rec->data();
+		const PackedRecord *packed = PackedRecord::ConstCast(rec);
+		const Array *data = packed ? nullptr : rec->data();
+		int size = packed ? packed->sampleCount() : (data ? data->size() : 0);
 
 		// Skip empty records
-		if ( data == nullptr ) continue;
-		if ( data->size() == 0 ) continue;
+		if ( size == 0 ) continue;
 
 		int imin = 0, imax = 0;
 
@@ -182,7 +334,7 @@ RecordSequence::Range RecordSequence::amplitudeRange(const Core::TimeWindow *tw)
 						imin = int(dt*fs);
 
 					dt = rec->endTime() - tw->endTime();
-					imax = data->size();
+					imax = size;
 					if ( dt > 0 )
 						imax -= int(dt*fs);
 				}
@@ -194,10 +346,20 @@ RecordSequence::Range RecordSequence::amplitudeRange(const Core::TimeWindow *tw)
 			}
 		}
 		else // no time window specified -> search over whole record
-			imax = data->size();
+			imax = size;
 
 		if ( imax <= imin ) continue;
 
+		// Decode only the requested samples of packed records
+		DoubleArray decoded;
+		if ( packed ) {
+			decoded.resize(imax - imin);
+			if ( !packed->decode(imin, imax, decoded.typedData()) ) continue;
+			data = &decoded;
+			imax -= imin;
+			imin = 0;
+		}
+
 		// The first record contributing to the range?
 		if ( !foundRecords ) {
 			if ( getRange(range, *data, imin, imax) )
@@ -338,19 +500,33 @@ GenericRecord *RecordSequence::contiguousRecord(const Core::TimeWindow *tw, bool
 
 	TArrayPtr rawData = new TArray;
 	GenericRecord *rawRecord = nullptr;
+	BitSetPtr clipMask;
 
-	for ( it = begin(); it != end(); ++it ) {
+	// Records which end before the time window cannot overlap
+	for ( it = tw ? lowerBound(tw->startTime()) : begin(); it != end(); ++it ) {
 		RecordCPtr rec = *it;
-		if ( rec->data() == nullptr ) continue;
+		const PackedRecord *packed = PackedRecord::ConstCast(rec.get());
+		if ( !packed && rec->data() == nullptr ) continue;
 		if ( tw != nullptr && !tw->overlaps(rec->timeWindow())) continue;
 
-		const TArray *ar = TArray::ConstCast(rec->data());
+		const TArray *ar;
 		TArrayPtr tmpData;
+		int offset = 0;
 
-		if ( ar == nullptr ) {
-			tmpData = (TArray*)rec->data()->copy(TArray::ArrayType);
+		if ( packed ) {
+			// Decode without keeping the samples in the record
+			tmpData = new TArray(packed->sampleCount());
+			if ( !packed->decode(0, tmpData->size(), tmpData->typedData()) ) continue;
 			ar = tmpData.get();
 		}
+		else {
+			ar = TArray::ConstCast(rec->data());
+
+			if ( ar == nullptr ) {
+				tmpData = (TArray*)rec->data()->copy(TArray::ArrayType);
+				ar = tmpData.get();
+			}
+		}
 
 		if ( !rawRecord ) {
 			// Remember frequency of first record
@@ -378,6 +554,7 @@ GenericRecord *RecordSequence::contiguousRecord(const Core::TimeWindow *tw, bool
 
 				tmpData = ar->slice(numSamples, ar->size());
 				ar = tmpData.get();
+				offset = numSamples;
 			}
 			// Gap
 			else if ( diffTime > 0.5/samplingFrequency ) {
@@ -400,15 +577,34 @@ GenericRecord *RecordSequence::contiguousRecord(const Core::TimeWindow *tw, bool
 			}
 		}
 
+		// Merge the clip masks, records without clipped samples are
+		// skipped without looking at their bits
+		if ( packed ) {
+			if ( packed->clipRuns().any() ) {
+				if ( !clipMask ) clipMask = new BitSet;
+				packed->clipRuns().orInto(*clipMask, rawData->size(), offset, ar->size());
+			}
+		}
+		else if ( rec->clipMask() && rec->clipMask()->any() ) {
+			if ( !clipMask ) clipMask = new BitSet;
+			clipMask->orRange(rawData->size(), *rec->clipMask(), offset, ar->size());
+		}
+
 		rawData->append(ar);
 
 		lastSample = (T)ar->impl().back();
 		lastRec = rec;
 	}
 
-	if ( rawRecord != nullptr && rawData )
+	if ( rawRecord != nullptr && rawData ) {
 		rawRecord->setData(rawData.get());
 
+		if ( clipMask ) {
+			clipMask->resize(rawData->size());
+			rawRecord->setClipMask(clipMask.get());
+		}
+	}
+
 	return rawRecord;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -416,6 +612,54 @@ GenericRecord *RecordSequence::contiguousRecord(const Core::TimeWindow *tw, bool
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+ArrayView<T> RecordSequence::contiguousView(const Core::TimeWindow *tw,
+                                            Core::Time *startTime) const {
+	typedef TypedArray<T> TArray;
+
+	if ( empty() ) return ArrayView<T>();
+
+	if ( tw == nullptr ) {
+		if ( size() > 1 ) return ArrayView<T>();
+
+		const Record *rec = front().get();
+		const TArray *ar = TArray::ConstCast(rec->data());
+		if ( ar == nullptr ) return ArrayView<T>();
+
+		if ( startTime ) *startTime = rec->startTime();
+		return ArrayView<T>(ar);
+	}
+
+	for ( const_iterator it = lowerBound(tw->startTime()); it != end(); ++it ) {
+		const Record *rec = it->get();
+		const TArray *ar = TArray::ConstCast(rec->data());
+		if ( ar == nullptr ) continue;
+
+		double fs = rec->samplingFrequency();
+		if ( fs <= 0 ) continue;
+
+		double halfSample = 0.5 / fs;
+		if ( (double)(tw->startTime() - rec->startTime()) < -halfSample ) continue;
+		if ( (double)(rec->endTime() - tw->endTime()) < -halfSample ) continue;
+
+		int i0 = (int)((double)(tw->startTime() - rec->startTime()) * fs + 0.5);
+		int i1 = (int)((double)(tw->endTime() - rec->startTime()) * fs + 0.5);
+
+		ArrayView<T> view(ar, i0, i1);
+		if ( startTime )
+			*startTime = rec->startTime() + Core::TimeSpan(view.offset() / fs);
+
+		return view;
+	}
+
+	return ArrayView<T>();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 GenericRecord *RecordSequence::continuousRecord(const Core::TimeWindow *tw, bool interpolate) const {
@@ -468,6 +712,24 @@ bool RecordSequence::findInsertPosition(const Record *rec, iterator *it) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordCPtr RecordSequence::storedRecord(const Record *rec) const {
+	// Take ownership of a fed record without references which is
+	// released if it is replaced by a packed copy
+	RecordCPtr stored(rec);
+
+	if ( _packRecords && !PackedRecord::ConstCast(rec) ) {
+		PackedRecord *packed = PackedRecord::Create(rec);
+		if ( packed ) stored = packed;
+	}
+
+	return stored;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool RecordSequence::timingQuality(int &count, float &quality) const {
 	double q = 0;
@@ -492,6 +754,17 @@ bool RecordSequence::timingQuality(int &count, float &quality) const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence::const_iterator RecordSequence::lowerBound(const Core::Time &time) const {
+	return std::partition_point(begin(), end(), [&time](const RecordCPtr &rec) {
+		return rec->endTime() < time;
+	});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 TimeWindowBuffer::TimeWindowBuffer(const Core::TimeWindow &tw, double tolerance)
 : RecordSequence(tolerance)
@@ -522,7 +795,9 @@ bool TimeWindowBuffer::feed(const Record *rec) {
 		return false;
 	}
 
-	insert(it, rec);
+	RecordCPtr stored = storedRecord(rec);
+	insert(it, stored);
+	recordInserted(stored.get());
 
 	return true;
 }
@@ -546,7 +821,9 @@ RecordSequence *TimeWindowBuffer::copy() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence *TimeWindowBuffer::clone() const {
-	return new TimeWindowBuffer(_timeWindow, _tolerance);
+	auto cp = new TimeWindowBuffer(_timeWindow, _tolerance);
+	cp->setPackRecords(_packRecords);
+	return cp;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -589,7 +866,9 @@ bool RingBuffer::feed(const Record *rec) {
 	if ( !findInsertPosition(rec, &it) )
 		return false;
 
-	insert(it, rec);
+	RecordCPtr stored = storedRecord(rec);
+	insert(it, stored);
+	recordInserted(stored.get());
 
 	if( ! recordCount())
 		return true;
@@ -629,13 +908,223 @@ RecordSequence *RingBuffer::copy() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence *RingBuffer::clone() const {
+	RingBuffer *cp;
+
 	if (_nmax)
-		return new RingBuffer(_nmax, _tolerance);
+		cp = new RingBuffer(_nmax, _tolerance);
 	else
-		return new RingBuffer(_span, _tolerance);
+		cp = new RingBuffer(_span, _tolerance);
+
+	cp->setPackRecords(_packRecords);
+	return cp;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+template <typename T>
+Array *createChunkData(const Array *data, int capacity) {
+	NumericArray<T> *chunk = new NumericArray<T>;
+	chunk->impl().reserve(std::max(capacity, data->size()));
+	chunk->append(data);
+	return chunk;
+}
+
+
+Array *createChunkData(const Array *data, int capacity) {
+	switch ( data->dataType() ) {
+		case Array::INT:
+			return createChunkData<int32_t>(data, capacity);
+		case Array::FLOAT:
+			return createChunkData<float>(data, capacity);
+		case Array::DOUBLE:
+			return createChunkData<double>(data, capacity);
+		default:
+			break;
+	}
 
 	return nullptr;
 }
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ChunkedRingBuffer::ChunkedRingBuffer(Core::TimeSpan span, int chunkSize,
+                                     double tolerance)
+: RecordSequence(tolerance)
+, _span(span)
+, _chunkSize(std::max(chunkSize, 1)) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkedRingBuffer::feed(const Record *rec) {
+	if ( !append(rec) ) {
+		iterator it;
+		if ( !findInsertPosition(rec, &it) )
+			return false;
+
+		startChunk(rec, it);
+	}
+
+	if ( _span ) {
+		Core::Time tmin = back()->endTime() - _span;
+		while ( front()->endTime() <= tmin )
+			pop_front();
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkedRingBuffer::append(const Record *rec) {
+	// The last chunk must still be the last record and nobody else must
+	// hold a reference to it: the deque and _chunk for the record and the
+	// record and _chunkData for the array
+	if ( !_chunk || empty() || back().get() != _chunk.get() )
+		return false;
+
+	if ( _chunk->referenceCount() > 2 || _chunkData->referenceCount() > 2 )
+		return false;
+
+	const Array *data = rec->data();
+	if ( !data || rec->clipMask() )
+		return false;
+
+	if ( data->dataType() != _chunkData->dataType() )
+		return false;
+
+	if ( rec->samplingFrequency() != _chunk->samplingFrequency() )
+		return false;
+
+	if ( rec->timingQuality() != _chunk->timingQuality() )
+		return false;
+
+	if ( rec->authentication() != _chunk->authentication() )
+		return false;
+
+	if ( rec->streamKey() != _chunk->streamKey() )
+		return false;
+
+	// Appending must not reallocate the samples
+	if ( _chunkData->size() + data->size() > _chunkSize )
+		return false;
+
+	double diff = (double)(rec->startTime() - _chunk->endTime());
+	if ( fabs(diff) * rec->samplingFrequency() > _tolerance )
+		return false;
+
+	_chunkData->append(data);
+	_chunk->dataUpdated();
+	changeMemoryUsage(static_cast<int64_t>(data->size()) * _chunkData->elementSize());
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ChunkedRingBuffer::startChunk(const Record *rec, iterator it) {
+	_chunk = nullptr;
+	_chunkData = nullptr;
+
+	const Array *data = rec->data();
+	ArrayPtr chunkData;
+
+	if ( data && !rec->clipMask() )
+		chunkData = createChunkData(data, _chunkSize);
+
+	if ( !chunkData ) {
+		insert(it, rec);
+		recordInserted(rec);
+		return;
+	}
+
+	GenericRecordPtr chunk = new GenericRecord(rec->networkCode(),
+	                                           rec->stationCode(),
+	                                           rec->locationCode(),
+	                                           rec->channelCode(),
+	                                           rec->startTime(),
+	                                           rec->samplingFrequency(),
+	                                           rec->timingQuality(),
+	                                           rec->dataType());
+	chunk->setAuthentication(rec->authentication());
+	chunk->setAuthority(rec->authority());
+	chunk->setData(chunkData.get());
+
+	// Only the chunk at the end is extended
+	bool last = it == end();
+	insert(it, chunk);
+	recordInserted(chunk.get());
+
+	if ( last ) {
+		_chunk = chunk;
+		_chunkData = chunkData;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ChunkedRingBuffer::reset() {
+	clear();
+	_chunk = nullptr;
+	_chunkData = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ChunkedRingBuffer::releaseRecords() {
+	RecordSequence::releaseRecords();
+	_chunk = nullptr;
+	_chunkData = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence *ChunkedRingBuffer::copy() const {
+	ChunkedRingBuffer *cp = static_cast<ChunkedRingBuffer*>(clone());
+
+	for ( const_iterator it = begin(); it != end(); ++it )
+		cp->push_back((*it)->copy());
+
+	return cp;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence *ChunkedRingBuffer::clone() const {
+	return new ChunkedRingBuffer(_span, _chunkSize, _tolerance);
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -652,6 +1141,16 @@ GenericRecord *RecordSequence::contiguousRecord<float>(const Core::TimeWindow *t
 template
 GenericRecord *RecordSequence::contiguousRecord<double>(const Core::TimeWindow *tw, bool interpolate) const;
 
+// Specialize contiguousView for int, float and double
+template
+ArrayView<int> RecordSequence::contiguousView<int>(const Core::TimeWindow *tw, Core::Time *startTime) const;
+
+template
+ArrayView<float> RecordSequence::contiguousView<float>(const Core::TimeWindow *tw, Core::Time *startTime) const;
+
+template
+ArrayView<double> RecordSequence::contiguousView<double>(const Core::TimeWindow *tw, Core::Time *startTime) const;
+
 // Specialize continuousRecord for int, float and double
 template
 GenericRecord *RecordSequence::continuousRecord<int>(const Core::TimeWindow *tw, bool interpolate) const;
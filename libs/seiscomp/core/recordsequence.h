@@ -22,9 +22,11 @@
 #define SEISCOMP_RECORDSEQUENCE_H
 
 
+#include <seiscomp/core/arrayview.h>
 #include <seiscomp/core/genericrecord.h>
 #include <seiscomp/core/timewindow.h>
 
+#include <cstdint>
 #include <deque>
 
 
@@ -54,9 +56,15 @@ class SC_SYSTEM_CORE_API RecordSequence : public std::deque<RecordCPtr> {
 		//! C'tor
 		RecordSequence(double tolerance=0.5);
 
+		//! Copies the records and settings, the copy is accounted
+		//! separately and is not evictable
+		RecordSequence(const RecordSequence &other);
+
 		//! D'tor
 		virtual ~RecordSequence();
 
+		RecordSequence &operator=(const RecordSequence &other);
+
 
 	// ----------------------------------------------------------------------
 	//  Public interface
@@ -81,6 +89,16 @@ class SC_SYSTEM_CORE_API RecordSequence : public std::deque<RecordCPtr> {
 		//! Set the time tolerance in samples
 		void setTolerance(double);
 
+		//! Enables storing fed records as PackedRecord which keeps integer
+		//! samples compressed in memory. Records which cannot be packed
+		//! without loss are stored as they are. Packed records are copies,
+		//! the buffer does not keep a reference to the fed record. This is
+		//! supported by TimeWindowBuffer and RingBuffer.
+		void setPackRecords(bool enable);
+
+		//! Returns whether fed records are packed
+		bool packRecords() const;
+
 		//! Return Record's as one contiguous record. Compiled in is support for
 		//! float, double and int. If interpolation is enabled gaps will be linearly
 		//! interpolated between the last and the next sample.
@@ -88,6 +106,20 @@ class SC_SYSTEM_CORE_API RecordSequence : public std::deque<RecordCPtr> {
 		GenericRecord *contiguousRecord(const Seiscomp::Core::TimeWindow *tw = nullptr,
 		                                bool interpolate = false) const;
 
+		//! Returns a view of the samples of the requested time window without
+		//! copying them. This is only possible if a single record with data
+		//! of type T covers the whole time window. If tw is nullptr the
+		//! sequence must consist of exactly one record. Unlike
+		//! contiguousRecord the view is trimmed to the time window. If
+		//! startTime is given it is set to the time of the first sample of
+		//! the view. In all other cases an empty view is returned and
+		//! contiguousRecord must be used. The view does not keep the record
+		//! alive, it is valid as long as the record is part of the sequence
+		//! or referenced elsewhere.
+		template <typename T>
+		ArrayView<T> contiguousView(const Seiscomp::Core::TimeWindow *tw = nullptr,
+		                            Core::Time *startTime = nullptr) const;
+
 		//! DECPRECATED: For backward compatibility, does exactly the same as
 		//!              contiguousRecord. Please use contiguousRecord in your
 		//!              code. This method will be removed in future releases.
@@ -121,12 +153,56 @@ class SC_SYSTEM_CORE_API RecordSequence : public std::deque<RecordCPtr> {
 		//! Returns the number of stored records, same as size().
 		size_t recordCount() const;
 
+		//! Returns the first record which ends at or after the given time
+		//! or end() if there is no such record. The lookup is a binary
+		//! search which relies on the records being sorted by their end
+		//! time as done by all implementations in this file.
+		const_iterator lowerBound(const Core::Time &time) const;
+
 		//! Determine average timing quality from the records stored in this
 		//! sequence.
 		//! Returns true on success; in that case, count and quality are set
 		bool timingQuality(int &count, float &quality) const;
 
 
+	// ----------------------------------------------------------------------
+	//  Memory accounting
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the approximate number of bytes held by the stored
+		//! records as accounted by WaveformMemory
+		size_t memoryUsage() const;
+
+		//! Recomputes the memory usage from the stored records. This is
+		//! only required after the records have been modified with
+		//! methods of the deque which are not covered below, e.g. insert
+		//! or erase.
+		void updateMemoryUsage();
+
+		//! Allows WaveformMemory to evict the records of this sequence
+		//! if the memory budget is exceeded. The owner must call
+		//! restore before it accesses the records.
+		void setEvictable(bool enable);
+		bool isEvictable() const;
+
+		//! Returns whether the records have been evicted and not yet
+		//! restored. Records fed after the eviction are kept.
+		bool isEvicted() const;
+
+		//! Marks the sequence as recently used and restores evicted
+		//! records. Returns false if records were dropped during the
+		//! eviction because no spill directory was set or they could not
+		//! be written.
+		bool restore();
+
+		//! Accounting versions of the deque methods
+		void push_back(const RecordCPtr &rec);
+		void push_front(const RecordCPtr &rec);
+		void pop_back();
+		void pop_front();
+		void clear();
+
+
 	// ----------------------------------------------------------------------
 	//  Protected interface
 	// ----------------------------------------------------------------------
@@ -134,12 +210,40 @@ class SC_SYSTEM_CORE_API RecordSequence : public std::deque<RecordCPtr> {
 		bool alreadyHasRecord(const Record*) const;
 		bool findInsertPosition(const Record*, iterator*);
 
+		//! Returns the record to be stored for a fed record, a packed
+		//! copy if packing is enabled and possible
+		RecordCPtr storedRecord(const Record*) const;
+
+		//! Accounts a record which has been inserted without the
+		//! accounting methods
+		void recordInserted(const Record*);
+
+		//! Releases all records when the sequence is evicted, without
+		//! accounting them
+		virtual void releaseRecords();
+
 
 	// ----------------------------------------------------------------------
 	//  Members
 	// ----------------------------------------------------------------------
 	protected:
 		double _tolerance;
+		bool   _packRecords{false};
+
+		//! Accounts a change of the memory held by the stored records,
+		//! e.g. after samples have been appended to a stored record
+		void changeMemoryUsage(int64_t delta);
+
+	private:
+		// Maintained by WaveformMemory
+		size_t   _memoryUsage{0};
+		uint64_t _memoryId{0};
+		uint64_t _lastUse{0};
+		bool     _evictable{false};
+		bool     _evicted{false};
+		bool     _incomplete{false};
+
+	friend class WaveformMemory;
 };
 
 
@@ -242,6 +346,79 @@ class SC_SYSTEM_CORE_API RingBuffer : public RecordSequence {
 };
 
 
+/**
+ * ChunkedRingBuffer
+ *
+ * A ring buffer for a fixed time span which stores the samples of
+ * continuous records in contiguous chunks instead of keeping each record.
+ * A fed record which continues the last chunk within the tolerance, has
+ * the same sampling frequency and an int, float or double data array is
+ * appended to the chunk. Otherwise a new chunk is started. A chunk holds
+ * at most chunkSize samples unless a single record is larger. Thus the
+ * sequence contains a few large records, lookups with lowerBound are
+ * cheap and contiguousView can return most windows without copying.
+ *
+ * A chunk is only extended as long as the buffer holds the only reference
+ * to it and to its data array. Records and views obtained from the buffer
+ * therefore never change, the next fed record starts a new chunk instead.
+ * Records with a clip mask or another data type are stored as they are.
+ */
+class SC_SYSTEM_CORE_API ChunkedRingBuffer : public RecordSequence {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! Creates a buffer which stores at least the given time span of
+		//! data ending at the end time of the last record.
+		ChunkedRingBuffer(Core::TimeSpan span, int chunkSize = 4096,
+		                  double tolerance = 0.5);
+
+
+	// ----------------------------------------------------------------------
+	//  Public RecordSequence interface overrides
+	// ----------------------------------------------------------------------
+	public:
+		virtual bool feed(const Record*);
+		virtual RecordSequence *copy() const;
+		virtual RecordSequence *clone() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! clear the buffer
+		void reset();
+
+		//! Return the TimeSpan the buffer stores
+		const Core::TimeSpan &timeSpanToStore() const;
+
+		//! Returns the maximum number of samples per chunk
+		int chunkSize() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	protected:
+		void releaseRecords() override;
+
+	private:
+		bool append(const Record *rec);
+		void startChunk(const Record *rec, iterator it);
+
+
+	// ----------------------------------------------------------------------
+	//  Members
+	// ----------------------------------------------------------------------
+	private:
+		Core::TimeSpan   _span;
+		int              _chunkSize;
+		GenericRecordPtr _chunk;
+		ArrayPtr         _chunkData;
+};
+
+
 
 // ----------------------------------------------------------------------
 //  Inline implementations
@@ -255,10 +432,30 @@ inline void RecordSequence::setTolerance(double dt) {
 	_tolerance = dt;
 }
 
+inline void RecordSequence::setPackRecords(bool enable) {
+	_packRecords = enable;
+}
+
+inline bool RecordSequence::packRecords() const {
+	return _packRecords;
+}
+
 inline size_t RecordSequence::recordCount() const {
 	return size();
 }
 
+inline size_t RecordSequence::memoryUsage() const {
+	return _memoryUsage;
+}
+
+inline bool RecordSequence::isEvictable() const {
+	return _evictable;
+}
+
+inline bool RecordSequence::isEvicted() const {
+	return _evicted;
+}
+
 inline const Core::TimeWindow &TimeWindowBuffer::timeWindowToStore() const {
 	return _timeWindow;
 }
@@ -270,6 +467,14 @@ inline unsigned int RingBuffer::numberOfRecordsToStore() const {
 inline const Core::TimeSpan &RingBuffer::timeSpanToStore() const {
 	return _span;
 }
+
+inline const Core::TimeSpan &ChunkedRingBuffer::timeSpanToStore() const {
+	return _span;
+}
+
+inline int ChunkedRingBuffer::chunkSize() const {
+	return _chunkSize;
+}
 	
 }
 
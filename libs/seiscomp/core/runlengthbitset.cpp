@@ -0,0 +1,142 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/core/runlengthbitset.h>
+
+#include <algorithm>
+
+
+namespace Seiscomp {
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RunLengthBitSet::RunLengthBitSet(const BitSet &bits) {
+	assign(bits);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RunLengthBitSet::assign(const BitSet &bits) {
+	_runs.clear();
+	_size = bits.size();
+
+	// findNext skips blocks without set bits
+	for ( size_t i = bits.findFirst(); i < _size; i = bits.findNext(i) ) {
+		if ( !_runs.empty() && _runs.back().start + _runs.back().length == i )
+			++_runs.back().length;
+		else
+			_runs.push_back({static_cast<uint32_t>(i), 1});
+	}
+
+	Runs(_runs).swap(_runs);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RunLengthBitSet::clear() {
+	Runs().swap(_runs);
+	_size = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RunLengthBitSet::test(size_t n) const {
+	// Find the last run which starts at or before n
+	auto it = std::upper_bound(_runs.begin(), _runs.end(), n,
+	                           [](size_t pos, const Run &run) {
+		return pos < run.start;
+	});
+
+	if ( it == _runs.begin() ) return false;
+	--it;
+	return n < static_cast<size_t>(it->start) + it->length;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t RunLengthBitSet::numberOfBitsSet() const {
+	size_t count = 0;
+	for ( const Run &run : _runs )
+		count += run.length;
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t RunLengthBitSet::byteSize() const {
+	return _runs.capacity() * sizeof(Run);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BitSet *RunLengthBitSet::toBitSet() const {
+	BitSet *bits = new BitSet(static_cast<int>(_size));
+	orInto(*bits, 0, 0, _size);
+	return bits;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RunLengthBitSet::orInto(BitSet &target, size_t pos, size_t from, size_t count) const {
+	if ( from >= _size ) return;
+	size_t to = std::min(_size, from + count);
+
+	if ( target.size() < pos + to - from )
+		target.resize(pos + to - from, false);
+
+	for ( const Run &run : _runs ) {
+		size_t start = std::max(static_cast<size_t>(run.start), from);
+		size_t end = std::min(static_cast<size_t>(run.start) + run.length, to);
+		if ( start >= to ) break;
+
+		for ( size_t i = start; i < end; ++i )
+			target.set(pos + i - from);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
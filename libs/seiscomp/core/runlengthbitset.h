@@ -0,0 +1,116 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_CORE_RUNLENGTHBITSET_H
+#define SEISCOMP_CORE_RUNLENGTHBITSET_H
+
+
+#include <seiscomp/core/bitset.h>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace Seiscomp {
+
+
+/**
+ * @brief The RunLengthBitSet class stores a set of bits as a sorted list
+ *        of runs of set bits.
+ *
+ * It is meant for long and sparse bit sets such as clip masks where
+ * usually no or only a few short ranges of bits are set. A bit set
+ * without set bits does not allocate any memory. It is not modified
+ * bitwise but built from a BitSet and expanded to a BitSet again.
+ */
+class SC_SYSTEM_CORE_API RunLengthBitSet {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct Run {
+			uint32_t start;
+			uint32_t length;
+		};
+
+		typedef std::vector<Run> Runs;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		RunLengthBitSet() = default;
+		explicit RunLengthBitSet(const BitSet &bits);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Replaces the content with the bits of a BitSet
+		void assign(const BitSet &bits);
+
+		//! The size of the bit set becomes zero
+		void clear();
+
+		//! Returns the number of bits
+		size_t size() const { return _size; }
+
+		//! Returns the runs of set bits in ascending order
+		const Runs &runs() const { return _runs; }
+
+		//! Returns true if any bit is set
+		bool any() const { return !_runs.empty(); }
+
+		//! Returns true if no bit is set
+		bool none() const { return _runs.empty(); }
+
+		//! Returns true if bit n is set
+		bool test(size_t n) const;
+
+		//! Returns the number of set bits
+		size_t numberOfBitsSet() const;
+
+		//! Returns the number of bytes used to store the runs
+		size_t byteSize() const;
+
+		//! Returns a newly allocated BitSet with the same bits
+		BitSet *toBitSet() const;
+
+		//! Bitwise-ORs count bits starting at from into target starting
+		//! at pos. The target is grown if required.
+		void orInto(BitSet &target, size_t pos, size_t from, size_t count) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		Runs   _runs;
+		size_t _size{0};
+};
+
+
+}
+
+
+#endif
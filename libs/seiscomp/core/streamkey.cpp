@@ -0,0 +1,191 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/core/streamkey.h>
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace Seiscomp {
+
+
+namespace {
+
+
+struct Codes {
+	std::string net;
+	std::string sta;
+	std::string loc;
+	std::string cha;
+};
+
+
+struct Table {
+	// Entries are never removed and a deque does not relocate its
+	// elements when growing, references to the codes remain valid.
+	std::deque<Codes>                         entries;
+	std::unordered_map<std::string, uint64_t> ids;
+	std::mutex                                mutex;
+};
+
+
+Table &table() {
+	static Table *instance = new Table;
+	return *instance;
+}
+
+
+// The codes are joined with a character that may not be part of a code
+// to prevent collisions of e.g. "AB" + "C" and "A" + "BC".
+std::string join(const std::string &net, const std::string &sta,
+                 const std::string &loc, const std::string &cha) {
+	std::string key;
+	key.reserve(net.size() + sta.size() + loc.size() + cha.size() + 3);
+	key += net;
+	key += '\0';
+	key += sta;
+	key += '\0';
+	key += loc;
+	key += '\0';
+	key += cha;
+	return key;
+}
+
+
+const Codes &codes(uint64_t id) {
+	static const Codes empty;
+	if ( !id ) {
+		return empty;
+	}
+
+	Table &t = table();
+	std::lock_guard<std::mutex> lk(t.mutex);
+	return t.entries[id-1];
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+StreamKey StreamKey::Intern(const std::string &net, const std::string &sta,
+                            const std::string &loc, const std::string &cha) {
+	std::string key = join(net, sta, loc, cha);
+	Table &t = table();
+	std::lock_guard<std::mutex> lk(t.mutex);
+
+	auto it = t.ids.find(key);
+	if ( it != t.ids.end() ) {
+		return StreamKey(it->second);
+	}
+
+	t.entries.push_back({net, sta, loc, cha});
+	uint64_t id = t.entries.size();
+	t.ids.emplace(std::move(key), id);
+	return StreamKey(id);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+StreamKey StreamKey::Find(const std::string &net, const std::string &sta,
+                          const std::string &loc, const std::string &cha) {
+	std::string key = join(net, sta, loc, cha);
+	Table &t = table();
+	std::lock_guard<std::mutex> lk(t.mutex);
+
+	auto it = t.ids.find(key);
+	if ( it != t.ids.end() ) {
+		return StreamKey(it->second);
+	}
+
+	return StreamKey();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t StreamKey::Count() {
+	Table &t = table();
+	std::lock_guard<std::mutex> lk(t.mutex);
+	return t.entries.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &StreamKey::networkCode() const {
+	return codes(_id).net;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &StreamKey::stationCode() const {
+	return codes(_id).sta;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &StreamKey::locationCode() const {
+	return codes(_id).loc;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &StreamKey::channelCode() const {
+	return codes(_id).cha;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string StreamKey::toString() const {
+	const Codes &c = codes(_id);
+	return c.net + "." + c.sta + "." + c.loc + "." + c.cha;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
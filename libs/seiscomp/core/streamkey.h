@@ -0,0 +1,122 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_CORE_STREAMKEY_H
+#define SEISCOMP_CORE_STREAMKEY_H
+
+
+#include <seiscomp/core.h>
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+
+namespace Seiscomp {
+
+
+/**
+ * @brief An interned stream identifier.
+ *
+ * A stream key represents a combination of network, station, location
+ * and channel code as a 64 bit integer. The codes are registered once in
+ * a global table and each distinct combination receives a unique id which
+ * stays valid for the lifetime of the process. Comparing and hashing keys
+ * are integer operations and thus much cheaper than comparing four
+ * strings or a concatenated stream id.
+ *
+ * The order of keys is the registration order and not the lexicographical
+ * order of the codes. All functions are thread-safe.
+ */
+class SC_SYSTEM_CORE_API StreamKey {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! Creates an invalid key
+		StreamKey() = default;
+		explicit StreamKey(uint64_t id) : _id(id) {}
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the key of the given codes and registers them if
+		//! they are not yet known.
+		static StreamKey Intern(const std::string &net, const std::string &sta,
+		                        const std::string &loc, const std::string &cha);
+
+		//! Returns the key of the given codes without registering them.
+		//! If the codes are not known an invalid key is returned.
+		static StreamKey Find(const std::string &net, const std::string &sta,
+		                      const std::string &loc, const std::string &cha);
+
+		//! Returns the number of registered streams
+		static size_t Count();
+
+		uint64_t id() const { return _id; }
+		bool isValid() const { return _id != 0; }
+
+		//! The codes of an invalid key are empty strings
+		const std::string &networkCode() const;
+		const std::string &stationCode() const;
+		const std::string &locationCode() const;
+		const std::string &channelCode() const;
+
+		//! Returns <net>.<sta>.<loc>.<cha>
+		std::string toString() const;
+
+		bool operator==(const StreamKey &other) const { return _id == other._id; }
+		bool operator!=(const StreamKey &other) const { return _id != other._id; }
+		bool operator<(const StreamKey &other) const { return _id < other._id; }
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		uint64_t _id{0};
+};
+
+
+inline std::ostream &operator<<(std::ostream &os, const StreamKey &key) {
+	return os << key.toString();
+}
+
+
+}
+
+
+namespace std {
+
+template <>
+struct hash<Seiscomp::StreamKey> {
+	size_t operator()(const Seiscomp::StreamKey &key) const {
+		return std::hash<uint64_t>()(key.id());
+	}
+};
+
+}
+
+
+#endif
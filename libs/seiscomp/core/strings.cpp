@@ -35,7 +35,9 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <cerrno>
+#include <charconv>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -356,6 +358,73 @@ bool fromString(double &value, const std::string &str) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+template <typename T>
+inline bool floatFromChars(T &value, std::string_view str) {
+	if ( str.empty() ) return false;
+
+#if defined(__cpp_lib_to_chars)
+	T tmp;
+	const char *end = str.data() + str.size();
+	auto res = std::from_chars(str.data(), end, tmp);
+	if ( res.ec != std::errc() || res.ptr != end )
+		return false;
+
+	value = tmp;
+	return true;
+#else
+	// strtod needs a terminated string and skips whitespaces
+	if ( isspace(str[0]) || str[0] == '+' ) return false;
+
+	char buffer[64];
+	std::string copy;
+	const char *data;
+	if ( str.size() < sizeof(buffer) ) {
+		memcpy(buffer, str.data(), str.size());
+		buffer[str.size()] = '\0';
+		data = buffer;
+	}
+	else {
+		copy.assign(str);
+		data = copy.c_str();
+	}
+
+	char *endptr = nullptr;
+	errno = 0;
+	double retval = strtod(data, &endptr);
+	if ( errno != 0 || endptr != data + str.size() )
+		return false;
+
+	if ( std::isnormal(retval) ) {
+		double aretval = std::fabs(retval);
+		if ( aretval < static_cast<double>(std::numeric_limits<T>::min())
+		  || aretval > static_cast<double>(std::numeric_limits<T>::max()) )
+			return false;
+	}
+
+	value = static_cast<T>(retval);
+	return true;
+#endif
+}
+
+}
+
+
+bool fromChars(float &value, std::string_view str) {
+	return floatFromChars(value, str);
+}
+
+
+bool fromChars(double &value, std::string_view str) {
+	return floatFromChars(value, str);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <>
 bool fromString(bool &value, const std::string &str) {
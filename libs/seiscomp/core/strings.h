@@ -32,6 +32,8 @@
 
 #include <limits>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <complex>
 
@@ -117,6 +119,24 @@ bool fromString(Enum<ENUMTYPE, END, NAMES> &value, const std::string &str);
 template <typename T>
 bool fromString(std::vector<T> &vec, const std::string &str);
 
+/**
+ * @brief Converts a character sequence into a number without copying it
+ *        into a string first. In contrast to fromString neither leading
+ *        whitespaces nor a leading '+' are accepted and all characters
+ *        must be consumed. The value is only changed on success.
+ * @param value The target value
+ * @param str The source characters
+ * @param base The base of integer conversions, e.g. 16 for hexadecimal
+ *             numbers without prefix
+ * @return Success flag
+ */
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type
+fromChars(T &value, std::string_view str, int base = 10);
+
+SC_SYSTEM_CORE_API bool fromChars(float &value, std::string_view str);
+SC_SYSTEM_CORE_API bool fromChars(double &value, std::string_view str);
+
 
 /**
  * @brief Produces output according to a format as used by printf. The output
@@ -150,6 +170,72 @@ SC_SYSTEM_CORE_API
 int split(std::vector<std::string> &tokens, const std::string &source,
           const char *delimiter, bool compressOn = true);
 
+/**
+ * @brief The Tokens class iterates over the tokens of a string separated by
+ *        one of the specified delimiter characters without copying them.
+ *
+ * The tokens are the same as returned by split but as views into the
+ * source which must outlive the iteration.
+ * @code
+ * for ( std::string_view tok : Core::Tokens(line, " \t") ) {
+ *     double v;
+ *     if ( !Core::fromChars(v, tok) ) return false;
+ * }
+ * @endcode
+ */
+class Tokens {
+	public:
+		class iterator {
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = std::string_view;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const std::string_view*;
+				using reference = const std::string_view&;
+
+			public:
+				iterator() = default;
+				iterator(std::string_view source, std::string_view delimiter,
+				         bool compressOn);
+
+				reference operator*() const { return _token; }
+				pointer operator->() const { return &_token; }
+
+				iterator &operator++();
+				iterator operator++(int);
+
+				bool operator==(const iterator &other) const;
+				bool operator!=(const iterator &other) const { return !(*this == other); }
+
+			private:
+				std::string_view _rest;
+				std::string_view _delimiter;
+				std::string_view _token;
+				bool             _compressOn{true};
+				bool             _last{false};
+				bool             _done{true};
+		};
+
+	public:
+		/**
+		 * @param source The source string
+		 * @param delimiter Sequence of characters to split the string at
+		 * @param compressOn If enabled, adjacent separators are merged
+		 *        together. Otherwise, every two separators delimit a token.
+		 */
+		Tokens(std::string_view source, std::string_view delimiter,
+		       bool compressOn = true)
+		: _source(source), _delimiter(delimiter), _compressOn(compressOn) {}
+
+		iterator begin() const { return iterator(_source, _delimiter, _compressOn); }
+		iterator end() const { return iterator(); }
+
+	private:
+		std::string_view _source;
+		std::string_view _delimiter;
+		bool             _compressOn;
+};
+
 /**
  * @brief Splits a string into several tokens separated by one of the specified
  *        delimiter characters. A delimiter character is ignored if it occurs in
@@ -21,6 +21,7 @@
 #include <seiscomp/core/enumeration.h>
 
 #include <cctype>
+#include <charconv>
 #include <sstream>
 #include <complex>
 
@@ -186,6 +187,91 @@ inline bool fromString(std::vector<T>& vec, const std::string& str) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type
+fromChars(T &value, std::string_view str, int base) {
+	if ( str.empty() ) return false;
+
+	T tmp;
+	const char *end = str.data() + str.size();
+	auto res = std::from_chars(str.data(), end, tmp, base);
+	if ( res.ec != std::errc() || res.ptr != end )
+		return false;
+
+	value = tmp;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline Tokens::iterator::iterator(std::string_view source,
+                                  std::string_view delimiter, bool compressOn)
+: _rest(source), _delimiter(delimiter), _compressOn(compressOn), _done(false) {
+	++*this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline Tokens::iterator &Tokens::iterator::operator++() {
+	if ( _last ) {
+		_done = true;
+		_token = std::string_view();
+		return *this;
+	}
+
+	size_t pos = _rest.find_first_of(_delimiter);
+	if ( pos == std::string_view::npos ) {
+		// The remainder is the last token, even if empty
+		_token = _rest;
+		_rest = std::string_view();
+		_last = true;
+		return *this;
+	}
+
+	_token = _rest.substr(0, pos);
+
+	size_t next = pos + 1;
+	if ( _compressOn ) {
+		next = _rest.find_first_not_of(_delimiter, pos);
+		if ( next == std::string_view::npos ) next = _rest.size();
+	}
+
+	_rest.remove_prefix(next);
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline Tokens::iterator Tokens::iterator::operator++(int) {
+	iterator tmp(*this);
+	++*this;
+	return tmp;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline bool Tokens::iterator::operator==(const iterator &other) const {
+	if ( _done || other._done ) return _done == other._done;
+	return _token.data() == other._token.data() && _last == other._last;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 inline bool fromString(std::vector<std::complex<T> >& vec, const std::string& str) {
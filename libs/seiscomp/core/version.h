@@ -50,6 +50,243 @@ namespace Core {
    - Added Seiscomp::Processing::MagnitudeProcessor_MLc _c6, _H and _minDepth.
    - Added Seiscomp::Processing::AmplitudeProcessor::parameter
    - Made Seiscomp::IO::DatabaseInterface::escape a const method
+   - Added Seiscomp::Client::ThreadedQueue::popAll
+   - Added Seiscomp::IO::RecordStream::nextBatch
+   - Added Seiscomp::IO::Socket::buffered
+   - Added Seiscomp::Client::StreamApplication::setRecordBatchSize
+   - Added Seiscomp::Client::StreamApplication::storeRecords
+   - Added Seiscomp::Math::Filtering::IIR::BiquadCascade::applyChannels
+   - Added Seiscomp::Math::Filtering::STALTAGroup
+   - Added batched Seiscomp::Math::fft and Seiscomp::Math::ifft
+   - Added Seiscomp::Math::Restitution::OverlapSaveFilter
+   - Added Seiscomp::Processing::Response::getCachedTransferFunction, publicID and
+     the process wide response cache
+   - Added Seiscomp::Processing::AmplitudeProcessor::deferEmissions
+   - Added Seiscomp::Processing::Application::setProcessingThreads and
+     processorStatistics
+   - Added Seiscomp::Processing::SharedFilter
+   - Added Seiscomp::ArrayView
+   - Added Seiscomp::RecordSequence::contiguousView
+   - Added Seiscomp::DataModel::DatabaseArchive::getObjectsOfParents
+   - Added Seiscomp::DataModel::DatabaseReader::bulkLoad
+   - Added Seiscomp::IO::DatabaseInterface::Parameter and execute/beginQuery
+     with parameters
+   - Added Seiscomp::IO::DatabaseInterface::getRowFieldValue
+   - Added Seiscomp::DataModel::DatabaseArchive::setImplicitTransactions
+   - Added Seiscomp::DataModel::DatabaseQueryPool
+   - Added Seiscomp::DataModel::InventoryIndex
+   - Added Seiscomp::StreamKey and Seiscomp::Record::streamKey
+   - Added Seiscomp::ChunkedRingBuffer and Seiscomp::RecordSequence::lowerBound
+   - Added Seiscomp::RecordStream::SharedMemory and SharedMemoryPublisher
+   - Added Seiscomp::Client::StreamApplication::setSharedMemoryPublisher
+   - Added Seiscomp::RecordStream::Cache
+   - Added travel time interface "grid"
+   - Made Seiscomp::ellipcorr and Seiscomp::TTT::Locsat thread-safe
+   - Seiscomp::TTT::LibTau instances share the loaded tables and are cheap
+     to copy
+   - Added Seiscomp::TravelTimeTableInterface::computeTimes
+   - Added Seiscomp::Seismology::LocatorSession
+   - Added Seiscomp::Seismology::LocatorInterface::sensorLocationDelegate
+   - Added Seiscomp::Geo::GeoFeatureIndex
+   - Added Seiscomp::Geo::QuadTree::queryBoundingBoxes
+   - Added Seiscomp::Processing::Regions::contains(feature, lat, lon)
+   - Seiscomp::Geo::GeoFeature::contains uses an edge index for features
+     with many vertices
+   - Added Seiscomp::Geo::GeoFeatureSet::readDirCached
+   - Added Seiscomp::Math::Geo::delazi for many points
+   - Added Seiscomp::Math::Geo::UnitVectors
+   - Added Seiscomp::Client::Inventory::stationVectors
+   - Added Seiscomp::Gui::RecordPyramid
+   - Added optional RecordPyramid parameter to Seiscomp::Gui::RecordPolyline::create
+     and Seiscomp::Gui::RecordPolylineF::create
+   - Added Seiscomp::Gui::RecordStreamThread::setBatchInterval and
+     signal receivedRecords
+   - Added Seiscomp::Gui::RecordView::feed(const RecordBatch &)
+   - Added Seiscomp::Gui::RecordView::setConcurrentRendering
+   - Added Seiscomp::Gui::RecordWidget::hasDirtyTraces and updateTraces
+   - Added Seiscomp::Gui::SpectrogramRenderer::setAsynchronous
+   - Added Seiscomp::Gui::EventListModel
+   - Added Seiscomp::Gui::MapsDesc::loaderThreads
+   - Added Seiscomp::Gui::Map::TileStore::setViewCenter
+   - Added Seiscomp::Gui::Map::TextureCache::setViewCenter
+   - Cache simplified and projected geometry in Seiscomp::Gui::Map::GeoFeatureLayer
+   - Added Seiscomp::Gui::Map::Projection::processRows
+   - Render Seiscomp::Gui::StationSymbol from cached sprites
+   - Added Seiscomp::Client::Inventory::loadInstruments
+   - Added Seiscomp::Client::Inventory::loadSnapshot and saveSnapshot
+   - Added Seiscomp::IO::XMLArchive::readStream
+   - Added Seiscomp::IO::BinaryArchive::open(const char*, size_t) and
+     create(std::string&) for memory based archives
+   - Changed Seiscomp::Core::Generic::ClassFactoryInterface::ClassPool to use a
+     transparent comparator
+   - Added Seiscomp::Client::Protocol::LZ4Dictionary content encoding
+   - Added Seiscomp::Client::Protocol::supportsEncoding and
+     CompressionDictionary
+   - Added dictionary support to ext::boost::iostreams::lz4_compressor and
+     lz4_decompressor
+   - Added Seiscomp::Client::Connection::beginBatch and endBatch
+   - Added Seiscomp::Client::Protocol::beginBatch and endBatch
+   - Added Seiscomp::Wired::Socket::connectLocal and bindLocal
+   - Added Seiscomp::Wired::Server::addLocalEndpoint
+   - Added Seiscomp::Client::SCMP::Socket::setLocalSocket
+   - Added messaging protocol "scmpl" for local socket connections
+   - Added Seiscomp::Client::Protocol::setSubscriptionFilter
+   - Added Seiscomp::Client::Connection::setSubscriptionFilter
+   - Added RecordStream factory "slinkmux"
+   - Added Seiscomp::RecordStream::Concurrent::acquired
+   - Added Seiscomp::RecordStream::SLConnection::reconnects
+   - Added Seiscomp::Logging::AsyncOutput
+   - Added global configuration parameter logging.async
+   - Changed Seiscomp::Logging::PublishLoc::enabled to std::atomic<bool>
+   - Added compile time log level SEISCOMP_LOG_LEVEL
+   - Added Seiscomp::Logging::BinaryOutput
+   - Added Seiscomp::Logging::Output::location
+   - Added global configuration parameter logging.binary
+   - Added Seiscomp::Processing::QcProcessorCombined
+   - Added Seiscomp::Math::Statistics::rms
+   - Added Seiscomp::Client::LatencyHistogram and LatencyMonitor
+   - Added Seiscomp::Client::Application::send
+   - Added Seiscomp::Client::Application::setLatencyStatisticsEnabled
+   - Added Seiscomp::Client::Application::latencyMonitor
+   - Added Seiscomp::Core::Metrics
+   - Added Seiscomp::Client::Application::setMetricsEnabled
+   - Added Seiscomp::RecordStream::SDSArchive::nextSegment
+   - Added Seiscomp::RecordStream::SDSAvailability
+   - Added Seiscomp::RecordStream::ChunkArchive and ChunkArchiveWriter
+   - Added Seiscomp::RecordStream::DecimationPyramid and Pyramid
+   - Added Seiscomp::IO::ResampleDesigns
+   - Removed the coefficient cache members of Seiscomp::IO::RecordResamplerBase
+   - Added Seiscomp::IO::AsyncFilter
+   - Added Seiscomp::IO::Spectralizer::Options::welchLength and welchOverlap
+   - Added Seiscomp::IO::Spectrum::isPowerSpectralDensity
+   - Added Seiscomp::Processing::QcProcessorPpsd and PpsdHistogram
+   - Changed Seiscomp::DataModel::PublicObject::PublicObjectMap to std::unordered_map
+   - Changed Seiscomp::DataModel::PublicObject::Iterator to a class which
+     iterates in unspecified order
+   - Made Seiscomp::DataModel::PublicObject::Find thread-safe
+   - Added Seiscomp::DataModel::ChildIndex
+   - Added hash indexes to the arrivals of Origin, the station magnitude
+     contributions of Magnitude, the picks, amplitudes, origins and events of
+     EventParameters, the networks of Inventory, the stations of Network and
+     the sensor locations of Station
+   - Added Seiscomp::DataModel::Diff2::setThreads
+   - Added Seiscomp::DataModel::Diff2::LogNode::child
+   - Added Seiscomp::DataModel::Snapshot and SnapshotWriter
+   - Added Seiscomp::DataModel::DatabaseArchive::getObjectsByPublicIDs
+   - Added Seiscomp::DataModel::PublicObjectCache::prefetch
+   - Added Seiscomp::DataModel::DatabaseArchive::getObjects(classType, publicIDs)
+   - Added Seiscomp::DataModel::DatabaseQuery::setQueryCache, clearQueryCache and
+     invalidateQueryCache
+   - Added Seiscomp::IO::Exporter::setThreads
+   - Added Seiscomp::IO::Importer::stream
+   - Added Seiscomp::Math::maedaAIC and maedaAICSNR
+   - Added Seiscomp::Processing::Picker::deferEmissions
+   - Added Seiscomp::Core::fromChars
+   - Added Seiscomp::Core::Tokens
+   - Added Seiscomp::IO::GFArchive::setCacheLimit, cacheLimit, cacheSize and clearCache
+   - Added Seiscomp::IO::GFArchive::setThreads
+   - Added Seiscomp::RecordStream::Replay
+   - Added Seiscomp::RecordStream::Concurrent::setMergeLateness and mergeLateness
+   - Added Seiscomp::Client::ThreadedQueue::drain
+   - Added Seiscomp::Processing::StationSettings
+   - Added optional compiled station settings to Seiscomp::Processing::Settings
+   - Added Seiscomp::Processing::AmplitudeProcessor::clone
+   - Added Seiscomp::Processing::MagnitudeProcessor::clone
+   - Added Seiscomp::Processing::ProcessorPrototypes
+   - Added Seiscomp::Math::Filtering::IIR::BiquadCascade::applyChain
+   - Added Seiscomp::Wired::ClientSession::pauseInbox
+   - Added Seiscomp::Wired::ClientSession::resumeInbox
+   - Added Seiscomp::Wired::HttpSession::isRequestPending
+   - Added Seiscomp::Wired::Websocket::PerMessageDeflate
+   - Added compressed flag to Seiscomp::Wired::Websocket::Frame and its finalizeBuffer
+   - Added Seiscomp::Wired::HttpSession::setWebsocketDeflateEnabled
+   - Added Seiscomp::Wired::HttpSession::websocketDeflate
+   - Added Seiscomp::Wired::HttpRequest::secWebsocketExtensions
+   - Added Seiscomp::System::Model::clearBindingCache
+   - Added Seiscomp::PackedIntArray
+   - Added Seiscomp::PackedRecord
+   - Added Seiscomp::RecordSequence::setPackRecords
+   - Added Seiscomp::RecordSequence::packRecords
+   - Added Seiscomp::BitSet::orRange
+   - Added Seiscomp::RunLengthBitSet
+   - Added Seiscomp::PackedRecord::clipRuns
+   - Seiscomp::RecordSequence::contiguousRecord merges the clip masks of the records
+   - Added Seiscomp::Client::Connection::recvPacket
+   - Added Seiscomp::Client::Connection::decode
+   - Added connection.decodeThreads to Seiscomp::Client::Application
+   - Added Seiscomp::DataModel::Notifier::SetCoalescingWindow
+   - Added Seiscomp::DataModel::Notifier::CoalescingWindow
+   - Added Seiscomp::DataModel::Notifier::IsDue
+   - Added Seiscomp::DataModel::Notifier::Flush
+   - Added Seiscomp::IO::BulkRecordReader
+   - Python: Array.numpy() keeps the array alive as long as the NumPy
+     array exists
+   - Added Seiscomp::IO::QuakeLink::Session
+   - Added Seiscomp::IO::XMLArchive::readStream(std::streambuf*, const StreamCallback&)
+   - Added Seiscomp::Gui::TravelTimeWorker
+   - Added Seiscomp::WaveformMemory
+   - Added RecordSequence::memoryUsage, setEvictable, isEvictable, isEvicted
+     and restore
+   - Added Seiscomp::Gui::RecordWidget::restoreRecords
+   - Added Seiscomp::Core::Generic::setServiceResolver, resolveService and
+     serviceMutex
+   - Added PluginRegistry::setLazyLoadingEnabled, isLazyLoadingEnabled,
+     loadDeferredPlugins and deferredPluginCount
+   - Added Seiscomp::System::ThreadPlacement, startThread, initThread and
+     the thread placement functions in seiscomp/system/threads.h
+   - Added virtual System::Application::initThreads
+   - Added Seiscomp::TTT::LocsatTables which is shared by all LOCSAT travel
+     time table and locator instances
+   - Added Seiscomp::Math::Filtering::Hilbert (HILBERT) and
+     Seiscomp::Math::Filtering::HilbertEnvelope (HENV)
+   - Added Seiscomp::Processing::TableXY::update and batch TableXY::at
+   - Added Seiscomp::Processing::MagnitudeProcessor::ComputeMagnitudes
+   - Added Seiscomp::Math::Statistics::OrderStatistics
+   - Added Seiscomp::Processing::GapInterpolator
+   - Added Seiscomp::Processing::WaveformProcessor::setGapInterpolationStrategy
+   - Added Seiscomp::Gui::MessageThread::setDecodingEnabled and
+     Seiscomp::Gui::MessageThread::takeMessage
+   - Added Seiscomp::DataModel::JournalIndex
+   - Added batch functions Seiscomp::Math::spect and
+     Seiscomp::Math::radiationPattern
+   - Added RecordStream "arclinkmux" with class
+     Seiscomp::RecordStream::ArclinkMuxConnection
+   - Added Seiscomp::IO::Socket::takeConnection and Socket::timeout
+   - Added Seiscomp::RecordStream::SLConnection::subscribe and unsubscribe
+   - Added Seiscomp::Processing::TemplateDetector
+   - Added Seiscomp::Processing::CrossCorrelator
+   - Added streamed reading to Seiscomp::IO::JSONArchive
+   - Changed Seiscomp::Core::Generic::ClassFactoryInterface::ClassPool and
+     ClassNames to hash tables and added InternedNames
+   - Added Seiscomp::Util::WildcardMatcher
+   - Seiscomp::Util::WildcardStringFirewall compiles its rules and bounds its
+     cache to MaxCacheSize entries
+   - Added Seiscomp::RecordStream::Concurrent::nextProxy
+   - Seiscomp::RecordStream::Concurrent::acquired returns whether the record
+     is queued
+   - Added Seiscomp::Math::Filtering::InPlaceFilter::hasSerializableState
+   - Added Seiscomp::Processing::WaveformProcessor::hasSerializableState
+   - Added Seiscomp::Processing::WaveformProcessor::serialize
+   - Added Seiscomp::Processing::GapInterpolator::serialize
+   - Added Seiscomp::Processing::Application::setCheckpointFile
+   - Added Seiscomp::Processing::Application::writeCheckpoint
+   - Added Seiscomp::DataModel::ObjectArena
+   - Added Seiscomp::DataModel::Object::operator new and operator delete
+   - Added Seiscomp::DataModel::InventoryIndex::getSensorLocations
+   - Added Seiscomp::DataModel::InventoryIndex::getNearestSensorLocations
+   - Added Seiscomp::Client::Inventory::getSensorLocations
+   - Added Seiscomp::Client::Inventory::getNearestSensorLocations
+   - Added Seiscomp::Gui::Map::Layer::setCachingEnabled
+   - Added Seiscomp::Gui::Map::Layer::isCachingEnabled
+   - Added Seiscomp::Gui::Map::Layer::invalidateCache
+   - Index cities and cache the label placement in Seiscomp::Gui::Map::CitiesLayer
+   - Added Seiscomp::Gui::DiagramWidget::setLevelOfDetailThreshold
+   - Added Seiscomp::Gui::DiagramWidget::levelOfDetailThreshold
+   - Added Seiscomp::Processing::Stream::ClearCache
+   - Added Seiscomp::IO::BSONArchive::open(const char*, size_t)
+   - Added Seiscomp::IO::BSONArchive::create(std::string&, bool)
+   - Added Seiscomp::IO::BSONArchive::setCompressionMethod
+   - Added optional forceWriteVersion to Seiscomp::IO::BSONArchive default constructor
 
  "16.1.0"   0x100100
    - Added Seiscomp::DataModel::numberOfComponents
@@ -0,0 +1,526 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT WaveformMemory
+
+#include <seiscomp/core/waveformmemory.h>
+#include <seiscomp/core/arrayfactory.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/metrics.h>
+#include <seiscomp/core/packedrecord.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/system.h>
+#include <seiscomp/logging/log.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#ifndef WIN32
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+
+namespace Seiscomp {
+
+
+namespace {
+
+
+// Approximate size of a record object without samples
+const size_t RecordOverhead = 128;
+
+
+int elementSize(Array::DataType dt) {
+	switch ( dt ) {
+		case Array::CHAR:
+			return 1;
+		case Array::INT:
+		case Array::FLOAT:
+			return 4;
+		case Array::DOUBLE:
+		case Array::COMPLEX_FLOAT:
+			return 8;
+		case Array::COMPLEX_DOUBLE:
+			return 16;
+		default:
+			break;
+	}
+
+	return 4;
+}
+
+
+unsigned int processID() {
+#ifndef WIN32
+	return static_cast<unsigned int>(getpid());
+#else
+	return static_cast<unsigned int>(GetCurrentProcessId());
+#endif
+}
+
+
+template <typename T>
+void writeValue(std::ostream &os, const T &value) {
+	os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+
+template <typename T>
+bool readValue(std::istream &is, T &value) {
+	return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+
+void writeString(std::ostream &os, const std::string &str) {
+	uint16_t len = static_cast<uint16_t>(str.size());
+	writeValue(os, len);
+	os.write(str.data(), len);
+}
+
+
+bool readString(std::istream &is, std::string &str) {
+	uint16_t len;
+	if ( !readValue(is, len) ) return false;
+	str.resize(len);
+	return len == 0 || is.read(&str[0], len);
+}
+
+
+/**
+ * Writes the header and the samples of a record. Only records with char,
+ * int, float or double samples can be written, clip masks are not kept.
+ */
+bool writeRecord(std::ostream &os, const Record *rec) {
+	const Array *data = rec->data();
+	if ( !data ) return false;
+
+	switch ( data->dataType() ) {
+		case Array::CHAR:
+		case Array::INT:
+		case Array::FLOAT:
+		case Array::DOUBLE:
+			break;
+		default:
+			return false;
+	}
+
+	writeString(os, rec->networkCode());
+	writeString(os, rec->stationCode());
+	writeString(os, rec->locationCode());
+	writeString(os, rec->channelCode());
+	writeValue(os, static_cast<int64_t>(rec->startTime().seconds()));
+	writeValue(os, static_cast<int32_t>(rec->startTime().microseconds()));
+	writeValue(os, rec->samplingFrequency());
+	writeValue(os, static_cast<int32_t>(rec->timingQuality()));
+	writeValue(os, static_cast<int32_t>(rec->authentication()));
+	writeValue(os, static_cast<int32_t>(data->dataType()));
+	writeValue(os, static_cast<int32_t>(data->size()));
+	os.write(static_cast<const char*>(data->data()),
+	         static_cast<std::streamsize>(data->size()) * data->elementSize());
+
+	return os.good();
+}
+
+
+GenericRecord *readRecord(std::istream &is) {
+	std::string net, sta, loc, cha;
+	int64_t seconds;
+	int32_t microseconds, timingQuality, authentication, dataType, size;
+	double fsamp;
+
+	if ( !readString(is, net) || !readString(is, sta)
+	  || !readString(is, loc) || !readString(is, cha)
+	  || !readValue(is, seconds) || !readValue(is, microseconds)
+	  || !readValue(is, fsamp) || !readValue(is, timingQuality)
+	  || !readValue(is, authentication) || !readValue(is, dataType)
+	  || !readValue(is, size) )
+		return nullptr;
+
+	Array::DataType dt = static_cast<Array::DataType>(dataType);
+	if ( size < 0 || dt > Array::DOUBLE ) return nullptr;
+
+	std::vector<char> buffer(static_cast<size_t>(size) * elementSize(dt));
+	if ( !buffer.empty() && !is.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) )
+		return nullptr;
+
+	ArrayPtr data = ArrayFactory::Create(dt, dt, size, buffer.data());
+	if ( !data ) return nullptr;
+
+	GenericRecord *rec = new GenericRecord(net, sta, loc, cha,
+	                                       Core::Time(seconds, microseconds),
+	                                       fsamp, timingQuality, dt);
+	rec->setAuthentication(static_cast<Record::Authentication>(authentication));
+	rec->setData(data.get());
+	return rec;
+}
+
+
+Core::Metrics::Gauge &bytesGauge() {
+	static Core::Metrics::Gauge &gauge = Core::Metrics::gauge("waveforms.memory.bytes");
+	return gauge;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+WaveformMemory &WaveformMemory::Instance() {
+	// Never destroyed, sequences may be released during static destruction
+	static WaveformMemory *instance = new WaveformMemory;
+	return *instance;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::setBudget(size_t bytes) {
+	_budget = bytes;
+	Core::Metrics::gauge("waveforms.memory.budget").set(static_cast<int64_t>(bytes));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t WaveformMemory::budget() const {
+	return _budget;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool WaveformMemory::setSpillDirectory(const std::string &path) {
+	if ( !path.empty() ) {
+		boost::system::error_code ec;
+		boost::filesystem::create_directories(SC_FS_PATH(path), ec);
+		if ( ec ) {
+			SEISCOMP_ERROR("Failed to create waveform spill directory %s: %s",
+			               path.c_str(), ec.message().c_str());
+			return false;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_spillDirectory = path;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &WaveformMemory::spillDirectory() const {
+	return _spillDirectory;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+WaveformMemory::Statistics WaveformMemory::statistics() const {
+	Statistics stats;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	stats.bytes = static_cast<size_t>(std::max(_bytes.load(), int64_t(0)));
+	stats.peakBytes = static_cast<size_t>(_peakBytes.load());
+	stats.sequences = _sequences.size();
+	stats.evictedSequences = _evictedSequences;
+	stats.evictions = _evictions;
+	stats.spills = _spills;
+	stats.restores = _restores;
+	stats.droppedRecords = _droppedRecords;
+
+	return stats;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t WaveformMemory::MemoryUsage(const Record *rec) {
+	if ( !rec ) return 0;
+
+	const PackedRecord *packed = PackedRecord::ConstCast(rec);
+	if ( packed )
+		return RecordOverhead + packed->byteSize();
+
+	// The sample count is known without decoding the data
+	return RecordOverhead
+	     + static_cast<size_t>(std::max(rec->sampleCount(), 0)) * elementSize(rec->dataType());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::add(RecordSequence *seq) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	seq->_memoryId = ++_nextId;
+	seq->_lastUse = ++_clock;
+	_sequences.insert(seq);
+	updateMetrics();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::remove(RecordSequence *seq) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_sequences.erase(seq);
+
+	SpillFiles::iterator it = _spillFiles.find(seq);
+	if ( it != _spillFiles.end() ) {
+		std::remove(it->second.c_str());
+		_spillFiles.erase(it);
+	}
+
+	if ( seq->_evicted ) {
+		seq->_evicted = false;
+		--_evictedSequences;
+	}
+
+	bytesGauge().set(_bytes -= static_cast<int64_t>(seq->_memoryUsage));
+	seq->_memoryUsage = 0;
+	updateMetrics();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::changed(RecordSequence *seq, int64_t delta) {
+	int64_t total = (_bytes += delta);
+	bytesGauge().set(total);
+
+	if ( delta <= 0 ) return;
+
+	seq->_lastUse = ++_clock;
+
+	int64_t peak = _peakBytes.load();
+	while ( total > peak && !_peakBytes.compare_exchange_weak(peak, total) ) {}
+
+	size_t budget = _budget;
+	if ( budget && total > static_cast<int64_t>(budget) ) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		enforce(seq);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::touch(RecordSequence *seq) {
+	seq->_lastUse = ++_clock;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool WaveformMemory::restore(RecordSequence *seq) {
+	std::string file;
+	bool complete;
+
+	seq->_lastUse = ++_clock;
+	if ( !seq->_evicted ) return true;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		seq->_evicted = false;
+		--_evictedSequences;
+		++_restores;
+
+		SpillFiles::iterator it = _spillFiles.find(seq);
+		if ( it != _spillFiles.end() ) {
+			file = it->second;
+			_spillFiles.erase(it);
+		}
+
+		complete = !seq->_incomplete;
+		seq->_incomplete = false;
+		updateMetrics();
+	}
+
+	static Core::Metrics::Counter &restores = Core::Metrics::counter("waveforms.memory.restores");
+	++restores;
+
+	if ( !file.empty() ) {
+		std::ifstream ifs(file.c_str(), std::ios::binary);
+		RecordPtr rec;
+
+		// Feeding accounts the records again and may evict other
+		// sequences but never the sequence being fed
+		while ( (rec = readRecord(ifs)) )
+			seq->feed(rec.get());
+
+		if ( !ifs.eof() ) {
+			SEISCOMP_WARNING("Failed to read all records from %s", file.c_str());
+			complete = false;
+		}
+
+		ifs.close();
+		std::remove(file.c_str());
+	}
+
+	return complete;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::enforce(RecordSequence *fed) {
+	size_t budget = _budget;
+	if ( !budget || _bytes <= static_cast<int64_t>(budget) ) return;
+
+	// Evict down to the low watermark to not evict with each fed record
+	int64_t low = static_cast<int64_t>(budget / 10 * 9);
+
+	std::vector<RecordSequence*> candidates;
+	for ( RecordSequence *seq : _sequences ) {
+		if ( seq != fed && seq->_evictable && seq->_memoryUsage > 0 )
+			candidates.push_back(seq);
+	}
+
+	std::sort(candidates.begin(), candidates.end(),
+	          [](const RecordSequence *a, const RecordSequence *b) {
+		return a->_lastUse < b->_lastUse;
+	});
+
+	for ( RecordSequence *seq : candidates ) {
+		if ( _bytes <= low ) break;
+		evict(seq);
+	}
+
+	updateMetrics();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::evict(RecordSequence *seq) {
+	static Core::Metrics::Counter &evictions = Core::Metrics::counter("waveforms.memory.evictions");
+	static Core::Metrics::Counter &spills = Core::Metrics::counter("waveforms.memory.spills");
+
+	size_t dropped = seq->size();
+
+	// A sequence evicted again before being restored appends to its file
+	SpillFiles::iterator it = _spillFiles.find(seq);
+	std::string file;
+	if ( it != _spillFiles.end() )
+		file = it->second;
+	else if ( !_spillDirectory.empty() )
+		file = spillFile(seq);
+
+	if ( !file.empty() ) {
+		std::ofstream ofs(file.c_str(), std::ios::binary | std::ios::app);
+		if ( ofs ) {
+			dropped = 0;
+			for ( const RecordCPtr &rec : *seq ) {
+				if ( !writeRecord(ofs, rec.get()) )
+					++dropped;
+			}
+		}
+
+		if ( ofs.good() ) {
+			_spillFiles[seq] = file;
+			++_spills;
+			++spills;
+		}
+		else {
+			SEISCOMP_WARNING("Failed to write records to %s", file.c_str());
+			dropped = seq->size();
+		}
+	}
+
+	seq->releaseRecords();
+
+	bytesGauge().set(_bytes -= static_cast<int64_t>(seq->_memoryUsage));
+	seq->_memoryUsage = 0;
+
+	if ( !seq->_evicted ) {
+		seq->_evicted = true;
+		++_evictedSequences;
+	}
+
+	if ( dropped ) {
+		seq->_incomplete = true;
+		_droppedRecords += dropped;
+	}
+
+	++_evictions;
+	++evictions;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string WaveformMemory::spillFile(const RecordSequence *seq) const {
+	return _spillDirectory + "/" + std::to_string(processID()) + "-"
+	     + std::to_string(seq->_memoryId) + ".rec";
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformMemory::updateMetrics() {
+	static Core::Metrics::Gauge &sequences = Core::Metrics::gauge("waveforms.memory.sequences");
+	static Core::Metrics::Gauge &evicted = Core::Metrics::gauge("waveforms.memory.evicted");
+	sequences.set(static_cast<int64_t>(_sequences.size()));
+	evicted.set(static_cast<int64_t>(_evictedSequences));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
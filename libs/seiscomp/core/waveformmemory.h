@@ -0,0 +1,182 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_CORE_WAVEFORMMEMORY_H
+#define SEISCOMP_CORE_WAVEFORMMEMORY_H
+
+
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace Seiscomp {
+
+
+class Record;
+class RecordSequence;
+
+
+/**
+ * @brief The WaveformMemory class accounts the memory held by all record
+ *        sequences of the process and enforces an optional budget.
+ *
+ * Each RecordSequence registers itself and reports the bytes of the
+ * records it stores. If a budget is set and the total exceeds it, the
+ * least recently used sequences which have been marked evictable are
+ * evicted until the total has dropped below 90% of the budget. The
+ * records of an evicted sequence are written to a file in the spill
+ * directory if one is set, otherwise they are dropped. The owner of an
+ * evictable sequence calls RecordSequence::restore before it accesses
+ * the records which reads spilled records back.
+ *
+ * Evictable sequences are evicted while another sequence is fed. All
+ * evictable sequences must therefore be used by one thread, e.g. the GUI
+ * thread or the processing thread of an application.
+ *
+ * The totals are published as the gauges "waveforms.memory.bytes",
+ * "waveforms.memory.budget", "waveforms.memory.sequences",
+ * "waveforms.memory.evicted" and the counters "waveforms.memory.evictions", "waveforms.memory.spills" and
+ * "waveforms.memory.restores".
+ */
+class SC_SYSTEM_CORE_API WaveformMemory {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct Statistics {
+			//! The bytes held by all sequences
+			size_t   bytes{0};
+			//! The maximum of bytes ever reached
+			size_t   peakBytes{0};
+			//! The number of registered sequences
+			size_t   sequences{0};
+			//! The number of sequences currently evicted
+			size_t   evictedSequences{0};
+			//! The number of evictions
+			uint64_t evictions{0};
+			//! The number of evictions which spilled records to disk
+			uint64_t spills{0};
+			//! The number of restored sequences
+			uint64_t restores{0};
+			//! The number of records which were dropped
+			uint64_t droppedRecords{0};
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	private:
+		WaveformMemory() = default;
+
+	public:
+		//! Returns the process-wide instance
+		static WaveformMemory &Instance();
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Sets the budget in bytes. A budget of 0 disables eviction
+		 *        which is the default. The budget is enforced with the
+		 *        next fed record.
+		 */
+		void setBudget(size_t bytes);
+		size_t budget() const;
+
+		/**
+		 * @brief Sets the directory where the records of evicted sequences
+		 *        are written to. The directory is created if it does not
+		 *        exist. An empty path disables spilling and evicted records
+		 *        are dropped. Already spilled records are still restored
+		 *        from the previous directory.
+		 * @return False if the directory cannot be created
+		 */
+		bool setSpillDirectory(const std::string &path);
+		const std::string &spillDirectory() const;
+
+		//! Returns the current statistics
+		Statistics statistics() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Sequence interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the approximate bytes held by a stored record
+		static size_t MemoryUsage(const Record *rec);
+
+	private:
+		void add(RecordSequence *seq);
+		void remove(RecordSequence *seq);
+
+		//! Accounts a change of the memory usage of a sequence and
+		//! enforces the budget
+		void changed(RecordSequence *seq, int64_t delta);
+
+		//! Marks a sequence as used
+		void touch(RecordSequence *seq);
+
+		bool restore(RecordSequence *seq);
+
+		void enforce(RecordSequence *fed);
+		void evict(RecordSequence *seq);
+		std::string spillFile(const RecordSequence *seq) const;
+		void updateMetrics();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		using SpillFiles = std::unordered_map<const RecordSequence*, std::string>;
+
+		mutable std::mutex                 _mutex;
+		std::unordered_set<RecordSequence*> _sequences;
+		SpillFiles                         _spillFiles;
+		std::string                        _spillDirectory;
+		std::atomic<size_t>                _budget{0};
+		std::atomic<int64_t>               _bytes{0};
+		std::atomic<int64_t>               _peakBytes{0};
+		std::atomic<uint64_t>              _clock{0};
+		std::atomic<uint64_t>              _nextId{0};
+		size_t                             _evictedSequences{0};
+		uint64_t                           _evictions{0};
+		uint64_t                           _spills{0};
+		uint64_t                           _restores{0};
+		uint64_t                           _droppedRecords{0};
+
+	friend class RecordSequence;
+};
+
+
+}
+
+
+#endif
@@ -0,0 +1,132 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_DATAMODEL_CHILDINDEX_H__
+#define SEISCOMP_DATAMODEL_CHILDINDEX_H__
+
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+/**
+ * @brief Hash index of the children of an aggregation keyed by a string
+ *        such as their publicID or the attribute of their index.
+ *
+ * The index is built when the aggregation reaches MinSize elements.
+ * Smaller aggregations are scanned linearly which is as fast and does not
+ * cost extra memory. The index is only changed by added and removed, so
+ * looking up children is read-only and can be done concurrently.
+ *
+ * The key of a child must not change while it is part of the aggregation.
+ * Copying a parent does not copy its children and hence neither copies
+ * the index.
+ */
+template <typename T>
+class ChildIndex {
+	public:
+		static const size_t MinSize = 16;
+
+	public:
+		ChildIndex() = default;
+		ChildIndex(const ChildIndex &) {}
+		ChildIndex &operator=(const ChildIndex &) { return *this; }
+
+	public:
+		/**
+		 * @brief Returns the first child with a key.
+		 * @param children The aggregation, a container of smart pointers
+		 * @param key The key to look for
+		 * @param keyOf Returns the key of a child
+		 */
+		template <typename Container, typename KeyOf>
+		T *find(const Container &children, const std::string &key,
+		        KeyOf keyOf) const {
+			if ( !_map ) {
+				for ( auto &&child : children ) {
+					if ( keyOf(child.get()) == key )
+						return child.get();
+				}
+
+				return nullptr;
+			}
+
+			auto it = _map->find(key);
+			return it != _map->end() ? it->second : nullptr;
+		}
+
+		//! Must be called after a child has been appended
+		template <typename Container, typename KeyOf>
+		void added(const Container &children, KeyOf keyOf) {
+			if ( _map ) {
+				T *child = children.back().get();
+				_map->emplace(keyOf(child), child);
+			}
+			else if ( children.size() >= MinSize ) {
+				_map.reset(new Map);
+				_map->reserve(children.size() * 2);
+				for ( auto &&child : children )
+					_map->emplace(keyOf(child.get()), child.get());
+			}
+		}
+
+		//! Must be called before a child is removed
+		template <typename Container, typename KeyOf>
+		void removed(const Container &children, const T *child, KeyOf keyOf) {
+			if ( !_map ) return;
+
+			auto it = _map->find(keyOf(child));
+			if ( it == _map->end() || it->second != child ) return;
+
+			_map->erase(it);
+
+			// Another child with the same key takes over
+			for ( auto &&other : children ) {
+				if ( other.get() != child && keyOf(other.get()) == keyOf(child) ) {
+					_map->emplace(keyOf(other.get()), other.get());
+					break;
+				}
+			}
+		}
+
+	private:
+		typedef std::unordered_map<std::string, T*> Map;
+		std::unique_ptr<Map> _map;
+};
+
+
+//! Returns the publicID of a child, the key function for public objects
+template <typename T>
+const std::string &publicIDOf(const T *object) {
+	return object->publicID();
+}
+
+
+}
+}
+
+
+#endif
@@ -20,6 +20,7 @@
 
 #define SEISCOMP_COMPONENT DatabaseArchive
 #include <seiscomp/core/exceptions.h>
+#include <seiscomp/core/metrics.h>
 #include <seiscomp/datamodel/databasearchive.h>
 #include <seiscomp/datamodel/version.h>
 #include <seiscomp/datamodel/stream.h>
@@ -27,6 +28,7 @@
 
 #define __STDC_FORMAT_MACROS
 #include <iostream>
+#include <unordered_set>
 #include <stdlib.h>
 #include <inttypes.h>
 #include <strings.h>
@@ -45,6 +47,20 @@ namespace Seiscomp {
 namespace DataModel {
 
 
+namespace {
+
+
+//! Starts a query and records its duration in the metrics registry
+bool beginTimedQuery(IO::DatabaseInterface *db, const char *query) {
+	static Metrics::Timer &timer = Metrics::timer("database.query");
+	Metrics::ScopedTimer scope(timer);
+	return db->beginQuery(query);
+}
+
+
+}
+
+
 class AttributeMapper {
 	public:
 		AttributeMapper(const DatabaseArchive::AttributeMap &map)
@@ -167,6 +183,23 @@ DatabaseIterator::DatabaseIterator(DatabaseArchive *database, const RTTI *rtti)
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseIterator::DatabaseIterator(std::shared_ptr<const Rows> rows)
+: _rtti(nullptr)
+, _reader(nullptr)
+, _count(0)
+, _oid(IO::DatabaseInterface::INVALID_OID)
+, _parent_oid(IO::DatabaseInterface::INVALID_OID)
+, _cached(true)
+, _rows(std::move(rows))
+{
+	setRow();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DatabaseIterator::DatabaseIterator()
 : _rtti(nullptr)
@@ -191,6 +224,8 @@ DatabaseIterator::DatabaseIterator(const DatabaseIterator &iter)
 , _parent_oid(iter._parent_oid)
 , _cached(iter._cached)
 , _lastModified(iter._lastModified)
+, _rows(iter._rows)
+, _row(iter._row)
 {
 	_object = iter._object;
 }
@@ -266,6 +301,24 @@ Object *DatabaseIterator::fetch() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseIterator::setRow() {
+	if ( !_rows || _row >= _rows->size() ) {
+		close();
+		return;
+	}
+
+	const Row &row = (*_rows)[_row];
+	_object = row.object;
+	_oid = row.oid;
+	_parent_oid = row.parentOid;
+	_lastModified = row.lastModified;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DatabaseIterator& DatabaseIterator::operator=(const DatabaseIterator &it) {
 	_rtti = it._rtti;
@@ -275,6 +328,8 @@ DatabaseIterator& DatabaseIterator::operator=(const DatabaseIterator &it) {
 	_oid = it._oid;
 	_parent_oid = it._parent_oid;
 	_lastModified = it._lastModified;
+	_rows = it._rows;
+	_row = it._row;
 	return *this;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -284,7 +339,7 @@ DatabaseIterator& DatabaseIterator::operator=(const DatabaseIterator &it) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool DatabaseIterator::valid() const {
-	return _reader != nullptr;
+	return _reader != nullptr || _rows != nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -339,6 +394,18 @@ Object* DatabaseIterator::operator*() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DatabaseIterator& DatabaseIterator::operator++() {
+	if ( _rows ) {
+		++_row;
+		setRow();
+		if ( _object ) ++_count;
+		return *this;
+	}
+
+	if ( !_reader ) {
+		_object = nullptr;
+		return *this;
+	}
+
 	while ( _reader->_db->fetchRow() ) {
 		_object = fetch();
 		if ( !_object ) continue;
@@ -371,6 +438,7 @@ void DatabaseIterator::close() {
 		_rtti = nullptr;
 	}
 
+	_rows = nullptr;
 	_object = nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -506,6 +574,7 @@ DatabaseArchive::DatabaseArchive(Seiscomp::IO::DatabaseInterface *i)
 	setHint(IGNORE_CHILDS);
 	Object::RegisterObserver(this);
 	_allowDbClose = false;
+	_implicitTransactions = true;
 
 	if ( !fetchVersion() ) {
 		close();
@@ -617,6 +686,15 @@ bool DatabaseArchive::fetchVersion() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseArchive::setImplicitTransactions(bool enable) {
+	_implicitTransactions = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool DatabaseArchive::hasError() const {
 	return !_errorMsg.empty();
@@ -678,7 +756,7 @@ Object *DatabaseArchive::queryObject(const Seiscomp::Core::RTTI &classType,
 		return nullptr;
 	}
 
-	if ( !_db->beginQuery(query.c_str()) ) {
+	if ( !beginTimedQuery(_db.get(), query.c_str()) ) {
 		SEISCOMP_ERROR("query [%s] failed", query.c_str());
 		return nullptr;
 	}
@@ -783,14 +861,13 @@ DatabaseIterator DatabaseArchive::getObjects(const PublicObject *parent,
 		return DatabaseIterator();
 	}
 
-	OID parentID = getCachedId(parent);
-	if ( !parentID && parent ) {
-		parentID = publicObjectId(parent->publicID());
+	OID parentID = 0;
+	if ( parent ) {
+		parentID = databaseId(parent);
 		if ( !parentID ) {
 			SEISCOMP_INFO("parent object with id '%s' not found in database", parent->publicID().c_str());
 			return DatabaseIterator();
 		}
-		registerId(parent, parentID);
 	}
 
 	return getObjectIterator(parentID, classType, ignorePublicObject);
@@ -800,6 +877,110 @@ DatabaseIterator DatabaseArchive::getObjects(const PublicObject *parent,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseIterator DatabaseArchive::getObjectsOfParents(const std::string &parentOids,
+                                                      const Seiscomp::Core::RTTI &classType,
+                                                      bool ignorePublicObject) {
+	if ( !validInterface() ) {
+		SEISCOMP_ERROR("no valid database interface");
+		return DatabaseIterator();
+	}
+
+	std::string query;
+
+	if ( ignorePublicObject || !classType.isTypeOf(PublicObject::TypeInfo()) )
+		query = std::string("select * from ") + classType.className() + " where ";
+	else {
+		std::stringstream ss;
+		ss << "select " << PublicObject::ClassName() << "." << _publicIDColumn << ","
+		   << classType.className() << ".* from "
+		   << PublicObject::ClassName() << "," << classType.className()
+		   << " where " << PublicObject::ClassName() << "._oid="
+		   << classType.className() << "._oid and ";
+
+		query = ss.str();
+	}
+
+	query += classType.className();
+	query += "._parent_oid in (" + parentOids + ")";
+
+	return getObjectIterator(query, classType);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseIterator DatabaseArchive::getObjectsByPublicIDs(const Seiscomp::Core::RTTI &classType,
+                                                        const std::vector<std::string> &publicIDs) {
+	if ( !validInterface() ) {
+		SEISCOMP_ERROR("no valid database interface");
+		return DatabaseIterator();
+	}
+
+	if ( publicIDs.empty() || !classType.isTypeOf(PublicObject::TypeInfo()) )
+		return DatabaseIterator();
+
+	std::stringstream ss;
+	ss << "select " << PublicObject::ClassName() << "." << _publicIDColumn << ","
+	   << classType.className() << ".* from "
+	   << PublicObject::ClassName() << "," << classType.className()
+	   << " where " << PublicObject::ClassName() << "._oid="
+	   << classType.className() << "._oid and "
+	   << PublicObject::ClassName() << "." << _publicIDColumn << " in (";
+
+	for ( size_t i = 0; i < publicIDs.size(); ++i ) {
+		if ( i ) ss << ",";
+		ss << "'" << toSQL(_db.get(), publicIDs[i]) << "'";
+	}
+
+	ss << ")";
+
+	return getObjectIterator(ss.str(), classType);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::vector<PublicObjectPtr>
+DatabaseArchive::getObjects(const Seiscomp::Core::RTTI &classType,
+                            const std::vector<std::string> &publicIDs) {
+	// Keeps the statements short enough for all backends
+	const size_t maxBatchSize = 500;
+
+	std::vector<PublicObjectPtr> objects;
+	std::unordered_set<std::string> seen;
+	std::vector<std::string> batch;
+
+	auto flush = [&]() {
+		DatabaseIterator it = getObjectsByPublicIDs(classType, batch);
+		for ( ; *it; ++it ) {
+			PublicObject *po = PublicObject::Cast(*it);
+			if ( po ) objects.push_back(po);
+		}
+		it.close();
+		batch.clear();
+	};
+
+	for ( const auto &publicID : publicIDs ) {
+		if ( !seen.insert(publicID).second ) continue;
+
+		batch.push_back(publicID);
+		if ( batch.size() == maxBatchSize ) flush();
+	}
+
+	if ( !batch.empty() ) flush();
+
+	return objects;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t DatabaseArchive::getObjectCount(const std::string &parentID,
                                        const Seiscomp::Core::RTTI &classType) {
@@ -956,7 +1137,7 @@ DatabaseIterator DatabaseArchive::getObjectIterator(const std::string &query,
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DatabaseIterator DatabaseArchive::getObjectIterator(const std::string &query,
                                                     const Seiscomp::Core::RTTI *classType) {
-	if ( !_db->beginQuery(query.c_str()) ) {
+	if ( !beginTimedQuery(_db.get(), query.c_str()) ) {
 		SEISCOMP_ERROR("starting query '%s' failed", query.c_str());
 		return DatabaseIterator();
 	}
@@ -1453,8 +1634,8 @@ DatabaseArchive::OID DatabaseArchive::publicObjectId(const std::string &publicId
 	OID id = IO::DatabaseInterface::INVALID_OID;
 	std::stringstream ss;
 	ss << "select _oid from " << PublicObject::ClassName()
-	   << " where " << _publicIDColumn << "='" << toSQL(_db.get(), publicId) << "'";
-	if ( !_db->beginQuery(ss.str().c_str()) ) {
+	   << " where " << _publicIDColumn << "=?";
+	if ( !_db->beginQuery(ss.str().c_str(), { publicId }) ) {
 		return id;
 	}
 
@@ -1579,7 +1760,7 @@ DatabaseArchive::OID DatabaseArchive::insertObject() {
 	ss << "insert into " << Object::ClassName() << "(_oid) values("
 	   << _db->defaultValue() << ")";
 
-	if ( !_db->execute(ss.str().c_str()) ) {
+	if ( !_db->execute(ss.str().c_str(), {}) ) {
 		return IO::DatabaseInterface::INVALID_OID;
 	}
 
@@ -1632,9 +1813,9 @@ bool DatabaseArchive::insertRow(const std::string &table,
 bool DatabaseArchive::deleteObject(OID id) {
 	std::stringstream ss;
 	ss << "delete from " << Object::ClassName()
-	   << " where _oid=" << id;
+	   << " where _oid=?";
 	SC_FMT_DEBUG("deleting object with id {}", id);
-	return _db->execute(ss.str().c_str());
+	return _db->execute(ss.str().c_str(), { id });
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1677,24 +1858,29 @@ bool DatabaseArchive::insert(Object *obj, const std::string &parentId) {
 		}
 	}
 
-	_db->start();
+	if ( _implicitTransactions ) {
+		_db->start();
+	}
 
 	OID oid = insertObject();
 	if ( oid == IO::DatabaseInterface::INVALID_OID ) {
-		_db->rollback();
+		if ( _implicitTransactions ) {
+			_db->rollback();
+		}
 		return false;
 	}
 
 	if ( po ) {
 		std::stringstream ss;
 		ss << "insert into " << PublicObject::ClassName()
-		   << "(_oid," << _publicIDColumn << ") values("
-		   << oid << ",'" << toSQL(_db.get(), po->publicID()) << "')";
+		   << "(_oid," << _publicIDColumn << ") values(?,?)";
 
-		if ( !_db->execute(ss.str().c_str()) ) {
+		if ( !_db->execute(ss.str().c_str(), { oid, po->publicID() }) ) {
 			SEISCOMP_ERROR("writing %s '%s' failed",
 			               obj->className(), po->publicID().c_str());
-			_db->rollback();
+			if ( _implicitTransactions ) {
+				_db->rollback();
+			}
 			return false;
 		}
 	}
@@ -1707,7 +1893,9 @@ bool DatabaseArchive::insert(Object *obj, const std::string &parentId) {
 
 	if ( !Core::Archive::success() ) {
 		SEISCOMP_ERROR("serializing object with type '%s' failed", obj->className());
-		_db->rollback();
+		if ( _implicitTransactions ) {
+			_db->rollback();
+		}
 		return false;
 	}
 
@@ -1745,13 +1933,17 @@ bool DatabaseArchive::insert(Object *obj, const std::string &parentId) {
 	}
 
 	if ( success ) {
-		_db->commit();
+		if ( _implicitTransactions ) {
+			_db->commit();
+		}
 		registerId(obj, oid);
 	}
 	else {
 		SEISCOMP_ERROR("writing object with type '%s' failed",
 		                obj->className());
-		_db->rollback();
+		if ( _implicitTransactions ) {
+			_db->rollback();
+		}
 	}
 
 	_validObject = success;
@@ -1920,13 +2112,13 @@ bool DatabaseArchive::remove(Object *object, const std::string &parentID) {
 	_validObject = true;
 
 	if ( !_db->execute((std::string("delete from ") + object->className() +
-	                    " where _oid=" + toString(oid)).c_str()) ) {
+	                    " where _oid=?").c_str(), { oid }) ) {
 		setValidity(false);
 	}
 
 	if ( PublicObject::Cast(object) ) {
 		if ( !_db->execute((std::string("delete from ") + PublicObject::ClassName() +
-		                    " where _oid=" + toString(oid)).c_str()) ) {
+		                    " where _oid=?").c_str(), { oid }) ) {
 			setValidity(false);
 		}
 	}
@@ -2279,6 +2471,21 @@ void DatabaseArchive::registerId(const Object *o, OID id) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseArchive::OID DatabaseArchive::databaseId(const PublicObject *object) {
+	OID oid = getCachedId(object);
+	if ( !oid ) {
+		oid = publicObjectId(object->publicID());
+		if ( oid ) registerId(object, oid);
+	}
+
+	return oid;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 int DatabaseArchive::getCacheSize() const {
 	_objectIdMutex.lock();
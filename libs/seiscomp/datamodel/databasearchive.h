@@ -27,7 +27,9 @@
 #include <seiscomp/datamodel/publicobject.h>
 
 #include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -125,7 +127,21 @@ class SC_SYSTEM_CORE_API DatabaseIterator : public Seiscomp::Core::BaseObject {
 	//  Implementation
 	// ----------------------------------------------------------------------
 	private:
+		//! An object of a result which has been read before
+		struct Row {
+			ObjectPtr           object;
+			OID                 oid;
+			OID                 parentOid;
+			OPT(Core::Time)     lastModified;
+		};
+
+		typedef std::vector<Row> Rows;
+
+		//! C'tor used by DatabaseQuery to iterate over a cached result
+		DatabaseIterator(std::shared_ptr<const Rows> rows);
+
 		Object *fetch() const;
+		void setRow();
 
 
 	private:
@@ -139,8 +155,12 @@ class SC_SYSTEM_CORE_API DatabaseIterator : public Seiscomp::Core::BaseObject {
 		mutable bool _cached;
 		mutable OPT(Core::Time) _lastModified;
 
+		std::shared_ptr<const Rows> _rows;
+		size_t _row{0};
+
 	//! Make DatabaseArchive a friend class
 	friend class DatabaseArchive;
+	friend class DatabaseQuery;
 };
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -259,6 +279,15 @@ class SC_SYSTEM_CORE_API DatabaseArchive : protected Core::Archive,
 		//! Returns the error message if hasError() return true
 		const std::string errorMsg() const;
 
+		/**
+		 * @brief Enables or disables the transaction each write is wrapped
+		 *        into. Disable it if the caller groups several writes into
+		 *        one transaction and handles errors of single writes, e.g.
+		 *        with savepoints. The default is enabled.
+		 * @param enable The enable flag
+		 */
+		void setImplicitTransactions(bool enable);
+
 		void benchmarkQueries(int count);
 
 		/**
@@ -306,6 +335,46 @@ class SC_SYSTEM_CORE_API DatabaseArchive : protected Core::Archive,
 		                            const Seiscomp::Core::RTTI& classType,
 		                            bool ignorePublicObject = false);
 
+		/**
+		 * Returns an iterator over all objects of a given type whose
+		 * parents are selected by an SQL expression. This allows to read
+		 * the children of many parents with a single query.
+		 * @param parentOids An SQL expression which is valid inside of
+		 *                   "in (...)" and yields the database ids of
+		 *                   the parent objects, e.g. a list of ids or a
+		 *                   sub query selecting _oid.
+		 * @param classType The type of the objects to iterate over.
+		 * @param ignorePublicObject See getObjects.
+		 * @return The database iterator
+		 */
+		DatabaseIterator getObjectsOfParents(const std::string &parentOids,
+		                                     const Seiscomp::Core::RTTI &classType,
+		                                     bool ignorePublicObject = false);
+
+		/**
+		 * Returns an iterator over public objects of a given type with
+		 * one of the given publicIDs. This allows to read many objects
+		 * with a single query.
+		 * @param classType The type of the objects to iterate over. The
+		 *                  type has to be derived from PublicObject.
+		 * @param publicIDs The publicIDs of the objects
+		 * @return The database iterator
+		 */
+		DatabaseIterator getObjectsByPublicIDs(const Seiscomp::Core::RTTI &classType,
+		                                       const std::vector<std::string> &publicIDs);
+
+		/**
+		 * Reads public objects of a given type by their publicIDs. Duplicate
+		 * IDs are ignored and the objects are read with one query per
+		 * 500 publicIDs.
+		 * @param classType The type of the objects to be read. The type has
+		 *                  to be derived from PublicObject.
+		 * @param publicIDs The publicIDs of the objects
+		 * @return The objects found in no particular order
+		 */
+		std::vector<PublicObjectPtr> getObjects(const Seiscomp::Core::RTTI &classType,
+		                                        const std::vector<std::string> &publicIDs);
+
 		/**
 		 * Returns the number of objects of a given type.
 		 * @param parentID The publicID of the parent object. When empty,
@@ -392,6 +461,11 @@ class SC_SYSTEM_CORE_API DatabaseArchive : protected Core::Archive,
 		//! Implements derived  method
 		bool create(const char* dataSource);
 
+		//! Returns the database id of a PublicObject from the id cache or
+		//! the database and caches it. Returns 0 if the object is not
+		//! stored in the database.
+		OID databaseId(const PublicObject *object);
+
 
 	// ----------------------------------------------------------------------
 	//  Protected Archive Interface
@@ -625,6 +699,7 @@ class SC_SYSTEM_CORE_API DatabaseArchive : protected Core::Archive,
 		mutable std::string::size_type _prefixOffset[64];
 
 		bool _allowDbClose;
+		bool _implicitTransactions;
 
 	friend class DatabaseIterator;
 	friend class AttributeMapper;
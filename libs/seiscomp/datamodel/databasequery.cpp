@@ -31,9 +31,55 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/logging/log.h>
 
+#include <set>
+
 namespace Seiscomp {
 namespace DataModel {
 
+
+namespace {
+
+
+// Collects the class names of an object and all its children
+class ClassCollector : public Visitor {
+	public:
+		bool visit(PublicObject *po) override {
+			names.insert(po->className());
+			return true;
+		}
+
+		void visit(Object *o) override {
+			names.insert(o->className());
+		}
+
+		std::set<std::string> names;
+};
+
+
+bool isIdentifierChar(char c) {
+	return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+
+// Returns whether a query reads a table. The tables are named after the
+// classes while columns start with a lower case letter.
+bool readsTable(const std::string &query, const std::string &table) {
+	size_t pos = 0;
+	while ( (pos = query.find(table, pos)) != std::string::npos ) {
+		size_t end = pos + table.size();
+		if ( (pos == 0 || !isIdentifierChar(query[pos-1]))
+		  && (end == query.size() || !isIdentifierChar(query[end])) )
+			return true;
+		pos = end;
+	}
+
+	return false;
+}
+
+
+}
+
+
 #define _T(name) _db->convertColumnName(name)
 
 DatabaseQuery::DatabaseQuery(Seiscomp::IO::DatabaseInterface* dbDriver)
@@ -52,6 +98,118 @@ DatabaseQuery::~DatabaseQuery() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseQuery::setQueryCache(size_t maxEntries, double maxAge) {
+	_cacheSize = maxEntries;
+	_cacheMaxAge = maxAge;
+
+	while ( _cache.size() > _cacheSize ) {
+		_cacheLookup.erase(_cache.back().query);
+		_cache.pop_back();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseQuery::clearQueryCache() {
+	_cache.clear();
+	_cacheLookup.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseQuery::invalidateQueryCache(const Object *object) {
+	if ( _cache.empty() || !object ) return;
+
+	ClassCollector collector;
+	const_cast<Object*>(object)->accept(&collector);
+
+	for ( auto it = _cache.begin(); it != _cache.end(); ) {
+		bool affected = false;
+		for ( const auto &name : collector.names ) {
+			if ( readsTable(it->query, name) ) {
+				affected = true;
+				break;
+			}
+		}
+
+		if ( affected ) {
+			_cacheLookup.erase(it->query);
+			it = _cache.erase(it);
+		}
+		else
+			++it;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseQuery::invalidateQueryCache(const Notifier *notifier) {
+	if ( notifier ) invalidateQueryCache(notifier->object());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseIterator DatabaseQuery::cachedObjectIterator(const std::string &query,
+                                                     const Seiscomp::Core::RTTI &classType) {
+	if ( !_cacheSize ) return getObjectIterator(query, classType);
+
+	auto lit = _cacheLookup.find(query);
+	if ( lit != _cacheLookup.end() ) {
+		if ( _cacheMaxAge <= 0
+		  || (double)(Core::Time::UTC() - lit->second->created) < _cacheMaxAge ) {
+			_cache.splice(_cache.begin(), _cache, lit->second);
+			return DatabaseIterator(lit->second->rows);
+		}
+
+		_cache.erase(lit->second);
+		_cacheLookup.erase(lit);
+	}
+
+	Core::Time created = Core::Time::UTC();
+	std::shared_ptr<DatabaseIterator::Rows> rows(new DatabaseIterator::Rows);
+
+	DatabaseIterator it = getObjectIterator(query, classType);
+	for ( ; *it; ++it ) {
+		DatabaseIterator::Row row;
+		row.object = *it;
+		row.oid = it.oid();
+		row.parentOid = it.parentOid();
+		row.lastModified = it._lastModified;
+		rows->push_back(row);
+	}
+	it.close();
+
+	// Do not keep the result of a failed query
+	if ( !validInterface() ) return DatabaseIterator(rows);
+
+	_cache.push_front(CacheEntry{query, rows, created});
+	_cacheLookup[query] = _cache.begin();
+
+	while ( _cache.size() > _cacheSize ) {
+		_cacheLookup.erase(_cache.back().query);
+		_cache.pop_back();
+	}
+
+	return DatabaseIterator(rows);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Station* DatabaseQuery::getStation(const std::string& network_code,
                                    const std::string& station_code,
@@ -175,7 +333,7 @@ DatabaseIterator DatabaseQuery::getAmplitudes(Seiscomp::Core::Time startTime,
 	query += toString(endTime);
 	query += "'";
 
-	return getObjectIterator(query, Amplitude::TypeInfo());
+	return cachedObjectIterator(query, Amplitude::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -191,7 +349,7 @@ DatabaseIterator DatabaseQuery::getAmplitudesForPick(const std::string& pickID)
 	query += toString(pickID);
 	query += "'";
 
-	return getObjectIterator(query, Amplitude::TypeInfo());
+	return cachedObjectIterator(query, Amplitude::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -207,7 +365,7 @@ DatabaseIterator DatabaseQuery::getAmplitudesForOrigin(const std::string& origin
 	query += toString(originID);
 	query += "'";
 
-	return getObjectIterator(query, Amplitude::TypeInfo());
+	return cachedObjectIterator(query, Amplitude::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -223,7 +381,7 @@ DatabaseIterator DatabaseQuery::getOriginsForAmplitude(const std::string& amplit
 	query += toString(amplitudeID);
 	query += "'";
 
-	return getObjectIterator(query, Origin::TypeInfo());
+	return cachedObjectIterator(query, Origin::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -255,7 +413,7 @@ DatabaseIterator DatabaseQuery::getArrivalsForAmplitude(const std::string& ampli
 	query += toString(amplitudeID);
 	query += "'";
 
-	return getObjectIterator(query, Arrival::TypeInfo());
+	return cachedObjectIterator(query, Arrival::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -271,7 +429,7 @@ DatabaseIterator DatabaseQuery::getPicks(const std::string& originID) {
 	query += toString(originID);
 	query += "'";
 
-	return getObjectIterator(query, Pick::TypeInfo());
+	return cachedObjectIterator(query, Pick::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -290,7 +448,7 @@ DatabaseIterator DatabaseQuery::getPicks(Seiscomp::Core::Time startTime,
 	query += toString(endTime);
 	query += "'";
 
-	return getObjectIterator(query, Pick::TypeInfo());
+	return cachedObjectIterator(query, Pick::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -320,7 +478,7 @@ DatabaseIterator DatabaseQuery::getPicks(Seiscomp::Core::Time startTime,
 	query += toString(waveformID.resourceURI());
 	query += "')";
 
-	return getObjectIterator(query, Pick::TypeInfo());
+	return cachedObjectIterator(query, Pick::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -336,7 +494,7 @@ DatabaseIterator DatabaseQuery::getWaveformQuality(const std::string& type) {
 	query += toString(type);
 	query += "'";
 
-	return getObjectIterator(query, WaveformQuality::TypeInfo());
+	return cachedObjectIterator(query, WaveformQuality::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -369,7 +527,7 @@ DatabaseIterator DatabaseQuery::getWaveformQuality(const WaveformStreamID& wavef
 	query += toString(parameter);
 	query += "'";
 
-	return getObjectIterator(query, WaveformQuality::TypeInfo());
+	return cachedObjectIterator(query, WaveformQuality::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -388,7 +546,7 @@ DatabaseIterator DatabaseQuery::getWaveformQuality(Seiscomp::Core::Time startTim
 	query += toString(endTime);
 	query += "'";
 
-	return getObjectIterator(query, WaveformQuality::TypeInfo());
+	return cachedObjectIterator(query, WaveformQuality::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -424,7 +582,7 @@ DatabaseIterator DatabaseQuery::getWaveformQuality(const WaveformStreamID& wavef
 	query += toString(parameter);
 	query += "'";
 
-	return getObjectIterator(query, WaveformQuality::TypeInfo());
+	return cachedObjectIterator(query, WaveformQuality::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -454,7 +612,7 @@ DatabaseIterator DatabaseQuery::getWaveformQualityDescending(const WaveformStrea
 	query += toString(parameter);
 	query += "' order by WaveformQuality._oid desc limit 10";
 
-	return getObjectIterator(query, WaveformQuality::TypeInfo());
+	return cachedObjectIterator(query, WaveformQuality::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -484,7 +642,7 @@ DatabaseIterator DatabaseQuery::getOutage(const WaveformStreamID& waveformID,
 	query += toString(waveformID.resourceURI());
 	query += "')";
 
-	return getObjectIterator(query, Outage::TypeInfo());
+	return cachedObjectIterator(query, Outage::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -514,7 +672,7 @@ DatabaseIterator DatabaseQuery::getQCLog(const WaveformStreamID& waveformID,
 	query += toString(waveformID.resourceURI());
 	query += "')";
 
-	return getObjectIterator(query, QCLog::TypeInfo());
+	return cachedObjectIterator(query, QCLog::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -536,7 +694,7 @@ DatabaseIterator DatabaseQuery::getPreferredOrigins(Seiscomp::Core::Time startTi
 	query += toString(referenceOriginID);
 	query += "'";
 
-	return getObjectIterator(query, Origin::TypeInfo());
+	return cachedObjectIterator(query, Origin::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -558,7 +716,7 @@ DatabaseIterator DatabaseQuery::getPreferredMagnitudes(Seiscomp::Core::Time star
 	query += toString(referenceMagnitudeID);
 	query += "'";
 
-	return getObjectIterator(query, Magnitude::TypeInfo());
+	return cachedObjectIterator(query, Magnitude::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -577,7 +735,7 @@ DatabaseIterator DatabaseQuery::getEvents(Seiscomp::Core::Time startTime,
 	query += toString(endTime);
 	query += "'";
 
-	return getObjectIterator(query, Event::TypeInfo());
+	return cachedObjectIterator(query, Event::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -593,7 +751,7 @@ DatabaseIterator DatabaseQuery::getOrigins(const std::string& eventID) {
 	query += toString(eventID);
 	query += "' order by Origin." + _T("creationInfo_creationTime") + " asc";
 
-	return getObjectIterator(query, Origin::TypeInfo());
+	return cachedObjectIterator(query, Origin::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -609,7 +767,7 @@ DatabaseIterator DatabaseQuery::getOriginsDescending(const std::string& eventID)
 	query += toString(eventID);
 	query += "' order by Origin." + _T("creationInfo_creationTime") + " desc";
 
-	return getObjectIterator(query, Origin::TypeInfo());
+	return cachedObjectIterator(query, Origin::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -625,7 +783,7 @@ DatabaseIterator DatabaseQuery::getFocalMechanismsDescending(const std::string&
 	query += toString(eventID);
 	query += "' order by FocalMechanism." + _T("creationInfo_creationTime") + " desc";
 
-	return getObjectIterator(query, FocalMechanism::TypeInfo());
+	return cachedObjectIterator(query, FocalMechanism::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -676,7 +834,7 @@ DatabaseIterator DatabaseQuery::getEventPicks(const std::string& eventID) {
 	query += toString(eventID);
 	query += "'";
 
-	return getObjectIterator(query, Pick::TypeInfo());
+	return cachedObjectIterator(query, Pick::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -695,7 +853,7 @@ DatabaseIterator DatabaseQuery::getEventPicksByWeight(const std::string& publicI
 	query += toString(publicID);
 	query += "'";
 
-	return getObjectIterator(query, Pick::TypeInfo());
+	return cachedObjectIterator(query, Pick::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -714,7 +872,7 @@ DatabaseIterator DatabaseQuery::getConfigModule(const std::string& name,
 	query += toString(name);
 	query += "'";
 
-	return getObjectIterator(query, ConfigModule::TypeInfo());
+	return cachedObjectIterator(query, ConfigModule::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -745,7 +903,7 @@ DatabaseIterator DatabaseQuery::getEquivalentPick(const std::string& stationCode
 	query += toString(locationCode);
 	query += "'";
 
-	return getObjectIterator(query, Pick::TypeInfo());
+	return cachedObjectIterator(query, Pick::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -761,7 +919,7 @@ DatabaseIterator DatabaseQuery::getJournal(const std::string& objectID) {
 	query += toString(objectID);
 	query += "'";
 
-	return getObjectIterator(query, JournalEntry::TypeInfo());
+	return cachedObjectIterator(query, JournalEntry::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -780,7 +938,7 @@ DatabaseIterator DatabaseQuery::getJournalAction(const std::string& objectID,
 	query += toString(objectID);
 	query += "'";
 
-	return getObjectIterator(query, JournalEntry::TypeInfo());
+	return cachedObjectIterator(query, JournalEntry::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -814,7 +972,7 @@ DatabaseIterator DatabaseQuery::getArclinkRequestByStreamCode(Seiscomp::Core::Ti
 	query += toString(locationCode);
 	query += "'";
 
-	return getObjectIterator(query, ArclinkRequest::TypeInfo());
+	return cachedObjectIterator(query, ArclinkRequest::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -830,7 +988,7 @@ DatabaseIterator DatabaseQuery::getArclinkRequestByRequestID(const std::string&
 	query += toString(requestID);
 	query += "'";
 
-	return getObjectIterator(query, ArclinkRequest::TypeInfo());
+	return cachedObjectIterator(query, ArclinkRequest::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -855,7 +1013,7 @@ DatabaseIterator DatabaseQuery::getArclinkRequestByUserID(const std::string& use
 	query += toString(type);
 	query += "'";
 
-	return getObjectIterator(query, ArclinkRequest::TypeInfo());
+	return cachedObjectIterator(query, ArclinkRequest::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -877,7 +1035,7 @@ DatabaseIterator DatabaseQuery::getArclinkRequestByTime(Seiscomp::Core::Time sta
 	query += toString(type);
 	query += "'";
 
-	return getObjectIterator(query, ArclinkRequest::TypeInfo());
+	return cachedObjectIterator(query, ArclinkRequest::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -917,7 +1075,7 @@ DatabaseIterator DatabaseQuery::getArclinkRequest(const std::string& userID,
 	query += toString(netClass);
 	query += "'";
 
-	return getObjectIterator(query, ArclinkRequest::TypeInfo());
+	return cachedObjectIterator(query, ArclinkRequest::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -960,7 +1118,7 @@ DatabaseIterator DatabaseQuery::getArclinkRequestRestricted(const std::string& u
 	query += toString(restricted);
 	query += "'";
 
-	return getObjectIterator(query, ArclinkRequest::TypeInfo());
+	return cachedObjectIterator(query, ArclinkRequest::TypeInfo());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
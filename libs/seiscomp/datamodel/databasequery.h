@@ -45,6 +45,11 @@
 #include <seiscomp/datamodel/arclinkrequestsummary.h>
 #include <seiscomp/datamodel/arclinkstatusline.h>
 #include <seiscomp/datamodel/databasereader.h>
+#include <seiscomp/datamodel/notifier.h>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
 
 
 namespace Seiscomp {
@@ -70,6 +75,37 @@ class SC_SYSTEM_CORE_API DatabaseQuery : public DatabaseReader {
 		~DatabaseQuery();
 
 
+	// ----------------------------------------------------------------------
+	//  Query cache
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Configures the cache of query results. The queries which
+		 *        return an iterator over objects keep their results in
+		 *        the cache and repeated queries do not access the database
+		 *        until the result is invalidated or expired. A result is
+		 *        read completely before the iterator is returned.
+		 * @param maxEntries The maximum number of cached results. The
+		 *                   least recently used result is dropped first.
+		 *                   0 disables the cache which is the default.
+		 * @param maxAge The maximum age of a cached result in seconds,
+		 *               0 for unlimited
+		 */
+		void setQueryCache(size_t maxEntries, double maxAge = 0);
+
+		//! Drops all cached query results
+		void clearQueryCache();
+
+		/**
+		 * @brief Drops all cached query results which read objects of the
+		 *        type of the given object or of any of its children.
+		 */
+		void invalidateQueryCache(const Object *object);
+
+		//! Drops the cached query results affected by a notifier
+		void invalidateQueryCache(const Notifier *notifier);
+
+
 	// ----------------------------------------------------------------------
 	//  Query interface
 	// ----------------------------------------------------------------------
@@ -455,6 +491,32 @@ class SC_SYSTEM_CORE_API DatabaseQuery : public DatabaseReader {
 		                                             const std::string& type,
 		                                             const std::string& netClass,
 		                                             bool restricted);
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		struct CacheEntry {
+			std::string                                      query;
+			std::shared_ptr<const DatabaseIterator::Rows>    rows;
+			Core::Time                                       created;
+		};
+
+		typedef std::list<CacheEntry> CacheEntries;
+
+		//! Returns an iterator over the cached result of a query and
+		//! runs the query if required
+		DatabaseIterator cachedObjectIterator(const std::string &query,
+		                                      const Seiscomp::Core::RTTI &classType);
+
+
+	private:
+		size_t                                                   _cacheSize{0};
+		double                                                   _cacheMaxAge{0};
+		//! Cached results, most recently used first
+		CacheEntries                                             _cache;
+		std::unordered_map<std::string, CacheEntries::iterator>  _cacheLookup;
 };
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -0,0 +1,240 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT DatabaseQueryPool
+#include <seiscomp/datamodel/databasequerypool.h>
+#include <seiscomp/logging/log.h>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseQueryPool::DatabaseQueryPool() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseQueryPool::~DatabaseQueryPool() {
+	close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseQueryPool::open(const char *uri, size_t connections) {
+	close();
+
+	if ( !connections ) {
+		connections = 1;
+	}
+
+	for ( size_t i = 0; i < connections; ++i ) {
+		IO::DatabaseInterfacePtr db = IO::DatabaseInterface::Open(uri);
+		if ( !db ) {
+			SEISCOMP_ERROR("Failed to open database connection %d of %d",
+			               static_cast<int>(i+1), static_cast<int>(connections));
+			close();
+			return false;
+		}
+
+		_queries.push_back(new DatabaseQuery(db.get()));
+		if ( _queries.back()->hasError() ) {
+			SEISCOMP_ERROR("Database connection %d of %d: %s",
+			               static_cast<int>(i+1), static_cast<int>(connections),
+			               _queries.back()->errorMsg().c_str());
+			close();
+			return false;
+		}
+	}
+
+	_closing = false;
+
+	for ( auto &query : _queries ) {
+		_threads.emplace_back(&DatabaseQueryPool::run, this, query.get());
+	}
+
+	SEISCOMP_DEBUG("Opened database query pool with %d connections",
+	               static_cast<int>(connections));
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseQueryPool::close() {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		_closing = true;
+	}
+
+	_condition.notify_all();
+
+	for ( auto &thread : _threads ) {
+		thread.join();
+	}
+
+	_threads.clear();
+
+	for ( auto &query : _queries ) {
+		if ( query->driver() ) {
+			query->driver()->disconnect();
+		}
+	}
+
+	_queries.clear();
+
+	// Tasks posted without an open connection are dropped
+	std::lock_guard<std::mutex> lk(_mutex);
+	_tasks.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseQueryPool::isOpen() const {
+	return !_threads.empty();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t DatabaseQueryPool::connections() const {
+	return _queries.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t DatabaseQueryPool::pending() const {
+	std::lock_guard<std::mutex> lk(_mutex);
+	return _tasks.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseQueryPool::post(Task task) {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		if ( _closing || _queries.empty() ) {
+			return false;
+		}
+
+		_tasks.push_back(std::move(task));
+	}
+
+	_condition.notify_one();
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::future<DatabaseQueryPool::Objects> DatabaseQueryPool::load(Query query) {
+	return submit([query](DatabaseQuery *db) mutable {
+		return collect(query, db);
+	});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseQueryPool::load(Query query, ObjectsCallback callback) {
+	return post([query, callback](DatabaseQuery *db) mutable {
+		Objects objects = collect(query, db);
+		callback(objects);
+	});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseQueryPool::Objects DatabaseQueryPool::collect(Query &query, DatabaseQuery *db) {
+	Objects objects;
+	DatabaseIterator it = query(db);
+	for ( ; *it; ++it ) {
+		objects.push_back(*it);
+	}
+	it.close();
+	return objects;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DatabaseQueryPool::run(DatabaseQuery *query) {
+	while ( true ) {
+		Task task;
+
+		{
+			std::unique_lock<std::mutex> lk(_mutex);
+			_condition.wait(lk, [this] { return _closing || !_tasks.empty(); });
+
+			// Queued tasks are run before the pool closes
+			if ( _tasks.empty() ) {
+				return;
+			}
+
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+
+		try {
+			task(query);
+		}
+		catch ( std::exception &e ) {
+			SEISCOMP_ERROR("Database query task failed: %s", e.what());
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
@@ -83,7 +83,7 @@ PublicObject* DatabaseReader::loadObject(const Seiscomp::Core::RTTI& classType,
 
 	Origin* origin = Origin::Cast(publicObject);
 	if ( origin ) {
-		load(origin);
+		bulkLoad(origin);
 		return origin;
 	}
 
@@ -220,6 +220,156 @@ PublicObject* DatabaseReader::loadObject(const Seiscomp::Core::RTTI& classType,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int DatabaseReader::bulkLoad(PublicObject *root, const BulkTables &tables) {
+	if ( !validInterface() || root == nullptr ) return 0;
+
+	OID rootOid = databaseId(root);
+	if ( !rootOid ) {
+		SEISCOMP_INFO("object with id '%s' not found in database", root->publicID().c_str());
+		return 0;
+	}
+
+	bool saveState = Notifier::IsEnabled();
+	Notifier::Disable();
+
+	// The parents of table i are selected by parentOids[i] which nests
+	// a sub query for each level below the root.
+	std::vector<std::string> parentOids(tables.size());
+	std::map<OID, PublicObject*> parents;
+	parents[rootOid] = root;
+
+	size_t count = 0;
+
+	for ( size_t i = 0; i < tables.size(); ++i ) {
+		const BulkTable &table = tables[i];
+
+		if ( table.parent < 0 )
+			parentOids[i] = Core::toString(rootOid);
+		else {
+			const char *parentTable = tables[table.parent].type->className();
+			parentOids[i] = std::string("select ") + parentTable + "._oid from " +
+			                parentTable + " where " + parentTable +
+			                "._parent_oid in (" + parentOids[table.parent] + ")";
+		}
+
+		bool isPublic = table.type->isTypeOf(PublicObject::TypeInfo());
+
+		DatabaseIterator it = getObjectsOfParents(parentOids[i], *table.type);
+		while ( *it ) {
+			Object *object = *it;
+			auto p = parents.find(it.parentOid());
+
+			if ( object->parent() != nullptr )
+				SEISCOMP_INFO("%s::add(%s) -> %s has already another parent",
+				              p != parents.end() ? p->second->className() : "?",
+				              object->className(), object->className());
+			else if ( p == parents.end() )
+				SEISCOMP_WARNING("cannot find parent with id %ld of %s",
+				                 static_cast<long>(it.parentOid()), object->className());
+			else if ( object->attachTo(p->second) ) {
+				if ( isPublic )
+					parents[it.oid()] = static_cast<PublicObject*>(object);
+				++count;
+			}
+
+			++it;
+		}
+		it.close();
+	}
+
+	Notifier::SetEnabled(saveState);
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int DatabaseReader::bulkLoad(Inventory *inventory) {
+	BulkTables tables;
+
+	auto add = [&tables](const Core::RTTI &type, int parent = -1) {
+		tables.push_back({&type, parent});
+		return static_cast<int>(tables.size()) - 1;
+	};
+
+	int stationGroup = add(StationGroup::TypeInfo());
+	add(StationReference::TypeInfo(), stationGroup);
+
+	int auxDevice = add(AuxDevice::TypeInfo());
+	add(AuxSource::TypeInfo(), auxDevice);
+
+	int sensor = add(Sensor::TypeInfo());
+	add(SensorCalibration::TypeInfo(), sensor);
+
+	int datalogger = add(Datalogger::TypeInfo());
+	add(DataloggerCalibration::TypeInfo(), datalogger);
+	add(Decimation::TypeInfo(), datalogger);
+
+	add(ResponsePAZ::TypeInfo());
+	add(ResponseFIR::TypeInfo());
+	if ( supportsVersion<0,10>() )
+		add(ResponseIIR::TypeInfo());
+	add(ResponsePolynomial::TypeInfo());
+	if ( supportsVersion<0,8>() )
+		add(ResponseFAP::TypeInfo());
+
+	bool hasComments = supportsVersion<0,10>();
+
+	int network = add(Network::TypeInfo());
+	if ( hasComments )
+		add(Comment::TypeInfo(), network);
+
+	int station = add(Station::TypeInfo(), network);
+	if ( hasComments )
+		add(Comment::TypeInfo(), station);
+
+	int sensorLocation = add(SensorLocation::TypeInfo(), station);
+	if ( hasComments )
+		add(Comment::TypeInfo(), sensorLocation);
+	add(AuxStream::TypeInfo(), sensorLocation);
+
+	int stream = add(Stream::TypeInfo(), sensorLocation);
+	if ( hasComments )
+		add(Comment::TypeInfo(), stream);
+
+	return bulkLoad(inventory, tables);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int DatabaseReader::bulkLoad(Origin *origin) {
+	BulkTables tables;
+
+	auto add = [&tables](const Core::RTTI &type, int parent = -1) {
+		tables.push_back({&type, parent});
+		return static_cast<int>(tables.size()) - 1;
+	};
+
+	add(Comment::TypeInfo());
+	add(CompositeTime::TypeInfo());
+	add(Arrival::TypeInfo());
+
+	int stationMagnitude = add(StationMagnitude::TypeInfo());
+	add(Comment::TypeInfo(), stationMagnitude);
+
+	int magnitude = add(Magnitude::TypeInfo());
+	add(Comment::TypeInfo(), magnitude);
+	add(StationMagnitudeContribution::TypeInfo(), magnitude);
+
+	return bulkLoad(origin, tables);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 EventParameters* DatabaseReader::loadEventParameters() {
 	if ( !validInterface() ) return nullptr;
@@ -1782,7 +1932,7 @@ Inventory* DatabaseReader::loadInventory() {
 
 	Inventory *inventory = new Inventory;
 
-	load(inventory);
+	bulkLoad(inventory);
 
 	SEISCOMP_DEBUG("objects in cache: %d", getCacheSize());
 	
@@ -25,6 +25,8 @@
 #include <seiscomp/datamodel/object.h>
 #include <seiscomp/datamodel/databasearchive.h>
 
+#include <vector>
+
 
 namespace Seiscomp {
 namespace DataModel {
@@ -135,6 +137,16 @@ class SC_SYSTEM_CORE_API DatabaseReader : public DatabaseArchive {
 		PublicObject* loadObject(const Seiscomp::Core::RTTI& classType,
 		                         const std::string& publicID);
 
+		/**
+		 * Loads all children and subchildren of an inventory or an origin
+		 * with one query per table instead of one query per parent object.
+		 * The objects are assigned to their parents by their database ids.
+		 * The resulting tree is equal to the one built by load().
+		 * @return The number of loaded objects
+		 */
+		int bulkLoad(Inventory*);
+		int bulkLoad(Origin*);
+
 		EventParameters* loadEventParameters();
 		int load(EventParameters*);
 		int loadPicks(EventParameters*);
@@ -258,6 +270,22 @@ class SC_SYSTEM_CORE_API DatabaseReader : public DatabaseArchive {
 		int loadDataSegments(DataExtent*);
 		int loadDataAttributeExtents(DataExtent*);
 
+
+	// ----------------------------------------------------------------------
+	//  Private interface
+	// ----------------------------------------------------------------------
+	private:
+		struct BulkTable {
+			const Seiscomp::Core::RTTI *type;
+			//! Index of the parent table or -1 if the parent is the root
+			int                         parent;
+		};
+
+		typedef std::vector<BulkTable> BulkTables;
+
+		//! Reads all tables in the given order whereas a parent table must
+		//! precede its children.
+		int bulkLoad(PublicObject *root, const BulkTables &tables);
 };
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -21,6 +21,7 @@
 #define SEISCOMP_COMPONENT DataModelDiff
 
 
+#include <seiscomp/core/strings.h>
 #include <seiscomp/datamodel/blob.h>
 #include <seiscomp/datamodel/complexarray.h>
 #include <seiscomp/datamodel/creationinfo.h>
@@ -28,7 +29,11 @@
 #include <seiscomp/datamodel/realarray.h>
 #include <seiscomp/datamodel/diff.h>
 
+#include <atomic>
+#include <exception>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 using namespace std;
 
@@ -189,6 +194,52 @@ bool compare(const Core::BaseObject *o1, const Core::BaseObject *o2,
 	return result;
 }
 
+// Creates a key of the index attributes of an object which is equal for two
+// objects if compare(o1, o2, true) returns true. Returns false if an index
+// attribute cannot be keyed.
+bool indexKey(const Core::BaseObject *o, string &key) {
+	key = o->className();
+
+	for ( size_t i = 0; i < o->meta()->propertyCount(); ++i ) {
+		const Core::MetaProperty* prop = o->meta()->property(i);
+		if ( !prop->isIndex() || prop->isArray() ) continue;
+		if ( prop->isClass() ) return false;
+
+		Core::MetaValue value;
+		try { value = prop->read(o); }
+		catch ( ... ) {
+			key += "|u";
+			continue;
+		}
+
+		if ( prop->isEnum() || prop->type() == "int" )
+			key += "|i" + Core::toString(boost::any_cast<int>(value));
+		else if ( prop->type() == "float" ) {
+			double v = boost::any_cast<double>(value);
+			// NaN never compares equal
+			if ( v != v ) return false;
+			// -0 and 0 compare equal
+			if ( v == 0 ) v = 0;
+			key += "|f";
+			key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+		}
+		else if ( prop->type() == "string" ) {
+			const string &v = boost::any_cast<const string&>(value);
+			key += "|s" + Core::toString(v.size()) + ":" + v;
+		}
+		else if ( prop->type() == "datetime" ) {
+			const Core::Time &v = boost::any_cast<const Core::Time&>(value);
+			key += "|t" + Core::toString(v.seconds()) + "." + Core::toString(v.microseconds());
+		}
+		else if ( prop->type() == "boolean" )
+			key += boost::any_cast<bool>(value) ? "|b1" : "|b0";
+		else
+			return false;
+	}
+
+	return true;
+}
+
 
 } // anonymous
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -210,6 +261,15 @@ Diff2::~Diff2() {}
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Diff2::setThreads(size_t threads) {
+	_threads = threads > 0 ? threads : 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Diff2::LogNode::write(ostream &os, int padding, int indent,
                            bool ignoreFirstPad) const {
@@ -302,57 +362,165 @@ void Diff2::diff(Object* o1, Object* o2,
 		// each element of one array must be searched among all elements
 		// of the other array. PublicObjects are identified based on their
 		// publicID, other Objects are compared by their index fields.
-		map<string, PublicObject*> o2POChilds;
-		vector<Object*> o2Childs;
-		for ( size_t i_o2 = 0; i_o2 < prop->arrayElementCount(o2); ++i_o2 ) {
-			Core::BaseObject* bo = const_cast<Core::BaseObject*>(prop->arrayObject(o2, i_o2));
-
-			PublicObject* po = PublicObject::Cast(bo);
-			if ( po )
-				o2POChilds[po->publicID()] = po;
-			else
-				o2Childs.push_back(Object::Cast(bo));
+		ChildPairs pairs;
+		matchChildren(prop, o1, o2, pairs);
+
+		const string &parentID = o1PO->publicID();
+		diffChildren(pairs, [this, &parentID](Object *c1, Object *c2, Notifiers &n, LogNode *l) {
+			diff(c1, c2, parentID, n, l);
+		}, notifiers, logNode.get());
+	}
+
+	if ( parentLogNode && logNode &&
+	     (logNode->level() == LogNode::ALL || logNode->childCount()) )
+		parentLogNode->addChild(logNode.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Diff2::matchChildren(const Core::MetaProperty *prop,
+                          Object *o1, Object *o2, ChildPairs &pairs) const {
+	map<string, PublicObject*> o2POChilds;
+	vector<Object*> o2Childs;
+	for ( size_t i_o2 = 0; i_o2 < prop->arrayElementCount(o2); ++i_o2 ) {
+		Core::BaseObject* bo = const_cast<Core::BaseObject*>(prop->arrayObject(o2, i_o2));
+
+		PublicObject* po = PublicObject::Cast(bo);
+		if ( po )
+			o2POChilds[po->publicID()] = po;
+		else
+			o2Childs.push_back(Object::Cast(bo));
+	}
+
+	// Other objects are looked up by the key of their index attributes.
+	// The candidates of a key are stored in reverse order to take the
+	// first one from the back. If an object cannot be keyed, all objects
+	// are compared one by one.
+	unordered_map<string, vector<size_t>> o2Keys;
+	vector<bool> o2Matched(o2Childs.size(), false);
+	bool keyed = true;
+	string key;
+
+	for ( size_t i = o2Childs.size(); i > 0; --i ) {
+		if ( !indexKey(o2Childs[i-1], key) ) {
+			keyed = false;
+			o2Keys.clear();
+			break;
 		}
 
-		// For each element of o1 array search counterpart in o2
-		for ( size_t i_o1 = 0; i_o1 < prop->arrayElementCount(o1); ++i_o1 ) {
-			Core::BaseObject* bo = const_cast<Core::BaseObject*>(prop->arrayObject(o1, i_o1));
-			Object *o1Child = Object::Cast(bo);
-			Object *o2Child = nullptr;
-			PublicObject *po = PublicObject::Cast(bo);
-			if ( po ) {
-				map<string, PublicObject*>::iterator it = o2POChilds.find(po->publicID());
-				if ( it != o2POChilds.end() ) {
-					o2Child = it->second;
-					o2POChilds.erase(it);
+		o2Keys[key].push_back(i-1);
+	}
+
+	// For each element of o1 array search counterpart in o2
+	for ( size_t i_o1 = 0; i_o1 < prop->arrayElementCount(o1); ++i_o1 ) {
+		Core::BaseObject* bo = const_cast<Core::BaseObject*>(prop->arrayObject(o1, i_o1));
+		Object *o1Child = Object::Cast(bo);
+		Object *o2Child = nullptr;
+		PublicObject *po = PublicObject::Cast(bo);
+		if ( po ) {
+			map<string, PublicObject*>::iterator it = o2POChilds.find(po->publicID());
+			if ( it != o2POChilds.end() ) {
+				o2Child = it->second;
+				o2POChilds.erase(it);
+			}
+		}
+		else if ( keyed && indexKey(o1Child, key) ) {
+			auto it = o2Keys.find(key);
+			if ( it != o2Keys.end() ) {
+				while ( !it->second.empty() && o2Matched[it->second.back()] )
+					it->second.pop_back();
+
+				if ( !it->second.empty() ) {
+					o2Child = o2Childs[it->second.back()];
+					o2Matched[it->second.back()] = true;
+					it->second.pop_back();
 				}
 			}
-			else {
-				for ( vector<Object*>::iterator it = o2Childs.begin();
-				      it != o2Childs.end(); ++it ) {
-					if ( compare(o1Child, *it, true) ) {
-						o2Child = *it;
-						o2Childs.erase(it);
-						break;
-					}
+		}
+		else {
+			for ( size_t i = 0; i < o2Childs.size(); ++i ) {
+				if ( !o2Matched[i] && compare(o1Child, o2Childs[i], true) ) {
+					o2Child = o2Childs[i];
+					o2Matched[i] = true;
+					break;
 				}
 			}
+		}
+
+		pairs.emplace_back(o1Child, o2Child);
+	}
+
+	// Add all elements of o2 array which have no counterpart in o1
+	for ( auto &item : o2POChilds )
+		pairs.emplace_back(nullptr, item.second);
+
+	for ( size_t i = 0; i < o2Childs.size(); ++i ) {
+		if ( !o2Matched[i] )
+			pairs.emplace_back(nullptr, o2Childs[i]);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Diff2::diffChildren(const ChildPairs &pairs, const ChildDiff &diffChild,
+                         Notifiers &notifiers, LogNode *logNode) {
+	if ( _threads < 2 || _parallel || pairs.size() < 2 ) {
+		for ( auto &pair : pairs )
+			diffChild(pair.first, pair.second, notifiers, logNode);
+		return;
+	}
 
-			diff(o1Child, o2Child, o1PO->publicID(), notifiers, logNode.get());
+	// Each pair is diffed into its own notifiers and log node which are
+	// collected in order afterwards. Children of the pairs are diffed
+	// sequentially.
+	size_t threadCount = min(_threads, pairs.size());
+	vector<Notifiers> results(pairs.size());
+	vector<LogNodePtr> logNodes(pairs.size());
+	vector<exception_ptr> errors(threadCount);
+	atomic<size_t> next(0);
+
+	auto worker = [&](size_t id) {
+		try {
+			for ( size_t i; (i = next++) < pairs.size(); ) {
+				if ( logNode )
+					logNodes[i] = new LogNode("", logNode->level());
+				diffChild(pairs[i].first, pairs[i].second, results[i], logNodes[i].get());
+			}
+		}
+		catch ( ... ) {
+			errors[id] = current_exception();
+			next = pairs.size();
 		}
+	};
+
+	_parallel = true;
+
+	vector<thread> workers;
+	for ( size_t id = 1; id < threadCount; ++id )
+		workers.emplace_back(worker, id);
+	worker(0);
+	for ( auto &t : workers )
+		t.join();
+
+	_parallel = false;
 
-		// Add all elements of o2 array which have no counterpart in o1
-		for ( map<string, PublicObject*>::iterator it = o2POChilds.begin();
-		      it != o2POChilds.end(); ++it )
-			diff(nullptr, it->second, o1PO->publicID(), notifiers, logNode.get());
-		for ( vector<Object*>::iterator it = o2Childs.begin();
-		      it != o2Childs.end(); ++it )
-			diff(nullptr, *it, o1PO->publicID(), notifiers, logNode.get());
+	for ( auto &error : errors ) {
+		if ( error ) rethrow_exception(error);
 	}
 
-	if ( parentLogNode && logNode &&
-	     (logNode->level() == LogNode::ALL || logNode->childCount()) )
-		parentLogNode->addChild(logNode.get());
+	for ( size_t i = 0; i < pairs.size(); ++i ) {
+		notifiers.insert(notifiers.end(), results[i].begin(), results[i].end());
+		if ( logNode ) {
+			for ( size_t c = 0; c < logNodes[i]->childCount(); ++c )
+				logNode->addChild(logNodes[i]->child(c));
+		}
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -615,52 +783,13 @@ void Diff3::diff(Object *o1, Object *o2,
 		// each element of one array must be searched among all elements
 		// of the other array. PublicObjects are identified based on their
 		// publicID, other Objects are compared by their index fields.
-		map<string, PublicObject*> o2POChilds;
-		vector<Object*> o2Childs;
-		for ( size_t i_o2 = 0; i_o2 < prop->arrayElementCount(o2); ++i_o2 ) {
-			Core::BaseObject* bo = const_cast<Core::BaseObject*>(prop->arrayObject(o2, i_o2));
-
-			PublicObject *po = PublicObject::Cast(bo);
-			if ( po )
-				o2POChilds[po->publicID()] = po;
-			else
-				o2Childs.push_back(Object::Cast(bo));
-		}
-
-		// For each element of o1 array search counterpart in o2
-		for ( size_t i_o1 = 0; i_o1 < prop->arrayElementCount(o1); ++i_o1 ) {
-			Core::BaseObject* bo = const_cast<Core::BaseObject*>(prop->arrayObject(o1, i_o1));
-			Object *o1Child = Object::Cast(bo);
-			Object *o2Child = nullptr;
-			PublicObject *po = PublicObject::Cast(bo);
-			if ( po ) {
-				map<string, PublicObject*>::iterator it = o2POChilds.find(po->publicID());
-				if ( it != o2POChilds.end() ) {
-					o2Child = it->second;
-					o2POChilds.erase(it);
-				}
-			}
-			else {
-				for ( vector<Object*>::iterator it = o2Childs.begin();
-				      it != o2Childs.end(); ++it ) {
-					if ( compare(o1Child, *it, true) ) {
-						o2Child = *it;
-						o2Childs.erase(it);
-						break;
-					}
-				}
-			}
-
-			diff(o1Child, o2Child, o1PO->publicID(), notifiers, logNode.get());
-		}
+		ChildPairs pairs;
+		matchChildren(prop, o1, o2, pairs);
 
-		// Add all elements of o2 array which have no counterpart in o1
-		for ( map<string, PublicObject*>::iterator it = o2POChilds.begin();
-		      it != o2POChilds.end(); ++it )
-			diff(nullptr, it->second, o1PO->publicID(), notifiers, logNode.get());
-		for ( vector<Object*>::iterator it = o2Childs.begin();
-		      it != o2Childs.end(); ++it )
-			diff(nullptr, *it, o1PO->publicID(), notifiers, logNode.get());
+		const string &parentID = o1PO->publicID();
+		diffChildren(pairs, [this, &parentID](Object *c1, Object *c2, Notifiers &n, LogNode *l) {
+			diff(c1, c2, parentID, n, l);
+		}, notifiers, logNode.get());
 	}
 
 	if ( parentLogNode && logNode &&
@@ -760,54 +889,13 @@ void Diff4::diff(Object *o1, Object *o2,
 		// each element of one array must be searched among all elements
 		// of the other array. PublicObjects are identified based on their
 		// publicID, other Objects are compared by their index fields.
-		map<string, PublicObject*> o2POChilds;
-		vector<Object*> o2Childs;
-		for ( size_t i_o2 = 0; i_o2 < prop->arrayElementCount(o2); ++i_o2 ) {
-			Core::BaseObject *bo = const_cast<Core::BaseObject*>(prop->arrayObject(o2, i_o2));
-
-			PublicObject *po = PublicObject::Cast(bo);
-			if ( po ) {
-				o2POChilds[po->publicID()] = po;
-			}
-			else {
-				o2Childs.push_back(Object::Cast(bo));
-			}
-		}
-
-		// For each element of o1 array search counterpart in o2
-		for ( size_t i_o1 = 0; i_o1 < prop->arrayElementCount(o1); ++i_o1 ) {
-			Core::BaseObject* bo = const_cast<Core::BaseObject*>(prop->arrayObject(o1, i_o1));
-			Object *o1Child = Object::Cast(bo);
-			Object *o2Child = nullptr;
-			PublicObject *po = PublicObject::Cast(bo);
-			if ( po ) {
-				auto it = o2POChilds.find(po->publicID());
-				if ( it != o2POChilds.end() ) {
-					o2Child = it->second;
-					o2POChilds.erase(it);
-				}
-			}
-			else {
-				for ( auto it = o2Childs.begin(); it != o2Childs.end(); ++it ) {
-					if ( compare(o1Child, *it, true) ) {
-						o2Child = *it;
-						o2Childs.erase(it);
-						break;
-					}
-				}
-			}
-
-			diff(o1Child, o2Child, o1PO->publicID(), notifiers, logNode.get());
-		}
+		ChildPairs pairs;
+		matchChildren(prop, o1, o2, pairs);
 
-		// Add all elements of o2 array which have no counterpart in o1
-		for ( auto it : o2POChilds ) {
-			diff(nullptr, it.second, o1PO->publicID(), notifiers, logNode.get());
-		}
-
-		for ( auto obj : o2Childs ) {
-			diff(nullptr, obj, o1PO->publicID(), notifiers, logNode.get());
-		}
+		const string &parentID = o1PO->publicID();
+		diffChildren(pairs, [this, &parentID](Object *c1, Object *c2, Notifiers &n, LogNode *l) {
+			diff(c1, c2, parentID, n, l);
+		}, notifiers, logNode.get());
 	}
 
 	if ( parentLogNode && logNode &&
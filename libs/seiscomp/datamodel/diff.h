@@ -27,6 +27,7 @@
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/object.h>
 
+#include <functional>
 #include <vector>
 #include <map>
 
@@ -81,6 +82,7 @@ class Diff2 {
 					_children.push_back(logNode);
 				}
 				inline size_t childCount() { return _children.size(); }
+				inline LogNode *child(size_t i) const { return _children[i].get(); }
 
 				inline void setMessage(const std::string &msg) { _message = msg; }
 
@@ -121,8 +123,39 @@ class Diff2 {
 		NotifierMessage *diff2Message(Object *o1, Object *o2,
 		                              const std::string &o1ParentID, LogNode *logNode = nullptr);
 
+		/**
+		 * @brief Sets the number of threads which diff the children of the
+		 *        first object with more than one child in an array, e.g.
+		 *        the networks of an inventory or the events of event
+		 *        parameters. The resulting notifiers and log nodes are the
+		 *        same as with a single thread.
+		 *
+		 * If more than one thread is used, the virtual hooks of derived
+		 * classes are called concurrently and must be thread-safe.
+		 * @param threads The number of threads, 1 by default
+		 */
+		void setThreads(size_t threads);
+		size_t threads() const { return _threads; }
+
 	protected:
+		typedef std::vector<std::pair<Object*, Object*>> ChildPairs;
+		typedef std::function<void (Object*, Object*, Notifiers&, LogNode*)> ChildDiff;
+
 		std::string o2t(const Core::BaseObject *o) const;
+
+		/**
+		 * @brief Pairs the elements of an array property of two objects.
+		 *        PublicObjects are paired by their publicID, other objects
+		 *        by their index attributes. Elements without counterpart
+		 *        are paired with nullptr.
+		 */
+		void matchChildren(const Core::MetaProperty *prop,
+		                   Object *o1, Object *o2, ChildPairs &pairs) const;
+
+		//! Diffs the child pairs in order, in parallel if enabled
+		void diffChildren(const ChildPairs &pairs, const ChildDiff &diffChild,
+		                  Notifiers &notifiers, LogNode *logNode);
+
 		void createLogNodes(LogNode *rootLogNode, const std::string &rootID,
 		                    Notifiers::const_iterator begin,
 		                    Notifiers::const_iterator end);
@@ -135,6 +168,10 @@ class Diff2 {
 		 * @return true if the object is blocked, false if should be processed.
 		 */
 		virtual bool blocked(const Core::BaseObject *o, LogNode *node, bool local);
+
+	private:
+		size_t _threads{1};
+		bool   _parallel{false};
 };
 
 
@@ -306,11 +306,7 @@ Pick* EventParameters::pick(size_t i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Pick* EventParameters::findPick(const std::string& publicID) const {
-	for ( std::vector<PickPtr>::const_iterator it = _picks.begin(); it != _picks.end(); ++it )
-		if ( (*it)->publicID() == publicID )
-			return (*it).get();
-
-	return nullptr;
+	return _picksIndex.find(_picks, publicID, publicIDOf<Pick>);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -345,6 +341,7 @@ bool EventParameters::add(Pick* pick) {
 
 	// Add the element
 	_picks.push_back(pick);
+	_picksIndex.added(_picks, publicIDOf<Pick>);
 	pick->setParent(this);
 
 	// Create the notifiers
@@ -389,6 +386,7 @@ bool EventParameters::remove(Pick* pick) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_picksIndex.removed(_picks, (*it).get(), publicIDOf<Pick>);
 	_picks.erase(it);
 
 	return true;
@@ -413,6 +411,7 @@ bool EventParameters::removePick(size_t i) {
 	_picks[i]->setParent(nullptr);
 	childRemoved(_picks[i].get());
 
+	_picksIndex.removed(_picks, _picks[i].get(), publicIDOf<Pick>);
 	_picks.erase(_picks.begin() + i);
 
 	return true;
@@ -442,11 +441,7 @@ Amplitude* EventParameters::amplitude(size_t i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Amplitude* EventParameters::findAmplitude(const std::string& publicID) const {
-	for ( std::vector<AmplitudePtr>::const_iterator it = _amplitudes.begin(); it != _amplitudes.end(); ++it )
-		if ( (*it)->publicID() == publicID )
-			return (*it).get();
-
-	return nullptr;
+	return _amplitudesIndex.find(_amplitudes, publicID, publicIDOf<Amplitude>);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -481,6 +476,7 @@ bool EventParameters::add(Amplitude* amplitude) {
 
 	// Add the element
 	_amplitudes.push_back(amplitude);
+	_amplitudesIndex.added(_amplitudes, publicIDOf<Amplitude>);
 	amplitude->setParent(this);
 
 	// Create the notifiers
@@ -525,6 +521,7 @@ bool EventParameters::remove(Amplitude* amplitude) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_amplitudesIndex.removed(_amplitudes, (*it).get(), publicIDOf<Amplitude>);
 	_amplitudes.erase(it);
 
 	return true;
@@ -549,6 +546,7 @@ bool EventParameters::removeAmplitude(size_t i) {
 	_amplitudes[i]->setParent(nullptr);
 	childRemoved(_amplitudes[i].get());
 
+	_amplitudesIndex.removed(_amplitudes, _amplitudes[i].get(), publicIDOf<Amplitude>);
 	_amplitudes.erase(_amplitudes.begin() + i);
 
 	return true;
@@ -714,11 +712,7 @@ Origin* EventParameters::origin(size_t i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Origin* EventParameters::findOrigin(const std::string& publicID) const {
-	for ( std::vector<OriginPtr>::const_iterator it = _origins.begin(); it != _origins.end(); ++it )
-		if ( (*it)->publicID() == publicID )
-			return (*it).get();
-
-	return nullptr;
+	return _originsIndex.find(_origins, publicID, publicIDOf<Origin>);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -753,6 +747,7 @@ bool EventParameters::add(Origin* origin) {
 
 	// Add the element
 	_origins.push_back(origin);
+	_originsIndex.added(_origins, publicIDOf<Origin>);
 	origin->setParent(this);
 
 	// Create the notifiers
@@ -797,6 +792,7 @@ bool EventParameters::remove(Origin* origin) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_originsIndex.removed(_origins, (*it).get(), publicIDOf<Origin>);
 	_origins.erase(it);
 
 	return true;
@@ -821,6 +817,7 @@ bool EventParameters::removeOrigin(size_t i) {
 	_origins[i]->setParent(nullptr);
 	childRemoved(_origins[i].get());
 
+	_originsIndex.removed(_origins, _origins[i].get(), publicIDOf<Origin>);
 	_origins.erase(_origins.begin() + i);
 
 	return true;
@@ -986,11 +983,7 @@ Event* EventParameters::event(size_t i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Event* EventParameters::findEvent(const std::string& publicID) const {
-	for ( std::vector<EventPtr>::const_iterator it = _events.begin(); it != _events.end(); ++it )
-		if ( (*it)->publicID() == publicID )
-			return (*it).get();
-
-	return nullptr;
+	return _eventsIndex.find(_events, publicID, publicIDOf<Event>);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1025,6 +1018,7 @@ bool EventParameters::add(Event* event) {
 
 	// Add the element
 	_events.push_back(event);
+	_eventsIndex.added(_events, publicIDOf<Event>);
 	event->setParent(this);
 
 	// Create the notifiers
@@ -1069,6 +1063,7 @@ bool EventParameters::remove(Event* event) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_eventsIndex.removed(_events, (*it).get(), publicIDOf<Event>);
 	_events.erase(it);
 
 	return true;
@@ -1093,6 +1088,7 @@ bool EventParameters::removeEvent(size_t i) {
 	_events[i]->setParent(nullptr);
 	childRemoved(_events[i].get());
 
+	_eventsIndex.removed(_events, _events[i].get(), publicIDOf<Event>);
 	_events.erase(_events.begin() + i);
 
 	return true;
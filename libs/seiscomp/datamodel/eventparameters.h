@@ -23,6 +23,7 @@
 
 
 #include <vector>
+#include <seiscomp/datamodel/childindex.h>
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/core/exceptions.h>
@@ -179,6 +180,12 @@ class SC_SYSTEM_CORE_API EventParameters : public PublicObject {
 		std::vector<FocalMechanismPtr> _focalMechanisms;
 		std::vector<EventPtr> _events;
 
+		// Indexes of the aggregations
+		ChildIndex<Pick> _picksIndex;
+		ChildIndex<Amplitude> _amplitudesIndex;
+		ChildIndex<Origin> _originsIndex;
+		ChildIndex<Event> _eventsIndex;
+
 	DECLARE_SC_CLASSFACTORY_FRIEND(EventParameters);
 };
 
@@ -66,6 +66,16 @@ Core::BaseObject *ImporterBinary::get(std::streambuf* buf) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ImporterBinary::get(std::streambuf* buf, const ObjectHandler &handler) {
+	// Binary archives are not streamed, read the whole object
+	return IO::Importer::get(buf, handler);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Core::BaseObject *ImporterVBinary::get(std::streambuf* buf) {
 	IO::VBinaryArchive ar;
@@ -87,6 +97,16 @@ Core::BaseObject *ImporterVBinary::get(std::streambuf* buf) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ImporterVBinary::get(std::streambuf* buf, const ObjectHandler &handler) {
+	// Binary archives are not streamed, read the whole object
+	return IO::Importer::get(buf, handler);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool ExporterBinary::put(std::streambuf* buf, Core::BaseObject *obj) {
 	IO::BinaryArchive ar;
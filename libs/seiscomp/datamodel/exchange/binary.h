@@ -44,6 +44,7 @@ class ImporterBinary : public IO::XML::Importer {
 	// ------------------------------------------------------------------
 	protected:
 		Core::BaseObject *get(std::streambuf* buf) override;
+		bool get(std::streambuf* buf, const ObjectHandler &handler) override;
 };
 
 
@@ -61,6 +62,7 @@ class ImporterVBinary : public IO::XML::Importer {
 	// ------------------------------------------------------------------
 	protected:
 		Core::BaseObject *get(std::streambuf* buf) override;
+		bool get(std::streambuf* buf, const ObjectHandler &handler) override;
 };
 
 
@@ -30,6 +30,7 @@
 #include <cstdlib>
 #include <map>
 #include <set>
+#include <vector>
 
 
 #define NS_QML           "http://quakeml.org/xmlns/quakeml/1.2"
@@ -78,32 +79,26 @@ std::string SMI_PREFIX = ReadSMIPrefix();
 REGISTER_EXPORTER_INTERFACE(Exporter, "qml1.2");
 REGISTER_EXPORTER_INTERFACE(RTExporter, "qml1.2rt");
 
-Amplitude *findAmplitude(EventParameters *ep, const std::string& id) {
-	for ( size_t i = 0; i < ep->amplitudeCount(); ++i )
-		if ( ep->amplitude(i)->publicID() == id )
-			return ep->amplitude(i);
-	return nullptr;
-}
-
-FocalMechanism *findFocalMechanism(EventParameters *ep, const std::string& id) {
-	for ( size_t i = 0; i < ep->focalMechanismCount(); ++i )
-		if ( ep->focalMechanism(i)->publicID() == id )
-			return ep->focalMechanism(i);
-	return nullptr;
-}
-
-Origin *findOrigin(EventParameters *ep, const std::string& id) {
-	for ( size_t i = 0; i < ep->originCount(); ++i )
-		if ( ep->origin(i)->publicID() == id )
-			return ep->origin(i);
-	return nullptr;
-}
-
-Pick *findPick(EventParameters *ep, const std::string& id) {
-	for ( size_t i = 0; i < ep->pickCount(); ++i )
-		if ( ep->pick(i)->publicID() == id )
-			return ep->pick(i);
-	return nullptr;
+// Sets the missing origin IDs of magnitudes and station magnitudes which are
+// exported as siblings of their origin. This is done once before the export
+// because events may share origins and may be serialized in parallel.
+void setOriginIDs(Core::BaseObject *obj) {
+	EventParameters *ep = EventParameters::Cast(obj);
+	if ( !ep ) return;
+
+	for ( size_t oi = 0; oi < ep->originCount(); ++oi ) {
+		Origin *origin = ep->origin(oi);
+		for ( size_t mi = 0; mi < origin->magnitudeCount(); ++mi ) {
+			Magnitude *magnitude = origin->magnitude(mi);
+			if ( magnitude->originID().empty() )
+				magnitude->setOriginID(origin->publicID());
+		}
+		for ( size_t si = 0; si < origin->stationMagnitudeCount(); ++si ) {
+			StationMagnitude *staMag = origin->stationMagnitude(si);
+			if ( staMag->originID().empty() )
+				staMag->setOriginID(origin->publicID());
+		}
+	}
 }
 
 // Local type map
@@ -238,7 +233,7 @@ struct FocalMechanismConnector : IO::XML::MemberHandler {
 		EventParameters *ep = event->eventParameters();
 		FocalMechanism *fm;
 		for ( size_t i = 0; i < event->focalMechanismReferenceCount(); ++i ) {
-			fm = findFocalMechanism(ep, event->focalMechanismReference(i)->focalMechanismID());
+			fm = ep->findFocalMechanism(event->focalMechanismReference(i)->focalMechanismID());
 			if ( fm ) {
 				output->handle(fm, tag, ns);
 			}
@@ -270,12 +265,16 @@ struct OriginConnector : IO::XML::MemberHandler {
 		Pick *pick;
 		bool foundPreferredMagnitude = event->preferredMagnitudeID().empty();
 
+		std::vector<std::string> orgIDs;
 		std::set<std::string> orgRefs;
 		std::set<std::string> pickRefs;
 
 		// Collect origin references
-		for ( size_t oi = 0; oi < event->originReferenceCount(); ++oi )
-			orgRefs.insert(event->originReference(oi)->originID());
+		for ( size_t oi = 0; oi < event->originReferenceCount(); ++oi ) {
+			const std::string &id = event->originReference(oi)->originID();
+			if ( orgRefs.insert(id).second )
+				orgIDs.push_back(id);
+		}
 
 		// Collect derived origin ids
 		for ( size_t fmi = 0; fmi < event->focalMechanismReferenceCount(); ++fmi ) {
@@ -283,71 +282,75 @@ struct OriginConnector : IO::XML::MemberHandler {
 			if ( fm ) {
 				for ( size_t mi = 0; mi < fm->momentTensorCount(); ++mi ) {
 					MomentTensor *mt = fm->momentTensor(mi);
-					if ( !mt->derivedOriginID().empty() )
-						orgRefs.insert(mt->derivedOriginID());
+					if ( !mt->derivedOriginID().empty() &&
+					     orgRefs.insert(mt->derivedOriginID()).second )
+						orgIDs.push_back(mt->derivedOriginID());
 				}
 			}
 		}
 
-		// Check all origins if they should be exported
-		for ( size_t i = 0; i < ep->originCount(); ++i ) {
-			origin = ep->origin(i);
-			if ( orgRefs.find(origin->publicID()) != orgRefs.end() ) {
-				for ( size_t mi = 0; mi < origin->magnitudeCount(); ++mi ) {
-					magnitude = origin->magnitude(mi);
-					if ( magnitude->originID().empty() )
-						magnitude->setOriginID(origin->publicID());
-					if ( event->preferredMagnitudeID() == magnitude->publicID() )
-						foundPreferredMagnitude = true;
-					output->handle(origin->magnitude(mi), "magnitude", "");
-				}
-				for ( size_t si = 0; si < origin->stationMagnitudeCount(); ++si ) {
-					staMag = origin->stationMagnitude(si);
-					if ( staMag->originID().empty() )
-						staMag->setOriginID(origin->publicID());
-					amplitude = findAmplitude(ep, staMag->amplitudeID());
-					if ( amplitude ) {
-						output->handle(amplitude, "amplitude", "");
-						// include picks referenced by amplitude
-						std::pair<std::set<std::string>::const_iterator, bool> res =
-						        pickRefs.insert(amplitude->pickID());
-						if ( res.second ) {
-							pick = findPick(ep, *res.first);
-							if ( pick ) {
-								output->handle(pick, "pick", "");
-							}
-						}
-					}
-					output->handle(staMag, "stationMagnitude", "");
-				}
-				output->handle(origin, tag, ns);
+		// Export the referenced origins. They are looked up by their ID
+		// rather than scanning all origins for each event which does not
+		// scale with large EventParameters.
+		for ( const std::string &id : orgIDs ) {
+			origin = ep->findOrigin(id);
+			if ( !origin ) continue;
 
-				// include picks referenced by origin arrivals
-				for ( size_t ai = 0; ai < origin->arrivalCount(); ++ai ) {
+			for ( size_t mi = 0; mi < origin->magnitudeCount(); ++mi ) {
+				magnitude = origin->magnitude(mi);
+				if ( event->preferredMagnitudeID() == magnitude->publicID() )
+					foundPreferredMagnitude = true;
+				output->handle(origin->magnitude(mi), "magnitude", "");
+			}
+			for ( size_t si = 0; si < origin->stationMagnitudeCount(); ++si ) {
+				staMag = origin->stationMagnitude(si);
+				amplitude = ep->findAmplitude(staMag->amplitudeID());
+				if ( amplitude ) {
+					output->handle(amplitude, "amplitude", "");
+					// include picks referenced by amplitude
 					std::pair<std::set<std::string>::const_iterator, bool> res =
-					        pickRefs.insert(origin->arrival(ai)->index().pickID);
+					        pickRefs.insert(amplitude->pickID());
 					if ( res.second ) {
-						pick = findPick(ep, *res.first);
+						pick = ep->findPick(*res.first);
 						if ( pick ) {
 							output->handle(pick, "pick", "");
 						}
 					}
 				}
+				output->handle(staMag, "stationMagnitude", "");
 			}
-			else if ( !foundPreferredMagnitude ) {
-				// Check for preferred magnitude in unassociated origins if not
-				// yet found
-				for ( size_t mi = 0; mi < origin->magnitudeCount(); ++mi ) {
-					magnitude = origin->magnitude(mi);
-					if ( event->preferredMagnitudeID() == magnitude->publicID() ) {
-						foundPreferredMagnitude = true;
-						output->handle(origin->magnitude(mi), "magnitude", "");
-						break;
+			output->handle(origin, tag, ns);
+
+			// include picks referenced by origin arrivals
+			for ( size_t ai = 0; ai < origin->arrivalCount(); ++ai ) {
+				std::pair<std::set<std::string>::const_iterator, bool> res =
+				        pickRefs.insert(origin->arrival(ai)->index().pickID);
+				if ( res.second ) {
+					pick = ep->findPick(*res.first);
+					if ( pick ) {
+						output->handle(pick, "pick", "");
 					}
 				}
 			}
 		}
 
+		// Check for preferred magnitude in unassociated origins if not yet
+		// found
+		for ( size_t i = 0; !foundPreferredMagnitude && i < ep->originCount(); ++i ) {
+			origin = ep->origin(i);
+			if ( orgRefs.find(origin->publicID()) != orgRefs.end() )
+				continue;
+
+			for ( size_t mi = 0; mi < origin->magnitudeCount(); ++mi ) {
+				magnitude = origin->magnitude(mi);
+				if ( event->preferredMagnitudeID() == magnitude->publicID() ) {
+					foundPreferredMagnitude = true;
+					output->handle(origin->magnitude(mi), "magnitude", "");
+					break;
+				}
+			}
+		}
+
 		if ( !foundPreferredMagnitude )
 			SEISCOMP_WARNING("preferred magnitude %s not found", event->preferredMagnitudeID().c_str());
 
@@ -373,16 +376,10 @@ struct RTMagnitudeConnector : IO::XML::MemberHandler {
 		for ( size_t oi = 0; oi < ep->originCount(); ++oi ) {
 			origin = ep->origin(oi);
 			for ( size_t mi = 0; mi < origin->magnitudeCount(); ++mi ) {
-				Magnitude *magnitude = origin->magnitude(mi);
-				if ( magnitude->originID().empty() )
-					magnitude->setOriginID(origin->publicID());
-				output->handle(magnitude, tag, ns);
+				output->handle(origin->magnitude(mi), tag, ns);
 			}
 			for ( size_t si = 0; si < origin->stationMagnitudeCount(); ++si ) {
-				StationMagnitude *staMag = origin->stationMagnitude(si);
-				if ( staMag->originID().empty() )
-					staMag->setOriginID(origin->publicID());
-				output->handle(staMag, "stationMagnitude", "");
+				output->handle(origin->stationMagnitude(si), "stationMagnitude", "");
 			}
 		}
 		return true;
@@ -405,7 +402,7 @@ struct RTMagnitudeReferenceConnector : IO::XML::MemberHandler {
 		EventParameters *ep = event->eventParameters();
 		Origin *origin;
 		for ( size_t oi = 0; oi < event->originReferenceCount(); ++oi ) {
-			origin = findOrigin(ep, event->originReference(oi)->originID());
+			origin = ep->findOrigin(event->originReference(oi)->originID());
 			if ( !origin ) continue;
 			for ( size_t mi = 0; mi < origin->magnitudeCount(); ++mi ) {
 				std::string v = origin->magnitude(mi)->publicID();
@@ -1439,6 +1436,17 @@ Exporter::Exporter() {
 	_defaultNsMap[std::string(NS_QML_BED)] = "";
 }
 
+bool Exporter::put(std::streambuf* buf, Core::BaseObject *obj) {
+	setOriginIDs(obj);
+	return IO::XML::Exporter::put(buf, obj);
+}
+
+bool Exporter::put(std::streambuf* buf, const IO::ExportObjectList &objects) {
+	for ( auto obj : objects )
+		setOriginIDs(obj);
+	return IO::XML::Exporter::put(buf, objects);
+}
+
 void Exporter::collectNamespaces(Core::BaseObject *obj) {
 	// Just copy the defined default namespace map to avoid expensive
 	// namespace collections
@@ -1454,6 +1462,17 @@ RTExporter::RTExporter() {
 	_defaultNsMap[std::string(NS_QML_BED_RT)] = "";
 }
 
+bool RTExporter::put(std::streambuf* buf, Core::BaseObject *obj) {
+	setOriginIDs(obj);
+	return IO::XML::Exporter::put(buf, obj);
+}
+
+bool RTExporter::put(std::streambuf* buf, const IO::ExportObjectList &objects) {
+	for ( auto obj : objects )
+		setOriginIDs(obj);
+	return IO::XML::Exporter::put(buf, objects);
+}
+
 void RTExporter::collectNamespaces(Core::BaseObject *obj) {
 	// Just copy the defined default namespace map to avoid expensive
 	// namespace collections
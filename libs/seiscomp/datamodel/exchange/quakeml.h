@@ -89,6 +89,9 @@ class Exporter : public IO::XML::Exporter {
 
 	protected:
 		void collectNamespaces(Core::BaseObject *) override;
+
+		bool put(std::streambuf* buf, Core::BaseObject *) override;
+		bool put(std::streambuf* buf, const IO::ExportObjectList &) override;
 };
 
 
@@ -98,6 +101,9 @@ class RTExporter : public IO::XML::Exporter {
 
 	protected:
 		void collectNamespaces(Core::BaseObject *) override;
+
+		bool put(std::streambuf* buf, Core::BaseObject *) override;
+		bool put(std::streambuf* buf, const IO::ExportObjectList &) override;
 };
 
 
@@ -1825,11 +1825,7 @@ Network* Inventory::network(const NetworkIndex& i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Network* Inventory::findNetwork(const std::string& publicID) const {
-	for ( std::vector<NetworkPtr>::const_iterator it = _networks.begin(); it != _networks.end(); ++it )
-		if ( (*it)->publicID() == publicID )
-			return (*it).get();
-
-	return nullptr;
+	return _networksIndex.find(_networks, publicID, publicIDOf<Network>);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1864,6 +1860,7 @@ bool Inventory::add(Network* network) {
 
 	// Add the element
 	_networks.push_back(network);
+	_networksIndex.added(_networks, publicIDOf<Network>);
 	network->setParent(this);
 
 	// Create the notifiers
@@ -1908,6 +1905,7 @@ bool Inventory::remove(Network* network) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_networksIndex.removed(_networks, (*it).get(), publicIDOf<Network>);
 	_networks.erase(it);
 
 	return true;
@@ -1932,6 +1930,7 @@ bool Inventory::removeNetwork(size_t i) {
 	_networks[i]->setParent(nullptr);
 	childRemoved(_networks[i].get());
 
+	_networksIndex.removed(_networks, _networks[i].get(), publicIDOf<Network>);
 	_networks.erase(_networks.begin() + i);
 
 	return true;
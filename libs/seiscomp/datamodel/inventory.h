@@ -33,6 +33,7 @@
 #include <seiscomp/datamodel/responsepolynomial.h>
 #include <seiscomp/datamodel/responsefap.h>
 #include <seiscomp/datamodel/network.h>
+#include <seiscomp/datamodel/childindex.h>
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/core/exceptions.h>
@@ -245,6 +246,9 @@ class SC_SYSTEM_CORE_API Inventory : public PublicObject {
 		std::vector<ResponseFAPPtr> _responseFAPs;
 		std::vector<NetworkPtr> _networks;
 
+		// Indexes of the aggregations
+		ChildIndex<Network> _networksIndex;
+
 	DECLARE_SC_CLASSFACTORY_FRIEND(Inventory);
 };
 
@@ -0,0 +1,526 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/datamodel/inventoryindex.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+namespace {
+
+
+inline std::string key(const std::string &a, const std::string &b) {
+	std::string k;
+	k.reserve(a.size() + b.size() + 1);
+	k += a;
+	k += '.';
+	k += b;
+	return k;
+}
+
+
+inline std::string key(const std::string &a, const std::string &b,
+                       const std::string &c) {
+	std::string k;
+	k.reserve(a.size() + b.size() + c.size() + 2);
+	k += a;
+	k += '.';
+	k += b;
+	k += '.';
+	k += c;
+	return k;
+}
+
+
+template <typename T>
+inline bool matchesInclusive(const T *obj, const Core::Time &time) {
+	try {
+		if ( obj->end() < time ) return false;
+	}
+	catch ( ... ) {}
+
+	return obj->start() <= time;
+}
+
+
+template <typename T>
+inline bool matchesExclusive(const T *obj, const Core::Time &time) {
+	try {
+		if ( obj->end() <= time ) return false;
+	}
+	catch ( ... ) {}
+
+	return obj->start() <= time;
+}
+
+
+// An invalid time matches all epochs
+bool matchesEpochs(const SensorLocation *loc, const Core::Time &time) {
+	if ( !time.valid() ) {
+		return true;
+	}
+
+	if ( !matchesExclusive(loc, time) ) {
+		return false;
+	}
+
+	const Station *station = loc->station();
+	if ( station && !matchesInclusive(station, time) ) {
+		return false;
+	}
+
+	const Network *network = station ? station->network() : nullptr;
+	return !network || matchesInclusive(network, time);
+}
+
+
+const double CellSize = 2.0;
+const int LatitudeCells = 90;
+const int LongitudeCells = 180;
+
+
+inline int latitudeCell(double lat) {
+	int row = static_cast<int>(floor((lat + 90) / CellSize));
+	return row < 0 ? 0 : (row >= LatitudeCells ? LatitudeCells - 1 : row);
+}
+
+
+inline int longitudeCell(double lon) {
+	int col = static_cast<int>(floor(lon / CellSize)) % LongitudeCells;
+	return col < 0 ? col + LongitudeCells : col;
+}
+
+
+bool lessDistance(const InventoryIndex::SensorLocationDistance &a,
+                  const InventoryIndex::SensorLocationDistance &b) {
+	return a.distance < b.distance;
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+InventoryIndex::InventoryIndex(const Inventory *inventory)
+: _inventory(inventory)
+, _dirty(true) {
+	Object::RegisterObserver(this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+InventoryIndex::~InventoryIndex() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void InventoryIndex::setInventory(const Inventory *inventory) {
+	std::lock_guard<std::mutex> lk(_mutex);
+	_inventory = inventory;
+	_dirty = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Inventory *InventoryIndex::inventory() const {
+	return _inventory;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void InventoryIndex::invalidate() {
+	std::lock_guard<std::mutex> lk(_mutex);
+	_dirty = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Station *InventoryIndex::getStation(const std::string &networkCode,
+                                    const std::string &stationCode,
+                                    const Core::Time &time,
+                                    InventoryError *error) const {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		if ( !_inventory ) {
+			return nullptr;
+		}
+
+		if ( _dirty ) {
+			build();
+		}
+
+		auto it = _stations.find(key(networkCode, stationCode));
+		if ( it != _stations.end() ) {
+			for ( const StationEpoch &epoch : it->second ) {
+				if ( matchesInclusive(epoch.network, time)
+				  && matchesInclusive(epoch.station, time) ) {
+					return epoch.station;
+				}
+			}
+		}
+	}
+
+	// Let the scan determine the reason
+	if ( error ) {
+		DataModel::getStation(_inventory, networkCode, stationCode, time, error);
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SensorLocation *
+InventoryIndex::getSensorLocation(const std::string &networkCode,
+                                  const std::string &stationCode,
+                                  const std::string &locationCode,
+                                  const Core::Time &time,
+                                  InventoryError *error) const {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		if ( !_inventory ) {
+			return nullptr;
+		}
+
+		if ( _dirty ) {
+			build();
+		}
+
+		auto it = _sensorLocations.find(key(networkCode, stationCode, locationCode));
+		if ( it != _sensorLocations.end() ) {
+			for ( SensorLocation *loc : it->second ) {
+				if ( matchesExclusive(loc, time) ) {
+					return loc;
+				}
+			}
+		}
+	}
+
+	if ( error ) {
+		DataModel::getSensorLocation(_inventory, networkCode, stationCode,
+		                             locationCode, time, error);
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Stream *InventoryIndex::getStream(const std::string &networkCode,
+                                  const std::string &stationCode,
+                                  const std::string &locationCode,
+                                  const std::string &channelCode,
+                                  const Core::Time &time,
+                                  InventoryError *error) const {
+	// Like getStream, only the streams of the first matching sensor
+	// location are searched
+	SensorLocation *loc = getSensorLocation(networkCode, stationCode,
+	                                        locationCode, time);
+	if ( loc ) {
+		for ( size_t i = 0; i < loc->streamCount(); ++i ) {
+			Stream *stream = loc->stream(i);
+			if ( stream->code() != channelCode ) continue;
+			if ( matchesExclusive(stream, time) ) {
+				return stream;
+			}
+		}
+	}
+
+	if ( error ) {
+		DataModel::getStream(_inventory, networkCode, stationCode,
+		                     locationCode, channelCode, time, error);
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t InventoryIndex::getSensorLocations(SensorLocationDistances &result,
+                                          double lat, double lon,
+                                          double radius,
+                                          const Core::Time &time) const {
+	result.clear();
+
+	std::lock_guard<std::mutex> lk(_mutex);
+	if ( !_inventory ) {
+		return 0;
+	}
+
+	if ( _dirty ) {
+		build();
+	}
+
+	collect(result, lat, lon, radius, time);
+	std::stable_sort(result.begin(), result.end(), lessDistance);
+
+	return result.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t InventoryIndex::getNearestSensorLocations(SensorLocationDistances &result,
+                                                 double lat, double lon,
+                                                 size_t count,
+                                                 const Core::Time &time,
+                                                 double maxDistance) const {
+	result.clear();
+	if ( !count ) {
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lk(_mutex);
+	if ( !_inventory ) {
+		return 0;
+	}
+
+	if ( _dirty ) {
+		build();
+	}
+
+	// Widen the search radius until enough sensor locations have been
+	// found. All sensor locations within the radius are collected, so
+	// the nearest ones are part of the result.
+	for ( double radius = CellSize; ; radius *= 2 ) {
+		if ( radius > maxDistance ) {
+			radius = maxDistance;
+		}
+
+		result.clear();
+		collect(result, lat, lon, radius, time);
+
+		if ( result.size() >= count || radius >= maxDistance || radius >= 180 ) {
+			break;
+		}
+	}
+
+	if ( result.size() > count ) {
+		std::partial_sort(result.begin(), result.begin() + count,
+		                  result.end(), lessDistance);
+		result.resize(count);
+	}
+	else {
+		std::stable_sort(result.begin(), result.end(), lessDistance);
+	}
+
+	return result.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void InventoryIndex::onObjectAdded(Object *, Object *newChild) {
+	if ( isIndexed(newChild) ) {
+		std::lock_guard<std::mutex> lk(_mutex);
+		_dirty = true;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void InventoryIndex::onObjectRemoved(Object *, Object *oldChild) {
+	if ( isIndexed(oldChild) ) {
+		std::lock_guard<std::mutex> lk(_mutex);
+		_dirty = true;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void InventoryIndex::onObjectModified(Object *object) {
+	if ( isIndexed(object) ) {
+		std::lock_guard<std::mutex> lk(_mutex);
+		_dirty = true;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool InventoryIndex::isIndexed(const Object *object) {
+	// Streams are not indexed but their codes and epochs are checked
+	// against the sensor locations found
+	return Network::ConstCast(object)
+	    || Station::ConstCast(object)
+	    || SensorLocation::ConstCast(object);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void InventoryIndex::build() const {
+	_stations.clear();
+	_sensorLocations.clear();
+	_positions.clear();
+	_cells.assign(LatitudeCells * LongitudeCells + 1, 0);
+	_dirty = false;
+
+	double pi180 = M_PI / 180.;
+	std::vector<Position> positions;
+	std::vector<int> positionCells;
+
+	for ( size_t i = 0; i < _inventory->networkCount(); ++i ) {
+		Network *network = _inventory->network(i);
+
+		for ( size_t j = 0; j < network->stationCount(); ++j ) {
+			Station *station = network->station(j);
+			_stations[key(network->code(), station->code())].push_back({network, station});
+
+			for ( size_t k = 0; k < station->sensorLocationCount(); ++k ) {
+				SensorLocation *loc = station->sensorLocation(k);
+				_sensorLocations[key(network->code(), station->code(), loc->code())].push_back(loc);
+
+				double lat, lon;
+				try {
+					lat = loc->latitude();
+					lon = loc->longitude();
+				}
+				catch ( ... ) {
+					continue;
+				}
+
+				if ( !std::isfinite(lat) || !std::isfinite(lon) ) {
+					continue;
+				}
+
+				double coslat = cos(lat * pi180);
+				positions.push_back({loc, coslat * cos(lon * pi180),
+				                     coslat * sin(lon * pi180), sin(lat * pi180)});
+				positionCells.push_back(latitudeCell(lat) * LongitudeCells + longitudeCell(lon));
+				++_cells[positionCells.back() + 1];
+			}
+		}
+	}
+
+	// Order the positions by their cell keeping the inventory order
+	// within each cell
+	for ( size_t i = 1; i < _cells.size(); ++i ) {
+		_cells[i] += _cells[i-1];
+	}
+
+	std::vector<size_t> next(_cells.begin(), _cells.end() - 1);
+	_positions.resize(positions.size());
+	for ( size_t i = 0; i < positions.size(); ++i ) {
+		_positions[next[positionCells[i]]++] = positions[i];
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void InventoryIndex::collect(SensorLocationDistances &result,
+                             double lat, double lon, double radius,
+                             const Core::Time &time) const {
+	if ( !(radius >= 0) ) {
+		return;
+	}
+
+	double pi180 = M_PI / 180., ip180 = 180. / M_PI;
+	double coslat = cos(lat * pi180);
+	double x = coslat * cos(lon * pi180);
+	double y = coslat * sin(lon * pi180);
+	double z = sin(lat * pi180);
+
+	int firstRow = latitudeCell(lat - radius);
+	int lastRow = latitudeCell(lat + radius);
+	int firstColumn = 0;
+	int columnCount = LongitudeCells;
+
+	// If the circle does not contain a pole its longitudes are bound
+	if ( lat - radius > -90 && lat + radius < 90 ) {
+		// Add a small margin against rounding errors
+		double dlon = asin(sin(radius * pi180) / coslat) * ip180 + 1E-6;
+		int first = static_cast<int>(floor((lon - dlon) / CellSize));
+		int last = static_cast<int>(floor((lon + dlon) / CellSize));
+		firstColumn = longitudeCell(first * CellSize);
+		columnCount = std::min(last - first + 1, LongitudeCells);
+	}
+
+	for ( int row = firstRow; row <= lastRow; ++row ) {
+		for ( int i = 0; i < columnCount; ++i ) {
+			size_t cell = row * LongitudeCells + (firstColumn + i) % LongitudeCells;
+
+			for ( size_t j = _cells[cell]; j < _cells[cell+1]; ++j ) {
+				const Position &pos = _positions[j];
+				double cosc = pos.x * x + pos.y * y + pos.z * z;
+				double dist = acos(cosc < -1.0 ? -1.0 : (cosc > 1.0 ? 1.0 : cosc)) * ip180;
+				if ( dist <= radius && matchesEpochs(pos.sensorLocation, time) ) {
+					result.push_back({pos.sensorLocation, dist});
+				}
+			}
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
@@ -0,0 +1,199 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_DATAMODEL_INVENTORYINDEX_H__
+#define SEISCOMP_DATAMODEL_INVENTORYINDEX_H__
+
+
+#include <seiscomp/datamodel/inventory.h>
+#include <seiscomp/datamodel/utils.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+DEFINE_SMARTPOINTER(InventoryIndex);
+
+/**
+ * @brief The InventoryIndex class resolves stations, sensor locations and
+ * streams of an inventory by their codes without scanning the inventory.
+ *
+ * The index maps network and station codes and additionally location
+ * codes to all matching epochs in inventory order. A lookup checks only
+ * the epochs of the requested codes and returns the same object as the
+ * corresponding function in datamodel/utils.h, e.g. getStation().
+ *
+ * Additionally the sensor locations are sorted into cells of 2x2 degrees
+ * on the sphere which allows to query all sensor locations within a
+ * distance of a point or its nearest sensor locations without computing
+ * the distance to every sensor location.
+ *
+ * The index observes all objects and is rebuilt with the next lookup
+ * after a network, station, sensor location or stream has been added,
+ * removed or updated, e.g. by applying notifiers. Lookups are thread
+ * safe as long as the inventory is not modified concurrently.
+ */
+class SC_SYSTEM_CORE_API InventoryIndex : public Observer {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct SensorLocationDistance {
+			SensorLocation *sensorLocation;
+			//! The distance in degrees
+			double          distance;
+		};
+
+		typedef std::vector<SensorLocationDistance> SensorLocationDistances;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		explicit InventoryIndex(const Inventory *inventory = nullptr);
+		~InventoryIndex() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Sets the indexed inventory which must outlive the index
+		void setInventory(const Inventory *inventory);
+		const Inventory *inventory() const;
+
+		//! Forces a rebuild with the next lookup
+		void invalidate();
+
+		//! See DataModel::getStation
+		Station *getStation(const std::string &networkCode,
+		                    const std::string &stationCode,
+		                    const Core::Time &time,
+		                    InventoryError *error = nullptr) const;
+
+		//! See DataModel::getSensorLocation
+		SensorLocation *getSensorLocation(const std::string &networkCode,
+		                                  const std::string &stationCode,
+		                                  const std::string &locationCode,
+		                                  const Core::Time &time,
+		                                  InventoryError *error = nullptr) const;
+
+		//! See DataModel::getStream
+		Stream *getStream(const std::string &networkCode,
+		                  const std::string &stationCode,
+		                  const std::string &locationCode,
+		                  const std::string &channelCode,
+		                  const Core::Time &time,
+		                  InventoryError *error = nullptr) const;
+
+		/**
+		 * @brief Returns all sensor locations within a distance of a point
+		 *        sorted by their distance.
+		 * @param result The output list which is cleared first
+		 * @param lat The latitude of the point in degrees
+		 * @param lon The longitude of the point in degrees
+		 * @param radius The maximum distance in degrees
+		 * @param time The time the sensor location epoch and the epochs of
+		 *             its station and network must cover. If the time is
+		 *             not valid then all epochs are returned.
+		 * @return The number of sensor locations found
+		 */
+		size_t getSensorLocations(SensorLocationDistances &result,
+		                          double lat, double lon, double radius,
+		                          const Core::Time &time) const;
+
+		/**
+		 * @brief Returns the nearest sensor locations of a point sorted by
+		 *        their distance. Parameters are the same as for
+		 *        getSensorLocations.
+		 * @param count The maximum number of sensor locations returned
+		 * @param maxDistance The maximum distance in degrees
+		 * @return The number of sensor locations found
+		 */
+		size_t getNearestSensorLocations(SensorLocationDistances &result,
+		                                 double lat, double lon, size_t count,
+		                                 const Core::Time &time,
+		                                 double maxDistance = 180) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Observer interface
+	// ----------------------------------------------------------------------
+	protected:
+		void onObjectAdded(Object *parent, Object *newChild) override;
+		void onObjectRemoved(Object *parent, Object *oldChild) override;
+		void onObjectModified(Object *object) override;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		static bool isIndexed(const Object *object);
+		void build() const;
+		void collect(SensorLocationDistances &result,
+		             double lat, double lon, double radius,
+		             const Core::Time &time) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct StationEpoch {
+			Network *network;
+			Station *station;
+		};
+
+		typedef std::unordered_map<std::string, std::vector<StationEpoch>> StationIndex;
+		typedef std::unordered_map<std::string, std::vector<SensorLocation*>> SensorLocationIndex;
+
+		struct Position {
+			SensorLocation *sensorLocation;
+			double          x, y, z;
+		};
+
+		const Inventory              *_inventory;
+		mutable StationIndex          _stations;
+		mutable SensorLocationIndex   _sensorLocations;
+		// The positions ordered by their cell and the offset of the first
+		// position of each cell
+		mutable std::vector<Position> _positions;
+		mutable std::vector<size_t>   _cells;
+		// Guarded by _mutex as the observer callbacks may be called from
+		// another thread than the lookups
+		mutable bool                  _dirty;
+		mutable std::mutex            _mutex;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,326 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/datamodel/journalindex.h>
+#include <seiscomp/datamodel/databasequery.h>
+
+#include <algorithm>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+namespace {
+
+
+inline Core::Time created(const JournalEntry *entry) {
+	try {
+		return entry->created();
+	}
+	catch ( ... ) {
+		return Core::Time();
+	}
+}
+
+
+inline bool olderThan(const JournalEntryPtr &a, const JournalEntryPtr &b) {
+	return created(a.get()) < created(b.get());
+}
+
+
+}
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+JournalIndex::JournalIndex(DatabaseQuery *query, const Core::TimeSpan &timeSpan)
+: _query(query)
+, _timeSpan(timeSpan) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+JournalIndex::~JournalIndex() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void JournalIndex::setQuery(DatabaseQuery *query) {
+	_query = query;
+	_index.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DatabaseQuery *JournalIndex::query() const {
+	return _query;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void JournalIndex::setTimeSpan(const Core::TimeSpan &timeSpan) {
+	_timeSpan = timeSpan;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Core::TimeSpan &JournalIndex::timeSpan() const {
+	return _timeSpan;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+JournalIndex::Item &JournalIndex::load(const std::string &objectID) {
+	auto it = _index.find(objectID);
+	if ( it != _index.end() ) {
+		it->second.lastAccess = Core::Time::UTC();
+		return it->second;
+	}
+
+	Item &item = _index[objectID];
+	item.lastAccess = Core::Time::UTC();
+
+	if ( _query ) {
+		DatabaseIterator dbit = _query->getJournal(objectID);
+		while ( dbit.get() ) {
+			JournalEntry *entry = JournalEntry::Cast(*dbit);
+			if ( entry ) {
+				item.entries.push_back(entry);
+			}
+			++dbit;
+		}
+		dbit.close();
+
+		std::stable_sort(item.entries.begin(), item.entries.end(), olderThan);
+	}
+
+	return item;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const JournalIndex::JournalEntries &
+JournalIndex::entries(const std::string &objectID) {
+	return load(objectID).entries;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+JournalIndex::JournalEntries
+JournalIndex::entries(const std::string &objectID, const std::string &action) {
+	JournalEntries result;
+
+	for ( const JournalEntryPtr &entry : load(objectID).entries ) {
+		if ( entry->action() == action ) {
+			result.push_back(entry);
+		}
+	}
+
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+JournalEntry *JournalIndex::latest(const std::string &objectID,
+                                   const std::string &action) {
+	const JournalEntries &list = load(objectID).entries;
+	for ( auto it = list.rbegin(); it != list.rend(); ++it ) {
+		if ( (*it)->action() == action ) {
+			return it->get();
+		}
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool JournalIndex::add(JournalEntry *entry) {
+	if ( !entry ) {
+		return false;
+	}
+
+	auto it = _index.find(entry->objectID());
+	if ( it == _index.end() ) {
+		// The entry is part of the journal read with the first lookup
+		if ( _query ) {
+			return false;
+		}
+
+		it = _index.insert(Index::value_type(entry->objectID(), Item())).first;
+		it->second.lastAccess = Core::Time::UTC();
+	}
+
+	JournalEntryPtr ptr = entry;
+	JournalEntries &list = it->second.entries;
+	auto pos = std::upper_bound(list.begin(), list.end(), ptr, olderThan);
+
+	// The entry might have been read from the database already. Only
+	// entries with the same creation time need to be checked.
+	Core::Time time = created(entry);
+	for ( auto prev = pos; prev != list.begin(); ) {
+		--prev;
+		if ( created(prev->get()) != time ) {
+			break;
+		}
+
+		if ( (prev->get() == entry) || (**prev == *entry) ) {
+			return false;
+		}
+	}
+
+	list.insert(pos, ptr);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool JournalIndex::remove(const JournalEntry *entry) {
+	if ( !entry ) {
+		return false;
+	}
+
+	auto it = _index.find(entry->objectID());
+	if ( it == _index.end() ) {
+		return false;
+	}
+
+	JournalEntries &list = it->second.entries;
+	for ( auto e = list.begin(); e != list.end(); ++e ) {
+		if ( (e->get() == entry) || (**e == *entry) ) {
+			list.erase(e);
+			return true;
+		}
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool JournalIndex::feed(const Notifier *notifier) {
+	if ( !notifier ) {
+		return false;
+	}
+
+	JournalEntry *entry = JournalEntry::Cast(notifier->object());
+	if ( !entry ) {
+		return false;
+	}
+
+	switch ( notifier->operation() ) {
+		case OP_ADD:
+			return add(entry);
+		case OP_REMOVE:
+			return remove(entry);
+		default:
+			break;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void JournalIndex::prune(const Core::Time &reference) {
+	Core::Time minTime = reference - _timeSpan;
+
+	for ( auto it = _index.begin(); it != _index.end(); ) {
+		if ( it->second.lastAccess < minTime ) {
+			it = _index.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool JournalIndex::contains(const std::string &objectID) const {
+	return _index.find(objectID) != _index.end();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t JournalIndex::size() const {
+	return _index.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void JournalIndex::clear() {
+	_index.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_DATAMODEL_JOURNALINDEX_H__
+#define SEISCOMP_DATAMODEL_JOURNALINDEX_H__
+
+
+#include <seiscomp/datamodel/journalentry.h>
+#include <seiscomp/datamodel/notifier.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+class DatabaseQuery;
+
+DEFINE_SMARTPOINTER(JournalIndex);
+
+/**
+ * @brief The JournalIndex class keeps the journal entries of recently
+ * accessed objects in memory.
+ *
+ * The first lookup of an object reads its journal from the database, all
+ * further lookups are served from memory. Journal entries received with
+ * notifiers are added to or removed from the indexed objects with add(),
+ * remove() or feed(). Entries of objects which have not been looked up
+ * yet are ignored if a database is configured because they are read with
+ * the first lookup anyway.
+ *
+ * The entries of an object are sorted by their creation time. Objects
+ * which have not been accessed for longer than the configured time span
+ * are dropped with prune() and will be read again from the database with
+ * the next lookup.
+ */
+class SC_SYSTEM_CORE_API JournalIndex : public Core::BaseObject {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		typedef std::vector<JournalEntryPtr> JournalEntries;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		explicit JournalIndex(DatabaseQuery *query = nullptr,
+		                      const Core::TimeSpan &timeSpan = Core::TimeSpan(86400, 0));
+		~JournalIndex() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Sets the database query used to read the journal of objects
+		//! which are not yet indexed. This clears the index.
+		void setQuery(DatabaseQuery *query);
+		DatabaseQuery *query() const;
+
+		//! Sets the time span after which unused objects are pruned
+		void setTimeSpan(const Core::TimeSpan &timeSpan);
+		const Core::TimeSpan &timeSpan() const;
+
+		//! Returns all journal entries of an object sorted by their
+		//! creation time. The returned reference is valid until the next
+		//! call of a non-const method.
+		const JournalEntries &entries(const std::string &objectID);
+
+		//! Returns all journal entries of an object with the given action
+		//! sorted by their creation time
+		JournalEntries entries(const std::string &objectID,
+		                       const std::string &action);
+
+		//! Returns the latest journal entry of an object with the given
+		//! action or nullptr
+		JournalEntry *latest(const std::string &objectID,
+		                     const std::string &action);
+
+		//! Adds a journal entry. Returns false if the entry has been
+		//! ignored.
+		bool add(JournalEntry *entry);
+
+		//! Removes a journal entry which equals the passed entry
+		bool remove(const JournalEntry *entry);
+
+		//! Adds or removes the journal entry of a notifier. Returns false
+		//! if the notifier does not carry a journal entry or has been
+		//! ignored.
+		bool feed(const Notifier *notifier);
+
+		//! Drops all objects which have not been accessed since
+		//! reference - timeSpan
+		void prune(const Core::Time &reference = Core::Time::UTC());
+
+		//! Returns whether the journal of an object is held in memory
+		bool contains(const std::string &objectID) const;
+
+		//! Returns the number of indexed objects
+		size_t size() const;
+
+		void clear();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Item {
+			JournalEntries entries;
+			Core::Time     lastAccess;
+		};
+
+		typedef std::unordered_map<std::string, Item> Index;
+
+		Item &load(const std::string &objectID);
+
+		DatabaseQuery  *_query;
+		Core::TimeSpan  _timeSpan;
+		Index           _index;
+};
+
+
+}
+}
+
+
+#endif
@@ -31,6 +31,17 @@ namespace Seiscomp {
 namespace DataModel {
 
 
+namespace {
+
+
+const std::string &stationMagnitudeContributionKey(const StationMagnitudeContribution *stationMagnitudeContribution) {
+	return stationMagnitudeContribution->stationMagnitudeID();
+}
+
+
+}
+
+
 IMPLEMENT_SC_CLASS_DERIVED(Magnitude, PublicObject, "Magnitude");
 
 
@@ -664,11 +675,7 @@ StationMagnitudeContribution* Magnitude::stationMagnitudeContribution(size_t i)
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 StationMagnitudeContribution* Magnitude::stationMagnitudeContribution(const StationMagnitudeContributionIndex& i) const {
-	for ( std::vector<StationMagnitudeContributionPtr>::const_iterator it = _stationMagnitudeContributions.begin(); it != _stationMagnitudeContributions.end(); ++it )
-		if ( i == (*it)->index() )
-			return (*it).get();
-
-	return nullptr;
+	return _stationMagnitudeContributionsIndex.find(_stationMagnitudeContributions, i.stationMagnitudeID, stationMagnitudeContributionKey);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -687,15 +694,14 @@ bool Magnitude::add(StationMagnitudeContribution* stationMagnitudeContribution)
 	}
 
 	// Duplicate index check
-	for ( auto &&elem : _stationMagnitudeContributions ) {
-		if ( elem->index() == stationMagnitudeContribution->index() ) {
-			SEISCOMP_ERROR("Magnitude::add(StationMagnitudeContribution*) -> an element with the same index has been added already");
-			return false;
-		}
+	if ( _stationMagnitudeContributionsIndex.find(_stationMagnitudeContributions, stationMagnitudeContribution->stationMagnitudeID(), stationMagnitudeContributionKey) != nullptr ) {
+		SEISCOMP_ERROR("Magnitude::add(StationMagnitudeContribution*) -> an element with the same index has been added already");
+		return false;
 	}
 
 	// Add the element
 	_stationMagnitudeContributions.push_back(stationMagnitudeContribution);
+	_stationMagnitudeContributionsIndex.added(_stationMagnitudeContributions, stationMagnitudeContributionKey);
 	stationMagnitudeContribution->setParent(this);
 
 	// Create the notifiers
@@ -740,6 +746,7 @@ bool Magnitude::remove(StationMagnitudeContribution* stationMagnitudeContributio
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_stationMagnitudeContributionsIndex.removed(_stationMagnitudeContributions, (*it).get(), stationMagnitudeContributionKey);
 	_stationMagnitudeContributions.erase(it);
 
 	return true;
@@ -764,6 +771,7 @@ bool Magnitude::removeStationMagnitudeContribution(size_t i) {
 	_stationMagnitudeContributions[i]->setParent(nullptr);
 	childRemoved(_stationMagnitudeContributions[i].get());
 
+	_stationMagnitudeContributionsIndex.removed(_stationMagnitudeContributions, _stationMagnitudeContributions[i].get(), stationMagnitudeContributionKey);
 	_stationMagnitudeContributions.erase(_stationMagnitudeContributions.begin() + i);
 
 	return true;
@@ -29,6 +29,7 @@
 #include <vector>
 #include <seiscomp/datamodel/comment.h>
 #include <seiscomp/datamodel/stationmagnitudecontribution.h>
+#include <seiscomp/datamodel/childindex.h>
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/core/exceptions.h>
@@ -248,6 +249,9 @@ class SC_SYSTEM_CORE_API Magnitude : public PublicObject {
 		std::vector<CommentPtr> _comments;
 		std::vector<StationMagnitudeContributionPtr> _stationMagnitudeContributions;
 
+		// Indexes of the aggregations
+		ChildIndex<StationMagnitudeContribution> _stationMagnitudeContributionsIndex;
+
 	DECLARE_SC_CLASSFACTORY_FRIEND(Magnitude);
 };
 
@@ -813,11 +813,7 @@ Station* Network::station(const StationIndex& i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Station* Network::findStation(const std::string& publicID) const {
-	for ( std::vector<StationPtr>::const_iterator it = _stations.begin(); it != _stations.end(); ++it )
-		if ( (*it)->publicID() == publicID )
-			return (*it).get();
-
-	return nullptr;
+	return _stationsIndex.find(_stations, publicID, publicIDOf<Station>);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -852,6 +848,7 @@ bool Network::add(Station* station) {
 
 	// Add the element
 	_stations.push_back(station);
+	_stationsIndex.added(_stations, publicIDOf<Station>);
 	station->setParent(this);
 
 	// Create the notifiers
@@ -896,6 +893,7 @@ bool Network::remove(Station* station) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_stationsIndex.removed(_stations, (*it).get(), publicIDOf<Station>);
 	_stations.erase(it);
 
 	return true;
@@ -920,6 +918,7 @@ bool Network::removeStation(size_t i) {
 	_stations[i]->setParent(nullptr);
 	childRemoved(_stations[i].get());
 
+	_stationsIndex.removed(_stations, _stations[i].get(), publicIDOf<Station>);
 	_stations.erase(_stations.begin() + i);
 
 	return true;
@@ -28,6 +28,7 @@
 #include <vector>
 #include <seiscomp/datamodel/comment.h>
 #include <seiscomp/datamodel/station.h>
+#include <seiscomp/datamodel/childindex.h>
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/core/exceptions.h>
@@ -290,6 +291,9 @@ class SC_SYSTEM_CORE_API Network : public PublicObject {
 		std::vector<CommentPtr> _comments;
 		std::vector<StationPtr> _stations;
 
+		// Indexes of the aggregations
+		ChildIndex<Station> _stationsIndex;
+
 	DECLARE_SC_CLASSFACTORY_FRIEND(Network);
 };
 
@@ -24,6 +24,7 @@
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/datamodel/metadata.h>
+#include <algorithm>
 #include <string>
 
 
@@ -109,8 +110,12 @@ IMPLEMENT_METAOBJECT(Notifier)
 
 IMPLEMENT_MESSAGE_FOR(Notifier, NotifierMessage, "notifier_message");
 Notifier::Pool Notifier::_notifiers;
+Notifier::ObjectIndex Notifier::_objectIndex;
+Notifier::UpdateIndex Notifier::_pendingUpdates;
 boost::thread_specific_ptr<bool> Notifier::_lock;
 bool Notifier::_checkOnCreate = true;
+double Notifier::_coalescingWindow = 0;
+Core::Time Notifier::_firstQueued;
 
 
 Notifier::Notifier()
@@ -159,32 +164,58 @@ Notifier* Notifier::Create(const std::string& parentId,
 	NotifierPtr notifier = new Notifier(parentId, op, object);
 
 	if ( _checkOnCreate ) {
-		PoolIterator it = _notifiers.begin();
-		for ( ; it != _notifiers.end(); ++it ) {
-			CompareResult res = (*it)->cmp(notifier.get());
-			// If there is already an equal notifier stored, discard the
-			// current one
-			if ( res == CR_EQUAL ) {
-				SEISCOMP_DEBUG("equal notifiers found => discarding the given (%s(%s, %s), %s(%s, %s))",
-				               (*it)->parentID().c_str(),
-				               (*it)->operation().toString(),
-				               (*it)->object()->className(),
-				               notifier->parentID().c_str(),
-				               notifier->operation().toString(),
-				               notifier->object()->className());
-				return nullptr;
+		// Only notifiers of the same object can be equal or opposite
+		ObjectIndex::iterator entry = _objectIndex.find(object);
+		if ( entry != _objectIndex.end() ) {
+			for ( PoolIterator it : entry->second ) {
+				CompareResult res = (*it)->cmp(notifier.get());
+				// If there is already an equal notifier stored, discard the
+				// current one
+				if ( res == CR_EQUAL ) {
+					SEISCOMP_DEBUG("equal notifiers found => discarding the given (%s(%s, %s), %s(%s, %s))",
+					               (*it)->parentID().c_str(),
+					               (*it)->operation().toString(),
+					               (*it)->object()->className(),
+					               notifier->parentID().c_str(),
+					               notifier->operation().toString(),
+					               notifier->object()->className());
+					return nullptr;
+				}
+				// If the notifier neutralize each other, remove the stored
+				// and discard the current one
+				else if ( res == CR_OPPOSITE ) {
+					SEISCOMP_DEBUG("opposite notifier found => removing the stored one");
+					Erase(it);
+					return nullptr;
+				}
+				// An update of an object which is removed afterwards is
+				// obsolete
+				else if ( res == CR_OVERRIDE && op == OP_REMOVE ) {
+					SEISCOMP_DEBUG("removal of updated object => removing the stored update");
+					Erase(it);
+					break;
+				}
 			}
-			// If the notifier neutralize each other, remove the stored
-			// and discard the current one
-			else if ( res == CR_OPPOSITE ) {
-				SEISCOMP_DEBUG("opposite notifier found => removing the stored one");
-				_notifiers.erase(it);
+		}
+		else if ( op == OP_UPDATE ) {
+			// Merge the update of another instance with the same publicID
+			// into the pooled update which keeps its position
+			PublicObject *po = PublicObject::Cast(object);
+			UpdateIndex::iterator pending = po ? _pendingUpdates.find(po->publicID()) : _pendingUpdates.end();
+			if ( pending != _pendingUpdates.end()
+			  && (*pending->second)->parentID() == parentId ) {
+				PoolIterator it = pending->second;
+				SEISCOMP_DEBUG("pending update of %s found => replacing its object",
+				               po->publicID().c_str());
+				RemoveFromIndex(it);
+				(*it)->_object = object;
+				AddToIndex(it);
 				return nullptr;
 			}
 		}
 	}
 
-	_notifiers.push_back(notifier);
+	Insert(notifier.get());
 	return notifier.get();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -210,20 +241,31 @@ Notifier* Notifier::Create(PublicObject* parent,
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 NotifierMessage* Notifier::GetMessage(bool allNotifier) {
+	if ( !IsDue() )
+		return nullptr;
+
+	return Flush(allNotifier);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+NotifierMessage* Notifier::Flush(bool allNotifier) {
 	if ( _notifiers.empty() )
 		return nullptr;
 
 	NotifierMessage* msg = new NotifierMessage;
-	PoolIterator it = _notifiers.begin();
 
 	if ( allNotifier ) {
-		for ( ; it != _notifiers.end(); ++it )
+		for ( PoolIterator it = _notifiers.begin(); it != _notifiers.end(); ++it )
 			msg->attach((*it).get());
-		_notifiers.clear();
+		Clear();
 	}
 	else {
-		msg->attach((*it).get());
-		_notifiers.erase(it);
+		msg->attach(_notifiers.front().get());
+		Erase(_notifiers.begin());
 	}
 
 	return msg;
@@ -233,6 +275,103 @@ NotifierMessage* Notifier::GetMessage(bool allNotifier) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Notifier::IsDue() {
+	if ( _notifiers.empty() )
+		return false;
+
+	if ( _coalescingWindow <= 0 )
+		return true;
+
+	return (double)(Core::Time::GMT() - _firstQueued) >= _coalescingWindow;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Notifier::SetCoalescingWindow(double seconds) {
+	_coalescingWindow = seconds;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double Notifier::CoalescingWindow() {
+	return _coalescingWindow;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Notifier::Insert(Notifier *notifier) {
+	if ( _notifiers.empty() )
+		_firstQueued = Core::Time::GMT();
+
+	_notifiers.push_back(notifier);
+	AddToIndex(--_notifiers.end());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Notifier::Erase(PoolIterator it) {
+	RemoveFromIndex(it);
+	_notifiers.erase(it);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Notifier::AddToIndex(PoolIterator it) {
+	const Notifier *n = it->get();
+	_objectIndex[n->object()].push_back(it);
+
+	if ( n->operation() == OP_UPDATE ) {
+		const PublicObject *po = PublicObject::ConstCast(n->object());
+		if ( po ) _pendingUpdates[po->publicID()] = it;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Notifier::RemoveFromIndex(PoolIterator it) {
+	const Notifier *n = it->get();
+
+	ObjectIndex::iterator entry = _objectIndex.find(n->object());
+	if ( entry != _objectIndex.end() ) {
+		std::vector<PoolIterator> &its = entry->second;
+		its.erase(std::remove(its.begin(), its.end(), it), its.end());
+		if ( its.empty() )
+			_objectIndex.erase(entry);
+	}
+
+	if ( n->operation() == OP_UPDATE ) {
+		const PublicObject *po = PublicObject::ConstCast(n->object());
+		if ( po ) {
+			UpdateIndex::iterator pending = _pendingUpdates.find(po->publicID());
+			if ( pending != _pendingUpdates.end() && pending->second == it )
+				_pendingUpdates.erase(pending);
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t Notifier::Size() {
 	return _notifiers.size();
@@ -245,6 +384,8 @@ size_t Notifier::Size() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Notifier::Clear() {
 	_notifiers.clear();
+	_objectIndex.clear();
+	_pendingUpdates.clear();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
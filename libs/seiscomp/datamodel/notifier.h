@@ -28,6 +28,8 @@
 #include <seiscomp/core/genericmessage.h>
 #include <boost/thread/tss.hpp>
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -64,6 +66,11 @@ class SC_SYSTEM_CORE_API Notifier : public Seiscomp::Core::BaseObject {
 		typedef Pool::iterator PoolIterator;
 		typedef Pool::const_iterator PoolConstIterator;
 
+		//! Pooled notifiers per object for checking new notifiers
+		typedef std::unordered_map<const Object*, std::vector<PoolIterator>> ObjectIndex;
+		//! Pooled updates per publicID
+		typedef std::unordered_map<std::string, PoolIterator> UpdateIndex;
+
 
 	// ----------------------------------------------------------------------
 	//  Xstruction
@@ -112,6 +119,26 @@ class SC_SYSTEM_CORE_API Notifier : public Seiscomp::Core::BaseObject {
 		//! Returns the current 'check' state
 		static bool IsCheckEnabled();
 
+		/**
+		 * Sets a time window during which notifiers are collected in
+		 * the pool before GetMessage() returns them. Within the window
+		 * repeated updates of an object or of objects with the same
+		 * publicID are merged into one and additions which are removed
+		 * again cancel out if checking is enabled. The caller must call
+		 * GetMessage() regularly to send the collected notifiers.
+		 * @param seconds The window length. 0 disables the window which
+		 *                is the default.
+		 */
+		static void SetCoalescingWindow(double seconds);
+
+		//! Returns the coalescing window in seconds
+		static double CoalescingWindow();
+
+		//! Returns whether the pooled notifiers are due to be sent, that
+		//! is the pool is not empty and the coalescing window of the
+		//! oldest notifier has elapsed.
+		static bool IsDue();
+
 
 		/**
 		 * Returns a message holding all notifications since the
@@ -126,6 +153,12 @@ class SC_SYSTEM_CORE_API Notifier : public Seiscomp::Core::BaseObject {
 		 */
 		static NotifierMessage* GetMessage(bool allNotifier = true);
 
+		/**
+		 * Same as GetMessage() but returns the notifiers regardless of
+		 * the coalescing window, e.g. before shutting down.
+		 */
+		static NotifierMessage* Flush(bool allNotifier = true);
+
 		//! Returns the size of the notifier objects currently stored.
 		static size_t Size();
 
@@ -204,6 +237,17 @@ class SC_SYSTEM_CORE_API Notifier : public Seiscomp::Core::BaseObject {
 	// ----------------------------------------------------------------------
 	//  Implementation
 	// ----------------------------------------------------------------------
+	private:
+		//! Appends a notifier to the pool and indexes it
+		static void Insert(Notifier *notifier);
+
+		//! Removes a notifier from the pool and the indexes
+		static void Erase(PoolIterator it);
+
+		static void AddToIndex(PoolIterator it);
+		static void RemoveFromIndex(PoolIterator it);
+
+
 	private:
 		std::string _parentID;
 		Operation _operation;
@@ -211,7 +255,11 @@ class SC_SYSTEM_CORE_API Notifier : public Seiscomp::Core::BaseObject {
 
 		static boost::thread_specific_ptr<bool> _lock;
 		static Pool _notifiers;
+		static ObjectIndex _objectIndex;
+		static UpdateIndex _pendingUpdates;
 		static bool _checkOnCreate;
+		static double _coalescingWindow;
+		static Core::Time _firstQueued;
 
 	DECLARE_SC_CLASSFACTORY_FRIEND(Notifier);
 };
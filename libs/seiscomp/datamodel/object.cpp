@@ -22,6 +22,7 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/datamodel/object.h>
 #include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/objectarena.h>
 
 
 namespace Seiscomp {
@@ -59,6 +60,24 @@ Object::~Object() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void *Object::operator new(size_t size) {
+	return ObjectArena::Allocate(size);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Object::operator delete(void *ptr) {
+	ObjectArena::Release(ptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject* Object::parent() const {
 	return _parent;
@@ -175,6 +175,11 @@ class SC_SYSTEM_CORE_API Object : public Core::BaseObject {
 		//! Destructor
 		virtual ~Object() override;
 
+		//! Objects are placed into the active ObjectArena of the current
+		//! thread, if any
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr);
+
 
 	// ------------------------------------------------------------------
 	//  Interface
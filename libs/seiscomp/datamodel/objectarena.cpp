@@ -0,0 +1,199 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/datamodel/objectarena.h>
+
+#include <algorithm>
+#include <new>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+namespace {
+
+
+// Prepended to each object to find the owning arena on release. Objects
+// which are not allocated in an arena carry a null pointer.
+struct alignas(std::max_align_t) Header {
+	ObjectArena *arena;
+};
+
+
+thread_local ObjectArena *currentArena = nullptr;
+
+
+inline size_t aligned(size_t size) {
+	const size_t alignment = alignof(std::max_align_t);
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ObjectArena::Scope::Scope(size_t chunkSize)
+: _arena(new ObjectArena(chunkSize))
+, _previous(currentArena) {
+	currentArena = _arena;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ObjectArena::Scope::~Scope() {
+	currentArena = _previous;
+	_arena->_active = false;
+	_arena->unref();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ObjectArena::ObjectArena(size_t chunkSize)
+: _chunkSize(aligned(std::max(chunkSize, size_t(4096)))) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ObjectArena::~ObjectArena() {
+	for ( char *chunk : _chunks )
+		::operator delete(chunk);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const ObjectArena *ObjectArena::Current() {
+	return currentArena;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void *ObjectArena::Allocate(size_t size) {
+	size = sizeof(Header) + aligned(size);
+
+	Header *header;
+	if ( currentArena ) {
+		header = static_cast<Header*>(currentArena->allocate(size));
+		header->arena = currentArena;
+	}
+	else {
+		header = static_cast<Header*>(::operator new(size));
+		header->arena = nullptr;
+	}
+
+	return header + 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ObjectArena::Release(void *ptr) {
+	if ( !ptr ) return;
+
+	Header *header = static_cast<Header*>(ptr) - 1;
+	if ( header->arena )
+		header->arena->unref();
+	else
+		::operator delete(header);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t ObjectArena::objectCount() const {
+	return _references - (_active ? 1 : 0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t ObjectArena::capacity() const {
+	return _capacity;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void *ObjectArena::allocate(size_t size) {
+	// Allocation only happens in the thread of the scope, releases can
+	// happen in any thread
+	++_references;
+
+	// Large objects get a chunk of their own to not waste the remaining
+	// space of the current chunk
+	if ( size > _chunkSize / 8 ) {
+		char *chunk = static_cast<char*>(::operator new(size));
+		_chunks.push_back(chunk);
+		_capacity += size;
+		return chunk;
+	}
+
+	if ( static_cast<size_t>(_end - _pos) < size ) {
+		_pos = static_cast<char*>(::operator new(_chunkSize));
+		_end = _pos + _chunkSize;
+		_chunks.push_back(_pos);
+		_capacity += _chunkSize;
+	}
+
+	void *ptr = _pos;
+	_pos += size;
+	return ptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ObjectArena::unref() {
+	if ( --_references == 0 )
+		delete this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
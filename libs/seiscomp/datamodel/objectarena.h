@@ -0,0 +1,152 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_DATAMODEL_OBJECTARENA_H
+#define SEISCOMP_DATAMODEL_OBJECTARENA_H
+
+
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+/**
+ * @brief Monotonic memory arena for bulk loaded data model objects.
+ *
+ * Loading a large inventory or event parameters document creates
+ * millions of small objects which are allocated and released one by one.
+ * While an arena scope is active in a thread, all data model objects
+ * created in this thread are placed consecutively into large chunks
+ * owned by the arena. Releasing an object does not return its memory,
+ * the chunks are released at once when the last object of the arena
+ * has been destroyed. Objects may outlive the scope and may be released
+ * in any thread.
+ *
+ * Usage:
+ * \code
+ * InventoryPtr inv;
+ * {
+ *     DataModel::ObjectArena::Scope arena;
+ *     IO::XMLArchive ar;
+ *     if ( ar.open(filename) ) ar >> inv;
+ * }
+ * \endcode
+ *
+ * The arena is meant for document loads where all objects share the
+ * lifetime of the root object. An object which is kept after the root
+ * has been released keeps all chunks of its arena alive. Only the
+ * objects itself are placed into the arena, not the memory allocated
+ * by their members, e.g. long strings and child vectors.
+ */
+class SC_SYSTEM_CORE_API ObjectArena {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Activates a new arena for the current thread during its
+		 *        lifetime. Scopes can be nested, the previous arena is
+		 *        activated again when the scope is left.
+		 */
+		class SC_SYSTEM_CORE_API Scope {
+			public:
+				explicit Scope(size_t chunkSize = 1 << 16);
+				~Scope();
+
+				Scope(const Scope &) = delete;
+				Scope &operator=(const Scope &) = delete;
+
+			public:
+				//! The arena of this scope
+				const ObjectArena *arena() const { return _arena; }
+
+			private:
+				ObjectArena *_arena;
+				ObjectArena *_previous;
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	private:
+		explicit ObjectArena(size_t chunkSize);
+		~ObjectArena();
+
+		ObjectArena(const ObjectArena &) = delete;
+		ObjectArena &operator=(const ObjectArena &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the arena of the current thread or nullptr
+		static const ObjectArena *Current();
+
+		//! Allocates the memory of an object, used by Object::operator new
+		static void *Allocate(size_t size);
+
+		//! Releases the memory of an object, used by Object::operator delete
+		static void Release(void *ptr);
+
+		//! Returns the number of objects allocated in the arena which are
+		//! still alive
+		size_t objectCount() const;
+
+		//! Returns the number of bytes reserved by the chunks
+		size_t capacity() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private interface
+	// ----------------------------------------------------------------------
+	private:
+		void *allocate(size_t size);
+		void unref();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		size_t              _chunkSize;
+		std::vector<char*>  _chunks;
+		char               *_pos{nullptr};
+		char               *_end{nullptr};
+		size_t              _capacity{0};
+		// Number of living objects plus one as long as the scope is active
+		std::atomic<size_t> _references{1};
+		std::atomic<bool>   _active{true};
+};
+
+
+}
+}
+
+
+#endif
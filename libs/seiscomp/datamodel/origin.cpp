@@ -34,6 +34,17 @@ namespace Seiscomp {
 namespace DataModel {
 
 
+namespace {
+
+
+const std::string &arrivalKey(const Arrival *arrival) {
+	return arrival->pickID();
+}
+
+
+}
+
+
 IMPLEMENT_SC_CLASS_DERIVED(Origin, PublicObject, "Origin");
 
 
@@ -1068,11 +1079,7 @@ Arrival* Origin::arrival(size_t i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Arrival* Origin::arrival(const ArrivalIndex& i) const {
-	for ( std::vector<ArrivalPtr>::const_iterator it = _arrivals.begin(); it != _arrivals.end(); ++it )
-		if ( i == (*it)->index() )
-			return (*it).get();
-
-	return nullptr;
+	return _arrivalsIndex.find(_arrivals, i.pickID, arrivalKey);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1091,15 +1098,14 @@ bool Origin::add(Arrival* arrival) {
 	}
 
 	// Duplicate index check
-	for ( auto &&elem : _arrivals ) {
-		if ( elem->index() == arrival->index() ) {
-			SEISCOMP_ERROR("Origin::add(Arrival*) -> an element with the same index has been added already");
-			return false;
-		}
+	if ( _arrivalsIndex.find(_arrivals, arrival->pickID(), arrivalKey) != nullptr ) {
+		SEISCOMP_ERROR("Origin::add(Arrival*) -> an element with the same index has been added already");
+		return false;
 	}
 
 	// Add the element
 	_arrivals.push_back(arrival);
+	_arrivalsIndex.added(_arrivals, arrivalKey);
 	arrival->setParent(this);
 
 	// Create the notifiers
@@ -1144,6 +1150,7 @@ bool Origin::remove(Arrival* arrival) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_arrivalsIndex.removed(_arrivals, (*it).get(), arrivalKey);
 	_arrivals.erase(it);
 
 	return true;
@@ -1168,6 +1175,7 @@ bool Origin::removeArrival(size_t i) {
 	_arrivals[i]->setParent(nullptr);
 	childRemoved(_arrivals[i].get());
 
+	_arrivalsIndex.removed(_arrivals, _arrivals[i].get(), arrivalKey);
 	_arrivals.erase(_arrivals.begin() + i);
 
 	return true;
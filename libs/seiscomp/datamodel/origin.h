@@ -32,6 +32,7 @@
 #include <vector>
 #include <seiscomp/datamodel/comment.h>
 #include <seiscomp/datamodel/arrival.h>
+#include <seiscomp/datamodel/childindex.h>
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/core/exceptions.h>
@@ -327,6 +328,9 @@ class SC_SYSTEM_CORE_API Origin : public PublicObject {
 		std::vector<StationMagnitudePtr> _stationMagnitudes;
 		std::vector<MagnitudePtr> _magnitudes;
 
+		// Indexes of the aggregations
+		ChildIndex<Arrival> _arrivalsIndex;
+
 	DECLARE_SC_CLASSFACTORY_FRIEND(Origin);
 };
 
@@ -25,12 +25,40 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/utils/replace.h>
+
+#include <atomic>
+#include <functional>
 #include <mutex>
 
 
 namespace {
 
-std::mutex cacheMutex;
+
+using Seiscomp::DataModel::PublicObject;
+
+
+/**
+ * The registry is split into shards selected by the hash of the publicID.
+ * Threads which create or destroy objects concurrently only contend if
+ * their objects fall into the same shard.
+ */
+const size_t ShardCount = 64;
+
+struct alignas(64) Shard {
+	std::mutex                    mutex;
+	PublicObject::PublicObjectMap objects;
+};
+
+Shard shards[ShardCount];
+std::atomic<size_t> objectCount(0);
+
+
+inline Shard &shard(const std::string &publicID) {
+	size_t hash = std::hash<std::string>()(publicID);
+	// Mix the high bits in, the low bits select the bucket of the map
+	return shards[(hash ^ (hash >> 17)) % ShardCount];
+}
+
 
 }
 
@@ -81,7 +109,6 @@ IMPLEMENT_SC_ABSTRACT_CLASS_DERIVED(PublicObject,
                                     Object,
                                     "PublicObject");
 
-PublicObject::PublicObjectMap PublicObject::_publicObjects;
 bool PublicObject::_generateIds = false;
 std::string PublicObject::_idPattern = "@classname@/@time/%Y%m%d%H%M%S.%f@.@id@";
 unsigned long PublicObject::_publicObjectId = 0;
@@ -159,11 +186,11 @@ bool PublicObject::registerMe() {
 
 	if ( _publicID.empty() ) return false;
 
-	std::lock_guard<std::mutex> lk(cacheMutex);
+	Shard &s = shard(_publicID);
+	std::lock_guard<std::mutex> lk(s.mutex);
 
-	PublicObjectMap::iterator it = _publicObjects.find(_publicID);
-	if ( it == _publicObjects.end() ) {
-		_publicObjects[_publicID] = this;
+	if ( s.objects.emplace(_publicID, this).second ) {
+		++objectCount;
 		_registered = true;
 		return true;
 	}
@@ -183,11 +210,13 @@ bool PublicObject::deregisterMe() {
 	if ( _publicID.empty() || !_registered )
 		return false;
 
-	std::lock_guard<std::mutex> lk(cacheMutex);
+	Shard &s = shard(_publicID);
+	std::lock_guard<std::mutex> lk(s.mutex);
 
-	PublicObjectMap::iterator it = _publicObjects.find(_publicID);
-	if ( it != _publicObjects.end() ) {
-		_publicObjects.erase(it);
+	PublicObjectMap::iterator it = s.objects.find(_publicID);
+	if ( it != s.objects.end() ) {
+		s.objects.erase(it);
+		--objectCount;
 		_registered = false;
 		return true;
 	}
@@ -239,8 +268,11 @@ bool PublicObject::validId() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject* PublicObject::Find(const std::string& publicID) {
-	PublicObjectMap::iterator it = _publicObjects.find(publicID);
-	if ( it == _publicObjects.end() ) return nullptr;
+	Shard &s = shard(publicID);
+	std::lock_guard<std::mutex> lk(s.mutex);
+
+	PublicObjectMap::iterator it = s.objects.find(publicID);
+	if ( it == s.objects.end() ) return nullptr;
 	return (*it).second;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -250,7 +282,7 @@ PublicObject* PublicObject::Find(const std::string& publicID) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t PublicObject::ObjectCount() {
-	return _publicObjects.size();
+	return objectCount;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -259,7 +291,7 @@ size_t PublicObject::ObjectCount() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject::Iterator PublicObject::Begin() {
-	return _publicObjects.begin();
+	return Iterator(0);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -268,7 +300,66 @@ PublicObject::Iterator PublicObject::Begin() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject::Iterator PublicObject::End() {
-	return _publicObjects.end();
+	return Iterator();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject::Iterator::Iterator(size_t shard)
+: _shard(shard), _it(shards[shard].objects.begin()) {
+	skipEmpty();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PublicObject::Iterator::skipEmpty() {
+	while ( _it == shards[_shard].objects.end() ) {
+		if ( ++_shard == ShardCount ) {
+			*this = Iterator();
+			return;
+		}
+
+		_it = shards[_shard].objects.begin();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject::Iterator &PublicObject::Iterator::operator++() {
+	++_it;
+	skipEmpty();
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject::Iterator PublicObject::Iterator::operator++(int) {
+	Iterator tmp(*this);
+	++*this;
+	return tmp;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PublicObject::Iterator::operator==(const Iterator &other) const {
+	if ( _shard != other._shard ) return false;
+	// All end iterators are equal
+	return _shard == size_t(-1) || _it == other._it;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
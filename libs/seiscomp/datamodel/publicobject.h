@@ -25,8 +25,9 @@
 
 #include <seiscomp/datamodel/object.h>
 #include <boost/thread/tss.hpp>
+#include <iterator>
 #include <string>
-#include <map>
+#include <unordered_map>
 
 
 namespace Seiscomp {
@@ -46,8 +47,43 @@ class SC_SYSTEM_CORE_API PublicObject : public Object {
 	//  Public types
 	// ------------------------------------------------------------------
 	public:
-		typedef std::map<std::string, PublicObject*> PublicObjectMap;
-		typedef PublicObjectMap::const_iterator Iterator;
+		//! The registered objects are distributed over several maps
+		//! by the hash of their publicID, each guarded by its own lock.
+		typedef std::unordered_map<std::string, PublicObject*> PublicObjectMap;
+
+		//! Iterates over all registered objects in unspecified order.
+		//! Registering or deregistering objects invalidates iterators.
+		class SC_SYSTEM_CORE_API Iterator {
+			public:
+				typedef std::forward_iterator_tag   iterator_category;
+				typedef PublicObjectMap::value_type value_type;
+				typedef std::ptrdiff_t              difference_type;
+				typedef const value_type           *pointer;
+				typedef const value_type           &reference;
+
+			public:
+				Iterator() = default;
+
+			public:
+				reference operator*() const { return *_it; }
+				pointer operator->() const { return &*_it; }
+
+				Iterator &operator++();
+				Iterator operator++(int);
+
+				bool operator==(const Iterator &other) const;
+				bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+			private:
+				explicit Iterator(size_t shard);
+				void skipEmpty();
+
+			private:
+				size_t                          _shard{size_t(-1)};
+				PublicObjectMap::const_iterator _it;
+
+			friend class PublicObject;
+		};
 
 
 	// ------------------------------------------------------------------
@@ -142,7 +178,8 @@ class SC_SYSTEM_CORE_API PublicObject : public Object {
 
 		/**
 		 * Returns an iterator to the first element of
-		 * the static PublicObject registration map
+		 * the static PublicObject registration map. Iterating is not
+		 * thread-safe.
 		 */
 		static Iterator Begin();
 
@@ -230,8 +267,6 @@ class SC_SYSTEM_CORE_API PublicObject : public Object {
 		std::string _publicID;
 		bool _registered;
 
-		static PublicObjectMap _publicObjects;
-
 		static bool _generateIds;
 		static std::string _idPattern;
 		static unsigned long _publicObjectId;
@@ -25,6 +25,7 @@
 #include <seiscomp/datamodel/databasearchive.h>
 
 #include <cassert>
+#include <unordered_set>
 
 
 namespace Seiscomp {
@@ -313,6 +314,36 @@ PublicObject *PublicObjectCache::find(const Seiscomp::Core::RTTI &classType,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t PublicObjectCache::prefetch(const Core::RTTI &classType,
+                                   const std::vector<std::string> &publicIDs) {
+	std::unordered_set<std::string> seen;
+	std::vector<std::string> missing;
+
+	for ( const auto &publicID : publicIDs ) {
+		if ( !seen.insert(publicID).second ) continue;
+
+		PublicObject *po = PublicObject::Find(publicID);
+		if ( po ) {
+			if ( po->typeInfo().isTypeOf(classType) ) feed(po);
+		}
+		else if ( _lookup.find(publicID) == _lookup.end() )
+			missing.push_back(publicID);
+	}
+
+	if ( !_archive || missing.empty() ) return 0;
+
+	auto objects = _archive->getObjects(classType, missing);
+	for ( auto &po : objects )
+		feed(po.get());
+
+	return objects.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Core::TimeWindow PublicObjectCache::timeWindow() const {
 	Core::TimeWindow tw;
@@ -365,7 +396,6 @@ void PublicObjectCache::push(PublicObject* obj) {
 	}
 	else {
 		item = new CacheItem;
-		item->lookup = itp.first;
 		itp.first->second = item;
 		++_size;
 	}
@@ -410,7 +440,7 @@ void PublicObjectCache::pop() {
 	else
 		_back = item->prev;
 
-	_lookup.erase(item->lookup);
+	_lookup.erase(item->object->publicID());
 
 	delete item;
 	--_size;
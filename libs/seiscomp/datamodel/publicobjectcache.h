@@ -26,6 +26,9 @@
 #include <seiscomp/datamodel/publicobject.h>
 #include <queue>
 #include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -111,15 +114,14 @@ class SC_SYSTEM_CORE_API PublicObjectCache : public Core::BaseObject {
 	private:
 		struct CacheItem;
 
-		typedef std::map<std::string, CacheItem*> CacheLookup;
+		typedef std::unordered_map<std::string, CacheItem*> CacheLookup;
 
-		// Simple double linked list
+		// Simple double linked list ordered by the time of insertion
 		struct CacheItem {
 			PublicObjectPtr       object;
 			time_t                timestamp;
 			CacheItem            *prev;
 			CacheItem            *next;
-			CacheLookup::iterator lookup;
 		};
 
 
@@ -196,8 +198,7 @@ class SC_SYSTEM_CORE_API PublicObjectCache : public Core::BaseObject {
 		virtual bool feed(PublicObject *po) = 0;
 
 		/**
-		 * Removes an object from the cache. This function
-		 * can be quite time consuming since its a linear search.
+		 * Removes an object from the cache.
 		 * @param po The PublicObject pointer to be removed
 		 * @return True or False
 		 */
@@ -235,6 +236,33 @@ class SC_SYSTEM_CORE_API PublicObjectCache : public Core::BaseObject {
 		PublicObject *find(const Core::RTTI &classType,
 		                   const std::string &publicID);
 
+		/**
+		 * @brief Loads all objects which are neither cached nor globally
+		 *        registered with DatabaseArchive::getObjects and feeds them
+		 *        to the cache. Registered objects are fed as well.
+		 *
+		 * A subsequent find of each of the objects will not query the
+		 * database, e.g. to look up the picks of all arrivals of an origin:
+		 *
+		 * @code
+		 * vector<string> pickIDs;
+		 * for ( size_t i = 0; i < origin->arrivalCount(); ++i )
+		 *     pickIDs.push_back(origin->arrival(i)->pickID());
+		 * _cache.prefetch<Pick>(pickIDs);
+		 * @endcode
+		 *
+		 * @param classType The class type of the objects
+		 * @param publicIDs The publicIDs of the objects
+		 * @return The number of objects read from the database
+		 */
+		size_t prefetch(const Core::RTTI &classType,
+		                const std::vector<std::string> &publicIDs);
+
+		template <typename T>
+		size_t prefetch(const std::vector<std::string> &publicIDs) {
+			return prefetch(T::TypeInfo(), publicIDs);
+		}
+
 		/**
 		 * Returns the cached state the the last object returned by find.
 		 * This function was introduced in API 1.1.
@@ -0,0 +1,5 @@
+-- Optional index which speeds up journal lookups by object and action,
+-- e.g. DatabaseQuery::getJournalAction. The prefix lengths keep the key
+-- below 767 bytes.
+SELECT 'Creating JournalEntry_objectID_action' AS '';
+CREATE INDEX JournalEntry_objectID_action ON JournalEntry(objectID(191),action(64));
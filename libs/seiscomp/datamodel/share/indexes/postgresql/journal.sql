@@ -0,0 +1,4 @@
+-- Optional index which speeds up journal lookups by object and action,
+-- e.g. DatabaseQuery::getJournalAction.
+\echo Creating JournalEntry_m_objectID_m_action
+CREATE INDEX IF NOT EXISTS JournalEntry_m_objectID_m_action ON JournalEntry(m_objectID,m_action);
@@ -0,0 +1,3 @@
+-- Optional index which speeds up journal lookups by object and action,
+-- e.g. DatabaseQuery::getJournalAction.
+CREATE INDEX IF NOT EXISTS JournalEntry_objectID_action ON JournalEntry(objectID,action);
@@ -0,0 +1,252 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT DataModel
+
+#include <seiscomp/datamodel/snapshot.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/utils.h>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+namespace {
+
+
+// Disables the registration of public objects and the creation of
+// notifiers while copying
+class CopyGuard {
+	public:
+		CopyGuard()
+		: _registration(PublicObject::IsRegistrationEnabled())
+		, _notifiers(Notifier::IsEnabled()) {
+			PublicObject::SetRegistrationEnabled(false);
+			Notifier::SetEnabled(false);
+		}
+
+		~CopyGuard() {
+			PublicObject::SetRegistrationEnabled(_registration);
+			Notifier::SetEnabled(_notifiers);
+		}
+
+	private:
+		bool _registration;
+		bool _notifiers;
+};
+
+
+// The reference of the copy is released by the last snapshot which
+// holds it, in whatever thread that is
+std::shared_ptr<const Object> share(Object *object) {
+	if ( !object ) return nullptr;
+	ObjectPtr keeper(object);
+	return std::shared_ptr<const Object>(object, [keeper](const Object*) mutable {
+		keeper = nullptr;
+	});
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const PublicObject *Snapshot::find(const std::string &publicID) const {
+	auto it = _index.find(publicID);
+	return it != _index.end() ? it->second : nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SnapshotWriter::SnapshotWriter(PublicObject *root) : _root(root) {
+	Object::RegisterObserver(this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SnapshotWriter::~SnapshotWriter() {
+	Object::UnregisterObserver(this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SnapshotCPtr SnapshotWriter::publish() {
+	if ( !_changed && _current )
+		return _current;
+
+	CopyGuard guard;
+
+	auto snapshot = std::make_shared<Snapshot>();
+	snapshot->_version = ++_version;
+
+	if ( _rootChanged || !_rootCopy ) {
+		_rootCopy = share(_root->clone());
+		_rootChanged = false;
+	}
+
+	snapshot->_root = _rootCopy;
+
+	for ( size_t i = 0; i < _root->meta()->propertyCount(); ++i ) {
+		const Core::MetaProperty *prop = _root->meta()->property(i);
+		if ( !prop->isArray() ) continue;
+
+		size_t count = prop->arrayElementCount(_root);
+		snapshot->_objects.reserve(snapshot->_objects.size() + count);
+
+		for ( size_t c = 0; c < count; ++c ) {
+			const Object *child = Object::Cast(prop->arrayObject(_root, c));
+			if ( !child ) continue;
+
+			Snapshot::SharedObject &childCopy = _copies[child];
+			if ( !childCopy || _dirty.count(child) )
+				childCopy = share(copy(child));
+			if ( !childCopy ) continue;
+
+			snapshot->_objects.push_back(childCopy);
+
+			const PublicObject *po = PublicObject::ConstCast(childCopy.get());
+			if ( po )
+				snapshot->_index.emplace(po->publicID(), po);
+		}
+	}
+
+	_dirty.clear();
+	_changed = false;
+
+	std::lock_guard<std::mutex> lk(_mutex);
+	_current = snapshot;
+	return _current;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SnapshotCPtr SnapshotWriter::current() const {
+	std::lock_guard<std::mutex> lk(_mutex);
+	return _current;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SnapshotWriter::invalidate(const Object *object) {
+	const Object *top = topLevel(object);
+	if ( !top ) return;
+
+	if ( top == _root )
+		_rootChanged = true;
+	else
+		_dirty.insert(top);
+
+	_changed = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SnapshotWriter::invalidateAll() {
+	_copies.clear();
+	_dirty.clear();
+	_rootChanged = true;
+	_changed = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SnapshotWriter::onObjectAdded(Object *parent, Object *newChild) {
+	const Object *top = topLevel(parent);
+	if ( !top ) return;
+
+	_dirty.insert(top == _root ? newChild : top);
+	_changed = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SnapshotWriter::onObjectRemoved(Object *parent, Object *oldChild) {
+	const Object *top = topLevel(parent);
+	if ( !top ) return;
+
+	if ( top == _root ) {
+		_copies.erase(oldChild);
+		_dirty.erase(oldChild);
+	}
+	else
+		_dirty.insert(top);
+
+	_changed = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SnapshotWriter::onObjectModified(Object *object) {
+	invalidate(object);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Object *SnapshotWriter::topLevel(const Object *object) const {
+	if ( object == _root ) return _root;
+
+	while ( object ) {
+		const PublicObject *parent = object->parent();
+		if ( parent == _root ) return object;
+		object = parent;
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
@@ -0,0 +1,172 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_DATAMODEL_SNAPSHOT_H
+#define SEISCOMP_DATAMODEL_SNAPSHOT_H
+
+
+#include <seiscomp/datamodel/publicobject.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace DataModel {
+
+
+/**
+ * @brief An immutable view of a PublicObject tree, e.g. EventParameters,
+ *        at the time it has been published by a SnapshotWriter.
+ *
+ * The snapshot holds a deep copy of each direct child of the root, e.g.
+ * each pick, amplitude, origin and event. Subsequent snapshots share the
+ * copies of all children whose subtrees have not changed. The objects of
+ * a snapshot are detached copies which are not registered and must only
+ * be read. In particular, readers must not create smart pointers to them
+ * since reference counting is not thread-safe.
+ */
+class SC_SYSTEM_CORE_API Snapshot {
+	public:
+		//! Returns the number of the snapshot, incremented with each change
+		uint64_t version() const { return _version; }
+
+		//! Returns a copy of the root object without children
+		const PublicObject *root() const { return static_cast<const PublicObject*>(_root.get()); }
+
+		//! Returns the number of children of the root
+		size_t objectCount() const { return _objects.size(); }
+
+		//! Returns a child of the root in the order of the root's arrays
+		const Object *object(size_t i) const { return _objects[i].get(); }
+
+		//! Returns the child of the root with the given publicID
+		const PublicObject *find(const std::string &publicID) const;
+
+		template <typename T>
+		const T *find(const std::string &publicID) const {
+			return T::ConstCast(find(publicID));
+		}
+
+	private:
+		typedef std::shared_ptr<const Object> SharedObject;
+
+		uint64_t                                                  _version{0};
+		SharedObject                                              _root;
+		std::vector<SharedObject>                                 _objects;
+		std::unordered_map<std::string, const PublicObject*>      _index;
+
+	friend class SnapshotWriter;
+};
+
+typedef std::shared_ptr<const Snapshot> SnapshotCPtr;
+
+
+DEFINE_SMARTPOINTER(SnapshotWriter);
+
+/**
+ * @brief Publishes snapshots of a PublicObject tree which is modified in a
+ *        single thread.
+ *
+ * The writer observes all changes made to the tree through add(), remove()
+ * and update(), hence also all notifiers applied to it. Changes made with
+ * setters without calling update() must be reported with invalidate().
+ *
+ * The thread which modifies the tree calls publish(), e.g. after each
+ * notifier message. It copies the changed children of the root and shares
+ * all others with the previous snapshot. Other threads call current()
+ * which returns the last published snapshot in constant time and keep it
+ * as long as they need a consistent view.
+ *
+ * The writer must be created and destroyed in the thread which modifies
+ * the tree and the root must outlive it.
+ */
+class SC_SYSTEM_CORE_API SnapshotWriter : public Observer {
+	// ------------------------------------------------------------------
+	//  Xstruction
+	// ------------------------------------------------------------------
+	public:
+		explicit SnapshotWriter(PublicObject *root);
+		~SnapshotWriter() override;
+
+
+	// ------------------------------------------------------------------
+	//  Public interface
+	// ------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Publishes a new snapshot if the tree has changed since
+		 *        the last one.
+		 * @return The current snapshot
+		 */
+		SnapshotCPtr publish();
+
+		//! Returns the last published snapshot. This method is thread-safe.
+		SnapshotCPtr current() const;
+
+		//! Marks the subtree an object belongs to as changed
+		void invalidate(const Object *object);
+
+		//! Marks the whole tree as changed
+		void invalidateAll();
+
+
+	// ------------------------------------------------------------------
+	//  Observer interface
+	// ------------------------------------------------------------------
+	public:
+		void onObjectAdded(Object *parent, Object *newChild) override;
+		void onObjectRemoved(Object *parent, Object *oldChild) override;
+		void onObjectModified(Object *object) override;
+
+
+	// ------------------------------------------------------------------
+	//  Private members
+	// ------------------------------------------------------------------
+	private:
+		//! Returns the child of the root which holds an object, the root
+		//! itself or nullptr if the object is not part of the tree
+		const Object *topLevel(const Object *object) const;
+
+		PublicObject                                                   *_root;
+		uint64_t                                                        _version{0};
+		bool                                                            _changed{true};
+		bool                                                            _rootChanged{true};
+		bool                                                            _copying{false};
+		std::unordered_map<const Object*, Snapshot::SharedObject>       _copies;
+		std::unordered_set<const Object*>                               _dirty;
+		Snapshot::SharedObject                                          _rootCopy;
+
+		mutable std::mutex                                              _mutex;
+		SnapshotCPtr                                                    _current;
+};
+
+
+}
+}
+
+
+#endif
@@ -903,11 +903,7 @@ SensorLocation* Station::sensorLocation(const SensorLocationIndex& i) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SensorLocation* Station::findSensorLocation(const std::string& publicID) const {
-	for ( std::vector<SensorLocationPtr>::const_iterator it = _sensorLocations.begin(); it != _sensorLocations.end(); ++it )
-		if ( (*it)->publicID() == publicID )
-			return (*it).get();
-
-	return nullptr;
+	return _sensorLocationsIndex.find(_sensorLocations, publicID, publicIDOf<SensorLocation>);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -942,6 +938,7 @@ bool Station::add(SensorLocation* sensorLocation) {
 
 	// Add the element
 	_sensorLocations.push_back(sensorLocation);
+	_sensorLocationsIndex.added(_sensorLocations, publicIDOf<SensorLocation>);
 	sensorLocation->setParent(this);
 
 	// Create the notifiers
@@ -986,6 +983,7 @@ bool Station::remove(SensorLocation* sensorLocation) {
 	(*it)->setParent(nullptr);
 	childRemoved((*it).get());
 
+	_sensorLocationsIndex.removed(_sensorLocations, (*it).get(), publicIDOf<SensorLocation>);
 	_sensorLocations.erase(it);
 
 	return true;
@@ -1010,6 +1008,7 @@ bool Station::removeSensorLocation(size_t i) {
 	_sensorLocations[i]->setParent(nullptr);
 	childRemoved(_sensorLocations[i].get());
 
+	_sensorLocationsIndex.removed(_sensorLocations, _sensorLocations[i].get(), publicIDOf<SensorLocation>);
 	_sensorLocations.erase(_sensorLocations.begin() + i);
 
 	return true;
@@ -28,6 +28,7 @@
 #include <vector>
 #include <seiscomp/datamodel/comment.h>
 #include <seiscomp/datamodel/sensorlocation.h>
+#include <seiscomp/datamodel/childindex.h>
 #include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/datamodel/publicobject.h>
 #include <seiscomp/core/exceptions.h>
@@ -320,6 +321,9 @@ class SC_SYSTEM_CORE_API Station : public PublicObject {
 		std::vector<CommentPtr> _comments;
 		std::vector<SensorLocationPtr> _sensorLocations;
 
+		// Indexes of the aggregations
+		ChildIndex<SensorLocation> _sensorLocationsIndex;
+
 	DECLARE_SC_CLASSFACTORY_FRIEND(Station);
 };
 
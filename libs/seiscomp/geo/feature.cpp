@@ -21,6 +21,8 @@
 #include <seiscomp/geo/feature.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
 
 
@@ -30,6 +32,235 @@ using namespace Seiscomp::Geo;
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+// Rings with less vertices are tested edge by edge
+const size_t MinIndexedSides = 32;
+// Upper bound of longitude bins per ring
+const size_t MaxBins = 1 << 16;
+// Tolerance in degrees to widen the longitude range of an edge
+const double BinTolerance = 1E-6;
+
+
+inline double sub(double a, double b) {
+	return GeoCoordinate::normalizeLon(a-b);
+}
+
+
+// The crossing test of Seiscomp::Geo::contains for the edge from
+// pj to pi.
+inline bool crosses(const GeoCoordinate &v, const GeoCoordinate &pi,
+                    const GeoCoordinate &pj) {
+	GeoCoordinate::ValueType relLonLeft = sub(pi.lon, v.lon);
+	GeoCoordinate::ValueType relLonRight = sub(pj.lon, v.lon);
+	GeoCoordinate::ValueType relWidth = relLonLeft-relLonRight;
+	if ( fabs(relWidth) > 180 ) {
+		if ( relWidth < -180 )
+			relWidth += 360;
+		else
+			relWidth -= 360;
+
+		relLonLeft = relLonRight+relWidth;
+	}
+
+	if ( (relLonLeft > 0) == (relLonRight > 0) ) return false;
+	return v.lat < (pj.lat-pi.lat) * sub(v.lon, pi.lon) / sub(pj.lon, pi.lon) + pi.lat;
+}
+
+
+inline double modulo360(double x) {
+	x = fmod(x, 360);
+	return x < 0 ? x + 360 : x;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * @brief Longitude bins of the edges of each ring. An edge is registered
+ *        in all bins its longitude range overlaps with, a point thus only
+ *        needs to test the edges of the bin its longitude falls into.
+ */
+struct GeoFeature::EdgeIndex {
+	struct Ring {
+		size_t                start{0};
+		// Number of vertices, without a duplicated last vertex if indexed
+		size_t                sides{0};
+		// Longitude where the first bin starts
+		double                origin{0};
+		// Covered longitude range, 360 if the ring wraps around
+		double                range{0};
+		double                binWidth{0};
+		// Edge offsets per bin, empty if the ring is tested edge by edge
+		std::vector<uint32_t> offsets;
+		// Indices of the end vertices of the edges
+		std::vector<uint32_t> edges;
+
+		void build(const GeoCoordinate *polygon);
+		bool contains(const GeoCoordinate &v, const GeoCoordinate *polygon) const;
+	};
+
+	std::vector<Ring> rings;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GeoFeature::EdgeIndex::Ring::build(const GeoCoordinate *polygon) {
+	size_t n = sides;
+	if ( polygon[0] == polygon[n-1] )
+		--n;
+
+	if ( n < MinIndexedSides ) return;
+
+	sides = n;
+
+	// Longitude ranges of all edges relative to the first vertex following
+	// the shorter way as the crossing test does
+	std::vector<double> lower(sides), upper(sides);
+	std::vector<bool> halfCircle(sides, false);
+	double pos = 0, minPos = 0, maxPos = 0;
+	bool wraps = false;
+
+	for ( size_t i = 0, j = sides-1; i < sides; j = i++ ) {
+		double width = sub(polygon[i].lon, polygon[j].lon);
+		// A half circle does not define a direction, the edge is
+		// registered in all bins
+		if ( fabs(width) >= 180 - BinTolerance )
+			halfCircle[i] = wraps = true;
+
+		// The edge to the first vertex closes the ring and is handled after
+		// the others
+		if ( !i ) continue;
+
+		lower[i] = std::min(pos, pos + width);
+		upper[i] = std::max(pos, pos + width);
+		pos += width;
+		minPos = std::min(minPos, pos);
+		maxPos = std::max(maxPos, pos);
+	}
+
+	double width = sub(polygon[0].lon, polygon[sides-1].lon);
+	lower[0] = std::min(pos, pos + width);
+	upper[0] = std::max(pos, pos + width);
+	minPos = std::min(minPos, lower[0]);
+	maxPos = std::max(maxPos, upper[0]);
+
+	if ( wraps || (maxPos - minPos >= 360 - 2*BinTolerance) ) {
+		origin = polygon[0].lon;
+		range = 360;
+	}
+	else {
+		origin = polygon[0].lon + minPos;
+		range = maxPos - minPos;
+		for ( size_t i = 0; i < sides; ++i ) {
+			lower[i] -= minPos;
+			upper[i] -= minPos;
+		}
+	}
+
+	size_t bins = std::min(sides, MaxBins);
+	binWidth = std::max(range / bins, BinTolerance);
+	bins = std::max(std::min(bins, static_cast<size_t>(ceil(range / binWidth))), size_t(1));
+
+	// Returns the bin range [first,last] of an edge, last may exceed the
+	// number of bins on wrapping rings
+	auto binRange = [&](size_t i, long &first, long &last) {
+		if ( halfCircle[i] ) {
+			first = 0;
+			last = static_cast<long>(bins)-1;
+			return;
+		}
+
+		first = static_cast<long>(floor((lower[i] - BinTolerance) / binWidth));
+		last = static_cast<long>(floor((upper[i] + BinTolerance) / binWidth));
+
+		if ( range < 360 ) {
+			first = std::max(first, 0L);
+			last = std::min(last, static_cast<long>(bins)-1);
+		}
+		else if ( last - first + 1 >= static_cast<long>(bins) ) {
+			first = 0;
+			last = static_cast<long>(bins)-1;
+		}
+	};
+
+	auto binIndex = [&](long k) {
+		k %= static_cast<long>(bins);
+		return static_cast<size_t>(k < 0 ? k + static_cast<long>(bins) : k);
+	};
+
+	offsets.assign(bins+1, 0);
+
+	for ( size_t i = 0; i < sides; ++i ) {
+		long first, last;
+		binRange(i, first, last);
+		for ( long k = first; k <= last; ++k )
+			++offsets[binIndex(k)+1];
+	}
+
+	for ( size_t k = 0; k < bins; ++k )
+		offsets[k+1] += offsets[k];
+
+	edges.resize(offsets[bins]);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end()-1);
+
+	for ( size_t i = 0; i < sides; ++i ) {
+		long first, last;
+		binRange(i, first, last);
+		for ( long k = first; k <= last; ++k )
+			edges[fill[binIndex(k)]++] = static_cast<uint32_t>(i);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool GeoFeature::EdgeIndex::Ring::contains(const GeoCoordinate &v,
+                                           const GeoCoordinate *polygon) const {
+	if ( offsets.empty() )
+		return Seiscomp::Geo::contains(v, polygon + start, sides);
+
+	polygon += start;
+
+	double x = modulo360(v.lon - origin);
+	size_t bins = offsets.size()-1;
+
+	if ( range < 360 ) {
+		// Points slightly west of the origin
+		if ( x > 360 - BinTolerance ) x = 0;
+		// No edge covers the longitude of the point
+		else if ( x > range + BinTolerance ) return false;
+	}
+
+	size_t bin = std::min(static_cast<size_t>(x / binWidth), bins-1);
+	bool oddCrossings = false;
+
+	for ( uint32_t k = offsets[bin]; k < offsets[bin+1]; ++k ) {
+		size_t i = edges[k];
+		size_t j = i ? i-1 : sides-1;
+		if ( crosses(v, polygon[i], polygon[j]) )
+			oddCrossings = !oddCrossings;
+	}
+
+	return oddCrossings;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 GeoFeature::GeoFeature(const Category* category, unsigned int rank)
 : _category(category)
@@ -103,6 +334,7 @@ void GeoFeature::addVertex(const GeoCoordinate &v, bool newSubFeature) {
 
 	// Add the new vertex
 	_vertices.push_back(v);
+	resetEdgeIndex();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -142,6 +374,8 @@ void GeoFeature::invertOrder() {
 			std::swap(_vertices[startIdx+j], _vertices[startIdx+count-1-j]);
 		startIdx = endIdx;
 	}
+
+	resetEdgeIndex();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -207,6 +441,8 @@ void GeoFeature::sort() {
 
 	assert(vi == _vertices.size());
 	assert(sfi == _subFeatures.size()+1);
+
+	resetEdgeIndex();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -222,10 +458,67 @@ void GeoFeature::setUserData(void *d) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+GeoFeature::EdgeIndexPtr GeoFeature::edgeIndex() const {
+	EdgeIndexPtr index = std::atomic_load(&_edgeIndex);
+	if ( index || (_vertices.size() < MinIndexedSides) ) return index;
+
+	std::shared_ptr<EdgeIndex> newIndex = std::make_shared<EdgeIndex>();
+	size_t startIdx = 0, endIdx = 0;
+	size_t nSubFeat = _subFeatures.size();
+
+	newIndex->rings.resize(nSubFeat+1);
+
+	for ( size_t i = 0; i <= nSubFeat; ++i ) {
+		endIdx = (i == nSubFeat ? _vertices.size() : _subFeatures[i]);
+		EdgeIndex::Ring &ring = newIndex->rings[i];
+		ring.start = startIdx;
+		ring.sides = endIdx - startIdx;
+		if ( ring.sides )
+			ring.build(&_vertices[startIdx]);
+		startIdx = endIdx;
+	}
+
+	// Concurrent readers may build the index at the same time, the first
+	// one wins
+	index = newIndex;
+	EdgeIndexPtr expected;
+	if ( !std::atomic_compare_exchange_strong(&_edgeIndex, &expected, index) )
+		return expected;
+
+	return index;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GeoFeature::resetEdgeIndex() {
+	// Modifications must not run concurrently with contains() anyway, a
+	// plain reset avoids the atomic operations for each added vertex
+	if ( _edgeIndex )
+		_edgeIndex.reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool GeoFeature::contains(const GeoCoordinate &v) const {
 	if ( !closedPolygon() ) return false;
 
+	EdgeIndexPtr index = edgeIndex();
+	if ( index ) {
+		bool isInside = false;
+		for ( const auto &ring : index->rings ) {
+			if ( ring.sides && ring.contains(v, _vertices.data()) )
+				isInside = !isInside;
+		}
+		return isInside;
+	}
+
 	size_t startIdx = 0, endIdx = 0;
 	size_t nSubFeat = _subFeatures.size();
 	bool isInside = false;
@@ -26,6 +26,7 @@
 #include <seiscomp/geo/boundingbox.h>
 
 #include <map>
+#include <memory>
 
 namespace Seiscomp {
 namespace Geo {
@@ -104,6 +105,13 @@ class SC_SYSTEM_CORE_API GeoFeature : public Core::BaseObject {
 		const GeoBoundingBox &bbox() const { return _bbox; }
 		const std::vector<size_t> &subFeatures() const { return _subFeatures; }
 
+		/**
+		 * @brief Checks whether a point is inside the closed polygon.
+		 * Features with many vertices build an edge index with the first
+		 * call which reduces the edges tested per ring to those crossing
+		 * the longitude of the point. The result is the same as with the
+		 * plain test of all edges.
+		 */
 		bool contains(const GeoCoordinate &v) const;
 
 		double area() const;
@@ -117,6 +125,12 @@ class SC_SYSTEM_CORE_API GeoFeature : public Core::BaseObject {
 	private:
 		typedef std::vector<GeoCoordinate> GeoCoordinates;
 
+		struct EdgeIndex;
+		typedef std::shared_ptr<const EdgeIndex> EdgeIndexPtr;
+
+		EdgeIndexPtr edgeIndex() const;
+		void resetEdgeIndex();
+
 		std::string          _name;
 		const Category      *_category;
 		void                *_userData;
@@ -132,6 +146,9 @@ class SC_SYSTEM_CORE_API GeoFeature : public Core::BaseObject {
 		 *  islands this vector would contain the indices of the start
 		 *  point of each island */
 		std::vector<size_t>  _subFeatures;
+
+		//! Lazily built from the vertices, reset by all modifying methods
+		mutable EdgeIndexPtr _edgeIndex;
 };
 
 
@@ -33,11 +33,291 @@
 #include <boost/regex.hpp>
 #include <boost/filesystem/operations.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 namespace fs = boost::filesystem;
 using namespace std;
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+const char CacheMagic[8] = {'S', 'C', 'G', 'E', 'O', 'F', 'S', '\0'};
+const uint32_t CacheVersion = 1;
+
+
+/**
+ * The cache file starts with the header followed by the sections it
+ * references. All offsets are relative to the start of the file and
+ * aligned to 8 bytes, all values are stored in host byte order.
+ */
+struct CacheHeader {
+	char     magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	uint64_t size;
+	uint64_t keyOffset;
+	uint64_t keyLength;
+	uint64_t fileCount;
+	uint64_t stringsOffset;
+	uint64_t stringsSize;
+	uint64_t categoriesOffset;
+	uint64_t categoryCount;
+	uint64_t featuresOffset;
+	uint64_t featureCount;
+	uint64_t attributesOffset;
+	uint64_t attributeCount;
+	uint64_t subFeaturesOffset;
+	uint64_t subFeatureCount;
+	uint64_t verticesOffset;
+	uint64_t vertexCount;
+};
+
+
+struct CacheString {
+	uint64_t offset;
+	uint64_t length;
+};
+
+
+struct CacheCategory {
+	CacheString name;
+	CacheString localName;
+	CacheString dataDir;
+	int64_t     parent;
+};
+
+
+struct CacheFeature {
+	CacheString name;
+	int64_t     category;
+	uint32_t    rank;
+	uint32_t    closedPolygon;
+	uint64_t    firstAttribute;
+	uint64_t    attributeCount;
+	uint64_t    firstSubFeature;
+	uint64_t    subFeatureCount;
+	uint64_t    firstVertex;
+	uint64_t    vertexCount;
+};
+
+
+struct CacheAttribute {
+	CacheString name;
+	CacheString value;
+};
+
+
+// Vertices are stored as flat array of latitude and longitude pairs
+typedef double CacheValue;
+
+
+uint64_t align8(uint64_t offset) {
+	return (offset + 7) & ~uint64_t(7);
+}
+
+
+// FNV-1a
+uint64_t hash(const string &data, uint64_t h = 14695981039346656037ULL) {
+	for ( unsigned char c : data ) {
+		h ^= c;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+
+string toHex(uint64_t value) {
+	char buf[17];
+	snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(value));
+	return buf;
+}
+
+
+void collectFiles(const fs::path &directory, const string &prefix,
+                  vector<string> &entries) {
+	fs::directory_iterator end_itd;
+	fs::directory_iterator itd(directory);
+
+	for ( ; itd != end_itd; ++itd ) {
+		string name = prefix + SC_FS_IT_LEAF(itd);
+		if ( fs::is_directory(*itd) ) {
+			collectFiles(*itd, name + "/", entries);
+			continue;
+		}
+
+		ostringstream entry;
+		entry << name << ':' << fs::file_size(*itd) << ':'
+		      << fs::last_write_time(*itd);
+		entries.push_back(entry.str());
+	}
+}
+
+
+/**
+ * Returns a key which identifies the state of a directory. It changes if
+ * any file is added, removed or modified.
+ */
+bool directoryKey(const string &dirPath, string &key) {
+	vector<string> entries;
+
+	try {
+		collectFiles(SC_FS_PATH(dirPath), "", entries);
+	}
+	catch ( ... ) {
+		return false;
+	}
+
+	std::sort(entries.begin(), entries.end());
+
+	uint64_t h = hash(dirPath);
+	for ( const auto &entry : entries ) {
+		h = hash(entry, h);
+		h = hash("\n", h);
+	}
+
+	key = dirPath + "\n" + to_string(entries.size()) +
+	      "\n" + toHex(h);
+	return true;
+}
+
+
+string defaultCachePath(const string &dirPath) {
+	return Seiscomp::Environment::Instance()->installDir() +
+	       "/var/cache/spatial/vector/" + toHex(hash(dirPath)) + ".bin";
+}
+
+
+class StringTable {
+	public:
+		CacheString add(const string &str) {
+			CacheString ref;
+			ref.offset = _data.size();
+			ref.length = str.size();
+			_data += str;
+			return ref;
+		}
+
+		const string &data() const { return _data; }
+
+	private:
+		string _data;
+};
+
+
+/**
+ * Read only view of a file which is memory mapped if supported.
+ */
+class MappedFile {
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile &) = delete;
+		~MappedFile() {
+#ifndef WIN32
+			if ( _map ) munmap(_map, _size);
+#endif
+		}
+
+	public:
+		bool open(const string &path) {
+#ifndef WIN32
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if ( fd < 0 ) return false;
+
+			struct stat st;
+			if ( fstat(fd, &st) || st.st_size < static_cast<off_t>(sizeof(CacheHeader)) ) {
+				::close(fd);
+				return false;
+			}
+
+			void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);
+
+			if ( map == MAP_FAILED ) return false;
+
+			_map = map;
+			_size = st.st_size;
+			_data = static_cast<const char*>(map);
+#else
+			ifstream ifs(path.c_str(), ios::binary);
+			if ( !ifs.is_open() ) return false;
+
+			_buffer.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+			_size = _buffer.size();
+			_data = _buffer.data();
+#endif
+			return true;
+		}
+
+		const char *data() const { return _data; }
+		size_t size() const { return _size; }
+
+	private:
+		const char   *_data{nullptr};
+		size_t        _size{0};
+#ifndef WIN32
+		void         *_map{nullptr};
+#else
+		vector<char>  _buffer;
+#endif
+};
+
+
+bool storeFile(const string &path, const vector<char> &blob) {
+	try {
+		SC_FS_DECLARE_PATH(filePath, path)
+		if ( SC_FS_HAS_PARENT_PATH(filePath) ) {
+			fs::create_directories(SC_FS_PARENT_PATH(filePath));
+		}
+	}
+	catch ( ... ) {
+		return false;
+	}
+
+	// Write to a temporary file first to never expose incomplete caches
+	// to concurrent readers
+	string tmpPath = path + ".part";
+	{
+		ofstream ofs(tmpPath.c_str(), ios::binary | ios::trunc);
+		if ( !ofs.is_open() ) return false;
+
+		ofs.write(blob.data(), blob.size());
+		if ( !ofs.good() ) {
+			ofs.close();
+			::remove(tmpPath.c_str());
+			return false;
+		}
+	}
+
+	if ( ::rename(tmpPath.c_str(), path.c_str()) != 0 ) {
+		::remove(tmpPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 namespace Seiscomp {
 namespace Geo {
@@ -166,11 +446,11 @@ void GeoFeatureSet::load() {
 	clear();
 
 	Environment* env = Environment::Instance();
-	if ( !readDir(env->configDir() + "/spatial/vector") ) {
-		if ( !readDir(env->shareDir() + "/spatial/vector") ) {
+	if ( !readDirCached(env->configDir() + "/spatial/vector", defaultCachePath(env->configDir() + "/spatial/vector")) ) {
+		if ( !readDirCached(env->shareDir() + "/spatial/vector", defaultCachePath(env->shareDir() + "/spatial/vector")) ) {
 			// For backward compatibility
-			if ( !readDir(env->configDir() + "/bna") ) {
-				if ( readDir(env->shareDir() + "/bna") ) {
+			if ( !readDirCached(env->configDir() + "/bna", defaultCachePath(env->configDir() + "/bna")) ) {
+				if ( readDirCached(env->shareDir() + "/bna", defaultCachePath(env->shareDir() + "/bna")) ) {
 					SEISCOMP_WARNING("The spatial vector data directory %s/bna is deprecated, "
 					                 "please move your files to %s/spatial/vector",
 					                 env->shareDir().c_str(),
@@ -257,6 +537,256 @@ size_t GeoFeatureSet::readDir(const std::string &dirPath) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t GeoFeatureSet::readDirCached(const std::string &dirPath,
+                                    const std::string &cachePath) {
+	clear();
+
+	string key;
+	if ( !directoryKey(dirPath, key) ) {
+		return 0;
+	}
+
+	Core::Time start = Core::Time::GMT();
+	size_t fileCount;
+
+	if ( readCache(cachePath, key, fileCount) ) {
+		SEISCOMP_INFO("%s in %fs (cached)", initStatus(dirPath, fileCount).c_str(),
+		              (Core::Time::GMT()-start).length());
+		return fileCount;
+	}
+
+	clear();
+	fileCount = readDir(dirPath);
+
+	if ( fileCount && !writeCache(cachePath, key, fileCount) ) {
+		SEISCOMP_WARNING("Unable to write feature cache %s", cachePath.c_str());
+	}
+
+	return fileCount;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool GeoFeatureSet::readCache(const std::string &path, const std::string &key,
+                              size_t &fileCount) {
+	MappedFile file;
+	if ( !file.open(path) ) {
+		return false;
+	}
+
+	const char *data = file.data();
+	uint64_t size = file.size();
+	if ( size < sizeof(CacheHeader) ) {
+		return false;
+	}
+
+	const CacheHeader *header = reinterpret_cast<const CacheHeader*>(data);
+
+	if ( memcmp(header->magic, CacheMagic, sizeof(CacheMagic))
+	  || header->version != CacheVersion
+	  || header->headerSize != sizeof(CacheHeader)
+	  || header->size != size
+	  || header->keyOffset + header->keyLength > size
+	  || header->stringsOffset + header->stringsSize > size
+	  || header->categoriesOffset + header->categoryCount * sizeof(CacheCategory) > size
+	  || header->featuresOffset + header->featureCount * sizeof(CacheFeature) > size
+	  || header->attributesOffset + header->attributeCount * sizeof(CacheAttribute) > size
+	  || header->subFeaturesOffset + header->subFeatureCount * sizeof(uint64_t) > size
+	  || header->verticesOffset + header->vertexCount * 2 * sizeof(CacheValue) > size ) {
+		SEISCOMP_DEBUG("Invalid feature cache %s", path.c_str());
+		return false;
+	}
+
+	if ( string(data + header->keyOffset, header->keyLength) != key ) {
+		SEISCOMP_DEBUG("Feature cache %s is outdated", path.c_str());
+		return false;
+	}
+
+	const char *strings = data + header->stringsOffset;
+	auto str = [&](const CacheString &ref, string &out) {
+		if ( ref.offset + ref.length > header->stringsSize ) return false;
+		out.assign(strings + ref.offset, ref.length);
+		return true;
+	};
+
+	const CacheCategory *categories = reinterpret_cast<const CacheCategory*>(data + header->categoriesOffset);
+	const CacheFeature *features = reinterpret_cast<const CacheFeature*>(data + header->featuresOffset);
+	const CacheAttribute *attributes = reinterpret_cast<const CacheAttribute*>(data + header->attributesOffset);
+	const uint64_t *subFeatures = reinterpret_cast<const uint64_t*>(data + header->subFeaturesOffset);
+	const CacheValue *vertices = reinterpret_cast<const CacheValue*>(data + header->verticesOffset);
+
+	string name, value;
+
+	for ( uint64_t i = 0; i < header->categoryCount; ++i ) {
+		const CacheCategory &rec = categories[i];
+		// Parents are always written before their children
+		if ( rec.parent >= static_cast<int64_t>(i) || !str(rec.name, name) ) {
+			clear();
+			return false;
+		}
+
+		Category *category = new Category(
+			static_cast<unsigned int>(i), name,
+			rec.parent >= 0 ? _categories[rec.parent] : nullptr
+		);
+		_categories.push_back(category);
+
+		if ( !str(rec.localName, category->localName)
+		  || !str(rec.dataDir, category->dataDir) ) {
+			clear();
+			return false;
+		}
+	}
+
+	for ( uint64_t i = 0; i < header->featureCount; ++i ) {
+		const CacheFeature &rec = features[i];
+		if ( rec.category >= static_cast<int64_t>(_categories.size())
+		  || rec.firstAttribute + rec.attributeCount > header->attributeCount
+		  || rec.firstSubFeature + rec.subFeatureCount > header->subFeatureCount
+		  || rec.firstVertex + rec.vertexCount > header->vertexCount
+		  || !str(rec.name, name) ) {
+			clear();
+			return false;
+		}
+
+		GeoFeature *feature = new GeoFeature(
+			name, rec.category >= 0 ? _categories[rec.category] : nullptr,
+			rec.rank
+		);
+		_features.push_back(feature);
+
+		for ( uint64_t a = 0; a < rec.attributeCount; ++a ) {
+			const CacheAttribute &attr = attributes[rec.firstAttribute + a];
+			if ( !str(attr.name, name) || !str(attr.value, value) ) {
+				clear();
+				return false;
+			}
+			feature->setAttribute(name, value);
+		}
+
+		const uint64_t *subFeature = subFeatures + rec.firstSubFeature;
+		const uint64_t *subFeatureEnd = subFeature + rec.subFeatureCount;
+		const CacheValue *v = vertices + rec.firstVertex * 2;
+
+		for ( uint64_t n = 0; n < rec.vertexCount; ++n, v += 2 ) {
+			bool newSubFeature = (subFeature != subFeatureEnd) && (*subFeature == n);
+			if ( newSubFeature ) ++subFeature;
+			feature->addVertex(GeoCoordinate(v[0], v[1]), newSubFeature);
+		}
+
+		feature->setClosedPolygon(rec.closedPolygon != 0);
+		feature->updateBoundingBox();
+	}
+
+	fileCount = header->fileCount;
+
+	SEISCOMP_DEBUG("Mapped feature cache %s", path.c_str());
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool GeoFeatureSet::writeCache(const std::string &path, const std::string &key,
+                               size_t fileCount) const {
+	StringTable strings;
+	vector<CacheCategory> categories;
+	vector<CacheFeature> features;
+	vector<CacheAttribute> attributes;
+	vector<uint64_t> subFeatures;
+	vector<CacheValue> vertices;
+	unordered_map<const Category*, int64_t> categoryIndex;
+
+	for ( size_t i = 0; i < _categories.size(); ++i ) {
+		const Category *category = _categories[i];
+		CacheCategory rec;
+		rec.name = strings.add(category->name);
+		rec.localName = strings.add(category->localName);
+		rec.dataDir = strings.add(category->dataDir);
+		auto it = categoryIndex.find(category->parent);
+		rec.parent = it != categoryIndex.end() ? it->second : -1;
+		categories.push_back(rec);
+		categoryIndex[category] = static_cast<int64_t>(i);
+	}
+
+	for ( const GeoFeature *feature : _features ) {
+		CacheFeature rec;
+		rec.name = strings.add(feature->name());
+		auto it = categoryIndex.find(feature->category());
+		rec.category = it != categoryIndex.end() ? it->second : -1;
+		rec.rank = feature->rank();
+		rec.closedPolygon = feature->closedPolygon() ? 1 : 0;
+
+		rec.firstAttribute = attributes.size();
+		rec.attributeCount = feature->attributes().size();
+		for ( const auto &attr : feature->attributes() ) {
+			CacheAttribute arec;
+			arec.name = strings.add(attr.first);
+			arec.value = strings.add(attr.second);
+			attributes.push_back(arec);
+		}
+
+		rec.firstSubFeature = subFeatures.size();
+		rec.subFeatureCount = feature->subFeatures().size();
+		subFeatures.insert(subFeatures.end(), feature->subFeatures().begin(),
+		                   feature->subFeatures().end());
+
+		rec.firstVertex = vertices.size() / 2;
+		rec.vertexCount = feature->vertices().size();
+		for ( const auto &v : feature->vertices() ) {
+			vertices.push_back(v.lat);
+			vertices.push_back(v.lon);
+		}
+
+		features.push_back(rec);
+	}
+
+	CacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+	header.version = CacheVersion;
+	header.headerSize = sizeof(CacheHeader);
+	header.fileCount = fileCount;
+	header.keyOffset = align8(sizeof(CacheHeader));
+	header.keyLength = key.size();
+	header.stringsOffset = align8(header.keyOffset + header.keyLength);
+	header.stringsSize = strings.data().size();
+	header.categoriesOffset = align8(header.stringsOffset + header.stringsSize);
+	header.categoryCount = categories.size();
+	header.featuresOffset = align8(header.categoriesOffset + categories.size() * sizeof(CacheCategory));
+	header.featureCount = features.size();
+	header.attributesOffset = align8(header.featuresOffset + features.size() * sizeof(CacheFeature));
+	header.attributeCount = attributes.size();
+	header.subFeaturesOffset = align8(header.attributesOffset + attributes.size() * sizeof(CacheAttribute));
+	header.subFeatureCount = subFeatures.size();
+	header.verticesOffset = align8(header.subFeaturesOffset + subFeatures.size() * sizeof(uint64_t));
+	header.vertexCount = vertices.size() / 2;
+	header.size = header.verticesOffset + vertices.size() * sizeof(CacheValue);
+
+	vector<char> blob(header.size, 0);
+	char *data = blob.data();
+	memcpy(data, &header, sizeof(header));
+	memcpy(data + header.keyOffset, key.data(), key.size());
+	memcpy(data + header.stringsOffset, strings.data().data(), header.stringsSize);
+	memcpy(data + header.categoriesOffset, categories.data(), categories.size() * sizeof(CacheCategory));
+	memcpy(data + header.featuresOffset, features.data(), features.size() * sizeof(CacheFeature));
+	memcpy(data + header.attributesOffset, attributes.data(), attributes.size() * sizeof(CacheAttribute));
+	memcpy(data + header.subFeaturesOffset, subFeatures.data(), subFeatures.size() * sizeof(uint64_t));
+	memcpy(data + header.verticesOffset, vertices.data(), vertices.size() * sizeof(CacheValue));
+
+	return storeFile(path, blob);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t GeoFeatureSet::readBNADirRecursive(const fs::path &directory,
                                           Category *category) {
@@ -121,6 +121,24 @@ class SC_SYSTEM_CORE_API GeoFeatureSet : public Core::BaseObject {
 		 */
 		ssize_t readFile(const std::string& filename, const Category* category);
 
+		/**
+		 * @brief Reads all files of a directory as readDir() does but keeps
+		 *        a binary copy of the result in a cache file.
+		 *
+		 * If the cache file is present and was created from the current
+		 * state of the directory, the features are restored from the
+		 * memory mapped file without parsing the source files. Otherwise
+		 * the directory is read and the cache file is written. The feature
+		 * set is cleared prior to reading.
+		 *
+		 * @param dirPath The directory to read
+		 * @param cachePath The path of the cache file
+		 * @return The number of files read
+		 * @since SeisComP ABI version 17.0.0
+		 */
+		size_t readDirCached(const std::string &dirPath,
+		                     const std::string &cachePath);
+
 		bool addFeature(GeoFeature *feature);
 
 		/** Returns reference to GeoFeature vector */
@@ -142,6 +160,14 @@ class SC_SYSTEM_CORE_API GeoFeatureSet : public Core::BaseObject {
 		size_t readDirRecursive(const boost::filesystem::path &directory,
 		                        Category *category);
 
+		/** Restores the feature set from a cache file created by writeCache() */
+		bool readCache(const std::string &path, const std::string &key,
+		               size_t &fileCount);
+
+		/** Writes the feature set to a cache file */
+		bool writeCache(const std::string &path, const std::string &key,
+		                size_t fileCount) const;
+
 		/** Prints the number of polygons read */
 		const std::string initStatus(const std::string &directory,
 		                             unsigned int fileCount) const;
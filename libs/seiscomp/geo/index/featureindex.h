@@ -0,0 +1,90 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_GEO_INDEX_FEATUREINDEX_H
+#define SEISCOMP_GEO_INDEX_FEATUREINDEX_H
+
+
+#include <seiscomp/geo/index/quadtree.h>
+
+#include <unordered_map>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Geo {
+
+
+/**
+ * @brief A spatial index for point in polygon lookups in a set of features.
+ *
+ * The features are stored in a QuadTree according to their bounding boxes
+ * and only the polygons of features whose bounding box contains a point are
+ * tested. In contrast to QuadTree::findFirst the lookup returns the same
+ * feature as testing all features in the order they have been added, hence
+ * the order defines the precedence of overlapping features.
+ *
+ * Features must not change their geometry or bounding box after they have
+ * been added.
+ */
+class SC_SYSTEM_CORE_API GeoFeatureIndex {
+	public:
+		GeoFeatureIndex() = default;
+
+	public:
+		/**
+		 * @brief Adds a feature to the index.
+		 * @param feature The feature const pointer. The ownership is not
+		 *                transferred.
+		 */
+		void addItem(const GeoFeature *feature);
+
+		//! Adds all features of the feature set
+		void add(const GeoFeatureSet &featureSet);
+
+		//! Removes all features
+		void clear();
+
+		//! Returns the number of indexed features
+		size_t size() const;
+
+		/**
+		 * @brief Returns the first added feature which contains the given
+		 *        coordinate.
+		 * @param gc The coordinate
+		 * @return The feature or nullptr
+		 */
+		const GeoFeature *findFirst(const GeoCoordinate &gc) const;
+
+
+	private:
+		QuadTree                                     _tree;
+		std::unordered_map<const GeoFeature*, size_t> _order;
+		//! Features without bounding box which are tested always
+		std::vector<const GeoFeature*>               _unbounded;
+};
+
+
+}
+}
+
+
+#endif
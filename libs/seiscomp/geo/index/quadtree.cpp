@@ -228,6 +228,32 @@ void QuadTree::Node::visit(const GeoBoundingBox &bb, const VisitFunc &func,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool QuadTree::Node::visitBoundingBoxes(const GeoCoordinate &gc,
+                                        const VisitFunc &func) const {
+	if ( !bbox.contains(gc) ) return true;
+
+	for ( size_t i = 0; i < features.size(); ++i ) {
+		if ( features[i]->bbox().contains(gc) ) {
+			if ( !func(features[i]) )
+				return false;
+		}
+	}
+
+	for ( size_t i = 0; i < 4; ++i ) {
+		if ( children[i] ) {
+			if ( !children[i]->visitBoundingBoxes(gc, func) )
+				return false;
+		}
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 const GeoFeature *QuadTree::Node::findFirst(const GeoCoordinate &gc) {
 	const GeoFeature *f;
@@ -331,6 +357,16 @@ void QuadTree::query(const GeoBoundingBox &bb, const VisitFunc &func,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void QuadTree::queryBoundingBoxes(const GeoCoordinate &gc,
+                                  const VisitFunc &func) const {
+	_root.visitBoundingBoxes(gc, func);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 const GeoFeature *QuadTree::findFirst(const GeoCoordinate &gc) {
 	return _root.findFirst(gc);
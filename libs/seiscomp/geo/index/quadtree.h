@@ -56,6 +56,14 @@ class SC_SYSTEM_CORE_API QuadTree {
 		void query(const GeoCoordinate &gc, const VisitFunc &) const;
 		void query(const GeoBoundingBox &bb, const VisitFunc &, bool clipOnlyNodes = false) const;
 
+		/**
+		 * @brief Visits all features whose bounding box contains the given
+		 *        coordinate. In contrast to query() the geometry of the
+		 *        features is not tested.
+		 * @param gc The normalized coordinate
+		 */
+		void queryBoundingBoxes(const GeoCoordinate &gc, const VisitFunc &) const;
+
 		/**
 		 * Visits the features of a quadtree by descending from the root to
 		 * the leaves or from the leaves to the root. The visitor is an
@@ -101,6 +109,7 @@ class SC_SYSTEM_CORE_API QuadTree {
 
 			void visit(const GeoCoordinate &gc, const VisitFunc &) const;
 			void visit(const GeoBoundingBox &bb, const VisitFunc &, bool clipOnlyNodes = false) const;
+			bool visitBoundingBoxes(const GeoCoordinate &gc, const VisitFunc &) const;
 
 			template <typename VISITOR>
 			bool acceptTopDown(const VISITOR &visitor);
@@ -34,6 +34,7 @@
 #include <seiscomp/utils/files.h>
 #include <seiscomp/utils/misc.h>
 
+#include <QElapsedTimer>
 #include <QHeaderView>
 #include <QLocale>
 #include <QMainWindow>
@@ -74,6 +75,10 @@ namespace {
 
 QString splashDefaultImage = ":/images/images/splash-default.png";
 
+// The time in milliseconds spent on dispatching decoded messages before
+// control is returned to the event loop
+const qint64 MessageTimeSlice = 50;
+
 
 // Don't catch signal on windows since that path hasn't tested.
 #ifdef WIN32
@@ -243,7 +248,9 @@ void Application::_GUI_Core_Settings::accept(SettingsLinker &linker) {
 	& cfg(fullScreen, "mode.fullscreen")
 	& cfg(interactive, "mode.interactive")
 	& cfg(mapsDesc, "map")
-	& cfg(commandTargetClient, "commands.target");
+	& cfg(commandTargetClient, "commands.target")
+	& cfg(queryCacheSize, "queryCache.size")
+	& cfg(queryCacheMaxAge, "queryCache.maxAge");
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -255,6 +262,7 @@ Application::_GUI_Core_Settings::_MapsDesc::_MapsDesc() {
 	location = "@DATADIR@/maps/world%s.png";
 	isMercatorProjected = false;
 	cacheSize = 0;
+	loaderThreads = 2;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -267,7 +275,8 @@ void Application::_GUI_Core_Settings::_MapsDesc::accept(SettingsLinker &linker)
 	& cfg(type, "type")
 	& cfg(format, "format")
 	& cfg(location, "location")
-	& cfg(cacheSize, "cacheSize");
+	& cfg(cacheSize, "cacheSize")
+	& cfg(loaderThreads, "loaderThreads");
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1017,6 +1026,10 @@ bool Application::init() {
 	}
 	catch ( ... ) {}
 
+	if ( query() )
+		query()->setQueryCache(std::max(_settings.queryCacheSize, 0),
+		                       _settings.queryCacheMaxAge);
+
 	_messageGroups.pick = "PICK";
 	_messageGroups.amplitude = "AMPLITUDE";
 	_messageGroups.magnitude = "MAGNITUDE";
@@ -1489,6 +1502,9 @@ void Application::destroyConnection() {
 void Application::databaseChanged() {
 	if ( query() ) {
 		query()->setDriver(_database.get());
+		query()->clearQueryCache();
+		query()->setQueryCache(std::max(_settings.queryCacheSize, 0),
+		                       _settings.queryCacheMaxAge);
 		Client::Application::_settings.database.URI = cdlg()->databaseURI();
 		if ( query()->hasError() ) {
 			if ( _database ) {
@@ -1523,6 +1539,7 @@ void Application::startMessageThread() {
 		connect(_thread, SIGNAL(connectionEstablished()), this, SIGNAL(connectionEstablished()));
 		connect(_thread, SIGNAL(connectionLost()), this, SIGNAL(connectionLost()));
 		_thread->setReconnectOnErrorEnabled(true);
+		_thread->setDecodingEnabled(Client::Application::_settings.messaging.decodeThreads > 0);
 		_thread->start();
 	}
 }
@@ -1551,102 +1568,130 @@ void Application::messagesAvailable() {
 
 	Seiscomp::Core::MessagePtr msg;
 	Client::PacketPtr pkt;
+
+	if ( _thread && _thread->isDecodingEnabled() ) {
+		// The messages have already been decoded by the message thread.
+		// Return to the event loop after the time slice has elapsed and
+		// continue with the remaining messages afterwards.
+		QElapsedTimer timer;
+		timer.start();
+
+		while ( _thread->takeMessage(msg, pkt) ) {
+			handleMessage(msg.get(), pkt.get());
+			if ( timer.elapsed() >= MessageTimeSlice ) {
+				QMetaObject::invokeMethod(this, "messagesAvailable", Qt::QueuedConnection);
+				break;
+			}
+		}
+
+		return;
+	}
+
 	while ( _connection->inboxSize() > 0 ) {
 		msg = _connection->recv(pkt);
-		if ( !msg ) {
-			// end of traffic?
-			if ( !pkt )
-				break;
+		// end of traffic?
+		if ( !msg && !pkt )
+			break;
 
-			emit messageSkipped(pkt.get());
-			continue;
-		}
+		handleMessage(msg.get(), pkt.get());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		if ( isDatabaseEnabled() ) {
-			Client::DatabaseProvideMessage *dbmsg = Client::DatabaseProvideMessage::Cast(msg);
-			if ( dbmsg && cdlg() ) {
-				cdlg()->setDefaultDatabaseParameters(dbmsg->service(), dbmsg->parameters());
-				if ( database() == nullptr ) {
-					cdlg()->setDatabaseParameters(dbmsg->service(), dbmsg->parameters());
-					cdlg()->connectToDatabase();
-					if ( cdlg()->hasDatabaseChanged() ) {
-						Client::Application::_settings.database.URI = cdlg()->databaseURI();
-						setDatabase(database());
-					}
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::handleMessage(Core::Message *msg, Client::Packet *pkt) {
+	if ( !msg ) {
+		if ( pkt ) emit messageSkipped(pkt);
+		return;
+	}
+
+	if ( isDatabaseEnabled() ) {
+		Client::DatabaseProvideMessage *dbmsg = Client::DatabaseProvideMessage::Cast(msg);
+		if ( dbmsg && cdlg() ) {
+			cdlg()->setDefaultDatabaseParameters(dbmsg->service(), dbmsg->parameters());
+			if ( database() == nullptr ) {
+				cdlg()->setDatabaseParameters(dbmsg->service(), dbmsg->parameters());
+				cdlg()->connectToDatabase();
+				if ( cdlg()->hasDatabaseChanged() ) {
+					Client::Application::_settings.database.URI = cdlg()->databaseURI();
+					setDatabase(database());
 				}
 			}
 		}
+	}
 
-		CommandMessage *cmd = CommandMessage::Cast(msg);
-		if ( cmd && _filterCommands ) {
-			QRegExp re(cmd->client().c_str());
-			if ( re.exactMatch(Client::Application::_settings.messaging.user.c_str()) ) {
-				if ( cmd->command() == CM_SHOW_NOTIFICATION ) {
-					if ( !cmd->parameter().empty() ) {
-						NotificationLevel nl = NL_UNDEFINED;
-						QString message;
-
-						size_t p = cmd->parameter().find(' ');
-						if ( p != string::npos ) {
-							if ( cmd->parameter()[0] == '[' &&
-							     cmd->parameter()[p-1] == ']' ) {
-								nl.fromString(cmd->parameter().substr(1, p-2));
-								message = cmd->parameter().substr(p+1).c_str();
-							}
+	CommandMessage *cmd = CommandMessage::Cast(msg);
+	if ( cmd && _filterCommands ) {
+		QRegExp re(cmd->client().c_str());
+		if ( re.exactMatch(Client::Application::_settings.messaging.user.c_str()) ) {
+			if ( cmd->command() == CM_SHOW_NOTIFICATION ) {
+				if ( !cmd->parameter().empty() ) {
+					NotificationLevel nl = NL_UNDEFINED;
+					QString message;
+
+					size_t p = cmd->parameter().find(' ');
+					if ( p != string::npos ) {
+						if ( cmd->parameter()[0] == '[' &&
+						     cmd->parameter()[p-1] == ']' ) {
+							nl.fromString(cmd->parameter().substr(1, p-2));
+							message = cmd->parameter().substr(p+1).c_str();
 						}
-						else
-							message = cmd->parameter().c_str();
-
-						emit showNotification(nl, message);
 					}
-				}
+					else
+						message = cmd->parameter().c_str();
 
-				emit messageAvailable(cmd, pkt.get());
-			}
-			else {
-				SEISCOMP_DEBUG("Ignoring command message for client: %s, user is: %s",
-				               cmd->client().c_str(),
-				               Client::Application::_settings.messaging.user.c_str());
+					emit showNotification(nl, message);
+				}
 			}
 
-			continue;
+			emit messageAvailable(cmd, pkt);
+		}
+		else {
+			SEISCOMP_DEBUG("Ignoring command message for client: %s, user is: %s",
+			               cmd->client().c_str(),
+			               Client::Application::_settings.messaging.user.c_str());
 		}
 
-		emit messageAvailable(msg.get(), pkt.get());
+		return;
+	}
 
-		NotifierMessage* nm = NotifierMessage::Cast(msg);
+	emit messageAvailable(msg, pkt);
 
-		if ( isAutoApplyNotifierEnabled() ) {
-			if ( !nm ) {
-				for ( Core::MessageIterator it = msg->iter(); *it; ++it ) {
-					DataModel::Notifier* n = DataModel::Notifier::Cast(*it);
-					if ( n ) {
-						// SEISCOMP_DEBUG("Non persistent notifier for '%s'", n->parentID().c_str());
-						n->apply();
-					}
-				}
-			}
-			else {
-				for ( NotifierMessage::iterator it = nm->begin(); it != nm->end(); ++it ) {
-					// SEISCOMP_DEBUG("Notifier for '%s'", (*it)->parentID().c_str());
-					(*it)->apply();
-				}
-			}
-		}
+	NotifierMessage* nm = NotifierMessage::Cast(msg);
 
+	if ( isAutoApplyNotifierEnabled() ) {
 		if ( !nm ) {
 			for ( Core::MessageIterator it = msg->iter(); *it; ++it ) {
 				DataModel::Notifier* n = DataModel::Notifier::Cast(*it);
 				if ( n ) {
-					emitNotifier(n);
+					// SEISCOMP_DEBUG("Non persistent notifier for '%s'", n->parentID().c_str());
+					n->apply();
 				}
 			}
 		}
 		else {
-			for ( NotifierMessage::iterator it = nm->begin(); it != nm->end(); ++it )
-				emitNotifier(it->get());
+			for ( NotifierMessage::iterator it = nm->begin(); it != nm->end(); ++it ) {
+				// SEISCOMP_DEBUG("Notifier for '%s'", (*it)->parentID().c_str());
+				(*it)->apply();
+			}
 		}
 	}
+
+	if ( !nm ) {
+		for ( Core::MessageIterator it = msg->iter(); *it; ++it ) {
+			DataModel::Notifier* n = DataModel::Notifier::Cast(*it);
+			if ( n ) {
+				emitNotifier(n);
+			}
+		}
+	}
+	else {
+		for ( NotifierMessage::iterator it = nm->begin(); it != nm->end(); ++it )
+			emitNotifier(it->get());
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1655,6 +1700,8 @@ void Application::messagesAvailable() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::emitNotifier(Notifier* n) {
+	if ( query() ) query()->invalidateQueryCache(n);
+
 	emit notifierAvailable(n);
 	if ( isInterpretNotifierEnabled() ) {
 		switch ( n->operation() ) {
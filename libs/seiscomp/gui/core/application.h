@@ -288,6 +288,7 @@ class SC_GUI_API Application : public QObject, public Client::Application {
 	private:
 		void startMessageThread();
 		void closeMessageThread();
+		void handleMessage(Core::Message *msg, Client::Packet *pkt);
 		void createSettingsDialog();
 		ConnectionDialog *cdlg();
 
@@ -302,6 +303,10 @@ class SC_GUI_API Application : public QObject, public Client::Application {
 			bool        interactive{true};
 			std::string guiGroup{"GUI"};
 			std::string commandTargetClient;
+			//! The number of cached database query results
+			int         queryCacheSize{100};
+			//! The maximum age of a cached query result in seconds
+			double      queryCacheMaxAge{60};
 
 			struct _MapsDesc : MapsDesc {
 				_MapsDesc();
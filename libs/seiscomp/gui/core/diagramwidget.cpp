@@ -27,6 +27,7 @@
 #include <QMenu>
 #include <QHBoxLayout>
 #include <QKeySequence>
+#include <QHash>
 #include <cmath>
 #include <iostream>
 #include <cstdio>
@@ -98,6 +99,9 @@ DiagramWidget::DiagramWidget(QWidget * parent, Type type, Qt::WindowFlags f)
 	_dragStart = false;
 	_indicesChanged = false;
 	_hoverId = -1;
+	_lodThreshold = 10000;
+	_lastRubberBandOperation = Select;
+	_incrementalSelection = false;
 	_markerDistance = QPointF(0,0);
 	setMouseTracking(true);
 	_disabledColor = Qt::red;
@@ -175,6 +179,7 @@ DiagramWidget::~DiagramWidget() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void DiagramWidget::setType(Type t) {
 	_type = t;
+	_pickIndex.dirty = true;
 	switch ( _type ) {
 		case Rectangular:
 			project = &DiagramWidget::projectRectangular;
@@ -325,11 +330,23 @@ void DiagramWidget::drawValues(QPainter &painter) {
 	qreal capHalfWidth = halfSymbolSize * 0.5;
 	painter.setClipRect(_diagramArea);
 
+	_pickIndex.pendingIds.clear();
+	_pickIndex.pendingPositions.clear();
+
+	// The style of the last symbol drawn at a pixel if the level of
+	// detail is reduced
+	bool reduceDetail = _lodThreshold >= 0 && _values.size() > _lodThreshold;
+	QHash<quint64, quint64> pixelStyles;
+
 	for ( int id = 0; id < _values.size(); ++id ) {
 		const ValueItem &v = _values[id];
 		if ( !_displayRect.contains(v.pt(_xIndex,_yIndex)) )
 			continue;
 
+		QPointF vp = (this->*project)(v.pt(_xIndex,_yIndex));
+		_pickIndex.pendingIds.append(id);
+		_pickIndex.pendingPositions.append(vp);
+
 		if ( !v.isVisible ) continue;
 
 		QColor c;
@@ -345,9 +362,27 @@ void DiagramWidget::drawValues(QPainter &painter) {
 		else
 			painter.setBrush(c);
 
-		QPointF vp = (this->*project)(v.pt(_xIndex,_yIndex));
+		bool hasErrorBars = _drawErrorBars && (
+			v.cols[_xIndex].lowerError > 0 || v.cols[_xIndex].upperError > 0 ||
+			v.cols[_yIndex].lowerError > 0 || v.cols[_yIndex].upperError > 0
+		);
+
+		if ( reduceDetail && !hasErrorBars ) {
+			quint64 pixel = (quint64(quint32(qRound(vp.x()))) << 32) |
+			                quint32(qRound(vp.y()));
+			quint64 style = (quint64(c.rgba()) << 8) | (quint64(v.type) << 2) |
+			                (v.isEnabled ? 2 : 0) |
+			                (v.valid(_xIndex,_yIndex) ? 1 : 0);
+			auto it = pixelStyles.find(pixel);
+			if ( it != pixelStyles.end() ) {
+				if ( it.value() == style ) continue;
+				it.value() = style;
+			}
+			else
+				pixelStyles.insert(pixel, style);
+		}
 
-		if ( _drawErrorBars ) {
+		if ( hasErrorBars ) {
 			if ( v.cols[_xIndex].lowerError > 0 or v.cols[_xIndex].upperError > 0 ) {
 				// Draw X error bars
 				QPointF left, right;
@@ -424,6 +459,8 @@ void DiagramWidget::drawValues(QPainter &painter) {
 	}
 
 	painter.setClipping(false);
+
+	buildPickIndex();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -819,6 +856,7 @@ void DiagramWidget::mousePressEvent(QMouseEvent *event) {
 		}
 
 		saveStates();
+		_incrementalSelection = false;
 
 		_dragStart = true;
 		_dragging = false;
@@ -1133,6 +1171,26 @@ void DiagramWidget::setDisabledValuesHidden(bool f) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DiagramWidget::setLevelOfDetailThreshold(int count) {
+	if ( _lodThreshold == count ) return;
+	_lodThreshold = count;
+	update();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int DiagramWidget::levelOfDetailThreshold() const {
+	return _lodThreshold;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void DiagramWidget::setDrawGridLines(bool f) {
 	_drawGridLines = f;
@@ -1598,6 +1656,7 @@ void DiagramWidget::setMarkerDistance(QPointF distances) {
 void DiagramWidget::clear() {
 	_hoverId = -1;
 	_values.clear();
+	_pickIndex.dirty = true;
 	_boundingRect = QRectF();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1760,6 +1819,7 @@ void DiagramWidget::selectValues(const QRectF& targetRect) {
 	update();
 
 	_rubberBand = tmp;
+	_incrementalSelection = false;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1776,6 +1836,7 @@ void DiagramWidget::setValue(int id, int x, qreal v,
 	}
 
 	_values[id].cols[x].value = v;
+	_pickIndex.dirty = true;
 	_values[id].cols[x].lowerError = lowerError;
 	_values[id].cols[x].upperError = upperError;
 	_values[id].cols[x].defaultError = defaultError;
@@ -1793,6 +1854,7 @@ void DiagramWidget::setValue(int id, const QPointF& p) {
 	}
 
 	_values[id].setPt(_xIndex,_yIndex, p);
+	_pickIndex.dirty = true;
 	update();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1808,6 +1870,7 @@ void DiagramWidget::setValue(int id, int x, int y, const QPointF& p) {
 	}
 
 	_values[id].setPt(x,y, p);
+	_pickIndex.dirty = true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -2139,8 +2202,118 @@ void DiagramWidget::checkSelection(int id) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void DiagramWidget::updateSelection() {
 	if ( _dragZoom ) return;
-	for ( int i = 0; i < _values.count(); ++i )
-		checkSelection(i);
+
+	// While dragging with the same operation only the values inside the
+	// previous or the current rubber band can change their state
+	if ( _dragging && _incrementalSelection && _type == Rectangular &&
+	     _rubberBandOperation == _lastRubberBandOperation &&
+	     isPickIndexValid() ) {
+		QRectF current = _rubberBand.normalized();
+		QRectF last = _lastRubberBand.normalized();
+		QPointF topLeft(qMin(current.left(), last.left()),
+		                qMin(current.top(), last.top()));
+		QPointF bottomRight(qMax(current.right(), last.right()),
+		                    qMax(current.bottom(), last.bottom()));
+
+		QRect area = QRectF((this->*project)(topLeft),
+		                    (this->*project)(bottomRight))
+		             .normalized().toAlignedRect().adjusted(-1,-1,1,1);
+
+		QVector<int> entries;
+		pickCandidates(area, entries);
+		for ( int entry : entries )
+			checkSelection(_pickIndex.ids[entry]);
+	}
+	else {
+		for ( int i = 0; i < _values.count(); ++i )
+			checkSelection(i);
+	}
+
+	_lastRubberBand = _rubberBand;
+	_lastRubberBandOperation = _rubberBandOperation;
+	_incrementalSelection = _dragging;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DiagramWidget::isPickIndexValid() const {
+	return !_pickIndex.dirty
+	    && _pickIndex.count == _values.count()
+	    && _pickIndex.xIndex == _xIndex
+	    && _pickIndex.yIndex == _yIndex
+	    && _pickIndex.displayRect == _displayRect
+	    && _pickIndex.diagramArea == _diagramArea;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DiagramWidget::buildPickIndex() {
+	PickIndex &index = _pickIndex;
+
+	index.displayRect = _displayRect;
+	index.diagramArea = _diagramArea;
+	index.xIndex = _xIndex;
+	index.yIndex = _yIndex;
+	index.count = _values.count();
+	index.dirty = false;
+
+	index.cellSize = qMax(symbolSize, 1);
+	index.columns = qMax(_diagramArea.width() / index.cellSize + 1, 1);
+	index.rows = qMax(_diagramArea.height() / index.cellSize + 1, 1);
+
+	auto cell = [this, &index](const QPointF &p) {
+		int col = qBound(0, int(floor((p.x() - _diagramArea.left()) / index.cellSize)),
+		                 index.columns-1);
+		int row = qBound(0, int(floor((p.y() - _diagramArea.top()) / index.cellSize)),
+		                 index.rows-1);
+		return row*index.columns + col;
+	};
+
+	// Counting sort of the collected entries by cell
+	int entryCount = index.pendingIds.count();
+	index.offsets.fill(0, index.columns*index.rows+1);
+	for ( int i = 0; i < entryCount; ++i )
+		++index.offsets[cell(index.pendingPositions[i])+1];
+
+	for ( int i = 1; i < index.offsets.count(); ++i )
+		index.offsets[i] += index.offsets[i-1];
+
+	QVector<int> fill(index.offsets);
+	index.ids.resize(entryCount);
+	index.positions.resize(entryCount);
+	for ( int i = 0; i < entryCount; ++i ) {
+		int pos = fill[cell(index.pendingPositions[i])]++;
+		index.ids[pos] = index.pendingIds[i];
+		index.positions[pos] = index.pendingPositions[i];
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DiagramWidget::pickCandidates(const QRect &rect, QVector<int> &entries) const {
+	// Appends the index entries of all cells overlapping rect, positions
+	// outside the diagram area are stored in the border cells
+	const PickIndex &index = _pickIndex;
+	int left = qBound(0, (int)floor(double(rect.left() - _diagramArea.left()) / index.cellSize), index.columns-1);
+	int right = qBound(0, (int)floor(double(rect.right() - _diagramArea.left()) / index.cellSize), index.columns-1);
+	int top = qBound(0, (int)floor(double(rect.top() - _diagramArea.top()) / index.cellSize), index.rows-1);
+	int bottom = qBound(0, (int)floor(double(rect.bottom() - _diagramArea.top()) / index.cellSize), index.rows-1);
+
+	for ( int row = top; row <= bottom; ++row ) {
+		int from = index.offsets[row*index.columns+left];
+		int to = index.offsets[row*index.columns+right+1];
+		for ( int i = from; i < to; ++i )
+			entries.append(i);
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -2163,6 +2336,32 @@ int DiagramWidget::findValue(const QPoint& p) const {
 	int mindist = -1;
 	int minid = -1;
 
+	if ( isPickIndexValid() ) {
+		QVector<int> entries;
+		pickCandidates(QRect(p.x()-symbolSize, p.y()-symbolSize,
+		                     2*symbolSize+1, 2*symbolSize+1), entries);
+
+		for ( int entry : entries ) {
+			int i = _pickIndex.ids[entry];
+			if ( !_values[i].isVisible ||
+			     !_values[i].cols[_xIndex].valid ||
+			     !_values[i].cols[_yIndex].valid ) continue;
+
+			if ( _mode != SelectEnableState && !_values[i].isEnabled ) continue;
+
+			int d = dist(_pickIndex.positions[entry],p);
+			if ( d < mindist || mindist == -1 || (d == mindist && i < minid) ) {
+				mindist = d;
+				minid = i;
+			}
+		}
+
+		if ( mindist >= 0 && mindist < symbolSize )
+			return minid;
+
+		return -1;
+	}
+
 	for ( int i = 0; i < _values.count(); ++i ) {
 		if ( !_values[i].isVisible ||
 		     !_values[i].cols[_xIndex].valid ||
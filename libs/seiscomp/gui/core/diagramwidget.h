@@ -188,6 +188,16 @@ class SC_GUI_API DiagramWidget : public QWidget {
 
 		int hoveredValue() const { return _hoverId; }
 
+		/**
+		 * @brief Sets the number of values above which a value is not drawn
+		 *        if the previous value drawn at the same pixel has an
+		 *        identical symbol. Values with error bars are always drawn.
+		 *        A negative count disables it, the default is 10000.
+		 * @param count The number of values
+		 */
+		void setLevelOfDetailThreshold(int count);
+		int levelOfDetailThreshold() const;
+
 
 	public slots:
 		void setDrawErrorBars(bool);
@@ -252,6 +262,10 @@ class SC_GUI_API DiagramWidget : public QWidget {
 		void checkSelection(int id);
 		void updateSelection();
 
+		bool isPickIndexValid() const;
+		void buildPickIndex();
+		void pickCandidates(const QRect &rect, QVector<int> &ids) const;
+
 		void saveStates();
 		void updateDiagramArea();
 
@@ -316,6 +330,32 @@ class SC_GUI_API DiagramWidget : public QWidget {
 			SelectMinus
 		};
 
+		// Screen space grid of all values inside the display rect which is
+		// built while drawing. It is only valid as long as the projection
+		// and the values have not changed.
+		struct PickIndex {
+			QRectF           displayRect;
+			QRect            diagramArea;
+			int              xIndex{-1};
+			int              yIndex{-1};
+			int              count{-1};
+			bool             dirty{true};
+
+			int              cellSize{1};
+			int              columns{0};
+			int              rows{0};
+			// Offsets of the cells into ids and positions, the cell at
+			// row r and column c holds the range
+			// [offsets[r*columns+c], offsets[r*columns+c+1])
+			QVector<int>     offsets;
+			QVector<int>     ids;
+			QVector<QPointF> positions;
+
+			// Unsorted entries collected while drawing
+			QVector<int>     pendingIds;
+			QVector<QPointF> pendingPositions;
+		};
+
 		QString _nameX;
 		QString _nameY;
 
@@ -367,6 +407,14 @@ class SC_GUI_API DiagramWidget : public QWidget {
 
 		int _hoverId;
 
+		int  _lodThreshold;
+		PickIndex _pickIndex;
+		// The rubber band and operation of the last selection update while
+		// dragging, see updateSelection
+		QRectF _lastRubberBand;
+		RubberBandOperation _lastRubberBandOperation;
+		bool _incrementalSelection;
+
 		QAction* _zoomAction;
 		QAction* _resetAction;
 		QAction* _toggleUncertainties;
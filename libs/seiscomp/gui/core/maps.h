@@ -45,8 +45,10 @@ namespace Gui {
  *     with type Tile
  * 4 - Add two new methods to notify about asynchronous tile loading
  *     success and cancellation
+ * 5 - Add TileStore::setViewCenter to prioritize asynchronous requests
+ *   - Add MapsDesc::loaderThreads
  */
-#define TILESTORE_VERSION 4
+#define TILESTORE_VERSION 5
 
 
 struct SC_GUI_API MapsDesc {
@@ -54,6 +56,9 @@ struct SC_GUI_API MapsDesc {
 	QString type;
 	bool    isMercatorProjected;
 	size_t  cacheSize;
+	//! The number of threads used to decode tiles of a tile directory.
+	//! 0 loads the tiles synchronously.
+	int     loaderThreads;
 };
 
 
@@ -36,6 +36,7 @@ namespace Gui {
 
 MessageThread::MessageThread(Seiscomp::Client::Connection* c)
 : _reconnectOnError(false)
+, _decode(false)
 , _connection(c) {}
 
 
@@ -45,6 +46,55 @@ void MessageThread::setReconnectOnErrorEnabled(bool e) {
 }
 
 
+void MessageThread::setDecodingEnabled(bool e) {
+	_decode = e;
+}
+
+
+bool MessageThread::isDecodingEnabled() const {
+	return _decode;
+}
+
+
+bool MessageThread::takeMessage(Seiscomp::Core::MessagePtr &msg,
+                                Seiscomp::Client::PacketPtr &packet) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if ( _decoded.empty() ) return false;
+
+	msg = _decoded.front().msg;
+	packet = _decoded.front().packet;
+	_decoded.pop_front();
+	return true;
+}
+
+
+void MessageThread::decodeInbox() {
+	while ( _connection->inboxSize() > 0 ) {
+		Item item;
+		item.packet = _connection->recvPacket();
+		if ( !item.packet ) break;
+
+		// Decoding creates all objects of the message, only applying them
+		// is left to the GUI thread
+		if ( item.packet->type == Packet::Data )
+			item.msg = Connection::decode(item.packet.get());
+
+		bool notify;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			notify = _decoded.empty();
+			_decoded.push_back(item);
+		}
+
+		// The receiver takes all pending messages, one notification per
+		// batch is sufficient
+		if ( notify )
+			emit messagesAvailable();
+	}
+}
+
+
 MessageThread::~MessageThread() {
 	SEISCOMP_INFO("destroying message thread");
 }
@@ -54,13 +104,19 @@ void MessageThread::run() {
 	Result result;
 
 	SEISCOMP_INFO("starting message thread");
-	emit messagesAvailable();
+	if ( _decode )
+		decodeInbox();
+	else
+		emit messagesAvailable();
 
 	while ( true ) {
 		//SEISCOMP_DEBUG("Automatic reconnect: %d", _reconnectOnError);
 		result = _connection->fetchInbox();
 		if ( result == OK ) {
-			emit messagesAvailable();
+			if ( _decode )
+				decodeInbox();
+			else
+				emit messagesAvailable();
 		}
 		else {
 			if ( _connection->isConnected() ) {
@@ -29,6 +29,9 @@
 
 #include <QtGui>
 
+#include <deque>
+#include <mutex>
+
 
 namespace Seiscomp {
 namespace Gui {
@@ -46,6 +49,19 @@ class SC_GUI_API MessageThread : public QThread {
 		Seiscomp::Client::Connection *connection() const;
 		void setReconnectOnErrorEnabled(bool e);
 
+		//! Enables decoding of the received messages in this thread. The
+		//! messages must then be read with takeMessage instead of from the
+		//! connection. Must be called before the thread is started.
+		void setDecodingEnabled(bool e);
+		bool isDecodingEnabled() const;
+
+		//! Returns the next decoded message and its packet in the order of
+		//! reception. The message is nullptr if the packet does not carry
+		//! a message or cannot be decoded. Returns false if nothing is
+		//! pending. Can be called from any thread.
+		bool takeMessage(Seiscomp::Core::MessagePtr &msg,
+		                 Seiscomp::Client::PacketPtr &packet);
+
 
 	signals:
 		void messagesAvailable();
@@ -55,8 +71,22 @@ class SC_GUI_API MessageThread : public QThread {
 
 
 	private:
+		//! Decodes all packets of the connection inbox
+		void decodeInbox();
+
+
+	private:
+		struct Item {
+			Seiscomp::Core::MessagePtr  msg;
+			Seiscomp::Client::PacketPtr packet;
+		};
+
 		bool _reconnectOnError;
+		bool _decode;
 		Seiscomp::Client::Connection *_connection;
+
+		std::mutex        _mutex;
+		std::deque<Item>  _decoded;
 };
 
 
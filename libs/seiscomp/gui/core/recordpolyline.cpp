@@ -20,6 +20,7 @@
 
 
 #include <seiscomp/gui/core/recordpolyline.h>
+#include <seiscomp/gui/core/recordpyramid.h>
 #include <iostream>
 
 
@@ -132,6 +133,51 @@ void RecordPolyline::create(RecordSequence const *records,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+/**
+ * Collects the blocks of the best fitting summary level which cover the
+ * samples [ofs,ofs+count) of a record as alternating minimum and maximum
+ * pseudo samples. step is set to the number of samples between two pseudo
+ * samples and shift to the number of samples the first pseudo sample lies
+ * before ofs. Returns false if the record must be drawn from its samples.
+ */
+bool collectBlocks(const RecordPyramid *pyramid, const Record *rec,
+                   double samplesPerPixel, int ofs, int count,
+                   vector<double> &samples, int &shift, double &step) {
+	if ( !pyramid ) return false;
+
+	int level = pyramid->level(samplesPerPixel);
+	if ( level < 0 ) return false;
+
+	const RecordPyramid::Summary *summary = pyramid->summary(rec);
+	if ( !summary || summary->levels.empty() || summary->sampleCount < ofs + count )
+		return false;
+
+	level = min(level, static_cast<int>(summary->levels.size()) - 1);
+	const RecordPyramid::Level &blocks = summary->levels[level];
+	int size = pyramid->blockSize(level);
+	int first = ofs / size;
+	int last = (ofs + count - 1) / size;
+
+	samples.clear();
+	for ( int b = first; b <= last; ++b ) {
+		samples.push_back(blocks[b].min);
+		samples.push_back(blocks[b].max);
+	}
+
+	shift = ofs - first * size;
+	step = size * 0.5;
+	return true;
+}
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void RecordPolyline::create(RecordSequence const *records,
                             const Core::Time &start,
@@ -140,7 +186,8 @@ void RecordPolyline::create(RecordSequence const *records,
                             double amplMin, double amplMax, double amplOffset,
                             int height, float *timingQuality,
                             QVector<QPair<int,int> >* gaps,
-                            bool optimization) {
+                            bool optimization,
+                            const RecordPyramid *pyramid) {
 	clear();
 
 	if ( records == nullptr ) return;
@@ -180,6 +227,11 @@ void RecordPolyline::create(RecordSequence const *records,
 	double startOfs = 0;
 	double endOfs = 0;
 
+	// Block summaries of the pyramid in use
+	vector<double> blockSamples;
+	int blockShift = 0;
+	double blockStep = 0;
+
 	for( ; it != records->end(); ++it ) {
 		const Record *rec = it->get();
 		const Record *lastRec = lastIt->get();
@@ -235,7 +287,21 @@ void RecordPolyline::create(RecordSequence const *records,
 			if ( nsamp <= 0 ) continue;
 		}
 
-		if ( rec->data()->dataType() == Array::FLOAT ) {
+		if ( optimization
+		  && collectBlocks(pyramid, rec, rec->samplingFrequency() / pixelPerSecond,
+		                   sampleOfs, nsamp, blockSamples, blockShift, blockStep) ) {
+			pushRecord(
+				poly,
+				blockSamples.data(),
+				static_cast<int>(blockSamples.size()), poly && diff <= tolerance,
+				yscl, amplOffset, optimization,
+				static_cast<int>(pixelPerSecond * (startOfs + blockShift * dt)),
+				pixelPerSecond * dt * blockStep,
+				collapsedSamples,
+				y_min, y_max, x_out, y_out, x_pos, y_pos
+			);
+		}
+		else if ( rec->data()->dataType() == Array::FLOAT ) {
 			pushRecord(
 				poly,
 				static_cast<const FloatArray*>(rec->data())->typedData() + sampleOfs,
@@ -856,7 +922,8 @@ void RecordPolylineF::create(RecordSequence const *records,
                              double amplMin, double amplMax, double amplOffset,
                              int height, float *timingQuality,
                              QVector<QPair<qreal,qreal> >* gaps,
-                             bool optimization) {
+                             bool optimization,
+                             const RecordPyramid *pyramid) {
 	clear();
 
 	if ( records == nullptr ) return;
@@ -896,6 +963,11 @@ void RecordPolylineF::create(RecordSequence const *records,
 	double startOfs = 0;
 	double endOfs = 0;
 
+	// Block summaries of the pyramid in use
+	vector<double> blockSamples;
+	int blockShift = 0;
+	double blockStep = 0;
+
 	for ( ; it != records->end(); ++it ) {
 		const Record *rec = it->get();
 		const Record *lastRec = lastIt->get();
@@ -951,7 +1023,21 @@ void RecordPolylineF::create(RecordSequence const *records,
 			if ( nsamp <= 0 ) continue;
 		}
 
-		if ( rec->data()->dataType() == Array::FLOAT ) {
+		if ( optimization
+		  && collectBlocks(pyramid, rec, rec->samplingFrequency() / pixelPerSecond,
+		                   sampleOfs, nsamp, blockSamples, blockShift, blockStep) ) {
+			pushRecord(
+				poly,
+				blockSamples.data(),
+				static_cast<int>(blockSamples.size()), poly && diff <= tolerance,
+				yscl, amplOffset, optimization,
+				pixelPerSecond * (startOfs + blockShift * dt),
+				pixelPerSecond * dt * blockStep,
+				collapsedSamples,
+				y_min, y_max, x_out, y_out, x_pos, y_pos
+			);
+		}
+		else if ( rec->data()->dataType() == Array::FLOAT ) {
 			pushRecord(
 				poly,
 				static_cast<const FloatArray*>(rec->data())->typedData() + sampleOfs,
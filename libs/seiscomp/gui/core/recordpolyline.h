@@ -40,6 +40,9 @@ namespace Seiscomp {
 namespace Gui {
 
 
+class RecordPyramid;
+
+
 DEFINE_SMARTPOINTER(AbstractRecordPolyline);
 class SC_GUI_API AbstractRecordPolyline : public Seiscomp::Core::BaseObject {
 	public:
@@ -78,6 +81,11 @@ class SC_GUI_API RecordPolyline : public AbstractRecordPolyline,
 		            QVector<QPair<int,int> >* gaps = nullptr,
 		            bool optimization = true);
 
+		//! Creates the polyline of the records in the time window
+		//! [start:end]. If optimization is enabled and a pyramid is
+		//! passed then records with many samples per pixel are drawn
+		//! from its block summaries. The pyramid must have been updated
+		//! with the given sequence.
 		void create(RecordSequence const *,
 		            const Core::Time &start,
 		            const Core::Time &end,
@@ -85,7 +93,8 @@ class SC_GUI_API RecordPolyline : public AbstractRecordPolyline,
 		            double amplMin, double amplMax, double amplOffset,
 		            int height, float *timingQuality = nullptr,
 		            QVector<QPair<int,int> >* gaps = nullptr,
-		            bool optimization = true);
+		            bool optimization = true,
+		            const RecordPyramid *pyramid = nullptr);
 
 		void createStepFunction(RecordSequence const *, double pixelPerSecond,
 		                        double amplMin, double amplMax, double amplOffset,
@@ -149,6 +158,11 @@ class SC_GUI_API RecordPolylineF : public AbstractRecordPolyline,
 		            QVector<QPair<qreal,qreal> >* gaps = nullptr,
 		            bool optimization = true);
 
+		//! Creates the polyline of the records in the time window
+		//! [start:end]. If optimization is enabled and a pyramid is
+		//! passed then records with many samples per pixel are drawn
+		//! from its block summaries. The pyramid must have been updated
+		//! with the given sequence.
 		void create(RecordSequence const *,
 		            const Core::Time &start,
 		            const Core::Time &end,
@@ -156,7 +170,8 @@ class SC_GUI_API RecordPolylineF : public AbstractRecordPolyline,
 		            double amplMin, double amplMax, double amplOffset,
 		            int height, float *timingQuality = nullptr,
 		            QVector<QPair<qreal,qreal> >* gaps = nullptr,
-		            bool optimization = true);
+		            bool optimization = true,
+		            const RecordPyramid *pyramid = nullptr);
 
 		// Returns the number of points
 		int points() const;
@@ -0,0 +1,226 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/gui/core/recordpyramid.h>
+#include <seiscomp/core/typedarray.h>
+
+#include <algorithm>
+
+
+namespace Seiscomp {
+namespace Gui {
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordPyramid::RecordPyramid(int blockSize, int factor)
+: _blockSize(std::max(blockSize, 2))
+, _factor(std::max(factor, 2)) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordPyramid::update(const RecordSequence *records) {
+	if ( !records ) {
+		clear();
+		return;
+	}
+
+	// Redraws without new records only compare the record pointers. Only
+	// the last record may grow, e.g. the current chunk of a
+	// ChunkedRingBuffer.
+	if ( !_records.empty() && records->size() == _records.size() ) {
+		bool unchanged = true;
+		size_t i = 0;
+		for ( const auto &rec : *records ) {
+			if ( rec != _records[i++] ) {
+				unchanged = false;
+				break;
+			}
+		}
+
+		if ( unchanged ) {
+			const Record *rec = _records.back().get();
+			auto it = _summaries.find(rec);
+			if ( it == _summaries.end() || !rec->data()
+			  || it->second.sampleCount == rec->data()->size() )
+				return;
+		}
+	}
+
+	Summaries summaries;
+	summaries.reserve(records->size());
+	std::vector<RecordCPtr> refs(records->begin(), records->end());
+
+	for ( const auto &ptr : *records ) {
+		const Record *rec = ptr.get();
+		const Array *data = rec->data();
+
+		if ( !data ) continue;
+
+		Summary summary;
+		auto it = _summaries.find(rec);
+		if ( it != _summaries.end() && it->second.startTime == rec->startTime()
+		  && it->second.sampleCount <= data->size() )
+			summary = std::move(it->second);
+		else
+			summary.startTime = rec->startTime();
+
+		switch ( data->dataType() ) {
+			case Array::FLOAT:
+				summarize(summary, static_cast<const FloatArray*>(data)->typedData(), data->size());
+				break;
+			case Array::DOUBLE:
+				summarize(summary, static_cast<const DoubleArray*>(data)->typedData(), data->size());
+				break;
+			default:
+				continue;
+		}
+
+		summaries.emplace(rec, std::move(summary));
+	}
+
+	_summaries.swap(summaries);
+	_records.swap(refs);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordPyramid::clear() {
+	_summaries.clear();
+	_records.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int RecordPyramid::blockSize(size_t level) const {
+	int size = _blockSize;
+	for ( size_t i = 0; i < level; ++i )
+		size *= _factor;
+	return size;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int RecordPyramid::level(double samplesPerPixel) const {
+	int level = -1;
+	double size = _blockSize;
+
+	while ( size * 2 <= samplesPerPixel ) {
+		++level;
+		size *= _factor;
+	}
+
+	return level;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const RecordPyramid::Summary *RecordPyramid::summary(const Record *rec) const {
+	auto it = _summaries.find(rec);
+	if ( it == _summaries.end() ) return nullptr;
+	return &it->second;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void RecordPyramid::summarize(Summary &summary, const T *data, int count) const {
+	if ( count <= 0 ) {
+		summary.levels.clear();
+		summary.sampleCount = 0;
+		return;
+	}
+
+	if ( summary.levels.empty() )
+		summary.levels.resize(1);
+
+	// The last block of each level may have been incomplete and is
+	// computed again together with all new blocks
+	Level &first = summary.levels[0];
+	size_t changed = summary.sampleCount / _blockSize;
+	first.resize((count + _blockSize - 1) / _blockSize);
+
+	for ( size_t b = changed; b < first.size(); ++b ) {
+		int start = static_cast<int>(b) * _blockSize;
+		int end = std::min(start + _blockSize, count);
+		Block block{static_cast<double>(data[start]), static_cast<double>(data[start])};
+		for ( int i = start + 1; i < end; ++i ) {
+			if ( data[i] < block.min ) block.min = data[i];
+			else if ( data[i] > block.max ) block.max = data[i];
+		}
+		first[b] = block;
+	}
+
+	for ( size_t l = 1; summary.levels[l-1].size() > 1; ++l ) {
+		if ( l == summary.levels.size() ) {
+			summary.levels.emplace_back();
+			changed = 0;
+		}
+		else
+			changed /= _factor;
+
+		const Level &lower = summary.levels[l-1];
+		Level &level = summary.levels[l];
+		level.resize((lower.size() + _factor - 1) / _factor);
+
+		for ( size_t b = changed; b < level.size(); ++b ) {
+			size_t start = b * _factor;
+			size_t end = std::min(start + _factor, lower.size());
+			Block block = lower[start];
+			for ( size_t i = start + 1; i < end; ++i ) {
+				block.min = std::min(block.min, lower[i].min);
+				block.max = std::max(block.max, lower[i].max);
+			}
+			level[b] = block;
+		}
+	}
+
+	summary.sampleCount = count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
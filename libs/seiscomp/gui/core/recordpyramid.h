@@ -0,0 +1,134 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_GUI_RECORDPYRAMID_H
+#define SEISCOMP_GUI_RECORDPYRAMID_H
+
+
+#ifndef Q_MOC_RUN
+#include <seiscomp/core/record.h>
+#include <seiscomp/core/recordsequence.h>
+#endif
+#include <seiscomp/gui/qt.h>
+
+#include <unordered_map>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Gui {
+
+
+/**
+ * @brief Multi-resolution minimum/maximum summaries of the records of a
+ *        record sequence.
+ *
+ * Each float or double record is summarized in levels of blocks. The first
+ * level holds the minimum and maximum of blockSize samples, each following
+ * level combines factor blocks of the previous level until one block
+ * covers the whole record. Drawing a record with many samples per pixel
+ * then only needs to visit the blocks of the best fitting level.
+ *
+ * update() synchronizes the summaries with the sequence. Summaries of
+ * records which are still part of the sequence are kept, only new records
+ * and samples appended to a record are summarized.
+ */
+class SC_GUI_API RecordPyramid {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct Block {
+			double min;
+			double max;
+		};
+
+		typedef std::vector<Block> Level;
+
+		struct Summary {
+			Core::Time         startTime;
+			int                sampleCount{0};
+			std::vector<Level> levels;
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		RecordPyramid(int blockSize = 32, int factor = 4);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Synchronizes the summaries with the records of a sequence
+		void update(const RecordSequence *records);
+
+		//! Removes all summaries
+		void clear();
+
+		//! Returns the number of samples of a block of the given level
+		int blockSize(size_t level) const;
+
+		/**
+		 * @brief Returns the level with the largest blocks which still
+		 *        resolves the given number of samples per pixel in at
+		 *        least two blocks.
+		 * @return The level or a negative number if the samples should be
+		 *         drawn directly
+		 */
+		int level(double samplesPerPixel) const;
+
+		//! Returns the summary of a record of the last updated sequence
+		//! or nullptr if the record is not summarized
+		const Summary *summary(const Record *rec) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		template <typename T>
+		void summarize(Summary &summary, const T *data, int count) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		typedef std::unordered_map<const Record*, Summary> Summaries;
+
+		int                     _blockSize;
+		int                     _factor;
+		Summaries               _summaries;
+		// References of the summarized records which keep the keys of
+		// the summaries valid
+		std::vector<RecordCPtr> _records;
+};
+
+
+}
+}
+
+
+#endif
@@ -46,8 +46,14 @@ RecordStreamThread::RecordStreamThread(const std::string& recordStreamURL)
 	_readingStreams = false;
 	_dataType = Array::FLOAT;
 	_recordHint = Record::DATA_ONLY;
+	_batchInterval = 0;
+
+	_batchTimer = new QTimer(this);
+	_batchTimer->setSingleShot(true);
+	QObject::connect(_batchTimer, SIGNAL(timeout()), this, SLOT(flushBatch()));
 
 	qRegisterMetaType<Seiscomp::RecordPtr>("Seiscomp::RecordPtr");
+	qRegisterMetaType<Seiscomp::Gui::RecordBatch>("Seiscomp::Gui::RecordBatch");
 
 	++_numberOfThreads;
 }
@@ -263,7 +269,7 @@ void RecordStreamThread::run()
 
 				try {
 					rec->endTime();
-					emit receivedRecord(rec);
+					deliver(rec);
 				}
 				catch ( ... ) {
 					SEISCOMP_ERROR("[rthread %d] Skipping invalid record for %s.%s.%s.%s (fsamp: %0.2f, nsamp: %d)",
@@ -371,6 +377,72 @@ void RecordStreamThread::setRecordHint(Record::Hint hint) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordStreamThread::setBatchInterval(int ms) {
+	_batchInterval = ms;
+	if ( _batchInterval > 0 )
+		_batchTimer->setInterval(_batchInterval);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int RecordStreamThread::batchInterval() const {
+	return _batchInterval;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordStreamThread::deliver(Record *rec) {
+	if ( _batchInterval <= 0 ) {
+		emit receivedRecord(rec);
+		return;
+	}
+
+	bool first;
+
+	_batchMutex.lock();
+	first = _batch.isEmpty();
+	_batch.append(rec);
+	_batchMutex.unlock();
+
+	// Only the first record of a batch posts an event to the thread of
+	// this object which starts the timer, all others are just queued
+	if ( first )
+		QMetaObject::invokeMethod(_batchTimer, "start", Qt::QueuedConnection);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordStreamThread::flushBatch() {
+	RecordBatch batch;
+
+	_batchMutex.lock();
+	batch.swap(_batch);
+	_batchMutex.unlock();
+
+	if ( batch.isEmpty() ) return;
+
+	emit receivedRecords(batch);
+
+	if ( receivers(SIGNAL(receivedRecord(Seiscomp::Record*))) > 0 ) {
+		for ( const RecordPtr &rec : batch )
+			emit receivedRecord(rec.get());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordStreamState RecordStreamState::_instance;
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
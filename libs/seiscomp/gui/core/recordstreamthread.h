@@ -35,6 +35,10 @@
 namespace Seiscomp {
 namespace Gui {
 
+
+typedef QVector<Seiscomp::RecordPtr> RecordBatch;
+
+
 //! \brief This class provides a thread to receive records from
 //! \brief a stream source.
 class SC_GUI_API RecordStreamThread : public QThread {
@@ -94,6 +98,16 @@ class SC_GUI_API RecordStreamThread : public QThread {
 		//! Returns the current recordthread ID
 		int ID() const;
 
+		//! Sets the interval in milliseconds records are collected for
+		//! before they are delivered with receivedRecords. A value of 0
+		//! (default) delivers each record with receivedRecord.
+		//! NOTE: The interval must be set before calling run() to have any
+		//! impact.
+		void setBatchInterval(int ms);
+
+		//! Returns the batch interval in milliseconds
+		int batchInterval() const;
+
 
 	signals:
 		//! This signal will be fired whenever a new record has been
@@ -103,6 +117,13 @@ class SC_GUI_API RecordStreamThread : public QThread {
 		//! the stream source.
 		void receivedRecord(Seiscomp::Record*);
 
+		//! This signal will be fired in batch mode with all records
+		//! read from the stream source within the batch interval. It is
+		//! emitted from the thread this object lives in, mostly the GUI
+		//! thread. If receivedRecord is connected as well, it is fired
+		//! for each record of the batch afterwards.
+		void receivedRecords(const Seiscomp::Gui::RecordBatch &);
+
 		//! This signal will be fired if an error occurs.
 		void handleError(const QString &);
 
@@ -111,6 +132,14 @@ class SC_GUI_API RecordStreamThread : public QThread {
 		void run();
 
 
+	private slots:
+		void flushBatch();
+
+
+	private:
+		void deliver(Record *rec);
+
+
 	private:
 		typedef std::map<std::string, double> GainMap;
 		int                                   _id;
@@ -123,6 +152,10 @@ class SC_GUI_API RecordStreamThread : public QThread {
 		GainMap                               _gainMap;
 		Array::DataType                       _dataType;
 		Record::Hint                          _recordHint;
+		int                                   _batchInterval;
+		QTimer                               *_batchTimer;
+		QMutex                                _batchMutex;
+		RecordBatch                           _batch;
 };
 
 
@@ -162,4 +195,8 @@ class SC_GUI_API RecordStreamState : public QObject {
 } // namespace Gui
 } // namespace Seiscomp
 
+
+Q_DECLARE_METATYPE(Seiscomp::Gui::RecordBatch)
+
+
 #endif
@@ -29,6 +29,7 @@
 #include <seiscomp/gui/core/recordstreamthread.h>
 #include <seiscomp/math/filter.h>
 
+#include <algorithm>
 #include <limits>
 
 #include <QApplication>
@@ -37,6 +38,7 @@
 #include <QDateTime>
 #include <QPainter>
 #include <QAction>
+#include <QRunnable>
 
 
 using namespace std;
@@ -377,6 +379,23 @@ class ItemWidget : public QWidget {
 };
 
 
+class TraceUpdater : public QRunnable {
+	public:
+		TraceUpdater(const QVector<RecordWidget*> &widgets, QAtomicInt &next)
+		: _widgets(widgets), _next(next) {}
+
+		void run() override {
+			int i;
+			while ( (i = _next.fetchAndAddRelaxed(1)) < _widgets.size() )
+				_widgets[i]->updateTraces();
+		}
+
+	private:
+		const QVector<RecordWidget*> &_widgets;
+		QAtomicInt                   &_next;
+};
+
+
 }
 
 namespace Seiscomp {
@@ -646,6 +665,8 @@ void RecordView::setupUi() {
 	_recordBorderDrawMode = SCScheme.records.recordBorders.drawMode;
 	_autoScale = false;
 	_autoMaxScale = false;
+	_concurrentRendering = false;
+	_renderPool = nullptr;
 
 	_thread = nullptr;
 
@@ -1014,6 +1035,55 @@ void RecordView::setAutoInsertItem(bool enable) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordView::setConcurrentRendering(bool enable) {
+	_concurrentRendering = enable;
+
+	if ( _concurrentRendering && !_renderPool )
+		_renderPool = new QThreadPool(this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordView::updateTraces() {
+	QVector<RecordWidget*> widgets;
+
+	for ( RecordViewItem *item : _rows ) {
+		if ( !item->isVisible() ) continue;
+
+		RecordWidget *w = item->widget();
+		if ( w->visibleRegion().isEmpty() ) continue;
+
+		// Evicted records must be reloaded in this thread before the
+		// polylines are built concurrently
+		w->restoreRecords();
+		if ( !w->hasDirtyTraces() ) continue;
+
+		widgets.append(w);
+	}
+
+	if ( widgets.size() < 2 ) return;
+
+	// The calling thread takes part and waits until all polylines are
+	// created. Records are fed in this thread only, so the sequences
+	// do not change meanwhile.
+	QAtomicInt next(0);
+	int threads = std::min(_renderPool->maxThreadCount(), widgets.size()-1);
+
+	for ( int i = 0; i < threads; ++i )
+		_renderPool->start(new TraceUpdater(widgets, next));
+
+	TraceUpdater(widgets, next).run();
+	_renderPool->waitForDone();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void RecordView::showAllRecords(bool enable) {
 	if ( _showAllRecords == enable ) return;
@@ -1099,14 +1169,56 @@ void RecordView::setAutoMaxScale(bool enable) {
 bool RecordView::feed(const Seiscomp::Record *rec) {
 	RecordCPtr saver(rec);
 
+	RecordViewItem *child = feedRecord(rec);
+	if ( !child ) return false;
+
+	if ( !_recordUpdateTimer.isActive() ) {
+		RecordWidget *w = child->widget();
+		if ( updatesEnabled() )
+			w->update();
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int RecordView::feed(const Seiscomp::Gui::RecordBatch &records) {
+	QSet<RecordWidget*> widgets;
+	int count = 0;
+
+	for ( const RecordPtr &rec : records ) {
+		RecordViewItem *child = feedRecord(rec.get());
+		if ( !child ) continue;
+		widgets.insert(child->widget());
+		++count;
+	}
+
+	if ( !_recordUpdateTimer.isActive() && updatesEnabled() ) {
+		for ( RecordWidget *w : widgets )
+			w->update();
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordViewItem *RecordView::feedRecord(const Seiscomp::Record *rec) {
 	if ( rec == nullptr )
-		return false;
+		return nullptr;
 
 	try {
 		rec->endTime();
 	}
 	catch ( ... ) {
-		return false;
+		return nullptr;
 	}
 
 	DataModel::WaveformStreamID streamID(rec->networkCode(), rec->stationCode(),
@@ -1117,26 +1229,18 @@ bool RecordView::feed(const Seiscomp::Record *rec) {
 	if ( !child ) {
 		if ( _autoInsertItems ) {
 			child = addItem(streamID, stationCode);
-			if ( !child ) return false;
+			if ( !child ) return nullptr;
 			emit addedItem(rec, child);
 		}
 		else
-			return false;
+			return nullptr;
 	}
 
-	if ( child->feed(rec) ) {
-		emit fedRecord(child, rec);
+	if ( !child->feed(rec) )
+		return nullptr;
 
-		if ( !_recordUpdateTimer.isActive() ) {
-			RecordWidget *w = child->widget();
-			if ( updatesEnabled() )
-				w->update();
-		}
-
-		return true;
-	}
-
-	return false;
+	emit fedRecord(child, rec);
+	return child;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1533,6 +1637,8 @@ bool RecordView::addItem(RecordViewItem* item) {
 	connect(item->widget(), SIGNAL(cursorMoved(QPoint)),
 	        this, SLOT(setZoomSpotFromGlobal(const QPoint&)));
 
+	item->widget()->installEventFilter(this);
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -3030,6 +3136,20 @@ bool RecordView::event(QEvent* event) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RecordView::eventFilter(QObject *obj, QEvent *event) {
+	// The first record widget painted creates the polylines of all
+	// visible items, the following ones only draw them
+	if ( _concurrentRendering && event->type() == QEvent::Paint )
+		updateTraces();
+
+	return QWidget::eventFilter(obj, event);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void RecordView::showEvent(QShowEvent *) {
 	resizeEvent(nullptr);
@@ -3253,8 +3373,10 @@ bool RecordView::setDataSource(const QString& streamURL) {
 	closeThread();
 	_thread = new RecordStreamThread((const char*)streamURL.toLatin1());
 
-	connect(_thread, SIGNAL(receivedRecord(Seiscomp::Record*)),
-	        this, SLOT(feed(Seiscomp::Record*)));
+	_thread->setBatchInterval(50);
+
+	connect(_thread, SIGNAL(receivedRecords(Seiscomp::Gui::RecordBatch)),
+	        this, SLOT(feed(Seiscomp::Gui::RecordBatch)));
 
 	return true;
 }
@@ -25,12 +25,14 @@
 
 #ifndef Q_MOC_RUN
 #include <seiscomp/gui/core/recordviewitem.h>
+#include <seiscomp/gui/core/recordstreamthread.h>
 #include <seiscomp/gui/core/timescale.h>
 #include <seiscomp/math/filter.h>
 #endif
 #include <QScrollArea>
 #include <QTimer>
 #include <QSet>
+#include <QThreadPool>
 
 
 namespace Seiscomp {
@@ -285,6 +287,10 @@ class SC_GUI_API RecordView : public QWidget {
 		bool feed(const Seiscomp::RecordPtr rec);
 		bool feed(Seiscomp::Record *rec);
 
+		//! Feeds all records of a batch and updates each affected
+		//! widget once afterwards. Returns the number of fed records.
+		int feed(const Seiscomp::Gui::RecordBatch &records);
+
 		void scrollLeft();
 		void scrollLeftSlowly();
 		void scrollRight();
@@ -324,6 +330,11 @@ class SC_GUI_API RecordView : public QWidget {
 		//! when using feed(...)
 		void setAutoInsertItem(bool enable);
 
+		//! Whether to create the polylines of all visible items on a
+		//! worker pool before they are painted. The record sequences must
+		//! not be shared between items if enabled.
+		void setConcurrentRendering(bool enable);
+
 		void setAbsoluteTimeEnabled(bool enable);
 
 		void setAutoScale(bool enable);
@@ -554,6 +565,7 @@ class SC_GUI_API RecordView : public QWidget {
 		virtual RecordLabel *createLabel(RecordViewItem*) const;
 
 		bool event(QEvent* event);
+		bool eventFilter(QObject *obj, QEvent *event);
 		void showEvent(QShowEvent *event);
 		void closeEvent(QCloseEvent *event);
 
@@ -569,6 +581,8 @@ class SC_GUI_API RecordView : public QWidget {
 	private:
 		void setupUi();
 
+		RecordViewItem *feedRecord(const Seiscomp::Record *rec);
+
 		void colorItem(RecordViewItem* item, int row);
 		void colorItem(RecordViewItem*);
 		void scaleContent();
@@ -580,6 +594,8 @@ class SC_GUI_API RecordView : public QWidget {
 
 		void applyBufferChange();
 
+		void updateTraces();
+
 		double mapToUnit(int x) const;
 		// bool buildFilter(const QString& text, std::vector<Seiscomp::Math::Filtering::IIR::Filter<float>* >* filterList);
 
@@ -642,6 +658,9 @@ class SC_GUI_API RecordView : public QWidget {
 		bool _autoInsertItems;
 		bool _autoScale;
 		bool _autoMaxScale;
+		bool _concurrentRendering;
+
+		QThreadPool *_renderPool;
 
 		bool _frames;
 		int  _frameMargin;
@@ -852,6 +852,9 @@ RecordWidget::Stream::Stream(bool owner) {
 	records[0] = records[1] = nullptr;
 	filter = nullptr;
 
+	pyramids[0].clear();
+	pyramids[1].clear();
+
 	pen = QPen(SCScheme.colors.records.foreground, SCScheme.records.lineWidth);
 	antialiasing = SCScheme.records.antiAliasing;
 	stepFunction = false;
@@ -923,6 +926,24 @@ void RecordWidget::Stream::free() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RecordWidget::Stream::restore() {
+	bool evicted = false;
+
+	for ( int i = 0; i < 2; ++i ) {
+		if ( records[i] == nullptr ) continue;
+		if ( records[i]->isEvicted() ) evicted = true;
+		records[i]->restore();
+	}
+
+	if ( evicted ) setDirty();
+	return evicted;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordWidget::RecordWidget(QWidget *parent)
 : QWidget(parent) {
@@ -1126,6 +1147,10 @@ bool RecordWidget::setRecords(int slot, RecordSequence *s, bool owner) {
 	stream->ownRawRecords = owner;
 	stream->filter = newFilter;
 
+	// Owned records are only accessed through this widget which restores
+	// them before use
+	if ( s && owner ) s->setEvictable(true);
+
 	if ( stream->records[Stream::Raw] ) {
 		float quality = -1;
 		int count = 0;
@@ -1160,7 +1185,10 @@ bool RecordWidget::setFilteredRecords(int slot, RecordSequence *s, bool owner) {
 
 	stream->records[Stream::Filtered] = s;
 	stream->ownFilteredRecords = owner;
-	if ( s ) _drawRecords = true;
+	if ( s ) {
+		if ( owner ) s->setEvictable(true);
+		_drawRecords = true;
+	}
 
 	changedRecords(slot, s);
 	stream->setDirty();
@@ -1591,6 +1619,7 @@ RecordSequence *RecordWidget::createRecords(int slot, bool owner) {
 			RecordSequence *seq = s->records[Stream::Raw]->clone();
 			ns->records[Stream::Raw] = seq;
 			ns->ownRawRecords = owner;
+			if ( owner ) seq->setEvictable(true);
 
 			setRecordFilter(slot, s->filter);
 
@@ -1936,7 +1965,9 @@ void RecordWidget::setDecorator(RecordWidgetDecorator *decorator) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence *RecordWidget::records() const {
-	return _streams.empty()?nullptr:_streams[0]->records[Stream::Raw];
+	if ( _streams.empty() ) return nullptr;
+	_streams[0]->restore();
+	return _streams[0]->records[Stream::Raw];
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1946,6 +1977,7 @@ RecordSequence *RecordWidget::records() const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence *RecordWidget::records(int slot) const {
 	if ( slot < 0 || slot >= _streams.size() ) return nullptr;
+	_streams[slot]->restore();
 	return _streams[slot]->records[Stream::Raw];
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1956,6 +1988,7 @@ RecordSequence *RecordWidget::records(int slot) const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence *RecordWidget::filteredRecords(int slot) const {
 	if ( slot < 0 || slot >= _streams.size() ) return nullptr;
+	_streams[slot]->restore();
 	return _streams[slot]->records[Stream::Filtered];
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -2310,6 +2343,17 @@ void RecordWidget::drawRecords(Stream *s, int slot) {
 		trace->poly = nullptr;
 	}
 
+	// The scroll bar is a child widget and is updated with the next
+	// paint event
+	_scrollBarSlot = slot;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::updateScrollBar(Stream *s) {
 	if ( _amplScale > 1 ) {
 		if ( !_scrollBar ) {
 			_scrollBar = new QScrollBar(Qt::Vertical, this);
@@ -2361,11 +2405,23 @@ void RecordWidget::createPolyline(int slot, AbstractRecordPolylinePtr &polyline,
 		polyline = pl;
 	}
 	else {
+		const RecordPyramid *pyramid = nullptr;
+		if ( optimization && seq ) {
+			Stream *s = _streams[slot];
+			for ( int i = 0; i < 2; ++i ) {
+				if ( s->records[i] == seq ) {
+					s->pyramids[i].update(seq);
+					pyramid = &s->pyramids[i];
+					break;
+				}
+			}
+		}
+
 		if ( highPrecision ) {
 			RecordPolylineFPtr pl = new RecordPolylineF;
 			pl->create(seq, leftTime(), rightTime(), pixelPerSecond,
 			           amplMin, amplMax, amplOffset,
-			           height, nullptr, nullptr, optimization);
+			           height, nullptr, nullptr, optimization, pyramid);
 
 			if ( _showScaledValues && isNegative(recordScale(slot)) ) {
 				flip(*pl, height);
@@ -2377,7 +2433,7 @@ void RecordWidget::createPolyline(int slot, AbstractRecordPolylinePtr &polyline,
 			RecordPolylinePtr pl = new RecordPolyline;
 			pl->create(seq, leftTime(), rightTime(), pixelPerSecond,
 			           amplMin, amplMax, amplOffset,
-			           height, nullptr, nullptr, optimization);
+			           height, nullptr, nullptr, optimization, pyramid);
 
 			if ( _showScaledValues && isNegative(recordScale(slot)) ) {
 				flip(*pl, height);
@@ -2634,6 +2690,19 @@ void RecordWidget::setDirty() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::restoreRecords() {
+	for ( StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it ) {
+		Stream *s = *it;
+		if ( s == nullptr ) continue;
+		if ( s->restore() ) _drawRecords = true;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool RecordWidget::isActive() const {
 	return _active;
@@ -2684,55 +2753,49 @@ bool RecordWidget::event(QEvent *event) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void RecordWidget::paintEvent(QPaintEvent *event) {
-	QPainter painter(this);
-
-	if ( _pixelPerSecond <= 0 ) return;
-	//bool emptyTrace = _poly[frontIndex].isEmpty();
+bool RecordWidget::updateTraces() {
+	if ( _pixelPerSecond <= 0 ) return false;
 
 	int w = width(), h = height();
 
 	if ( _scrollBar && _scrollBar->isVisible() )
 		w -= _scrollBar->width();
 
-	if ( h == 0 || w == 0 )
-		return; // actually this must never happen
+	if ( h == 0 || w == 0 ) return false;
 
-	QRect rect = event->rect();
-	QColor fg;
-	QColor bg = palette().color(QPalette::Base);
-	QColor alignColor;
-	int    x;
+	return updateTraces(h);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-	/*
-	if ( emptyTrace )
-		bg = blend(bg, Qt::red, 90);
-	*/
 
-	if ( !_enabled ) {
-		fg = QColor(160,160,160);
-		alignColor = fg;
-	}
-	else {
-		fg = palette().color(foregroundRole());
-		alignColor = SCScheme.colors.records.alignment;
-	}
 
-	painter.setClipRect(rect);
-	painter.translate(_canvasRect.left(), _canvasRect.top());
 
-	int sel_xmin = int((_smin-_tmin)*_pixelPerSecond),
-	    sel_xmax = int((_smax-_tmin)*_pixelPerSecond);
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RecordWidget::hasDirtyTraces() const {
+	for ( int i = 0; i < _streams.size(); ++i ) {
+		const Stream *stream = _streams[i];
+		if ( !stream->visible ) continue;
+		// Only the current slot is drawn in single mode
+		if ( (_drawMode == Single) && (i != _currentSlot) ) continue;
 
-	if ( sel_xmin < 0 ) sel_xmin = 0;
-	if ( sel_xmin > _canvasRect.width() ) sel_xmin = _canvasRect.width();
-	if ( sel_xmax < 0 ) sel_xmax = 0;
-	if ( sel_xmax > _canvasRect.width() ) sel_xmax = _canvasRect.width();
+		if ( (stream->records[Stream::Filtered] && (stream->filtering || _showAllRecords) && stream->traces[Stream::Filtered].dirty) ||
+		     (stream->records[Stream::Raw] && (!stream->filtering || _showAllRecords) && stream->traces[Stream::Raw].dirty) )
+			return true;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-	int sel_w = sel_xmax - sel_xmin;
 
-	bool emitUpdated = false;
 
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// Lays out the streams for the given canvas height and creates the
+// polylines of all dirty traces. Nothing is painted and no child widget
+// is touched, the scroll bar is updated with the next paint event.
+bool RecordWidget::updateTraces(int h) {
+	bool updated = false;
 	int slot;
 
 	switch ( _drawMode ) {
@@ -2761,14 +2824,11 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 			}
 
 			if ( stream ) {
-				if ( stream->hasCustomBackgroundColor )
-					painter.fillRect(0, stream->posY, _canvasRect.width(), stream->height, blend(bg, stream->customBackgroundColor));
-
 				if ( (stream->records[Stream::Filtered] && (stream->filtering || _showAllRecords) && stream->traces[Stream::Filtered].dirty) ||
 				     (stream->records[Stream::Raw] && (!stream->filtering || _showAllRecords) && stream->traces[Stream::Raw].dirty) ) {
 					prepareRecords(stream);
 					drawRecords(stream, _currentSlot);
-					emitUpdated = true;
+					updated = true;
 				}
 			}
 
@@ -2798,14 +2858,11 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 				stream->posY = streamYOffset;
 				stream->height = streamHeight;
 
-				if ( stream->hasCustomBackgroundColor )
-					painter.fillRect(0,stream->posY,_canvasRect.width(),stream->height, blend(bg, stream->customBackgroundColor));
-
 				if ( (stream->records[Stream::Filtered] && (stream->filtering || _showAllRecords) && stream->traces[Stream::Filtered].dirty) ||
 					(stream->records[Stream::Raw] && (!stream->filtering || _showAllRecords) && stream->traces[Stream::Raw].dirty) ) {
 					prepareRecords(stream);
 					drawRecords(stream, slot);
-					emitUpdated = true;
+					updated = true;
 				}
 
 				streamYOffset += streamHeight + _rowSpacing;
@@ -2819,7 +2876,6 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 			bool isDirty = false;
 			bool isFirst[2] = {true,true};
 			double minAmpl[2] = {0,0}, maxAmpl[2] = {0,0};
-			QColor customBackgroundColor;
 
 			// Two passes: First pass fetches the amplitude range and so on and scales all records appropriate
 			for ( StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it ) {
@@ -2833,10 +2889,6 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 				stream->posY = 0;
 				stream->height = h;
 
-				if ( stream->hasCustomBackgroundColor &&
-					 !customBackgroundColor.isValid() )
-					customBackgroundColor = stream->customBackgroundColor;
-
 				if ( (stream->records[Stream::Filtered] && (stream->filtering || _showAllRecords) && stream->traces[Stream::Filtered].dirty) ||
 					(stream->records[Stream::Raw] && (!stream->filtering || _showAllRecords) && stream->traces[Stream::Raw].dirty) ) {
 					isDirty = true;
@@ -2858,9 +2910,6 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 				}
 			}
 
-			if ( customBackgroundColor.isValid() )
-				painter.fillRect(_canvasRect, blend(bg, customBackgroundColor));
-
 			if ( !isDirty ) break;
 
 			// Second pass draws all records
@@ -2876,7 +2925,7 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 				stream->traces[1].dyMax = maxAmpl[1];
 
 				drawRecords(stream, slot);
-				emitUpdated = true;
+				updated = true;
 			}
 			break;
 		}
@@ -2886,7 +2935,6 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 			bool isDirty = false;
 			bool isFirst[2] = {true,true};
 			double minAmpl[2] = {0,0}, maxAmpl[2] = {0,0};
-			QColor customBackgroundColor;
 			// Two passes: First pass fetches the amplitude range and so on and scales all records appropriate
 			for ( StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it ) {
 				Stream *stream = *it;
@@ -2899,10 +2947,6 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 				stream->posY = 0;
 				stream->height = h;
 
-				if ( stream->hasCustomBackgroundColor &&
-					 !customBackgroundColor.isValid() )
-					customBackgroundColor = stream->customBackgroundColor;
-
 				if ( (stream->records[Stream::Filtered] && (stream->filtering || _showAllRecords) && stream->traces[Stream::Filtered].dirty) ||
 					(stream->records[Stream::Raw] && (!stream->filtering || _showAllRecords) && stream->traces[Stream::Raw].dirty) ) {
 					isDirty = true;
@@ -2927,9 +2971,6 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 				}
 			}
 
-			if ( customBackgroundColor.isValid() )
-				painter.fillRect(_canvasRect, blend(bg, customBackgroundColor));
-
 			if ( !isDirty ) break;
 
 			// Second pass draws all records
@@ -2945,12 +2986,113 @@ void RecordWidget::paintEvent(QPaintEvent *event) {
 				}
 
 				drawRecords(stream, slot);
-				emitUpdated = true;
+				updated = true;
 			}
 			break;
 		}
 	}
 
+	if ( updated ) _tracesUpdated = true;
+	return updated;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::paintEvent(QPaintEvent *event) {
+	QPainter painter(this);
+
+	if ( _pixelPerSecond <= 0 ) return;
+
+	restoreRecords();
+	//bool emptyTrace = _poly[frontIndex].isEmpty();
+
+	int w = width(), h = height();
+
+	if ( _scrollBar && _scrollBar->isVisible() )
+		w -= _scrollBar->width();
+
+	if ( h == 0 || w == 0 )
+		return; // actually this must never happen
+
+	QRect rect = event->rect();
+	QColor fg;
+	QColor bg = palette().color(QPalette::Base);
+	QColor alignColor;
+	int    x;
+
+	/*
+	if ( emptyTrace )
+		bg = blend(bg, Qt::red, 90);
+	*/
+
+	if ( !_enabled ) {
+		fg = QColor(160,160,160);
+		alignColor = fg;
+	}
+	else {
+		fg = palette().color(foregroundRole());
+		alignColor = SCScheme.colors.records.alignment;
+	}
+
+	painter.setClipRect(rect);
+	painter.translate(_canvasRect.left(), _canvasRect.top());
+
+	int sel_xmin = int((_smin-_tmin)*_pixelPerSecond),
+	    sel_xmax = int((_smax-_tmin)*_pixelPerSecond);
+
+	if ( sel_xmin < 0 ) sel_xmin = 0;
+	if ( sel_xmin > _canvasRect.width() ) sel_xmin = _canvasRect.width();
+	if ( sel_xmax < 0 ) sel_xmax = 0;
+	if ( sel_xmax > _canvasRect.width() ) sel_xmax = _canvasRect.width();
+
+	int sel_w = sel_xmax - sel_xmin;
+
+	updateTraces(h);
+
+	bool emitUpdated = _tracesUpdated;
+	_tracesUpdated = false;
+
+	if ( _scrollBarSlot >= 0 ) {
+		if ( _scrollBarSlot < _streams.size() )
+			updateScrollBar(_streams[_scrollBarSlot]);
+		_scrollBarSlot = -1;
+	}
+
+	// Custom backgrounds
+	switch ( _drawMode ) {
+		default:
+		case Single:
+		{
+			Stream *stream = (_currentSlot >= 0 && _currentSlot < _streams.size()) ?
+			                 _streams[_currentSlot] : nullptr;
+			if ( stream && stream->visible && stream->hasCustomBackgroundColor )
+				painter.fillRect(0, stream->posY, _canvasRect.width(), stream->height, blend(bg, stream->customBackgroundColor));
+			break;
+		}
+
+		case InRows:
+			for ( StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it ) {
+				Stream *stream = *it;
+				if ( stream->visible && stream->hasCustomBackgroundColor )
+					painter.fillRect(0, stream->posY, _canvasRect.width(), stream->height, blend(bg, stream->customBackgroundColor));
+			}
+			break;
+
+		case Stacked:
+		case SameOffset:
+			for ( StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it ) {
+				Stream *stream = *it;
+				if ( stream->visible && stream->hasCustomBackgroundColor ) {
+					painter.fillRect(_canvasRect, blend(bg, stream->customBackgroundColor));
+					break;
+				}
+			}
+			break;
+	}
+
 	_drawRecords = false;
 
 	QColor sel = blend(bg, SCScheme.colors.recordView.selectedTraceZoom);
@@ -36,6 +36,7 @@
 #include <seiscomp/math/filter.h>
 
 #include "recordpolyline.h"
+#include "recordpyramid.h"
 #endif
 
 
@@ -421,6 +422,10 @@ class SC_GUI_API RecordWidget : public QWidget {
 		//! according its size and parameters
 		void setDirty();
 
+		//! Reloads the records of all slots that have been evicted
+		//! by the waveform memory budget and marks them dirty
+		void restoreRecords();
+
 		//! Whether to show the current selected recordstream or
 		//! both recordstreams
 		void showAllRecords(bool enable);
@@ -526,6 +531,22 @@ class SC_GUI_API RecordWidget : public QWidget {
 
 		const DataModel::WaveformStreamID& streamID() const;
 
+		//! Returns whether any visible trace needs to create its
+		//! polyline with the next paint event
+		bool hasDirtyTraces() const;
+
+		/**
+		 * @brief Creates the polylines of all dirty traces for the current
+		 *        geometry without painting them.
+		 *
+		 * Neither child widgets are touched nor signals are emitted, so
+		 * this can be called from a worker thread while the calling
+		 * thread does not modify the widget or its record sequences.
+		 * The next paint event then only draws the polylines.
+		 * @return Whether any polyline has been created
+		 */
+		bool updateTraces();
+
 		void setSlotCount(int);
 		int slotCount() const;
 
@@ -685,9 +706,11 @@ class SC_GUI_API RecordWidget : public QWidget {
 
 			void setDirty();
 			void free();
+			bool restore();
 
 			RecordSequence *records[2];
 			Trace           traces[2];
+			RecordPyramid   pyramids[2];
 			bool            ownRawRecords;
 			bool            ownFilteredRecords;
 			bool            visible;
@@ -730,8 +753,10 @@ class SC_GUI_API RecordWidget : public QWidget {
 		                       const Record*, const Record*,
 		                       double tolerance) const;
 
+		bool updateTraces(int height);
 		void prepareRecords(Stream *s);
 		void drawRecords(Stream *s, int slot);
+		void updateScrollBar(Stream *s);
 		void drawTrace(QPainter &painter,
 		               const Trace *trace,
 		               const RecordSequence *seq,
@@ -777,6 +802,8 @@ class SC_GUI_API RecordWidget : public QWidget {
 		bool                 _showScaledValues{false};
 
 		bool                 _drawRecords{false};
+		bool                 _tracesUpdated{false};
+		int                  _scrollBarSlot{-1};
 		bool                 _drawRecordID{true};
 		bool                 _drawOffset{true};
 		bool                 _drawSPS{false};
@@ -20,10 +20,127 @@
 
 #include <seiscomp/gui/core/spectrogramrenderer.h>
 #include <seiscomp/gui/core/application.h>
+#include <seiscomp/core/genericrecord.h>
+
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWidget>
+
+#include <deque>
+#include <mutex>
 
 
 namespace Seiscomp {
 namespace Gui {
+
+
+namespace {
+
+
+template <typename F>
+void popSpectra(IO::Spectralizer *spectralizer,
+                Math::Restitution::FFT::TransferFunction *tf, F add) {
+	IO::SpectrumPtr spec;
+
+	while ( (spec = spectralizer->pop()) ) {
+		if ( !spec->isValid() ) {
+			continue;
+		}
+
+		// Deconvolution
+		if ( tf ) {
+			Seiscomp::ComplexDoubleArray *data = spec->data();
+			double df = spec->maximumFrequency() / (data->size()-1);
+			tf->deconvolve(data->size()-1, data->typedData()+1, df, df);
+		}
+
+		add(spec.get());
+	}
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * State shared between the renderer and the jobs computing the spectra.
+ * Reference counts of Seiscomp objects are not thread-safe, all smart
+ * pointers in here are only modified with the mutex held. The transfer
+ * function is owned by the renderer and only used with the mutex held.
+ */
+struct SpectrogramRenderer::Worker {
+	std::mutex                                mutex;
+	std::deque<RecordPtr>                     pending;
+	PowerSpectra                              done;
+	IO::SpectralizerPtr                       spectralizer;
+	Math::Restitution::FFT::TransferFunction *transferFunction{nullptr};
+	double                                    scale{1.0};
+	unsigned int                              generation{0};
+	bool                                      running{false};
+	QWidget                                  *target{nullptr};
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct SpectrogramRenderer::Job : QRunnable {
+	Job(const std::shared_ptr<Worker> &w) : worker(w) {}
+
+	void run() override {
+		std::unique_lock<std::mutex> lock(worker->mutex);
+
+		while ( !worker->pending.empty() ) {
+			std::deque<RecordPtr> records;
+			records.swap(worker->pending);
+
+			IO::SpectralizerPtr spectralizer = worker->spectralizer;
+			unsigned int generation = worker->generation;
+			PowerSpectra spectra;
+
+			lock.unlock();
+
+			// The records are private copies, only this job references them
+			for ( auto &rec : records ) {
+				if ( !spectralizer->push(rec.get()) ) {
+					continue;
+				}
+
+				lock.lock();
+				double scale = worker->scale;
+				popSpectra(spectralizer.get(), worker->transferFunction,
+				           [&spectra, scale](const IO::Spectrum *spec) {
+					spectra.push_back(new PowerSpectrum(*spec, scale));
+				});
+				lock.unlock();
+			}
+
+			records.clear();
+
+			lock.lock();
+			spectralizer = nullptr;
+
+			if ( (generation == worker->generation) && !spectra.empty() ) {
+				worker->done.append(spectra);
+				if ( worker->target ) {
+					QMetaObject::invokeMethod(worker->target, "update",
+					                          Qt::QueuedConnection);
+				}
+			}
+
+			spectra.clear();
+		}
+
+		worker->running = false;
+	}
+
+	std::shared_ptr<Worker> worker;
+};
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -53,6 +170,28 @@ SpectrogramRenderer::SpectrogramRenderer() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SpectrogramRenderer::~SpectrogramRenderer() {
+	if ( !_worker ) {
+		return;
+	}
+
+	// Detach from a still running job
+	std::lock_guard<std::mutex> lock(_worker->mutex);
+	++_worker->generation;
+	_worker->pending.clear();
+	_worker->done.clear();
+	_worker->target = nullptr;
+	_worker->transferFunction = nullptr;
+	_worker->spectralizer = nullptr;
+	_transferFunction = nullptr;
+	_spectralizer = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::setGradient(const Gradient &gradient) {
 	Gradient::const_iterator it;
@@ -96,6 +235,11 @@ bool SpectrogramRenderer::setOptions(const IO::Spectralizer::Options &opts) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::setScale(double scale) {
 	_scale = scale;
+
+	if ( _worker ) {
+		std::lock_guard<std::mutex> lock(_worker->mutex);
+		_worker->scale = _scale;
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -125,8 +269,21 @@ void SpectrogramRenderer::reset() {
 	_spectra.clear();
 	_images.clear();
 
-	_spectralizer = new IO::Spectralizer;
-	_spectralizer->setOptions(_options);
+	if ( _worker ) {
+		std::lock_guard<std::mutex> lock(_worker->mutex);
+		// Results of running jobs are discarded
+		++_worker->generation;
+		_worker->pending.clear();
+		_worker->done.clear();
+
+		_spectralizer = new IO::Spectralizer;
+		_spectralizer->setOptions(_options);
+		_worker->spectralizer = _spectralizer;
+	}
+	else {
+		_spectralizer = new IO::Spectralizer;
+		_spectralizer->setOptions(_options);
+	}
 
 	_renderedFmin = _renderedFmax = -1;
 
@@ -153,26 +310,34 @@ bool SpectrogramRenderer::feed(const Record *rec) {
 		return false;
 	}
 
-	if ( _spectralizer->push(rec) ) {
-		IO::SpectrumPtr spec;
+	if ( _worker ) {
+		if ( !rec->data() ) {
+			return false;
+		}
 
-		while ( (spec = _spectralizer->pop()) ) {
-			if ( !spec->isValid() ) {
-				continue;
-			}
+		// The spectralizer filters the data in place and the records are
+		// shared with the GUI thread, so the job gets a private copy
+		GenericRecord *copy = new GenericRecord(*rec);
+		copy->setData(rec->data()->copy(Array::DOUBLE));
 
-			// Deconvolution
-			if ( _transferFunction ) {
-				Seiscomp::ComplexDoubleArray *data = spec->data();
-				double df = spec->maximumFrequency() / (data->size()-1);
-				_transferFunction->deconvolve(data->size()-1, data->typedData()+1, df, df);
-			}
+		std::lock_guard<std::mutex> lock(_worker->mutex);
+		_worker->pending.push_back(copy);
+		if ( !_worker->running ) {
+			_worker->running = true;
+			QThreadPool::globalInstance()->start(new Job(_worker));
+		}
 
+		return true;
+	}
+
+	if ( _spectralizer->push(rec) ) {
+		popSpectra(_spectralizer.get(), _transferFunction.get(),
+		           [this](const IO::Spectrum *spec) {
 			_spectra.push_back(new PowerSpectrum(*spec, _scale));
 			if ( !_dirty ) {
 				addSpectrum(_spectra.back().get());
 			}
-		}
+		});
 	}
 
 	return true;
@@ -234,9 +399,9 @@ void SpectrogramRenderer::setTimeRange(double tmin, double tmax) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::setTimeWindow(const Core::TimeWindow& tw) {
-	_timeWindow = tw;
+	collectSpectra();
 
-	bool needUpdate = false;
+	_timeWindow = tw;
 
 	// Trim front
 	if ( _timeWindow.startTime().valid() && !_spectra.empty() ) {
@@ -246,7 +411,6 @@ void SpectrogramRenderer::setTimeWindow(const Core::TimeWindow& tw) {
 			auto spec = it->get();
 			if ( spec->endTime <= _timeWindow.startTime() ) {
 				it = _spectra.erase(it);
-				needUpdate = true;
 			}
 			else {
 				break;
@@ -263,7 +427,6 @@ void SpectrogramRenderer::setTimeWindow(const Core::TimeWindow& tw) {
 			auto spec = it->get();
 			if ( spec->startTime >= _timeWindow.endTime() ) {
 				it = _spectra.erase(it);
-				needUpdate = true;
 			}
 			else {
 				break;
@@ -271,8 +434,24 @@ void SpectrogramRenderer::setTimeWindow(const Core::TimeWindow& tw) {
 		}
 	}
 
-	if ( needUpdate ) {
-		setDirty();
+	// Drop the images which are completely outside the window rather than
+	// recoloring all remaining spectra
+	while ( !_images.isEmpty() && _timeWindow.startTime().valid() ) {
+		const SpecImage &img = _images.front();
+		Core::Time endTime = img.startTime + Core::TimeSpan((double)img.dt * (img.width - 0.5));
+		if ( endTime > _timeWindow.startTime() ) {
+			break;
+		}
+		_images.removeFirst();
+	}
+
+	while ( !_images.isEmpty() && _timeWindow.endTime().valid() ) {
+		const SpecImage &img = _images.back();
+		Core::Time startTime = img.startTime - Core::TimeSpan((double)img.dt * 0.5);
+		if ( startTime < _timeWindow.endTime() ) {
+			break;
+		}
+		_images.removeLast();
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -353,7 +532,52 @@ void SpectrogramRenderer::setSmoothTransform(bool st) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::setTransferFunction(Math::Restitution::FFT::TransferFunction *tf) {
-	_transferFunction = tf;
+	if ( _worker ) {
+		std::lock_guard<std::mutex> lock(_worker->mutex);
+		_transferFunction = tf;
+		_worker->transferFunction = tf;
+	}
+	else {
+		_transferFunction = tf;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::setAsynchronous(QWidget *target) {
+	if ( target ) {
+		if ( !_worker ) {
+			_worker = std::make_shared<Worker>();
+		}
+
+		std::lock_guard<std::mutex> lock(_worker->mutex);
+		_worker->target = target;
+		_worker->scale = _scale;
+		_worker->transferFunction = _transferFunction.get();
+	}
+	else if ( _worker ) {
+		{
+			std::lock_guard<std::mutex> lock(_worker->mutex);
+			++_worker->generation;
+			_worker->pending.clear();
+			_worker->done.clear();
+			_worker->target = nullptr;
+			_worker->transferFunction = nullptr;
+			_worker->spectralizer = nullptr;
+			// Replace the spectralizer which a job may still reference
+			// while the lock is held
+			if ( _spectralizer ) {
+				_spectralizer = new IO::Spectralizer;
+			}
+		}
+
+		_worker.reset();
+	}
+
+	reset();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -370,6 +594,31 @@ void SpectrogramRenderer::setDirty() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::collectSpectra() {
+	if ( !_worker ) {
+		return;
+	}
+
+	PowerSpectra spectra;
+
+	{
+		std::lock_guard<std::mutex> lock(_worker->mutex);
+		spectra.swap(_worker->done);
+	}
+
+	for ( auto &spec : spectra ) {
+		_spectra.push_back(spec);
+		if ( !_dirty ) {
+			addSpectrum(spec.get());
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::renderSpectrogram() {
 	_images.clear();
@@ -455,8 +704,9 @@ void SpectrogramRenderer::addSpectrum(const PowerSpectrum *spec) {
 		}
 		else {
 			if ( img.width >= img.data.width() ) {
-				// Extent image by one column
-				img.data = img.data.copy(0,0,img.width+PRE_ALLOC_WIDTH,img.data.height());
+				// Grow geometrically to keep the number of copies low
+				// on long spectrograms
+				img.data = img.data.copy(0,0,img.width+std::max(img.width, PRE_ALLOC_WIDTH),img.data.height());
 			}
 
 			// Fill colors for column
@@ -633,6 +883,8 @@ void SpectrogramRenderer::render(QPainter &p, const QRect &rect,
 		return;
 	}
 
+	collectSpectra();
+
 	Core::Time t0 = _alignment + Core::TimeSpan(_tmin);
 	Core::Time t1 = _alignment + Core::TimeSpan(_tmax);
 
@@ -31,6 +31,8 @@
 
 #include <QPainter>
 
+#include <memory>
+
 
 namespace Seiscomp {
 namespace Gui {
@@ -55,6 +57,9 @@ class SC_GUI_API SpectrogramRenderer {
 		//! C'tor
 		SpectrogramRenderer();
 
+		//! D'tor
+		~SpectrogramRenderer();
+
 
 	// ----------------------------------------------------------------------
 	//  Public Interface
@@ -115,6 +120,21 @@ class SC_GUI_API SpectrogramRenderer {
 		//! Sets the transfer function for deconvolution
 		void setTransferFunction(Math::Restitution::FFT::TransferFunction *tf);
 
+		/**
+		 * @brief Computes the spectra of fed records on a worker thread
+		 *        of the global thread pool.
+		 *
+		 * Each fed record is only transformed once, on the worker thread.
+		 * The image columns of new spectra are added with the next call
+		 * to render. Once new spectra are available, update() of the
+		 * target is invoked with a queued connection. Must be called
+		 * before records are fed, it resets the spectrogram.
+		 * @param target The widget to update or nullptr to compute the
+		 *               spectra synchronously in feed
+		 */
+		void setAsynchronous(QWidget *target);
+		bool isAsynchronous() const { return _worker != nullptr; }
+
 		bool isDirty() const { return _dirty; }
 
 		//! Creates the spectrogram. This is usually done in render if the
@@ -193,7 +213,11 @@ class SC_GUI_API SpectrogramRenderer {
 			double         maximumAmplitude;
 		};
 
+		struct Worker;
+		struct Job;
+
 		void setDirty();
+		void collectSpectra();
 		void addSpectrum(const PowerSpectrum *);
 		void fillRow(SpecImage &img, DoubleArray *spec,
 		             int column, int offset);
@@ -229,6 +253,7 @@ class SC_GUI_API SpectrogramRenderer {
 		bool                      _dirty;
 		double                    _renderedFmin;
 		double                    _renderedFmax;
+		std::shared_ptr<Worker>   _worker;
 };
 
 
@@ -30,7 +30,9 @@ namespace Gui {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SpectrogramWidget::SpectrogramWidget(QWidget *parent, Qt::WindowFlags f)
-: QWidget(parent, f) {}
+: QWidget(parent, f) {
+	_renderer.setAsynchronous(this);
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
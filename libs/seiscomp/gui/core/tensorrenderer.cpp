@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <math.h>
+#include <vector>
 #include <QPainter>
 
 
@@ -299,6 +300,24 @@ int BeachballPlot::plot(Math::AXIS ax[3])
 */
 
 
+// Computes the distance from the center and the direction of n pixels of
+// a row starting at x with step dx
+void unprojectRow(float *dist, float *vx, float *vy, float *vz,
+                  float x, float y, float dx, int n) {
+	for ( int j = 0; j < n; ++j ) {
+		float xf = x + j*dx;
+		float d = xf*xf + y*y;
+		float div_z = 1.0f / (1.0f + d);
+		float div_xy = M_SQRT2 * div_z;
+
+		dist[j] = d;
+		vx[j] = y * div_xy;
+		vy[j] = -xf * div_xy;
+		vz[j] = -(1.0f - d) * div_z;
+	}
+}
+
+
 }
 
 
@@ -693,9 +712,6 @@ void TensorRenderer::render(QImage& img, const Math::Tensor2Sd &t, const Math::M
 	float distLimit2 = (1.0f + smoothDist) * (1.0f + smoothDist);
 
 	float dist;
-	float div_z;
-	float div_xy;
-	float xx, yy, zz, xy, xz, yz;
 	float sign;
 	Math::Vector3f v, vr, n, l(-1,1,-2);
 
@@ -704,12 +720,28 @@ void TensorRenderer::render(QImage& img, const Math::Tensor2Sd &t, const Math::M
 	n = m.column(2);
 	n.normalize();
 
+	// The radiation pattern is evaluated row by row with the normalized
+	// deviatoric tensor
+	Math::Tensor2Sf dev(Mxx*norm, t._12*norm, t._13*norm,
+	                              Myy*norm, t._23*norm,
+	                                        Mzz*norm);
+
+	int width = size.width();
+	std::vector<float> rows(width*5);
+	float *rowDist = rows.data();
+	float *rowX = rowDist + width;
+	float *rowY = rowX + width;
+	float *rowZ = rowY + width;
+	float *rowSign = rowZ + width;
+
 	float yf = iyf;
 
 	for ( int i = 0; i < size.height(); ++i, yf += dt ) {
-		float xf = ixf;
-		for ( int j = 0; j < size.width(); ++j, ++data, xf += dt ) {
-			dist = xf*xf + yf*yf;
+		unprojectRow(rowDist, rowX, rowY, rowZ, ixf, yf, dt, width);
+		Math::radiationPattern(rowSign, dev, rowX, rowY, rowZ, width);
+
+		for ( int j = 0; j < width; ++j, ++data ) {
+			dist = rowDist[j];
 			if ( dist > 1.0f ) {
 				if ( dist <= distLimit2 ) {
 					float d = (sqrt(dist) - 1.0f) / smoothDist;
@@ -720,21 +752,11 @@ void TensorRenderer::render(QImage& img, const Math::Tensor2Sd &t, const Math::M
 				continue;
 			}
 
-			div_z = 1.0f / (1.0f + dist);
-			div_xy = M_SQRT2 * div_z;
-
-			v[0] = yf * div_xy;
-			v[1] = -xf * div_xy;
-			v[2] = -(1.0f - dist) * div_z;
-
-			xx = v[0]*v[0];
-			xy = v[0]*v[1];
-			xz = v[0]*v[2];
-			yy = v[1]*v[1];
-			yz = v[1]*v[2];
-			zz = v[2]*v[2];
+			v[0] = rowX[j];
+			v[1] = rowY[j];
+			v[2] = rowZ[j];
 
-			sign = norm*(xx*Mxx + yy*Myy + zz*Mzz + 2*(xy*t._12 + xz*t._13 + yz*t._23));
+			sign = rowSign[j];
 			if ( sign > 1 ) sign = 1; else if ( sign < -1 ) sign = -1;
 
 			Math::Vector3f vr;
@@ -879,20 +901,33 @@ void TensorRenderer::render(QImage& img, const Math::Tensor2Sd &t) {
 	float distLimit2 = (1.0f + smoothDist) * (1.0f + smoothDist);
 
 	float dist;
-	float div_z;
-	float div_xy;
-	float xx, yy, zz, xy, xz, yz;
 	float sign;
 	Math::Vector3f v, vr, l(-1,1,-2);
 
 	l.normalize();
 
+	// The radiation pattern is evaluated row by row with the normalized
+	// deviatoric tensor
+	Math::Tensor2Sf dev(Mxx*norm, t._12*norm, t._13*norm,
+	                              Myy*norm, t._23*norm,
+	                                        Mzz*norm);
+
+	int width = size.width();
+	std::vector<float> rows(width*5);
+	float *rowDist = rows.data();
+	float *rowX = rowDist + width;
+	float *rowY = rowX + width;
+	float *rowZ = rowY + width;
+	float *rowSign = rowZ + width;
+
 	float yf = iyf;
 
 	for ( int i = 0; i < size.height(); ++i, yf += dt ) {
-		float xf = ixf;
-		for ( int j = 0; j < size.width(); ++j, ++data, xf += dt ) {
-			dist = xf*xf + yf*yf;
+		unprojectRow(rowDist, rowX, rowY, rowZ, ixf, yf, dt, width);
+		Math::radiationPattern(rowSign, dev, rowX, rowY, rowZ, width);
+
+		for ( int j = 0; j < width; ++j, ++data ) {
+			dist = rowDist[j];
 			if ( dist > 1.0f ) {
 				if ( dist <= distLimit2 ) {
 					float d = (sqrt(dist) - 1.0f) / smoothDist;
@@ -903,21 +938,11 @@ void TensorRenderer::render(QImage& img, const Math::Tensor2Sd &t) {
 				continue;
 			}
 
-			div_z = 1.0f / (1.0f + dist);
-			div_xy = M_SQRT2 * div_z;
-
-			v[0] = yf * div_xy;
-			v[1] = -xf * div_xy;
-			v[2] = -(1.0f - dist) * div_z;
-
-			xx = v[0]*v[0];
-			xy = v[0]*v[1];
-			xz = v[0]*v[2];
-			yy = v[1]*v[1];
-			yz = v[1]*v[2];
-			zz = v[2]*v[2];
+			v[0] = rowX[j];
+			v[1] = rowY[j];
+			v[2] = rowZ[j];
 
-			sign = norm*(xx*Mxx + yy*Myy + zz*Mzz + 2*(xy*t._12 + xz*t._13 + yz*t._23));
+			sign = rowSign[j];
 			if ( sign > 1 ) sign = 1; else if ( sign < -1 ) sign = -1;
 
 			if ( sign >= 0 )
@@ -785,6 +785,7 @@ Stream* findStream(Station *station, const Seiscomp::Core::Time &time,
 
 			if ( stream->start() > time ) continue;
 
+			Client::Inventory::Instance()->loadInstruments(stream);
 			Sensor *sensor = Sensor::Find(stream->sensor());
 			if ( !sensor ) continue;
 
@@ -3926,13 +3927,18 @@ RecordViewItem* AmplitudeView::addRawStream(const DataModel::SensorLocation *loc
 
 
 	Util::KeyValuesPtr keys = getParams(sid.networkCode(), sid.stationCode());
+	// Shared by the amplitude and the magnitude processor
+	Processing::StationSettingsPtr stationSettings =
+		new Processing::StationSettings(SCApp->configModuleName(),
+		                                sid.networkCode(), sid.stationCode(),
+		                                &SCCoreApp->configuration(), keys.get());
 
 	if ( !proc->setup(
 		Processing::Settings(
 			SCApp->configModuleName(),
 			sid.networkCode(), sid.stationCode(),
 			sid.locationCode(), sid.channelCode().substr(0,2),
-			&SCCoreApp->configuration(), keys.get())) ) {
+			&SCCoreApp->configuration(), keys.get(), stationSettings.get())) ) {
 		cerr << sid.networkCode() << "." << sid.stationCode() << ": setup processor failed ("
 		     << proc->status().toString() << ", " << proc->statusValue() << ")"
 		     << ": ignoring station" << endl;
@@ -4020,7 +4026,7 @@ RecordViewItem* AmplitudeView::addRawStream(const DataModel::SensorLocation *loc
 			SCApp->configModuleName(),
 			sid.networkCode(), sid.stationCode(),
 			sid.locationCode(), sid.channelCode().substr(0,2),
-			&SCCoreApp->configuration(), keys.get())) ) {
+			&SCCoreApp->configuration(), keys.get(), stationSettings.get())) ) {
 		cerr << sid.networkCode() << "." << sid.stationCode() << ": setup magnitude processor failed"
 		     << ": ignoring station" << endl;
 		return nullptr;
@@ -545,6 +545,15 @@ void CalculateAmplitudes::addProcessor(
 		}
 	}
 
+	// Compile the station settings once and share them with all processors
+	// of that station
+	StationSettingsPtr &stationSettings = _stationSettings[stationID];
+	if ( !stationSettings )
+		stationSettings = new StationSettings(
+			SCApp->configModuleName(),
+			pick->waveformID().networkCode(), pick->waveformID().stationCode(),
+			&SCCoreApp->configuration(), keys);
+
 	proc->setReferencingPickID(pick->publicID());
 	proc->setPublishFunction(bind(&CalculateAmplitudes::emitAmplitude, this, placeholders::_1, placeholders::_2));
 
@@ -579,7 +588,7 @@ void CalculateAmplitudes::addProcessor(
 			SCApp->configModuleName(),
 			pick->waveformID().networkCode(), pick->waveformID().stationCode(),
 			pick->waveformID().locationCode(), pick->waveformID().channelCode().substr(0,2),
-			&SCCoreApp->configuration(), keys)) ) {
+			&SCCoreApp->configuration(), keys, stationSettings.get())) ) {
 		pair<TableRowMap::iterator, TableRowMap::iterator> itp = _rows.equal_range(proc.get());
 		for ( TableRowMap::iterator row_it = itp.first; row_it != itp.second; ++row_it )
 			setError(row_it->second, QString("Setup failed (%1: %2)")
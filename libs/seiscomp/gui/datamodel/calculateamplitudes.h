@@ -150,12 +150,14 @@ class SC_GUI_API CalculateAmplitudes : public QDialog {
 		typedef std::map<std::string, ProcessorSlot> ProcessorMap;
 		typedef std::multimap<Processing::AmplitudeProcessorCPtr, int> TableRowMap;
 		typedef std::map<std::string, Seiscomp::Util::KeyValuesPtr> ParameterMap;
+		typedef std::map<std::string, Seiscomp::Processing::StationSettingsPtr> StationSettingsMap;
 		typedef std::map<std::string, Seiscomp::Processing::StreamPtr> StreamMap;
 
 		::Ui::CalculateAmplitudes _ui;
 
 		ProcessorMap              _processors;
 		ParameterMap              _parameters;
+		StationSettingsMap        _stationSettings;
 		StreamMap                 _streams;
 		TableRowMap               _rows;
 		PickAmplitudeMap          _amplitudes;
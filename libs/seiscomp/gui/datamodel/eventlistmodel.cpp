@@ -0,0 +1,987 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/gui/datamodel/eventlistmodel.h>
+#include <seiscomp/gui/core/scheme.h>
+#include <seiscomp/gui/core/utils.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/datamodel/databasequery.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/originquality.h>
+#include <seiscomp/datamodel/originreference.h>
+#include <seiscomp/datamodel/utils.h>
+#include <seiscomp/seismology/regions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+using namespace Seiscomp::DataModel;
+
+
+namespace Seiscomp {
+namespace Gui {
+
+
+namespace {
+
+
+const double Missing = std::numeric_limits<double>::quiet_NaN();
+
+
+const char *timeFormat() {
+	static std::string format;
+	if ( format.empty() ) {
+		format = "%F %T";
+		if ( SCScheme.precision.originTime > 0 ) {
+			format += ".%";
+			format += Core::toString(SCScheme.precision.originTime);
+			format += "f";
+		}
+	}
+
+	return format.c_str();
+}
+
+
+template <typename T>
+typename Core::SmartPointer<T>::Impl findObject(DatabaseQuery *query,
+                                                const std::string &publicID) {
+	if ( publicID.empty() ) {
+		return nullptr;
+	}
+
+	T *obj = T::Find(publicID);
+	if ( !obj && query ) {
+		obj = T::Cast(query->getObject(T::TypeInfo(), publicID));
+	}
+
+	return obj;
+}
+
+
+bool isNumeric(int column) {
+	switch ( column ) {
+		case EventListModel::OriginTime:
+		case EventListModel::Magnitude:
+		case EventListModel::Phases:
+		case EventListModel::RMS:
+		case EventListModel::Latitude:
+		case EventListModel::Longitude:
+		case EventListModel::Depth:
+			return true;
+		default:
+			return false;
+	}
+}
+
+
+QString originText(const Origin *origin, int column) {
+	if ( !origin ) {
+		return "-";
+	}
+
+	try {
+		switch ( column ) {
+			case EventListModel::OriginTime:
+				return timeToString(origin->time().value(), timeFormat());
+			case EventListModel::Type:
+				return QString(QChar(objectStatusToChar(origin)));
+			case EventListModel::Phases:
+				return QString("%1").arg(origin->quality().usedPhaseCount());
+			case EventListModel::RMS:
+				return QString("%1").arg(origin->quality().standardError(), 0, 'f', SCScheme.precision.rms);
+			case EventListModel::Latitude:
+			{
+				double lat = origin->latitude();
+				return QString("%1 %2").arg(fabs(lat), 0, 'f', SCScheme.precision.location).arg(lat < 0 ? "S" : "N");
+			}
+			case EventListModel::Longitude:
+			{
+				double lon = origin->longitude();
+				return QString("%1 %2").arg(fabs(lon), 0, 'f', SCScheme.precision.location).arg(lon < 0 ? "W" : "E");
+			}
+			case EventListModel::Depth:
+				return QString("%1 km").arg(depthToString(origin->depth(), SCScheme.precision.depth));
+			case EventListModel::Agency:
+				return origin->creationInfo().agencyID().c_str();
+			case EventListModel::Region:
+				return Regions::getRegionName(origin->latitude(), origin->longitude()).c_str();
+			case EventListModel::ID:
+				return origin->publicID().c_str();
+			default:
+				break;
+		}
+	}
+	catch ( ... ) {}
+
+	return "-";
+}
+
+
+QVariant originForeground(const Origin *origin, int column) {
+	if ( !origin ) {
+		return QVariant();
+	}
+
+	try {
+		if ( column == EventListModel::Type ) {
+			return origin->evaluationMode() == MANUAL ?
+			       SCScheme.colors.originStatus.manual :
+			       SCScheme.colors.originStatus.automatic;
+		}
+		else if ( column == EventListModel::Agency ) {
+			auto it = SCScheme.colors.agencies.find(origin->creationInfo().agencyID());
+			if ( it != SCScheme.colors.agencies.end() ) {
+				return it.value();
+			}
+		}
+	}
+	catch ( ... ) {
+		if ( column == EventListModel::Type ) {
+			return SCScheme.colors.originStatus.automatic;
+		}
+	}
+
+	return QVariant();
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct EventListModel::Entry {
+	EventPtr               event;
+	OriginPtr              origin;
+	MagnitudePtr           magnitude;
+	std::vector<OriginPtr> origins;
+	QString                originID;
+	QString                magnitudeID;
+	double                 keys[ColumnCount];
+	int                    row{-1};
+	bool                   fetched{false};
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+EventListModel::EventListModel(DatabaseQuery *query, QObject *parent)
+: QAbstractItemModel(parent)
+, _query(query)
+, _sortColumn(OriginTime)
+, _sortOrder(Qt::DescendingOrder) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+EventListModel::~EventListModel() {
+	qDeleteAll(_rows);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void EventListModel::setDatabase(DatabaseQuery *query) {
+	_query = query;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int EventListModel::load(const Core::TimeWindow &tw) {
+	if ( !_query ) {
+		return 0;
+	}
+
+	beginResetModel();
+
+	qDeleteAll(_rows);
+	_rows.clear();
+	_events.clear();
+	_preferred.clear();
+
+	// Read the preferred origins and magnitudes with one query each. They
+	// are kept alive until the events have resolved them.
+	QVector<OriginPtr> origins;
+	QVector<MagnitudePtr> magnitudes;
+
+	DatabaseIterator it = _query->getPreferredOrigins(tw.startTime(), tw.endTime(), "");
+	for ( ; *it; ++it ) {
+		OriginPtr origin = Origin::Cast(*it);
+		if ( origin ) {
+			origins.append(origin);
+		}
+	}
+	it.close();
+
+	it = _query->getPreferredMagnitudes(tw.startTime(), tw.endTime(), "");
+	for ( ; *it; ++it ) {
+		MagnitudePtr magnitude = DataModel::Magnitude::Cast(*it);
+		if ( magnitude ) {
+			magnitudes.append(magnitude);
+		}
+	}
+	it.close();
+
+	it = _query->getEvents(tw.startTime(), tw.endTime());
+	for ( ; *it; ++it ) {
+		EventPtr event = Event::Cast(*it);
+		if ( !event ) {
+			continue;
+		}
+
+		QString id = event->publicID().c_str();
+		if ( _events.contains(id) ) {
+			continue;
+		}
+
+		Entry *entry = new Entry;
+		entry->event = event;
+		resolve(entry);
+
+		_events[id] = entry;
+		_rows.append(entry);
+	}
+	it.close();
+
+	std::stable_sort(_rows.begin(), _rows.end(), [this](const Entry *a, const Entry *b) {
+		return lessThan(a, b);
+	});
+	renumber(0, _rows.size()-1);
+
+	endResetModel();
+
+	return _rows.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void EventListModel::clear() {
+	beginResetModel();
+	qDeleteAll(_rows);
+	_rows.clear();
+	_events.clear();
+	_preferred.clear();
+	endResetModel();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool EventListModel::add(Event *event) {
+	if ( !event ) {
+		return false;
+	}
+
+	QString id = event->publicID().c_str();
+	auto it = _events.find(id);
+	if ( it != _events.end() ) {
+		it.value()->event = event;
+		refresh(it.value());
+		return true;
+	}
+
+	Entry *entry = new Entry;
+	entry->event = event;
+	resolve(entry);
+
+	int row = sortedRow(entry);
+
+	beginInsertRows(QModelIndex(), row, row);
+	_rows.insert(row, entry);
+	_events[id] = entry;
+	renumber(row, _rows.size()-1);
+	endInsertRows();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool EventListModel::remove(const std::string &eventID) {
+	auto it = _events.find(eventID.c_str());
+	if ( it == _events.end() ) {
+		return false;
+	}
+
+	Entry *entry = it.value();
+	int row = entry->row;
+
+	beginRemoveRows(QModelIndex(), row, row);
+	_rows.remove(row);
+	_events.erase(it);
+	if ( _preferred.value(entry->originID) == entry ) {
+		_preferred.remove(entry->originID);
+	}
+	if ( _preferred.value(entry->magnitudeID) == entry ) {
+		_preferred.remove(entry->magnitudeID);
+	}
+	renumber(row, _rows.size()-1);
+	endRemoveRows();
+
+	delete entry;
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool EventListModel::handleNotifier(const Notifier *n) {
+	Object *obj = n->object();
+
+	Event *event = Event::Cast(obj);
+	if ( event ) {
+		switch ( n->operation() ) {
+			case OP_ADD:
+			{
+				Event *registered = Event::Find(event->publicID());
+				return add(registered ? registered : event);
+			}
+			case OP_UPDATE:
+			{
+				if ( !_events.contains(event->publicID().c_str()) ) {
+					return false;
+				}
+				Event *registered = Event::Find(event->publicID());
+				return add(registered ? registered : event);
+			}
+			case OP_REMOVE:
+				return remove(event->publicID());
+			default:
+				return false;
+		}
+	}
+
+	OriginReference *ref = OriginReference::Cast(obj);
+	if ( ref ) {
+		Entry *entry = _events.value(n->parentID().c_str());
+		if ( !entry || !entry->fetched ) {
+			return false;
+		}
+
+		QModelIndex parent = createIndex(entry->row, 0, nullptr);
+		auto it = std::find_if(entry->origins.begin(), entry->origins.end(),
+		                       [ref](const OriginPtr &o) {
+			return o->publicID() == ref->originID();
+		});
+
+		if ( n->operation() == OP_ADD ) {
+			if ( it != entry->origins.end() ) {
+				return false;
+			}
+
+			OriginPtr origin = findObject<Origin>(_query, ref->originID());
+			if ( !origin ) {
+				return false;
+			}
+
+			// Origins are listed youngest first
+			beginInsertRows(parent, 0, 0);
+			entry->origins.insert(entry->origins.begin(), origin);
+			endInsertRows();
+			return true;
+		}
+		else if ( n->operation() == OP_REMOVE ) {
+			if ( it == entry->origins.end() ) {
+				return false;
+			}
+
+			int row = static_cast<int>(it - entry->origins.begin());
+			beginRemoveRows(parent, row, row);
+			entry->origins.erase(it);
+			endRemoveRows();
+			return true;
+		}
+
+		return false;
+	}
+
+	if ( Origin::Cast(obj) || DataModel::Magnitude::Cast(obj) ) {
+		if ( n->operation() == OP_REMOVE ) {
+			return false;
+		}
+
+		Entry *entry = _preferred.value(static_cast<PublicObject*>(obj)->publicID().c_str());
+		if ( !entry ) {
+			return false;
+		}
+
+		refresh(entry);
+		return true;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Event *EventListModel::event(const QModelIndex &index) const {
+	Entry *e = entry(index);
+	return e ? e->event.get() : nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Origin *EventListModel::origin(const QModelIndex &index) const {
+	Entry *e = entry(index);
+	if ( !e ) {
+		return nullptr;
+	}
+
+	if ( index.internalPointer() ) {
+		return e->origins[index.row()].get();
+	}
+
+	return e->origin.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+QModelIndex EventListModel::indexOf(const std::string &eventID) const {
+	Entry *entry = _events.value(eventID.c_str());
+	if ( !entry ) {
+		return QModelIndex();
+	}
+
+	return createIndex(entry->row, 0, nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+QModelIndex EventListModel::index(int row, int column,
+                                  const QModelIndex &parent) const {
+	if ( (row < 0) || (column < 0) || (column >= ColumnCount) ) {
+		return QModelIndex();
+	}
+
+	if ( !parent.isValid() ) {
+		if ( row >= _rows.size() ) {
+			return QModelIndex();
+		}
+
+		return createIndex(row, column, nullptr);
+	}
+
+	// Origin rows do not have children
+	if ( parent.internalPointer() ) {
+		return QModelIndex();
+	}
+
+	Entry *e = entry(parent);
+	if ( !e || (row >= static_cast<int>(e->origins.size())) ) {
+		return QModelIndex();
+	}
+
+	return createIndex(row, column, e);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+QModelIndex EventListModel::parent(const QModelIndex &child) const {
+	Entry *e = static_cast<Entry*>(child.internalPointer());
+	if ( !e ) {
+		return QModelIndex();
+	}
+
+	return createIndex(e->row, 0, nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int EventListModel::rowCount(const QModelIndex &parent) const {
+	if ( !parent.isValid() ) {
+		return _rows.size();
+	}
+
+	if ( (parent.column() > 0) || parent.internalPointer() ) {
+		return 0;
+	}
+
+	Entry *e = entry(parent);
+	return e ? static_cast<int>(e->origins.size()) : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int EventListModel::columnCount(const QModelIndex &) const {
+	return ColumnCount;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool EventListModel::hasChildren(const QModelIndex &parent) const {
+	if ( !parent.isValid() ) {
+		return !_rows.isEmpty();
+	}
+
+	if ( (parent.column() > 0) || parent.internalPointer() ) {
+		return false;
+	}
+
+	// Unfetched events are expandable until their origins are known
+	Entry *e = entry(parent);
+	return e && (!e->fetched || !e->origins.empty());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool EventListModel::canFetchMore(const QModelIndex &parent) const {
+	if ( !parent.isValid() || parent.internalPointer() ) {
+		return false;
+	}
+
+	Entry *e = entry(parent);
+	return e && !e->fetched;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void EventListModel::fetchMore(const QModelIndex &parent) {
+	if ( !canFetchMore(parent) ) {
+		return;
+	}
+
+	Entry *e = entry(parent);
+	std::vector<OriginPtr> origins;
+
+	if ( _query ) {
+		DatabaseIterator it = _query->getOriginsDescending(e->event->publicID());
+		for ( ; *it; ++it ) {
+			OriginPtr origin = Origin::Cast(*it);
+			if ( !origin ) {
+				continue;
+			}
+
+			// Prefer instances which are already in use
+			Origin *registered = Origin::Find(origin->publicID());
+			origins.push_back(registered ? registered : origin.get());
+		}
+		it.close();
+	}
+	else {
+		for ( size_t i = e->event->originReferenceCount(); i > 0; --i ) {
+			Origin *origin = Origin::Find(e->event->originReference(i-1)->originID());
+			if ( origin ) {
+				origins.push_back(origin);
+			}
+		}
+	}
+
+	e->fetched = true;
+
+	if ( origins.empty() ) {
+		return;
+	}
+
+	beginInsertRows(parent, 0, static_cast<int>(origins.size())-1);
+	e->origins.swap(origins);
+	endInsertRows();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+QVariant EventListModel::data(const QModelIndex &index, int role) const {
+	Entry *e = entry(index);
+	if ( !e ) {
+		return QVariant();
+	}
+
+	int column = index.column();
+	const Origin *origin = index.internalPointer() ?
+	                       e->origins[index.row()].get() : e->origin.get();
+
+	switch ( role ) {
+		case Qt::DisplayRole:
+			if ( index.internalPointer() ) {
+				return originText(origin, column);
+			}
+			return text(e, column);
+
+		case Qt::ForegroundRole:
+			return originForeground(origin, column);
+
+		case Qt::TextAlignmentRole:
+			if ( isNumeric(column) && (column != OriginTime) ) {
+				return int(Qt::AlignRight | Qt::AlignVCenter);
+			}
+			break;
+
+		case Qt::UserRole:
+			if ( !index.internalPointer() && isNumeric(column) && !std::isnan(e->keys[column]) ) {
+				return e->keys[column];
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	return QVariant();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+QVariant EventListModel::headerData(int section, Qt::Orientation orientation,
+                                    int role) const {
+	if ( (orientation != Qt::Horizontal) || (role != Qt::DisplayRole) ) {
+		return QVariant();
+	}
+
+	switch ( section ) {
+		case OriginTime: return tr("OT(%1)").arg(SCScheme.dateTime.useLocalTime ? Core::Time::LocalTimeZone().c_str() : "UTC");
+		case Type: return tr("Type");
+		case Magnitude: return tr("M");
+		case MagnitudeType: return tr("MType");
+		case Phases: return tr("Phases");
+		case RMS: return tr("RMS");
+		case Latitude: return tr("Lat");
+		case Longitude: return tr("Lon");
+		case Depth: return tr("Depth");
+		case Agency: return tr("Agency");
+		case Region: return tr("Region");
+		case ID: return tr("ID");
+		default: break;
+	}
+
+	return QVariant();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void EventListModel::sort(int column, Qt::SortOrder order) {
+	if ( (column < 0) || (column >= ColumnCount) ) {
+		return;
+	}
+
+	_sortColumn = column;
+	_sortOrder = order;
+
+	if ( _rows.isEmpty() ) {
+		return;
+	}
+
+	emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(),
+	                            QAbstractItemModel::VerticalSortHint);
+
+	QVector<Entry*> previous = _rows;
+
+	if ( isNumeric(column) ) {
+		std::stable_sort(_rows.begin(), _rows.end(), [this](const Entry *a, const Entry *b) {
+			return lessThan(a, b);
+		});
+	}
+	else {
+		// Create the texts only once per row rather than per comparison
+		typedef QPair<QString, Entry*> TextKey;
+		QVector<TextKey> keys(_rows.size());
+		for ( int i = 0; i < _rows.size(); ++i ) {
+			keys[i] = TextKey(text(_rows[i], column), _rows[i]);
+		}
+
+		std::stable_sort(keys.begin(), keys.end(), [order](const TextKey &a, const TextKey &b) {
+			return order == Qt::AscendingOrder ? a.first < b.first : b.first < a.first;
+		});
+
+		for ( int i = 0; i < keys.size(); ++i ) {
+			_rows[i] = keys[i].second;
+		}
+	}
+
+	renumber(0, _rows.size()-1);
+
+	// Origin rows keep their row and parent entry, only the event rows move
+	QModelIndexList from = persistentIndexList(), to;
+	for ( const QModelIndex &idx : from ) {
+		if ( idx.internalPointer() ) {
+			to.append(idx);
+		}
+		else {
+			to.append(createIndex(previous[idx.row()]->row, idx.column(), nullptr));
+		}
+	}
+	changePersistentIndexList(from, to);
+
+	emit layoutChanged(QList<QPersistentModelIndex>(),
+	                   QAbstractItemModel::VerticalSortHint);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+EventListModel::Entry *EventListModel::entry(const QModelIndex &index) const {
+	if ( !index.isValid() ) {
+		return nullptr;
+	}
+
+	Entry *parent = static_cast<Entry*>(index.internalPointer());
+	if ( parent ) {
+		return parent;
+	}
+
+	return index.row() < _rows.size() ? _rows[index.row()] : nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void EventListModel::resolve(Entry *entry) {
+	if ( _preferred.value(entry->originID) == entry ) {
+		_preferred.remove(entry->originID);
+	}
+	if ( _preferred.value(entry->magnitudeID) == entry ) {
+		_preferred.remove(entry->magnitudeID);
+	}
+
+	const Event *event = entry->event.get();
+	entry->origin = findObject<Origin>(_query, event->preferredOriginID());
+	entry->magnitude = findObject<DataModel::Magnitude>(_query, event->preferredMagnitudeID());
+	entry->originID = event->preferredOriginID().c_str();
+	entry->magnitudeID = event->preferredMagnitudeID().c_str();
+
+	if ( !entry->originID.isEmpty() ) {
+		_preferred[entry->originID] = entry;
+	}
+	if ( !entry->magnitudeID.isEmpty() ) {
+		_preferred[entry->magnitudeID] = entry;
+	}
+
+	std::fill(entry->keys, entry->keys + ColumnCount, Missing);
+
+	const Origin *origin = entry->origin.get();
+	if ( origin ) {
+		entry->keys[OriginTime] = static_cast<double>(origin->time().value());
+		entry->keys[Latitude] = origin->latitude();
+		entry->keys[Longitude] = origin->longitude();
+
+		try { entry->keys[Depth] = origin->depth().value(); }
+		catch ( ... ) {}
+
+		try { entry->keys[Phases] = origin->quality().usedPhaseCount(); }
+		catch ( ... ) {}
+
+		try { entry->keys[RMS] = origin->quality().standardError(); }
+		catch ( ... ) {}
+	}
+
+	if ( entry->magnitude ) {
+		entry->keys[Magnitude] = entry->magnitude->magnitude().value();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void EventListModel::refresh(Entry *entry) {
+	resolve(entry);
+
+	int from = entry->row;
+	int last = _rows.size()-1;
+	int to = from;
+
+	// Only search the sorted part of the rows without the updated entry
+	if ( (from > 0) && lessThan(entry, _rows[from-1]) ) {
+		to = std::upper_bound(_rows.begin(), _rows.begin() + from, entry,
+		                      [this](const Entry *a, const Entry *b) {
+			return lessThan(a, b);
+		}) - _rows.begin();
+	}
+	else if ( (from < last) && lessThan(_rows[from+1], entry) ) {
+		to = std::upper_bound(_rows.begin() + from + 1, _rows.end(), entry,
+		                      [this](const Entry *a, const Entry *b) {
+			return lessThan(a, b);
+		}) - _rows.begin();
+	}
+
+	if ( to != from ) {
+		beginMoveRows(QModelIndex(), from, from, QModelIndex(), to);
+		_rows.remove(from);
+		if ( to > from ) {
+			--to;
+		}
+		_rows.insert(to, entry);
+		renumber(std::min(from, to), std::max(from, to));
+		endMoveRows();
+	}
+
+	emit dataChanged(createIndex(entry->row, 0, nullptr),
+	                 createIndex(entry->row, ColumnCount-1, nullptr));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool EventListModel::lessThan(const Entry *a, const Entry *b) const {
+	if ( _sortOrder == Qt::DescendingOrder ) {
+		std::swap(a, b);
+	}
+
+	if ( isNumeric(_sortColumn) ) {
+		double ka = a->keys[_sortColumn];
+		double kb = b->keys[_sortColumn];
+
+		// Missing values are lower than any value
+		if ( std::isnan(ka) ) {
+			return !std::isnan(kb);
+		}
+		if ( std::isnan(kb) ) {
+			return false;
+		}
+
+		return ka < kb;
+	}
+
+	return text(a, _sortColumn) < text(b, _sortColumn);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int EventListModel::sortedRow(const Entry *entry) const {
+	return std::upper_bound(_rows.begin(), _rows.end(), entry,
+	                        [this](const Entry *a, const Entry *b) {
+		return lessThan(a, b);
+	}) - _rows.begin();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void EventListModel::renumber(int from, int to) {
+	for ( int i = from; i <= to; ++i ) {
+		_rows[i]->row = i;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+QString EventListModel::text(const Entry *entry, int column) const {
+	switch ( column ) {
+		case Magnitude:
+			if ( entry->magnitude ) {
+				return QString("%1").arg(entry->magnitude->magnitude().value(), 0, 'f', SCScheme.precision.magnitude);
+			}
+			return "-";
+		case MagnitudeType:
+			if ( entry->magnitude ) {
+				return entry->magnitude->type().c_str();
+			}
+			return "-";
+		case Region:
+		{
+			std::string region = eventRegion(entry->event.get());
+			if ( !region.empty() ) {
+				return region.c_str();
+			}
+			break;
+		}
+		case ID:
+			return entry->event->publicID().c_str();
+		default:
+			break;
+	}
+
+	return originText(entry->origin.get(), column);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
@@ -0,0 +1,195 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_GUI_EVENTLISTMODEL_H
+#define SEISCOMP_GUI_EVENTLISTMODEL_H
+
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
+#ifndef Q_MOC_RUN
+#include <seiscomp/core/timewindow.h>
+#include <seiscomp/datamodel/event.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/magnitude.h>
+#endif
+#include <seiscomp/gui/qt.h>
+
+#include <string>
+
+
+namespace Seiscomp {
+
+namespace DataModel {
+
+class DatabaseQuery;
+class Notifier;
+
+}
+
+namespace Gui {
+
+
+/**
+ * @brief A lazily populated item model of events and their origins.
+ *
+ * In contrast to the EventListView tree widget only the events with their
+ * preferred origins and magnitudes are kept in memory. The origins of
+ * an event are fetched from the database when its row is expanded the first
+ * time (see canFetchMore and fetchMore). Sort keys are stored as plain
+ * numbers per event and sorting only permutes the row order. New and
+ * updated events are inserted or moved at their sorted position without
+ * resorting the whole list.
+ */
+class SC_GUI_API EventListModel : public QAbstractItemModel {
+	Q_OBJECT
+
+	// ------------------------------------------------------------------
+	//  Public types
+	// ------------------------------------------------------------------
+	public:
+		enum Column {
+			OriginTime = 0,
+			Type,
+			Magnitude,
+			MagnitudeType,
+			Phases,
+			RMS,
+			Latitude,
+			Longitude,
+			Depth,
+			Agency,
+			Region,
+			ID,
+			ColumnCount
+		};
+
+
+	// ------------------------------------------------------------------
+	//  X'truction
+	// ------------------------------------------------------------------
+	public:
+		EventListModel(DataModel::DatabaseQuery *query = nullptr,
+		               QObject *parent = nullptr);
+		~EventListModel() override;
+
+
+	// ------------------------------------------------------------------
+	//  Public interface
+	// ------------------------------------------------------------------
+	public:
+		//! Sets the database used to load events and to fetch origins
+		void setDatabase(DataModel::DatabaseQuery *query);
+
+		/**
+		 * @brief Replaces all events with the events of the given time
+		 *        window read from the database.
+		 * @param tw The time window
+		 * @return The number of events read
+		 */
+		int load(const Core::TimeWindow &tw);
+
+		//! Removes all events
+		void clear();
+
+		//! Adds an event or updates it if it is already part of the model
+		bool add(DataModel::Event *event);
+
+		//! Removes an event
+		bool remove(const std::string &eventID);
+
+		/**
+		 * @brief Updates the model according to a notifier. Events are
+		 *        added, updated and removed and origin references are
+		 *        added to already fetched origin lists. Updates of
+		 *        preferred origins and magnitudes refresh their events.
+		 * @param n The notifier
+		 * @return Whether the model has changed
+		 */
+		bool handleNotifier(const DataModel::Notifier *n);
+
+		//! Returns the event of an event or origin row
+		DataModel::Event *event(const QModelIndex &index) const;
+
+		//! Returns the origin of an origin row or the preferred origin of
+		//! an event row
+		DataModel::Origin *origin(const QModelIndex &index) const;
+
+		//! Returns the index of the event row with the given publicID
+		QModelIndex indexOf(const std::string &eventID) const;
+
+
+	// ------------------------------------------------------------------
+	//  QAbstractItemModel interface
+	// ------------------------------------------------------------------
+	public:
+		QModelIndex index(int row, int column,
+		                  const QModelIndex &parent = QModelIndex()) const override;
+		QModelIndex parent(const QModelIndex &child) const override;
+
+		int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+		int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+		bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+
+		bool canFetchMore(const QModelIndex &parent) const override;
+		void fetchMore(const QModelIndex &parent) override;
+
+		QVariant data(const QModelIndex &index, int role) const override;
+		QVariant headerData(int section, Qt::Orientation orientation,
+		                    int role = Qt::DisplayRole) const override;
+
+		void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+
+	// ------------------------------------------------------------------
+	//  Private interface
+	// ------------------------------------------------------------------
+	private:
+		struct Entry;
+
+		Entry *entry(const QModelIndex &index) const;
+		void resolve(Entry *entry);
+		void refresh(Entry *entry);
+		bool lessThan(const Entry *a, const Entry *b) const;
+		int sortedRow(const Entry *entry) const;
+		void renumber(int from, int to);
+		QString text(const Entry *entry, int column) const;
+
+
+	// ------------------------------------------------------------------
+	//  Private members
+	// ------------------------------------------------------------------
+	private:
+		DataModel::DatabaseQuery *_query;
+		QVector<Entry*>           _rows;
+		QHash<QString, Entry*>    _events;
+		QHash<QString, Entry*>    _preferred;
+		int                       _sortColumn;
+		Qt::SortOrder             _sortOrder;
+};
+
+
+}
+}
+
+
+#endif
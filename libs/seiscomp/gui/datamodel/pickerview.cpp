@@ -183,6 +183,7 @@ class ZoomRecordWidget : public RecordWidget {
 			gradient.setColorAt(1.0, QColor(255,   0,   0, 255));
 
 			for ( int i = 0; i < 3; ++i ) {
+				spectrogram[i].setAsynchronous(this);
 				spectrogram[i].setOptions(spectrogram[i].options());
 				spectrogram[i].setGradient(gradient);
 			}
@@ -2559,6 +2560,12 @@ void PickerView::init() {
 	SC_D.recordView->setDefaultRowHeight(fontMetrics().ascent()*2+6);
 	SC_D.recordView->setSelectionEnabled(false);
 	SC_D.recordView->setRecordUpdateInterval(1000);
+	// Record sequences are not shared between the items of the picker
+	SC_D.recordView->setConcurrentRendering(true);
+
+	SC_D.ttWorker = new TravelTimeWorker(this);
+	connect(SC_D.ttWorker, SIGNAL(resultsAvailable()),
+	        this, SLOT(theoreticalArrivalsComputed()));
 
 	connect(SC_D.recordView, SIGNAL(currentItemChanged(RecordViewItem*, RecordViewItem*)),
 	        this, SLOT(itemSelected(RecordViewItem*, RecordViewItem*)));
@@ -5049,93 +5056,119 @@ bool PickerView::addTheoreticalArrivals(RecordViewItem* item,
 			depth = 0.0;
 		}
 
-		TravelTimeList* ttt = SC_D.ttTable->compute(elat, elon, depth, slat, slon, salt);
+		// The travel times are computed on a worker thread and the markers
+		// are added by theoreticalArrivalsComputed
+		TravelTimeWorker::Request req;
+		req.id = item->streamID();
+		req.sourceLatitude = elat;
+		req.sourceLongitude = elon;
+		req.sourceDepth = depth;
+		req.latitude = slat;
+		req.longitude = slon;
+		req.elevation = salt;
+		SC_D.ttWorker->compute(TravelTimeWorker::Requests(1, req));
 
-		if ( ttt ) {
-			QMap<QString, RecordMarker*> currentPhases;
+		return true;
+	}
+	catch ( std::exception& excp ) {
+		SEISCOMP_ERROR("%s", excp.what());
+		//item->label()->setText("unknown", 0, Qt::darkRed);
+	}
 
-			foreach ( const QString &phase, SC_D.phases ) {
-				// Find the TravelTime from the TravelTimeList that corresponds
-				// the current phase
-				const TravelTime *tt = findPhase(*ttt, phase, delta);
-				if ( !tt ) continue;
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-				// If there is already a theoretical marker for the given
-				// TravelTime the current item gets another alias
-				if ( currentPhases.contains(tt->phase.c_str()) ) {
-					currentPhases[tt->phase.c_str()]->addAlias(phase + THEORETICAL_POSTFIX);
-					continue;
-				}
 
-				PickerMarker* marker = new PickerMarker(
-					item->widget(),
-					(Core::Time)SC_D.origin->time() + Core::TimeSpan(tt->time),
-					phase + THEORETICAL_POSTFIX,
-					PickerMarker::Theoretical,
-					false
-				);
 
-				marker->setVisible(SC_D.ui.actionShowTheoreticalArrivals->isChecked());
 
-				// Set the description of the marker that is used as display text
-				marker->setDescription(tt->phase.c_str());
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PickerView::setTheoreticalArrivals(RecordViewItem *item,
+                                        const TravelTimeList &ttt) {
+	// Remove the markers of a previous result
+	for ( int i = 0; i < item->widget()->markerCount(); ) {
+		PickerMarker* m = static_cast<PickerMarker*>(item->widget()->marker(i));
+		if ( m->type() == PickerMarker::Theoretical )
+			item->widget()->removeMarker(i);
+		else
+			++i;
+	}
 
-				// Remember the phase
-				currentPhases[tt->phase.c_str()] = marker;
-			}
+	double delta = item->value(ITEM_DISTANCE_INDEX);
+	QMap<QString, RecordMarker*> currentPhases;
 
-			foreach ( const QString &phase, SC_D.showPhases ) {
-				// Find the TravelTime from the TravelTimeList that corresponds
-				// the current phase
-				const TravelTime *tt = findPhase(*ttt, phase, delta);
-				if ( !tt ) continue;
+	foreach ( const QString &phase, SC_D.phases ) {
+		// Find the TravelTime from the TravelTimeList that corresponds
+		// the current phase
+		const TravelTime *tt = findPhase(ttt, phase, delta);
+		if ( !tt ) continue;
 
-				// If there is already a theoretical marker for the given
-				// TravelTime the current item gets another alias
-				if ( currentPhases.contains(tt->phase.c_str()) ) {
-					currentPhases[tt->phase.c_str()]->addAlias(phase + THEORETICAL_POSTFIX);
-					continue;
-				}
+		// If there is already a theoretical marker for the given
+		// TravelTime the current item gets another alias
+		if ( currentPhases.contains(tt->phase.c_str()) ) {
+			currentPhases[tt->phase.c_str()]->addAlias(phase + THEORETICAL_POSTFIX);
+			continue;
+		}
 
-				PickerMarker* marker = new PickerMarker(
-					item->widget(),
-					(Core::Time)SC_D.origin->time() + Core::TimeSpan(tt->time),
-					phase + THEORETICAL_POSTFIX,
-					PickerMarker::Theoretical,
-					false
-				);
+		PickerMarker* marker = new PickerMarker(
+			item->widget(),
+			(Core::Time)SC_D.origin->time() + Core::TimeSpan(tt->time),
+			phase + THEORETICAL_POSTFIX,
+			PickerMarker::Theoretical,
+			false
+		);
 
-				marker->setVisible(SC_D.ui.actionShowTheoreticalArrivals->isChecked());
+		marker->setVisible(SC_D.ui.actionShowTheoreticalArrivals->isChecked());
 
-				// Set the description of the marker that is used as display text
-				marker->setDescription(tt->phase.c_str());
+		// Set the description of the marker that is used as display text
+		marker->setDescription(tt->phase.c_str());
 
-				// Remember the phase
-				currentPhases[tt->phase.c_str()] = marker;
-			}
+		// Remember the phase
+		currentPhases[tt->phase.c_str()] = marker;
+	}
 
-			delete ttt;
-		}
+	foreach ( const QString &phase, SC_D.showPhases ) {
+		// Find the TravelTime from the TravelTimeList that corresponds
+		// the current phase
+		const TravelTime *tt = findPhase(ttt, phase, delta);
+		if ( !tt ) continue;
 
-		for ( int i = 0; i < item->widget()->markerCount(); ++i ) {
-			PickerMarker* m = static_cast<PickerMarker*>(item->widget()->marker(i));
-			if ( m->text() == "P" && m->isArrival() ) {
-				RecordMarker* m2 = item->widget()->marker("P" THEORETICAL_POSTFIX);
-				if ( m2 ) {
-					item->setValue(ITEM_RESIDUAL_INDEX, -fabs((double)(m->correctedTime() - m2->correctedTime())));
-					break;
-				}
-			}
+		// If there is already a theoretical marker for the given
+		// TravelTime the current item gets another alias
+		if ( currentPhases.contains(tt->phase.c_str()) ) {
+			currentPhases[tt->phase.c_str()]->addAlias(phase + THEORETICAL_POSTFIX);
+			continue;
 		}
 
-		return true;
+		PickerMarker* marker = new PickerMarker(
+			item->widget(),
+			(Core::Time)SC_D.origin->time() + Core::TimeSpan(tt->time),
+			phase + THEORETICAL_POSTFIX,
+			PickerMarker::Theoretical,
+			false
+		);
+
+		marker->setVisible(SC_D.ui.actionShowTheoreticalArrivals->isChecked());
+
+		// Set the description of the marker that is used as display text
+		marker->setDescription(tt->phase.c_str());
+
+		// Remember the phase
+		currentPhases[tt->phase.c_str()] = marker;
 	}
-	catch ( std::exception& excp ) {
-		SEISCOMP_ERROR("%s", excp.what());
-		//item->label()->setText("unknown", 0, Qt::darkRed);
+
+	for ( int i = 0; i < item->widget()->markerCount(); ++i ) {
+		PickerMarker* m = static_cast<PickerMarker*>(item->widget()->marker(i));
+		if ( m->text() == "P" && m->isArrival() ) {
+			RecordMarker* m2 = item->widget()->marker("P" THEORETICAL_POSTFIX);
+			if ( m2 ) {
+				item->setValue(ITEM_RESIDUAL_INDEX, -fabs((double)(m->correctedTime() - m2->correctedTime())));
+				break;
+			}
+		}
 	}
 
-	return false;
+	item->widget()->update();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -5146,6 +5179,9 @@ bool PickerView::addTheoreticalArrivals(RecordViewItem* item,
 bool PickerView::fillTheoreticalArrivals() {
 	bool stationSet = false;
 
+	// Results of a previous origin or table are outdated
+	SC_D.ttWorker->cancel();
+
 	for ( int i = 0; i < SC_D.recordView->rowCount(); ++i ) {
 		WaveformStreamID stream_id = SC_D.recordView->streamID(i);
 
@@ -5163,6 +5199,31 @@ bool PickerView::fillTheoreticalArrivals() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PickerView::theoreticalArrivalsComputed() {
+	TravelTimeWorker::Results results = SC_D.ttWorker->takeResults();
+	if ( !SC_D.origin ) return;
+
+	for ( const TravelTimeWorker::Result &res : results ) {
+		if ( !res.valid ) continue;
+
+		// The item might have been removed meanwhile
+		RecordViewItem *item = SC_D.recordView->item(res.id);
+		if ( !item ) continue;
+
+		setTheoreticalArrivals(item, res.travelTimes);
+	}
+
+	if ( SC_D.ui.actionSortByResidual->isChecked() )
+		sortByResidual();
+
+	SC_D.currentRecord->update();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool PickerView::fillRawPicks() {
 	bool pickAdded = false;
@@ -6078,6 +6139,7 @@ void PickerView::ttTableChanged(QString tables) {
 		                      .arg(SC_D.ttTableName.c_str()));
 	}
 
+	SC_D.ttWorker->setTable(SC_D.ttInterface, SC_D.ttTableName);
 	fillTheoreticalArrivals();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
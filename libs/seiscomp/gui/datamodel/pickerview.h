@@ -517,6 +517,7 @@ class SC_GUI_API PickerView : public QMainWindow {
 
 		void ttInterfaceChanged(QString);
 		void ttTableChanged(QString);
+		void theoreticalArrivalsComputed();
 
 
 	protected:
@@ -559,6 +560,7 @@ class SC_GUI_API PickerView : public QMainWindow {
 		                            const std::string& netCode,
 		                            const std::string& staCode,
 		                            const std::string& locCode);
+		void setTheoreticalArrivals(RecordViewItem*, const TravelTimeList &ttt);
 
 		bool addRawPick(Seiscomp::DataModel::Pick*);
 
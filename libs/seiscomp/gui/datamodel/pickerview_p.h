@@ -36,6 +36,7 @@
 
 #include "pickerview.h"
 
+#include <seiscomp/gui/datamodel/ttworker.h>
 #include <seiscomp/gui/datamodel/ui_pickerview.h>
 
 
@@ -118,6 +119,7 @@ class PickerViewPrivate {
 		QString                             currentPhase;
 		QString                             lastRecordURL;
 		TravelTimeTableInterfacePtr         ttTable;
+		TravelTimeWorker                   *ttWorker{nullptr};
 		bool                                centerSelection;
 		bool                                checkVisibility;
 		bool                                acquireNextStations;
@@ -23,10 +23,15 @@
 
 #include "stationsymbol.h"
 
+#include <QImage>
 #include <QPoint>
 #include <QPolygon>
 #include <QPainter>
 
+#include <algorithm>
+#include <map>
+#include <tuple>
+
 #include <seiscomp/gui/map/canvas.h>
 #include <seiscomp/gui/map/projection.h>
 #include <seiscomp/gui/core/application.h>
@@ -39,6 +44,39 @@ namespace Gui {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+// Maps with thousands of stations use only a handful of different styles.
+// Each style is rendered once into a sprite which is then blitted for
+// each station.
+struct SpriteKey {
+	int  radius;
+	int  frameSize;
+	QRgb frameColor;
+	QRgb outlineColor;
+	QRgb color;
+	bool antialias;
+
+	bool operator<(const SpriteKey &other) const {
+		return std::tie(radius, frameSize, frameColor, outlineColor, color, antialias) <
+		       std::tie(other.radius, other.frameSize, other.frameColor,
+		                other.outlineColor, other.color, other.antialias);
+	}
+};
+
+
+const size_t MaxSprites = 1024;
+std::map<SpriteKey, QImage> sprites;
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 StationSymbol::StationSymbol(Map::Decorator* decorator)
 : Symbol(decorator) {
@@ -162,33 +200,57 @@ int StationSymbol::radius() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void StationSymbol::customDraw(const Map::Canvas *, QPainter& painter) {
-	painter.save();
+	_stationPolygon = generateShape(_position.x(), _position.y(), _radius);
 
-	QPen pen(Qt::MiterJoin);
-	QBrush brush(Qt::SolidPattern);
+	SpriteKey key{_radius, _frameSize, _frameColor.rgba(), _outlineColor.rgba(),
+	              _color.rgba(), painter.testRenderHint(QPainter::Antialiasing)};
 
-	if ( _frameSize > 0 ) {
-		pen.setColor(_frameColor);
-		painter.setPen(pen);
+	// The shape extent plus margins for the pen and antialiasing
+	int extent = std::max(_radius, _radius + _frameSize) + 2;
+	QPoint origin(extent, extent);
 
-		brush.setColor(_frameColor);
-		painter.setBrush(brush);
+	QRect target(_position - origin, QSize(2*extent+1, 2*extent+1));
+	if ( painter.transform().type() == QTransform::TxNone &&
+	     !target.intersects(QRect(0, 0, painter.device()->width(), painter.device()->height())) )
+		return;
 
-		_stationPolygon = generateShape(_position.x(), _position.y(), _radius + _frameSize);
-		painter.drawPolygon(_stationPolygon);
-	}
+	auto it = sprites.find(key);
+	if ( it == sprites.end() ) {
+		if ( sprites.size() >= MaxSprites )
+			sprites.clear();
 
-	pen.setColor(_outlineColor);
-	painter.setPen(pen);
+		QImage sprite(target.size(), QImage::Format_ARGB32_Premultiplied);
+		sprite.fill(Qt::transparent);
 
-	brush.setColor(_color);
-	painter.setBrush(brush);
+		QPainter p(&sprite);
+		p.setRenderHint(QPainter::Antialiasing, key.antialias);
 
-	_stationPolygon = generateShape(_position.x(), _position.y(), _radius);
+		QPen pen(Qt::MiterJoin);
+		QBrush brush(Qt::SolidPattern);
+
+		if ( _frameSize > 0 ) {
+			pen.setColor(_frameColor);
+			p.setPen(pen);
+
+			brush.setColor(_frameColor);
+			p.setBrush(brush);
 
-	painter.drawPolygon(_stationPolygon);
+			p.drawPolygon(generateShape(origin.x(), origin.y(), _radius + _frameSize));
+		}
+
+		pen.setColor(_outlineColor);
+		p.setPen(pen);
+
+		brush.setColor(_color);
+		p.setBrush(brush);
+
+		p.drawPolygon(generateShape(origin.x(), origin.y(), _radius));
+		p.end();
+
+		it = sprites.insert(std::make_pair(key, sprite)).first;
+	}
 
-	painter.restore();
+	painter.drawImage(target.topLeft(), it->second);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
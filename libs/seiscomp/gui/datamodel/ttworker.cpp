@@ -0,0 +1,249 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT Gui::TravelTimeWorker
+
+#include <seiscomp/gui/datamodel/ttworker.h>
+#include <seiscomp/logging/log.h>
+
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <deque>
+#include <mutex>
+
+
+namespace Seiscomp {
+namespace Gui {
+
+
+namespace {
+
+
+// The number of requests computed before the results are handed over
+const size_t ChunkSize = 32;
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * State shared between the worker and its job. Everything in here is only
+ * accessed with the mutex held.
+ */
+struct TravelTimeWorker::State {
+	std::mutex                   mutex;
+	std::string                  interface;
+	std::string                  model;
+	std::deque<Request>          pending;
+	Results                      done;
+	unsigned int                 generation{0};
+	bool                         running{false};
+	TravelTimeWorker            *target{nullptr};
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct TravelTimeWorker::Job : QRunnable {
+	Job(const std::shared_ptr<State> &s) : state(s) {}
+
+	void run() override {
+		// The table is private to this job, reference counts of Seiscomp
+		// objects must not be shared between threads
+		TravelTimeTableInterfacePtr table;
+		std::string interface, model;
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+
+		while ( !state->pending.empty() ) {
+			size_t count = std::min(state->pending.size(), ChunkSize);
+			Requests requests(state->pending.begin(),
+			                  state->pending.begin() + count);
+			state->pending.erase(state->pending.begin(),
+			                     state->pending.begin() + count);
+
+			unsigned int generation = state->generation;
+
+			if ( !table || (interface != state->interface) || (model != state->model) ) {
+				interface = state->interface;
+				model = state->model;
+				table = nullptr;
+			}
+
+			lock.unlock();
+
+			if ( !table ) {
+				table = TravelTimeTableInterfaceFactory::Create(interface.c_str());
+				if ( table && !table->setModel(model) ) {
+					SEISCOMP_WARNING("Failed to set travel time table %s/%s",
+					                 interface.c_str(), model.c_str());
+					table = nullptr;
+				}
+			}
+
+			Results results(requests.size());
+			for ( size_t i = 0; i < requests.size(); ++i ) {
+				const Request &req = requests[i];
+				Result &res = results[i];
+				res.id = req.id;
+				res.valid = false;
+
+				if ( !table ) continue;
+
+				try {
+					TravelTimeList *ttt = table->compute(
+						req.sourceLatitude, req.sourceLongitude, req.sourceDepth,
+						req.latitude, req.longitude, req.elevation
+					);
+
+					if ( ttt ) {
+						res.travelTimes = *ttt;
+						res.valid = true;
+						delete ttt;
+					}
+				}
+				catch ( std::exception &e ) {
+					SEISCOMP_ERROR("%s", e.what());
+				}
+			}
+
+			lock.lock();
+
+			if ( generation == state->generation ) {
+				bool notify = state->done.empty();
+				state->done.insert(state->done.end(), results.begin(), results.end());
+				if ( notify && state->target ) {
+					QMetaObject::invokeMethod(state->target, "deliver",
+					                          Qt::QueuedConnection);
+				}
+			}
+		}
+
+		state->running = false;
+	}
+
+	std::shared_ptr<State> state;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+TravelTimeWorker::TravelTimeWorker(QObject *parent)
+: QObject(parent), _state(new State) {
+	_state->target = this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+TravelTimeWorker::~TravelTimeWorker() {
+	// Detach from a still running job
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	++_state->generation;
+	_state->pending.clear();
+	_state->done.clear();
+	_state->target = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TravelTimeWorker::setTable(const std::string &interface,
+                                const std::string &model) {
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	if ( (_state->interface == interface) && (_state->model == model) )
+		return;
+
+	++_state->generation;
+	_state->pending.clear();
+	_state->done.clear();
+	_state->interface = interface;
+	_state->model = model;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TravelTimeWorker::compute(const Requests &requests) {
+	if ( requests.empty() ) return;
+
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	_state->pending.insert(_state->pending.end(), requests.begin(), requests.end());
+
+	if ( !_state->running ) {
+		_state->running = true;
+		QThreadPool::globalInstance()->start(new Job(_state));
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TravelTimeWorker::cancel() {
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	++_state->generation;
+	_state->pending.clear();
+	_state->done.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+TravelTimeWorker::Results TravelTimeWorker::takeResults() {
+	Results results;
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	results.swap(_state->done);
+	return results;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TravelTimeWorker::deliver() {
+	emit resultsAvailable();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
@@ -0,0 +1,129 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_GUI_TTWORKER_H
+#define SEISCOMP_GUI_TTWORKER_H
+
+
+#include <seiscomp/datamodel/waveformstreamid.h>
+#include <seiscomp/seismology/ttt.h>
+#include <seiscomp/gui/qt.h>
+
+#include <QObject>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Gui {
+
+
+/**
+ * @brief The TravelTimeWorker class computes the travel times of many
+ *        source-receiver pairs on the global thread pool.
+ *
+ * Requests are queued and processed in chunks by one job at a time. The
+ * job creates its own travel time table so that nothing is shared with the
+ * GUI thread. Results are collected and announced with resultsAvailable
+ * which is emitted in the thread of the worker object.
+ */
+class SC_GUI_API TravelTimeWorker : public QObject {
+	Q_OBJECT
+
+	// ------------------------------------------------------------------
+	// Public types
+	// ------------------------------------------------------------------
+	public:
+		struct Request {
+			DataModel::WaveformStreamID id;
+			double                      sourceLatitude;
+			double                      sourceLongitude;
+			double                      sourceDepth;
+			double                      latitude;
+			double                      longitude;
+			double                      elevation;
+		};
+
+		struct Result {
+			DataModel::WaveformStreamID id;
+			//! False if the travel times could not be computed
+			bool                        valid;
+			TravelTimeList              travelTimes;
+		};
+
+		typedef std::vector<Request> Requests;
+		typedef std::vector<Result> Results;
+
+
+	// ------------------------------------------------------------------
+	// X'struction
+	// ------------------------------------------------------------------
+	public:
+		TravelTimeWorker(QObject *parent = nullptr);
+		~TravelTimeWorker() override;
+
+
+	// ------------------------------------------------------------------
+	// Public interface
+	// ------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Sets the travel time interface and model used for
+		 *        subsequent requests. Queued requests are discarded.
+		 */
+		void setTable(const std::string &interface, const std::string &model);
+
+		//! Queues requests and starts a job if none is running
+		void compute(const Requests &requests);
+
+		//! Discards all queued requests and the results not yet taken
+		//! including those of a running job
+		void cancel();
+
+		//! Returns and removes the results computed so far
+		Results takeResults();
+
+
+	signals:
+		void resultsAvailable();
+
+
+	private slots:
+		void deliver();
+
+
+	// ------------------------------------------------------------------
+	// Private members
+	// ------------------------------------------------------------------
+	private:
+		struct State;
+		struct Job;
+
+		std::shared_ptr<State> _state;
+};
+
+
+}
+}
+
+
+#endif
@@ -974,16 +974,30 @@ void Canvas::setSelectedCity(const Math::Geo::CityD *c) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Canvas::drawLayers(QPainter &painter) {
+	// Cached layers are not used while dragging where each frame changes
+	// the view anyway and if the painter scales, e.g. while printing
+	bool useCache = !_previewMode
+	             && painter.transform().type() <= QTransform::TxTranslate;
+
 	foreach ( Layer *layer, _layers ) {
 		if ( _dirtyVectorLayers ) layer->setDirty();
-		if ( !layer->isVisible() ) continue;
+		if ( !layer->isVisible() ) {
+			// Release the image of hidden layers
+			layer->_cache = QImage();
+			layer->_cacheValid = false;
+			continue;
+		}
 
 		if ( layer->isDirty() ) {
 			layer->calculateMapPosition(this);
 			layer->_dirty = false;
+			layer->_cacheValid = false;
 		}
 
-		layer->draw(this, painter);
+		if ( useCache && layer->isCachingEnabled() )
+			drawCachedLayer(layer, painter);
+		else
+			layer->draw(this, painter);
 	}
 
 	_dirtyVectorLayers = false;
@@ -993,6 +1007,32 @@ void Canvas::drawLayers(QPainter &painter) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Canvas::drawCachedLayer(Layer *layer, QPainter &painter) {
+	if ( !layer->_cacheValid || layer->_cache.size() != _buffer.size()
+	  || layer->_cacheHints != painter.renderHints() ) {
+		if ( layer->_cache.size() != _buffer.size() )
+			layer->_cache = QImage(_buffer.size(), QImage::Format_ARGB32_Premultiplied);
+		layer->_cache.fill(Qt::transparent);
+
+		QPainter p(&layer->_cache);
+		p.setRenderHints(painter.renderHints());
+		p.setFont(painter.font());
+		p.setPen(painter.pen());
+		p.setBrush(painter.brush());
+		layer->draw(this, p);
+
+		layer->_cacheHints = painter.renderHints();
+		layer->_cacheValid = true;
+	}
+
+	painter.drawImage(0, 0, layer->_cache);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Canvas::drawImage(const QRectF &geoReference, const QImage &image,
                        CompositionMode compositionMode, FilterMode filterMode) {
@@ -1840,10 +1880,13 @@ QMenu* Canvas::menu(QMenu *parent) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Canvas::updateLayer(const Layer::UpdateHints &hints) {
-	if ( hints.testFlag(Layer::Position) ) {
-		Layer *layer = static_cast<Layer*>(sender());
+	Layer *layer = static_cast<Layer*>(sender());
+	// Only the layer which requested the update is rendered again, all
+	// other cached layers are composited from their images
+	layer->invalidateCache();
+
+	if ( hints.testFlag(Layer::Position) )
 		layer->calculateMapPosition(this);
-	}
 
 	if ( hints.testFlag(Layer::RasterLayer) )
 		_dirtyRasterLayer = true;
@@ -353,6 +353,7 @@ class SC_GUI_API Canvas : public QObject {
 		              bool &lastUnderline, bool &lastBold);
 
 		void drawLegends(QPainter &painter);
+		void drawCachedLayer(Layer *layer, QPainter &painter);
 		void setupLayer(Layer *layer);
 
 
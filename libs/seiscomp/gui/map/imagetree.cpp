@@ -25,9 +25,17 @@
 #include <seiscomp/core/interfacefactory.ipp>
 #include <seiscomp/logging/log.h>
 
+#include <QCoreApplication>
+#include <QEvent>
+#include <QRunnable>
+#include <QSet>
+#include <QThreadPool>
+
 #include <iostream>
+#include <cmath>
 #include <cstdio>
 #include <clocale>
+#include <memory>
 
 
 IMPLEMENT_INTERFACE_FACTORY(Seiscomp::Gui::Map::TileStore, SC_GUI_API);
@@ -125,11 +133,77 @@ QString generatePath(int level, int col, int row,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const QEvent::Type TileLoadedEventType = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+
+struct TileLoadedEvent : QEvent {
+	TileLoadedEvent(const TileIndex &t, const QImage &img)
+	: QEvent(TileLoadedEventType), tile(t), image(img) {}
+
+	TileIndex tile;
+	QImage    image;
+};
+
+
+class TileDirectory;
+
+
+//! Receives the decoded tiles in the thread of the tile directory
+class TileReceiver : public QObject {
+	public:
+		TileReceiver(TileDirectory *dir) : _dir(dir) {}
+
+		bool event(QEvent *e) override;
+
+	private:
+		TileDirectory *_dir;
+};
+
+
+class TileLoader : public QRunnable {
+	public:
+		TileLoader(QObject *receiver, const TileIndex &tile, const QString &path)
+		: _receiver(receiver), _tile(tile), _path(path) {}
+
+		void run() override {
+			QImage img;
+
+			// Decode and convert off the GUI thread, the texture cache
+			// only takes the image
+			if ( img.load(_path) &&
+			     img.format() != QImage::Format_RGB32 &&
+			     img.format() != QImage::Format_ARGB32 ) {
+				img = img.convertToFormat(QImage::Format_ARGB32);
+			}
+
+			QCoreApplication::postEvent(_receiver, new TileLoadedEvent(_tile, img));
+		}
+
+	private:
+		QObject   *_receiver;
+		TileIndex  _tile;
+		QString    _path;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 class TileDirectory : public TileStore {
 	public:
 		TileDirectory() {}
 
+		~TileDirectory() override {
+			if ( _pool ) {
+				// Drop queued requests and wait for the running ones before
+				// the receiver goes away
+				_pool->clear();
+				_pool->waitForDone();
+			}
+		}
+
 		bool open(MapsDesc &desc) override {
 			_filePattern = desc.location.toStdString();
 
@@ -138,6 +212,12 @@ class TileDirectory : public TileStore {
 				QImage img(id);
 				_tilesize = img.size();
 
+				if ( (desc.loaderThreads > 0) && QCoreApplication::instance() ) {
+					_receiver.reset(new TileReceiver(this));
+					_pool.reset(new QThreadPool);
+					_pool->setMaxThreadCount(desc.loaderThreads);
+				}
+
 				return true;
 			}
 
@@ -149,19 +229,44 @@ class TileDirectory : public TileStore {
 		}
 
 		LoadResult load(QImage &img, const TileIndex &tile) override {
-			return img.load(getID(tile)) ? OK : Error;
+			if ( !_pool ) {
+				return img.load(getID(tile)) ? OK : Error;
+			}
+
+			if ( _failed.contains(tile.id) ) {
+				return Error;
+			}
+
+			if ( !_pending.contains(tile.id) ) {
+				_pending.insert(tile.id);
+				// Tiles close to the view center are decoded first
+				int priority = -static_cast<int>(viewCenterDistance(tile) * 1E6);
+				_pool->start(new TileLoader(_receiver.get(), tile, getID(tile)), priority);
+			}
+
+			return Deferred;
 		}
 
 		QString getID(const TileIndex &tile) const override {
 			return generatePath(tile.level(), tile.column(), tile.row(), _filePattern);
 		}
 
-		// Tiles are never loaded asynchronously
 		bool hasPendingRequests() const override {
-			return false;
+			return !_pending.isEmpty();
 		}
 
-		void refresh() override {}
+		void refresh() override {
+			_failed.clear();
+		}
+
+		void tileLoaded(const TileIndex &tile, QImage &img) {
+			_pending.remove(tile.id);
+			if ( img.isNull() ) {
+				_failed.insert(tile.id);
+			}
+
+			loadingComplete(img, tile);
+		}
 
 
 	protected:
@@ -176,13 +281,32 @@ class TileDirectory : public TileStore {
 		}
 
 	private:
-		std::string _filePattern;
+		std::string                   _filePattern;
+		std::unique_ptr<TileReceiver> _receiver;
+		std::unique_ptr<QThreadPool>  _pool;
+		QSet<TileIndex::Storage>      _pending;
+		QSet<TileIndex::Storage>      _failed;
 };
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool TileReceiver::event(QEvent *e) {
+	if ( e->type() != TileLoadedEventType ) {
+		return QObject::event(e);
+	}
+
+	TileLoadedEvent *ev = static_cast<TileLoadedEvent*>(e);
+	_dir->tileLoaded(ev->tile, ev->image);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -192,7 +316,7 @@ class TileDirectory : public TileStore {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 TileStore::TileStore()
-: _tree(nullptr) {}
+: _tree(nullptr), _viewCenter(0.5, 0.5) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -207,6 +331,33 @@ void TileStore::setImageTree(ImageTree *tree) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TileStore::setViewCenter(const QPointF &center) {
+	_viewCenter = center;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double TileStore::viewCenterDistance(const TileIndex &tile) const {
+	double scale = 1.0 / double(TileIndex::Storage(1) << tile.level());
+	double dx = fabs((tile.column() + 0.5) * scale - _viewCenter.x());
+	double dy = (tile.row() + 0.5) * scale - _viewCenter.y();
+
+	// Wrap around the dateline
+	if ( dx > 0.5 ) {
+		dx = 1.0 - dx;
+	}
+
+	return sqrt(dx*dx + dy*dy);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void TileStore::finishedLoading(QImage &img, const TileIndex &tile) {
 	if ( _tree )
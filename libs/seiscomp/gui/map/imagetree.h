@@ -29,6 +29,7 @@
 #include <seiscomp/gui/core/maps.h>
 
 #include <QImage>
+#include <QPointF>
 
 
 namespace Seiscomp {
@@ -90,6 +91,13 @@ class SC_GUI_API TileStore : public Core::BaseObject {
 		//! state changed, e.g. finishedLoading.
 		void setImageTree(ImageTree *tree);
 
+		//! Sets the center of the view in normalized tile coordinates
+		//! ranging from 0 to 1 from west to east and north to south.
+		//! Stores loading asynchronously should serve tiles close to
+		//! the center first.
+		//! This function was introduced with TILESTORE_VERSION 5.
+		void setViewCenter(const QPointF &center);
+
 	public:
 		virtual int maxLevel() const = 0;
 
@@ -133,10 +141,15 @@ class SC_GUI_API TileStore : public Core::BaseObject {
 		//! Invalidates the tile of a particular node
 		void invalidate(const TileIndex &tile);
 
+		//! Returns the normalized distance of the tile center to the
+		//! view center
+		double viewCenterDistance(const TileIndex &tile) const;
+
 
 	protected:
 		ImageTree *_tree;
 		QSize      _tilesize;
+		QPointF    _viewCenter;
 
 };
 
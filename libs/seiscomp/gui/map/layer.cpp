@@ -42,7 +42,9 @@ Layer::Layer(QObject* parent)
 , _canvas(nullptr)
 , _visible(true)
 , _antiAliasing(false)
-, _dirty(true) {
+, _dirty(true)
+, _cachingEnabled(false)
+, _cacheValid(false) {
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -297,7 +299,9 @@ bool Layer::isVisible() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Layer::setAntiAliasingEnabled(bool v) {
+	if ( _antiAliasing == v ) return;
 	_antiAliasing = v;
+	invalidateCache();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -322,6 +326,27 @@ void Layer::setDirty() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Layer::setCachingEnabled(bool enable) {
+	_cachingEnabled = enable;
+	invalidateCache();
+	if ( !_cachingEnabled )
+		_cache = QImage();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Layer::invalidateCache() {
+	_cacheValid = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Legend* Layer::legend(int i) const {
 	if ( i < 0 || i >= _legends.size() ) return nullptr;
@@ -31,7 +31,9 @@
 #include <seiscomp/gui/map/legend.h>
 #include <seiscomp/gui/map/mapsymbol.h>
 
+#include <QImage>
 #include <QObject>
+#include <QPainter>
 
 
 class QContextMenuEvent;
@@ -39,7 +41,6 @@ class QKeyEvent;
 class QMouseEvent;
 class QDialog;
 class QMenu;
-class QPainter;
 class QWidget;
 
 
@@ -145,6 +146,21 @@ class SC_GUI_API Layer : public QObject, public Seiscomp::Core::BaseObject {
 		void setDirty();
 		bool isDirty() const;
 
+		/**
+		 * @brief Enables caching of the rendered layer. The canvas renders
+		 *        the layer into an offscreen image and composites the image
+		 *        as long as the layer did not change. A layer which is
+		 *        cached must request an update or set itself dirty whenever
+		 *        its content changes. Caching is disabled by default.
+		 * @param enable Boolean flag
+		 */
+		void setCachingEnabled(bool enable);
+		bool isCachingEnabled() const;
+
+		//! Discards the cached image which is rendered again with the
+		//! next draw
+		void invalidateCache();
+
 		Canvas *canvas() const { return _canvas; }
 
 	public:
@@ -190,6 +206,11 @@ class SC_GUI_API Layer : public QObject, public Seiscomp::Core::BaseObject {
 		Legends         _legends;
 		bool            _dirty;
 
+		bool            _cachingEnabled;
+		bool            _cacheValid;
+		QImage          _cache;
+		QPainter::RenderHints _cacheHints;
+
 	friend class Canvas;
 };
 
@@ -199,6 +220,10 @@ inline bool Layer::isDirty() const {
 	return _dirty;
 }
 
+inline bool Layer::isCachingEnabled() const {
+	return _cachingEnabled;
+}
+
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Layer::UpdateHints)
 
@@ -25,6 +25,9 @@
 #include <seiscomp/gui/map/projection.h>
 #include <seiscomp/gui/map/standardlegend.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 namespace Seiscomp {
 namespace Gui {
@@ -32,14 +35,112 @@ namespace Map {
 
 #define CITY_NORMAL_SYMBOL_SIZE 4
 #define CITY_BIG_SYMBOL_SIZE    6
+
+
+namespace {
+
+
+// The cities are indexed in cells of 5x5 degrees
+const double IndexCellSize = 5.0;
+const int IndexRows = 36;
+const int IndexColumns = 72;
+
+
+int indexRow(double lat) {
+	int row = int(floor((lat + 90) / IndexCellSize));
+	return row < 0 ? 0 : (row >= IndexRows ? IndexRows - 1 : row);
+}
+
+
+int indexColumn(double lon) {
+	int column = int(floor((lon + 180) / IndexCellSize)) % IndexColumns;
+	return column < 0 ? column + IndexColumns : column;
+}
+
+
+int indexCell(double lat, double lon) {
+	return indexRow(lat) * IndexColumns + indexColumn(lon);
+}
+
+
+// The width of a cell of the label collision grid in pixels
+const int LabelGridColumnWidth = 64;
+
+
+}
+
+
+/**
+ * @brief Collision grid of the placed labels. Each label is stored in all
+ *        cells it overlaps, a new label is only tested against the labels
+ *        of the cells it overlaps.
+ */
+class CitiesLayer::LabelGrid {
+	public:
+		LabelGrid(int width, int height, int rowHeight)
+		: _rowHeight(std::max(rowHeight, 1))
+		, _rows(std::max(height / _rowHeight + 1, 1))
+		, _columns(std::max(width / LabelGridColumnWidth + 1, 1))
+		, _cells(_rows * _columns) {}
+
+	public:
+		bool intersects(const QRect &rect) const {
+			int firstRow, lastRow, firstColumn, lastColumn;
+			if ( !range(rect, firstRow, lastRow, firstColumn, lastColumn) )
+				return false;
+
+			for ( int row = firstRow; row <= lastRow; ++row ) {
+				for ( int column = firstColumn; column <= lastColumn; ++column ) {
+					foreach ( const QRect &other, _cells[row * _columns + column] ) {
+						if ( other.intersects(rect) ) return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		void insert(const QRect &rect) {
+			int firstRow, lastRow, firstColumn, lastColumn;
+			if ( !range(rect, firstRow, lastRow, firstColumn, lastColumn) )
+				return;
+
+			for ( int row = firstRow; row <= lastRow; ++row ) {
+				for ( int column = firstColumn; column <= lastColumn; ++column )
+					_cells[row * _columns + column].append(rect);
+			}
+		}
+
+	private:
+		bool range(const QRect &rect, int &firstRow, int &lastRow,
+		           int &firstColumn, int &lastColumn) const {
+			firstRow = std::max(rect.top() / _rowHeight, 0);
+			lastRow = std::min(rect.bottom() / _rowHeight, _rows - 1);
+			firstColumn = std::max(rect.left() / LabelGridColumnWidth, 0);
+			lastColumn = std::min(rect.right() / LabelGridColumnWidth, _columns - 1);
+			return rect.bottom() >= 0 && rect.right() >= 0
+			    && firstRow <= lastRow && firstColumn <= lastColumn;
+		}
+
+	private:
+		int                     _rowHeight;
+		int                     _rows;
+		int                     _columns;
+		QVector<QVector<QRect>> _cells;
+};
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-CitiesLayer::CitiesLayer(QObject* parent) : Layer(parent), _selectedCity(nullptr) {
+CitiesLayer::CitiesLayer(QObject* parent)
+: Layer(parent)
+, _selectedCity(nullptr)
+, _indexedCities(nullptr)
+, _indexedCityCount(0) {
 	setName("cities");
+	setCachingEnabled(true);
 	_topPopulatedPlaces = -1;
 
 	StandardLegend *legend = new StandardLegend(this);
@@ -81,30 +182,26 @@ void CitiesLayer::init(const Config::Config &cfg) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void CitiesLayer::draw(const Seiscomp::Gui::Map::Canvas* canvas,
-                       QPainter& painter) {
-	if ( !isVisible() ) return;
+void CitiesLayer::calculateMapPosition(const Canvas *canvas) {
+	_labels.clear();
+
 	if ( canvas == nullptr ) return;
 
-	Seiscomp::Gui::Map::Projection* projection = canvas->projection();
+	const Projection *projection = canvas->projection();
 	if ( projection == nullptr ) return;
 
-	painter.save();
-
-	painter.setRenderHint(QPainter::Antialiasing, isAntiAliasingEnabled());
+	const std::vector<Math::Geo::CityD> &cities = SCCoreApp->cities();
+	if ( cities.data() != _indexedCities || cities.size() != _indexedCityCount )
+		buildIndex(cities);
 
 	QFont font(SCScheme.fonts.cityLabels);
 	font.setBold(true);
-	painter.setFont(font);
+	QFontMetrics fontMetrics(font);
 
-	QFontMetrics fontMetrics = painter.fontMetrics();
+	int width = canvas->width(),
+	    height = canvas->height();
 
-	int height = canvas->height(),
-	    width = canvas->width(),
-	    fontHeight = fontMetrics.height(),
-	    gridHeight = height / fontHeight;
-
-	Grid grid(gridHeight);
+	LabelGrid grid(width, height, fontMetrics.height());
 
 	double radius = -1;
 
@@ -112,28 +209,56 @@ void CitiesLayer::draw(const Seiscomp::Gui::Map::Canvas* canvas,
 		radius = Math::Geo::deg2km(width / projection->pixelPerDegree()) *
 		                           SCScheme.map.cityPopulationWeight;
 
-	size_t maxRenderedCitites = SCCoreApp->cities().size();
+	int maxRenderedCitites = cities.size();
 	if ( _topPopulatedPlaces > 0 )
 		maxRenderedCitites = _topPopulatedPlaces;
 
-	bool lastUnderline = false;
-	bool lastBold = true;
-
 	if ( _selectedCity )
-		drawCity(painter, grid, font, lastUnderline, lastBold, projection,
-		         *_selectedCity, fontMetrics, width, fontHeight);
+		placeCity(grid, projection, *_selectedCity, fontMetrics, width, height);
+
+	// Only cities in the visible part of the map are considered. They
+	// are placed in order of decreasing population as the index refers to
+	// the list sorted by population.
+	QVector<int> indexes;
+	collectCities(indexes, projection, radius);
+	std::sort(indexes.begin(), indexes.end());
 
-	size_t citiesRendered = 0;
+	int citiesRendered = 0;
 
-	foreach ( const Math::Geo::CityD& city, SCCoreApp->cities() ) {
+	foreach ( int index, indexes ) {
 		if ( citiesRendered >= maxRenderedCitites ) break;
-		if ( city.population() < radius ) break;
+
+		const Math::Geo::CityD &city = cities[index];
 		if ( &city == _selectedCity ) continue;
 
-		if ( drawCity(painter, grid, font, lastUnderline, lastBold, projection,
-		         city, fontMetrics, width, fontHeight) )
+		if ( placeCity(grid, projection, city, fontMetrics, width, height) )
 			++citiesRendered;
 	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CitiesLayer::draw(const Seiscomp::Gui::Map::Canvas* canvas,
+                       QPainter& painter) {
+	if ( !isVisible() ) return;
+	if ( canvas == nullptr ) return;
+
+	painter.save();
+
+	painter.setRenderHint(QPainter::Antialiasing, isAntiAliasingEnabled());
+
+	QFont font(SCScheme.fonts.cityLabels);
+	font.setBold(true);
+	painter.setFont(font);
+
+	bool lastUnderline = false;
+	bool lastBold = true;
+
+	foreach ( const Label &label, _labels )
+		drawLabel(painter, font, lastUnderline, lastBold, label);
 
 	painter.restore();
 }
@@ -143,100 +268,137 @@ void CitiesLayer::draw(const Seiscomp::Gui::Map::Canvas* canvas,
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool CitiesLayer::drawCity(QPainter& painter, Grid &grid, QFont &font,
-                           bool &lastUnderline, bool &lastBold,
-                           const Projection* projection,
-                           const Math::Geo::CityD& city,
-                           const QFontMetrics& fontMetrics,
-                           int width, int rowHeight) {
-	QPoint p;
-	if ( !projection->project(p, QPointF(city.lon, city.lat)) )
-		return false;
+void CitiesLayer::buildIndex(const std::vector<Math::Geo::CityD> &cities) {
+	_cells.clear();
+	_cells.resize(IndexRows * IndexColumns);
 
-	int gridY, gridPrevY, gridNextY;
+	// The cities are sorted by population, each cell keeps that order
+	for ( size_t i = 0; i < cities.size(); ++i )
+		_cells[indexCell(cities[i].lat, cities[i].lon)].append(int(i));
 
-	gridY = p.y() / rowHeight;
+	_indexedCities = cities.data();
+	_indexedCityCount = cities.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-	if ( gridY < 0 || gridY >= grid.count() ) return false;
-	if ( p.x() < 0 || p.x() >= width ) return false;
 
-	QRect labelRect(fontMetrics.boundingRect(city.name().c_str()));
 
-	bool capital = (city.category() == "B" || city.category() == "C");
-	bool bold = city.population() >= 1000000;
 
-	int symbolSize = 4;
-	if ( bold )
-		symbolSize = 6;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CitiesLayer::collectCities(QVector<int> &indexes,
+                                const Projection *projection,
+                                double minPopulation) const {
+	const Geo::GeoBoundingBox &bbox = projection->boundingBox();
+
+	int firstRow = 0, lastRow = IndexRows - 1;
+	int firstColumn = 0, columnCount = IndexColumns;
+
+	// The visible cells are extended by one cell in each direction to
+	// cover cities close to the bounding box of curved projections
+	if ( !bbox.isEmpty() && !bbox.isNull() ) {
+		firstRow = std::max(indexRow(bbox.south) - 1, 0);
+		lastRow = std::min(indexRow(bbox.north) + 1, IndexRows - 1);
+
+		if ( !bbox.coversFullLongitude() ) {
+			firstColumn = indexColumn(bbox.west) - 1;
+			columnCount = std::min(int(bbox.width() / IndexCellSize) + 4,
+			                       IndexColumns);
+		}
+	}
 
-	labelRect.moveTo(QPoint(p.x()+symbolSize/2, p.y()));
-	labelRect.setWidth(labelRect.width()+2);
+	const std::vector<Math::Geo::CityD> &cities = SCCoreApp->cities();
 
-	QList<QRect> &gridRow = grid[gridY];
+	for ( int row = firstRow; row <= lastRow; ++row ) {
+		for ( int i = 0; i < columnCount; ++i ) {
+			int column = (firstColumn + i + IndexColumns) % IndexColumns;
+			const QVector<int> &cell = _cells[row * IndexColumns + column];
 
-	bool foundPlace = true;
-	for ( Row::iterator it = gridRow.begin();
-	      it != gridRow.end(); ++it ) {
-		if ( it->intersects(labelRect) ) {
-			foundPlace = false;
-			break;
+			foreach ( int index, cell ) {
+				// Less populated cities are left out when zooming out
+				if ( cities[index].population() < minPopulation ) break;
+				indexes.append(index);
+			}
 		}
 	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 
-	if ( !foundPlace ) {
-		labelRect.moveTo(labelRect.left() - labelRect.width() - symbolSize,
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CitiesLayer::placeCity(LabelGrid &grid, const Projection* projection,
+                            const Math::Geo::CityD& city,
+                            const QFontMetrics& fontMetrics,
+                            int width, int height) {
+	QPoint p;
+	if ( !projection->project(p, QPointF(city.lon, city.lat)) )
+		return false;
+
+	if ( p.y() < 0 || p.y() >= height ) return false;
+	if ( p.x() < 0 || p.x() >= width ) return false;
+
+	QRect labelRect(fontMetrics.boundingRect(city.name().c_str()));
+
+	Label label;
+	label.city = &city;
+	label.position = p;
+	label.capital = (city.category() == "B" || city.category() == "C");
+	label.bold = city.population() >= 1000000;
+	label.symbolSize = label.bold ? CITY_BIG_SYMBOL_SIZE : CITY_NORMAL_SYMBOL_SIZE;
+
+	labelRect.moveTo(QPoint(p.x()+label.symbolSize/2, p.y()));
+	labelRect.setWidth(labelRect.width()+2);
+
+	if ( grid.intersects(labelRect) ) {
+		labelRect.moveTo(labelRect.left() - labelRect.width() - label.symbolSize,
 		                 labelRect.top());
-		foundPlace = true;
-		for ( Row::iterator it = gridRow.begin();
-		      it != gridRow.end(); ++it ) {
-			if ( it->intersects(labelRect) ) {
-				foundPlace = false;
-				break;
-			}
-		}
+		if ( grid.intersects(labelRect) )
+			return false;
 	}
 
-	if ( !foundPlace ) return false;
+	grid.insert(labelRect);
+
+	label.rect = labelRect;
+	_labels.append(label);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-	gridY = labelRect.top() / rowHeight;
 
-	gridPrevY = gridY - 1;
-	gridNextY = gridY + 1;
 
-	gridRow = grid[gridY];
-	gridRow.append(labelRect);
-	if ( gridPrevY >= 0 ) grid[gridPrevY].append(labelRect);
-	if ( gridNextY < grid.count() ) grid[gridNextY].append(labelRect);
 
-	if ( capital ) {
-		painter.setPen(SCScheme.colors.map.cityOutlines);
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CitiesLayer::drawLabel(QPainter& painter, QFont &font,
+                            bool &lastUnderline, bool &lastBold,
+                            const Label &label) {
+	painter.setPen(SCScheme.colors.map.cityOutlines);
+	if ( label.capital )
 		painter.setBrush(SCScheme.colors.map.cityCapital);
-	}
-	else {
-		painter.setPen(SCScheme.colors.map.cityOutlines);
+	else
 		painter.setBrush(SCScheme.colors.map.cityNormal);
-	}
-	painter.drawRect(p.x()-symbolSize/2, p.y()-symbolSize/2, symbolSize,
-	                 symbolSize);
+
+	painter.drawRect(label.position.x()-label.symbolSize/2,
+	                 label.position.y()-label.symbolSize/2,
+	                 label.symbolSize, label.symbolSize);
 
 	painter.setPen(SCScheme.colors.map.cityLabels);
 
-	if ( capital != lastUnderline ) {
-		lastUnderline = capital;
-		font.setUnderline(capital);
+	if ( label.capital != lastUnderline ) {
+		lastUnderline = label.capital;
+		font.setUnderline(label.capital);
 		painter.setFont(font);
 	}
 
-	if ( bold != lastBold ) {
-		lastBold = bold;
-		font.setBold(bold);
+	if ( label.bold != lastBold ) {
+		lastBold = label.bold;
+		font.setBold(label.bold);
 		painter.setFont(font);
 	}
 
-	painter.drawText(labelRect, Qt::AlignLeft | Qt::AlignTop |
-	                 Qt::TextSingleLine, city.name().c_str());
-
-	return true;
+	painter.drawText(label.rect, Qt::AlignLeft | Qt::AlignTop |
+	                 Qt::TextSingleLine, label.city->name().c_str());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -245,7 +407,9 @@ bool CitiesLayer::drawCity(QPainter& painter, Grid &grid, QFont &font,
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void CitiesLayer::setSelectedCity(const Math::Geo::CityD* c) {
+	if ( _selectedCity == c ) return;
 	_selectedCity = c;
+	setDirty();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
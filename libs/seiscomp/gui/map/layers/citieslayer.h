@@ -26,6 +26,10 @@
 #include <seiscomp/gui/map/layer.h>
 #include <seiscomp/math/coord.h>
 
+#include <QVector>
+
+#include <vector>
+
 namespace Seiscomp {
 namespace Gui {
 namespace Map {
@@ -41,23 +45,47 @@ class SC_GUI_API CitiesLayer : public Layer {
 		virtual ~CitiesLayer();
 
 		virtual void init(const Config::Config&);
+		virtual void calculateMapPosition(const Canvas*);
 		virtual void draw(const Canvas*, QPainter&);
 
 		void setSelectedCity(const Math::Geo::CityD*);
 		const Math::Geo::CityD* selectedCity() const;
 
 	private:
-		typedef QList<QRect> Row;
-		typedef QVector<Row> Grid;
+		struct Label {
+			const Math::Geo::CityD *city;
+			QPoint                  position;
+			QRect                   rect;
+			int                     symbolSize;
+			bool                    capital;
+			bool                    bold;
+		};
+
+		typedef QVector<Label> Labels;
+		typedef QVector<QVector<int> > Cells;
+
+		class LabelGrid;
 
 	private:
-		bool drawCity(QPainter&, Grid&, QFont&, bool&, bool&,
-		              const Projection*, const Math::Geo::CityD&,
-		              const QFontMetrics&, int, int);
+		void buildIndex(const std::vector<Math::Geo::CityD> &cities);
+		void collectCities(QVector<int> &indexes, const Projection*,
+		                   double minPopulation) const;
+		bool placeCity(LabelGrid&, const Projection*, const Math::Geo::CityD&,
+		               const QFontMetrics&, int, int);
+		void drawLabel(QPainter&, QFont&, bool&, bool&, const Label&);
 
 	private:
 		const Math::Geo::CityD *_selectedCity;
 		int _topPopulatedPlaces;
+
+		// The indexes of the cities of each cell of the index in order
+		// of decreasing population
+		Cells                   _cells;
+		const Math::Geo::CityD *_indexedCities;
+		size_t                  _indexedCityCount;
+
+		// The labels placed for the current view
+		Labels                  _labels;
 };
 
 
@@ -27,6 +27,7 @@
 
 #include <QMenu>
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
 
@@ -189,6 +190,90 @@ QPainter::CompositionMode getCompositionMode(const std::string &name) {
 }
 
 
+// The maximum screen distance in pixels a simplified feature may deviate
+// from its original vertices
+const double SimplificationTolerance = 0.5;
+
+
+/**
+ * Douglas-Peucker simplification of a vertex chain. The first and the last
+ * vertex are always kept as well as all vertices which are farther away from
+ * the simplified chain than tolerance. Closed chains are additionally split
+ * at the vertex farthest from the first one to not collapse them into a
+ * single line.
+ */
+void simplify(vector<Geo::GeoCoordinate> &out, const Geo::GeoCoordinate *v,
+              size_t n, double tolerance, bool closed) {
+	if ( n <= 2 ) {
+		out.insert(out.end(), v, v + n);
+		return;
+	}
+
+	auto distance = [v](size_t a, size_t b, size_t i) {
+		double dx = v[b].lon - v[a].lon, dy = v[b].lat - v[a].lat;
+		double px = v[i].lon - v[a].lon, py = v[i].lat - v[a].lat;
+		double len = dx*dx + dy*dy;
+		if ( len > 0 ) {
+			double t = std::max(0.0, std::min(1.0, (px*dx + py*dy) / len));
+			px -= t*dx; py -= t*dy;
+		}
+		return px*px + py*py;
+	};
+
+	double tolerance2 = tolerance*tolerance;
+	vector<char> keep(n, 0);
+	vector<pair<size_t, size_t>> ranges;
+
+	keep[0] = keep[n-1] = 1;
+
+	if ( closed ) {
+		size_t split = 0;
+		double maxDist = -1;
+		for ( size_t i = 1; i < n-1; ++i ) {
+			double d = distance(0, 0, i);
+			if ( d > maxDist ) {
+				maxDist = d;
+				split = i;
+			}
+		}
+
+		keep[split] = 1;
+		ranges.push_back(make_pair(0, split));
+		ranges.push_back(make_pair(split, n-1));
+	}
+	else {
+		ranges.push_back(make_pair(0, n-1));
+	}
+
+	while ( !ranges.empty() ) {
+		size_t a = ranges.back().first, b = ranges.back().second;
+		ranges.pop_back();
+
+		size_t idx = 0;
+		double maxDist = tolerance2;
+		for ( size_t i = a+1; i < b; ++i ) {
+			double d = distance(a, b, i);
+			if ( d > maxDist ) {
+				maxDist = d;
+				idx = i;
+			}
+		}
+
+		if ( idx ) {
+			keep[idx] = 1;
+			ranges.push_back(make_pair(a, idx));
+			ranges.push_back(make_pair(idx, b));
+		}
+	}
+
+	for ( size_t i = 0; i < n; ++i ) {
+		if ( keep[i] ) {
+			out.push_back(v[i]);
+		}
+	}
+}
+
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -538,6 +623,8 @@ void GeoFeatureLayer::renderFeatures(Canvas *canvas, QPainter &painter) {
 		return;
 	}
 
+	updateCache(canvas);
+
 	// Debug pen and label point
 	QPen debugPen;
 	debugPen.setColor(Qt::black);
@@ -764,7 +851,23 @@ bool GeoFeatureLayer::drawFeature(Canvas *canvas, QPainter *painter,
 	}
 	// Points, polylines and polygons
 	else {
-		canvas->drawFeature(*painter, f, props->filled, props->roughness);
+		const CachedFeature &cached = cachedFeature(canvas, props, f);
+
+		if ( !cached.path.isEmpty() ) {
+			if ( f->closedPolygon() ) {
+				painter->drawPath(cached.path);
+			}
+			else {
+				QBrush backup = painter->brush();
+				painter->setBrush(Qt::NoBrush);
+				painter->drawPath(cached.path);
+				painter->setBrush(backup);
+			}
+		}
+
+		if ( !cached.points.isEmpty() ) {
+			painter->drawPoints(cached.points);
+		}
 
 		// Draw the name if requested and if there is enough space
 		if ( props->drawName ) {
@@ -832,6 +935,141 @@ bool GeoFeatureLayer::drawFeature(Canvas *canvas, QPainter *painter,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GeoFeatureLayer::updateCache(Canvas *canvas) {
+	const Projection *proj = canvas->projection();
+	uint roughness = canvas->polygonRoughness();
+
+	if ( proj != _cacheProjection || proj->pixelPerDegree() != _cachePixelPerDegree ) {
+		// The simplified vertices depend on the scale
+		_cache.clear();
+	}
+	else if ( proj->center() != _cacheCenter || canvas->size() != _cacheSize ||
+	          roughness != _cacheRoughness ) {
+		// Only the screen geometry needs to be recomputed
+		for ( auto &item : _cache ) {
+			item.second.projected = false;
+			item.second.path = QPainterPath();
+			item.second.points.clear();
+		}
+	}
+	else {
+		return;
+	}
+
+	_cacheProjection = proj;
+	_cachePixelPerDegree = proj->pixelPerDegree();
+	_cacheRoughness = roughness;
+	_cacheCenter = proj->center();
+	_cacheSize = canvas->size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const GeoFeatureLayer::CachedFeature &
+GeoFeatureLayer::cachedFeature(Canvas *canvas, const LayerProperties *props,
+                               const Geo::GeoFeature *f) {
+	CachedFeature &entry = _cache[f];
+	if ( entry.projected ) {
+		return entry;
+	}
+
+	Projection *proj = canvas->projection();
+	const auto &vertices = f->vertices();
+	const auto &subFeatures = f->subFeatures();
+	size_t nSubFeat = subFeatures.size();
+	size_t startIdx, endIdx;
+
+	if ( !entry.simplified ) {
+		double tolerance = SimplificationTolerance / proj->pixelPerDegree();
+
+		startIdx = 0;
+		for ( size_t i = 0; i <= nSubFeat; ++i, startIdx = endIdx ) {
+			endIdx = (i == nSubFeat ? vertices.size() : subFeatures[i]);
+			if ( i > 0 ) {
+				entry.subFeatures.push_back(entry.vertices.size());
+			}
+
+			simplify(entry.vertices, &vertices[startIdx], endIdx - startIdx,
+			         tolerance, f->closedPolygon());
+		}
+
+		// Do not keep a copy if nothing has been removed
+		if ( entry.vertices.size() == vertices.size() ) {
+			vector<Geo::GeoCoordinate>().swap(entry.vertices);
+			vector<size_t>().swap(entry.subFeatures);
+		}
+
+		entry.simplified = true;
+	}
+
+	const auto &v = entry.vertices.empty() ? vertices : entry.vertices;
+	const auto &s = entry.vertices.empty() ? subFeatures : entry.subFeatures;
+	nSubFeat = s.size();
+
+	ClipHint clipHint = proj->boundingBox().relation(f->bbox()) == Geo::GeoBoundingBox::Contains
+	                    ? NoClip : DoClip;
+	uint roughness = props->roughness < 0 ? canvas->polygonRoughness() : props->roughness;
+
+	// Filled polygons with holes are combined into a single path
+	bool combine = f->closedPolygon() && props->filled && nSubFeat > 0;
+	bool gotFirstPath = false;
+	bool firstForward = true;
+
+	startIdx = 0;
+	for ( size_t i = 0; i <= nSubFeat; ++i, startIdx = endIdx ) {
+		endIdx = (i == nSubFeat ? v.size() : s[i]);
+		size_t n = endIdx - startIdx;
+		if ( !n ) {
+			continue;
+		}
+
+		const Geo::GeoCoordinate *part = &v[startIdx];
+
+		if ( combine ) {
+			QPainterPath subPath;
+			if ( !proj->project(subPath, n, part, true, roughness, clipHint) ) {
+				continue;
+			}
+
+			bool forward = Geo::area(part, n) > 0;
+			if ( !gotFirstPath ) {
+				entry.path = subPath;
+				firstForward = forward;
+				gotFirstPath = true;
+			}
+			else if ( forward == firstForward ) {
+				entry.path.addPath(subPath);
+			}
+			else {
+				entry.path -= subPath;
+			}
+		}
+		else if ( n == 1 ) {
+			QPoint p;
+			if ( proj->project(p, QPointF(part->lon, part->lat)) ) {
+				entry.points.append(p);
+			}
+		}
+		else {
+			QPainterPath subPath;
+			if ( proj->project(subPath, n, part, f->closedPolygon(), roughness, clipHint) ) {
+				entry.path.addPath(subPath);
+			}
+		}
+	}
+
+	entry.projected = true;
+	return entry;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 QMenu *GeoFeatureLayer::menu(QMenu *parentMenu) const {
 	QMenu *menu = buildMenu(_root, parentMenu);
@@ -856,6 +1094,7 @@ QMenu *GeoFeatureLayer::menu(QMenu *parentMenu) const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void GeoFeatureLayer::geoFeatureSetUpdated() {
 	_initialized = false;
+	_cache.clear();
 
 	if ( _root != nullptr ) {
 		delete _root;
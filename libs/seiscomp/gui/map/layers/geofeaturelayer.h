@@ -30,6 +30,9 @@
 
 
 #include <QImage>
+#include <QPainterPath>
+
+#include <unordered_map>
 
 
 namespace Seiscomp {
@@ -38,6 +41,7 @@ namespace Map {
 
 
 class Canvas;
+class Projection;
 
 
 class SC_GUI_API GeoFeatureLayer : public Layer,
@@ -189,8 +193,37 @@ class SC_GUI_API GeoFeatureLayer : public Layer,
 		                 const QPen *debugPen, const LayerProperties *props,
 		                 const Geo::GeoFeature *f);
 
+		/**
+		 * @brief The cached screen geometry of a feature. The vertices are
+		 *        simplified for the current scale and kept as long as the
+		 *        scale does not change, the path and points are kept as long
+		 *        as the view does not change.
+		 */
+		struct CachedFeature {
+			std::vector<Geo::GeoCoordinate> vertices;
+			std::vector<size_t>             subFeatures;
+			bool                            simplified{false};
+			bool                            projected{false};
+			QPainterPath                    path;
+			QVector<QPoint>                 points;
+		};
+
+		using FeatureCache = std::unordered_map<const Geo::GeoFeature*, CachedFeature>;
+
+		void updateCache(Canvas *canvas);
+		const CachedFeature &cachedFeature(Canvas *canvas,
+		                                   const LayerProperties *props,
+		                                   const Geo::GeoFeature *f);
+
 		bool                       _initialized;
 		CategoryNode              *_root;
+
+		FeatureCache               _cache;
+		const Projection          *_cacheProjection{nullptr};
+		qreal                      _cachePixelPerDegree{0};
+		uint                       _cacheRoughness{0};
+		QPointF                    _cacheCenter;
+		QSize                      _cacheSize;
 };
 
 
@@ -37,6 +37,7 @@ namespace Map {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 GridLayer::GridLayer(QObject* parent) : Layer(parent) {
 	setName("grid");
+	setCachingEnabled(true);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -138,7 +139,9 @@ void GridLayer::draw(const Seiscomp::Gui::Map::Canvas *canvas,
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void GridLayer::setGridDistance(const QPointF &p) {
+	if ( _gridDistance == p ) return;
 	_gridDistance = p;
+	invalidateCache();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -68,7 +68,8 @@ SymbolLayer::~SymbolLayer() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool SymbolLayer::add(Symbol *symbol) {
 	_symbols.push_back(symbol);
-	setDirty();
+	// Only the new symbol needs to be projected, this is done in draw
+	_pendingSymbols.push_back(symbol);
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -85,8 +86,8 @@ SymbolLayer::const_iterator SymbolLayer::remove(Symbol *symbol) {
 			if ( top() == symbol )
 				setTop(nullptr);
 
+			_pendingSymbols.removeOne(symbol);
 			delete *it;
-			setDirty();
 			return _symbols.erase(it);
 		}
 	}
@@ -123,6 +124,7 @@ void SymbolLayer::clear() {
 	foreach ( Symbol *s, _symbols )
 		delete s;
 	_symbols.clear();
+	_pendingSymbols.clear();
 	setDirty();
 	setTop(nullptr);
 }
@@ -226,6 +228,8 @@ void SymbolLayer::setVisible(bool v) {
 void SymbolLayer::calculateMapPosition(const Canvas *canvas) {
 	foreach ( Symbol *s, _symbols )
 		s->calculateMapPosition(canvas);
+
+	_pendingSymbols.clear();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -251,15 +255,28 @@ bool SymbolLayer::isInside(const QMouseEvent *event, const QPointF &geoPos) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SymbolLayer::draw(const Canvas *canvas, QPainter &p) {
-	p.save();
+	foreach ( Symbol *s, _pendingSymbols )
+		s->calculateMapPosition(canvas);
+	_pendingSymbols.clear();
 
-	for ( int i = Seiscomp::Gui::Map::Symbol::NONE; i <= Seiscomp::Gui::Map::Symbol::HIGH; ++i ) {
-		foreach ( Symbol *s, _symbols ) {
-			if ( s->isClipped() || !s->isVisible() || (s->priority() != i) )
-				continue;
+	// Sort the symbols into their priorities with one pass
+	foreach ( Symbol *s, _symbols ) {
+		if ( s->isClipped() || !s->isVisible() )
+			continue;
 
+		int i = s->priority();
+		if ( i < Symbol::NONE || i > Symbol::HIGH )
+			continue;
+
+		_drawBuckets[i].push_back(s);
+	}
+
+	p.save();
+
+	for ( auto &bucket : _drawBuckets ) {
+		for ( Symbol *s : bucket )
 			s->draw(canvas, p);
-		}
+		bucket.clear();
 	}
 
 	Symbol *tmp = top();
@@ -26,6 +26,8 @@
 #include <seiscomp/gui/map/mapsymbol.h>
 #include <QList>
 
+#include <vector>
+
 
 namespace Seiscomp {
 namespace Gui {
@@ -95,8 +97,11 @@ class SC_GUI_API SymbolLayer : public Layer {
 
 
 	private:
-		Symbols  _symbols;
-		Symbol  *_topSymbol;
+		Symbols              _symbols;
+		//! Symbols added since the last projection of all symbols
+		Symbols              _pendingSymbols;
+		Symbol              *_topSymbol;
+		std::vector<Symbol*> _drawBuckets[Symbol::HIGH+1];
 };
 
 
@@ -18,7 +18,11 @@
  ***************************************************************************/
 
 
+#include <QAtomicInt>
 #include <QPainter>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <iostream>
 
 #include <seiscomp/math/geo.h>
@@ -28,6 +32,47 @@
 
 IMPLEMENT_INTERFACE_FACTORY(Seiscomp::Gui::Map::Projection, SC_GUI_API);
 
+
+namespace {
+
+
+// Do not split images with less pixels than this
+const int MinPixelsPerBand = 65536;
+
+
+Q_GLOBAL_STATIC(QThreadPool, rowPool)
+
+
+class RowBandProcessor : public QRunnable {
+	public:
+		RowBandProcessor(const std::function<void (int, int)> &func,
+		                 int fromRow, int toRow, int rowsPerBand,
+		                 QAtomicInt &next, QSemaphore *done)
+		: _func(func), _fromRow(fromRow), _toRow(toRow)
+		, _rowsPerBand(rowsPerBand), _next(next), _done(done) {}
+
+		void run() override {
+			int band;
+			while ( (band = _next.fetchAndAddRelaxed(1)) * _rowsPerBand < _toRow - _fromRow ) {
+				int from = _fromRow + band * _rowsPerBand;
+				_func(from, std::min(from + _rowsPerBand, _toRow));
+			}
+
+			if ( _done ) _done->release();
+		}
+
+	private:
+		const std::function<void (int, int)> &_func;
+		int                                   _fromRow;
+		int                                   _toRow;
+		int                                   _rowsPerBand;
+		QAtomicInt                           &_next;
+		QSemaphore                           *_done;
+};
+
+
+}
+
 namespace Seiscomp {
 namespace Gui {
 namespace Map {
@@ -456,7 +501,10 @@ void Projection::setSize(int width, int height) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Projection::draw(QImage &img, bool filter, TextureCache *cache) {
-	if ( cache ) cache->beginPaint();
+	if ( cache ) {
+		cache->beginPaint();
+		cache->setViewCenter(center());
+	}
 
 	setSize(img.width(), img.height());
 
@@ -598,6 +646,40 @@ bool Projection::project(QPainterPath &screenPath, size_t n,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Projection::processRows(int fromRow, int toRow, int pixelsPerRow,
+                             const std::function<void (int, int)> &func) const {
+	int rows = toRow - fromRow;
+	if ( rows <= 0 ) return;
+
+	QThreadPool *pool = rowPool();
+	qint64 pixels = qint64(rows) * pixelsPerRow;
+	int workers = std::min(pool->maxThreadCount(),
+	                       static_cast<int>(pixels / MinPixelsPerBand) - 1);
+
+	if ( workers <= 0 || rows < 2 ) {
+		func(fromRow, toRow);
+		return;
+	}
+
+	// Use more bands than threads to compensate unevenly expensive rows
+	int bands = std::min(rows, (workers + 1) * 4);
+	int rowsPerBand = (rows + bands - 1) / bands;
+
+	QAtomicInt next(0);
+	QSemaphore done;
+
+	for ( int i = 0; i < workers; ++i )
+		pool->start(new RowBandProcessor(func, fromRow, toRow, rowsPerBand, next, &done));
+
+	RowBandProcessor(func, fromRow, toRow, rowsPerBand, next, nullptr).run();
+	done.acquire(workers);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Projection::setGridLines(qreal numLines) {
 	_gridLines = numLines < 1.0 ? 1.0 : numLines;
@@ -30,6 +30,8 @@
 #include <QPainterPath>
 #include <QImage>
 
+#include <functional>
+
 
 namespace Seiscomp {
 namespace Gui {
@@ -187,6 +189,20 @@ class SC_GUI_API Projection {
 		void setSize(int width, int height);
 		void setVisibleRadius(qreal r);
 
+		/**
+		 * @brief Calls func with consecutive bands [from,to) of the given
+		 *        row range on a thread pool. The calling thread takes part
+		 *        and the function returns when all rows have been processed.
+		 *        Small images are processed in the calling thread only.
+		 * @param fromRow The first row
+		 * @param toRow The row after the last row
+		 * @param pixelsPerRow The number of pixels in each row
+		 * @param func The function to process a band of rows. It is called
+		 *             concurrently and must only write to its own rows.
+		 */
+		void processRows(int fromRow, int toRow, int pixelsPerRow,
+		                 const std::function<void (int, int)> &func) const;
+
 		virtual void render(QImage &img, bool highQuality, TextureCache *cache) = 0;
 
 
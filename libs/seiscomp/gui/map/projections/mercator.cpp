@@ -24,6 +24,7 @@
 
 #include <math.h>
 #include <iostream>
+#include <vector>
 
 #define deg2rad(d) (M_PI*(d)/180.0)
 #define rad2deg(d) (180.0*(d)/M_PI)
@@ -129,19 +130,42 @@ void drawLowQualityImage(MercatorProjectionProxy *proj, QImage &buffer, const QR
 	ratioX.parts.lo = 0;
 	ratioX.value /= scaledWidth;
 
-	while ( true ) {
-		int width = image.width();
-		int height = image.height();
+	int width = image.width();
+	int height = image.height();
+
+	if ( y0 < 0 )
+		y0 = 0;
+
+	if ( y1 >= proj->_height )
+		y1 = proj->_height-1;
+
+	// The source line of each target row. It does not depend on x and is
+	// shared by both parts of a wrapped image.
+	std::vector<int> sourceRows(y1-y0+1);
+	for ( int i = y0; i <= y1; ++i ) {
+		qreal lat0 = proj->_halfHeight - i;
+		lat0 = lat0 / (qreal)proj->_scale + proj->_centerY;
+		lat0 = atan(sinh(lat0*M_PI))*oo2Pi*90.0;
 
+		qreal y_ = 1.0 - (lat0 - minLat) / rangeLat;
+		if ( y_ < 0 ) y_ = 0;
+		else if ( y_ > 1 ) y_ = 1;
+
+		int y_ofs = (int)(y_*height);
+		if ( y_ofs >= height ) y_ofs = height-1;
+		sourceRows[i-y0] = y_ofs;
+	}
+
+	const QRgb *image_data = (const QRgb*)image.bits();
+	QRgb *targetData = (QRgb*)buffer.bits();
+	int targetWidth = buffer.width();
+
+	while ( true ) {
 		Coord xofs;
 
 		int x0c = x0,
-		    y0c = y0,
 		    x1c = x1;
 
-		QRgb *targetData = (QRgb*)buffer.bits();
-		int targetWidth = buffer.width();
-
 		if ( x0c < 0 ) {
 			xofs.value = ratioX.value * -x0c;
 			x0c = 0;
@@ -149,48 +173,26 @@ void drawLowQualityImage(MercatorProjectionProxy *proj, QImage &buffer, const QR
 		else
 			xofs.value = 0;
 
-		if ( y0c < 0 )
-			y0c = 0;
-
 		if ( x1c >= proj->_width )
 			x1c = proj->_width-1;
 
-		if ( y1 >= proj->_height )
-			y1 = proj->_height-1;
-
-		targetData += targetWidth * y0c + x0c;
-
-		const QRgb *image_data = (const QRgb*)image.bits();
-		const QRgb *data;
-
-		for ( int i = y0c; i <= y1; ++i ) {
-			QRgb *targetPixel = targetData;
+		proj->processRows(y0, y1+1, x1c-x0c+1, [&](int fromRow, int toRow) {
+			for ( int i = fromRow; i < toRow; ++i ) {
+				QRgb *targetPixel = targetData + targetWidth * i + x0c;
+				const QRgb *data = image_data + width*sourceRows[i-y0];
 
-			Coord x;
-			x.value = xofs.value;
+				Coord x;
+				x.value = xofs.value;
 
-			qreal lat0 = proj->_halfHeight - i;
-			lat0 = lat0 / (qreal)proj->_scale + proj->_centerY;
-			lat0 = atan(sinh(lat0*M_PI))*oo2Pi*90.0;
+				for ( int j = x0c; j <= x1c; ++j ) {
+					QRgb c = data[x.parts.hi];
+					COMPOSITOR::combine(*targetPixel, c);
+					++targetPixel;
 
-			qreal y_ = 1.0 - (lat0 - minLat) / rangeLat;
-			if ( y_ < 0 ) y_ = 0;
-			else if ( y_ > 1 ) y_ = 1;
-
-			int y_ofs = (int)(y_*height);
-			if ( y_ofs >= height ) y_ofs = height-1;
-			data = image_data + width*y_ofs;
-
-			for ( int j = x0c; j <= x1c; ++j ) {
-				QRgb c = data[x.parts.hi];
-				COMPOSITOR::combine(*targetPixel, c);
-				++targetPixel;
-
-				x.value += ratioX.value;
+					x.value += ratioX.value;
+				}
 			}
-
-			targetData += targetWidth;
-		}
+		});
 
 		if ( drawTwoParts ) {
 			x0 += proj->_mapWidth/2;
@@ -274,16 +276,48 @@ void drawHighQualityImage(MercatorProjectionProxy *proj, QImage &buffer, const Q
 	maxYOffs.parts.lo = 0;
 	maxYOffs.parts.hi = height-1;
 
+	if ( y0 < 0 )
+		y0 = 0;
+
+	if ( y1 >= proj->_height )
+		y1 = proj->_height-1;
+
+	// The source coordinate of each target row. It does not depend on x
+	// and is shared by both parts of a wrapped image.
+	std::vector<Coord> sourceRows(y1-y0+1);
+	for ( int i = y0; i <= y1; ++i ) {
+		Coord y;
+
+		qreal lat0 = proj->_halfHeight - i;
+		lat0 = lat0 / (qreal)proj->_scale + proj->_centerY;
+		lat0 = atan(sinh(lat0*M_PI))*oo2Pi*90.0;
+		qreal y_ = 1.0 - ((lat0 - minLat) / rangeLat);
+		if ( y_ < 0 ) y_ = 0;
+		else if ( y_ > 1 ) y_ = 1;
+
+		y.parts.hi = height;
+		y.parts.lo = 0;
+		y.value *= y_;
+		if ( y.value > Coord::fraction_half_max )
+			y.value -= Coord::fraction_half_max;
+		else
+			y.value = 0;
+
+		if ( y.value >= maxYOffs.value ) y = maxYOffs;
+
+		sourceRows[i-y0] = y;
+	}
+
+	const QRgb *image_data = (const QRgb*)image.bits();
+	QRgb *targetData = (QRgb*)buffer.bits();
+	int targetWidth = buffer.width();
+
 	while ( true ) {
 		Coord xofs;
 
 		int x0c = x0,
-		    y0c = y0,
 		    x1c = x1;
 
-		QRgb *targetData = (QRgb*)buffer.bits();
-		int targetWidth = buffer.width();
-
 		if ( x0c < 0 ) {
 			xofs.value = ratioX.value * -x0c;
 			x0c = 0;
@@ -291,56 +325,30 @@ void drawHighQualityImage(MercatorProjectionProxy *proj, QImage &buffer, const Q
 		else
 			xofs.value = 0;
 
-		if ( y0c < 0 )
-			y0c = 0;
-
 		if ( x1c >= proj->_width )
 			x1c = proj->_width-1;
 
-		if ( y1 >= proj->_height )
-			y1 = proj->_height-1;
-
-		targetData += targetWidth * y0c + x0c;
+		proj->processRows(y0, y1+1, x1c-x0c+1, [&](int fromRow, int toRow) {
+			for ( int i = fromRow; i < toRow; ++i ) {
+				QRgb *targetPixel = targetData + targetWidth * i + x0c;
+				const Coord &y = sourceRows[i-y0];
 
-		const QRgb *image_data = (const QRgb*)image.bits();
+				Coord x;
+				x.value = xofs.value;
 
-		for ( int i = y0c; i <= y1; ++i ) {
-			QRgb *targetPixel = targetData;
+				for ( int j = x0c; j <= x1c; ++j ) {
+					QRgb c;
+					if ( x.value > Coord::fraction_half_max )
+						getTexelBilinear(c, image_data, width, height, x.value - Coord::fraction_half_max, y);
+					else
+						getTexelBilinear(c, image_data, width, height, 0, y);
+					COMPOSITOR::combine(*targetPixel, c);
+					++targetPixel;
 
-			Coord x, y;
-			x.value = xofs.value;
-
-			qreal lat0 = proj->_halfHeight - i;
-			lat0 = lat0 / (qreal)proj->_scale + proj->_centerY;
-			lat0 = atan(sinh(lat0*M_PI))*oo2Pi*90.0;
-			qreal y_ = 1.0 - ((lat0 - minLat) / rangeLat);
-			if ( y_ < 0 ) y_ = 0;
-			else if ( y_ > 1 ) y_ = 1;
-
-			y.parts.hi = height;
-			y.parts.lo = 0;
-			y.value *= y_;
-			if ( y.value > Coord::fraction_half_max )
-				y.value -= Coord::fraction_half_max;
-			else
-				y.value = 0;
-
-			if ( y.value >= maxYOffs.value ) y = maxYOffs;
-
-			for ( int j = x0c; j <= x1c; ++j ) {
-				QRgb c;
-				if ( x.value > Coord::fraction_half_max )
-					getTexelBilinear(c, image_data, width, height, x.value - Coord::fraction_half_max, y);
-				else
-					getTexelBilinear(c, image_data, width, height, 0, y);
-				COMPOSITOR::combine(*targetPixel, c);
-				++targetPixel;
-
-				x.value += ratioX.value;
+					x.value += ratioX.value;
+				}
 			}
-
-			targetData += targetWidth;
-		}
+		});
 
 		if ( drawTwoParts ) {
 			x0 += proj->_mapWidth/2;
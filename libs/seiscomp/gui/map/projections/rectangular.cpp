@@ -165,21 +165,37 @@ void drawLowQualityImage(RectangularProjectionProxy *proj, QImage &buffer, const
 	ratioX.value /= scaledWidth;
 	ratioY.value /= scaledHeight;
 
-	while ( true ) {
-		int width = image.width();
-		int height = image.height();
+	int width = image.width();
+	int height = image.height();
 
-		Coord xofs, yofs;
+	// Something has to be painted
+	const QRgb *image_data = (const QRgb*)image.bits();
+	QRgb *targetData = (QRgb*)buffer.bits();
+	int targetWidth = buffer.width();
 
-		int x0c = x0,
-		    y0c = y0,
-		    x1c = x1;
+	Coord yofs;
+
+	if ( y0 < 0 ) {
+		yofs.value = ratioY.value * -y0;
+		height -= yofs.parts.hi;
+		image_data += width * yofs.parts.hi;
+		y0 = 0;
+	}
+	else
+		yofs.value = 0;
 
-		// Something has to be painted
-		const QRgb *data = (const QRgb*)image.bits();
+	if ( y1 >= proj->_height )
+		y1 = proj->_height-1;
 
-		QRgb *targetData = (QRgb*)buffer.bits();
-		int targetWidth = buffer.width();
+	// The source line of each row is computed from the row index and not
+	// accumulated to be able to split the rows into independent bands
+	Coord::value_type y00 = yofs.parts.lo;
+
+	while ( true ) {
+		Coord xofs;
+
+		int x0c = x0,
+		    x1c = x1;
 
 		if ( x0c < 0 ) {
 			xofs.value = ratioX.value * -x0c;
@@ -191,47 +207,25 @@ void drawLowQualityImage(RectangularProjectionProxy *proj, QImage &buffer, const
 		if ( x1c >= proj->_width )
 			x1c = proj->_width-1;
 
-		if ( y0c < 0 ) {
-			yofs.value = ratioY.value * -y0c;
-			height -= yofs.parts.hi;
-			data += image.width() * yofs.parts.hi;
-			y0c = 0;
-		}
-		else
-			yofs.value = 0;
-
-		if ( y1 >= proj->_height )
-			y1 = proj->_height-1;
-
-		targetData += targetWidth * y0c + x0c;
-
-		Coord y;
-		y.parts.hi = 0;
-		y.parts.lo = yofs.parts.lo;
-
-		for ( int i = y0c; i <= y1; ++i ) {
-			QRgb *targetPixel = targetData;
-
-			Coord x;
-			x.value = xofs.value;
+		proj->processRows(y0, y1+1, x1c-x0c+1, [&](int fromRow, int toRow) {
+			for ( int i = fromRow; i < toRow; ++i ) {
+				QRgb *targetPixel = targetData + targetWidth * i + x0c;
 
-			for ( int j = x0c; j <= x1c; ++j ) {
-				COMPOSITOR::combine(*targetPixel, data[x.parts.hi]);
-				++targetPixel;
+				Coord y;
+				y.value = y00 + ratioY.value * (i-y0);
+				const QRgb *data = image_data + width * y.parts.hi;
 
-				x.value += ratioX.value;
-			}
+				Coord x;
+				x.value = xofs.value;
 
-			targetData += targetWidth;
+				for ( int j = x0c; j <= x1c; ++j ) {
+					COMPOSITOR::combine(*targetPixel, data[x.parts.hi]);
+					++targetPixel;
 
-			y.value += ratioY.value;
-			int skipLines = y.parts.hi;
-			while ( skipLines ) {
-				data += width;
-				--skipLines;
+					x.value += ratioX.value;
+				}
 			}
-			y.parts.hi = 0;
-		}
+		});
 
 		if ( drawTwoParts ) {
 			x0 += proj->_mapWidth;
@@ -311,21 +305,41 @@ void drawHighQualityImage(RectangularProjectionProxy *proj, QImage &buffer, cons
 	ratioX.value /= scaledWidth;
 	ratioY.value /= scaledHeight;
 
-	while ( true ) {
-		int width = image.width();
-		int height = image.height();
+	int width = image.width();
+	int height = image.height();
 
-		Coord xofs, yofs;
+	// Something has to be painted
+	const QRgb *image_data = (const QRgb*)image.bits();
+	QRgb *targetData = (QRgb*)buffer.bits();
+	int targetWidth = buffer.width();
 
-		int x0c = x0,
-		    y0c = y0,
-		    x1c = x1;
+	Coord yofs;
 
-		// Something has to be painted
-		const QRgb *data = (const QRgb*)image.bits();
+	if ( y0 < 0 ) {
+		yofs.value = ratioY.value * -y0;
+		height -= yofs.parts.hi;
+		image_data += width * yofs.parts.hi;
+		y0 = 0;
+	}
+	else
+		yofs.value = 0;
+
+	if ( y1 >= proj->_height )
+		y1 = proj->_height-1;
+
+	// The source line of each row is computed from the row index and not
+	// accumulated to be able to split the rows into independent bands
+	Coord::value_type y00 = yofs.parts.lo;
+	if ( y00 > Coord::fraction_half_max )
+		y00 -= Coord::fraction_half_max;
+	else
+		y00 = 0;
+
+	while ( true ) {
+		Coord xofs;
 
-		QRgb *targetData = (QRgb*)buffer.bits();
-		int targetWidth = buffer.width();
+		int x0c = x0,
+		    x1c = x1;
 
 		if ( x0c < 0 ) {
 			xofs.value = ratioX.value * -x0c;
@@ -337,57 +351,32 @@ void drawHighQualityImage(RectangularProjectionProxy *proj, QImage &buffer, cons
 		if ( x1c >= proj->_width )
 			x1c = proj->_width-1;
 
-		if ( y0c < 0 ) {
-			yofs.value = ratioY.value * -y0c;
-			height -= yofs.parts.hi;
-			data += image.width() * yofs.parts.hi;
-			y0c = 0;
-		}
-		else
-			yofs.value = 0;
-
-		if ( y1 >= proj->_height )
-			y1 = proj->_height-1;
-
-		targetData += targetWidth * y0c + x0c;
-
-		Coord y;
-		y.parts.hi = 0;
-		y.parts.lo = yofs.parts.lo;
-		if ( y.value > Coord::fraction_half_max )
-			y.value -= Coord::fraction_half_max;
-		else
-			y.value = 0;
-
-		for ( int i = y0c; i <= y1; ++i ) {
-			QRgb *targetPixel = targetData;
-
-			Coord x;
-			x.value = xofs.value;
-
-			for ( int j = x0c; j <= x1c; ++j ) {
-				QRgb c;
-				if ( x.value > Coord::fraction_half_max )
-					getTexelBilinear(c, data, width, height, x.value - Coord::fraction_half_max, y);
-				else
-					getTexelBilinear(c, data, width, height, 0, y);
-				COMPOSITOR::combine(*targetPixel, c);
-				++targetPixel;
-
-				x.value += ratioX.value;
-			}
-
-			targetData += targetWidth;
-
-			y.value += ratioY.value;
-			int skipLines = y.parts.hi;
-			height -= skipLines;
-			while ( skipLines ) {
-				data += width;
-				--skipLines;
+		proj->processRows(y0, y1+1, x1c-x0c+1, [&](int fromRow, int toRow) {
+			for ( int i = fromRow; i < toRow; ++i ) {
+				QRgb *targetPixel = targetData + targetWidth * i + x0c;
+
+				Coord y;
+				y.value = y00 + ratioY.value * (i-y0);
+				const QRgb *data = image_data + width * y.parts.hi;
+				int lines = height - y.parts.hi;
+				y.parts.hi = 0;
+
+				Coord x;
+				x.value = xofs.value;
+
+				for ( int j = x0c; j <= x1c; ++j ) {
+					QRgb c;
+					if ( x.value > Coord::fraction_half_max )
+						getTexelBilinear(c, data, width, lines, x.value - Coord::fraction_half_max, y);
+					else
+						getTexelBilinear(c, data, width, lines, 0, y);
+					COMPOSITOR::combine(*targetPixel, c);
+					++targetPixel;
+
+					x.value += ratioX.value;
+				}
 			}
-			y.parts.hi = 0;
-		}
+		});
 
 		if ( drawTwoParts ) {
 			x0 += proj->_mapWidth;
@@ -22,6 +22,7 @@
 #include <QHash>
 #include <QMutex>
 
+#include <cmath>
 #include <iostream>
 
 #include <seiscomp/gui/map/texturecache.h>
@@ -164,6 +165,31 @@ void TextureCache::beginPaint() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TextureCache::setViewCenter(const QPointF &geoCoords) {
+	if ( !_tileStore ) {
+		return;
+	}
+
+	double x = (geoCoords.x() + 180.0) / 360.0;
+	x -= floor(x);
+
+	double y;
+	if ( _isMercatorProjected ) {
+		double lat = std::max(-85.05113, std::min(85.05113, geoCoords.y())) * M_PI / 180.0;
+		y = (1.0 - log(tan(lat) + 1.0 / cos(lat)) / M_PI) * 0.5;
+	}
+	else {
+		y = (90.0 - geoCoords.y()) / 180.0;
+	}
+
+	_tileStore->setViewCenter(QPointF(x, y));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void TextureCache::setCacheLimit(int limit) {
 	_textureCacheLimit = limit;
@@ -92,6 +92,10 @@ class SC_GUI_API TextureCache : public Core::BaseObject {
 
 		void beginPaint();
 
+		//! Passes the view center in geographic coordinates to the
+		//! tile store to prioritize asynchronous requests
+		void setViewCenter(const QPointF &geoCoords);
+
 		void setCacheLimit(int limit);
 		void setCurrentTime(const Core::Time &t);
 
@@ -25,6 +25,7 @@
 #include <seiscomp/core/exceptions.h>
 
 #include <iostream>
+#include <algorithm>
 #include <fstream>
 #include <string.h>
 
@@ -173,6 +174,22 @@ bool BinaryArchive::open(std::streambuf* buf) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BinaryArchive::open(const char *data, size_t size) {
+	close();
+
+	_memoryBuffer.set(data, size);
+	_buf = &_memoryBuffer;
+	_memory = true;
+	_deleteOnClose = false;
+
+	return Seiscomp::Core::Archive::open(nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool BinaryArchive::create(const char* file) {
 	close();
@@ -214,15 +231,57 @@ bool BinaryArchive::create(std::streambuf* buf) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BinaryArchive::create(std::string &buffer) {
+	close();
+
+	// The stream buffer is only set to pass the validity checks, all
+	// output is appended to the target buffer in writeBytes
+	_memoryBuffer.set(nullptr, 0);
+	_buf = &_memoryBuffer;
+	_output = &buffer;
+	_outputSize = buffer.size();
+	_deleteOnClose = false;
+
+	return Seiscomp::Core::Archive::create(nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BinaryArchive::close() {
 	if ( _deleteOnClose && _buf )
 		delete _buf;
 
 	_classes.clear();
+	_checkedTargets.clear();
 	_sequenceSize = -1;
 
+	if ( _output ) {
+		_output->resize(_outputSize);
+	}
+
 	_buf = nullptr;
+	_memory = false;
+	_output = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline int BinaryArchive::readBytes(void* buf, int size) {
+	if ( _memory ) {
+		int n = std::min(size, _memoryBuffer.available());
+		if ( n > 0 )
+			memcpy(buf, _memoryBuffer.take(n), n);
+		return n;
+	}
+
+	return _buf ? _buf->sgetn((char*)buf, size) : 0;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -232,7 +291,7 @@ void BinaryArchive::close() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 void BinaryArchive::readInt(T& value) {
-	int size = _buf?_buf->sgetn((char*)&value, sizeof(T)):0;
+	int size = readBytes((char*)&value, sizeof(T));
 	if ( size != sizeof(T) ) {
 		SEISCOMP_ERROR("read(int): expected %d bytes from stream, got %d", (int)sizeof(T), size);
 		setValidity(false);
@@ -281,7 +340,7 @@ void BinaryArchive::read(int64_t& value) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BinaryArchive::read(float& value) {
-	int size = _buf?_buf->sgetn((char*)&value, sizeof(float)):0;
+	int size = readBytes((char*)&value, sizeof(float));
 	if ( size != sizeof(float) ) {
 		SEISCOMP_ERROR("read(float): expected %d bytes from stream, got %d", (int)sizeof(float), size);
 		setValidity(false);
@@ -294,7 +353,7 @@ void BinaryArchive::read(float& value) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BinaryArchive::read(double& value) {
-	int size = _buf?_buf->sgetn((char*)&value, sizeof(double)):0;
+	int size = readBytes((char*)&value, sizeof(double));
 	if ( size != sizeof(double) ) {
 		SEISCOMP_ERROR("read(double): expected %d bytes from stream, got %d", (int)sizeof(double), size);
 		setValidity(false);
@@ -313,7 +372,7 @@ void BinaryArchive::read(std::vector<char>& value) {
 	}
 
 	int vsize;
-	int size = _buf->sgetn((char*)&vsize, sizeof(int));
+	int size = readBytes((char*)&vsize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(array.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -322,7 +381,7 @@ void BinaryArchive::read(std::vector<char>& value) {
 
 	value.resize(vsize);
 	vsize = vsize * sizeof(char);
-	size = _buf->sgetn((char*)&value[0], vsize);
+	size = readBytes((char*)&value[0], vsize);
 	if ( size != vsize ) {
 		SEISCOMP_ERROR("read(char*): expected %d bytes from stream, got %d", vsize, size);
 		setValidity(false);
@@ -342,7 +401,7 @@ void BinaryArchive::readIntVector(std::vector<T>& value) {
 	}
 
 	int vsize;
-	int size = _buf->sgetn((char*)&vsize, sizeof(int));
+	int size = readBytes((char*)&vsize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(array.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -351,7 +410,7 @@ void BinaryArchive::readIntVector(std::vector<T>& value) {
 
 	value.resize(vsize);
 	vsize = vsize * sizeof(int);
-	size = _buf->sgetn((char*)&value[0], vsize);
+	size = readBytes((char*)&value[0], vsize);
 	if ( size != vsize ) {
 		SEISCOMP_ERROR("read(int*): expected %d bytes from stream, got %d", vsize, size);
 		setValidity(false);
@@ -406,7 +465,7 @@ void BinaryArchive::read(std::vector<float>& value) {
 	}
 
 	int vsize;
-	int size = _buf->sgetn((char*)&vsize, sizeof(int));
+	int size = readBytes((char*)&vsize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(array.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -415,7 +474,7 @@ void BinaryArchive::read(std::vector<float>& value) {
 
 	value.resize(vsize);
 	vsize = vsize * sizeof(float);
-	size = _buf->sgetn((char*)&value[0], vsize);
+	size = readBytes((char*)&value[0], vsize);
 	if ( size != vsize ) {
 		SEISCOMP_ERROR("read(float*): expected %d bytes from stream, got %d", vsize, size);
 		setValidity(false);
@@ -434,7 +493,7 @@ void BinaryArchive::read(std::vector<double>& value) {
 	}
 
 	int vsize;
-	int size = _buf->sgetn((char*)&vsize, sizeof(int));
+	int size = readBytes((char*)&vsize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(array.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -443,7 +502,7 @@ void BinaryArchive::read(std::vector<double>& value) {
 
 	value.resize(vsize);
 	vsize = vsize * sizeof(double);
-	size = _buf->sgetn((char*)&value[0], vsize);
+	size = readBytes((char*)&value[0], vsize);
 	if ( size != vsize ) {
 		SEISCOMP_ERROR("read(double*): expected %d bytes from stream, got %d", vsize, size);
 		setValidity(false);
@@ -462,7 +521,7 @@ void BinaryArchive::read(std::vector<std::string>& value) {
 	}
 
 	int vsize;
-	int size = _buf->sgetn((char*)&vsize, sizeof(int));
+	int size = readBytes((char*)&vsize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(array.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -488,7 +547,7 @@ void BinaryArchive::read(std::vector<Core::Time>& value) {
 	}
 
 	int vsize;
-	int size = _buf->sgetn((char*)&vsize, sizeof(int));
+	int size = readBytes((char*)&vsize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(array.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -508,7 +567,7 @@ void BinaryArchive::read(std::vector<Core::Time>& value) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BinaryArchive::read(std::complex<float>& value) {
-	int size = _buf?_buf->sgetn((char*)&value, sizeof(std::complex<float>)):0;
+	int size = readBytes((char*)&value, sizeof(std::complex<float>));
 	if ( size != sizeof(std::complex<float>) ) {
 		SEISCOMP_ERROR("read(complex<float>): expected %d bytes from stream, got %d", (int)sizeof(std::complex<float>), size);
 		setValidity(false);
@@ -521,7 +580,7 @@ void BinaryArchive::read(std::complex<float>& value) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BinaryArchive::read(std::complex<double>& value) {
-	int size = _buf?_buf->sgetn((char*)&value, sizeof(std::complex<double>)):0;
+	int size = readBytes((char*)&value, sizeof(std::complex<double>));
 	if ( size != sizeof(std::complex<double>) ) {
 		SEISCOMP_ERROR("read(complex<double>): expected %d bytes from stream, got %d", (int)sizeof(std::complex<double>), size);
 		setValidity(false);
@@ -535,7 +594,7 @@ void BinaryArchive::read(std::complex<double>& value) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BinaryArchive::read(bool& value) {
 	char tmp;
-	int size = _buf?_buf->sgetn(&tmp, sizeof(char)):0;
+	int size = readBytes(&tmp, sizeof(char));
 	if ( size != sizeof(char) ) {
 		SEISCOMP_ERROR("read(bool): expected %d bytes from stream, got %d", (int)sizeof(char), size);
 		setValidity(false);
@@ -556,7 +615,7 @@ void BinaryArchive::read(std::vector<std::complex<double> >& value) {
 	}
 
 	int vsize;
-	int size = _buf->sgetn((char*)&vsize, sizeof(int));
+	int size = readBytes((char*)&vsize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(array.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -565,7 +624,7 @@ void BinaryArchive::read(std::vector<std::complex<double> >& value) {
 
 	value.resize(vsize);
 	vsize = vsize * sizeof(std::complex<double>);
-	size = _buf->sgetn((char*)&value[0], vsize);
+	size = readBytes((char*)&value[0], vsize);
 
 	if ( size != vsize ) {
 		SEISCOMP_ERROR("read(complex<double>*): expected %d bytes from stream, got %d", vsize, size);
@@ -585,7 +644,7 @@ void BinaryArchive::read(std::string& value) {
 	}
 
 	int ssize;
-	int size = _buf->sgetn((char*)&ssize, sizeof(int));
+	int size = readBytes((char*)&ssize, sizeof(int));
 	if ( size != sizeof(int) ) {
 		SEISCOMP_ERROR("read(string.len): expected %d bytes from stream, got %d", (int)sizeof(int), size);
 		setValidity(false);
@@ -594,10 +653,23 @@ void BinaryArchive::read(std::string& value) {
 
 	if ( !ssize )
 		value.clear();
+	else if ( _memory ) {
+		// Assign directly from memory and avoid the initialization of
+		// the resized string
+		const char *data = ssize > 0 ? _memoryBuffer.take(ssize) : nullptr;
+		if ( !data ) {
+			SEISCOMP_ERROR("read(string): expected %d bytes from stream, got %d",
+			               ssize, _memoryBuffer.available());
+			setValidity(false);
+			return;
+		}
+
+		value.assign(data, ssize);
+	}
 	else {
 		value.resize(ssize);
 		ssize = ssize * sizeof(std::string::value_type);
-		size = _buf->sgetn((char*)&value[0], ssize);
+		size = readBytes((char*)&value[0], ssize);
 		if ( size != ssize ) {
 			SEISCOMP_ERROR("read(string): expected %d bytes from stream, got %d", ssize, size);
 			setValidity(false);
@@ -612,8 +684,8 @@ void BinaryArchive::read(std::string& value) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BinaryArchive::read(Seiscomp::Core::Time& value) {
 	dateint tmpSeconds, tmpUSeconds;
-	int size = _buf?_buf->sgetn((char*)&tmpSeconds, sizeof(tmpSeconds)):0;
-	size += _buf?_buf->sgetn((char*)&tmpUSeconds, sizeof(tmpUSeconds)):0;
+	int size = readBytes((char*)&tmpSeconds, sizeof(tmpSeconds));
+	size += readBytes((char*)&tmpUSeconds, sizeof(tmpUSeconds));
 	if ( size != sizeof(tmpSeconds) + sizeof(tmpUSeconds) ) {
 		SEISCOMP_ERROR("read(datetime): expected %d bytes from stream, got %d", int(sizeof(tmpSeconds) + sizeof(tmpUSeconds)), size);
 		setValidity(false);
@@ -627,6 +699,15 @@ void BinaryArchive::read(Seiscomp::Core::Time& value) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 inline int BinaryArchive::writeBytes(const void* buf, int size) {
+	if ( _output ) {
+		// Grow the target geometrically and trim it in close()
+		if ( _outputSize + size > _output->size() )
+			_output->resize(std::max(_output->size() * 2, _outputSize + size + 256));
+		memcpy(&(*_output)[_outputSize], buf, size);
+		_outputSize += size;
+		return size;
+	}
+
 	return _buf->sputn((const char*)buf, size);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -893,7 +974,9 @@ bool BinaryArchive::locateObjectByName(const char* name,
 			if ( class_id == -1 ) {
 				read(_classname);
 				//std::cout << "read raw classname " << _classname << std::endl;
+				class_id = static_cast<int>(_classes.size());
 				_classes.push_back(_classname);
+				_checkedTargets.push_back(nullptr);
 			}
 			else {
 				if ( class_id >= 0 && class_id < (int)_classes.size() )
@@ -902,10 +985,16 @@ bool BinaryArchive::locateObjectByName(const char* name,
 					throw Seiscomp::Core::StreamException("unknown class id");
 			}
 
-			if ( !Seiscomp::Core::ClassFactory::IsTypeOf(targetClass, _classname.c_str()) ) {
-				throw Seiscomp::Core::StreamException(std::string("expected exact or derived from ")
-				                                      + targetClass + ", found " + _classname);
-				return false;
+			// The type check requires two class factory lookups and is
+			// only done again if the class is read for another target
+			if ( _checkedTargets[class_id] != targetClass ) {
+				if ( !Seiscomp::Core::ClassFactory::IsTypeOf(targetClass, _classname.c_str()) ) {
+					throw Seiscomp::Core::StreamException(std::string("expected exact or derived from ")
+					                                      + targetClass + ", found " + _classname);
+					return false;
+				}
+
+				_checkedTargets[class_id] = targetClass;
 			}
 		}
 
@@ -1123,6 +1212,24 @@ bool VBinaryArchive::open(std::streambuf *buf) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool VBinaryArchive::open(const char *data, size_t size) {
+	_error = "";
+
+	if ( !BinaryArchive::open(data, size) ) return false;
+
+	if ( !readHeader() ) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool VBinaryArchive::create(const char* file) {
 	_error = "";
@@ -1147,6 +1254,18 @@ bool VBinaryArchive::create(std::streambuf *buf) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool VBinaryArchive::create(std::string &buffer) {
+	_error = "";
+	if ( !BinaryArchive::create(buffer) ) return false;
+	writeHeader();
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void VBinaryArchive::close() {
 	BinaryArchive::close();
@@ -55,9 +55,30 @@ class SC_SYSTEM_CORE_API BinaryArchive : public Seiscomp::Core::Archive {
 		bool open(const char* file);
 		bool open(std::streambuf*);
 
+		/**
+		 * @brief Opens an archive reading from contiguous memory. Fields
+		 *        are copied directly from the memory area without going
+		 *        through virtual stream buffer calls. The memory must be
+		 *        valid until the archive is closed.
+		 * @param data The data pointer
+		 * @param size The number of bytes available
+		 * @return Success flag
+		 */
+		bool open(const char *data, size_t size);
+
 		bool create(const char* file);
 		bool create(std::streambuf*);
 
+		/**
+		 * @brief Creates an archive appending its output to a string.
+		 *        The string is grown in larger steps while writing and
+		 *        trimmed to the written size when the archive is closed.
+		 * @param buffer The target buffer which must be valid until the
+		 *               archive is closed
+		 * @return Success flag
+		 */
+		bool create(std::string &buffer);
+
 		//! Implements derived virtual method
 		virtual void close();
 
@@ -168,6 +189,7 @@ class SC_SYSTEM_CORE_API BinaryArchive : public Seiscomp::Core::Archive {
 		//! Implements derived virtual method
 		void serialize(SerializeDispatcher&);
 
+		int readBytes(void*, int);
 		int writeBytes(const void*, int);
 
 
@@ -188,7 +210,35 @@ class SC_SYSTEM_CORE_API BinaryArchive : public Seiscomp::Core::Archive {
 
 
 	protected:
+		//! Stream buffer over contiguous memory which additionally allows
+		//! to consume bytes without virtual calls
+		class MemoryBuffer : public std::streambuf {
+			public:
+				void set(const char *data, size_t size) {
+					char *p = const_cast<char*>(data);
+					setg(p, p, p + size);
+				}
+
+				//! Returns a pointer to the next size bytes and consumes
+				//! them or nullptr if less bytes are available
+				const char *take(int size) {
+					if ( egptr() - gptr() < size ) return nullptr;
+					const char *p = gptr();
+					gbump(size);
+					return p;
+				}
+
+				//! Returns the number of bytes left
+				int available() const {
+					return static_cast<int>(egptr() - gptr());
+				}
+		};
+
 		std::streambuf* _buf;
+		MemoryBuffer    _memoryBuffer;
+		bool            _memory{false};
+		std::string    *_output{nullptr};
+		size_t          _outputSize{0};
 
 	private:
 		bool _deleteOnClose;
@@ -200,6 +250,7 @@ class SC_SYSTEM_CORE_API BinaryArchive : public Seiscomp::Core::Archive {
 
 		typedef std::vector<std::string> ClassList;
 		ClassList _classes;
+		std::vector<const char*> _checkedTargets;
 };
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -227,9 +278,11 @@ class SC_SYSTEM_CORE_API VBinaryArchive : public BinaryArchive {
 
 		bool open(const char* file);
 		bool open(std::streambuf*);
+		bool open(const char *data, size_t size);
 
 		bool create(const char* file);
 		bool create(std::streambuf*);
+		bool create(std::string &buffer);
 
 		void close();
 
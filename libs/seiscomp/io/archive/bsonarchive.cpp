@@ -23,7 +23,9 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/core/platform/platform.h>
 #include <seiscomp/datamodel/version.h>
+#include <seiscomp/io/streams/filter/lz4.h>
 
+#include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 
@@ -38,6 +40,8 @@ extern "C" {
 	#include "bson/bson.h"
 }
 
+#include <lz4/lz4frame.h>
+
 
 namespace Seiscomp {
 namespace IO {
@@ -49,21 +53,84 @@ ssize_t streamBufReadCallback(void* context, uint8_t* buffer, size_t len) {
 	std::streambuf* buf = static_cast<std::streambuf*>(context);
 	if ( buf == nullptr ) return -1;
 
-	long count = 0;
-	int ch = buf->sgetc();
-	while ( ch != EOF && len-- ) {
-		*buffer++ = (char)buf->sbumpc();
-		ch = buf->sgetc();
-		++count;
-	}
-
-	return count;
+	return buf->sgetn(reinterpret_cast<char*>(buffer), len);
 }
 
 ssize_t streamBufReadCallback2(void* context, void* buffer, size_t len) {
 	return streamBufReadCallback(context, (unsigned char *) buffer, len);
 }
 
+bool lz4Compress(std::string &out, const char *data, size_t size) {
+	LZ4F_preferences_t prefs;
+	memset(&prefs, 0, sizeof(prefs));
+	prefs.frameInfo.contentSize = size;
+
+	size_t offset = out.size();
+	out.resize(offset + LZ4F_compressFrameBound(size, &prefs));
+
+	size_t written = LZ4F_compressFrame(&out[offset], out.size() - offset,
+	                                    data, size, &prefs);
+	if ( LZ4F_isError(written) ) {
+		SEISCOMP_ERROR("LZ4 compression failed: %s", LZ4F_getErrorName(written));
+		out.resize(offset);
+		return false;
+	}
+
+	out.resize(offset + written);
+	return true;
+}
+
+bool lz4Decompress(std::string &out, const char *data, size_t size) {
+	LZ4F_dctx *ctx;
+	if ( LZ4F_isError(LZ4F_createDecompressionContext(&ctx, LZ4F_VERSION)) )
+		return false;
+
+	// Use the content size from the frame header if present
+	LZ4F_frameInfo_t info;
+	size_t srcPos = size;
+	size_t r = LZ4F_getFrameInfo(ctx, &info, data, &srcPos);
+	if ( LZ4F_isError(r) ) {
+		SEISCOMP_ERROR("LZ4 decompression failed: %s", LZ4F_getErrorName(r));
+		LZ4F_freeDecompressionContext(ctx);
+		return false;
+	}
+
+	// LZ4 cannot compress better than 1:255, do not trust larger sizes
+	if ( info.contentSize > (unsigned long long)size * 255 + 1024 ) {
+		SEISCOMP_ERROR("LZ4 decompression failed: invalid content size");
+		LZ4F_freeDecompressionContext(ctx);
+		return false;
+	}
+
+	out.resize(info.contentSize ? info.contentSize : std::max(size * 4, size_t(1024)));
+	size_t outPos = 0;
+
+	while ( r != 0 ) {
+		if ( outPos == out.size() && !info.contentSize )
+			out.resize(out.size() * 2);
+
+		size_t dstSize = out.size() - outPos;
+		size_t srcSize = size - srcPos;
+		r = LZ4F_decompress(ctx, &out[outPos], &dstSize, data + srcPos, &srcSize, nullptr);
+		if ( LZ4F_isError(r) ) {
+			SEISCOMP_ERROR("LZ4 decompression failed: %s", LZ4F_getErrorName(r));
+			break;
+		}
+
+		srcPos += srcSize;
+		outPos += dstSize;
+
+		if ( r != 0 && srcSize == 0 && dstSize == 0 ) {
+			SEISCOMP_ERROR("LZ4 decompression failed: truncated or invalid frame");
+			break;
+		}
+	}
+
+	LZ4F_freeDecompressionContext(ctx);
+	out.resize(outPos);
+	return r == 0;
+}
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -79,7 +146,20 @@ class BSONArchive::BSONImpl : public Core::BaseObject {
 			children = nullptr;
 			bsonReader = nullptr;
 			jsonReader = nullptr;
+			ownsRoot = false;
 			links = nullptr;
+			target = nullptr;
+			targetData = nullptr;
+			targetSize = 0;
+			targetOffset = 0;
+		}
+
+		// Grows the target string on behalf of libbson while building
+		// the document directly inside of it
+		static void *growTarget(void *, size_t size, void *ctx) {
+			BSONImpl *impl = static_cast<BSONImpl*>(ctx);
+			impl->target->resize(impl->targetOffset + size);
+			return &(*impl->target)[impl->targetOffset];
 		}
 
 		const bson_t       *root;
@@ -89,6 +169,19 @@ class BSONArchive::BSONImpl : public Core::BaseObject {
 		bson_reader_t      *bsonReader;
 		bson_json_reader_t *jsonReader;
 
+		// Root document of a memory archive, either static or parsed
+		// from JSON if ownsRoot is set
+		bson_t              staticRoot;
+		bool                ownsRoot;
+		// Inflated data of a compressed memory archive
+		std::string         inflated;
+
+		// Output string the current document is built in
+		std::string        *target;
+		uint8_t            *targetData;
+		size_t              targetSize;
+		size_t              targetOffset;
+
 		bson_iter_t         iter;
 		bson_iter_t         iterParent;
 		bson_iter_t         iterChildren;
@@ -101,15 +194,17 @@ class BSONArchive::BSONImpl : public Core::BaseObject {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-BSONArchive::BSONArchive() : Seiscomp::Core::Archive() {
+BSONArchive::BSONArchive(int forceWriteVersion) : Seiscomp::Core::Archive() {
 	_siblingCount = 0;
 	_startSequence = false;
 	_validObject = false;
 	_buf = nullptr;
+	_target = nullptr;
 	_deleteOnClose = false;
 	_compression = false;
+	_compressionMethod = ZIP;
 	_json = false;
-	_forceWriteVersion = -1;
+	_forceWriteVersion = forceWriteVersion;
 
 	_impl = new BSONImpl;
 }
@@ -124,8 +219,10 @@ BSONArchive::BSONArchive(std::streambuf* buf, bool isReading, int forceWriteVers
 	_startSequence = false;
 	_validObject = false;
 	_buf = nullptr;
+	_target = nullptr;
 	_deleteOnClose = false;
 	_compression = false;
+	_compressionMethod = ZIP;
 	_json = false;
 	_forceWriteVersion = forceWriteVersion;
 
@@ -201,7 +298,10 @@ bool BSONArchive::open() {
 	boost::iostreams::filtering_istreambuf filtered_buf;
 
 	if ( _compression ) {
-		filtered_buf.push(boost::iostreams::zlib_decompressor());
+		if ( _compressionMethod == LZ4 )
+			filtered_buf.push(ext::boost::iostreams::lz4_decompressor());
+		else
+			filtered_buf.push(boost::iostreams::zlib_decompressor());
 		filtered_buf.push(*_buf);
 		buf = &filtered_buf;
 	}
@@ -252,6 +352,80 @@ bool BSONArchive::open() {
 		}
 	}
 
+	return openDocument();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BSONArchive::open(const char *data, size_t size) {
+	close();
+
+	if ( data == nullptr ) return false;
+
+	if ( !Seiscomp::Core::Archive::open(nullptr) )
+		return false;
+
+	if ( _compression ) {
+		_impl->inflated.clear();
+
+		if ( _compressionMethod == LZ4 ) {
+			if ( !lz4Decompress(_impl->inflated, data, size) )
+				return false;
+		}
+		else {
+			try {
+				boost::iostreams::filtering_ostream os;
+				os.push(boost::iostreams::zlib_decompressor());
+				os.push(boost::iostreams::back_inserter(_impl->inflated));
+				os.write(data, size);
+				os.reset();
+			}
+			catch ( std::exception &e ) {
+				SEISCOMP_ERROR("%s", e.what());
+				return false;
+			}
+		}
+
+		data = _impl->inflated.data();
+		size = _impl->inflated.size();
+	}
+
+	if ( _json ) {
+		bson_error_t err;
+		if ( !bson_init_from_json(&_impl->staticRoot, data, size, &err) ) {
+			SEISCOMP_ERROR("%s", err.message);
+			return false;
+		}
+
+		_impl->ownsRoot = true;
+	}
+	else {
+		// Iterate the first document in place
+		uint32_t len;
+		if ( size < 5 ) return false;
+		memcpy(&len, data, sizeof(len));
+		len = BSON_UINT32_FROM_LE(len);
+		if ( len > size ) return false;
+
+		if ( !bson_init_static(&_impl->staticRoot,
+		                       reinterpret_cast<const uint8_t*>(data), len) )
+			return false;
+	}
+
+	_impl->root = &_impl->staticRoot;
+
+	return openDocument();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BSONArchive::openDocument() {
 	bson_iter_t iter;
 	const char *ver;
 	uint32_t len;
@@ -307,6 +481,19 @@ bool BSONArchive::create(std::streambuf* buf, bool writeVersion) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BSONArchive::create(std::string &buffer, bool writeVersion) {
+	close();
+
+	_target = &buffer;
+
+	return create(writeVersion);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool BSONArchive::create(const char* filename, bool writeVersion) {
 	close();
@@ -347,7 +534,20 @@ bool BSONArchive::create(bool writeVersion) {
 	else
 		setVersion(Core::Version(0,0));
 
-	_impl->current = bson_new();
+	if ( _target && !_compression && !_json ) {
+		// Build the document directly inside the target string
+		_impl->target = _target;
+		_impl->targetOffset = _target->size();
+		_impl->targetData = nullptr;
+		_impl->targetSize = 0;
+		_impl->current = bson_new_from_buffer(&_impl->targetData,
+		                                      &_impl->targetSize,
+		                                      BSONImpl::growTarget,
+		                                      _impl.get());
+	}
+	else
+		_impl->current = bson_new();
+
 	_impl->links = new std::list<std::pair<std::string, bson_t*> >;
 
 	bson_append_utf8(_impl->current, "version", -1, (Seiscomp::Core::toString(versionMajor()) + "." + Seiscomp::Core::toString(versionMinor())).c_str(), -1);
@@ -374,6 +574,16 @@ void BSONArchive::close() {
 			_impl->root = nullptr;
 			_impl->bsonReader = nullptr;
 		}
+		else if ( _impl->root == &_impl->staticRoot ) {
+			if ( _impl->ownsRoot ) {
+				bson_destroy(&_impl->staticRoot);
+				_impl->ownsRoot = false;
+			}
+
+			_impl->root = nullptr;
+		}
+
+		_impl->inflated.clear();
 	}
 	else {
 		if ( _impl->links != nullptr ) {
@@ -393,7 +603,10 @@ void BSONArchive::close() {
 			boost::iostreams::filtering_ostreambuf filtered_buf;
 
 			if ( _compression ) {
-				filtered_buf.push(boost::iostreams::zlib_compressor());
+				if ( _compressionMethod == LZ4 )
+					filtered_buf.push(ext::boost::iostreams::lz4_compressor());
+				else
+					filtered_buf.push(boost::iostreams::zlib_compressor());
 				filtered_buf.push(*_buf);
 				buf = &filtered_buf;
 			}
@@ -408,6 +621,37 @@ void BSONArchive::close() {
 				buf->sputn((const char *) bson_get_data(_impl->current), _impl->current->len);
 			}
 		}
+		else if ( _impl->target ) {
+			// The document has been built in place, cut off the reserve
+			_impl->target->resize(_impl->targetOffset + _impl->current->len);
+			_impl->target = nullptr;
+			_impl->targetData = nullptr;
+			_impl->targetSize = 0;
+		}
+		else if ( _target && _impl->current ) {
+			const char *data = (const char *) bson_get_data(_impl->current);
+			size_t len = _impl->current->len;
+			char *str = nullptr;
+
+			if ( _json ) {
+				str = bson_as_json(_impl->current, &len);
+				data = str;
+			}
+
+			if ( !_compression )
+				_target->append(data, len);
+			else if ( _compressionMethod == LZ4 )
+				lz4Compress(*_target, data, len);
+			else {
+				boost::iostreams::filtering_ostream os;
+				os.push(boost::iostreams::zlib_compressor());
+				os.push(boost::iostreams::back_inserter(*_target));
+				os.write(data, len);
+				os.reset();
+			}
+
+			if ( str ) bson_free(str);
+		}
 
 		if ( _impl->current != nullptr ) {
 			bson_destroy(_impl->current);
@@ -420,6 +664,7 @@ void BSONArchive::close() {
 
 	_deleteOnClose = false;
 	_buf = nullptr;
+	_target = nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -435,6 +680,15 @@ void BSONArchive::setCompression(bool enable) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BSONArchive::setCompressionMethod(CompressionMethod method) {
+	_compressionMethod = method;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BSONArchive::setJSON(bool enable) {
 	_json = enable;
@@ -32,12 +32,19 @@ namespace IO {
 /** \brief An archive using BSON streams
  */
 class SC_SYSTEM_CORE_API BSONArchive : public Seiscomp::Core::Archive {
+	public:
+		enum CompressionMethod {
+			ZIP,
+			LZ4
+		};
+
+
 	// ----------------------------------------------------------------------
 	//  Xstruction
 	// ----------------------------------------------------------------------
 	public:
 		//! Constructor
-		BSONArchive();
+		BSONArchive(int forceWriteVersion = -1);
 
 		//! Constructor with predefined buffer and mode
 		BSONArchive(std::streambuf* buf, bool isReading = true,
@@ -57,9 +64,34 @@ class SC_SYSTEM_CORE_API BSONArchive : public Seiscomp::Core::Archive {
 		//! Implements derived virtual method
 		virtual bool open(const char* filename);
 
+		/**
+		 * @brief Opens an archive reading from contiguous memory. An
+		 *        uncompressed BSON document is not copied but iterated in
+		 *        place, compressed data are inflated once into an internal
+		 *        buffer. The memory must be valid until the archive is
+		 *        closed.
+		 * @param data The data pointer
+		 * @param size The number of bytes available
+		 * @return Success flag
+		 */
+		bool open(const char *data, size_t size);
+
 		//! Creates an archive writing to a streambuf
 		bool create(std::streambuf* buf, bool writeVersion = true);
 
+		/**
+		 * @brief Creates an archive appending its output to a string.
+		 *        Without compression and JSON the document is built
+		 *        directly inside the string which grows as required,
+		 *        otherwise the document is compressed or converted into
+		 *        the string when the archive is closed.
+		 * @param buffer The target buffer which must be valid and must not
+		 *               be modified until the archive is closed
+		 * @param writeVersion Whether to write the schema version
+		 * @return Success flag
+		 */
+		bool create(std::string &buffer, bool writeVersion = true);
+
 		//! Implements derived virtual method
 		virtual bool create(const char* filename, bool writeVersion = true);
 
@@ -72,6 +104,13 @@ class SC_SYSTEM_CORE_API BSONArchive : public Seiscomp::Core::Archive {
 		 */
 		void setCompression(bool enable);
 
+		/**
+		 * Sets the compression method if compression is enabled. LZ4
+		 * uses the LZ4 frame format.
+		 * @param method The method to be used
+		 */
+		void setCompressionMethod(CompressionMethod method);
+
 		/**
 		 * Enables/Disables JSON format
 		 * @param enable The state of this flag
@@ -205,6 +244,7 @@ class SC_SYSTEM_CORE_API BSONArchive : public Seiscomp::Core::Archive {
 	// ----------------------------------------------------------------------
 	private:
 		bool open();
+		bool openDocument();
 		bool create(bool writeVersion);
 
 		template<typename T>
@@ -238,9 +278,11 @@ class SC_SYSTEM_CORE_API BSONArchive : public Seiscomp::Core::Archive {
 		bool                   _validObject;
 
 		std::streambuf        *_buf;
+		std::string           *_target;
 		bool                   _deleteOnClose;
 
 		bool                   _compression;
+		CompressionMethod      _compressionMethod;
 		bool                   _json;
 		int                    _forceWriteVersion;
 };
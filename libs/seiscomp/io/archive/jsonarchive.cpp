@@ -27,9 +27,13 @@
 #include <seiscomp/datamodel/version.h>
 #include <seiscomp/math/math.h>
 
+#include <rapidjson/writer.h>
+
 #include <boost/lexical_cast.hpp>
+#include <deque>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include <string.h>
 #include <stdint.h>
 #include <limits>
@@ -55,57 +59,46 @@ struct jsontime {
 	const Core::Time &ref;
 };
 
-struct jsonstring {
-	jsonstring(const string &s) : str(s) {}
-	const string &str;
-};
-
-
 ostream &operator<<(ostream &os, const jsontime &js) {
 	os << js.ref.toString("\"" DATE_FORMAT "\"");
 	return os;
 }
 
-ostream &operator<<(ostream &os, const jsonstring &js) {
-	// Keep it simple and forward utf-8 unescaped bytes
-	size_t l = js.str.length();
-	for ( size_t i = 0; i < l; ++i ) {
-		char c = js.str[i];
-		switch ( c ) {
-			case '"':
-			case '\\':
-				os.write("\\", 1);
-				os.write((const char*)&c, 1);
-				break;
-			case '\b':
-				os.write("\\b", 2);
-				break;
-			case '\f':
-				os.write("\\f", 2);
-				break;
-			case '\n':
-				os.write("\\n", 2);
-				break;
-			case '\r':
-				os.write("\\r", 2);
-				break;
-			case '\t':
-				os.write("\\t", 2);
-				break;
-			default:
-				os.write((const char*)&c, 1);
-				break;
-		}
-	}
 
-	return os;
-}
+struct OutputStream {
+	typedef streambuf::char_type Ch;
+
+	OutputStream(streambuf *buf) : _buf(buf) {}
+
+	void Put(Ch c) { _buf->sputc(c); }
+	void Flush() {}
+
+	streambuf *_buf;
+};
+
+
+typedef rapidjson::Writer<OutputStream, rapidjson::UTF8<>, rapidjson::UTF8<>,
+                          rapidjson::CrtAllocator,
+                          rapidjson::kWriteNanAndInfFlag> ValueWriter;
+
+
+inline void put(ValueWriter &writer, int value) { writer.Int(value); }
+inline void put(ValueWriter &writer, int64_t value) { writer.Int64(value); }
+inline void put(ValueWriter &writer, double value) { writer.Double(value); }
 
 
 struct InputStream {
 	typedef streambuf::char_type Ch;
 
-	InputStream(streambuf *buf) : _buf(buf), _pos(0) {}
+	InputStream(streambuf *buf) : _buf(buf), _pos(0) {
+		try {
+			_origin = _buf->pubseekoff(0, ios_base::cur, ios_base::in);
+		}
+		catch ( ... ) {
+			// Some stream buffers throw if they do not support seeking
+			_origin = streampos(streamoff(-1));
+		}
+	}
 
 	Ch Peek() const {
 		streambuf::int_type c = _buf->sgetc();
@@ -120,22 +113,536 @@ struct InputStream {
 
 	size_t Tell() const { return _pos; }
 
+	bool seekable() const { return _origin != streampos(streamoff(-1)); }
+
+	bool seek(size_t pos) {
+		if ( pos == _pos ) return true;
+		if ( !seekable() ) return false;
+
+		streampos target = _origin + streamoff(pos);
+		try {
+			if ( _buf->pubseekpos(target, ios_base::in) != target )
+				return false;
+		}
+		catch ( ... ) {
+			return false;
+		}
+
+		_pos = pos;
+		return true;
+	}
+
 	void Put(Ch) { RAPIDJSON_ASSERT(false); }
 	void Flush() { RAPIDJSON_ASSERT(false); }
 	Ch* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
 	size_t PutEnd(Ch*) { RAPIDJSON_ASSERT(false); return 0; }
 
 	streambuf *_buf;
+	streampos _origin;
 	size_t _pos;
 };
 
 
+class MemoryBuffer : public streambuf {
+	public:
+		MemoryBuffer(const char *data, size_t size) {
+			char *tmp = const_cast<char*>(data);
+			setg(tmp, tmp, tmp + size);
+		}
+
+	protected:
+		pos_type seekoff(off_type ofs, ios_base::seekdir dir,
+		                 ios_base::openmode) override {
+			char *next;
+
+			switch ( dir ) {
+				case ios_base::beg:
+					next = eback() + ofs;
+					break;
+				case ios_base::cur:
+					next = gptr() + ofs;
+					break;
+				case ios_base::end:
+					next = egptr() + ofs;
+					break;
+				default:
+					return pos_type(off_type(-1));
+			}
+
+			if ( next > egptr() || next < eback() )
+				return pos_type(off_type(-1));
+
+			setg(eback(), next, egptr());
+			return pos_type(next - eback());
+		}
+
+		pos_type seekpos(pos_type pos, ios_base::openmode mode) override {
+			return seekoff(off_type(pos), ios_base::beg, mode);
+		}
+};
+
+
+struct KeyHandler : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, KeyHandler> {
+	bool String(const char *str, rapidjson::SizeType length, bool) {
+		key.assign(str, length);
+		return true;
+	}
+
+	string key;
+};
+
+
+// Values are parsed one by one from the stream and may be followed by
+// further members or elements. Numbers are parsed with full precision to
+// read back exactly what has been written.
+const unsigned ParseFlags = rapidjson::kParseStopWhenDoneFlag |
+                            rapidjson::kParseFullPrecisionFlag |
+                            rapidjson::kParseNanAndInfFlag;
+
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// Pulls objects and arrays lazily from the input stream. Each open container
+// is represented by a frame whose placeholder node is passed around in place
+// of a document value. Frames are stacked, the innermost container on top.
+struct JSONArchive::Parser {
+	static const size_t ElementPoolSize = 1 << 20;
+
+	enum State {
+		// The name has been read and the stream is positioned at the value
+		Pending,
+		// The value has been parsed into memory
+		Materialized,
+		// The value has been skipped and can be read again at its offset
+		Indexed,
+		// The value has been skipped and cannot be read again
+		Consumed
+	};
+
+	struct Member {
+		string      name;
+		State       state{Pending};
+		char        type{0};
+		size_t      offset{0};
+		Value       value;
+	};
+
+	struct Frame {
+		Frame(const string &n, bool array, bool seq)
+		: node(rapidjson::kObjectType), name(n), isArray(array)
+		, sequential(seq) {}
+
+		Value         node;
+		string        name;
+		bool          isArray;
+		// Whether the container is the value the parent frame is
+		// positioned at
+		bool          sequential;
+		bool          closed{false};
+		size_t        count{0};
+		size_t        offset{0};
+		// Allocates the materialized members
+		Document::AllocatorType allocator;
+		deque<Member> members;
+		Document      element;
+	};
+
+	Parser(streambuf *buf) : stream(buf) {}
+
+	~Parser() {
+		for ( Frame *frame : frames )
+			delete frame;
+	}
+
+	bool fail(const char *what) {
+		if ( !failed ) {
+			SEISCOMP_ERROR("%s (offset %zu)", what, stream.Tell());
+			failed = true;
+		}
+
+		return false;
+	}
+
+	bool fail(rapidjson::ParseErrorCode code, size_t offset) {
+		if ( !failed ) {
+			SEISCOMP_ERROR("%s (offset %zu)", rapidjson::GetParseError_En(code), offset);
+			failed = true;
+		}
+
+		return false;
+	}
+
+	const Value *open() {
+		rapidjson::SkipWhitespace(stream);
+
+		if ( stream.Peek() != '{' ) {
+			// Anything else than an object is read as a whole
+			root.ParseStream<ParseFlags>(stream);
+			if ( root.HasParseError() ) {
+				fail(root.GetParseError(), root.GetErrorOffset());
+				return nullptr;
+			}
+
+			return &root;
+		}
+
+		stream.Take();
+		Frame *frame = new Frame("", false, false);
+		frame->offset = stream.Tell();
+		frames.push_back(frame);
+		return &frame->node;
+	}
+
+	Frame *frame(const Value *node) const {
+		for ( auto it = frames.rbegin(); it != frames.rend(); ++it ) {
+			if ( &(*it)->node == node )
+				return *it;
+		}
+
+		return nullptr;
+	}
+
+	bool seek(size_t offset) {
+		if ( !stream.seek(offset) )
+			return fail("JSON stream is not seekable");
+		return true;
+	}
+
+	// Skips the value at the current position. Objects and arrays are only
+	// scanned for their closing bracket and not validated.
+	bool skip() {
+		InputStream::Ch c = stream.Peek();
+		if ( c != '{' && c != '[' ) {
+			rapidjson::BaseReaderHandler<> handler;
+			if ( !reader.Parse<ParseFlags>(stream, handler) )
+				return fail(reader.GetParseErrorCode(), reader.GetErrorOffset());
+			return true;
+		}
+
+		size_t depth = 0;
+		do {
+			c = stream.Take();
+			switch ( c ) {
+				case '"':
+					while ( (c = stream.Take()) != '"' ) {
+						if ( c == '\\' )
+							c = stream.Take();
+						if ( c == '\0' )
+							return fail(rapidjson::kParseErrorStringMissQuotationMark, stream.Tell());
+					}
+					break;
+				case '{':
+				case '[':
+					++depth;
+					break;
+				case '}':
+				case ']':
+					--depth;
+					break;
+				case '\0':
+					return fail(rapidjson::kParseErrorTermination, stream.Tell());
+			}
+		}
+		while ( depth );
+
+		return true;
+	}
+
+	bool parse(Value &target, Document::AllocatorType &allocator) {
+		Document doc(&allocator);
+		doc.ParseStream<ParseFlags>(stream);
+		if ( doc.HasParseError() )
+			return fail(doc.GetParseError(), doc.GetErrorOffset());
+		target.Swap(doc);
+		return true;
+	}
+
+	// Reads the name of the next member of an object frame and leaves the
+	// stream positioned at its value
+	Member *next(Frame *frame) {
+		if ( failed || frame->closed || !seek(frame->offset) )
+			return nullptr;
+
+		rapidjson::SkipWhitespace(stream);
+
+		if ( stream.Peek() == '}' ) {
+			stream.Take();
+			frame->closed = true;
+			frame->offset = stream.Tell();
+			return nullptr;
+		}
+
+		if ( frame->count ) {
+			if ( stream.Peek() != ',' ) {
+				fail(rapidjson::kParseErrorObjectMissCommaOrCurlyBracket, stream.Tell());
+				return nullptr;
+			}
+
+			stream.Take();
+			rapidjson::SkipWhitespace(stream);
+		}
+
+		if ( stream.Peek() != '"' ) {
+			fail(rapidjson::kParseErrorObjectMissName, stream.Tell());
+			return nullptr;
+		}
+
+		KeyHandler handler;
+		if ( !reader.Parse<ParseFlags>(stream, handler) ) {
+			fail(reader.GetParseErrorCode(), reader.GetErrorOffset());
+			return nullptr;
+		}
+
+		rapidjson::SkipWhitespace(stream);
+		if ( stream.Peek() != ':' ) {
+			fail(rapidjson::kParseErrorObjectMissColon, stream.Tell());
+			return nullptr;
+		}
+
+		stream.Take();
+		rapidjson::SkipWhitespace(stream);
+
+		frame->members.emplace_back();
+		Member &member = frame->members.back();
+		member.name.swap(handler.key);
+		member.type = stream.Peek();
+		member.offset = stream.Tell();
+
+		frame->offset = member.offset;
+		++frame->count;
+
+		return &member;
+	}
+
+	// Positions the stream at the next element of an array frame
+	bool nextElement(Frame *frame) {
+		if ( failed || frame->closed || !seek(frame->offset) )
+			return false;
+
+		rapidjson::SkipWhitespace(stream);
+
+		if ( stream.Peek() == ']' ) {
+			stream.Take();
+			frame->closed = true;
+			frame->offset = stream.Tell();
+			return false;
+		}
+
+		if ( frame->count ) {
+			if ( stream.Peek() != ',' )
+				return fail(rapidjson::kParseErrorArrayMissCommaOrSquareBracket, stream.Tell());
+
+			stream.Take();
+			rapidjson::SkipWhitespace(stream);
+		}
+
+		++frame->count;
+		return true;
+	}
+
+	// Passes the pending member which has not been requested
+	bool pass(Frame *frame, Member &member) {
+		if ( stream.seekable() ) {
+			if ( !skip() ) return false;
+			member.state = Indexed;
+		}
+		else {
+			if ( !parse(member.value, frame->allocator) ) return false;
+			member.state = Materialized;
+		}
+
+		frame->offset = stream.Tell();
+		return true;
+	}
+
+	bool materialize(Frame *frame, Member &member) {
+		if ( member.state == Materialized )
+			return true;
+
+		if ( member.state == Consumed || !seek(member.offset) )
+			return false;
+
+		if ( !parse(member.value, frame->allocator) )
+			return false;
+
+		if ( member.state == Pending )
+			frame->offset = stream.Tell();
+
+		member.state = Materialized;
+		return true;
+	}
+
+	// Skips the remaining members or elements of a frame
+	bool drain(Frame *frame) {
+		if ( frame->isArray ) {
+			while ( nextElement(frame) ) {
+				if ( !skip() ) return false;
+				frame->offset = stream.Tell();
+			}
+		}
+		else {
+			if ( !frame->members.empty() && frame->members.back().state == Pending ) {
+				if ( !seek(frame->offset) || !skip() ) return false;
+				frame->members.back().state = Consumed;
+				frame->offset = stream.Tell();
+			}
+
+			while ( next(frame) ) {
+				if ( !skip() ) return false;
+				frame->members.pop_back();
+				frame->offset = stream.Tell();
+			}
+		}
+
+		return !failed;
+	}
+
+	void pop() {
+		Frame *frame = frames.back();
+		frames.pop_back();
+
+		// Continue the parent after the value
+		if ( frame->sequential && !frames.empty() && drain(frame) )
+			frames.back()->offset = frame->offset;
+
+		delete frame;
+	}
+
+	// Closes all frames opened after the given one
+	bool unwind(Frame *frame) {
+		while ( frames.back() != frame )
+			pop();
+		return !failed;
+	}
+
+	// Closes the frame and all frames opened after it
+	void finish(const Value *node) {
+		Frame *frame = this->frame(node);
+		if ( frame && unwind(frame) )
+			pop();
+	}
+
+	static bool matches(const Member &member, const char *name,
+	                    const char *targetClass, bool tag) {
+		if ( !tag )
+			return member.name == name;
+
+		if ( member.type == '[' ) {
+			if ( !name ) return false;
+			return member.name == name ||
+			       Core::ClassFactory::IsTypeOf(name, member.name.c_str());
+		}
+
+		if ( member.type != '{' )
+			return false;
+
+		if ( name && *name )
+			return member.name == name ||
+			       Core::ClassFactory::IsTypeOf(name, member.name.c_str());
+
+		if ( targetClass )
+			return Core::ClassFactory::IsTypeOf(targetClass, member.name.c_str());
+
+		return false;
+	}
+
+	// Looks up a member of an object frame, either in the members already
+	// read or further in the stream. A matching member read from the stream
+	// is left pending.
+	Member *find(Frame *frame, const char *name, const char *targetClass,
+	             bool tag) {
+		if ( failed || frame->isArray || !unwind(frame) )
+			return nullptr;
+
+		for ( Member &member : frame->members ) {
+			if ( member.state == Consumed ) continue;
+			if ( matches(member, name, targetClass, tag) )
+				return &member;
+		}
+
+		if ( !frame->members.empty() && frame->members.back().state == Pending ) {
+			if ( !pass(frame, frame->members.back()) )
+				return nullptr;
+		}
+
+		Member *member;
+		while ( (member = next(frame)) != nullptr ) {
+			if ( matches(*member, name, targetClass, tag) )
+				return member;
+			if ( !pass(frame, *member) )
+				return nullptr;
+		}
+
+		return nullptr;
+	}
+
+	const Value *attribute(Frame *frame, const char *name) {
+		Member *member = find(frame, name, nullptr, false);
+		if ( member == nullptr || !materialize(frame, *member) )
+			return nullptr;
+		return &member->value;
+	}
+
+	// Opens an object or array member as a new frame
+	Frame *enter(Member &member) {
+		bool sequential = member.state == Pending;
+
+		if ( !seek(member.offset) )
+			return nullptr;
+
+		Frame *frame = new Frame(member.name, stream.Take() == '[', sequential);
+		frame->offset = stream.Tell();
+		frames.push_back(frame);
+
+		member.state = stream.seekable() ? Indexed : Consumed;
+
+		return frame;
+	}
+
+	const Value *element(Frame *frame) {
+		if ( !unwind(frame) || !nextElement(frame) )
+			return nullptr;
+
+		// Release the previous elements once in a while rather than after
+		// each small one
+		frame->element.SetNull();
+		if ( frame->element.GetAllocator().Size() > ElementPoolSize )
+			frame->element.GetAllocator().Clear();
+
+		frame->element.ParseStream<ParseFlags>(stream);
+		if ( frame->element.HasParseError() ) {
+			fail(frame->element.GetParseError(), frame->element.GetErrorOffset());
+			return nullptr;
+		}
+
+		frame->offset = stream.Tell();
+		return &frame->element;
+	}
+
+	// Returns the first member of an object frame without consuming its
+	// value
+	Member *first(Frame *frame) {
+		if ( frame->members.empty() )
+			next(frame);
+		return frame->members.empty() ? nullptr : &frame->members.front();
+	}
+
+	InputStream       stream;
+	rapidjson::Reader reader;
+	bool              failed{false};
+	vector<Frame*>    frames;
+	Document          root;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 JSONArchive::JSONArchive()
 : _forceWriteVersion(-1)
@@ -149,6 +656,7 @@ JSONArchive::JSONArchive()
 	_attribIndex = 0;
 	_os = nullptr;
 	_document = nullptr;
+	_parser = nullptr;
 	_objectLocation = nullptr;
 	_current = nullptr;
 	_formattedOutput = false;
@@ -172,6 +680,7 @@ JSONArchive::JSONArchive(std::streambuf* buf, bool isReading,
 	_attribIndex = 0;
 	_os = nullptr;
 	_document = nullptr;
+	_parser = nullptr;
 	_objectLocation = nullptr;
 	_current = nullptr;
 	_formattedOutput = false;
@@ -216,19 +725,7 @@ bool JSONArchive::open(const char* file) {
 		_deleteBufOnClose = true;
 	}
 
-	_document = new Document;
-	InputStream is(_buf);
-	_document->ParseStream(is);
-	if ( _document->HasParseError() ) {
-		SEISCOMP_ERROR("%s", rapidjson::GetParseError_En(_document->GetParseError()));
-		close();
-		return false;
-	}
-
-	_current = _document;
-	parseVersion();
-
-	return Core::Archive::open(nullptr);
+	return openStream();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -243,19 +740,7 @@ bool JSONArchive::open(std::streambuf *buf) {
 	_deleteBufOnClose = false;
 	_deleteStreamOnClose = false;
 
-	_document = new Document;
-	InputStream is(_buf);
-	_document->ParseStream(is);
-	if ( _document->HasParseError() ) {
-		SEISCOMP_ERROR("%s", rapidjson::GetParseError_En(_document->GetParseError()));
-		close();
-		return false;
-	}
-
-	_current = _document;
-	parseVersion();
-
-	return Core::Archive::open(nullptr);
+	return openStream();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -279,8 +764,26 @@ bool JSONArchive::from(const Value *v) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool JSONArchive::from(const char *str) {
 	close();
+
+	_buf = new MemoryBuffer(str, strlen(str));
+	_deleteBufOnClose = true;
+	_deleteStreamOnClose = false;
+
+	return openStream();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool JSONArchive::from(char *str, bool insitu) {
+	if ( !insitu )
+		return from(const_cast<const char*>(str));
+
+	close();
 	_document = new Document;
-	_document->Parse(str);
+	_document->ParseInsitu(str);
 	if ( _document->HasParseError() ) {
 		SEISCOMP_ERROR("%s", rapidjson::GetParseError_En(_document->GetParseError()));
 		close();
@@ -297,19 +800,14 @@ bool JSONArchive::from(const char *str) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool JSONArchive::from(char *str, bool insitu) {
-	close();
-	_document = new Document;
-	if ( insitu )
-		_document->ParseInsitu(str);
-	else
-		_document->Parse(str);
-	if ( _document->HasParseError() ) {
-		SEISCOMP_ERROR("%s", rapidjson::GetParseError_En(_document->GetParseError()));
+bool JSONArchive::openStream() {
+	_parser = new Parser(_buf);
+	_current = _parser->open();
+	if ( _current == nullptr ) {
 		close();
 		return false;
 	}
-	_current = _document;
+
 	parseVersion();
 
 	return Core::Archive::open(nullptr);
@@ -321,30 +819,23 @@ bool JSONArchive::from(char *str, bool insitu) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void JSONArchive::parseVersion() {
-	for ( ConstItr itr = _current->MemberBegin(); itr != _current->MemberEnd(); ++itr ) {
-		if ( itr->value.IsString() && !strcmp("version", itr->name.GetString()) ) {
-			std::string version = itr->value.GetString();
-			size_t pos = version.find(".");
-
-			if ( pos != std::string::npos ) {
-				int major;
-				int minor;
-
-				if ( Core::fromString(major, version.substr(0, pos) ) &&
-				     Core::fromString(minor, version.substr(pos + 1, std::string::npos)) )
-					setVersion(Core::Version(major, minor));
-				else
-					setVersion(Core::Version(0,0));
-			}
-			else {
-				int major;
+	Parser::Frame *frame = _parser ? _parser->frame(_current) : nullptr;
+	if ( frame ) {
+		// Only the leading member is checked to not read ahead the whole
+		// document. The version is always written first.
+		Parser::Member *member = _parser->first(frame);
+		if ( member && member->type == '"' && member->name == "version" &&
+		     _parser->materialize(frame, *member) )
+			parseVersion(member->value.GetString());
+		return;
+	}
 
-				if (Core::fromString(major, version.substr(0, pos)) )
-					setVersion(Core::Version(major ,0));
-				else
-					setVersion(Core::Version(0,0));
-			}
+	if ( !_current->IsObject() )
+		return;
 
+	for ( ConstItr itr = _current->MemberBegin(); itr != _current->MemberEnd(); ++itr ) {
+		if ( itr->value.IsString() && !strcmp("version", itr->name.GetString()) ) {
+			parseVersion(itr->value.GetString());
 			break;
 		}
 	}
@@ -354,6 +845,34 @@ void JSONArchive::parseVersion() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void JSONArchive::parseVersion(const std::string &version) {
+	size_t pos = version.find(".");
+
+	if ( pos != std::string::npos ) {
+		int major;
+		int minor;
+
+		if ( Core::fromString(major, version.substr(0, pos) ) &&
+		     Core::fromString(minor, version.substr(pos + 1, std::string::npos)) )
+			setVersion(Core::Version(major, minor));
+		else
+			setVersion(Core::Version(0,0));
+	}
+	else {
+		int major;
+
+		if (Core::fromString(major, version.substr(0, pos)) )
+			setVersion(Core::Version(major ,0));
+		else
+			setVersion(Core::Version(0,0));
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool JSONArchive::create(const char* file, bool writeVersion) {
 	close();
@@ -442,6 +961,11 @@ void JSONArchive::close() {
 			_buf->sputn("\n",1);
 	}
 
+	if ( _parser ) {
+		delete _parser;
+		_parser = nullptr;
+	}
+
 	if ( _deleteStreamOnClose && _os )
 		delete _os;
 
@@ -1039,7 +1563,8 @@ inline void JSONArchive::postAttrib() {
 void JSONArchive::write(int8_t value) {
 	if ( !_buf ) return;
 	preAttrib();
-	*_os << value;
+	OutputStream os(_buf);
+	ValueWriter(os).Int(value);
 	postAttrib();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1051,7 +1576,8 @@ void JSONArchive::write(int8_t value) {
 void JSONArchive::write(int16_t value) {
 	if ( !_buf ) return;
 	preAttrib();
-	*_os << value;
+	OutputStream os(_buf);
+	ValueWriter(os).Int(value);
 	postAttrib();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1063,7 +1589,8 @@ void JSONArchive::write(int16_t value) {
 void JSONArchive::write(int32_t value) {
 	if ( !_buf ) return;
 	preAttrib();
-	*_os << value;
+	OutputStream os(_buf);
+	ValueWriter(os).Int(value);
 	postAttrib();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1075,7 +1602,8 @@ void JSONArchive::write(int32_t value) {
 void JSONArchive::write(int64_t value) {
 	if ( !_buf ) return;
 	preAttrib();
-	*_os << value;
+	OutputStream os(_buf);
+	ValueWriter(os).Int64(value);
 	postAttrib();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1104,8 +1632,11 @@ void JSONArchive::write(double value) {
 	preAttrib();
 	if ( Math::isNaN(value) )
 		*_os << "\"NaN\"";
-	else
-		*_os << boost::lexical_cast<std::string>(value);
+	else {
+		// Writes the shortest representation which reads back exactly
+		OutputStream os(_buf);
+		ValueWriter(os).Double(value);
+	}
 	postAttrib();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1118,12 +1649,12 @@ template <typename T>
 void JSONArchive::writeVector(std::vector<T> &value) {
 	if ( !_buf ) return;
 	preAttrib();
-	*_os << "[";
-	for ( size_t i = 0; i < value.size(); ++i ) {
-		if ( i ) *_os << ",";
-		*_os << value[i];
-	}
-	*_os << "]";
+	OutputStream os(_buf);
+	ValueWriter writer(os);
+	writer.StartArray();
+	for ( size_t i = 0; i < value.size(); ++i )
+		put(writer, value[i]);
+	writer.EndArray();
 	postAttrib();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1198,12 +1729,12 @@ void JSONArchive::write(std::vector<double> &value) {
 void JSONArchive::write(std::vector<std::string> &value) {
 	if ( !_buf ) return;
 	preAttrib();
-	*_os << "[";
-	for ( size_t i = 0; i < value.size(); ++i ) {
-		if ( i ) *_os << ",";
-		*_os << "\"" << jsonstring(value[i]) << "\"";
-	}
-	*_os << "]";
+	OutputStream os(_buf);
+	ValueWriter writer(os);
+	writer.StartArray();
+	for ( size_t i = 0; i < value.size(); ++i )
+		writer.String(value[i].data(), value[i].size());
+	writer.EndArray();
 	postAttrib();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1290,7 +1821,8 @@ void JSONArchive::write(std::string &value) {
 
 	if ( (hint() & XML_MANDATORY) || !value.empty() ) {
 		preAttrib();
-		*_os << "\"" << jsonstring(value) << "\"";
+		OutputStream os(_buf);
+		ValueWriter(os).String(value.data(), value.size());
 		postAttrib();
 	}
 }
@@ -1455,6 +1987,22 @@ std::string JSONArchive::determineClassName() {
 	if ( _current == nullptr || _objectLocation == nullptr )
 		return "";
 
+	if ( _parser ) {
+		Parser::Frame *frame = _parser->frame(_objectLocation);
+		if ( frame )
+			return frame->name;
+
+		frame = _parser->frame(_current);
+		if ( frame ) {
+			for ( const Parser::Member &member : frame->members ) {
+				if ( &member.value == _objectLocation )
+					return member.name;
+			}
+
+			return "";
+		}
+	}
+
 	if ( !_current->IsObject() )
 		return "";
 
@@ -1521,6 +2069,13 @@ inline void JSONArchive::_serialize(T &target) {
 
 		Core::Archive::serialize(target);
 
+		if ( _parser ) {
+			// Skip whatever has not been read of a streamed object
+			_parser->finish(backupLocation);
+			if ( _parser->failed )
+				setValidity(false);
+		}
+
 		_currentIndex = backupIdx;
 		_current = backupCurrent;
 		_currentArray = backupCurrentArray;
@@ -1668,6 +2223,14 @@ void JSONArchive::serialize(SerializeDispatcher &disp) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 const JSONArchive::Value *JSONArchive::findAttrib(const Value *node, const char* name) {
+	Parser::Frame *frame = _parser ? _parser->frame(node) : nullptr;
+	if ( frame ) {
+		const Value *value = _parser->attribute(frame, name);
+		if ( _parser->failed )
+			setValidity(false);
+		return value;
+	}
+
 	// find the child node with name = param name
 	if ( !node->IsObject() )
 		return nullptr;
@@ -1689,6 +2252,36 @@ const JSONArchive::Value *JSONArchive::findAttrib(const Value *node, const char*
 const JSONArchive::Value *
 JSONArchive::findTag(const Value *node, Size &index,
                      const char* name, const char* targetClass) {
+	Parser::Frame *frame = _parser ? _parser->frame(node) : nullptr;
+	if ( frame ) {
+		const Value *value = nullptr;
+		Parser::Member *member = _parser->find(frame, name, targetClass, true);
+
+		if ( member ) {
+			if ( member->state == Parser::Materialized )
+				value = selectTag(&member->value, index, targetClass);
+			else {
+				Parser::Frame *child = _parser->enter(*member);
+				if ( child == nullptr )
+					value = nullptr;
+				else if ( child->isArray ) {
+					_currentArray = &child->node;
+					index = 0;
+					value = unwrap(_parser->element(child), targetClass);
+				}
+				else {
+					index = -1;
+					value = &child->node;
+				}
+			}
+		}
+
+		if ( _parser->failed )
+			setValidity(false);
+
+		return value;
+	}
+
 	// find the child node with name = param name
 	if ( !node->IsObject() )
 		return nullptr;
@@ -1702,26 +2295,6 @@ JSONArchive::findTag(const Value *node, Size &index,
 				if ( !Core::ClassFactory::IsTypeOf(name, itr->name.GetString()) )
 					continue;
 			}
-
-			_currentArray = &itr->value;
-			index = 0;
-
-			if ( _currentArray->Size() <= index )
-				return nullptr;
-
-			if ( targetClass ) {
-				// Dynamic classes are wrapped
-				auto wrapper = &(*_currentArray)[index];
-				if ( wrapper->MemberBegin() != wrapper->MemberEnd() ) {
-					_current = wrapper;
-					return &_current->MemberBegin()->value;
-				}
-
-				return nullptr;
-			}
-			else {
-				return &(*_currentArray)[index];
-			}
 		}
 		else {
 			if ( name && *name ) {
@@ -1739,11 +2312,9 @@ JSONArchive::findTag(const Value *node, Size &index,
 			else {
 				continue;
 			}
-
-			index = -1;
 		}
 
-		return &itr->value;
+		return selectTag(&itr->value, index, targetClass);
 	}
 
 	return nullptr;
@@ -1757,24 +2328,63 @@ JSONArchive::findTag(const Value *node, Size &index,
 const JSONArchive::Value *
 JSONArchive::findNextTag(const Value *node, Size &index,
                          const char* name, const char* targetClass) {
-	if ( _currentIndex < 0 ) return nullptr;
-	++_currentIndex;
-	if ( _currentIndex >= node->Size() )
+	// The previous tag was a single object
+	if ( index == Size(-1) ) return nullptr;
+
+	Parser::Frame *frame = _parser ? _parser->frame(node) : nullptr;
+	if ( frame ) {
+		++index;
+		const Value *value = unwrap(_parser->element(frame), targetClass);
+		if ( _parser->failed )
+			setValidity(false);
+		return value;
+	}
+
+	++index;
+	if ( index >= node->Size() )
 		return nullptr;
 
-	if ( targetClass ) {
-		// Dynamic classes are wrapped
-		auto wrapper = &(*node)[_currentIndex];
-		if ( wrapper->MemberBegin() != wrapper->MemberEnd() ) {
-			_current = wrapper;
-			return &_current->MemberBegin()->value;
-		}
+	return unwrap(&(*node)[index], targetClass);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		return nullptr;
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const JSONArchive::Value *
+JSONArchive::selectTag(const Value *value, Size &index, const char* targetClass) {
+	if ( !value->IsArray() ) {
+		index = -1;
+		return value;
 	}
-	else {
-		return &(*node)[_currentIndex];
+
+	_currentArray = value;
+	index = 0;
+
+	if ( _currentArray->Size() <= index )
+		return nullptr;
+
+	return unwrap(&(*_currentArray)[index], targetClass);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const JSONArchive::Value *
+JSONArchive::unwrap(const Value *element, const char* targetClass) {
+	if ( element == nullptr || targetClass == nullptr )
+		return element;
+
+	// Dynamic classes are wrapped
+	if ( element->MemberBegin() != element->MemberEnd() ) {
+		_current = element;
+		return &_current->MemberBegin()->value;
 	}
+
+	return nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -34,6 +34,14 @@ namespace IO {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 /** \brief An archive using JSON streams
+ *
+ * Values are written directly to the output stream buffer. Streams and
+ * strings are read lazily: only the members of the enclosing objects are
+ * pulled from the stream on demand and each element of an array of objects
+ * is parsed on its own right before it is deserialized. Memory usage is
+ * therefore bounded by the largest array element rather than by the size of
+ * the document. Members which are skipped while looking ahead are indexed if
+ * the stream buffer is seekable and parsed into memory otherwise.
  */
 class SC_SYSTEM_CORE_API JSONArchive : public Core::Archive {
 	// ----------------------------------------------------------------------
@@ -69,10 +77,12 @@ class SC_SYSTEM_CORE_API JSONArchive : public Core::Archive {
 		bool open(std::streambuf*);
 		//! Reads an archive from a rapidjson document value
 		bool from(const Value*);
-		//! Reads the archive from a string
+		//! Reads the archive from a string. The string is read lazily and
+		//! must remain valid until the archive is closed.
 		bool from(const char *str);
 		//! Reads the archive from a string and allows optional insitu parsing
-		//! which replaces the contents of the string (destructive).
+		//! which replaces the contents of the string (destructive). Insitu
+		//! parsing builds the complete document in memory.
 		bool from(char *str, bool insitu = true);
 
 		bool create(const char *file, bool writeVersion = true);
@@ -206,7 +216,9 @@ class SC_SYSTEM_CORE_API JSONArchive : public Core::Archive {
 	//  Private interface
 	// ----------------------------------------------------------------------
 	private:
+		bool openStream();
 		void parseVersion();
+		void parseVersion(const std::string &version);
 		void createDocument(bool writeVersion);
 
 		template <typename T>
@@ -220,11 +232,16 @@ class SC_SYSTEM_CORE_API JSONArchive : public Core::Archive {
 	//  Implementation
 	// ----------------------------------------------------------------------
 	private:
+		struct Parser;
+
 		const Value *findAttrib(const Value *node, const char* name);
 		const Value *findTag(const Value *node, Size &index,
 		                     const char* name, const char* targetClass);
 		const Value *findNextTag(const Value *node, Size &index,
 		                         const char* name, const char* targetClass);
+		const Value *selectTag(const Value *value, Size &index,
+		                       const char* targetClass);
+		const Value *unwrap(const Value *element, const char* targetClass);
 
 		template <typename T>
 		void readIntVector(std::vector<T> &value);
@@ -249,6 +266,7 @@ class SC_SYSTEM_CORE_API JSONArchive : public Core::Archive {
 		std::streambuf *_buf;
 		std::ostream   *_os;
 		Document       *_document;
+		Parser         *_parser;
 		const Value    *_objectLocation;
 		const Value    *_current;
 		const Value    *_currentArray;
@@ -178,6 +178,17 @@ xmlChar *nodeGetContent(xmlNodePtr node) {
 }
 
 
+Core::Version parseVersion(char *version) {
+	char* seperator = strchr(version, '.');
+	if ( seperator != nullptr ) {
+		*seperator++ = '\0';
+		return Core::Version(atoi(version), atoi(seperator));
+	}
+
+	return Core::Version(atoi(version),0);
+}
+
+
 }
 
 XMLArchive::XMLArchive() : Seiscomp::Core::Archive() {
@@ -244,6 +255,14 @@ bool XMLArchive::open(std::streambuf* buf) {
 bool XMLArchive::open(const char* filename) {
 	close();
 
+	if ( !openFile(filename) )
+		return false;
+
+	return open();
+}
+
+
+bool XMLArchive::openFile(const char *filename) {
 	if ( !strcmp(filename, "-") ) {
 		_buf = std::cin.rdbuf();
 		_deleteOnClose = false;
@@ -266,7 +285,7 @@ bool XMLArchive::open(const char* filename) {
 		_deleteOnClose = true;
 	}
 
-	return open();
+	return true;
 }
 
 
@@ -335,14 +354,7 @@ bool XMLArchive::open() {
 
 	xmlChar* version = xmlGetProp(cur, (const xmlChar*)"version");
 	if ( version != nullptr ) {
-		char* seperator = strchr((char*)version, '.');
-		if ( seperator != nullptr ) {
-			*seperator++ = '\0';
-			setVersion(Core::Version(atoi((char*)version), atoi((char*)seperator)));
-		}
-		else
-			setVersion(Core::Version(atoi((char*)version),0));
-	
+		setVersion(parseVersion((char*)version));
 		xmlFree(version);
 	}
 	else
@@ -489,6 +501,203 @@ void XMLArchive::close() {
 }
 
 
+Core::BaseObject *XMLArchive::readStream(const char *filename) {
+	Core::BaseObject *object = nullptr;
+	if ( !readStream(filename, nullptr, nullptr, &object, nullptr) )
+		return nullptr;
+	return object;
+}
+
+
+size_t XMLArchive::readStream(const char *filename, const StreamCallback &callback) {
+	size_t count = 0;
+	if ( callback )
+		readStream(filename, nullptr, &callback, nullptr, &count);
+	return count;
+}
+
+
+size_t XMLArchive::readStream(std::streambuf *buf, const StreamCallback &callback) {
+	size_t count = 0;
+	if ( buf && callback )
+		readStream(nullptr, buf, &callback, nullptr, &count);
+	return count;
+}
+
+
+bool XMLArchive::readStream(const char *filename, std::streambuf *buf,
+                            const StreamCallback *callback,
+                            Core::BaseObject **object, size_t *count) {
+	close();
+
+	if ( buf ) {
+		_buf = buf;
+		_deleteOnClose = false;
+	}
+	else if ( !openFile(filename) ) {
+		close();
+		return false;
+	}
+
+	if ( !Seiscomp::Core::Archive::open(nullptr) ) {
+		close();
+		return false;
+	}
+
+	boost::iostreams::filtering_istreambuf filtered_buf;
+	void *context = _buf;
+
+	if ( _compression ) {
+		switch ( _compressionMethod ) {
+			case ZIP:
+				filtered_buf.push(boost::iostreams::zlib_decompressor());
+				break;
+			case GZIP:
+				filtered_buf.push(boost::iostreams::gzip_decompressor());
+				break;
+			default:
+				break;
+		}
+
+		filtered_buf.push(*_buf);
+		context = &filtered_buf;
+	}
+
+	xmlTextReaderPtr reader = xmlReaderForIO(streamBufReadCallback,
+	                                         streamBufCloseCallback,
+	                                         context, nullptr, nullptr, 0);
+	if ( reader == nullptr ) {
+		close();
+		return false;
+	}
+
+	// Locates the next element on the current level, returns false if
+	// the end of the parent element or of the document has been reached
+	auto nextElement = [reader](int ret) {
+		while ( ret == 1 ) {
+			int type = xmlTextReaderNodeType(reader);
+			if ( type == XML_READER_TYPE_ELEMENT ) return true;
+			if ( type == XML_READER_TYPE_END_ELEMENT ) return false;
+			ret = xmlTextReaderRead(reader);
+		}
+		return false;
+	};
+
+	// Unmanaged object which is returned if no callback is given
+	Core::BaseObject *container = nullptr;
+	xmlNodePtr holder = nullptr;
+	bool ok = nextElement(xmlTextReaderRead(reader));
+	bool empty = false;
+
+	setVersion(Core::Version(0,0));
+
+	if ( ok && !xmlStrcmp(xmlTextReaderConstLocalName(reader), (const xmlChar*)_rootTag.c_str()) ) {
+		xmlChar* version = xmlTextReaderGetAttribute(reader, (const xmlChar*)"version");
+		if ( version != nullptr ) {
+			setVersion(parseVersion((char*)version));
+			xmlFree(version);
+		}
+
+		const xmlChar *prefix = xmlTextReaderConstPrefix(reader);
+		if ( prefix != nullptr )
+			_namespace.first = (const char*)prefix;
+
+		const xmlChar *uri = xmlTextReaderConstNamespaceUri(reader);
+		if ( uri != nullptr )
+			_namespace.second = (const char*)uri;
+
+		// Move to the top-level object
+		ok = !xmlTextReaderIsEmptyElement(reader) &&
+		     nextElement(xmlTextReaderRead(reader));
+	}
+
+	if ( ok ) {
+		int depth = xmlTextReaderDepth(reader);
+		xmlNodePtr node = xmlTextReaderCurrentNode(reader);
+		empty = xmlTextReaderIsEmptyElement(reader);
+
+		// The children are deserialized one by one below a copy of the
+		// top-level element which holds its attributes
+		holder = xmlNewNode(nullptr, node->name);
+		holder->properties = xmlCopyPropList(holder, node->properties);
+
+		if ( !callback ) {
+			container = Core::ClassFactory::Create((const char*)node->name);
+			ok = container != nullptr;
+		}
+
+		int ret = empty ? 0 : xmlTextReaderRead(reader);
+
+		while ( ok && ret == 1 && xmlTextReaderDepth(reader) > depth ) {
+			if ( xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT ) {
+				ret = xmlTextReaderRead(reader);
+				continue;
+			}
+
+			xmlNodePtr child = xmlTextReaderExpand(reader);
+			if ( child == nullptr ) {
+				ret = -1;
+				break;
+			}
+
+			Core::BaseObjectPtr callbackTarget;
+			Core::BaseObject *target = container;
+			if ( callback ) {
+				callbackTarget = Core::ClassFactory::Create((const char*)holder->name);
+				target = callbackTarget.get();
+				if ( !target ) {
+					ok = false;
+					break;
+				}
+			}
+
+			xmlNodePtr copy = xmlCopyNode(child, 1);
+			xmlAddChild(holder, copy);
+
+			Seiscomp::Core::Archive::setValidity(true);
+			_objectLocation = holder;
+			serialize(target);
+
+			xmlUnlinkNode(copy);
+			xmlFreeNode(copy);
+
+			if ( callback ) {
+				++*count;
+				if ( !(*callback)(target) )
+					break;
+			}
+
+			// Skips the subtree and frees the nodes read so far
+			ret = xmlTextReaderNext(reader);
+		}
+
+		if ( ret < 0 )
+			ok = false;
+		else if ( ok && container && empty ) {
+			// Read the attributes of an object without children
+			Seiscomp::Core::Archive::setValidity(true);
+			_objectLocation = holder;
+			serialize(container);
+		}
+
+		xmlFreeNode(holder);
+	}
+
+	xmlFreeTextReader(reader);
+	close();
+
+	if ( !ok ) {
+		delete container;
+		return false;
+	}
+
+	if ( object )
+		*object = container;
+
+	return true;
+}
+
+
 const std::string& XMLArchive::rootNamespace() const {
 	return _namespace.first;
 }
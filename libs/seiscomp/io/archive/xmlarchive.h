@@ -24,6 +24,8 @@
 #include <seiscomp/core/io.h>
 #include <seiscomp/core.h>
 
+#include <functional>
+
 namespace Seiscomp {
 namespace IO {
 
@@ -39,6 +41,16 @@ class SC_SYSTEM_CORE_API XMLArchive : public Seiscomp::Core::Archive {
 			GZIP
 		};
 
+		/**
+		 * @brief Callback for streamed reading. It receives a newly created
+		 *        top-level object (e.g. EventParameters or Inventory) which
+		 *        holds exactly one of the children found in the document.
+		 *        The object is released after the callback returned unless
+		 *        it or its child is referenced elsewhere.
+		 * @return false to stop reading
+		 */
+		using StreamCallback = std::function<bool (Core::BaseObject *object)>;
+
 	// ----------------------------------------------------------------------
 	//  Xstruction
 	// ----------------------------------------------------------------------
@@ -73,6 +85,40 @@ class SC_SYSTEM_CORE_API XMLArchive : public Seiscomp::Core::Archive {
 		//! Implements derived virtual method
 		virtual void close();
 
+		/**
+		 * @brief Reads the top-level object of a document without building
+		 *        a DOM of the whole document. Only the subtree of the child
+		 *        currently deserialized is kept in memory which lowers the
+		 *        memory footprint for large files considerably.
+		 * @param filename The file to read, "-" for stdin
+		 * @return The object or nullptr in case of errors. The returned
+		 *         pointer is unmanaged and its ownership goes over to the
+		 *         caller.
+		 */
+		Core::BaseObject *readStream(const char *filename);
+
+		/**
+		 * @brief Reads a document without building a DOM and passes each
+		 *        child of the top-level object to a callback. Children
+		 *        which are not referenced by the callback are freed
+		 *        immediately and the memory consumption does not depend on
+		 *        the size of the document.
+		 * @param filename The file to read, "-" for stdin
+		 * @param callback The callback
+		 * @return The number of children passed to the callback
+		 */
+		size_t readStream(const char *filename, const StreamCallback &callback);
+
+		/**
+		 * @brief Same as readStream(const char*, const StreamCallback&) but
+		 *        reads the document from a streambuf, e.g. a payload
+		 *        received from the network.
+		 * @param buf The streambuf which is not managed by the archive
+		 * @param callback The callback
+		 * @return The number of children passed to the callback
+		 */
+		size_t readStream(std::streambuf *buf, const StreamCallback &callback);
+
 		//! Sets the root tagname to define the document entry.
 		//! The default tagname is "seiscomp"
 		void setRootName(const std::string &name);
@@ -225,9 +271,14 @@ class SC_SYSTEM_CORE_API XMLArchive : public Seiscomp::Core::Archive {
 	//  Implementation
 	// ----------------------------------------------------------------------
 	private:
+		bool openFile(const char *filename);
 		bool open();
 		bool create(bool writeVersion, bool headerNode);
 
+		bool readStream(const char *filename, std::streambuf *buf,
+		                const StreamCallback *callback,
+		                Core::BaseObject **object, size_t *count);
+
 		void addChild(const char* name, const char* type) const;
 		void* addRootNode(const char* name) const;
 		void writeAttrib(const std::string& value);
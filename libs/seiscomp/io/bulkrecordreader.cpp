@@ -0,0 +1,165 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/io/bulkrecordreader.h>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BulkRecordReader::BulkRecordReader() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BulkRecordReader::~BulkRecordReader() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t BulkRecordReader::read(RecordStream *rs, const Core::TimeWindow &tw) {
+	if ( !rs ) return 0;
+
+	size_t count = 0;
+	RecordPtr rec;
+
+	while ( (rec = rs->next()) ) {
+		auto &seq = _sequences[rec->streamID()];
+		if ( !seq ) {
+			if ( tw )
+				seq.reset(new TimeWindowBuffer(tw));
+			else
+				seq.reset(new RingBuffer(0));
+		}
+
+		if ( seq->feed(rec.get()) )
+			++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BulkRecordReader::clear() {
+	_sequences.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::vector<std::string> BulkRecordReader::streamIDs() const {
+	std::vector<std::string> ids;
+	ids.reserve(_sequences.size());
+	for ( const auto &item : _sequences )
+		ids.push_back(item.first);
+	return ids;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t BulkRecordReader::recordCount(const std::string &streamID) const {
+	const RecordSequence *seq = sequence(streamID);
+	return seq ? seq->size() : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const RecordSequence *
+BulkRecordReader::sequence(const std::string &streamID) const {
+	auto it = _sequences.find(streamID);
+	return it != _sequences.end() ? it->second.get() : nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+GenericRecord *
+BulkRecordReader::contiguousRecord(const std::string &streamID,
+                                   Array::DataType dataType,
+                                   bool interpolate) const {
+	const RecordSequence *seq = sequence(streamID);
+	if ( !seq || seq->empty() ) return nullptr;
+
+	switch ( dataType ) {
+		case Array::INT:
+			return seq->contiguousRecord<int>(nullptr, interpolate);
+		case Array::FLOAT:
+			return seq->contiguousRecord<float>(nullptr, interpolate);
+		case Array::DOUBLE:
+			return seq->contiguousRecord<double>(nullptr, interpolate);
+		default:
+			break;
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DoubleArray *BulkRecordReader::headers(const std::string &streamID) const {
+	const RecordSequence *seq = sequence(streamID);
+	if ( !seq ) return nullptr;
+
+	DoubleArray *hdr = new DoubleArray(static_cast<int>(seq->size() * HC_QUANTITY));
+	double *row = hdr->typedData();
+
+	for ( const RecordCPtr &rec : *seq ) {
+		row[HC_START_TIME] = static_cast<double>(rec->startTime());
+		row[HC_END_TIME] = static_cast<double>(rec->endTime());
+		row[HC_SAMPLING_FREQUENCY] = rec->samplingFrequency();
+		row[HC_SAMPLE_COUNT] = rec->sampleCount();
+		row[HC_TIMING_QUALITY] = rec->timingQuality();
+		row += HC_QUANTITY;
+	}
+
+	return hdr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
@@ -0,0 +1,142 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_BULKRECORDREADER_H
+#define SEISCOMP_IO_BULKRECORDREADER_H
+
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/io/recordstream.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+/**
+ * @brief The BulkRecordReader class reads all records of a record stream
+ *        and merges them per stream.
+ *
+ * It is meant for scripting languages where iterating over single
+ * records is expensive. The records of each stream are collected in a
+ * RecordSequence and handed out as one contiguous record. Gaps and
+ * overlaps are handled by RecordSequence::contiguousRecord. Additionally
+ * the headers of all records of a stream can be retrieved as a single
+ * array.
+ */
+class SC_SYSTEM_CORE_API BulkRecordReader {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! The columns of a row returned by headers()
+		enum HeaderColumn {
+			HC_START_TIME,
+			HC_END_TIME,
+			HC_SAMPLING_FREQUENCY,
+			HC_SAMPLE_COUNT,
+			HC_TIMING_QUALITY,
+			HC_QUANTITY
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		BulkRecordReader();
+		~BulkRecordReader();
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Reads all records of a record stream until it is
+		 *        exhausted. The records are added to the already read ones.
+		 * @param rs The record stream which must be configured already.
+		 * @param tw Optional time window. If valid then only the records
+		 *           overlapping the time window are kept.
+		 * @return The number of records added
+		 */
+		size_t read(RecordStream *rs,
+		            const Core::TimeWindow &tw = Core::TimeWindow());
+
+		//! Removes all read records
+		void clear();
+
+		//! Returns the ids of all read streams in lexicographical order
+		std::vector<std::string> streamIDs() const;
+
+		//! Returns the number of records of a stream
+		size_t recordCount(const std::string &streamID) const;
+
+		//! Returns the sequence of a stream or nullptr if nothing has been
+		//! read for it. The sequence is owned by the reader.
+		const RecordSequence *sequence(const std::string &streamID) const;
+
+		/**
+		 * @brief Merges all records of a stream into one record.
+		 * @param streamID The stream id
+		 * @param dataType The data type of the returned samples. Only
+		 *                 INT, FLOAT and DOUBLE are supported.
+		 * @param interpolate Whether gaps are linearly interpolated
+		 * @return The merged record which must be managed by the caller or
+		 *         nullptr if the stream is unknown or the data type is
+		 *         not supported.
+		 */
+		GenericRecord *contiguousRecord(const std::string &streamID,
+		                                Array::DataType dataType = Array::DOUBLE,
+		                                bool interpolate = false) const;
+
+		/**
+		 * @brief Returns the headers of all records of a stream in order.
+		 * Each record occupies HC_QUANTITY consecutive values, see
+		 * HeaderColumn. Times are given as seconds since epoch.
+		 * @param streamID The stream id
+		 * @return The headers which must be managed by the caller or nullptr
+		 *         if the stream is unknown.
+		 */
+		DoubleArray *headers(const std::string &streamID) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		using Sequences = std::map<std::string, std::unique_ptr<RecordSequence>>;
+
+		Sequences _sequences;
+};
+
+
+}
+}
+
+
+#endif
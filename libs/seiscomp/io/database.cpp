@@ -252,6 +252,113 @@ std::string DatabaseInterface::convertColumnName(const std::string& name) const
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseInterface::bindParameters(std::string &out, const char *command,
+                                       const Parameters &params) const {
+	out.clear();
+
+	size_t index = 0;
+	bool quoted = false;
+	std::string escaped;
+
+	for ( const char *c = command; *c; ++c ) {
+		if ( *c == '\'' )
+			quoted = !quoted;
+		else if ( *c == '?' && !quoted ) {
+			if ( index >= params.size() ) {
+				SEISCOMP_ERROR("bind: missing parameter %d in: %s",
+				               static_cast<int>(index+1), command);
+				return false;
+			}
+
+			const Parameter &param = params[index++];
+			switch ( param.type ) {
+				case Parameter::Integer:
+					out += Core::toString(param.integer);
+					break;
+				case Parameter::Float:
+					out += Core::toString(param.number);
+					break;
+				case Parameter::Text:
+					if ( !escape(escaped, param.text) )
+						return false;
+					out += '\'';
+					out += escaped;
+					out += '\'';
+					break;
+				default:
+					out += "NULL";
+					break;
+			}
+
+			continue;
+		}
+
+		out += *c;
+	}
+
+	if ( index != params.size() ) {
+		SEISCOMP_ERROR("bind: %d parameters given but %d placeholders found in: %s",
+		               static_cast<int>(params.size()), static_cast<int>(index),
+		               command);
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseInterface::execute(const char *command, const Parameters &params) {
+	std::string statement;
+	if ( !command || !bindParameters(statement, command, params) )
+		return false;
+
+	return execute(statement.c_str());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseInterface::beginQuery(const char *query, const Parameters &params) {
+	std::string statement;
+	if ( !query || !bindParameters(statement, query, params) )
+		return false;
+
+	return beginQuery(statement.c_str());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseInterface::getRowFieldValue(int index, int64_t &value) {
+	const char *data = static_cast<const char*>(getRowField(index));
+	if ( !data ) return false;
+	return Core::fromString(value, data);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DatabaseInterface::getRowFieldValue(int index, double &value) {
+	const char *data = static_cast<const char*>(getRowField(index));
+	if ( !data ) return false;
+	return Core::fromString(value, data);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 std::string DatabaseInterface::getRowFieldString(int index) {
 	const void *data = getRowField(index);
@@ -81,6 +81,31 @@ DEFINE_SMARTPOINTER(DatabaseInterface);
 		typedef uint64_t OID;
 		static const OID INVALID_OID;
 
+		//! A value bound to a '?' placeholder of a statement
+		struct Parameter {
+			enum Type {
+				Null,
+				Integer,
+				Float,
+				Text
+			};
+
+			Parameter() = default;
+			Parameter(int value) : type(Integer), integer(value) {}
+			Parameter(int64_t value) : type(Integer), integer(value) {}
+			Parameter(uint64_t value) : type(Integer), integer(static_cast<int64_t>(value)) {}
+			Parameter(double value) : type(Float), number(value) {}
+			Parameter(const char *value) : type(Text), text(value) {}
+			Parameter(std::string value) : type(Text), text(std::move(value)) {}
+
+			Type        type{Null};
+			int64_t     integer{0};
+			double      number{0};
+			std::string text;
+		};
+
+		typedef std::vector<Parameter> Parameters;
+
 
 	// ------------------------------------------------------------------
 	//  Xstruction
@@ -160,6 +185,25 @@ DEFINE_SMARTPOINTER(DatabaseInterface);
 		//! Ends a query after its results are not needed anymore
 		virtual void endQuery() = 0;
 
+		/** Executes a SQL command with parameters bound to its '?'
+		    placeholders. Drivers prepare the command once per connection
+		    and reuse it for subsequent calls with the same command text,
+		    so the command should not contain variable literals.
+		    The default implementation substitutes the escaped parameters
+		    into the command text and calls execute(const char*).
+		    @return False, if the command has not been executed because
+		            of errors.
+		  */
+		virtual bool execute(const char* command, const Parameters &params);
+
+		/** Starts a SQL query with parameters bound to its '?'
+		    placeholders. The results are fetched with fetchRow and
+		    getRowField like for beginQuery(const char*) and the query must
+		    be ended with endQuery. See execute(const char*, const Parameters&)
+		    for details.
+		  */
+		virtual bool beginQuery(const char* query, const Parameters &params);
+
 		/** Returns the default value name for the 'insert into' statement.
 		    This is needed because sqlite3 does not support
 		    \code
@@ -236,6 +280,17 @@ DEFINE_SMARTPOINTER(DatabaseInterface);
 		  */
 		virtual const void *getRowField(int index) = 0;
 
+		/** Returns the integer content of an indexed field of a fetched
+		    row. Drivers with typed result access return the value without
+		    a conversion to text. The default implementation parses the
+		    text returned by getRowField.
+		    @return False if the field is NULL or not an integer.
+		  */
+		virtual bool getRowFieldValue(int index, int64_t &value);
+
+		//! Same as getRowFieldValue(int, int64_t&) for floating point values
+		virtual bool getRowFieldValue(int index, double &value);
+
 		/**
 		 * Convenience method to return the string of a certain column
 		 * @param index The field index (column)
@@ -301,6 +356,12 @@ DEFINE_SMARTPOINTER(DatabaseInterface);
 		virtual bool handleURIParameter(const std::string &name,
 		                                const std::string &value);
 
+		//! Returns the command with all '?' placeholders outside of
+		//! quoted literals replaced by the escaped parameters. Returns
+		//! false if the number of placeholders does not match.
+		bool bindParameters(std::string &out, const char *command,
+		                    const Parameters &params) const;
+
 		//! This method has to be implemented in derived classes to
 		//! connect to the database using the members _user, _password,
 		//! _host, _port and _database
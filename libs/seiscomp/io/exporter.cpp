@@ -84,6 +84,7 @@ IMPLEMENT_SC_ABSTRACT_CLASS(Exporter, "Exporter");
 Exporter::Exporter() {
 	_prettyPrint = false;
 	_indentation = 2;
+	_threads = 1;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -125,6 +126,15 @@ void Exporter::setIndent(int i) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Exporter::setThreads(int threads) {
+	_threads = threads > 0 ? threads : 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Exporter::write(std::streambuf* buf, Core::BaseObject *obj) {
 	return put(buf, obj);
@@ -77,6 +77,17 @@ class SC_SYSTEM_CORE_API Exporter : public Core::BaseObject {
 		void setFormattedOutput(bool enable);
 		void setIndent(int);
 
+		/**
+		 * @brief Sets the number of threads used to serialize independent
+		 *        objects, e.g. the events of an EventParameters object.
+		 *
+		 * The output is the same as with a single thread. Exporters
+		 * which do not support parallel serialization ignore this
+		 * setting.
+		 * @param threads The number of threads, default is 1
+		 */
+		void setThreads(int threads);
+
 		bool write(std::streambuf* buf, Core::BaseObject *);
 		bool write(std::string filename, Core::BaseObject *);
 
@@ -109,6 +120,7 @@ class SC_SYSTEM_CORE_API Exporter : public Core::BaseObject {
 	protected:
 		bool _prettyPrint;
 		int  _indentation;
+		int  _threads;
 };
 
 
@@ -22,8 +22,16 @@
 
 #include <seiscomp/logging/log.h>
 #include <seiscomp/io/gfarchive.h>
+#include <seiscomp/core/greensfunction.h>
 #include <seiscomp/core/interfacefactory.ipp>
 
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
 #include <string.h>
 
 
@@ -35,13 +43,145 @@ namespace IO {
 
 
 IMPLEMENT_SC_ABSTRACT_CLASS(GFArchive, "GFArchive");
+
+
+namespace {
+
+
+Core::GreensFunction *copy(const Core::GreensFunction *gf) {
+	Core::GreensFunction *result = new Core::GreensFunction(
+		gf->model(), gf->distance(), gf->depth(),
+		gf->samplingFrequency(), gf->timeOffset()
+	);
+
+	result->setId(gf->id());
+
+	for ( int i = 0; i < Core::GreensFunctionComponent::Quantity; ++i ) {
+		Array *data = gf->data(i);
+		if ( data ) {
+			ArrayPtr clone = data->clone();
+			result->setData(i, clone.get());
+		}
+	}
+
+	return result;
+}
+
+
+size_t memoryUsage(const Core::GreensFunction *gf) {
+	size_t bytes = sizeof(Core::GreensFunction);
+
+	for ( int i = 0; i < Core::GreensFunctionComponent::Quantity; ++i ) {
+		Array *data = gf->data(i);
+		if ( data )
+			bytes += static_cast<size_t>(data->size()) * data->elementSize();
+	}
+
+	return bytes;
+}
+
+
+}
+
+
+/**
+ * @brief Least recently used Green's functions with a memory limit.
+ */
+struct GFArchive::Cache {
+	typedef std::tuple<std::string, double, double, Core::TimeSpan> Key;
+
+	struct Entry {
+		Key                     key;
+		Core::GreensFunctionPtr gf;
+		size_t                  bytes;
+	};
+
+	typedef std::list<Entry> Entries;
+
+	void shrink(size_t bytes) {
+		while ( (size > bytes) && !entries.empty() ) {
+			size -= entries.back().bytes;
+			lookup.erase(entries.back().key);
+			entries.pop_back();
+		}
+	}
+
+	std::mutex                           mutex;
+	// The most recently used entry is the first one
+	Entries                              entries;
+	std::map<Key, Entries::iterator>     lookup;
+	size_t                               limit{0};
+	size_t                               size{0};
+};
+
+
+
+/**
+ * @brief Worker threads which run fetches and collect their results.
+ */
+struct GFArchive::Fetcher {
+	~Fetcher() {
+		cancel();
+	}
+
+	void run() {
+		std::unique_lock<std::mutex> l(mutex);
+
+		while ( !pending.empty() ) {
+			Fetch fetch = std::move(pending.front());
+			pending.pop_front();
+			l.unlock();
+
+			Core::GreensFunction *gf = nullptr;
+			try {
+				gf = fetch();
+			}
+			catch ( std::exception &e ) {
+				SEISCOMP_ERROR("Green's functions - fetch failed: %s", e.what());
+			}
+
+			l.lock();
+			if ( gf ) done.push_back(gf);
+			cond.notify_all();
+		}
+
+		--running;
+		cond.notify_all();
+	}
+
+	void join() {
+		for ( auto &worker : workers )
+			worker.join();
+		workers.clear();
+	}
+
+	void cancel() {
+		{
+			std::unique_lock<std::mutex> l(mutex);
+			pending.clear();
+			cond.wait(l, [this] { return running == 0; });
+			for ( auto gf : done )
+				delete gf;
+			done.clear();
+		}
+
+		join();
+	}
+
+	std::mutex                         mutex;
+	std::condition_variable            cond;
+	std::deque<Fetch>                  pending;
+	std::deque<Core::GreensFunction*>  done;
+	std::vector<std::thread>           workers;
+	size_t                             running{0};
+};
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-GFArchive::GFArchive() {}
+GFArchive::GFArchive() : _cache(new Cache), _fetcher(new Fetcher) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -128,6 +268,148 @@ std::list<double> GFArchive::availableDepths(const std::string &model) const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GFArchive::setCacheLimit(size_t bytes) {
+	std::lock_guard<std::mutex> l(_cache->mutex);
+	_cache->limit = bytes;
+	_cache->shrink(bytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t GFArchive::cacheLimit() const {
+	std::lock_guard<std::mutex> l(_cache->mutex);
+	return _cache->limit;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t GFArchive::cacheSize() const {
+	std::lock_guard<std::mutex> l(_cache->mutex);
+	return _cache->size;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GFArchive::clearCache() {
+	std::lock_guard<std::mutex> l(_cache->mutex);
+	_cache->shrink(0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GFArchive::setThreads(size_t threads) {
+	_threads = threads > 0 ? threads : 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunction *GFArchive::cached(const std::string &model,
+                                        double depth, double distance,
+                                        const Core::TimeSpan &span) const {
+	std::lock_guard<std::mutex> l(_cache->mutex);
+	if ( _cache->lookup.empty() )
+		return nullptr;
+
+	auto it = _cache->lookup.find(Cache::Key(model, depth, distance, span));
+	if ( it == _cache->lookup.end() )
+		return nullptr;
+
+	_cache->entries.splice(_cache->entries.begin(), _cache->entries, it->second);
+	return copy(it->second->gf.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GFArchive::cache(const std::string &model, double depth, double distance,
+                      const Core::TimeSpan &span, const Core::GreensFunction *gf) {
+	std::lock_guard<std::mutex> l(_cache->mutex);
+	if ( !_cache->limit )
+		return;
+
+	size_t bytes = memoryUsage(gf);
+	if ( bytes > _cache->limit )
+		return;
+
+	Cache::Key key(model, depth, distance, span);
+	auto it = _cache->lookup.find(key);
+	if ( it != _cache->lookup.end() ) {
+		_cache->size -= it->second->bytes;
+		_cache->entries.erase(it->second);
+		_cache->lookup.erase(it);
+	}
+
+	_cache->shrink(_cache->limit - bytes);
+	_cache->entries.push_front(Cache::Entry{key, copy(gf), bytes});
+	_cache->lookup[key] = _cache->entries.begin();
+	_cache->size += bytes;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunction *GFArchive::fetchConcurrently(std::vector<Fetch> &fetches) {
+	std::unique_lock<std::mutex> l(_fetcher->mutex);
+
+	for ( auto &fetch : fetches )
+		_fetcher->pending.push_back(std::move(fetch));
+	fetches.clear();
+
+	while ( (_fetcher->running < _threads)
+	     && (_fetcher->running < _fetcher->pending.size()) ) {
+		++_fetcher->running;
+		_fetcher->workers.emplace_back(&Fetcher::run, _fetcher.get());
+	}
+
+	_fetcher->cond.wait(l, [this] {
+		return !_fetcher->done.empty() || !_fetcher->running;
+	});
+
+	if ( _fetcher->done.empty() ) {
+		// All fetches have been completed
+		l.unlock();
+		_fetcher->join();
+		return nullptr;
+	}
+
+	Core::GreensFunction *gf = _fetcher->done.front();
+	_fetcher->done.pop_front();
+	return gf;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GFArchive::cancelFetches() {
+	_fetcher->cancel();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
@@ -27,6 +27,10 @@
 #include <seiscomp/math/coord.h>
 #include <seiscomp/core.h>
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 
 namespace Seiscomp {
 
@@ -120,13 +124,86 @@ class SC_SYSTEM_CORE_API GFArchive : public Core::BaseObject {
 
 		bool hasLocalTravelTimes() const { return _hasLocalTravelTimes; }
 
+		/**
+		 * @brief Sets the memory limit of the cache of Green's functions.
+		 *
+		 * Archives which support the cache keep the Green's functions they
+		 * have read and interpolated keyed by model, depth, distance and
+		 * timespan. A repeated request is served with a copy of the cached
+		 * function without accessing the archive again. If the limit is
+		 * exceeded the least recently used functions are dropped.
+		 * @param bytes The limit in bytes, 0 disables the cache which is
+		 *              the default.
+		 */
+		void setCacheLimit(size_t bytes);
+		size_t cacheLimit() const;
+
+		//! Returns the number of bytes used by the cache
+		size_t cacheSize() const;
+
+		//! Removes all Green's functions from the cache
+		void clearCache();
+
+		/**
+		 * @brief Sets the number of threads which resolve the requests.
+		 *
+		 * Archives which support it read and interpolate all queued
+		 * requests concurrently. get() then returns the Green's functions
+		 * in the order they have been completed rather than in the order
+		 * of the requests. Use the id to assign them.
+		 * @param threads The number of threads, 1 by default
+		 */
+		void setThreads(size_t threads);
+		size_t threads() const { return _threads; }
+
 
 	public:
 		static GFArchive* Create(const char* service);
 		static GFArchive* Open(const char* url);
 
+	protected:
+		/**
+		 * @brief Returns a copy of a cached Green's function.
+		 * @return The copy which is owned by the caller or nullptr if the
+		 *         function is not cached.
+		 */
+		Core::GreensFunction *cached(const std::string &model,
+		                             double depth, double distance,
+		                             const Core::TimeSpan &span) const;
+
+		//! Stores a copy of a Green's function in the cache if enabled
+		void cache(const std::string &model, double depth, double distance,
+		           const Core::TimeSpan &span, const Core::GreensFunction *gf);
+
+		//! Resolves a single request and returns its Green's function or
+		//! nullptr on failure.
+		typedef std::function<Core::GreensFunction*()> Fetch;
+
+		/**
+		 * @brief Runs fetches on the worker threads and returns the next
+		 *        completed Green's function.
+		 *
+		 * The fetches are appended to the ones still pending. Fetches which
+		 * fail are skipped.
+		 * @return The Green's function which is owned by the caller or
+		 *         nullptr if all fetches have been completed.
+		 */
+		Core::GreensFunction *fetchConcurrently(std::vector<Fetch> &fetches);
+
+		//! Drops all pending fetches and waits for the running ones. This
+		//! must be called before the fetches become invalid, e.g. in the
+		//! destructor of a derived class.
+		void cancelFetches();
+
 	protected:
 		bool _hasLocalTravelTimes{false};
+
+	private:
+		struct Cache;
+		struct Fetcher;
+		std::unique_ptr<Cache>   _cache;
+		std::unique_ptr<Fetcher> _fetcher;
+		size_t                   _threads{1};
 };
 
 
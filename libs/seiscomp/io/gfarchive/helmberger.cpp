@@ -106,6 +106,35 @@ HelmbergerArchive::~HelmbergerArchive() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool HelmbergerArchive::setSource(std::string source) {
+	size_t pos = source.find('?');
+	if ( pos != std::string::npos ) {
+		std::vector<std::string> toks;
+		Core::split(toks, source.substr(pos+1).c_str(), "&");
+		source.erase(pos);
+
+		for ( const std::string &tok : toks ) {
+			std::string name = tok, value;
+			size_t p = tok.find('=');
+			if ( p != std::string::npos ) {
+				name = tok.substr(0, p);
+				value = tok.substr(p+1);
+			}
+
+			if ( name == "cache" ) {
+				size_t megabytes;
+				if ( !Core::fromString(megabytes, value) ) {
+					SEISCOMP_ERROR("Invalid cache size: %s", value.c_str());
+					return false;
+				}
+				setCacheLimit(megabytes * 1024 * 1024);
+			}
+			else if ( !name.empty() ) {
+				SEISCOMP_ERROR("Invalid option: %s", tok.c_str());
+				return false;
+			}
+		}
+	}
+
 	fs::path directory;
 	try {
 		directory = SC_FS_PATH(source);
@@ -187,8 +216,10 @@ bool HelmbergerArchive::setSource(std::string source) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void HelmbergerArchive::close() {
+	cancelFetches();
 	_requests.clear();
 	_models.clear();
+	clearCache();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -304,170 +335,197 @@ bool HelmbergerArchive::addRequest(const std::string &id,
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Core::GreensFunction* HelmbergerArchive::get() {
+	if ( threads() > 1 ) {
+		std::vector<Fetch> fetches;
+		for ( const Request &req : _requests )
+			fetches.push_back([this, req]() { return fetch(req); });
+		_requests.clear();
+		return fetchConcurrently(fetches);
+	}
+
 	while ( !_requests.empty() ) {
 		Request req = _requests.front();
 		_requests.pop_front();
 
-		std::string modelprefix = req.model/* + "_efl"*/;
-		std::string pathprefix = _baseDirectory + "/" + modelprefix + "/" +
-		                         modelprefix/* + "_tmp"*/;
+		Core::GreensFunction *gf = fetch(req);
+		if ( gf ) return gf;
+	}
 
-		int distKm = (int)req.distance;
-		int iDepth = (int)req.depth;
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		ModelMap::iterator mit = _models.find(req.model);
-		if ( mit == _models.end() ) {
-			SEISCOMP_DEBUG("Green's functions - helmberger: req dropped, model %s not available",
-			                req.model.c_str());
-			continue;
-		}
 
-		DoubleList::iterator lbdist = mit->second.distances.lower_bound(distKm);
-		DoubleList::iterator ubdist = lbdist--;
-		DoubleList::iterator lbdep = mit->second.depths.lower_bound(req.depth);
-		DoubleList::iterator ubdep = lbdep--;
 
-		double dist1, dist2, dist;
-		double dep1, dep2, dep;
 
-		// Distance is lower than the first stored value
-		if ( ubdist == mit->second.distances.begin() ) {
-			dist1 = *ubdist;
-			++ubdist;
-			dist2 = *ubdist;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunction* HelmbergerArchive::fetch(const Request &req) {
+	std::string modelprefix = req.model/* + "_efl"*/;
+	std::string pathprefix = _baseDirectory + "/" + modelprefix + "/" +
+	                         modelprefix/* + "_tmp"*/;
 
-			double maxDistError = dist2 - dist1;
-			if ( dist1 - distKm > maxDistError ) {
-				SEISCOMP_DEBUG("Green's functions - helmberger: distance too low: %d km", distKm);
-				continue;
-			}
+	int distKm = (int)req.distance;
+	int iDepth = (int)req.depth;
 
-			dist2 = dist1;
-		}
-		// Distance is greater than the last stored value
-		else if ( ubdist == mit->second.distances.end() ) {
-			dist2 = *lbdist;
-			--lbdist;
-			dist1 = *lbdist;
-
-			double maxDistError = dist2 - dist1;
-			if ( distKm - dist2 > maxDistError ) {
-				SEISCOMP_DEBUG("Green's functions - helmberger: distance too high: %d km", distKm);
-				continue;
-			}
+	Core::TimeSpan ts = _defaultTimespan;
+	if ( req.timeSpan ) ts = req.timeSpan;
 
-			dist2 = dist1;
-		}
-		else {
-			dist1 = *lbdist;
-			dist2 = *ubdist;
-		}
+	Core::GreensFunction *cachedGF = cached(req.model, iDepth, distKm, ts);
+	if ( cachedGF ) {
+		cachedGF->setId(req.id);
+		return cachedGF;
+	}
 
-		// Depth is lower than the first stored value
-		if ( ubdep == mit->second.depths.begin() ) {
-			dep1 = dep2 = *ubdep;
+	ModelMap::iterator mit = _models.find(req.model);
+	if ( mit == _models.end() ) {
+		SEISCOMP_DEBUG("Green's functions - helmberger: req dropped, model %s not available",
+		                req.model.c_str());
+		return nullptr;
+	}
 
-			dep1 = *ubdep;
-			++ubdep;
-			dep2 = *ubdep;
+	DoubleList::iterator lbdist = mit->second.distances.lower_bound(distKm);
+	DoubleList::iterator ubdist = lbdist--;
+	DoubleList::iterator lbdep = mit->second.depths.lower_bound(req.depth);
+	DoubleList::iterator ubdep = lbdep--;
 
-			double maxDepError = dep2 - dep1;
-			if ( dep1 - iDepth > maxDepError ) {
-				SEISCOMP_DEBUG("Green's functions - helmberger: depth too low: %d km", iDepth);
-				continue;
-			}
+	double dist1, dist2, dist;
+	double dep1, dep2, dep;
 
-			dep2 = dep1;
+	// Distance is lower than the first stored value
+	if ( ubdist == mit->second.distances.begin() ) {
+		dist1 = *ubdist;
+		++ubdist;
+		dist2 = *ubdist;
 
+		double maxDistError = dist2 - dist1;
+		if ( dist1 - distKm > maxDistError ) {
+			SEISCOMP_DEBUG("Green's functions - helmberger: distance too low: %d km", distKm);
+			return nullptr;
 		}
-		// Depth is greater than the last stored value
-		else if ( ubdep == mit->second.depths.end() ) {
-			dep2 = *lbdep;
-			--lbdep;
-			dep1 = *lbdep;
-
-			double maxDepError = dep2 - dep1;
-			if ( iDepth - dep2 > maxDepError ) {
-				SEISCOMP_DEBUG("Green's functions - helmberger: depth too high: %d km", iDepth);
-				continue;
-			}
 
-			dep2 = dep1;
-		}
-		else {
-			dep1 = *lbdep;
-			dep2 = *ubdep;
+		dist2 = dist1;
+	}
+	// Distance is greater than the last stored value
+	else if ( ubdist == mit->second.distances.end() ) {
+		dist2 = *lbdist;
+		--lbdist;
+		dist1 = *lbdist;
+
+		double maxDistError = dist2 - dist1;
+		if ( distKm - dist2 > maxDistError ) {
+			SEISCOMP_DEBUG("Green's functions - helmberger: distance too high: %d km", distKm);
+			return nullptr;
 		}
 
-		if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
-			dist = dist1;
-		}
-		else {
-			dist = dist2;
-		}
+		dist2 = dist1;
+	}
+	else {
+		dist1 = *lbdist;
+		dist2 = *ubdist;
+	}
 
-		if ( fabs(iDepth - dep1) < fabs(iDepth - dep2) ) {
-			dep = dep1;
-		}
-		else {
-			dep = dep2;
+	// Depth is lower than the first stored value
+	if ( ubdep == mit->second.depths.begin() ) {
+		dep1 = dep2 = *ubdep;
+
+		dep1 = *ubdep;
+		++ubdep;
+		dep2 = *ubdep;
+
+		double maxDepError = dep2 - dep1;
+		if ( dep1 - iDepth > maxDepError ) {
+			SEISCOMP_DEBUG("Green's functions - helmberger: depth too low: %d km", iDepth);
+			return nullptr;
 		}
 
-		/*
-		if ( fabs(depError) > maxDepError || fabs(distError) > maxDistError ) {
+		dep2 = dep1;
+
+	}
+	// Depth is greater than the last stored value
+	else if ( ubdep == mit->second.depths.end() ) {
+		dep2 = *lbdep;
+		--lbdep;
+		dep1 = *lbdep;
+
+		double maxDepError = dep2 - dep1;
+		if ( iDepth - dep2 > maxDepError ) {
+			SEISCOMP_DEBUG("Green's functions - helmberger: depth too high: %d km", iDepth);
+			return nullptr;
 		}
-		*/
 
-		Core::TimeSpan ts = _defaultTimespan;
-		if ( req.timeSpan ) ts = req.timeSpan;
+		dep2 = dep1;
+	}
+	else {
+		dep1 = *lbdep;
+		dep2 = *ubdep;
+	}
 
-		double ofs = _models[req.model].velocity != 0?dist / _models[req.model].velocity:0;
+	if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
+		dist = dist1;
+	}
+	else {
+		dist = dist2;
+	}
 
-		if ( dist1 == dist || dist2 == dist ) {
-			std::string file = pathprefix + Core::toString(dist) + "d" + Core::toString(dep) + ".disp";
-			//std::cout << file << std::endl;
+	if ( fabs(iDepth - dep1) < fabs(iDepth - dep2) ) {
+		dep = dep1;
+	}
+	else {
+		dep = dep2;
+	}
 
-			Core::GreensFunction *gf = read(file, ts, ofs);
-			if ( gf ) {
-				gf->setId(req.id);
-				gf->setModel(req.model);
-				gf->setDepth(dep);
-				gf->setDistance(dist);
-				//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf->distance(), gf->timeOffset());
-				return gf;
-			}
+	/*
+	if ( fabs(depError) > maxDepError || fabs(distError) > maxDistError ) {
+	}
+	*/
+
+	double ofs = mit->second.velocity != 0?dist / mit->second.velocity:0;
+
+	if ( dist1 == dist || dist2 == dist ) {
+		std::string file = pathprefix + Core::toString(dist) + "d" + Core::toString(dep) + ".disp";
+		//std::cout << file << std::endl;
+
+		Core::GreensFunction *gf = read(file, ts, ofs);
+		if ( gf ) {
+			gf->setId(req.id);
+			gf->setModel(req.model);
+			gf->setDepth(dep);
+			gf->setDistance(dist);
+			//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf->distance(), gf->timeOffset());
+			cache(req.model, iDepth, distKm, ts, gf);
+			return gf;
 		}
-		else {
-			std::string file = pathprefix + Core::toString(dist1) + "d" + Core::toString(dep) + ".disp";
-			Core::GreensFunction *gf1 = read(file, ts, ofs);
+	}
+	else {
+		std::string file = pathprefix + Core::toString(dist1) + "d" + Core::toString(dep) + ".disp";
+		Core::GreensFunction *gf1 = read(file, ts, ofs);
 
-			file = pathprefix + Core::toString(dist2) + "d" + Core::toString(dep) + ".disp";
-			Core::GreensFunction *gf2 = read(file, ts, ofs);
+		file = pathprefix + Core::toString(dist2) + "d" + Core::toString(dep) + ".disp";
+		Core::GreensFunction *gf2 = read(file, ts, ofs);
 
-			if ( gf1 && gf2 ) {
-				gf1->setId(req.id);
-				gf1->setModel(req.model);
-				gf1->setDepth(dep);
-				gf1->setDistance(distKm);
+		if ( gf1 && gf2 ) {
+			gf1->setId(req.id);
+			gf1->setModel(req.model);
+			gf1->setDepth(dep);
+			gf1->setDistance(distKm);
 
-				interpolate(gf1, gf2, distKm, dist1, dist2);
-				delete gf2;
+			interpolate(gf1, gf2, distKm, dist1, dist2);
+			delete gf2;
 
-				//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf1->distance(), gf1->timeOffset());
-				return gf1;
-			}
-			else {
-				SEISCOMP_ERROR("Green's functions - Unable to read %s or %s",
-				               (pathprefix + Core::toString(dist1) + "d" + Core::toString(dep) + ".disp").c_str(),
-				               file.c_str());
-				if ( gf1 ) delete gf1;
-				if ( gf2 ) delete gf2;
-			}
+			//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf1->distance(), gf1->timeOffset());
+			cache(req.model, iDepth, distKm, ts, gf1);
+			return gf1;
+		}
+		else {
+			SEISCOMP_ERROR("Green's functions - Unable to read %s or %s",
+			               (pathprefix + Core::toString(dist1) + "d" + Core::toString(dep) + ".disp").c_str(),
+			               file.c_str());
+			if ( gf1 ) delete gf1;
+			if ( gf2 ) delete gf2;
 		}
-
-		//SEISCOMP_DEBUG("No greensfunction found");
 	}
 
+	//SEISCOMP_DEBUG("No greensfunction found");
 	return nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
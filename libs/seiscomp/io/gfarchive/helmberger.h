@@ -35,6 +35,14 @@ namespace Seiscomp {
 namespace IO {
 
 
+/**
+ * @brief The HelmbergerArchive class reads Green's functions from a
+ *        directory of Helmberger files per model.
+ *
+ * The source is the base directory which can be followed by the option
+ * "cache=N" to keep the interpolated Green's functions up to N megabytes,
+ * e.g. "/data/gf?cache=512", see GFArchive::setCacheLimit.
+ */
 class SC_SYSTEM_CORE_API HelmbergerArchive : public GFArchive {
 	// ----------------------------------------------------------------------
 	//  Xstruction
@@ -102,6 +110,11 @@ class SC_SYSTEM_CORE_API HelmbergerArchive : public GFArchive {
 		};
 
 		typedef std::list<Request> RequestList;
+
+		//! Reads and interpolates the Green's function of a request. This
+		//! is called concurrently if more than one thread is used.
+		Core::GreensFunction* fetch(const Request &req);
+
 		typedef std::set<double> DoubleList;
 
 		struct ModelConfig {
@@ -86,6 +86,7 @@ Instaseis::~Instaseis() {
 bool Instaseis::setSource(string source) {
 	// Close socket
 	_socket.close();
+	clearCache();
 
 	_path = string();
 	_hasInfo = false;
@@ -138,6 +139,14 @@ bool Instaseis::setSource(string source) {
 						return false;
 					}
 				}
+				else if ( name == "cache" ) {
+					size_t megabytes;
+					if ( !Core::fromString(megabytes, value) ) {
+						SEISCOMP_ERROR("Invalid value for 'cache': %s", value.c_str());
+						return false;
+					}
+					setCacheLimit(megabytes * 1024 * 1024);
+				}
 			}
 		}
 	}
@@ -523,16 +532,22 @@ Core::GreensFunction *Instaseis::get() {
 		Request req = _requests.front();
 		_requests.pop_front();
 
+		double ts = _defaultTimespan;
+		if ( req.timeSpan ) ts = req.timeSpan;
+
+		if ( (_maxLength > 0) && (ts >= _maxLength) )
+			ts = _maxLength;
+
+		Core::GreensFunction *cachedGF = cached(_model, req.depth, req.distance, Core::TimeSpan(ts));
+		if ( cachedGF ) {
+			cachedGF->setId(req.id);
+			return cachedGF;
+		}
+
 		try {
 			if ( !_socket.isOpen() || _socket.tryReconnect() )
 				_socket.open(_host);
 
-			double ts = _defaultTimespan;
-			if ( req.timeSpan ) ts = req.timeSpan;
-
-			if ( (_maxLength > 0) && (ts >= _maxLength) )
-				ts = _maxLength;
-
 			string timespan = ts > 0 ? ("&endtime=" + Core::toString((double)ts)) : "";
 			string request = "GET " + _path + "greens_function"
 			                 "?sourcedepthinmeters=" + Core::toString(req.depth*1000) +
@@ -659,6 +674,7 @@ Core::GreensFunction *Instaseis::get() {
 			gf->setTimeOffset(_srcShift);
 			gf->setModel(_model);
 
+			cache(_model, req.depth, req.distance, Core::TimeSpan(ts), gf);
 			return gf;
 		}
 		catch ( std::exception &e ) {
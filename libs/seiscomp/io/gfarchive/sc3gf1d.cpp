@@ -33,6 +33,11 @@
 #include <rapidjson/document.h>
 #include <rapidjson/istreamwrapper.h>
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <iostream>
 #include <fstream>
 
@@ -125,6 +130,77 @@ double getValue(const std::map<double, double> &map, double ref) {
 }
 
 
+/**
+ * @brief Read-only memory mapping of a file together with a stream to
+ *        read from it.
+ */
+class MappedFile : private std::streambuf {
+	public:
+		MappedFile() : stream(this) {}
+		~MappedFile() {
+			if ( _data ) munmap(_data, _size);
+		}
+
+		bool open(const std::string &filename) {
+			int fd = ::open(filename.c_str(), O_RDONLY);
+			if ( fd < 0 ) return false;
+
+			struct stat st;
+			if ( fstat(fd, &st) != 0 || st.st_size <= 0 ) {
+				::close(fd);
+				return false;
+			}
+
+			void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+
+			if ( addr == MAP_FAILED ) return false;
+
+			_data = static_cast<char*>(addr);
+			_size = st.st_size;
+			setg(_data, _data, _data + _size);
+			return true;
+		}
+
+	protected:
+		pos_type seekoff(off_type ofs, std::ios_base::seekdir dir,
+		                 std::ios_base::openmode mode) override {
+			char *next;
+
+			switch ( dir ) {
+				case std::ios_base::beg:
+					next = eback() + ofs;
+					break;
+				case std::ios_base::cur:
+					next = gptr() + ofs;
+					break;
+				case std::ios_base::end:
+					next = egptr() + ofs;
+					break;
+				default:
+					return pos_type(off_type(-1));
+			}
+
+			if ( next > egptr() || next < eback() )
+				return pos_type(off_type(-1));
+
+			setg(eback(), next, egptr());
+			return pos_type(next - eback());
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override {
+			return seekoff(off_type(pos), std::ios_base::beg, mode);
+		}
+
+	public:
+		std::istream stream;
+
+	private:
+		char   *_data{nullptr};
+		size_t  _size{0};
+};
+
+
 }
 
 
@@ -235,6 +311,39 @@ SC3GF1DArchive::~SC3GF1DArchive() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool SC3GF1DArchive::setSource(std::string source) {
+	_useMMap = false;
+
+	size_t pos = source.find('?');
+	if ( pos != std::string::npos ) {
+		std::vector<std::string> toks;
+		Core::split(toks, source.substr(pos+1).c_str(), "&");
+		source.erase(pos);
+
+		for ( const std::string &tok : toks ) {
+			std::string name = tok, value;
+			size_t p = tok.find('=');
+			if ( p != std::string::npos ) {
+				name = tok.substr(0, p);
+				value = tok.substr(p+1);
+			}
+
+			if ( name == "mmap" )
+				_useMMap = true;
+			else if ( name == "cache" ) {
+				size_t megabytes;
+				if ( !Core::fromString(megabytes, value) ) {
+					SEISCOMP_ERROR("Invalid cache size: %s", value.c_str());
+					return false;
+				}
+				setCacheLimit(megabytes * 1024 * 1024);
+			}
+			else if ( !name.empty() ) {
+				SEISCOMP_ERROR("Invalid option: %s", tok.c_str());
+				return false;
+			}
+		}
+	}
+
 	fs::path directory;
 	try {
 		directory = SC_FS_PATH(source);
@@ -375,8 +484,10 @@ bool SC3GF1DArchive::setSource(std::string source) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SC3GF1DArchive::close() {
+	cancelFetches();
 	_requests.clear();
 	_models.clear();
+	clearCache();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -491,175 +602,259 @@ bool SC3GF1DArchive::addRequest(const std::string &id,
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Core::GreensFunction* SC3GF1DArchive::get() {
+	if ( threads() > 1 ) {
+		std::vector<Fetch> fetches;
+		for ( const Request &req : _requests )
+			fetches.push_back([this, req]() { return fetch(req); });
+		_requests.clear();
+		return fetchConcurrently(fetches);
+	}
+
 	while ( !_requests.empty() ) {
 		Request req = _requests.front();
 		_requests.pop_front();
 
-		std::string pathprefix = _baseDirectory + "/" + req.model + "/";
+		Core::GreensFunction *gf = fetch(req);
+		if ( gf ) return gf;
+	}
 
-		int distKm = (int)req.distance;
-		double fDepth = req.depth;
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		ModelMap::iterator mit = _models.find(req.model);
-		if ( mit == _models.end() ) continue;
 
-		DoubleList::iterator lbdist = mit->second.distances.lower_bound(distKm);
-		DoubleList::iterator ubdist = lbdist--;
-		DoubleList::iterator lbdep = mit->second.depths.lower_bound(req.depth);
-		DoubleList::iterator ubdep = lbdep--;
 
-		double dist1, dist2, dist;
-		double dep1, dep2, dep;
 
-		// Distance is lower than the first stored value
-		if ( ubdist == mit->second.distances.begin() ) {
-			dist1 = *ubdist;
-			++ubdist;
-			if ( ubdist != mit->second.distances.end() )
-				dist2 = *ubdist;
-			else
-				dist2 = dist1;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunction* SC3GF1DArchive::fetch(const Request &req) {
+	std::string pathprefix = _baseDirectory + "/" + req.model + "/";
 
-			double maxDistError = dist2 - dist1;
-			if ( dist1 - distKm > maxDistError ) {
-				SEISCOMP_DEBUG("Distance too low: %d km", distKm);
-				continue;
-			}
+	int distKm = (int)req.distance;
+	double fDepth = req.depth;
 
-			dist2 = dist1;
-		}
-		// Distance is greater than the last stored value
-		else if ( ubdist == mit->second.distances.end() ) {
-			dist2 = *lbdist;
-			--lbdist;
-			dist1 = *lbdist;
-
-			double maxDistError = dist2 - dist1;
-			if ( distKm - dist2 > maxDistError ) {
-				SEISCOMP_DEBUG("Distance too high: %d km", distKm);
-				continue;
-			}
+	Core::TimeSpan ts = _defaultTimespan;
+	if ( req.timeSpan ) ts = req.timeSpan;
 
-			dist2 = dist1;
-		}
-		else {
-			dist1 = *lbdist;
+	Core::GreensFunction *cachedGF = cached(req.model, fDepth, distKm, ts);
+	if ( cachedGF ) {
+		cachedGF->setId(req.id);
+		return cachedGF;
+	}
+
+	ModelMap::iterator mit = _models.find(req.model);
+	if ( mit == _models.end() ) return nullptr;
+
+	DoubleList::iterator lbdist = mit->second.distances.lower_bound(distKm);
+	DoubleList::iterator ubdist = lbdist--;
+	DoubleList::iterator lbdep = mit->second.depths.lower_bound(req.depth);
+	DoubleList::iterator ubdep = lbdep--;
+
+	double dist1, dist2, dist;
+	double dep1, dep2, dep;
+
+	// Distance is lower than the first stored value
+	if ( ubdist == mit->second.distances.begin() ) {
+		dist1 = *ubdist;
+		++ubdist;
+		if ( ubdist != mit->second.distances.end() )
 			dist2 = *ubdist;
+		else
+			dist2 = dist1;
+
+		double maxDistError = dist2 - dist1;
+		if ( dist1 - distKm > maxDistError ) {
+			SEISCOMP_DEBUG("Distance too low: %d km", distKm);
+			return nullptr;
 		}
 
-		// Depth is lower than the first stored value
-		if ( ubdep == mit->second.depths.begin() ) {
-			dep1 = dep2 = *ubdep;
+		dist2 = dist1;
+	}
+	// Distance is greater than the last stored value
+	else if ( ubdist == mit->second.distances.end() ) {
+		dist2 = *lbdist;
+		--lbdist;
+		dist1 = *lbdist;
+
+		double maxDistError = dist2 - dist1;
+		if ( distKm - dist2 > maxDistError ) {
+			SEISCOMP_DEBUG("Distance too high: %d km", distKm);
+			return nullptr;
+		}
 
-			dep1 = *ubdep;
-			++ubdep;
-			if ( ubdep != mit->second.depths.end() )
-				dep2 = *ubdep;
-			else
-				dep2 = dep1;
+		dist2 = dist1;
+	}
+	else {
+		dist1 = *lbdist;
+		dist2 = *ubdist;
+	}
 
-			double maxDepError = dep2 - dep1;
-			if ( dep1 - fDepth > maxDepError ) {
-				SEISCOMP_DEBUG("Depth too low: %f km < %d km", fDepth, (int)dep1);
-				continue;
-			}
+	// Depth is lower than the first stored value
+	if ( ubdep == mit->second.depths.begin() ) {
+		dep1 = dep2 = *ubdep;
 
+		dep1 = *ubdep;
+		++ubdep;
+		if ( ubdep != mit->second.depths.end() )
+			dep2 = *ubdep;
+		else
 			dep2 = dep1;
 
+		double maxDepError = dep2 - dep1;
+		if ( dep1 - fDepth > maxDepError ) {
+			SEISCOMP_DEBUG("Depth too low: %f km < %d km", fDepth, (int)dep1);
+			return nullptr;
 		}
-		// Depth is greater than the last stored value
-		else if ( ubdep == mit->second.depths.end() ) {
-			dep2 = *lbdep;
-			--lbdep;
-			dep1 = *lbdep;
-
-			double maxDepError = dep2 - dep1;
-			if ( fDepth - dep2 > maxDepError ) {
-				SEISCOMP_DEBUG("Depth too high: %f km", fDepth);
-				continue;
-			}
 
-			dep2 = dep1;
-		}
-		else {
-			dep1 = *lbdep;
-			dep2 = *ubdep;
+		dep2 = dep1;
+
+	}
+	// Depth is greater than the last stored value
+	else if ( ubdep == mit->second.depths.end() ) {
+		dep2 = *lbdep;
+		--lbdep;
+		dep1 = *lbdep;
+
+		double maxDepError = dep2 - dep1;
+		if ( fDepth - dep2 > maxDepError ) {
+			SEISCOMP_DEBUG("Depth too high: %f km", fDepth);
+			return nullptr;
 		}
 
-		if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
-			dist = dist1;
+		dep2 = dep1;
+	}
+	else {
+		dep1 = *lbdep;
+		dep2 = *ubdep;
+	}
+
+	if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
+		dist = dist1;
+	}
+	else {
+		dist = dist2;
+	}
+
+	if ( fabs(fDepth - dep1) < fabs(fDepth - dep2) ) {
+		dep = dep1;
+	}
+	else {
+		dep = dep2;
+	}
+
+	/*
+	if ( fabs(depError) > maxDepError || fabs(distError) > maxDistError ) {
+	}
+	*/
+
+	// For greens functions for bilinear interpolation
+	Core::GreensFunction *gf_11;
+	Core::GreensFunction *gf_12;
+	Core::GreensFunction *gf_21;
+	Core::GreensFunction *gf_22;
+
+	if ( (dist == dist1) || (dist == dist2) || (dist1 == dist2) ) {
+		char dep_str[10], dist_str[10];
+		snprintf(dep_str, 10, "%04d", (int)dep*10);
+		snprintf(dist_str, 10, "%05d", (int)dist);
+		std::string file = pathprefix + dep_str + "/" + dist_str + "/" + dep_str + "." + dist_str + ".";
+
+		//double ofs = dist / _models[req.model].velocity;
+		double ofs = 0;
+
+		Core::GreensFunction *gf = read(file, ts, ofs);
+		if ( gf ) {
+			gf->setId(req.id);
+			gf->setModel(req.model);
+			gf->setDepth(dep);
+			gf->setDistance(dist);
+			gf_11 = gf_12 = gf;
 		}
 		else {
-			dist = dist2;
+			SEISCOMP_ERROR("Unable to read %s", file.c_str());
+			return nullptr;
 		}
-
-		if ( fabs(fDepth - dep1) < fabs(fDepth - dep2) ) {
-			dep = dep1;
+	}
+	else {
+		char dep_str[10], dist1_str[10], dist2_str[10];
+		snprintf(dep_str, 10, "%04d", (int)dep*10);
+		snprintf(dist1_str, 10, "%05d", (int)dist1);
+		snprintf(dist2_str, 10, "%05d", (int)dist2);
+		std::string file1 = pathprefix + dep_str + "/" + dist1_str + "/" + dep_str + "." + dist1_str + ".";
+		std::string file2 = pathprefix + dep_str + "/" + dist2_str + "/" + dep_str + "." + dist2_str + ".";
+
+		//double ofs = dist / _models[req.model].velocity;
+		double ofs = 0;
+
+		Core::GreensFunction *gf1 = read(file1, ts, ofs);
+		Core::GreensFunction *gf2 = read(file2, ts, ofs);
+		if ( gf1 && gf2 ) {
+			gf1->setId(req.id);
+			gf1->setModel(req.model);
+			gf1->setDepth(dep);
+			gf1->setDistance(distKm);
+
+			gf_11 = gf1;
+			gf_12 = gf2;
 		}
 		else {
-			dep = dep2;
-		}
+			SEISCOMP_ERROR("Unable to read %s or %s",
+			               file1.c_str(), file2.c_str());
+			if ( gf1 ) delete gf1;
+			if ( gf2 ) delete gf2;
 
-		/*
-		if ( fabs(depError) > maxDepError || fabs(distError) > maxDistError ) {
+			return nullptr;
 		}
-		*/
+	}
+
 
-		// For greens functions for bilinear interpolation
-		Core::GreensFunction *gf_11;
-		Core::GreensFunction *gf_12;
-		Core::GreensFunction *gf_21;
-		Core::GreensFunction *gf_22;
+	double alt_dep = dep;
+	if ( dep != dep1 )
+		alt_dep = dep1;
+	else if ( dep != dep2 )
+		alt_dep = dep2;
 
+	if ( dep == alt_dep ) {
+		gf_21 = gf_11;
+		gf_22 = gf_12;
+	}
+	else {
 		if ( (dist == dist1) || (dist == dist2) || (dist1 == dist2) ) {
 			char dep_str[10], dist_str[10];
-			snprintf(dep_str, 10, "%04d", (int)dep*10);
+			snprintf(dep_str, 10, "%04d", (int)alt_dep*10);
 			snprintf(dist_str, 10, "%05d", (int)dist);
 			std::string file = pathprefix + dep_str + "/" + dist_str + "/" + dep_str + "." + dist_str + ".";
 
-			Core::TimeSpan ts = _defaultTimespan;
-			if ( req.timeSpan ) ts = req.timeSpan;
-
 			//double ofs = dist / _models[req.model].velocity;
 			double ofs = 0;
 
 			Core::GreensFunction *gf = read(file, ts, ofs);
 			if ( gf ) {
-				gf->setId(req.id);
-				gf->setModel(req.model);
-				gf->setDepth(dep);
-				gf->setDistance(dist);
-				gf_11 = gf_12 = gf;
+				gf_21 = gf_22 = gf;
 			}
 			else {
+				if ( gf_11 ) delete gf_11;
+				if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
+
 				SEISCOMP_ERROR("Unable to read %s", file.c_str());
-				continue;
+				return nullptr;
 			}
 		}
 		else {
 			char dep_str[10], dist1_str[10], dist2_str[10];
-			snprintf(dep_str, 10, "%04d", (int)dep*10);
+			snprintf(dep_str, 10, "%04d", (int)alt_dep*10);
 			snprintf(dist1_str, 10, "%05d", (int)dist1);
 			snprintf(dist2_str, 10, "%05d", (int)dist2);
 			std::string file1 = pathprefix + dep_str + "/" + dist1_str + "/" + dep_str + "." + dist1_str + ".";
 			std::string file2 = pathprefix + dep_str + "/" + dist2_str + "/" + dep_str + "." + dist2_str + ".";
 
-			Core::TimeSpan ts = _defaultTimespan;
-			if ( req.timeSpan ) ts = req.timeSpan;
-
 			//double ofs = dist / _models[req.model].velocity;
 			double ofs = 0;
 
 			Core::GreensFunction *gf1 = read(file1, ts, ofs);
 			Core::GreensFunction *gf2 = read(file2, ts, ofs);
 			if ( gf1 && gf2 ) {
-				gf1->setId(req.id);
-				gf1->setModel(req.model);
-				gf1->setDepth(dep);
-				gf1->setDistance(distKm);
-
-				gf_11 = gf1;
-				gf_12 = gf2;
+				gf_21 = gf1;
+				gf_22 = gf2;
 			}
 			else {
 				SEISCOMP_ERROR("Unable to read %s or %s",
@@ -667,103 +862,36 @@ Core::GreensFunction* SC3GF1DArchive::get() {
 				if ( gf1 ) delete gf1;
 				if ( gf2 ) delete gf2;
 
-				continue;
-			}
-		}
-
-
-		double alt_dep = dep;
-		if ( dep != dep1 )
-			alt_dep = dep1;
-		else if ( dep != dep2 )
-			alt_dep = dep2;
-
-		if ( dep == alt_dep ) {
-			gf_21 = gf_11;
-			gf_22 = gf_12;
-		}
-		else {
-			if ( (dist == dist1) || (dist == dist2) || (dist1 == dist2) ) {
-				char dep_str[10], dist_str[10];
-				snprintf(dep_str, 10, "%04d", (int)alt_dep*10);
-				snprintf(dist_str, 10, "%05d", (int)dist);
-				std::string file = pathprefix + dep_str + "/" + dist_str + "/" + dep_str + "." + dist_str + ".";
+				if ( gf_11 ) delete gf_11;
+				if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
 
-				Core::TimeSpan ts = _defaultTimespan;
-				if ( req.timeSpan ) ts = req.timeSpan;
-
-				//double ofs = dist / _models[req.model].velocity;
-				double ofs = 0;
-
-				Core::GreensFunction *gf = read(file, ts, ofs);
-				if ( gf ) {
-					gf_21 = gf_22 = gf;
-				}
-				else {
-					if ( gf_11 ) delete gf_11;
-					if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
-
-					SEISCOMP_ERROR("Unable to read %s", file.c_str());
-					continue;
-				}
+				return nullptr;
 			}
-			else {
-				char dep_str[10], dist1_str[10], dist2_str[10];
-				snprintf(dep_str, 10, "%04d", (int)alt_dep*10);
-				snprintf(dist1_str, 10, "%05d", (int)dist1);
-				snprintf(dist2_str, 10, "%05d", (int)dist2);
-				std::string file1 = pathprefix + dep_str + "/" + dist1_str + "/" + dep_str + "." + dist1_str + ".";
-				std::string file2 = pathprefix + dep_str + "/" + dist2_str + "/" + dep_str + "." + dist2_str + ".";
-
-				Core::TimeSpan ts = _defaultTimespan;
-				if ( req.timeSpan ) ts = req.timeSpan;
-
-				//double ofs = dist / _models[req.model].velocity;
-				double ofs = 0;
-
-				Core::GreensFunction *gf1 = read(file1, ts, ofs);
-				Core::GreensFunction *gf2 = read(file2, ts, ofs);
-				if ( gf1 && gf2 ) {
-					gf_21 = gf1;
-					gf_22 = gf2;
-				}
-				else {
-					SEISCOMP_ERROR("Unable to read %s or %s",
-					               file1.c_str(), file2.c_str());
-					if ( gf1 ) delete gf1;
-					if ( gf2 ) delete gf2;
-
-					if ( gf_11 ) delete gf_11;
-					if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
-
-					continue;
-				}
-			}
-
-			gf_11->setDepth(fDepth);
 		}
 
-		if ( !interpolate(gf_11, gf_12, gf_21, gf_22,
-		                  distKm, dist1, dist2, fDepth, dep, alt_dep) ) {
-			SEISCOMP_ERROR("Interpolation for %d / %f failed", distKm, fDepth);
+		gf_11->setDepth(fDepth);
+	}
 
-			if ( gf_11 ) delete gf_11;
-			if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
+	if ( !interpolate(gf_11, gf_12, gf_21, gf_22,
+	                  distKm, dist1, dist2, fDepth, dep, alt_dep) ) {
+		SEISCOMP_ERROR("Interpolation for %d / %f failed", distKm, fDepth);
 
-			if ( gf_21 && ((gf_21 != gf_11) && (gf_21 != gf_12)) ) delete gf_21;
-			if ( gf_22 && ((gf_22 != gf_11) && (gf_22 != gf_12) && (gf_22 != gf_21)) ) delete gf_22;
-		}
-		else {
-			if ( gf_12 && (gf_12 != gf_11) ) delete gf_12;
-			if ( gf_21 && ((gf_21 != gf_11) && (gf_21 != gf_12)) ) delete gf_21;
-			if ( gf_22 && ((gf_22 != gf_11) && (gf_22 != gf_12) && (gf_22 != gf_21)) ) delete gf_22;
+		if ( gf_11 ) delete gf_11;
+		if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
 
-			return gf_11;
-		}
+		if ( gf_21 && ((gf_21 != gf_11) && (gf_21 != gf_12)) ) delete gf_21;
+		if ( gf_22 && ((gf_22 != gf_11) && (gf_22 != gf_12) && (gf_22 != gf_21)) ) delete gf_22;
+	}
+	else {
+		if ( gf_12 && (gf_12 != gf_11) ) delete gf_12;
+		if ( gf_21 && ((gf_21 != gf_11) && (gf_21 != gf_12)) ) delete gf_21;
+		if ( gf_22 && ((gf_22 != gf_11) && (gf_22 != gf_12) && (gf_22 != gf_21)) ) delete gf_22;
 
-		SEISCOMP_DEBUG("No greensfunction found");
+		cache(req.model, fDepth, distKm, ts, gf_11);
+		return gf_11;
 	}
 
+	SEISCOMP_DEBUG("No greensfunction found");
 	return nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -801,15 +929,24 @@ Core::GreensFunction* SC3GF1DArchive::read(const std::string &file,
 
 	for ( int i = 0; i < GF_COMPS; ++i ) {
 		std::string filename = file + comps[i].toString();
-		std::ifstream ifs(filename .c_str());
-		if ( !ifs.good() ) {
-			SEISCOMP_DEBUG("Green's functions - %s: not found", filename.c_str());
-			return nullptr;
+		MappedFile mapping;
+		std::ifstream ifs;
+		std::istream *is = &ifs;
+
+		if ( _useMMap && mapping.open(filename) )
+			is = &mapping.stream;
+		else {
+			ifs.open(filename.c_str());
+			if ( !ifs.good() ) {
+				SEISCOMP_DEBUG("Green's functions - %s: not found", filename.c_str());
+				if ( gf ) delete gf;
+				return nullptr;
+			}
 		}
 
 		IO::SACRecord sac;
 		try {
-			sac.read(ifs);
+			sac.read(*is);
 		}
 		catch ( std::exception &exc ) {
 			SEISCOMP_ERROR("%s: %s", filename.c_str(), exc.what());
@@ -35,6 +35,19 @@ namespace Seiscomp {
 namespace IO {
 
 
+/**
+ * @brief The SC3GF1DArchive class reads Green's functions from a directory
+ *        of SAC files per model, depth and distance.
+ *
+ * The source is the base directory which can be followed by options, e.g.
+ * "/data/gf?mmap&cache=512".
+ *
+ * Supported options:
+ * - mmap: Maps the SAC files into memory rather than reading them through
+ *         a file stream.
+ * - cache=N: Keeps the interpolated Green's functions up to N megabytes,
+ *            see GFArchive::setCacheLimit.
+ */
 class SC_SYSTEM_CORE_API SC3GF1DArchive : public GFArchive {
 	// ----------------------------------------------------------------------
 	//  Xstruction
@@ -102,6 +115,11 @@ class SC_SYSTEM_CORE_API SC3GF1DArchive : public GFArchive {
 		};
 
 		typedef std::list<Request> RequestList;
+
+		//! Reads and interpolates the Green's function of a request. This
+		//! is called concurrently if more than one thread is used.
+		Core::GreensFunction* fetch(const Request &req);
+
 		typedef std::set<double> DoubleList;
 		typedef std::map<double, double> TTDepth;
 		typedef std::map<double, TTDepth> TTDistance;
@@ -125,6 +143,7 @@ class SC_SYSTEM_CORE_API SC3GF1DArchive : public GFArchive {
 		std::string        _baseDirectory;
 		Core::TimeSpan     _defaultTimespan;
 		RequestList        _requests;
+		bool               _useMMap{false};
 };
 
 }
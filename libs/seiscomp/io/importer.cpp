@@ -89,6 +89,44 @@ Core::BaseObject *Importer::read(std::string filename) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Importer::stream(std::streambuf* buf, const ObjectHandler &handler) {
+	return get(buf, handler);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Importer::stream(std::string filename, const ObjectHandler &handler) {
+	if ( filename != "-" ) {
+		std::ifstream ifs(filename.c_str(), std::ios_base::in);
+		if ( !ifs.good() ) return false;
+
+		return get(ifs.rdbuf(), handler);
+	}
+
+	return get(std::cin.rdbuf(), handler);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Importer::get(std::streambuf* buf, const ObjectHandler &handler) {
+	Core::BaseObjectPtr obj = get(buf);
+	if ( !obj ) return false;
+
+	handler(nullptr, obj.get());
+	return withoutErrors();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Importer::withoutErrors() const {
 	return _hasErrors == false;
@@ -26,6 +26,7 @@
 #include <seiscomp/core/interfacefactory.h>
 #include <seiscomp/core.h>
 
+#include <functional>
 #include <streambuf>
 #include <string>
 
@@ -62,12 +63,40 @@ class SC_SYSTEM_CORE_API Importer : public Core::BaseObject {
 	// ------------------------------------------------------------------
 	//  Public interface
 	// ------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Receives the objects read by stream().
+		 *
+		 * The first argument is the parent of the object or nullptr for
+		 * a top-level object. The object is deleted after the call unless
+		 * the callback keeps a reference to it. Returning false stops
+		 * reading.
+		 */
+		typedef std::function<bool (Core::BaseObject *parent,
+		                            Core::BaseObject *object)> ObjectHandler;
+
+
 	public:
 		static Importer *Create(const char *type);
 
 		Core::BaseObject *read(std::streambuf* buf);
 		Core::BaseObject *read(std::string filename);
 
+		/**
+		 * @brief Reads the objects one after another without building the
+		 *        whole object tree in memory.
+		 *
+		 * A top-level object, e.g. EventParameters, is passed without its
+		 * children first. Its children, e.g. the picks, origins and
+		 * events, are then passed complete one by one with the top-level
+		 * object as parent but without being added to it. Importers which
+		 * do not support streaming read the whole object and pass it as
+		 * top-level object.
+		 * @return Whether the input has been read without errors
+		 */
+		bool stream(std::streambuf* buf, const ObjectHandler &handler);
+		bool stream(std::string filename, const ObjectHandler &handler);
+
 		bool withoutErrors() const;
 
 	// ------------------------------------------------------------------
@@ -77,6 +106,11 @@ class SC_SYSTEM_CORE_API Importer : public Core::BaseObject {
 		//! Interface method that must be implemented by real importers.
 		virtual Core::BaseObject *get(std::streambuf* buf) = 0;
 
+		//! Interface method that should be implemented by importers which
+		//! support streaming. The default implementation reads the whole
+		//! object with get().
+		virtual bool get(std::streambuf* buf, const ObjectHandler &handler);
+
 
 	protected:
 		bool _hasErrors;
@@ -0,0 +1,527 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT QLClient
+
+#define MAX_LINE_LENGTH             4096
+#define MAX_HELLO_LINES             20
+
+#include <streambuf>
+#include <string>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/io/archive/xmlarchive.h>
+#include <seiscomp/logging/log.h>
+
+#include "session.h"
+#include "protocol_private.h"
+
+
+using namespace std;
+
+namespace Seiscomp {
+namespace IO {
+namespace QuakeLink {
+
+namespace {
+
+using Private::equals;
+using Private::startsWith;
+
+// Read-only view on a received payload which is passed to the XMLArchive
+// without copying it
+class PayloadBuf : public streambuf {
+	public:
+		PayloadBuf(const string &data) {
+			char *tmp = const_cast<char*>(data.data());
+			setg(tmp, tmp, tmp + data.size());
+		}
+};
+
+} // ns anonymous
+
+Session::Session()
+: Wired::ClientSession(nullptr, MAX_LINE_LENGTH)
+, _ssl(false), _options(opIgnore), _serverAPI(0), _state(Hello)
+, _helloLines(0), _welcomed(false), _decode(false), _source(dsGet)
+, _archived(false), _updatedBufferSize(-1) {}
+
+Session::~Session() {}
+
+bool Session::init(const string &url, int options) {
+	Private::URL parsed;
+	if ( !Private::parseURL(parsed, url) ) {
+		SEISCOMP_ERROR("%sunsupported protocol: %s",
+		               _logPrefix.c_str(), parsed.protocol.c_str());
+		return false;
+	}
+
+	_service = parsed.service;
+	_user = parsed.user;
+	_pass = parsed.pass;
+	_ssl = parsed.ssl;
+	_options = options;
+
+	SEISCOMP_INFO("%sservice initialized: %s://%s%s",
+	              _logPrefix.c_str(), parsed.protocol.c_str(),
+	              _user.empty() ? "" : (_user + ":***@").c_str(),
+	              _service.c_str());
+
+	return true;
+}
+
+bool Session::connect() {
+	if ( _service.empty() ) {
+		SEISCOMP_ERROR("%ssession not initialized", _logPrefix.c_str());
+		return false;
+	}
+
+	if ( _parent ) {
+		SEISCOMP_ERROR("%ssession is still part of a reactor",
+		               _logPrefix.c_str());
+		return false;
+	}
+
+	size_t pos = _service.rfind(':');
+	string host = _service.substr(0, pos);
+	Wired::Socket::port_t port;
+	if ( pos == string::npos ||
+	     !Core::fromString(port, _service.substr(pos + 1)) ) {
+		SEISCOMP_ERROR("%sinvalid service: %s",
+		               _logPrefix.c_str(), _service.c_str());
+		return false;
+	}
+
+	Wired::SocketPtr sock;
+	if ( _ssl )
+		sock = new Wired::SSLSocket;
+	else {
+		// The connection is established while the reactor is running
+		sock = new Wired::Socket;
+		sock->setNonBlocking(true);
+	}
+
+	Wired::Socket::Status status = sock->connect(host, port);
+	if ( status != Wired::Socket::Success ) {
+		SEISCOMP_ERROR("%scould not connect to service '%s': %s",
+		               _logPrefix.c_str(), _service.c_str(),
+		               Wired::Socket::toString(status));
+		return false;
+	}
+
+	if ( _ssl )
+		sock->setNonBlocking(true);
+
+	sock->setMode(Wired::Device::Read);
+	setDevice(sock.get());
+
+	// reset the state of a previous connection
+	_flags = NoFlags;
+	_inboxPos = 0;
+	_postDataSize = 0;
+	_outbox.clear();
+	_heldInbox.clear();
+
+	_state = Hello;
+	_helloLines = 0;
+	_welcomed = false;
+	_serverID.clear();
+	_serverAPI = 0;
+	_response = nullptr;
+	_archived = false;
+	_updatesBetween.clear();
+
+	// The server handles the requests in order, so the authentication and
+	// the options are queued without waiting for the greeting
+	sendRequest("HELLO");
+
+	if ( _user.empty() ) {
+		SEISCOMP_DEBUG("%sskipping authentication", _logPrefix.c_str());
+	}
+	else {
+		SEISCOMP_DEBUG("%sperforming authentication", _logPrefix.c_str());
+		sendRequest("auth " + _user + " " + _pass, false);
+	}
+
+	sendOptions(opAll);
+
+	return true;
+}
+
+void Session::setOptions(int options) {
+	if ( _options == options ) return;
+	int oldOptions = _options;
+	_options = options;
+	// if connected updated only those options which have been changed
+	if ( _device && _device->isValid() )
+		sendOptions(oldOptions ^ _options);
+}
+
+void Session::setDecodingEnabled(bool enable) {
+	_decode = enable;
+}
+
+bool Session::get(const string &eventID, int revision,
+                  const RequestFormatVersion &formatVersion) {
+	return checkRequest(formatVersion) &&
+	       sendRequest(Private::getRequest(eventID, revision, formatVersion));
+}
+
+bool Session::getUpdates(const string &eventID,
+                         const RequestFormatVersion &formatVersion) {
+	return checkRequest(formatVersion) &&
+	       sendRequest(Private::getUpdatesRequest(eventID, formatVersion));
+}
+
+bool Session::selectArchived(const Core::Time &from, const Core::Time &to,
+                             const RequestFormatVersion &formatVersion,
+                             const string &where, Domain domain,
+                             OrderBy orderBy, unsigned long limit,
+                             unsigned long offset) {
+	string req;
+	if ( !checkRequest(formatVersion) ||
+	     !Private::selectRequest(req, "ARCHIVED ", from, to, formatVersion,
+	                             where, domain, _serverAPI, orderBy, limit,
+	                             offset) )
+		return false;
+
+	// archived events are passed on immediately
+	_archived = false;
+	return sendRequest(req);
+}
+
+bool Session::select(bool archived, const Core::Time &from,
+                     const Core::Time &to,
+                     const RequestFormatVersion &formatVersion,
+                     const string &where, Domain domain,
+                     int updatedBufferSize, OrderBy orderBy,
+                     unsigned long limit, unsigned long offset) {
+	string req;
+	if ( !checkRequest(formatVersion) ||
+	     !Private::selectRequest(req, archived ? "" : "UPDATED ", from, to,
+	                             formatVersion, where, domain, _serverAPI,
+	                             orderBy, limit, offset) )
+		return false;
+
+	_archived = archived;
+	_updatedBufferSize = updatedBufferSize;
+	return sendRequest(req);
+}
+
+void Session::abort() {
+	if ( _device && _device->isValid() )
+		sendRequest("ABORT");
+}
+
+void Session::close() {
+	if ( _device && _device->isValid() )
+		SEISCOMP_DEBUG("%sconnection to %s closed",
+		               _logPrefix.c_str(), _service.c_str());
+
+	_welcomed = false;
+	_response = nullptr;
+	_updatesBetween.clear();
+	Wired::ClientSession::close();
+}
+
+void Session::handleWelcome() {}
+
+void Session::handleResponse(Response *, DataSource) {}
+
+bool Session::handleObject(Core::BaseObject *, const Response &, DataSource) {
+	return true;
+}
+
+void Session::handleEndOfData(DataSource) {}
+
+void Session::logAndInvalidate(const char *msg, const char *detail) {
+	if ( detail != nullptr )
+		SEISCOMP_ERROR("%s%s: %s, disconnecting", _logPrefix.c_str(), msg, detail);
+	else
+		SEISCOMP_ERROR("%s%s, disconnecting", _logPrefix.c_str(), msg);
+	invalidate();
+}
+
+void Session::handleInbox(const char *data, size_t len) {
+	string line(data, len);
+
+	switch ( _state ) {
+		case Hello:
+			if ( startsWith(line, "QuakeLink") )
+				_serverID = line;
+			else if ( startsWith(line, "API=") ) {
+				if ( !Core::fromString(_serverAPI, Core::trim(line).substr(4)) ) {
+					logAndInvalidate("HELLO: Server responded with non numeric "
+					                 "API version string");
+					return;
+				}
+			}
+			else if ( startsWith(line, "WELCOME") ) {
+				_state = HelloBreak;
+				return;
+			}
+
+			if ( ++_helloLines >= MAX_HELLO_LINES )
+				logAndInvalidate("HELLO: Server did not respond with 'WELCOME' "
+				                 "in first 20 lines of response");
+			break;
+
+		case HelloBreak:
+			if ( !line.empty() ) {
+				logAndInvalidate("HELLO: Server did not respond with 'WELCOME' "
+				                 "followed by new line");
+				return;
+			}
+
+			_state = ResponseCode;
+			_welcomed = true;
+			handleWelcome();
+			break;
+
+		case ResponseCode:
+			handleResponseCode(line);
+			break;
+
+		case Header:
+			if ( !line.empty() ) {
+				const char *error;
+				string detail;
+				if ( !Private::parseHeaderLine(*_response, line, error, detail,
+				                               _logPrefix) )
+					logAndInvalidate(error, detail.c_str());
+				return;
+			}
+
+			// the header must at least contain a content type and length
+			if ( _response->type == ctUndefined ) {
+				logAndInvalidate("response header: Missing Content-Type");
+				return;
+			}
+			if ( _response->length <= 0 ) {
+				logAndInvalidate("response header: Missing Content-Length");
+				return;
+			}
+
+			SEISCOMP_DEBUG("%sreading %u payload bytes", _logPrefix.c_str(),
+			               _response->length);
+			_response->data.reserve(_response->length);
+			_state = Payload;
+			setPostDataSize(_response->length);
+			break;
+
+		case Payload:
+			// Not reached, the payload is passed to handlePostData
+			break;
+
+		case PayloadBreak:
+			if ( !line.empty() ) {
+				logAndInvalidate("could not read line break");
+				return;
+			}
+
+			finishResponse();
+			break;
+
+		case NotFoundBreak:
+			if ( !line.empty() ) {
+				logAndInvalidate("could not read line break");
+				return;
+			}
+
+			_state = ResponseCode;
+			handleEndOfData(dsGet);
+			break;
+	}
+}
+
+void Session::handlePostData(const char *data, size_t len) {
+	if ( _state != Payload || !_response ) return;
+
+	_response->data.append(data, len);
+	if ( _response->data.size() >= _response->length )
+		_state = PayloadBreak;
+}
+
+void Session::handleInboxError(Error error) {
+	if ( error == TooManyCharactersPerLine )
+		logAndInvalidate("received line exceeds maximum length");
+	else
+		logAndInvalidate("could not read from server");
+}
+
+bool Session::sendRequest(const string &req, bool log) {
+	if ( !_device || !_device->isValid() ) {
+		SEISCOMP_ERROR("%scould not send request '%s': not connected",
+		               _logPrefix.c_str(), log ? req.c_str() : "***");
+		return false;
+	}
+
+	SEISCOMP_DEBUG("%ssending request: %s", _logPrefix.c_str(),
+	               log ? req.c_str() : "***");
+	send(req.c_str(), req.size());
+	send("\r\n", 2);
+	return true;
+}
+
+void Session::sendOptions(int changedOptions) {
+	for ( const string &req : Private::optionRequests(_options, changedOptions) )
+		sendRequest(req);
+}
+
+bool Session::checkRequest(const RequestFormatVersion &formatVersion) {
+	if ( !_welcomed ) {
+		SEISCOMP_ERROR("%srequest not possible before the server welcomed "
+		               "the session", _logPrefix.c_str());
+		return false;
+	}
+
+	if ( !Private::isSupported(formatVersion, _serverAPI) ) {
+		SEISCOMP_WARNING("Format version %u not supported by server",
+		                 formatVersion.version());
+		return false;
+	}
+
+	return true;
+}
+
+void Session::handleResponseCode(const string &code) {
+	if ( code.empty() ) {
+		logAndInvalidate("received empty response code");
+		return;
+	}
+
+	if ( code == "ALIVE" ) {
+		SEISCOMP_DEBUG("%sreceived ALIVE message", _logPrefix.c_str());
+		return;
+	}
+
+	SEISCOMP_DEBUG("%sread response code: %s", _logPrefix.c_str(),
+	               code.c_str());
+
+	if ( startsWith(code, "DATA/GET 200") )
+		_source = dsGet;
+	else if ( startsWith(code, "DATA/GET 404") ) {
+		// no data available
+		_state = NotFoundBreak;
+		return;
+	}
+	else if ( startsWith(code, "DATA/SELECT/ARCHIVED 200") )
+		_source = dsArchived;
+	else if ( startsWith(code, "DATA/SELECT/UPDATED 200") )
+		_source = dsUpdated;
+	else if ( startsWith(code, "EOD/SELECT/ARCHIVED") ) {
+		SEISCOMP_DEBUG("%sEOD/SELECT/ARCHIVED", _logPrefix.c_str());
+		_archived = false;
+		flushUpdatesBetween();
+		handleEndOfData(dsArchived);
+		return;
+	}
+	else if ( equals(code, "EOD/SELECT") ) {
+		SEISCOMP_DEBUG("%sEOD/SELECT", _logPrefix.c_str());
+		flushUpdatesBetween();
+		handleEndOfData(dsUpdated);
+		return;
+	}
+	else {
+		string detail = "got: '" + code + "'";
+		logAndInvalidate("received unexpected response code", detail.c_str());
+		return;
+	}
+
+	_response = new Response;
+	_state = Header;
+}
+
+void Session::finishResponse() {
+	ResponsePtr response = _response;
+	_response = nullptr;
+	_state = ResponseCode;
+
+	switch ( _source ) {
+		case dsGet:
+			if ( _decode && response->type == ctXML )
+				decode(*response, dsGet);
+			handleResponse(response.get(), dsGet);
+			handleEndOfData(dsGet);
+			return;
+
+		case dsArchived:
+			_archived = true;
+			break;
+
+		case dsUpdated:
+			// QuakeLink < 2022.060 did not set the Content-Timestamp
+			// header for UPDATED data. As a workarround the current
+			// timestamp is used.
+			if ( !response->timestamp.valid() )
+				response->timestamp = Core::Time::GMT();
+
+			// archived data processed or cache disabled: sent update
+			// immediately
+			if ( !_archived || _updatedBufferSize < 0 )
+				break;
+
+			// intermediate update, try to buffer
+			if ( _updatesBetween.size() < static_cast<size_t>(_updatedBufferSize) )
+				_updatesBetween.push_back(response);
+			else
+				SEISCOMP_WARNING("%sreceived to many updates while still "
+				                 "processing archived events, dropping update",
+				                 _logPrefix.c_str());
+			return;
+	}
+
+	if ( _decode && response->type == ctXML )
+		decode(*response, _source);
+	handleResponse(response.get(), _source);
+}
+
+void Session::flushUpdatesBetween() {
+	if ( _updatesBetween.empty() ) return;
+
+	SEISCOMP_INFO("%sprocessing %lu updates received in between",
+	              _logPrefix.c_str(),
+	              static_cast<unsigned long>(_updatesBetween.size()));
+
+	vector<ResponsePtr> updates;
+	updates.swap(_updatesBetween);
+	for ( const ResponsePtr &response : updates ) {
+		if ( _decode && response->type == ctXML )
+			decode(*response, dsUpdated);
+		handleResponse(response.get(), dsUpdated);
+	}
+}
+
+void Session::decode(const Response &response, DataSource source) {
+	PayloadBuf buf(response.data);
+	XMLArchive ar;
+	if ( response.gzip ) {
+		ar.setCompression(true);
+		ar.setCompressionMethod(XMLArchive::GZIP);
+	}
+
+	ar.readStream(&buf, [&](Core::BaseObject *object) {
+		return handleObject(object, response, source);
+	});
+}
+
+} // ns QuakeLink
+} // ns IO
+} // ns Seiscomp
@@ -0,0 +1,297 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_QUAKELINK_SESSION_H
+#define SEISCOMP_IO_QUAKELINK_SESSION_H
+
+
+#include <seiscomp/io/quakelink/connection.h>
+#include <seiscomp/wired/clientsession.h>
+
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace IO {
+namespace QuakeLink {
+
+
+/**
+ * @brief The Session class is an event-driven QuakeLink client.
+ *
+ * In contrast to Connection it does not block while waiting for the server.
+ * It is added to a Wired::Reactor which passes received data to the session
+ * as soon as it is available. Response headers and payloads are parsed
+ * incrementally from whatever has been received and complete responses are
+ * passed to handleResponse. Many sessions can be served by one thread.
+ *
+ * The session is driven by overriding the handlers, e.g.
+ * @code
+ * class MySession : public Session {
+ *     protected:
+ *         void handleWelcome() override {
+ *             select(true);
+ *         }
+ *
+ *         void handleResponse(Response *response, DataSource) override {
+ *             ...
+ *         }
+ * };
+ *
+ * Wired::Reactor reactor;
+ * reactor.setup();
+ * MySession *session = new MySession;
+ * if ( session->init("ql://localhost:18010") && session->connect() )
+ *     reactor.addSession(session);
+ * reactor.run();
+ * @endcode
+ *
+ * If decoding is enabled then XML payloads are additionally decoded with
+ * the streaming reader of the XMLArchive and each top-level object is passed
+ * to handleObject.
+ */
+DEFINE_SMARTPOINTER(Session);
+class SC_SYSTEM_CORE_API Session : public Wired::ClientSession {
+	public:
+		//! The request a response belongs to
+		enum DataSource {
+			dsGet,
+			dsArchived,
+			dsUpdated
+		};
+
+	public:
+		/** Default constructor */
+		Session();
+
+		/** Destructor */
+		~Session() override;
+
+	public:
+		/**
+		 * @brief Initializes the session with a connection URL and options
+		 * @param url URL of the QuakeLink including user name and password if
+		 * required
+		 * @param options Bit mask of all options to enable
+		 * @return True if the URL is valid
+		 */
+		bool init(const std::string &url, int options = opIgnore);
+
+		/**
+		 * @brief Opens the connection and queues the greeting, the
+		 * authentication and the options. The session must be added to a
+		 * reactor afterwards. Plain connections are established without
+		 * blocking, SSL connections block until the handshake finished.
+		 * handleWelcome is called when the server answered the greeting.
+		 * @return True if the connection could be opened
+		 */
+		bool connect();
+
+		/**
+		 * @brief Returns whether the server has answered the greeting
+		 * @return True if requests can be sent
+		 */
+		bool welcomed() const { return _welcomed; }
+
+		/**
+		 * @brief Sets connection options. If connected only the changed
+		 * options are sent.
+		 * @param options Bit mask of all options to enable
+		 */
+		void setOptions(int options);
+
+		/**
+		 * @brief Enables decoding of XML payloads. Each top-level object
+		 * of a payload is passed to handleObject before the response is
+		 * passed to handleResponse. Disabled by default.
+		 */
+		void setDecodingEnabled(bool enable);
+		bool isDecodingEnabled() const { return _decode; }
+
+		/**
+		 * @brief Requests one particular event revision.
+		 * @param eventID The event ID
+		 * @param revision Event revision, use a negative number to query the
+		 * latest revision
+		 * @param formatVersion Response format and version
+		 * @return True if the request could be queued. False if the server
+		 * has not yet welcomed the session or does not support the format.
+		 */
+		bool get(const std::string &eventID, int revision = -1,
+		         const RequestFormatVersion &formatVersion = rfSummary);
+
+		/**
+		 * @brief Requests all updates of a particular event. The response
+		 * format is restricted to 'summary'.
+		 * @param eventID The event ID
+		 * @param formatVersion Response format and version
+		 * @return True if the request could be queued
+		 */
+		bool getUpdates(const std::string &eventID,
+		                const RequestFormatVersion &formatVersion = rfSummary);
+
+		/**
+		 * @brief Selects archived events. See Connection::selectArchived
+		 * for a description of the parameters.
+		 * @return True if the request could be queued
+		 */
+		bool selectArchived(const Core::Time &from = Core::Time(),
+		                    const Core::Time &to = Core::Time(),
+		                    const RequestFormatVersion &formatVersion = rfSummary,
+		                    const std::string &where = "",
+		                    Domain domain = doEvents,
+		                    OrderBy orderBy = obUndefined,
+		                    unsigned long limit = 0,
+		                    unsigned long offset = 0);
+
+		/**
+		 * @brief Selects updated and (optional) archived events until
+		 * abort() is called. See Connection::select for a description of
+		 * the parameters.
+		 * @return True if the request could be queued
+		 */
+		bool select(bool archived = false,
+		            const Core::Time &from = Core::Time(),
+		            const Core::Time &to = Core::Time(),
+		            const RequestFormatVersion &formatVersion = rfSummary,
+		            const std::string &where = "",
+		            Domain domain = doEvents,
+		            int updatedBufferSize = 1000,
+		            OrderBy orderBy = obUndefined,
+		            unsigned long limit = 0,
+		            unsigned long offset = 0);
+
+		/**
+		 * @brief Gracefully aborts a select request. handleEndOfData is
+		 * called with dsUpdated when the server has finished.
+		 */
+		void abort();
+
+		//! Returns the server ID, empty until the session has been welcomed
+		const std::string &serverID() const { return _serverID; }
+
+		//! Returns the server API version
+		Version serverAPI() const { return _serverAPI; }
+
+		//! Closes the connection
+		void close() override;
+
+	protected:
+		/**
+		 * @brief Called when the server answered the greeting. Requests
+		 * are usually issued from here.
+		 */
+		virtual void handleWelcome();
+
+		/**
+		 * @brief Called for each complete response. The response is
+		 * released afterwards unless referenced by a ResponsePtr.
+		 * @param response The response
+		 * @param source The request the response belongs to
+		 */
+		virtual void handleResponse(Response *response, DataSource source);
+
+		/**
+		 * @brief Called with each top-level object, e.g. EventParameters
+		 * holding exactly one child, of an XML payload if decoding is
+		 * enabled.
+		 * @param object The object which is released afterwards unless
+		 * referenced
+		 * @param response The response the object was decoded from
+		 * @param source The request the response belongs to
+		 * @return False to skip the remaining objects of the payload
+		 */
+		virtual bool handleObject(Core::BaseObject *object,
+		                          const Response &response, DataSource source);
+
+		/**
+		 * @brief Called when the server finished a request: dsGet after a
+		 * GET request has been answered with or without data, dsArchived
+		 * after all archived events have been sent and dsUpdated when a
+		 * select request ended.
+		 */
+		virtual void handleEndOfData(DataSource source);
+
+		//! Logs an error and invalidates the session
+		void logAndInvalidate(const char *msg, const char *detail = nullptr);
+
+		inline void setLogPrefix(const std::string &prefix) {
+			_logPrefix = prefix;
+		}
+
+	protected:
+		void handleInbox(const char *data, size_t len) override;
+		void handlePostData(const char *data, size_t len) override;
+		void handleInboxError(Error error) override;
+
+	private:
+		enum State {
+			Hello,
+			HelloBreak,
+			ResponseCode,
+			Header,
+			Payload,
+			PayloadBreak,
+			NotFoundBreak
+		};
+
+		bool sendRequest(const std::string &req, bool log = true);
+		void sendOptions(int changedOptions);
+		bool checkRequest(const RequestFormatVersion &formatVersion);
+		void handleResponseCode(const std::string &code);
+		void finishResponse();
+		void flushUpdatesBetween();
+		void decode(const Response &response, DataSource source);
+
+	protected:
+		std::string              _logPrefix;
+
+		std::string              _service;
+		std::string              _user;
+		std::string              _pass;
+		bool                     _ssl;
+
+		int                      _options;
+		std::string              _serverID;
+		Version                  _serverAPI;
+
+	private:
+		State                    _state;
+		size_t                   _helloLines;
+		bool                     _welcomed;
+		bool                     _decode;
+
+		ResponsePtr              _response;
+		DataSource               _source;
+
+		// Cache of updates received during selection of archived events
+		bool                     _archived;
+		int                      _updatedBufferSize;
+		std::vector<ResponsePtr> _updatesBetween;
+};
+
+
+} // ns QuakeLink
+} // ns IO
+} // ns Seiscomp
+
+
+#endif // SEISCOMP_IO_QUAKELINK_SESSION_H
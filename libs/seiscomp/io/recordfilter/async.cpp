@@ -0,0 +1,239 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT AsyncFilter
+
+#include "async.h"
+
+#include <seiscomp/logging/log.h>
+
+#include <functional>
+
+
+using namespace std;
+using namespace Seiscomp;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace Seiscomp {
+namespace IO {
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AsyncFilter::AsyncFilter(RecordFilterInterface *filter, size_t workers,
+                         size_t queueSize)
+: _template(filter), _queueSize(max(queueSize, size_t(1))) {
+	workers = max(workers, size_t(1));
+
+	for ( size_t i = 0; i < workers; ++i ) {
+		_workers.emplace_back(new Worker);
+		_workers.back()->filter = _template ? _template->clone() : nullptr;
+	}
+
+	for ( auto &worker : _workers )
+		worker->thread = thread(&AsyncFilter::run, this, worker.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AsyncFilter::~AsyncFilter() {
+	{
+		lock_guard<mutex> l(_mutex);
+		_stopped = true;
+	}
+
+	for ( auto &worker : _workers ) {
+		worker->wakeup.notify_all();
+		worker->thread.join();
+	}
+
+	for ( Record *rec : _output )
+		delete rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *AsyncFilter::feed(const Record *rec) {
+	if ( rec ) {
+		size_t index = hash<string>()(rec->streamID()) % _workers.size();
+		push(*_workers[index], Feed, rec);
+		_fed = true;
+	}
+
+	return pop();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *AsyncFilter::flush() {
+	Record *rec = pop();
+	if ( rec || !_fed ) return rec;
+
+	// Flush all records fed since the last flush. This is repeated if
+	// records are fed in between, e.g. by a PipeFilter.
+	broadcast(Flush);
+	_fed = false;
+	return pop();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncFilter::reset() {
+	broadcast(Reset);
+
+	lock_guard<mutex> l(_mutex);
+	for ( Record *rec : _output )
+		delete rec;
+	_output.clear();
+	_processed.clear();
+	_fed = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordFilterInterface *AsyncFilter::clone() const {
+	return new AsyncFilter(_template ? _template->clone() : nullptr,
+	                       _workers.size(), _queueSize);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncFilter::push(Worker &worker, TaskType type, const Record *rec) {
+	unique_lock<mutex> l(_mutex);
+	_space.wait(l, [&]() { return worker.tasks.size() < _queueSize; });
+	worker.tasks.push_back(Task{type, rec});
+	++_pending;
+	worker.wakeup.notify_one();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncFilter::broadcast(TaskType type) {
+	for ( auto &worker : _workers )
+		push(*worker, type, nullptr);
+
+	// Wait until all workers have processed all queued tasks
+	unique_lock<mutex> l(_mutex);
+	_done.wait(l, [this]() { return _pending == 0; });
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *AsyncFilter::pop() {
+	lock_guard<mutex> l(_mutex);
+	_processed.clear();
+
+	if ( _output.empty() ) return nullptr;
+
+	Record *rec = _output.front();
+	_output.pop_front();
+	return rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncFilter::run(Worker *worker) {
+	vector<Record*> output;
+	unique_lock<mutex> l(_mutex);
+
+	while ( true ) {
+		worker->wakeup.wait(l, [&]() { return _stopped || !worker->tasks.empty(); });
+
+		// Queued tasks are processed before the worker stops
+		if ( worker->tasks.empty() ) break;
+
+		Task task = std::move(worker->tasks.front());
+		worker->tasks.pop_front();
+		_space.notify_all();
+		l.unlock();
+
+		RecordFilterInterface *filter = worker->filter.get();
+		Record *rec;
+
+		if ( filter ) {
+			switch ( task.type ) {
+				case Feed:
+					rec = filter->feed(task.record.get());
+					while ( rec ) {
+						output.push_back(rec);
+						rec = filter->feed(nullptr);
+					}
+					break;
+				case Flush:
+					while ( (rec = filter->flush()) )
+						output.push_back(rec);
+					break;
+				case Reset:
+					filter->reset();
+					break;
+			}
+		}
+
+		l.lock();
+		// Reference counting is not thread-safe, the record is released
+		// by the calling thread
+		_processed.push_back(std::move(task.record));
+		_output.insert(_output.end(), output.begin(), output.end());
+		output.clear();
+		--_pending;
+		_done.notify_all();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
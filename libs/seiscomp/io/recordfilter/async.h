@@ -0,0 +1,133 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDFILTER_ASYNC
+#define SEISCOMP_IO_RECORDFILTER_ASYNC
+
+
+#include <seiscomp/io/recordfilter.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+DEFINE_SMARTPOINTER(AsyncFilter);
+
+/**
+ * \brief Runs a record filter on worker threads.
+ *
+ * Each worker runs its own clone of the filter. Records are assigned to
+ * the workers by their stream ID, so all records of a stream are processed
+ * in order by the same worker. If more than one stream is fed, the filter
+ * should be a RecordDemuxFilter.
+ *
+ * feed() queues the record and returns the next record which has been
+ * output by the workers so far, if any. It blocks only if the queue of the
+ * worker is full. Call feed(nullptr) to fetch further output records.
+ * flush() waits until all queued records have been processed, flushes
+ * the filters of all workers and returns the output records one by one.
+ *
+ * Records passed to feed() are referenced until they have been processed
+ * and must therefore be managed by smart pointers. They are not modified
+ * and released only by the calling thread.
+ *
+ * Several stages can be chained with a PipeFilter, each running on its
+ * own threads.
+ */
+class SC_SYSTEM_CORE_API AsyncFilter : public RecordFilterInterface {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! Creates the worker threads.
+		//! Note: the ownership of the filter goes to the async filter
+		//! @param filter The filter to run
+		//! @param workers The number of worker threads
+		//! @param queueSize The maximum number of records queued per
+		//!                  worker
+		AsyncFilter(RecordFilterInterface *filter, size_t workers = 1,
+		            size_t queueSize = 1024);
+		~AsyncFilter() override;
+
+
+	// ----------------------------------------------------------------------
+	//  RecordFilter interface
+	// ----------------------------------------------------------------------
+	public:
+		Record *feed(const Record *rec) override;
+		Record *flush() override;
+		void reset() override;
+		RecordFilterInterface *clone() const override;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		enum TaskType {
+			Feed,
+			Flush,
+			Reset
+		};
+
+		struct Task {
+			TaskType   type;
+			RecordCPtr record;
+		};
+
+		struct Worker {
+			RecordFilterInterfacePtr filter;
+			std::deque<Task>         tasks;
+			std::condition_variable  wakeup;
+			std::thread              thread;
+		};
+
+		void push(Worker &worker, TaskType type, const Record *rec);
+		void broadcast(TaskType type);
+		void run(Worker *worker);
+		Record *pop();
+
+		RecordFilterInterfacePtr             _template;
+		size_t                               _queueSize;
+		std::vector<std::unique_ptr<Worker>> _workers;
+		std::deque<Record*>                  _output;
+		std::vector<RecordCPtr>              _processed;
+		size_t                               _pending{0};
+		bool                                 _fed{false};
+		bool                                 _stopped{false};
+		std::mutex                           _mutex;
+		std::condition_variable              _space;
+		std::condition_variable              _done;
+};
+
+
+}
+}
+
+
+#endif
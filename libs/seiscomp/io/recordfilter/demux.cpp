@@ -66,7 +66,7 @@ Record *RecordDemuxFilter::feed(const Record *rec) {
 	}
 
 	if ( rec ) {
-		auto itp = _streams.insert(FilterMap::value_type(rec->streamID(), _template));
+		auto itp = _streams.insert(FilterMap::value_type(rec->streamKey(), _template));
 		// New slot created
 		if ( itp.second ) {
 			// Is that the first, reuse the template otherwise clone it
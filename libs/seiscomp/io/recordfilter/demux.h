@@ -22,7 +22,7 @@
 #define SEISCOMP_IO_RECORDFILTER_DEMUX_H
 
 #include <seiscomp/io/recordfilter.h>
-#include <map>
+#include <unordered_map>
 
 
 namespace Seiscomp {
@@ -67,7 +67,7 @@ class SC_SYSTEM_CORE_API RecordDemuxFilter : public RecordFilterInterface {
 	//  Private members
 	// ------------------------------------------------------------------
 	private:
-		typedef std::map<std::string, RecordFilterInterfacePtr> FilterMap;
+		typedef std::unordered_map<StreamKey, RecordFilterInterfacePtr> FilterMap;
 		RecordFilterInterfacePtr _template;
 		FilterMap                _streams;
 };
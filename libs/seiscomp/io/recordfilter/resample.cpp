@@ -199,38 +199,14 @@ Array::DataType dataType<int>() {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-int RecordResamplerBase::_instanceCount = 0;
-RecordResamplerBase::CoefficientMap RecordResamplerBase::_coefficients;
-std::mutex RecordResamplerBase::_coefficientMutex;
+RecordResamplerBase::RecordResamplerBase() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-RecordResamplerBase::RecordResamplerBase() {
-	_coefficientMutex.lock();
-	++_instanceCount;
-	_coefficientMutex.unlock();
-}
-// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
-
-// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-RecordResamplerBase::~RecordResamplerBase() {
-	// If the last instance is deleted clean the coefficients table
-	_coefficientMutex.lock();
-	--_instanceCount;
-	if ( _instanceCount == 0 ) {
-		 CoefficientMap::iterator it;
-		 for ( it = _coefficients.begin(); it != _coefficients.end(); ++it )
-				 delete it->second;
-		 _coefficients.clear();
-	}
-	_coefficientMutex.unlock();
-}
+RecordResamplerBase::~RecordResamplerBase() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -313,9 +289,10 @@ void RecordResampler<T>::init(UpsampleStage *stage, const Record *rec, int N) {
 	stage->targetRate = stage->sampleRate*stage->N;
 	stage->width = _lanczosKernelWidth;
 	stage->N2 = stage->width;
+	stage->phases = ResampleDesigns::Lanczos(stage->N, stage->width);
 	// The sample itself, the width to the right and to the left and a buffer
-	// on the left side
-	stage->buffer.resize(stage->width*2+1+1);
+	// on the left side, stored twice
+	stage->buffer.resize((stage->width*2+1+1)*2);
 	stage->dt = 1.0 / stage->sampleRate;
 	stage->reset();
 }
@@ -369,6 +346,7 @@ GenericRecord *RecordResampler<T>::resample(DownsampleStage *stage, const Record
 	size_t data_len = (size_t)ar->size();
 	const T *data = ar->typedData();
 	T *buffer = &stage->buffer[0];
+	size_t length = stage->buffer.size() / 2;
 
 	if ( stage->missingSamples > 0 ) {
 		if ( !stage->startTime.valid() ) {
@@ -396,7 +374,9 @@ GenericRecord *RecordResampler<T>::resample(DownsampleStage *stage, const Record
 		}
 
 		size_t toCopy = std::min(stage->missingSamples, data_len);
-		memcpy(buffer + stage->buffer.size() - stage->missingSamples,
+		memcpy(buffer + length - stage->missingSamples,
+		       data, toCopy*sizeof(T));
+		memcpy(buffer + 2*length - stage->missingSamples,
 		       data, toCopy*sizeof(T));
 		data += toCopy;
 		data_len -= toCopy;
@@ -420,13 +400,9 @@ GenericRecord *RecordResampler<T>::resample(DownsampleStage *stage, const Record
 	do {
 		if ( stage->samplesToSkip == 0 ) {
 			// Calculate scalar product of coefficients and ring buffer
-			double *coeff = &((*stage->coefficients)[0]);
-			double weightedSum = 0;
-
-			for ( size_t i = stage->front; i < stage->buffer.size(); ++i )
-				weightedSum += buffer[i] * *(coeff++);
-			for ( size_t i = 0; i < stage->front; ++i )
-				weightedSum += buffer[i] * *(coeff++);
+			double weightedSum = innerProduct(buffer + stage->front,
+			                                  stage->coefficients->data(),
+			                                  length);
 
 			if ( !resampled_data ) {
 				startTime = stage->startTime;
@@ -444,26 +420,8 @@ GenericRecord *RecordResampler<T>::resample(DownsampleStage *stage, const Record
 
 		size_t num_samples = std::min(stage->samplesToSkip, data_len);
 
-		size_t chunk_size = std::min(num_samples, stage->buffer.size()-stage->front);
-		memcpy(buffer + stage->front, data, chunk_size*sizeof(T));
-
-		data += chunk_size;
-
-		// Split chunks
-		if ( chunk_size < num_samples ) {
-			chunk_size = num_samples - chunk_size;
-
-			memcpy(buffer, data, chunk_size*sizeof(T));
-
-			stage->front = chunk_size;
-
-			data += chunk_size;
-		}
-		else {
-			stage->front += chunk_size;
-			if ( stage->front >= stage->buffer.size() )
-				stage->front -= stage->buffer.size();
-		}
+		pushRing(buffer, length, stage->front, data, num_samples);
+		data += num_samples;
 
 		stage->samplesToSkip -= num_samples;
 		data_len -= num_samples;
@@ -538,11 +496,14 @@ GenericRecord *RecordResampler<T>::resample(UpsampleStage *stage, const Record *
 
 	const T *data = ar->typedData();
 	T *buffer = &stage->buffer[0];
+	size_t length = stage->buffer.size() / 2;
 	Core::Time startTime;
 
 	if ( stage->missingSamples > 0 ) {
 		size_t toCopy = std::min(stage->missingSamples, data_len);
-		memcpy(buffer + stage->buffer.size() - stage->missingSamples,
+		memcpy(buffer + length - stage->missingSamples,
+		       data, toCopy*sizeof(T));
+		memcpy(buffer + 2*length - stage->missingSamples,
 		       data, toCopy*sizeof(T));
 		data += toCopy;
 		data_len -= toCopy;
@@ -570,46 +531,20 @@ GenericRecord *RecordResampler<T>::resample(UpsampleStage *stage, const Record *
 
 	resampled_data = new TypedArray<T>;
 
-	while ( data_len > 0 ) {
-		double xi = 0.0;
-
-		// Generate N new samples (upsampling)
-		for ( int n = 0; n < stage->N; ++n ) {
-			// Calculate Lanzcos kernel
-			double weightedSum = 0;
-			int a = -stage->width;
-			size_t bi = stage->front;
-
-			for ( ; a <= stage->width; ++a, ++bi ) {
-				if ( bi == stage->buffer.size() ) bi -= stage->buffer.size();
-				weightedSum += buffer[bi]*Lanczos(xi-a,stage->width);
-			}
-
-			xi += stage->downRatio;
+	size_t taps = stage->width*2+1;
+	const double *phases = stage->phases->data();
+	resampled_data->resize(static_cast<int>(data_len*stage->N));
+	T *out = resampled_data->typedData();
 
-			T sample = (T)weightedSum;
-			resampled_data->append(1, &sample);
-		}
+	while ( data_len > 0 ) {
+		// Generate N new samples (upsampling) with the precomputed
+		// Lanczos kernel of each phase
+		for ( int n = 0; n < stage->N; ++n )
+			*out++ = (T)innerProduct(buffer + stage->front, phases + n*taps, taps);
 
 		// Push the sample to the ring buffer
-		size_t chunk_size = std::min((size_t)1, stage->buffer.size()-stage->front);
-		memcpy(buffer + stage->front, data, chunk_size*sizeof(T));
-
-		data += chunk_size;
-
-		// Split chunks
-		if ( chunk_size < 1 ) {
-			chunk_size = 1 - chunk_size;
-			memcpy(buffer, data, chunk_size*sizeof(T));
-			stage->front = chunk_size;
-			data += chunk_size;
-		}
-		else {
-			stage->front += chunk_size;
-			if ( stage->front >= stage->buffer.size() )
-				stage->front -= stage->buffer.size();
-		}
-
+		pushRing(buffer, length, stage->front, data, 1);
+		++data;
 		--data_len;
 	}
 
@@ -736,93 +671,56 @@ Record *RecordResampler<T>::feed(const Record *record) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 void RecordResampler<T>::initCoefficients(DownsampleStage *stage) {
-	_coefficientMutex.lock();
-
 	stage->valid = true;
 
-	CoefficientMap::iterator it = _coefficients.find(stage->N);
-	if ( it != _coefficients.end() )
-		stage->coefficients = it->second;
-	else {
-		stage->coefficients = nullptr;
-
-		if ( stage->N > _maxN ) {
-			for ( int i = _maxN; i > 1; --i ) {
-				if ( stage->N % i == 0 ) {
-					_coefficientMutex.unlock();
-
-					int nextStageN = stage->N / i;
-					if ( nextStageN > _maxN ) {
-						SEISCOMP_WARNING("[dec] max decimations exceeded: %d > %d",
-						                 nextStageN, _maxN);
-						stage->valid = false;
-						return;
-					}
-
-					//SEISCOMP_DEBUG("[dec] clipping N=%d to %d and create sub stage",
-					//               stage->N, i);
-
-					stage->N = i;
-					stage->targetRate = stage->sampleRate / stage->N;
+	if ( stage->N > _maxN ) {
+		for ( int i = _maxN; i > 1; --i ) {
+			if ( stage->N % i == 0 ) {
+				int nextStageN = stage->N / i;
+				if ( nextStageN > _maxN ) {
+					SEISCOMP_WARNING("[dec] max decimations exceeded: %d > %d",
+					                 nextStageN, _maxN);
+					stage->valid = false;
+					return;
+				}
 
-					DownsampleStage *nextStage = new DownsampleStage;
-					nextStage->sampleRate = stage->targetRate;
-					nextStage->targetRate = _targetRate;
-					nextStage->N = nextStageN;
+				//SEISCOMP_DEBUG("[dec] clipping N=%d to %d and create sub stage",
+				//               stage->N, i);
 
-					initCoefficients(nextStage);
+				stage->N = i;
+				stage->targetRate = stage->sampleRate / stage->N;
 
-					if ( !nextStage->valid ) {
-						delete nextStage;
-						stage->valid = false;
-						return;
-					}
-					else {
-						stage->nextStage = nextStage;
-					}
+				DownsampleStage *nextStage = new DownsampleStage;
+				nextStage->sampleRate = stage->targetRate;
+				nextStage->targetRate = _targetRate;
+				nextStage->N = nextStageN;
 
-					_coefficientMutex.lock();
+				initCoefficients(nextStage);
 
-					break;
+				if ( !nextStage->valid ) {
+					delete nextStage;
+					stage->valid = false;
+					return;
 				}
-			}
-
-			CoefficientMap::iterator it = _coefficients.find(stage->N);
-			if ( it != _coefficients.end() )
-				stage->coefficients = it->second;
-		}
-
-		if ( stage->coefficients == nullptr ) {
-			// Create and cache coefficients for N
-			int Ncoeff = stage->N*_coeffScale*2+1;
-
-			Coefficients *coeff = new Coefficients(Ncoeff);
 
-			double bands[4] = {0,0.5*(_fp/stage->N),0.5*(_fs/stage->N),0.5};
-			double weights[2] = {1,1};
-			double desired[2] = {1,0};
-
-			if ( remez(&((*coeff)[0]), Ncoeff, 2, bands, desired, weights, BANDPASS) ) {
-				SEISCOMP_WARNING("[dec] failed to build coefficients for N=%d, ignore stream", stage->N);
-				stage->valid = false;
-				delete coeff;
-				_coefficientMutex.unlock();
-				return;
+				stage->nextStage = nextStage;
+				break;
 			}
-
-			SEISCOMP_DEBUG("[dec] caching %d coefficents for N=%d", Ncoeff, stage->N);
-
-			_coefficients[stage->N] = coeff;
-			stage->coefficients = coeff;
 		}
 	}
 
+	// The designs are shared by all instances
+	stage->coefficients = ResampleDesigns::Lowpass(stage->N, _fp, _fs, _coeffScale);
+	if ( !stage->coefficients ) {
+		SEISCOMP_WARNING("[dec] no coefficients for N=%d, ignore stream", stage->N);
+		stage->valid = false;
+		return;
+	}
+
 	stage->dt = 1.0 / stage->sampleRate;
 	stage->N2 = stage->coefficients->size() / 2;
-	stage->buffer.resize(stage->coefficients->size());
+	stage->buffer.resize(stage->coefficients->size()*2);
 	stage->reset();
-
-	_coefficientMutex.unlock();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -23,11 +23,10 @@
 
 
 #include <seiscomp/io/recordfilter.h>
+#include <seiscomp/io/recordfilter/resampledesigns.h>
 #include <seiscomp/core/genericrecord.h>
 
-#include <mutex>
 #include <deque>
-#include <map>
 
 
 namespace Seiscomp {
@@ -46,13 +45,6 @@ class SC_SYSTEM_CORE_API RecordResamplerBase : public RecordFilterInterface {
 		virtual void reset();
 
 	protected:
-		typedef std::vector<double> Coefficients;
-		typedef std::map<int, Coefficients*> CoefficientMap;
-
-		static int                   _instanceCount;
-		static CoefficientMap        _coefficients;
-		static std::mutex            _coefficientMutex;
-
 		double                       _currentRate;
 		double                       _targetRate;
 		double                       _fp;
@@ -113,6 +105,7 @@ class SC_SYSTEM_CORE_API RecordResampler : public RecordResamplerBase {
 			int N2;
 
 			// The ring buffer that holds the last samples for downsampling.
+			// It is stored twice in a row, see pushRing.
 			std::vector<T> buffer;
 
 			// The number of samples still missing in the buffer before
@@ -129,7 +122,7 @@ class SC_SYSTEM_CORE_API RecordResampler : public RecordResamplerBase {
 			Seiscomp::Core::Time lastEndTime;
 
 			void reset() {
-				missingSamples = buffer.size();
+				missingSamples = buffer.size() / 2;
 				front = 0;
 				startTime = Seiscomp::Core::Time();
 				lastEndTime = Seiscomp::Core::Time();
@@ -148,7 +141,7 @@ class SC_SYSTEM_CORE_API RecordResampler : public RecordResamplerBase {
 
 			size_t samplesToSkip;
 
-			Coefficients *coefficients;
+			ResampleDesigns::CoefficientsCPtr coefficients;
 
 			DownsampleStage *nextStage;
 
@@ -162,6 +155,9 @@ class SC_SYSTEM_CORE_API RecordResampler : public RecordResamplerBase {
 		struct UpsampleStage : Stage {
 			double downRatio;
 			int width;
+
+			// The Lanczos kernel of each of the N output phases
+			ResampleDesigns::CoefficientsCPtr phases;
 		};
 
 		void initCoefficients(DownsampleStage *stage);
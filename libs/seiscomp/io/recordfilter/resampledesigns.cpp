@@ -0,0 +1,138 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT Resample
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/math/math.h>
+#include <seiscomp/io/recordstream/remez/remez.h>
+#include <seiscomp/io/recordfilter/resampledesigns.h>
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+namespace {
+
+
+typedef std::tuple<int, double, double, int> LowpassKey;
+typedef std::pair<int, int> LanczosKey;
+
+std::mutex designMutex;
+std::map<LowpassKey, ResampleDesigns::CoefficientsCPtr> lowpassDesigns;
+std::map<LanczosKey, ResampleDesigns::CoefficientsCPtr> lanczosDesigns;
+
+
+// sinc(x*PI)
+double sincpi(double x) {
+	if ( x == 0.0 ) return 1.0;
+	return sin(M_PI*x) / (M_PI*x);
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ResampleDesigns::CoefficientsCPtr
+ResampleDesigns::Lowpass(int N, double fp, double fs, int coeffScale) {
+	std::lock_guard<std::mutex> l(designMutex);
+
+	LowpassKey key(N, fp, fs, coeffScale);
+	auto it = lowpassDesigns.find(key);
+	if ( it != lowpassDesigns.end() )
+		return it->second;
+
+	// Failed designs are cached as well to not run them again
+	CoefficientsCPtr &design = lowpassDesigns[key];
+
+	int Ncoeff = N*coeffScale*2+1;
+	std::shared_ptr<Coefficients> coeff = std::make_shared<Coefficients>(Ncoeff);
+
+	double bands[4] = {0,0.5*(fp/N),0.5*(fs/N),0.5};
+	double weights[2] = {1,1};
+	double desired[2] = {1,0};
+
+	if ( remez(coeff->data(), Ncoeff, 2, bands, desired, weights, BANDPASS) ) {
+		SEISCOMP_WARNING("[dec] failed to build coefficients for N=%d", N);
+		return design;
+	}
+
+	SEISCOMP_DEBUG("[dec] caching %d coefficents for N=%d, fp=%f, fs=%f",
+	               Ncoeff, N, fp, fs);
+
+	design = coeff;
+	return design;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ResampleDesigns::CoefficientsCPtr ResampleDesigns::Lanczos(int N, int width) {
+	std::lock_guard<std::mutex> l(designMutex);
+
+	LanczosKey key(N, width);
+	auto it = lanczosDesigns.find(key);
+	if ( it != lanczosDesigns.end() )
+		return it->second;
+
+	int taps = width*2+1;
+	std::shared_ptr<Coefficients> coeff = std::make_shared<Coefficients>(N*taps);
+
+	for ( int n = 0; n < N; ++n ) {
+		double x = (double)n / N;
+		for ( int a = -width; a <= width; ++a ) {
+			double d = x - a;
+			(*coeff)[n*taps+a+width] = (-width < d && d < width)
+			                         ? sincpi(d) * sincpi(d/width) : 0;
+		}
+	}
+
+	lanczosDesigns[key] = coeff;
+	return coeff;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t ResampleDesigns::Size() {
+	std::lock_guard<std::mutex> l(designMutex);
+	return lowpassDesigns.size() + lanczosDesigns.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
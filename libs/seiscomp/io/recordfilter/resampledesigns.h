@@ -0,0 +1,120 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDFILTER_RESAMPLEDESIGNS_H
+#define SEISCOMP_IO_RECORDFILTER_RESAMPLEDESIGNS_H
+
+
+#include <seiscomp/core.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+/**
+ * @brief Process wide cache of the filter designs used by the resamplers.
+ *
+ * Designs are shared by all RecordResampler instances and the decimation
+ * RecordStream. A design is computed once per parameter set and kept for
+ * the lifetime of the process.
+ */
+class SC_SYSTEM_CORE_API ResampleDesigns {
+	public:
+		typedef std::vector<double> Coefficients;
+		typedef std::shared_ptr<const Coefficients> CoefficientsCPtr;
+
+	public:
+		/**
+		 * @brief Returns the anti-alias lowpass for decimation by N designed
+		 *        with the Remez exchange algorithm.
+		 * @param N The decimation factor
+		 * @param fp The end of the passband relative to the target Nyquist
+		 *           frequency
+		 * @param fs The start of the stopband relative to the target Nyquist
+		 *           frequency
+		 * @param coeffScale The number of coefficients per side and factor
+		 * @return The N*coeffScale*2+1 coefficients or nullptr if the design
+		 *         failed
+		 */
+		static CoefficientsCPtr Lowpass(int N, double fp, double fs, int coeffScale);
+
+		/**
+		 * @brief Returns the polyphase decomposition of the Lanczos
+		 *        interpolation kernel for upsampling by N.
+		 * @param N The upsampling factor
+		 * @param width The kernel width
+		 * @return N phases of width*2+1 coefficients each. Phase n
+		 *         interpolates at n/N samples after the kernel center.
+		 */
+		static CoefficientsCPtr Lanczos(int N, int width);
+
+		//! Returns the number of cached designs
+		static size_t Size();
+};
+
+
+/**
+ * @brief Computes the inner product of samples and coefficients. The sum is
+ *        split into four independent accumulators which allows the compiler
+ *        to vectorize the loop.
+ */
+template <typename T>
+inline double innerProduct(const T *x, const double *c, size_t n) {
+	double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+
+	for ( ; i + 4 <= n; i += 4 ) {
+		s0 += x[i] * c[i];
+		s1 += x[i+1] * c[i+1];
+		s2 += x[i+2] * c[i+2];
+		s3 += x[i+3] * c[i+3];
+	}
+
+	for ( ; i < n; ++i )
+		s0 += x[i] * c[i];
+
+	return (s0 + s1) + (s2 + s3);
+}
+
+
+/**
+ * @brief Adds samples to a ring buffer of length n which is stored twice in
+ *        a row. The n samples starting at front are then always contiguous
+ *        and can be passed to innerProduct.
+ */
+template <typename T>
+inline void pushRing(T *buffer, size_t n, size_t &front, const T *data, size_t count) {
+	for ( size_t i = 0; i < count; ++i ) {
+		buffer[front] = buffer[front+n] = data[i];
+		if ( ++front == n ) front = 0;
+	}
+}
+
+
+}
+}
+
+
+#endif
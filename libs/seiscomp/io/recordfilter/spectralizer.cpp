@@ -147,6 +147,8 @@ Spectralizer::Options::Options() {
 	specSamples = -1;
 	taperWidth = 0.05;
 	noalign = false;
+	welchLength = 0;
+	welchOverlap = 0.5;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -164,6 +166,9 @@ Spectralizer::Spectralizer() {
 	_filter = nullptr;
 	// Default taper width is 5%
 	_taperWidth = 0.05;
+	// Welch averaging is disabled by default
+	_welchLength = 0;
+	_welchOverlap = 0.5;
 	_buffer = nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -192,12 +197,19 @@ bool Spectralizer::setOptions(const Options &opts) {
 	SEISCOMP_DEBUG("[spec] samples = %d", opts.specSamples);
 	SEISCOMP_DEBUG("[spec] filter = %s", opts.filter.c_str());
 	SEISCOMP_DEBUG("[spec] taperWidth = %f", _taperWidth);
+	SEISCOMP_DEBUG("[spec] welchLength = %fs", opts.welchLength);
+	SEISCOMP_DEBUG("[spec] welchOverlap = %f%%", opts.welchOverlap*100);
 
 	if ( opts.windowOverlap < 1 )
 		_timeStep = _windowLength * (1-opts.windowOverlap);
 	else
 		return false;
 
+	if ( opts.welchOverlap < 0 || opts.welchOverlap >= 1 )
+		return false;
+
+	_welchLength = opts.welchLength;
+	_welchOverlap = opts.welchOverlap;
 	_specSamples = opts.specSamples;
 	_noalign = opts.noalign;
 
@@ -238,6 +250,42 @@ void Spectralizer::init(const Record *rec) {
 	_buffer->tmpOffset = 0;
 	_buffer->tmp.resize(_buffer->buffer.size() + _buffer->tmpOffset*2);
 	_buffer->tmp.fill(0.0);
+
+	size_t n = _buffer->buffer.size();
+	_buffer->segmentLength = n;
+	_buffer->segmentStep = n;
+	_buffer->segmentCount = 1;
+
+	if ( _welchLength > 0 ) {
+		size_t length = size_t(_buffer->sampleRate*_welchLength + 0.5);
+		if ( length > 0 && length < n ) {
+			_buffer->segmentLength = length;
+			_buffer->segmentStep = max(size_t(length*(1-_welchOverlap) + 0.5), size_t(1));
+			_buffer->segmentCount = (n-length) / _buffer->segmentStep + 1;
+		}
+	}
+
+	_buffer->window.assign(_buffer->segmentLength, 1.0);
+	Math::HannWindow<double>().apply(_buffer->segmentLength, _buffer->window.data(), _taperWidth);
+
+	if ( _welchLength > 0 ) {
+		// One-sided power spectral density scaling
+		double sum = 0;
+		for ( double w : _buffer->window )
+			sum += w*w;
+		_buffer->psdScale = sum > 0 ? 1.0 / (_buffer->sampleRate*sum) : 0;
+		_buffer->segments.resize(_buffer->segmentCount*_buffer->segmentLength);
+		_buffer->segmentData.resize(_buffer->segmentCount);
+		for ( size_t i = 0; i < _buffer->segmentCount; ++i )
+			_buffer->segmentData[i] = _buffer->segments.data() + i*_buffer->segmentLength;
+	}
+	else {
+		_buffer->psdScale = 0;
+		_buffer->segments.clear();
+		_buffer->segmentData.clear();
+	}
+
+	_buffer->segmentSpectra.clear();
 	_buffer->reset(_filter);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -362,15 +410,23 @@ Record *Spectralizer::fft(const Record *rec) {
 
 			size_t sampleCount = _buffer->buffer.size();
 
-			// Demean data excluding the padding window
-			demean(_buffer->tmp.size()-_buffer->tmpOffset*2, _buffer->tmp.typedData()+_buffer->tmpOffset);
-			// Detrend data excluding the padding window
-			detrend(_buffer->tmp.size()-_buffer->tmpOffset*2, _buffer->tmp.typedData()+_buffer->tmpOffset);
-			// Apply Von-Hann window
-			Math::HannWindow<double>().apply(_buffer->tmp.size()-_buffer->tmpOffset*2, _buffer->tmp.typedData()+_buffer->tmpOffset, _taperWidth);
-
-			spec = new ComplexDoubleArray;
-			Math::fft(spec->impl(), _buffer->tmp.size(), _buffer->tmp.typedData());
+			if ( _buffer->psdScale > 0 )
+				spec = welch();
+			else {
+				int n = _buffer->tmp.size()-_buffer->tmpOffset*2;
+				double *samples = _buffer->tmp.typedData()+_buffer->tmpOffset;
+
+				// Demean data excluding the padding window
+				demean(n, samples);
+				// Detrend data excluding the padding window
+				detrend(n, samples);
+				// Apply the precomputed Von-Hann window
+				for ( int i = 0; i < n; ++i )
+					samples[i] *= _buffer->window[i];
+
+				spec = new ComplexDoubleArray;
+				Math::fft(spec->impl(), _buffer->tmp.size(), _buffer->tmp.typedData());
+			}
 
 			if ( _specSamples > 0 )
 				reduce<Mag>(*spec, _specSamples);
@@ -381,6 +437,7 @@ Record *Spectralizer::fft(const Record *rec) {
 				                        _timeStep, _buffer->sampleRate*0.5,
 				                        (int)sampleCount/2);
 				spectrum->setData(spec.get());
+				spectrum->setPowerSpectralDensity(_buffer->psdScale > 0);
 				_nextSpectra.push_back(spectrum);
 			}
 
@@ -425,6 +482,50 @@ Record *Spectralizer::fft(const Record *rec) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ComplexDoubleArray *Spectralizer::welch() {
+	const double *samples = _buffer->tmp.typedData()+_buffer->tmpOffset;
+	size_t length = _buffer->segmentLength;
+
+	// Prepare all segments and transform them with a single call
+	for ( size_t i = 0; i < _buffer->segmentCount; ++i ) {
+		double *segment = _buffer->segments.data() + i*length;
+		memcpy(segment, samples + i*_buffer->segmentStep, length*sizeof(double));
+		demean(length, segment);
+		detrend(length, segment);
+		for ( size_t j = 0; j < length; ++j )
+			segment[j] *= _buffer->window[j];
+	}
+
+	Math::fft(_buffer->segmentSpectra, _buffer->segmentCount, length,
+	          _buffer->segmentData.data());
+
+	size_t bins = _buffer->segmentSpectra[0].size();
+	ComplexDoubleArray *psd = new ComplexDoubleArray(bins);
+	Math::Complex *out = psd->typedData();
+
+	for ( const auto &spectrum : _buffer->segmentSpectra ) {
+		// The first bin is real, its imaginary part holds the Nyquist
+		// frequency with the built-in fft
+		out[0] += spectrum[0].real()*spectrum[0].real();
+		for ( size_t i = 1; i < bins; ++i )
+			out[i] += norm(spectrum[i]);
+	}
+
+	// Average and double all but the zero frequency to account for the
+	// negative frequencies
+	double scale = _buffer->psdScale / _buffer->segmentCount;
+	out[0] *= scale;
+	for ( size_t i = 1; i < bins; ++i )
+		out[i] *= 2*scale;
+
+	return psd;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
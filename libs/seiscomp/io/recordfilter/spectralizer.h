@@ -26,6 +26,7 @@
 #include <deque>
 
 #include <seiscomp/math/filter.h>
+#include <seiscomp/math/fft.h>
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/core/genericrecord.h>
 
@@ -48,7 +49,14 @@ class SC_SYSTEM_CORE_API Spectrum : public Core::BaseObject {
 			_data = data;
 		}
 
+		//! Marks the data as power spectral density. The real part of
+		//! each sample holds the density and the imaginary part is zero.
+		void setPowerSpectralDensity(bool psd) {
+			_psd = psd;
+		}
+
 		bool isValid() const { return _data && _data->size() > 0; }
+		bool isPowerSpectralDensity() const { return _psd; }
 
 		const ComplexDoubleArray *data() const { return _data.get(); }
 		ComplexDoubleArray *data() { return _data.get(); }
@@ -70,6 +78,7 @@ class SC_SYSTEM_CORE_API Spectrum : public Core::BaseObject {
 		Core::TimeSpan        _dt;
 		int                   _sampleCount;
 		double                _frequency;
+		bool                  _psd{false};
 		ComplexDoubleArrayPtr _data;
 };
 
@@ -106,7 +115,18 @@ class SC_SYSTEM_CORE_API Spectralizer : public Core::BaseObject {
 			bool        noalign;
 			//! The taper width applied to either side of the processed time
 			//! window given as fraction of windowLength, e.g. 0.05 for 5%.
+			//! With Welch averaging the taper is applied to each segment.
 			double      taperWidth;
+			//! The segment length in seconds for Welch averaging. If
+			//! positive, each window is split into overlapping segments
+			//! whose power spectral densities are averaged. The output
+			//! spectra then hold the power spectral density, see
+			//! Spectrum::isPowerSpectralDensity. The default is 0 which
+			//! transforms each window as a whole.
+			double      welchLength;
+			//! The overlap of subsequent segments as fraction of
+			//! welchLength. This value must be in [0,1).
+			double      welchOverlap;
 		};
 
 
@@ -162,6 +182,19 @@ class SC_SYSTEM_CORE_API Spectralizer : public Core::BaseObject {
 			DoubleArray tmp;
 			int tmpOffset;
 
+			// The window function of a segment which is computed once
+			// per segment length.
+			std::vector<double> window;
+
+			// The Welch segments transformed with a single fft call.
+			size_t segmentLength;
+			size_t segmentStep;
+			size_t segmentCount;
+			double psdScale;
+			std::vector<double> segments;
+			std::vector<const double*> segmentData;
+			std::vector<Math::ComplexArray> segmentSpectra;
+
 			size_t samplesToSkip;
 
 			// The number of samples still missing in the buffer before
@@ -195,12 +228,15 @@ class SC_SYSTEM_CORE_API Spectralizer : public Core::BaseObject {
 
 		void init(const Record *rec);
 		Record *fft(const Record *rec);
+		ComplexDoubleArray *welch();
 
 		double                        _windowLength;
 		double                        _timeStep;
 		bool                          _noalign;
 		int                           _specSamples;
 		double                        _taperWidth;
+		double                        _welchLength;
+		double                        _welchOverlap;
 		FilterPtr                     _filter;
 		SpecBuffer                   *_buffer;
 		std::deque<Spectrum*>         _nextSpectra;
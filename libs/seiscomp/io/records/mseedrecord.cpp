@@ -21,7 +21,9 @@
 #define SEISCOMP_COMPONENT MSEEDRECORD
 #include <seiscomp/logging/log.h>
 #include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/io/records/steim.h>
 #include <seiscomp/core/arrayfactory.h>
+#include <seiscomp/core/recordpool.h>
 #include <seiscomp/utils/certstore.h>
 
 #include <openssl/asn1.h>
@@ -53,6 +55,100 @@ void _Record_Handler(char *record, int reclen, void *packed) {
 }
 
 
+template <typename T>
+bool assignSamples(Array *target, Array::DataType caller, int size, const void *data) {
+	auto &impl = static_cast<TypedArray<T>*>(target)->impl();
+
+	switch ( caller ) {
+		case Array::CHAR:
+			impl.assign(static_cast<const char*>(data), static_cast<const char*>(data) + size);
+			return true;
+		case Array::INT:
+			impl.assign(static_cast<const int32_t*>(data), static_cast<const int32_t*>(data) + size);
+			return true;
+		case Array::FLOAT:
+			impl.assign(static_cast<const float*>(data), static_cast<const float*>(data) + size);
+			return true;
+		case Array::DOUBLE:
+			impl.assign(static_cast<const double*>(data), static_cast<const double*>(data) + size);
+			return true;
+		default:
+			return false;
+	}
+}
+
+
+/* creates the sample array, recycled arrays are used if the record pool
+ * is enabled */
+ArrayPtr createSamples(Array::DataType toCreate, Array::DataType caller,
+                       int size, const void *data) {
+	if ( RecordPool::capacity() ) {
+		ArrayPtr array = RecordPool::createArray(toCreate);
+		bool assigned = false;
+
+		switch ( toCreate ) {
+			case Array::CHAR:
+				assigned = assignSamples<char>(array.get(), caller, size, data);
+				break;
+			case Array::INT:
+				assigned = assignSamples<int32_t>(array.get(), caller, size, data);
+				break;
+			case Array::FLOAT:
+				assigned = assignSamples<float>(array.get(), caller, size, data);
+				break;
+			case Array::DOUBLE:
+				assigned = assignSamples<double>(array.get(), caller, size, data);
+				break;
+			default:
+				break;
+		}
+
+		if ( assigned ) return array;
+		RecordPool::recycle(array);
+	}
+
+	return ArrayFactory::Create(toCreate, caller, size, data);
+}
+
+
+/* decodes the Steim frames of a record unpacked without data samples */
+int decodeSteim(const MSRecord *pmsr, int nsamp, Array::DataType dt,
+                ArrayPtr &data) {
+	int offset = pmsr->fsdh->data_offset;
+	if ( (offset <= 0) || (offset >= pmsr->reclen) ) return -1;
+
+	IntArrayPtr samples = static_cast<IntArray*>(RecordPool::createArray(Array::INT).get());
+	samples->resize(nsamp);
+	int32_t last;
+	int nframes = (pmsr->reclen - offset) / Steim::FrameSize;
+	int n;
+
+	if ( pmsr->encoding == DE_STEIM1 )
+		n = Steim::decode1(pmsr->record + offset, nframes, pmsr->byteorder != 0,
+		                   samples->typedData(), nsamp, &last);
+	else
+		n = Steim::decode2(pmsr->record + offset, nframes, pmsr->byteorder != 0,
+		                   samples->typedData(), nsamp, &last);
+
+	if ( n != nsamp ) return n;
+
+	if ( n && (samples->get(n-1) != last) )
+		SEISCOMP_WARNING("MSEED: Steim integrity check failed, last sample=%d, Xn=%d",
+		                 samples->get(n-1), last);
+
+	if ( dt == Array::INT )
+		data = samples;
+	else {
+		data = createSamples(dt, Array::INT, n, samples->typedData());
+		ArrayPtr tmp = samples;
+		samples = nullptr;
+		RecordPool::recycle(tmp);
+	}
+
+	return n;
+}
+
+
 bool isPowerOfTwo(size_t n) {
 	if ( !n ) return false;
 
@@ -117,34 +213,47 @@ MSeedRecord::MSeedRecord(Array::DataType dt, Hint h)
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 MSeedRecord::MSeedRecord(MSRecord *rec, Array::DataType dt, Hint h)
-: Record(dt, h, rec->network, rec->station, rec->location, rec->channel,
-         Seiscomp::Core::Time(hptime_t(rec->starttime / HPTMODULUS),
-                              hptime_t(rec->starttime % HPTMODULUS)),
-         int(rec->samplecnt), rec->samprate, rec->Blkt1001 ? rec->Blkt1001->timing_qual : -1)
+: Record(dt, h)
 , _data(0)
-, _seqno(rec->sequence_number)
-, _rectype(rec->dataquality)
-, _srfact(rec->fsdh->samprate_fact)
-, _srmult(rec->fsdh->samprate_mult)
-, _byteorder(rec->byteorder)
-, _encoding(rec->encoding)
-, _reclen(rec->reclen)
 , _encodingFlag(true)
 {
+	_setHeader(rec);
+
 	if ( _hint == SAVE_RAW ) {
 		_raw.setData(rec->reclen,rec->record);
 	}
 	else if ( _hint == DATA_ONLY ) {
-		try {
-			_setDataAttributes(rec->reclen, rec->record);
-		}
-		catch ( LibmseedException &e ) {
-			_nsamp = 0;
-			_fsamp = 0;
-			_data = nullptr;
-			SEISCOMP_ERROR("%s", e.what());
-		}
+		_decodeData(rec);
 	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MSeedRecord::_setHeader(MSRecord *rec) {
+	_net = rec->network;
+	_sta = rec->station;
+	_loc = rec->location;
+	_cha = rec->channel;
+	_streamKey.store(0, std::memory_order_relaxed);
+	_stime = Seiscomp::Core::Time(hptime_t(rec->starttime / HPTMODULUS),
+	                              hptime_t(rec->starttime % HPTMODULUS));
+	_nsamp = int(rec->samplecnt);
+	_fsamp = rec->samprate;
+	_timequal = rec->Blkt1001 ? rec->Blkt1001->timing_qual : -1;
+	_authenticationStatus = NOT_SIGNED;
+	_authority.clear();
+
+	RecordPool::recycle(_data);
+	_seqno = rec->sequence_number;
+	_rectype = rec->dataquality;
+	_srfact = rec->fsdh->samprate_fact;
+	_srmult = rec->fsdh->samprate_mult;
+	_byteorder = rec->byteorder;
+	_encoding = rec->encoding;
+	_reclen = rec->reclen;
 
 	_srnum = 0;
 	_srdenom = 1;
@@ -187,6 +296,23 @@ MSeedRecord::MSeedRecord(MSRecord *rec, Array::DataType dt, Hint h)
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MSeedRecord::_decodeData(MSRecord *rec) {
+	try {
+		_setDataAttributes(rec->reclen, rec->record);
+	}
+	catch ( LibmseedException &e ) {
+		_nsamp = 0;
+		_fsamp = 0;
+		_data = nullptr;
+		SEISCOMP_ERROR("%s", e.what());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 MSeedRecord::MSeedRecord(const MSeedRecord &msrec)
 : Record(msrec)
@@ -237,7 +363,9 @@ MSeedRecord::MSeedRecord(const Record &rec, int reclen)
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-MSeedRecord::~MSeedRecord() {}
+MSeedRecord::~MSeedRecord() {
+	RecordPool::recycle(_data);
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -522,33 +650,42 @@ void MSeedRecord::_setDataAttributes(int reclen, char *data) const {
 
 	if ( !data ) return;
 
-	int r = msr_unpack(data, reclen, &pmsr, 1, 0);
+	// Steim compressed samples are decoded natively into the sample
+	// array, libmseed just unpacks the header and the blockettes then.
+	bool steim = (_encoding == DE_STEIM1) || (_encoding == DE_STEIM2);
+
+	int r = msr_unpack(data, reclen, &pmsr, steim ? 0 : 1, 0);
 	if ( r != MS_NOERROR ) {
 		throw LibmseedException(fmt::format("Unpacking of Mini SEED record failed: {}", r));
 	}
 
 	Array::DataType dt = _datatype;
-	_data = nullptr;
+	RecordPool::recycle(_data);
+
+	if ( steim )
+		pmsr->numsamples = decodeSteim(pmsr, _nsamp, dt, _data);
 
 	if ( pmsr->numsamples == _nsamp ) {
-		switch ( pmsr->sampletype ) {
-			case 'i':
-				_data = ArrayFactory::Create(dt, Array::INT, _nsamp, pmsr->datasamples);
-				break;
-			case 'f':
-				_data = ArrayFactory::Create(dt, Array::FLOAT, _nsamp, pmsr->datasamples);
-				break;
-			case 'd':
-				if ( dt < Array::DOUBLE ) {
-					// We need double precision in order to store doubles.
-					dt = Array::DOUBLE;
-				}
+		if ( !steim ) {
+			switch ( pmsr->sampletype ) {
+				case 'i':
+					_data = createSamples(dt, Array::INT, _nsamp, pmsr->datasamples);
+					break;
+				case 'f':
+					_data = createSamples(dt, Array::FLOAT, _nsamp, pmsr->datasamples);
+					break;
+				case 'd':
+					if ( dt < Array::DOUBLE ) {
+						// We need double precision in order to store doubles.
+						dt = Array::DOUBLE;
+					}
 
-				_data = ArrayFactory::Create(dt, Array::DOUBLE, _nsamp, pmsr->datasamples);
-				break;
-			case 'a':
-				_data = ArrayFactory::Create(dt, Array::CHAR, _nsamp, pmsr->datasamples);
-				break;
+					_data = createSamples(dt, Array::DOUBLE, _nsamp, pmsr->datasamples);
+					break;
+				case 'a':
+					_data = createSamples(dt, Array::CHAR, _nsamp, pmsr->datasamples);
+					break;
+			}
 		}
 
 		// Check authentication
@@ -661,7 +798,7 @@ void MSeedRecord::_setDataAttributes(int reclen, char *data) const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void MSeedRecord::saveSpace() const {
 	if (_hint == SAVE_RAW && _data) {
-		_data = 0;
+		RecordPool::recycle(_data);
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -865,12 +1002,27 @@ void MSeedRecord::read(std::istream &is) {
 		throw Core::EndOfStreamException("Invalid Mini SEED record, too small");
 	}
 
+	// Only the header is unpacked here. With the SAVE_RAW hint the samples
+	// are decoded from the raw record on the first call to data().
 	int r = msr_unpack(buffer.data(), reclen, &prec, 0, 0);
 	if ( r != MS_NOERROR ) {
 		throw LibmseedException(fmt::format("Unpacking of Mini SEED record failed: {}", r));
 	}
 
-	*this = MSeedRecord(prec, this->_datatype, this->_hint);
+	// Populate the attributes in place rather than through a temporary
+	// record which would copy the raw data twice
+	_setHeader(prec);
+
+	if ( _hint == SAVE_RAW ) {
+		buffer.resize(reclen);
+		_raw.impl().swap(buffer);
+	}
+	else {
+		_raw.impl().clear();
+		if ( _hint == DATA_ONLY )
+			_decodeData(prec);
+	}
+
 	msr_free(&prec);
 	if ( _fsamp <= 0 ) {
 		throw LibmseedException("Unpacking of Mini SEED record failed, invalid sample rate");
@@ -137,6 +137,7 @@ class SC_SYSTEM_CORE_API MSeedRecord: public Record {
 
 		//! Returns a nonmutable pointer to the data samples if the data is available; otherwise 0
 		//! (the data type is independent from the original one and was given by the DataType flag in the constructor)
+		//! With the hint SAVE_RAW the samples are unpacked on the first call.
 		const Array* data() const override;
 
 		const Array* raw() const override;
@@ -162,6 +163,10 @@ class SC_SYSTEM_CORE_API MSeedRecord: public Record {
 		void write(std::ostream& out);
 
 	private:
+		//! Sets all attributes from an unpacked record header and clears
+		//! decoded data
+		void _setHeader(MSRecord *rec);
+		void _decodeData(MSRecord *rec);
 		void _setDataAttributes(int reclen, char *data) const;
 
 	private:
@@ -0,0 +1,432 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/io/records/steim.h>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+
+namespace Seiscomp {
+namespace IO {
+namespace Steim {
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline bool hostIsBigEndian() {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	return true;
+#else
+	return false;
+#endif
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline uint32_t loadWord(const char *p, bool swap) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	if ( swap )
+		v = (v >> 24) | ((v >> 8) & 0x0000ff00) | ((v << 8) & 0x00ff0000) | (v << 24);
+	return v;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline void storeWord(char *p, uint32_t v) {
+	p[0] = static_cast<char>(v >> 24);
+	p[1] = static_cast<char>(v >> 16);
+	p[2] = static_cast<char>(v >> 8);
+	p[3] = static_cast<char>(v);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <int BITS>
+inline int32_t signExtend(uint32_t v) {
+	return static_cast<int32_t>(v << (32 - BITS)) >> (32 - BITS);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <int BITS, int N>
+inline int unpack(int32_t *d, uint32_t word) {
+	for ( int i = 0; i < N; ++i )
+		d[i] = signExtend<BITS>(word >> ((N - 1 - i) * BITS));
+	return N;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * @brief Replaces the differences by the samples: the first sample is
+ *        set to the forward integration constant and each following
+ *        sample is the sum of its predecessor and its difference.
+ */
+void integrate(int32_t *samples, int n, int32_t first) {
+	samples[0] = first;
+
+	int i = 1;
+
+#if defined(__SSE2__)
+	__m128i carry = _mm_set1_epi32(first);
+	for ( ; i + 4 <= n; i += 4 ) {
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+		x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+		x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+		x = _mm_add_epi32(x, carry);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(samples + i), x);
+		carry = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+	}
+#elif defined(__ARM_NEON)
+	int32x4_t zero = vdupq_n_s32(0);
+	int32x4_t carry = vdupq_n_s32(first);
+	for ( ; i + 4 <= n; i += 4 ) {
+		int32x4_t x = vld1q_s32(samples + i);
+		x = vaddq_s32(x, vextq_s32(zero, x, 3));
+		x = vaddq_s32(x, vextq_s32(zero, x, 2));
+		x = vaddq_s32(x, carry);
+		vst1q_s32(samples + i, x);
+		carry = vdupq_n_s32(vgetq_lane_s32(x, 3));
+	}
+#endif
+
+	// Overflows wrap around as in the SIMD code paths
+	for ( ; i < n; ++i )
+		samples[i] = static_cast<int32_t>(static_cast<uint32_t>(samples[i-1]) +
+		                                  static_cast<uint32_t>(samples[i]));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Extracts the differences of a Steim1 word
+inline int unpack1(int32_t *d, uint32_t word, uint32_t code) {
+	switch ( code ) {
+		case 0:
+			return 0;
+		case 1:
+			return unpack<8,4>(d, word);
+		case 2:
+			return unpack<16,2>(d, word);
+		default:
+			d[0] = static_cast<int32_t>(word);
+			return 1;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Extracts the differences of a Steim2 word, returns -1 on error
+inline int unpack2(int32_t *d, uint32_t word, uint32_t code) {
+	switch ( code ) {
+		case 0:
+			return 0;
+		case 1:
+			return unpack<8,4>(d, word);
+		case 2:
+			switch ( word >> 30 ) {
+				case 1:
+					return unpack<30,1>(d, word);
+				case 2:
+					return unpack<15,2>(d, word);
+				case 3:
+					return unpack<10,3>(d, word);
+				default:
+					return -1;
+			}
+		default:
+			switch ( word >> 30 ) {
+				case 0:
+					return unpack<6,5>(d, word);
+				case 1:
+					return unpack<5,6>(d, word);
+				case 2:
+					return unpack<4,7>(d, word);
+				default:
+					return -1;
+			}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename UNPACK>
+int decode(const char *frames, int nframes, bool bigEndian,
+           int32_t *samples, int nsamples, int32_t *last, UNPACK unpackWord) {
+	if ( nsamples <= 0 ) return 0;
+	if ( !frames || nframes <= 0 ) return -1;
+
+	bool swap = bigEndian != hostIsBigEndian();
+	int32_t first = static_cast<int32_t>(loadWord(frames + 4, swap));
+	int count = 0;
+
+	if ( last ) *last = static_cast<int32_t>(loadWord(frames + 8, swap));
+
+	for ( int f = 0; (f < nframes) && (count < nsamples); ++f ) {
+		const char *frame = frames + f * FrameSize;
+		uint32_t nibbles = loadWord(frame, swap);
+
+		// The first frame carries the integration constants in words 1 and 2
+		for ( int w = f ? 1 : 3; (w < 16) && (count < nsamples); ++w ) {
+			uint32_t word = loadWord(frame + w * 4, swap);
+			uint32_t code = (nibbles >> (30 - 2 * w)) & 0x03;
+			int n;
+
+			// A word holds up to seven differences which are written to
+			// the output directly as long as there is enough space left
+			if ( nsamples - count >= 7 ) {
+				n = unpackWord(samples + count, word, code);
+				if ( n < 0 ) return -1;
+				count += n;
+			}
+			else {
+				int32_t d[7];
+				n = unpackWord(d, word, code);
+				if ( n < 0 ) return -1;
+				if ( n > nsamples - count ) n = nsamples - count;
+				for ( int i = 0; i < n; ++i )
+					samples[count++] = d[i];
+			}
+		}
+	}
+
+	if ( count ) integrate(samples, count, first);
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline int64_t difference(const int32_t *samples, int i, int32_t previous) {
+	return static_cast<int64_t>(samples[i]) - (i ? samples[i-1] : previous);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline bool fits(int64_t d, int bits) {
+	int64_t limit = int64_t(1) << (bits - 1);
+	return (d >= -limit) && (d < limit);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct Packing {
+	int      count;
+	int      bits;
+	uint32_t code;
+	uint32_t dnib;
+};
+
+
+// Ordered by decreasing number of differences per word
+const Packing Steim1Packings[] = {
+	{ 4,  8, 1, 0 },
+	{ 2, 16, 2, 0 },
+	{ 1, 32, 3, 0 }
+};
+
+const Packing Steim2Packings[] = {
+	{ 7,  4, 3, 2 },
+	{ 6,  5, 3, 1 },
+	{ 5,  6, 3, 0 },
+	{ 4,  8, 1, 0 },
+	{ 3, 10, 2, 3 },
+	{ 2, 15, 2, 2 },
+	{ 1, 30, 2, 1 }
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <int N>
+int encode(const int32_t *samples, int nsamples, int32_t previous,
+           char *frames, int nframes, int *packed,
+           const Packing (&packings)[N], bool steim2) {
+	if ( packed ) *packed = 0;
+	if ( nsamples <= 0 ) return 0;
+	if ( !frames || nframes <= 0 ) return -1;
+
+	int idx = 0;
+	int f = 0;
+
+	for ( ; (f < nframes) && (idx < nsamples); ++f ) {
+		char *frame = frames + f * FrameSize;
+		uint32_t nibbles = 0;
+
+		if ( !f ) {
+			storeWord(frame + 4, static_cast<uint32_t>(samples[0]));
+			storeWord(frame + 8, 0);
+		}
+
+		for ( int w = f ? 1 : 3; w < 16; ++w ) {
+			uint32_t word = 0;
+			uint32_t code = 0;
+
+			if ( idx < nsamples ) {
+				int64_t d[7];
+				int available = nsamples - idx;
+				if ( available > 7 ) available = 7;
+				for ( int i = 0; i < available; ++i )
+					d[i] = difference(samples, idx + i, previous);
+
+				const Packing *p = nullptr;
+				for ( int i = 0; i < N; ++i ) {
+					if ( packings[i].count > available ) continue;
+
+					bool ok = true;
+					// A single 32 bit Steim1 difference wraps around like
+					// the decoder integration
+					if ( packings[i].bits < 32 ) {
+						for ( int k = 0; k < packings[i].count; ++k ) {
+							if ( !fits(d[k], packings[i].bits) ) {
+								ok = false;
+								break;
+							}
+						}
+					}
+
+					if ( ok ) {
+						p = &packings[i];
+						break;
+					}
+				}
+
+				if ( !p ) return -1;
+
+				code = p->code;
+				if ( steim2 && (code != 1) )
+					word = p->dnib << 30;
+
+				uint32_t mask = p->bits < 32 ? (uint32_t(1) << p->bits) - 1 : ~uint32_t(0);
+				for ( int k = 0; k < p->count; ++k )
+					word |= (static_cast<uint32_t>(d[k]) & mask) << ((p->count - 1 - k) * p->bits);
+
+				idx += p->count;
+			}
+
+			nibbles |= code << (30 - 2 * w);
+			storeWord(frame + w * 4, word);
+		}
+
+		storeWord(frame, nibbles);
+	}
+
+	// Reverse integration constant
+	storeWord(frames + 8, static_cast<uint32_t>(samples[idx-1]));
+
+	if ( packed ) *packed = idx;
+
+	return f;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int decode1(const char *frames, int nframes, bool bigEndian,
+            int32_t *samples, int nsamples, int32_t *last) {
+	return decode(frames, nframes, bigEndian, samples, nsamples, last, unpack1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int decode2(const char *frames, int nframes, bool bigEndian,
+            int32_t *samples, int nsamples, int32_t *last) {
+	return decode(frames, nframes, bigEndian, samples, nsamples, last, unpack2);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int encode1(const int32_t *samples, int nsamples, int32_t previous,
+            char *frames, int nframes, int *packed) {
+	return encode(samples, nsamples, previous, frames, nframes, packed,
+	              Steim1Packings, false);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int encode2(const int32_t *samples, int nsamples, int32_t previous,
+            char *frames, int nframes, int *packed) {
+	return encode(samples, nsamples, previous, frames, nframes, packed,
+	              Steim2Packings, true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
+}
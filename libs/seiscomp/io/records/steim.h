@@ -0,0 +1,102 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SC_IO_RECORDS_STEIM_H
+#define SC_IO_RECORDS_STEIM_H
+
+
+#include <seiscomp/core.h>
+#include <cstdint>
+
+
+namespace Seiscomp {
+namespace IO {
+namespace Steim {
+
+
+//! The size of a Steim frame in bytes
+const int FrameSize = 64;
+
+
+/**
+ * @brief Decodes Steim1 compressed frames.
+ *
+ * The differences are written to the output buffer and integrated in
+ * place afterwards, no intermediate buffer is used. On x86-64 (SSE2) and
+ * AArch64 (NEON) the integration is vectorized.
+ * @param frames Pointer to the first frame
+ * @param nframes The number of frames
+ * @param bigEndian Whether the frame words are stored in big endian
+ *                  byte order, which is the SEED default
+ * @param samples The output buffer
+ * @param nsamples The number of samples to decode. The output buffer must
+ *                 be able to hold at least that many samples.
+ * @param last If not null then the reverse integration constant of the
+ *             first frame is stored there to be used for an integrity
+ *             check of the last sample.
+ * @return The number of decoded samples or -1 in case of an error
+ */
+SC_SYSTEM_CORE_API int decode1(const char *frames, int nframes, bool bigEndian,
+                               int32_t *samples, int nsamples,
+                               int32_t *last = nullptr);
+
+/**
+ * @brief Decodes Steim2 compressed frames.
+ * @see decode1
+ */
+SC_SYSTEM_CORE_API int decode2(const char *frames, int nframes, bool bigEndian,
+                               int32_t *samples, int nsamples,
+                               int32_t *last = nullptr);
+
+/**
+ * @brief Encodes samples in Steim1 frames. The frames are written in
+ *        big endian byte order.
+ * @param samples The input samples
+ * @param nsamples The number of input samples
+ * @param previous The last sample of the previous record which is used
+ *                 to compute the first difference. Pass samples[0] if
+ *                 there is no previous record.
+ * @param frames The output buffer
+ * @param nframes The number of frames the output buffer can hold
+ * @param packed Returns the number of packed samples which can be less
+ *               than nsamples if the output buffer is full
+ * @return The number of used frames or -1 in case of an error
+ */
+SC_SYSTEM_CORE_API int encode1(const int32_t *samples, int nsamples,
+                               int32_t previous, char *frames, int nframes,
+                               int *packed);
+
+/**
+ * @brief Encodes samples in Steim2 frames. Differences which do not fit
+ *        into 30 bits cannot be represented and result in an error.
+ * @see encode1
+ */
+SC_SYSTEM_CORE_API int encode2(const int32_t *samples, int nsamples,
+                               int32_t previous, char *frames, int nframes,
+                               int *packed);
+
+
+}
+}
+}
+
+
+#endif
@@ -78,6 +78,21 @@ bool RecordStream::setRecordType(const char *type) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t RecordStream::nextBatch(std::vector<Record*> &records, size_t max) {
+	if ( !max ) return 0;
+
+	Record *rec = next();
+	if ( !rec ) return 0;
+
+	records.push_back(rec);
+	return 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void RecordStream::setDataType(Array::DataType dataType) {
 	_dataType = dataType;
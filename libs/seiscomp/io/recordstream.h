@@ -26,6 +26,8 @@
 #include <seiscomp/core/record.h>
 #include <seiscomp/io/recordstreamexceptions.h>
 
+#include <vector>
+
 
 namespace Seiscomp {
 namespace IO {
@@ -200,8 +202,11 @@ class SC_SYSTEM_CORE_API RecordStream : public Core::InterruptibleObject {
 
 		/**
 		 * @brief Sets the hint how records should be created. The default
-		 *        is SAVE_RAW. This method must be called before calling
-		 *        next().
+		 *        is SAVE_RAW which decodes only the record headers and
+		 *        unpacks the samples on demand. Consumers which only look
+		 *        at the headers, e.g. availability scans, can pass
+		 *        META_ONLY to not keep the raw data at all. This method
+		 *        must be called before calling next().
 		 * @param hint The record creation hint
 		 */
 		void setDataHint(Record::Hint hint);
@@ -213,6 +218,22 @@ class SC_SYSTEM_CORE_API RecordStream : public Core::InterruptibleObject {
 		 */
 		virtual Record *next() = 0;
 
+		/**
+		 * @brief Appends the next records from the source to a batch.
+		 *        The default implementation appends the result of one
+		 *        call to next(). Implementations which can return further
+		 *        records without blocking, e.g. because they have already
+		 *        been received, append them with the same call.
+		 * @param records The vector the records are appended to. The
+		 *                ownership of the appended instances goes to the
+		 *                caller.
+		 * @param max The maximum number of records to append, must be
+		 *            greater than 0.
+		 * @return The number of appended records. Iteration stops if 0 is
+		 *         returned.
+		 */
+		virtual size_t nextBatch(std::vector<Record*> &records, size_t max);
+
 
 	// ------------------------------------------------------------------
 	//  RecordStream static interface
@@ -90,32 +90,26 @@ bool ArclinkConnection::setSource(const string &serverloc) {
 	size_t pos = serverloc.find('?');
 	if ( pos != std::string::npos ) {
 		_serverloc = serverloc.substr(0, pos);
-		std::string params = serverloc.substr(pos+1);
-		std::vector<std::string> toks;
-		split(toks, params.c_str(), "&");
-		if ( !toks.empty() ) {
-			for ( std::vector<std::string>::iterator it = toks.begin();
-			      it != toks.end(); ++it ) {
-				std::string name, value;
-
-				pos = it->find('=');
-				if ( pos != std::string::npos ) {
-					name = it->substr(0, pos);
-					value = it->substr(pos+1);
-				}
-				else {
-					name = *it;
-					value = "";
-				}
+		std::string_view params(serverloc);
+		params.remove_prefix(pos+1);
+		for ( std::string_view tok : Tokens(params, "&") ) {
+			std::string_view name, value;
+
+			pos = tok.find('=');
+			if ( pos != std::string_view::npos ) {
+				name = tok.substr(0, pos);
+				value = tok.substr(pos+1);
+			}
+			else
+				name = tok;
 
-				if ( name == "user" )
-					_user = value;
-				else if ( name == "pwd" )
-					_passwd = value;
+			if ( name == "user" )
+				_user = value;
+			else if ( name == "pwd" )
+				_passwd = value;
 
-				if ( name == "dump" )
-					_dump.open(value.c_str());
-			}
+			if ( name == "dump" )
+				_dump.open(std::string(value).c_str());
 		}
 	}
 	else
@@ -248,20 +242,16 @@ void ArclinkConnection::handshake() {
 		_remainingBytes = 0;
 	}
 	else if ( r.compare(0, 6, "CHUNK ") == 0 ) {
-		char *tail;
 		_chunkMode = true;
-		_remainingBytes = strtoul(r.c_str() + 6, &tail, 10);
-		if ( *tail ) {
+		if ( !fromChars(_remainingBytes, std::string_view(r).substr(6)) ) {
 			SEISCOMP_ERROR("Invalid ArcLink response: %s", r.c_str());
 			throw ArclinkException("invalid response");
 		}
 		SEISCOMP_DEBUG("Chunk mode detected, first chunk with %d bytes", _remainingBytes);
 	}
 	else {
-		char *tail;
 		_chunkMode = false;
-		_remainingBytes = strtoul(r.c_str(), &tail, 10);
-		if ( *tail ) {
+		if ( !fromChars(_remainingBytes, r) ) {
 			SEISCOMP_ERROR("Invalid ArcLink response: %s", r.c_str());
 			throw ArclinkException("invalid response");
 		}
@@ -298,30 +288,40 @@ Record *ArclinkConnection::next() {
 
 	try {
 		while ( _sock.isOpen() ) {
-			std::istringstream stream(std::istringstream::in|std::istringstream::binary);
 			// HACK to retrieve the record length
-			string data = _sock.read(RECSIZE);
-			int reclen = ms_detect(data.c_str(), RECSIZE);
-			if (reclen > RECSIZE)
-				data += _sock.read(reclen - RECSIZE);
-			else {
+			const char *data = _sock.peek(RECSIZE);
+			int reclen = ms_detect(data, RECSIZE);
+			if ( reclen <= RECSIZE ) {
 				if (reclen <= 0) SEISCOMP_ERROR("Retrieving the record length failed (try 512 Byte)!");
 				reclen = RECSIZE;
 			}
 
-			stream.str(data);
-
-			IO::MSeedRecord *rec = new IO::MSeedRecord();
-			setupRecord(rec);
-			try {
-				rec->read(stream);
+			// Records which fit into the receive buffer are decoded in
+			// place, larger ones are copied
+			string buffer;
+			if ( reclen <= BUFSIZE ) {
+				data = _sock.peek(reclen);
+				_sock.skip(reclen);
 			}
-			catch ( ... ) {
-				delete rec;
-				rec = nullptr;
+			else {
+				buffer = _sock.read(reclen);
+				data = buffer.data();
+			}
+
+			IO::MSeedRecord *rec = nullptr;
+			MSRecord *prec = nullptr;
+			if ( msr_unpack(const_cast<char*>(data), reclen, &prec, 0, 0) == MS_NOERROR ) {
+				try {
+					rec = new IO::MSeedRecord(prec, _dataType, _hint);
+				}
+				catch ( ... ) {
+					rec = nullptr;
+				}
 			}
 
-			if ( _dump ) _dump << data;
+			if ( prec ) msr_free(&prec);
+
+			if ( _dump ) _dump.write(data, reclen);
 
 			/////////////////////////////////////
 			_remainingBytes -= reclen;
@@ -330,9 +330,7 @@ Record *ArclinkConnection::next() {
 			if ( _chunkMode && _remainingBytes <= 0 ) {
 				string r = _sock.readline();
 				if ( r.compare(0, 6, "CHUNK ") == 0 ) {
-					char *tail;
-					_remainingBytes = strtoul(r.c_str() + 6, &tail, 10);
-					if ( *tail ) {
+					if ( !fromChars(_remainingBytes, std::string_view(r).substr(6)) ) {
 						SEISCOMP_ERROR("Invalid ArcLink response: %s", r.c_str());
 						_sock.close();
 					}
@@ -0,0 +1,781 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT ArclinkMuxConnection
+
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/wired/clientsession.h>
+#include <seiscomp/wired/reactor.h>
+
+#include "arclinkmux.h"
+
+#include <algorithm>
+#include <map>
+
+#include <libmseed.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::IO;
+
+
+namespace Seiscomp {
+namespace RecordStream {
+namespace {
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *DefaultHost = "localhost";
+const int DefaultPort = 18001;
+const int DefaultConnections = 4;
+const int MaxConnections = 64;
+
+// The size of the receive buffer shared by all connections
+const size_t ReceiveBufferSize = 65536;
+// The record size read before the length is detected, see ArclinkConnection
+const size_t RecordSize = 512;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// Returns the length of the record starting at data which holds at least
+// RecordSize bytes. Records without a detectable length are assumed to
+// have RecordSize bytes.
+size_t recordLength(const char *data, size_t len) {
+	int reclen = ms_detect(data, static_cast<int>(len));
+	if ( reclen > static_cast<int>(RecordSize) )
+		return static_cast<size_t>(reclen);
+
+	if ( reclen <= 0 )
+		SEISCOMP_ERROR("Retrieving the record length failed (try 512 Byte)!");
+
+	return RecordSize;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline bool equals(const char *data, size_t len, const char *str) {
+	return (len == strlen(str)) && !strncmp(data, str, len);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * @brief The reactor which dispatches the events of all connections.
+ *
+ * Instead of running the event loop until it is stopped, dispatch handles
+ * the events of a single wait which allows to hand over the decoded
+ * records after each round.
+ */
+class ArclinkMuxConnection::Multiplexer : public Wired::Reactor {
+	public:
+		Multiplexer() {
+			_buffer.resize(ReceiveBufferSize);
+		}
+
+	public:
+		void dispatch() {
+			for ( Wired::Device *device = wait(); device; device = _devices.next() ) {
+				Wired::Session *session = device->session();
+
+				if ( !device->isValid() ) {
+					session->close();
+					removeSession(session);
+				}
+				else if ( _devices.timedOut() && !session->handleTimeout() ) {
+					session->close();
+					removeSession(session);
+				}
+				else {
+					session->update();
+					if ( !device->isValid() )
+						removeSession(session);
+				}
+			}
+		}
+
+	protected:
+		void sessionRemoved(Wired::Session *session) override;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * @brief The Session class runs one ArcLink request.
+ *
+ * The handshake of ArclinkConnection is implemented as a state machine
+ * driven by the received lines. The waveform data is passed as post
+ * data and decoded record by record.
+ */
+class ArclinkMuxConnection::Session : public Wired::ClientSession {
+	public:
+		enum State {
+			Hello,
+			Organization,
+			User,
+			Request,
+			End,
+			Download,
+			Data,
+			Chunk,
+			Purge,
+			Finished
+		};
+
+	public:
+		Session(ArclinkMuxConnection *owner, Wired::Socket *socket,
+		        const vector<string> &lines)
+		: Wired::ClientSession(socket)
+		, _owner(owner)
+		, _lines(lines)
+		, _state(Hello)
+		, _chunkMode(false)
+		, _fallback(false)
+		, _remainingBytes(0)
+		, _recordLength(0) {
+			sendLine("HELLO");
+		}
+
+	public:
+		State state() const { return _state; }
+
+		const char *server() const {
+			return _server.c_str();
+		}
+
+		void setServer(const string &server) {
+			_server = server;
+		}
+
+	protected:
+		void handleInbox(const char *data, size_t len) override {
+			switch ( _state ) {
+				case Hello:
+					if ( equals(data, len, "ERROR") ) {
+						SEISCOMP_ERROR("[%s] remote server did not accept HELLO",
+						               server());
+						abort();
+						return;
+					}
+					_state = Organization;
+					SEISCOMP_DEBUG("[%s] %s", server(), data);
+					break;
+
+				case Organization:
+					SEISCOMP_DEBUG("[%s] running at %s", server(), data);
+					if ( _owner->_password.empty() )
+						sendLine("USER " + _owner->_user);
+					else
+						sendLine("USER " + _owner->_user + " " + _owner->_password);
+					_state = User;
+					break;
+
+				case User:
+					if ( !accepted(data, len, "USER") ) return;
+					sendLine("REQUEST WAVEFORM format=MSEED");
+					_state = Request;
+					break;
+
+				case Request:
+					if ( !accepted(data, len, "REQUEST") ) return;
+					for ( const string &line : _lines )
+						sendLine(line);
+					sendLine("END");
+					_state = End;
+					break;
+
+				case End:
+					if ( !accepted(data, len, "END") ) return;
+					_reqID.assign(data, len);
+					sendLine("BCDOWNLOAD " + _reqID);
+					_state = Download;
+					break;
+
+				case Download:
+					if ( equals(data, len, "ERROR") && !_fallback ) {
+						_fallback = true;
+						sendLine("BDOWNLOAD " + _reqID);
+						break;
+					}
+
+					if ( equals(data, len, "ERROR") || equals(data, len, "END") ) {
+						SEISCOMP_DEBUG("[%s] request %s: %s",
+						               server(), _reqID.c_str(), data);
+						purge();
+						break;
+					}
+
+					if ( !strncmp(data, "CHUNK ", 6) ) {
+						_chunkMode = true;
+						startData(data + 6, len - 6);
+					}
+					else
+						startData(data, len);
+					break;
+
+				case Chunk:
+					if ( !strncmp(data, "CHUNK ", 6) )
+						startData(data + 6, len - 6);
+					else {
+						SEISCOMP_DEBUG("[%s] received status: %s", server(), data);
+						purge();
+					}
+					break;
+
+				case Purge:
+					_state = Finished;
+					close();
+					break;
+
+				default:
+					SEISCOMP_WARNING("[%s] unexpected response: %s",
+					                 server(), data);
+					break;
+			}
+		}
+
+		void handlePostData(const char *data, size_t len) override {
+			_remainingBytes -= len;
+
+			while ( len > 0 ) {
+				if ( _record.empty() && (len >= RecordSize) ) {
+					// Complete records are decoded in place from the
+					// receive buffer of the reactor
+					size_t reclen = recordLength(data, len);
+					if ( reclen <= len ) {
+						decode(data, reclen);
+						data += reclen;
+						len -= reclen;
+						continue;
+					}
+				}
+
+				// Collect a record spanning two reads
+				size_t target = _recordLength ? _recordLength : RecordSize;
+				size_t n = min(target - _record.size(), len);
+				_record.insert(_record.end(), data, data + n);
+				data += n;
+				len -= n;
+
+				if ( _record.size() < target )
+					break;
+
+				if ( !_recordLength ) {
+					_recordLength = recordLength(_record.data(), _record.size());
+					if ( _recordLength > _record.size() )
+						continue;
+				}
+
+				decode(_record.data(), _record.size());
+				_record.clear();
+				_recordLength = 0;
+			}
+
+			if ( !_remainingBytes ) {
+				if ( _chunkMode )
+					_state = Chunk;
+				else
+					purge();
+			}
+		}
+
+	private:
+		void sendLine(const string &line) {
+			send(line.c_str(), line.size());
+			send("\r\n", 2);
+		}
+
+		bool accepted(const char *data, size_t len, const char *command) {
+			if ( !equals(data, len, "ERROR") )
+				return true;
+
+			SEISCOMP_ERROR("[%s] command failed: %s", server(), command);
+			abort();
+			return false;
+		}
+
+		void startData(const char *data, size_t len) {
+			int size;
+			if ( !Core::fromString(size, string(data, len)) || (size < 0) ) {
+				SEISCOMP_ERROR("[%s] invalid ArcLink response: %s",
+				               server(), string(data, len).c_str());
+				abort();
+				return;
+			}
+
+			if ( !size ) {
+				if ( _chunkMode )
+					_state = Chunk;
+				else
+					purge();
+				return;
+			}
+
+			_remainingBytes = static_cast<size_t>(size);
+			_state = Data;
+			setPostDataSize(_remainingBytes);
+		}
+
+		void purge() {
+			if ( !_record.empty() ) {
+				SEISCOMP_WARNING("[%s] dropped incomplete record with %zu bytes",
+				                 server(), _record.size());
+				_record.clear();
+				_recordLength = 0;
+			}
+
+			sendLine("PURGE " + _reqID);
+			_state = Purge;
+		}
+
+		void abort() {
+			_state = Finished;
+			invalidate();
+		}
+
+		void decode(const char *data, size_t len) {
+			if ( _owner->_dump )
+				_owner->_dump.write(data, static_cast<streamsize>(len));
+
+			MSRecord *prec = nullptr;
+			if ( msr_unpack(const_cast<char*>(data), static_cast<int>(len),
+			                &prec, 0, 0) != MS_NOERROR ) {
+				SEISCOMP_WARNING("[%s] failed to unpack record", server());
+				if ( prec ) msr_free(&prec);
+				return;
+			}
+
+			try {
+				// Create the record from the unpacked header instead of
+				// parsing the buffer a second time
+				_owner->_records.push_back(
+					new MSeedRecord(prec, _owner->_dataType, _owner->_hint)
+				);
+			}
+			catch ( ... ) {}
+
+			msr_free(&prec);
+		}
+
+	private:
+		ArclinkMuxConnection *_owner;
+		vector<string>        _lines;
+		string                _server;
+		State                 _state;
+		string                _reqID;
+		bool                  _chunkMode;
+		bool                  _fallback;
+		size_t                _remainingBytes;
+		vector<char>          _record;
+		size_t                _recordLength;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ArclinkMuxConnection::Multiplexer::sessionRemoved(Wired::Session *session) {
+	Session *s = static_cast<Session*>(session);
+	if ( s->state() < Session::Purge ) {
+		SEISCOMP_ERROR("[%s] connection closed before the request finished",
+		               s->server());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+IMPLEMENT_SC_CLASS_DERIVED(ArclinkMuxConnection, IO::RecordStream,
+                           "ArclinkMuxConnection");
+REGISTER_RECORDSTREAM(ArclinkMuxConnection, "arclinkmux");
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ArclinkMuxConnection::ArclinkMuxConnection()
+: _connections(DefaultConnections)
+, _user("guest@anywhere")
+, _timeout(0)
+, _multiplexer(new Multiplexer)
+, _requests(0)
+, _started(false)
+, _closed(false) {
+	// The device group must be set up before the stream can be
+	// interrupted from another thread
+	if ( !_multiplexer->setup() )
+		SEISCOMP_ERROR("Failed to set up the reactor");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ArclinkMuxConnection::~ArclinkMuxConnection() {
+	cleanup();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::setSource(const string &source) {
+	if ( _started )
+		return false;
+
+	_servers.clear();
+	_connections = DefaultConnections;
+
+	string serverlist = source;
+
+	size_t pos = source.find('?');
+	if ( pos != string::npos ) {
+		serverlist = source.substr(0, pos);
+
+		vector<string> toks;
+		Core::split(toks, source.substr(pos+1).c_str(), "&");
+		for ( const auto &tok : toks ) {
+			string name, value;
+
+			pos = tok.find('=');
+			if ( pos != string::npos ) {
+				name = tok.substr(0, pos);
+				value = tok.substr(pos+1);
+			}
+			else
+				name = tok;
+
+			if ( name == "connections" ) {
+				if ( !Core::fromString(_connections, value)
+				  || _connections < 1 || _connections > MaxConnections ) {
+					SEISCOMP_ERROR("Invalid number of connections: %s",
+					               value.c_str());
+					return false;
+				}
+			}
+			else if ( name == "user" )
+				_user = value;
+			else if ( name == "pwd" )
+				_password = value;
+			else if ( name == "dump" )
+				_dump.open(value.c_str(), ios_base::out | ios_base::binary);
+		}
+	}
+
+	vector<string> hosts;
+	Core::split(hosts, serverlist.c_str(), ",", false);
+	if ( hosts.empty() )
+		hosts.push_back(string());
+
+	for ( const auto &host : hosts ) {
+		Server server;
+		server.host = DefaultHost;
+		server.port = DefaultPort;
+
+		pos = host.find(':');
+		if ( pos == string::npos ) {
+			if ( !host.empty() )
+				server.host = host;
+		}
+		else {
+			if ( pos > 0 )
+				server.host = host.substr(0, pos);
+			if ( (pos < host.size()-1)
+			  && (!Core::fromString(server.port, host.substr(pos+1))
+			   || server.port <= 0 || server.port > 65535) ) {
+				SEISCOMP_ERROR("Invalid port: %s", host.c_str());
+				_servers.clear();
+				return false;
+			}
+		}
+
+		_servers.push_back(server);
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::setRecordType(const char *type) {
+	return !strcmp(type, "mseed");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::addStream(const string &net, const string &sta,
+                                     const string &loc, const string &cha) {
+	auto result = _streams.insert(StreamIdx(net, sta, loc, cha));
+	if ( result.second ) _ordered.push_back(*result.first);
+	return result.second;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::addStream(const string &net, const string &sta,
+                                     const string &loc, const string &cha,
+                                     const Core::Time &stime,
+                                     const Core::Time &etime) {
+	auto result = _streams.insert(StreamIdx(net, sta, loc, cha, stime, etime));
+	if ( result.second ) _ordered.push_back(*result.first);
+	return result.second;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::setStartTime(const Core::Time &stime) {
+	_stime = stime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::setEndTime(const Core::Time &etime) {
+	_etime = etime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::setTimeout(int seconds) {
+	_timeout = seconds;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ArclinkMuxConnection::close() {
+	_closed = true;
+	_multiplexer->interrupt();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t ArclinkMuxConnection::requestCount() const {
+	return _requests;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ArclinkMuxConnection::start() {
+	_started = true;
+
+	if ( _servers.empty() && !setSource(string()) )
+		return;
+
+	Core::Time endTime = _etime;
+	if ( !endTime.valid() ) endTime = Core::Time::UTC();
+
+	// Distribute the stations round-robin over all requests. Subsequent
+	// requests are sent to different servers.
+	vector<vector<string>> requests(_servers.size() * _connections);
+	map<string, size_t> stations;
+
+	for ( const StreamIdx &idx : _ordered ) {
+		SEISCOMP_DEBUG("Arclink request: %s", idx.str(_stime, endTime).c_str());
+		if ( (!idx.startTime().valid() && !_stime.valid())
+		  || (!idx.endTime().valid() && !endTime.valid()) ) {
+			// invalid time window ignore stream
+			SEISCOMP_WARNING("... has invalid time window -> ignore this request above");
+			continue;
+		}
+
+		auto it = stations.find(idx.network() + "." + idx.station());
+		if ( it == stations.end() ) {
+			size_t index = stations.size() % requests.size();
+			it = stations.insert(make_pair(idx.network() + "." + idx.station(), index)).first;
+		}
+
+		requests[it->second].push_back(idx.str(_stime, endTime));
+	}
+
+	for ( size_t i = 0; i < requests.size(); ++i ) {
+		if ( requests[i].empty() ) continue;
+
+		const Server &server = _servers[i % _servers.size()];
+
+		Wired::SocketPtr socket = new Wired::Socket;
+		socket->setNonBlocking(true);
+
+		Wired::Socket::Status status = socket->connect(server.host, static_cast<Wired::Socket::port_t>(server.port));
+		if ( status != Wired::Socket::Success ) {
+			SEISCOMP_ERROR("[%s:%d] failed to connect: %s",
+			               server.host.c_str(), server.port,
+			               Wired::Socket::toString(status));
+			continue;
+		}
+
+		// The HELLO queued by the session adds the write mode which
+		// signals the completed connect
+		socket->setMode(Wired::Device::Read);
+		if ( _timeout > 0 )
+			socket->setTimeout(_timeout * 1000);
+
+		Session *session = new Session(this, socket.get(), requests[i]);
+		session->setServer(server.host + ":" + Core::toString(server.port));
+
+		if ( !_multiplexer->addSession(session) ) {
+			delete session;
+			continue;
+		}
+
+		++_requests;
+	}
+
+	SEISCOMP_DEBUG("Started %zu requests for %zu stations",
+	               _requests, stations.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ArclinkMuxConnection::fetch() {
+	if ( !_started )
+		start();
+
+	while ( _records.empty() ) {
+		if ( _closed || !_multiplexer->count() ) {
+			cleanup();
+			return false;
+		}
+
+		_multiplexer->dispatch();
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ArclinkMuxConnection::cleanup() {
+	_multiplexer->clear();
+
+	for ( Record *rec : _records )
+		delete rec;
+	_records.clear();
+
+	if ( _dump.is_open() )
+		_dump.close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *ArclinkMuxConnection::next() {
+	if ( !fetch() )
+		return nullptr;
+
+	Record *rec = _records.front();
+	_records.pop_front();
+	return rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t ArclinkMuxConnection::nextBatch(vector<Record*> &records, size_t max) {
+	if ( !fetch() )
+		return 0;
+
+	size_t count = 0;
+	while ( (count < max) && !_records.empty() ) {
+		records.push_back(_records.front());
+		_records.pop_front();
+		++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
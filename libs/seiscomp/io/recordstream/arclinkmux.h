@@ -0,0 +1,176 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDSTREAM_ARCLINKMUX_H
+#define SEISCOMP_IO_RECORDSTREAM_ARCLINKMUX_H
+
+
+#include <seiscomp/io/recordstream.h>
+#include <seiscomp/io/recordstream/streamidx.h>
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+DEFINE_SMARTPOINTER(ArclinkMuxConnection);
+
+/**
+ * @brief The ArclinkMuxConnection class requests data from one or more
+ *        ArcLink servers with multiple concurrent requests handled by a
+ *        single thread.
+ *
+ * The requested stations are distributed round-robin over all requests
+ * where all channels of a station are part of the same request. The
+ * requests in turn are distributed over the configured servers which
+ * must all serve the requested data. All connections are non-blocking
+ * and driven by a Wired reactor which reads into one reusable receive
+ * buffer. Records are decoded directly from that buffer unless they span
+ * two reads.
+ */
+class SC_SYSTEM_CORE_API ArclinkMuxConnection : public IO::RecordStream {
+	DECLARE_SC_CLASS(ArclinkMuxConnection);
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! C'tor
+		ArclinkMuxConnection();
+
+		//! D'tor
+		~ArclinkMuxConnection() override;
+
+
+	// ----------------------------------------------------------------------
+	//  RecordStream Interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Sets the servers and the request parameters. The source
+		 *        is a comma separated list of servers followed by the
+		 *        parameters of an ArcLink source and the additional
+		 *        parameter 'connections' which defines the number of
+		 *        concurrent requests per server, e.g.
+		 *        host1:18001,host2:18001?connections=4&user=foo.
+		 */
+		bool setSource(const std::string &source) override;
+
+		//! Only mseed is supported.
+		bool setRecordType(const char *type) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const Core::Time &startTime,
+		               const Core::Time &endTime) override;
+
+		bool setStartTime(const Core::Time &stime) override;
+		bool setEndTime(const Core::Time &etime) override;
+
+		//! Sets the timeout of each connection. A connection which does
+		//! not receive data within that time is closed.
+		bool setTimeout(int seconds) override;
+
+		//! Terminates all requests. This is safe to be called from
+		//! another thread.
+		void close() override;
+
+		Record *next() override;
+
+		//! Returns all records which have been decoded with the last read
+		//! of the sockets.
+		size_t nextBatch(std::vector<Record*> &records, size_t max) override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the number of requests which have been started
+		size_t requestCount() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		//! Connects to the servers and sends the requests
+		void start();
+
+		//! Reads the sockets until records are available. Returns false
+		//! if all requests are finished or the stream has been closed.
+		bool fetch();
+
+		//! Closes all connections and drops pending records
+		void cleanup();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		class Multiplexer;
+		class Session;
+
+		struct Server {
+			std::string host;
+			int         port;
+		};
+
+		std::vector<Server>           _servers;
+		int                           _connections;
+		std::string                   _user;
+		std::string                   _password;
+		int                           _timeout;
+		std::list<StreamIdx>          _ordered;
+		std::set<StreamIdx>           _streams;
+		Core::Time                    _stime;
+		Core::Time                    _etime;
+		std::ofstream                 _dump;
+		std::unique_ptr<Multiplexer>  _multiplexer;
+		std::deque<Record*>           _records;
+		size_t                        _requests;
+		bool                          _started;
+		std::atomic<bool>             _closed;
+};
+
+
+} // namespace RecordStream
+} // namespace Seiscomp
+
+
+#endif
@@ -20,10 +20,13 @@
 
 #define SEISCOMP_COMPONENT BalancedConnection
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <string>
 #include <iostream>
 #include <functional>
+#include <set>
 
 #include <seiscomp/logging/log.h>
 #include <seiscomp/core/datetime.h>
@@ -76,6 +79,9 @@ bool BalancedConnection::setSource(const string &source) {
 	reset();
 
 	_rsarray.clear();
+	_sources.clear();
+	_streams.clear();
+	_work.clear();
 
 	size_t p1,p2;
 
@@ -84,9 +90,12 @@ bool BalancedConnection::setSource(const string &source) {
 	 *  type1/source1;type2/source2;...;typeN/sourceN
 	 * where
 	 *  sourceN is either source or (source)
+	 * followed by the optional ??merge=seconds
 	 */
 
 	string serverloc = source;
+	if ( !extractMergeOption(serverloc) )
+		return false;
 
 	while (true) {
 		// Find first slash
@@ -152,6 +161,15 @@ bool BalancedConnection::setSource(const string &source) {
 
 		_rsarray.push_back(make_pair(rs, false));
 
+		string prefix = "recordstream.balanced." + Core::toString(_sources.size());
+		Source src;
+		src.type = type1;
+		src.address = source1;
+		src.recordCount = &Core::Metrics::counter(prefix + ".records");
+		src.requestTime = &Core::Metrics::timer(prefix + ".requests");
+		src.latency = &Core::Metrics::timer(prefix + ".latency");
+		_sources.push_back(std::move(src));
+
 		if ( p2 == serverloc.length() )
 			break;
 
@@ -165,6 +183,134 @@ bool BalancedConnection::setSource(const string &source) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::addStream(const string &net, const string &sta,
+                                   const string &loc, const string &cha) {
+	if ( _started || _rsarray.empty() )
+		return false;
+
+	_streams.push_back({net, sta, loc, cha, Core::Time(), Core::Time(), Core::Time()});
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::addStream(const string &net, const string &sta,
+                                   const string &loc, const string &cha,
+                                   const Core::Time &stime,
+                                   const Core::Time &etime) {
+	if ( _started || _rsarray.empty() )
+		return false;
+
+	_streams.push_back({net, sta, loc, cha, stime, etime, Core::Time()});
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::setStartTime(const Core::Time &stime) {
+	_startTime = stime;
+	return Concurrent::setStartTime(stime);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::setEndTime(const Core::Time &etime) {
+	_endTime = etime;
+	return Concurrent::setEndTime(etime);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::setTimeWindow(const Core::TimeWindow &w) {
+	_startTime = w.startTime();
+	_endTime = w.endTime();
+	return Concurrent::setTimeWindow(w);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::setTimeout(int seconds) {
+	_timeout = seconds;
+	return Concurrent::setTimeout(seconds);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::setRecordType(const char *type) {
+	_recordType = type ? type : "";
+	return Concurrent::setRecordType(type);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *BalancedConnection::next() {
+	if ( !_started && !_streams.empty() ) {
+		auto now = Clock::now();
+		for ( auto &src : _sources ) {
+			src.requested = now;
+			src.records = 0;
+		}
+
+		if ( _rsarray.size() > 1 && isBounded() ) {
+			split();
+			SEISCOMP_DEBUG("Split %zu streams into %zu windows",
+			               _streams.size(), _work.size());
+
+			for ( size_t i = 0; i < _rsarray.size(); ++i ) {
+				RecordStreamPtr rs = request(i);
+				if ( rs )
+					_rsarray[i] = make_pair(rs, true);
+			}
+		}
+		else {
+			for ( const auto &s : _streams ) {
+				bool ok;
+
+				if ( s.startTime.valid() || s.endTime.valid() )
+					ok = Concurrent::addStream(s.net, s.sta, s.loc, s.cha,
+					                           s.startTime, s.endTime);
+				else
+					ok = Concurrent::addStream(s.net, s.sta, s.loc, s.cha);
+
+				if ( !ok )
+					SEISCOMP_ERROR("Failed to add stream %s.%s.%s.%s",
+					               s.net.c_str(), s.sta.c_str(),
+					               s.loc.c_str(), s.cha.c_str());
+			}
+		}
+
+		_streams.clear();
+	}
+
+	return Concurrent::next();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 int BalancedConnection::getRS(const string &net, const string &sta,
                               const string &loc, const string &cha) {
@@ -179,5 +325,181 @@ int BalancedConnection::getRS(const string &net, const string &sta,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::acquired(size_t index, const Record *rec) {
+	Source &src = _sources[index];
+
+	if ( !src.records++ )
+		src.latency->record(
+			chrono::duration<double>(Clock::now() - src.requested).count()
+		);
+
+	src.recordCount->add();
+
+	if ( src.cutoffs.empty() )
+		return true;
+
+	// Drop records of a window which overlap the previous window of the
+	// same stream, they have already been delivered with that window
+	int i = src.streams.match(rec->streamID());
+	if ( i < 0 || !src.cutoffs[i].valid() )
+		return true;
+
+	return rec->startTime() >= src.cutoffs[i];
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordStreamPtr BalancedConnection::nextProxy(size_t index) {
+	Source &src = _sources[index];
+
+	double elapsed = chrono::duration<double>(Clock::now() - src.requested).count();
+	src.requestTime->record(elapsed);
+
+	{
+		lock_guard<mutex> lock(_workMtx);
+		// Empty requests tell nothing about the throughput
+		if ( src.records && elapsed > 0 ) {
+			double rate = src.records / elapsed;
+			src.rate = src.rate > 0 ? 0.5 * (src.rate + rate) : rate;
+		}
+	}
+
+	return request(index);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BalancedConnection::isBounded() const {
+	for ( const auto &s : _streams ) {
+		if ( !(s.startTime.valid() ? s.startTime : _startTime).valid() )
+			return false;
+		if ( !(s.endTime.valid() ? s.endTime : _endTime).valid() )
+			return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BalancedConnection::split() {
+	const Core::TimeSpan day(86400, 0);
+
+	_work.clear();
+
+	for ( const auto &s : _streams ) {
+		Core::Time start = s.startTime.valid() ? s.startTime : _startTime;
+		Core::Time end = s.endTime.valid() ? s.endTime : _endTime;
+
+		Core::Time cutoff;
+		while ( start < end ) {
+			Core::Time next = min(start + day, end);
+			_work.push_back({s.net, s.sta, s.loc, s.cha, start, next, cutoff});
+			cutoff = start = next;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordStreamPtr BalancedConnection::request(size_t index) {
+	Source &src = _sources[index];
+
+	// Create the request before taking work to not lose it if the source
+	// is not available
+	RecordStreamPtr rs = RecordStream::Create(src.type.c_str());
+	if ( !rs || !rs->setSource(src.address) ) {
+		SEISCOMP_ERROR("Failed to create request for %s/%s",
+		               src.type.c_str(), src.address.c_str());
+		return nullptr;
+	}
+
+	vector<Work> batch;
+
+	{
+		lock_guard<mutex> lock(_workMtx);
+
+		if ( _work.empty() )
+			return nullptr;
+
+		// The share of the source of the total throughput, equal shares
+		// as long as not all sources have been measured
+		double total = 0;
+		bool measured = true;
+		for ( const auto &s : _sources ) {
+			total += s.rate;
+			if ( s.rate <= 0 ) measured = false;
+		}
+
+		double share = measured ? src.rate / total : 1.0 / _sources.size();
+
+		// Take half of the share of the remaining work to leave room for
+		// adapting to changes of the throughput
+		size_t count = max(size_t(1), size_t(ceil(_work.size() * share * 0.5)));
+
+		// Take at most one window per stream, otherwise the cutoffs of
+		// their records cannot be told apart
+		set<string> ids;
+		for ( auto it = _work.begin(); it != _work.end() && batch.size() < count; ) {
+			string id = it->net + "." + it->sta + "." + it->loc + "." + it->cha;
+			if ( !ids.insert(id).second ) {
+				++it;
+				continue;
+			}
+
+			batch.push_back(std::move(*it));
+			it = _work.erase(it);
+		}
+	}
+
+	if ( !_recordType.empty() )
+		rs->setRecordType(_recordType.c_str());
+	if ( _timeout >= 0 )
+		rs->setTimeout(_timeout);
+	rs->setDataType(_dataType);
+	rs->setDataHint(_hint);
+
+	src.streams.clear();
+	src.cutoffs.clear();
+
+	for ( const auto &w : batch ) {
+		if ( !rs->addStream(w.net, w.sta, w.loc, w.cha, w.startTime, w.endTime) ) {
+			SEISCOMP_ERROR("Failed to add stream %s.%s.%s.%s to %s/%s",
+			               w.net.c_str(), w.sta.c_str(), w.loc.c_str(),
+			               w.cha.c_str(), src.type.c_str(),
+			               src.address.c_str());
+			continue;
+		}
+
+		src.streams.add(w.net + "." + w.sta + "." + w.loc + "." + w.cha);
+		src.cutoffs.push_back(w.cutoff);
+	}
+
+	SEISCOMP_DEBUG("Requesting %zu windows from %s/%s",
+	               batch.size(), src.type.c_str(), src.address.c_str());
+
+	src.requested = Clock::now();
+	src.records = 0;
+
+	return rs;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
@@ -23,12 +23,31 @@
 
 
 #include <seiscomp/io/recordstream/concurrent.h>
+#include <seiscomp/core/metrics.h>
+#include <seiscomp/utils/wildcardmatcher.h>
 #include <seiscomp/core.h>
 
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
 
 namespace {
 
 
+/**
+ * Distributes the requested streams over a set of sources.
+ *
+ * Real-time requests are assigned statically by a hash of the station
+ * code. If all requested streams have an end time, the streams are split
+ * into time windows of at most a day and the sources fetch them in
+ * batches: whenever a source has delivered its batch it requests the next
+ * one. The size of a batch is a share of the remaining work according to
+ * the throughput measured per source, so faster sources take over the
+ * work of slower ones.
+ */
 class BalancedConnection : public Seiscomp::RecordStream::Concurrent {
 	public:
 		//! C'tor
@@ -38,11 +57,85 @@ class BalancedConnection : public Seiscomp::RecordStream::Concurrent {
 		//! Initialize the combined connection.
 		bool setSource(const std::string &serverloc) override;
 
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const Seiscomp::Core::Time &startTime,
+		               const Seiscomp::Core::Time &endTime) override;
+
+		bool setStartTime(const Seiscomp::Core::Time &stime) override;
+		bool setEndTime(const Seiscomp::Core::Time &etime) override;
+		bool setTimeWindow(const Seiscomp::Core::TimeWindow &w) override;
+		bool setTimeout(int seconds) override;
+		bool setRecordType(const char *type) override;
+
+		Seiscomp::Record *next() override;
+
 	protected:
 		int getRS(const std::string &networkCode,
 		          const std::string &stationCode,
 		          const std::string &locationCode,
 		          const std::string &channelCode) override;
+
+		bool acquired(size_t index, const Seiscomp::Record *rec) override;
+		Seiscomp::IO::RecordStreamPtr nextProxy(size_t index) override;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		//! A stream or a time window of a stream
+		struct Work {
+			std::string          net;
+			std::string          sta;
+			std::string          loc;
+			std::string          cha;
+			Seiscomp::Core::Time startTime;
+			Seiscomp::Core::Time endTime;
+			//! Records starting before have been delivered with the
+			//! previous window of the stream, unset for the first window
+			Seiscomp::Core::Time cutoff;
+		};
+
+		struct Source {
+			std::string                       type;
+			std::string                       address;
+			//! The smoothed number of records per second, zero if not
+			//! measured yet
+			double                            rate{0};
+
+			// The current request, only accessed by the acquisition
+			// thread of the source
+			Clock::time_point                 requested;
+			size_t                            records{0};
+			//! The streams of the request and their cutoff times
+			Seiscomp::Util::WildcardMatcher   streams;
+			std::vector<Seiscomp::Core::Time> cutoffs;
+
+			Seiscomp::Core::Metrics::Counter  *recordCount{nullptr};
+			Seiscomp::Core::Metrics::Timer    *requestTime{nullptr};
+			Seiscomp::Core::Metrics::Timer    *latency{nullptr};
+		};
+
+		bool isBounded() const;
+		void split();
+		//! Creates a request of the next batch of work for a source
+		Seiscomp::IO::RecordStreamPtr request(size_t index);
+
+		std::vector<Source>  _sources;
+		std::vector<Work>    _streams;
+		std::deque<Work>     _work;
+		std::mutex           _workMtx;
+
+		Seiscomp::Core::Time _startTime;
+		Seiscomp::Core::Time _endTime;
+		std::string          _recordType;
+		int                  _timeout{-1};
 };
 
 
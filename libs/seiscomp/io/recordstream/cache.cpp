@@ -0,0 +1,824 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT Cache
+
+#include <seiscomp/io/recordstream/cache.h>
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/system.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/system/environment.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::RecordStream;
+
+
+namespace fs = boost::filesystem;
+
+
+namespace {
+
+
+const char *TimeFormat = "%Y%m%dT%H%M%S.%f";
+const char *Extension = ".mseed";
+
+
+bool hasWildcards(const string &code) {
+	return code.find_first_of("*?") != string::npos;
+}
+
+
+string directoryName(const string &service, string address) {
+	// Do not expose credentials in the directory name
+	size_t pos = address.rfind('@');
+	if ( pos != string::npos ) {
+		address.erase(0, pos + 1);
+	}
+
+	string name = service + "_" + address;
+	for ( char &c : name ) {
+		if ( !isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.' ) {
+			c = '_';
+		}
+	}
+
+	return name;
+}
+
+
+string chunkName(const Core::TimeWindow &tw) {
+	return tw.startTime().toString(TimeFormat) + "_" +
+	       tw.endTime().toString(TimeFormat) + Extension;
+}
+
+
+bool parseChunkName(Core::TimeWindow &tw, const string &name) {
+	size_t extLen = strlen(Extension);
+	if ( name.size() <= extLen || name.compare(name.size() - extLen, extLen, Extension) ) {
+		return false;
+	}
+
+	size_t pos = name.find('_');
+	if ( pos == string::npos ) {
+		return false;
+	}
+
+	Core::Time startTime, endTime;
+	if ( !startTime.fromString(name.substr(0, pos).c_str(), TimeFormat)
+	  || !endTime.fromString(name.substr(pos + 1, name.size() - pos - 1 - extLen).c_str(), TimeFormat)
+	  || endTime <= startTime ) {
+		return false;
+	}
+
+	tw.set(startTime, endTime);
+	return true;
+}
+
+
+bool writeRecord(ostream &os, const Record *rec) {
+	try {
+		auto msrec = IO::MSeedRecord::ConstCast(rec);
+		const Array *raw = msrec ? msrec->raw() : nullptr;
+
+		if ( raw && raw->size() > 0 ) {
+			os.write(static_cast<const char*>(raw->data()),
+			         raw->size() * raw->elementSize());
+		}
+		else {
+			IO::MSeedRecord copy(*rec);
+			copy.write(os);
+		}
+	}
+	catch ( exception &e ) {
+		SEISCOMP_WARNING("%s: failed to cache record: %s",
+		                 rec->streamID().c_str(), e.what());
+		return false;
+	}
+
+	return os.good();
+}
+
+
+}
+
+
+IMPLEMENT_SC_CLASS_DERIVED(Cache,
+                           Seiscomp::IO::RecordStream,
+                           "Cache");
+
+REGISTER_RECORDSTREAM(Cache, "cache");
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string Cache::Request::streamID() const {
+	return networkCode + "." + stationCode + "." + locationCode + "." + channelCode;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Cache::Cache() : _minAge(3600, 0) {
+	_factory = RecordFactory::Find("mseed");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Cache::~Cache() {
+	releaseProxy();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::setSource(const string &source) {
+	string proxy = source;
+	string params;
+
+	size_t pos = proxy.find("??");
+	if ( pos != string::npos ) {
+		params = proxy.substr(pos + 2);
+		proxy.erase(pos);
+	}
+
+	pos = proxy.find('/');
+	if ( pos != string::npos ) {
+		_service = proxy.substr(0, pos);
+		_address = proxy.substr(pos + 1);
+	}
+	else {
+		_service = proxy;
+		_address.clear();
+	}
+
+	if ( _service.empty() ) {
+		SEISCOMP_ERROR("Missing proxy stream, expected cache://service/source");
+		return false;
+	}
+
+	string dir;
+
+	vector<string> toks;
+	Core::split(toks, params.c_str(), "&");
+	for ( const auto &tok : toks ) {
+		string name, value;
+
+		pos = tok.find('=');
+		if ( pos != string::npos ) {
+			name = tok.substr(0, pos);
+			value = tok.substr(pos + 1);
+		}
+		else {
+			name = tok;
+		}
+
+		if ( name == "dir" ) {
+			dir = value;
+		}
+		else if ( name == "minAge" ) {
+			double minAge;
+			if ( !Core::fromString(minAge, value) || minAge < 0 ) {
+				SEISCOMP_ERROR("Invalid cache value for '%s': expected a positive "
+				               "numerical value", name.c_str());
+				throw IO::RecordStreamException("invalid minAge parameter value");
+			}
+
+			_minAge = Core::TimeSpan(minAge);
+		}
+		else if ( !name.empty() ) {
+			SEISCOMP_ERROR("Unknown cache parameter '%s'", name.c_str());
+			throw IO::RecordStreamException("invalid cache parameter");
+		}
+	}
+
+	if ( dir.empty() ) {
+		_directory = Environment::Instance()->installDir() + "/var/cache/waveforms/" +
+		             directoryName(_service, _address);
+	}
+	else {
+		_directory = Environment::Instance()->absolutePath(dir);
+	}
+
+	IO::RecordStreamPtr test = Create(_service.c_str());
+	if ( !test ) {
+		SEISCOMP_ERROR("Unable to create proxy service: %s", _service.c_str());
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::setRecordType(const char *type) {
+	_recordType = type;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::addStream(const string &net, const string &sta,
+                      const string &loc, const string &cha) {
+	_requests.push_back({net, sta, loc, cha, Core::Time(), Core::Time()});
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::addStream(const string &net, const string &sta,
+                      const string &loc, const string &cha,
+                      const Seiscomp::Core::Time &startTime,
+                      const Seiscomp::Core::Time &endTime) {
+	_requests.push_back({net, sta, loc, cha, startTime, endTime});
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::setStartTime(const Seiscomp::Core::Time &startTime) {
+	_startTime = startTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::setEndTime(const Seiscomp::Core::Time &endTime) {
+	_endTime = endTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::setTimeout(int seconds) {
+	_timeout = seconds;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Cache::close() {
+	_closeRequested = true;
+
+	lock_guard<mutex> l(_mutex);
+	if ( _proxy ) {
+		_proxy->close();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Cache::Request Cache::effective(const Request &req) const {
+	Request res(req);
+	if ( !res.startTime.valid() ) {
+		res.startTime = _startTime;
+	}
+	if ( !res.endTime.valid() ) {
+		res.endTime = _endTime;
+	}
+	return res;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::isCacheable(const Request &req) const {
+	if ( hasWildcards(req.networkCode) || hasWildcards(req.stationCode)
+	  || hasWildcards(req.locationCode) || hasWildcards(req.channelCode) ) {
+		return false;
+	}
+
+	if ( !req.startTime.valid() || !req.endTime.valid()
+	  || req.endTime <= req.startTime ) {
+		return false;
+	}
+
+	// Recent data may still be incomplete upstream
+	return req.endTime <= Core::Time::GMT() - _minAge;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string Cache::streamDirectory(const Request &req) const {
+	return _directory + "/" + req.networkCode + "/" + req.stationCode + "/" +
+	       req.streamID();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Cache::Chunks Cache::chunks(const Request &req) const {
+	Chunks res;
+	string dir = streamDirectory(req);
+
+	try {
+		SC_FS_DECLARE_PATH(path, dir)
+		if ( !fs::is_directory(path) ) {
+			return res;
+		}
+
+		fs::directory_iterator end;
+		for ( fs::directory_iterator it(path); it != end; ++it ) {
+			string name = SC_FS_FILE_NAME(SC_FS_DE_PATH(it));
+			Chunk chunk;
+
+			// Skip partial downloads
+			if ( name.empty() || name[0] == '.' ) {
+				continue;
+			}
+
+			if ( !parseChunkName(chunk.window, name) ) {
+				continue;
+			}
+
+			chunk.path = dir + "/" + name;
+			res.push_back(chunk);
+		}
+	}
+	catch ( exception &e ) {
+		SEISCOMP_WARNING("Failed to read cache directory %s: %s",
+		                 dir.c_str(), e.what());
+	}
+
+	sort(res.begin(), res.end(), [](const Chunk &a, const Chunk &b) {
+		return a.window.startTime() < b.window.startTime();
+	});
+
+	return res;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Cache::Gaps Cache::gaps(const Request &req) const {
+	Gaps res;
+	Core::Time cursor = req.startTime;
+
+	for ( const auto &chunk : chunks(req) ) {
+		if ( chunk.window.endTime() <= cursor ) {
+			continue;
+		}
+
+		if ( chunk.window.startTime() >= req.endTime ) {
+			break;
+		}
+
+		if ( chunk.window.startTime() > cursor ) {
+			res.push_back(Core::TimeWindow(cursor, chunk.window.startTime()));
+		}
+
+		cursor = chunk.window.endTime();
+		if ( cursor >= req.endTime ) {
+			break;
+		}
+	}
+
+	if ( cursor < req.endTime ) {
+		res.push_back(Core::TimeWindow(cursor, req.endTime));
+	}
+
+	return res;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+IO::RecordStream *Cache::createProxy() {
+	IO::RecordStreamPtr proxy = Create(_service.c_str());
+	if ( !proxy ) {
+		SEISCOMP_ERROR("Unable to create proxy service: %s", _service.c_str());
+		return nullptr;
+	}
+
+	try {
+		if ( !proxy->setSource(_address) ) {
+			SEISCOMP_ERROR("Failed to set proxy source: %s", _address.c_str());
+			return nullptr;
+		}
+	}
+	catch ( exception &e ) {
+		SEISCOMP_ERROR("Failed to set proxy source: %s", e.what());
+		return nullptr;
+	}
+
+	if ( !_recordType.empty() ) {
+		proxy->setRecordType(_recordType.c_str());
+	}
+
+	if ( _timeout ) {
+		proxy->setTimeout(_timeout);
+	}
+
+	lock_guard<mutex> l(_mutex);
+	_proxy = proxy;
+	if ( _closeRequested ) {
+		_proxy->close();
+	}
+
+	return _proxy.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Cache::releaseProxy() {
+	lock_guard<mutex> l(_mutex);
+	_proxy = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::fetch(const vector<pair<size_t, Core::TimeWindow>> &windows) {
+	struct Output {
+		string        path;
+		string        partPath;
+		ofstream      stream;
+		size_t        records{0};
+		bool          good{true};
+	};
+
+	IO::RecordStream *proxy = createProxy();
+	if ( !proxy ) {
+		return false;
+	}
+
+	// Keep the raw records to write them unchanged
+	proxy->setDataHint(Record::SAVE_RAW);
+
+	map<string, unique_ptr<Output>> outputs;
+
+	for ( const auto &item : windows ) {
+		const Request req = effective(_requests[item.first]);
+		const Core::TimeWindow &tw = item.second;
+
+		// Duplicate requests of a channel are fetched only once
+		if ( outputs.find(req.streamID()) != outputs.end() ) {
+			continue;
+		}
+
+		string dir = streamDirectory(req);
+		string name = chunkName(tw);
+
+		try {
+			fs::create_directories(SC_FS_PATH(dir));
+		}
+		catch ( exception &e ) {
+			SEISCOMP_ERROR("Failed to create cache directory %s: %s",
+			               dir.c_str(), e.what());
+			continue;
+		}
+
+		unique_ptr<Output> output(new Output);
+		output->path = dir + "/" + name;
+		output->partPath = dir + "/." + name + ".part";
+		output->stream.open(output->partPath.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+		if ( !output->stream.is_open() ) {
+			SEISCOMP_ERROR("Failed to create cache file %s", output->partPath.c_str());
+			continue;
+		}
+
+		SEISCOMP_DEBUG("%s: fetching %s ~ %s", req.streamID().c_str(),
+		               tw.startTime().iso().c_str(), tw.endTime().iso().c_str());
+
+		proxy->addStream(req.networkCode, req.stationCode, req.locationCode,
+		                 req.channelCode, tw.startTime(), tw.endTime());
+		outputs[req.streamID()] = std::move(output);
+	}
+
+	bool success = !outputs.empty();
+
+	if ( success ) {
+		try {
+			Record *rec;
+			while ( (rec = proxy->next()) ) {
+				auto it = outputs.find(rec->streamID());
+				if ( it != outputs.end() ) {
+					Output &output = *it->second;
+					if ( writeRecord(output.stream, rec) ) {
+						++output.records;
+					}
+					else {
+						output.good = false;
+					}
+				}
+
+				delete rec;
+			}
+		}
+		catch ( exception &e ) {
+			SEISCOMP_ERROR("Failed to fetch records from proxy stream: %s", e.what());
+			success = false;
+		}
+	}
+
+	releaseProxy();
+
+	if ( _closeRequested ) {
+		success = false;
+	}
+
+	for ( auto &item : outputs ) {
+		Output &output = *item.second;
+		output.stream.close();
+
+		// Windows without data are not stored as covered because an empty
+		// response cannot be told apart from an upstream failure.
+		if ( success && output.good && output.records ) {
+			if ( ::rename(output.partPath.c_str(), output.path.c_str()) == 0 ) {
+				continue;
+			}
+
+			SEISCOMP_ERROR("Failed to rename cache file %s", output.partPath.c_str());
+		}
+
+		::unlink(output.partPath.c_str());
+	}
+
+	return success;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Cache::prepare() {
+	vector<Gaps> requestGaps(_requests.size());
+	vector<bool> cached(_requests.size(), false);
+	size_t rounds = 0;
+
+	for ( size_t i = 0; i < _requests.size(); ++i ) {
+		Request req = effective(_requests[i]);
+		if ( !isCacheable(req) ) {
+			_forward.push_back(req);
+			continue;
+		}
+
+		cached[i] = true;
+		requestGaps[i] = gaps(req);
+		rounds = max(rounds, requestGaps[i].size());
+	}
+
+	// Most record streams accept only one time window per channel, so the
+	// n-th gap of each channel is fetched in the n-th round.
+	for ( size_t round = 0; round < rounds; ++round ) {
+		vector<pair<size_t, Core::TimeWindow>> windows;
+
+		for ( size_t i = 0; i < requestGaps.size(); ++i ) {
+			if ( round < requestGaps[i].size() ) {
+				windows.push_back(make_pair(i, requestGaps[i][round]));
+			}
+		}
+
+		if ( !fetch(windows) ) {
+			SEISCOMP_WARNING("Fetching missing data failed, serving the cached "
+			                 "records only");
+			break;
+		}
+	}
+
+	for ( size_t i = 0; i < _requests.size(); ++i ) {
+		if ( !cached[i] ) {
+			continue;
+		}
+
+		Request req = effective(_requests[i]);
+		for ( const auto &chunk : chunks(req) ) {
+			if ( chunk.window.endTime() <= req.startTime
+			  || chunk.window.startTime() >= req.endTime ) {
+				continue;
+			}
+
+			_files.push_back(make_pair(i, chunk.path));
+		}
+	}
+
+	_fileRequest = _requests.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Cache::openNextChunk() {
+	while ( !_files.empty() ) {
+		auto item = _files.front();
+		_files.pop_front();
+
+		if ( item.first != _fileRequest ) {
+			_fileRequest = item.first;
+			_lastEndTime = Core::Time();
+		}
+
+		_file.clear();
+		_file.open(item.second.c_str(), ios_base::in | ios_base::binary);
+		if ( _file.is_open() ) {
+			return true;
+		}
+
+		SEISCOMP_WARNING("Failed to open cache file %s", item.second.c_str());
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *Cache::nextCached() {
+	if ( !_factory ) {
+		return nullptr;
+	}
+
+	while ( !_closeRequested ) {
+		if ( !_file.is_open() && !openNextChunk() ) {
+			return nullptr;
+		}
+
+		Record *rec = _factory->create();
+		if ( !rec ) {
+			return nullptr;
+		}
+
+		setupRecord(rec);
+
+		try {
+			rec->read(_file);
+		}
+		catch ( Core::EndOfStreamException & ) {
+			delete rec;
+			_file.close();
+			continue;
+		}
+		catch ( exception &e ) {
+			SEISCOMP_ERROR("Skipping corrupt cache file: %s", e.what());
+			delete rec;
+			_file.close();
+			continue;
+		}
+
+		const Request req = effective(_requests[_fileRequest]);
+
+		try {
+			Core::Time endTime = rec->endTime();
+
+			// Adjacent chunks share the records at their boundaries
+			if ( endTime <= req.startTime || rec->startTime() >= req.endTime
+			  || (_lastEndTime.valid() && endTime <= _lastEndTime) ) {
+				delete rec;
+				continue;
+			}
+
+			_lastEndTime = endTime;
+		}
+		catch ( ... ) {
+			delete rec;
+			continue;
+		}
+
+		return rec;
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *Cache::next() {
+	if ( !_closeRequested ) {
+		if ( !_prepared ) {
+			prepare();
+			_prepared = true;
+
+			// Stream everything which is not cacheable from the proxy
+			if ( !_forward.empty() && !_closeRequested ) {
+				IO::RecordStream *proxy = createProxy();
+				if ( proxy ) {
+					proxy->setDataType(_dataType);
+					proxy->setDataHint(_hint);
+					proxy->setStartTime(_startTime);
+					proxy->setEndTime(_endTime);
+
+					for ( const auto &req : _forward ) {
+						if ( req.startTime.valid() || req.endTime.valid() ) {
+							proxy->addStream(req.networkCode, req.stationCode,
+							                 req.locationCode, req.channelCode,
+							                 req.startTime, req.endTime);
+						}
+						else {
+							proxy->addStream(req.networkCode, req.stationCode,
+							                 req.locationCode, req.channelCode);
+						}
+					}
+				}
+
+				_forward.clear();
+			}
+		}
+
+		Record *rec = nextCached();
+		if ( rec ) {
+			return rec;
+		}
+
+		if ( _proxy && !_closeRequested ) {
+			rec = _proxy->next();
+			if ( rec ) {
+				return rec;
+			}
+		}
+	}
+
+	// Finished or closed, reset for the next request
+	releaseProxy();
+	_file.close();
+	_files.clear();
+	_requests.clear();
+	_forward.clear();
+	_prepared = false;
+	_closeRequested = false;
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
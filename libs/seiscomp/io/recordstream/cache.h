@@ -0,0 +1,166 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_RECORDSTREAM_CACHE_H
+#define SEISCOMP_RECORDSTREAM_CACHE_H
+
+
+#include <seiscomp/io/recordstream.h>
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+DEFINE_SMARTPOINTER(Cache);
+
+/**
+ * @brief Proxy record stream which keeps the records fetched from an
+ *        archive service, e.g. fdsnws or arclink, in a local directory.
+ *
+ * Each fetched time window of a channel is stored as one miniSEED file
+ * whose name holds the time window. The set of files of a channel thus
+ * describes the time intervals which are covered by the cache. A request
+ * only fetches the gaps from the proxy stream and reads all data from the
+ * cache afterwards. Requests with wildcards, without end time or which end
+ * less than minAge seconds ago are passed to the proxy stream unchanged.
+ */
+class SC_SYSTEM_CORE_API Cache : public Seiscomp::IO::RecordStream {
+	DECLARE_SC_CLASS(Cache)
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		Cache();
+		~Cache() override;
+
+
+	// ----------------------------------------------------------------------
+	//  RecordStream interface
+	// ----------------------------------------------------------------------
+	public:
+		bool setSource(const std::string &source) override;
+		bool setRecordType(const char *type) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const Seiscomp::Core::Time &startTime,
+		               const Seiscomp::Core::Time &endTime) override;
+
+		bool setStartTime(const Seiscomp::Core::Time &startTime) override;
+		bool setEndTime(const Seiscomp::Core::Time &endTime) override;
+		bool setTimeout(int seconds) override;
+
+		void close() override;
+
+		Record *next() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the directory of the cached records
+		const std::string &directory() const { return _directory; }
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		struct Request {
+			std::string networkCode;
+			std::string stationCode;
+			std::string locationCode;
+			std::string channelCode;
+			Core::Time  startTime;
+			Core::Time  endTime;
+
+			std::string streamID() const;
+		};
+
+		struct Chunk {
+			Core::TimeWindow window;
+			std::string      path;
+		};
+
+		using Requests = std::vector<Request>;
+		using Chunks = std::vector<Chunk>;
+		using Gaps = std::vector<Core::TimeWindow>;
+
+		Request effective(const Request &req) const;
+		bool isCacheable(const Request &req) const;
+		std::string streamDirectory(const Request &req) const;
+		Chunks chunks(const Request &req) const;
+		Gaps gaps(const Request &req) const;
+
+		IO::RecordStream *createProxy();
+		void releaseProxy();
+		bool fetch(const std::vector<std::pair<size_t, Core::TimeWindow>> &windows);
+		void prepare();
+		bool openNextChunk();
+		Record *nextCached();
+
+		std::string                    _service;
+		std::string                    _address;
+		std::string                    _directory;
+		std::string                    _recordType;
+		Core::TimeSpan                 _minAge;
+		Requests                       _requests;
+		Requests                       _forward;
+		Core::Time                     _startTime;
+		Core::Time                     _endTime;
+		int                            _timeout{0};
+
+		std::mutex                     _mutex;
+		IO::RecordStreamPtr            _proxy;
+		std::atomic<bool>              _closeRequested{false};
+		bool                           _prepared{false};
+
+		std::deque<std::pair<size_t, std::string>> _files;
+		std::ifstream                  _file;
+		size_t                         _fileRequest{0};
+		Core::Time                     _lastEndTime;
+		RecordFactory                 *_factory{nullptr};
+};
+
+
+}
+}
+
+
+#endif
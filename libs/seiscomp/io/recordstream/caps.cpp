@@ -35,6 +35,7 @@
 
 #include <libmseed.h>
 #include <ctype.h>
+#include <poll.h>
 #include <functional>
 #include <fstream>
 
@@ -62,8 +63,16 @@ struct RecordHeaderTime {
 };
 
 
+//! Records which can be read from a buffer holding the complete payload
+class BufferRecord {
+	public:
+		virtual ~BufferRecord() {}
+		virtual void read(const char *data, int size) = 0;
+};
+
+
 template <typename INPUTTYPE>
-class CAPSRecord : public GenericRecord {
+class CAPSRecord : public GenericRecord, public BufferRecord {
 	public:
 		CAPSRecord(std::string net, std::string sta,
 		           std::string loc, std::string cha,
@@ -117,6 +126,31 @@ class CAPSRecord : public GenericRecord {
 			setData(ar.get());
 		}
 
+		void read(const char *data, int size) override {
+			if ( size < _nsamp * static_cast<int>(sizeof(INPUTTYPE)) )
+				throw Core::StreamException("not enough samples in stream");
+
+			ArrayPtr ar;
+
+			switch ( _datatype ) {
+				case Array::CHAR:
+					ar = readData<char>(data);
+					break;
+				case Array::INT:
+					ar = readData<int>(data);
+					break;
+				default:
+				case Array::FLOAT:
+					ar = readData<float>(data);
+					break;
+				case Array::DOUBLE:
+					ar = readData<double>(data);
+					break;
+			};
+
+			setData(ar.get());
+		}
+
 
 	private:
 		template <typename T>
@@ -132,17 +166,28 @@ class CAPSRecord : public GenericRecord {
 			}
 			return true;
 		}
+
+		template <typename T>
+		TypedArray<T> *readData(const char *data) {
+			TypedArray<T> *target = new TypedArray<T>(_nsamp);
+			T *samples = target->typedData();
+			for ( int i = 0; i < _nsamp; ++i, data += sizeof(INPUTTYPE) ) {
+				INPUTTYPE val;
+				memcpy(&val, data, sizeof(val));
+				samples[i] = (T)gc::Endianess::Converter::FromLittleEndian(val);
+			}
+			return target;
+		}
 };
 
 
-class MSeedRecord_ : public IO::MSeedRecord {
+class MSeedRecord_ : public IO::MSeedRecord, public BufferRecord {
 	public:
 		MSeedRecord_() {}
 
 	public:
 		void read(std::istream &is) {
 			int reclen = -1;
-			MSRecord *prec = nullptr;
 			const int LEN = 128;
 			char header[LEN];
 
@@ -168,7 +213,36 @@ class MSeedRecord_ : public IO::MSeedRecord {
 			if ( !is.read(&rawrec[LEN], reclen-LEN) )
 				throw Core::StreamException("Fatal error occured during reading from stream");
 
-			if ( msr_unpack(&rawrec[0], reclen, &prec, 0, 0) == MS_NOERROR ) {
+			unpack(&rawrec[0], reclen);
+		}
+
+		void read(const char *data, int size) override {
+			const int LEN = 128;
+
+			if ( size < LEN )
+				throw Core::StreamException("Incomplete header");
+
+			if ( !MS_ISVALIDHEADER(data) )
+				throw IO::LibmseedException("Invalid header");
+
+			int reclen = ms_detect(data, size);
+			if ( reclen <= 0 )
+				throw IO::LibmseedException("Retrieving the record length failed");
+
+			if ( reclen < LEN )
+				throw Core::EndOfStreamException("Invalid miniSEED record, too small");
+
+			if ( reclen > size )
+				throw Core::StreamException("Fatal error occured during reading from stream");
+
+			unpack(const_cast<char*>(data), reclen);
+		}
+
+	private:
+		void unpack(char *data, int reclen) {
+			MSRecord *prec = nullptr;
+
+			if ( msr_unpack(data, reclen, &prec, 0, 0) == MS_NOERROR ) {
 				*static_cast<IO::MSeedRecord*>(this) = IO::MSeedRecord(prec,this->_datatype,this->_hint);
 				msr_free(&prec);
 				if ( _fsamp <= 0 )
@@ -563,120 +637,85 @@ bool RecordStream::handshake() {
 		if ( _terminated )
 			return false;
 
-		// Do handshake
-		if ( !_user.empty() && !_password.empty() ) {
-			string auth = "AUTH "+ _user + " " + _password + "\n";
-			_socket->write(auth.c_str(), auth.length());
-		}
+		// Do handshake. All requests are sent at once and the server
+		// response is read afterwards.
+		string handshake;
+
+		if ( !_user.empty() && !_password.empty() )
+			handshake += "AUTH "+ _user + " " + _password + "\n";
 
-		_socket->write("BEGIN REQUEST\n", 14);
+		handshake += "BEGIN REQUEST\n";
 
 		if ( !_realtime )
-			_socket->write("REALTIME OFF\n", 13);
+			handshake += "REALTIME OFF\n";
 
 		if ( _ooo )
-			_socket->write("OUTOFORDER ON\n", 14);
+			handshake += "OUTOFORDER ON\n";
 
 		if ( _minMTime.valid() || _maxMTime.valid() ) {
-			_socket->write("MTIME ", 6);
-			if ( _minMTime.valid() ) {
-				auto s = _minMTime.toString("%Y,%m,%d,%H,%M,%S,%f");
-				_socket->write(s.c_str(), s.size());
-			}
-			_socket->write(":", 1);
-			if ( _maxMTime.valid() ) {
-				auto s = _maxMTime.toString("%Y,%m,%d,%H,%M,%S,%f");
-				_socket->write(s.c_str(), s.size());
-			}
-			_socket->write("\n", 1);
+			handshake += "MTIME ";
+			if ( _minMTime.valid() )
+				handshake += _minMTime.toString("%Y,%m,%d,%H,%M,%S,%f");
+			handshake += ":";
+			if ( _maxMTime.valid() )
+				handshake += _maxMTime.toString("%Y,%m,%d,%H,%M,%S,%f");
+			handshake += "\n";
 		}
 
-		// First pass: continue all previous streams
-		for ( RequestList::iterator it = _requests.begin();
-		      it != _requests.end(); ++it ) {
-			if ( it->second.receivedData == false ) continue;
+		auto appendTime = [](stringstream &req, const Core::Time &time) {
+			int year, mon, day, hour, minute, second, microseconds;
+			time.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
+			req << year << "," << mon << "," << day << ","
+			    << hour << "," << minute << "," << second << "," << microseconds;
+		};
 
+		auto appendRequest = [&](const RequestList::value_type &request) {
 			stringstream req;
-			req << "STREAM ADD " << it->first << endl;
+			req << "STREAM ADD " << request.first << endl;
 			req << "TIME ";
 
-			int year, mon, day, hour, minute, second, microseconds;
-
-			if ( it->second.start.valid() ) {
-				it->second.start.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
-			else if ( _startTime.valid() ) {
-				_startTime.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
+			if ( request.second.start.valid() )
+				appendTime(req, request.second.start);
+			else if ( _startTime.valid() )
+				appendTime(req, _startTime);
 
 			req << ":";
 
-			if ( it->second.end.valid() ) {
-				it->second.end.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
-			else if ( _endTime.valid() ) {
-				_endTime.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
+			if ( request.second.end.valid() )
+				appendTime(req, request.second.end);
+			else if ( _endTime.valid() )
+				appendTime(req, _endTime);
 
 			req << endl;
 
 			string line = req.str();
 			SEISCOMP_DEBUG("%s", line.c_str());
-			_socket->write(line.c_str(), line.size());
+			handshake += line;
+		};
+
+		// First pass: continue all previous streams
+		for ( const auto &request : _requests ) {
+			if ( request.second.receivedData )
+				appendRequest(request);
 		}
 
 		// Second pass: subscribe to remaining streams
-		for ( RequestList::iterator it = _requests.begin();
-		      it != _requests.end(); ++it ) {
-			if ( it->second.receivedData == true ) continue;
-
-			stringstream req;
-			req << "STREAM ADD " << it->first << endl;
-			req << "TIME ";
-
-			int year, mon, day, hour, minute, second, microseconds;
-
-			if ( it->second.start.valid() ) {
-				it->second.start.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
-			else if ( _startTime.valid() ) {
-				_startTime.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
-
-			req << ":";
-
-			if ( it->second.end.valid() ) {
-				it->second.end.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
-			else if ( _endTime.valid() ) {
-				_endTime.get(&year, &mon, &day, &hour, &minute, &second, &microseconds);
-				req << year << "," << mon << "," << day << ","
-				    << hour << "," << minute << "," << second << "," << microseconds;
-			}
+		for ( const auto &request : _requests ) {
+			if ( !request.second.receivedData )
+				appendRequest(request);
+		}
 
-			req << endl;
+		handshake += "END\n";
 
-			string line = req.str();
-			SEISCOMP_DEBUG("%s", line.c_str());
-			_socket->write(line.c_str(), line.size());
+		const char *data = handshake.c_str();
+		size_t remaining = handshake.size();
+		while ( remaining > 0 ) {
+			ssize_t sent = _socket->write(data, remaining);
+			if ( sent <= 0 ) break;
+			data += sent;
+			remaining -= sent;
 		}
 
-		_socket->write("END\n", 4);
-
 		_buf.set_read_limit(-1);
 		gc::ResponseHeader header;
 		if ( !header.get(_buf) ) {
@@ -927,7 +966,17 @@ Record *RecordStream::next() {
 					setupRecord(rec);
 
 					try {
-						rec->read(_stream);
+						// Parse the payload in place if it fits into the
+						// receive buffer, otherwise read it through the stream
+						BufferRecord *bufferRecord = dynamic_cast<BufferRecord*>(rec);
+						const char *payload = bufferRecord && (header.size > 0) ?
+						                      _buf.view(header.size) : nullptr;
+						if ( payload ) {
+							bufferRecord->read(payload, header.size);
+							_buf.consume(header.size);
+						}
+						else
+							rec->read(_stream);
 
 						if ( _currentItem != nullptr ) {
 							// Never throw when an invalid record has parsed. Better let the application
@@ -945,6 +994,7 @@ Record *RecordStream::next() {
 					catch ( std::exception &e ) {
 						_stream.clear();
 						SEISCOMP_WARNING("parse record error: %s", e.what());
+						delete rec;
 					}
 				}
 			}
@@ -965,6 +1015,46 @@ Record *RecordStream::next() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RecordStream::hasPendingData() const {
+	if ( _buf.buffered() > 0 ) return true;
+	if ( !_socket || !_socket->isValid() ) return false;
+
+	struct pollfd pfd;
+	pfd.fd = _socket->fd();
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	return (::poll(&pfd, 1, 0) > 0) && (pfd.revents & POLLIN);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t RecordStream::nextBatch(std::vector<Record*> &records, size_t max) {
+	size_t count = 0;
+
+	// Only the first record is waited for, further records are returned
+	// as long as data has already been received
+	while ( count < max ) {
+		if ( count && !hasPendingData() ) break;
+
+		Record *rec = next();
+		if ( !rec ) break;
+
+		records.push_back(rec);
+		++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool RecordStream::setStartTime(const Core::Time &stime) {
 	_startTime = stime;
@@ -28,6 +28,8 @@
 #include <seiscomp/wired/devices/socket.h>
 #include <seiscomp3/io/recordstream.h>
 
+#include <algorithm>
+#include <cstring>
 #include <list>
 #include <map>
 
@@ -81,6 +83,59 @@ class socketbuf : public std::streambuf {
 			return egptr() - gptr() + _allowed_reads;
 		}
 
+		//! Returns the number of received bytes which have not been read yet
+		int buffered() const {
+			return eback() + _real_buffer_size - gptr();
+		}
+
+		/**
+		 * @brief Returns a pointer to the next bytes in the receive buffer
+		 *        without copying them.
+		 *
+		 * Pending bytes are moved to the front of the buffer and the
+		 * socket is read until the requested number of bytes is
+		 * available. The bytes are not consumed, call consume after
+		 * they have been processed.
+		 * @param bytes The number of bytes which must not exceed the read
+		 *              limit and the buffer size.
+		 * @return The pointer or NULL if the bytes cannot be provided. If
+		 *         the connection has been closed the read limit is set to 0.
+		 */
+		char *view(int bytes) {
+			if ( bytes > N ) return NULL;
+
+			int limit = read_limit();
+			if ( (limit >= 0) && (bytes > limit) ) return NULL;
+
+			int available = buffered();
+			if ( available < bytes ) {
+				memmove(_in, gptr(), available);
+				_real_buffer_size = available;
+
+				while ( _real_buffer_size < bytes ) {
+					int res = _sock->read(_in + _real_buffer_size, N - _real_buffer_size);
+					if ( res <= 0 ) {
+						_real_buffer_size = 0;
+						setg(_in, _in, _in);
+						_allowed_reads = 0;
+						return NULL;
+					}
+
+					_real_buffer_size += res;
+				}
+
+				setg(_in, _in, _in + _real_buffer_size);
+				set_read_limit(limit);
+			}
+
+			return gptr();
+		}
+
+		//! Consumes bytes of the get area, see view
+		void consume(int bytes) {
+			gbump(bytes);
+		}
+
 
 	protected:
 		virtual int underflow() {
@@ -130,10 +185,13 @@ class socketbuf : public std::streambuf {
 				return -1;
 
 			while ( off > 0 ) {
-				int ch = sbumpc();
-				if ( ch == traits_type::eof() )
+				if ( (gptr() == egptr())
+				  && traits_type::eq_int_type(underflow(), traits_type::eof()) )
 					return -1;
-				--off;
+
+				std::streamoff n = std::min<std::streamoff>(off, egptr() - gptr());
+				gbump(n);
+				off -= n;
 			}
 
 			return 0;
@@ -188,6 +246,8 @@ class RecordStream : public Seiscomp::IO::RecordStream {
 
 		Seiscomp::Record *next() override;
 
+		size_t nextBatch(std::vector<Seiscomp::Record*> &records, size_t max) override;
+
 	// ----------------------------------------------------------------------
 	// protected methods
 	// ----------------------------------------------------------------------
@@ -235,6 +295,7 @@ class RecordStream : public Seiscomp::IO::RecordStream {
 		void wait();
 		void disconnect();
 		bool handshake();
+		bool hasPendingData() const;
 		void onItemAboutToBeRemoved(const SessionTableItem *item);
 
 
@@ -248,7 +309,7 @@ class RecordStream : public Seiscomp::IO::RecordStream {
 		std::istream            _stream;
 		RequestList             _requests;
 		SocketPtr               _socket;
-		socketbuf<512>          _buf;
+		socketbuf<65536>        _buf;
 		char                    _lineBuf[201];
 		std::string             _host;
 		int                     _port;
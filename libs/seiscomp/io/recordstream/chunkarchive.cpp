@@ -0,0 +1,780 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT ChunkArchive
+
+#include <errno.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/system/environment.h>
+#include <seiscomp/utils/files.h>
+
+#include "chunkarchive.h"
+
+
+using namespace std;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+REGISTER_RECORDSTREAM(ChunkArchive, "chunkarchive");
+
+
+namespace {
+
+
+const char *FileMagic = "SCCHKAR1";
+const char *IndexMagic = "SCCHKIX1";
+const char *ChunkMagic = "CHNK";
+const uint32_t ByteOrder = 0x01020304;
+const int64_t Microseconds = 1000000;
+const int64_t MicrosecondsPerDay = 86400 * Microseconds;
+const size_t BlockSize = 128;
+
+enum Encoding {
+	Int32DeltaBitPack = 1,
+	Float64 = 2
+};
+
+
+struct FileHeader {
+	char     magic[8];
+	uint32_t byteOrder;
+	uint32_t reserved;
+};
+
+
+struct ChunkHeader {
+	char     magic[4];
+	uint32_t count;
+	int64_t  startTime;
+	double   samplingFrequency;
+	uint32_t encoding;
+	uint32_t size;
+};
+
+
+struct IndexEntry {
+	int64_t  startTime;
+	int64_t  endTime;
+	uint64_t offset;
+	uint32_t size;
+	uint32_t count;
+};
+
+
+int64_t toMicroseconds(const Time &time) {
+	return static_cast<int64_t>(time.seconds()) * Microseconds + time.microseconds();
+}
+
+
+Time fromMicroseconds(int64_t usecs) {
+	int64_t secs = usecs / Microseconds;
+	usecs -= secs * Microseconds;
+	if ( usecs < 0 ) {
+		--secs;
+		usecs += Microseconds;
+	}
+
+	return Time(static_cast<long>(secs), static_cast<long>(usecs));
+}
+
+
+int64_t dayOf(int64_t usecs) {
+	int64_t day = usecs / MicrosecondsPerDay;
+	return usecs < 0 && day * MicrosecondsPerDay != usecs ? day - 1 : day;
+}
+
+
+//! Returns the time of sample index relative to start
+int64_t sampleTime(int64_t start, double fsamp, size_t index) {
+	return start + static_cast<int64_t>(llround(index * Microseconds / fsamp));
+}
+
+
+string dayFile(const string &root, const string &net, const string &sta,
+               const string &loc, const string &cha, int64_t day) {
+	int year, yday;
+	Time(static_cast<long>(day * 86400), 0).get2(&year, &yday);
+
+	char doy[4];
+	snprintf(doy, sizeof(doy), "%03d", yday + 1);
+	string y = toString(year);
+
+	return root + "/" + y + "/" + net + "/" + sta + "/" + cha + ".C/" +
+	       net + "." + sta + "." + loc + "." + cha + ".C." + y + "." + doy;
+}
+
+
+string sidecar(const string &fname) {
+	size_t pos = fname.rfind('/');
+	if ( pos == string::npos )
+		return "." + fname + ".idx";
+	return fname.substr(0, pos+1) + "." + fname.substr(pos+1) + ".idx";
+}
+
+
+/**
+ * @brief Encodes the differences of subsequent samples as zigzag integers,
+ *        bit packed in blocks of BlockSize values. Each block starts with
+ *        one byte holding the bit width of its values.
+ */
+void encodeInt32(const int32_t *samples, size_t n, string &out) {
+	uint32_t values[BlockSize];
+	uint32_t prev = 0;
+
+	for ( size_t i = 0; i < n; i += BlockSize ) {
+		size_t m = min(BlockSize, n - i);
+		uint32_t bits = 0;
+
+		for ( size_t j = 0; j < m; ++j ) {
+			uint32_t cur = static_cast<uint32_t>(samples[i+j]);
+			int32_t delta = static_cast<int32_t>(cur - prev);
+			values[j] = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+			bits |= values[j];
+			prev = cur;
+		}
+
+		uint8_t width = 0;
+		while ( width < 32 && (static_cast<uint64_t>(bits) >> width) )
+			++width;
+
+		out.push_back(static_cast<char>(width));
+
+		uint64_t acc = 0;
+		int filled = 0;
+		for ( size_t j = 0; j < m; ++j ) {
+			acc |= static_cast<uint64_t>(values[j]) << filled;
+			filled += width;
+			while ( filled >= 8 ) {
+				out.push_back(static_cast<char>(acc & 0xff));
+				acc >>= 8;
+				filled -= 8;
+			}
+		}
+
+		if ( filled > 0 )
+			out.push_back(static_cast<char>(acc & 0xff));
+	}
+}
+
+
+/**
+ * @brief Decodes n samples encoded with encodeInt32. The values of a block
+ *        are unpacked with a fixed width without branches before the
+ *        differences are summed up.
+ */
+bool decodeInt32(const char *data, size_t size, size_t n, int32_t *out) {
+	uint8_t block[BlockSize * 4 + 8];
+	uint32_t prev = 0;
+	size_t pos = 0;
+
+	for ( size_t i = 0; i < n; i += BlockSize ) {
+		size_t m = min(BlockSize, n - i);
+		if ( pos >= size ) return false;
+
+		unsigned width = static_cast<uint8_t>(data[pos++]);
+		if ( width > 32 ) return false;
+
+		size_t bytes = (m * width + 7) / 8;
+		if ( pos + bytes > size ) return false;
+
+		memcpy(block, data + pos, bytes);
+		memset(block + bytes, 0, 8);
+		pos += bytes;
+
+		uint64_t mask = (static_cast<uint64_t>(1) << width) - 1;
+		int32_t *values = out + i;
+
+		for ( size_t j = 0; j < m; ++j ) {
+			size_t bit = j * width;
+			const uint8_t *p = block + (bit >> 3);
+			uint64_t v = static_cast<uint64_t>(p[0])
+			           | static_cast<uint64_t>(p[1]) << 8
+			           | static_cast<uint64_t>(p[2]) << 16
+			           | static_cast<uint64_t>(p[3]) << 24
+			           | static_cast<uint64_t>(p[4]) << 32;
+			uint32_t z = static_cast<uint32_t>((v >> (bit & 7)) & mask);
+			values[j] = static_cast<int32_t>((z >> 1) ^ (0u - (z & 1)));
+		}
+
+		for ( size_t j = 0; j < m; ++j ) {
+			prev += static_cast<uint32_t>(values[j]);
+			values[j] = static_cast<int32_t>(prev);
+		}
+	}
+
+	return true;
+}
+
+
+bool readHeader(FILE *fp, const char *magic) {
+	FileHeader header;
+	return fread(&header, sizeof(header), 1, fp) == 1
+	    && !memcmp(header.magic, magic, sizeof(header.magic))
+	    && header.byteOrder == ByteOrder;
+}
+
+
+bool writeHeader(FILE *fp, const char *magic) {
+	FileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(header.magic));
+	header.byteOrder = ByteOrder;
+	return fwrite(&header, sizeof(header), 1, fp) == 1;
+}
+
+
+//! Opens a file for appending and writes the file header if it is empty
+FILE *openAppend(const string &fname, const char *magic) {
+	FILE *fp = fopen(fname.c_str(), "ab");
+	if ( !fp ) return nullptr;
+
+	if ( ftello(fp) == 0 && !writeHeader(fp, magic) ) {
+		fclose(fp);
+		return nullptr;
+	}
+
+	return fp;
+}
+
+
+}
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+struct ChunkArchiveWriter::Stream {
+	string          net;
+	string          sta;
+	string          loc;
+	string          cha;
+	int64_t         startTime{0};
+	double          samplingFrequency{0};
+	bool            integer{true};
+	vector<int32_t> ints;
+	vector<double>  doubles;
+
+	size_t size() const { return integer ? ints.size() : doubles.size(); }
+};
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ChunkArchiveWriter::ChunkArchiveWriter(const string &root, size_t chunkSize)
+: _root(root), _chunkSize(max(chunkSize, BlockSize)) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ChunkArchiveWriter::~ChunkArchiveWriter() {
+	flush();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchiveWriter::write(const Record *rec) {
+	const Array *data = rec ? rec->data() : nullptr;
+	if ( !data || rec->samplingFrequency() <= 0 ) return false;
+
+	bool integer = data->dataType() == Array::INT;
+	unique_ptr<Stream> &ptr = _streams[rec->streamID()];
+	if ( !ptr ) {
+		ptr.reset(new Stream);
+		ptr->net = rec->networkCode();
+		ptr->sta = rec->stationCode();
+		ptr->loc = rec->locationCode();
+		ptr->cha = rec->channelCode();
+	}
+
+	Stream &stream = *ptr;
+	int64_t startTime = toMicroseconds(rec->startTime());
+	double fsamp = rec->samplingFrequency();
+	bool ok = true;
+
+	// Start a new chunk if the record does not continue the buffered
+	// samples
+	if ( stream.size() ) {
+		int64_t expected = sampleTime(stream.startTime, stream.samplingFrequency, stream.size());
+		if ( stream.samplingFrequency != fsamp || stream.integer != integer
+		  || fabs(static_cast<double>(startTime - expected)) > 0.5 * Microseconds / fsamp )
+			ok = writeChunk(stream, stream.size());
+	}
+
+	if ( !stream.size() ) {
+		stream.startTime = startTime;
+		stream.samplingFrequency = fsamp;
+		stream.integer = integer;
+	}
+
+	if ( integer ) {
+		const IntArray *ints = static_cast<const IntArray*>(data);
+		stream.ints.insert(stream.ints.end(), ints->typedData(),
+		                   ints->typedData() + ints->size());
+	}
+	else {
+		DoubleArrayPtr doubles = static_cast<DoubleArray*>(data->copy(Array::DOUBLE));
+		stream.doubles.insert(stream.doubles.end(), doubles->typedData(),
+		                      doubles->typedData() + doubles->size());
+	}
+
+	// Write complete chunks, chunks do not cross day boundaries
+	while ( ok && stream.size() ) {
+		int64_t dayEnd = (dayOf(stream.startTime) + 1) * MicrosecondsPerDay;
+		size_t toDayEnd = static_cast<size_t>(ceil((dayEnd - stream.startTime) * stream.samplingFrequency / Microseconds));
+		size_t count = min(_chunkSize, toDayEnd);
+		if ( stream.size() < count ) break;
+		ok = writeChunk(stream, count);
+	}
+
+	return ok;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchiveWriter::flush() {
+	bool ok = true;
+
+	for ( auto &item : _streams ) {
+		Stream &stream = *item.second;
+		while ( stream.size() ) {
+			int64_t dayEnd = (dayOf(stream.startTime) + 1) * MicrosecondsPerDay;
+			size_t toDayEnd = static_cast<size_t>(ceil((dayEnd - stream.startTime) * stream.samplingFrequency / Microseconds));
+			if ( !writeChunk(stream, min(stream.size(), toDayEnd)) ) {
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	return ok;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchiveWriter::writeChunk(Stream &stream, size_t count) {
+	count = min(count, stream.size());
+
+	string payload;
+	ChunkHeader header;
+	memcpy(header.magic, ChunkMagic, sizeof(header.magic));
+	header.count = static_cast<uint32_t>(count);
+	header.startTime = stream.startTime;
+	header.samplingFrequency = stream.samplingFrequency;
+
+	if ( stream.integer ) {
+		header.encoding = Int32DeltaBitPack;
+		encodeInt32(stream.ints.data(), count, payload);
+	}
+	else {
+		header.encoding = Float64;
+		payload.assign(reinterpret_cast<const char*>(stream.doubles.data()),
+		               count * sizeof(double));
+	}
+
+	header.size = static_cast<uint32_t>(payload.size());
+
+	string fname = dayFile(_root, stream.net, stream.sta, stream.loc,
+	                       stream.cha, dayOf(stream.startTime));
+	string path = fname.substr(0, fname.rfind('/'));
+	if ( !Util::pathExists(path) && !Util::createPath(path) ) {
+		SEISCOMP_ERROR("%s: cannot create directory", path.c_str());
+		return false;
+	}
+
+	FILE *fp = openAppend(fname, FileMagic);
+	if ( !fp ) {
+		SEISCOMP_ERROR("%s: %s", fname.c_str(), strerror(errno));
+		return false;
+	}
+
+	IndexEntry entry;
+	entry.startTime = stream.startTime;
+	entry.endTime = sampleTime(stream.startTime, stream.samplingFrequency, count);
+	entry.offset = static_cast<uint64_t>(ftello(fp));
+	entry.size = header.size;
+	entry.count = header.count;
+
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+	       && fwrite(payload.data(), 1, payload.size(), fp) == payload.size();
+	ok = (fclose(fp) == 0) && ok;
+	if ( !ok ) {
+		SEISCOMP_ERROR("%s: write error", fname.c_str());
+		return false;
+	}
+
+	// A missing index entry is recovered by the reader from the chunk
+	// headers
+	fp = openAppend(sidecar(fname), IndexMagic);
+	if ( fp ) {
+		if ( fwrite(&entry, sizeof(entry), 1, fp) != 1 )
+			SEISCOMP_WARNING("%s: cannot write index", fname.c_str());
+		fclose(fp);
+	}
+
+	if ( stream.integer )
+		stream.ints.erase(stream.ints.begin(), stream.ints.begin() + count);
+	else
+		stream.doubles.erase(stream.doubles.begin(), stream.doubles.begin() + count);
+
+	stream.startTime = entry.endTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ChunkArchive::ChunkArchive() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ChunkArchive::~ChunkArchive() {
+	if ( _fp ) fclose(_fp);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchive::setSource(const string &source) {
+	_root = source.empty()
+	      ? Environment::Instance()->installDir() + "/var/lib/chunkarchive"
+	      : Environment::Instance()->absolutePath(source);
+	_closeRequested = false;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchive::addStream(const string &net, const string &sta,
+                             const string &loc, const string &cha) {
+	return addStream(net, sta, loc, cha, Time(), Time());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchive::addStream(const string &net, const string &sta,
+                             const string &loc, const string &cha,
+                             const Time &stime, const Time &etime) {
+	if ( net.find_first_of("*?") != string::npos
+	  || sta.find_first_of("*?") != string::npos
+	  || loc.find_first_of("*?") != string::npos
+	  || cha.find_first_of("*?") != string::npos ) {
+		SEISCOMP_ERROR("Wildcards are not supported: %s.%s.%s.%s",
+		               net.c_str(), sta.c_str(), loc.c_str(), cha.c_str());
+		return false;
+	}
+
+	Request request;
+	request.net = net;
+	request.sta = sta;
+	request.loc = loc;
+	request.cha = cha;
+	request.stime = stime;
+	request.etime = etime;
+	_requests.push_back(request);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchive::setStartTime(const Time &stime) {
+	_stime = stime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchive::setEndTime(const Time &etime) {
+	_etime = etime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ChunkArchive::close() {
+	lock_guard<mutex> l(_mutex);
+	_closeRequested = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *ChunkArchive::next() {
+	lock_guard<mutex> l(_mutex);
+
+	while ( !_closeRequested ) {
+		while ( _chunk < _chunks.size() ) {
+			Record *rec = readChunk(_chunks[_chunk++]);
+			if ( rec ) return rec;
+		}
+
+		if ( !openNextFile() )
+			break;
+	}
+
+	if ( _fp ) {
+		fclose(_fp);
+		_fp = nullptr;
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ChunkArchive::openNextFile() {
+	if ( _fp ) {
+		fclose(_fp);
+		_fp = nullptr;
+	}
+
+	_chunks.clear();
+	_chunk = 0;
+
+	while ( _request < _requests.size() ) {
+		const Request &req = _requests[_request];
+		Time stime = req.stime.valid() ? req.stime : _stime;
+		Time etime = req.etime.valid() ? req.etime : _etime;
+		if ( !etime.valid() ) etime = Time::GMT();
+
+		if ( !stime.valid() ) {
+			SEISCOMP_ERROR("%s.%s.%s.%s: no start time given",
+			               req.net.c_str(), req.sta.c_str(),
+			               req.loc.c_str(), req.cha.c_str());
+			++_request;
+			continue;
+		}
+
+		int64_t start = toMicroseconds(stime);
+		int64_t end = toMicroseconds(etime);
+
+		if ( !_started ) {
+			_day = dayOf(start);
+			_started = true;
+		}
+		else
+			++_day;
+
+		if ( _day > dayOf(end) ) {
+			++_request;
+			_started = false;
+			continue;
+		}
+
+		_fname = dayFile(_root, req.net, req.sta, req.loc, req.cha, _day);
+		_fp = fopen(_fname.c_str(), "rb");
+		if ( !_fp ) continue;
+
+		if ( !readHeader(_fp, FileMagic) ) {
+			SEISCOMP_WARNING("%s: invalid file header", _fname.c_str());
+			fclose(_fp);
+			_fp = nullptr;
+			continue;
+		}
+
+		fseeko(_fp, 0, SEEK_END);
+		uint64_t fileSize = static_cast<uint64_t>(ftello(_fp));
+		uint64_t covered = sizeof(FileHeader);
+
+		vector<Chunk> chunks;
+		FILE *idx = fopen(sidecar(_fname).c_str(), "rb");
+		if ( idx ) {
+			if ( readHeader(idx, IndexMagic) ) {
+				IndexEntry entry;
+				while ( fread(&entry, sizeof(entry), 1, idx) == 1 ) {
+					if ( entry.offset != covered ) break;
+					chunks.push_back({entry.startTime, entry.endTime,
+					                  entry.offset, entry.size, entry.count});
+					covered = entry.offset + sizeof(ChunkHeader) + entry.size;
+				}
+			}
+
+			fclose(idx);
+		}
+
+		// Recover chunks which are not indexed from their headers
+		while ( covered + sizeof(ChunkHeader) <= fileSize ) {
+			ChunkHeader header;
+			if ( fseeko(_fp, covered, SEEK_SET) != 0
+			  || fread(&header, sizeof(header), 1, _fp) != 1
+			  || memcmp(header.magic, ChunkMagic, sizeof(header.magic))
+			  || header.samplingFrequency <= 0
+			  || covered + sizeof(ChunkHeader) + header.size > fileSize )
+				break;
+
+			chunks.push_back({header.startTime,
+			                  sampleTime(header.startTime, header.samplingFrequency, header.count),
+			                  covered, header.size, header.count});
+			covered += sizeof(ChunkHeader) + header.size;
+		}
+
+		bool sorted = is_sorted(chunks.begin(), chunks.end(),
+		                        [](const Chunk &a, const Chunk &b) {
+		                            return a.endTime < b.endTime;
+		                        });
+
+		auto it = chunks.begin();
+		if ( sorted )
+			it = partition_point(chunks.begin(), chunks.end(),
+			                     [start](const Chunk &c) { return c.endTime <= start; });
+
+		for ( ; it != chunks.end(); ++it ) {
+			if ( it->startTime > end ) {
+				if ( sorted ) break;
+				continue;
+			}
+
+			if ( it->endTime > start )
+				_chunks.push_back(*it);
+		}
+
+		if ( !_chunks.empty() )
+			return true;
+
+		fclose(_fp);
+		_fp = nullptr;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *ChunkArchive::readChunk(const Chunk &chunk) {
+	const Request &req = _requests[_request];
+	Time stime = req.stime.valid() ? req.stime : _stime;
+	Time etime = req.etime.valid() ? req.etime : _etime;
+
+	ChunkHeader header;
+	if ( fseeko(_fp, chunk.offset, SEEK_SET) != 0
+	  || fread(&header, sizeof(header), 1, _fp) != 1
+	  || memcmp(header.magic, ChunkMagic, sizeof(header.magic))
+	  || header.size != chunk.size || header.count != chunk.count ) {
+		SEISCOMP_WARNING("%s: invalid chunk at %llu", _fname.c_str(),
+		                 static_cast<unsigned long long>(chunk.offset));
+		return nullptr;
+	}
+
+	// The samples within the time window are computed from the sampling
+	// frequency
+	double fsamp = header.samplingFrequency;
+	size_t first = 0, last = header.count;
+	if ( stime.valid() ) {
+		double offset = static_cast<double>(toMicroseconds(stime) - header.startTime) * fsamp / Microseconds;
+		if ( offset > 0 )
+			first = min(last, static_cast<size_t>(ceil(offset)));
+	}
+
+	if ( etime.valid() ) {
+		double offset = static_cast<double>(toMicroseconds(etime) - header.startTime) * fsamp / Microseconds;
+		last = offset < 0 ? 0 : min(last, static_cast<size_t>(floor(offset)) + 1);
+	}
+
+	if ( first >= last )
+		return nullptr;
+
+	string payload(header.size, '\0');
+	if ( header.size && fread(&payload[0], 1, payload.size(), _fp) != payload.size() ) {
+		SEISCOMP_WARNING("%s: truncated chunk", _fname.c_str());
+		return nullptr;
+	}
+
+	GenericRecord *rec = new GenericRecord(req.net, req.sta, req.loc, req.cha,
+	                                       fromMicroseconds(sampleTime(header.startTime, fsamp, first)),
+	                                       fsamp, -1, _dataType, _hint);
+
+	if ( header.encoding == Int32DeltaBitPack ) {
+		vector<int32_t> samples(header.count);
+		if ( !decodeInt32(payload.data(), payload.size(), samples.size(), samples.data()) ) {
+			SEISCOMP_WARNING("%s: corrupt chunk", _fname.c_str());
+			delete rec;
+			return nullptr;
+		}
+
+		rec->setData(static_cast<int>(last - first), samples.data() + first, Array::INT);
+	}
+	else if ( header.encoding == Float64 && payload.size() == header.count * sizeof(double) ) {
+		rec->setData(static_cast<int>(last - first),
+		             reinterpret_cast<const double*>(payload.data()) + first,
+		             Array::DOUBLE);
+	}
+	else {
+		SEISCOMP_WARNING("%s: unsupported chunk encoding %u", _fname.c_str(),
+		                 header.encoding);
+		delete rec;
+		return nullptr;
+	}
+
+	return rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
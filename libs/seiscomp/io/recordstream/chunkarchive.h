@@ -0,0 +1,189 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDSTREAM_CHUNKARCHIVE_H
+#define SEISCOMP_IO_RECORDSTREAM_CHUNKARCHIVE_H
+
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <seiscomp/core/record.h>
+#include <seiscomp/io/recordstream.h>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+/**
+ * @brief The chunk archive stores the samples of each stream in compressed
+ *        chunks instead of miniSEED records.
+ *
+ * The day files are organized like an SDS archive:
+ * ROOT/YEAR/NET/STA/CHA.C/NET.STA.LOC.CHA.C.YEAR.DOY
+ *
+ * Each chunk holds up to a configurable number of contiguous samples of a
+ * single day with one header. Integer samples are delta encoded and bit
+ * packed in blocks of 128 samples with the bit width of each block.
+ * Floating point samples are stored as they are. A sidecar index
+ * (.[filename].idx) holds the time span and file offset of each chunk.
+ * A reader finds the first chunk of a time window with a binary search in
+ * the index and the first sample within the chunk directly from the
+ * sampling rate, without decoding anything in front of it.
+ */
+class ChunkArchiveWriter {
+	// ----------------------------------------------------------------------
+	//  Xstruction
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Creates a writer.
+		 * @param root The archive root directory
+		 * @param chunkSize The maximum number of samples per chunk
+		 */
+		explicit ChunkArchiveWriter(const std::string &root,
+		                            size_t chunkSize = 4096);
+		~ChunkArchiveWriter();
+
+
+	// ----------------------------------------------------------------------
+	//  Public Interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Adds the samples of a record. The samples are buffered
+		 *        per stream until a chunk is complete, the record does not
+		 *        continue the buffered samples or a day ends.
+		 * @return false if the record has no data or a chunk could not
+		 *         be written
+		 */
+		bool write(const Record *rec);
+
+		//! Writes the buffered samples of all streams
+		bool flush();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Stream;
+
+		bool writeChunk(Stream &stream, size_t count);
+
+		std::string                                     _root;
+		size_t                                          _chunkSize;
+		std::map<std::string, std::unique_ptr<Stream>>  _streams;
+};
+
+
+/**
+ * @brief The ChunkArchive class reads records from a chunk archive, see
+ *        ChunkArchiveWriter.
+ *
+ * The source is the archive root. Each chunk is returned as one
+ * GenericRecord which is cut to the requested time window. Wildcards are
+ * not supported.
+ */
+class ChunkArchive : public Seiscomp::IO::RecordStream {
+	// ----------------------------------------------------------------------
+	//  Xstruction
+	// ----------------------------------------------------------------------
+	public:
+		ChunkArchive();
+		~ChunkArchive() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public Interface
+	// ----------------------------------------------------------------------
+	public:
+		bool setSource(const std::string &source) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const Seiscomp::Core::Time &startTime,
+		               const Seiscomp::Core::Time &endTime) override;
+
+		bool setStartTime(const Seiscomp::Core::Time &stime) override;
+		bool setEndTime(const Seiscomp::Core::Time &etime) override;
+
+		void close() override;
+
+		Seiscomp::Record *next() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		struct Request {
+			std::string          net;
+			std::string          sta;
+			std::string          loc;
+			std::string          cha;
+			Seiscomp::Core::Time stime;
+			Seiscomp::Core::Time etime;
+		};
+
+		struct Chunk {
+			int64_t  startTime;
+			int64_t  endTime;
+			uint64_t offset;
+			uint32_t size;
+			uint32_t count;
+		};
+
+		bool openNextFile();
+		Seiscomp::Record *readChunk(const Chunk &chunk);
+
+		std::string           _root;
+		std::vector<Request>  _requests;
+		Seiscomp::Core::Time  _stime;
+		Seiscomp::Core::Time  _etime;
+		size_t                _request{0};
+		int64_t               _day{0};
+		bool                  _started{false};
+		std::string           _fname;
+		FILE                 *_fp{nullptr};
+		std::vector<Chunk>    _chunks;
+		size_t                _chunk{0};
+		std::mutex            _mutex;
+		bool                  _closeRequested{false};
+};
+
+
+}
+}
+
+
+#endif
@@ -27,8 +27,10 @@
 #include <seiscomp/core/datetime.h>
 #include <seiscomp/core/strings.h>
 #include <seiscomp/io/recordinput.h>
+#include <seiscomp/system/threads.h>
 #include <seiscomp/client/queue.ipp>
 
+#include <algorithm>
 #include <cstdio>
 #include <string>
 #include <iostream>
@@ -42,6 +44,21 @@ using namespace Seiscomp::IO;
 
 namespace Seiscomp {
 namespace RecordStream {
+
+
+namespace {
+
+
+//! Orders the heap by end time and arrival, earliest on top.
+template <typename T>
+bool later(const T &a, const T &b) {
+	if ( a.endTime != b.endTime )
+		return a.endTime > b.endTime;
+	return a.sequence > b.sequence;
+}
+
+
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -57,6 +74,7 @@ Concurrent::Concurrent() : _queue(1024) {}
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Concurrent::~Concurrent() {
 	close();
+	clearPending();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -211,8 +229,11 @@ void Concurrent::close() {
 
 	_queue.close();
 
-	for ( size_t i = 0; i < _rsarray.size(); ++i ) {
-		_rsarray[i].first->close();
+	{
+		lock_guard<mutex> proxyLock(_proxyMtx);
+		for ( size_t i = 0; i < _rsarray.size(); ++i ) {
+			_rsarray[i].first->close();
+		}
 	}
 
 	for ( auto &thread : _threads ) {
@@ -234,14 +255,38 @@ void Concurrent::close() {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void Concurrent::acquiThread(RecordStream *rs) {
+void Concurrent::acquiThread(size_t index) {
 	SEISCOMP_DEBUG("Starting acquisition thread");
 
+	RecordStream *rs = _rsarray[index].first.get();
 	Record *rec;
 
 	try {
-		while ( (rec = rs->next()) ) {
-			_queue.push(rec);
+		while ( rs ) {
+			while ( (rec = rs->next()) ) {
+				if ( !acquired(index, rec) ) {
+					delete rec;
+					continue;
+				}
+
+				if ( !_queue.push({rec, index}) ) {
+					delete rec;
+					break;
+				}
+			}
+
+			if ( _queue.isClosed() )
+				break;
+
+			RecordStreamPtr proxy = nextProxy(index);
+
+			lock_guard<mutex> proxyLock(_proxyMtx);
+			// Do not start another request once the connection is closed
+			if ( !proxy || _queue.isClosed() )
+				break;
+
+			_rsarray[index].first = proxy;
+			rs = proxy.get();
 		}
 	}
 	catch ( OperationInterrupted &e ) {
@@ -253,7 +298,7 @@ void Concurrent::acquiThread(RecordStream *rs) {
 
 	SEISCOMP_DEBUG("Finished acquisition thread");
 
-	_queue.push(nullptr);
+	_queue.push({nullptr, index});
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -267,18 +312,24 @@ Record *Concurrent::next() {
 
 		if ( !_started ) {
 			_started = true;
+			clearPending();
+			_watermarks.clear();
+			_newest = Core::Time();
+			_sequence = 0;
 
 			for ( size_t i = 0; i < _rsarray.size(); ++i) {
 				if ( _rsarray[i].second && !_queue.isClosed() ) {
 					++_nthreads;
+					_watermarks[i] = Core::Time();
 					_rsarray[i].first->setDataType(_dataType);
 					_rsarray[i].first->setDataHint(_hint);
 					_threads.push_back(
-						thread(
+						System::startThread(
+							"acquisition",
 							bind(
 								&Concurrent::acquiThread,
 								this,
-								_rsarray[i].first.get()
+								i
 							)
 						)
 					);
@@ -291,28 +342,33 @@ Record *Concurrent::next() {
 		}
 	}
 
+	if ( _lateness > Core::TimeSpan(0,0) )
+		return nextMerged();
+
 	try {
 		while ( true ) {
-			Record * rec =  _queue.pop();
-			if ( rec) {
+			// Take all queued records at once to reduce the contention
+			// with the acquisition threads
+			if ( _nextPending >= _pending.size() ) {
+				_pending.clear();
+				_nextPending = 0;
+				_queue.popAll(_pending);
+			}
+
+			Record *rec = _pending[_nextPending++].record;
+			if ( rec ) {
 				return rec;
 			}
-			else {
-				// Null record received ... a thread finished
-				lock_guard<mutex> lock(_mtx);
-				if ( --_nthreads ) {
-					// Still threads running ... keep on reading the queue
-					continue;
-				}
 
-				SEISCOMP_DEBUG("Last acquisition thread terminated");
+			// Null record received ... a thread finished
+			if ( !finished() )
 				break;
-			}
 		}
 
-		if ( _queue.size() > 0 ) {
+		size_t remaining = _queue.size() + _pending.size() - _nextPending;
+		if ( remaining > 0 ) {
 			SEISCOMP_ERROR("Finished acquisition, but data queue not empty "
-			               "(%zu items still)", _queue.size());
+			               "(%zu items still)", remaining);
 		}
 
 		SEISCOMP_DEBUG("Closing record queue");
@@ -331,8 +387,178 @@ Record *Concurrent::next() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *Concurrent::nextMerged() {
+	try {
+		while ( true ) {
+			if ( !_heap.empty() && isDue(_heap.front()) ) {
+				pop_heap(_heap.begin(), _heap.end(), later<HeapItem>);
+				Record *rec = _heap.back().record;
+				_heap.pop_back();
+				return rec;
+			}
+
+			// All threads finished and all records returned
+			if ( _watermarks.empty() )
+				break;
+
+			_pending.clear();
+			_nextPending = 0;
+			_queue.popAll(_pending);
+
+			for ( ; _nextPending < _pending.size(); ++_nextPending ) {
+				const Item &item = _pending[_nextPending];
+
+				if ( !item.record ) {
+					_watermarks.erase(item.source);
+					finished();
+					continue;
+				}
+
+				Core::Time endTime;
+				try {
+					endTime = item.record->endTime();
+				}
+				catch ( Core::ValueException & ) {
+					// Invalid sampling rate
+					endTime = item.record->startTime();
+				}
+
+				Core::Time &watermark = _watermarks[item.source];
+				if ( !watermark.valid() || watermark < endTime )
+					watermark = endTime;
+				if ( !_newest.valid() || _newest < endTime )
+					_newest = endTime;
+
+				_heap.push_back({endTime, _sequence++, item.record});
+				push_heap(_heap.begin(), _heap.end(), later<HeapItem>);
+			}
+		}
+
+		SEISCOMP_DEBUG("Closing record queue");
+		_queue.close();
+	}
+	catch ( Client::QueueClosedException & ) {
+		SEISCOMP_DEBUG("Queue closed, break streaming");
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Concurrent::isDue(const HeapItem &item) const {
+	// No more records to wait for
+	if ( _watermarks.empty() )
+		return true;
+
+	// Waited long enough for stalled streams
+	if ( _newest - item.endTime > _lateness )
+		return true;
+
+	// Every running stream has passed the record
+	for ( const auto &watermark : _watermarks ) {
+		if ( !watermark.second.valid() || watermark.second < item.endTime )
+			return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Concurrent::finished() {
+	lock_guard<mutex> lock(_mtx);
+	if ( --_nthreads ) {
+		// Still threads running ... keep on reading the queue
+		return true;
+	}
+
+	SEISCOMP_DEBUG("Last acquisition thread terminated");
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Concurrent::setMergeLateness(const Core::TimeSpan &lateness) {
+	lock_guard<mutex> lock(_mtx);
+
+	if ( _started || lateness < Core::TimeSpan(0,0) )
+		return false;
+
+	_lateness = lateness;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Core::TimeSpan &Concurrent::mergeLateness() const {
+	return _lateness;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Concurrent::extractMergeOption(string &source) {
+	_lateness = Core::TimeSpan(0,0);
+
+	size_t pos = source.rfind("??merge=");
+	// Not present or an option of a parenthesized proxy stream
+	if ( pos == string::npos || source.find(')', pos) != string::npos )
+		return true;
+
+	string value = source.substr(pos+8);
+	double seconds;
+	if ( !Core::fromString(seconds, value) || seconds < 0 ) {
+		SEISCOMP_ERROR("Invalid merge lateness: %s", value.c_str());
+		return false;
+	}
+
+	_lateness = Core::TimeSpan(seconds);
+	source.erase(pos);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Concurrent::acquired(size_t, const Record *) {
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordStreamPtr Concurrent::nextProxy(size_t) {
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Concurrent::reset() {
+	// Release the records left in the queue before it forgets them
+	clearPending();
 	_queue.reset();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -340,6 +566,27 @@ void Concurrent::reset() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Concurrent::clearPending() {
+	_pending.erase(_pending.begin(), _pending.begin() + _nextPending);
+	_queue.drain(_pending);
+
+	for ( const Item &item : _pending ) {
+		if ( item.record ) delete item.record;
+	}
+
+	for ( const HeapItem &item : _heap )
+		delete item.record;
+
+	_pending.clear();
+	_nextPending = 0;
+	_heap.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 } // namespace RecordStream
 } // namespace Seiscomp
@@ -28,11 +28,26 @@
 #include <seiscomp/core.h>
 #include <seiscomp/client/queue.h>
 
+#include <map>
+
 
 namespace Seiscomp {
 namespace RecordStream {
 
 
+/**
+ * @brief The Concurrent class reads a set of proxy streams in parallel,
+ *        one acquisition thread per stream.
+ *
+ * By default records are returned in the order they arrive from the
+ * threads. With a merge lateness set, records are reordered by end time
+ * across the proxy streams: a record is held back until every running
+ * proxy stream has delivered a record ending at the same time or later,
+ * or until a record has been received which ends more than the lateness
+ * after it. A proxy stream which stalls therefore delays the others by at
+ * most the lateness in data time. Records arriving after that are
+ * returned immediately.
+ */
 class SC_SYSTEM_CORE_API Concurrent : public IO::RecordStream {
 	// ----------------------------------------------------------------------
 	//  X'truction
@@ -83,6 +98,25 @@ class SC_SYSTEM_CORE_API Concurrent : public IO::RecordStream {
 		Record *next() override;
 
 
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Enables the time-ordered merge of the proxy streams.
+		 *        This must be called before the first call to next().
+		 * @param lateness The maximum time span of data a record is held
+		 *                 back to wait for records of other proxy
+		 *                 streams. A zero time span disables the merge.
+		 * @return false if the stream has already been started or the
+		 *         lateness is negative.
+		 */
+		bool setMergeLateness(const Core::TimeSpan &lateness);
+
+		//! Returns the merge lateness, zero if records are not merged.
+		const Core::TimeSpan &mergeLateness() const;
+
+
 	// ----------------------------------------------------------------------
 	//  Concurrent interface
 	// ----------------------------------------------------------------------
@@ -92,14 +126,63 @@ class SC_SYSTEM_CORE_API Concurrent : public IO::RecordStream {
 		                      const std::string &locationCode,
 		                      const std::string &channelCode) = 0;
 
+		/**
+		 * @brief Called from the acquisition thread of a proxy stream for
+		 *        each record before it is queued.
+		 * @param index The index of the proxy stream in _rsarray
+		 * @param rec The acquired record
+		 * @return false to drop the record. The default implementation
+		 *         returns true.
+		 */
+		virtual bool acquired(size_t index, const Record *rec);
+
+		/**
+		 * @brief Called from the acquisition thread of a proxy stream when
+		 *        it has delivered all records. Implementations can return
+		 *        a new proxy stream which replaces the finished one in
+		 *        _rsarray, e.g. to request further streams from the same
+		 *        source. The default implementation returns null.
+		 * @param index The index of the proxy stream in _rsarray
+		 * @return The proxy stream to continue with or null to finish the
+		 *         acquisition thread
+		 */
+		virtual IO::RecordStreamPtr nextProxy(size_t index);
+
 		void reset();
 
+		/**
+		 * @brief Removes the option "??merge=seconds" from the end of a
+		 *        source and sets the merge lateness accordingly. Options
+		 *        of parenthesized proxy streams are not touched.
+		 * @return false if the option value is invalid.
+		 */
+		bool extractMergeOption(std::string &source);
+
 
 	// ----------------------------------------------------------------------
 	//  Private methods and members
 	// ----------------------------------------------------------------------
 	private:
-		void acquiThread(IO::RecordStream *rs);
+		//! A queued record together with the index of its proxy stream.
+		//! A null record signals that the acquisition thread has finished.
+		struct Item {
+			Record *record{nullptr};
+			size_t  source{0};
+		};
+
+		struct HeapItem {
+			Core::Time endTime;
+			uint64_t   sequence;
+			Record    *record;
+		};
+
+		void acquiThread(size_t index);
+		void clearPending();
+		//! Handles a finished acquisition thread and returns false if it
+		//! was the last one.
+		bool finished();
+		Record *nextMerged();
+		bool isDue(const HeapItem &item) const;
 
 	protected:
 		using RecordStreamItem = std::pair<IO::RecordStreamPtr, bool>;
@@ -110,8 +193,21 @@ class SC_SYSTEM_CORE_API Concurrent : public IO::RecordStream {
 	private:
 		int                            _nthreads{0};
 		std::list<std::thread>         _threads;
-		Client::ThreadedQueue<Record*> _queue;
+		Client::ThreadedQueue<Item>    _queue;
+		std::vector<Item>              _pending;
+		size_t                         _nextPending{0};
 		std::mutex                     _mtx;
+		//! Serializes replacing proxy streams with closing them
+		std::mutex                     _proxyMtx;
+
+		// Merge state, only accessed by the consumer
+		Core::TimeSpan                 _lateness;
+		std::vector<HeapItem>          _heap;
+		uint64_t                       _sequence{0};
+		//! The end time of the latest record per running proxy stream.
+		//! An entry is removed when its thread finishes.
+		std::map<size_t, Core::Time>   _watermarks;
+		Core::Time                     _newest;
 };
 
 
@@ -27,7 +27,6 @@
 #include <string.h>
 
 #include "decimation.h"
-#include "remez/remez.h"
 
 
 using namespace std;
@@ -316,13 +315,6 @@ void Decimation::cleanup() {
 		_streams.clear();
 	}
 
-	{
-		CoefficientMap::iterator it;
-		for ( it = _coefficients.begin(); it != _coefficients.end(); ++it )
-			delete it->second;
-		_coefficients.clear();
-	}
-
 	_source = nullptr;
 
 	if ( _nextRecord != nullptr ) delete _nextRecord;
@@ -390,81 +382,50 @@ int Decimation::checkSR(Record *rec) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Decimation::initCoefficients(ResampleStage *stage) {
-	CoefficientMap::iterator it = _coefficients.find(stage->N);
-	if ( it != _coefficients.end() ) {
-		if ( it->second == nullptr )
-			// Invalid coefficients for that stage?
-			return false;
-
-		stage->coefficients = it->second;
-	}
-	else {
-		stage->coefficients = nullptr;
-
-		if ( stage->N > _maxN ) {
-			for ( int i = _maxN; i > 1; --i ) {
-				if ( stage->N % i == 0 ) {
-					int nextStageN = stage->N / i;
-
-					if ( nextStageN > _maxN ) {
-						SEISCOMP_WARNING("[dec] max decimations exceeded: %d > %d",
-						                 nextStageN, _maxN);
-						return false;
-					}
-
-					SEISCOMP_DEBUG("[dec] clipping N=%d to %d and create sub stage",
-					               stage->N, i);
-
-					stage->N = i;
-					stage->targetRate = stage->sampleRate / stage->N;
-
-					ResampleStage *nextStage = new ResampleStage;
-					nextStage->sampleRate = stage->targetRate;
-					nextStage->targetRate = _targetRate;
-					nextStage->N = nextStageN;
-					if ( !initCoefficients(nextStage) ) {
-						delete nextStage;
-						return false;
-					}
-
-					stage->nextStage = nextStage;
-
-					break;
+	if ( stage->N > _maxN ) {
+		for ( int i = _maxN; i > 1; --i ) {
+			if ( stage->N % i == 0 ) {
+				int nextStageN = stage->N / i;
+
+				if ( nextStageN > _maxN ) {
+					SEISCOMP_WARNING("[dec] max decimations exceeded: %d > %d",
+					                 nextStageN, _maxN);
+					return false;
 				}
-			}
 
-			CoefficientMap::iterator it = _coefficients.find(stage->N);
-			if ( it != _coefficients.end() )
-				stage->coefficients = it->second;
-		}
+				SEISCOMP_DEBUG("[dec] clipping N=%d to %d and create sub stage",
+				               stage->N, i);
 
-		if ( stage->coefficients == nullptr ) {
-			// Create and cache coefficients for N
-			int Ncoeff = stage->N*_coeffScale*2+1;
+				stage->N = i;
+				stage->targetRate = stage->sampleRate / stage->N;
 
-			Coefficients *coeff = new Coefficients(Ncoeff);
+				ResampleStage *nextStage = new ResampleStage;
+				nextStage->sampleRate = stage->targetRate;
+				nextStage->targetRate = _targetRate;
+				nextStage->N = nextStageN;
+				if ( !initCoefficients(nextStage) ) {
+					delete nextStage;
+					return false;
+				}
 
-			double bands[4] = {0,0.5*(_fp/stage->N),0.5*(_fs/stage->N),0.5};
-			double weights[2] = {1,1};
-			double desired[2] = {1,0};
+				stage->nextStage = nextStage;
 
-			if ( remez(&((*coeff)[0]), Ncoeff, 2, bands, desired, weights, BANDPASS) ) {
-				SEISCOMP_WARNING("[dec] failed to build coefficients for N=%d, ignore stream", stage->N);
-				delete coeff;
-				_coefficients[stage->N] = nullptr;
-				return false;
+				break;
 			}
-
-			SEISCOMP_DEBUG("[dec] caching %d coefficents for N=%d", Ncoeff, stage->N);
-
-			_coefficients[stage->N] = coeff;
-			stage->coefficients = coeff;
 		}
 	}
 
+	// The designs are shared with all other decimation streams and
+	// resamplers
+	stage->coefficients = IO::ResampleDesigns::Lowpass(stage->N, _fp, _fs, _coeffScale);
+	if ( !stage->coefficients ) {
+		SEISCOMP_WARNING("[dec] no coefficients for N=%d, ignore stream", stage->N);
+		return false;
+	}
+
 	stage->dt = 1.0 / stage->sampleRate;
 	stage->N2 = stage->coefficients->size() / 2;
-	stage->buffer.resize(stage->coefficients->size());
+	stage->buffer.resize(stage->coefficients->size()*2);
 	stage->reset();
 	stage->valid = true;
 
@@ -502,7 +463,7 @@ bool Decimation::push(Record *rec) {
 		_nextRecord = nullptr;
 	}
 
-	string id = rec->streamID();
+	StreamKey id = rec->streamKey();
 	ResampleStage *stage;
 	StreamMap::iterator it = _streams.find(id);
 
@@ -609,10 +570,13 @@ GenericRecord *Decimation::resample(ResampleStage *stage, Record *rec) {
 	size_t data_len = (size_t)ar->size();
 	const double *data = ar->typedData();
 	double *buffer = &stage->buffer[0];
+	size_t length = stage->buffer.size() / 2;
 
 	if ( stage->missingSamples > 0 ) {
 		size_t toCopy = std::min(stage->missingSamples, data_len);
-		memcpy(buffer + stage->buffer.size() - stage->missingSamples,
+		memcpy(buffer + length - stage->missingSamples,
+		       data, toCopy*sizeof(double));
+		memcpy(buffer + 2*length - stage->missingSamples,
 		       data, toCopy*sizeof(double));
 		data += toCopy;
 		data_len -= toCopy;
@@ -635,13 +599,9 @@ GenericRecord *Decimation::resample(ResampleStage *stage, Record *rec) {
 	do {
 		if ( stage->samplesToSkip == 0 ) {
 			// Calculate scalar product of coefficients and ring buffer
-			double *coeff = &((*stage->coefficients)[0]);
-			double sample = 0;
-
-			for ( size_t i = stage->front; i < stage->buffer.size(); ++i )
-				sample += buffer[i] * *(coeff++);
-			for ( size_t i = 0; i < stage->front; ++i )
-				sample += buffer[i] * *(coeff++);
+			double sample = IO::innerProduct(buffer + stage->front,
+			                                 stage->coefficients->data(),
+			                                 length);
 
 			if ( !resampled_data ) {
 				startTime = stage->startTime + Core::TimeSpan(stage->dt*stage->N2);
@@ -656,26 +616,8 @@ GenericRecord *Decimation::resample(ResampleStage *stage, Record *rec) {
 
 		size_t num_samples = std::min(stage->samplesToSkip, data_len);
 
-		size_t chunk_size = std::min(num_samples, stage->buffer.size()-stage->front);
-		memcpy(buffer + stage->front, data, chunk_size*sizeof(double));
-
-		data += chunk_size;
-
-		// Split chunks
-		if ( chunk_size < num_samples ) {
-			chunk_size = num_samples - chunk_size;
-
-			memcpy(buffer, data, chunk_size*sizeof(double));
-
-			stage->front = chunk_size;
-
-			data += chunk_size;
-		}
-		else {
-			stage->front += chunk_size;
-			if ( stage->front >= stage->buffer.size() )
-				stage->front -= stage->buffer.size();
-		}
+		IO::pushRing(buffer, length, stage->front, data, num_samples);
+		data += num_samples;
 
 		stage->startTime += Core::TimeSpan(stage->dt*num_samples);
 		stage->samplesToSkip -= num_samples;
@@ -23,9 +23,11 @@
 
 #include <sstream>
 #include <map>
+#include <unordered_map>
 
 #include <seiscomp/core/genericrecord.h>
 #include <seiscomp/io/recordstream.h>
+#include <seiscomp/io/recordfilter/resampledesigns.h>
 #include <seiscomp/core.h>
 
 namespace Seiscomp {
@@ -88,8 +90,6 @@ class SC_SYSTEM_CORE_API Decimation : public Seiscomp::IO::RecordStream {
 	//  Implementation
 	// ----------------------------------------------------------------------
 	private:
-		typedef std::vector<double> Coefficients;
-
 		struct ResampleStage {
 			ResampleStage() : nextStage(nullptr) {}
 			~ResampleStage() { if ( nextStage ) delete nextStage; }
@@ -111,9 +111,10 @@ class SC_SYSTEM_CORE_API Decimation : public Seiscomp::IO::RecordStream {
 			int N2;
 			size_t samplesToSkip;
 
-			Coefficients *coefficients;
+			IO::ResampleDesigns::CoefficientsCPtr coefficients;
 
 			// The ring buffer that holds the last samples for downsampling.
+			// It is stored twice in a row, see IO::pushRing.
 			std::vector<double> buffer;
 
 			// The number of samples still missing in the buffer before
@@ -132,7 +133,7 @@ class SC_SYSTEM_CORE_API Decimation : public Seiscomp::IO::RecordStream {
 			ResampleStage *nextStage;
 
 			void reset() {
-				missingSamples = buffer.size();
+				missingSamples = buffer.size() / 2;
 				front = 0;
 				samplesToSkip = 0;
 				startTime = Core::Time();
@@ -142,8 +143,7 @@ class SC_SYSTEM_CORE_API Decimation : public Seiscomp::IO::RecordStream {
 			}
 		};
 
-		typedef std::map<int, Coefficients*> CoefficientMap;
-		typedef std::map<std::string, ResampleStage*> StreamMap;
+		typedef std::unordered_map<StreamKey, ResampleStage*> StreamMap;
 
 		void init(ResampleStage *stage, Record *rec);
 		bool initCoefficients(ResampleStage *stage);
@@ -156,7 +156,6 @@ class SC_SYSTEM_CORE_API Decimation : public Seiscomp::IO::RecordStream {
 		int                 _maxN;
 		int                 _coeffScale;
 		StreamMap           _streams;
-		CoefficientMap      _coefficients;
 		GenericRecord      *_nextRecord;
 };
 
@@ -22,10 +22,17 @@
 
 #include <cstdlib>
 #include <string>
+#include <string_view>
 #include <set>
 #include <utility>
 #include <limits>
 #include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <fcntl.h>
 #ifndef WIN32
 #include <unistd.h>
@@ -66,6 +73,49 @@ REGISTER_RECORDSTREAM(FDSNWSSSLConnection, "fdsnwss");
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct FDSNWSConnectionBase::Parallel {
+	struct Request {
+		std::vector<StreamIdx> streams;
+		std::deque<Record*>    records;
+		bool                   done{false};
+	};
+
+	~Parallel() {
+		{
+			lock_guard<mutex> l(mtx);
+			stopped = true;
+			for ( auto conn : connections ) {
+				if ( conn ) conn->_socket->interrupt();
+			}
+			cond.notify_all();
+		}
+
+		for ( auto &thread : threads )
+			thread.join();
+
+		for ( auto &request : requests ) {
+			for ( auto rec : request.records )
+				delete rec;
+		}
+	}
+
+	std::vector<Request>               requests;
+	// The request whose records are returned
+	size_t                             current{0};
+	// The next request to be started
+	size_t                             next{0};
+	bool                               stopped{false};
+	std::vector<FDSNWSConnectionBase*> connections;
+	std::vector<std::thread>           threads;
+	std::mutex                         mtx;
+	std::condition_variable            cond;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 FDSNWSConnectionBase::FDSNWSConnectionBase(const char *protocol, IO::Socket *socket, int defaultPort)
 : _protocol(protocol)
@@ -74,6 +124,13 @@ FDSNWSConnectionBase::FDSNWSConnectionBase(const char *protocol, IO::Socket *soc
 , _readingData(false)
 , _chunkMode(false)
 , _remainingBytes(0)
+, _timeout(-1)
+, _keepAlive(false)
+, _closeConnection(false)
+, _finished(false)
+, _parallelRequests(1)
+, _chunkLength(0)
+, _chunkStreams(0)
 {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -81,8 +138,66 @@ FDSNWSConnectionBase::FDSNWSConnectionBase(const char *protocol, IO::Socket *soc
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool FDSNWSConnectionBase::setSource(const std::string &source) {
-	size_t pos = source.find('/');
+FDSNWSConnectionBase::~FDSNWSConnectionBase() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool FDSNWSConnectionBase::setSource(const std::string &src) {
+	string source = src;
+	size_t pos = source.find('?');
+	if ( pos != string::npos ) {
+		string_view query(source);
+		query.remove_prefix(pos+1);
+
+		size_t parallelRequests = 1, chunkStreams = 0;
+		double chunkLength = 0;
+		bool options = true;
+
+		for ( string_view tok : Core::Tokens(query, "&") ) {
+			size_t sep = tok.find('=');
+			string_view name = tok.substr(0, sep);
+			string_view value = sep != string_view::npos ? tok.substr(sep+1) : string_view();
+			int number;
+
+			if ( name == "parallel" ) {
+				if ( !fromChars(number, value) || number < 1 ) {
+					SEISCOMP_ERROR("fdsnws: invalid parallel value: %s", string(value).c_str());
+					return false;
+				}
+				parallelRequests = number;
+			}
+			else if ( name == "chunk" ) {
+				if ( !fromChars(chunkLength, value) || chunkLength < 0 ) {
+					SEISCOMP_ERROR("fdsnws: invalid chunk value: %s", string(value).c_str());
+					return false;
+				}
+			}
+			else if ( name == "streams" ) {
+				if ( !fromChars(number, value) || number < 0 ) {
+					SEISCOMP_ERROR("fdsnws: invalid streams value: %s", string(value).c_str());
+					return false;
+				}
+				chunkStreams = number;
+			}
+			else {
+				// Not an option, e.g. a query of a redirect location
+				options = false;
+				break;
+			}
+		}
+
+		if ( options ) {
+			_parallelRequests = parallelRequests;
+			_chunkLength = chunkLength;
+			_chunkStreams = chunkStreams;
+			source.erase(pos);
+		}
+	}
+
+	pos = source.find('/');
 	if ( pos != string::npos ) {
 		_url = source.substr(pos);
 		_host = source.substr(0, pos);
@@ -161,6 +276,7 @@ bool FDSNWSConnectionBase::setEndTime(const Seiscomp::Core::Time &etime) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool FDSNWSConnectionBase::setTimeout(int seconds) {
+	_timeout = seconds;
 	_socket->setTimeout(seconds);
 	return true;
 }
@@ -185,6 +301,15 @@ bool FDSNWSConnectionBase::clear() {
 // Hopefully safe to be called from another thread
 void FDSNWSConnectionBase::close() {
 	_socket->interrupt();
+
+	if ( _parallel ) {
+		lock_guard<mutex> l(_parallel->mtx);
+		_parallel->stopped = true;
+		for ( auto conn : _parallel->connections ) {
+			if ( conn ) conn->_socket->interrupt();
+		}
+		_parallel->cond.notify_all();
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -196,7 +321,8 @@ bool FDSNWSConnectionBase::reconnect() {
 	if ( _socket->isOpen() )
 		_socket->close();
 
-	_readingData = false;
+	_parallel.reset();
+	resetResponse();
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -362,7 +488,7 @@ void FDSNWSConnectionBase::openConnection(const std::string &host) {
 				throw GeneralException("server sent invalid response: " + line);
 
 			int code;
-			if ( !fromString(code, line.substr(0, pos)) )
+			if ( !fromChars(code, string_view(line).substr(0, pos)) )
 				throw GeneralException("server sent invalid status code: " + line.substr(0, pos));
 
 			if ( code != 200 )
@@ -434,6 +560,8 @@ void FDSNWSConnectionBase::handshake() {
 	_socket->sendRequest("User-Agent: Mosaic/1.0", false);
 	_socket->sendRequest("Content-Type: text/plain", false);
 	_socket->sendRequest("Content-Length: " + toString(request.size()), false);
+	if ( !_keepAlive )
+		_socket->sendRequest("Connection: close", false);
 	_socket->sendRequest("", false);
 	_socket->write(request);
 
@@ -453,16 +581,15 @@ void FDSNWSConnectionBase::handshake() {
 		throw GeneralException("server sent invalid response: " + line);
 
 	int code;
-	if ( !fromString(code, line.substr(0, pos)) )
+	if ( !fromChars(code, string_view(line).substr(0, pos)) )
 		throw GeneralException("server sent invalid status code: " + line.substr(0, pos));
 
 	if ( code == 200 ) {
 		// Keep on reading body
 	}
 	else if ( code == 204 ) {
-		// No data
-		_remainingBytes = 0;
-		return;
+		// No data, the headers are read to be able to reuse the
+		// connection
 	}
 	else if ( code == 301 or code == 302 ) {
 		// Redirect
@@ -499,7 +626,9 @@ void FDSNWSConnectionBase::handshake() {
 			}
 		}
 		else if ( line.compare(0, 15, "CONTENT-LENGTH:") == 0 ) {
-			if ( !fromString(_remainingBytes, line.substr(15)) )
+			string_view value(line);
+			value.remove_prefix(min(value.find_first_not_of(" \t", 15), value.size()));
+			if ( !fromChars(_remainingBytes, value) )
 				throw GeneralException("invalid Content-Length response");
 			if ( _remainingBytes < 0 )
 				throw GeneralException("Content-Length must be positive");
@@ -508,6 +637,19 @@ void FDSNWSConnectionBase::handshake() {
 			redirectLocation = line.substr(pos+1);
 			trim(redirectLocation);
 		}
+		else if ( line.compare(0, 11, "CONNECTION:") == 0 ) {
+			string value = line.substr(11);
+			trim(value);
+			transform(value.begin(), value.end(), value.begin(), ::tolower);
+			if ( value == "close" )
+				_closeConnection = true;
+		}
+	}
+
+	if ( code == 204 ) {
+		_chunkMode = false;
+		_remainingBytes = 0;
+		return;
 	}
 
 	if ( _chunkMode ) {
@@ -528,6 +670,7 @@ void FDSNWSConnectionBase::handshake() {
 				if ( redirectLocation[0] == '/' ) {
 					redirectLocation = _host + redirectLocation;
 					_socket->close();
+					_closeConnection = false;
 				}
 				else {
 					_error = "Invalid redirect location protocol";
@@ -553,6 +696,9 @@ void FDSNWSConnectionBase::handshake() {
 				}
 
 				redirectLocation.erase(0, pos+3);
+				_closeConnection = false;
+				if ( _timeout >= 0 )
+					_socket->setTimeout(_timeout);
 			}
 
 			setSource(redirectLocation);
@@ -568,26 +714,44 @@ void FDSNWSConnectionBase::handshake() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Record *FDSNWSConnectionBase::next() {
-	if ( _readingData && !_socket->isOpen() )
+	if ( _parallelRequests > 1 )
+		return nextParallel();
+
+	if ( _readingData && (_finished || !_socket->isOpen()) )
 		return nullptr;
 
 	_socket->startTimer();
 
 	if ( !_readingData ) {
-		try {
-			openConnection(_host);
-			handshake();
-		}
-		catch ( const GeneralException &e ) {
-			SEISCOMP_ERROR("fdsnws: %s", e.what());
-			_socket->close();
-			return nullptr;
+		for ( int attempt = 0; ; ++attempt ) {
+			bool reused = _socket->isOpen();
+
+			try {
+				if ( !reused )
+					openConnection(_host);
+				handshake();
+				break;
+			}
+			catch ( const GeneralException &e ) {
+				_socket->close();
+
+				// The server might have closed an idle keep-alive
+				// connection, try once again with a new one
+				if ( reused && attempt == 0 ) {
+					SEISCOMP_DEBUG("fdsnws: reused connection failed, reconnect");
+					resetResponse();
+					continue;
+				}
+
+				SEISCOMP_ERROR("fdsnws: %s", e.what());
+				return nullptr;
+			}
 		}
 
 		_readingData = true;
 		if ( !_chunkMode && _remainingBytes <= 0 ) {
 			SEISCOMP_DEBUG("Content length is 0, nothing to read");
-			_socket->close();
+			finishResponse();
 			return nullptr;
 		}
 	}
@@ -624,7 +788,7 @@ Record *FDSNWSConnectionBase::next() {
 					return rec;
 				}
 				else {
-					_socket->close();
+					finishResponse();
 					break;
 				}
 			}
@@ -649,6 +813,27 @@ Record *FDSNWSConnectionBase::next() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t FDSNWSConnectionBase::nextBatch(std::vector<Record*> &records, size_t max) {
+	size_t count = 0;
+
+	// The response has been requested completely, reading ahead does not
+	// wait for data which is not going to arrive
+	while ( count < max ) {
+		Record *rec = next();
+		if ( !rec ) break;
+
+		records.push_back(rec);
+		++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 std::string FDSNWSConnectionBase::readBinary(int size) {
 	if ( size <= 0 ) return "";
@@ -656,13 +841,14 @@ std::string FDSNWSConnectionBase::readBinary(int size) {
 	string data;
 	int bytesLeft = size;
 
-	while ( bytesLeft > 0 ) {
+	while ( bytesLeft > 0 && !_finished ) {
 		if ( _chunkMode && _remainingBytes <= 0 ) {
 			string r = _socket->readline();
-			size_t pos = r.find(' ');
+			// The size is followed by optional chunk extensions
+			string_view size = string_view(r).substr(0, r.find_first_of(" \t;"));
 			unsigned int remainingBytes;
 
-			if ( sscanf(r.substr(0, pos).c_str(), "%X", &remainingBytes) !=  1 )
+			if ( !fromChars(remainingBytes, size, 16) )
 				throw GeneralException("invalid chunk header: " + r);
 
 			_remainingBytes = remainingBytes;
@@ -670,7 +856,10 @@ std::string FDSNWSConnectionBase::readBinary(int size) {
 			if ( _remainingBytes <= 0 ) {
 				if ( _error.size() )
 					throw GeneralException(_error);
-				_socket->close();
+				// Read the empty line terminating the chunked body
+				if ( _keepAlive )
+					_socket->readline();
+				finishResponse();
 				break;
 			}
 		}
@@ -695,7 +884,7 @@ std::string FDSNWSConnectionBase::readBinary(int size) {
 				_socket->readline();
 			}
 			else {
-				_socket->close();
+				finishResponse();
 			}
 		}
 	}
@@ -707,6 +896,195 @@ std::string FDSNWSConnectionBase::readBinary(int size) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void FDSNWSConnectionBase::resetResponse() {
+	_readingData = false;
+	_chunkMode = false;
+	_remainingBytes = 0;
+	_closeConnection = false;
+	_finished = false;
+	_error.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void FDSNWSConnectionBase::finishResponse() {
+	_finished = true;
+	if ( !_keepAlive || _closeConnection )
+		_socket->close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void FDSNWSConnectionBase::startParallel() {
+	_parallel.reset(new Parallel);
+
+	// Split the time windows at multiples of the chunk length. The
+	// slices are requested in time order, so the records of each
+	// stream are returned in time order.
+	map<int64_t, vector<StreamIdx>> slices;
+	for ( const auto &stream : _streams ) {
+		Time stime = stream.startTime().valid() ? stream.startTime() : _stime;
+		Time etime = stream.endTime().valid() ? stream.endTime() : _etime;
+		if ( !stime.valid() || !etime.valid() ) {
+			SEISCOMP_WARNING("%s has invalid time window -> ignore",
+			                 stream.str(_stime, _etime).c_str());
+			continue;
+		}
+
+		if ( _chunkLength <= 0 ) {
+			slices[0].push_back(StreamIdx(stream.network(), stream.station(),
+			                              stream.location(), stream.channel(),
+			                              stime, etime));
+			continue;
+		}
+
+		while ( stime < etime ) {
+			int64_t slice = int64_t(floor(double(stime) / _chunkLength));
+			Time end = Time(double(slice+1) * _chunkLength);
+			if ( end > etime ) end = etime;
+
+			slices[slice].push_back(StreamIdx(stream.network(), stream.station(),
+			                                  stream.location(), stream.channel(),
+			                                  stime, end));
+			stime = end;
+		}
+	}
+
+	size_t streamsPerRequest = _chunkStreams;
+	if ( !streamsPerRequest && _chunkLength <= 0 && !slices.empty() ) {
+		// Distribute the streams evenly
+		size_t count = slices.begin()->second.size();
+		streamsPerRequest = (count + _parallelRequests - 1) / _parallelRequests;
+	}
+
+	for ( auto &slice : slices ) {
+		auto &streams = slice.second;
+		size_t step = streamsPerRequest ? streamsPerRequest : streams.size();
+
+		for ( size_t i = 0; i < streams.size(); i += step ) {
+			_parallel->requests.emplace_back();
+			_parallel->requests.back().streams.assign(
+				streams.begin() + i,
+				streams.begin() + min(i + step, streams.size())
+			);
+		}
+	}
+
+	size_t threads = min(_parallelRequests, _parallel->requests.size());
+	SEISCOMP_DEBUG("fdsnws: %d requests with %d connections",
+	               int(_parallel->requests.size()), int(threads));
+
+	_parallel->connections.resize(threads, nullptr);
+
+	Parallel *parallel = _parallel.get();
+	const char *protocol = _protocol;
+	int defaultPort = _defaultPort;
+	string host = _host, url = _url;
+	Array::DataType dataType = _dataType;
+	Record::Hint hint = _hint;
+	int timeout = _timeout;
+
+	for ( size_t i = 0; i < threads; ++i ) {
+		_parallel->threads.emplace_back([=]() {
+			IO::Socket *socket;
+			if ( !strcmp(protocol, "https") )
+				socket = new IO::SSLSocket;
+			else
+				socket = new IO::Socket;
+
+			unique_ptr<FDSNWSConnectionBase> conn(
+				new FDSNWSConnectionBase(protocol, socket, defaultPort)
+			);
+			conn->_host = host;
+			conn->_url = url;
+			conn->_keepAlive = true;
+			conn->setDataType(dataType);
+			conn->setDataHint(hint);
+			if ( timeout >= 0 )
+				conn->setTimeout(timeout);
+
+			unique_lock<mutex> l(parallel->mtx);
+			parallel->connections[i] = conn.get();
+
+			while ( true ) {
+				// Do not read ahead more than two requests per connection
+				parallel->cond.wait(l, [parallel, threads]() {
+					return parallel->stopped
+					    || parallel->next >= parallel->requests.size()
+					    || parallel->next < parallel->current + threads*2;
+				});
+
+				if ( parallel->stopped || parallel->next >= parallel->requests.size() )
+					break;
+
+				Parallel::Request &request = parallel->requests[parallel->next++];
+				l.unlock();
+
+				conn->resetResponse();
+				conn->_streams.clear();
+				conn->_streams.insert(request.streams.begin(), request.streams.end());
+
+				while ( Record *rec = conn->next() ) {
+					lock_guard<mutex> guard(parallel->mtx);
+					request.records.push_back(rec);
+					parallel->cond.notify_all();
+				}
+
+				l.lock();
+				request.done = true;
+				parallel->cond.notify_all();
+			}
+
+			parallel->connections[i] = nullptr;
+		});
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *FDSNWSConnectionBase::nextParallel() {
+	if ( !_parallel )
+		startParallel();
+
+	Parallel *parallel = _parallel.get();
+	unique_lock<mutex> l(parallel->mtx);
+
+	while ( parallel->current < parallel->requests.size() ) {
+		Parallel::Request &request = parallel->requests[parallel->current];
+		parallel->cond.wait(l, [parallel, &request]() {
+			return parallel->stopped || request.done || !request.records.empty();
+		});
+
+		if ( parallel->stopped )
+			return nullptr;
+
+		if ( !request.records.empty() ) {
+			Record *rec = request.records.front();
+			request.records.pop_front();
+			return rec;
+		}
+
+		++parallel->current;
+		parallel->cond.notify_all();
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 FDSNWSConnection::FDSNWSConnection()
 : FDSNWSConnectionBase("http", new IO::Socket, 80) {}
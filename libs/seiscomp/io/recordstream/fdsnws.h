@@ -24,6 +24,7 @@
 #include <string>
 #include <set>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <seiscomp/core.h>
 #include <seiscomp/core/interruptible.h>
@@ -37,12 +38,35 @@ namespace Seiscomp {
 namespace RecordStream {
 
 
+/**
+ * @brief Requests data from a FDSNWS dataselect service.
+ *
+ * By default all streams are requested with a single POST request. The
+ * source accepts the following options to split large requests:
+ *
+ * - parallel: The number of requests which are run in parallel, each with
+ *   its own keep-alive connection. The default is 1.
+ * - chunk: The maximum time span of a request in seconds. The time windows
+ *   are split at multiples of the chunk length.
+ * - streams: The maximum number of streams of a request. If neither chunk
+ *   nor streams is given, the streams are distributed evenly over the
+ *   parallel requests.
+ *
+ * Records are decoded as they arrive. The requests are returned in their
+ * order, so the records of each stream are returned in time order.
+ * Multiple hosts are requested in parallel with the routing record stream.
+ */
 class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream {
 	protected:
 		//! C'tor
 		FDSNWSConnectionBase(const char *protocol, IO::Socket *socket, int defaultPort);
 
 
+	public:
+		//! D'tor
+		~FDSNWSConnectionBase() override;
+
+
 	public:
 		//! The recordtype cannot be selected when using an arclink
 		//! connection. It will always create MiniSeed records
@@ -80,6 +104,8 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream {
 
 		virtual Record *next();
 
+		size_t nextBatch(std::vector<Record*> &records, size_t max) override;
+
 		//! Reconnects a terminated arclink connection.
 		bool reconnect();
 
@@ -88,6 +114,8 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream {
 
 
 	private:
+		struct Parallel;
+
 		const char *getProxy() const;
 		void openConnection(const std::string &);
 
@@ -95,6 +123,14 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream {
 		std::string readBinary(int size);
 		void handshake();
 
+		//! Prepares a new request on the same connection
+		void resetResponse();
+		//! Closes the connection or keeps it open for the next request
+		void finishResponse();
+
+		void startParallel();
+		Record *nextParallel();
+
 
 	private:
 		const char          *_protocol;
@@ -110,6 +146,16 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream {
 		bool                 _chunkMode;
 		int                  _remainingBytes;
 		std::string          _error;
+		int                  _timeout;
+		bool                 _keepAlive;
+		bool                 _closeConnection;
+		bool                 _finished;
+		size_t               _parallelRequests;
+		double               _chunkLength;
+		size_t               _chunkStreams;
+		// Declared last to stop the requests before any other member
+		// is destroyed
+		std::unique_ptr<Parallel> _parallel;
 };
 
 
@@ -139,7 +139,8 @@ bool File::addStream(const string &net, const string &sta,
 		_filter.emplace(id, TimeWindowFilter());
 	}
 	else { // wildcards characters are present
-		_reFilter.emplace_back(id, TimeWindowFilter());
+		_reMatcher.add(id);
+		_reFilter.emplace_back();
 	}
 
 	return true;
@@ -159,7 +160,8 @@ bool File::addStream(const string &net, const string &sta,
 		_filter.emplace(id, TimeWindowFilter(startTime, endTime));
 	}
 	else { // wildcards characters are present
-		_reFilter.emplace_back(id, TimeWindowFilter(startTime, endTime));
+		_reMatcher.add(id);
+		_reFilter.emplace_back(startTime, endTime);
 	}
 
 	return true;
@@ -225,20 +227,18 @@ const File::TimeWindowFilter* File::findTimeWindowFilter(Record *rec) {
 	}
 
 	// then search the wildcarded filters
-	for ( const auto &pair : _reFilter ) {
-		const auto &wild = pair.first;
-		const auto &twf = pair.second;
-		if ( Core::wildcmp(wild, streamID) ) {
-			// now add this stream to the fully qualified ones, so that
-			// next record with the same stream will be resolved without
-			// going through this loop
-			_filter.emplace(streamID, twf);
-			return &twf;
-		}
+	int index = _reMatcher.match(streamID);
+	if ( index < 0 ) {
+		// no matches
+		return nullptr;
 	}
 
-	// no matches
-	return nullptr;
+	// now add this stream to the fully qualified ones, so that
+	// next record with the same stream will be resolved without
+	// matching again
+	const auto &twf = _reFilter[index];
+	_filter.emplace(streamID, twf);
+	return &twf;
 }
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
@@ -256,6 +256,7 @@ Record *File::next() {
 		}
 		_filter.clear();
 		_reFilter.clear();
+		_reMatcher.clear();
 		_closeRequested = false;
 		return nullptr;
 	}
@@ -27,6 +27,7 @@
 #include <map>
 
 #include <seiscomp/io/recordstream.h>
+#include <seiscomp/utils/wildcardmatcher.h>
 #include <seiscomp/core.h>
 
 
@@ -115,7 +116,9 @@ class SC_SYSTEM_CORE_API File : public Seiscomp::IO::RecordStream {
 		};
 
 		using FilterMap = std::map<std::string, TimeWindowFilter>;
-		using ReFilterList = std::vector<std::pair<std::string,TimeWindowFilter> >;
+		//! The filters of wildcard stream IDs in the order of the patterns
+		//! of the matcher
+		using ReFilterList = std::vector<TimeWindowFilter>;
 
 		const TimeWindowFilter* findTimeWindowFilter(Record *rec);
 
@@ -126,6 +129,7 @@ class SC_SYSTEM_CORE_API File : public Seiscomp::IO::RecordStream {
 		std::istream   *_current{&_fstream};
 		FilterMap       _filter;
 		ReFilterList    _reFilter;
+		Util::WildcardMatcher _reMatcher;
 		Core::Time      _startTime;
 		Core::Time      _endTime;
 };
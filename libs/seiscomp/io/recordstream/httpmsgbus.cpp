@@ -33,6 +33,8 @@
 
 #include "httpmsgbus.h"
 
+#include <libmseed.h>
+
 using namespace std;
 
 namespace Seiscomp {
@@ -532,10 +534,8 @@ void HMBConnection<SocketType>::initSession()
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename SocketType>
-std::string HMBConnection<SocketType>::receive() {
+bool HMBConnection<SocketType>::receive(const char *&data, int &len) {
 	while (true) {
-		std::string data;
-
 		try {
 			if ( _sid.length() == 0 )
 				initSession();
@@ -546,10 +546,11 @@ std::string HMBConnection<SocketType>::receive() {
 				_sock.httpGet(_serverPath + "stream/" + _sid);
 			}
 
+			// The message buffer is reused for all messages
 			_sock.startTimer();
-			data = _sock.httpRead(4);
+			_buffer.assign(_sock.httpRead(4));
 			int size;
-			memcpy(&size, data.c_str(), 4);
+			memcpy(&size, _buffer.data(), 4);
 			size = BSON_UINT32_FROM_LE(size);
 
 			SEISCOMP_DEBUG("BSON size: %d", size);
@@ -558,7 +559,7 @@ std::string HMBConnection<SocketType>::receive() {
 				throw Core::GeneralException("invalid BSON size");
 
 			_sock.startTimer();
-			data += _sock.httpRead(size - 4);
+			_buffer.append(_sock.httpRead(size - 4));
 		}
 		catch ( Core::GeneralException &e ) {
 			if ( _sock.isOpen() )
@@ -571,7 +572,7 @@ std::string HMBConnection<SocketType>::receive() {
 		try {
 			bson_t bson = BSON_INITIALIZER;
 
-			if ( !bson_init_static(&bson, (const uint8_t *) data.data(), data.length()) )
+			if ( !bson_init_static(&bson, (const uint8_t *) _buffer.data(), _buffer.length()) )
 				throw Core::GeneralException("invalid BSON data");
 
 			std::string msgtype = bsonGetString(&bson, "type");
@@ -581,17 +582,19 @@ std::string HMBConnection<SocketType>::receive() {
 				int64_t seq = bsonGetInt(&bson, "seq");
 				_queues[qname].setSequenceNumber(seq + 1);
 
+				// The record is passed without copying it out of the
+				// message buffer
 				const void *cdata;
-				int cdata_len;
-				bsonGetBlob(&bson, "data", &cdata, &cdata_len);
-				return std::string((const char *)cdata, cdata_len);
+				bsonGetBlob(&bson, "data", &cdata, &len);
+				data = static_cast<const char *>(cdata);
+				return true;
 			}
 			else if ( !strcmp(msgtype.c_str(), "EOF") ) {
 				if ( _sock.isOpen() )
 					_sock.close();
 
 				_sid = "";
-				return "";
+				return false;
 			}
 			else if ( !strcmp(msgtype.c_str(), "HEARTBEAT") ) {
 				// do nothing
@@ -641,22 +644,31 @@ Record *HMBConnection<SocketType>::next() {
 		_readingData = true;
 	}
 
-	while ( true ) {
-		std::string data = receive();
-		if ( data.empty() ) break;
+	const char *data;
+	int len;
+
+	while ( receive(data, len) ) {
+		if ( len <= 0 ) continue;
 
-		std::istringstream stream(std::istringstream::in|std::istringstream::binary);
-		stream.str(data);
+		// Create the record from the unpacked header instead of parsing
+		// a copy of the data with a stream
+		MSRecord *prec = nullptr;
+		if ( msr_unpack(const_cast<char *>(data), len, &prec, 0, 0) != MS_NOERROR ) {
+			if ( prec ) msr_free(&prec);
+			continue;
+		}
 
-		IO::MSeedRecord *rec = new IO::MSeedRecord();
-		setupRecord(rec);
+		IO::MSeedRecord *rec = nullptr;
 		try {
-			rec->read(stream);
-			return rec;
+			rec = new IO::MSeedRecord(prec, _dataType, _hint);
 		}
 		catch ( ... ) {
-			delete rec;
+			rec = nullptr;
 		}
+
+		msr_free(&prec);
+
+		if ( rec ) return rec;
 	}
 
 	return nullptr;
@@ -139,12 +139,16 @@ class SC_SYSTEM_CORE_API HMBConnection : public Seiscomp::IO::RecordStream {
 		std::string _sid;
 		std::string _cid;
 		bool _readingData;
+		std::string _buffer;
 
 		std::string bsonGetString(const bson_t *bson, const char *key);
 		int64_t bsonGetInt(const bson_t *bson, const char *key);
 		void bsonGetBlob(const bson_t *bson, const char *key, const void **data, int *data_len);
 		void initSession();
-		std::string receive();
+		//! Receives the next MSEED message and returns the record data
+		//! which points into the reused message buffer. Returns false
+		//! if the stream has finished.
+		bool receive(const char *&data, int &len);
 };
 
 }
@@ -0,0 +1,892 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT Pyramid
+
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <libmseed.h>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/system.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/system/environment.h>
+#include <seiscomp/utils/files.h>
+
+#include "pyramid.h"
+
+
+using namespace std;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace fs = boost::filesystem;
+
+
+REGISTER_RECORDSTREAM(Pyramid, "pyramid");
+
+
+namespace {
+
+
+const char *Magic = "SCPYRLV1";
+const uint32_t ByteOrder = 0x01020304;
+const int64_t Microseconds = 1000000;
+const int64_t MicrosecondsPerDay = 86400 * Microseconds;
+const int64_t NoTime = numeric_limits<int64_t>::min();
+
+
+struct Header {
+	char     magic[8];
+	uint32_t byteOrder;
+	uint32_t seconds;
+	int64_t  lastTime;
+};
+
+
+int64_t toMicroseconds(const Time &time) {
+	return static_cast<int64_t>(time.seconds()) * Microseconds + time.microseconds();
+}
+
+
+Time fromMicroseconds(int64_t usecs) {
+	int64_t secs = usecs / Microseconds;
+	usecs -= secs * Microseconds;
+	if ( usecs < 0 ) {
+		--secs;
+		usecs += Microseconds;
+	}
+
+	return Time(static_cast<long>(secs), static_cast<long>(usecs));
+}
+
+
+int64_t dayOf(int64_t usecs) {
+	int64_t day = usecs / MicrosecondsPerDay;
+	return usecs < 0 && day * MicrosecondsPerDay != usecs ? day - 1 : day;
+}
+
+
+vector<string> listDirectory(const string &dir, bool directories) {
+	vector<string> names;
+
+	try {
+		SC_FS_DECLARE_PATH(path, dir)
+		fs::directory_iterator it(path), end;
+		for ( ; it != end; ++it ) {
+			if ( directories ? !fs::is_directory(*it) : !fs::is_regular_file(*it) )
+				continue;
+
+			string name = SC_FS_FILE_NAME(SC_FS_DE_PATH(it));
+			if ( name.empty() || name[0] == '.' ) continue;
+			names.push_back(name);
+		}
+	}
+	catch ( ... ) {}
+
+	return names;
+}
+
+
+//! Splits a day file name NET.STA.LOC.CHA.D.YEAR.DOY into its stream codes
+bool parseFileName(const string &name, string codes[4]) {
+	size_t start = 0;
+
+	for ( int i = 0; i < 4; ++i ) {
+		size_t p = name.find('.', start);
+		if ( p == string::npos ) return false;
+		codes[i] = name.substr(start, p - start);
+		start = p + 1;
+	}
+
+	return name.compare(start, 2, "D.") == 0;
+}
+
+
+string levelFile(const string &root, int seconds, const string &net,
+                 const string &sta, const string &loc, const string &cha,
+                 int64_t day) {
+	int year, yday;
+	Time(static_cast<long>(day * 86400), 0).get2(&year, &yday);
+
+	char doy[4];
+	snprintf(doy, sizeof(doy), "%03d", yday + 1);
+	string y = toString(year);
+
+	return DecimationPyramid::LevelPath(root, seconds) + "/" + y + "/" +
+	       net + "/" + sta + "/" + cha + "/" +
+	       net + "." + sta + "." + loc + "." + cha + "." + y + "." + doy;
+}
+
+
+bool readHeader(int fd, int seconds, Header &header) {
+	return pread(fd, &header, sizeof(header), 0) == sizeof(header)
+	    && !memcmp(header.magic, Magic, sizeof(header.magic))
+	    && header.byteOrder == ByteOrder
+	    && header.seconds == static_cast<uint32_t>(seconds);
+}
+
+
+//! Converts the samples of an unpacked record
+bool samples(const MSRecord *prec, vector<double> &data) {
+	data.resize(static_cast<size_t>(prec->numsamples));
+
+	switch ( prec->sampletype ) {
+		case 'i':
+			copy(static_cast<const int32_t*>(prec->datasamples),
+			     static_cast<const int32_t*>(prec->datasamples) + data.size(),
+			     data.begin());
+			return true;
+		case 'f':
+			copy(static_cast<const float*>(prec->datasamples),
+			     static_cast<const float*>(prec->datasamples) + data.size(),
+			     data.begin());
+			return true;
+		case 'd':
+			copy(static_cast<const double*>(prec->datasamples),
+			     static_cast<const double*>(prec->datasamples) + data.size(),
+			     data.begin());
+			return true;
+		default:
+			return false;
+	}
+}
+
+
+struct DayFileState {
+	uint64_t size{0};
+	int64_t  mtime{0};
+	uint64_t offset{0};
+};
+
+
+typedef map<string, DayFileState> DayFileStates;
+
+
+void loadState(const string &fname, DayFileStates &states) {
+	ifstream ifs(fname);
+	string path;
+	DayFileState state;
+
+	while ( ifs >> path >> state.size >> state.mtime >> state.offset )
+		states[path] = state;
+}
+
+
+bool saveState(const string &fname, const DayFileStates &states) {
+	string tmp = fname + ".tmp";
+	{
+		ofstream ofs(tmp);
+		for ( const auto &item : states )
+			ofs << item.first << " " << item.second.size << " "
+			    << item.second.mtime << " " << item.second.offset << "\n";
+		if ( !ofs.good() ) return false;
+	}
+
+	return rename(tmp.c_str(), fname.c_str()) == 0;
+}
+
+
+}
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+const vector<int> DecimationPyramid::DefaultLevels = { 10, 60, 600, 3600 };
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DecimationPyramid::DecimationPyramid(const string &root, const vector<int> &levels)
+: _root(root) {
+	for ( int seconds : levels ) {
+		if ( seconds <= 0 || 86400 % seconds ) {
+			SEISCOMP_WARNING("Ignoring decimation level of %ds which does not "
+			                 "divide a day", seconds);
+			continue;
+		}
+
+		_levels.push_back(seconds);
+	}
+
+	sort(_levels.begin(), _levels.end());
+	_levels.erase(unique(_levels.begin(), _levels.end()), _levels.end());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DecimationPyramid::~DecimationPyramid() {
+	flush();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string DecimationPyramid::LevelPath(const string &root, int seconds) {
+	return root + "/.pyramid/" + toString(seconds);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+vector<int> DecimationPyramid::Levels(const string &root) {
+	vector<int> levels;
+
+	for ( const string &name : listDirectory(root + "/.pyramid", true) ) {
+		int seconds;
+		if ( fromString(seconds, name) && seconds > 0 && !(86400 % seconds) )
+			levels.push_back(seconds);
+	}
+
+	sort(levels.begin(), levels.end());
+	return levels;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DecimationPyramid::write(const Record *rec) {
+	const Array *data = rec ? rec->data() : nullptr;
+	if ( !data || rec->samplingFrequency() <= 0 ) return false;
+
+	DoubleArrayPtr samples = static_cast<DoubleArray*>(data->copy(Array::DOUBLE));
+	if ( !samples ) return false;
+
+	add(rec->networkCode(), rec->stationCode(), rec->locationCode(),
+	    rec->channelCode(), toMicroseconds(rec->startTime()),
+	    rec->samplingFrequency(), samples->typedData(),
+	    static_cast<size_t>(samples->size()));
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DecimationPyramid::add(const string &net, const string &sta,
+                            const string &loc, const string &cha,
+                            int64_t startTime, double samplingFrequency,
+                            const double *samples, size_t count) {
+	for ( int seconds : _levels ) {
+		int64_t width = seconds * Microseconds;
+		int64_t currentDay = NoTime;
+		uint32_t currentBin = numeric_limits<uint32_t>::max();
+		File *f = nullptr;
+		Bin *bin = nullptr;
+
+		for ( size_t i = 0; i < count; ++i ) {
+			int64_t t = startTime + static_cast<int64_t>(llround(i * Microseconds / samplingFrequency));
+			int64_t day = dayOf(t);
+
+			if ( day != currentDay ) {
+				string path = levelFile(_root, seconds, net, sta, loc, cha, day);
+				_fileLevels[path] = seconds;
+				f = &file(path);
+				currentDay = day;
+				currentBin = numeric_limits<uint32_t>::max();
+			}
+
+			if ( t <= f->lastTime ) continue;
+
+			uint32_t index = static_cast<uint32_t>((t - day * MicrosecondsPerDay) / width);
+			if ( index != currentBin ) {
+				bin = &f->bins[index];
+				currentBin = index;
+			}
+
+			double v = samples[i];
+			if ( !bin->count ) {
+				bin->min = bin->max = v;
+				bin->sum = 0;
+			}
+			else {
+				bin->min = min(bin->min, v);
+				bin->max = max(bin->max, v);
+			}
+
+			bin->sum += v;
+			++bin->count;
+
+			if ( t > f->newLastTime )
+				f->newLastTime = t;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DecimationPyramid::File &DecimationPyramid::file(const string &path) {
+	File &f = _files[path];
+	if ( f.loaded ) return f;
+
+	f.loaded = true;
+	f.lastTime = NoTime;
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if ( fd >= 0 ) {
+		Header header;
+		if ( readHeader(fd, _fileLevels[path], header) )
+			f.lastTime = header.lastTime;
+		::close(fd);
+	}
+
+	f.newLastTime = f.lastTime;
+	return f;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DecimationPyramid::flush() {
+	bool ok = true;
+
+	for ( auto &item : _files ) {
+		if ( !flush(item.first, _fileLevels[item.first], item.second) )
+			ok = false;
+	}
+
+	_files.clear();
+	_fileLevels.clear();
+	return ok;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DecimationPyramid::flush(const string &path, int seconds, File &f) {
+	if ( f.bins.empty() ) return true;
+
+	string dir = path.substr(0, path.rfind('/'));
+	if ( !Util::pathExists(dir) && !Util::createPath(dir) ) {
+		SEISCOMP_ERROR("%s: cannot create directory", dir.c_str());
+		return false;
+	}
+
+	int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if ( fd < 0 ) {
+		SEISCOMP_ERROR("%s: %s", path.c_str(), strerror(errno));
+		return false;
+	}
+
+	off_t fileSize = static_cast<off_t>(sizeof(Header) + (86400 / seconds) * sizeof(Bin));
+	struct stat st;
+	Header header;
+	bool ok = fstat(fd, &st) == 0;
+
+	if ( ok && st.st_size == 0 ) {
+		// New files hold all bins of the day, empty bins are zero
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, Magic, sizeof(header.magic));
+		header.byteOrder = ByteOrder;
+		header.seconds = static_cast<uint32_t>(seconds);
+		header.lastTime = NoTime;
+		ok = pwrite(fd, &header, sizeof(header), 0) == sizeof(header)
+		  && ftruncate(fd, fileSize) == 0;
+	}
+	else if ( ok ) {
+		ok = readHeader(fd, seconds, header) && st.st_size == fileSize;
+		if ( !ok )
+			SEISCOMP_ERROR("%s: invalid level file", path.c_str());
+	}
+
+	// Merge the bins with the stored bins in one span
+	if ( ok ) {
+		uint32_t first = f.bins.begin()->first;
+		uint32_t last = f.bins.rbegin()->first;
+		vector<Bin> bins(last - first + 1);
+		size_t bytes = bins.size() * sizeof(Bin);
+		off_t offset = static_cast<off_t>(sizeof(Header) + first * sizeof(Bin));
+
+		ok = pread(fd, bins.data(), bytes, offset) == static_cast<ssize_t>(bytes);
+
+		for ( auto it = f.bins.begin(); ok && it != f.bins.end(); ++it ) {
+			Bin &stored = bins[it->first - first];
+			const Bin &added = it->second;
+
+			if ( !stored.count )
+				stored = added;
+			else {
+				stored.min = min(stored.min, added.min);
+				stored.max = max(stored.max, added.max);
+				stored.sum += added.sum;
+				stored.count += added.count;
+			}
+		}
+
+		ok = ok && pwrite(fd, bins.data(), bytes, offset) == static_cast<ssize_t>(bytes);
+	}
+
+	if ( ok ) {
+		header.lastTime = f.newLastTime;
+		ok = pwrite(fd, &header, sizeof(header), 0) == sizeof(header);
+	}
+
+	if ( !ok )
+		SEISCOMP_ERROR("%s: failed to write bins", path.c_str());
+
+	::close(fd);
+
+	f.bins.clear();
+	f.lastTime = f.newLastTime;
+	return ok;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t DecimationPyramid::update() {
+	string stateFile = _root + "/.pyramid/.state";
+	DayFileStates states, updated;
+	loadState(stateFile, states);
+
+	size_t changed = 0;
+	MSRecord *prec = nullptr;
+	vector<char> data;
+	vector<double> values;
+
+	// Layout: YEAR/NET/STA/CHA.D/NET.STA.LOC.CHA.D.YEAR.DOY
+	for ( const string &year : listDirectory(_root, true) ) {
+		string yearPath = year + "/";
+		for ( const string &net : listDirectory(_root + "/" + yearPath, true) ) {
+			string netPath = yearPath + net + "/";
+			for ( const string &sta : listDirectory(_root + "/" + netPath, true) ) {
+				string staPath = netPath + sta + "/";
+				for ( const string &cha : listDirectory(_root + "/" + staPath, true) ) {
+					string chaPath = staPath + cha + "/";
+					for ( const string &name : listDirectory(_root + "/" + chaPath, false) ) {
+						string path = chaPath + name;
+						string codes[4];
+						if ( !parseFileName(name, codes) ) continue;
+
+						struct stat st;
+						string fname = _root + "/" + path;
+						if ( stat(fname.c_str(), &st) != 0 )
+							continue;
+
+						DayFileState &state = updated[path];
+						auto it = states.find(path);
+						if ( it != states.end() )
+							state = it->second;
+
+						uint64_t size = static_cast<uint64_t>(st.st_size);
+						if ( state.size == size && state.mtime == st.st_mtime )
+							continue;
+
+						// A file which has been rewritten is read again, the
+						// time of the last sample of each level prevents
+						// adding samples twice
+						if ( size < state.offset )
+							state.offset = 0;
+
+						state.size = size;
+						state.mtime = st.st_mtime;
+
+						FILE *fp = fopen(fname.c_str(), "rb");
+						if ( !fp ) continue;
+
+						data.clear();
+						if ( state.offset < size && fseeko(fp, state.offset, SEEK_SET) == 0 ) {
+							data.resize(size - state.offset);
+							data.resize(fread(data.data(), 1, data.size(), fp));
+						}
+
+						fclose(fp);
+
+						size_t offset = 0;
+						while ( offset + MINRECLEN <= data.size() ) {
+							char *rec = data.data() + offset;
+							int reclen = ms_detect(rec, static_cast<int>(min<size_t>(data.size() - offset, MAXRECLEN)));
+
+							if ( reclen < 0 ) {
+								offset += 64;
+								continue;
+							}
+
+							// Truncated record at the end of a growing file
+							if ( reclen == 0 || offset + reclen > data.size() )
+								break;
+
+							if ( msr_unpack(rec, reclen, &prec, 1, 0) == MS_NOERROR
+							  && prec->samprate > 0 && samples(prec, values) )
+								add(codes[0], codes[1], codes[2], codes[3],
+								    prec->starttime * (Microseconds / HPTMODULUS),
+								    prec->samprate, values.data(), values.size());
+
+							offset += reclen;
+						}
+
+						state.offset += offset;
+						flush();
+						++changed;
+					}
+				}
+			}
+		}
+	}
+
+	msr_free(&prec);
+
+	if ( (changed || updated.size() != states.size()) && !saveState(stateFile, updated) )
+		SEISCOMP_WARNING("%s: failed to write pyramid state", stateFile.c_str());
+
+	return changed;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Pyramid::Pyramid() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Pyramid::~Pyramid() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Pyramid::setSource(const string &source) {
+	string src = source;
+	_rate = 0;
+	_statistic = MinMax;
+	_level = 0;
+
+	size_t pos = src.find('?');
+	if ( pos != string::npos ) {
+		vector<string> toks;
+		split(toks, src.substr(pos+1).c_str(), "&");
+		src.erase(pos);
+
+		for ( const string &tok : toks ) {
+			string name = tok, value;
+			size_t p = tok.find('=');
+			if ( p != string::npos ) {
+				name = tok.substr(0, p);
+				value = tok.substr(p+1);
+			}
+
+			if ( name == "rate" ) {
+				if ( !fromString(_rate, value) || _rate < 0 ) {
+					SEISCOMP_ERROR("Invalid pyramid rate: %s", value.c_str());
+					return false;
+				}
+			}
+			else if ( name == "stat" ) {
+				if ( value == "min" )
+					_statistic = Minimum;
+				else if ( value == "max" )
+					_statistic = Maximum;
+				else if ( value == "mean" )
+					_statistic = Mean;
+				else if ( value == "minmax" )
+					_statistic = MinMax;
+				else {
+					SEISCOMP_ERROR("Invalid pyramid statistic: %s", value.c_str());
+					return false;
+				}
+			}
+			else if ( !name.empty() ) {
+				SEISCOMP_ERROR("Invalid pyramid option: %s", tok.c_str());
+				return false;
+			}
+		}
+	}
+
+	_root = src.empty()
+	      ? Environment::Instance()->installDir() + "/var/lib/archive"
+	      : Environment::Instance()->absolutePath(src);
+
+	vector<int> levels = DecimationPyramid::Levels(_root);
+	if ( levels.empty() ) {
+		SEISCOMP_ERROR("%s: no decimation levels", _root.c_str());
+		return false;
+	}
+
+	// The coarsest level which provides at least the requested rate
+	_level = levels.front();
+	double samplesPerBin = _statistic == MinMax ? 2 : 1;
+	for ( int seconds : levels ) {
+		if ( _rate > 0 && samplesPerBin / seconds >= _rate )
+			_level = seconds;
+	}
+
+	if ( _rate > 0 && samplesPerBin / _level < _rate )
+		SEISCOMP_WARNING("%s: finest decimation level of %ds does not "
+		                 "provide %f sps", _root.c_str(), _level, _rate);
+
+	SEISCOMP_DEBUG("%s: reading decimation level of %ds", _root.c_str(), _level);
+	_closeRequested = false;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Pyramid::addStream(const string &net, const string &sta,
+                        const string &loc, const string &cha) {
+	return addStream(net, sta, loc, cha, Time(), Time());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Pyramid::addStream(const string &net, const string &sta,
+                        const string &loc, const string &cha,
+                        const Time &stime, const Time &etime) {
+	if ( net.find_first_of("*?") != string::npos
+	  || sta.find_first_of("*?") != string::npos
+	  || loc.find_first_of("*?") != string::npos
+	  || cha.find_first_of("*?") != string::npos ) {
+		SEISCOMP_ERROR("Wildcards are not supported: %s.%s.%s.%s",
+		               net.c_str(), sta.c_str(), loc.c_str(), cha.c_str());
+		return false;
+	}
+
+	Request request;
+	request.net = net;
+	request.sta = sta;
+	request.loc = loc;
+	request.cha = cha;
+	request.stime = stime;
+	request.etime = etime;
+	_requests.push_back(request);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Pyramid::setStartTime(const Time &stime) {
+	_stime = stime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Pyramid::setEndTime(const Time &etime) {
+	_etime = etime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Pyramid::close() {
+	lock_guard<mutex> l(_mutex);
+	_closeRequested = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *Pyramid::next() {
+	lock_guard<mutex> l(_mutex);
+
+	while ( !_closeRequested && _level > 0 ) {
+		// Each contiguous run of bins of a day is returned as one record
+		while ( _bin < _bins.size() ) {
+			if ( !_bins[_bin].count ) {
+				++_bin;
+				continue;
+			}
+
+			size_t first = _bin;
+			while ( _bin < _bins.size() && _bins[_bin].count )
+				++_bin;
+
+			return createRecord(_requests[_request], first, _bin);
+		}
+
+		if ( !readNextDay() )
+			break;
+	}
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Pyramid::readNextDay() {
+	_bins.clear();
+	_bin = 0;
+
+	int64_t width = _level * Microseconds;
+	int64_t binsPerDay = 86400 / _level;
+
+	while ( _request < _requests.size() ) {
+		const Request &req = _requests[_request];
+		Time stime = req.stime.valid() ? req.stime : _stime;
+		Time etime = req.etime.valid() ? req.etime : _etime;
+		if ( !etime.valid() ) etime = Time::GMT();
+
+		if ( !stime.valid() ) {
+			SEISCOMP_ERROR("%s.%s.%s.%s: no start time given",
+			               req.net.c_str(), req.sta.c_str(),
+			               req.loc.c_str(), req.cha.c_str());
+			++_request;
+			continue;
+		}
+
+		int64_t start = toMicroseconds(stime);
+		int64_t end = toMicroseconds(etime);
+
+		if ( !_started ) {
+			_day = dayOf(start);
+			_started = true;
+		}
+		else
+			++_day;
+
+		if ( _day > dayOf(end) ) {
+			++_request;
+			_started = false;
+			continue;
+		}
+
+		// The bins of the day which overlap the time window
+		int64_t dayStart = _day * MicrosecondsPerDay;
+		int64_t first = max<int64_t>(0, (start - dayStart) / width);
+		int64_t last = min<int64_t>(binsPerDay, (end - dayStart + width - 1) / width);
+		if ( first >= last ) continue;
+
+		string fname = levelFile(_root, _level, req.net, req.sta, req.loc,
+		                         req.cha, _day);
+		int fd = open(fname.c_str(), O_RDONLY);
+		if ( fd < 0 ) continue;
+
+		Header header;
+		if ( readHeader(fd, _level, header) ) {
+			_bins.resize(static_cast<size_t>(last - first));
+			size_t bytes = _bins.size() * sizeof(DecimationPyramid::Bin);
+			off_t offset = static_cast<off_t>(sizeof(Header) + first * sizeof(DecimationPyramid::Bin));
+			if ( pread(fd, _bins.data(), bytes, offset) != static_cast<ssize_t>(bytes) )
+				_bins.clear();
+		}
+		else
+			SEISCOMP_WARNING("%s: invalid level file", fname.c_str());
+
+		::close(fd);
+
+		if ( !_bins.empty() ) {
+			_dayStart = dayStart + first * width;
+			return true;
+		}
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *Pyramid::createRecord(const Request &req, size_t first, size_t last) {
+	vector<double> values;
+	values.reserve((last - first) * (_statistic == MinMax ? 2 : 1));
+
+	for ( size_t i = first; i < last; ++i ) {
+		const DecimationPyramid::Bin &bin = _bins[i];
+		switch ( _statistic ) {
+			case Minimum:
+				values.push_back(bin.min);
+				break;
+			case Maximum:
+				values.push_back(bin.max);
+				break;
+			case Mean:
+				values.push_back(bin.sum / bin.count);
+				break;
+			case MinMax:
+				values.push_back(bin.min);
+				values.push_back(bin.max);
+				break;
+		}
+	}
+
+	double fsamp = (_statistic == MinMax ? 2.0 : 1.0) / _level;
+	GenericRecord *rec = new GenericRecord(req.net, req.sta, req.loc, req.cha,
+	                                       fromMicroseconds(_dayStart + static_cast<int64_t>(first) * _level * Microseconds),
+	                                       fsamp, -1, _dataType, _hint);
+	rec->setData(static_cast<int>(values.size()), values.data(), Array::DOUBLE);
+	return rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
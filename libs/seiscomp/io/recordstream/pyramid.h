@@ -0,0 +1,238 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDSTREAM_PYRAMID_H
+#define SEISCOMP_IO_RECORDSTREAM_PYRAMID_H
+
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <seiscomp/core/record.h>
+#include <seiscomp/io/recordstream.h>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+/**
+ * @brief The DecimationPyramid class maintains precomputed decimation
+ *        levels of an SDS archive.
+ *
+ * Each level holds the minimum, maximum and mean of the samples of a stream
+ * in bins of a fixed number of seconds. The levels are stored in the
+ * directory .pyramid of the archive root:
+ * .pyramid/SECONDS/YEAR/NET/STA/CHA/NET.STA.LOC.CHA.YEAR.DOY
+ *
+ * A level file holds all bins of a day at fixed offsets. Empty bins mark
+ * gaps. Each file remembers the time of the last sample added, samples
+ * which are not later than that are ignored. Data which is added to the
+ * archive out of order is therefore not reflected.
+ */
+class DecimationPyramid {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct Bin {
+			double   min;
+			double   max;
+			double   sum;
+			uint32_t count;
+			uint32_t reserved;
+		};
+
+		//! The default level widths in seconds
+		static const std::vector<int> DefaultLevels;
+
+
+	// ----------------------------------------------------------------------
+	//  Xstruction
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Creates a pyramid of an archive.
+		 * @param root The SDS archive root
+		 * @param levels The level widths in seconds. Widths which do not
+		 *               divide a day are ignored.
+		 */
+		explicit DecimationPyramid(const std::string &root,
+		                           const std::vector<int> &levels = DefaultLevels);
+		~DecimationPyramid();
+
+
+	// ----------------------------------------------------------------------
+	//  Public Interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the directory of a level
+		static std::string LevelPath(const std::string &root, int seconds);
+
+		//! Returns the level widths stored for an archive root
+		static std::vector<int> Levels(const std::string &root);
+
+		const std::vector<int> &levels() const { return _levels; }
+
+		/**
+		 * @brief Adds the samples of a record to all levels. This is the
+		 *        hook for applications which write the archive. The bins
+		 *        are written with flush().
+		 */
+		bool write(const Record *rec);
+
+		//! Writes all modified bins
+		bool flush();
+
+		/**
+		 * @brief Adds all records to the levels which have been appended
+		 *        to the day files of the archive since the last update.
+		 *        The read position of each day file is kept in
+		 *        .pyramid/.state.
+		 * @return The number of day files which have been read
+		 */
+		size_t update();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct File {
+			bool                    loaded{false};
+			int64_t                 lastTime{0};
+			int64_t                 newLastTime{0};
+			std::map<uint32_t, Bin> bins;
+		};
+
+		void add(const std::string &net, const std::string &sta,
+		         const std::string &loc, const std::string &cha,
+		         int64_t startTime, double samplingFrequency,
+		         const double *samples, size_t count);
+
+		File &file(const std::string &path);
+		bool flush(const std::string &path, int seconds, File &file);
+
+		std::string                  _root;
+		std::vector<int>             _levels;
+		std::map<std::string, File>  _files;
+		std::map<std::string, int>   _fileLevels;
+};
+
+
+/**
+ * @brief The Pyramid class reads the decimation levels of an archive which
+ *        are maintained by DecimationPyramid.
+ *
+ * The source is the archive root with the output sampling rate and the
+ * statistic to return, e.g. /data/archive?rate=0.01&stat=minmax. The
+ * coarsest level which still provides the requested rate is read. The
+ * statistic is one of min, max, mean or minmax. The latter returns the
+ * minimum and maximum of each bin as two subsequent samples. Wildcards are
+ * not supported.
+ */
+class Pyramid : public Seiscomp::IO::RecordStream {
+	// ----------------------------------------------------------------------
+	//  Xstruction
+	// ----------------------------------------------------------------------
+	public:
+		Pyramid();
+		~Pyramid() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public Interface
+	// ----------------------------------------------------------------------
+	public:
+		bool setSource(const std::string &source) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const Seiscomp::Core::Time &startTime,
+		               const Seiscomp::Core::Time &endTime) override;
+
+		bool setStartTime(const Seiscomp::Core::Time &stime) override;
+		bool setEndTime(const Seiscomp::Core::Time &etime) override;
+
+		void close() override;
+
+		Seiscomp::Record *next() override;
+
+		//! Returns the level width in seconds which is read or 0 if the
+		//! archive has no levels
+		int level() const { return _level; }
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		enum Statistic {
+			Minimum,
+			Maximum,
+			Mean,
+			MinMax
+		};
+
+		struct Request {
+			std::string          net;
+			std::string          sta;
+			std::string          loc;
+			std::string          cha;
+			Seiscomp::Core::Time stime;
+			Seiscomp::Core::Time etime;
+		};
+
+		bool readNextDay();
+		Seiscomp::Record *createRecord(const Request &req, size_t first, size_t last);
+
+		std::string                       _root;
+		double                            _rate{0};
+		Statistic                         _statistic{MinMax};
+		int                               _level{0};
+		std::vector<Request>              _requests;
+		Seiscomp::Core::Time              _stime;
+		Seiscomp::Core::Time              _etime;
+		size_t                            _request{0};
+		int64_t                           _day{0};
+		bool                              _started{false};
+		int64_t                           _dayStart{0};
+		std::vector<DecimationPyramid::Bin> _bins;
+		size_t                            _bin{0};
+		std::mutex                        _mutex;
+		bool                              _closeRequested{false};
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,485 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT Replay
+
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <libmseed.h>
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/system/environment.h>
+#include <seiscomp/io/records/mseedrecord.h>
+
+#include "replay.h"
+
+
+using namespace std;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+REGISTER_RECORDSTREAM(Replay, "replay");
+
+
+namespace {
+
+
+hptime_t toHPTime(const Time &time) {
+	return static_cast<hptime_t>(time.seconds()) * HPTMODULUS + time.microseconds();
+}
+
+
+/**
+ * @brief Read-only stream buffer on top of a memory block.
+ */
+class MemoryBuffer : public streambuf {
+	public:
+		void reset(const char *data, size_t size) {
+			char *tmp = const_cast<char*>(data);
+			setg(tmp, tmp, tmp + size);
+		}
+};
+
+
+}
+
+
+/**
+ * @brief Read-only memory mapping of a file together with a stream to
+ *        read single records from it.
+ */
+struct Replay::MappedFile {
+	MappedFile() : stream(&buffer) {}
+	~MappedFile() {
+		if ( data ) munmap(const_cast<char*>(data), size);
+	}
+
+	bool open(const string &fname) {
+		int fd = ::open(fname.c_str(), O_RDONLY);
+		if ( fd < 0 ) return false;
+
+		struct stat st;
+		if ( fstat(fd, &st) != 0 || st.st_size <= 0 ) {
+			::close(fd);
+			return false;
+		}
+
+		void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+
+		if ( addr == MAP_FAILED ) return false;
+
+		data = static_cast<const char*>(addr);
+		size = st.st_size;
+		name = fname;
+		return true;
+	}
+
+	istream &record(uint64_t offset, uint32_t length) {
+		buffer.reset(data + offset, length);
+		stream.clear();
+		return stream;
+	}
+
+	string       name;
+	const char  *data{nullptr};
+	size_t       size{0};
+	MemoryBuffer buffer;
+	istream      stream;
+};
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Replay::Replay() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Replay::~Replay() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::setSource(const string &source) {
+	reset();
+
+	string src = source;
+	_speed = 0;
+
+	size_t pos = src.find('?');
+	if ( pos != string::npos ) {
+		vector<string> toks;
+		Core::split(toks, src.substr(pos+1).c_str(), "&");
+		src.erase(pos);
+
+		for ( const string &tok : toks ) {
+			string name = tok, value;
+			size_t p = tok.find('=');
+			if ( p != string::npos ) {
+				name = tok.substr(0, p);
+				value = tok.substr(p+1);
+			}
+
+			if ( name == "speed" ) {
+				if ( !Core::fromString(_speed, value) || _speed <= 0 ) {
+					SEISCOMP_ERROR("Invalid replay speed: %s", value.c_str());
+					return false;
+				}
+			}
+			else if ( !name.empty() ) {
+				SEISCOMP_ERROR("Invalid replay option: %s", tok.c_str());
+				return false;
+			}
+		}
+	}
+
+	vector<string> fnames;
+	Core::split(fnames, src.c_str(), ",");
+
+	for ( const string &fname : fnames ) {
+		string absPath = Environment::Instance()->absolutePath(fname);
+
+		unique_ptr<MappedFile> file(new MappedFile);
+		if ( !file->open(absPath) ) {
+			SEISCOMP_ERROR("Could not map record file %s: %s",
+			               absPath.c_str(), strerror(errno));
+			_files.clear();
+			return false;
+		}
+
+		SEISCOMP_DEBUG("+ Replay file: %s", absPath.c_str());
+		_files.push_back(move(file));
+	}
+
+	if ( _files.empty() ) {
+		SEISCOMP_ERROR("No replay files given");
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::addStream(const string &net, const string &sta,
+                       const string &loc, const string &cha) {
+	return addFilter(net, sta, loc, cha, TimeWindow());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::addStream(const string &net, const string &sta,
+                       const string &loc, const string &cha,
+                       const Time &startTime, const Time &endTime) {
+	return addFilter(net, sta, loc, cha, TimeWindow{startTime, endTime});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::setStartTime(const Time &startTime) {
+	if ( _indexed ) return false;
+	_startTime = startTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::setEndTime(const Time &endTime) {
+	if ( _indexed ) return false;
+	_endTime = endTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Replay::close() {
+	lock_guard<mutex> l(_mutex);
+	_closeRequested = true;
+	_wakeUp.notify_all();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::setRecordType(const char *type) {
+	if ( strcmp(type, "mseed") ) {
+		SEISCOMP_ERROR("Replay supports miniSEED records only");
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Seiscomp::Record *Replay::next() {
+	if ( !_indexed && !_closeRequested )
+		buildIndex();
+
+	while ( !_closeRequested && _next < _index.size() ) {
+		const Entry &entry = _index[_next++];
+
+		if ( !pace(entry.endTime) )
+			break;
+
+		MappedFile &file = *_files[entry.file];
+		IO::MSeedRecord *rec = new IO::MSeedRecord(_dataType, _hint);
+
+		try {
+			rec->read(file.record(entry.offset, entry.length));
+		}
+		catch ( std::exception &e ) {
+			SEISCOMP_ERROR("%s: record at %lu: %s", file.name.c_str(),
+			               static_cast<unsigned long>(entry.offset), e.what());
+			delete rec;
+			continue;
+		}
+
+		return rec;
+	}
+
+	reset();
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t Replay::recordCount() const {
+	return _index.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double Replay::speed() const {
+	return _speed;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::addFilter(const string &net, const string &sta,
+                       const string &loc, const string &cha,
+                       const TimeWindow &tw) {
+	if ( _indexed ) return false;
+
+	auto id = net + "." + sta + "." + loc + "." + cha;
+	if ( id.find_first_of("*?") == string::npos )
+		_filter.emplace(id, tw);
+	else {
+		_wildcardMatcher.add(id);
+		_wildcardFilter.push_back(tw);
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Replay::TimeWindow *Replay::findTimeWindow(const string &streamID) {
+	auto it = _filter.find(streamID);
+	if ( it != _filter.end() )
+		return &it->second;
+
+	int index = _wildcardMatcher.match(streamID);
+	if ( index < 0 )
+		return nullptr;
+
+	// Resolve the next record of this stream without matching again
+	return &_filter.emplace(streamID, _wildcardFilter[index]).first->second;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Replay::buildIndex() {
+	bool filtered = !_filter.empty() || !_wildcardFilter.empty();
+	hptime_t startTime = _startTime.valid() ? toHPTime(_startTime) : 0;
+	hptime_t endTime = _endTime.valid() ? toHPTime(_endTime) : 0;
+	MSRecord *prec = nullptr;
+	string streamID;
+
+	for ( size_t i = 0; i < _files.size() && !_closeRequested; ++i ) {
+		const MappedFile &file = *_files[i];
+		size_t offset = 0;
+
+		while ( offset + MINRECLEN <= file.size ) {
+			const char *data = file.data + offset;
+			int reclen = ms_detect(data, static_cast<int>(min<size_t>(file.size - offset, MAXRECLEN)));
+
+			if ( reclen < 0 ) {
+				// No record header, skip over to the next block as
+				// MSeedRecord::read does
+				offset += 64;
+				continue;
+			}
+
+			if ( reclen == 0 || offset + reclen > file.size ) {
+				SEISCOMP_WARNING("%s: unreadable record at %lu, skipping the "
+				                 "rest of the file", file.name.c_str(),
+				                 static_cast<unsigned long>(offset));
+				break;
+			}
+
+			if ( msr_unpack(const_cast<char*>(data), reclen, &prec, 0, 0) != MS_NOERROR ) {
+				offset += reclen;
+				continue;
+			}
+
+			hptime_t recStart = prec->starttime;
+			hptime_t recEnd = prec->samprate > 0
+			                ? recStart + static_cast<hptime_t>(prec->samplecnt / prec->samprate * HPTMODULUS)
+			                : recStart;
+
+			hptime_t windowStart = startTime, windowEnd = endTime;
+
+			if ( filtered ) {
+				streamID = string(prec->network) + "." + prec->station + "." +
+				           prec->location + "." + prec->channel;
+
+				const TimeWindow *tw = findTimeWindow(streamID);
+				if ( !tw ) {
+					offset += reclen;
+					continue;
+				}
+
+				if ( tw->start.valid() ) windowStart = toHPTime(tw->start);
+				if ( tw->end.valid() ) windowEnd = toHPTime(tw->end);
+			}
+
+			// Same selection as the file record stream
+			if ( (windowStart && recEnd < windowStart)
+			  || (windowEnd && recStart >= windowEnd) ) {
+				offset += reclen;
+				continue;
+			}
+
+			_index.push_back({static_cast<uint32_t>(i),
+			                  static_cast<uint32_t>(reclen),
+			                  offset, recEnd});
+			offset += reclen;
+		}
+	}
+
+	msr_free(&prec);
+
+	stable_sort(_index.begin(), _index.end(),
+	            [](const Entry &a, const Entry &b) {
+	                return a.endTime < b.endTime;
+	            });
+
+	SEISCOMP_DEBUG("Indexed %lu records of %lu files",
+	               static_cast<unsigned long>(_index.size()),
+	               static_cast<unsigned long>(_files.size()));
+
+	_indexed = true;
+	_next = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Replay::reset() {
+	_files.clear();
+	_index.clear();
+	_index.shrink_to_fit();
+	_next = 0;
+	_indexed = false;
+	_filter.clear();
+	_wildcardFilter.clear();
+	_wildcardMatcher.clear();
+	_startTime = Time();
+	_endTime = Time();
+	_referenceTime = 0;
+	_referenceClock = Clock::time_point();
+	_closeRequested = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Replay::pace(int64_t endTime) {
+	if ( _speed <= 0 ) return !_closeRequested;
+
+	if ( _referenceClock == Clock::time_point() ) {
+		_referenceTime = endTime;
+		_referenceClock = Clock::now();
+		return !_closeRequested;
+	}
+
+	auto delay = chrono::microseconds(
+		static_cast<int64_t>((endTime - _referenceTime) / _speed)
+	);
+
+	unique_lock<mutex> l(_mutex);
+	_wakeUp.wait_until(l, _referenceClock + delay,
+	                   [this]() { return _closeRequested.load(); });
+	return !_closeRequested;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,188 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDSTREAM_REPLAY_H
+#define SEISCOMP_IO_RECORDSTREAM_REPLAY_H
+
+
+#include <seiscomp/io/recordstream.h>
+#include <seiscomp/utils/wildcardmatcher.h>
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+DEFINE_SMARTPOINTER(Replay);
+
+
+/**
+ * @brief The Replay class plays back a set of multiplexed miniSEED files
+ *        in time order.
+ *
+ * The files are mapped into memory rather than loaded. With the first
+ * call to next() the headers of all records are decoded and the records
+ * matching the requested streams and time window are collected in an
+ * index which is sorted by record end time, the time a record would have
+ * been received in real time. Records with the same end time keep the
+ * order of the files and of the records in a file. Replaying the same
+ * files therefore always yields the same sequence of records.
+ *
+ * The source is a comma separated list of files which can be followed
+ * by options, e.g. "day1.mseed,day2.mseed?speed=2".
+ *
+ * Supported options:
+ * - speed: Paces the records in real time, scaled by the given factor.
+ *          The first record is returned immediately and each following
+ *          record when the difference of its end time to the end time of
+ *          the first record, divided by speed, has elapsed. Without this
+ *          option records are returned as fast as possible.
+ */
+class SC_SYSTEM_CORE_API Replay : public Seiscomp::IO::RecordStream {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		Replay();
+		~Replay() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public RecordStream interface
+	// ----------------------------------------------------------------------
+	public:
+		bool setSource(const std::string &source) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const Seiscomp::Core::Time &startTime,
+		               const Seiscomp::Core::Time &endTime) override;
+
+		bool setStartTime(const Seiscomp::Core::Time &startTime) override;
+		bool setEndTime(const Seiscomp::Core::Time &endTime) override;
+
+		//! Interrupts a pending next() call which waits for the next
+		//! record to become due. This is safe to be called from another
+		//! thread.
+		void close() override;
+
+		//! Only miniSEED is supported.
+		bool setRecordType(const char *type) override;
+
+		Record *next() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the number of indexed records. The index is built with
+		//! the first call to next(), before that 0 is returned.
+		size_t recordCount() const;
+
+		//! Returns the replay speed, 0 if records are not paced.
+		double speed() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		struct MappedFile;
+
+		struct Entry {
+			uint32_t file;
+			uint32_t length;
+			uint64_t offset;
+			int64_t  endTime;
+		};
+
+		struct TimeWindow {
+			Core::Time start;
+			Core::Time end;
+		};
+
+		using FilterMap = std::map<std::string, TimeWindow>;
+		//! The time windows of wildcard stream IDs in the order of the
+		//! patterns of the matcher
+		using WildcardFilterList = std::vector<TimeWindow>;
+		using Clock = std::chrono::steady_clock;
+
+		bool addFilter(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const TimeWindow &tw);
+
+		//! Returns the time window of a stream or nullptr if the stream
+		//! has not been requested.
+		const TimeWindow *findTimeWindow(const std::string &streamID);
+
+		void buildIndex();
+		void reset();
+
+		//! Waits until a record with the given end time is due. Returns
+		//! false if the stream has been closed in the meantime.
+		bool pace(int64_t endTime);
+
+
+	private:
+		std::vector<std::unique_ptr<MappedFile>> _files;
+		std::vector<Entry>                       _index;
+		size_t                                   _next{0};
+		bool                                     _indexed{false};
+
+		FilterMap                                _filter;
+		WildcardFilterList                       _wildcardFilter;
+		Util::WildcardMatcher                    _wildcardMatcher;
+		Core::Time                               _startTime;
+		Core::Time                               _endTime;
+
+		double                                   _speed{0};
+		int64_t                                  _referenceTime{0};
+		Clock::time_point                        _referenceClock;
+
+		std::atomic<bool>                        _closeRequested{false};
+		std::mutex                               _mutex;
+		std::condition_variable                  _wakeUp;
+};
+
+
+}
+}
+
+
+#endif
@@ -59,6 +59,64 @@ size_t findClosingParenthesis(const string &s, size_t p) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// The maximum number of wildcard patterns a single match option is
+// expanded to
+const size_t MaxAlternatives = 256;
+
+
+/**
+ * Expands the alternatives of a match option starting at pos into plain
+ * wildcard patterns, e.g. (GE|GR).*.*.BH? into GE.*.*.BH? and GR.*.*.BH?.
+ * Parsing stops at an unbalanced closing parenthesis or at the end of
+ * the option.
+ */
+bool expandAlternatives(const string &match, size_t &pos, vector<string> &alternatives) {
+	vector<string> sequences(1);
+
+	while ( pos < match.size() && match[pos] != ')' ) {
+		char c = match[pos++];
+		if ( c == '|' ) {
+			alternatives.insert(alternatives.end(), sequences.begin(), sequences.end());
+			sequences.assign(1, string());
+		}
+		else if ( c == '(' ) {
+			vector<string> group;
+			if ( !expandAlternatives(match, pos, group) || pos >= match.size() ) {
+				return false;
+			}
+
+			// Skip the closing parenthesis
+			++pos;
+
+			if ( sequences.size() * group.size() > MaxAlternatives ) {
+				return false;
+			}
+
+			vector<string> product;
+			for ( const string &head : sequences ) {
+				for ( const string &tail : group ) {
+					product.push_back(head + tail);
+				}
+			}
+
+			sequences.swap(product);
+		}
+		else {
+			for ( string &sequence : sequences ) {
+				sequence += c;
+			}
+		}
+	}
+
+	alternatives.insert(alternatives.end(), sequences.begin(), sequences.end());
+	return alternatives.size() <= MaxAlternatives;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 REGISTER_RECORDSTREAM(RoutingConnection, "routing");
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -75,6 +133,9 @@ bool RoutingConnection::setSource(const string &source) {
 
 	_rsarray.clear();
 	_rules.clear();
+	_index.clear();
+	_indexRules.clear();
+	_regexRules.clear();
 
 	/*
 	 * Format of source is:
@@ -82,8 +143,11 @@ bool RoutingConnection::setSource(const string &source) {
 	 * where
 	 *  sourceN is either source or (source)
 	 *  pattern is NET.STA.LOC.CHA and the special charactes ? * | ( ) are allowed
+	 * followed by the optional ??merge=seconds
 	 */
 	string input = source;
+	if ( !extractMergeOption(input) )
+		return false;
 
 	do {
 		// Extract type1: anything until '/' (not greedy)
@@ -189,6 +253,22 @@ bool RoutingConnection::setSource(const string &source) {
 			throw RecordStreamException("Invalid RecordStream URL");
 		}
 
+		// Index the rule by its wildcard patterns, rules with too many
+		// alternatives are matched with the regular expression
+		size_t rule = _rules.size() - 1;
+		size_t pos = 0;
+		vector<string> alternatives;
+		if ( expandAlternatives(match1, pos, alternatives) && pos == match1.size() ) {
+			for ( const string &pattern : alternatives ) {
+				_index.add(pattern);
+				_indexRules.push_back(rule);
+			}
+		}
+		else {
+			SEISCOMP_DEBUG("Match %s is not indexed", match1.c_str());
+			_regexRules.push_back(rule);
+		}
+
 	}
 	while ( !input.empty() );
 
@@ -204,13 +284,28 @@ int RoutingConnection::getRS(const string &net, const string &sta,
                              const string &loc, const string &cha) {
 	const string stream = net + "." + sta + "." + loc +  "." + cha;
 
-	for ( size_t i = 0; i < _rules.size(); ++i) {
-		if ( regex_match(stream, _rules[i].match) ) {
-			SEISCOMP_DEBUG("stream %s -> recordstream %lu (%s %s %s)",
-			               stream.c_str(), i, _rules[i].type.c_str(),
-			               _rules[i].source.c_str(), _rules[i].matchOpt.c_str());
-			return i;
+	// The first matching pattern belongs to the first matching indexed
+	// rule
+	int pattern = _index.match(stream);
+	size_t i = pattern >= 0 ? _indexRules[pattern] : _rules.size();
+
+	// Rules which are not indexed take precedence if they come first
+	for ( size_t rule : _regexRules ) {
+		if ( rule >= i ) {
+			break;
 		}
+
+		if ( regex_match(stream, _rules[rule].match) ) {
+			i = rule;
+			break;
+		}
+	}
+
+	if ( i < _rules.size() ) {
+		SEISCOMP_DEBUG("stream %s -> recordstream %lu (%s %s %s)",
+		               stream.c_str(), i, _rules[i].type.c_str(),
+		               _rules[i].source.c_str(), _rules[i].matchOpt.c_str());
+		return i;
 	}
 
 	SEISCOMP_DEBUG("stream %s doesn't match any RecordStream", stream.c_str());
@@ -23,6 +23,7 @@
 
 
 #include <seiscomp/io/recordstream/concurrent.h>
+#include <seiscomp/utils/wildcardmatcher.h>
 #include <boost/regex.hpp>
 
 
@@ -53,6 +54,13 @@ class RoutingConnection : public Seiscomp::RecordStream::Concurrent {
 		};
 
 		std::vector<Rule> _rules;
+
+		// The rules expanded into wildcard patterns in the order of the
+		// rules and the rule of each pattern
+		Seiscomp::Util::WildcardMatcher _index;
+		std::vector<size_t>             _indexRules;
+		// The rules which could not be expanded
+		std::vector<size_t>             _regexRules;
 };
 
 
@@ -21,8 +21,16 @@
 #define SEISCOMP_COMPONENT SDS
 
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
+#include <thread>
 #include <libmseed.h>
 
 #include <boost/version.hpp>
@@ -128,7 +136,481 @@ Time getStartTime(const string &file) {
 }
 
 
+hptime_t toHPTime(const Time &time) {
+	return static_cast<hptime_t>(time.seconds()) * HPTMODULUS + time.microseconds();
 }
+
+
+/**
+ * @brief Read-only stream buffer on top of a memory block.
+ */
+class MemoryBuffer : public streambuf {
+	public:
+		void reset(const char *data, size_t size) {
+			char *tmp = const_cast<char*>(data);
+			setg(tmp, tmp, tmp + size);
+		}
+
+	protected:
+		pos_type seekoff(off_type ofs, ios_base::seekdir dir,
+		                 ios_base::openmode mode) override {
+			if ( !(mode & ios_base::in) )
+				return pos_type(off_type(-1));
+
+			char *next;
+
+			switch ( dir ) {
+				case ios_base::beg:
+					next = eback() + ofs;
+					break;
+				case ios_base::cur:
+					next = gptr() + ofs;
+					break;
+				case ios_base::end:
+					next = egptr() + ofs;
+					break;
+				default:
+					return pos_type(off_type(-1));
+			}
+
+			if ( next > egptr() || next < eback() )
+				return pos_type(off_type(-1));
+
+			setg(eback(), next, egptr());
+			return pos_type(next - eback());
+		}
+
+		pos_type seekpos(pos_type pos, ios_base::openmode mode) override {
+			return seekoff(off_type(pos), ios_base::beg, mode);
+		}
+};
+
+
+/**
+ * @brief Index of the records of a day file. Each entry holds the offset
+ *        of a record and its time span. The index can be saved to and
+ *        loaded from a sidecar file.
+ */
+struct RecordIndex {
+	struct Entry {
+		uint64_t offset;
+		int64_t  startTime;
+		int64_t  endTime;
+	};
+
+	struct Header {
+		char     magic[8];
+		uint32_t byteOrder;
+		uint32_t count;
+		uint64_t fileSize;
+		int64_t  fileTime;
+		uint64_t scanned;
+		uint32_t sorted;
+		uint32_t reserved;
+	};
+
+	static constexpr const char *Magic = "SCSDSIX1";
+	static const uint32_t ByteOrder = 0x01020304;
+
+	vector<Entry> entries;
+	uint64_t      fileSize{0};
+	int64_t       fileTime{0};
+	//! The number of bytes covered by the index
+	uint64_t      scanned{0};
+	bool          sorted{true};
+
+	static string sidecar(const string &fname) {
+		size_t pos = fname.rfind('/');
+		if ( pos == string::npos )
+			return "." + fname + ".idx";
+		return fname.substr(0, pos+1) + "." + fname.substr(pos+1) + ".idx";
+	}
+
+	bool load(const string &fname) {
+		FILE *fp = fopen(fname.c_str(), "rb");
+		if ( !fp ) return false;
+
+		Header header;
+		struct stat st;
+		bool ok = fread(&header, sizeof(header), 1, fp) == 1
+		       && !memcmp(header.magic, Magic, sizeof(header.magic))
+		       && header.byteOrder == ByteOrder
+		       // Reject truncated or otherwise corrupt indexes before
+		       // trusting the entry count
+		       && fstat(fileno(fp), &st) == 0
+		       && static_cast<uint64_t>(st.st_size) == sizeof(Header) + uint64_t(header.count) * sizeof(Entry);
+
+		if ( ok ) {
+			entries.resize(header.count);
+			ok = entries.empty()
+			  || fread(entries.data(), sizeof(Entry), entries.size(), fp) == entries.size();
+		}
+
+		fclose(fp);
+
+		if ( !ok ) {
+			entries.clear();
+			return false;
+		}
+
+		fileSize = header.fileSize;
+		fileTime = header.fileTime;
+		scanned = header.scanned;
+		sorted = header.sorted != 0;
+		return true;
+	}
+
+	bool save(const string &fname) const {
+		// A unique temporary file in the same directory keeps concurrent
+		// writers from different threads and processes apart
+		string tmp = fname + ".XXXXXX";
+		int fd = mkstemp(&tmp[0]);
+		if ( fd < 0 ) return false;
+
+		// mkstemp creates the file with 0600, the index is shared with
+		// other readers of the archive
+		fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+		FILE *fp = fdopen(fd, "wb");
+		if ( !fp ) {
+			::close(fd);
+			unlink(tmp.c_str());
+			return false;
+		}
+
+		Header header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, Magic, sizeof(header.magic));
+		header.byteOrder = ByteOrder;
+		header.count = static_cast<uint32_t>(entries.size());
+		header.fileSize = fileSize;
+		header.fileTime = fileTime;
+		header.scanned = scanned;
+		header.sorted = sorted ? 1 : 0;
+
+		bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+		       && (entries.empty()
+		        || fwrite(entries.data(), sizeof(Entry), entries.size(), fp) == entries.size());
+		ok = (fclose(fp) == 0) && ok;
+
+		// Replace the index atomically to not confuse concurrent readers
+		if ( !ok || rename(tmp.c_str(), fname.c_str()) != 0 ) {
+			unlink(tmp.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Checks whether the index still describes the leading part of
+	 *        a day file. This is the case if the file is unchanged or if
+	 *        records have been appended only.
+	 * @return true if the index can be used, possibly after scanning the
+	 *         appended part.
+	 */
+	bool isValid(const char *data, size_t size, int64_t mtime) const {
+		if ( size < scanned ) return false;
+		if ( size == fileSize && mtime == fileTime ) return true;
+		if ( entries.empty() ) return scanned == 0;
+
+		// The file has grown, check that the last indexed record has not
+		// been touched
+		const Entry &last = entries.back();
+		if ( last.offset >= size ) return false;
+
+		MSRecord *prec = nullptr;
+		int reclen = ms_detect(data + last.offset, static_cast<int>(min<size_t>(size - last.offset, MAXRECLEN)));
+		if ( reclen <= 0 || last.offset + reclen > size ) return false;
+
+		bool ok = msr_unpack(const_cast<char*>(data + last.offset), reclen, &prec, 0, 0) == MS_NOERROR
+		       && prec->starttime == last.startTime;
+		msr_free(&prec);
+		return ok;
+	}
+
+	/**
+	 * @brief Decodes the headers of all records behind the scanned part
+	 *        and appends them to the index.
+	 * @return false if the record length of a record could not be
+	 *         determined.
+	 */
+	bool scan(const char *data, size_t size) {
+		MSRecord *prec = nullptr;
+		bool result = true;
+
+		while ( scanned + MINRECLEN <= size ) {
+			const char *rec = data + scanned;
+			int reclen = ms_detect(rec, static_cast<int>(min<size_t>(size - scanned, MAXRECLEN)));
+
+			if ( reclen < 0 ) {
+				// No record header, skip over to the next block as
+				// MSeedRecord::read does
+				scanned += 64;
+				continue;
+			}
+
+			if ( reclen == 0 ) {
+				// Either a truncated record at the end of a growing file or
+				// a record without blockette 1000
+				result = scanned + MAXRECLEN <= size ? false : result;
+				break;
+			}
+
+			if ( scanned + reclen > size ) break;
+
+			if ( msr_unpack(const_cast<char*>(rec), reclen, &prec, 0, 0) == MS_NOERROR ) {
+				Entry entry;
+				entry.offset = scanned;
+				entry.startTime = prec->starttime;
+				if ( prec->samprate > 0 )
+					entry.endTime = entry.startTime + static_cast<hptime_t>(prec->samplecnt / prec->samprate * HPTMODULUS);
+				else
+					entry.endTime = entry.startTime + HPTMODULUS;
+
+				if ( !entries.empty() && entries.back().endTime > entry.endTime )
+					sorted = false;
+
+				entries.push_back(entry);
+			}
+
+			scanned += reclen;
+		}
+
+		msr_free(&prec);
+		return result;
+	}
+
+	//! Returns the offset of the first record ending after stime.
+	uint64_t find(hptime_t stime) const {
+		vector<Entry>::const_iterator it;
+
+		if ( sorted ) {
+			it = partition_point(entries.begin(), entries.end(),
+			                     [stime](const Entry &e) {
+			                         return e.endTime <= stime && e.startTime <= stime;
+			                     });
+		}
+		else {
+			it = find_if(entries.begin(), entries.end(),
+			             [stime](const Entry &e) {
+			                 return e.endTime > stime || e.startTime > stime;
+			             });
+		}
+
+		return it != entries.end() ? it->offset : scanned;
+	}
+
+	//! Returns the offset behind the last record starting before etime
+	//! or the end of the scanned part if the records are not sorted.
+	uint64_t findEnd(hptime_t etime) const {
+		if ( !sorted ) return scanned;
+
+		auto it = partition_point(entries.begin(), entries.end(),
+		                          [etime](const Entry &e) {
+		                              return e.startTime <= etime;
+		                          });
+
+		return it != entries.end() ? it->offset : scanned;
+	}
+
+	//! Returns the offset of the first record behind offset which starts
+	//! after etime. This is where reading records sequentially stops.
+	uint64_t findStop(uint64_t offset, hptime_t etime) const {
+		if ( sorted ) return max(offset, findEnd(etime));
+
+		auto it = partition_point(entries.begin(), entries.end(),
+		                          [offset](const Entry &e) {
+		                              return e.offset < offset;
+		                          });
+		it = find_if(it, entries.end(),
+		             [etime](const Entry &e) {
+		                 return e.startTime > etime;
+		             });
+
+		return it != entries.end() ? it->offset : scanned;
+	}
+};
+
+
+/**
+ * @brief Brings the index of a day file up to date. The sidecar file is
+ *        read and written if persist is set, otherwise the headers are
+ *        scanned.
+ */
+bool updateIndex(RecordIndex &index, const string &fname,
+                 const char *data, size_t size, int64_t mtime,
+                 bool persist) {
+	string idxFile = RecordIndex::sidecar(fname);
+
+	if ( !persist || !index.load(idxFile) || !index.isValid(data, size, mtime) )
+		index = RecordIndex();
+
+	if ( index.fileSize != size || index.fileTime != mtime ) {
+		if ( !index.scan(data, size) ) {
+			SEISCOMP_DEBUG("SDS: [%s] cannot index records", fname.c_str());
+			return false;
+		}
+
+		index.fileSize = size;
+		index.fileTime = mtime;
+
+		if ( persist && !index.save(idxFile) )
+			SEISCOMP_DEBUG("SDS: [%s] cannot write index: %s",
+			               idxFile.c_str(), strerror(errno));
+	}
+
+	return true;
+}
+
+
+}
+
+
+/**
+ * @brief Read-only memory mapping of a day file together with a stream
+ *        to read records from it.
+ */
+struct SDSArchive::MappedFile {
+	MappedFile() : stream(&buffer) {}
+	~MappedFile() { close(); }
+
+	bool open(const string &fname) {
+		close();
+
+		int fd = ::open(fname.c_str(), O_RDONLY);
+		if ( fd < 0 ) return false;
+
+		struct stat st;
+		if ( fstat(fd, &st) != 0 || st.st_size <= 0 ) {
+			::close(fd);
+			return false;
+		}
+
+		void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+
+		if ( addr == MAP_FAILED ) {
+			SEISCOMP_DEBUG("mmap %s: %s", fname.c_str(), strerror(errno));
+			return false;
+		}
+
+		data = static_cast<const char*>(addr);
+		size = st.st_size;
+		mtime = st.st_mtime;
+
+		buffer.reset(data, size);
+		stream.clear();
+		return true;
+	}
+
+	void close() {
+		if ( data ) {
+			munmap(const_cast<char*>(data), size);
+			data = nullptr;
+			size = 0;
+		}
+
+		buffer.reset(nullptr, 0);
+	}
+
+	const char  *data{nullptr};
+	size_t       size{0};
+	int64_t      mtime{0};
+	MemoryBuffer buffer;
+	istream      stream;
+};
+
+
+
+
+/**
+ * @brief A day file which is read in the background.
+ */
+struct SDSArchive::PrefetchJob {
+	PrefetchJob() : stream(&buffer) {}
+
+	string       fname;
+	bool         first{false};
+	Time         stime;
+	Time         etime;
+	//! The content of the file starting with the first requested record
+	vector<char> data;
+	bool         found{false};
+	bool         done{false};
+	MemoryBuffer buffer;
+	istream      stream;
+};
+
+
+
+
+/**
+ * @brief Thread pool which loads prefetch jobs in the order they are
+ *        pushed.
+ */
+class SDSArchive::Prefetcher {
+	public:
+		Prefetcher(const SDSArchive *archive, size_t threads)
+		: _archive(archive) {
+			for ( size_t i = 0; i < threads; ++i )
+				_threads.emplace_back(&Prefetcher::run, this);
+		}
+
+		~Prefetcher() {
+			{
+				lock_guard<mutex> l(_mutex);
+				_stop = true;
+			}
+
+			_jobAvailable.notify_all();
+			for ( auto &t : _threads )
+				t.join();
+		}
+
+		void push(const PrefetchJobPtr &job) {
+			{
+				lock_guard<mutex> l(_mutex);
+				_jobs.push_back(job);
+			}
+
+			_jobAvailable.notify_one();
+		}
+
+		void wait(const PrefetchJobPtr &job) {
+			unique_lock<mutex> l(_mutex);
+			_jobDone.wait(l, [&job]() { return job->done; });
+		}
+
+	private:
+		void run() {
+			unique_lock<mutex> l(_mutex);
+
+			while ( true ) {
+				_jobAvailable.wait(l, [this]() { return _stop || !_jobs.empty(); });
+				if ( _stop ) break;
+
+				PrefetchJobPtr job = _jobs.front();
+				_jobs.pop_front();
+
+				l.unlock();
+				_archive->loadPrefetchJob(*job);
+				l.lock();
+
+				job->done = true;
+				_jobDone.notify_all();
+			}
+		}
+
+	private:
+		const SDSArchive       *_archive;
+		vector<thread>          _threads;
+		PrefetchJobs            _jobs;
+		mutex                   _mutex;
+		condition_variable      _jobAvailable;
+		condition_variable      _jobDone;
+		bool                    _stop{false};
+};
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -241,14 +723,59 @@ SDSArchive::SDSArchive(const string arcroot) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-SDSArchive::~SDSArchive() {}
+SDSArchive::~SDSArchive() {
+	closeFile();
+	_prefetchJobs.clear();
+	_prefetcher.reset();
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool SDSArchive::setSource(const string &src) {
+bool SDSArchive::setSource(const string &source) {
+	string src = source;
+
+	_useMMap = false;
+	_useIndex = false;
+	_useAvailability = false;
+	_availability.clear();
+	_readAhead = 0;
+
+	size_t pos = src.find('?');
+	if ( pos != string::npos ) {
+		vector<string> toks;
+		Core::split(toks, src.substr(pos+1).c_str(), "&");
+		src.erase(pos);
+
+		for ( const string &tok : toks ) {
+			string name = tok, value;
+			size_t p = tok.find('=');
+			if ( p != string::npos ) {
+				name = tok.substr(0, p);
+				value = tok.substr(p+1);
+			}
+
+			if ( name == "mmap" )
+				_useMMap = true;
+			else if ( name == "index" )
+				_useIndex = true;
+			else if ( name == "availability" )
+				_useAvailability = true;
+			else if ( name == "readahead" ) {
+				if ( !Core::fromString(_readAhead, value) ) {
+					SEISCOMP_ERROR("Invalid SDS readahead value: %s", value.c_str());
+					return false;
+				}
+			}
+			else if ( !name.empty() ) {
+				SEISCOMP_ERROR("Invalid SDS option: %s", tok.c_str());
+				return false;
+			}
+		}
+	}
+
 	if ( src.empty() ) {
 		_arcroots.push_back(Environment::Instance()->installDir() + "/var/lib/archive");
 	}
@@ -352,6 +879,9 @@ bool SDSArchive::setTimeout(int seconds) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SDSArchive::close() {
 	lock_guard<mutex> l(_mutex);
+	closeFile();
+	_prefetchJobs.clear();
+	_prefetcher.reset();
 	_readFiles.clear();
 	_fnames = FileQueue();
 	_streamSet.clear();
@@ -359,6 +889,7 @@ void SDSArchive::close() {
 	_curiter = _orderedRequests.begin();
 	_stime = _etime = Time();
 	_curidx = nullptr;
+	_segmentsStarted = false;
 	_closeRequested = true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -513,12 +1044,19 @@ bool SDSArchive::resolveLoc(string &pathStr,
 		if ( _readFiles.find(filename) == _readFiles.end() ) {
 			_readFiles.insert(filename);
 
-			if ( first && getStartTime(fpath) > requestStartTime ) {
+			const SDSAvailability::DayFile *known = lookupAvailability(fpath);
+
+			if ( first && (known ? known->start() : getStartTime(fpath)) > requestStartTime ) {
 				(Time::FromYearDay(year, doy) - TimeSpan(86400,0)).get2(&year, &doy);
 				resolveLoc(pathStr, net, sta, loc, cha, requestStartTime, doy+1, year, true);
 				first = false;
 			}
 
+			if ( known && !known->overlaps(requestStartTime, _curidx->etime) ) {
+				SEISCOMP_DEBUG("- %s (no data)", fpath.c_str());
+				return true;
+			}
+
 			SEISCOMP_DEBUG("+ %s", fpath.c_str());
 			_fnames.push(File(fpath,first));
 		}
@@ -545,11 +1083,18 @@ bool SDSArchive::resolveLoc(string &pathStr,
 			if ( _readFiles.find(fpath) == _readFiles.end() ) {
 				_readFiles.insert(fpath);
 
-				if ( first && getStartTime(fpath) > requestStartTime ) {
+				const SDSAvailability::DayFile *known = lookupAvailability(fpath);
+
+				if ( first && (known ? known->start() : getStartTime(fpath)) > requestStartTime ) {
 					(Time::FromYearDay(year, doy) - TimeSpan(86400,0)).get2(&year, &doy);
 					resolveLoc(pathStr, net, sta, loc, cha, requestStartTime, doy+1, year, first);
 				}
 
+				if ( known && !known->overlaps(requestStartTime, _curidx->etime) ) {
+					SEISCOMP_DEBUG("- %s (no data)", fpath.c_str());
+					continue;
+				}
+
 				SEISCOMP_DEBUG("+ %s", fpath.c_str());
 				_fnames.push(File(fpath,first));
 			}
@@ -575,12 +1120,15 @@ bool SDSArchive::resolveFiles(const string &net, const string &sta,
 	snprintf(buf, 9, "%d", year);
 	bool result = true;
 
-	for ( const string &root : _arcroots ) {
-		string path = root + "/" + buf + "/";
+	for ( size_t i = 0; i < _arcroots.size(); ++i ) {
+		string path = _arcroots[i] + "/" + buf + "/";
+		_curAvailability = i < _availability.size() ? _availability[i] : nullptr;
 		if ( !resolveNet(path, net, sta, loc, cha, requestStartTime, doy, year, first) )
 			result = false;
 	}
 
+	_curAvailability = nullptr;
+
 	return result;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -590,6 +1138,11 @@ bool SDSArchive::resolveFiles(const string &net, const string &sta,
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SDSArchive::resolveRequest() {
+	if ( _useAvailability && _availability.empty() ) {
+		for ( const string &root : _arcroots )
+			_availability.push_back(SDSAvailability::Open(root));
+	}
+
 	Time stime = _curidx->stime;
 	Time etime = _curidx->etime;
 	int sdoy = getDoy(stime);
@@ -614,24 +1167,158 @@ void SDSArchive::resolveRequest() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const SDSAvailability::DayFile *SDSArchive::lookupAvailability(const string &fname) const {
+	if ( !_curAvailability ) return nullptr;
+
+	const string &root = _curAvailability->root();
+	if ( fname.compare(0, root.size(), root) != 0 || fname.size() <= root.size() + 1 )
+		return nullptr;
+
+	struct stat st;
+	if ( stat(fname.c_str(), &st) != 0 ) return nullptr;
+
+	return _curAvailability->find(fname.substr(root.size() + 1),
+	                              static_cast<size_t>(st.st_size), st.st_mtime);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSArchive::openFile(const string &fname) {
+	if ( _useMMap ) {
+		if ( !_mappedFile ) _mappedFile.reset(new MappedFile);
+		if ( _mappedFile->open(fname) ) {
+			_stream = &_mappedFile->stream;
+			return true;
+		}
+		// Fall back to a file stream, e.g. for empty files
+	}
+
+	_file.open(fname.c_str(), ifstream::in | ifstream::binary);
+	if ( !_file.is_open() ) {
+		_file.clear();
+		return false;
+	}
+
+	_stream = &_file;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SDSArchive::closeFile() {
+	if ( _prefetchJob && _stream == &_prefetchJob->stream )
+		_prefetchJob.reset();
+	else if ( _mappedFile && _stream == &_mappedFile->stream )
+		_mappedFile->close();
+	else if ( _file.is_open() )
+		_file.close();
+
+	_stream = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSArchive::lookupIndex(const string &fname, const MappedFile &mapping,
+                             const Time &stime, const Time &etime,
+                             size_t &offset, size_t &endOffset) {
+	RecordIndex index;
+
+	if ( !updateIndex(index, fname, mapping.data, mapping.size, mapping.mtime, true) )
+		return false;
+
+	offset = index.find(toHPTime(stime));
+	endOffset = etime.valid() ? index.findEnd(toHPTime(etime)) : mapping.size;
+	if ( endOffset < offset ) endOffset = offset;
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSArchive::setStartFromIndex(const string &fname) {
+	if ( !_useIndex ) return false;
+
+	MappedFile *mapping = nullptr;
+	unique_ptr<MappedFile> tmpMapping;
+
+	if ( _mappedFile && _stream == &_mappedFile->stream )
+		mapping = _mappedFile.get();
+	else {
+		// The headers are scanned from a temporary mapping if the file
+		// is read through a stream
+		tmpMapping.reset(new MappedFile);
+		if ( !tmpMapping->open(fname) ) return false;
+		mapping = tmpMapping.get();
+	}
+
+	Time stime = (_curidx->stime == Time())?_stime:_curidx->stime;
+	size_t offset, endOffset;
+
+	if ( !lookupIndex(fname, *mapping, stime, Time(), offset, endOffset) )
+		return false;
+
+	_stream->clear();
+	_stream->seekg(static_cast<streamoff>(offset), ios::beg);
+	if ( offset >= mapping->size )
+		_stream->clear(ios::eofbit);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool SDSArchive::setStart(const string &fname, bool bsearch) {
+	Time stime = (_curidx->stime == Time())?_stime:_curidx->stime;
+	long int offset = 0;
+	long int size;
+
+	_stream->seekg(0, ios::end);
+	size = (long int)_stream->tellg();
+	if ( size <= 0 )
+		return false;
+
+	bool result = findStart(fname, stime, size, bsearch, offset);
+
+	_stream->seekg(offset, ios::beg);
+	if ( offset == size )
+		_stream->clear(ios::eofbit);
+
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSArchive::findStart(const string &fname, const Time &stime,
+                           long int size, bool bsearch, long int &offset) {
 	MSRecord *prec = nullptr;
 	MSFileParam *pfp = nullptr;
 	double samprate = 0.0;
 	Time physFirstStartTime, physFirstEndTime;
 	Time recstime, recetime;
-	Time stime = (_curidx->stime == Time())?_stime:_curidx->stime;
 	off_t fpos;
 	int retcode;
-	long int offset = 0;
-	long int size;
 	bool result = true;
 
-	_file.seekg(0, ios::end);
-	size = (long int)_file.tellg();
-	if ( size <= 0 )
-		return false;
+	offset = 0;
 
 	if ( bsearch ) {
 		//! binary search
@@ -731,10 +1418,6 @@ bool SDSArchive::setStart(const string &fname, bool bsearch) {
 	/* Cleanup memory and close file */
 	ms_readmsr_r(&pfp, &prec, nullptr, -1, nullptr, nullptr, 0, 0, 0);
 
-	_file.seekg(offset, ios::beg);
-	if ( offset == size )
-		_file.clear(ios::eofbit);
-
 	return result;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -746,12 +1429,15 @@ bool SDSArchive::setStart(const string &fname, bool bsearch) {
 Seiscomp::Record *SDSArchive::next() {
 	lock_guard<mutex> l(_mutex);
 
-	if ( _file.is_open() ) {
+	if ( _readAhead > 0 )
+		return nextPrefetched();
+
+	if ( _stream ) {
 		while ( !_closeRequested ) {
 			Seiscomp::IO::MSeedRecord *rec = new Seiscomp::IO::MSeedRecord(_dataType, _hint);
 
 			try {
-				rec->read(_file);
+				rec->read(*_stream);
 				if ( rec->startTime() > _curidx->etime ) {
 					delete rec;
 					break;
@@ -768,13 +1454,13 @@ Seiscomp::Record *SDSArchive::next() {
 			catch( exception &e ) {
 				// Invalid record, delete it
 				delete rec;
-				SEISCOMP_ERROR("exc: %d, %s", (int)_file.tellg(), e.what());
-				if ( !_file.good() )
+				SEISCOMP_ERROR("exc: %d, %s", (int)_stream->tellg(), e.what());
+				if ( !_stream->good() )
 					break;
 			}
 		}
 
-		_file.close();
+		closeFile();
 	}
 	else
 		_curiter = _orderedRequests.begin();
@@ -803,20 +1489,18 @@ Seiscomp::Record *SDSArchive::next() {
 				File file = _fnames.front();
 				_fnames.pop();
 
-				_file.open(file.first.c_str(), ifstream::in | ifstream::binary);
-				if ( !_file.is_open() ) {
+				if ( !openFile(file.first) ) {
 					SEISCOMP_DEBUG("R %s (not found)",file.first.c_str());
-					_file.clear();
 				}
 				else {
 					SEISCOMP_DEBUG("R %s (first: %d)",file.first.c_str(), file.second);
 					// File part of start time
-					if ( file.second ) {
+					if ( file.second && !setStartFromIndex(file.first) ) {
 						if ( !setStart(file.first, true) ) {
 							if ( !setStart(file.first, false) ) {
 								SEISCOMP_WARNING("Error reading file %s; start of time window maybe incorrect",
 								                 file.first.c_str());
-								_file.close();
+								closeFile();
 								continue;
 							}
 						}
@@ -825,7 +1509,7 @@ Seiscomp::Record *SDSArchive::next() {
 					while ( !_closeRequested ) {
 						Seiscomp::IO::MSeedRecord *rec = new Seiscomp::IO::MSeedRecord(_dataType, _hint);
 						try {
-							rec->read(_file);
+							rec->read(*_stream);
 							if ( rec->startTime() > _curidx->etime ) {
 								delete rec;
 								break;
@@ -841,16 +1525,276 @@ Seiscomp::Record *SDSArchive::next() {
 						}
 						catch( exception &e ) {
 							delete rec;
-							SEISCOMP_ERROR("exc: %d, %s", (int)_file.tellg(), e.what());
-							if ( !_file.good() )
+							SEISCOMP_ERROR("exc: %d, %s", (int)_stream->tellg(), e.what());
+							if ( !_stream->good() )
 								break;
 						}
 					}
 
-					_file.close();
+					closeFile();
+				}
+			}
+		}
+	}
+
+	SEISCOMP_DEBUG("[sds] end of data");
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t SDSArchive::nextBatch(std::vector<Seiscomp::Record*> &records, size_t max) {
+	size_t count = 0;
+
+	while ( count < max ) {
+		Seiscomp::Record *rec = next();
+		if ( !rec ) break;
+
+		records.push_back(rec);
+		++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSArchive::nextSegment(FileSegment &segment) {
+	lock_guard<mutex> l(_mutex);
+
+	if ( !_segmentsStarted ) {
+		_segmentsStarted = true;
+		_curiter = _orderedRequests.begin();
+	}
+
+	File file;
+	while ( !_closeRequested && nextFile(file) ) {
+		MappedFile mapping;
+		if ( !mapping.open(file.first) ) {
+			SEISCOMP_DEBUG("R %s (not found)", file.first.c_str());
+			continue;
+		}
+
+		RecordIndex index;
+		if ( !updateIndex(index, file.first, mapping.data, mapping.size,
+		                  mapping.mtime, _useIndex) ) {
+			SEISCOMP_WARNING("Error reading file %s; skipping it", file.first.c_str());
+			continue;
+		}
+
+		size_t offset = file.second ? index.find(toHPTime(_curidx->stime)) : 0;
+		size_t endOffset = index.findStop(offset, toHPTime(_curidx->etime));
+		if ( endOffset <= offset )
+			continue;
+
+		SEISCOMP_DEBUG("R %s (%zu-%zu)", file.first.c_str(), offset, endOffset);
+
+		segment.path = file.first;
+		segment.offset = offset;
+		segment.length = endOffset - offset;
+		return true;
+	}
+
+	SEISCOMP_DEBUG("[sds] end of data");
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSArchive::nextFile(File &file) {
+	while ( _fnames.empty() ) {
+		if ( _curiter == _orderedRequests.end() )
+			return false;
+
+		if ( _etime == Time() )
+			_etime = Time::GMT();
+
+		if ( (_curiter->stime == Time() && _stime == Time()) ) {
+			SEISCOMP_WARNING("... has invalid time window -> ignore this request above");
+			++_curiter;
+			continue;
+		}
+
+		_curidx = &*_curiter;
+		// Check start/end times and set globals if not set
+		if ( _curidx->stime == Time() ) _curidx->stime = _stime;
+		if ( _curidx->etime == Time() ) _curidx->etime = _etime;
+		++_curiter;
+		resolveRequest();
+	}
+
+	file = _fnames.front();
+	_fnames.pop();
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSArchive::schedulePrefetch() {
+	File file;
+	if ( !nextFile(file) )
+		return false;
+
+	PrefetchJobPtr job = make_shared<PrefetchJob>();
+	job->fname = file.first;
+	job->first = file.second;
+	job->stime = _curidx->stime;
+	job->etime = _curidx->etime;
+
+	_prefetchJobs.push_back(job);
+	_prefetcher->push(job);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SDSArchive::loadPrefetchJob(PrefetchJob &job) const {
+	size_t offset = 0;
+	size_t endOffset = 0;
+	bool located = false;
+
+	if ( _useIndex ) {
+		MappedFile mapping;
+		if ( mapping.open(job.fname) )
+			located = lookupIndex(job.fname, mapping,
+			                      job.first ? job.stime : Time(), job.etime,
+			                      offset, endOffset);
+	}
+
+	int fd = ::open(job.fname.c_str(), O_RDONLY);
+	if ( fd < 0 ) return;
+
+	struct stat st;
+	if ( fstat(fd, &st) != 0 ) {
+		::close(fd);
+		return;
+	}
+
+	job.found = true;
+
+	if ( !located ) {
+		endOffset = st.st_size;
+
+		if ( job.first && st.st_size > 0 ) {
+			long int start = 0;
+			if ( !findStart(job.fname, job.stime, st.st_size, true, start)
+			  && !findStart(job.fname, job.stime, st.st_size, false, start) ) {
+				SEISCOMP_WARNING("Error reading file %s; start of time window maybe incorrect",
+				                 job.fname.c_str());
+				job.found = false;
+				::close(fd);
+				return;
+			}
+
+			offset = start;
+		}
+	}
+
+	if ( endOffset > static_cast<size_t>(st.st_size) )
+		endOffset = st.st_size;
+	if ( offset > endOffset )
+		offset = endOffset;
+
+	job.data.resize(endOffset - offset);
+
+	size_t bytesRead = 0;
+	while ( bytesRead < job.data.size() ) {
+		ssize_t r = pread(fd, job.data.data() + bytesRead,
+		                  job.data.size() - bytesRead, offset + bytesRead);
+		if ( r < 0 && errno == EINTR ) continue;
+		if ( r <= 0 ) break;
+		bytesRead += r;
+	}
+
+	job.data.resize(bytesRead);
+	::close(fd);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Seiscomp::Record *SDSArchive::nextPrefetched() {
+	if ( !_prefetcher ) {
+		_prefetcher.reset(new Prefetcher(this, _readAhead));
+		_curiter = _orderedRequests.begin();
+	}
+
+	while ( !_closeRequested ) {
+		if ( _stream ) {
+			while ( !_closeRequested ) {
+				Seiscomp::IO::MSeedRecord *rec = new Seiscomp::IO::MSeedRecord(_dataType, _hint);
+
+				try {
+					rec->read(*_stream);
+					if ( rec->startTime() > _prefetchJob->etime ) {
+						delete rec;
+						break;
+					}
+
+					return rec;
+				}
+				catch ( EndOfStreamException &e ) {
+					// EOF for this file, do nothing
+					delete rec;
+					SEISCOMP_DEBUG("exc: %s", e.what());
+					break;
+				}
+				catch( exception &e ) {
+					// Invalid record, delete it
+					delete rec;
+					SEISCOMP_ERROR("exc: %d, %s", (int)_stream->tellg(), e.what());
+					if ( !_stream->good() )
+						break;
 				}
 			}
+
+			closeFile();
+		}
+
+		// Keep the configured number of files in flight
+		while ( _prefetchJobs.size() < _readAhead && schedulePrefetch() );
+
+		if ( _prefetchJobs.empty() )
+			break;
+
+		_prefetchJob = _prefetchJobs.front();
+		_prefetchJobs.pop_front();
+
+		// Replace the job which is about to be consumed
+		schedulePrefetch();
+
+		_prefetcher->wait(_prefetchJob);
+
+		if ( !_prefetchJob->found ) {
+			SEISCOMP_DEBUG("R %s (not found)", _prefetchJob->fname.c_str());
+			_prefetchJob.reset();
+			continue;
 		}
+
+		SEISCOMP_DEBUG("R %s (first: %d, %zu bytes prefetched)",
+		               _prefetchJob->fname.c_str(), _prefetchJob->first,
+		               _prefetchJob->data.size());
+
+		_prefetchJob->buffer.reset(_prefetchJob->data.data(), _prefetchJob->data.size());
+		_stream = &_prefetchJob->stream;
 	}
 
 	SEISCOMP_DEBUG("[sds] end of data");
@@ -26,12 +26,15 @@
 #include <sstream>
 #include <fstream>
 #include <queue>
+#include <deque>
 #include <list>
 #include <set>
+#include <memory>
 #include <mutex>
 
 #include <seiscomp/core/version.h>
 #include <seiscomp/io/recordstream.h>
+#include <seiscomp/io/recordstream/sdsavailability.h>
 
 
 namespace Seiscomp {
@@ -41,7 +44,46 @@ namespace RecordStream {
 DEFINE_SMARTPOINTER(SDS);
 
 
+/**
+ * @brief The SDSArchive class reads records from one or more SDS archives.
+ *
+ * The source is a comma separated list of archive roots which can be
+ * followed by options, e.g. "/archive1,/archive2?mmap&index".
+ *
+ * Supported options:
+ * - mmap: Maps the day files into memory and reads records from the mapping
+ *         rather than through a file stream.
+ * - index: Uses a sidecar index per day file to look up the record where
+ *          the requested time window starts. The index is stored as a
+ *          hidden file next to the day file (.[filename].idx), created
+ *          on first use and updated if the day file has grown. If it
+ *          cannot be written, the index is kept only for the read at hand.
+ * - readahead=N: Reads the next N day files in the order they are
+ *                delivered on a pool of N threads while the current one is
+ *                consumed. The order of the records is not affected.
+ * - availability: Uses the availability index of each archive root, see
+ *                 SDSAvailability, to skip day files which do not hold data
+ *                 for the requested time window without opening them. Day
+ *                 files which have changed since the index has been
+ *                 updated are read as usual.
+ *
+ * Instead of reading records, the byte ranges of the day files holding the
+ * requested records can be queried with nextSegment, e.g. to pass the raw
+ * miniSEED data on without decoding it.
+ */
 class SDSArchive : public Seiscomp::IO::RecordStream {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! A byte range of a day file
+		struct FileSegment {
+			std::string path;
+			size_t      offset;
+			size_t      length;
+		};
+
+
 	// ----------------------------------------------------------------------
 	//  Xstruction
 	// ----------------------------------------------------------------------
@@ -79,6 +121,22 @@ class SDSArchive : public Seiscomp::IO::RecordStream {
 
 		virtual Seiscomp::Record *next();
 
+		size_t nextBatch(std::vector<Seiscomp::Record*> &records, size_t max) override;
+
+		/**
+		 * @brief Returns the next byte range of a day file which contains
+		 *        the records of the requested streams and time windows.
+		 *
+		 * The range starts with the record that next() would return
+		 * first and ends before the record where next() would stop
+		 * reading the file. The records are not decoded, only their
+		 * headers are scanned or, with the index option, looked up in
+		 * the sidecar index. This function must not be mixed with next().
+		 * @param segment The output segment
+		 * @return false if there is no further data
+		 */
+		bool nextSegment(FileSegment &segment);
+
 
 	// ----------------------------------------------------------------------
 	//  Implementation
@@ -112,6 +170,13 @@ class SDSArchive : public Seiscomp::IO::RecordStream {
 		typedef std::pair<std::string,bool> File;
 		typedef std::queue<File> FileQueue;
 
+		struct MappedFile;
+		struct PrefetchJob;
+		class Prefetcher;
+
+		typedef std::shared_ptr<PrefetchJob> PrefetchJobPtr;
+		typedef std::deque<PrefetchJobPtr> PrefetchJobs;
+
 		std::vector<std::string>  _arcroots;
 		Seiscomp::Core::Time      _stime;
 		Seiscomp::Core::Time      _etime;
@@ -124,10 +189,40 @@ class SDSArchive : public Seiscomp::IO::RecordStream {
 		std::mutex                _mutex;
 		bool                      _closeRequested;
 		std::ifstream             _file;
+		std::unique_ptr<MappedFile> _mappedFile;
+		std::istream             *_stream{nullptr};
+		bool                      _useMMap{false};
+		bool                      _useIndex{false};
+		size_t                    _readAhead{0};
+		std::unique_ptr<Prefetcher> _prefetcher;
+		PrefetchJobs              _prefetchJobs;
+		PrefetchJobPtr            _prefetchJob;
+		bool                      _segmentsStarted{false};
+		bool                      _useAvailability{false};
+		std::vector<std::shared_ptr<const SDSAvailability>> _availability;
+		std::shared_ptr<const SDSAvailability> _curAvailability;
 
 		int getDoy(const Seiscomp::Core::Time &time);
 		void resolveRequest();
+		bool openFile(const std::string &fname);
+		void closeFile();
 		bool setStart(const std::string &fname, bool bsearch);
+		bool setStartFromIndex(const std::string &fname);
+		const SDSAvailability::DayFile *lookupAvailability(const std::string &fname) const;
+
+		Seiscomp::Record *nextPrefetched();
+		bool nextFile(File &file);
+		bool schedulePrefetch();
+		void loadPrefetchJob(PrefetchJob &job) const;
+
+		static bool findStart(const std::string &fname,
+		                      const Seiscomp::Core::Time &stime,
+		                      long int size, bool bsearch, long int &offset);
+		static bool lookupIndex(const std::string &fname,
+		                        const MappedFile &mapping,
+		                        const Seiscomp::Core::Time &stime,
+		                        const Seiscomp::Core::Time &etime,
+		                        size_t &offset, size_t &endOffset);
 
 		bool resolveNet(std::string &path,
 		                const std::string &net, const std::string &sta,
@@ -0,0 +1,602 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT SDS
+
+#include <sys/stat.h>
+#include <errno.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <libmseed.h>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/system.h>
+#include <seiscomp/datamodel/dataextent.h>
+#include <seiscomp/datamodel/datasegment.h>
+
+#include "sdsavailability.h"
+
+
+using namespace std;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace fs = boost::filesystem;
+
+
+namespace {
+
+
+struct Header {
+	char     magic[8];
+	uint32_t byteOrder;
+	uint32_t count;
+	int64_t  lastScan;
+};
+
+struct FileHeader {
+	uint32_t pathLength;
+	uint32_t segmentCount;
+	uint64_t size;
+	int64_t  mtime;
+	uint64_t scanned;
+	int64_t  updated;
+};
+
+struct SegmentRecord {
+	int64_t  start;
+	int64_t  end;
+	double   sampleRate;
+	uint32_t quality;
+	uint32_t reserved;
+};
+
+const char *Magic = "SCSDSAV1";
+const uint32_t ByteOrder = 0x01020304;
+
+
+int64_t toMicroseconds(const Time &time) {
+	return static_cast<int64_t>(time.seconds()) * 1000000 + time.microseconds();
+}
+
+
+Time fromMicroseconds(int64_t usecs) {
+	int64_t secs = usecs / 1000000;
+	usecs -= secs * 1000000;
+	if ( usecs < 0 ) {
+		--secs;
+		usecs += 1000000;
+	}
+
+	return Time(static_cast<long>(secs), static_cast<long>(usecs));
+}
+
+
+Time fromHPTime(hptime_t time) {
+	return fromMicroseconds(static_cast<int64_t>(time) * 1000000 / HPTMODULUS);
+}
+
+
+//! Returns whether b continues a within half a sample
+bool isContiguous(const SDSAvailability::Segment &a,
+                  const SDSAvailability::Segment &b) {
+	if ( a.sampleRate != b.sampleRate || a.quality != b.quality )
+		return false;
+
+	double tolerance = a.sampleRate > 0 ? 0.5 / a.sampleRate : 0;
+	return static_cast<double>(b.start - a.end) <= tolerance
+	    && b.end >= a.start;
+}
+
+
+void append(vector<SDSAvailability::Segment> &segments,
+            const SDSAvailability::Segment &segment) {
+	if ( !segments.empty() && isContiguous(segments.back(), segment) ) {
+		if ( segment.end > segments.back().end )
+			segments.back().end = segment.end;
+		return;
+	}
+
+	segments.push_back(segment);
+}
+
+
+vector<string> listDirectory(const string &dir, bool directories) {
+	vector<string> names;
+
+	try {
+		SC_FS_DECLARE_PATH(path, dir)
+		fs::directory_iterator it(path), end;
+		for ( ; it != end; ++it ) {
+			if ( directories ? !fs::is_directory(*it) : !fs::is_regular_file(*it) )
+				continue;
+
+			string name = SC_FS_FILE_NAME(SC_FS_DE_PATH(it));
+			if ( name.empty() || name[0] == '.' ) continue;
+			names.push_back(name);
+		}
+	}
+	catch ( ... ) {}
+
+	return names;
+}
+
+
+//! Splits a day file name NET.STA.LOC.CHA.D.YEAR.DOY into its stream codes
+bool parseFileName(const string &path, string codes[4]) {
+	size_t start = path.rfind('/');
+	start = start == string::npos ? 0 : start + 1;
+
+	for ( int i = 0; i < 4; ++i ) {
+		size_t p = path.find('.', start);
+		if ( p == string::npos ) return false;
+		codes[i] = path.substr(start, p - start);
+		start = p + 1;
+	}
+
+	return path.compare(start, 2, "D.") == 0;
+}
+
+
+}
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+const char *SDSAvailability::DefaultFile = ".availability";
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Time SDSAvailability::DayFile::start() const {
+	Time start;
+
+	for ( const Segment &segment : segments ) {
+		if ( !start.valid() || segment.start < start )
+			start = segment.start;
+	}
+
+	return start;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSAvailability::DayFile::overlaps(const Time &start, const Time &end) const {
+	for ( const Segment &segment : segments ) {
+		if ( (!end.valid() || segment.start <= end)
+		  && (!start.valid() || segment.end > start) )
+			return true;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SDSAvailability::SDSAvailability(const string &root) : _root(root) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+shared_ptr<const SDSAvailability> SDSAvailability::Open(const string &root) {
+	struct Entry {
+		shared_ptr<const SDSAvailability> index;
+		size_t                            size;
+		int64_t                           mtime;
+	};
+
+	static mutex cacheMutex;
+	static map<string, Entry> cache;
+
+	string fname = root + "/" + DefaultFile;
+	struct stat st;
+	bool exists = stat(fname.c_str(), &st) == 0;
+
+	lock_guard<mutex> l(cacheMutex);
+
+	if ( !exists ) {
+		cache.erase(root);
+		return nullptr;
+	}
+
+	Entry &entry = cache[root];
+	if ( entry.index && entry.size == static_cast<size_t>(st.st_size)
+	  && entry.mtime == st.st_mtime )
+		return entry.index;
+
+	shared_ptr<SDSAvailability> index = make_shared<SDSAvailability>(root);
+	if ( !index->load(fname) ) {
+		SEISCOMP_WARNING("%s: invalid availability index", fname.c_str());
+		cache.erase(root);
+		return nullptr;
+	}
+
+	entry.index = index;
+	entry.size = st.st_size;
+	entry.mtime = st.st_mtime;
+	return entry.index;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSAvailability::load(const string &fname) {
+	string indexFile = fname.empty() ? _root + "/" + DefaultFile : fname;
+	FILE *fp = fopen(indexFile.c_str(), "rb");
+	if ( !fp ) return false;
+
+	DayFiles files;
+	Header header;
+	bool ok = fread(&header, sizeof(header), 1, fp) == 1
+	       && !memcmp(header.magic, Magic, sizeof(header.magic))
+	       && header.byteOrder == ByteOrder;
+
+	for ( uint32_t i = 0; ok && i < header.count; ++i ) {
+		FileHeader fh;
+		if ( fread(&fh, sizeof(fh), 1, fp) != 1 ) {
+			ok = false;
+			break;
+		}
+
+		string path(fh.pathLength, '\0');
+		vector<SegmentRecord> records(fh.segmentCount);
+		if ( (fh.pathLength && fread(&path[0], 1, path.size(), fp) != path.size())
+		  || (fh.segmentCount && fread(records.data(), sizeof(SegmentRecord), records.size(), fp) != records.size()) ) {
+			ok = false;
+			break;
+		}
+
+		DayFile &file = files[path];
+		file.size = fh.size;
+		file.mtime = fh.mtime;
+		file.scanned = fh.scanned;
+		file.updated = fromMicroseconds(fh.updated);
+		file.segments.reserve(records.size());
+		for ( const SegmentRecord &rec : records ) {
+			Segment segment;
+			segment.start = fromMicroseconds(rec.start);
+			segment.end = fromMicroseconds(rec.end);
+			segment.sampleRate = rec.sampleRate;
+			segment.quality = static_cast<char>(rec.quality);
+			file.segments.push_back(segment);
+		}
+	}
+
+	fclose(fp);
+
+	if ( !ok ) return false;
+
+	_files.swap(files);
+	_lastScan = fromMicroseconds(header.lastScan);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSAvailability::save(const string &fname) const {
+	string indexFile = fname.empty() ? _root + "/" + DefaultFile : fname;
+	string tmp = indexFile + "." + toString(getpid()) + ".tmp";
+	FILE *fp = fopen(tmp.c_str(), "wb");
+	if ( !fp ) return false;
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, Magic, sizeof(header.magic));
+	header.byteOrder = ByteOrder;
+	header.count = static_cast<uint32_t>(_files.size());
+	header.lastScan = toMicroseconds(_lastScan);
+
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+	vector<SegmentRecord> records;
+	for ( auto it = _files.begin(); ok && it != _files.end(); ++it ) {
+		const DayFile &file = it->second;
+
+		FileHeader fh;
+		memset(&fh, 0, sizeof(fh));
+		fh.pathLength = static_cast<uint32_t>(it->first.size());
+		fh.segmentCount = static_cast<uint32_t>(file.segments.size());
+		fh.size = file.size;
+		fh.mtime = file.mtime;
+		fh.scanned = file.scanned;
+		fh.updated = toMicroseconds(file.updated);
+
+		records.resize(file.segments.size());
+		for ( size_t i = 0; i < records.size(); ++i ) {
+			const Segment &segment = file.segments[i];
+			records[i].start = toMicroseconds(segment.start);
+			records[i].end = toMicroseconds(segment.end);
+			records[i].sampleRate = segment.sampleRate;
+			records[i].quality = static_cast<uint32_t>(segment.quality);
+			records[i].reserved = 0;
+		}
+
+		ok = fwrite(&fh, sizeof(fh), 1, fp) == 1
+		  && fwrite(it->first.data(), 1, it->first.size(), fp) == it->first.size()
+		  && (records.empty()
+		   || fwrite(records.data(), sizeof(SegmentRecord), records.size(), fp) == records.size());
+	}
+
+	ok = (fclose(fp) == 0) && ok;
+
+	// Replace the index atomically to not confuse concurrent readers
+	if ( !ok || rename(tmp.c_str(), indexFile.c_str()) != 0 ) {
+		unlink(tmp.c_str());
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t SDSAvailability::update() {
+	DayFiles files;
+	size_t changed = 0;
+
+	// Layout: YEAR/NET/STA/CHA.D/NET.STA.LOC.CHA.D.YEAR.DOY
+	for ( const string &year : listDirectory(_root, true) ) {
+		string yearPath = year + "/";
+		for ( const string &net : listDirectory(_root + "/" + yearPath, true) ) {
+			string netPath = yearPath + net + "/";
+			for ( const string &sta : listDirectory(_root + "/" + netPath, true) ) {
+				string staPath = netPath + sta + "/";
+				for ( const string &cha : listDirectory(_root + "/" + staPath, true) ) {
+					string chaPath = staPath + cha + "/";
+					for ( const string &name : listDirectory(_root + "/" + chaPath, false) ) {
+						string path = chaPath + name;
+						string codes[4];
+						if ( !parseFileName(name, codes) ) continue;
+
+						struct stat st;
+						if ( stat((_root + "/" + path).c_str(), &st) != 0 )
+							continue;
+
+						DayFile &file = files[path];
+						auto it = _files.find(path);
+						if ( it != _files.end() )
+							file = move(it->second);
+
+						size_t size = static_cast<size_t>(st.st_size);
+						if ( file.size == size && file.mtime == st.st_mtime )
+							continue;
+
+						// Only appended records are scanned. Otherwise the
+						// file is scanned from the beginning.
+						if ( size <= file.size ) {
+							file.scanned = 0;
+							file.segments.clear();
+						}
+
+						file.size = size;
+						file.mtime = st.st_mtime;
+
+						if ( !scan(path, file) )
+							SEISCOMP_WARNING("%s/%s: cannot scan records",
+							                 _root.c_str(), path.c_str());
+
+						file.updated = Time::GMT();
+						++changed;
+					}
+				}
+			}
+		}
+	}
+
+	// Count the files which have been removed
+	for ( const auto &item : _files ) {
+		if ( files.find(item.first) == files.end() )
+			++changed;
+	}
+
+	_files.swap(files);
+	_lastScan = Time::GMT();
+	return changed;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SDSAvailability::scan(const string &path, DayFile &file) const {
+	string fname = _root + "/" + path;
+	FILE *fp = fopen(fname.c_str(), "rb");
+	if ( !fp ) return false;
+
+	vector<char> data;
+	if ( file.scanned < file.size && fseeko(fp, file.scanned, SEEK_SET) == 0 ) {
+		data.resize(file.size - file.scanned);
+		data.resize(fread(data.data(), 1, data.size(), fp));
+	}
+
+	fclose(fp);
+
+	MSRecord *prec = nullptr;
+	size_t offset = 0;
+	bool result = true;
+
+	while ( offset + MINRECLEN <= data.size() ) {
+		const char *rec = data.data() + offset;
+		int reclen = ms_detect(rec, static_cast<int>(min<size_t>(data.size() - offset, MAXRECLEN)));
+
+		if ( reclen < 0 ) {
+			// No record header, skip over to the next block
+			offset += 64;
+			continue;
+		}
+
+		// Either a truncated record at the end of a growing file or a
+		// record without blockette 1000
+		if ( reclen == 0 ) {
+			result = offset + MAXRECLEN <= data.size() ? false : result;
+			break;
+		}
+
+		if ( offset + reclen > data.size() ) break;
+
+		if ( msr_unpack(const_cast<char*>(rec), reclen, &prec, 0, 0) == MS_NOERROR ) {
+			Segment segment;
+			segment.start = fromHPTime(prec->starttime);
+			segment.sampleRate = prec->samprate;
+			segment.quality = prec->dataquality ? prec->dataquality : 'D';
+			if ( prec->samprate > 0 )
+				segment.end = fromHPTime(prec->starttime + static_cast<hptime_t>(prec->samplecnt / prec->samprate * HPTMODULUS));
+			else
+				segment.end = segment.start;
+
+			append(file.segments, segment);
+		}
+
+		offset += reclen;
+	}
+
+	msr_free(&prec);
+	file.scanned += offset;
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const SDSAvailability::DayFile *
+SDSAvailability::find(const string &path, size_t size, int64_t mtime) const {
+	auto it = _files.find(path);
+	if ( it == _files.end() || it->second.size != size || it->second.mtime != mtime )
+		return nullptr;
+
+	return &it->second;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DataModel::DataAvailabilityPtr
+SDSAvailability::dataAvailability(const vector<string> &patterns) const {
+	struct Stream {
+		vector<Segment> segments;
+		Time            updated;
+	};
+
+	map<string, Stream> streams;
+	map<string, DataModel::WaveformStreamID> ids;
+
+	for ( const auto &item : _files ) {
+		string codes[4];
+		if ( !parseFileName(item.first, codes) ) continue;
+
+		string id = codes[0] + "." + codes[1] + "." + codes[2] + "." + codes[3];
+		if ( !patterns.empty()
+		  && none_of(patterns.begin(), patterns.end(),
+		             [&id](const string &pattern) { return wildcmp(pattern, id); }) )
+			continue;
+
+		Stream &stream = streams[id];
+		stream.segments.insert(stream.segments.end(),
+		                       item.second.segments.begin(),
+		                       item.second.segments.end());
+		if ( !stream.updated.valid() || item.second.updated > stream.updated )
+			stream.updated = item.second.updated;
+
+		if ( ids.find(id) == ids.end() )
+			ids[id] = DataModel::WaveformStreamID(codes[0], codes[1], codes[2], codes[3], "");
+	}
+
+	// The extents are not registered to not collide with other instances
+	bool registrationEnabled = DataModel::PublicObject::IsRegistrationEnabled();
+	DataModel::PublicObject::SetRegistrationEnabled(false);
+
+	DataModel::DataAvailabilityPtr availability = new DataModel::DataAvailability;
+
+	for ( auto &item : streams ) {
+		vector<Segment> &segments = item.second.segments;
+		if ( segments.empty() ) continue;
+
+		sort(segments.begin(), segments.end(),
+		     [](const Segment &a, const Segment &b) { return a.start < b.start; });
+
+		vector<Segment> merged;
+		for ( const Segment &segment : segments )
+			append(merged, segment);
+
+		DataModel::DataExtentPtr extent = new DataModel::DataExtent("DataExtent/" + item.first);
+		extent->setWaveformID(ids[item.first]);
+		extent->setStart(merged.front().start);
+		extent->setEnd(merged.front().end);
+		extent->setUpdated(item.second.updated);
+		extent->setLastScan(_lastScan);
+		extent->setSegmentOverflow(false);
+
+		for ( const Segment &segment : merged ) {
+			if ( segment.end > extent->end() )
+				extent->setEnd(segment.end);
+
+			DataModel::DataSegmentPtr seg = new DataModel::DataSegment;
+			seg->setStart(segment.start);
+			seg->setEnd(segment.end);
+			seg->setUpdated(item.second.updated);
+			seg->setSampleRate(segment.sampleRate);
+			seg->setQuality(string(1, segment.quality));
+			seg->setOutOfOrder(false);
+			extent->add(seg.get());
+		}
+
+		availability->add(extent.get());
+	}
+
+	DataModel::PublicObject::SetRegistrationEnabled(registrationEnabled);
+
+	return availability;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
@@ -0,0 +1,160 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDSTREAM_SDSAVAILABILITY_H
+#define SEISCOMP_IO_RECORDSTREAM_SDSAVAILABILITY_H
+
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/datamodel/dataavailability.h>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+/**
+ * @brief The SDSAvailability class holds the contiguous data segments of
+ *        all day files of an SDS archive root.
+ *
+ * The index is stored in the file .availability in the archive root. It
+ * is brought up to date with update() which only scans day files which are
+ * new or have changed. If records have been appended to a day file, only
+ * the appended part is scanned.
+ *
+ * The SDSArchive uses the index with the availability option to skip day
+ * files which do not hold data for the requested time window.
+ */
+class SDSAvailability {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! A contiguous time span of records with the same sample rate
+		//! and quality
+		struct Segment {
+			Core::Time start;
+			Core::Time end;
+			double     sampleRate{0};
+			char       quality{'D'};
+		};
+
+		//! The scanned part of a day file
+		struct DayFile {
+			size_t               size{0};
+			int64_t              mtime{0};
+			size_t               scanned{0};
+			//! The time when the segments have been changed the last time
+			Core::Time           updated;
+			std::vector<Segment> segments;
+
+			//! Returns the start time of the first record or an invalid
+			//! time if the file does not hold any record
+			Core::Time start() const;
+
+			//! Returns whether any segment overlaps the given time window
+			bool overlaps(const Core::Time &start, const Core::Time &end) const;
+		};
+
+		//! The day files keyed by their path relative to the root
+		typedef std::map<std::string, DayFile> DayFiles;
+
+		static const char *DefaultFile;
+
+
+	// ----------------------------------------------------------------------
+	//  Xstruction
+	// ----------------------------------------------------------------------
+	public:
+		explicit SDSAvailability(const std::string &root);
+
+
+	// ----------------------------------------------------------------------
+	//  Public Interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Returns the shared index of an archive root. The index
+		 *        is loaded from its default file and reloaded if the file
+		 *        has been changed since.
+		 * @return The index or nullptr if it has not been created yet
+		 */
+		static std::shared_ptr<const SDSAvailability> Open(const std::string &root);
+
+		const std::string &root() const { return _root; }
+		const DayFiles &files() const { return _files; }
+		const Core::Time &lastScan() const { return _lastScan; }
+
+		//! Loads the index from a file, the default file if empty
+		bool load(const std::string &fname = "");
+
+		//! Saves the index atomically to a file, the default file if empty
+		bool save(const std::string &fname = "") const;
+
+		/**
+		 * @brief Scans all day files of the archive root which are not
+		 *        indexed or have changed and drops files which do not
+		 *        exist anymore.
+		 * @return The number of day files which have been changed
+		 */
+		size_t update();
+
+		/**
+		 * @brief Looks up a day file.
+		 * @param path The path relative to the root
+		 * @param size The current size of the file
+		 * @param mtime The current modification time of the file
+		 * @return The file or nullptr if it is not indexed or has changed
+		 */
+		const DayFile *find(const std::string &path, size_t size,
+		                    int64_t mtime) const;
+
+		/**
+		 * @brief Creates the data extents of the indexed streams.
+		 *        Contiguous segments of subsequent day files are merged.
+		 * @param patterns Stream IDs (NET.STA.LOC.CHA) with wildcards. If
+		 *                 empty, all streams are returned.
+		 */
+		DataModel::DataAvailabilityPtr
+		dataAvailability(const std::vector<std::string> &patterns = {}) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		bool scan(const std::string &path, DayFile &file) const;
+
+		std::string _root;
+		DayFiles    _files;
+		Core::Time  _lastScan;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,779 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT SharedMemory
+
+#include <seiscomp/io/recordstream/shm.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/logging/log.h>
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+/*
+ * Segment layout
+ *
+ * The segment starts with the header followed by the ring buffer of
+ * capacity bytes. Head and tail are monotonic byte positions, the offset
+ * into the ring buffer is the position modulo capacity. Each entry starts
+ * with an EntryHeader and is aligned to 8 bytes. An entry never wraps
+ * around, the remaining space at the end of the ring is filled with a
+ * padding entry instead.
+ *
+ * The writer first advances the tail behind all entries which are about to
+ * be overwritten, then writes the entry and finally advances the head.
+ * A reader copies an entry and checks afterwards whether the tail has
+ * passed its position in the mean time. In that case the copy is discarded.
+ */
+struct SharedMemoryHeader {
+	char                  magic[8];
+	std::atomic<uint32_t> version;
+	uint32_t              headerSize;
+	uint64_t              capacity;
+	std::atomic<uint64_t> head;
+	std::atomic<uint64_t> tail;
+};
+
+
+}
+}
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::RecordStream;
+
+
+namespace {
+
+
+const char     Magic[8] = {'S','C','S','H','M','R','E','C'};
+const uint32_t Version = 1;
+const size_t   HeaderSize = 64;
+const size_t   MinCapacity = 1 << 16;
+
+enum EntryType {
+	Padding = 0,
+	RecordEntry = 1
+};
+
+struct EntryHeader {
+	uint32_t size;
+	uint32_t type;
+};
+
+struct RecordHeader {
+	char     networkCode[16];
+	char     stationCode[16];
+	char     locationCode[16];
+	char     channelCode[16];
+	int64_t  startSeconds;
+	int32_t  startMicroseconds;
+	int32_t  timingQuality;
+	double   samplingFrequency;
+	int32_t  sampleCount;
+	uint8_t  dataType;
+	uint8_t  authentication;
+	uint16_t reserved;
+};
+
+
+static_assert(sizeof(SharedMemoryHeader) <= HeaderSize,
+              "Shared memory header exceeds the reserved size");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory positions must be lock free");
+static_assert(sizeof(EntryHeader) % 8 == 0, "EntryHeader is not aligned");
+static_assert(sizeof(RecordHeader) % 8 == 0, "RecordHeader is not aligned");
+
+
+inline uint64_t align(uint64_t size) {
+	return (size + 7) & ~uint64_t(7);
+}
+
+
+inline std::string segmentPath(const std::string &name) {
+	return "/" + name;
+}
+
+
+bool setCode(char (&target)[16], const std::string &code) {
+	if ( code.size() >= sizeof(target) ) {
+		return false;
+	}
+
+	memset(target, 0, sizeof(target));
+	memcpy(target, code.data(), code.size());
+	return true;
+}
+
+
+std::string getCode(const char (&source)[16]) {
+	return std::string(source, strnlen(source, sizeof(source)));
+}
+
+
+bool isSupported(Array::DataType dt) {
+	switch ( dt ) {
+		case Array::CHAR:
+		case Array::INT:
+		case Array::FLOAT:
+		case Array::DOUBLE:
+			return true;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+
+int elementSize(Array::DataType dt) {
+	switch ( dt ) {
+		case Array::CHAR:
+			return 1;
+		case Array::INT:
+		case Array::FLOAT:
+			return 4;
+		case Array::DOUBLE:
+			return 8;
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+
+}
+
+
+IMPLEMENT_SC_CLASS_DERIVED(SharedMemory,
+                           Seiscomp::IO::RecordStream,
+                           "SharedMemory");
+
+REGISTER_RECORDSTREAM(SharedMemory, "shm");
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedMemoryPublisher::~SharedMemoryPublisher() {
+	close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryPublisher::open(const std::string &name, size_t capacity) {
+	close();
+
+	if ( name.empty() || name.find('/') != std::string::npos ) {
+		SEISCOMP_ERROR("Invalid shared memory segment name: '%s'", name.c_str());
+		return false;
+	}
+
+	capacity = std::max(capacity, MinCapacity) & ~size_t(7);
+
+	auto path = segmentPath(name);
+
+	// Replace a segment of a previous run, attached readers check the
+	// inode and switch to the new segment.
+	shm_unlink(path.c_str());
+
+	int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if ( fd < 0 ) {
+		SEISCOMP_ERROR("Failed to create shared memory segment %s: %s",
+		               path.c_str(), strerror(errno));
+		return false;
+	}
+
+	size_t size = HeaderSize + capacity;
+	if ( ftruncate(fd, static_cast<off_t>(size)) < 0 ) {
+		SEISCOMP_ERROR("Failed to resize shared memory segment %s: %s",
+		               path.c_str(), strerror(errno));
+		::close(fd);
+		shm_unlink(path.c_str());
+		return false;
+	}
+
+	void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if ( mem == MAP_FAILED ) {
+		SEISCOMP_ERROR("Failed to map shared memory segment %s: %s",
+		               path.c_str(), strerror(errno));
+		shm_unlink(path.c_str());
+		return false;
+	}
+
+	_header = new (mem) SharedMemoryHeader;
+	memcpy(_header->magic, Magic, sizeof(Magic));
+	_header->headerSize = HeaderSize;
+	_header->capacity = capacity;
+	_header->head.store(0, std::memory_order_relaxed);
+	_header->tail.store(0, std::memory_order_relaxed);
+	// Readers check the version last
+	_header->version.store(Version, std::memory_order_release);
+
+	_data = static_cast<char*>(mem) + HeaderSize;
+	_mappedSize = size;
+	_name = name;
+
+	SEISCOMP_INFO("Publishing records to shared memory segment %s with %zu bytes",
+	              path.c_str(), capacity);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedMemoryPublisher::close() {
+	if ( !_header ) {
+		return;
+	}
+
+	munmap(_header, _mappedSize);
+	_header = nullptr;
+	_data = nullptr;
+	_mappedSize = 0;
+	_name.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryPublisher::publish(const Record *rec) {
+	if ( !_header ) {
+		return false;
+	}
+
+	const Array *data = rec->data();
+	if ( !data || !isSupported(data->dataType()) ) {
+		return false;
+	}
+
+	RecordHeader rh;
+	if ( !setCode(rh.networkCode, rec->networkCode())
+	  || !setCode(rh.stationCode, rec->stationCode())
+	  || !setCode(rh.locationCode, rec->locationCode())
+	  || !setCode(rh.channelCode, rec->channelCode()) ) {
+		return false;
+	}
+
+	rh.startSeconds = rec->startTime().seconds();
+	rh.startMicroseconds = static_cast<int32_t>(rec->startTime().microseconds());
+	rh.timingQuality = rec->timingQuality();
+	rh.samplingFrequency = rec->samplingFrequency();
+	rh.sampleCount = data->size();
+	rh.dataType = static_cast<uint8_t>(data->dataType());
+	rh.authentication = static_cast<uint8_t>(rec->authentication());
+	rh.reserved = 0;
+
+	size_t bytes = static_cast<size_t>(rh.sampleCount) * static_cast<size_t>(data->elementSize());
+	uint64_t capacity = _header->capacity;
+	uint64_t need = align(sizeof(EntryHeader) + sizeof(RecordHeader) + bytes);
+
+	// Do not let a single record flush most of the ring
+	if ( need > capacity / 4 ) {
+		SEISCOMP_DEBUG("%s: record with %zu bytes exceeds shared memory limit",
+		               rec->streamID().c_str(), static_cast<size_t>(need));
+		return false;
+	}
+
+	uint64_t head = _header->head.load(std::memory_order_relaxed);
+	uint64_t tail = _header->tail.load(std::memory_order_relaxed);
+	uint64_t offset = head % capacity;
+	uint64_t padding = offset + need > capacity ? capacity - offset : 0;
+	uint64_t end = head + padding + need;
+
+	if ( end - tail > capacity ) {
+		while ( end - tail > capacity ) {
+			auto eh = reinterpret_cast<const EntryHeader*>(_data + tail % capacity);
+			tail += eh->size;
+		}
+
+		// Publish the new tail before the old entries are overwritten
+		_header->tail.store(tail, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	if ( padding ) {
+		EntryHeader eh{static_cast<uint32_t>(padding), Padding};
+		memcpy(_data + offset, &eh, sizeof(eh));
+		offset = 0;
+	}
+
+	EntryHeader eh{static_cast<uint32_t>(need), RecordEntry};
+	char *entry = _data + offset;
+	memcpy(entry, &eh, sizeof(eh));
+	memcpy(entry + sizeof(eh), &rh, sizeof(rh));
+	if ( bytes ) {
+		memcpy(entry + sizeof(eh) + sizeof(rh), data->data(), bytes);
+	}
+
+	_header->head.store(end, std::memory_order_release);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedMemory::SharedMemory() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedMemory::~SharedMemory() {
+	detach();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::setSource(const std::string &source) {
+	detach();
+
+	_name = source;
+	while ( !_name.empty() && _name[0] == '/' ) {
+		_name.erase(0, 1);
+	}
+
+	if ( _name.empty() || _name.find('/') != std::string::npos ) {
+		SEISCOMP_ERROR("Invalid shared memory segment name: '%s'", source.c_str());
+		_name.clear();
+		return false;
+	}
+
+	if ( !attach() ) {
+		SEISCOMP_WARNING("Shared memory segment %s is not yet available, waiting "
+		                 "for the publisher", segmentPath(_name).c_str());
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::addStream(const std::string &net, const std::string &sta,
+                             const std::string &loc, const std::string &cha) {
+	auto id = net + "." + sta + "." + loc + "." + cha;
+	if ( id.find_first_of("*?") == std::string::npos ) {
+		_filter.emplace(id, TimeWindowFilter());
+	}
+	else {
+		_reMatcher.add(id);
+		_reFilter.emplace_back();
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::addStream(const std::string &net, const std::string &sta,
+                             const std::string &loc, const std::string &cha,
+                             const Seiscomp::Core::Time &startTime,
+                             const Seiscomp::Core::Time &endTime) {
+	auto id = net + "." + sta + "." + loc + "." + cha;
+	if ( id.find_first_of("*?") == std::string::npos ) {
+		_filter.emplace(id, TimeWindowFilter(startTime, endTime));
+	}
+	else {
+		_reMatcher.add(id);
+		_reFilter.emplace_back(startTime, endTime);
+	}
+
+	if ( startTime.valid() ) {
+		_hasTimeFilter = true;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::setStartTime(const Seiscomp::Core::Time &startTime) {
+	_startTime = startTime;
+	if ( _startTime.valid() ) {
+		_hasTimeFilter = true;
+	}
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::setEndTime(const Seiscomp::Core::Time &endTime) {
+	_endTime = endTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::setTimeout(int seconds) {
+	_timeout = seconds;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedMemory::close() {
+	_closeRequested = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::attach() {
+	int fd = shm_open(segmentPath(_name).c_str(), O_RDONLY, 0);
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	struct stat st;
+	if ( fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < HeaderSize ) {
+		::close(fd);
+		return false;
+	}
+
+	size_t size = static_cast<size_t>(st.st_size);
+	void *mem = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if ( mem == MAP_FAILED ) {
+		SEISCOMP_ERROR("Failed to map shared memory segment %s: %s",
+		               segmentPath(_name).c_str(), strerror(errno));
+		return false;
+	}
+
+	auto header = static_cast<SharedMemoryHeader*>(mem);
+	if ( header->version.load(std::memory_order_acquire) != Version
+	  || memcmp(header->magic, Magic, sizeof(Magic))
+	  || header->headerSize != HeaderSize
+	  || HeaderSize + header->capacity > size ) {
+		munmap(mem, size);
+		return false;
+	}
+
+	_header = header;
+	_data = static_cast<const char*>(mem) + HeaderSize;
+	_mappedSize = size;
+	_inode = static_cast<uint64_t>(st.st_ino);
+	_started = false;
+
+	SEISCOMP_DEBUG("Attached to shared memory segment %s",
+	               segmentPath(_name).c_str());
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedMemory::detach() {
+	if ( !_header ) {
+		return;
+	}
+
+	munmap(_header, _mappedSize);
+	_header = nullptr;
+	_data = nullptr;
+	_mappedSize = 0;
+	_inode = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::replaced() const {
+	int fd = shm_open(segmentPath(_name).c_str(), O_RDONLY, 0);
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	struct stat st;
+	bool res = fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_ino) != _inode;
+	::close(fd);
+	return res;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemory::accept(const Record *rec) {
+	const TimeWindowFilter *twf = nullptr;
+
+	if ( !_filter.empty() || !_reFilter.empty() ) {
+		auto streamID = rec->streamID();
+		auto it = _filter.find(streamID);
+		if ( it != _filter.end() ) {
+			twf = &it->second;
+		}
+		else {
+			int index = _reMatcher.match(streamID);
+			if ( index < 0 ) {
+				return false;
+			}
+
+			// Resolve the next record of this stream without matching
+			// the wildcards again
+			twf = &_filter.emplace(streamID, _reFilter[index]).first->second;
+		}
+	}
+
+	const Core::Time &start = twf && twf->start.valid() ? twf->start : _startTime;
+	const Core::Time &end = twf && twf->end.valid() ? twf->end : _endTime;
+
+	if ( start.valid() && rec->endTime() <= start ) {
+		return false;
+	}
+
+	if ( end.valid() && rec->startTime() >= end ) {
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *SharedMemory::read(size_t offset, uint32_t size) {
+	RecordHeader rh;
+
+	if ( size < sizeof(EntryHeader) + sizeof(rh) ) {
+		return nullptr;
+	}
+
+	const char *entry = _data + offset + sizeof(EntryHeader);
+	memcpy(&rh, entry, sizeof(rh));
+
+	auto dt = static_cast<Array::DataType>(rh.dataType);
+	if ( !isSupported(dt) || rh.sampleCount < 0 || rh.samplingFrequency <= 0 ) {
+		return nullptr;
+	}
+
+	size_t bytes = static_cast<size_t>(rh.sampleCount) * static_cast<size_t>(elementSize(dt));
+	if ( sizeof(EntryHeader) + sizeof(rh) + bytes > size ) {
+		return nullptr;
+	}
+
+	// Force termination of the codes if the entry has been torn
+	rh.networkCode[sizeof(rh.networkCode)-1] = '\0';
+	rh.stationCode[sizeof(rh.stationCode)-1] = '\0';
+	rh.locationCode[sizeof(rh.locationCode)-1] = '\0';
+	rh.channelCode[sizeof(rh.channelCode)-1] = '\0';
+
+	GenericRecord *rec = new GenericRecord(
+		getCode(rh.networkCode), getCode(rh.stationCode),
+		getCode(rh.locationCode), getCode(rh.channelCode),
+		Core::Time(rh.startSeconds, rh.startMicroseconds),
+		rh.samplingFrequency, rh.timingQuality,
+		_dataType, _hint
+	);
+
+	rec->setAuthentication(static_cast<Record::Authentication>(rh.authentication));
+	rec->setData(rh.sampleCount, entry + sizeof(rh), dt);
+
+	return rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *SharedMemory::next() {
+	using namespace std::chrono;
+
+	const auto pollInterval = milliseconds(10);
+	const auto checkInterval = seconds(1);
+
+	auto idleSince = steady_clock::now();
+	auto lastCheck = idleSince;
+
+	while ( !_closeRequested ) {
+		if ( !_header ) {
+			if ( _name.empty() || !attach() ) {
+				if ( _timeout > 0 && steady_clock::now() - idleSince >= seconds(_timeout) ) {
+					SEISCOMP_WARNING("Timeout while waiting for shared memory segment %s",
+					                 segmentPath(_name).c_str());
+					return nullptr;
+				}
+
+				std::this_thread::sleep_for(milliseconds(100));
+				continue;
+			}
+		}
+
+		if ( !_started ) {
+			// Time windows require the buffered records, otherwise
+			// start with the records published from now on
+			_pos = _hasTimeFilter ?
+				_header->tail.load(std::memory_order_acquire) :
+				_header->head.load(std::memory_order_acquire);
+			_started = true;
+		}
+
+		uint64_t head = _header->head.load(std::memory_order_acquire);
+		if ( _pos >= head ) {
+			auto now = steady_clock::now();
+
+			if ( now - lastCheck >= checkInterval ) {
+				lastCheck = now;
+				if ( replaced() ) {
+					SEISCOMP_INFO("Shared memory segment %s has been recreated, reattaching",
+					              segmentPath(_name).c_str());
+					detach();
+					if ( attach() ) {
+						// All records of the new segment are new
+						_pos = _header->tail.load(std::memory_order_acquire);
+						_started = true;
+					}
+					continue;
+				}
+			}
+
+			if ( _timeout > 0 && now - idleSince >= seconds(_timeout) ) {
+				SEISCOMP_WARNING("Timeout while reading from shared memory segment %s",
+				                 segmentPath(_name).c_str());
+				return nullptr;
+			}
+
+			std::this_thread::sleep_for(pollInterval);
+			continue;
+		}
+
+		uint64_t tail = _header->tail.load(std::memory_order_acquire);
+		if ( _pos < tail ) {
+			SEISCOMP_WARNING("Reader of shared memory segment %s is too slow, "
+			                 "skipped %llu bytes", segmentPath(_name).c_str(),
+			                 static_cast<unsigned long long>(tail - _pos));
+			_pos = tail;
+			continue;
+		}
+
+		uint64_t capacity = _header->capacity;
+		size_t offset = static_cast<size_t>(_pos % capacity);
+		EntryHeader eh;
+		memcpy(&eh, _data + offset, sizeof(eh));
+
+		bool valid = eh.size >= sizeof(eh) && eh.size % 8 == 0
+		          && offset + eh.size <= capacity;
+
+		Record *rec = nullptr;
+		if ( valid && eh.type == RecordEntry ) {
+			rec = read(offset, eh.size);
+		}
+
+		// Discard everything which has been overwritten while reading
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if ( _header->tail.load(std::memory_order_relaxed) > _pos ) {
+			delete rec;
+			continue;
+		}
+
+		if ( !valid ) {
+			SEISCOMP_ERROR("Invalid entry in shared memory segment %s, skipping "
+			               "to the latest record", segmentPath(_name).c_str());
+			_pos = head;
+			continue;
+		}
+
+		_pos += eh.size;
+		idleSince = steady_clock::now();
+
+		if ( !rec ) {
+			continue;
+		}
+
+		if ( !accept(rec) ) {
+			delete rec;
+			continue;
+		}
+
+		return rec;
+	}
+
+	_closeRequested = false;
+	_started = false;
+	_filter.clear();
+	_reFilter.clear();
+	_reMatcher.clear();
+	detach();
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
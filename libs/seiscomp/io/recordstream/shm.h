@@ -0,0 +1,199 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_RECORDSTREAM_SHM_H
+#define SEISCOMP_RECORDSTREAM_SHM_H
+
+
+#include <seiscomp/io/recordstream.h>
+#include <seiscomp/utils/wildcardmatcher.h>
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+//! The header of a shared memory segment, defined in shm.cpp
+struct SharedMemoryHeader;
+
+
+/**
+ * @brief Writes records into a POSIX shared memory ring buffer.
+ *
+ * The segment is created by the publisher and holds the record headers
+ * together with the decoded samples. Co-located processes read the
+ * published records with the SharedMemory record stream (shm://name)
+ * without requesting the same streams from the upstream server again.
+ * There is exactly one publisher per segment. If the ring is full then the
+ * oldest records are overwritten, readers which are too slow will skip them.
+ */
+class SC_SYSTEM_CORE_API SharedMemoryPublisher {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		SharedMemoryPublisher() = default;
+		SharedMemoryPublisher(const SharedMemoryPublisher &) = delete;
+		SharedMemoryPublisher &operator=(const SharedMemoryPublisher &) = delete;
+		~SharedMemoryPublisher();
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Creates the segment. An existing segment with the same
+		 *        name is replaced, attached readers detect that and
+		 *        attach to the new segment.
+		 * @param name The segment name without leading slash
+		 * @param capacity The size of the ring buffer in bytes
+		 * @return Success flag
+		 */
+		bool open(const std::string &name, size_t capacity);
+
+		//! Unmaps the segment. The segment itself is not removed to let
+		//! readers fetch the records which are still buffered.
+		void close();
+
+		bool isOpen() const { return _header != nullptr; }
+
+		/**
+		 * @brief Publishes a record. Records without data or with an
+		 *        unsupported sample type are ignored.
+		 * @param rec The record
+		 * @return Whether the record has been written
+		 */
+		bool publish(const Record *rec);
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		SharedMemoryHeader *_header{nullptr};
+		char               *_data{nullptr};
+		size_t              _mappedSize{0};
+		std::string         _name;
+};
+
+
+DEFINE_SMARTPOINTER(SharedMemory);
+
+/**
+ * @brief Reads records from a shared memory segment which is filled by a
+ *        SharedMemoryPublisher, e.g. a StreamApplication which has been
+ *        configured with recordstream.publish.
+ *
+ * Without a start time only records which are published after the stream
+ * has been opened are returned. With a start time reading starts at the
+ * oldest record of the ring buffer.
+ */
+class SC_SYSTEM_CORE_API SharedMemory : public Seiscomp::IO::RecordStream {
+	DECLARE_SC_CLASS(SharedMemory)
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		SharedMemory();
+		~SharedMemory() override;
+
+
+	// ----------------------------------------------------------------------
+	//  RecordStream interface
+	// ----------------------------------------------------------------------
+	public:
+		bool setSource(const std::string &source) override;
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const Seiscomp::Core::Time &startTime,
+		               const Seiscomp::Core::Time &endTime) override;
+
+		bool setStartTime(const Seiscomp::Core::Time &startTime) override;
+		bool setEndTime(const Seiscomp::Core::Time &endTime) override;
+		bool setTimeout(int seconds) override;
+
+		void close() override;
+
+		Record *next() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		struct TimeWindowFilter {
+			TimeWindowFilter() {}
+			TimeWindowFilter(const Core::Time &stime, const Core::Time &etime)
+			: start(stime), end(etime) {}
+
+			Core::Time  start;
+			Core::Time  end;
+		};
+
+		using FilterMap = std::map<std::string, TimeWindowFilter>;
+		//! The filters of wildcard stream IDs in the order of the patterns
+		//! of the matcher
+		using ReFilterList = std::vector<TimeWindowFilter>;
+
+		bool attach();
+		void detach();
+		bool replaced() const;
+		bool accept(const Record *rec);
+		Record *read(size_t offset, uint32_t size);
+
+		std::string         _name;
+		SharedMemoryHeader *_header{nullptr};
+		const char         *_data{nullptr};
+		size_t              _mappedSize{0};
+		uint64_t            _inode{0};
+		uint64_t            _pos{0};
+		bool                _started{false};
+		std::atomic<bool>   _closeRequested{false};
+		FilterMap           _filter;
+		ReFilterList        _reFilter;
+		Util::WildcardMatcher _reMatcher;
+		bool                _hasTimeFilter{false};
+		Core::Time          _startTime;
+		Core::Time          _endTime;
+		int                 _timeout{0};
+};
+
+
+}
+}
+
+
+#endif
@@ -254,24 +254,6 @@ void SLStreamIdx::setTimestamp(Time &rectime) const {
 
 
 
-// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-SLConnection::StreamBuffer::StreamBuffer() {}
-// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
-
-// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-streambuf *SLConnection::StreamBuffer::setbuf(char *s, streamsize n) {
-	setp(nullptr, nullptr);
-	setg(s, s, s + n);
-	return this;
-}
-// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
-
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SLConnection::SLConnection()
 : RecordStream() {
@@ -391,6 +373,7 @@ bool SLConnection::clear() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SLConnection::close() {
 	_sock.interrupt();
+	_nextSock.interrupt();
 	_retriesLeft = -1;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -476,13 +459,13 @@ bool SLConnection::setTimeout(int seconds) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void SLConnection::handshake() {
+void SLConnection::handshake(IO::Socket &sock, const set<SLStreamIdx> &streams) {
 	Util::StopWatch aStopWatch;
 
 	bool batchmode = false;
 	if ( _useBatch ) {
-		_sock.sendRequest("BATCH",false);
-		string response = _sock.readline();
+		sock.sendRequest("BATCH",false);
+		string response = sock.readline();
 
 		if (response == "OK") {
 			batchmode = true;
@@ -494,7 +477,7 @@ void SLConnection::handshake() {
 	else
 		SEISCOMP_INFO("BATCH mode requests disabled");
 
-	for (set<SLStreamIdx>::iterator it = _streams.begin(); it != _streams.end(); ++it) {
+	for (set<SLStreamIdx>::const_iterator it = streams.begin(); it != streams.end(); ++it) {
 		try {
 			Time stime = (it->startTime() != Time()) ? it->startTime() : _stime;
 			Time etime = (it->endTime() != Time()) ? it->endTime() : _etime;
@@ -533,24 +516,24 @@ void SLConnection::handshake() {
 					timestr += " " + etime.toString("%Y,%m,%d,%H,%M,%S");
 			}
 
-			_sock.startTimer();
-			_sock.sendRequest("STATION " + it->station() + " " + it->network(), !batchmode);
+			sock.startTimer();
+			sock.sendRequest("STATION " + it->station() + " " + it->network(), !batchmode);
 			SEISCOMP_DEBUG("Seedlink command: STATION %s %s", it->station().c_str(),it->network().c_str());
-			_sock.sendRequest("SELECT " + it->selector(), !batchmode);
+			sock.sendRequest("SELECT " + it->selector(), !batchmode);
 			SEISCOMP_DEBUG("Seedlink command: SELECT %s", it->selector().c_str());
 
 			if ( timestr.length() > 0 ) {
-				_sock.sendRequest("TIME " + timestr, !batchmode);
+				sock.sendRequest("TIME " + timestr, !batchmode);
 				SEISCOMP_DEBUG("Seedlink command: TIME %s", timestr.c_str());
 			}
 			else {
-				_sock.sendRequest("DATA", !batchmode);
+				sock.sendRequest("DATA", !batchmode);
 				SEISCOMP_DEBUG("Seedlink command: DATA");
 			}
 		}
 		catch ( SocketCommandException & ) {}
 	}
-	_sock.sendRequest("END",false);
+	sock.sendRequest("END",false);
 
 	SEISCOMP_DEBUG("handshake done in %f seconds", (double)aStopWatch.elapsed());
 }
@@ -605,6 +588,14 @@ Record *SLConnection::next() {
 
 	while ( !_sock.isInterrupted() ) {
 		try {
+			if ( _subscriptionsChanged ) {
+				applySubscriptions();
+				// All streams have been unsubscribed
+				if ( _streams.empty() ) {
+					break;
+				}
+			}
+
 			if ( !_readingData ) {
 				if ( _streams.empty() ) {
 					break;
@@ -618,10 +609,11 @@ Record *SLConnection::next() {
 				_sock.startTimer();
 				SEISCOMP_DEBUG("Handshaking SeedLink server at %s", _serverloc.c_str());
 
-				handshake();
+				handshake(_sock, _streams);
 
 				if ( inReconnect) {
 					SEISCOMP_INFO("Connection to %s re-established", _serverloc.c_str());
+					++_reconnects;
 				}
 
 				_readingData = true;
@@ -631,52 +623,56 @@ Record *SLConnection::next() {
 			}
 
 			_sock.startTimer();
-			_slrecord = _sock.read(strlen(TERMTOKEN));
-			if ( !_slrecord.compare(TERMTOKEN) ) {
+			const char *data = _sock.peek(strlen(TERMTOKEN));
+			if ( !strncmp(data, TERMTOKEN, strlen(TERMTOKEN)) ) {
 				_sock.close();
 				break;
 			}
 
-			_slrecord += _sock.read(strlen(ERRTOKEN)-strlen(TERMTOKEN));
-			if ( !_slrecord.compare(ERRTOKEN) ) {
+			data = _sock.peek(strlen(ERRTOKEN));
+			if ( !strncmp(data, ERRTOKEN, strlen(ERRTOKEN)) ) {
 				_sock.close();
 				break;
 			}
 
-			_slrecord += _sock.read(HEADSIZE+RECSIZE-strlen(ERRTOKEN));
-			char *data = const_cast<char *>(_slrecord.c_str());
-			if ( !MS_ISVALIDHEADER(data+HEADSIZE) ) {
+			// The packet is decoded in place from the receive buffer which
+			// stays valid until the next read
+			data = _sock.peek(HEADSIZE+RECSIZE);
+			_sock.skip(HEADSIZE+RECSIZE);
+
+			char *record = const_cast<char*>(data + HEADSIZE);
+			if ( !MS_ISVALIDHEADER(record) ) {
 				SEISCOMP_WARNING("Invalid MSEED record received (MS_ISVALIDHEADER failed)");
 				continue;
 			}
 
 			MSRecord *prec = nullptr;
 
-			if ( msr_unpack(data+HEADSIZE,RECSIZE,&prec,0,0) == MS_NOERROR ) {
-				int samprate_fact = prec->fsdh->samprate_fact;
-				int numsamples = prec->fsdh->numsamples;
+			if ( msr_unpack(record, RECSIZE, &prec, 0, 0) == MS_NOERROR ) {
+				updateStreams(_streams, prec);
 
-				updateStreams(_streams,prec);
-				msr_free(&prec);
+				IO::MSeedRecord *rec = nullptr;
 
 				/* Test for a so-called end-of-detection-record */
-				if ( !(samprate_fact == 0 && numsamples == 0) ) {
-					istream stream(&_streambuf);
-					stream.clear();
-					stream.rdbuf()->pubsetbuf(data+HEADSIZE,RECSIZE);
-
-					IO::MSeedRecord *rec = new IO::MSeedRecord();
-					setupRecord(rec);
+				if ( !(prec->fsdh->samprate_fact == 0 && prec->fsdh->numsamples == 0) ) {
+					// Create the record from the unpacked header instead
+					// of parsing the packet a second time
 					try {
-						rec->read(stream);
+						rec = new IO::MSeedRecord(prec, _dataType, _hint);
+						if ( rec->samplingFrequency() <= 0 ) {
+							delete rec;
+							rec = nullptr;
+						}
 					}
 					catch ( ... ) {
-						delete rec;
-						continue;
+						rec = nullptr;
 					}
+				}
 
+				msr_free(&prec);
+
+				if ( rec )
 					return rec;
-				}
 			}
 			else
 				SEISCOMP_WARNING("Could not parse the incoming MiniSEED record. Ignore it.");
@@ -726,6 +722,148 @@ Record *SLConnection::next() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SLConnection::subscribe(const string &net, const string &sta,
+                             const string &loc, const string &cha) {
+	lock_guard<mutex> l(_subscriptionMutex);
+	_subscriptions.push_back({SLStreamIdx(net, sta, loc, cha), true});
+	_subscriptionsChanged = true;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SLConnection::unsubscribe(const string &net, const string &sta,
+                               const string &loc, const string &cha) {
+	lock_guard<mutex> l(_subscriptionMutex);
+	_subscriptions.push_back({SLStreamIdx(net, sta, loc, cha), false});
+	_subscriptionsChanged = true;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SLConnection::applySubscriptions() {
+	if ( _nextSubscriptionAttempt.valid() && Time::GMT() < _nextSubscriptionAttempt )
+		return;
+
+	vector<Subscription> subscriptions;
+
+	{
+		lock_guard<mutex> l(_subscriptionMutex);
+		subscriptions.swap(_subscriptions);
+		_subscriptionsChanged = false;
+	}
+
+	// The copies keep the time stamps of the received records
+	set<SLStreamIdx> streams(_streams);
+	bool changed = false;
+
+	for ( const Subscription &subscription : subscriptions ) {
+		if ( subscription.add )
+			changed = streams.insert(subscription.stream).second || changed;
+		else
+			changed = (streams.erase(subscription.stream) > 0) || changed;
+	}
+
+	if ( !changed ) return;
+
+	// Not yet connected: the next handshake uses the new streams
+	if ( !_readingData || !_sock.isOpen() || streams.empty() ) {
+		_streams.swap(streams);
+		if ( _streams.empty() && _sock.isOpen() ) {
+			SEISCOMP_DEBUG("All streams have been unsubscribed");
+			_sock.close();
+		}
+		return;
+	}
+
+	SEISCOMP_DEBUG("Handshaking a second connection to %s with %zu streams",
+	               _serverloc.c_str(), streams.size());
+
+	try {
+		_nextSock.setTimeout(_sock.timeout());
+		_nextSock.open(_serverloc);
+		_nextSock.startTimer();
+		handshake(_nextSock, streams);
+	}
+	catch ( GeneralException &e ) {
+		_nextSock.close();
+
+		if ( _sock.isInterrupted() )
+			return;
+
+		SEISCOMP_ERROR("Changing the subscriptions failed: %s, trying again "
+		               "in 5 seconds", e.what());
+
+		// Keep the changes for the next attempt
+		lock_guard<mutex> l(_subscriptionMutex);
+		_subscriptions.insert(_subscriptions.begin(),
+		                      subscriptions.begin(), subscriptions.end());
+		_subscriptionsChanged = true;
+		_nextSubscriptionAttempt = Time::GMT() + TimeSpan(5, 0);
+		return;
+	}
+
+	// Packets which have been received on the current connection but
+	// not yet read are requested again by the new connection
+	_sock.takeConnection(_nextSock);
+	_streams.swap(streams);
+	_nextSubscriptionAttempt = Time();
+
+	SEISCOMP_INFO("Subscriptions changed, now reading %zu streams from %s",
+	              _streams.size(), _serverloc.c_str());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SLConnection::hasPacket() {
+	if ( !_readingData || !_sock.isOpen() ) return false;
+
+	try {
+		return _sock.buffered() + _sock.poll() >= HEADSIZE + RECSIZE;
+	}
+	catch ( SocketException & ) {
+		return false;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t SLConnection::nextBatch(std::vector<Record*> &records, size_t max) {
+	size_t count = 0;
+
+	// Only the first record is waited for, further records are returned
+	// as long as complete packets have already been received
+	while ( count < max ) {
+		if ( count && !hasPacket() ) break;
+
+		Record *rec = next();
+		if ( !rec ) break;
+
+		records.push_back(rec);
+		++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
@@ -21,8 +21,11 @@
 #ifndef SEISCOMP_IO_RECORDSTREAM_SLINK_H
 #define SEISCOMP_IO_RECORDSTREAM_SLINK_H
 
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <set>
+#include <vector>
 #include <iostream>
 #include <sstream>
 #include <signal.h>
@@ -157,27 +160,65 @@ class SC_SYSTEM_CORE_API SLConnection : public Seiscomp::IO::RecordStream {
 		//! Reads the data stream
 		virtual Record *next();
 
+		//! Returns the next record and all further records which have
+		//! already been received
+		size_t nextBatch(std::vector<Record*> &records, size_t max) override;
+
 		//! Removes all stream list, time window, etc. -entries from the connection description object.
 		bool clear();
 
 		//! Reconnects a terminated seedlink connection.
 		bool reconnect();
 
-
-	private:
-		void handshake();
+		//! Returns the number of re-established connections. This is safe
+		//! to be called from another thread than the reading one.
+		size_t reconnects() const { return _reconnects; }
+
+		/**
+		 * @brief Adds a stream to the request while data is being read.
+		 *
+		 * SeedLink does not allow to change the selection of a session
+		 * after the handshake. The changes are therefore applied by
+		 * handshaking a second connection with the new set of streams
+		 * which replaces the current connection once it has been
+		 * established. Each stream continues after its last received
+		 * record, so data of the unchanged streams is neither
+		 * interrupted nor transferred again.
+		 *
+		 * The changes are applied before the next packet is read. This
+		 * is safe to be called from another thread than the reading one.
+		 * @return Whether the change has been scheduled
+		 */
+		bool subscribe(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode);
+
+		/**
+		 * @brief Removes a stream from the request while data is being
+		 *        read, see subscribe. Removing the last stream finishes
+		 *        the stream.
+		 * @return Whether the change has been scheduled
+		 */
+		bool unsubscribe(const std::string &networkCode,
+		                 const std::string &stationCode,
+		                 const std::string &locationCode,
+		                 const std::string &channelCode);
 
 
 	private:
-		class StreamBuffer : public std::streambuf {
-			public:
-				StreamBuffer();
-				std::streambuf *setbuf(char *s, std::streamsize n);
+		struct Subscription {
+			SLStreamIdx stream;
+			bool        add;
 		};
 
-		StreamBuffer          _streambuf;
+		void handshake(IO::Socket &sock, const std::set<SLStreamIdx> &streams);
+		void applySubscriptions();
+		bool hasPacket();
+
+
+	private:
 		std::string           _serverloc;
-		std::string           _slrecord;
 		IO::Socket            _sock;
 		std::set<SLStreamIdx> _streams;
 		Core::Time            _stime;
@@ -186,6 +227,14 @@ class SC_SYSTEM_CORE_API SLConnection : public Seiscomp::IO::RecordStream {
 		bool                  _useBatch;
 		int                   _maxRetries;
 		int                   _retriesLeft;
+		std::atomic<size_t>   _reconnects{0};
+
+		// The connection which is handshaked to change the subscriptions
+		IO::Socket                _nextSock;
+		std::mutex                _subscriptionMutex;
+		std::vector<Subscription> _subscriptions;
+		std::atomic<bool>         _subscriptionsChanged{false};
+		Core::Time                _nextSubscriptionAttempt;
 };
 
 
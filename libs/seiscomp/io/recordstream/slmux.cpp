@@ -0,0 +1,222 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT SLMuxConnection
+
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+
+#include "slmux.h"
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::IO;
+
+
+namespace Seiscomp {
+namespace RecordStream {
+namespace {
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const int DefaultConnections = 4;
+const int MaxConnections = 64;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+REGISTER_RECORDSTREAM(SLMuxConnection, "slinkmux");
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SLMuxConnection::setSource(const string &source) {
+	if ( _started )
+		return false;
+
+	reset();
+
+	_rsarray.clear();
+	_shards.clear();
+	_stations.clear();
+
+	int connections = DefaultConnections;
+	string serverloc = source;
+	string params;
+
+	setMergeLateness(Core::TimeSpan(0,0));
+
+	size_t pos = source.find('?');
+	if ( pos != string::npos ) {
+		serverloc = source.substr(0, pos);
+
+		vector<string> toks;
+		Core::split(toks, source.substr(pos+1).c_str(), "&");
+		for ( const auto &tok : toks ) {
+			if ( tok.compare(0, 12, "connections=") == 0 ) {
+				if ( !Core::fromString(connections, tok.substr(12))
+				  || connections < 1 || connections > MaxConnections ) {
+					SEISCOMP_ERROR("Invalid number of connections: %s",
+					               tok.c_str() + 12);
+					return false;
+				}
+				continue;
+			}
+
+			if ( tok.compare(0, 6, "merge=") == 0 ) {
+				double seconds;
+				if ( !Core::fromString(seconds, tok.substr(6))
+				  || !setMergeLateness(Core::TimeSpan(seconds)) ) {
+					SEISCOMP_ERROR("Invalid merge lateness: %s", tok.c_str() + 6);
+					return false;
+				}
+				continue;
+			}
+
+			if ( tok.empty() ) continue;
+
+			params += params.empty() ? '?' : '&';
+			params += tok;
+		}
+	}
+
+	for ( int i = 0; i < connections; ++i ) {
+		SLConnectionPtr rs = new SLConnection;
+		if ( !rs->setSource(serverloc + params) ) {
+			SEISCOMP_ERROR("Invalid SeedLink source: %s", source.c_str());
+			_rsarray.clear();
+			_shards.clear();
+			return false;
+		}
+
+		_rsarray.push_back(make_pair(rs, false));
+
+		_shards.emplace_back(new Shard);
+		_shards.back()->connection = rs;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SLMuxConnection::close() {
+	if ( _started ) {
+		for ( size_t i = 0; i < _shards.size(); ++i ) {
+			ShardStatistics stats = shardStatistics(i);
+			if ( !stats.stations ) continue;
+			SEISCOMP_DEBUG("Shard #%zu: %zu stations, %zu records, "
+			               "%zu samples, %zu reconnects",
+			               i, stats.stations, stats.records, stats.samples,
+			               stats.reconnects);
+		}
+	}
+
+	Concurrent::close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t SLMuxConnection::shardCount() const {
+	return _shards.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SLMuxConnection::ShardStatistics
+SLMuxConnection::shardStatistics(size_t index) const {
+	ShardStatistics stats;
+	if ( index >= _shards.size() )
+		return stats;
+
+	const Shard *shard = _shards[index].get();
+	stats.stations = shard->stations;
+	stats.records = shard->records;
+	stats.samples = shard->samples;
+	stats.reconnects = shard->connection->reconnects();
+	return stats;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int SLMuxConnection::getRS(const string &net, const string &sta,
+                           const string &, const string &) {
+	if ( _shards.empty() )
+		return -1;
+
+	// All channels of a station are requested from the same connection
+	auto it = _stations.find(net + "." + sta);
+	if ( it != _stations.end() )
+		return it->second;
+
+	int index = _stations.size() % _shards.size();
+	_stations[net + "." + sta] = index;
+	++_shards[index]->stations;
+
+	return index;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SLMuxConnection::acquired(size_t index, const Record *rec) {
+	Shard *shard = _shards[index].get();
+	++shard->records;
+	shard->samples += rec->sampleCount();
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+} // namespace RecordStream
+} // namespace Seiscomp
@@ -0,0 +1,131 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_IO_RECORDSTREAM_SLMUX_H
+#define SEISCOMP_IO_RECORDSTREAM_SLMUX_H
+
+
+#include <seiscomp/io/recordstream/concurrent.h>
+#include <seiscomp/io/recordstream/slconnection.h>
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+/**
+ * @brief The SLMuxConnection class distributes the requested stations over
+ *        multiple SeedLink connections to the same server.
+ *
+ * Each connection (shard) is read by its own thread and reconnects
+ * independently of the others, so a stalled connection does not block the
+ * stations of the other shards. All channels of a station are requested
+ * from the same shard. Stations are assigned round-robin in the order they
+ * are added.
+ */
+class SC_SYSTEM_CORE_API SLMuxConnection : public Concurrent {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct ShardStatistics {
+			size_t stations{0};
+			size_t records{0};
+			size_t samples{0};
+			size_t reconnects{0};
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! C'tor
+		SLMuxConnection() = default;
+
+
+	// ----------------------------------------------------------------------
+	//  RecordStream Interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Initializes the shards. The source is a SeedLink source
+		 *        with the additional parameter 'connections' which defines
+		 *        the number of shards, e.g. localhost:18000?connections=4,
+		 *        and 'merge' which sets the merge lateness in seconds, see
+		 *        Concurrent. All other parameters are passed to each
+		 *        SeedLink connection.
+		 */
+		bool setSource(const std::string &source) override;
+
+		//! Terminates all shards.
+		void close() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the number of shards
+		size_t shardCount() const;
+
+		//! Returns the statistics of a shard. This is safe to be called
+		//! while reading.
+		ShardStatistics shardStatistics(size_t index) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Concurrent interface
+	// ----------------------------------------------------------------------
+	protected:
+		int getRS(const std::string &networkCode,
+		          const std::string &stationCode,
+		          const std::string &locationCode,
+		          const std::string &channelCode) override;
+
+		bool acquired(size_t index, const Record *rec) override;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Shard {
+			SLConnectionPtr     connection;
+			size_t              stations{0};
+			std::atomic<size_t> records{0};
+			std::atomic<size_t> samples{0};
+		};
+
+		std::vector<std::unique_ptr<Shard>> _shards;
+		std::map<std::string, int>          _stations;
+};
+
+
+} // namespace RecordStream
+} // namespace Seiscomp
+
+
+#endif
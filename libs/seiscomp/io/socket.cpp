@@ -263,7 +263,7 @@ void Socket::fillbuf() {
 	if ( _interrupt )
 		throw OperationInterrupted();
 
-	int byteCount = readImpl(_buf + _wp, BUFSIZE - _wp);
+	int byteCount = readImpl(_buf + _wp, RECVBUFSIZE - _wp);
 	if ( byteCount < 0 ) {
 		if ( errno != EAGAIN && errno != EWOULDBLOCK ) {
 			_reconnect = true;
@@ -330,7 +330,7 @@ void Socket::fillbuf() {
 	if ( _interrupt )
 		throw OperationInterrupted();
 
-	byteCount = readImpl(_buf + _wp, BUFSIZE - _wp);
+	byteCount = readImpl(_buf + _wp, RECVBUFSIZE - _wp);
 	if ( byteCount < 0 ) {
 		if ( errno == EAGAIN || errno == EWOULDBLOCK ) {
 			return;
@@ -461,6 +461,23 @@ string Socket::read(int size) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *Socket::peek(int size) {
+	if ( size > BUFSIZE ) {
+		SEISCOMP_ERROR("Socket peek: size > BUFSIZE");
+		size = BUFSIZE;
+	}
+
+	while ( _wp - _rp < size )
+		fillbuf();
+
+	return _buf + _rp;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 string Socket::readline() {
 	while ( 1 ) {
@@ -688,6 +705,34 @@ int Socket::takeFd() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Socket::takeConnection(Socket &other) {
+	// Do not call close which would reset the interrupt flag. On Windows
+	// the WinSock reference of the current connection is passed to the
+	// new one and released when other is closed.
+	if ( _sockfd != -1 ) {
+#ifndef WIN32
+		::close(_sockfd);
+#else
+		closesocket(_sockfd);
+#endif
+	}
+
+	_sockfd = other._sockfd;
+	other._sockfd = -1;
+
+	_rp = 0;
+	_wp = other._wp - other._rp;
+	memcpy(_buf, other._buf + other._rp, _wp);
+	_reconnect = false;
+
+	other.close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SSLSocket::SSLSocket() : Socket(), _bio(nullptr), _ssl(nullptr), _ctx(nullptr) {
 	SSL_library_init();
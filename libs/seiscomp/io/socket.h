@@ -36,6 +36,9 @@
 
 #define BUFSIZE 4096
 #define RECSIZE 512
+// The capacity of the receive buffer. A single read is limited to BUFSIZE
+// but one system call can receive many of those blocks.
+#define RECVBUFSIZE 65536
 
 namespace Seiscomp {
 namespace IO {
@@ -74,6 +77,8 @@ class SC_SYSTEM_CORE_API Socket: public Seiscomp::Core::InterruptibleObject {
 
 	public:
 		void setTimeout(int seconds);
+		//! Returns the timeout in seconds, 0 means no timeout
+		int timeout() const { return _timeout; }
 		void startTimer();
 		void stopTimer();
 		virtual void open(const std::string& serverLocation);
@@ -83,13 +88,38 @@ class SC_SYSTEM_CORE_API Socket: public Seiscomp::Core::InterruptibleObject {
 		void write(const std::string& s);
 		std::string readline();
 		std::string read(int size);
+
+		/**
+		 * @brief Waits until at least size bytes are buffered and returns
+		 *        them without consuming and copying them.
+		 * @param size The number of bytes which must not exceed BUFSIZE
+		 * @return The pointer into the receive buffer which is valid until
+		 *         the next call of a read method
+		 */
+		const char *peek(int size);
+
+		//! Consumes size bytes which have been returned by peek before
+		void skip(int size) { _rp += size; }
 		std::string sendRequest(const std::string& request, bool waitResponse);
 		bool isInterrupted();
 		void interrupt();
 		int poll();
 
+		//! Returns the number of bytes which have been read from the
+		//! socket but not yet consumed
+		int buffered() const { return _wp - _rp; }
+
 		int takeFd();
 
+		/**
+		 * @brief Closes the current connection and continues with the
+		 *        connection of another socket including its buffered
+		 *        data. The other socket is closed afterwards. A pending
+		 *        interrupt of this socket is kept.
+		 * @param other The socket to take the connection from
+		 */
+		void takeConnection(Socket &other);
+
 	protected:
 		void handleInterrupt(int) throw();
 		virtual int readImpl(char *buf, int count);
@@ -107,7 +137,7 @@ class SC_SYSTEM_CORE_API Socket: public Seiscomp::Core::InterruptibleObject {
 	private:
 		enum { READ = 0, WRITE = 1 };
 		int _pipefd[2];
-		char _buf[BUFSIZE + 1];
+		char _buf[RECVBUFSIZE + 1];
 		int _rp;
 		int _wp;
 		int _timeout;
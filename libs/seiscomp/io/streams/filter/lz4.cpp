@@ -33,6 +33,32 @@ namespace iostreams {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+lz4_dictionary::lz4_dictionary(std::string data, unsigned int id)
+: _data(std::move(data))
+, _id(id) {
+	// LZ4 references at most 64kb backwards, keep the tail
+	if ( _data.size() > 65536 )
+		_data.erase(0, _data.size() - 65536);
+
+	_cdict = LZ4F_createCDict(_data.data(), _data.size());
+	if ( !_cdict )
+		throw std::runtime_error("lz4: failed to create dictionary");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+lz4_dictionary::~lz4_dictionary() {
+	LZ4F_freeCDict(_cdict);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 lz4_base::lz4_base(size_t inputBufferSize)
 : _inputBufferSize(inputBufferSize)
@@ -66,12 +92,16 @@ void lz4_base::cleanup_() {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-lz4_compress_base::lz4_compress_base(size_t inputBufferSize)
+lz4_compress_base::lz4_compress_base(size_t inputBufferSize,
+                                     const lz4_dictionary *dict)
 : lz4_base(inputBufferSize)
-, _ctx(nullptr) {
+, _ctx(nullptr)
+, _dict(dict) {
 	std::memset(&_prefs, 0, sizeof(_prefs));
 	_prefs.compressionLevel = LZ4HC_CLEVEL_DEFAULT;
 	_prefs.autoFlush = 1;
+	if ( _dict )
+		_prefs.frameInfo.dictID = _dict->_id;
 	_outputBufferSize = std::max(LZ4F_compressFrameBound(inputBufferSize, nullptr), size_t(64));
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -102,7 +132,11 @@ bool lz4_compress_base::init() {
 		return false;
 	}
 
-	r = LZ4F_compressBegin(_ctx, _outputBuffer, _outputBufferSize, &_prefs);
+	if ( _dict )
+		r = LZ4F_compressBegin_usingCDict(_ctx, _outputBuffer, _outputBufferSize,
+		                                  _dict->_cdict, &_prefs);
+	else
+		r = LZ4F_compressBegin(_ctx, _outputBuffer, _outputBufferSize, &_prefs);
 	if ( LZ4F_isError(r) ) {
 		cleanup_();
 		return false;
@@ -189,13 +223,16 @@ void lz4_compress_base::done() {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-lz4_decompress_base::lz4_decompress_base(size_t inputBufferSize)
+lz4_decompress_base::lz4_decompress_base(size_t inputBufferSize,
+                                         const lz4_dictionary *dict)
 : lz4_base(inputBufferSize)
 , _ctx(nullptr)
 , _inputBuffer(nullptr)
 , _inputBufferPos(0)
 , _inputBuffered(0)
-, _outputBufferPos(0) {
+, _outputBufferPos(0)
+, _dict(dict)
+, _frameChecked(false) {
 	_outputBufferSize = std::max(inputBufferSize, size_t(128));
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -242,11 +279,34 @@ bool lz4_decompress_base::decompress() {
 
 	_outputBufferPos = 0;
 
+	if ( _dict && !_frameChecked ) {
+		// Reject frames compressed with another dictionary
+		LZ4F_frameInfo_t info;
+		size_t headerSize = _inputBuffered;
+		r = LZ4F_getFrameInfo(_ctx, &info, _inputBuffer, &headerSize);
+		if ( LZ4F_isError(r) || (info.dictID != _dict->_id) ) {
+			cleanup_();
+			return false;
+		}
+
+		_frameChecked = true;
+		std::copy(_inputBuffer + headerSize,
+		          _inputBuffer + _inputBuffered, _inputBuffer);
+		_inputBuffered -= headerSize;
+	}
+
 	size_t usedInput = _inputBuffered;
 	size_t usedOutput = _outputBufferSize;
 
-	r = LZ4F_decompress(_ctx, _outputBuffer, &usedOutput,
-	                    _inputBuffer, &usedInput, nullptr);
+	if ( _dict ) {
+		r = LZ4F_decompress_usingDict(_ctx, _outputBuffer, &usedOutput,
+		                              _inputBuffer, &usedInput,
+		                              _dict->_data.data(), _dict->_data.size(),
+		                              nullptr);
+	}
+	else
+		r = LZ4F_decompress(_ctx, _outputBuffer, &usedOutput,
+		                    _inputBuffer, &usedInput, nullptr);
 	if ( LZ4F_isError(r) ) {
 		cleanup_();
 		return false;
@@ -27,6 +27,7 @@
 #include <boost/iostreams/pipeline.hpp>
 
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include <lz4/lz4frame_static.h>
@@ -40,6 +41,34 @@ namespace iostreams {
 using namespace ::boost::iostreams;
 
 
+/**
+ * @brief A predefined dictionary shared by compressor and decompressor.
+ *
+ * Small payloads do not contain enough redundancy to be compressed
+ * efficiently. A dictionary with typical content primes the compressor
+ * with references which do not need to be transmitted. The same dictionary
+ * must be used for decompression. The dictionary is copied and can be
+ * shared by many filters and threads concurrently.
+ */
+struct lz4_dictionary {
+	/**
+	 * @brief Constructs a dictionary.
+	 * @param data The dictionary content, at most 64kb are used.
+	 * @param id The identifier which is stored in the frame header and
+	 *           checked by the decompressor. Zero omits the identifier.
+	 */
+	lz4_dictionary(std::string data, unsigned int id = 0);
+	~lz4_dictionary();
+
+	lz4_dictionary(const lz4_dictionary &) = delete;
+	lz4_dictionary &operator=(const lz4_dictionary &) = delete;
+
+	std::string  _data;
+	unsigned int _id;
+	LZ4F_CDict  *_cdict;
+};
+
+
 struct lz4_base {
 	lz4_base(size_t inputBufferSize);
 	~lz4_base();
@@ -54,7 +83,7 @@ struct lz4_base {
 
 
 struct lz4_compress_base : lz4_base {
-	lz4_compress_base(size_t inputBufferSize);
+	lz4_compress_base(size_t inputBufferSize, const lz4_dictionary *dict);
 	~lz4_compress_base();
 
 	void cleanup_();
@@ -65,6 +94,7 @@ struct lz4_compress_base : lz4_base {
 
 	LZ4F_cctx *_ctx;
 	LZ4F_preferences_t _prefs;
+	const lz4_dictionary *_dict;
 };
 
 
@@ -80,8 +110,9 @@ class basic_l4z_compressor : private lz4_compress_base {
 		, optimally_buffered_tag
 		{};
 
-		explicit basic_l4z_compressor(size_t bufferSize = 128)
-		: lz4_compress_base(bufferSize), _bufferSize(bufferSize) {}
+		explicit basic_l4z_compressor(size_t bufferSize = 128,
+		                              const lz4_dictionary *dict = nullptr)
+		: lz4_compress_base(bufferSize, dict), _bufferSize(bufferSize) {}
 
 		std::streamsize optimal_buffer_size() const { return _bufferSize; }
 
@@ -131,7 +162,7 @@ typedef basic_l4z_compressor<char> lz4_compressor;
 
 
 struct lz4_decompress_base : lz4_base {
-	lz4_decompress_base(size_t inputBufferSize);
+	lz4_decompress_base(size_t inputBufferSize, const lz4_dictionary *dict);
 	~lz4_decompress_base();
 
 	void cleanup_();
@@ -144,6 +175,8 @@ struct lz4_decompress_base : lz4_base {
 	std::streamsize  _inputBufferPos;
 	std::streamsize  _inputBuffered;
 	std::streamsize  _outputBufferPos;
+	const lz4_dictionary *_dict;
+	bool             _frameChecked;
 };
 
 
@@ -157,8 +190,9 @@ class basic_l4z_decompressor : private lz4_decompress_base {
 		, multichar_tag
 		{};
 
-		explicit basic_l4z_decompressor(size_t bufferSize = 128)
-		: lz4_decompress_base(bufferSize), _bufferSize(bufferSize) {}
+		explicit basic_l4z_decompressor(size_t bufferSize = 128,
+		                                const lz4_dictionary *dict = nullptr)
+		: lz4_decompress_base(bufferSize, dict), _bufferSize(bufferSize) {}
 
 		template<typename Source>
 		std::streamsize read(Source &snk, char_type *s, std::streamsize n) {
@@ -22,9 +22,11 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/io/xml/exporter.h>
 
+#include <atomic>
 #include <iostream>
 #include <set>
 #include <ostream>
+#include <thread>
 #include <libxml/xmlreader.h>
 
 
@@ -84,8 +86,14 @@ class NamespaceCollector : public OutputHandler {
 
 static const char *xmlHeader = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
 
+// The number of dispatched objects per thread which are serialized at once
+static const size_t jobsPerThread = 64;
+
 Exporter::Exporter() : _ostr(std::cout.rdbuf()) {
 	_typemap = nullptr;
+	_root = nullptr;
+	_current = nullptr;
+	_target = nullptr;
 }
 
 TypeMap* Exporter::typeMap() {
@@ -138,7 +146,9 @@ bool Exporter::put(std::streambuf* buf, Core::BaseObject *obj) {
 
 	collectNamespaces(obj);
 
+	beginObject(buf, obj);
 	handle(obj, "", "", nullptr);
+	endObject();
 
 	if ( !_headerNode.empty() )
 		_ostr << std::endl << "</" << _headerNode << ">";
@@ -165,7 +175,9 @@ bool Exporter::put(std::streambuf* buf, const ExportObjectList &objects) {
 		_tagOpen = false;
 		_firstElement = true;
 		_indent = 0;
+		beginObject(buf, *it);
 		handle(*it, "", "", nullptr);
+		endObject();
 	}
 
 	if ( !_headerNode.empty() )
@@ -192,8 +204,134 @@ void Exporter::handle(Core::BaseObject *obj, const char *defaultTag, const char
 	if ( handler == nullptr )
 		handler = _typemap->getHandler(obj->className());
 
-	if ( handler )
-		handler->put(obj, tag->name.c_str(), tag->ns.c_str(), this);
+	if ( handler == nullptr )
+		return;
+
+	// The children of the root object are independent of each other
+	if ( _root != nullptr && _current == _root && obj != _root ) {
+		dispatch(obj, tag, handler);
+		return;
+	}
+
+	Core::BaseObject *parent = _current;
+	_current = obj;
+	handler->put(obj, tag->name.c_str(), tag->ns.c_str(), this);
+	_current = parent;
+}
+
+
+void Exporter::dispatch(Core::BaseObject *obj, const TypeMap::Tag *tag,
+                        NodeHandler *handler) {
+	if ( _tagOpen ) {
+		_ostr << ">";
+		_tagOpen = false;
+	}
+
+	Job job;
+	job.object = obj;
+	job.tag = tag->name;
+	job.ns = tag->ns;
+	job.handler = handler;
+	job.indent = _indent;
+	job.prefix = _buffer.str();
+	_buffer.str("");
+	_jobs.push_back(std::move(job));
+
+	// The state after the element of the object has been closed
+	_lastTagState = 0;
+
+	if ( _jobs.size() >= static_cast<size_t>(_threads) * jobsPerThread )
+		flush();
+}
+
+
+void Exporter::beginObject(std::streambuf *buf, Core::BaseObject *obj) {
+	_current = nullptr;
+
+	if ( _threads < 2 ) {
+		_root = nullptr;
+		return;
+	}
+
+	// Everything written in between the objects is buffered and written
+	// along with the serialized objects
+	_root = obj;
+	_target = buf;
+	_buffer.str("");
+	_ostr.rdbuf(&_buffer);
+}
+
+
+void Exporter::endObject() {
+	if ( _root == nullptr ) return;
+
+	flush();
+
+	std::string remaining = _buffer.str();
+	_buffer.str("");
+	_target->sputn(remaining.data(), remaining.size());
+
+	_ostr.rdbuf(_target);
+	_root = nullptr;
+	_target = nullptr;
+}
+
+
+void Exporter::flush() {
+	if ( _jobs.empty() ) return;
+
+	size_t threadCount = std::min(static_cast<size_t>(_threads), _jobs.size());
+	std::vector<std::exception_ptr> errors(threadCount);
+	std::atomic<size_t> next(0);
+
+	auto worker = [&](size_t id) {
+		// Each thread serializes with its own state into its own buffer
+		Exporter exporter;
+		std::stringbuf output;
+		exporter._typemap = _typemap;
+		exporter._namespaces = _namespaces;
+		exporter._prettyPrint = _prettyPrint;
+		exporter._indentation = _indentation;
+		exporter._firstElement = false;
+		exporter._ostr.rdbuf(&output);
+
+		try {
+			for ( size_t i; (i = next++) < _jobs.size(); ) {
+				Job &job = _jobs[i];
+				exporter._indent = job.indent;
+				exporter._tagOpen = false;
+				exporter._lastTagState = 0;
+				exporter.handle(job.object, job.tag.c_str(), job.ns.c_str(), job.handler);
+				job.output = output.str();
+				output.str("");
+			}
+		}
+		catch ( ... ) {
+			errors[id] = std::current_exception();
+			next = _jobs.size();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for ( size_t id = 1; id < threadCount; ++id )
+		workers.emplace_back(worker, id);
+	worker(0);
+	for ( auto &t : workers )
+		t.join();
+
+	for ( auto &error : errors ) {
+		if ( error ) {
+			_jobs.clear();
+			std::rethrow_exception(error);
+		}
+	}
+
+	for ( auto &job : _jobs ) {
+		_target->sputn(job.prefix.data(), job.prefix.size());
+		_target->sputn(job.output.data(), job.output.size());
+	}
+
+	_jobs.clear();
 }
 
 
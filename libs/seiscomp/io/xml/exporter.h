@@ -26,7 +26,9 @@
 #include <seiscomp/io/exporter.h>
 
 #include <ostream>
+#include <sstream>
 #include <map>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -70,6 +72,12 @@ class SC_SYSTEM_CORE_API Exporter : public IO::Exporter, public OutputHandler {
 	// ------------------------------------------------------------------
 	private:
 		void handle(Core::BaseObject *, const char *tag, const char *ns, NodeHandler *);
+		void dispatch(Core::BaseObject *, const TypeMap::Tag *tag, NodeHandler *);
+		void beginObject(std::streambuf *buf, Core::BaseObject *);
+		void endObject();
+		//! Serializes the dispatched objects and writes them in order
+		void flush();
+
 		bool openElement(const char *name, const char *ns);
 		void addAttribute(const char *name, const char *ns, const char *value);
 		void closeElement(const char *name, const char *ns);
@@ -88,6 +96,18 @@ class SC_SYSTEM_CORE_API Exporter : public IO::Exporter, public OutputHandler {
 
 
 	private:
+		//! An object serialized by a worker thread
+		struct Job {
+			Core::BaseObject *object;
+			std::string       tag;
+			std::string       ns;
+			NodeHandler      *handler;
+			int               indent;
+			//! The output preceding the object
+			std::string       prefix;
+			std::string       output;
+		};
+
 		std::string  _headerNode;
 		std::ostream _ostr;
 		TypeMap     *_typemap;
@@ -95,6 +115,13 @@ class SC_SYSTEM_CORE_API Exporter : public IO::Exporter, public OutputHandler {
 		int          _indent;
 		bool         _tagOpen;
 		bool         _firstElement;
+
+		// Parallel serialization
+		Core::BaseObject *_root;
+		Core::BaseObject *_current;
+		std::streambuf   *_target;
+		std::stringbuf    _buffer;
+		std::vector<Job>  _jobs;
 };
 
 
@@ -58,6 +58,18 @@ int streamBufCloseCallback(void* context) {
 }
 
 
+bool isChildMember(NodeHandler *handler, MemberNodeHandler *member) {
+	ClassHandler *classHandler = dynamic_cast<ClassHandler*>(handler);
+	if ( classHandler == nullptr ) return false;
+
+	for ( auto &child : classHandler->childs ) {
+		if ( &child == member ) return true;
+	}
+
+	return false;
+}
+
+
 }
 
 
@@ -67,6 +79,7 @@ NoneHandler Importer::_none;
 Importer::Importer() {
 	_typemap = nullptr;
 	_strictNamespaceCheck = true;
+	_cancelled = false;
 }
 
 TypeMap* Importer::typeMap() {
@@ -138,121 +151,170 @@ Core::BaseObject *Importer::get(std::streambuf* buf) {
 }
 
 
-bool Importer::traverse(NodeHandler *handler, void *n, void *c, Core::BaseObject *target) {
-	xmlNodePtr node = reinterpret_cast<xmlNodePtr>(n);
-	xmlNodePtr childs = reinterpret_cast<xmlNodePtr>(c);
-	ChildList remaining;
-	TagSet mandatory;
+bool Importer::get(std::streambuf* buf, const ObjectHandler &handler) {
+	if ( _typemap == nullptr ) return false;
+	if ( buf == nullptr ) return false;
 
-	handler->init(target, n, mandatory);
+	xmlTextReaderPtr reader = xmlReaderForIO(streamBufReadCallback,
+	                                         streamBufCloseCallback,
+	                                         buf, nullptr, nullptr,
+	                                         XML_PARSE_BIG_LINES);
+	if ( reader == nullptr )
+		return false;
 
-	bool result = true;
+	_any.mapper = _typemap;
+	_cancelled = false;
+	_hasErrors = false;
 
-	for ( xmlNodePtr child = childs; child != nullptr; child = child->next ) {
-		if ( child->type != XML_ELEMENT_NODE ) continue;
+	bool saveStrictNsCheck = NodeHandler::strictNsCheck;
+	NodeHandler::strictNsCheck = _strictNamespaceCheck;
+
+	// The objects are the root element or the children of the header node
+	int objectDepth = _headerNode.empty() ? 0 : 1;
+	bool foundRoot = false;
+	int ret = 0;
+
+	try {
+		while ( !_cancelled && (ret = xmlTextReaderRead(reader)) == 1 ) {
+			if ( xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT )
+				continue;
+
+			if ( !foundRoot ) {
+				foundRoot = true;
+				if ( objectDepth > 0 ) {
+					// Check the root tag matching "seiscomp"
+					const xmlChar *name = xmlTextReaderConstLocalName(reader);
+					if ( xmlStrcmp(name, (const xmlChar*)_headerNode.c_str()) ) {
+						SEISCOMP_WARNING("Invalid root tag: %s, expected: %s",
+						                 reinterpret_cast<const char*>(name),
+						                 _headerNode.c_str());
+						_hasErrors = true;
+						break;
+					}
+					continue;
+				}
+			}
 
-		handler->propagate(nullptr, false, true);
+			if ( xmlTextReaderDepth(reader) != objectDepth )
+				continue;
 
-		try {
-			handler->get(target, child);
-		}
-		catch ( std::exception &e ) {
-			if ( handler->isOptional )
-				SEISCOMP_WARNING("L%ld: (optional) %s.%s: %s",
-				                 xmlGetLineNo(node),
-				                 reinterpret_cast<const char*>(node->name),
-				                 reinterpret_cast<const char*>(child->name),
-				                 e.what());
-			else
-				throw e;
+			if ( !streamObject(reader, handler) )
+				_hasErrors = true;
 		}
 
-		if ( !handler->isOptional )
-			mandatory.erase((const char*)child->name);
+		if ( ret == -1 )
+			_hasErrors = true;
+	}
+	catch ( ... ) {
+		NodeHandler::strictNsCheck = saveStrictNsCheck;
+		xmlFreeTextReader(reader);
+		throw;
+	}
 
-		if ( handler->object == nullptr && handler->isAnyType ) {
-			if ( _any.get(target, child) ) {
-				handler->object = _any.object;
-				handler->childHandler = _any.childHandler;
-				handler->newInstance = _any.newInstance;
-			}
-		}
+	NodeHandler::strictNsCheck = saveStrictNsCheck;
+	xmlFreeTextReader(reader);
 
-		Core::BaseObject *newTarget = handler->object;
-		MemberNodeHandler *memberHandler = handler->memberHandler;
-		NodeHandler *childHandler = handler->childHandler;
-		bool newInstance = handler->newInstance;
-		bool optional = handler->isOptional;
+	return foundRoot && !_hasErrors;
+}
 
-		if ( newTarget ) {
-			if ( childHandler == nullptr ) {
-				childHandler = _typemap->getHandler(newTarget->className());
-				if ( childHandler == nullptr ) {
-					SEISCOMP_WARNING("No class handler for %s", newTarget->className());
-					if ( newInstance )
-						delete newTarget;
-					handler->object = nullptr;
-					newTarget = nullptr;
-					childHandler = &_none;
-				}
-			}
-		}
-		else
-			childHandler = &_none;
 
-		try {
-			if ( traverse(childHandler, child, child->children, handler->object) ) {
-				if ( newTarget && newInstance && !memberHandler )
-					remaining.push_back(newTarget);
+bool Importer::streamObject(void *r, const ObjectHandler &handler) {
+	xmlTextReaderPtr reader = reinterpret_cast<xmlTextReaderPtr>(r);
+	xmlNodePtr node = xmlTextReaderCurrentNode(reader);
+	int depth = xmlTextReaderDepth(reader);
+	bool empty = xmlTextReaderIsEmptyElement(reader) == 1;
+
+	_any.propagate(nullptr, false, true);
+	// Unknown elements are skipped along with their children by the caller
+	if ( !_any.get(nullptr, node) || _any.object == nullptr )
+		return true;
+
+	Core::BaseObjectPtr object = _any.object;
+	NodeHandler *objectHandler = _any.childHandler;
+	if ( objectHandler == nullptr )
+		objectHandler = _typemap->getHandler(object->className());
+	if ( objectHandler == nullptr ) {
+		SEISCOMP_WARNING("No class handler for %s", object->className());
+		return true;
+	}
 
+	ChildList remaining;
+	TagSet mandatory;
+	bool result = true;
+
+	// The attributes are available with the start tag
+	objectHandler->init(object.get(), node, mandatory);
+
+	if ( !handler(nullptr, object.get()) ) {
+		_cancelled = true;
+		return true;
+	}
+
+	if ( !empty ) {
+		int ret = xmlTextReaderRead(reader);
+		while ( !_cancelled && ret == 1 && xmlTextReaderDepth(reader) > depth ) {
+			if ( xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT ) {
+				ret = xmlTextReaderRead(reader);
+				continue;
 			}
-			else {
-				if ( newTarget && newInstance )
-					delete newTarget;
-				newTarget = nullptr;
-				if ( optional )
-					SEISCOMP_INFO("L%ld: Invalid %s element: ignoring",
-					              xmlGetLineNo(child),
-					              reinterpret_cast<const char*>(child->name));
-				else {
-					SEISCOMP_WARNING("L%ld: %s is not optional within %s",
-					                 xmlGetLineNo(child),
-					                 reinterpret_cast<const char*>(child->name),
-					                 reinterpret_cast<const char*>(node->name));
-					result = false;
-				}
+
+			// Expand only the current child, it is released when the reader
+			// moves on
+			xmlNodePtr child = xmlTextReaderExpand(reader);
+			if ( child == nullptr ) {
+				result = false;
+				break;
 			}
-		}
-		catch ( std::exception &e ) {
-			SEISCOMP_WARNING("L%ld: %s: %s", xmlGetLineNo(child),
-			                 reinterpret_cast<const char*>(child->name), e.what());
-			if ( newTarget ) {
-				if ( newInstance )
-					delete newTarget;
 
-				if ( !optional ) {
-					SEISCOMP_WARNING("L%ld: %s is not optional within %s",
-					                 xmlGetLineNo(child),
-					                 reinterpret_cast<const char*>(child->name),
-					                 reinterpret_cast<const char*>(node->name));
-					result = false;
-				}
-				else
-					SEISCOMP_WARNING("L%ld: %s: ignoring optional member %s: invalid",
-					                 xmlGetLineNo(child),
-					                 reinterpret_cast<const char*>(node->name),
-					                 reinterpret_cast<const char*>(child->name));
+			if ( !traverseChild(objectHandler, node, child, object.get(),
+			                    remaining, mandatory, &handler) )
+				result = false;
 
-				newTarget = nullptr;
-			}
+			// Skip the subtree of the child
+			ret = xmlTextReaderNext(reader);
 		}
 
-		if ( memberHandler ) {
-			if ( !memberHandler->finalize(target, newTarget) ) {
-				if ( newTarget && newInstance )
-					remaining.push_back(newTarget);
-			}
+		if ( ret == -1 )
+			result = false;
+	}
+
+	objectHandler->finalize(object.get(), &remaining);
+
+	for ( ChildList::iterator it = remaining.begin(); it != remaining.end(); ++it )
+		if ( *it != nullptr ) delete *it;
+
+	if ( !mandatory.empty() ) {
+		std::string attribs;
+		for ( TagSet::iterator it = mandatory.begin(); it != mandatory.end(); ++it ) {
+			if ( it != mandatory.begin() ) attribs += ", ";
+			attribs += *it;
 		}
+		SEISCOMP_WARNING("L%d: %s: missing mandatory attribute%s: %s",
+		                 xmlTextReaderGetParserLineNumber(reader),
+		                 reinterpret_cast<const char*>(node->name),
+		                 mandatory.size() == 1?"":"s", attribs.c_str());
+		return false;
+	}
+
+	return result;
+}
+
+
+bool Importer::traverse(NodeHandler *handler, void *n, void *c, Core::BaseObject *target) {
+	xmlNodePtr node = reinterpret_cast<xmlNodePtr>(n);
+	xmlNodePtr childs = reinterpret_cast<xmlNodePtr>(c);
+	ChildList remaining;
+	TagSet mandatory;
+
+	handler->init(target, n, mandatory);
+
+	bool result = true;
+
+	for ( xmlNodePtr child = childs; child != nullptr; child = child->next ) {
+		if ( child->type != XML_ELEMENT_NODE ) continue;
+
+		if ( !traverseChild(handler, n, child, target, remaining, mandatory, nullptr) )
+			result = false;
 	}
 
 	handler->finalize(target, &remaining);
@@ -288,6 +350,129 @@ bool Importer::traverse(NodeHandler *handler, void *n, void *c, Core::BaseObject
 }
 
 
+
+bool Importer::traverseChild(NodeHandler *handler, void *n, void *c,
+                             Core::BaseObject *target,
+                             ChildList &remaining, TagSet &mandatory,
+                             const ObjectHandler *objectHandler) {
+	xmlNodePtr node = reinterpret_cast<xmlNodePtr>(n);
+	xmlNodePtr child = reinterpret_cast<xmlNodePtr>(c);
+	bool result = true;
+
+	handler->propagate(nullptr, false, true);
+
+	try {
+		handler->get(target, child);
+	}
+	catch ( std::exception &e ) {
+		if ( handler->isOptional )
+			SEISCOMP_WARNING("L%ld: (optional) %s.%s: %s",
+			                 xmlGetLineNo(node),
+			                 reinterpret_cast<const char*>(node->name),
+			                 reinterpret_cast<const char*>(child->name),
+			                 e.what());
+		else
+			throw e;
+	}
+
+	if ( !handler->isOptional )
+		mandatory.erase((const char*)child->name);
+
+	if ( handler->object == nullptr && handler->isAnyType ) {
+		if ( _any.get(target, child) ) {
+			handler->object = _any.object;
+			handler->childHandler = _any.childHandler;
+			handler->newInstance = _any.newInstance;
+		}
+	}
+
+	Core::BaseObject *newTarget = handler->object;
+	MemberNodeHandler *memberHandler = handler->memberHandler;
+	NodeHandler *childHandler = handler->childHandler;
+	bool newInstance = handler->newInstance;
+	bool optional = handler->isOptional;
+
+	if ( newTarget ) {
+		if ( childHandler == nullptr ) {
+			childHandler = _typemap->getHandler(newTarget->className());
+			if ( childHandler == nullptr ) {
+				SEISCOMP_WARNING("No class handler for %s", newTarget->className());
+				if ( newInstance )
+					delete newTarget;
+				handler->object = nullptr;
+				newTarget = nullptr;
+				childHandler = &_none;
+			}
+		}
+	}
+	else
+		childHandler = &_none;
+
+	try {
+		if ( traverse(childHandler, child, child->children, handler->object) ) {
+			if ( newTarget && newInstance && !memberHandler )
+				remaining.push_back(newTarget);
+
+		}
+		else {
+			if ( newTarget && newInstance )
+				delete newTarget;
+			newTarget = nullptr;
+			if ( optional )
+				SEISCOMP_INFO("L%ld: Invalid %s element: ignoring",
+				              xmlGetLineNo(child),
+				              reinterpret_cast<const char*>(child->name));
+			else {
+				SEISCOMP_WARNING("L%ld: %s is not optional within %s",
+				                 xmlGetLineNo(child),
+				                 reinterpret_cast<const char*>(child->name),
+				                 reinterpret_cast<const char*>(node->name));
+				result = false;
+			}
+		}
+	}
+	catch ( std::exception &e ) {
+		SEISCOMP_WARNING("L%ld: %s: %s", xmlGetLineNo(child),
+		                 reinterpret_cast<const char*>(child->name), e.what());
+		if ( newTarget ) {
+			if ( newInstance )
+				delete newTarget;
+
+			if ( !optional ) {
+				SEISCOMP_WARNING("L%ld: %s is not optional within %s",
+				                 xmlGetLineNo(child),
+				                 reinterpret_cast<const char*>(child->name),
+				                 reinterpret_cast<const char*>(node->name));
+				result = false;
+			}
+			else
+				SEISCOMP_WARNING("L%ld: %s: ignoring optional member %s: invalid",
+				                 xmlGetLineNo(child),
+				                 reinterpret_cast<const char*>(node->name),
+				                 reinterpret_cast<const char*>(child->name));
+
+			newTarget = nullptr;
+		}
+	}
+
+	if ( memberHandler ) {
+		if ( objectHandler && newTarget && newInstance &&
+		     isChildMember(handler, memberHandler) ) {
+			// The handler takes over the child instead of its parent
+			Core::BaseObjectPtr obj = newTarget;
+			if ( !(*objectHandler)(target, newTarget) )
+				_cancelled = true;
+		}
+		else if ( !memberHandler->finalize(target, newTarget) ) {
+			if ( newTarget && newInstance )
+				remaining.push_back(newTarget);
+		}
+	}
+
+	return result;
+}
+
+
 }
 }
 }
@@ -66,6 +66,10 @@ class SC_SYSTEM_CORE_API Importer : public IO::Importer {
 		//! Interface method that must be implemented by real importers.
 		virtual Core::BaseObject *get(std::streambuf* buf);
 
+		//! Reads the document incrementally and expands only one child
+		//! of the top-level objects at a time.
+		virtual bool get(std::streambuf* buf, const ObjectHandler &handler);
+
 
 	// ------------------------------------------------------------------
 	//  Private interface
@@ -75,6 +79,17 @@ class SC_SYSTEM_CORE_API Importer : public IO::Importer {
 		              void *node, void *childs,
 		              Core::BaseObject *target);
 
+		//! Reads a child node into target. If handler is set, children
+		//! of target are passed to it instead of being added.
+		bool traverseChild(NodeHandler *handler,
+		                   void *node, void *child,
+		                   Core::BaseObject *target,
+		                   ChildList &remaining, TagSet &mandatory,
+		                   const ObjectHandler *objectHandler);
+
+		//! Streams the top-level object the reader is positioned at
+		bool streamObject(void *reader, const ObjectHandler &handler);
+
 
 	private:
 		static NoneHandler _none;
@@ -82,6 +97,7 @@ class SC_SYSTEM_CORE_API Importer : public IO::Importer {
 		bool _strictNamespaceCheck;
 
 		Core::BaseObject *_result;
+		bool _cancelled;
 		std::string _headerNode;
 		TypeMap *_typemap;
 };
@@ -0,0 +1,283 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT log
+
+#include <seiscomp/logging/async.h>
+#include <seiscomp/logging/channel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace Seiscomp {
+namespace Logging {
+namespace {
+
+
+std::mutex registryMutex;
+std::vector<AsyncOutput*> registry;
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AsyncOutput::AsyncOutput(Output *target, size_t capacity)
+: _target(target) {
+	size_t size = 2;
+	while ( size < capacity ) size <<= 1;
+
+	_slots.reset(new Slot[size]);
+	_mask = size - 1;
+
+	for ( size_t i = 0; i < size; ++i ) {
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	{
+		std::lock_guard<std::mutex> l(registryMutex);
+		registry.push_back(this);
+	}
+
+	_thread = std::thread(&AsyncOutput::run, this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AsyncOutput::~AsyncOutput() {
+	// Stop receiving messages before shutting down the writer
+	clear();
+
+	{
+		std::lock_guard<std::mutex> l(registryMutex);
+		registry.erase(std::remove(registry.begin(), registry.end(), this),
+		               registry.end());
+	}
+
+	{
+		std::lock_guard<std::mutex> l(_wakeupMutex);
+		_running = false;
+	}
+
+	_wakeup.notify_one();
+
+	if ( _thread.joinable() ) {
+		_thread.join();
+	}
+
+	flush();
+
+	delete _target;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncOutput::flush(bool wait) {
+	if ( wait ) {
+		_consumerMutex.lock();
+	}
+	else {
+		int tries = 100;
+		while ( !_consumerMutex.try_lock() ) {
+			if ( !--tries ) return;
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+
+	while ( pop() );
+
+	_consumerMutex.unlock();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncOutput::FlushAll() {
+	// Do not block forever if the crash happened while holding the lock
+	std::unique_lock<std::mutex> l(registryMutex, std::try_to_lock);
+	if ( !l.owns_lock() ) return;
+
+	for ( auto output : registry ) {
+		output->flush(false);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncOutput::log(const char *, LogLevel, const char *, time_t) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncOutput::publish(const Data &data) {
+	if ( !push(data.publisher, data.time, data.msg) ) {
+		return;
+	}
+
+	if ( _sleeping.load() ) {
+		_wakeup.notify_one();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool AsyncOutput::push(PublishLoc *publisher, time_t time, const char *msg) {
+	size_t pos = _head.load(std::memory_order_relaxed);
+	Slot *slot;
+
+	// Bounded multi producer queue: each slot carries a sequence number
+	// which tells whether it is free for the position to be written.
+	while ( true ) {
+		slot = &_slots[pos & _mask];
+		size_t seq = slot->sequence.load(std::memory_order_acquire);
+		intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+		if ( diff == 0 ) {
+			if ( _head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+				break;
+			}
+		}
+		else if ( diff < 0 ) {
+			// Full
+			++_dropped;
+			return false;
+		}
+		else {
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->publisher = publisher;
+	slot->time = time;
+	// Reuses the capacity of the slot string after the first round
+	slot->msg.assign(msg);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool AsyncOutput::pop() {
+	// Precondition: _consumerMutex is locked
+	size_t pos = _tail.load(std::memory_order_relaxed);
+	Slot &slot = _slots[pos & _mask];
+
+	if ( slot.sequence.load(std::memory_order_acquire) != pos + 1 ) {
+		return false;
+	}
+
+	Data data;
+	data.publisher = slot.publisher;
+	data.time = slot.time;
+	data.msg = slot.msg.c_str();
+
+	// Node::publish is public and dispatches to the private Output
+	// implementation which sets the context for the target log call
+	static_cast<Node*>(_target)->publish(data);
+
+	slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+	_tail.store(pos + 1, std::memory_order_relaxed);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool AsyncOutput::empty() const {
+	size_t pos = _tail.load(std::memory_order_relaxed);
+	return _slots[pos & _mask].sequence.load(std::memory_order_acquire) != pos + 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncOutput::drain() {
+	{
+		std::lock_guard<std::mutex> l(_consumerMutex);
+		while ( pop() );
+	}
+
+	size_t dropped = _dropped;
+	if ( dropped != _reportedDrops ) {
+		// This is queued as any other message
+		SEISCOMP_WARNING("Asynchronous logging dropped %zu messages",
+		                 dropped - _reportedDrops);
+		_reportedDrops = dropped;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AsyncOutput::run() {
+	while ( _running ) {
+		drain();
+
+		std::unique_lock<std::mutex> l(_wakeupMutex);
+		_sleeping = true;
+		// A notification racing with going to sleep is caught by the
+		// timeout at the latest
+		_wakeup.wait_for(l, std::chrono::milliseconds(100), [this]() {
+			return !_running || !empty();
+		});
+		_sleeping = false;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
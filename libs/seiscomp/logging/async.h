@@ -0,0 +1,131 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SC_LOGGING_ASYNC_H
+#define SC_LOGGING_ASYNC_H
+
+#include <seiscomp/logging/output.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace Seiscomp {
+namespace Logging {
+
+
+/**
+ * \brief Asynchronous logging output
+ *
+ * This output queues each log message in a bounded lock-free ring buffer
+ * and forwards it to the wrapped output from a background thread. The
+ * logging thread therefore never blocks on the target, e.g. a slow disk.
+ * If the buffer is full, then the message is dropped and counted. The
+ * number of dropped messages is logged as soon as there is space again.
+ *
+ * The wrapped output must not be subscribed to any channel, the
+ * asynchronous output must be subscribed instead.
+ * \code
+ * AsyncOutput *log = new AsyncOutput(new FileOutput("app.log"));
+ * log->subscribe(GetAll());
+ * \endcode
+ */
+class SC_SYSTEM_CORE_API AsyncOutput : public Output {
+	public:
+		/**
+		 * @brief Constructs an asynchronous output and starts the writer
+		 *        thread.
+		 * @param target The output to forward messages to. The ownership
+		 *               is transferred.
+		 * @param capacity The number of messages that can be buffered.
+		 *                 It is rounded up to the next power of two.
+		 */
+		AsyncOutput(Output *target, size_t capacity = 4096);
+		~AsyncOutput() override;
+
+	public:
+		//! Returns the wrapped output
+		Output *target() const { return _target; }
+
+		//! Returns the number of dropped messages since construction
+		size_t droppedMessages() const { return _dropped; }
+
+		/**
+		 * @brief Writes all buffered messages in the calling thread.
+		 * @param wait Whether to wait for the writer thread if it is
+		 *             currently writing. If false then the writer thread
+		 *             is given approximately one second to finish.
+		 */
+		void flush(bool wait = true);
+
+		//! Flushes all asynchronous outputs, e.g. from a crash handler.
+		static void FlushAll();
+
+	protected:
+		//! Not used, messages are intercepted in publish
+		void log(const char* channelName,
+		         LogLevel level,
+		         const char* msg,
+		         time_t time) override;
+
+	private:
+		void publish(const Data &data) override;
+
+		bool push(PublishLoc *publisher, time_t time, const char *msg);
+		bool pop();
+		bool empty() const;
+		void drain();
+		void run();
+
+	private:
+		struct Slot {
+			std::atomic<size_t>  sequence;
+			PublishLoc          *publisher;
+			time_t               time;
+			std::string          msg;
+		};
+
+		Output                  *_target;
+		std::unique_ptr<Slot[]>  _slots;
+		size_t                   _mask;
+
+		alignas(64) std::atomic<size_t> _head{0};
+		alignas(64) std::atomic<size_t> _tail{0};
+
+		std::atomic<size_t>      _dropped{0};
+		size_t                   _reportedDrops{0};
+
+		std::mutex               _consumerMutex;
+		std::mutex               _wakeupMutex;
+		std::condition_variable  _wakeup;
+		std::atomic<bool>        _sleeping{false};
+		std::atomic<bool>        _running{true};
+		std::thread              _thread;
+};
+
+
+}
+}
+
+#endif
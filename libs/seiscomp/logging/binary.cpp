@@ -0,0 +1,280 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT log
+
+#include <seiscomp/logging/binary.h>
+#include <seiscomp/logging/channel.h>
+#include <seiscomp/logging/publishloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace Seiscomp {
+namespace Logging {
+namespace {
+
+
+const size_t MinimumSize = 4096;
+const size_t MaxStringLength = 0xffff;
+
+
+template <typename T>
+inline char *put(char *p, T value) {
+	memcpy(p, &value, sizeof(T));
+	return p + sizeof(T);
+}
+
+
+inline size_t stringLength(const char *str) {
+	return str ? std::min(strlen(str), MaxStringLength) : 0;
+}
+
+
+inline char *putString(char *p, const char *str, size_t len) {
+	p = put<uint16_t>(p, static_cast<uint16_t>(len));
+	if ( len ) memcpy(p, str, len);
+	return p + len;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *BinaryOutput::Magic = "SCBL";
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BinaryOutput::BinaryOutput() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BinaryOutput::~BinaryOutput() {
+	// Stop receiving messages before unmapping
+	clear();
+	close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BinaryOutput::open(const char *filename, size_t size) {
+	std::lock_guard<std::mutex> l(_mutex);
+
+	unmap();
+
+	_filename = filename;
+	_size = std::max(size, MinimumSize);
+
+	struct stat st;
+	if ( !stat(filename, &st) ) {
+		// Keep the previous trace
+		::rename(filename, (_filename + ".1").c_str());
+	}
+
+	return create();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BinaryOutput::close() {
+	std::lock_guard<std::mutex> l(_mutex);
+	unmap();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BinaryOutput::create() {
+	_fd = ::open(_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if ( _fd < 0 ) {
+		return false;
+	}
+
+	if ( ftruncate(_fd, _size) ) {
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+
+	void *data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+	if ( data == MAP_FAILED ) {
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+
+	_data = static_cast<char*>(data);
+
+	FileHeader *header = reinterpret_cast<FileHeader*>(_data);
+	memcpy(header->magic, Magic, sizeof(header->magic));
+	header->version = Version;
+	header->used = sizeof(FileHeader);
+
+	_locations.clear();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BinaryOutput::unmap() {
+	if ( !_data ) {
+		return;
+	}
+
+	uint64_t used = reinterpret_cast<FileHeader*>(_data)->used;
+	munmap(_data, _size);
+	_data = nullptr;
+
+	// Strip the unused space
+	if ( ftruncate(_fd, used) ) {}
+	::close(_fd);
+	_fd = -1;
+
+	_locations.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BinaryOutput::log(const char *channelName,
+                       LogLevel level,
+                       const char *msg,
+                       time_t) {
+	int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()
+	).count();
+
+	std::lock_guard<std::mutex> l(_mutex);
+
+	if ( !_data ) {
+		return;
+	}
+
+	const PublishLoc *loc = location();
+	size_t channelLength = stringLength(channelName);
+	size_t componentLength = stringLength(loc->component);
+	size_t fileLength = stringLength(loc->fileName);
+	size_t functionLength = stringLength(loc->functionName);
+
+	const size_t locationSize = 4 + 1 + 4 + 1 + 4
+	                          + 2 + channelLength + 2 + componentLength
+	                          + 2 + fileLength + 2 + functionLength;
+
+	// Each record must fit into an empty file
+	size_t msgLength = std::min(strlen(msg),
+	                            (_size - sizeof(FileHeader)) / 2);
+	const size_t messageSize = 4 + 1 + 4 + 8 + 4 + msgLength;
+
+	FileHeader *header = reinterpret_cast<FileHeader*>(_data);
+	auto it = _locations.find(loc);
+	size_t required = messageSize + (it == _locations.end() ? locationSize : 0);
+
+	if ( header->used + required > _size ) {
+		unmap();
+		::rename(_filename.c_str(), (_filename + ".1").c_str());
+		if ( !create() ) {
+			return;
+		}
+
+		header = reinterpret_cast<FileHeader*>(_data);
+		it = _locations.end();
+		required = messageSize + locationSize;
+
+		if ( header->used + required > _size ) {
+			msgLength = 0;
+		}
+	}
+
+	uint32_t id;
+
+	if ( it == _locations.end() ) {
+		id = static_cast<uint32_t>(_locations.size());
+		_locations[loc] = id;
+
+		char *p = _data + header->used;
+		p = put<uint32_t>(p, static_cast<uint32_t>(locationSize));
+		p = put<uint8_t>(p, LocationRecord);
+		p = put<uint32_t>(p, id);
+		p = put<uint8_t>(p, static_cast<uint8_t>(level));
+		p = put<uint32_t>(p, static_cast<uint32_t>(loc->lineNum));
+		p = putString(p, channelName, channelLength);
+		p = putString(p, loc->component, componentLength);
+		p = putString(p, loc->fileName, fileLength);
+		p = putString(p, loc->functionName, functionLength);
+		header->used += locationSize;
+	}
+	else {
+		id = it->second;
+	}
+
+	char *p = _data + header->used;
+	p = put<uint32_t>(p, static_cast<uint32_t>(4 + 1 + 4 + 8 + 4 + msgLength));
+	p = put<uint8_t>(p, MessageRecord);
+	p = put<uint32_t>(p, id);
+	p = put<int64_t>(p, now);
+	p = put<uint32_t>(p, static_cast<uint32_t>(msgLength));
+	memcpy(p, msg, msgLength);
+
+	// The record becomes visible to a reader of the file only after it is
+	// complete
+	header->used += 4 + 1 + 4 + 8 + 4 + msgLength;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,110 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SC_LOGGING_BINARY_H
+#define SC_LOGGING_BINARY_H
+
+#include <seiscomp/logging/output.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+namespace Seiscomp {
+namespace Logging {
+
+
+/**
+ * \brief Binary logging output
+ *
+ * This output writes log entries as compact binary records into a memory
+ * mapped file. The source location of a log statement (channel, component,
+ * file, function and line) is written only once per file and referenced by
+ * each message record which holds a timestamp in microseconds and the
+ * message. If the file is full, it is renamed to [filename].1 and a new file
+ * is started. The records are written in host byte order and can be
+ * rendered with sclogdecode.
+ *
+ * File layout: FileHeader followed by records. Each record starts with its
+ * size (uint32) including the size field and its type (uint8):
+ * - LocationRecord: id (uint32), level (uint8), line (uint32) and the
+ *   strings channel, component, file and function each prefixed by their
+ *   length (uint16)
+ * - MessageRecord: location id (uint32), time in microseconds since
+ *   epoch (int64) and the message prefixed by its length (uint32)
+ */
+class SC_SYSTEM_CORE_API BinaryOutput : public Output {
+	public:
+		struct FileHeader {
+			char     magic[4];
+			uint32_t version;
+			//! The number of bytes used including the header
+			uint64_t used;
+		};
+
+		enum RecordType {
+			LocationRecord = 1,
+			MessageRecord = 2
+		};
+
+		static const char *Magic;
+		static const uint32_t Version = 1;
+
+	public:
+		BinaryOutput();
+		~BinaryOutput() override;
+
+	public:
+		/**
+		 * @brief Opens a binary log file. An existing file is rotated.
+		 * @param filename The filename
+		 * @param size The size of the file in bytes
+		 * @return Success flag
+		 */
+		bool open(const char *filename, size_t size = 64 * 1024 * 1024);
+		void close();
+		bool isOpen() const { return _data != nullptr; }
+
+	protected:
+		void log(const char* channelName,
+		         LogLevel level,
+		         const char* msg,
+		         time_t time) override;
+
+	private:
+		bool create();
+		void unmap();
+
+	private:
+		std::mutex     _mutex;
+		std::string    _filename;
+		size_t         _size{0};
+		int            _fd{-1};
+		char          *_data{nullptr};
+		std::unordered_map<const PublishLoc*, uint32_t> _locations;
+};
+
+
+}
+}
+
+#endif
@@ -46,7 +46,7 @@ namespace Logging {
 
 
 	// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-PublishLoc::PublishLoc(bool *enabled, const char *component,
+PublishLoc::PublishLoc(std::atomic<bool> *enabled, const char *component,
                        const char *fileName, const char *functionName,
                        int lineNum, Channel *channel)
 : enabled(enabled)
@@ -58,7 +58,7 @@ PublishLoc::PublishLoc(bool *enabled, const char *component,
 	static std::mutex registrationLock;
 	std::lock_guard<std::mutex> lock(registrationLock);
 	pub = new Publisher(this);
-	*enabled = pub->enabled();
+	enabled->store(pub->enabled(), std::memory_order_relaxed);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
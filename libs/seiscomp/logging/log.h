@@ -81,16 +81,33 @@ enum LogLevel {
 # define SEISCOMP_LOGGING_CURRENT_FUNCTION "[unknown]"
 #endif
 
+/* The most verbose log level which is compiled in. Statements of the
+   predefined levels above are removed at compile time including the
+   evaluation of their arguments, e.g. -DSEISCOMP_LOG_LEVEL=5 strips all
+   SEISCOMP_DEBUG statements. The values correspond to LogLevel.
+ */
+#ifndef SEISCOMP_LOG_LEVEL
+#  define SEISCOMP_LOG_LEVEL Seiscomp::Logging::LL_DEBUG
+#endif
+
+/* The enabled flag of a call site is updated whenever an output subscribes
+   or unsubscribes. It is checked again after the registration of the call
+   site to not format messages which nobody receives.
+ */
 #define SEISCOMP_LOGGING_CALL(ID, COMPONENT, CHANNEL, FUNC, ...) \
-	static bool ID ## _enabled = true; \
-	if ( unlikely(ID ## _enabled) ) { \
+	static std::atomic<bool> ID ## _enabled{true}; \
+	if ( unlikely(ID ## _enabled.load(std::memory_order_relaxed)) ) { \
 		static Seiscomp::Logging::PublishLoc ID(& ID ## _enabled, \
 			STR(COMPONENT), __FILE__, \
 			SEISCOMP_LOGGING_CURRENT_FUNCTION, \
 			__LINE__, CHANNEL); \
-		FUNC(&ID, CHANNEL, ##__VA_ARGS__); \
+		if ( ID ## _enabled.load(std::memory_order_relaxed) ) \
+			FUNC(&ID, CHANNEL, ##__VA_ARGS__); \
 	}
 
+#define _sclevel(LEVEL, STMT) \
+	do { if ( Seiscomp::Logging::LEVEL <= SEISCOMP_LOG_LEVEL ) STMT; } while(0)
+
 
 #define _scplain(ID, CHANNEL, MSG) \
 	do { SEISCOMP_LOGGING_CALL(ID, SEISCOMP_COMPONENT, CHANNEL, Seiscomp::Logging::Publish, MSG) } while(0)
@@ -130,13 +147,13 @@ enum LogLevel {
     Note that unless there are subscribers to this message, it will do nothing.
 */
 #define SEISCOMP_DEBUG(...) \
-	_scprintf(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, ##__VA_ARGS__)
+	_sclevel(LL_DEBUG, _scprintf(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, ##__VA_ARGS__))
 
 #define SC_FMT_DEBUG(...) \
-	_scfmt(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, ##__VA_ARGS__)
+	_sclevel(LL_DEBUG, _scfmt(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, ##__VA_ARGS__))
 
 #define SEISCOMP_VDEBUG(format, args) \
-	_scv(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, format, args)
+	_sclevel(LL_DEBUG, _scv(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, format, args))
 
 /*! @def SEISCOMP_INFO(format, ...)
     @brief Log a message to the "info" channel.  Takes printf style arguments.
@@ -152,13 +169,13 @@ enum LogLevel {
     Note that unless there are subscribers to this message, it will do nothing.
 */
 #define SEISCOMP_INFO(...) \
-	_scprintf(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, ##__VA_ARGS__)
+	_sclevel(LL_INFO, _scprintf(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, ##__VA_ARGS__))
 
 #define SC_FMT_INFO(...) \
-	_scfmt(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, ##__VA_ARGS__)
+	_sclevel(LL_INFO, _scfmt(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, ##__VA_ARGS__))
 
 #define SEISCOMP_VINFO(format, args) \
-	_scv(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, format, args)
+	_sclevel(LL_INFO, _scv(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, format, args))
 
 /*! @def SEISCOMP_WARNING(format, ...)
     @brief Log a message to the "warning" channel.  Takes printf style
@@ -178,13 +195,13 @@ enum LogLevel {
     Note that unless there are subscribers to this message, it will do nothing.
 */
 #define SEISCOMP_WARNING(...) \
-	_scprintf(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, ##__VA_ARGS__)
+	_sclevel(LL_WARNING, _scprintf(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, ##__VA_ARGS__))
 
 #define SC_FMT_WARNING(...) \
-	_scfmt(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, ##__VA_ARGS__)
+	_sclevel(LL_WARNING, _scfmt(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, ##__VA_ARGS__))
 
 #define SEISCOMP_VWARNING(format, args) \
-	_scv(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, format, args)
+	_sclevel(LL_WARNING, _scv(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, format, args))
 
 /*! @def SEISCOMP_ERROR(...)
     @brief Log a message to the "error" channel. Takes printf style arguments.
@@ -202,13 +219,13 @@ enum LogLevel {
     Note that unless there are subscribers to this message, it will do nothing.
 */
 #define SEISCOMP_ERROR(...) \
-	_scprintf(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, ##__VA_ARGS__)
+	_sclevel(LL_ERROR, _scprintf(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, ##__VA_ARGS__))
 
 #define SC_FMT_ERROR(...) \
-	_scfmt(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, ##__VA_ARGS__)
+	_sclevel(LL_ERROR, _scfmt(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, ##__VA_ARGS__))
 
 #define SEISCOMP_VERROR(format, args) \
-	_scv(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, format, args)
+	_sclevel(LL_ERROR, _scv(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, format, args))
 
 /*! @def SEISCOMP_NOTICE(...)
     @brief Log a message to the "notice" channel. Takes printf style arguments.
@@ -226,13 +243,13 @@ enum LogLevel {
     Note that unless there are subscribers to this message, it will do nothing.
 */
 #define SEISCOMP_NOTICE(...) \
-  _scprintf(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, ##__VA_ARGS__)
+	_sclevel(LL_NOTICE, _scprintf(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, ##__VA_ARGS__))
 
 #define SC_FMT_NOTICE(...) \
-	_scfmt(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, ##__VA_ARGS__)
+	_sclevel(LL_NOTICE, _scfmt(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, ##__VA_ARGS__))
 
 #define SEISCOMP_VNOTICE(format, args) \
-	_scv(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, format, args)
+	_sclevel(LL_NOTICE, _scv(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, format, args))
 
 /*! @def SEISCOMP_LOG(channel,format,...)
     @brief Log a message to a user defined channel. Takes a channel and printf
@@ -311,19 +328,19 @@ enum LogLevel {
 
 
 #define SEISCOMP_DEBUG_S(str) \
-	_scplain(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, str)
+	_sclevel(LL_DEBUG, _scplain(_SCLOGID, Seiscomp::Logging::_SCDebugChannel, str))
 
 #define SEISCOMP_INFO_S(str) \
-	_scplain(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, str)
+	_sclevel(LL_INFO, _scplain(_SCLOGID, Seiscomp::Logging::_SCInfoChannel, str))
 
 #define SEISCOMP_WARNING_S(str) \
-	_scplain(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, str)
+	_sclevel(LL_WARNING, _scplain(_SCLOGID, Seiscomp::Logging::_SCWarningChannel, str))
 
 #define SEISCOMP_ERROR_S(str) \
-	_scplain(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, str)
+	_sclevel(LL_ERROR, _scplain(_SCLOGID, Seiscomp::Logging::_SCErrorChannel, str))
 
 #define SEISCOMP_NOTICE_S(str) \
-	_scplain(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, str)
+	_sclevel(LL_NOTICE, _scplain(_SCLOGID, Seiscomp::Logging::_SCNoticeChannel, str))
 
 #define SEISCOMP_LOG_S(channel, str) \
 	_scplain(_SCLOGID, channel, str)
@@ -73,6 +73,9 @@ class SC_SYSTEM_CORE_API Output : public Node {
 		const char* functionName() const;
 		/** Returns the line number of the current log entry */
 		int lineNum() const;
+		/** Returns the location of the current log entry which is unique
+		    for each log statement */
+		const PublishLoc *location() const { return _publisher; }
 
 	private:
 		void publish(const Data &data);
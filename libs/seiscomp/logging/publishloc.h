@@ -27,6 +27,7 @@
 #include <fmt/format.h>
 #include <fmt/printf.h>
 
+#include <atomic>
 #include <cstdarg>
 
 
@@ -51,12 +52,12 @@ struct SC_SYSTEM_CORE_API PublishLoc {
     to be initialized at run-time which adds extra code and a guard variable
     for the struct.
  */
-	PublishLoc(bool *enabled, const char *component,
+	PublishLoc(std::atomic<bool> *enabled, const char *component,
 	           const char *fileName, const char *functionName,
 	           int lineNum, Channel *channel);
 	~PublishLoc();
 
-	bool *enabled;
+	std::atomic<bool> *enabled;
 
 	Node *pub;
 	const char *component;
@@ -65,9 +66,9 @@ struct SC_SYSTEM_CORE_API PublishLoc {
 	int lineNum;
 	Channel *channel;
 
-	inline void enable() { *enabled = true; }
-	inline void disable() { *enabled = false; }
-	inline bool isEnabled() { return *enabled; }
+	inline void enable() { enabled->store(true, std::memory_order_relaxed); }
+	inline void disable() { enabled->store(false, std::memory_order_relaxed); }
+	inline bool isEnabled() { return enabled->load(std::memory_order_relaxed); }
 };
 
 
@@ -0,0 +1,143 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/math/aic.h>
+
+#include <cmath>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Math {
+namespace {
+
+
+int aicFromEnergy(int n, const std::vector<double> &energy, int margin,
+                  double *aic) {
+	int imin = margin, imax = n-margin;
+	if ( imin < 2 || imax <= imin ) return -1;
+
+	// Suffix sums are accumulated from the end rather than subtracting the
+	// leading energy from the total which loses precision on the small
+	// trailing sums of a trace with a large dynamic range.
+	std::vector<double> suffix(n+1, 0.0);
+	for ( int i = n-1; i >= 0; --i )
+		suffix[i] = suffix[i+1] + energy[i];
+
+	double prefix = 0;
+	for ( int i = 0; i < imin; ++i )
+		prefix += energy[i];
+
+	double minaic = 0;
+	int kmin = -1;
+
+	for ( int k = imin; k < imax; ++k ) {
+		double var1 = prefix/(k-1),
+		       var2 = suffix[k]/(n-k-1);
+		double value = k*log10(var1) + (n-k-1)*log10(var2);
+
+		prefix += energy[k];
+
+		if ( aic ) aic[k] = value;
+
+		// Windows without energy have no defined AIC
+		if ( !(var1 > 0) || !(var2 > 0) ) continue;
+
+		if ( kmin < 0 || value < minaic ) {
+			minaic = value;
+			kmin = k;
+		}
+	}
+
+	if ( aic ) {
+		double maxaic = aic[imin] > aic[imax-1] ? aic[imin] : aic[imax-1];
+		for ( int k = 0; k < imin; ++k )
+			aic[k] = aic[n-k-1] = maxaic;
+	}
+
+	return kmin;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int maedaAIC(int n, const double *data, int margin, double *aic) {
+	if ( n <= 0 ) return -1;
+
+	std::vector<double> energy(n);
+	for ( int i = 0; i < n; ++i )
+		energy[i] = data[i]*data[i];
+
+	return aicFromEnergy(n, energy, margin, aic);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int maedaAIC(int n, int channels, const double * const *data, int margin,
+             double *aic) {
+	if ( n <= 0 || channels <= 0 ) return -1;
+
+	std::vector<double> energy(n, 0.0);
+	for ( int c = 0; c < channels; ++c ) {
+		const double *channel = data[c];
+		for ( int i = 0; i < n; ++i )
+			energy[i] += channel[i]*channel[i];
+	}
+
+	return aicFromEnergy(n, energy, margin, aic);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double maedaAICSNR(int n, const double *data, int onset, int margin) {
+	double noise = 0, signal = 0;
+
+	for ( int i = margin; i < onset; ++i )
+		noise += data[i]*data[i];
+
+	noise = sqrt(noise / (onset-margin));
+
+	for ( int i = onset; i < n-margin; ++i ) {
+		double a = fabs(data[i]);
+		if ( a > signal )
+			signal = a;
+	}
+
+	return 0.707 * signal / noise;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_MATH_AIC_H
+#define SEISCOMP_MATH_AIC_H
+
+
+#include <seiscomp/core.h>
+
+
+namespace Seiscomp {
+namespace Math {
+
+
+/**
+ * @brief Computes the Akaike Information Criterion of a trace after
+ *        Maeda (1985), see also Zhang et al. (2003), BSSA.
+ *
+ * The AIC at sample k is k*log10(var(x[0..k-1])) + (n-k-1)*log10(var(x[k..n-1])).
+ * The variances are derived from prefix and suffix sums of the energy
+ * in O(n). The trace is expected to be filtered and demeaned.
+ * @param n The number of samples
+ * @param data The samples
+ * @param margin The number of samples at either end which are not
+ *               considered as onset
+ * @param aic Optional output array of n values receiving the AIC. The
+ *            margins are set to the maximum of the AIC at the margins.
+ * @return The index of the AIC minimum or -1 if there is no valid onset
+ */
+SC_SYSTEM_CORE_API
+int maedaAIC(int n, const double *data, int margin = 10, double *aic = nullptr);
+
+/**
+ * @brief Computes the AIC of several channels, e.g. the components of a
+ *        station, at once.
+ *
+ * The energy of all channels is summed which is equivalent to the AIC of
+ * the L2 norm of the channels.
+ * @param n The number of samples of each channel
+ * @param channels The number of channels
+ * @param data The samples of each channel
+ * @param margin The number of samples at either end which are not
+ *               considered as onset
+ * @param aic Optional output array of n values receiving the AIC
+ * @return The index of the AIC minimum or -1 if there is no valid onset
+ */
+SC_SYSTEM_CORE_API
+int maedaAIC(int n, int channels, const double * const *data, int margin = 10,
+             double *aic = nullptr);
+
+/**
+ * @brief Returns the signal-to-noise ratio at an AIC onset, the peak
+ *        amplitude after the onset relative to the RMS before the onset.
+ * @param n The number of samples
+ * @param data The samples
+ * @param onset The index of the onset
+ * @param margin The number of samples at either end which are ignored
+ * @return The signal-to-noise ratio
+ */
+SC_SYSTEM_CORE_API
+double maedaAICSNR(int n, const double *data, int onset, int margin = 10);
+
+
+}
+}
+
+
+#endif
@@ -22,6 +22,10 @@
 #include <seiscomp/math/fft.h>
 #include <seiscomp/math/filter.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 
 #define TWO_PI (M_PI*2)
 
@@ -46,7 +50,6 @@ namespace Seiscomp {
 namespace Math {
 
 
-#ifndef MATH_USE_FFTW3
 namespace {
 
 
@@ -56,44 +59,152 @@ enum FFTDirection {
 };
 
 
+#ifdef MATH_USE_FFTW3
+//! The fftw plan of one length and direction. Plans are created for
+//! in-place transforms of unaligned data and executed with the new-array
+//! execute functions.
+struct Plan {
+	Plan(int n, FFTDirection dir) {
+		double *tmp = reinterpret_cast<double*>(fftw_malloc(sizeof(double)*(n+2)));
+		if ( dir == Forward )
+			plan = fftw_plan_dft_r2c_1d(n, tmp, reinterpret_cast<fftw_complex*>(tmp),
+			                            FFTW_ESTIMATE | FFTW_UNALIGNED);
+		else
+			plan = fftw_plan_dft_c2r_1d(n, reinterpret_cast<fftw_complex*>(tmp), tmp,
+			                            FFTW_ESTIMATE | FFTW_UNALIGNED);
+		fftw_free(tmp);
+	}
+
+	~Plan() {
+		fftw_destroy_plan(plan);
+	}
+
+	fftw_plan plan;
+};
+#else
+//! The tables of a transform of n real samples. The twiddle factors are
+//! computed with the same recurrences as the transform used before, so the
+//! results do not change. The backward transform uses the conjugates.
+struct Plan {
+	Plan(int n, FFTDirection) {
+		int nn = n; // twice the number of complex points
+		int i, j, m, mmax, istep;
+		double wtemp, wr, wpr, wpi, wi, theta;
+
+		j = 1;
+		for ( i = 1; i < nn; i += 2 ) {
+			if ( j > i ) {
+				swaps.push_back(i);
+				swaps.push_back(j);
+			}
+
+			m = nn >> 1;
+			while ( m >= 2 && j > m ) {
+				j -= m;
+				m >>= 1;
+			}
+
+			j += m;
+		}
+
+		mmax = 2;
+		while ( nn > mmax ) {
+			istep = 2*mmax;
+			theta = TWO_PI/mmax;
+			wtemp = sin(0.5*theta);
+			wpr = -2.0*wtemp*wtemp;
+			wpi = sin(theta);
+			wr = 1.0;
+			wi = 0.0;
+
+			for ( m = 1; m < mmax; m += 2 ) {
+				fourierTwiddles.push_back(wr);
+				fourierTwiddles.push_back(wi);
+				wr = (wtemp=wr)*wpr-wi*wpi+wr;
+				wi = wi*wpr+wtemp*wpi+wi;
+			}
+
+			mmax = istep;
+		}
+
+		nn = n / 2;
+		theta = M_PI/(double)nn;
+		wtemp = sin(0.5*theta);
+		wpr = -2.0*wtemp*wtemp;
+		wpi = sin(theta);
+		wr = 1.0+wpr;
+		wi = wpi;
+		for ( i = 2; i <= nn/2; ++i ) {
+			realTwiddles.push_back(wr);
+			realTwiddles.push_back(wi);
+			wr = (wtemp = wr)*wpr-wi*wpi+wr;
+			wi = wi*wpr+wtemp*wpi+wi;
+		}
+	}
+
+	// Pairs of (1-based) indices to swap for the bit reversal
+	std::vector<int>    swaps;
+	// Pairs of (wr, wi) per butterfly group of all stages
+	std::vector<double> fourierTwiddles;
+	// Pairs of (wr, wi) to separate the spectrum of the real data
+	std::vector<double> realTwiddles;
+};
+#endif
+
+
+typedef std::shared_ptr<const Plan> PlanPtr;
+
+std::mutex planMutex;
+std::map<int, PlanPtr> plans;
+
+
+//! Returns the cached plan of length n. The transform lengths are powers of
+//! two, so the cache holds only a few entries.
+PlanPtr getPlan(int n, FFTDirection dir) {
+#ifdef MATH_USE_FFTW3
+	int key = dir == Forward ? n : -n;
+#else
+	int key = n;
+#endif
+
+	// This also serializes the fftw planner which is not thread safe
+	std::lock_guard<std::mutex> lock(planMutex);
+	PlanPtr &plan = plans[key];
+	if ( !plan )
+		plan = make_shared<Plan>(n, dir);
+	return plan;
+}
+
+
+#ifndef MATH_USE_FFTW3
 
 #define SWAP(a,b) tempr=(a);(a)=(b);(b)=tempr
 
 template <typename T>
-void fourier(T *data, int nn, int isign) {
+void fourier(T *data, int nn, const Plan &plan, int isign) {
 	int n,mmax,m,j,istep,i;
-	double wtemp,wr,wpr,wpi,wi,theta;
+	double wr,wi;
 	T tempr,tempi;
 
 	n = nn << 1;
-	j = 1;
-
-	for ( i = 1; i < n; i += 2 ) {
-		if ( j > i ) {
-			SWAP(data[j],data[i]);
-			SWAP(data[j+1],data[i+1]);
-		}
-
-		m = n >> 1;
-		while ( m >= 2 && j > m ) {
-			j -= m;
-			m >>= 1;
-		}
 
-		j += m;
+	for ( size_t k = 0; k < plan.swaps.size(); k += 2 ) {
+		i = plan.swaps[k];
+		j = plan.swaps[k+1];
+		SWAP(data[j],data[i]);
+		SWAP(data[j+1],data[i+1]);
 	}
 
+	const double *tw = plan.fourierTwiddles.data();
+
 	mmax = 2;
 	while ( n > mmax ) {
 		istep = 2*mmax;
-		theta = TWO_PI/(isign*mmax);
-		wtemp = sin(0.5*theta);
-		wpr = -2.0*wtemp*wtemp;
-		wpi = sin(theta);
-		wr = 1.0;
-		wi = 0.0;
 
-		for ( m = 1; m < mmax; m +=2 ) {
+		for ( m = 1; m < mmax; m += 2, tw += 2 ) {
+			wr = tw[0];
+			wi = isign*tw[1];
+
 			for ( i = m; i <= n; i += istep ) {
 				j = i+mmax;
 				tempr = wr*data[j]-wi*data[j+1];
@@ -103,9 +214,6 @@ void fourier(T *data, int nn, int isign) {
 				data[i] += tempr;
 				data[i+1] += tempi;
 			}
-
-			wr = (wtemp=wr)*wpr-wi*wpi+wr;
-			wi = wi*wpr+wtemp*wpi+wi;
 		}
 
 		mmax=istep;
@@ -116,7 +224,7 @@ void fourier(T *data, int nn, int isign) {
 
 
 template <typename T>
-void transform(T *data, int n, FFTDirection dir) {
+void transform(T *data, int n, const Plan &plan, FFTDirection dir) {
 	if ( n < 4 ) return;
 
 	--data;
@@ -124,25 +232,24 @@ void transform(T *data, int n, FFTDirection dir) {
 
 	int i,i1,i2,i3,i4,n2p3;
 	T c1 = 0.5,c2,h1r,h1i,h2r,h2i;
-	double wr,wi,wpr,wpi,wtemp,theta;
+	double wr,wi,wsign;
 
-	theta = M_PI/(double)n;
 	if ( dir == Forward ) {
 		c2 = -0.5;
-		fourier(data,n,1);
+		wsign = 1;
+		fourier(data,n,plan,1);
 	}
 	else {
 		c2 = 0.5;
-		theta = -theta;
+		wsign = -1;
 	}
 
-	wtemp = sin(0.5*theta);
-	wpr = -2.0*wtemp*wtemp;
-	wpi = sin(theta);
-	wr = 1.0+wpr;
-	wi = wpi;
+	const double *tw = plan.realTwiddles.data();
+
 	n2p3 = 2*n+3;
-	for ( i = 2; i <= n/2; ++i ) {
+	for ( i = 2; i <= n/2; ++i, tw += 2 ) {
+		wr = tw[0];
+		wi = wsign*tw[1];
 		i4 = 1+(i3 = n2p3-(i2=1+(i1 = i+i-1)));
 		h1r = c1*(data[i1]+data[i3]);
 		h1i = c1*(data[i2]-data[i4]);
@@ -152,8 +259,6 @@ void transform(T *data, int n, FFTDirection dir) {
 		data[i2] = h1i+wr*h2i+wi*h2r;
 		data[i3] = h1r-wr*h2r+wi*h2i;
 		data[i4] = -h1i+wr*h2i+wi*h2r;
-		wr = (wtemp = wr)*wpr-wi*wpi+wr;
-		wi = wi*wpr+wtemp*wpi+wi;
 	}
 
 	if ( dir == Forward ) {
@@ -163,29 +268,20 @@ void transform(T *data, int n, FFTDirection dir) {
 	else {
 		data[1] = c1*((h1r = data[1])+data[2]);
 		data[2] = c1*(h1r-data[2]);
-		fourier(data,n,-1);
+		fourier(data,n,plan,-1);
 	}
 }
 
-
-}
 #endif
 
 
-//!
-//! input:  half complex spectrum, N/2+1 Points
-//! output: real data, N points
-//!
 template <typename T>
-void ifft(int n, T *out, ComplexArray &coeff) {
+void inverse(int n, T *out, ComplexArray &coeff, const Plan *plan) {
 	int tn = coeff.size()*2;
 	double *inout = reinterpret_cast<double*>(&coeff[0]);
 
 #ifdef MATH_USE_FFTW3
-	fftw_plan backward = fftw_plan_dft_c2r_1d(tn, (fftw_complex *)inout, inout,
-	                                          FFTW_ESTIMATE);
-	fftw_execute(backward);
-	fftw_destroy_plan(backward);
+	fftw_execute_dft_c2r(plan->plan, (fftw_complex *)inout, inout);
 
 	tn -= 2;
 	for ( int i = 0; i < n; ++i )
@@ -195,7 +291,8 @@ void ifft(int n, T *out, ComplexArray &coeff) {
 	for ( int i = 3; i < tn; i += 2 )
 		inout[i] *= -1;
 
-	transform(inout, tn, Backward); // do inverse FFT
+	if ( plan )
+		transform(inout, tn, *plan, Backward); // do inverse FFT
 
 	double norm = 2.0 / (double)tn;
 	for ( int i = 0; i < n; ++i )
@@ -204,17 +301,8 @@ void ifft(int n, T *out, ComplexArray &coeff) {
 }
 
 
-
-//!
-//! wrapper for the NR "realft" FFT routine
-//! input: real data, N points
-//! output: half complex spectrum, N/2+1 Points
-//!
 template <typename T>
-void fft(ComplexArray &out, int n, const T *data) {
-	int fftn = /*npow2?*/Filtering::next_power_of_2(n)/*:n*/;
-	if ( fftn <= 0 ) return;
-
+void forward(ComplexArray &out, int n, const T *data, int fftn, const Plan *plan) {
 #ifdef MATH_USE_FFTW3
 	out.resize(fftn/2+1);
 #else
@@ -230,12 +318,10 @@ void fft(ComplexArray &out, int n, const T *data) {
 		inout[i] = 0.0;
 
 #ifdef MATH_USE_FFTW3
-	fftw_plan forward = fftw_plan_dft_r2c_1d(fftn, inout, (fftw_complex *)inout,
-	                                         FFTW_ESTIMATE);
-	fftw_execute(forward);
-	fftw_destroy_plan(forward);
+	fftw_execute_dft_r2c(plan->plan, inout, (fftw_complex *)inout);
 #else
-	transform(inout, fftn, Forward); // do FFT
+	if ( plan )
+		transform(inout, fftn, *plan, Forward); // do FFT
 
 	// Swap sign of imaginary part
 	for ( int i = 3; i < fftn; i += 2 )
@@ -244,6 +330,86 @@ void fft(ComplexArray &out, int n, const T *data) {
 }
 
 
+//! Returns the plan of the inverse transform of a spectrum of the given
+//! size or nullptr if no transform is required.
+PlanPtr inversePlan(size_t size) {
+	int tn = size*2;
+#ifndef MATH_USE_FFTW3
+	if ( tn < 4 ) return nullptr;
+#endif
+	return getPlan(tn, Backward);
+}
+
+
+//! Returns the plan of the forward transform of fftn samples or nullptr
+//! if no transform is required.
+PlanPtr forwardPlan(int fftn) {
+#ifndef MATH_USE_FFTW3
+	if ( fftn < 4 ) return nullptr;
+#endif
+	return getPlan(fftn, Forward);
+}
+
+
+}
+
+
+//!
+//! input:  half complex spectrum, N/2+1 Points
+//! output: real data, N points
+//!
+template <typename T>
+void ifft(int n, T *out, ComplexArray &coeff) {
+	PlanPtr plan = inversePlan(coeff.size());
+	inverse(n, out, coeff, plan.get());
+}
+
+
+template <typename T>
+void ifft(int count, int n, T *const *out, std::vector<ComplexArray> &spectra) {
+	PlanPtr plan;
+	size_t size = 0;
+
+	for ( int i = 0; i < count; ++i ) {
+		if ( !plan || spectra[i].size() != size ) {
+			size = spectra[i].size();
+			plan = inversePlan(size);
+		}
+
+		inverse(n, out[i], spectra[i], plan.get());
+	}
+}
+
+
+
+//!
+//! wrapper for the NR "realft" FFT routine
+//! input: real data, N points
+//! output: half complex spectrum, N/2+1 Points
+//!
+template <typename T>
+void fft(ComplexArray &out, int n, const T *data) {
+	int fftn = /*npow2?*/Filtering::next_power_of_2(n)/*:n*/;
+	if ( fftn <= 0 ) return;
+
+	PlanPtr plan = forwardPlan(fftn);
+	forward(out, n, data, fftn, plan.get());
+}
+
+
+template <typename T>
+void fft(std::vector<ComplexArray> &spectra, int count, int n, const T *const *data) {
+	int fftn = Filtering::next_power_of_2(n);
+	if ( fftn <= 0 ) return;
+
+	PlanPtr plan = forwardPlan(fftn);
+
+	spectra.resize(count);
+	for ( int i = 0; i < count; ++i )
+		forward(spectra[i], n, data[i], fftn, plan.get());
+}
+
+
 // Explicit template instantiation for float and double types
 template SC_SYSTEM_CORE_API
 void ifft<float>(int n, float *out, ComplexArray &coeff);
@@ -251,12 +417,24 @@ void ifft<float>(int n, float *out, ComplexArray &coeff);
 template SC_SYSTEM_CORE_API
 void ifft<double>(int n, double *out, ComplexArray &coeff);
 
+template SC_SYSTEM_CORE_API
+void ifft<float>(int count, int n, float *const *out, std::vector<ComplexArray> &spectra);
+
+template SC_SYSTEM_CORE_API
+void ifft<double>(int count, int n, double *const *out, std::vector<ComplexArray> &spectra);
+
 template SC_SYSTEM_CORE_API
 void fft<float>(ComplexArray &out, int n, const float *data);
 
 template SC_SYSTEM_CORE_API
 void fft<double>(ComplexArray &out, int n, const double *data);
 
+template SC_SYSTEM_CORE_API
+void fft<float>(std::vector<ComplexArray> &spectra, int count, int n, const float *const *data);
+
+template SC_SYSTEM_CORE_API
+void fft<double>(std::vector<ComplexArray> &spectra, int count, int n, const double *const *data);
+
 
 }
 }
@@ -60,6 +60,12 @@ inline void fft(Seiscomp::ComplexDoubleArray &spec, const DoubleArray &data) {
 }
 
 
+//! Computes the spectra of count sequences of n samples each. The
+//! transforms share the cached tables of their length.
+template <typename T>
+void fft(std::vector<ComplexArray> &spectra, int count, int n, const T *const *data);
+
+
 template <typename T>
 void ifft(int n, T *out, ComplexArray &spec);
 
@@ -82,6 +88,11 @@ inline void ifft(DoubleArray &out, Seiscomp::ComplexDoubleArray &spec) {
 	ifft(out.impl(), spec.impl());
 }
 
+//! Computes count sequences of n samples each from their spectra. The
+//! spectra are modified.
+template <typename T>
+void ifft(int count, int n, T *const *out, std::vector<ComplexArray> &spectra);
+
 
 }
 }
@@ -47,6 +47,9 @@ namespace bs = boost::spirit;
 #include <sstream>
 #include <string>
 #include <numeric>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 
 
@@ -363,6 +366,27 @@ struct Parser : bs::grammar< Parser<T> >
 	generator_type generator;
 };
 
+
+// Parsed filters by filter string. Create hands out clones of them so
+// that a filter string is parsed only once. The number of entries is
+// bounded to not grow without limit with generated filter strings.
+template <typename T>
+struct FilterCache {
+	using Prototype = unique_ptr<Math::Filtering::InPlaceFilter<T>>;
+
+	mutex                   mtx;
+	map<string, Prototype>  filters;
+};
+
+const size_t MaxCachedFilters = 1024;
+
+
+template <typename T>
+FilterCache<T> &filterCache() {
+	static FilterCache<T> cache;
+	return cache;
+}
+
 }
 
 
@@ -376,6 +400,17 @@ namespace Filtering
 
 template <typename T>
 InPlaceFilter<T> *InPlaceFilter<T>::Create(const string &strFilter, string *error_str) {
+	FilterCache<T> &cache = filterCache<T>();
+
+	{
+		lock_guard<mutex> lock(cache.mtx);
+		auto it = cache.filters.find(strFilter);
+		if ( it != cache.filters.end() ) {
+			if ( error_str ) error_str->clear();
+			return it->second->clone();
+		}
+	}
+
 	string error;
 	typename Parser<T>::parameter_list parameters;
 	typename Parser<T>::tmp_list tmp;
@@ -395,6 +430,13 @@ InPlaceFilter<T> *InPlaceFilter<T>::Create(const string &strFilter, string *erro
 
 	if ( error_str ) *error_str = error;
 
+	if ( result && error.empty() ) {
+		typename FilterCache<T>::Prototype prototype(result->clone());
+		lock_guard<mutex> lock(cache.mtx);
+		if ( prototype && cache.filters.size() < MaxCachedFilters )
+			cache.filters.emplace(strFilter, std::move(prototype));
+	}
+
 	return result;
 }
 
@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <seiscomp/core/baseobject.h>
+#include <seiscomp/core/io.h>
 #include <seiscomp/core/interfacefactory.h>
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/core/datetime.h>
@@ -101,6 +102,13 @@ class SC_SYSTEM_CORE_API InPlaceFilter : public Core::BaseObject {
 		//! filter state depending on former input data
 		virtual InPlaceFilter<TYPE>* clone() const = 0;
 
+		//! Returns whether serialize writes and restores the internal
+		//! filter state depending on former input data. The configuration
+		//! is not part of that state: it must be restored into a filter
+		//! with the same configuration whose sampling frequency has
+		//! already been set.
+		virtual bool hasSerializableState() const { return false; }
+
 		//! Creates a new filter by name. The user is responsible to
 		//! release the memory
 		//! pointed to by the return value.
@@ -139,6 +147,7 @@ class SC_SYSTEM_CORE_API SelfFilter : public InPlaceFilter<TYPE> {
 		virtual void apply(int n, TYPE *inout) {}
 
 		virtual InPlaceFilter<TYPE>* clone() const { return new SelfFilter(); }
+		virtual bool hasSerializableState() const { return true; }
 };
 
 
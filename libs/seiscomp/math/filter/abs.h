@@ -41,6 +41,8 @@ class AbsFilter : public InPlaceFilter<T> {
 		void apply(int n, T *inout) override;
 
 		InPlaceFilter<T> *clone() const override;
+
+		bool hasSerializableState() const override { return true; }
 };
 
 
@@ -18,10 +18,12 @@
  ***************************************************************************/
 
 
+#include <algorithm>
 #include <math.h>
 #include <vector>
 #include <ostream>
 #include <iostream>
+#include <type_traits>
 
 #include<seiscomp/math/filter/biquad.h>
 
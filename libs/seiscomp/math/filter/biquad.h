@@ -102,6 +102,10 @@ class Biquad : public InPlaceFilter<TYPE> {
 
 		InPlaceFilter<TYPE> *clone() const override;
 
+		//! Serializes the filter memory
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
 
 	// ------------------------------------------------------------------
 	//  Public members
@@ -140,6 +144,42 @@ class BiquadCascade : public InPlaceFilter<TYPE> {
 
 		void set(const Biquads &biquads);
 
+		/**
+		 * @brief Filters several channels with cascades of the same design
+		 *        at once.
+		 *
+		 * Up to four channels are processed in parallel in SIMD lanes while
+		 * each filter keeps its own memory. The result is the same as
+		 * calling filters[i]->apply(n, data[i]) for each channel.
+		 * @param nchannels The number of channels
+		 * @param filters The filters, one per channel
+		 * @param n The number of samples of each channel
+		 * @param data The sample arrays, one per channel
+		 * @return false if not all filters are biquad cascades with the
+		 *         same coefficients. In that case nothing is filtered.
+		 */
+		static bool applyChannels(int nchannels,
+		                          InPlaceFilter<TYPE> *const *filters,
+		                          int n, TYPE *const *data);
+
+		/**
+		 * @brief Applies several cascades one after another to the same
+		 *        data in one pass.
+		 *
+		 * Each block of samples is passed through all sections of all
+		 * cascades before the next block is read. The result is the same
+		 * as calling cascades[i]->apply(n, inout) for each cascade in
+		 * order. Reimplementations of apply in derived classes are not
+		 * called.
+		 * @param ncascades The number of cascades
+		 * @param cascades The cascades in the order they are applied
+		 * @param n The number of samples
+		 * @param inout The samples which are filtered in place
+		 */
+		static void applyChain(int ncascades,
+		                       BiquadCascade<TYPE> *const *cascades,
+		                       int n, TYPE *inout);
+
 
 	// ------------------------------------------------------------------
 	//  InplaceFilter interface
@@ -152,6 +192,24 @@ class BiquadCascade : public InPlaceFilter<TYPE> {
 		void setSamplingFrequency(double /*fsamp*/) override {}
 		int setParameters(int n, const double *params) override;
 
+		//! Serializes the memory of all biquads
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
+
+	private:
+		template <int LANES, int SECTIONS>
+		static void applySections(BiquadCascade<TYPE> *const *cascades,
+		                          size_t first, TYPE *buf, int n);
+
+		template <int LANES>
+		static void applyBlock(BiquadCascade<TYPE> *const *cascades,
+		                       TYPE *block, int n);
+
+		template <int LANES>
+		static void applyLanes(BiquadCascade<TYPE> *const *cascades,
+		                       int n, TYPE *const *data);
+
 
 	// ------------------------------------------------------------------
 	//  Protected members
@@ -42,18 +42,80 @@ Biquad<TYPE>::Biquad(const Biquad<TYPE> &other)
 	v1 = v2 = 0.;
 }
 
+namespace {
+
+
+// The number of samples that are passed through all sections of a cascade
+// before the next block is read. A block of all lanes stays in the L1 cache.
+const int BlockSize = 128;
+const int MaxLanes = 4;
+
+
+/**
+ * Passes a block of interleaved samples of LANES channels through SECTIONS
+ * consecutive sections. The sections are chained per sample so that the
+ * recursions of different sections overlap in the pipeline and the lanes
+ * are independent and map onto vector registers.
+ */
+template <int LANES, int SECTIONS, typename TYPE>
+void filterBlock(const BiquadCoefficients *const *c, double *v1, double *v2,
+                 TYPE *buf, int n) {
+	BiquadCoefficients cs[SECTIONS];
+	double s1[SECTIONS][LANES], s2[SECTIONS][LANES];
+
+	for ( int s = 0; s < SECTIONS; ++s ) {
+		cs[s] = *c[s];
+		for ( int k = 0; k < LANES; ++k ) {
+			s1[s][k] = v1[s*LANES+k];
+			s2[s][k] = v2[s*LANES+k];
+		}
+	}
+
+	for ( int i = 0; i < n; ++i, buf += LANES ) {
+		for ( int s = 0; s < SECTIONS; ++s ) {
+			for ( int k = 0; k < LANES; ++k ) {
+				double v0 = buf[k] - cs[s].a1*s1[s][k] - cs[s].a2*s2[s][k];
+				buf[k] = TYPE(cs[s].b0*v0 + cs[s].b1*s1[s][k] + cs[s].b2*s2[s][k]);
+				s2[s][k] = s1[s][k]; s1[s][k] = v0;
+			}
+		}
+	}
+
+	for ( int s = 0; s < SECTIONS; ++s ) {
+		for ( int k = 0; k < LANES; ++k ) {
+			v1[s*LANES+k] = s1[s][k];
+			v2[s*LANES+k] = s2[s][k];
+		}
+	}
+}
+
+
+bool sameCoefficients(const BiquadCoefficients &a, const BiquadCoefficients &b) {
+	return a.b0 == b.b0 && a.b1 == b.b1 && a.b2 == b.b2
+	    && a.a0 == b.a0 && a.a1 == b.a1 && a.a2 == b.a2;
+}
+
+
+}
+
+
 template<typename TYPE>
 void Biquad<TYPE>::apply(int n, TYPE *inout) {
 	// This is the direct form 2 implementation according to
 	// https://en.wikipedia.org/wiki/Digital_biquad_filter#Direct_form_2
+	const double b0 = coefficients.b0, b1 = coefficients.b1, b2 = coefficients.b2;
+	const double a1 = coefficients.a1, a2 = coefficients.a2;
+	// Keep the memory in locals, inout may alias the members
+	double s1 = v1, s2 = v2;
 	TYPE *ff = inout;
 	for ( int i = 0; i < n;  ++i ) {
 
 		// a0 is assumed to be 1
-		double v0 = ff[i] - coefficients.a1*v1 - coefficients.a2*v2;
-		ff[i]     = TYPE(coefficients.b0*v0 + coefficients.b1*v1 + coefficients.b2*v2);
-		v2 = v1; v1 = v0;
+		double v0 = ff[i] - a1*s1 - a2*s2;
+		ff[i]     = TYPE(b0*v0 + b1*s1 + b2*s2);
+		s2 = s1; s1 = v0;
 	}
+	v1 = s1; v2 = s2;
 }
 
 template<typename TYPE>
@@ -80,6 +142,12 @@ int Biquad<TYPE>::setParameters(int n, const double *params) {
 	return n;
 }
 
+template<typename TYPE>
+void Biquad<TYPE>::serialize(Core::Archive &ar) {
+	ar & NAMED_OBJECT("v1", v1);
+	ar & NAMED_OBJECT("v2", v2);
+}
+
 template<typename TYPE>
 BiquadCascade<TYPE>::BiquadCascade() {}
 
@@ -94,8 +162,137 @@ int BiquadCascade<TYPE>::size() const { return _biq.size(); }
 
 template<typename TYPE>
 void BiquadCascade<TYPE>::apply(int n, TYPE *inout) {
-	for ( Biquad<TYPE> &biq : _biq )
-		biq.apply(n, inout);
+	if ( _biq.size() < 2 ) {
+		for ( Biquad<TYPE> &biq : _biq )
+			biq.apply(n, inout);
+		return;
+	}
+
+	BiquadCascade<TYPE> *self = this;
+	applyLanes<1>(&self, n, &inout);
+}
+
+template<typename TYPE>
+template <int LANES, int SECTIONS>
+void BiquadCascade<TYPE>::applySections(BiquadCascade<TYPE> *const *cascades,
+                                        size_t first, TYPE *buf, int n) {
+	const BiquadCoefficients *c[SECTIONS];
+	double v1[SECTIONS*LANES], v2[SECTIONS*LANES];
+
+	for ( int s = 0; s < SECTIONS; ++s ) {
+		c[s] = &cascades[0]->_biq[first+s].coefficients;
+		for ( int k = 0; k < LANES; ++k ) {
+			v1[s*LANES+k] = cascades[k]->_biq[first+s].v1;
+			v2[s*LANES+k] = cascades[k]->_biq[first+s].v2;
+		}
+	}
+
+	filterBlock<LANES,SECTIONS,TYPE>(c, v1, v2, buf, n);
+
+	for ( int s = 0; s < SECTIONS; ++s ) {
+		for ( int k = 0; k < LANES; ++k ) {
+			cascades[k]->_biq[first+s].v1 = v1[s*LANES+k];
+			cascades[k]->_biq[first+s].v2 = v2[s*LANES+k];
+		}
+	}
+}
+
+template<typename TYPE>
+template <int LANES>
+void BiquadCascade<TYPE>::applyBlock(BiquadCascade<TYPE> *const *cascades,
+                                     TYPE *block, int n) {
+	const size_t nsections = cascades[0]->_biq.size();
+	size_t s = 0;
+
+	// Chaining sections lets their recursions overlap. This is only
+	// done in double precision: in single precision the output of
+	// each section must be rounded inside the chain which eats up the
+	// gain and which GCC 12 drops when vectorizing the lanes.
+	if ( std::is_same<TYPE, double>::value ) {
+		for ( ; s + 4 <= nsections; s += 4 )
+			applySections<LANES,4>(cascades, s, block, n);
+		for ( ; s + 2 <= nsections; s += 2 )
+			applySections<LANES,2>(cascades, s, block, n);
+	}
+
+	for ( ; s < nsections; ++s )
+		applySections<LANES,1>(cascades, s, block, n);
+}
+
+template<typename TYPE>
+template <int LANES>
+void BiquadCascade<TYPE>::applyLanes(BiquadCascade<TYPE> *const *cascades,
+                                     int n, TYPE *const *data) {
+	TYPE buf[BlockSize*LANES];
+
+	// Pass blocks through all sections instead of running each section
+	// over the whole data
+	for ( int i = 0; i < n; i += BlockSize ) {
+		int m = std::min(BlockSize, n - i);
+		TYPE *block = LANES == 1 ? data[0] + i : buf;
+
+		// Interleave the channels
+		if ( LANES > 1 ) {
+			for ( int j = 0; j < m; ++j )
+				for ( int k = 0; k < LANES; ++k )
+					buf[j*LANES+k] = data[k][i+j];
+		}
+
+		applyBlock<LANES>(cascades, block, m);
+
+		if ( LANES > 1 ) {
+			for ( int j = 0; j < m; ++j )
+				for ( int k = 0; k < LANES; ++k )
+					data[k][i+j] = buf[j*LANES+k];
+		}
+	}
+}
+
+template<typename TYPE>
+bool BiquadCascade<TYPE>::applyChannels(int nchannels,
+                                        InPlaceFilter<TYPE> *const *filters,
+                                        int n, TYPE *const *data) {
+	if ( nchannels <= 0 ) return true;
+
+	BiquadCascade<TYPE> *first = dynamic_cast<BiquadCascade<TYPE>*>(filters[0]);
+	if ( !first ) return false;
+
+	for ( int c = 1; c < nchannels; ++c ) {
+		BiquadCascade<TYPE> *other = dynamic_cast<BiquadCascade<TYPE>*>(filters[c]);
+		if ( !other || other->_biq.size() != first->_biq.size() ) return false;
+		for ( size_t s = 0; s < first->_biq.size(); ++s ) {
+			if ( !sameCoefficients(other->_biq[s].coefficients,
+			                       first->_biq[s].coefficients) )
+				return false;
+		}
+	}
+
+	for ( int c = 0; c < nchannels; c += MaxLanes ) {
+		BiquadCascade<TYPE> *group[MaxLanes];
+		int lanes = std::min(MaxLanes, nchannels - c);
+		for ( int k = 0; k < lanes; ++k )
+			group[k] = static_cast<BiquadCascade<TYPE>*>(filters[c+k]);
+
+		switch ( lanes ) {
+			case 4: applyLanes<4>(group, n, data + c); break;
+			case 3: applyLanes<3>(group, n, data + c); break;
+			case 2: applyLanes<2>(group, n, data + c); break;
+			default: group[0]->apply(n, data[c]); break;
+		}
+	}
+
+	return true;
+}
+
+template<typename TYPE>
+void BiquadCascade<TYPE>::applyChain(int ncascades,
+                                     BiquadCascade<TYPE> *const *cascades,
+                                     int n, TYPE *inout) {
+	for ( int i = 0; i < n; i += BlockSize ) {
+		int m = std::min(BlockSize, n - i);
+		for ( int c = 0; c < ncascades; ++c )
+			applyBlock<1>(cascades + c, inout + i, m);
+	}
 }
 
 template<typename TYPE>
@@ -114,6 +311,35 @@ void BiquadCascade<TYPE>::reset() {
 		biq.reset();
 }
 
+template<typename TYPE>
+void BiquadCascade<TYPE>::serialize(Core::Archive &ar) {
+	// The memory is stored as v1 and v2 of each biquad in a row
+	std::vector<double> memory;
+
+	if ( !ar.isReading() ) {
+		memory.reserve(_biq.size() * 2);
+		for ( const Biquad<TYPE> &biq : _biq ) {
+			memory.push_back(biq.v1);
+			memory.push_back(biq.v2);
+		}
+	}
+
+	ar & NAMED_OBJECT("memory", memory);
+
+	if ( ar.isReading() ) {
+		// A different design cannot continue with that state
+		if ( memory.size() != _biq.size() * 2 ) {
+			ar.setValidity(false);
+			return;
+		}
+
+		for ( size_t i = 0; i < _biq.size(); ++i ) {
+			_biq[i].v1 = memory[i*2];
+			_biq[i].v2 = memory[i*2+1];
+		}
+	}
+}
+
 template<typename TYPE>
 void BiquadCascade<TYPE>::append(Biquad<TYPE> const &biq) {
 	_biq.push_back(biq);
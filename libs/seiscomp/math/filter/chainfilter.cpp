@@ -52,6 +52,7 @@ template<typename TYPE>
 bool ChainFilter<TYPE>::add(InPlaceFilter<TYPE> *f) {
 	if ( indexOf(f) != size_t(-1) ) return false;
 	_filters.push_back(f);
+	updateCascades();
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -67,6 +68,7 @@ bool ChainFilter<TYPE>::remove(size_t pos) {
 
 	delete _filters[pos];
 	_filters.erase(_filters.begin() + pos);
+	updateCascades();
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -82,6 +84,7 @@ InPlaceFilter<TYPE>* ChainFilter<TYPE>::take(size_t pos) {
 
 	InPlaceFilter<TYPE> *f = _filters[pos];
 	_filters.erase(_filters.begin() + pos);
+	updateCascades();
 	return f;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -118,8 +121,23 @@ size_t ChainFilter<TYPE>::filterCount() const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename TYPE>
 void ChainFilter<TYPE>::apply(int n, TYPE *inout) {
-	for ( InPlaceFilter<TYPE> *filter : _filters )
-		filter->apply(n, inout);
+	size_t count = _filters.size();
+	for ( size_t i = 0; i < count; ) {
+		size_t end = i;
+		while ( end < count && _cascades[end] )
+			++end;
+
+		// Run consecutive biquad cascades block wise in one pass rather
+		// than each of them over the whole data
+		if ( end - i > 1 ) {
+			IIR::BiquadCascade<TYPE>::applyChain(end - i, &_cascades[i], n, inout);
+			i = end;
+		}
+		else {
+			_filters[i]->apply(n, inout);
+			++i;
+		}
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -172,6 +190,18 @@ int ChainFilter<TYPE>::setParameters(int n, const double *params) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template<typename TYPE>
+void ChainFilter<TYPE>::updateCascades() {
+	_cascades.resize(_filters.size());
+	for ( size_t i = 0; i < _filters.size(); ++i )
+		_cascades[i] = dynamic_cast<IIR::BiquadCascade<TYPE>*>(_filters[i]);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename TYPE>
 InPlaceFilter<TYPE> *ChainFilter<TYPE>::clone() const {
@@ -186,6 +216,41 @@ InPlaceFilter<TYPE> *ChainFilter<TYPE>::clone() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template<typename TYPE>
+bool ChainFilter<TYPE>::hasSerializableState() const {
+	for ( InPlaceFilter<TYPE> *filter : _filters ) {
+		if ( !filter->hasSerializableState() )
+			return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template<typename TYPE>
+void ChainFilter<TYPE>::serialize(Core::Archive &ar) {
+	int32_t count = static_cast<int32_t>(_filters.size());
+	ar & NAMED_OBJECT("count", count);
+
+	if ( count != static_cast<int32_t>(_filters.size()) ) {
+		ar.setValidity(false);
+		return;
+	}
+
+	// The states of the filters follow each other in chain order
+	for ( InPlaceFilter<TYPE> *filter : _filters )
+		filter->serialize(ar);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 INSTANTIATE_INPLACE_FILTER(ChainFilter, SC_SYSTEM_CORE_API);
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
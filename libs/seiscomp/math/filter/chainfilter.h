@@ -23,6 +23,7 @@
 
 
 #include <seiscomp/math/filter.h>
+#include <seiscomp/math/filter/biquad.h>
 
 
 namespace Seiscomp {
@@ -84,13 +85,26 @@ class ChainFilter : public InPlaceFilter<TYPE> {
 
 		InPlaceFilter<TYPE> *clone() const override;
 
+		//! Returns true if all filters of the chain have a serializable
+		//! state
+		bool hasSerializableState() const override;
+		void serialize(Core::Archive &ar) override;
+
 
 	// ------------------------------------------------------------------
 	//  Private members
 	// ------------------------------------------------------------------
+	private:
+		//! Updates the biquad cascade view of the filters
+		void updateCascades();
+
 	private:
 		typedef std::vector<InPlaceFilter<TYPE>*> FilterChain;
-		FilterChain _filters;
+		typedef std::vector<IIR::BiquadCascade<TYPE>*> CascadeChain;
+		FilterChain  _filters;
+		//! The filters which are biquad cascades or nullptr. Consecutive
+		//! cascades are applied in one pass over the data.
+		CascadeChain _cascades;
 };
 
 
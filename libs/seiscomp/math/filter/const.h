@@ -42,6 +42,8 @@ class ConstFilter : public InPlaceFilter<T> {
 
 		InPlaceFilter<T>* clone() const override;
 
+		bool hasSerializableState() const override { return true; }
+
 	private:
 		T _const;
 };
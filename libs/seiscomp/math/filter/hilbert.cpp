@@ -0,0 +1,267 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/math/filter/hilbert.h>
+#include <seiscomp/math/math.h>
+#include <seiscomp/core/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+
+namespace Seiscomp {
+namespace Math {
+namespace Filtering {
+
+
+namespace {
+
+
+typedef std::shared_ptr<const std::vector<double>> CoefficientsCPtr;
+
+std::mutex designMutex;
+std::map<int, CoefficientsCPtr> designs;
+
+
+// Returns the 2*M+1 coefficients of the Hamming windowed Hilbert
+// transformer in the order of the samples in the buffer, oldest first.
+CoefficientsCPtr design(int M) {
+	std::lock_guard<std::mutex> l(designMutex);
+
+	auto it = designs.find(M);
+	if ( it != designs.end() )
+		return it->second;
+
+	std::shared_ptr<std::vector<double>> coeff = std::make_shared<std::vector<double>>(2*M+1, 0.0);
+	for ( int n = 1; n <= M; n += 2 ) {
+		double h = 2.0 / (M_PI*n) * (0.54 + 0.46*cos(M_PI*n/(M+1)));
+		// The sample n steps before the center is the oldest
+		(*coeff)[M-n] = h;
+		(*coeff)[M+n] = -h;
+	}
+
+	designs[M] = coeff;
+	return coeff;
+}
+
+
+// The sum is split into four independent accumulators which allows the
+// compiler to vectorize the loop.
+template <typename T>
+inline double innerProduct(const T *x, const double *c, size_t n) {
+	double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+
+	for ( ; i + 4 <= n; i += 4 ) {
+		s0 += x[i] * c[i];
+		s1 += x[i+1] * c[i+1];
+		s2 += x[i+2] * c[i+2];
+		s3 += x[i+3] * c[i+3];
+	}
+
+	for ( ; i < n; ++i )
+		s0 += x[i] * c[i];
+
+	return (s0 + s1) + (s2 + s3);
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+Hilbert<T>::Hilbert(double fmin, double fsamp)
+: _fmin(fmin), _fsamp(0), _halfWidth(0), _front(0), _firstSample(true) {
+	if ( fsamp )
+		setSamplingFrequency(fsamp);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void Hilbert<T>::setSamplingFrequency(double fsamp) {
+	if ( _fsamp == fsamp ) return;
+
+	_fsamp = fsamp;
+
+	// The window main lobe limits the response at low frequencies. Two
+	// periods of the lowest frequency per side keep the passband ripple
+	// below one percent.
+	_halfWidth = std::max(1, (int)ceil(2.0 * _fsamp / _fmin));
+	_coefficients = design(_halfWidth);
+	_buffer.resize((2*_halfWidth+1)*2);
+
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+int Hilbert<T>::setParameters(int n, const double *params) {
+	if ( n > 1 ) return 1;
+
+	if ( n == 1 ) {
+		if ( params[0] <= 0 )
+			return -1;
+		_fmin = params[0];
+	}
+
+	return n;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void Hilbert<T>::reset() {
+	_front = 0;
+	_firstSample = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void Hilbert<T>::analytic(int n, const T *in, T *real, T *imag) {
+	if ( _fsamp == 0.0 )
+		throw Core::GeneralException("Samplerate not initialized");
+
+	if ( n <= 0 ) return;
+
+	// Initialize the history with the first sample. The transform of a
+	// constant is zero which avoids a transient for data with an offset.
+	if ( _firstSample ) {
+		std::fill(_buffer.begin(), _buffer.end(), in[0]);
+		_firstSample = false;
+	}
+
+	const size_t length = _buffer.size() / 2;
+	const double *coeff = _coefficients->data();
+	T *buffer = _buffer.data();
+
+	for ( int i = 0; i < n; ++i ) {
+		buffer[_front] = buffer[_front+length] = in[i];
+		if ( ++_front == length ) _front = 0;
+
+		// The window starting at front holds the samples oldest first
+		const T *window = buffer + _front;
+		imag[i] = (T)innerProduct(window, coeff, length);
+		real[i] = window[_halfWidth];
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void Hilbert<T>::apply(int n, T *inout) {
+	if ( _fsamp == 0.0 )
+		throw Core::GeneralException("Samplerate not initialized");
+
+	if ( n <= 0 ) return;
+
+	std::vector<T> real(n);
+	analytic(n, inout, real.data(), inout);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+InPlaceFilter<T> *Hilbert<T>::clone() const {
+	return new Hilbert<T>(_fmin, _fsamp);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+HilbertEnvelope<T>::HilbertEnvelope(double fmin, double fsamp)
+: Hilbert<T>(fmin, fsamp) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void HilbertEnvelope<T>::apply(int n, T *inout) {
+	if ( this->_fsamp == 0.0 )
+		throw Core::GeneralException("Samplerate not initialized");
+
+	if ( n <= 0 ) return;
+
+	std::vector<T> imag(n);
+	this->analytic(n, inout, inout, imag.data());
+
+	for ( int i = 0; i < n; ++i )
+		inout[i] = (T)sqrt((double)inout[i]*inout[i] + (double)imag[i]*imag[i]);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+InPlaceFilter<T> *HilbertEnvelope<T>::clone() const {
+	return new HilbertEnvelope<T>(this->_fmin, this->_fsamp);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+INSTANTIATE_INPLACE_FILTER(Hilbert, SC_SYSTEM_CORE_API);
+INSTANTIATE_INPLACE_FILTER(HilbertEnvelope, SC_SYSTEM_CORE_API);
+REGISTER_INPLACE_FILTER(Hilbert, "HILBERT");
+REGISTER_INPLACE_FILTER(HilbertEnvelope, "HENV");
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
+}
@@ -0,0 +1,121 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_MATH_FILTER_HILBERT_H
+#define SEISCOMP_MATH_FILTER_HILBERT_H
+
+
+#include <seiscomp/math/filter.h>
+
+#include <memory>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Math {
+namespace Filtering {
+
+
+/**
+ * @brief Streaming FIR Hilbert transformer.
+ *
+ * The Hilbert transform is approximated by a Hamming windowed FIR filter
+ * of odd length. In contrast to BandPassEnvelope no band limitation of the
+ * input is required. The transform is accurate for frequencies above the
+ * lower frequency limit passed to the constructor and below about
+ * 0.9 times the Nyquist frequency. The filter length is chosen from that
+ * limit and the sampling frequency. Designs are shared by all instances.
+ *
+ * The output is delayed by half the filter length. Together with the
+ * input delayed by the same number of samples it forms the analytic
+ * signal.
+ *
+ * This filter may be used in a filter chain. Its name is HILBERT and it
+ * accepts one optional argument:
+ *   - lower frequency limit in Hz (default: 0.5)
+ */
+template <typename T>
+class Hilbert : public InPlaceFilter<T> {
+	public:
+		Hilbert(double fmin = 0.5, double fsamp = 0);
+
+
+	public:
+		void setSamplingFrequency(double fsamp) override;
+		int setParameters(int n, const double *params) override;
+
+		void apply(int n, T *inout) override;
+		InPlaceFilter<T> *clone() const override;
+
+		//! Resets the filter values
+		void reset();
+
+		//! Returns the delay of the output in samples
+		int delay() const { return _halfWidth; }
+
+
+	protected:
+		//! Applies the filter and writes the delayed input to real and
+		//! its Hilbert transform to imag. Both may point to inout.
+		void analytic(int n, const T *in, T *real, T *imag);
+
+
+	protected:
+		typedef std::shared_ptr<const std::vector<double>> CoefficientsCPtr;
+
+		double           _fmin;
+		double           _fsamp;
+		int              _halfWidth;
+		CoefficientsCPtr _coefficients;
+		// Ring buffer of the last 2*_halfWidth+1 samples stored twice
+		std::vector<T>   _buffer;
+		size_t           _front;
+		bool             _firstSample;
+};
+
+
+/**
+ * @brief Streaming envelope filter.
+ *
+ * Computes the magnitude of the analytic signal of Hilbert. The envelope
+ * is delayed by half the filter length.
+ *
+ * This filter may be used in a filter chain. Its name is HENV and it
+ * accepts one optional argument:
+ *   - lower frequency limit in Hz (default: 0.5)
+ */
+template <typename T>
+class HilbertEnvelope : public Hilbert<T> {
+	public:
+		HilbertEnvelope(double fmin = 0.5, double fsamp = 0);
+
+
+	public:
+		void apply(int n, T *inout) override;
+		InPlaceFilter<T> *clone() const override;
+};
+
+
+} // namespace Seiscomp::Math::Filtering
+} // namespace Seiscomp::Math
+} // namespace Seiscomp
+
+
+#endif
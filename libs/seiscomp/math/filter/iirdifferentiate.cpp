@@ -83,6 +83,13 @@ InPlaceFilter<T> *IIRDifferentiate<T>::clone() const {
 }
 
 
+template <typename T>
+void IIRDifferentiate<T>::serialize(Core::Archive &ar) {
+	ar & TAGGED_MEMBER(v1);
+	ar & TAGGED_MEMBER(init);
+}
+
+
 INSTANTIATE_INPLACE_FILTER(IIRDifferentiate, SC_SYSTEM_CORE_API);
 REGISTER_INPLACE_FILTER(IIRDifferentiate, "DIFF");
 
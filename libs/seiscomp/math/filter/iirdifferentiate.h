@@ -51,6 +51,9 @@ class IIRDifferentiate : public InPlaceFilter<T> {
 
 		InPlaceFilter<T> *clone() const override;
 
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
 	private:
 		T _v1;
 		T _fsamp;
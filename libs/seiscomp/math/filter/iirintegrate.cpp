@@ -105,6 +105,13 @@ InPlaceFilter<T> *IIRIntegrate<T>::clone() const {
 }
 
 
+template <typename T>
+void IIRIntegrate<T>::serialize(Core::Archive &ar) {
+	ar & TAGGED_MEMBER(v1);
+	ar & TAGGED_MEMBER(v2);
+}
+
+
 INSTANTIATE_INPLACE_FILTER(IIRIntegrate, SC_SYSTEM_CORE_API);
 REGISTER_INPLACE_FILTER(IIRIntegrate, "INT");
 
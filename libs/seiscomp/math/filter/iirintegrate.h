@@ -51,6 +51,9 @@ class IIRIntegrate : public InPlaceFilter<T> {
 
 		InPlaceFilter<T> *clone() const override;
 
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
 	private:
 		void init(double a);
 
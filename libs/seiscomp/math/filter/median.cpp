@@ -62,76 +62,40 @@ void Median<TYPE>::apply(int n, TYPE *inout) {
 	}
 
 	size_t mid = _sampleCount / 2;
-	TYPE sample;
-
-	// The median calculation requires a sorted buffer. Sorting is an expencive
-	// operation and should be performed on the entire buffer for each sample.
-	// Hence, a second, sorted buffer is used which managed slightly different
-	// depending on the buffer size.
-	// For a buffer length of less than 10 samples it is faster to use the
-	// linear std::find, change the value without changing the container size
-	// and perform a subsequent sort operation on an almost sorted buffer.
-	// For larger buffer sizes it is more efficient to delete the old value and
-	// insert the new value at the correct postion taking advantage of the
-	// binary_search routine.
-	//
-	// Speed up depending on buffer size compared against creation of sorted
-	// copy of ring buffer of each sample:
-	//
-	//   size  find/sort   erase/insert
-	//      3    1.41056       0.939747
-	//      5    1.38352       1.09831
-	//      7    1.47858       1.34695
-	//     10    1.63019       1.76063
-	//     15    1.98368       2.60729
-	//     20    1.58768       3.86773
-	//     50    1.68139       9.86892
-	//    100    1.70717      20.8161
-	if ( _sampleCount < 10 ) {
-		for ( int i = 0; i < n; ++i ) {
-			sample = inout[i];
-			// before the _buffer at _index will be overriden in the next step,
-			// we search for the value in the sorted buffer and replace it by
-			// the current sample
-			*std::find(_sorted.begin(), _sorted.end(), _buffer[_index]) = sample;
-
-			// store sample for later use in ring buffer
-			_buffer[_index++] = sample;
-			if ( _index >= _sampleCount ) {
-				_index = 0;
-			}
-
-			// sort vector for computing the median (which is pre-sorted except
-			// for one element)
-			std::sort(_sorted.begin(), _sorted.end());
-
-			inout[i] = (_sampleCount % 2) ? _sorted[mid] :  // odd
-			           (_sorted[mid-1] + _sorted[mid]) / 2; // even
+	auto begin = _sorted.begin();
+	auto end = _sorted.end();
+
+	// The median calculation requires a sorted buffer of the ring buffer
+	// contents. Instead of sorting for each sample, the sorted buffer is
+	// updated incrementally: the position of the outgoing value is located
+	// with a binary search and the elements between this position and the
+	// insert position of the incoming value are shifted by one. This
+	// replaces the erase/insert pair which moved the whole tail of the
+	// buffer twice.
+	for ( int i = 0; i < n; ++i ) {
+		TYPE sample = inout[i];
+		auto pos = std::lower_bound(begin, end, _buffer[_index]);
+
+		if ( sample > *pos ) {
+			auto next = std::upper_bound(pos + 1, end, sample);
+			std::move(pos + 1, next, pos);
+			*(next - 1) = sample;
 		}
-	}
-	else {
-		for ( int i = 0; i < n; ++i ) {
-			sample = inout[i];
-
-			// before the _buffer at _index will be overriden in the next step,
-			// we search for the value in the sorted buffer, deleted it and
-			// insert the new value at the correct position eliminated the need
-			// for a sort operation
-			_sorted.erase(std::lower_bound(_sorted.begin(), _sorted.end(), _buffer[_index]));
-			_sorted.insert(std::upper_bound(_sorted.begin(), _sorted.end(), sample), sample);
-
-			// store sample for later use in ring buffer
-			_buffer[_index++] = inout[i];
-			if ( _index >= _sampleCount ) {
-				_index = 0;
-			}
-
-			inout[i] = (_sampleCount % 2) ? _sorted[mid] :  // odd
-			           (_sorted[mid-1] + _sorted[mid]) / 2; // even
+		else if ( sample < *pos ) {
+			auto next = std::upper_bound(begin, pos, sample);
+			std::move_backward(next, pos, pos + 1);
+			*next = sample;
 		}
-	}
 
+		// store sample for later use in ring buffer
+		_buffer[_index++] = sample;
+		if ( _index >= _sampleCount ) {
+			_index = 0;
+		}
 
+		inout[i] = (_sampleCount % 2) ? _sorted[mid] :  // odd
+		           (_sorted[mid-1] + _sorted[mid]) / 2; // even
+	}
 }
 
 
@@ -21,6 +21,7 @@
 #define SEISCOMP_COMPONENT MinMax
 
 #include <math.h>
+#include <functional>
 
 #include <seiscomp/math/filter/minmax.h>
 #include <seiscomp/core/exceptions.h>
@@ -65,7 +66,7 @@ void MinMax<TYPE>::setSamplingFrequency(double fsamp) {
 	_fsamp = fsamp;
 	_sampleCount = (int)(_fsamp * _timeSpan);
 	if ( _sampleCount < 1 ) _sampleCount = 1;
-	_buffer.resize(_sampleCount);
+	_candidates.resize(_sampleCount);
 	reset();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -91,8 +92,47 @@ int MinMax<TYPE>::setParameters(int n, const double *params) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename TYPE>
 void MinMax<TYPE>::reset() {
-	_firstSample = true;
-	_index = 0;
+	_position = 0;
+	_front = 0;
+	_size = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template<typename TYPE>
+template <typename DOMINATES>
+void MinMax<TYPE>::filter(int n, TYPE *inout, DOMINATES dominates) {
+	size_t capacity = _candidates.size();
+
+	for ( int i = 0; i < n; ++i, ++_position ) {
+		// Remove the candidate which left the window. The window is
+		// initialized with the first sample which is equivalent to keeping
+		// the first sample as candidate until it leaves the window.
+		if ( _size && _candidates[_front].position + _sampleCount <= _position ) {
+			if ( ++_front == capacity ) _front = 0;
+			--_size;
+		}
+
+		// Samples which are dominated by the new sample will never become
+		// the extremum again because they leave the window earlier
+		size_t back = _front + _size;
+		if ( back >= capacity ) back -= capacity;
+
+		while ( _size ) {
+			size_t last = back ? back - 1 : capacity - 1;
+			if ( dominates(_candidates[last].value, inout[i]) ) break;
+			back = last;
+			--_size;
+		}
+
+		_candidates[back] = {inout[i], _position};
+		++_size;
+
+		inout[i] = _candidates[_front].value;
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -124,42 +164,7 @@ void Min<TYPE>::apply(int n, TYPE *inout) {
 	if ( MinMax<TYPE>::_fsamp == 0.0 )
 		throw Seiscomp::Core::GeneralException("Samplerate not initialized");
 
-	// Initialize the minmax buffer with the first sample
-	if ( MinMax<TYPE>::_firstSample && n ) {
-		std::fill(MinMax<TYPE>::_buffer.begin(), MinMax<TYPE>::_buffer.end(), inout[0]);
-		_minimum = inout[0];
-		MinMax<TYPE>::_firstSample = false;
-	}
-
-	for ( int i = 0; i < n; ++i ) {
-		TYPE poppedValue = MinMax<TYPE>::_buffer[MinMax<TYPE>::_index];
-		MinMax<TYPE>::_buffer[MinMax<TYPE>::_index] = inout[i];
-
-		if ( MinMax<TYPE>::_buffer[MinMax<TYPE>::_index] < _minimum )
-			_minimum = MinMax<TYPE>::_buffer[MinMax<TYPE>::_index];
-		else if ( poppedValue <= _minimum ) {
-			// A maximum has been removed, check for new one
-			TYPE oldMinimum = _minimum;
-
-			// Recompute maximum
-			_minimum = MinMax<TYPE>::_buffer[0];
-			if ( _minimum > oldMinimum ) {
-				for ( int j = 1; j < MinMax<TYPE>::_sampleCount; ++j ) {
-					if ( MinMax<TYPE>::_buffer[j] < _minimum ) {
-						_minimum = MinMax<TYPE>::_buffer[j];
-						if ( _minimum <= oldMinimum ) break;
-					}
-				}
-			}
-		}
-
-		inout[i] = _minimum;
-
-		++MinMax<TYPE>::_index;
-
-		if ( MinMax<TYPE>::_index >= MinMax<TYPE>::_sampleCount )
-			MinMax<TYPE>::_index = 0;
-	}
+	MinMax<TYPE>::filter(n, inout, std::less<TYPE>());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -191,42 +196,7 @@ void Max<TYPE>::apply(int n, TYPE *inout) {
 	if ( MinMax<TYPE>::_fsamp == 0.0 )
 		throw Seiscomp::Core::GeneralException("Samplerate not initialized");
 
-	// Initialize the minmax buffer with the first sample
-	if ( MinMax<TYPE>::_firstSample && n ) {
-		std::fill(MinMax<TYPE>::_buffer.begin(), MinMax<TYPE>::_buffer.end(), inout[0]);
-		_maximum = inout[0];
-		MinMax<TYPE>::_firstSample = false;
-	}
-
-	for ( int i = 0; i < n; ++i ) {
-		TYPE poppedValue = MinMax<TYPE>::_buffer[MinMax<TYPE>::_index];
-		MinMax<TYPE>::_buffer[MinMax<TYPE>::_index] = inout[i];
-
-		if ( MinMax<TYPE>::_buffer[MinMax<TYPE>::_index] > _maximum )
-			_maximum = MinMax<TYPE>::_buffer[MinMax<TYPE>::_index];
-		else if ( poppedValue >= _maximum ) {
-			// A maximum has been removed, check for new one
-			TYPE oldMaximum = _maximum;
-
-			// Recompute maximum
-			_maximum = MinMax<TYPE>::_buffer[0];
-			if ( _maximum < oldMaximum ) {
-				for ( int j = 1; j < MinMax<TYPE>::_sampleCount; ++j ) {
-					if ( MinMax<TYPE>::_buffer[j] > _maximum ) {
-						_maximum = MinMax<TYPE>::_buffer[j];
-						if ( _maximum >= oldMaximum ) break;
-					}
-				}
-			}
-		}
-
-		inout[i] = _maximum;
-
-		++MinMax<TYPE>::_index;
-
-		if ( MinMax<TYPE>::_index >= MinMax<TYPE>::_sampleCount )
-			MinMax<TYPE>::_index = 0;
-	}
+	MinMax<TYPE>::filter(n, inout, std::greater<TYPE>());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -234,6 +204,7 @@ void Max<TYPE>::apply(int n, TYPE *inout) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+INSTANTIATE_INPLACE_FILTER(MinMax, SC_SYSTEM_CORE_API);
 INSTANTIATE_INPLACE_FILTER(Min, SC_SYSTEM_CORE_API);
 REGISTER_INPLACE_FILTER(Min, "MIN");
 INSTANTIATE_INPLACE_FILTER(Max, SC_SYSTEM_CORE_API);
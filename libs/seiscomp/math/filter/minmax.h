@@ -57,12 +57,36 @@ class MinMax : public InPlaceFilter<TYPE> {
 
 
 	protected:
-		double            _timeSpan;
-		double            _fsamp;
-		int               _sampleCount;
-		int               _index;
-		bool              _firstSample;
-		std::vector<TYPE> _buffer;
+		/**
+		 * @brief Pushes the samples into the window and replaces them with
+		 *        the dominating value of the window.
+		 *
+		 * The window is maintained as a monotonic queue of candidates which
+		 * makes the update O(1) amortized per sample independent of the
+		 * window length.
+		 * @param n The number of samples
+		 * @param inout The samples
+		 * @param dominates Returns true if the first value replaces the
+		 *                  second as extremum
+		 */
+		template <typename DOMINATES>
+		void filter(int n, TYPE *inout, DOMINATES dominates);
+
+
+	protected:
+		struct Candidate {
+			TYPE   value;
+			size_t position;
+		};
+
+		double                 _timeSpan;
+		double                 _fsamp;
+		int                    _sampleCount;
+		size_t                 _position;
+		// Ring buffer of candidates, at most one per sample of the window
+		std::vector<Candidate> _candidates;
+		size_t                 _front;
+		size_t                 _size;
 };
 
 
@@ -75,9 +99,6 @@ class Min : public MinMax<TYPE> {
 		// apply filter to data vector **in*place**
 		void apply(int n, TYPE *inout) override;
 		InPlaceFilter<TYPE> *clone() const override;
-
-	private:
-		TYPE _minimum;
 };
 
 
@@ -90,9 +111,6 @@ class Max : public MinMax<TYPE> {
 		// apply filter to data vector **in*place**
 		void apply(int n, TYPE *inout) override;
 		InPlaceFilter<TYPE> *clone() const override;
-
-	private:
-		TYPE _maximum;
 };
 
 
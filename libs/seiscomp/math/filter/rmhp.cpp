@@ -103,6 +103,13 @@ InPlaceFilter<TYPE> *RunningMean<TYPE>::clone() const {
 }
 
 
+template<typename TYPE>
+void RunningMean<TYPE>::serialize(Core::Archive &ar) {
+	ar & TAGGED_MEMBER(sampleCount);
+	ar & TAGGED_MEMBER(average);
+}
+
+
 template<typename TYPE>
 RunningMeanHighPass<TYPE>::RunningMeanHighPass(double windowLength, double fsamp)
 : RunningMean<TYPE>(windowLength, fsamp)
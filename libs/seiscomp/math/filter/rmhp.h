@@ -54,6 +54,9 @@ class RunningMean : public InPlaceFilter<TYPE> {
 		// resets the filter, i.e. erases the filter memory
 		void reset();
 
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
 
 	protected:
 		double _windowLength,  _samplingFrequency;
@@ -21,6 +21,7 @@
 #include <seiscomp/core/exceptions.h>
 #include <seiscomp/math/filter/stalta.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -135,6 +136,14 @@ InPlaceFilter<TYPE> *STALTA<TYPE>::clone() const {
 }
 
 
+template<typename TYPE>
+void STALTA<TYPE>::serialize(Core::Archive &ar) {
+	ar & TAGGED_MEMBER(sampleCount);
+	ar & TAGGED_MEMBER(STA);
+	ar & TAGGED_MEMBER(LTA);
+}
+
+
 INSTANTIATE_INPLACE_FILTER(STALTA, SC_SYSTEM_CORE_API);
 REGISTER_INPLACE_FILTER(STALTA, "STALTA");
 
@@ -248,6 +257,16 @@ InPlaceFilter<TYPE> *STALTA2<TYPE>::clone() const {
 }
 
 
+template<typename TYPE>
+void STALTA2<TYPE>::serialize(Core::Archive &ar) {
+	ar & TAGGED_MEMBER(sampleCount);
+	ar & TAGGED_MEMBER(STA);
+	ar & TAGGED_MEMBER(LTA);
+	// Whether the LTA is frozen during an event
+	ar & TAGGED_MEMBER(updateLTA);
+}
+
+
 INSTANTIATE_INPLACE_FILTER(STALTA2, SC_SYSTEM_CORE_API);
 REGISTER_INPLACE_FILTER(STALTA2, "STALTA2");
 
@@ -349,6 +368,250 @@ INSTANTIATE_INPLACE_FILTER(STALTA_Classic, SC_SYSTEM_CORE_API);
 REGISTER_INPLACE_FILTER(STALTA_Classic, "STALTAClassic");
 
 
+namespace {
+
+
+// The number of channels updated at once and the block size in samples
+const int STALTALanes = 8;
+const int STALTABlockSize = 64;
+
+
+}
+
+
+template<typename TYPE>
+STALTAGroup<TYPE>::STALTAGroup(double lenSTA, double lenLTA,
+                               double triggerOn, double triggerOff,
+                               double fsamp)
+: _lenSTA(lenSTA)
+, _lenLTA(lenLTA)
+, _triggerOn(triggerOn)
+, _triggerOff(triggerOff) {
+	checkParameters(_lenSTA, _lenLTA);
+	setSamplingFrequency(fsamp);
+}
+
+
+template<typename TYPE>
+size_t STALTAGroup<TYPE>::addChannel() {
+	_STA.push_back(0.);
+	_LTA.push_back(0.);
+	_sampleCount.push_back(0);
+	_triggered.push_back(0);
+	return _STA.size() - 1;
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::reset() {
+	for ( size_t c = 0; c < _STA.size(); ++c )
+		reset(c);
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::reset(size_t channel) {
+	_STA[channel] = _LTA[channel] = 0.;
+	_sampleCount[channel] = 0;
+	_triggered[channel] = 0;
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::setSamplingFrequency(double fsamp) {
+	if ( fsamp <= 0. ) {
+		throw Core::ValueException("Sampling frequency must be positive");
+	}
+
+	_fsamp  = fsamp;
+	_numSTA = static_cast<int>(_lenSTA * fsamp + 0.5);
+	_numLTA = static_cast<int>(_lenLTA * fsamp + 0.5);
+
+	reset();
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::apply(int n, TYPE *const *data, Triggers *triggers) {
+	size_t nch = _STA.size();
+	size_t c = 0;
+
+	for ( ; c + STALTALanes <= nch; c += STALTALanes ) {
+		bool initialized = true;
+		for ( int k = 0; k < STALTALanes; ++k ) {
+			if ( _sampleCount[c+k] < _numLTA ) {
+				initialized = false;
+				break;
+			}
+		}
+
+		if ( initialized )
+			applyLanes(c, n, data + c, triggers);
+		else {
+			for ( int k = 0; k < STALTALanes; ++k )
+				apply(c+k, n, data[c+k], triggers);
+		}
+	}
+
+	for ( ; c < nch; ++c )
+		apply(c, n, data[c], triggers);
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::apply(size_t channel, int n, TYPE *inout,
+                              Triggers *triggers) {
+	update(channel, n, inout);
+	checkTriggers(channel, n, inout, triggers);
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::update(size_t channel, int n, TYPE *inout) {
+	// This is the same as STALTA::apply
+	double normLTA = 1. / _numLTA;
+	double normSTA = 1. / _numSTA;
+	double STA = _STA[channel], LTA = _LTA[channel];
+	int sampleCount = _sampleCount[channel];
+
+	for ( int i = 0; i < n; ++i ) {
+		double current = std::abs(inout[i]);
+		bool initialized{true};
+
+		if ( sampleCount < _numSTA ) {
+			normSTA = 1. / (sampleCount + 1);
+			STA = (STA * sampleCount + current) * normSTA;
+			initialized = false;
+		}
+		else {
+			STA += (current - STA) * normSTA;
+		}
+
+		if ( sampleCount < _numLTA ) {
+			normLTA = 1. / (sampleCount + 1);
+			LTA = (LTA * sampleCount + current) * normLTA;
+			initialized = false;
+		}
+		else {
+			LTA += (STA - LTA) * normLTA;
+		}
+
+		if ( !initialized ) {
+			++sampleCount;
+		}
+
+		if ( LTA < std::numeric_limits<double>::epsilon() ) {
+			inout[i] = static_cast<TYPE>(STA * 1e6);
+		}
+		else {
+			inout[i] = static_cast<TYPE>(sampleCount < _numSTA ? 1 : STA / LTA);
+		}
+	}
+
+	_STA[channel] = STA;
+	_LTA[channel] = LTA;
+	_sampleCount[channel] = sampleCount;
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::applyLanes(size_t first, int n, TYPE *const *data,
+                                   Triggers *triggers) {
+	const double normLTA = 1. / _numLTA;
+	const double normSTA = 1. / _numSTA;
+	// The LTA decays at most by a factor of (1-normLTA) per sample. If it
+	// starts above this value it does not fall below epsilon within a
+	// block and the ratio needs no special case. The factor of two covers
+	// rounding.
+	const double minLTA = 2 * std::numeric_limits<double>::epsilon()
+	                    / std::pow(1. - normLTA, STALTABlockSize);
+	double STA[STALTALanes], LTA[STALTALanes];
+	TYPE buf[STALTABlockSize*STALTALanes];
+
+	for ( int k = 0; k < STALTALanes; ++k ) {
+		STA[k] = _STA[first+k];
+		LTA[k] = _LTA[first+k];
+	}
+
+	for ( int i = 0; i < n; i += STALTABlockSize ) {
+		int m = std::min(STALTABlockSize, n - i);
+		bool regular = true;
+
+		for ( int k = 0; k < STALTALanes; ++k ) {
+			if ( !(LTA[k] >= minLTA) ) {
+				regular = false;
+				break;
+			}
+		}
+
+		if ( !regular ) {
+			for ( int k = 0; k < STALTALanes; ++k ) {
+				_STA[first+k] = STA[k];
+				_LTA[first+k] = LTA[k];
+				update(first+k, m, data[k] + i);
+				STA[k] = _STA[first+k];
+				LTA[k] = _LTA[first+k];
+			}
+			continue;
+		}
+
+		// Interleave the channels
+		for ( int j = 0; j < m; ++j )
+			for ( int k = 0; k < STALTALanes; ++k )
+				buf[j*STALTALanes+k] = data[k][i+j];
+
+		// All channels are initialized, so the lanes run the same
+		// branch free update
+		TYPE *b = buf;
+		for ( int j = 0; j < m; ++j, b += STALTALanes ) {
+			for ( int k = 0; k < STALTALanes; ++k ) {
+				double current = std::abs(static_cast<double>(b[k]));
+				STA[k] += (current - STA[k]) * normSTA;
+				LTA[k] += (STA[k] - LTA[k]) * normLTA;
+				b[k] = static_cast<TYPE>(STA[k] / LTA[k]);
+			}
+		}
+
+		for ( int j = 0; j < m; ++j )
+			for ( int k = 0; k < STALTALanes; ++k )
+				data[k][i+j] = buf[j*STALTALanes+k];
+	}
+
+	for ( int k = 0; k < STALTALanes; ++k ) {
+		_STA[first+k] = STA[k];
+		_LTA[first+k] = LTA[k];
+		checkTriggers(first+k, n, data[k], triggers);
+	}
+}
+
+
+template<typename TYPE>
+void STALTAGroup<TYPE>::checkTriggers(size_t channel, int n, const TYPE *ratio,
+                                      Triggers *triggers) {
+	bool triggered = _triggered[channel];
+
+	for ( int i = 0; i < n; ++i ) {
+		if ( !triggered ) {
+			if ( ratio[i] < _triggerOn ) continue;
+			triggered = true;
+		}
+		else {
+			if ( ratio[i] > _triggerOff ) continue;
+			triggered = false;
+		}
+
+		if ( triggers )
+			triggers->push_back({channel, i, triggered});
+	}
+
+	_triggered[channel] = triggered;
+}
+
+
+template class SC_SYSTEM_CORE_API STALTAGroup<float>;
+template class SC_SYSTEM_CORE_API STALTAGroup<double>;
+
+
 } // namespace Seiscomp::Math::Filtering
 } // namespace Seiscomp::Math
 } // namespace Seiscomp
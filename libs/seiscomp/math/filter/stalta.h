@@ -54,6 +54,10 @@ class STALTA : public InPlaceFilter<TYPE> {
 
 		InPlaceFilter<TYPE> *clone() const override;
 
+		//! Serializes the current STA and LTA
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
 	protected:
 		// length of STA and LTA windows in seconds
 		double _lenSTA, _lenLTA;
@@ -100,6 +104,10 @@ class STALTA2 : public InPlaceFilter<TYPE> {
 
 		InPlaceFilter<TYPE> *clone() const override;
 
+		//! Serializes the current STA and LTA
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
 	protected:
 		// length of STA and LTA windows in seconds
 		double _lenSTA, _lenLTA;
@@ -178,6 +186,80 @@ class STALTA_Classic : public InPlaceFilter<TYPE> {
 };
 
 
+// Recursive STA/LTA of many channels at once
+//
+// Computes the same ratios as STALTA for a group of channels sharing the
+// same sampling frequency. The state of all channels is kept in arrays
+// and initialized channels are updated several at a time in vector
+// registers. The ratios are written in place and trigger on/off events
+// are reported using the thresholds.
+
+template<typename TYPE>
+class STALTAGroup {
+	public:
+		struct Trigger {
+			size_t channel; // channel index
+			int    index;   // sample index into the data passed to apply
+			bool   on;      // trigger on or off
+		};
+
+		typedef std::vector<Trigger> Triggers;
+
+	public:
+		STALTAGroup(double lenSTA=2, double lenLTA=50,
+		            double triggerOn=3., double triggerOff=1.5,
+		            double fsamp=1.);
+
+	public:
+		// Adds a channel and returns its index
+		size_t addChannel();
+
+		size_t channelCount() const { return _STA.size(); }
+
+		// Resets all channels
+		void reset();
+
+		// Resets a single channel
+		void reset(size_t channel);
+
+		void setSamplingFrequency(double fsamp);
+
+		// Compute the ratios of n samples of all channels in place. data
+		// must hold channelCount() arrays. Trigger events are appended to
+		// triggers if not nullptr.
+		void apply(int n, TYPE *const *data, Triggers *triggers = nullptr);
+
+		// Compute the ratios of a single channel in place
+		void apply(size_t channel, int n, TYPE *inout,
+		           Triggers *triggers = nullptr);
+
+	private:
+		void update(size_t channel, int n, TYPE *inout);
+		void applyLanes(size_t first, int n, TYPE *const *data,
+		                Triggers *triggers);
+		void checkTriggers(size_t channel, int n, const TYPE *ratio,
+		                   Triggers *triggers);
+
+	protected:
+		// length of STA and LTA windows in seconds
+		double _lenSTA, _lenLTA;
+
+		// length of STA and LTA windows in samples
+		int _numSTA, _numLTA;
+
+		// thresholds to declare a trigger on and off
+		double _triggerOn, _triggerOff;
+
+		// sampling frequency in Hz
+		double _fsamp;
+
+		// Per channel state
+		std::vector<double> _STA, _LTA;
+		std::vector<int>    _sampleCount;
+		std::vector<char>   _triggered;
+};
+
+
 } // namespace Seiscomp::Math::Filter
 } // namespace Seiscomp::Math
 } // namespace Seiscomp
@@ -68,6 +68,11 @@ InPlaceFilter<TYPE>* InitialTaper<TYPE>::clone() const {
 	return new InitialTaper<TYPE>(_taperLength, _offset, _samplingFrequency);
 }
 
+template<typename TYPE>
+void InitialTaper<TYPE>::serialize(Core::Archive &ar) {
+	ar & TAGGED_MEMBER(sampleCount);
+}
+
 template<typename TYPE>
 void InitialTaper<TYPE>::apply(int n, TYPE *inout) {
 	if ( _sampleCount >= _taperLengthI ) return;
@@ -54,6 +54,9 @@ class InitialTaper : public InPlaceFilter<TYPE> {
 		// resets the filter, i.e. erases the filter memory
 		void reset() { _sampleCount = 0; }
 
+		bool hasSerializableState() const override { return true; }
+		void serialize(Core::Archive &ar) override;
+
 
 	private:
 		double _taperLength,  _samplingFrequency;
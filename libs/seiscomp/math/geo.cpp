@@ -37,9 +37,11 @@ namespace Math
 namespace Geo
 {
 
-static int _delazi(double lat1,  double lon1, double lat2, double lon2,
-                   double *dist, double *azi, double *baz) {
-	double a,b,gam,cosa,cosb,cosc,sina,sinb,sinc,delta;
+// The terms of point 1 are passed in to share them between many point 2
+static inline int _delazi(double lat1, double lon1, double cosb, double sinb,
+                          double lat2, double lon2,
+                          double *dist, double *azi, double *baz) {
+	double a,gam,cosa,cosc,sina,sinc,delta;
 	if (lat1==lat2 && lon1==lon2) {
 		if (dist) *dist = 0.;
 		if (azi) *azi  = 0.;
@@ -47,12 +49,9 @@ static int _delazi(double lat1,  double lon1, double lat2, double lon2,
 		return 0;
 	}
 	a     = M_PI_2 - lat2;
-	b     = M_PI_2 - lat1;
 	gam   = lon1 - lon2;
 	cosa  = cos(a);
-	cosb  = cos(b);
 	sina  = sin(a);
-	sinb  = sin(b);
 	cosc  = cosa*cosb + sinb*sina*cos(gam);
 	cosc = std::min(1.0, std::max(-1.0, cosc));
 	delta = acos(cosc);
@@ -84,6 +83,12 @@ static int _delazi(double lat1,  double lon1, double lat2, double lon2,
 	return 0;
 }
 
+static int _delazi(double lat1,  double lon1, double lat2, double lon2,
+                   double *dist, double *azi, double *baz) {
+	double b = M_PI_2 - lat1;
+	return _delazi(lat1, lon1, cos(b), sin(b), lat2, lon2, dist, azi, baz);
+}
+
 void delazi(double lat1, double lon1, double lat2, double lon2,
             double *dist, double *azi1, double *azi2) {
 	double pi180 = M_PI/180., ip180 = 180./M_PI;
@@ -101,6 +106,25 @@ double delta(double lat1, double lon1, double lat2, double lon2) {
 	return out_dist;
 }
 
+void delazi(double lat1, double lon1, size_t count,
+            const double *lat2, const double *lon2,
+            double *dist, double *azi1, double *azi2) {
+	double pi180 = M_PI/180., ip180 = 180./M_PI;
+	double rlat1 = lat1*pi180, rlon1 = lon1*pi180;
+	double b = M_PI_2 - rlat1;
+	double cosb = cos(b), sinb = sin(b);
+
+	for ( size_t i = 0; i < count; ++i ) {
+		_delazi(rlat1, rlon1, cosb, sinb, lat2[i]*pi180, lon2[i]*pi180,
+		        dist ? dist + i : nullptr,
+		        azi1 ? azi1 + i : nullptr,
+		        azi2 ? azi2 + i : nullptr);
+		if (dist) dist[i] *= ip180;
+		if (azi1) azi1[i] *= ip180;
+		if (azi2) azi2[i] *= ip180;
+	}
+}
+
 static void mb_geocr( double lon, double lat, double *a, double *b, double *c ) {
 	double blbda, bphi, ep, ug, vg;
 
@@ -521,6 +545,51 @@ const CityD* largestCity(double lat, double lon, double maxDist,
 
 
 
+void UnitVectors::clear() {
+	_x.clear();
+	_y.clear();
+	_z.clear();
+}
+
+void UnitVectors::reserve(size_t count) {
+	_x.reserve(count);
+	_y.reserve(count);
+	_z.reserve(count);
+}
+
+void UnitVectors::push_back(double lat, double lon) {
+	double pi180 = M_PI/180.;
+	double coslat = cos(lat*pi180);
+	_x.push_back(coslat*cos(lon*pi180));
+	_y.push_back(coslat*sin(lon*pi180));
+	_z.push_back(sin(lat*pi180));
+}
+
+void UnitVectors::delta(double lat, double lon, double *dist) const {
+	double pi180 = M_PI/180., ip180 = 180./M_PI;
+	double coslat = cos(lat*pi180);
+	double x = coslat*cos(lon*pi180);
+	double y = coslat*sin(lon*pi180);
+	double z = sin(lat*pi180);
+	size_t n = _x.size();
+	const double *px = _x.data(), *py = _y.data(), *pz = _z.data();
+
+	// The dot products and the clipping are kept in a separate loop
+	// without any calls which the compiler can vectorize
+	for ( size_t i = 0; i < n; ++i ) {
+		double cosc = px[i]*x + py[i]*y + pz[i]*z;
+		dist[i] = cosc < -1.0 ? -1.0 : (cosc > 1.0 ? 1.0 : cosc);
+	}
+
+	for ( size_t i = 0; i < n; ++i )
+		dist[i] = acos(dist[i])*ip180;
+}
+
+
+
+
+
+
 PositionInterpolator::PositionInterpolator(double lat1, double lon1,
                                            double lat2, double lon2,
                                            int steps)
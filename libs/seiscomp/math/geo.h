@@ -54,6 +54,20 @@ void delazi(double lat1, double lon1, double lat2, double lon2,
             double *out_azi2 = nullptr);
 
 
+/**
+ * Same as delazi but for one point (lat1, lon1) and 'count' points
+ * (lat2[i], lon2[i]). The terms of the first point are computed only
+ * once. The results are identical to calling delazi for each pair.
+ * Each of the output arrays may be nullptr, otherwise it must hold 'count'
+ * values.
+ */
+SC_SYSTEM_CORE_API
+void delazi(double lat1, double lon1, size_t count,
+            const double *lat2, const double *lon2,
+            double *out_dist, double *out_azi1 = nullptr,
+            double *out_azi2 = nullptr);
+
+
 /**
  * For two points (lat1, lon1) and (lat2, lon2),
  * the angular distance 'dist' in degrees,
@@ -213,6 +227,39 @@ largestCity(double lat, double lon,
             double *dist, double *azi);
 
 
+/**
+ * Cartesian unit vectors of points on the sphere, e.g. station locations.
+ * The angular distance of two points reduces to the arc cosine of the dot
+ * product of their vectors. The components are stored in separate arrays
+ * to allow the compiler to vectorize the distance computation of all
+ * points to another point.
+ */
+class SC_SYSTEM_CORE_API UnitVectors {
+	public:
+		void clear();
+		void reserve(size_t count);
+
+		//! Adds the point (lat, lon) given in degrees
+		void push_back(double lat, double lon);
+
+		size_t size() const { return _x.size(); }
+		bool empty() const { return _x.empty(); }
+
+		/**
+		 * Computes the angular distances in degrees of all points to
+		 * (lat, lon). The results agree with delta within the rounding
+		 * errors of the different formulas.
+		 * @param out_dist The output array which must hold size() values
+		 */
+		void delta(double lat, double lon, double *out_dist) const;
+
+	private:
+		std::vector<double> _x;
+		std::vector<double> _y;
+		std::vector<double> _z;
+};
+
+
 class SC_SYSTEM_CORE_API PositionInterpolator {
 	public:
 		/**
@@ -49,10 +49,18 @@ double median(int n, const double *f)
 	if (n==0)
 		throw std::out_of_range("attempted computation of median for zero-length array");
 	vector<double> v(&f[0], &f[n]);
-	sort(v.begin(), v.end());
 	int mid = n/2;
 
-	return (n%2) ? v[mid] : (v[mid-1]+v[mid])/2;
+	// Only the middle element(s) are needed, a partial selection is
+	// sufficient instead of a full sort. The lower half contains all values
+	// less than or equal the selected one, its maximum is the second middle
+	// element in case of an even number of samples.
+	nth_element(v.begin(), v.begin()+mid, v.end());
+
+	if ( n % 2 )
+		return v[mid];
+
+	return (*max_element(v.begin(), v.begin()+mid)+v[mid])/2;
 }
 
 double fractile(const DoubleArray &v, double x)
@@ -68,15 +76,18 @@ double fractile(const std::vector<double> &v, double x)
 double fractile(int n, const double *f, double x)
 {
 	vector<double> v(&f[0], &f[n]);
-	sort(v.begin(), v.end());
 
 	double i = double(v.size()-1)*x;
 	double diff = double(int(i))-i;
+	vector<double>::iterator it = v.begin()+int(i);
+
+	nth_element(v.begin(), it, v.end());
 
 	if (diff==0)
-		return v[int(i)];
+		return *it;
 
-	return (v[int(i)]-v[int(i)+1])*diff + v[int(i)];
+	// The upper neighbour is the smallest value of the upper partition
+	return (*it-*min_element(it+1, v.end()))*diff + *it;
 }
 
 
@@ -92,12 +103,58 @@ double mean(const std::vector<double> &v)
 
 double mean(int n, const double *f)
 {
-	double m=0;
+	// Four independent partial sums break the dependency chain of the
+	// additions and allow the compiler to vectorize the loop
+	double m0=0, m1=0, m2=0, m3=0;
+	int i=0;
+
+	for (; i+4<=n; i+=4) {
+		m0 += f[i];
+		m1 += f[i+1];
+		m2 += f[i+2];
+		m3 += f[i+3];
+	}
 
-	for (int i=0; i<n; i++) 
-		m += f[i];
+	for (; i<n; i++)
+		m0 += f[i];
+
+	return ((m0+m1)+(m2+m3))/n;
+}
+
+
+double rms(const DoubleArray &v, double offset)
+{
+	return rms(v.size(), (const double*)v.data(), offset);
+}
+
+double rms(const std::vector<double> &v, double offset)
+{
+	return rms(v.size(), &v[0], offset);
+}
+
+double rms(int n, const double *f, double offset)
+{
+	if (n==0)
+		throw std::out_of_range("attempted computation of rms for zero-length array");
+
+	double s0=0, s1=0, s2=0, s3=0;
+	int i=0;
+
+	for (; i+4<=n; i+=4) {
+		double d0 = f[i]-offset, d1 = f[i+1]-offset;
+		double d2 = f[i+2]-offset, d3 = f[i+3]-offset;
+		s0 += d0*d0;
+		s1 += d1*d1;
+		s2 += d2*d2;
+		s3 += d3*d3;
+	}
+
+	for (; i<n; i++) {
+		double d = f[i]-offset;
+		s0 += d*d;
+	}
 
-	return m/n;
+	return sqrt(((s0+s1)+(s2+s3))/n);
 }
 
 
@@ -36,6 +36,11 @@ SC_SYSTEM_CORE_API double mean(const DoubleArray &);
 SC_SYSTEM_CORE_API double mean(const std::vector<double> &);
 SC_SYSTEM_CORE_API double mean(int n, const double *);
 
+//! Returns the root mean square of the values with respect to offset
+SC_SYSTEM_CORE_API double rms(const DoubleArray &, double offset = 0);
+SC_SYSTEM_CORE_API double rms(const std::vector<double> &, double offset = 0);
+SC_SYSTEM_CORE_API double rms(int n, const double *, double offset = 0);
+
 SC_SYSTEM_CORE_API double median(const DoubleArray &);
 SC_SYSTEM_CORE_API double median(const std::vector<double> &);
 SC_SYSTEM_CORE_API double median(int n, const double *);
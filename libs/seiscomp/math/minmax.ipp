@@ -31,12 +31,23 @@ minmax(int n, const TYPE *f, int i1, int i2, TYPE *fmin, TYPE *fmax)
 	if(i1<0) i1=0;
 	if(i2>n) i2=n;
 
-	*fmin = *fmax = f[i1];
-	f += i1+1;
-	for (i=i1+1; i<i2; i++, f++) {
-		if(*f > *fmax) *fmax = *f; 
-		if(*f < *fmin) *fmin = *f; 
-        }
+	// Branchless updates of two independent lanes which the compiler is
+	// able to map to packed min/max instructions
+	TYPE lo0 = f[i1], hi0 = f[i1], lo1 = f[i1], hi1 = f[i1];
+	for (i=i1+1; i+1<i2; i+=2) {
+		lo0 = f[i]   < lo0 ? f[i]   : lo0;
+		hi0 = f[i]   > hi0 ? f[i]   : hi0;
+		lo1 = f[i+1] < lo1 ? f[i+1] : lo1;
+		hi1 = f[i+1] > hi1 ? f[i+1] : hi1;
+	}
+
+	if (i<i2) {
+		lo0 = f[i] < lo0 ? f[i] : lo0;
+		hi0 = f[i] > hi0 ? f[i] : hi0;
+	}
+
+	*fmin = lo1 < lo0 ? lo1 : lo0;
+	*fmax = hi1 > hi0 ? hi1 : hi0;
 
 	return 0;
 }
@@ -0,0 +1,592 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/math/orderstatistics.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace Seiscomp {
+namespace Math {
+namespace Statistics {
+
+
+namespace {
+
+
+// Turns the shifted sums into the mean and the standard deviation with
+// respect to the mean
+void meanDeviation(double count, double sum, double sum2, double shift,
+                   double &value, double &stdev) {
+	double m = sum / count;
+	value = m + shift;
+	stdev = 0;
+
+	if ( count > 1 ) {
+		double d = std::max(0.0, sum2 - m * sum);
+		stdev = sqrt(d / (count - 1));
+	}
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void OrderStatistics::Sums::add(const Sums &other, double weight) {
+	count += weight * other.count;
+	sum += weight * other.sum;
+	sum2 += weight * other.sum2;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OrderStatistics::OrderStatistics()
+: _root(npos), _shift(0), _seed(2463534242u) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OrderStatistics::Handle OrderStatistics::insert(double value) {
+	Handle handle;
+
+	if ( !_freeHandles.empty() ) {
+		handle = _freeHandles.back();
+		_freeHandles.pop_back();
+	}
+	else {
+		handle = _nodes.size();
+		_nodes.emplace_back();
+	}
+
+	// The sums are relative to the first value which keeps the
+	// cancellation in the standard deviation small
+	if ( _root == npos )
+		_shift = value;
+
+	// xorshift32
+	_seed ^= _seed << 13;
+	_seed ^= _seed >> 17;
+	_seed ^= _seed << 5;
+
+	Node &n = _nodes[handle];
+	n.value = value;
+	n.left = n.right = npos;
+	n.priority = _seed;
+	n.used = true;
+	pull(handle);
+
+	size_t left, right;
+	split(_root, handle, left, right);
+	_root = merge(merge(left, handle), right);
+
+	return handle;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::remove(Handle handle) {
+	if ( !contains(handle) ) return false;
+
+	_root = erase(_root, handle);
+	_nodes[handle].used = false;
+	_freeHandles.push_back(handle);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::update(Handle handle, double value) {
+	if ( !contains(handle) ) return false;
+
+	_root = erase(_root, handle);
+
+	if ( _root == npos )
+		_shift = value;
+
+	Node &n = _nodes[handle];
+	n.value = value;
+	n.left = n.right = npos;
+	pull(handle);
+
+	size_t left, right;
+	split(_root, handle, left, right);
+	_root = merge(merge(left, handle), right);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void OrderStatistics::clear() {
+	_nodes.clear();
+	_freeHandles.clear();
+	_root = npos;
+	_shift = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::contains(Handle handle) const {
+	return handle < _nodes.size() && _nodes[handle].used;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double OrderStatistics::value(Handle handle) const {
+	return node(handle).value;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t OrderStatistics::rank(Handle handle) const {
+	node(handle);
+
+	size_t r = 0;
+	size_t n = _root;
+
+	while ( n != handle ) {
+		if ( less(handle, n) )
+			n = _nodes[n].left;
+		else {
+			r += sums(_nodes[n].left).count + 1;
+			n = _nodes[n].right;
+		}
+	}
+
+	return r + (size_t)sums(_nodes[n].left).count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double OrderStatistics::at(size_t rank) const {
+	if ( rank >= size() )
+		throw std::out_of_range("rank out of range");
+
+	return _nodes[find(rank)].value;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double OrderStatistics::median() const {
+	size_t n = size();
+	if ( n == 0 )
+		throw std::out_of_range("attempted computation of median for zero-length array");
+
+	size_t mid = n / 2;
+	if ( n % 2 )
+		return at(mid);
+
+	return (at(mid - 1) + at(mid)) / 2;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::mean(double &value, double &stdev) const {
+	if ( empty() ) return false;
+
+	Sums s = sums(_root);
+	meanDeviation(s.count, s.sum, s.sum2, _shift, value, stdev);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::median(double &value, double &stdev) const {
+	if ( empty() ) return false;
+
+	value = median();
+	stdev = 0;
+
+	Sums s = sums(_root);
+	if ( s.count > 1 ) {
+		// Sum of the squared deviations from the median
+		double m = value - _shift;
+		double d = std::max(0.0, s.sum2 - 2 * m * s.sum + s.count * m * m);
+		stdev = sqrt(d / (s.count - 1));
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::trimmedMean(double percent, double &value, double &stdev) const {
+	if ( empty() ) return false;
+
+	Sums s = trimmed(percent);
+	meanDeviation(s.count, s.sum, s.sum2, _shift, value, stdev);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::medianTrimmedMean(double distance, double &value, double &stdev) const {
+	if ( empty() ) return false;
+
+	double m = median();
+
+	// The values within the distance form a contiguous range in the
+	// order. It starts after the smaller values which are too far away
+	// and ends before the larger values which are too far away.
+	Sums below = prefixWhile([m, distance](double v) {
+		return v <= m && !(std::abs(v - m) <= distance);
+	});
+	Sums upto = prefixWhile([m, distance](double v) {
+		return v <= m || std::abs(v - m) <= distance;
+	});
+
+	upto.add(below, -1);
+	meanDeviation(upto.count, upto.sum, upto.sum2, _shift, value, stdev);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double OrderStatistics::trimmedMeanWeight(Handle handle, double percent) const {
+	return trimmedWeight(rank(handle), percent);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double OrderStatistics::medianTrimmedMeanWeight(Handle handle, double distance) const {
+	return std::abs(value(handle) - median()) <= distance ? 1 : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool OrderStatistics::less(size_t a, size_t b) const {
+	const Node &na = _nodes[a];
+	const Node &nb = _nodes[b];
+	return na.value < nb.value || (na.value == nb.value && a < b);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void OrderStatistics::pull(size_t node) {
+	Node &n = _nodes[node];
+	double x = n.value - _shift;
+
+	n.count = 1;
+	n.sum = x;
+	n.sum2 = x * x;
+
+	for ( size_t child : { n.left, n.right } ) {
+		if ( child == npos ) continue;
+		const Node &c = _nodes[child];
+		n.count += c.count;
+		n.sum += c.sum;
+		n.sum2 += c.sum2;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void OrderStatistics::split(size_t node, size_t key, size_t &left, size_t &right) {
+	if ( node == npos ) {
+		left = right = npos;
+		return;
+	}
+
+	Node &n = _nodes[node];
+	if ( less(node, key) ) {
+		split(n.right, key, n.right, right);
+		left = node;
+	}
+	else {
+		split(n.left, key, left, n.left);
+		right = node;
+	}
+
+	pull(node);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t OrderStatistics::merge(size_t left, size_t right) {
+	if ( left == npos ) return right;
+	if ( right == npos ) return left;
+
+	if ( _nodes[left].priority > _nodes[right].priority ) {
+		_nodes[left].right = merge(_nodes[left].right, right);
+		pull(left);
+		return left;
+	}
+
+	_nodes[right].left = merge(left, _nodes[right].left);
+	pull(right);
+	return right;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t OrderStatistics::erase(size_t node, size_t key) {
+	if ( node == key )
+		return merge(_nodes[node].left, _nodes[node].right);
+
+	if ( less(key, node) )
+		_nodes[node].left = erase(_nodes[node].left, key);
+	else
+		_nodes[node].right = erase(_nodes[node].right, key);
+
+	pull(node);
+	return node;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const OrderStatistics::Node &OrderStatistics::node(Handle handle) const {
+	if ( !contains(handle) )
+		throw std::out_of_range("invalid handle");
+
+	return _nodes[handle];
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t OrderStatistics::find(size_t rank) const {
+	size_t n = _root;
+
+	while ( true ) {
+		size_t leftCount = (size_t)sums(_nodes[n].left).count;
+		if ( rank < leftCount )
+			n = _nodes[n].left;
+		else if ( rank == leftCount )
+			return n;
+		else {
+			rank -= leftCount + 1;
+			n = _nodes[n].right;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OrderStatistics::Sums OrderStatistics::sums(size_t node) const {
+	Sums s;
+	if ( node != npos ) {
+		const Node &n = _nodes[node];
+		s.count = n.count;
+		s.sum = n.sum;
+		s.sum2 = n.sum2;
+	}
+	return s;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OrderStatistics::Sums OrderStatistics::prefix(size_t count) const {
+	Sums s;
+	size_t n = _root;
+
+	while ( count > 0 && n != npos ) {
+		const Node &node = _nodes[n];
+		Sums left = sums(node.left);
+
+		if ( count <= left.count )
+			n = node.left;
+		else {
+			s.add(left);
+			s.add(element(n));
+			count -= (size_t)left.count + 1;
+			n = node.right;
+		}
+	}
+
+	return s;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OrderStatistics::Sums OrderStatistics::element(size_t node) const {
+	Sums s;
+	double x = _nodes[node].value - _shift;
+	s.count = 1;
+	s.sum = x;
+	s.sum2 = x * x;
+	return s;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename P>
+OrderStatistics::Sums OrderStatistics::prefixWhile(P pred) const {
+	Sums s;
+	size_t n = _root;
+
+	while ( n != npos ) {
+		const Node &node = _nodes[n];
+		if ( pred(node.value) ) {
+			s.add(sums(node.left));
+			s.add(element(n));
+			n = node.right;
+		}
+		else
+			n = node.left;
+	}
+
+	return s;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OrderStatistics::Sums OrderStatistics::trimmed(double percent) const {
+	// Same weighting as computeTrimmedMean: the inner values have weight
+	// one, the first and the last used value a fractional weight.
+	size_t n = size();
+	double xl = percent * 0.005;
+	long k = long(n * xl + 1e-5);
+	double w = k + 1 - n * xl;
+	long lo = k, hi = long(n) - k - 1;
+
+	Sums s;
+
+	if ( lo + 1 < hi ) {
+		s = prefix(size_t(hi));
+		s.add(prefix(size_t(lo + 1)), -1);
+	}
+
+	if ( lo >= 0 && lo < long(n) )
+		s.add(element(find(size_t(lo))), w);
+
+	if ( hi != lo && hi >= 0 && hi < long(n) )
+		s.add(element(find(size_t(hi))), w);
+
+	return s;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double OrderStatistics::trimmedWeight(size_t rank, double percent) const {
+	size_t n = size();
+	double xl = percent * 0.005;
+	long k = long(n * xl + 1e-5);
+	long i = long(rank);
+
+	if ( i >= k + 1 && i < long(n) - k - 1 )
+		return 1;
+
+	if ( i == k || i == long(n) - k - 1 )
+		return k + 1 - n * xl;
+
+	return 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+} // namespace Statistics
+} // namespace Math
+} // namespace Seiscomp
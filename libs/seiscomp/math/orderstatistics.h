@@ -0,0 +1,192 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_MATH_ORDERSTATISTICS_H
+#define SEISCOMP_MATH_ORDERSTATISTICS_H
+
+
+#include <seiscomp/core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Math {
+namespace Statistics {
+
+
+/**
+ * @brief A multiset of values which keeps the order statistics and the
+ *        partial sums up to date while values are added, removed or
+ *        changed.
+ *
+ * All operations run in O(log n) expected time. This allows to maintain
+ * an aggregated value, e.g. a network magnitude from its station
+ * magnitudes, incrementally instead of computing it from scratch after
+ * each change. The aggregations match the corresponding functions of
+ * mean.h up to rounding.
+ *
+ * Each value is referenced by the handle returned by insert. Equal values
+ * are ordered by their handles. Values must not be NaN.
+ */
+class SC_SYSTEM_CORE_API OrderStatistics {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		using Handle = size_t;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		OrderStatistics();
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Adds a value and returns its handle. Handles of removed values
+		//! are reused.
+		Handle insert(double value);
+
+		//! Removes a value, returns false if the handle is not valid
+		bool remove(Handle handle);
+
+		//! Changes a value, returns false if the handle is not valid
+		bool update(Handle handle, double value);
+
+		void clear();
+
+		size_t size() const { return _root == npos ? 0 : _nodes[_root].count; }
+		bool empty() const { return _root == npos; }
+
+		bool contains(Handle handle) const;
+
+		//! Returns the value of a handle. Throws std::out_of_range if the
+		//! handle is not valid.
+		double value(Handle handle) const;
+
+		//! Returns the position of a value in ascending order. Throws
+		//! std::out_of_range if the handle is not valid.
+		size_t rank(Handle handle) const;
+
+		//! Returns the value at a position in ascending order. Throws
+		//! std::out_of_range if rank >= size().
+		double at(size_t rank) const;
+
+		//! Same as Statistics::median, throws std::out_of_range if empty
+		double median() const;
+
+		//! Same as computeMean. Returns false if empty.
+		bool mean(double &value, double &stdev) const;
+
+		//! Computes the median and the standard deviation of the values
+		//! with respect to the median. Returns false if empty.
+		bool median(double &value, double &stdev) const;
+
+		//! Same as computeTrimmedMean. Returns false if empty.
+		bool trimmedMean(double percent, double &value, double &stdev) const;
+
+		//! Same as computeMedianTrimmedMean. Returns false if empty.
+		bool medianTrimmedMean(double distance, double &value, double &stdev) const;
+
+		//! Returns the weight of a value as computed by computeTrimmedMean.
+		//! Throws std::out_of_range if the handle is not valid.
+		double trimmedMeanWeight(Handle handle, double percent) const;
+
+		//! Returns the weight of a value as computed by
+		//! computeMedianTrimmedMean. Throws std::out_of_range if the handle
+		//! is not valid.
+		double medianTrimmedMeanWeight(Handle handle, double distance) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private types and methods
+	// ----------------------------------------------------------------------
+	private:
+		static const size_t npos = size_t(-1);
+
+		// A treap node, each node holds the aggregates of its subtree
+		struct Node {
+			double   value;
+			size_t   left;
+			size_t   right;
+			size_t   count;
+			// Sums of the values relative to _shift and their squares
+			double   sum;
+			double   sum2;
+			uint32_t priority;
+			bool     used;
+		};
+
+		struct Sums {
+			double count{0};
+			double sum{0};
+			double sum2{0};
+
+			void add(const Sums &other, double weight = 1);
+		};
+
+		bool less(size_t a, size_t b) const;
+		void pull(size_t node);
+		void split(size_t node, size_t key, size_t &left, size_t &right);
+		size_t merge(size_t left, size_t right);
+		size_t erase(size_t node, size_t key);
+
+		const Node &node(Handle handle) const;
+		size_t find(size_t rank) const;
+		Sums sums(size_t node) const;
+		Sums prefix(size_t count) const;
+		Sums element(size_t node) const;
+
+		// Returns the sums of the leading values for which pred is true.
+		// pred must be true for a prefix of the ordered values only.
+		template <typename P>
+		Sums prefixWhile(P pred) const;
+
+		// Returns the weighted sums as used by trimmedMean
+		Sums trimmed(double percent) const;
+		double trimmedWeight(size_t rank, double percent) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		std::vector<Node>   _nodes;
+		std::vector<Handle> _freeHandles;
+		size_t              _root;
+		double              _shift;
+		uint32_t            _seed;
+};
+
+
+} // namespace Statistics
+} // namespace Math
+} // namespace Seiscomp
+
+
+#endif
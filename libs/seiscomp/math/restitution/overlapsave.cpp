@@ -0,0 +1,252 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#include <seiscomp/math/restitution/overlapsave.h>
+#include <seiscomp/core/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace Math {
+namespace Restitution {
+
+
+namespace {
+
+
+// Weight of spectral bin k with the same taper bounds transformFFT uses
+double taperWeight(int k, int istart, int iend, int estart, int eend) {
+	if ( k < istart ) return 0;
+	if ( k < iend ) return 0.5*(1-cos(M_PI*double(k-istart)/(iend-istart)));
+	if ( k >= eend ) return 0;
+	if ( k >= estart ) return 0.5*(1+cos(M_PI*double(k-estart)/(eend-estart)));
+	return 1;
+}
+
+
+}
+
+
+template <typename T>
+OverlapSaveFilter<T>::OverlapSaveFilter(const FFT::TransferFunction *tf,
+                                        double minFreq, double maxFreq,
+                                        double length, double fsamp)
+: _tf(tf), _minFreq(minFreq), _maxFreq(maxFreq), _length(length)
+, _fsamp(0), _taps(0), _fftSize(0), _blockSize(0), _fill(0) {
+	if ( fsamp )
+		setSamplingFrequency(fsamp);
+}
+
+
+template <typename T>
+void OverlapSaveFilter<T>::setTransferFunction(const FFT::TransferFunction *tf) {
+	_tf = tf;
+	design();
+}
+
+
+template <typename T>
+int OverlapSaveFilter<T>::delay() const {
+	return _taps ? _taps/2 + _blockSize : 0;
+}
+
+
+template <typename T>
+void OverlapSaveFilter<T>::reset() {
+	fill(_input.begin(), _input.end(), 0.0);
+	fill(_output.begin(), _output.end(), 0.0);
+	_fill = 0;
+}
+
+
+template <typename T>
+void OverlapSaveFilter<T>::setSamplingFrequency(double fsamp) {
+	if ( _fsamp == fsamp ) return;
+	_fsamp = fsamp;
+	design();
+}
+
+
+template <typename T>
+int OverlapSaveFilter<T>::setParameters(int n, const double *params) {
+	if ( n < 2 || n > 3 ) return 3;
+
+	_minFreq = params[0];
+	_maxFreq = params[1];
+	_length = n > 2 ? params[2] : 0;
+
+	// Otherwise the kernel is designed when the sampling frequency is set
+	if ( _fsamp > 0 )
+		design();
+
+	return n;
+}
+
+
+template <typename T>
+void OverlapSaveFilter<T>::design() {
+	_taps = _fftSize = _blockSize = 0;
+	_kernel.clear();
+	_input.clear();
+	_output.clear();
+	_work.clear();
+	_fill = 0;
+
+	if ( !_tf || _fsamp <= 0 ) return;
+
+	double length = _length;
+	if ( length <= 0 )
+		length = _minFreq > 0 ? 4.0 / _minFreq : 10.0;
+
+	_taps = (int)Filtering::next_power_of_2((long)(length * _fsamp));
+	if ( _taps < 16 ) _taps = 16;
+
+	_fftSize = _taps * 2;
+	_blockSize = _fftSize - _taps + 1;
+
+	// The layout of the spectra depends on the FFT implementation, let
+	// the transform of an empty kernel define it.
+	vector<double> h(_taps, 0.0);
+	ComplexArray coeff;
+	fft(coeff, _taps, &h[0]);
+
+	int ncoeff = _taps/2+1;
+	int nbins = (int)coeff.size();
+	double df = _fsamp / _taps;
+
+	int iTaperStart = 0, iTaperEnd = 0;
+	int eTaperStart = ncoeff, eTaperEnd = ncoeff;
+
+	if ( _minFreq > 0 ) {
+		iTaperEnd = min((int)(_minFreq / df), ncoeff);
+		iTaperStart = iTaperEnd / 2;
+	}
+
+	if ( _maxFreq > 0 ) {
+		eTaperStart = min((int)(_maxFreq / df), ncoeff);
+		eTaperEnd = min((int)((_maxFreq * 2) / df), ncoeff);
+		if ( eTaperStart < iTaperEnd ) eTaperStart = iTaperEnd;
+	}
+
+	// Tapered inverse response shifted by half the kernel length. DC and
+	// Nyquist are left zero, bins with zero weight are not deconvolved to
+	// not divide by zeros of the transfer function.
+	int first = nbins, last = 0;
+	for ( int k = 1; k < nbins && k < _taps/2; ++k ) {
+		double w = taperWeight(k, iTaperStart, iTaperEnd, eTaperStart, eTaperEnd);
+		coeff[k] = (k & 1) ? -w : w;
+		if ( w > 0 ) {
+			if ( first > k ) first = k;
+			last = k;
+		}
+	}
+
+	if ( first <= last )
+		_tf->deconvolve(last-first+1, &coeff[first], first*df, df);
+
+	ifft(_taps, &h[0], coeff);
+
+	// Smooth the truncation of the impulse response
+	int ramp = _taps / 10;
+	for ( int i = 0; i < ramp; ++i ) {
+		double w = 0.5*(1-cos(M_PI*double(i)/ramp));
+		h[i] *= w;
+		h[_taps-1-i] *= w;
+	}
+
+	_work.assign(_fftSize, 0.0);
+	copy(h.begin(), h.end(), _work.begin());
+	fft(_kernel, _fftSize, &_work[0]);
+
+	_input.assign(_fftSize, 0.0);
+	_output.assign(_blockSize, 0.0);
+}
+
+
+template <typename T>
+void OverlapSaveFilter<T>::filterBlock() {
+	fft(_spectrum, _fftSize, &_input[0]);
+
+	// The first bin may carry the real Nyquist coefficient as imaginary
+	// part, both are real and multiplied separately.
+	_spectrum[0] = Complex(_spectrum[0].real() * _kernel[0].real(),
+	                       _spectrum[0].imag() * _kernel[0].imag());
+	for ( size_t k = 1; k < _spectrum.size(); ++k )
+		_spectrum[k] *= _kernel[k];
+
+	ifft(_fftSize, &_work[0], _spectrum);
+
+	// Only the last blockSize samples are free of wrap around
+	copy(_work.begin() + (_taps-1), _work.end(), _output.begin());
+	copy(_input.end() - (_taps-1), _input.end(), _input.begin());
+}
+
+
+template <typename T>
+void OverlapSaveFilter<T>::apply(int n, T *inout) {
+	if ( _fsamp <= 0 )
+		throw Core::GeneralException("Samplerate not initialized");
+
+	if ( !_tf )
+		throw Core::GeneralException("Transfer function not set");
+
+	while ( n > 0 ) {
+		int chunk = min(n, _blockSize - _fill);
+		double *in = &_input[_taps-1+_fill];
+		const double *out = &_output[_fill];
+
+		for ( int i = 0; i < chunk; ++i ) {
+			double v = inout[i];
+			inout[i] = (T)out[i];
+			in[i] = v;
+		}
+
+		_fill += chunk;
+		inout += chunk;
+		n -= chunk;
+
+		if ( _fill == _blockSize ) {
+			filterBlock();
+			_fill = 0;
+		}
+	}
+}
+
+
+template <typename T>
+Filtering::InPlaceFilter<T> *OverlapSaveFilter<T>::clone() const {
+	return new OverlapSaveFilter<T>(_tf.get(), _minFreq, _maxFreq, _length, _fsamp);
+}
+
+
+template class SC_SYSTEM_CORE_API OverlapSaveFilter<float>;
+template class SC_SYSTEM_CORE_API OverlapSaveFilter<double>;
+
+
+}
+}
+}
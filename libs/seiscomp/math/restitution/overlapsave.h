@@ -0,0 +1,130 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#ifndef SEISCOMP_MATH_RESTITUTION_OVERLAPSAVE_H
+#define SEISCOMP_MATH_RESTITUTION_OVERLAPSAVE_H
+
+
+#include <vector>
+#include <seiscomp/math/fft.h>
+#include <seiscomp/math/filter.h>
+#include <seiscomp/math/restitution/transferfunction.h>
+
+
+namespace Seiscomp {
+namespace Math {
+namespace Restitution {
+
+
+/**
+ * @brief The OverlapSaveFilter class deconvolves a continuous data stream
+ *        with a transfer function.
+ *
+ * The inverse of the transfer function, tapered below minFreq and above
+ * maxFreq in the same way as transformFFT does, is turned into a FIR
+ * kernel once the sampling frequency is known. The kernel spectrum is
+ * kept and the stream is filtered block wise with the overlap-save method
+ * so that each incoming sample costs a fraction of two FFTs of twice the
+ * kernel length instead of transforming the whole time window again
+ * whenever new data arrive.
+ *
+ * The kernel is non-causal and blocks are only filtered when complete,
+ * so the output is delayed by delay() samples with respect to the input.
+ * The first delay() output samples are zero.
+ */
+template <typename T>
+class OverlapSaveFilter : public Filtering::InPlaceFilter<T> {
+	public:
+		/**
+		 * @brief Constructs the filter.
+		 * @param tf The transfer function to deconvolve with. The object is
+		 *           referenced by the filter.
+		 * @param minFreq The lower corner of the spectral taper in Hz.
+		 *                Disabled if not greater than 0.
+		 * @param maxFreq The upper corner of the spectral taper in Hz.
+		 *                Disabled if not greater than 0.
+		 * @param length The kernel length in seconds. If not greater than 0
+		 *               four periods of minFreq or ten seconds are used.
+		 * @param fsamp The sampling frequency. If 0 the kernel is designed
+		 *              when setSamplingFrequency is called.
+		 */
+		OverlapSaveFilter(const FFT::TransferFunction *tf = nullptr,
+		                  double minFreq = 0, double maxFreq = 0,
+		                  double length = 0, double fsamp = 0);
+
+
+	public:
+		void setTransferFunction(const FFT::TransferFunction *tf);
+
+		//! Returns the number of kernel taps
+		int kernelLength() const { return _taps; }
+
+		//! Returns the delay of the output in samples
+		int delay() const;
+
+		//! Clears the data history while keeping the kernel
+		void reset();
+
+
+	// InPlaceFilter interface
+	public:
+		void setSamplingFrequency(double fsamp) override;
+
+		//! Sets minFreq, maxFreq and optionally the kernel length
+		int setParameters(int n, const double *params) override;
+
+		void apply(int n, T *inout) override;
+
+		Filtering::InPlaceFilter<T> *clone() const override;
+
+
+	private:
+		void design();
+		void filterBlock();
+
+
+	private:
+		FFT::TransferFunctionCPtr _tf;
+		double                    _minFreq;
+		double                    _maxFreq;
+		double                    _length;
+		double                    _fsamp;
+
+		int                       _taps;
+		int                       _fftSize;
+		int                       _blockSize;
+		int                       _fill;
+
+		ComplexArray              _kernel;
+		ComplexArray              _spectrum;
+		std::vector<double>       _input;
+		std::vector<double>       _output;
+		std::vector<double>       _work;
+};
+
+
+}
+}
+}
+
+
+#endif
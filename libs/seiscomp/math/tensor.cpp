@@ -808,6 +808,44 @@ T Spectral2S<T>::norm() {
 	return sqrt(a1*a1 + a2*a2 + a3*a3);
 }
 //---------------------------------------------------------------------------
+template <typename T>
+size_t spect(Spectral2S<T> *spectra, const Tensor2S<T> *tensors, size_t n,
+             T atol, int itmax) {
+	size_t count = 0;
+	for ( size_t i = 0; i < n; ++i ) {
+		if ( spectra[i].spect(tensors[i], atol, itmax) )
+			++count;
+	}
+	return count;
+}
+//---------------------------------------------------------------------------
+template <typename T>
+void radiationPattern(T *amplitudes, const Tensor2S<T> &A,
+                      const T *x, const T *y, const T *z, size_t n) {
+	// copy the components to allow vectorization of the loop
+	const T a11 = A._11, a22 = A._22, a33 = A._33;
+	const T a12 = 2*A._12, a13 = 2*A._13, a23 = 2*A._23;
+
+	for ( size_t i = 0; i < n; ++i ) {
+		const T vx = x[i], vy = y[i], vz = z[i];
+		amplitudes[i] = vx*vx*a11 + vy*vy*a22 + vz*vz*a33 +
+		                vx*vy*a12 + vx*vz*a13 + vy*vz*a23;
+	}
+}
+//---------------------------------------------------------------------------
+template <typename T>
+void radiationPattern(T *amplitudes, const Tensor2S<T> *tensors, size_t n,
+                      const Vector3<T> &v) {
+	const T xx = v.x*v.x, yy = v.y*v.y, zz = v.z*v.z;
+	const T xy = 2*v.x*v.y, xz = 2*v.x*v.z, yz = 2*v.y*v.z;
+
+	for ( size_t i = 0; i < n; ++i ) {
+		const Tensor2S<T> &A = tensors[i];
+		amplitudes[i] = xx*A._11 + yy*A._22 + zz*A._33 +
+		                xy*A._12 + xz*A._13 + yz*A._23;
+	}
+}
+//---------------------------------------------------------------------------
 template class SC_SYSTEM_CORE_API Tensor2N<float>;
 template class SC_SYSTEM_CORE_API Tensor2N<double>;
 
@@ -817,6 +855,15 @@ template class SC_SYSTEM_CORE_API Tensor2S<double>;
 template class SC_SYSTEM_CORE_API Spectral2S<float>;
 template class SC_SYSTEM_CORE_API Spectral2S<double>;
 
+template SC_SYSTEM_CORE_API size_t spect<float>(Spectral2S<float> *, const Tensor2S<float> *, size_t, float, int);
+template SC_SYSTEM_CORE_API size_t spect<double>(Spectral2S<double> *, const Tensor2S<double> *, size_t, double, int);
+
+template SC_SYSTEM_CORE_API void radiationPattern<float>(float *, const Tensor2S<float> &, const float *, const float *, const float *, size_t);
+template SC_SYSTEM_CORE_API void radiationPattern<double>(double *, const Tensor2S<double> &, const double *, const double *, const double *, size_t);
+
+template SC_SYSTEM_CORE_API void radiationPattern<float>(float *, const Tensor2S<float> *, size_t, const Vector3<float> &);
+template SC_SYSTEM_CORE_API void radiationPattern<double>(double *, const Tensor2S<double> *, size_t, const Vector3<double> &);
+
 
 }
 }
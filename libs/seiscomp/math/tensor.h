@@ -256,6 +256,31 @@ typedef Spectral2S<float>  Spectral2Sf;
 typedef Spectral2S<double> Spectral2Sd;
 
 
+/**
+ * Batch functions which process arrays of tensors or directions. The
+ * directions are passed as separate coordinate arrays which allows the
+ * compiler to vectorize the loops.
+ */
+
+//! spectral decomposition of n tensors, returns the number of tensors
+//! which have been decomposed successfully
+template <typename T>
+size_t spect(Spectral2S<T> *spectra, const Tensor2S<T> *tensors, size_t n,
+             T atol = 1e-12, int itmax = 50);
+
+//! evaluate the P wave radiation pattern v^T A v of a moment tensor
+//! for n directions. The isotropic part is not removed.
+template <typename T>
+void radiationPattern(T *amplitudes, const Tensor2S<T> &A,
+                      const T *x, const T *y, const T *z, size_t n);
+
+//! evaluate the P wave radiation pattern of n moment tensors for a
+//! single direction
+template <typename T>
+void radiationPattern(T *amplitudes, const Tensor2S<T> *tensors, size_t n,
+                      const Vector3<T> &v);
+
+
 }
 }
 
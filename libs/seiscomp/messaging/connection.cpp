@@ -332,6 +332,19 @@ Result Connection::unsubscribe(const string &group) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Connection::setSubscriptionFilter(const std::string &group,
+                                         const std::vector<std::string> &types,
+                                         const std::vector<std::string> &parentIDs) {
+	if ( !_protocol ) return _lastError = InvalidProtocol;
+	_lastError = _protocol->setSubscriptionFilter(group, types, parentIDs);
+	return _lastError;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Result Connection::fetchInbox() {
 	if ( !_protocol ) return _lastError = InvalidProtocol;
@@ -352,6 +365,26 @@ Result Connection::syncOutbox() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Connection::beginBatch(size_t maxBytes) {
+	if ( !_protocol ) return _lastError = InvalidProtocol;
+	return _lastError = _protocol->beginBatch(maxBytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Connection::endBatch() {
+	if ( !_protocol ) return _lastError = InvalidProtocol;
+	return _lastError = _protocol->endBatch();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Core::Message *Connection::recv(Packet **packet, Result *status) {
 	if ( packet ) *packet = nullptr;
@@ -363,11 +396,8 @@ Core::Message *Connection::recv(Packet **packet, Result *status) {
 	}
 
 	while ( true ) {
-		Packet *p = _protocol->recv(&_lastError);
-		if ( !p ) {
-			if ( status ) *status = _lastError;
-			return nullptr;
-		}
+		Packet *p = recvPacket(status);
+		if ( !p ) return nullptr;
 
 		if ( p->type != Packet::Data ) {
 			if ( packet ) {
@@ -383,19 +413,7 @@ Core::Message *Connection::recv(Packet **packet, Result *status) {
 			continue;
 		}
 
-		Core::Message *msg = nullptr;
-
-		Protocol::ContentEncoding ce(Protocol::Identity);
-		if ( p->headerContentEncoding.empty()
-		  || ce.fromString(p->headerContentEncoding) ) {
-			Protocol::ContentType ct;
-			if ( !ct.fromString(p->headerContentType) )
-				_lastError = ContentTypeUnknown;
-			else
-				msg = Protocol::decode(p->payload, ce, ct);
-		}
-		else
-			_lastError = ContentEncodingUnknown;
+		Core::Message *msg = decode(p, &_lastError);
 
 		if ( packet ) {
 			*packet = p;
@@ -421,6 +439,48 @@ Core::Message *Connection::recv(Packet **packet, Result *status) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Packet *Connection::recvPacket(Result *status) {
+	if ( !_protocol ) {
+		_lastError = InvalidProtocol;
+		if ( status ) *status = _lastError;
+		return nullptr;
+	}
+
+	Packet *p = _protocol->recv(&_lastError);
+	if ( status ) *status = _lastError;
+	return p;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::Message *Connection::decode(const Packet *packet, Result *status) {
+	Core::Message *msg = nullptr;
+	Result result = OK;
+
+	Protocol::ContentEncoding ce(Protocol::Identity);
+	if ( packet->headerContentEncoding.empty()
+	  || ce.fromString(packet->headerContentEncoding) ) {
+		Protocol::ContentType ct;
+		if ( !ct.fromString(packet->headerContentType) )
+			result = ContentTypeUnknown;
+		else
+			msg = Protocol::decode(packet->payload, ce, ct);
+	}
+	else
+		result = ContentEncodingUnknown;
+
+	if ( status ) *status = result;
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Core::Message *Connection::recv(PacketPtr &packet, Result *status) {
 	Packet *tmp;
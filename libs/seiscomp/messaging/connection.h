@@ -194,6 +194,18 @@ class SC_SYSTEM_CLIENT_API Connection : public Core::BaseObject {
 		Result unsubscribe(const char *group);
 		Result unsubscribe(const std::string &group);
 
+		/**
+		 * @brief Restricts the messages of a group to particular object
+		 *        types or parents. See Protocol::setSubscriptionFilter().
+		 * @param group The group name
+		 * @param types The object class names, empty matches all
+		 * @param parentIDs The parent publicIDs, empty matches all
+		 * @return Result code
+		 */
+		Result setSubscriptionFilter(const std::string &group,
+		                             const std::vector<std::string> &types,
+		                             const std::vector<std::string> &parentIDs = {});
+
 		/**
 		 * @brief Waits for a new message to arrive so that a subsequent call
 		 *        to \ref recv() will return immediately.
@@ -208,6 +220,22 @@ class SC_SYSTEM_CLIENT_API Connection : public Core::BaseObject {
 		 */
 		Result syncOutbox();
 
+		/**
+		 * @brief Starts a batch of messages which are written to the
+		 *        network together. See Protocol::beginBatch().
+		 * @param maxBytes The number of collected bytes which causes the
+		 *                 messages to be written before the batch is finished.
+		 * @return Result code
+		 */
+		Result beginBatch(size_t maxBytes = 65536);
+
+		/**
+		 * @brief Finishes a batch and writes all collected messages.
+		 *        See Protocol::endBatch().
+		 * @return Result code
+		 */
+		Result endBatch();
+
 		/**
 		 * @brief Reads a message from the backend. If no message is available
 		 *        locally the call will block until a message arrives.
@@ -223,6 +251,28 @@ class SC_SYSTEM_CLIENT_API Connection : public Core::BaseObject {
 		Core::Message *recv(Packet **packet = nullptr, Result *status = nullptr);
 		Core::Message *recv(PacketPtr &packet, Result *status = nullptr);
 
+		/**
+		 * @brief Reads a packet from the backend without decoding its
+		 *        payload. If no packet is available locally the call will
+		 *        block until a packet arrives.
+		 * @param status An optional status storage which holds the result of
+		 *               the operation.
+		 * @return The packet or nullptr if an error occurred. The ownership
+		 *         goes to the caller.
+		 */
+		Packet *recvPacket(Result *status = nullptr);
+
+		/**
+		 * @brief Decodes the payload of a data packet as returned by
+		 *        recvPacket(). This does not access the connection and can
+		 *        be called from any thread.
+		 * @param packet The data packet
+		 * @param status An optional status storage which holds the result of
+		 *               the operation.
+		 * @return The message or nullptr if the payload cannot be decoded.
+		 */
+		static Core::Message *decode(const Packet *packet, Result *status = nullptr);
+
 		Result sendMessage(const Core::Message *msg);
 		Result sendMessage(const std::string &targetGroup, const Core::Message *msg);
 
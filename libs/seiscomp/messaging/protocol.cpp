@@ -39,6 +39,7 @@
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
+#include <cstring>
 #include <iostream>
 
 
@@ -69,6 +70,14 @@ const std::string Protocol::STATUS_GROUP   = "STATUS_GROUP";
 namespace {
 
 
+const ext::boost::iostreams::lz4_dictionary &messageDictionary() {
+	static const ext::boost::iostreams::lz4_dictionary dict(
+		Protocol::CompressionDictionary(), 1
+	);
+	return dict;
+}
+
+
 class ImportXMLArchive : public IO::XMLArchive {
 	public:
 		ImportXMLArchive(std::streambuf* buf, bool isReading = true,
@@ -80,16 +89,9 @@ class ImportXMLArchive : public IO::XMLArchive {
 
 
 template <typename AR>
-inline void parse(Core::Message *&msg, const char *blob, size_t blob_length,
-                  Protocol::ContentEncoding encoding) {
+inline void parseFiltered(Core::Message *&msg, const char *blob, size_t blob_length,
+                          Protocol::ContentEncoding encoding) {
 	bio::stream_buffer<bio::array_source> buf(blob, blob_length);
-
-	if ( encoding == Protocol::Identity ) {
-		AR ar(&buf, true);
-		ar >> msg;
-		return;
-	}
-
 	bio::filtering_istreambuf filtered_buf;
 
 	switch ( encoding ) {
@@ -102,6 +104,9 @@ inline void parse(Core::Message *&msg, const char *blob, size_t blob_length,
 		case Protocol::LZ4:
 			filtered_buf.push(ext::boost::iostreams::lz4_decompressor());
 			break;
+		case Protocol::LZ4Dictionary:
+			filtered_buf.push(ext::boost::iostreams::lz4_decompressor(128, &messageDictionary()));
+			break;
 		default:
 			throw runtime_error("Invalid encoding type");
 	}
@@ -113,17 +118,68 @@ inline void parse(Core::Message *&msg, const char *blob, size_t blob_length,
 
 
 template <typename AR>
-inline bool write(std::string &blob, const Core::Message *&msg,
-                  Protocol::ContentEncoding encoding, int schemaVersion) {
-	bio::stream_buffer<boost::iostreams::back_insert_device<std::string> > buf(blob);
+inline void parse(Core::Message *&msg, const char *blob, size_t blob_length,
+                  Protocol::ContentEncoding encoding) {
+	if ( encoding == Protocol::Identity ) {
+		bio::stream_buffer<bio::array_source> buf(blob, blob_length);
+		AR ar(&buf, true);
+		ar >> msg;
+		return;
+	}
+
+	parseFiltered<AR>(msg, blob, blob_length, encoding);
+}
+
 
+template <>
+inline void parse<IO::VBinaryArchive>(Core::Message *&msg, const char *blob,
+                                      size_t blob_length,
+                                      Protocol::ContentEncoding encoding) {
 	if ( encoding == Protocol::Identity ) {
-		AR ar(&buf, false, schemaVersion);
-		Core::Message *tmp = const_cast<Core::Message*>(msg);
-		ar << tmp;
-		return ar.success();
+		// Read directly from the blob without a stream buffer
+		IO::VBinaryArchive ar;
+		if ( ar.open(blob, blob_length) )
+			ar >> msg;
+		return;
+	}
+
+	parseFiltered<IO::VBinaryArchive>(msg, blob, blob_length, encoding);
+}
+
+
+template <>
+inline void parse<IO::BSONArchive>(Core::Message *&msg, const char *blob,
+                                   size_t blob_length,
+                                   Protocol::ContentEncoding encoding) {
+	IO::BSONArchive ar;
+
+	switch ( encoding ) {
+		case Protocol::Identity:
+			break;
+		case Protocol::Deflate:
+		case Protocol::GZip:
+			ar.setCompression(true);
+			ar.setCompressionMethod(IO::BSONArchive::ZIP);
+			break;
+		case Protocol::LZ4:
+			ar.setCompression(true);
+			ar.setCompressionMethod(IO::BSONArchive::LZ4);
+			break;
+		default:
+			parseFiltered<IO::BSONArchive>(msg, blob, blob_length, encoding);
+			return;
 	}
 
+	// Iterate the document in place or inflate it once into a buffer
+	if ( ar.open(blob, blob_length) )
+		ar >> msg;
+}
+
+
+template <typename AR>
+inline bool writeFiltered(std::string &blob, const Core::Message *&msg,
+                          Protocol::ContentEncoding encoding, int schemaVersion) {
+	bio::stream_buffer<boost::iostreams::back_insert_device<std::string> > buf(blob);
 	bio::filtering_ostreambuf filtered_buf;
 
 	switch ( encoding ) {
@@ -136,6 +192,9 @@ inline bool write(std::string &blob, const Core::Message *&msg,
 		case Protocol::LZ4:
 			filtered_buf.push(ext::boost::iostreams::lz4_compressor());
 			break;
+		case Protocol::LZ4Dictionary:
+			filtered_buf.push(ext::boost::iostreams::lz4_compressor(128, &messageDictionary()));
+			break;
 		default:
 			return false;
 	}
@@ -149,6 +208,70 @@ inline bool write(std::string &blob, const Core::Message *&msg,
 }
 
 
+template <typename AR>
+inline bool write(std::string &blob, const Core::Message *&msg,
+                  Protocol::ContentEncoding encoding, int schemaVersion) {
+	if ( encoding == Protocol::Identity ) {
+		bio::stream_buffer<boost::iostreams::back_insert_device<std::string> > buf(blob);
+		AR ar(&buf, false, schemaVersion);
+		Core::Message *tmp = const_cast<Core::Message*>(msg);
+		ar << tmp;
+		return ar.success();
+	}
+
+	return writeFiltered<AR>(blob, msg, encoding, schemaVersion);
+}
+
+
+template <>
+inline bool write<IO::VBinaryArchive>(std::string &blob, const Core::Message *&msg,
+                                      Protocol::ContentEncoding encoding,
+                                      int schemaVersion) {
+	if ( encoding == Protocol::Identity ) {
+		// Append directly to the blob without a stream buffer
+		IO::VBinaryArchive ar(schemaVersion);
+		if ( !ar.create(blob) ) return false;
+		Core::Message *tmp = const_cast<Core::Message*>(msg);
+		ar << tmp;
+		return ar.success();
+	}
+
+	return writeFiltered<IO::VBinaryArchive>(blob, msg, encoding, schemaVersion);
+}
+
+
+template <>
+inline bool write<IO::BSONArchive>(std::string &blob, const Core::Message *&msg,
+                                   Protocol::ContentEncoding encoding,
+                                   int schemaVersion) {
+	IO::BSONArchive ar(schemaVersion);
+
+	switch ( encoding ) {
+		case Protocol::Identity:
+			break;
+		case Protocol::Deflate:
+		case Protocol::GZip:
+			ar.setCompression(true);
+			ar.setCompressionMethod(IO::BSONArchive::ZIP);
+			break;
+		case Protocol::LZ4:
+			ar.setCompression(true);
+			ar.setCompressionMethod(IO::BSONArchive::LZ4);
+			break;
+		default:
+			return writeFiltered<IO::BSONArchive>(blob, msg, encoding, schemaVersion);
+	}
+
+	// Build the document in the blob or compress it at once when closing
+	if ( !ar.create(blob) ) return false;
+	Core::Message *tmp = const_cast<Core::Message*>(msg);
+	ar << tmp;
+	bool success = ar.success();
+	ar.close();
+	return success;
+}
+
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -179,6 +302,7 @@ Protocol::State::State() {
 Protocol::Protocol() {
 	_schemaVersion = 0;
 	_wantMembershipInfo = true;
+	resetRemoteEncodings();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -224,6 +348,35 @@ const Protocol::Groups &Protocol::groups() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Protocol::setSubscriptionFilter(const std::string &,
+                                       const std::vector<std::string> &,
+                                       const std::vector<std::string> &) {
+	return OK;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Protocol::beginBatch(size_t) {
+	return OK;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Protocol::endBatch() {
+	return OK;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Protocol::handleInterrupt(int) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -231,6 +384,16 @@ void Protocol::handleInterrupt(int) {}
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Protocol::resetRemoteEncodings() {
+	_remoteEncodings.set();
+	_remoteEncodings.reset(LZ4Dictionary);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Protocol::queuePacket(Packet *p) {
 	_inbox.push_back(p);
@@ -336,6 +499,53 @@ bool Protocol::encode(std::string &blob, const Core::Message *msg,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &Protocol::CompressionDictionary() {
+	static const std::string dict = [] {
+		// Less frequent tokens first, LZ4 prefers short offsets. Each token
+		// is stored like a string in a binary archive (length followed by
+		// the characters) which makes class name references match as
+		// a whole.
+		static const char *tokens[] = {
+			"MomentTensorStationContribution", "MomentTensorComponentContribution",
+			"MomentTensorPhaseSetting", "MomentTensor", "DataUsed",
+			"FocalMechanismReference", "FocalMechanism", "NodalPlanes",
+			"PrincipalAxes", "Axis", "NodalPlane", "Tensor",
+			"EventDescription", "region name", "Flinn-Engdahl region",
+			"ConfidenceEllipsoid", "OriginUncertainty", "OriginQuality",
+			"CompositeTime", "IntegerQuantity", "TimeWindow", "Reading",
+			"PickReference", "AmplitudeReference", "OriginReference", "Event",
+			"preliminary", "confirmed", "reviewed", "final", "rejected",
+			"earthquake", "not existing", "manual", "LOCSAT", "iasp91",
+			"scevent", "scautoloc", "scmag", "scamp", "scautopick", "AIC",
+			"BK", "STALTA", "BP(0.7,2)", "RMHP(10)>>ITAPER(30)>>BW(4,0.7,2)",
+			"snr", "MLv", "ML", "mb", "mB", "Mwp", "Mw(mB)", "Mw(Mwp)", "M",
+			"Sg", "Sn", "Pg", "Pn", "PKP", "S", "P", "BHN", "BHE", "BHZ",
+			"HHN", "HHE", "HHZ", "EHZ", "SHZ", "00", "10",
+			"Magnitude/", "StationMagnitude/", "Origin/", "Amplitude/", "Pick/",
+			"StationMagnitudeContribution", "StationMagnitude", "Magnitude",
+			"Comment", "Arrival", "Origin", "Amplitude", "Pick",
+			"RealQuantity", "TimeQuantity", "WaveformStreamID", "CreationInfo",
+			"Phase", "EventParameters", "Notifier", "NotifierMessage"
+		};
+
+		std::string data;
+		for ( const char *token : tokens ) {
+			int size = static_cast<int>(strlen(token));
+			data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+			data.append(token, size);
+		}
+
+		return data;
+	}();
+
+	return dict;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>}
 size_t Protocol::inboxSize() const {
 	lock_guard<mutex> l(_readMutex);
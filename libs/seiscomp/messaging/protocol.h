@@ -28,6 +28,7 @@
 #include <seiscomp/core/optional.h>
 #include <seiscomp/messaging/packet.h>
 
+#include <bitset>
 #include <deque>
 #include <map>
 #include <mutex>
@@ -222,13 +223,15 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 				Identity,
 				Deflate,
 				GZip,
-				LZ4
+				LZ4,
+				LZ4Dictionary
 			),
 			ENAMES(
 				"identity",
 				"deflate",
 				"gzip",
-				"lz4"
+				"lz4",
+				"lz4-dict"
 			)
 		);
 
@@ -322,6 +325,17 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 		 */
 		Core::Version schemaVersion() const;
 
+		/**
+		 * @brief Returns whether the remote end is able to decode messages
+		 *        with the given content encoding.
+		 * Servers which do not announce their encodings are assumed to
+		 * support all but LZ4Dictionary. This requires a successfull
+		 * connection to be valid.
+		 * @param encoding The content encoding
+		 * @return true if supported, false otherwise
+		 */
+		bool supportsEncoding(ContentEncoding encoding) const;
+
 		/**
 		 * @brief Returns configuration parameters as key-value store
 		 *        returned by the broker.
@@ -352,6 +366,21 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 		 */
 		virtual Result unsubscribe(const std::string &group) = 0;
 
+		/**
+		 * @brief Restricts the messages of a group to notifier messages
+		 *        carrying particular object types or parents. The filter
+		 *        is evaluated by the broker and kept across reconnects.
+		 *        Protocols which do not support filtering deliver all
+		 *        messages, clients must not rely on the filter.
+		 * @param group The group name
+		 * @param types The object class names, empty matches all
+		 * @param parentIDs The parent publicIDs, empty matches all
+		 * @return Result code
+		 */
+		virtual Result setSubscriptionFilter(const std::string &group,
+		                                     const std::vector<std::string> &types,
+		                                     const std::vector<std::string> &parentIDs = {});
+
 		/**
 		 * @brief Sends data with a particular content type.
 		 * @param targetGroup The group name to send the message to
@@ -424,6 +453,28 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 		 */
 		virtual Result syncOutbox() = 0;
 
+		/**
+		 * @brief Starts collecting sent messages to write them to the
+		 *        network together.
+		 * @details Bursts of small messages cause one write call and network
+		 *          packet each. Within a batch the frames are collected and
+		 *          written at once when the batch is finished or has grown
+		 *          beyond maxBytes. Each message keeps its own frame,
+		 *          order and sequence number. Protocols which do not
+		 *          support batching send each message immediately.
+		 * @param maxBytes The number of collected bytes which causes the
+		 *                 messages to be written before the batch is finished.
+		 * @return Result code
+		 */
+		virtual Result beginBatch(size_t maxBytes = 65536);
+
+		/**
+		 * @brief Finishes a batch started with \ref beginBatch and writes
+		 *        all collected messages.
+		 * @return Result code
+		 */
+		virtual Result endBatch();
+
 		/**
 		 * @brief Disconnects gracefully from the broker. It sends a disconnect
 		 *        message and wait for the receipt. In contrast to close, this
@@ -507,6 +558,17 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 		                   ContentEncoding encoding, ContentType type,
 		                   int schemaVersion);
 
+		/**
+		 * @brief Returns the dictionary used by the LZ4Dictionary encoding.
+		 *
+		 * The dictionary holds class names and values typically found in
+		 * notifier messages. It is part of the encoding and must be the same
+		 * on both sides, it must therefore never be changed. An improved
+		 * dictionary requires a new encoding.
+		 * @return The raw dictionary content
+		 */
+		static const std::string &CompressionDictionary();
+
 
 	// ----------------------------------------------------------------------
 	//  Interruptible interface
@@ -521,6 +583,12 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 	protected:
 		void queuePacket(Packet *p);
 
+		/**
+		 * Resets the encodings supported by the server to the ones
+		 * assumed if the server does not announce them.
+		 */
+		void resetRemoteEncodings();
+
 		/**
 		 * Clears all messages in the inbox. This method is not intended for
 		 * public use. Note that it does not lock the read mutex.
@@ -542,6 +610,9 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 		std::string        _registeredClientName;
 		Core::Version      _schemaVersion; //!< The schema version the
 		                                   //!< server supports
+		std::bitset<EContentEncodingQuantity>
+		                   _remoteEncodings; //!< The encodings the server
+		                                     //!< is able to decode
 		KeyValueStore      _extendedParameters;
 		std::string        _certificate;   //!< Optional client certificate
 
@@ -560,6 +631,10 @@ inline Core::Version Protocol::schemaVersion() const {
 	return _schemaVersion;
 }
 
+inline bool Protocol::supportsEncoding(ContentEncoding encoding) const {
+	return _remoteEncodings.test(encoding);
+}
+
 inline const Protocol::KeyValueStore &Protocol::extendedParameters() const {
 	return _extendedParameters;
 }
@@ -60,6 +60,15 @@ class Socket : public Protocol {
 		 */
 		void setSSL(bool enable);
 
+		/**
+		 * @brief Sets the path of a local (unix domain) socket which is used
+		 *        instead of the host and port of the connection URL. The
+		 *        URL parameter "socket" overrides this path. This call has
+		 *        only effect *before* calling connect.
+		 * @param path The socket path or an empty string to use TCP.
+		 */
+		void setLocalSocket(const std::string &path);
+
 		/**
 		 * @brief Sets the acknowledgement window. This window is actually
 		 *        the number of messages the server will handle without
@@ -128,6 +137,7 @@ class Socket : public Protocol {
 		BufferQueue            _outbox;
 		BufferQueue            _backlog; // Messages need to be sent after re-connect
 		bool                   _useSSL;
+		std::string            _localSocket;
 		std::set<std::string>  _subscriptions;
 		char                   _buffer[1024];
 		char                  *_getp;
@@ -27,6 +27,7 @@
 #include <seiscomp/broker/protocol.h>
 
 #include <seiscomp/core/strings.h>
+#include <seiscomp/system/environment.h>
 #include <seiscomp/utils/url.h>
 #include <seiscomp/utils/base64.h>
 #include <seiscomp/wired/protocols/http.h>
@@ -235,6 +236,19 @@ class SecureWebsocketConnection : public WebsocketConnection {
 };
 
 
+/**
+ * @brief The LocalWebsocketConnection class is a simple wrapper that
+ *        registers as "scmpl" protocol and connects to the local socket
+ *        of a broker on the same host.
+ */
+class LocalWebsocketConnection : public WebsocketConnection {
+	public:
+		LocalWebsocketConnection() {
+			setLocalSocket(Environment::Instance()->absolutePath("@ROOTDIR@/var/run/scmaster.sock"));
+		}
+};
+
+
 }
 
 
@@ -243,6 +257,7 @@ class SecureWebsocketConnection : public WebsocketConnection {
 
 REGISTER_CONNECTION_PROTOCOL(WebsocketConnection, "scmp");
 REGISTER_CONNECTION_PROTOCOL(SecureWebsocketConnection, "scmps");
+REGISTER_CONNECTION_PROTOCOL(LocalWebsocketConnection, "scmpl");
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -251,6 +266,8 @@ REGISTER_CONNECTION_PROTOCOL(SecureWebsocketConnection, "scmps");
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 WebsocketConnection::WebsocketConnection() {
 	_inboxWaterLevel = 0;
+	_batching = false;
+	_batchLimit = 0;
 	_select.setTriggerMode(DeviceGroup::LevelTriggered);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -278,6 +295,8 @@ Result WebsocketConnection::connect(const char *address,
 		_state = State();
 		_select.clear();
 		_groups.clear();
+		_batch.clear();
+		resetRemoteEncodings();
 		_errorMessage = string();
 
 		_sockMutex.lock();
@@ -311,6 +330,7 @@ Result WebsocketConnection::connect(const char *address,
 		int port = -1;
 		string host = "localhost";
 		string path, queue;
+		string localSocket = _localSocket;
 
 		Util::Url url(address);
 		if ( !url ) {
@@ -360,11 +380,26 @@ Result WebsocketConnection::connect(const char *address,
 				setAckWindow(static_cast<uint32_t>(ackWindow));
 				SEISCOMP_DEBUG("Set acknowledge window to %d", ackWindow);
 			}
+			else if ( param == "socket" )
+				localSocket = Environment::Instance()->absolutePath(value);
+		}
+
+		if ( !localSocket.empty() && _useSSL ) {
+			_errorMessage = "SSL is not supported with local sockets";
+			_socket = nullptr;
+			return InvalidURLParameters;
 		}
 
 		_socket->setSocketTimeout(timeoutMs / 1000, (timeoutMs % 1000) * 1000);
 
-		int ret = _socket->connect(host, port);
+		int ret;
+		if ( localSocket.empty() )
+			ret = _socket->connect(host, port);
+		else {
+			SEISCOMP_DEBUG("Use local socket %s", localSocket.c_str());
+			ret = _socket->connectLocal(localSocket);
+		}
+
 		if ( ret != Wired::Socket::Success ) {
 			_errorMessage = "Failed to connect";
 			_socket = nullptr;
@@ -548,6 +583,16 @@ Result WebsocketConnection::connect(const char *address,
 				Core::split(groups, string(headers.val_start, headers.val_len).c_str(), ",", true);
 				for ( auto &&group : groups ) _groups.insert(group);
 			}
+			else if ( headers.nameEquals(SCMP_PROTO_REPLY_CONNECT_HEADER_ENCODINGS) ) {
+				vector<string> encodings;
+				Core::split(encodings, string(headers.val_start, headers.val_len).c_str(), ",", true);
+				_remoteEncodings.reset();
+				for ( auto &&name : encodings ) {
+					ContentEncoding encoding;
+					if ( encoding.fromString(Core::trim(name)) )
+						_remoteEncodings.set(encoding);
+				}
+			}
 			// Parse DB extensions
 			else if ( headers.nameEquals("Schema-Version") ) {
 				string version(headers.val_start, headers.val_len);
@@ -612,6 +657,20 @@ Result WebsocketConnection::connect(const char *address,
 		}
 	}
 
+	// Restore the subscription filters
+	vector<string> filteredGroups;
+	{
+		lock_guard<mutex> lread(_readMutex);
+		for ( auto &&item : _filters )
+			filteredGroups.push_back(item.first);
+	}
+
+	for ( auto &&group : filteredGroups ) {
+		Result r = sendFilter(group);
+		if ( r != OK )
+			return r;
+	}
+
 	// Flush the outbox with respect to last messages
 	return flushBacklog();
 }
@@ -660,15 +719,91 @@ Result WebsocketConnection::subscribe(const std::string &group) {
 		lock_guard<mutex> l(_readMutex);
 		do {
 			if ( _subscriptions.find(group) != _subscriptions.end() ) {
-				return OK;
+				break;
 			}
 
 			r = fetchAndQueuePacket();
 		}
 		while ( r == OK );
+
+		if ( r != OK )
+			return r;
 	}
 
-	return r;
+	lock_guard<mutex> l(_writeMutex);
+	return sendFilter(group);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result WebsocketConnection::setSubscriptionFilter(const std::string &group,
+                                                  const std::vector<std::string> &types,
+                                                  const std::vector<std::string> &parentIDs) {
+	bool subscribed;
+
+	{
+		lock_guard<mutex> l(_readMutex);
+
+		if ( types.empty() && parentIDs.empty() )
+			_filters.erase(group);
+		else
+			_filters[group] = Filter(types, parentIDs);
+
+		lock_guard<mutex> lsock(_sockMutex);
+		subscribed = _socket && (_subscriptions.find(group) != _subscriptions.end());
+	}
+
+	// Otherwise the filter is sent with the subscription
+	if ( !subscribed )
+		return OK;
+
+	lock_guard<mutex> l(_writeMutex);
+
+	if ( !types.empty() || !parentIDs.empty() )
+		return sendFilter(group);
+
+	// Reset the filter explicitly
+	Buffer msg;
+	msg.data = SCMP_PROTO_CMD_SUBSCRIBE "\n"
+	           SCMP_PROTO_CMD_SUBSCRIBE_HEADER_GROUPS ":";
+	msg.data += group;
+	msg.data += "\n"
+	            SCMP_PROTO_CMD_SUBSCRIBE_HEADER_TYPES ":*\n"
+	            SCMP_PROTO_CMD_SUBSCRIBE_HEADER_PARENTS ":*\n\n";
+
+	return send(&msg, WSFrame::TextFrame, false);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result WebsocketConnection::sendFilter(const std::string &group) {
+	Filter filter;
+
+	{
+		lock_guard<mutex> l(_readMutex);
+		auto it = _filters.find(group);
+		if ( it == _filters.end() )
+			return OK;
+		filter = it->second;
+	}
+
+	Buffer msg;
+	msg.data = SCMP_PROTO_CMD_SUBSCRIBE "\n"
+	           SCMP_PROTO_CMD_SUBSCRIBE_HEADER_GROUPS ":";
+	msg.data += group;
+	msg.data += "\n" SCMP_PROTO_CMD_SUBSCRIBE_HEADER_TYPES ":";
+	msg.data += filter.first.empty() ? "*" : Core::join(filter.first, ",");
+	msg.data += "\n" SCMP_PROTO_CMD_SUBSCRIBE_HEADER_PARENTS ":";
+	msg.data += filter.second.empty() ? "*" : Core::join(filter.second, ",");
+	msg.data += "\n\n";
+
+	return send(&msg, WSFrame::TextFrame, false);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -895,6 +1030,15 @@ Result WebsocketConnection::syncOutbox() {
 
 	lock_guard<mutex> lw(_writeMutex);
 
+	// Collected frames cannot be acknowledged before they were written
+	if ( !_batch.empty() ) {
+		lock_guard<mutex> ls(_sockMutex);
+		if ( !_socket || !_socket->isValid() )
+			return NotConnected;
+		r = flushBatch();
+		if ( r != OK ) return r;
+	}
+
 	while ( !_outbox.empty() ) {
 		_writeMutex.unlock();
 		_readMutex.lock();
@@ -940,6 +1084,44 @@ Result WebsocketConnection::syncOutbox() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result WebsocketConnection::beginBatch(size_t maxBytes) {
+	lock_guard<mutex> lw(_writeMutex);
+	_batching = true;
+	_batchLimit = maxBytes;
+	return OK;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result WebsocketConnection::endBatch() {
+	lock_guard<mutex> lw(_writeMutex);
+	_batching = false;
+
+	if ( _batch.empty() ) return OK;
+
+	lock_guard<mutex> ls(_sockMutex);
+	if ( !_socket || !_socket->isValid() ) {
+		// The frames are part of the outbox and will be sent again
+		// after reconnecting
+		_batch.clear();
+		_errorMessage = "Not connected";
+		return NotConnected;
+	}
+
+	_socket->addMode(Wired::Device::Write);
+	Result r = flushBatch();
+	_socket->removeMode(Wired::Device::Write);
+	return r;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Result WebsocketConnection::recv(Packet &p) {
 	while ( true ) {
@@ -1328,9 +1510,28 @@ Result WebsocketConnection::send(Buffer *msg, WSFrame::Type type, bool isRegular
 
 	Wired::Websocket::Frame::finalizeBuffer(msg, type);
 	_socket->addMode(Wired::Device::Write);
-	r = sendSocket(msg->header.data(), msg->header.size());
-	if ( r == OK )
-		r = sendSocket(msg->data.data(), msg->data.size());
+
+	if ( _batching && isRegular ) {
+		_batch.append(msg->header);
+		_batch.append(msg->data);
+
+		// Write if the batch is full or if the server must acknowledge
+		// the collected messages before new ones can be sent
+		if ( (_batch.size() >= _batchLimit)
+		  || (_ackWindow && (_outbox.size() + 1 >= _ackWindow)) )
+			r = flushBatch();
+		else
+			r = OK;
+	}
+	else {
+		// Keep the order of collected frames and this one
+		r = flushBatch();
+		if ( r == OK )
+			r = sendSocket(msg->header.data(), msg->header.size());
+		if ( r == OK )
+			r = sendSocket(msg->data.data(), msg->data.size());
+	}
+
 	_socket->removeMode(Wired::Device::Write);
 	_sockMutex.unlock();
 
@@ -1404,6 +1605,18 @@ Result WebsocketConnection::sendSocket(const char *data, int len) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result WebsocketConnection::flushBatch() {
+	if ( _batch.empty() ) return OK;
+	Result r = sendSocket(_batch.data(), static_cast<int>(_batch.size()));
+	_batch.clear();
+	return r;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void WebsocketConnection::updateReceiveBuffer() {
 	lock_guard<mutex> l(_readMutex);
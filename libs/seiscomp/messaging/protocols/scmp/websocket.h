@@ -25,6 +25,9 @@
 #include <seiscomp/messaging/protocols/scmp/socket.h>
 #include <seiscomp/wired/protocols/websocket.h>
 
+#include <map>
+#include <vector>
+
 
 namespace Seiscomp {
 namespace Client {
@@ -49,6 +52,9 @@ class WebsocketConnection : public Socket {
 
 		virtual Result subscribe(const std::string &group) override;
 		virtual Result unsubscribe(const std::string &group) override;
+		virtual Result setSubscriptionFilter(const std::string &group,
+		                                     const std::vector<std::string> &types,
+		                                     const std::vector<std::string> &parentIDs = {}) override;
 
 		virtual Result sendData(const std::string &targetGroup,
 		                        const char *data, size_t len,
@@ -65,6 +71,9 @@ class WebsocketConnection : public Socket {
 		virtual Result fetchInbox() override;
 		virtual Result syncOutbox() override;
 
+		virtual Result beginBatch(size_t maxBytes = 65536) override;
+		virtual Result endBatch() override;
+
 		virtual Result recv(Packet &p) override;
 		virtual Packet *recv(Result *result = nullptr) override;
 
@@ -84,6 +93,12 @@ class WebsocketConnection : public Socket {
 		void waitForAck();
 		Result flushBacklog();
 
+		/**
+		 * Sends the subscription filter of a group if one is set.
+		 * @pre _writeMutex is locked
+		 */
+		Result sendFilter(const std::string &group);
+
 		Result readFrame(WSFrame &frame, std::mutex *mutex, bool forceBlock = false);
 		bool handleFrame(WSFrame &frame, Packet *p, Result *result = nullptr);
 
@@ -95,6 +110,12 @@ class WebsocketConnection : public Socket {
 		Result send(Wired::Buffer *msg, WSFrame::Type type, bool isRegular);
 		Result sendSocket(const char *data, int len);
 
+		/**
+		 * Writes all collected batch frames.
+		 * @pre _writeMutex and _sockMutex are locked
+		 */
+		Result flushBatch();
+
 		void updateReceiveBuffer();
 		void closeSocket(const char *errorMessage = nullptr,
 		                 int errorMessageLen = -1);
@@ -112,6 +133,13 @@ class WebsocketConnection : public Socket {
 		mutable std::mutex _waitMutex;
 		WSFrame            _recvFrame;
 		size_t             _inboxWaterLevel;
+		bool               _batching;
+		size_t             _batchLimit;
+		std::string        _batch; //!< The collected frames of a batch
+
+		using Filter = std::pair<std::vector<std::string>, std::vector<std::string>>;
+		using Filters = std::map<std::string, Filter>;
+		Filters            _filters; //!< Subscription filters, guarded by _readMutex
 };
 
 
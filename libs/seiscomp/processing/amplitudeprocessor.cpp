@@ -27,6 +27,7 @@
 #include <seiscomp/math/mean.h>
 #include <seiscomp/math/filter/iirdifferentiate.h>
 #include <seiscomp/logging/log.h>
+#include <seiscomp/core/arrayview.h>
 #include <seiscomp/core/interfacefactory.ipp>
 #include <seiscomp/system/environment.h>
 #include <seiscomp/seismology/ttt.h>
@@ -68,6 +69,8 @@ IMPLEMENT_SC_ABSTRACT_CLASS_DERIVED(AmplitudeProcessor, TimeWindowProcessor, "Am
 
 namespace {
 
+thread_local AmplitudeProcessor::Emissions *deferredEmissions = nullptr;
+
 typedef vector<AmplitudeProcessor::Locale> Regionalization;
 
 DEFINE_SMARTPOINTER(TypeSpecificRegionalization);
@@ -1306,7 +1309,7 @@ void AmplitudeProcessor::setEnvironment(const DataModel::Origin *hypocenter,
 		if ( profile.feature ) {
 			switch ( profile.check ) {
 				case Locale::Source:
-					if ( !profile.feature->contains(Geo::GeoCoordinate(hypoLat, hypoLon)) ) {
+					if ( !Regions::contains(profile.feature, hypoLat, hypoLon) ) {
 						notFoundStatus = EpicenterOutOfRegions;
 						continue;
 					}
@@ -1314,11 +1317,11 @@ void AmplitudeProcessor::setEnvironment(const DataModel::Origin *hypocenter,
 					break;
 
 				case Locale::SourceReceiver:
-					if ( !profile.feature->contains(Geo::GeoCoordinate(hypoLat, hypoLon)) ) {
+					if ( !Regions::contains(profile.feature, hypoLat, hypoLon) ) {
 						notFoundStatus = EpicenterOutOfRegions;
 						continue;
 					}
-					if ( !profile.feature->contains(Geo::GeoCoordinate(recvLat, recvLon)) ) {
+					if ( !Regions::contains(profile.feature, recvLat, recvLon) ) {
 						notFoundStatus = ReceiverOutOfRegions;
 						continue;
 					}
@@ -1607,6 +1610,38 @@ void AmplitudeProcessor::reprocess(OPT(double) searchBegin,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AmplitudeProcessor *AmplitudeProcessor::clone() const {
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AmplitudeProcessor *AmplitudeProcessor::prepareClone(AmplitudeProcessor *copy) const {
+	if ( getOperator() != nullptr ) {
+		delete copy;
+		return nullptr;
+	}
+
+	copy->reset();
+	copy->_environment.hypocenter = nullptr;
+	copy->_environment.receiver = nullptr;
+	copy->_environment.pick = nullptr;
+	copy->_environment.locale = nullptr;
+	copy->_lastAmplitude = Core::None;
+	copy->_pickID.clear();
+	copy->_func = nullptr;
+
+	return copy;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void AmplitudeProcessor::reset() {
 	TimeWindowProcessor::reset();
@@ -1981,17 +2016,17 @@ bool AmplitudeProcessor::computeNoise(const DoubleArray &data, int i1, int i2, d
 		return true;
 	}
 
-	DoubleArrayPtr d = static_cast<DoubleArray*>(data.slice(i1, i2));
-	if ( !d ) {
+	DoubleArrayView d(&data, i1, i2);
+	if ( d.empty() ) {
 		return false;
 	}
 
 	double ofs, amp;
 
 	// compute pre-arrival offset
-	ofs = d->median();
+	ofs = d.median();
 	// compute rms after removing offset
-	amp = 2 * d->rms(ofs);
+	amp = 2 * d.rms(ofs);
 
 	if ( offset ) *offset = ofs;
 	if ( amplitude ) *amplitude = amp;
@@ -2390,7 +2425,15 @@ void AmplitudeProcessor::setPublishFunction(const PublishFunc& func) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void AmplitudeProcessor::emitAmplitude(const Result &res) {
-	if ( isEnabled() && _func )
+	if ( !isEnabled() || !_func )
+		return;
+
+	if ( deferredEmissions ) {
+		deferredEmissions->push_back([this, res]() {
+			if ( _func ) _func(this, res);
+		});
+	}
+	else
 		_func(this, res);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -2398,6 +2441,15 @@ void AmplitudeProcessor::emitAmplitude(const Result &res) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void AmplitudeProcessor::deferEmissions(Emissions *emissions) {
+	deferredEmissions = emissions;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void AmplitudeProcessor::finalizeAmplitude(DataModel::Amplitude *) const {
 	// Do nothing
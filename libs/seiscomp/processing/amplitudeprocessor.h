@@ -222,6 +222,9 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor : public TimeWindowProcessor {
 		using PublishFunc = std::function<void (const AmplitudeProcessor*,
 		                                        const Result &)>;
 
+		using Emission = std::function<void ()>;
+		using Emissions = std::vector<Emission>;
+
 
 	// ----------------------------------------------------------------------
 	//  X'truction
@@ -361,6 +364,15 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor : public TimeWindowProcessor {
 		//! to use response information or not.
 		virtual bool setup(const Settings &settings) override;
 
+		//! Returns a new processor with the configuration of this one,
+		//! including the result of setup and the stream configuration,
+		//! but without trigger, environment, publish function and data.
+		//! This allows to set up a prototype once and to create
+		//! processors from it without parsing the configuration again.
+		//! The default implementation returns nullptr which means that
+		//! cloning is not supported.
+		virtual AmplitudeProcessor *clone() const;
+
 		//! Sets the trigger used to compute the timewindow to calculate
 		//! the amplitude
 		//! Once a trigger has been set all succeeding calls will fail.
@@ -382,6 +394,12 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor : public TimeWindowProcessor {
 
 		void setPublishFunction(const PublishFunc &func);
 
+		//! Collects the results emitted by amplitude processors in the
+		//! calling thread in emissions instead of calling the publish
+		//! functions directly. The caller has to run the emissions, e.g.
+		//! in the main thread. Passing nullptr restores direct publishing.
+		static void deferEmissions(Emissions *emissions);
+
 		//! Returns the computed noise offset
 		OPT(double) noiseOffset() const;
 
@@ -468,6 +486,12 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor : public TimeWindowProcessor {
 		//! This method gets called when an amplitude has to be published
 		void emitAmplitude(const Result &result);
 
+		//! Finishes a copy of this processor created by clone
+		//! implementations: it drops the per trigger state of the copy.
+		//! If this processor uses an operator, the copy is deleted and
+		//! nullptr is returned since operators cannot be copied.
+		AmplitudeProcessor *prepareClone(AmplitudeProcessor *copy) const;
+
 	private:
 		bool readLocale(Locale *locale,
 		                const Settings &settings,
@@ -20,9 +20,11 @@
 
 #define SEISCOMP_COMPONENT AmplitudeML
 
+#include <seiscomp/core/strings.h>
 #include <seiscomp/logging/log.h>
 #include <seiscomp/processing/regions.h>
 #include <seiscomp/processing/amplitudes/ML.h>
+#include <seiscomp/processing/sharedfilter.h>
 #include <seiscomp/math/mean.h>
 #include <seiscomp/math/filter/chainfilter.h>
 #include <seiscomp/math/filter/seismometers.h>
@@ -127,6 +129,10 @@ AbstractAmplitudeProcessor_ML::AbstractAmplitudeProcessor_ML(
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void AbstractAmplitudeProcessor_ML::initFilter(double fsamp) {
 	Filter *preFilter{nullptr};
+	Filter *filter{nullptr};
+	// Identifies the filter chain to share its output with other
+	// processors of the same stream
+	string filterID = _preFilter;
 
 	if ( !_preFilter.empty() ) {
 		string error;
@@ -152,19 +158,27 @@ void AbstractAmplitudeProcessor_ML::initFilter(double fsamp) {
 			auto chain = new Filtering::ChainFilter<double>;
 			chain->add(preFilter);
 			chain->add(waFilter);
-			setFilter(chain);
+			filter = chain;
 		}
 		else if ( preFilter ) {
-			setFilter(preFilter);
+			filter = preFilter;
 		}
 		else {
-			setFilter(waFilter);
+			filter = waFilter;
+		}
+
+		if ( waFilter ) {
+			filterID += ">>WA(" + Core::toString(_config.woodAndersonResponse.gain) +
+			            "," + Core::toString(_config.woodAndersonResponse.T0) +
+			            "," + Core::toString(_config.woodAndersonResponse.h) + ")";
 		}
 	}
 	else {
-		setFilter(preFilter);
+		filter = preFilter;
 	}
 
+	setFilter(filter ? new SharedFilter(filterID, filter) : nullptr);
+
 	AmplitudeProcessor::initFilter(fsamp);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -299,7 +313,7 @@ bool AbstractAmplitudeProcessor_ML::deconvolveData(Response *resp,
 		return false;
 
 	Math::Restitution::FFT::TransferFunctionPtr instrumentResponse =
-		resp->getTransferFunction(numberOfIntegrations < 0 ? 0 : numberOfIntegrations);
+		resp->getCachedTransferFunction(numberOfIntegrations < 0 ? 0 : numberOfIntegrations);
 
 	if ( !instrumentResponse )
 		return false;
@@ -42,6 +42,15 @@ AmplitudeProcessor_MLv::AmplitudeProcessor_MLv()
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AmplitudeProcessor *AmplitudeProcessor_MLv::clone() const {
+	return prepareClone(new AmplitudeProcessor_MLv(*this));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool AmplitudeProcessor_MLv::computeAmplitude(const DoubleArray &data,
                                               size_t i1, size_t i2,
@@ -34,6 +34,8 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor_MLv : public AbstractAmplitudeProc
 		AmplitudeProcessor_MLv();
 
 	public:
+		AmplitudeProcessor *clone() const override;
+
 		bool computeAmplitude(const DoubleArray &data,
 		                      size_t i1, size_t i2,
 		                      size_t si1, size_t si2,
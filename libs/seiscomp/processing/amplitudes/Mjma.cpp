@@ -52,6 +52,15 @@ AmplitudeProcessor_Mjma::AmplitudeProcessor_Mjma()
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AmplitudeProcessor *AmplitudeProcessor_Mjma::clone() const {
+	return prepareClone(new AmplitudeProcessor_Mjma(*this));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void AmplitudeProcessor_Mjma::initFilter(double fsamp) {
 	if ( !_enableResponses ) {
@@ -77,7 +86,7 @@ bool AmplitudeProcessor_Mjma::deconvolveData(Response *resp,
 		return false;
 
 	Math::Restitution::FFT::TransferFunctionPtr tf =
-		resp->getTransferFunction(numberOfIntegrations < 0 ? 0 : numberOfIntegrations);
+		resp->getCachedTransferFunction(numberOfIntegrations < 0 ? 0 : numberOfIntegrations);
 
 	if ( tf == nullptr )
 		return false;
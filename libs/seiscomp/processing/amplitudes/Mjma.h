@@ -35,6 +35,8 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor_Mjma : public AmplitudeProcessor {
 		AmplitudeProcessor_Mjma(const Core::Time& trigger);
 
 	public:
+		AmplitudeProcessor *clone() const override;
+
 		virtual void initFilter(double fsamp) override;
 
 	protected:
@@ -141,6 +141,15 @@ AmplitudeProcessor_ms20::AmplitudeProcessor_ms20()
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AmplitudeProcessor *AmplitudeProcessor_ms20::clone() const {
+	return prepareClone(new AmplitudeProcessor_ms20(*this));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void AmplitudeProcessor_ms20::AmplitudeProcessor_ms20::initFilter(double fsamp) {
 	AmplitudeProcessor::setFilter(
@@ -34,6 +34,8 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor_ms20 : public AmplitudeProcessor {
 		AmplitudeProcessor_ms20();
 
 	public:
+		AmplitudeProcessor *clone() const override;
+
 		void initFilter(double fsamp) override;
 
 	protected:
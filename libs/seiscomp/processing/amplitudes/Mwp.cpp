@@ -138,6 +138,15 @@ AmplitudeProcessor_Mwp::AmplitudeProcessor_Mwp()
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+AmplitudeProcessor *AmplitudeProcessor_Mwp::clone() const {
+	return prepareClone(new AmplitudeProcessor_Mwp(*this));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void AmplitudeProcessor_Mwp::init() {
 	setSignalEnd("min(D * 11.5, 95)");
@@ -34,6 +34,8 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor_Mwp : public AmplitudeProcessor {
 		AmplitudeProcessor_Mwp();
 
 	public:
+		AmplitudeProcessor *clone() const override;
+
 		const DoubleArray *processedData(Component comp) const override;
 
 	protected:
@@ -35,6 +35,8 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor_mB : public AmplitudeProcessor {
 		AmplitudeProcessor_mB();
 
 	public:
+		AmplitudeProcessor *clone() const override;
+
 		void finalizeAmplitude(DataModel::Amplitude *amplitude) const override;
 
 	protected:
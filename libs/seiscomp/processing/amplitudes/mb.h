@@ -37,6 +37,8 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor_mb : public AmplitudeProcessor {
 		AmplitudeProcessor_mb();
 
 	public:
+		AmplitudeProcessor *clone() const override;
+
 		void initFilter(double fsamp) override;
 
 		void finalizeAmplitude(DataModel::Amplitude *amplitude) const override;
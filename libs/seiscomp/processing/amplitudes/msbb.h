@@ -33,6 +33,9 @@ class SC_SYSTEM_CLIENT_API AmplitudeProcessor_msbb : public AmplitudeProcessor {
 	public:
 		AmplitudeProcessor_msbb();
 
+	public:
+		AmplitudeProcessor *clone() const override;
+
 	protected:
 		bool computeAmplitude(const DoubleArray &data,
 		                      size_t i1, size_t i2,
@@ -21,15 +21,158 @@
 #define SEISCOMP_COMPONENT ProcessingApplication
 
 #include <seiscomp/processing/application.h>
+#include <seiscomp/processing/amplitudeprocessor.h>
+#include <seiscomp/processing/picker.h>
+#include <seiscomp/core/strings.h>
 #include <seiscomp/datamodel/configstation.h>
+#include <seiscomp/io/archive/binarchive.h>
 #include <seiscomp/logging/log.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 
 namespace Seiscomp {
 
 namespace Processing {
 
 
+namespace {
+
+
+// Returns the key of a processor state in the checkpoint file. The index
+// counts the processors of the same class on the stream which have been
+// registered before.
+std::string stateKey(const StreamKey &key, const WaveformProcessor *wp,
+                     size_t index) {
+	return key.toString() + " " + wp->className() + " " + Core::toString(index);
+}
+
+
+}
+
+
+// Threads that feed a record to a set of processors. The calling thread
+// takes part and run returns when all processors have been fed. Each job
+// carries its own copy of the record: reference counts are not thread-safe
+// and a processor keeps a reference to the last record it has been fed.
+struct Application::Workers {
+	struct Job {
+		WaveformProcessor             *processor;
+		RecordCPtr                     record;
+		AmplitudeProcessor::Emissions  emissions;
+		Picker::Emissions              picks;
+		std::exception_ptr             exception;
+		double                         seconds{0};
+	};
+
+	typedef std::vector<Job> Jobs;
+
+	explicit Workers(int count) {
+		for ( int i = 0; i < count; ++i )
+			threads.emplace_back([this]() { loop(); });
+	}
+
+	~Workers() {
+		{
+			std::lock_guard<std::mutex> l(mutex);
+			quit = true;
+		}
+
+		wakeup.notify_all();
+
+		for ( auto &thread : threads )
+			thread.join();
+	}
+
+	void run(Jobs &pending) {
+		{
+			std::lock_guard<std::mutex> l(mutex);
+			jobs = &pending;
+			next = 0;
+			done = 0;
+			++generation;
+		}
+
+		wakeup.notify_all();
+		work();
+
+		std::unique_lock<std::mutex> l(mutex);
+		idle.wait(l, [this]() { return done == jobs->size() && !active; });
+		jobs = nullptr;
+	}
+
+	void loop() {
+		size_t seen = 0;
+		std::unique_lock<std::mutex> l(mutex);
+
+		while ( true ) {
+			wakeup.wait(l, [&]() { return quit || seen != generation; });
+			if ( quit ) return;
+
+			seen = generation;
+			// The batch might have been completed without this thread
+			if ( !jobs ) continue;
+
+			++active;
+			l.unlock();
+			work();
+			l.lock();
+			--active;
+			idle.notify_all();
+		}
+	}
+
+	void work() {
+		while ( true ) {
+			size_t i = next++;
+			if ( i >= jobs->size() ) break;
+
+			Job &job = (*jobs)[i];
+			AmplitudeProcessor::deferEmissions(&job.emissions);
+			Picker::deferEmissions(&job.picks);
+
+			auto start = std::chrono::steady_clock::now();
+			try {
+				job.processor->feed(job.record.get());
+			}
+			catch ( ... ) {
+				job.exception = std::current_exception();
+			}
+			job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			AmplitudeProcessor::deferEmissions(nullptr);
+			Picker::deferEmissions(nullptr);
+			++done;
+		}
+	}
+
+	std::vector<std::thread> threads;
+	std::mutex               mutex;
+	std::condition_variable  wakeup;
+	std::condition_variable  idle;
+	Jobs                    *jobs{nullptr};
+	std::atomic<size_t>      next{0};
+	std::atomic<size_t>      done{0};
+	size_t                   generation{0};
+	int                      active{0};
+	bool                     quit{false};
+};
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Application::Application(int argc, char **argv)
 : Client::StreamApplication(argc, argv), _waveformBuffer(30.*60.) {
 	_registrationBlocked = false;
@@ -142,7 +285,11 @@ void Application::registerProcessor(const std::string& networkCode,
                                     const std::string& locationCode,
                                     const std::string& channelCode,
                                     WaveformProcessor *wp) {
-	_processors.insert(ProcessorMap::value_type(networkCode + "." + stationCode + "." + locationCode + "." + channelCode, wp));
+	StreamKey key = StreamKey::Intern(networkCode, stationCode, locationCode, channelCode);
+	if ( !_checkpointStates.empty() )
+		restoreState(key, wp);
+
+	_processors[key].push_back(wp);
 
 	// Because we are dealing with a multimap we need to check if the pointer
 	// is already registered for this station. Otherwise the remove method will
@@ -272,31 +419,27 @@ void Application::removeProcessors(const std::string& networkCode,
                                    const std::string& locationCode,
                                    const std::string& channelCode) {
 
-	bool checkPendingQueue;
-	std::pair<ProcessorMap::iterator, ProcessorMap::iterator> itq =
-		_processors.equal_range(networkCode + "." +
-		                        stationCode + "." +
-		                        locationCode + "." +
-		                        channelCode);
-
-	checkPendingQueue = itq.first == itq.second;
-
-	// Remove stations - processor association
-	for ( ProcessorMap::iterator it = itq.first; it != itq.second; ++it ) {
-		for ( StationProcessors::iterator its = _stationProcessors.begin();
-		      its != _stationProcessors.end(); )
-		{
-			if ( its->second == it->second ) {
-				SEISCOMP_DEBUG("Removed processor from station %s", its->first.c_str());
-				_stationProcessors.erase(its++);
-				break;
+	ProcessorMap::iterator itp =
+		_processors.find(StreamKey::Find(networkCode, stationCode,
+		                                 locationCode, channelCode));
+
+	if ( itp != _processors.end() ) {
+		// Remove stations - processor association
+		for ( const WaveformProcessorPtr &wp : itp->second ) {
+			for ( StationProcessors::iterator its = _stationProcessors.begin();
+			      its != _stationProcessors.end(); ++its )
+			{
+				if ( its->second == wp ) {
+					SEISCOMP_DEBUG("Removed processor from station %s", its->first.c_str());
+					_stationProcessors.erase(its);
+					break;
+				}
 			}
 		}
-	}
 
-	_processors.erase(itq.first, itq.second);
-
-	if ( !checkPendingQueue ) return;
+		_processors.erase(itp);
+		return;
+	}
 
 	// Remove from pending queue (if exists)
 	for ( WaveformProcessorQueue::iterator it = _waveformProcessorQueue.begin();
@@ -344,11 +487,19 @@ void Application::removeProcessor(Processing::WaveformProcessor *wp) {
 	for ( ProcessorMap::iterator it = _processors.begin();
 	      it != _processors.end(); )
 	{
-		if ( it->second.get() == wp ) {
-			SEISCOMP_DEBUG("Removed processor from stream %s    addr=0x%lx",
-				       it->first.c_str(), (long)wp);
-			_processors.erase(it++);
+		WaveformProcessors &procs = it->second;
+		for ( WaveformProcessors::iterator itw = procs.begin(); itw != procs.end(); ) {
+			if ( itw->get() == wp ) {
+				SEISCOMP_DEBUG("Removed processor from stream %s    addr=0x%lx",
+				               it->first.toString().c_str(), (long)wp);
+				itw = procs.erase(itw);
+			}
+			else
+				++itw;
 		}
+
+		if ( procs.empty() )
+			it = _processors.erase(it);
 		else
 			++it;
 	}
@@ -387,7 +538,273 @@ void Application::removeProcessor(Processing::WaveformProcessor *wp) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t Application::processorCount() const {
-	return _processors.size();
+	size_t count = 0;
+	for ( const auto &item : _processors )
+		count += item.second.size();
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::setProcessingThreads(int threads) {
+	_workers.reset(threads > 1 ? new Workers(threads-1) : nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int Application::processingThreads() const {
+	return _workers ? static_cast<int>(_workers->threads.size()) + 1 : 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const Application::ProcessorStatisticsMap &
+Application::processorStatistics() const {
+	return _statistics;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::resetProcessorStatistics() {
+	_statistics.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::feedProcessor(WaveformProcessor *wp, const Record *rec) {
+	auto start = std::chrono::steady_clock::now();
+	wp->feed(rec);
+	addStatistics(wp, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::addStatistics(const WaveformProcessor *wp, double seconds) {
+	const AmplitudeProcessor *proc = AmplitudeProcessor::ConstCast(wp);
+	ProcessorStatistics &stats = _statistics[proc ? proc->type() : wp->className()];
+	++stats.count;
+	stats.seconds += seconds;
+	if ( seconds > stats.maxSeconds )
+		stats.maxSeconds = seconds;
+
+	if ( !stats.timer )
+		stats.timer = &Core::Metrics::timer("processing." + (proc ? proc->type() : std::string(wp->className())));
+	stats.timer->record(seconds);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::setCheckpointFile(const std::string &path, double interval) {
+	_checkpointFile = path;
+	_checkpointInterval = interval;
+	_lastCheckpoint = Core::Time::UTC();
+	_checkpointStates.clear();
+
+	if ( _checkpointFile.empty() ) return true;
+
+	return readCheckpoint();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &Application::checkpointFile() const {
+	return _checkpointFile;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::readCheckpoint() {
+	std::ifstream ifs(_checkpointFile.c_str(), std::ios::binary);
+	// No checkpoint has been written yet
+	if ( !ifs.is_open() ) return true;
+
+	std::string content((std::istreambuf_iterator<char>(ifs)),
+	                    std::istreambuf_iterator<char>());
+
+	std::vector<std::string> keys, states;
+
+	IO::VBinaryArchive ar;
+	if ( !ar.open(content.data(), content.size()) ) {
+		SEISCOMP_ERROR("%s: invalid checkpoint file", _checkpointFile.c_str());
+		return false;
+	}
+
+	ar & NAMED_OBJECT("keys", keys);
+	ar & NAMED_OBJECT("states", states);
+
+	if ( !ar.success() || keys.size() != states.size() ) {
+		SEISCOMP_ERROR("%s: invalid checkpoint file", _checkpointFile.c_str());
+		return false;
+	}
+
+	for ( size_t i = 0; i < keys.size(); ++i )
+		_checkpointStates[keys[i]].swap(states[i]);
+
+	SEISCOMP_INFO("Read %lu processor states from %s",
+	              (unsigned long)_checkpointStates.size(),
+	              _checkpointFile.c_str());
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::writeCheckpoint() {
+	if ( _checkpointFile.empty() ) return false;
+
+	_lastCheckpoint = Core::Time::UTC();
+
+	CheckpointStates states;
+
+	for ( const auto &item : _processors ) {
+		const WaveformProcessors &procs = item.second;
+		for ( size_t i = 0; i < procs.size(); ++i ) {
+			WaveformProcessor *wp = procs[i].get();
+			if ( wp->isFinished() || !wp->hasSerializableState() )
+				continue;
+
+			size_t index = 0;
+			for ( size_t j = 0; j < i; ++j ) {
+				if ( !strcmp(procs[j]->className(), wp->className()) )
+					++index;
+			}
+
+			std::string &state = states[stateKey(item.first, wp, index)];
+			IO::BinaryArchive ar;
+			ar.create(state);
+			wp->serialize(ar);
+			ar.close();
+		}
+	}
+
+	// Keep the states of processors which have not been added again
+	states.insert(_checkpointStates.begin(), _checkpointStates.end());
+
+	std::vector<std::string> keys, blobs;
+	keys.reserve(states.size());
+	blobs.reserve(states.size());
+	for ( auto &item : states ) {
+		keys.push_back(item.first);
+		blobs.emplace_back();
+		blobs.back().swap(item.second);
+	}
+
+	std::string content;
+	{
+		IO::VBinaryArchive ar;
+		ar.create(content);
+		ar & NAMED_OBJECT("keys", keys);
+		ar & NAMED_OBJECT("states", blobs);
+		ar.close();
+	}
+
+	// Write to a temporary file first to never leave an incomplete
+	// checkpoint behind
+	std::string tmpPath = _checkpointFile + ".part";
+	{
+		std::ofstream ofs(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+		if ( ofs.is_open() )
+			ofs.write(content.data(), content.size());
+
+		if ( !ofs.good() ) {
+			ofs.close();
+			::remove(tmpPath.c_str());
+			SEISCOMP_ERROR("%s: failed to write checkpoint", tmpPath.c_str());
+			return false;
+		}
+	}
+
+	if ( ::rename(tmpPath.c_str(), _checkpointFile.c_str()) != 0 ) {
+		::remove(tmpPath.c_str());
+		SEISCOMP_ERROR("%s: failed to write checkpoint", _checkpointFile.c_str());
+		return false;
+	}
+
+	SEISCOMP_DEBUG("Wrote %lu processor states to %s",
+	               (unsigned long)keys.size(), _checkpointFile.c_str());
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::restoreState(const StreamKey &key, WaveformProcessor *wp) {
+	if ( !wp->hasSerializableState() ) return;
+
+	size_t index = 0;
+	ProcessorMap::const_iterator itp = _processors.find(key);
+	if ( itp != _processors.end() ) {
+		for ( const auto &proc : itp->second ) {
+			if ( !strcmp(proc->className(), wp->className()) )
+				++index;
+		}
+	}
+
+	CheckpointStates::iterator it = _checkpointStates.find(stateKey(key, wp, index));
+	if ( it == _checkpointStates.end() ) return;
+
+	IO::BinaryArchive ar;
+	if ( ar.open(it->second.data(), it->second.size()) )
+		wp->serialize(ar);
+
+	if ( ar.success() )
+		SEISCOMP_DEBUG("Restored state of %s on stream %s",
+		               wp->className(), key.toString().c_str());
+	else {
+		SEISCOMP_WARNING("Failed to restore state of %s on stream %s",
+		                 wp->className(), key.toString().c_str());
+		wp->reset();
+	}
+
+	_checkpointStates.erase(it);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::initConfiguration() {
+	if ( !Client::StreamApplication::initConfiguration() )
+		return false;
+
+	try {
+		setProcessingThreads(configGetInt("processing.threads"));
+	}
+	catch ( ... ) {}
+
+	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -441,7 +858,6 @@ void Application::updateObject(const std::string& parentID, DataModel::Object* o
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::handleRecord(Record *rec) {
-	std::string streamID = rec->streamID();
 	std::list<WaveformProcessor*> trashList;
 
 	RecordPtr tmp(rec);
@@ -452,24 +868,92 @@ void Application::handleRecord(Record *rec) {
 
 	_registrationBlocked = true;
 
-	std::pair<ProcessorMap::iterator, ProcessorMap::iterator> itq = _processors.equal_range(streamID);
-	for ( ProcessorMap::iterator it = itq.first; it != itq.second; ++it ) {
-		// The proc must not be already on the removal list
-		if ( std::find(_waveformProcessorRemovalQueue.begin(),
-		               _waveformProcessorRemovalQueue.end(),
-		               it->second) != _waveformProcessorRemovalQueue.end() )
-			continue;
-
-		// Schedule the processor for deletion when finished
-		if ( it->second->isFinished() )
-			trashList.push_back(it->second.get());
-		else {
-			it->second->feed(rec);
-			if ( it->second->isFinished() )
-				trashList.push_back(it->second.get());
+	Workers::Jobs jobs;
+
+	ProcessorMap::iterator itp = _processors.find(rec->streamKey());
+	if ( itp != _processors.end() ) {
+		// Iterate by index: the references to the mapped vectors survive
+		// a rehash but a registration might grow the vector
+		WaveformProcessors &procs = itp->second;
+		for ( size_t i = 0; i < procs.size(); ++i ) {
+			WaveformProcessor *wp = procs[i].get();
+
+			// The proc must not be already on the removal list
+			if ( std::find(_waveformProcessorRemovalQueue.begin(),
+			               _waveformProcessorRemovalQueue.end(),
+			               wp) != _waveformProcessorRemovalQueue.end() )
+				continue;
+
+			// Schedule the processor for deletion when finished
+			if ( wp->isFinished() )
+				trashList.push_back(wp);
+			else if ( _workers && (AmplitudeProcessor::Cast(wp) || Picker::Cast(wp)) ) {
+				// The copy is private to the processor, only its thread
+				// touches the reference count while the jobs run
+				RecordCPtr copy = rec->copy();
+				const Record *last = wp->lastRecord();
+
+				if ( last && last->referenceCount() > 1 ) {
+					// The last record is shared, e.g. a buffered record fed
+					// on registration. Releasing it in a worker would race
+					// with other processors, feed the processor here. From
+					// now on it holds only its private copy.
+					feedProcessor(wp, copy.get());
+					if ( wp->isFinished() )
+						trashList.push_back(wp);
+				}
+				else {
+					jobs.emplace_back();
+					jobs.back().processor = wp;
+					jobs.back().record = copy;
+				}
+			}
+			else {
+				feedProcessor(wp, rec);
+				if ( wp->isFinished() )
+					trashList.push_back(wp);
+			}
 		}
 	}
 
+	if ( !jobs.empty() ) {
+		std::exception_ptr exception;
+		Picker::Emissions picks;
+
+		_workers->run(jobs);
+
+		// Publish the results in the main thread
+		for ( auto &job : jobs ) {
+			for ( auto &emission : job.emissions )
+				emission();
+
+			picks.insert(picks.end(),
+			             std::make_move_iterator(job.picks.begin()),
+			             std::make_move_iterator(job.picks.end()));
+
+			addStatistics(job.processor, job.seconds);
+
+			if ( job.exception && !exception )
+				exception = job.exception;
+
+			if ( job.processor->isFinished() )
+				trashList.push_back(job.processor);
+		}
+
+		// Picks are published ordered by their time and not by the order
+		// of the pickers
+		std::stable_sort(picks.begin(), picks.end(),
+		                 [](const Picker::Emission &a, const Picker::Emission &b) {
+			return a.time < b.time;
+		});
+
+		for ( auto &pick : picks )
+			pick.publish();
+
+		if ( exception )
+			std::rethrow_exception(exception);
+	}
+
 	// Delete finished processors
 	for ( std::list<WaveformProcessor*>::iterator itt = trashList.begin();
 	      itt != trashList.end(); ++itt ) {
@@ -513,6 +997,10 @@ void Application::handleRecord(Record *rec) {
 		registerProcessor(wid.networkCode(), wid.stationCode(),
 		                  wid.locationCode(), wid.channelCode(), twp.get());
 	}
+
+	if ( !_checkpointFile.empty() && _checkpointInterval > Core::TimeSpan(0, 0)
+	  && Core::Time::UTC() - _lastCheckpoint >= _checkpointInterval )
+		writeCheckpoint();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -521,6 +1009,9 @@ void Application::handleRecord(Record *rec) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::done() {
+	if ( !_checkpointFile.empty() )
+		writeCheckpoint();
+
 	Client::StreamApplication::done();
 	//_waveformBuffer.printStreams();
 }
@@ -544,10 +1035,17 @@ void Application::enableStation(const std::string& code, bool enabled) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::enableStream(const std::string& code, bool enabled) {
-	std::pair<StationProcessors::iterator, StationProcessors::iterator> itq = _processors.equal_range(code);
-	for (StationProcessors::iterator it = itq.first; it != itq.second; ++it) {
+	std::vector<std::string> toks;
+	if ( Core::split(toks, code.c_str(), ".", false) != 4 )
+		return;
+
+	ProcessorMap::iterator itp = _processors.find(StreamKey::Find(toks[0], toks[1], toks[2], toks[3]));
+	if ( itp == _processors.end() )
+		return;
+
+	for ( const WaveformProcessorPtr &wp : itp->second ) {
 		SEISCOMP_INFO("%s stream %s", enabled?"Enabling":"Disabling", code.c_str());
-		it->second->setEnabled(enabled);
+		wp->setEnabled(enabled);
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -28,6 +28,11 @@
 #include <seiscomp/processing/timewindowprocessor.h>
 #include <seiscomp/processing/streambuffer.h>
 
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 
 namespace Seiscomp {
 namespace Processing {
@@ -81,11 +86,72 @@ class SC_SYSTEM_CLIENT_API Application : public Client::StreamApplication {
 
 		size_t processorCount() const;
 
+		/**
+		 * @brief Sets the number of threads that feed amplitude processors
+		 *        and pickers.
+		 *
+		 * With more than one thread all amplitude processors and pickers
+		 * of a record are fed concurrently, the main thread included. Each
+		 * of them receives its own copy of the record. Their results are
+		 * published in the main thread once all of them have been fed:
+		 * amplitudes in processor order followed by picks ordered by pick
+		 * time. Other processors are always fed in the main thread. The
+		 * default is 1 (sequential feeding) which can be changed with the
+		 * configuration parameter processing.threads. This must not be
+		 * called while a record is being handled.
+		 */
+		void setProcessingThreads(int threads);
+		int processingThreads() const;
+
+		//! Accumulated feed times of all processors of a type
+		struct ProcessorStatistics {
+			size_t count{0};
+			double seconds{0};
+			double maxSeconds{0};
+			//! The timer of the metrics registry, see Core::Metrics
+			Core::Metrics::Timer *timer{nullptr};
+		};
+
+		typedef std::map<std::string, ProcessorStatistics> ProcessorStatisticsMap;
+
+		//! Returns the feed statistics keyed by the amplitude type or the
+		//! class name of other processors.
+		const ProcessorStatisticsMap &processorStatistics() const;
+		void resetProcessorStatistics();
+
+		/**
+		 * @brief Enables checkpointing of the processor states.
+		 *
+		 * The states of all processors which have a serializable state
+		 * (see WaveformProcessor::hasSerializableState) are written to
+		 * the file when the application is done and, if an interval is
+		 * given, periodically while records are handled. The file is
+		 * read when this method is called and a processor added
+		 * afterwards restores the state of the processor of the same
+		 * class on the same stream. If the next record follows the
+		 * restored state the processor continues without initializing
+		 * again, otherwise the usual gap handling applies. This must be
+		 * called before the processors are added. An empty path disables
+		 * checkpointing.
+		 * @param path The path of the checkpoint file
+		 * @param interval The interval of periodic checkpoints in seconds,
+		 *                 0 writes only when the application is done
+		 * @return false if an existing file could not be read
+		 */
+		bool setCheckpointFile(const std::string &path, double interval = 0);
+		const std::string &checkpointFile() const;
+
+		//! Writes the processor states to the checkpoint file. States
+		//! read from the file which have not been restored yet are kept.
+		bool writeCheckpoint();
+
 
 	// ----------------------------------------------------------------------
 	//  Protected methods
 	// ----------------------------------------------------------------------
 	protected:
+		bool initConfiguration() override;
+
 		void addObject(const std::string& parentID, DataModel::Object* o) override;
 		void removeObject(const std::string& parentID, DataModel::Object* o) override;
 		void updateObject(const std::string& parentID, DataModel::Object* o) override;
@@ -121,13 +187,19 @@ class SC_SYSTEM_CLIENT_API Application : public Client::StreamApplication {
 		void registerProcessor(const DataModel::WaveformStreamID &wfid,
 				       TimeWindowProcessor *twp);
 
+		void feedProcessor(WaveformProcessor *wp, const Record *rec);
+		void addStatistics(const WaveformProcessor *wp, double seconds);
+		bool readCheckpoint();
+		void restoreState(const StreamKey &key, WaveformProcessor *wp);
+
 
 	// ----------------------------------------------------------------------
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
 		typedef std::multimap<std::string, WaveformProcessorPtr> StationProcessors;
-		typedef std::multimap<std::string, WaveformProcessorPtr> ProcessorMap;
+		typedef std::vector<WaveformProcessorPtr>                WaveformProcessors;
+		typedef std::unordered_map<StreamKey, WaveformProcessors> ProcessorMap;
 		typedef DataModel::WaveformStreamID                      WID;
 		typedef std::pair<WID, WaveformProcessorPtr>             WaveformProcessorItem;
 		typedef std::pair<WID, TimeWindowProcessorPtr>           TimeWindowProcessorItem;
@@ -144,6 +216,19 @@ class SC_SYSTEM_CLIENT_API Application : public Client::StreamApplication {
 		WaveformProcessorRemovalQueue   _waveformProcessorRemovalQueue;
 		TimeWindowProcessorQueue        _timeWindowProcessorQueue;
 		bool                            _registrationBlocked;
+
+		struct Workers;
+		std::unique_ptr<Workers>        _workers;
+		ProcessorStatisticsMap          _statistics;
+
+		//! The serialized processor states read from the checkpoint file
+		//! which have not been restored yet
+		typedef std::map<std::string, std::string> CheckpointStates;
+
+		std::string                     _checkpointFile;
+		Core::TimeSpan                  _checkpointInterval;
+		Core::Time                      _lastCheckpoint;
+		CheckpointStates                _checkpointStates;
 };
 
 
@@ -0,0 +1,368 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/processing/crosscorrelation.h>
+#include <seiscomp/math/fft.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <thread>
+#include <tuple>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+struct CrossCorrelator::Group {
+	std::vector<uint32_t>           windows;
+	int                             fftn;
+	std::vector<Math::ComplexArray> spectra;
+	// The energy of the demeaned windows, zero for constant windows
+	std::vector<double>             energies;
+};
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+CrossCorrelator::CrossCorrelator()
+: _maxDelay(1.0)
+, _minCoefficient(0.7)
+, _upsampling(8)
+, _threads(0) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::setMaximumDelay(double seconds) {
+	_maxDelay = seconds;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double CrossCorrelator::maximumDelay() const {
+	return _maxDelay;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::setMinimumCoefficient(double coefficient) {
+	_minCoefficient = coefficient;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double CrossCorrelator::minimumCoefficient() const {
+	return _minCoefficient;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::setUpsampling(int factor) {
+	// The length of the transform must remain a power of two
+	_upsampling = 1;
+	while ( _upsampling < factor ) _upsampling <<= 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int CrossCorrelator::upsampling() const {
+	return _upsampling;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::setThreads(int threads) {
+	_threads = std::max(threads, 0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int CrossCorrelator::threads() const {
+	return _threads;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::setPairFilter(const PairFilter &filter) {
+	_pairFilter = filter;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int CrossCorrelator::add(const Window &window) {
+	if ( window.data.size() < 2 || !(window.samplingFrequency > 0) )
+		return -1;
+
+	_windows.push_back(window);
+	return static_cast<int>(_windows.size()-1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t CrossCorrelator::windowCount() const {
+	return _windows.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const CrossCorrelator::Window &CrossCorrelator::window(size_t index) const {
+	return _windows[index];
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::clear() {
+	_windows.clear();
+	_results.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::compute() {
+	_results.clear();
+
+	typedef std::tuple<std::string, std::string, double> GroupKey;
+	std::map<GroupKey, std::vector<uint32_t>> groups;
+
+	for ( size_t i = 0; i < _windows.size(); ++i ) {
+		const Window &w = _windows[i];
+		groups[GroupKey(w.streamID, w.phase, w.samplingFrequency)].push_back(i);
+	}
+
+	int maxThreads = _threads;
+	if ( maxThreads <= 0 )
+		maxThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+	// Groups are processed one after another to hold only the spectra of
+	// one group in memory
+	for ( auto &item : groups ) {
+		if ( item.second.size() < 2 ) continue;
+
+		Group group;
+		group.windows.swap(item.second);
+
+		size_t maxLength = 0;
+		for ( uint32_t idx : group.windows )
+			maxLength = std::max(maxLength, static_cast<size_t>(_windows[idx].data.size()));
+
+		// The transform must hold the full linear correlation
+		group.fftn = 1;
+		while ( size_t(group.fftn) < 2*maxLength ) group.fftn <<= 1;
+
+		size_t count = group.windows.size();
+		std::vector<std::vector<double>> padded(count);
+		std::vector<const double*> input(count);
+		group.energies.resize(count);
+
+		for ( size_t i = 0; i < count; ++i ) {
+			const DoubleArray &data = _windows[group.windows[i]].data;
+			std::vector<double> &buffer = padded[i];
+			buffer.assign(group.fftn, 0.0);
+
+			double mean = 0;
+			for ( int j = 0; j < data.size(); ++j ) mean += data[j];
+			mean /= data.size();
+
+			double energy = 0;
+			for ( int j = 0; j < data.size(); ++j ) {
+				buffer[j] = data[j] - mean;
+				energy += buffer[j]*buffer[j];
+			}
+
+			group.energies[i] = energy;
+			input[i] = buffer.data();
+		}
+
+		Math::fft(group.spectra, static_cast<int>(count), group.fftn, input.data());
+		padded.clear();
+
+		int threadCount = static_cast<int>(std::min(size_t(maxThreads), count-1));
+		std::vector<std::vector<Result>> threadResults(threadCount);
+		std::atomic<size_t> nextRow(0);
+
+		auto worker = [&](std::vector<Result> &results) {
+			size_t row;
+			while ( (row = nextRow++) < count-1 )
+				correlate(group, row, results);
+		};
+
+		if ( threadCount == 1 )
+			worker(threadResults[0]);
+		else {
+			std::vector<std::thread> workers;
+			for ( int i = 0; i < threadCount; ++i )
+				workers.emplace_back(worker, std::ref(threadResults[i]));
+			for ( std::thread &t : workers )
+				t.join();
+		}
+
+		for ( const std::vector<Result> &results : threadResults )
+			_results.insert(_results.end(), results.begin(), results.end());
+	}
+
+	std::sort(_results.begin(), _results.end(),
+	          [](const Result &a, const Result &b) {
+		return a.first < b.first || (a.first == b.first && a.second < b.second);
+	});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::vector<CrossCorrelator::Result> &CrossCorrelator::results() const {
+	return _results;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CrossCorrelator::correlate(const Group &group, size_t row,
+                                std::vector<Result> &results) const {
+	if ( group.energies[row] <= 0 ) return;
+
+	const Window &w1 = _windows[group.windows[row]];
+	const Math::ComplexArray &s1 = group.spectra[row];
+	int half = group.fftn / 2;
+	int n = group.fftn * _upsampling;
+	double fsamp = w1.samplingFrequency * _upsampling;
+
+	Math::ComplexArray cross;
+	std::vector<double> corr(n);
+
+	for ( size_t col = row+1; col < group.windows.size(); ++col ) {
+		const Window &w2 = _windows[group.windows[col]];
+		if ( w1.eventID == w2.eventID || group.energies[col] <= 0 ) continue;
+		if ( _pairFilter && !_pairFilter(w1, w2) ) continue;
+
+		// The lags of the upsampled correlation which fulfill the maximum
+		// delay and which do not exceed the overlap of both windows.
+		// delay = lag/fsamp - offset
+		double offset = (double)((w2.reference - w2.startTime) - (w1.reference - w1.startTime));
+		int lo = static_cast<int>(ceil((offset - _maxDelay) * fsamp));
+		int hi = static_cast<int>(floor((offset + _maxDelay) * fsamp));
+		lo = std::max(lo, -(w1.data.size()-1) * _upsampling);
+		hi = std::min(hi, (w2.data.size()-1) * _upsampling);
+		if ( hi - lo < 2 ) continue;
+
+		// Zero padding of the cross spectrum interpolates the correlation.
+		// The built-in transform packs the Nyquist coefficient into the
+		// imaginary part of the first bin, it is dropped as with the
+		// transform of fftw.
+		const Math::ComplexArray &s2 = group.spectra[col];
+		cross.assign(s1.size() == size_t(half) ? half*_upsampling : half*_upsampling+1,
+		             Math::Complex(0, 0));
+		cross[0] = Math::Complex(s2[0].real() * s1[0].real(), 0);
+		for ( int k = 1; k < half; ++k )
+			cross[k] = s2[k] * std::conj(s1[k]);
+
+		// r[lag] = sum(w2[lag+j] * w1[j])
+		Math::ifft(n, corr.data(), cross);
+
+		auto value = [&](int lag) { return corr[lag < 0 ? lag + n : lag]; };
+
+		int peakLag = lo;
+		double peak = value(lo);
+		for ( int lag = lo+1; lag <= hi; ++lag ) {
+			double v = value(lag);
+			if ( v > peak ) {
+				peak = v;
+				peakLag = lag;
+			}
+		}
+
+		// A maximum at the bounds is not a peak of the correlation function
+		if ( peakLag == lo || peakLag == hi ) continue;
+
+		double y0 = value(peakLag-1), y2 = value(peakLag+1);
+		double denom = y0 - 2*peak + y2;
+		double shift = 0;
+		if ( denom < 0 ) {
+			shift = 0.5 * (y0 - y2) / denom;
+			peak -= 0.25 * (y0 - y2) * shift;
+		}
+
+		// The inverse transform of the padded spectrum is scaled by the
+		// inverse upsampling factor
+		double coefficient = peak * _upsampling /
+		                     sqrt(group.energies[row] * group.energies[col]);
+		if ( coefficient < _minCoefficient ) continue;
+
+		Result result;
+		result.first = group.windows[row];
+		result.second = group.windows[col];
+		result.delay = static_cast<float>((peakLag + shift) / fsamp - offset);
+		result.coefficient = static_cast<float>(std::min(coefficient, 1.0));
+		results.push_back(result);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
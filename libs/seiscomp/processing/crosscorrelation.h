@@ -0,0 +1,163 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_PROCESSING_CROSSCORRELATION_H
+#define SEISCOMP_PROCESSING_CROSSCORRELATION_H
+
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/client.h>
+
+#include <boost/function.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+/**
+ * @brief The CrossCorrelator class measures the differential times of
+ *        phases of event pairs by cross-correlating their waveforms.
+ *
+ * Windows are grouped by stream, phase and sampling frequency and all pairs
+ * of windows of different events within a group are correlated. The
+ * spectrum of each window is computed once and shared by all of its pairs.
+ * The pairs are distributed over a number of threads, each cross spectrum
+ * is zero padded to interpolate the correlation function and the peak is
+ * refined with a parabola through the neighbouring samples.
+ *
+ * The results refer to the windows by index to keep them small even for
+ * large numbers of pairs.
+ */
+class SC_SYSTEM_CLIENT_API CrossCorrelator {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct Window {
+			std::string eventID;
+			std::string streamID;
+			std::string phase;
+			//! The reference time, e.g. the pick time
+			Core::Time  reference;
+			//! The time of the first sample
+			Core::Time  startTime;
+			double      samplingFrequency;
+			DoubleArray data;
+		};
+
+		/**
+		 * The result of a pair of windows. The delay is the time of the
+		 * phase of the second window relative to its reference minus the
+		 * time of the phase of the first window relative to its reference.
+		 */
+		struct Result {
+			uint32_t first;
+			uint32_t second;
+			float    delay;
+			float    coefficient;
+		};
+
+		//! Returns whether a pair of windows should be correlated
+		typedef boost::function<bool (const Window&, const Window&)> PairFilter;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		CrossCorrelator();
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Sets the maximum absolute delay in seconds, default is 1
+		void setMaximumDelay(double seconds);
+		double maximumDelay() const;
+
+		//! Sets the minimum correlation coefficient of a result, default
+		//! is 0.7
+		void setMinimumCoefficient(double coefficient);
+		double minimumCoefficient() const;
+
+		//! Sets the factor by which the correlation function is
+		//! interpolated, default is 8. The factor is rounded up to the
+		//! next power of two.
+		void setUpsampling(int factor);
+		int upsampling() const;
+
+		//! Sets the number of threads, 0 uses the number of cores which
+		//! is the default
+		void setThreads(int threads);
+		int threads() const;
+
+		void setPairFilter(const PairFilter &filter);
+
+		/**
+		 * @brief Adds a window.
+		 * @return The index of the window or -1 if the window has less
+		 *         than two samples or no valid sampling frequency
+		 */
+		int add(const Window &window);
+
+		size_t windowCount() const;
+		const Window &window(size_t index) const;
+
+		//! Removes all windows and results
+		void clear();
+
+		//! Correlates all pairs. The results are sorted by the indexes
+		//! of their windows.
+		void compute();
+
+		const std::vector<Result> &results() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods and members
+	// ----------------------------------------------------------------------
+	private:
+		struct Group;
+
+		void correlate(const Group &group, size_t row,
+		               std::vector<Result> &results) const;
+
+		double              _maxDelay;
+		double              _minCoefficient;
+		int                 _upsampling;
+		int                 _threads;
+		PairFilter          _pairFilter;
+		std::vector<Window> _windows;
+		std::vector<Result> _results;
+};
+
+
+}
+}
+
+
+#endif
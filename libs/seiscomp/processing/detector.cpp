@@ -116,6 +116,16 @@ void Detector::reset() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Detector::serialize(Archive &ar) {
+	WaveformProcessor::serialize(ar);
+	ar & TAGGED_MEMBER(lastPick);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SimpleDetector::SimpleDetector(double deadTime)
  : Detector(deadTime) {}
@@ -199,6 +209,17 @@ void SimpleDetector::reset() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SimpleDetector::serialize(Archive &ar) {
+	Detector::serialize(ar);
+	ar & TAGGED_MEMBER(triggered);
+	ar & TAGGED_MEMBER(pickEmitted);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool SimpleDetector::validateOn(const Record *record, size_t &i, const DoubleArray &) {
 	return true;
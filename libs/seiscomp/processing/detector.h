@@ -55,6 +55,9 @@ class SC_SYSTEM_CLIENT_API Detector : public WaveformProcessor {
 
 		virtual void reset() override;
 
+		//! Adds the time of the last pick to the serialized state
+		void serialize(Archive &ar) override;
+
 	protected:
 		virtual bool emitPick(const Record* rec, const Core::Time& t);
 
@@ -88,6 +91,9 @@ class SC_SYSTEM_CLIENT_API SimpleDetector : public Detector {
 
 		void reset() override;
 
+		//! Adds the trigger state to the serialized state
+		void serialize(Archive &ar) override;
+
 	protected:
 		bool isOn() const { return _triggered; }
 		bool isOff() const { return !_triggered; }
@@ -0,0 +1,201 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/processing/gapinterpolator.h>
+
+#include <algorithm>
+
+
+namespace Seiscomp {
+namespace Processing {
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+GapInterpolator::GapInterpolator(Strategy strategy)
+: _strategy(strategy), _historyFront(0), _historySize(0) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GapInterpolator::setStrategy(Strategy strategy) {
+	_strategy = strategy;
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GapInterpolator::setHistoryLength(size_t length) {
+	if ( length == _history.size() ) return;
+
+	_history.assign(length, 0.0);
+	_history.shrink_to_fit();
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GapInterpolator::reset() {
+	_historyFront = 0;
+	_historySize = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GapInterpolator::feed(size_t n, const double *samples) {
+	if ( !needsHistory() ) return;
+
+	size_t capacity = _history.size();
+
+	// Only the most recent samples fit into the history
+	if ( n > capacity ) {
+		samples += n - capacity;
+		n = capacity;
+	}
+
+	while ( n > 0 ) {
+		size_t chunk = std::min(n, capacity - _historyFront);
+		std::copy(samples, samples + chunk, _history.begin() + _historyFront);
+		_historyFront += chunk;
+		if ( _historyFront == capacity ) _historyFront = 0;
+		samples += chunk;
+		n -= chunk;
+		_historySize = std::min(_historySize + chunk, capacity);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GapInterpolator::serialize(Core::Archive &ar) {
+	// The history is stored from the oldest to the most recent sample
+	std::vector<double> recent;
+
+	if ( !ar.isReading() ) {
+		size_t capacity = _history.size();
+		recent.reserve(_historySize);
+		for ( size_t k = _historySize; k > 0; --k )
+			recent.push_back(_history[(_historyFront + capacity - k) % capacity]);
+	}
+
+	ar & NAMED_OBJECT("history", recent);
+
+	if ( ar.isReading() ) {
+		reset();
+		feed(recent.size(), recent.data());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double GapInterpolator::mirrored(size_t k) const {
+	// Reflect k into [0, size-1], the period is twice the history length
+	// without the samples at both ends
+	size_t last = _historySize - 1;
+	k %= 2 * last;
+	if ( k > last ) k = 2 * last - k;
+
+	size_t capacity = _history.size();
+	size_t index = (_historyFront + capacity - 1 - k) % capacity;
+	return _history[index];
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GapInterpolator::interpolate(size_t missingSamples,
+                                  double lastSample, double nextSample,
+                                  const Sink &sink) {
+	if ( missingSamples == 0 ) return;
+
+	if ( _block.size() != BlockSize )
+		_block.resize(BlockSize);
+
+	Strategy strategy = _strategy;
+	if ( strategy == Mirror && _historySize < 2 )
+		strategy = Linear;
+
+	double step = 1.0 / (double)(missingSamples + 1);
+
+	// The mirrored signal continues the history at the start of the gap.
+	// Its offset to the sample after the gap is removed linearly.
+	double mirrorOffset = 0;
+	if ( strategy == Mirror )
+		mirrorOffset = nextSample - mirrored(missingSamples + 1);
+
+	for ( size_t offset = 0; offset < missingSamples; offset += BlockSize ) {
+		size_t n = std::min(BlockSize, missingSamples - offset);
+		double *block = _block.data();
+
+		switch ( strategy ) {
+			case Linear:
+			{
+				double delta = nextSample - lastSample;
+				for ( size_t i = 0; i < n; ++i )
+					block[i] = lastSample + (offset + i + 1) * step * delta;
+				break;
+			}
+			case Hold:
+				std::fill(block, block + n, lastSample);
+				break;
+			case Mirror:
+				for ( size_t i = 0; i < n; ++i ) {
+					size_t k = offset + i + 1;
+					block[i] = mirrored(k) + k * step * mirrorOffset;
+				}
+				break;
+		}
+
+		sink(n, block);
+	}
+
+	// The history must not span the gap, it is rebuilt from the
+	// following records
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
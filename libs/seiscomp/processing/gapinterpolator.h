@@ -0,0 +1,148 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_PROCESSING_GAPINTERPOLATOR_H
+#define SEISCOMP_PROCESSING_GAPINTERPOLATOR_H
+
+
+#include <seiscomp/client.h>
+#include <seiscomp/core/io.h>
+
+#include <functional>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+/**
+ * @brief Generates the samples of a data gap.
+ *
+ * The samples are generated in blocks of a fixed size into an internal
+ * buffer which is allocated once. Each block is handed over to a sink,
+ * e.g. the fill method of a processor, which allows a stateful filter to
+ * continue across the gap instead of being reset.
+ *
+ * The following strategies are supported:
+ *   - Linear: linear interpolation between the last sample before and the
+ *     first sample after the gap
+ *   - Hold: repeats the last sample before the gap
+ *   - Mirror: fills the gap with the recent samples mirrored in time and
+ *     corrected by a linear trend to join the first sample after the gap.
+ *     In contrast to the other strategies the amplitude spectrum of the
+ *     signal before the gap is preserved which avoids a quiet segment in
+ *     e.g. noise or amplitude measurements. The recent samples must be
+ *     passed with feed. Without history it falls back to Linear.
+ */
+class SC_SYSTEM_CLIENT_API GapInterpolator {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		enum Strategy {
+			Linear,
+			Hold,
+			Mirror
+		};
+
+		//! Receives a block of n generated samples. The samples may be
+		//! modified by the sink.
+		using Sink = std::function<void (size_t n, double *samples)>;
+
+		//! The maximum number of samples passed to the sink at once
+		static const size_t BlockSize = 512;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		GapInterpolator(Strategy strategy = Linear);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		void setStrategy(Strategy strategy);
+		Strategy strategy() const { return _strategy; }
+
+		//! Sets the number of recent samples kept for Mirror. The history
+		//! is only kept if the strategy is Mirror.
+		void setHistoryLength(size_t length);
+		size_t historyLength() const { return _history.size(); }
+
+		//! Returns whether feed needs to be called
+		bool needsHistory() const { return _strategy == Mirror && !_history.empty(); }
+
+		//! Clears the history
+		void reset();
+
+		//! Adds samples to the history
+		void feed(size_t n, const double *samples);
+
+		/**
+		 * @brief Generates the missing samples between two samples and
+		 *        passes them in blocks to the sink. The history is
+		 *        cleared afterwards.
+		 * @param missingSamples The number of samples to generate
+		 * @param lastSample The last sample before the gap
+		 * @param nextSample The first sample after the gap
+		 * @param sink The receiver of the generated samples
+		 */
+		void interpolate(size_t missingSamples,
+		                 double lastSample, double nextSample,
+		                 const Sink &sink);
+
+		//! Writes or restores the history. The history length must be
+		//! set before restoring, the most recent samples that fit are
+		//! kept.
+		void serialize(Core::Archive &ar);
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		//! Returns the sample k steps back from the most recent one in
+		//! the history mirrored at both of its ends
+		double mirrored(size_t k) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		Strategy            _strategy;
+		// Ring buffer of the recent samples
+		std::vector<double> _history;
+		size_t              _historyFront;
+		size_t              _historySize;
+		std::vector<double> _block;
+};
+
+
+}
+}
+
+
+#endif
@@ -231,6 +231,15 @@ std::string MagnitudeProcessor::amplitudeType() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MagnitudeProcessor *MagnitudeProcessor::clone() const {
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool MagnitudeProcessor::setup(const Settings &settings) {
 	if ( !Processor::setup(settings) )
@@ -598,6 +607,132 @@ bool MagnitudeProcessor::initRegionalization(const Settings &settings) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+// Returns the regionalization of a magnitude type if regions are
+// configured. Must be called with globalParameterMutex held.
+const Regionalization *findRegionalization(const string &type) {
+	auto it = regionalizationRegistry.find(type);
+	if ( it == regionalizationRegistry.end() ) {
+		return nullptr;
+	}
+
+	TypeSpecificRegionalization *tsr = it->second.get();
+	if ( !tsr or tsr->regionalization.empty() ) {
+		return nullptr;
+	}
+
+	return &tsr->regionalization;
+}
+
+
+// Searches the first profile which matches the source and the receiver
+MagnitudeProcessor::Status findLocale(const Regionalization &regionalization,
+                                      const DataModel::Origin *hypocenter,
+                                      const DataModel::SensorLocation *receiver,
+                                      double delta, double depth,
+                                      const MagnitudeProcessor::Locale *&locale) {
+	using Locale = MagnitudeProcessor::Locale;
+
+	locale = nullptr;
+
+	// There are region profiles so meta data are required
+	if ( !hypocenter ) {
+		return MagnitudeProcessor::MetaDataRequired;
+	}
+
+	if ( !receiver ) {
+		return MagnitudeProcessor::MetaDataRequired;
+	}
+
+	double hypoLat, hypoLon;
+	double recvLat, recvLon;
+
+	try {
+		// All attributes are optional and throw an exception if not set
+		hypoLat = hypocenter->latitude().value();
+		hypoLon = hypocenter->longitude().value();
+	}
+	catch ( ... ) {
+		return MagnitudeProcessor::MetaDataRequired;
+	}
+
+	try {
+		// Both attributes are optional and throw an exception if not set
+		recvLat = receiver->latitude();
+		recvLon = receiver->longitude();
+	}
+	catch ( ... ) {
+		return MagnitudeProcessor::MetaDataRequired;
+	}
+
+	MagnitudeProcessor::Status notFoundStatus = MagnitudeProcessor::OK;
+
+	for ( const Locale &profile : regionalization ) {
+		if ( profile.feature ) {
+			switch ( profile.check ) {
+				case Locale::Source:
+					if ( !Regions::contains(profile.feature, hypoLat, hypoLon) ) {
+						notFoundStatus = MagnitudeProcessor::EpicenterOutOfRegions;
+						continue;
+					}
+
+					break;
+
+				case Locale::SourceReceiver:
+					if ( !Regions::contains(profile.feature, hypoLat, hypoLon) ) {
+						notFoundStatus = MagnitudeProcessor::EpicenterOutOfRegions;
+						continue;
+					}
+					if ( !Regions::contains(profile.feature, recvLat, recvLon) ) {
+						notFoundStatus = MagnitudeProcessor::ReceiverOutOfRegions;
+						continue;
+					}
+					break;
+
+				case Locale::SourceReceiverPath:
+					if ( !Regions::contains(profile.feature, hypoLat, hypoLon, recvLat, recvLon) ) {
+						notFoundStatus = MagnitudeProcessor::RayPathOutOfRegions;
+						continue;
+					}
+					break;
+			}
+		}
+
+		if ( profile.minimumDepth and depth < *profile.minimumDepth ) {
+			notFoundStatus = MagnitudeProcessor::DepthOutOfRange;
+			continue;
+		}
+		if ( profile.maximumDepth and depth > *profile.maximumDepth ) {
+			notFoundStatus = MagnitudeProcessor::DepthOutOfRange;
+			continue;
+		}
+
+		// Found region
+		locale = &profile;
+
+		if ( locale->minimumDistance and delta < *locale->minimumDistance ) {
+			return MagnitudeProcessor::DistanceOutOfRange;
+		}
+		if ( locale->maximumDistance and delta > *locale->maximumDistance ) {
+			return MagnitudeProcessor::DistanceOutOfRange;
+		}
+
+		return MagnitudeProcessor::OK;
+	}
+
+	return notFoundStatus;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 MagnitudeProcessor::Status
 MagnitudeProcessor::computeMagnitude(double amplitudeValue,
@@ -613,102 +748,89 @@ MagnitudeProcessor::computeMagnitude(double amplitudeValue,
 	// Check if regionalization is desired
 	{
 		lock_guard<mutex> l(globalParameterMutex);
-		auto it = regionalizationRegistry.find(type());
-		if ( it != regionalizationRegistry.end() ) {
-			TypeSpecificRegionalization *tsr = it->second.get();
-			if ( tsr and !tsr->regionalization.empty() ) {
-				// There are region profiles so meta data are required
-				if ( !hypocenter ) {
-					return MetaDataRequired;
-				}
+		const Regionalization *regionalization = findRegionalization(type());
+		if ( regionalization ) {
+			auto r = findLocale(*regionalization, hypocenter, receiver,
+			                    delta, depth, locale);
+			if ( r != OK ) {
+				return r;
+			}
+		}
+	}
 
-				if ( !receiver ) {
-					return MetaDataRequired;
-				}
+	return computeWithLocale(amplitudeValue, unit, period, snr, delta, depth,
+	                         hypocenter, receiver, amplitude, locale, value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-				double hypoLat, hypoLon;
-				double recvLat, recvLon;
 
-				try {
-					// All attributes are optional and throw an exception if not set
-					hypoLat = hypocenter->latitude().value();
-					hypoLon = hypocenter->longitude().value();
-				}
-				catch ( ... ) {
-					return MetaDataRequired;
-				}
 
-				try {
-					// Both attributes are optional and throw an exception if not set
-					recvLat = receiver->latitude();
-					recvLon = receiver->longitude();
-				}
-				catch ( ... ) {
-					return MetaDataRequired;
-				}
 
-				Status notFoundStatus = OK;
-
-				for ( const Locale &profile : tsr->regionalization ) {
-					if ( profile.feature ) {
-						switch ( profile.check ) {
-							case Locale::Source:
-								if ( !profile.feature->contains(Geo::GeoCoordinate(hypoLat, hypoLon)) ) {
-									notFoundStatus = EpicenterOutOfRegions;
-									continue;
-								}
-
-								break;
-
-							case Locale::SourceReceiver:
-								if ( !profile.feature->contains(Geo::GeoCoordinate(hypoLat, hypoLon)) ) {
-									notFoundStatus = EpicenterOutOfRegions;
-									continue;
-								}
-								if ( !profile.feature->contains(Geo::GeoCoordinate(recvLat, recvLon)) ) {
-									notFoundStatus = ReceiverOutOfRegions;
-									continue;
-								}
-								break;
-
-							case Locale::SourceReceiverPath:
-								if ( !Regions::contains(profile.feature, hypoLat, hypoLon, recvLat, recvLon) ) {
-									notFoundStatus = RayPathOutOfRegions;
-									continue;
-								}
-								break;
-						}
-					}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MagnitudeProcessor::ComputeMagnitudes(const DataModel::Origin *hypocenter,
+                                           double depth,
+                                           StationAmplitudes &amplitudes) {
+	vector<const Locale*> locales(amplitudes.size(), nullptr);
 
-					if ( profile.minimumDepth and depth < *profile.minimumDepth ) {
-						notFoundStatus = DepthOutOfRange;
-						continue;
-					}
-					if ( profile.maximumDepth and depth > *profile.maximumDepth ) {
-						notFoundStatus = DepthOutOfRange;
-						continue;
-					}
+	// Resolve all locales with a single lock and one registry lookup per
+	// magnitude type
+	{
+		lock_guard<mutex> l(globalParameterMutex);
+		const string *lastType = nullptr;
+		const Regionalization *regionalization = nullptr;
 
-					// Found region
-					locale = &profile;
+		for ( size_t i = 0; i < amplitudes.size(); ++i ) {
+			StationAmplitude &input = amplitudes[i];
 
-					if ( locale->minimumDistance and delta < *locale->minimumDistance ) {
-						return DistanceOutOfRange;
-					}
-					if ( locale->maximumDistance and delta > *locale->maximumDistance ) {
-						return DistanceOutOfRange;
-					}
+			if ( !input.processor ) {
+				input.status = Error;
+				continue;
+			}
 
-					break;
-				}
+			if ( !lastType or *lastType != input.processor->type() ) {
+				lastType = &input.processor->type();
+				regionalization = findRegionalization(*lastType);
+			}
 
-				if ( !locale ) {
-					return notFoundStatus;
-				}
+			input.status = OK;
+
+			if ( regionalization ) {
+				input.status = findLocale(*regionalization, hypocenter,
+				                          input.receiver, input.delta, depth,
+				                          locales[i]);
 			}
 		}
 	}
 
+	for ( size_t i = 0; i < amplitudes.size(); ++i ) {
+		StationAmplitude &input = amplitudes[i];
+		if ( input.status != OK ) {
+			continue;
+		}
+
+		input.status = input.processor->computeWithLocale(
+			input.amplitudeValue, input.unit, input.period, input.snr,
+			input.delta, depth, hypocenter, input.receiver, input.amplitude,
+			locales[i], input.value
+		);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MagnitudeProcessor::Status
+MagnitudeProcessor::computeWithLocale(double amplitudeValue,
+                                      const std::string &unit,
+                                      double period, double snr,
+                                      double delta, double depth,
+                                      const DataModel::Origin *hypocenter,
+                                      const DataModel::SensorLocation *receiver,
+                                      const DataModel::Amplitude *amplitude,
+                                      const Locale *locale,
+                                      double &value) {
 	if ( locale )
 		SEISCOMP_DEBUG("%s.%s: %s: locale = '%s'",
 		               _networkCode.c_str(), _stationCode.c_str(), _type.c_str(),
@@ -133,6 +133,29 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor : public Processor {
 			Core::BaseObjectPtr    extra;
 		};
 
+		/**
+		 * @brief An amplitude of a station and the resulting magnitude as
+		 *        used by ComputeMagnitudes.
+		 */
+		struct StationAmplitude {
+			//! The processor which has been set up for the station
+			MagnitudeProcessor              *processor{nullptr};
+			double                           amplitudeValue{0};
+			std::string                      unit;
+			double                           period{0};
+			double                           snr{0};
+			double                           delta{0};
+			const DataModel::SensorLocation *receiver{nullptr};
+			const DataModel::Amplitude      *amplitude{nullptr};
+
+			//! The status of the computation
+			Status                           status{Error};
+			//! The magnitude, see computeMagnitude
+			double                           value{0};
+		};
+
+		using StationAmplitudes = std::vector<StationAmplitude>;
+
 
 	// ----------------------------------------------------------------------
 	//  X'truction
@@ -167,6 +190,15 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor : public Processor {
 
 		virtual bool setup(const Settings &settings) override;
 
+		/**
+		 * @brief Returns a copy of this processor including the result of
+		 *        setup. This allows to set up a prototype once and to create
+		 *        processors from it without parsing the configuration again.
+		 * @return The copy or nullptr if cloning is not supported which is
+		 *         what the default implementation returns.
+		 */
+		virtual MagnitudeProcessor *clone() const;
+
 		/**
 		 * @brief Computes the magnitude from an amplitude. The method signature
 		 *        has changed with API version >= 11. Prior to that version,
@@ -194,6 +226,21 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor : public Processor {
 		                        const DataModel::Amplitude *amplitude,
 		                        double &value);
 
+		/**
+		 * @brief Computes the magnitudes of all amplitudes of an origin at
+		 *        once. The result is the same as calling computeMagnitude
+		 *        for each amplitude with its processor, but the regional
+		 *        profiles are resolved in one pass. treatAsValidMagnitude
+		 *        of each processor reflects its last amplitude in the list.
+		 * @param hypocenter The optional origin which describes the hypocenter.
+		 * @param depth The depth of the hypocenter in kilometers.
+		 * @param amplitudes The amplitudes which receive the status and the
+		 *                   magnitude value.
+		 */
+		static void ComputeMagnitudes(const DataModel::Origin *hypocenter,
+		                              double depth,
+		                              StationAmplitudes &amplitudes);
+
 		/**
 		 * @brief When computeMagnitude return an error the computed magnitude
 		 *        value might nevertheless contain a meaningful value. E.g. if
@@ -298,6 +345,17 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor : public Processor {
 		                const Settings &settings,
 		                const std::string &configPrefix);
 
+		//! Computes the magnitude for an already resolved locale and
+		//! applies the corrections
+		Status computeWithLocale(double amplitudeValue, const std::string &unit,
+		                         double period, double snr,
+		                         double delta, double depth,
+		                         const DataModel::Origin *hypocenter,
+		                         const DataModel::SensorLocation *receiver,
+		                         const DataModel::Amplitude *amplitude,
+		                         const Locale *locale,
+		                         double &value);
+
 	protected:
 		struct Correction {
 			typedef std::pair<double, double> A;
@@ -60,6 +60,15 @@ MagnitudeProcessor_ML::MagnitudeProcessor_ML() : Processing::MagnitudeProcessor(
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MagnitudeProcessor *MagnitudeProcessor_ML::clone() const {
+	return new MagnitudeProcessor_ML(*this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 std::string MagnitudeProcessor_ML::amplitudeType() const {
 	return MagnitudeProcessor::amplitudeType();
@@ -38,6 +38,8 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_ML : public MagnitudeProcessor {
 
 
 	public:
+		MagnitudeProcessor *clone() const override;
+
 		bool setup(const Settings &settings) override;
 
 		std::string amplitudeType() const override;
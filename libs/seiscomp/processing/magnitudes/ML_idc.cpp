@@ -69,6 +69,15 @@ Magnitude_ML_idc::Magnitude_ML_idc()
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MagnitudeProcessor *Magnitude_ML_idc::clone() const {
+	return new Magnitude_ML_idc(*this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 std::string Magnitude_ML_idc::amplitudeType() const {
 	return MagnitudeProcessor::amplitudeType();
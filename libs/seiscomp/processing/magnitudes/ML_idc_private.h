@@ -39,6 +39,8 @@ class SC_SYSTEM_CLIENT_API Magnitude_ML_idc : public MagnitudeProcessor {
 		Magnitude_ML_idc();
 
 	public:
+		MagnitudeProcessor *clone() const override;
+
 		virtual std::string amplitudeType() const;
 
 		virtual bool setup(const Settings &settings);
@@ -75,6 +75,15 @@ MagnitudeProcessor_MLc::MagnitudeProcessor_MLc()
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MagnitudeProcessor *MagnitudeProcessor_MLc::clone() const {
+	return new MagnitudeProcessor_MLc(*this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 std::string MagnitudeProcessor_MLc::amplitudeType() const {
 	return MagnitudeProcessor::amplitudeType();
@@ -37,6 +37,8 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_MLc : public MagnitudeProcessor {
 
 
 	public:
+		MagnitudeProcessor *clone() const override;
+
 		bool setup(const Settings &settings) override;
 
 		std::string amplitudeType() const override;
@@ -67,6 +67,15 @@ MagnitudeProcessor_MLv::MagnitudeProcessor_MLv()
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MagnitudeProcessor *MagnitudeProcessor_MLv::clone() const {
+	return new MagnitudeProcessor_MLv(*this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool MagnitudeProcessor_MLv::setup(const Settings &settings) {
 	if ( !MagnitudeProcessor::setup(settings) ) {
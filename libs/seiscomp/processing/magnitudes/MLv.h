@@ -40,6 +40,8 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_MLv : public MagnitudeProcessor {
 
 
 	public:
+		MagnitudeProcessor *clone() const override;
+
 		bool setup(const Settings &settings) override;
 
 
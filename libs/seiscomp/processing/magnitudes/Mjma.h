@@ -33,6 +33,9 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_Mjma : public MagnitudeProcessor {
 	public:
 		MagnitudeProcessor_Mjma();
 
+	public:
+		MagnitudeProcessor *clone() const override;
+
 	protected:
 		Status computeMagnitude(double amplitude, const std::string &unit,
 		                        double period, double snr,
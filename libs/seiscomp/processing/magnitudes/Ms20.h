@@ -35,6 +35,9 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_ms20 : public MagnitudeProcessor {
 	public:
 		MagnitudeProcessor_ms20();
 
+	public:
+		MagnitudeProcessor *clone() const override;
+
 		bool setup(const Settings &settings) override;
 
 	protected:
@@ -35,6 +35,9 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_Mwp : public MagnitudeProcessor {
 	public:
 		MagnitudeProcessor_Mwp();
 
+	public:
+		MagnitudeProcessor *clone() const override;
+
 		Status computeMagnitude(double amplitude, const std::string &unit,
 		                        double period, double snr,
 		                        double delta, double depth,
@@ -35,6 +35,9 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_mBc : public MagnitudeProcessor_mB
 	public:
 		MagnitudeProcessor_mBc();
 
+	public:
+		MagnitudeProcessor *clone() const override;
+
 		Status estimateMw(const Config::Config *config,
 		                  double magnitude, double &Mw_estimate,
 		                  double &Mw_stdError) override;
@@ -36,6 +36,8 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_mB : public MagnitudeProcessor {
 		MagnitudeProcessor_mB();
 		MagnitudeProcessor_mB(const std::string& type);
 
+	public:
+		MagnitudeProcessor *clone() const override;
 
 		bool setup(const Settings &settings) override;
 
@@ -37,6 +37,9 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_mb : public MagnitudeProcessor {
 	public:
 		MagnitudeProcessor_mb();
 
+	public:
+		MagnitudeProcessor *clone() const override;
+
 	protected:
 		Status computeMagnitude(double amplitude, const std::string &unit,
 		                        double period, double snr,
@@ -38,6 +38,8 @@ class SC_SYSTEM_CLIENT_API Magnitude_mb_idc : public MagnitudeProcessor {
 		Magnitude_mb_idc();
 
 	public:
+		MagnitudeProcessor *clone() const override;
+
 		virtual std::string amplitudeType() const;
 
 		virtual bool setup(const Settings &settings);
@@ -35,6 +35,9 @@ class SC_SYSTEM_CLIENT_API MagnitudeProcessor_msbb : public MagnitudeProcessor {
 	public:
 		MagnitudeProcessor_msbb();
 
+	public:
+		MagnitudeProcessor *clone() const override;
+
 	protected:
 		Status computeMagnitude(double amplitude, const std::string &unit,
 		                        double period, double snr,
@@ -22,6 +22,7 @@
 #define SEISCOMP_PROCESSING_MAGNITUDES_UTILS_H
 
 
+#include <cstddef>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -43,7 +44,24 @@ struct TableXY {
 	// Throws out_of_range if x is out of range
 	T at(double x) const;
 
+	// Evaluates the table for n values, writes NaN for each x out of range
+	// and returns the number of values in range
+	size_t at(const double *x, T *y, size_t n) const;
+
+	// Rebuilds the lookup index, must be called if items are changed
+	// other than with set()
+	void update();
+
 	Items items;
+
+	// Uniform grid over the x range. Each cell holds the index of the
+	// first item at or behind the cell start which turns the lookup into
+	// a constant time operation for most tables.
+	std::vector<size_t> grid;
+	double              gridScale{0};
+
+	private:
+		bool interpolate(double x, T &y) const;
 };
 
 
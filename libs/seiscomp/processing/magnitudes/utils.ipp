@@ -21,6 +21,7 @@
 #include <seiscomp/core/strings.h>
 #include <stdexcept>
 #include <algorithm>
+#include <limits>
 
 
 namespace Seiscomp {
@@ -44,6 +45,7 @@ bool TableXY<T>::empty() const {
 template <typename T>
 bool TableXY<T>::set(const std::string &definition) {
 	items.clear();
+	grid.clear();
 
 	std::istringstream iss(definition);
 	std::string item;
@@ -94,6 +96,8 @@ bool TableXY<T>::set(const std::string &definition) {
 		return a.first < b.first;
 	});
 
+	update();
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -105,6 +109,7 @@ bool TableXY<T>::set(const std::string &definition) {
 template <typename T>
 bool TableXY<T>::set(const std::vector<std::string> &definition) {
 	items.clear();
+	grid.clear();
 
 	for ( const auto &item: definition ) {
 		double x;
@@ -128,6 +133,8 @@ bool TableXY<T>::set(const std::vector<std::string> &definition) {
 		return a.first < b.first;
 	});
 
+	update();
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -138,21 +145,111 @@ bool TableXY<T>::set(const std::vector<std::string> &definition) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template <typename T>
 T TableXY<T>::at(double x) const {
+	T y;
+	if ( !interpolate(x, y) ) {
+		throw std::out_of_range("x out of range");
+	}
+
+	return y;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+size_t TableXY<T>::at(const double *x, T *y, size_t n) const {
+	size_t count = 0;
+
+	for ( size_t i = 0; i < n; ++i ) {
+		if ( interpolate(x[i], y[i]) ) {
+			++count;
+		}
+		else {
+			y[i] = std::numeric_limits<T>::quiet_NaN();
+		}
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void TableXY<T>::update() {
+	grid.clear();
+	gridScale = 0;
+
+	if ( items.size() < 2 ) {
+		return;
+	}
+
+	double x0 = items.front().first;
+	double range = items.back().first - x0;
+	if ( !(range > 0) ) {
+		return;
+	}
+
+	// A few cells per item keep the number of steps per lookup small
+	// for non-uniformly spaced tables
+	size_t cells = std::min(items.size() * 4, size_t(4096));
+	gridScale = cells / range;
+	grid.resize(cells);
+
+	size_t i = 1;
+	for ( size_t c = 0; c < cells; ++c ) {
+		double x = x0 + c / gridScale;
+		while ( i + 1 < items.size() && items[i].first < x ) {
+			++i;
+		}
+		grid[c] = i;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+bool TableXY<T>::interpolate(double x, T &y) const {
 	if ( items.size() >= 2 ) {
-		for ( size_t i = 1; i < items.size(); ++i ) {
-			if ( items[i - 1].first <= x && x <= items[i].first ) {
-				double q = (x - items[i - 1].first) / (items[i].first - items[i - 1].first);
-				return q * (items[i].second - items[i - 1].second) + items[i - 1].second;
-			}
+		if ( !(items.front().first <= x && x <= items.back().first) ) {
+			return false;
 		}
+
+		size_t i = 1;
+		if ( !grid.empty() ) {
+			size_t cell = std::min(size_t((x - items.front().first) * gridScale),
+			                       grid.size() - 1);
+			i = std::max(size_t(1), std::min(grid[cell], items.size() - 1));
+		}
+
+		// Search the first item at or behind x. The grid only provides the
+		// start, the steps keep the result correct if the grid is stale.
+		while ( i > 1 && items[i - 1].first >= x ) {
+			--i;
+		}
+		while ( items[i].first < x ) {
+			++i;
+		}
+
+		double q = (x - items[i - 1].first) / (items[i].first - items[i - 1].first);
+		y = q * (items[i].second - items[i - 1].second) + items[i - 1].second;
+		return true;
 	}
 	else if ( items.size() == 1 ) {
 		if ( items[0].first == x ) {
-			return items[0].second;
+			y = items[0].second;
+			return true;
 		}
 	}
 
-	throw std::out_of_range("x out of range");
+	return false;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
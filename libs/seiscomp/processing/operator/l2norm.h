@@ -22,6 +22,9 @@
 #define SEISCOMP_PROCESSING_OPERATOR_L2NORM_H
 
 
+#include <cmath>
+
+
 namespace Seiscomp {
 namespace Processing {
 namespace Operator {
@@ -42,9 +45,11 @@ class L2Norm {
 template <typename T>
 struct L2Norm<T,2> {
 	void operator()(const Record *, T *data[2], int n, const Core::Time &stime, double sfreq) const {
+		T *x = data[0];
+		const T *y = data[1];
+
 		for ( int i = 0; i < n; ++i )
-			data[0][i] = sqrt(data[0][i] * data[0][i] +
-			                  data[1][i] * data[1][i]);
+			x[i] = std::sqrt(x[i]*x[i] + y[i]*y[i]);
 	}
 
 	bool publish(int c) const { return c == 0; }
@@ -56,9 +61,11 @@ struct L2Norm<T,2> {
 template <typename T>
 struct L2Norm<T,3> {
 	void operator()(const Record *, T *data[3], int n, const Core::Time &stime, double sfreq) const {
+		T *x = data[0];
+		const T *y = data[1], *z = data[2];
+
 		for ( int i = 0; i < n; ++i )
-			data[0][i] = sqrt(data[0][i] * data[0][i] +
-			                  data[1][i] * data[1][i]);
+			x[i] = std::sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
 	}
 
 	bool publish(int c) const { return c == 0; }
@@ -26,6 +26,7 @@
 #include <seiscomp/processing/waveformoperator.h>
 #include <seiscomp/core/genericrecord.h>
 #include <seiscomp/core/recordsequence.h>
+#include <seiscomp/math/filter/biquad.h>
 
 
 namespace Seiscomp {
@@ -236,8 +237,13 @@ class FilterWrapper {
 						_filter[i] = _baseFilter->clone();
 						_filter[i]->setSamplingFrequency(sfreq);
 					}
+				}
 
-					_filter[i]->apply(n, data[i]);
+				// Filter all components in one go if the filter is a plain
+				// biquad cascade, e.g. a Butterworth filter
+				if ( !Math::Filtering::IIR::BiquadCascade<T>::applyChannels(N, _filter, n, data) ) {
+					for ( int i = 0; i < N; ++i )
+						_filter[i]->apply(n, data[i]);
 				}
 			}
 
@@ -229,15 +229,9 @@ WaveformProcessor::Status NCompsOperator<T,N,PROC,BSIZE>::process(int, const Rec
 				// Combine the clip masks with OR if available
 				const BitSet *recClipMask = (*rec_it)->clipMask();
 				if ( (recClipMask != nullptr) && recClipMask->any() ) {
-					int ofs = data[i]->size();
-					int nBits = data[i]->size() + len;
 					if ( !clipMask )
-						clipMask = new BitSet(nBits);
-					else if ( (int)clipMask->size() < nBits )
-						clipMask->resize(nBits, false);
-
-					for ( int i = startIndex; i < len; ++i, ++ofs )
-						clipMask->set(ofs, clipMask->test(ofs) || recClipMask->test(i));
+						clipMask = new BitSet;
+					clipMask->orRange(data[i]->size(), *recClipMask, startIndex, len);
 				}
 
 				data[i]->append(len, srcData->typedData()+startIndex);
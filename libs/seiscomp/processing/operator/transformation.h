@@ -54,11 +54,16 @@ struct Transformation<T,2> {
 	void reset() {}
 
 	void operator()(const Record *, T *data[2], int n, const Core::Time &, double) const {
+		// Load the coefficients once and run the components as plain
+		// arrays which lets the compiler vectorize the loop
+		const T m11 = matrix.c._11, m12 = matrix.c._12;
+		const T m21 = matrix.c._21, m22 = matrix.c._22;
+		T *x = data[0], *y = data[1];
+
 		for ( int i = 0; i < n; ++i ) {
-			Math::Vector3<T> v = matrix*Math::Vector3<T>(*data[0], *data[1], 0);
-			*data[0] = v.x;
-			*data[1] = v.y;
-			++data[0]; ++data[1];
+			const T vx = x[i], vy = y[i];
+			x[i] = m11*vx + m12*vy;
+			y[i] = m21*vx + m22*vy;
 		}
 	}
 
@@ -75,12 +80,16 @@ struct Transformation<T,3> {
 	void reset() {}
 
 	void operator()(const Record *, T *data[3], int n, const Core::Time &, double) const {
+		const T m11 = matrix.c._11, m12 = matrix.c._12, m13 = matrix.c._13;
+		const T m21 = matrix.c._21, m22 = matrix.c._22, m23 = matrix.c._23;
+		const T m31 = matrix.c._31, m32 = matrix.c._32, m33 = matrix.c._33;
+		T *x = data[0], *y = data[1], *z = data[2];
+
 		for ( int i = 0; i < n; ++i ) {
-			Math::Vector3<T> v = matrix*Math::Vector3<T>(*data[0], *data[1], *data[2]);
-			*data[0] = v.x;
-			*data[1] = v.y;
-			*data[2] = v.z;
-			++data[0]; ++data[1]; ++data[2];
+			const T vx = x[i], vy = y[i], vz = z[i];
+			x[i] = m11*vx + m12*vy + m13*vz;
+			y[i] = m21*vx + m22*vy + m23*vz;
+			z[i] = m31*vx + m32*vy + m33*vz;
 		}
 	}
 
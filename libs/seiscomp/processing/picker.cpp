@@ -35,6 +35,13 @@ namespace Seiscomp {
 namespace Processing {
 
 IMPLEMENT_SC_ABSTRACT_CLASS_DERIVED(Picker, TimeWindowProcessor, "Picker");
+
+
+namespace {
+
+thread_local Picker::Emissions *deferredEmissions = nullptr;
+
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -151,7 +158,15 @@ void Picker::setPublishFunction(const PublishFunc& func) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Picker::emitPick(const Result &result) {
-	if ( isEnabled() && _func )
+	if ( !isEnabled() || !_func )
+		return;
+
+	if ( deferredEmissions ) {
+		deferredEmissions->push_back({result.time, [this, result]() {
+			if ( _func ) _func(this, result);
+		}});
+	}
+	else
 		_func(this, result);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -159,6 +174,15 @@ void Picker::emitPick(const Result &result) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Picker::deferEmissions(Emissions *emissions) {
+	deferredEmissions = emissions;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Picker::process(const Record *record, const DoubleArray &) {
 	// Sampling frequency has not been set yet
@@ -27,6 +27,9 @@
 #include <seiscomp/client.h>
 #include <boost/function.hpp>
 
+#include <functional>
+#include <vector>
+
 
 namespace Seiscomp {
 namespace Processing {
@@ -73,6 +76,14 @@ class SC_SYSTEM_CLIENT_API Picker : public TimeWindowProcessor {
 		typedef boost::function<void (const Picker*,
 		                              const Result &)> PublishFunc;
 
+		//! A deferred pick and its time
+		struct Emission {
+			Core::Time             time;
+			std::function<void ()> publish;
+		};
+
+		typedef std::vector<Emission> Emissions;
+
 	// ----------------------------------------------------------------------
 	//  X'truction
 	// ----------------------------------------------------------------------
@@ -157,6 +168,12 @@ class SC_SYSTEM_CLIENT_API Picker : public TimeWindowProcessor {
 
 		void setPublishFunction(const PublishFunc& func);
 
+		//! Collects the picks emitted by pickers in the calling thread in
+		//! emissions instead of calling the publish functions directly.
+		//! The caller has to publish them, e.g. in the main thread ordered
+		//! by time. Passing nullptr restores direct publishing.
+		static void deferEmissions(Emissions *emissions);
+
 		//! Dumps the record data into an ASCII file
 		void writeData();
 
@@ -24,6 +24,7 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/processing/picker/araic.h>
 #include <seiscomp/io/records/sacrecord.h>
+#include <seiscomp/math/aic.h>
 
 #include <fstream>
 
@@ -38,121 +39,6 @@ namespace Processing {
 REGISTER_POSTPICKPROCESSOR(ARAICPicker, "AIC");
 
 
-namespace {
-
-
-template<typename TYPE>
-static double
-maeda_aic_snr_const(int n, const TYPE *data, int onset, int margin) {
-	// expects a properly filtered and demeaned trace
-	double snr = 0, noise = 0, signal = 0;
-
-	for ( int i = margin; i < onset; ++i ) {
-		noise += data[i] * data[i];
-	}
-
-	noise = sqrt(noise / (onset-margin));
-
-	for ( int i = onset; i < n-margin; ++i ) {
-		double a = fabs(data[i]);
-		if ( a > signal ) {
-			signal = a;
-		}
-	}
-
-	snr = 0.707 * signal / noise;
-
-	return snr;
-}
-
-
-//
-// AIC repicker using the simple non-AR algorithm of Maeda (1985),
-// see paper of Zhang et al. (2003) in BSSA
-//
-
-template<typename TYPE>
-void maeda_aic(int n, TYPE *data, int &kmin, double &snr, int margin=10) {
-	// expects a properly filtered and demeaned trace
-
-	// square trace in place
-	for ( int i=0; i<n; ++i ) {
-		data[i] = data[i]*data[i];
-	}
-
-	// windowed sum for variance computation
-	double sumwin1 = 0, sumwin2 = 0, minaic = 0;
-	int imin = margin, imax = n-margin;
-	for ( int i = 0; i < n; ++i ) {
-		if ( i < imin )
-			sumwin1 += data[i];
-		else
-			sumwin2 += data[i];
-	}
-	
-	for ( int k = imin; k < imax; ++k ) {
-		double var1 = sumwin1/(k-1),
-		       var2 = sumwin2/(n-k-1);
-		double aic = k*log10(var1) + (n-k-1)*log10(var2);
-
-		sumwin1 += data[k];
-		sumwin2 -= data[k];
-
-		data[k] = aic;
-		if ( k == imin ) minaic = aic;
-		if ( aic < minaic ) {
-			minaic = aic;
-			kmin = k;
-//			snr = sqrt(var2/var1);
-		}
-	}
-
-	double maxaic = data[imin] > data[imax-1] ? data[imin] : data[imax-1];
-
-	for ( int k = 0; k < imin; ++k ) {
-		data[k] = data[n-k-1] = maxaic;
-	}
-	snr = maeda_aic_snr_const(n, data, kmin, margin);
-}
-
-
-template<typename TYPE>
-void maeda_aic_const(int n, const TYPE *data, int &kmin, double &snr, int margin=10) {
-	// expects a properly filtered and demeaned trace
-
-	// windowed sum for variance computation
-	double sumwin1 = 0, sumwin2 = 0, minaic = 0;
-	int imin = margin, imax = n-margin;
-	for ( int i = 0; i < n; ++i ) {
-		TYPE squared = data[i]*data[i];
-		if ( i < imin )
-			sumwin1 += squared;
-		else
-			sumwin2 += squared;
-	}
-	
-	for ( int k = imin; k < imax; ++k ) {
-		double var1 = sumwin1/(k-1),
-		       var2 = sumwin2/(n-k-1);
-		double aic = k*log10(var1) + (n-k-1)*log10(var2);
-		TYPE squared = data[k]*data[k];
-
-		sumwin1 += squared;
-		sumwin2 -= squared;
-
-		if ( (k == imin) || (aic < minaic) ) {
-			minaic = aic;
-			kmin = k;
-		}
-	}
-
-	snr = maeda_aic_snr_const(n, data, kmin, margin);
-}
-
-
-}
-
-
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 ARAICPicker::ARAICPicker() : _dumpTraces(false) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -283,9 +169,18 @@ bool ARAICPicker::calculatePick(int n, const double *data,
 		}
 	}
 
-	triggerIdx = -1;
-	snr = -1;
-	maeda_aic_const(signalEndIdx-signalStartIdx, &tmp[signalStartIdx], triggerIdx, snr);
+	//
+	// AIC repicker using the simple non-AR algorithm of Maeda (1985),
+	// see paper of Zhang et al. (2003) in BSSA
+	//
+	int count = signalEndIdx-signalStartIdx;
+	triggerIdx = Math::maedaAIC(count, &tmp[signalStartIdx]);
+	if ( triggerIdx < 0 ) {
+		SEISCOMP_DEBUG("AIC: no onset in %d samples", count);
+		return false;
+	}
+
+	snr = Math::maedaAICSNR(count, &tmp[signalStartIdx], triggerIdx);
 	triggerIdx += signalStartIdx;
 
 	return true;
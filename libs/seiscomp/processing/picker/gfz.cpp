@@ -22,6 +22,7 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/math/filter/butterworth.h>
 #include <seiscomp/processing/picker/gfz.h>
+#include <seiscomp/processing/sharedfilter.h>
 
 
 using namespace std;
@@ -161,7 +162,7 @@ bool GFZPicker::setup(const Settings &settings) {
 	settings.getValue(_usedFilter, "picker.GFZ.filter");
 	if ( !_usedFilter.empty() ) {
 		string error;
-		Filter *f = Filter::Create(_usedFilter, &error);
+		Filter *f = SharedFilter::Create(_usedFilter, &error);
 		if ( f == nullptr ) {
 			SEISCOMP_ERROR("failed to create filter '%s': %s",
 			               _usedFilter.c_str(), error.c_str());
@@ -24,14 +24,100 @@
 #include <seiscomp/processing/processor.h>
 #include <seiscomp/config/config.h>
 
+#include <array>
+#include <set>
+
 
 using namespace std;
 
 
+#define ROOT_CONFIG_KEY "module."
+
+
 namespace Seiscomp {
 namespace Processing {
 
 
+namespace {
+
+
+using Prefixes = array<string, 3>;
+
+
+// The configuration prefixes of a station in order of precedence
+Prefixes configPrefixes(const string &module, const string &network,
+                        const string &station) {
+	string root = string(ROOT_CONFIG_KEY) + module + ".";
+	return {
+		root + network + "." + station + ".",
+		root + network + ".",
+		root + "global."
+	};
+}
+
+
+bool getConfig(string &value, const Config::Config *config, const string &name) {
+	vector<string> values;
+	if ( !config->getStrings(values, name) )
+		return false;
+
+	value = Core::join(values, ",");
+	return true;
+}
+
+
+bool getConfig(int &value, const Config::Config *config, const string &name) {
+	return config->getInt(value, name);
+}
+
+
+bool getConfig(double &value, const Config::Config *config, const string &name) {
+	return config->getDouble(value, name);
+}
+
+
+bool getConfig(bool &value, const Config::Config *config, const string &name) {
+	return config->getBool(value, name);
+}
+
+
+bool getKey(string &value, const Util::KeyValues *keys, const string &name) {
+	return keys->getString(value, name);
+}
+
+
+bool getKey(int &value, const Util::KeyValues *keys, const string &name) {
+	return keys->getInt(value, name);
+}
+
+
+bool getKey(double &value, const Util::KeyValues *keys, const string &name) {
+	return keys->getDouble(value, name);
+}
+
+
+bool getKey(bool &value, const Util::KeyValues *keys, const string &name) {
+	return keys->getBool(value, name);
+}
+
+
+template <typename T>
+bool lookup(T &value, const Config::Config *config, const Prefixes &prefixes,
+            const Util::KeyValues *keys, const string &parameter) {
+	if ( config != nullptr ) {
+		for ( const string &prefix : prefixes ) {
+			if ( getConfig(value, config, prefix + parameter) )
+				return true;
+		}
+	}
+
+	return keys && getKey(value, keys, parameter);
+}
+
+
+}
+
+
 IMPLEMENT_SC_ABSTRACT_CLASS(Processor, "Processor");
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -68,17 +154,66 @@ Settings::Settings(const string &mod,
                    const string &location,
                    const string &stream,
                    const Config::Config *config,
-                   const Util::KeyValues *keys)
+                   const Util::KeyValues *keys,
+                   const StationSettings *compiled)
 : module(mod), networkCode(network), stationCode(station),
   locationCode(location), channelCode(stream),
-  localConfiguration(config), keyParameters(keys) {}
+  localConfiguration(config), keyParameters(keys),
+  compiledSettings(compiled) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+StationSettings::StationSettings(const string &module,
+                                 const string &network,
+                                 const string &station,
+                                 const Config::Config *config,
+                                 const Util::KeyValues *keys) {
+	Prefixes prefixes = configPrefixes(module, network, station);
+
+	// Collect the names of all parameters which are possibly set for this
+	// station
+	set<string> parameters;
+	if ( config != nullptr ) {
+		Config::SymbolTable *symtab = config->symbolTable();
+		if ( symtab != nullptr ) {
+			for ( auto it = symtab->begin(); it != symtab->end(); ++it ) {
+				const string &name = (*it)->name;
+				for ( const string &prefix : prefixes ) {
+					if ( name.size() > prefix.size() &&
+					     !name.compare(0, prefix.size(), prefix) )
+						parameters.insert(name.substr(prefix.size()));
+				}
+			}
+		}
+	}
+
+	if ( keys != nullptr ) {
+		for ( const auto &item : *keys )
+			parameters.insert(item.first);
+	}
+
+	// Each type is resolved on its own since a value of higher precedence
+	// which cannot be converted must not hide one of lower precedence
+	for ( const string &parameter : parameters ) {
+		Value value;
+		value.hasText = lookup(value.text, config, prefixes, keys, parameter);
+		value.hasInt = lookup(value.intValue, config, prefixes, keys, parameter);
+		value.hasDouble = lookup(value.doubleValue, config, prefixes, keys, parameter);
+		value.hasBool = lookup(value.boolValue, config, prefixes, keys, parameter);
+
+		if ( value.hasText || value.hasInt || value.hasDouble || value.hasBool )
+			_values.emplace(parameter, std::move(value));
+	}
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-#define ROOT_CONFIG_KEY "module."
 string Settings::getString(const string &parameter) const {
 	std::string value;
 	if ( !getValue(value, parameter) )
@@ -128,30 +263,24 @@ bool Settings::getBool(const string &parameter) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Settings::getValue(std::string &value, const std::string &parameter) const {
-	if ( localConfiguration != nullptr ) {
-		std::vector<std::string> values;
-		if ( localConfiguration->getStrings(values, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + stationCode + "." + parameter) ) {
-			value = Core::join(values, ",");
-			return true;
-		}
+	if ( compiledSettings )
+		return compiledSettings->getValue(value, parameter);
+
+	return lookup(value, localConfiguration, configPrefixes(module, networkCode, stationCode),
+	              keyParameters, parameter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		values.clear();
-		if ( localConfiguration->getStrings(values, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + parameter) ) {
-			value = Core::join(values, ",");
-			return true;
-		}
 
-		values.clear();
-		if ( localConfiguration->getStrings(values, string(ROOT_CONFIG_KEY) + module + ".global." + parameter) ) {
-			value = Core::join(values, ",");
-			return true;
-		}
-	}
 
-	if ( keyParameters && keyParameters->getString(value, parameter) )
-		return true;
 
-	return false;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Settings::getValue(int &value, const std::string &parameter) const {
+	if ( compiledSettings )
+		return compiledSettings->getValue(value, parameter);
+
+	return lookup(value, localConfiguration, configPrefixes(module, networkCode, stationCode),
+	              keyParameters, parameter);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -159,22 +288,39 @@ bool Settings::getValue(std::string &value, const std::string &parameter) const
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool Settings::getValue(int &value, const std::string &parameter) const {
-	if ( localConfiguration != nullptr ) {
-		if ( localConfiguration->getInt(value, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + stationCode + "." + parameter) )
-			return true;
+bool Settings::getValue(double &value, const std::string &parameter) const {
+	if ( compiledSettings )
+		return compiledSettings->getValue(value, parameter);
+
+	return lookup(value, localConfiguration, configPrefixes(module, networkCode, stationCode),
+	              keyParameters, parameter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Settings::getValue(bool &value, const std::string &parameter) const {
+	if ( compiledSettings )
+		return compiledSettings->getValue(value, parameter);
+
+	return lookup(value, localConfiguration, configPrefixes(module, networkCode, stationCode),
+	              keyParameters, parameter);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		if ( localConfiguration->getInt(value, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + parameter) )
-			return true;
 
-		if ( localConfiguration->getInt(value, string(ROOT_CONFIG_KEY) + module + ".global." + parameter) )
-			return true;
-	}
 
-	if ( keyParameters && keyParameters->getInt(value, parameter) )
-		return true;
 
-	return false;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool StationSettings::getValue(std::string &value, const std::string &parameter) const {
+	auto it = _values.find(parameter);
+	if ( it == _values.end() || !it->second.hasText )
+		return false;
+
+	value = it->second.text;
+	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -182,22 +328,27 @@ bool Settings::getValue(int &value, const std::string &parameter) const {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool Settings::getValue(double &value, const std::string &parameter) const {
-	if ( localConfiguration != nullptr ) {
-		if ( localConfiguration->getDouble(value, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + stationCode + "." + parameter) )
-			return true;
+bool StationSettings::getValue(int &value, const std::string &parameter) const {
+	auto it = _values.find(parameter);
+	if ( it == _values.end() || !it->second.hasInt )
+		return false;
+
+	value = it->second.intValue;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		if ( localConfiguration->getDouble(value, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + parameter) )
-			return true;
 
-		if ( localConfiguration->getDouble(value, string(ROOT_CONFIG_KEY) + module + ".global." + parameter) )
-			return true;
-	}
 
-	if ( keyParameters && keyParameters->getDouble(value, parameter) )
-		return true;
 
-	return false;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool StationSettings::getValue(double &value, const std::string &parameter) const {
+	auto it = _values.find(parameter);
+	if ( it == _values.end() || !it->second.hasDouble )
+		return false;
+
+	value = it->second.doubleValue;
+	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -205,22 +356,22 @@ bool Settings::getValue(double &value, const std::string &parameter) const {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool Settings::getValue(bool &value, const std::string &parameter) const {
-	if ( localConfiguration != nullptr ) {
-		if ( localConfiguration->getBool(value, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + stationCode + "." + parameter) )
-			return true;
+bool StationSettings::getValue(bool &value, const std::string &parameter) const {
+	auto it = _values.find(parameter);
+	if ( it == _values.end() || !it->second.hasBool )
+		return false;
+
+	value = it->second.boolValue;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		if ( localConfiguration->getBool(value, string(ROOT_CONFIG_KEY) + module + "." + networkCode + "." + parameter) )
-			return true;
 
-		if ( localConfiguration->getBool(value, string(ROOT_CONFIG_KEY) + module + ".global." + parameter) )
-			return true;
-	}
 
-	if ( keyParameters && keyParameters->getBool(value, parameter) )
-		return true;
 
-	return false;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t StationSettings::size() const {
+	return _values.size();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -26,6 +26,8 @@
 #include <seiscomp/utils/keyvalues.h>
 #include <seiscomp/client.h>
 
+#include <unordered_map>
+
 
 namespace Seiscomp {
 
@@ -36,6 +38,58 @@ namespace Config {
 namespace Processing {
 
 
+DEFINE_SMARTPOINTER(StationSettings);
+
+
+/**
+ * @brief The StationSettings class is a compiled snapshot of all processing
+ *        parameters of a station.
+ *
+ * It is built once from the application configuration and the station
+ * bindings. Each parameter found in either of them is resolved for all
+ * supported types with the same precedence as Settings::getValue. A lookup
+ * is then a single hash map access instead of composing and looking up
+ * up to three configuration keys. A snapshot can be shared by all
+ * processors of a station as long as the configuration and the bindings
+ * do not change.
+ */
+class SC_SYSTEM_CLIENT_API StationSettings : public Core::BaseObject {
+	public:
+		StationSettings(const std::string &module,
+		                const std::string &network,
+		                const std::string &station,
+		                const Config::Config *config,
+		                const Util::KeyValues *keys);
+
+	public:
+		//! Returns the value of a parameter. If the parameter is not set or
+		//! cannot be converted to the requested type, false is returned.
+		bool getValue(std::string &value, const std::string &parameter) const;
+		bool getValue(int &value, const std::string &parameter) const;
+		bool getValue(double &value, const std::string &parameter) const;
+		bool getValue(bool &value, const std::string &parameter) const;
+
+		//! Returns the number of compiled parameters
+		size_t size() const;
+
+	private:
+		struct Value {
+			std::string text;
+			int         intValue{0};
+			double      doubleValue{0};
+			bool        boolValue{false};
+			bool        hasText{false};
+			bool        hasInt{false};
+			bool        hasDouble{false};
+			bool        hasBool{false};
+		};
+
+		using Values = std::unordered_map<std::string, Value>;
+
+		Values _values;
+};
+
+
 struct SC_SYSTEM_CLIENT_API Settings {
 	Settings(const std::string &module,
 	         const std::string &network,
@@ -43,7 +97,8 @@ struct SC_SYSTEM_CLIENT_API Settings {
 	         const std::string &location,
 	         const std::string &stream,
 	         const Config::Config *config,
-	         const Util::KeyValues *keys);
+	         const Util::KeyValues *keys,
+	         const StationSettings *compiled = nullptr);
 
 	//! Returns a parameter value for a station. The first
 	//! lookup is in the global application configuration
@@ -64,7 +119,8 @@ struct SC_SYSTEM_CLIENT_API Settings {
 	//! with name "key.module.network.station.parameter.
 	//! If it is not found it tries to lookup the value in
 	//! keyParameters. If no value is found, false is returned,
-	//! true otherwise
+	//! true otherwise. If compiledSettings is set, the value is
+	//! taken from that snapshot instead.
 	bool getValue(std::string &value, const std::string &parameter) const;
 	bool getValue(int &value, const std::string &parameter) const;
 	bool getValue(double &value, const std::string &parameter) const;
@@ -77,6 +133,7 @@ struct SC_SYSTEM_CLIENT_API Settings {
 	const std::string     &channelCode;
 	const Config::Config  *localConfiguration;
 	const Util::KeyValues *keyParameters;
+	const StationSettings *compiledSettings;
 };
 
 
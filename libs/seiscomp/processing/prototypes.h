@@ -0,0 +1,131 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_PROCESSING_PROTOTYPES_H
+#define SEISCOMP_PROCESSING_PROTOTYPES_H
+
+
+#include <seiscomp/processing/amplitudeprocessor.h>
+#include <seiscomp/processing/magnitudeprocessor.h>
+
+#include <map>
+#include <string>
+#include <tuple>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+/**
+ * @brief The ProcessorPrototypes class keeps set up processors per stream
+ *        and type as prototypes and creates new processors by cloning them.
+ *
+ * Creating a processor through its factory and calling setup for each
+ * trigger means parsing the configuration, creating responses and
+ * filters again and again. With prototypes this is done once per stream
+ * and type. The prototypes of a station must be removed if its
+ * configuration or bindings change.
+ *
+ * T must provide type() and clone(). Processors which do not support
+ * cloning are not stored, create then always returns nullptr and the
+ * caller falls back to the factory.
+ */
+template <typename T>
+class ProcessorPrototypes {
+	public:
+		using Pointer = typename Core::SmartPointer<T>::Impl;
+
+
+	public:
+		/**
+		 * @brief Creates a processor from the prototype of a stream.
+		 * @return The new processor or nullptr if no prototype is available
+		 */
+		Pointer create(const std::string &type,
+		               const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) const {
+			auto it = _prototypes.find(Key(networkCode, stationCode, locationCode,
+			                               channelCode, type));
+			if ( it == _prototypes.end() )
+				return nullptr;
+
+			return it->second->clone();
+		}
+
+		/**
+		 * @brief Registers a clone of a set up processor as prototype for a
+		 *        stream. An existing prototype is replaced.
+		 * @param proc The processor which must not have received data yet
+		 * @return false if the processor does not support cloning
+		 */
+		bool add(const T *proc,
+		         const std::string &networkCode,
+		         const std::string &stationCode,
+		         const std::string &locationCode,
+		         const std::string &channelCode) {
+			Pointer prototype = proc->clone();
+			if ( !prototype )
+				return false;
+
+			_prototypes[Key(networkCode, stationCode, locationCode,
+			                channelCode, proc->type())] = prototype;
+			return true;
+		}
+
+		//! Removes all prototypes of a station
+		void remove(const std::string &networkCode, const std::string &stationCode) {
+			auto it = _prototypes.lower_bound(Key(networkCode, stationCode,
+			                                      std::string(), std::string(),
+			                                      std::string()));
+			while ( it != _prototypes.end() &&
+			        std::get<0>(it->first) == networkCode &&
+			        std::get<1>(it->first) == stationCode )
+				it = _prototypes.erase(it);
+		}
+
+		//! Removes all prototypes
+		void clear() { _prototypes.clear(); }
+
+		//! Returns the number of prototypes
+		size_t size() const { return _prototypes.size(); }
+
+
+	private:
+		// Network, station, location, channel and type
+		using Key = std::tuple<std::string, std::string, std::string,
+		                       std::string, std::string>;
+
+		std::map<Key, Pointer> _prototypes;
+};
+
+
+using AmplitudeProcessorPrototypes = ProcessorPrototypes<AmplitudeProcessor>;
+using MagnitudeProcessorPrototypes = ProcessorPrototypes<MagnitudeProcessor>;
+
+
+}
+}
+
+
+#endif
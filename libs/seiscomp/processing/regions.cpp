@@ -48,12 +48,19 @@ std::map<std::string, RegionsPtr> registry;
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Geo::GeoFeature *Regions::find(double lat, double lon) const {
-	for ( Geo::GeoFeature *feature : featureSet.features() ) {
-		if ( feature->contains(Geo::GeoCoordinate(lat, lon)) )
-			return feature;
+	// Feature sets which were not set up with load() are not indexed
+	if ( _index.size() != featureSet.features().size() ) {
+		for ( Geo::GeoFeature *feature : featureSet.features() ) {
+			if ( feature->contains(Geo::GeoCoordinate(lat, lon)) )
+				return feature;
+		}
+
+		return nullptr;
 	}
 
-	return nullptr;
+	return const_cast<Geo::GeoFeature*>(
+		_index.findFirst(Geo::GeoCoordinate(lat, lon))
+	);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -130,12 +137,12 @@ bool Regions::contains(const Geo::GeoFeature *feature,
 		return false;
 	}
 
-	if ( !feature->contains(Geo::GeoCoordinate(lat0, lon0)) ) {
+	if ( !contains(feature, lat0, lon0) ) {
 		return false;
 	}
 
 	if ( samplingDistance <= 0.0 ) {
-		return feature->contains(Geo::GeoCoordinate(lat1, lon1));
+		return contains(feature, lat1, lon1);
 	}
 
 	Math::Geo::delazi_wgs84(lat0, lon0, lat1, lon1, &dist, &az, &baz);
@@ -151,7 +158,7 @@ bool Regions::contains(const Geo::GeoFeature *feature,
 			lat0, lon0, &lat1, &lon1
 		);
 
-		if ( !feature->contains(Geo::GeoCoordinate(lat1, lon1)) ) {
+		if ( !contains(feature, lat1, lon1) ) {
 			return false;
 		}
 	}
@@ -163,6 +170,25 @@ bool Regions::contains(const Geo::GeoFeature *feature,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Regions::contains(const Geo::GeoFeature *feature, double lat, double lon) {
+	Geo::GeoCoordinate gc(lat, lon);
+	const Geo::GeoBoundingBox &bbox = feature->bbox();
+
+	// Features without bounding box are tested directly
+	if ( !bbox.isEmpty() ) {
+		Geo::GeoCoordinate ngc(gc);
+		if ( !bbox.contains(ngc.normalize()) )
+			return false;
+	}
+
+	return feature->contains(gc);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 const Regions *Regions::load(const std::string &filename) {
 	std::lock_guard<std::mutex> l(registryMutex);
@@ -176,6 +202,8 @@ const Regions *Regions::load(const std::string &filename) {
 		return nullptr;
 	}
 
+	regions->_index.add(regions->featureSet);
+
 	registry[filename] = regions;
 	return regions.get();
 }
@@ -27,6 +27,7 @@
 
 #include <seiscomp/config/config.h>
 #include <seiscomp/geo/featureset.h>
+#include <seiscomp/geo/index/featureindex.h>
 
 
 namespace Seiscomp {
@@ -92,10 +93,26 @@ class Regions : public Core::BaseObject {
 		                     double lat1, double lon1,
 		                     double samplingDistance = 10);
 
+		/**
+		 * @brief Checks whether a point is contained in a given feature.
+		 *        The polygon is only tested if the bounding box of the
+		 *        feature contains the point.
+		 * @param feature The feature to test again.
+		 * @param lat The latitude of the point
+		 * @param lon The longitude of the point
+		 * @return true if contained, false otherwise
+		 */
+		static bool contains(const Geo::GeoFeature *feature,
+		                     double lat, double lon);
+
 		static const Regions *load(const std::string& filename);
 
 	public:
 		Geo::GeoFeatureSet featureSet;
+
+	private:
+		//! The spatial index of featureSet which is built by load()
+		Geo::GeoFeatureIndex _index;
 };
 
 
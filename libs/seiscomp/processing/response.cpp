@@ -21,6 +21,15 @@
 
 #include <seiscomp/processing/response.h>
 #include <seiscomp/math/restitution/fft.h>
+#include <seiscomp/datamodel/responsefap.h>
+#include <seiscomp/datamodel/responsepaz.h>
+
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 
 namespace Seiscomp {
@@ -30,6 +39,177 @@ namespace Processing  {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+typedef std::vector<Math::Complex> Coefficients;
+typedef std::shared_ptr<const Coefficients> CoefficientsCPtr;
+
+
+struct CacheKey {
+	std::string publicID;
+	int         numberOfIntegrations;
+	int         n;
+	double      startFreq;
+	double      df;
+
+	bool operator<(const CacheKey &other) const {
+		return std::tie(publicID, numberOfIntegrations, n, startFreq, df) <
+		       std::tie(other.publicID, other.numberOfIntegrations,
+		                other.n, other.startFreq, other.df);
+	}
+};
+
+
+// Observes the data model to drop the coefficients of inventory responses
+// that are modified or removed, e.g. by applied notifiers.
+class ResponseCache : public DataModel::Observer {
+	public:
+		ResponseCache() {
+			DataModel::Object::RegisterObserver(this);
+		}
+
+	public:
+		CoefficientsCPtr get(const CacheKey &key) {
+			std::lock_guard<std::mutex> l(_mutex);
+			auto it = _lookup.find(key);
+			if ( it == _lookup.end() )
+				return nullptr;
+
+			// Move to the front of the usage list
+			_entries.splice(_entries.begin(), _entries, it->second);
+			return it->second->second;
+		}
+
+		void put(const CacheKey &key, const CoefficientsCPtr &coeffs) {
+			std::lock_guard<std::mutex> l(_mutex);
+			size_t bytes = coeffs->size() * sizeof(Math::Complex);
+			if ( bytes > _capacity || _lookup.find(key) != _lookup.end() )
+				return;
+
+			_entries.emplace_front(key, coeffs);
+			_lookup[key] = _entries.begin();
+			_size += bytes;
+			trim();
+		}
+
+		void setCapacity(size_t bytes) {
+			std::lock_guard<std::mutex> l(_mutex);
+			_capacity = bytes;
+			trim();
+		}
+
+		size_t capacity() {
+			std::lock_guard<std::mutex> l(_mutex);
+			return _capacity;
+		}
+
+		void clear() {
+			std::lock_guard<std::mutex> l(_mutex);
+			_entries.clear();
+			_lookup.clear();
+			_size = 0;
+		}
+
+	protected:
+		void onObjectRemoved(DataModel::Object *, DataModel::Object *child) override {
+			invalidate(child);
+		}
+
+		void onObjectModified(DataModel::Object *object) override {
+			invalidate(object);
+		}
+
+	private:
+		void invalidate(const DataModel::Object *object) {
+			// Only these responses are resolved with a public ID
+			const DataModel::PublicObject *response = DataModel::ResponsePAZ::ConstCast(object);
+			if ( !response ) response = DataModel::ResponseFAP::ConstCast(object);
+			if ( !response ) return;
+
+			std::lock_guard<std::mutex> l(_mutex);
+			// Entries are ordered by the public ID first
+			auto it = _lookup.lower_bound(CacheKey{response->publicID(), std::numeric_limits<int>::min(), 0, 0, 0});
+			while ( it != _lookup.end() && it->first.publicID == response->publicID() ) {
+				_size -= it->second->second->size() * sizeof(Math::Complex);
+				_entries.erase(it->second);
+				it = _lookup.erase(it);
+			}
+		}
+
+		void trim() {
+			while ( _size > _capacity ) {
+				_size -= _entries.back().second->size() * sizeof(Math::Complex);
+				_lookup.erase(_entries.back().first);
+				_entries.pop_back();
+			}
+		}
+
+	private:
+		typedef std::list<std::pair<CacheKey, CoefficientsCPtr>> Entries;
+
+		std::mutex                            _mutex;
+		Entries                               _entries;
+		std::map<CacheKey, Entries::iterator> _lookup;
+		size_t                                _capacity{32*1024*1024};
+		size_t                                _size{0};
+};
+
+
+ResponseCache &responseCache() {
+	static ResponseCache cache;
+	return cache;
+}
+
+
+// Deconvolves with coefficients that are evaluated once per frequency
+// sampling and shared through the response cache.
+class CachedTransferFunction : public Math::Restitution::FFT::TransferFunction {
+	public:
+		CachedTransferFunction(Math::Restitution::FFT::TransferFunction *tf,
+		                       const std::string &publicID,
+		                       int numberOfIntegrations)
+		: _tf(tf), _publicID(publicID)
+		, _numberOfIntegrations(numberOfIntegrations) {}
+
+	protected:
+		void evaluate_(Math::Complex *out, int n, const double *x) const override {
+			_tf->evaluate(out, n, x);
+		}
+
+		void deconvolve_(int n, Math::Complex *spec, double startFreq, double df) const override {
+			CacheKey key{_publicID, _numberOfIntegrations, n, startFreq, df};
+			CoefficientsCPtr coeffs = responseCache().get(key);
+			if ( !coeffs ) {
+				auto tmp = std::make_shared<Coefficients>(n, Math::Complex(1.0, 0.0));
+				_tf->deconvolve(n, tmp->data(), startFreq, df);
+				coeffs = tmp;
+				responseCache().put(key, coeffs);
+			}
+
+			const Math::Complex *c = coeffs->data();
+			for ( int i = 0; i < n; ++i )
+				spec[i] *= c[i];
+		}
+
+		void convolve_(int n, Math::Complex *spec, double startFreq, double df) const override {
+			_tf->convolve(n, spec, startFreq, df);
+		}
+
+	private:
+		Math::Restitution::FFT::TransferFunctionPtr _tf;
+		std::string                                 _publicID;
+		int                                         _numberOfIntegrations;
+};
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Response::Response() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -50,7 +230,7 @@ bool Response::deconvolveFFT(int n, float *inout, double fsamp,
                              double min_freq, double max_freq,
                              int numberOfIntegrations) {
 	Math::Restitution::FFT::TransferFunctionPtr tf =
-		getTransferFunction(numberOfIntegrations);
+		getCachedTransferFunction(numberOfIntegrations);
 	if ( !tf )
 		return false;
 
@@ -68,7 +248,7 @@ bool Response::deconvolveFFT(int n, double *inout, double fsamp,
                              double min_freq, double max_freq,
                              int numberOfIntegrations) {
 	Math::Restitution::FFT::TransferFunctionPtr tf =
-		getTransferFunction(numberOfIntegrations);
+		getCachedTransferFunction(numberOfIntegrations);
 	if ( !tf )
 		return false;
 
@@ -116,6 +296,66 @@ Response::getTransferFunction(int numberOfIntegrations) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Math::Restitution::FFT::TransferFunction *
+Response::getCachedTransferFunction(int numberOfIntegrations) {
+	Math::Restitution::FFT::TransferFunction *tf =
+		getTransferFunction(numberOfIntegrations);
+	if ( !tf || _publicID.empty() )
+		return tf;
+
+	return new CachedTransferFunction(tf, _publicID, numberOfIntegrations);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Response::setPublicID(const std::string &publicID) {
+	_publicID = publicID;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &Response::publicID() const {
+	return _publicID;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Response::setCacheCapacity(size_t bytes) {
+	responseCache().setCapacity(bytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t Response::cacheCapacity() {
+	return responseCache().capacity();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Response::clearCache() {
+	responseCache().clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 ResponsePAZ::ResponsePAZ() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
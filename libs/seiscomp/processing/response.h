@@ -28,6 +28,7 @@
 #include <seiscomp/math/filter/seismometers.h>
 #include <seiscomp/client.h>
 
+#include <string>
 #include <vector>
 
 
@@ -85,6 +86,44 @@ class SC_SYSTEM_CLIENT_API Response : public Core::BaseObject {
 		//!                             additional zeros to 'zeros'.
 		virtual Math::Restitution::FFT::TransferFunction *
 			getTransferFunction(int numberOfIntegrations = 0);
+
+		//! Returns the transfer function of getTransferFunction whose
+		//! deconvolution coefficients are kept in a process wide cache
+		//! keyed by the public ID, the number of integrations and the
+		//! frequency sampling. Processors created again for the same
+		//! stream and time window length reuse the coefficients. Without
+		//! a public ID the plain transfer function is returned.
+		Math::Restitution::FFT::TransferFunction *
+			getCachedTransferFunction(int numberOfIntegrations = 0);
+
+
+	// ----------------------------------------------------------------------
+	//  Public attributes
+	// ----------------------------------------------------------------------
+	public:
+		//! Sets the public ID of the inventory response this object was
+		//! created from. An empty ID disables caching.
+		void setPublicID(const std::string &publicID);
+		const std::string &publicID() const;
+
+		//! Sets the maximum number of bytes used by the cache of all
+		//! responses. Least recently used entries are evicted first and
+		//! a capacity of 0 disables the cache. The default is 32 MiB.
+		static void setCacheCapacity(size_t bytes);
+		static size_t cacheCapacity();
+
+		//! Removes all cached coefficients. Coefficients of PAZ and FAP
+		//! responses that are modified or removed in the data model are
+		//! dropped automatically and Client::Inventory clears the cache if
+		//! its inventory is replaced.
+		static void clearCache();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		std::string _publicID;
 };
 
 
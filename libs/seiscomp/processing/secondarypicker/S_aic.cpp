@@ -22,6 +22,7 @@
 
 #include <seiscomp/logging/log.h>
 #include <seiscomp/processing/operator/ncomps.h>
+#include <seiscomp/math/aic.h>
 #include <seiscomp/math/filter.h>
 
 #include "S_aic.h"
@@ -35,56 +36,10 @@ namespace Processing {
 
 namespace {
 
-template<typename TYPE>
-double
-maeda_aic_snr_const(int n, const TYPE *data, int onset, int margin) {
+void maeda_aic(int n, const double *data, int &kmin, double &snr, int margin=10) {
 	// expects a properly filtered and demeaned trace
-	double snr=0, noise=0, signal=0;
-	for (int i=margin; i<onset; i++)
-		noise += data[i]*data[i];
-	noise = sqrt(noise/(onset-margin));
-	for (int i=onset; i<n-margin; i++) {
-		double a=fabs(data[i]);
-		if (a>signal) signal=a;
-	}
-	snr = 0.707*signal/noise;
-
-	return snr;
-}
-
-
-template<typename TYPE>
-void
-maeda_aic(int n, const TYPE *data, int &kmin, double &snr, int margin=10) {
-	// expects a properly filtered and demeaned trace
-
-	// windowed sum for variance computation
-	double sumwin1 = 0, sumwin2 = 0, minaic = 0;
-	int imin = margin, imax = n-margin;
-	for ( int i = 0; i < n; ++i ) {
-		TYPE squared = data[i]*data[i];
-		if ( i < imin )
-			sumwin1 += squared;
-		else
-			sumwin2 += squared;
-	}
-
-	for ( int k = imin; k < imax; ++k ) {
-		double var1 = sumwin1/(k-1),
-		       var2 = sumwin2/(n-k-1);
-		double aic = k*log10(var1) + (n-k-1)*log10(var2);
-		TYPE squared = data[k]*data[k];
-
-		sumwin1 += squared;
-		sumwin2 -= squared;
-
-		if ( (k == imin) || (aic < minaic) ) {
-			minaic = aic;
-			kmin = k;
-		}
-	}
-
-	snr = maeda_aic_snr_const(n, data, kmin, margin);
+	kmin = Math::maedaAIC(n, data, margin);
+	snr = kmin >= 0 ? Math::maedaAICSNR(n, data, kmin, margin) : 0;
 }
 
 }
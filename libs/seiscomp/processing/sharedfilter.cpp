@@ -0,0 +1,317 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT SharedFilter
+
+#include <seiscomp/processing/sharedfilter.h>
+#include <seiscomp/logging/log.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Processing {
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct SharedFilter::Stage {
+	explicit Stage(Math::Filtering::InPlaceFilter<double> *f) : filter(f) {}
+
+	// Filters the block starting at sample pos if it is the next one or
+	// copies the output if the same block has been filtered last. The last
+	// block is only kept if other consumers may still request it.
+	bool apply(size_t pos, int n, double *data, bool keep) {
+		std::lock_guard<std::mutex> l(mutex);
+
+		if ( pos == position ) {
+			keep = keep || !pos;
+			if ( keep )
+				lastInput.assign(data, data + n);
+
+			filter->apply(n, data);
+
+			if ( keep ) {
+				lastOutput.assign(data, data + n);
+				lastStart = pos;
+			}
+			else
+				lastStart = std::numeric_limits<size_t>::max();
+
+			position += n;
+			return true;
+		}
+
+		if ( pos == lastStart && static_cast<size_t>(n) == lastOutput.size()
+		  && std::equal(data, data + n, lastInput.begin()) ) {
+			std::copy(lastOutput.begin(), lastOutput.end(), data);
+			return true;
+		}
+
+		return false;
+	}
+
+	std::mutex                                              mutex;
+	std::unique_ptr<Math::Filtering::InPlaceFilter<double>> filter;
+	size_t                                                  position{0};
+	size_t                                                  lastStart{std::numeric_limits<size_t>::max()};
+	std::vector<double>                                     lastInput;
+	std::vector<double>                                     lastOutput;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+struct StageKey {
+	std::string id;
+	std::string streamID;
+	double      fsamp;
+	Core::Time  startTime;
+
+	bool operator<(const StageKey &other) const {
+		return std::tie(id, streamID, fsamp, startTime) <
+		       std::tie(other.id, other.streamID, other.fsamp, other.startTime);
+	}
+};
+
+
+template <typename STAGE>
+class StageRegistry {
+	public:
+		// Applies the first block of a consumer to a matching stage or to
+		// a new one created by the factory and returns the stage.
+		template <typename FACTORY>
+		std::shared_ptr<STAGE> attach(const StageKey &key, int n, double *data,
+		                              const FACTORY &factory) {
+			std::lock_guard<std::mutex> l(_mutex);
+
+			auto range = _stages.equal_range(key);
+			for ( auto it = range.first; it != range.second; ) {
+				std::shared_ptr<STAGE> stage = it->second.lock();
+				if ( !stage ) {
+					it = _stages.erase(it);
+					continue;
+				}
+
+				if ( stage->apply(0, n, data, true) )
+					return stage;
+
+				++it;
+			}
+
+			std::shared_ptr<STAGE> stage = std::make_shared<STAGE>(factory());
+			stage->apply(0, n, data, true);
+			_stages.emplace(key, stage);
+			return stage;
+		}
+
+	private:
+		std::mutex                                         _mutex;
+		std::multimap<StageKey, std::weak_ptr<STAGE>>      _stages;
+};
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedFilter::SharedFilter(const std::string &id,
+                           Math::Filtering::InPlaceFilter<double> *filter)
+: _id(id), _prototype(filter), _fsamp(0), _position(0) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedFilter::~SharedFilter() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedFilter *SharedFilter::Create(const std::string &filter,
+                                   std::string *errorMessage) {
+	Math::Filtering::InPlaceFilter<double> *f =
+		Math::Filtering::InPlaceFilter<double>::Create(filter, errorMessage);
+	if ( !f ) return nullptr;
+	return new SharedFilter(filter, f);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &SharedFilter::id() const {
+	return _id;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedFilter::isShared() const {
+	return _stage && _stage.use_count() > 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedFilter::setStartTime(const Core::Time &time) {
+	_startTime = time;
+	if ( _private ) _private->setStartTime(time);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedFilter::setStreamID(const std::string &net,
+                               const std::string &sta,
+                               const std::string &loc,
+                               const std::string &cha) {
+	_streamID[0] = net;
+	_streamID[1] = sta;
+	_streamID[2] = loc;
+	_streamID[3] = cha;
+	if ( _private ) _private->setStreamID(net, sta, loc, cha);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedFilter::setSamplingFrequency(double fsamp) {
+	_fsamp = fsamp;
+	if ( _private ) _private->setSamplingFrequency(fsamp);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int SharedFilter::setParameters(int, const double *) {
+	// The parameters are part of the shared filter
+	return 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedFilter::apply(int n, double *inout) {
+	if ( n <= 0 ) return;
+
+	if ( !_private ) {
+		if ( !_stage ) {
+			static StageRegistry<Stage> registry;
+
+			StageKey key{
+				_id,
+				_streamID[0] + "." + _streamID[1] + "." + _streamID[2] + "." + _streamID[3],
+				_fsamp, _startTime
+			};
+
+			_stage = registry.attach(key, n, inout, [this]() { return createFilter(); });
+			_position += n;
+			return;
+		}
+
+		if ( _stage->apply(_position, n, inout, _stage.use_count() > 1) ) {
+			_position += n;
+			return;
+		}
+
+		SEISCOMP_DEBUG("%s.%s.%s.%s: filter '%s' diverged from shared stage, "
+		               "restarting", _streamID[0].c_str(), _streamID[1].c_str(),
+		               _streamID[2].c_str(), _streamID[3].c_str(), _id.c_str());
+		_stage = nullptr;
+		startPrivate();
+	}
+
+	_private->apply(n, inout);
+	_position += n;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Math::Filtering::InPlaceFilter<double> *SharedFilter::clone() const {
+	return new SharedFilter(_id, _prototype->clone());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Math::Filtering::InPlaceFilter<double> *SharedFilter::createFilter() const {
+	Math::Filtering::InPlaceFilter<double> *filter = _prototype->clone();
+	if ( _fsamp > 0 )
+		filter->setSamplingFrequency(_fsamp);
+	if ( _startTime.valid() )
+		filter->setStartTime(_startTime);
+	filter->setStreamID(_streamID[0], _streamID[1], _streamID[2], _streamID[3]);
+	return filter;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedFilter::startPrivate() {
+	_private.reset(createFilter());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
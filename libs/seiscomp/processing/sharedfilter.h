@@ -0,0 +1,132 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_PROCESSING_SHAREDFILTER_H
+#define SEISCOMP_PROCESSING_SHAREDFILTER_H
+
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/math/filter.h>
+#include <seiscomp/client.h>
+
+#include <memory>
+#include <string>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+/**
+ * @brief The SharedFilter class lets processors on the same stream share
+ *        the output of identical filters.
+ *
+ * All shared filters with the same id, stream ID, sampling frequency and
+ * start time that receive the same data attach to one filter stage. The
+ * first consumer that applies a block runs the stage filter, the others
+ * copy its output, so that e.g. several amplitude processors created for
+ * the same pick filter each record only once. The stage is reference
+ * counted and released with its last consumer.
+ *
+ * A consumer that receives other data than the stage, e.g. because of a
+ * different gap handling, continues with a private filter which starts
+ * from scratch. A consumer that cannot join a stage with its first block
+ * uses a private filter right away and behaves exactly like the wrapped
+ * filter.
+ */
+class SC_SYSTEM_CLIENT_API SharedFilter : public Math::Filtering::InPlaceFilter<double> {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! C'tor
+		//! @param id The identifier of the filter configuration. Filters
+		//!           with equal ids must produce equal output.
+		//! @param filter The filter to share which is managed by this
+		//!               instance
+		SharedFilter(const std::string &id, Math::Filtering::InPlaceFilter<double> *filter);
+
+		//! D'tor
+		~SharedFilter() override;
+
+		//! Creates a shared filter from a filter string as accepted by
+		//! InPlaceFilter::Create using the string as id.
+		static SharedFilter *Create(const std::string &filter,
+		                            std::string *errorMessage = nullptr);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		const std::string &id() const;
+
+		//! Returns whether the filter output is shared with a stage
+		bool isShared() const;
+
+
+	// ----------------------------------------------------------------------
+	//  InPlaceFilter interface
+	// ----------------------------------------------------------------------
+	public:
+		void setStartTime(const Core::Time &time) override;
+		void setStreamID(const std::string &net,
+		                 const std::string &sta,
+		                 const std::string &loc,
+		                 const std::string &cha) override;
+		void setSamplingFrequency(double fsamp) override;
+		int setParameters(int n, const double *params) override;
+
+		void apply(int n, double *inout) override;
+
+		Math::Filtering::InPlaceFilter<double> *clone() const override;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		Math::Filtering::InPlaceFilter<double> *createFilter() const;
+		void startPrivate();
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Stage;
+
+		std::string                                             _id;
+		std::unique_ptr<Math::Filtering::InPlaceFilter<double>> _prototype;
+		std::unique_ptr<Math::Filtering::InPlaceFilter<double>> _private;
+		std::shared_ptr<Stage>                                  _stage;
+		std::string                                             _streamID[4];
+		Core::Time                                              _startTime;
+		double                                                  _fsamp;
+		size_t                                                  _position;
+};
+
+
+}
+}
+
+
+#endif
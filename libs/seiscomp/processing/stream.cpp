@@ -27,11 +27,152 @@
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <mutex>
+#include <unordered_map>
 
 
 namespace Seiscomp {
 namespace Processing  {
+
+
+namespace {
+
+
+/**
+ * Caches the resolved meta data of streams of the inventory of
+ * Client::Inventory by stream ID and epoch start. The cache observes all
+ * objects and is cleared if an object of the inventory is updated or
+ * removed or if the inventory is destroyed. Adding objects, e.g. loading
+ * instruments on demand, only drops the entries without a sensor response
+ * which might be resolved now.
+ */
+class StreamCache : public DataModel::Observer {
+	public:
+		StreamCache() : _inventory(nullptr) {
+			DataModel::Object::RegisterObserver(this);
+		}
+
+	public:
+		bool get(const DataModel::Stream *stream, Stream &target) {
+			std::string key;
+			const DataModel::Inventory *inv = makeKey(stream, key);
+			if ( !inv ) return false;
+
+			std::lock_guard<std::mutex> lk(_mutex);
+			if ( _inventory != inv ) return false;
+
+			auto it = _entries.find(key);
+			if ( it == _entries.end() ) return false;
+			target = *it->second;
+			return true;
+		}
+
+		void put(const DataModel::Stream *stream, const Stream &source) {
+			std::string key;
+			const DataModel::Inventory *inv = makeKey(stream, key);
+			if ( !inv ) return;
+
+			std::lock_guard<std::mutex> lk(_mutex);
+			if ( _inventory != inv ) {
+				_entries.clear();
+				_inventory = inv;
+			}
+
+			_entries[key] = new Stream(source);
+		}
+
+		void clear() {
+			std::lock_guard<std::mutex> lk(_mutex);
+			_entries.clear();
+		}
+
+	protected:
+		void onObjectAdded(DataModel::Object *parent, DataModel::Object *) override {
+			if ( !belongsToInventory(parent) ) return;
+
+			std::lock_guard<std::mutex> lk(_mutex);
+			for ( auto it = _entries.begin(); it != _entries.end(); ) {
+				Sensor *sensor = it->second->sensor();
+				if ( !sensor || !sensor->response() )
+					it = _entries.erase(it);
+				else
+					++it;
+			}
+		}
+
+		void onObjectRemoved(DataModel::Object *parent, DataModel::Object *) override {
+			if ( belongsToInventory(parent) ) clear();
+		}
+
+		void onObjectModified(DataModel::Object *object) override {
+			if ( belongsToInventory(object) ) clear();
+		}
+
+		void onObjectDestroyed(DataModel::Object *object) override {
+			// Called for every object, the derived part is gone already
+			if ( object != _inventory.load() ) return;
+
+			std::lock_guard<std::mutex> lk(_mutex);
+			_entries.clear();
+			_inventory = nullptr;
+		}
+
+	private:
+		// Returns the inventory of the stream if it is the inventory of
+		// Client::Inventory and sets key
+		static const DataModel::Inventory *makeKey(const DataModel::Stream *stream,
+		                                           std::string &key) {
+			Client::Inventory *client = Client::Inventory::Instance();
+			if ( !client || !client->inventory() ) return nullptr;
+
+			const DataModel::SensorLocation *loc = stream->sensorLocation();
+			const DataModel::Station *sta = loc ? loc->station() : nullptr;
+			const DataModel::Network *net = sta ? sta->network() : nullptr;
+			const DataModel::Inventory *inv = net ? net->inventory() : nullptr;
+			if ( !inv || inv != client->inventory() ) return nullptr;
+
+			key = net->code();
+			key += '.';
+			key += sta->code();
+			key += '.';
+			key += loc->code();
+			key += '.';
+			key += stream->code();
+			key += '/';
+			key += stream->start().iso();
+			return inv;
+		}
+
+		bool belongsToInventory(const DataModel::Object *object) const {
+			const DataModel::Object *inv = _inventory.load();
+			if ( !inv ) return false;
+
+			while ( object ) {
+				if ( object == inv ) return true;
+				object = object->parent();
+			}
+
+			return false;
+		}
+
+	private:
+		std::unordered_map<std::string, StreamPtr> _entries;
+		std::atomic<const DataModel::Object*>       _inventory;
+		std::mutex                                  _mutex;
+};
+
+
+StreamCache &streamCache() {
+	// Created on demand to not depend on the initialization order of the
+	// observer registry
+	static StreamCache cache;
+	return cache;
+}
+
+
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -50,6 +191,26 @@ Stream::Stream() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Stream::init(const DataModel::Stream *stream) {
+	if ( streamCache().get(stream, *this) ) return;
+	resolve(stream);
+	streamCache().put(stream, *this);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Stream::ClearCache() {
+	streamCache().clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Stream::resolve(const DataModel::Stream *stream) {
 	gain = 0.0;
 	gainFrequency = Core::None;
 	gainUnit = std::string();
@@ -87,6 +248,9 @@ void Stream::init(const DataModel::Stream *stream) {
 		dip = 999;
 	}
 
+	// Fetch the instruments if the inventory has been loaded without them
+	Client::Inventory::Instance()->loadInstruments(stream);
+
 	DataModel::Sensor *sensor = DataModel::Sensor::Find(stream->sensor());
 	if ( sensor ) {
 		Math::Restitution::FFT::TransferFunctionPtr tf;
@@ -113,6 +277,7 @@ void Stream::init(const DataModel::Stream *stream) {
 			}
 			else {
 				ResponsePAZPtr proc_response = new ResponsePAZ;
+				proc_response->setPublicID(paz->publicID());
 				try { proc_response->setNormalizationFactor(paz->normalizationFactor()); } catch ( ... ) {}
 				try { proc_response->setNormalizationFrequency(paz->normalizationFrequency()); } catch ( ... ) {}
 				try { proc_response->setPoles(paz->poles().content()); } catch ( ... ) {}
@@ -135,6 +300,7 @@ void Stream::init(const DataModel::Stream *stream) {
 			DataModel::ResponseFAP *fap = DataModel::ResponseFAP::Find(sensor->response());
 			if ( fap ) {
 				ResponseFAPPtr proc_response = new ResponseFAP;
+				proc_response->setPublicID(fap->publicID());
 
 				try {
 					sensorGainFrequency = fap->gainFrequency();
@@ -60,8 +60,17 @@ class SC_SYSTEM_CLIENT_API Stream : public Core::BaseObject {
 		          const std::string &channelCode,
 		          const Core::Time &time);
 
+		//! Initializes the stream meta data from an inventory stream.
+		//! The meta data of streams of the inventory of Client::Inventory
+		//! are cached by stream ID and epoch and shared with all streams
+		//! initialized later from the same epoch, including the sensor and
+		//! its response. The cache is cleared if an object of this
+		//! inventory is updated or removed, e.g. by notifiers.
 		void init(const DataModel::Stream *stream);
 
+		//! Clears the cached stream meta data
+		static void ClearCache();
+
 		void setCode(const std::string &code);
 		const std::string &code() const;
 
@@ -87,6 +96,13 @@ class SC_SYSTEM_CLIENT_API Stream : public Core::BaseObject {
 		double      dip;
 
 
+	// ----------------------------------------------------------------------
+	//  Private interface
+	// ----------------------------------------------------------------------
+	private:
+		void resolve(const DataModel::Stream *stream);
+
+
 	// ----------------------------------------------------------------------
 	//  Members
 	// ----------------------------------------------------------------------
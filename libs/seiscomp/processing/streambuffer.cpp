@@ -19,7 +19,9 @@
 
 
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 #include <seiscomp/processing/streambuffer.h>
 
 
@@ -96,9 +98,27 @@ void StreamBuffer::setTimeSpan(const Seiscomp::Core::TimeSpan& timeSpan) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence* StreamBuffer::sequence(const WaveformID& wid) const {
-	SequenceMap::const_iterator it = _sequences.find(wid);
-	if ( it != _sequences.end() )
+	// Streams which were never registered cannot be part of the buffer
+	StreamKey key = StreamKey::Find(wid.networkCode, wid.stationCode,
+	                                wid.locationCode, wid.channelCode);
+	if ( !key.isValid() )
+		return nullptr;
+
+	return sequence(key);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence* StreamBuffer::sequence(const StreamKey &key) const {
+	SequenceMap::const_iterator it = _sequences.find(key);
+	if ( it != _sequences.end() ) {
+		it->second->restore();
 		return it->second;
+	}
 	return nullptr;
 }
 
@@ -115,8 +135,8 @@ RecordSequence* StreamBuffer::feed(const Record *rec) {
 		return nullptr;
 	}
 
-	WaveformID wid(rec);
-	RecordSequence *seq = sequence(wid);
+	StreamKey key = rec->streamKey();
+	RecordSequence *seq = sequence(key);
 
 	if ( !seq ) {
 		switch ( _mode ) {
@@ -128,7 +148,8 @@ RecordSequence* StreamBuffer::feed(const Record *rec) {
 				break;
 		}
 
-		_sequences[wid] = seq;
+		seq->setEvictable(true);
+		_sequences[key] = seq;
 		_newStreamAdded = true;
 	}
 
@@ -154,16 +175,20 @@ bool StreamBuffer::addedNewStream() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void StreamBuffer::printStreams(std::ostream& os) const {
+	std::vector<std::pair<std::string, RecordSequence*>> streams;
+	streams.reserve(_sequences.size());
+
 	for ( SequenceMap::const_iterator it = _sequences.begin();
-	      it != _sequences.end(); ++it ) {
-		os << "["
-		          << it->first.networkCode << "."
-		          << it->first.stationCode << "."
-		          << it->first.locationCode << "."
-		          << it->first.channelCode << "] "
-		          << it->second->timeWindow().startTime().toString("%F %T") << " - "
-		          << it->second->timeWindow().endTime().toString("%F %T")
-		          << std::endl;
+	      it != _sequences.end(); ++it )
+		streams.emplace_back(it->first.toString(), it->second);
+
+	std::sort(streams.begin(), streams.end());
+
+	for ( const auto &item : streams ) {
+		os << "[" << item.first << "] "
+		   << item.second->timeWindow().startTime().toString("%F %T") << " - "
+		   << item.second->timeWindow().endTime().toString("%F %T")
+		   << std::endl;
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -177,15 +202,10 @@ std::list<std::string> StreamBuffer::getStreams() const {
 	std::list<std::string> streamList;
 
 	for ( SequenceMap::const_iterator it = _sequences.begin();
-	      it != _sequences.end(); ++it ) {
-		
-		streamList.push_back(
-		              it->first.networkCode + "."
-		            + it->first.stationCode + "."
-		            + it->first.locationCode + "."
-		            + it->first.channelCode
-		);
-	}
+	      it != _sequences.end(); ++it )
+		streamList.push_back(it->first.toString());
+
+	streamList.sort();
 
 	return streamList;
 }
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <list>
+#include <unordered_map>
 
 #include <seiscomp/core/recordsequence.h>
 #include <seiscomp/client.h>
@@ -33,6 +34,11 @@ namespace Seiscomp {
 namespace Processing {
 
 
+/**
+ * Buffers the records of many streams in one sequence per stream. The
+ * sequences are evictable by the WaveformMemory budget, sequence() and
+ * feed() restore evicted records before the sequence is returned.
+ */
 class SC_SYSTEM_CLIENT_API StreamBuffer {
 	// ----------------------------------------------------------------------
 	//  Public Types
@@ -99,11 +105,13 @@ class SC_SYSTEM_CLIENT_API StreamBuffer {
 		void setTimeSpan(const Core::TimeSpan &timeSpan);
 
 		RecordSequence *sequence(const WaveformID &wid) const;
+		RecordSequence *sequence(const StreamKey &key) const;
 		RecordSequence *feed(const Record *rec);
 
 		bool addedNewStream() const;
 
 		void printStreams(std::ostream &os = std::cout) const;
+		//! Returns all stream ids in lexicographical order
 		std::list<std::string> getStreams() const;
 
 		//! Clears the streambuffer and removes all cached records
@@ -119,7 +127,7 @@ class SC_SYSTEM_CLIENT_API StreamBuffer {
 			RING_BUFFER
 		};
 
-		using SequenceMap = std::map<WaveformID, RecordSequence*>;
+		using SequenceMap = std::unordered_map<StreamKey, RecordSequence*>;
 
 		Mode                     _mode;
 		Seiscomp::Core::Time     _timeStart;
@@ -0,0 +1,365 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/processing/templatedetector.h>
+#include <seiscomp/math/filter.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+IMPLEMENT_SC_CLASS_DERIVED(TemplateDetector, Detector, "TemplateDetector");
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+TemplateDetector::TemplateDetector(double initTime)
+: Detector(initTime)
+, _threshold(0.7)
+, _blockSize(1024)
+, _fftn(0)
+, _maxLength(0)
+, _consumed(0) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool TemplateDetector::addTemplate(const std::string &id,
+                                   const DoubleArray &data,
+                                   const Core::TimeSpan &offset) {
+	if ( data.size() < 2 ) return false;
+
+	Template tpl;
+	tpl.id = id;
+	tpl.offset = offset;
+	tpl.triggered = false;
+	tpl.peak = 0;
+	tpl.data.assign(data.typedData(), data.typedData() + data.size());
+
+	double mean = 0;
+	for ( double v : tpl.data ) mean += v;
+	mean /= tpl.data.size();
+
+	double norm = 0;
+	for ( double &v : tpl.data ) {
+		v -= mean;
+		norm += v*v;
+	}
+
+	if ( norm <= 0 ) return false;
+
+	norm = sqrt(norm);
+	for ( double &v : tpl.data ) v /= norm;
+
+	_templates.push_back(tpl);
+	_fftn = 0;
+	reset();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::clearTemplates() {
+	_templates.clear();
+	_fftn = 0;
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t TemplateDetector::templateCount() const {
+	return _templates.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::setThreshold(double threshold) {
+	_threshold = threshold;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double TemplateDetector::threshold() const {
+	return _threshold;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::setBlockSize(size_t samples) {
+	_blockSize = std::max(samples, size_t(1));
+	_fftn = 0;
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t TemplateDetector::blockSize() const {
+	return _blockSize;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::setDetectionFunction(const DetectionFunc &func) {
+	_detectionFunc = func;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const std::string &TemplateDetector::methodID() const {
+	static std::string methodID = "TemplateMatching";
+	return methodID;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::reset() {
+	Detector::reset();
+	_buffer.clear();
+	_startTime = Core::Time();
+	_consumed = 0;
+
+	for ( Template &tpl : _templates )
+		tpl.triggered = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::prepare() {
+	_maxLength = 0;
+	for ( const Template &tpl : _templates )
+		_maxLength = std::max(_maxLength, tpl.data.size());
+
+	// Each block yields fftn - maxLength + 1 correlation values
+	_fftn = Math::Filtering::next_power_of_2(
+		std::max(_blockSize + _maxLength - 1, 2 * _maxLength)
+	);
+
+	// The templates are zero padded to the transform length
+	std::vector<std::vector<double>> padded(_templates.size());
+	std::vector<const double*> data(_templates.size());
+	for ( size_t i = 0; i < _templates.size(); ++i ) {
+		padded[i] = _templates[i].data;
+		padded[i].resize(_fftn, 0.0);
+		data[i] = padded[i].data();
+	}
+
+	std::vector<Math::ComplexArray> spectra;
+	Math::fft(spectra, _templates.size(), _fftn, data.data());
+	for ( size_t i = 0; i < _templates.size(); ++i )
+		_templates[i].spectrum.swap(spectra[i]);
+
+	_block.resize(_fftn);
+	_correlations.resize(_templates.size() * _fftn);
+	_sums.resize(_fftn + 1);
+	_squaredSums.resize(_fftn + 1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::process(const Record *record, const DoubleArray &filteredData) {
+	if ( _templates.empty() ) return;
+	if ( !_fftn ) prepare();
+
+	size_t n = filteredData.size();
+
+	int startIndex = 0;
+	if ( !_stream.initialized )
+		startIndex = std::max(0, int(n) - int(_stream.receivedSamples - _stream.neededSamples));
+
+	Core::Time startTime = record->startTime() + Core::TimeSpan(startIndex / _stream.fsamp);
+
+	// Records which do not continue the buffered samples, e.g. after an
+	// interpolated gap, start a new sequence
+	if ( _startTime.valid() ) {
+		Core::Time expected = sampleTime(_buffer.size());
+		if ( fabs(double(startTime - expected)) > 0.5 / _stream.fsamp ) {
+			_buffer.clear();
+			_startTime = Core::Time();
+			for ( Template &tpl : _templates )
+				tpl.triggered = false;
+		}
+	}
+
+	if ( !_startTime.valid() ) {
+		_startTime = startTime;
+		_consumed = 0;
+	}
+
+	_buffer.insert(_buffer.end(), filteredData.typedData() + startIndex,
+	               filteredData.typedData() + n);
+
+	while ( _buffer.size() >= size_t(_fftn) )
+		correlate(record);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::correlate(const Record *record) {
+	size_t outputs = _fftn - _maxLength + 1;
+	size_t count = _templates.size();
+
+	// The mean is removed to keep the sums below precise. It does not
+	// change the correlation with the zero mean templates.
+	double mean = 0;
+	for ( int i = 0; i < _fftn; ++i ) mean += _buffer[i];
+	mean /= _fftn;
+
+	_sums[0] = _squaredSums[0] = 0;
+	for ( int i = 0; i < _fftn; ++i ) {
+		double v = _buffer[i] - mean;
+		_block[i] = v;
+		_sums[i+1] = _sums[i] + v;
+		_squaredSums[i+1] = _squaredSums[i] + v*v;
+	}
+
+	Math::ComplexArray blockSpectrum;
+	Math::fft(blockSpectrum, _fftn, _block.data());
+
+	// The built-in transform packs the Nyquist coefficient into the
+	// imaginary part of the first bin
+	bool packed = blockSpectrum.size() == size_t(_fftn / 2);
+
+	_spectra.resize(count);
+	std::vector<double*> out(count);
+
+	for ( size_t t = 0; t < count; ++t ) {
+		const Math::ComplexArray &tpl = _templates[t].spectrum;
+		Math::ComplexArray &spec = _spectra[t];
+		spec.resize(blockSpectrum.size());
+
+		size_t i = 0;
+		if ( packed ) {
+			spec[0] = Math::Complex(blockSpectrum[0].real() * tpl[0].real(),
+			                        blockSpectrum[0].imag() * tpl[0].imag());
+			i = 1;
+		}
+
+		for ( ; i < spec.size(); ++i )
+			spec[i] = blockSpectrum[i] * std::conj(tpl[i]);
+
+		out[t] = &_correlations[t * _fftn];
+	}
+
+	Math::ifft(int(count), _fftn, out.data(), _spectra);
+
+	for ( size_t t = 0; t < count; ++t ) {
+		Template &tpl = _templates[t];
+		const double *cc = out[t];
+		size_t m = tpl.data.size();
+
+		for ( size_t k = 0; k < outputs; ++k ) {
+			double sum = _sums[k+m] - _sums[k];
+			double var = _squaredSums[k+m] - _squaredSums[k] - sum * sum / m;
+			double coeff = var > 0 ? cc[k] / sqrt(var) : 0;
+
+			if ( coeff >= _threshold ) {
+				if ( !tpl.triggered || coeff > tpl.peak ) {
+					tpl.triggered = true;
+					tpl.peak = coeff;
+					tpl.peakTime = sampleTime(k);
+				}
+			}
+			else if ( tpl.triggered ) {
+				tpl.triggered = false;
+
+				Detection detection;
+				detection.templateID = tpl.id;
+				detection.time = tpl.peakTime + tpl.offset;
+				detection.coefficient = tpl.peak;
+				emitDetection(record, detection);
+			}
+		}
+	}
+
+	_buffer.erase(_buffer.begin(), _buffer.begin() + outputs);
+	_consumed += outputs;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::Time TemplateDetector::sampleTime(size_t index) const {
+	// Computed from the start to not accumulate rounding errors
+	return _startTime + Core::TimeSpan((_consumed + index) / _stream.fsamp);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TemplateDetector::emitDetection(const Record *record,
+                                     const Detection &detection) {
+	if ( isEnabled() && _detectionFunc )
+		_detectionFunc(this, record, detection);
+
+	emitPick(record, detection.time);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
@@ -0,0 +1,178 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_PROCESSING_TEMPLATEDETECTOR_H
+#define SEISCOMP_PROCESSING_TEMPLATEDETECTOR_H
+
+
+#include <seiscomp/processing/detector.h>
+#include <seiscomp/math/fft.h>
+
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+DEFINE_SMARTPOINTER(TemplateDetector);
+
+/**
+ * @brief The TemplateDetector class detects signals which are similar to
+ *        a set of event templates by normalized cross-correlation.
+ *
+ * The continuous (filtered) stream is correlated with all templates in the
+ * frequency domain using overlap-save. Each block is transformed once and
+ * shared by all templates, the correlations are transformed back in one
+ * batch. The number of samples processed per block is at least the
+ * configured block size, larger blocks reduce the cost per sample but
+ * delay the detections.
+ *
+ * A detection is emitted at the maximum correlation coefficient of each
+ * excursion above the threshold. Its time is the time of the first
+ * template sample plus the template offset, e.g. the offset of the pick
+ * within the template. Detections are passed to the detection function
+ * and as picks to the publish function of the Detector.
+ *
+ * Templates must have the sampling frequency of the stream and be
+ * filtered with the same filter as the processor.
+ */
+class SC_SYSTEM_CLIENT_API TemplateDetector : public Detector {
+	DECLARE_SC_CLASS(TemplateDetector)
+
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		struct Detection {
+			std::string templateID;
+			Core::Time  time;
+			double      coefficient;
+		};
+
+		typedef boost::function<void (const TemplateDetector*, const Record*,
+		                              const Detection&)> DetectionFunc;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		TemplateDetector(double initTime = 0.0);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Adds a template. This resets the processor.
+		 * @param id The template identifier which is reported with the
+		 *           detections
+		 * @param data The template samples
+		 * @param offset The offset added to the time of the first template
+		 *               sample to form the detection time
+		 * @return false if the template is shorter than two samples or
+		 *         constant
+		 */
+		bool addTemplate(const std::string &id, const DoubleArray &data,
+		                 const Core::TimeSpan &offset = Core::TimeSpan(0,0));
+
+		//! Removes all templates. This resets the processor.
+		void clearTemplates();
+
+		size_t templateCount() const;
+
+		//! Sets the correlation coefficient which must be exceeded for a
+		//! detection, default is 0.7
+		void setThreshold(double threshold);
+		double threshold() const;
+
+		//! Sets the minimum number of samples correlated per block,
+		//! default is 1024. This resets the processor.
+		void setBlockSize(size_t samples);
+		size_t blockSize() const;
+
+		void setDetectionFunction(const DetectionFunc &func);
+
+		const std::string &methodID() const override;
+
+		void reset() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Protected interface
+	// ----------------------------------------------------------------------
+	protected:
+		void process(const Record *record, const DoubleArray &filteredData) override;
+
+		//! Called for each detection, the default implementation calls
+		//! the detection function and emitPick
+		virtual void emitDetection(const Record *record, const Detection &detection);
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods and members
+	// ----------------------------------------------------------------------
+	private:
+		struct Template {
+			std::string         id;
+			std::vector<double> data; // Zero mean and unit norm
+			Core::TimeSpan      offset;
+			Math::ComplexArray  spectrum;
+			bool                triggered;
+			double              peak;
+			Core::Time          peakTime;
+		};
+
+		void prepare();
+		void correlate(const Record *record);
+		Core::Time sampleTime(size_t index) const;
+
+		std::vector<Template>           _templates;
+		double                          _threshold;
+		size_t                          _blockSize;
+		DetectionFunc                   _detectionFunc;
+
+		// The transform length and the maximum template length, zero if
+		// the spectra of the templates must be computed
+		int                             _fftn;
+		size_t                          _maxLength;
+
+		// The samples which have not been correlated with all templates yet
+		// and the number of samples correlated before since the start time
+		std::vector<double>             _buffer;
+		Core::Time                      _startTime;
+		size_t                          _consumed;
+
+		std::vector<double>             _block;
+		std::vector<Math::ComplexArray> _spectra;
+		std::vector<double>             _correlations;
+		std::vector<double>             _sums;
+		std::vector<double>             _squaredSums;
+};
+
+
+}
+}
+
+
+#endif
@@ -52,6 +52,10 @@ class SC_SYSTEM_CLIENT_API TimeWindowProcessor : public WaveformProcessor {
 	public:
 		void reset() override;
 
+		//! Returns false: the processor works on a bounded time window
+		//! which is fed again after a restart
+		bool hasSerializableState() const override;
+
 		//! Sets the time window for the data to be fed
 		void setTimeWindow(const Core::TimeWindow &tw);
 		const Core::TimeWindow &timeWindow() const;
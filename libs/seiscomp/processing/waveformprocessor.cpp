@@ -22,6 +22,7 @@
 
 #include <seiscomp/processing/waveformprocessor.h>
 #include <seiscomp/processing/waveformoperator.h>
+#include <seiscomp/core/genericrecord.h>
 #include <seiscomp/logging/log.h>
 
 #include <functional>
@@ -40,7 +41,7 @@ IMPLEMENT_SC_ABSTRACT_CLASS(WaveformProcessor, "WaveformProcessor");
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 WaveformProcessor::StreamState::StreamState()
 : lastSample(0), neededSamples(0), receivedSamples(0), initialized(false),
-  fsamp(0.0), filter(nullptr) {
+  restored(false), fsamp(0.0), filter(nullptr) {
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -74,6 +75,31 @@ WaveformProcessor::WaveformProcessor(const Core::TimeSpan &initTime,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+WaveformProcessor::WaveformProcessor(const WaveformProcessor &other)
+: Processor(other)
+, _enabled(other._enabled)
+, _initTime(other._initTime)
+, _gapThreshold(other._gapThreshold)
+, _gapTolerance(other._gapTolerance)
+, _enableSaturationCheck(other._enableSaturationCheck)
+, _saturationThreshold(other._saturationThreshold)
+, _enableGapInterpolation(other._enableGapInterpolation)
+, _gapInterpolator(other._gapInterpolator.strategy())
+, _usedComponent(other._usedComponent)
+, _status(other._status)
+, _statusValue(other._statusValue) {
+	for ( int i = 0; i < 3; ++i )
+		_streamConfig[i] = other._streamConfig[i];
+
+	if ( other._stream.filter != nullptr )
+		_stream.filter = other._stream.filter->clone();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 WaveformProcessor::~WaveformProcessor() {
 	close();
@@ -147,6 +173,7 @@ void WaveformProcessor::reset() {
 	Filter *tmp = _stream.filter;
 
 	_stream = StreamState();
+	_gapInterpolator.reset();
 
 	if ( _operator ) _operator->reset();
 
@@ -192,6 +219,24 @@ bool WaveformProcessor::isGapInterpolationEnabled() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformProcessor::setGapInterpolationStrategy(GapInterpolator::Strategy strategy) {
+	_gapInterpolator.setStrategy(strategy);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+GapInterpolator::Strategy WaveformProcessor::gapInterpolationStrategy() const {
+	return _gapInterpolator.strategy();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void WaveformProcessor::setSaturationCheckEnabled(bool enable) {
 	_enableSaturationCheck = enable;
@@ -294,7 +339,14 @@ bool WaveformProcessor::store(const Record *record) {
 			Core::TimeSpan gap = record->startTime() - _stream.dataTimeWindow.endTime() - Core::TimeSpan(0,1);
 			double gapSecs = (double)gap;
 
-			if ( gap > _gapThreshold ) {
+			if ( _stream.restored && gap > _gapThreshold && gap > _gapTolerance ) {
+				// A restored state is only continued by the data which
+				// follows it, otherwise start from scratch
+				SEISCOMP_DEBUG("[%s] restored state does not continue with the data: reset",
+				               record->streamID().c_str());
+				reset();
+			}
+			else if ( gap > _gapThreshold ) {
 				size_t gapsize = static_cast<size_t>(ceil(_stream.fsamp * gapSecs));
 				bool handled = handleGap(_stream.filter, gap, _stream.lastSample, (*arr)[0], gapsize);
 				if ( handled )
@@ -343,6 +395,9 @@ bool WaveformProcessor::store(const Record *record) {
 	}
 	_stream.lastSample = (*arr)[arr->size()-1];
 
+	if ( _gapInterpolator.needsHistory() )
+		_gapInterpolator.feed(arr->size(), arr->typedData());
+
 	// Fill the values and do the actual filtering
 	fill(arr->size(), arr->typedData());
 	if ( _status > InProgress ) return false;
@@ -362,6 +417,7 @@ bool WaveformProcessor::store(const Record *record) {
 	}
 
 	_stream.lastRecord = record;
+	_stream.restored = false;
 
 	return true;
 }
@@ -430,13 +486,12 @@ bool WaveformProcessor::handleGap(Filter *filter, const Core::TimeSpan& span,
                                   size_t missingSamples) {
 	if ( span <= _gapTolerance ) {
 		if ( _enableGapInterpolation ) {
-			double delta = nextSample - lastSample;
-			double step = 1./(double)(missingSamples+1);
-			double di = step;
-			for ( size_t i = 0; i < missingSamples; ++i, di += step ) {
-				double value = lastSample + di*delta;
-				fill(1, &value);
-			}
+			// The samples are filled in blocks and pass the filter which
+			// continues without being reset
+			_gapInterpolator.interpolate(
+				missingSamples, lastSample, nextSample,
+				[this](size_t n, double *samples) { fill(n, samples); }
+			);
 			return true;
 		}
 	}
@@ -597,6 +652,92 @@ bool WaveformProcessor::parseSaturationThreshold(const Settings &settings,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool WaveformProcessor::hasSerializableState() const {
+	if ( _operator ) return false;
+	return !_stream.filter || _stream.filter->hasSerializableState();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WaveformProcessor::serialize(Archive &ar) {
+	// Without a received record there is nothing but the configuration
+	double fsamp = _stream.lastRecord ? _stream.fsamp : 0.0;
+	ar & NAMED_OBJECT("fsamp", fsamp);
+
+	if ( ar.isReading() ) {
+		reset();
+		if ( fsamp <= 0 ) return;
+
+		try {
+			setupStream(fsamp);
+		}
+		catch ( std::exception &e ) {
+			SEISCOMP_WARNING("restore state: setup stream: %s", e.what());
+			ar.setValidity(false);
+			return;
+		}
+	}
+	else if ( fsamp <= 0 )
+		return;
+
+	int64_t receivedSamples = static_cast<int64_t>(_stream.receivedSamples);
+	Core::Time startTime = _stream.dataTimeWindow.startTime();
+	Core::Time endTime = _stream.dataTimeWindow.endTime();
+
+	ar & NAMED_OBJECT("receivedSamples", receivedSamples);
+	ar & NAMED_OBJECT("initialized", _stream.initialized);
+	ar & NAMED_OBJECT("lastSample", _stream.lastSample);
+	ar & NAMED_OBJECT("startTime", startTime);
+	ar & NAMED_OBJECT("endTime", endTime);
+
+	// The last record including its data is kept to check the continuity
+	// of the next record and for derived classes which access it
+	GenericRecordPtr lastRecord;
+	if ( ar.isReading() )
+		lastRecord = new GenericRecord;
+	else {
+		lastRecord = new GenericRecord(*_stream.lastRecord);
+		lastRecord->setData(_stream.lastRecord->data()->copy(_stream.lastRecord->data()->dataType()));
+	}
+
+	ar & NAMED_OBJECT("lastRecord", *lastRecord);
+
+	if ( ar.isReading() ) {
+		if ( !ar.success() || lastRecord->samplingFrequency() != fsamp ) {
+			ar.setValidity(false);
+			reset();
+			return;
+		}
+
+		_stream.receivedSamples = static_cast<size_t>(receivedSamples);
+		_stream.dataTimeWindow = Core::TimeWindow(startTime, endTime);
+		_stream.lastRecord = lastRecord;
+		_stream.restored = true;
+
+		if ( _stream.filter ) {
+			_stream.filter->setStartTime(startTime);
+			_stream.filter->setStreamID(lastRecord->networkCode(), lastRecord->stationCode(),
+			                            lastRecord->locationCode(), lastRecord->channelCode());
+		}
+	}
+
+	if ( _stream.filter )
+		_stream.filter->serialize(ar);
+
+	_gapInterpolator.serialize(ar);
+
+	if ( ar.isReading() && !ar.success() )
+		reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void WaveformProcessor::setupStream(double fsamp) {
 	const Core::TimeSpan minGapThres(2 * 1.0 / fsamp);
@@ -609,6 +750,12 @@ void WaveformProcessor::setupStream(double fsamp) {
 		_gapThreshold = minGapThres;
 	}
 
+	// Keep enough samples to mirror the longest tolerated gap
+	if ( _enableGapInterpolation && _gapInterpolator.strategy() == GapInterpolator::Mirror )
+		_gapInterpolator.setHistoryLength(static_cast<size_t>(ceil(fsamp * (double)_gapTolerance)) + 1);
+	else
+		_gapInterpolator.setHistoryLength(0);
+
 	initFilter(fsamp);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -27,6 +27,7 @@
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/core/enumeration.h>
 #include <seiscomp/math/filter.h>
+#include <seiscomp/processing/gapinterpolator.h>
 #include <seiscomp/processing/processor.h>
 #include <seiscomp/processing/stream.h>
 
@@ -193,6 +194,14 @@ class SC_SYSTEM_CLIENT_API WaveformProcessor : public Processor {
 		//! D'tor
 		virtual ~WaveformProcessor();
 
+	protected:
+		//! Copies the configuration and the stream setup of another
+		//! processor but not its data state. The filter is cloned, an
+		//! operator is not copied. This is meant to be used by clone
+		//! implementations of derived classes.
+		WaveformProcessor(const WaveformProcessor &other);
+		WaveformProcessor &operator=(const WaveformProcessor &) = delete;
+
 
 	// ----------------------------------------------------------------------
 	//  Public interface
@@ -259,6 +268,12 @@ class SC_SYSTEM_CLIENT_API WaveformProcessor : public Processor {
 		void setGapInterpolationEnabled(bool enable);
 		bool isGapInterpolationEnabled() const;
 
+		//! Sets how missing samples are interpolated if gap interpolation
+		//! is enabled. Must be set before the first record is fed.
+		//! Default: Linear
+		void setGapInterpolationStrategy(GapInterpolator::Strategy strategy);
+		GapInterpolator::Strategy gapInterpolationStrategy() const;
+
 		//! Enables saturation check of absolute values of incoming samples and
 		//! sets the status to DataClipped if checked positive. The data
 		//! is checked in the fill method. If derived classes reimplement
@@ -315,6 +330,31 @@ class SC_SYSTEM_CLIENT_API WaveformProcessor : public Processor {
 		//! are going to be fed in. The processing has been finished.
 		virtual void close() const;
 
+		//! Returns whether the data state can be checkpointed with
+		//! serialize. This requires that no operator is set and that the
+		//! filter, if any, has a serializable state. Derived classes
+		//! with additional state which is not serialized must return
+		//! false.
+		virtual bool hasSerializableState() const;
+
+		/**
+		 * @brief Writes or restores the data state of the processor.
+		 *
+		 * The state consists of the stream state, the last record, the
+		 * filter state and the gap interpolation history. It allows to
+		 * continue processing after a restart without initializing again
+		 * if the next record follows the last record. After a gap larger
+		 * than the gap tolerance the processor starts from scratch,
+		 * records which have already been processed are skipped. The
+		 * configuration is not part of the state and must be set up
+		 * before the state is restored.
+		 * Derived classes with additional state reimplement this method
+		 * and call this implementation first. The filter states are
+		 * written one after another which requires a sequential archive
+		 * such as IO::BinaryArchive.
+		 */
+		void serialize(Archive &ar) override;
+
 
 	// ----------------------------------------------------------------------
 	//  Protected interface
@@ -365,6 +405,9 @@ class SC_SYSTEM_CLIENT_API WaveformProcessor : public Processor {
 			size_t            receivedSamples;
 			//! Initialization state
 			bool              initialized;
+			//! Whether the state has been restored and not yet been
+			//! continued by a record
+			bool              restored;
 
 			//! The last received record on this component
 			RecordCPtr        lastRecord;
@@ -392,6 +435,7 @@ class SC_SYSTEM_CLIENT_API WaveformProcessor : public Processor {
 
 		//! default: false
 		bool                        _enableGapInterpolation;
+		GapInterpolator             _gapInterpolator;
 
 		StreamState                 _stream;
 
@@ -0,0 +1,341 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/qc/qcprocessor_combined.h>
+
+#include <cmath>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+namespace {
+
+
+// The loops use four independent accumulators which allows the compiler to
+// vectorize them without relaxing the floating point semantics
+
+double sum(const double *data, size_t n) {
+	double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+
+	for ( ; i + 4 <= n; i += 4 ) {
+		s0 += data[i];
+		s1 += data[i+1];
+		s2 += data[i+2];
+		s3 += data[i+3];
+	}
+
+	for ( ; i < n; ++i )
+		s0 += data[i];
+
+	return (s0 + s1) + (s2 + s3);
+}
+
+
+double squaredDeviations(const double *data, size_t n, double mean,
+                         double &maxDeviation) {
+	double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	double m0 = 0, m1 = 0, m2 = 0, m3 = 0;
+	size_t i = 0;
+
+	for ( ; i + 4 <= n; i += 4 ) {
+		double d0 = data[i] - mean;
+		double d1 = data[i+1] - mean;
+		double d2 = data[i+2] - mean;
+		double d3 = data[i+3] - mean;
+		s0 += d0*d0;
+		s1 += d1*d1;
+		s2 += d2*d2;
+		s3 += d3*d3;
+		m0 = d0 > m0 ? d0 : m0;
+		m1 = d1 > m1 ? d1 : m1;
+		m2 = d2 > m2 ? d2 : m2;
+		m3 = d3 > m3 ? d3 : m3;
+	}
+
+	for ( ; i < n; ++i ) {
+		double d = data[i] - mean;
+		s0 += d*d;
+		m0 = d > m0 ? d : m0;
+	}
+
+	m0 = m0 > m1 ? m0 : m1;
+	m2 = m2 > m3 ? m2 : m3;
+	maxDeviation = m0 > m2 ? m0 : m2;
+
+	return (s0 + s1) + (s2 + s3);
+}
+
+
+}
+
+
+IMPLEMENT_SC_CLASS_DERIVED(QcProcessorCombined, QcProcessor, "QcProcessorCombined");
+
+
+QcProcessorCombined::QcProcessorCombined()
+: QcProcessor(), _outageThreshold(1800) {
+	for ( int i = 0; i < ParameterCount; ++i )
+		_enabled[i] = true;
+
+	_lastRecordArrivalTime = Core::Time::GMT();
+}
+
+
+void QcProcessorCombined::setEnabled(Parameter parameter, bool enable) {
+	_enabled[parameter] = enable;
+}
+
+
+bool QcProcessorCombined::isEnabled(Parameter parameter) const {
+	return _enabled[parameter];
+}
+
+
+void QcProcessorCombined::setOutageThreshold(int threshold) {
+	_outageThreshold = threshold;
+}
+
+
+QcParameter *QcProcessorCombined::getState(Parameter parameter) const {
+	return _results[parameter].get();
+}
+
+
+QcParameter *QcProcessorCombined::createParameter(Parameter parameter,
+                                                  const Record *record) {
+	QcParameter *qcp = new QcParameter;
+	qcp->recordStartTime = record->startTime();
+	qcp->recordEndTime = record->endTime();
+	qcp->recordSamplingFrequency = record->samplingFrequency();
+	_results[parameter] = qcp;
+	return qcp;
+}
+
+
+bool QcProcessorCombined::setState(const Record *record, const DoubleArray &data) {
+	for ( int i = 0; i < ParameterCount; ++i )
+		_results[i] = nullptr;
+
+	double fsamp = record->samplingFrequency();
+	bool valid = false;
+
+	if ( _enabled[Availability] ) {
+		createParameter(Availability, record)->parameter = 0;
+		valid = true;
+	}
+
+	if ( _enabled[Delay] ) {
+		createParameter(Delay, record)->parameter = (double)(Core::Time::GMT() - record->endTime());
+		valid = true;
+	}
+
+	if ( _enabled[Latency] ) {
+		Core::Time now = Core::Time::GMT();
+		QcParameter *qcp = createParameter(Latency, record);
+		qcp->recordStartTime = now;
+		qcp->recordEndTime = now;
+		qcp->parameter = (double)(now - _lastRecordArrivalTime);
+		_lastRecordArrivalTime = now;
+		valid = true;
+	}
+
+	if ( _stream.lastRecord ) {
+		try {
+			Core::Time lastRecEnd = _stream.lastRecord->endTime();
+			Core::Time curRecStart = record->startTime();
+			double diff = (double)(curRecStart - lastRecEnd);
+
+			if ( _enabled[Gap] && diff >= (0.5 / fsamp) ) {
+				createParameter(Gap, record)->parameter = diff;
+				valid = true;
+			}
+
+			if ( _enabled[Overlap] && diff < (-0.5 / fsamp) ) {
+				createParameter(Overlap, record)->parameter = -1.0*diff;
+				valid = true;
+			}
+
+			if ( _enabled[Outage] ) {
+				double outage = 0.0;
+
+				// Handle out-of-order records
+				if ( _recent < lastRecEnd ) {
+					outage = diff;
+					_recent = lastRecEnd;
+				}
+				else if ( _recent < curRecStart )
+					outage = (double)(curRecStart - _recent);
+
+				if ( outage >= _outageThreshold ) {
+					createParameter(Outage, record)->parameter = outage;
+					valid = true;
+				}
+			}
+		}
+		catch ( Core::ValueException & ) {}
+	}
+
+	if ( _enabled[Timing] ) {
+		const IO::MSeedRecord *mrec = IO::MSeedRecord::ConstCast(record);
+		if ( mrec && (double)mrec->timingQuality() != -1 ) {
+			createParameter(Timing, record)->parameter = (double)mrec->timingQuality();
+			valid = true;
+		}
+	}
+
+	if ( !_enabled[Mean] && !_enabled[Rms] && !_enabled[Spike] )
+		return valid;
+
+	const double *samples = data.typedData();
+	int size = data.size();
+	double maxDeviation;
+	double mean = sum(samples, size) / size;
+	double rms = sqrt(squaredDeviations(samples, size, mean, maxDeviation) / size);
+
+	if ( _enabled[Mean] ) {
+		createParameter(Mean, record)->parameter = mean;
+		valid = true;
+	}
+
+	if ( _enabled[Rms] ) {
+		createParameter(Rms, record)->parameter = rms;
+		valid = true;
+	}
+
+	// Spikes exceed the mean by five times the rms, the sample scan is
+	// skipped for the vast majority of records which cannot contain one
+	if ( _enabled[Spike] && size >= 3 && maxDeviation > 5.0*rms ) {
+		QcProcessorSpike::Spikes spikes;
+		double previous = _stream.lastSample;
+		int last_i = (int)(-fsamp/2 - 1);
+
+		for ( int i = 0; i < size; ++i ) {
+			if ( i != 0 ) previous = samples[i-1];
+
+			double p1, p2;
+			if ( i < size - 1 ) {
+				p1 = (previous-mean) - (samples[i]-mean);
+				p2 = (samples[i]-mean) - (samples[i+1]-mean);
+			}
+			else
+				p1 = p2 = 0.0;
+
+			if ( p1*p2 < -1e6 && (samples[i]-mean) > 5.0*rms && (i - last_i) > (int)(fsamp/2) ) {
+				spikes[record->startTime() + Core::TimeSpan((double)(i/fsamp))] = samples[i];
+				last_i = i;
+			}
+		}
+
+		if ( !spikes.empty() ) {
+			createParameter(Spike, record)->parameter = spikes;
+			valid = true;
+		}
+	}
+
+	return valid;
+}
+
+
+double QcProcessorCombined::getDouble(Parameter parameter) const {
+	if ( !_results[parameter] )
+		throw Core::ValueException("no data");
+
+	try {
+		return boost::any_cast<double>(_results[parameter]->parameter);
+	}
+	catch ( const boost::bad_any_cast & ) {
+		throw Core::ValueException("no data");
+	}
+}
+
+
+double QcProcessorCombined::getAvailability() const {
+	if ( !_results[Availability] )
+		throw Core::ValueException("no data");
+
+	try {
+		return boost::any_cast<int>(_results[Availability]->parameter);
+	}
+	catch ( const boost::bad_any_cast & ) {
+		throw Core::ValueException("no data");
+	}
+}
+
+
+double QcProcessorCombined::getDelay() const {
+	return getDouble(Delay);
+}
+
+
+double QcProcessorCombined::getGap() const {
+	return getDouble(Gap);
+}
+
+
+double QcProcessorCombined::getLatency() const {
+	return getDouble(Latency);
+}
+
+
+double QcProcessorCombined::getMean() const {
+	return getDouble(Mean);
+}
+
+
+double QcProcessorCombined::getOutage() const {
+	return getDouble(Outage);
+}
+
+
+double QcProcessorCombined::getOverlap() const {
+	return getDouble(Overlap);
+}
+
+
+double QcProcessorCombined::getRms() const {
+	return getDouble(Rms);
+}
+
+
+QcProcessorSpike::Spikes QcProcessorCombined::getSpikes() const {
+	if ( !_results[Spike] )
+		throw Core::ValueException("no data");
+
+	try {
+		return boost::any_cast<QcProcessorSpike::Spikes>(_results[Spike]->parameter);
+	}
+	catch ( const boost::bad_any_cast & ) {
+		throw Core::ValueException("no data");
+	}
+}
+
+
+double QcProcessorCombined::getTiming() const {
+	return getDouble(Timing);
+}
+
+
+}
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_PROCESSING_QCPROCESSORCOMBINED_H
+#define SEISCOMP_PROCESSING_QCPROCESSORCOMBINED_H
+
+
+#include <seiscomp/qc/qcprocessor.h>
+#include <seiscomp/qc/qcprocessor_spike.h>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+DEFINE_SMARTPOINTER(QcProcessorCombined);
+
+/**
+ * @brief The QcProcessorCombined class computes all QC parameters of a
+ *        stream at once.
+ *
+ * Each record is converted only once and the sample based parameters
+ * (mean, rms and spikes) share the same passes over the data. The results
+ * are equal to the results of the individual processors. Observers are
+ * notified once per record and query the parameters they are interested
+ * in with getState(Parameter).
+ */
+class SC_SYSTEM_CLIENT_API QcProcessorCombined : public QcProcessor {
+	DECLARE_SC_CLASS(QcProcessorCombined);
+
+	public:
+		enum Parameter {
+			Availability,
+			Delay,
+			Gap,
+			Latency,
+			Mean,
+			Outage,
+			Overlap,
+			Rms,
+			Spike,
+			Timing,
+			ParameterCount
+		};
+
+	public:
+		QcProcessorCombined();
+
+	public:
+		//! Enables or disables the computation of a parameter. All
+		//! parameters are enabled by default.
+		void setEnabled(Parameter parameter, bool enable);
+		bool isEnabled(Parameter parameter) const;
+
+		//! Sets the outage threshold in seconds
+		void setOutageThreshold(int threshold);
+
+		//! Returns the result of the last record for a parameter or
+		//! nullptr if the parameter is not set for the last record
+		using QcProcessor::getState;
+		QcParameter *getState(Parameter parameter) const;
+
+		double getAvailability() const;
+		double getDelay() const;
+		double getGap() const;
+		double getLatency() const;
+		double getMean() const;
+		double getOutage() const;
+		double getOverlap() const;
+		double getRms() const;
+		QcProcessorSpike::Spikes getSpikes() const;
+		double getTiming() const;
+
+		bool setState(const Record *record, const DoubleArray &data) override;
+
+	private:
+		QcParameter *createParameter(Parameter parameter, const Record *record);
+		double getDouble(Parameter parameter) const;
+
+	private:
+		bool           _enabled[ParameterCount];
+		QcParameterPtr _results[ParameterCount];
+		int            _outageThreshold;
+		Core::Time     _recent;
+		Core::Time     _lastRecordArrivalTime;
+};
+
+
+}
+}
+
+#endif
@@ -0,0 +1,350 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/qc/qcprocessor_ppsd.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/math/filter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+namespace {
+
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+
+}
+
+
+PpsdHistogram::PpsdHistogram(double minPower, double maxPower, double powerStep)
+: _minPower(minPower), _powerStep(powerStep > 0 ? powerStep : 1) {
+	_powerCount = maxPower > minPower ? size_t(ceil((maxPower-minPower) / _powerStep)) : 1;
+}
+
+
+void PpsdHistogram::setPeriods(double minPeriod, double maxPeriod, double step) {
+	_periods.clear();
+	_periodStep = step;
+
+	if ( minPeriod > 0 && step > 0 ) {
+		for ( size_t i = 0; ; ++i ) {
+			double period = minPeriod * pow(2.0, i*step);
+			if ( period > maxPeriod * (1+1E-9) ) break;
+			_periods.push_back(period);
+		}
+	}
+
+	clear();
+}
+
+
+void PpsdHistogram::clear() {
+	_counts.assign(_periods.size()*_powerCount, 0);
+	_psdCount = 0;
+}
+
+
+bool PpsdHistogram::add(const std::vector<double> &power) {
+	if ( power.size() != _periods.size() || _periods.empty() )
+		return false;
+
+	for ( size_t i = 0; i < power.size(); ++i ) {
+		if ( std::isnan(power[i]) ) continue;
+
+		double bin = floor((power[i]-_minPower) / _powerStep);
+		size_t index = bin < 0 ? 0 : std::min(size_t(bin), _powerCount-1);
+		++_counts[i*_powerCount + index];
+	}
+
+	++_psdCount;
+	return true;
+}
+
+
+bool PpsdHistogram::merge(const PpsdHistogram &other) {
+	if ( other._periods.size() != _periods.size()
+	  || other._powerCount != _powerCount
+	  || other._minPower != _minPower
+	  || other._powerStep != _powerStep )
+		return false;
+
+	for ( size_t i = 0; i < _periods.size(); ++i ) {
+		if ( fabs(other._periods[i] - _periods[i]) > _periods[i]*1E-6 )
+			return false;
+	}
+
+	for ( size_t i = 0; i < _counts.size(); ++i )
+		_counts[i] += other._counts[i];
+
+	_psdCount += other._psdCount;
+	return true;
+}
+
+
+std::vector<double> PpsdHistogram::percentile(double percentile) const {
+	std::vector<double> power(_periods.size(), NaN);
+
+	for ( size_t i = 0; i < _periods.size(); ++i ) {
+		const uint32_t *counts = &_counts[i*_powerCount];
+		uint64_t total = 0;
+		for ( size_t j = 0; j < _powerCount; ++j )
+			total += counts[j];
+
+		if ( !total ) continue;
+
+		double threshold = total * percentile * 0.01;
+		uint64_t sum = 0;
+		for ( size_t j = 0; j < _powerCount; ++j ) {
+			sum += counts[j];
+			if ( sum >= threshold && sum > 0 ) {
+				power[i] = this->power(j);
+				break;
+			}
+		}
+	}
+
+	return power;
+}
+
+
+bool PpsdHistogram::write(std::ostream &os) const {
+	os.precision(10);
+	os << "PPSD 1 " << _psdCount << " " << _minPower << " " << _powerStep
+	   << " " << _powerCount << " " << _periodStep << " " << _periods.size();
+	for ( double period : _periods )
+		os << " " << period;
+	os << "\n";
+
+	for ( size_t i = 0; i < _periods.size(); ++i ) {
+		for ( size_t j = 0; j < _powerCount; ++j ) {
+			uint32_t c = count(i, j);
+			if ( c ) os << i << " " << j << " " << c << "\n";
+		}
+	}
+
+	return os.good();
+}
+
+
+bool PpsdHistogram::read(std::istream &is) {
+	std::string magic;
+	int version;
+	size_t psdCount, powerCount, periodCount;
+	double minPower, powerStep, periodStep;
+
+	if ( !(is >> magic >> version >> psdCount >> minPower >> powerStep
+	            >> powerCount >> periodStep >> periodCount)
+	  || magic != "PPSD" || version != 1 || powerCount == 0 || powerStep <= 0 )
+		return false;
+
+	std::vector<double> periods(periodCount);
+	for ( double &period : periods ) {
+		if ( !(is >> period) ) return false;
+	}
+
+	std::vector<uint32_t> counts(periodCount*powerCount, 0);
+	size_t i, j;
+	uint32_t c;
+	while ( is >> i >> j >> c ) {
+		if ( i >= periodCount || j >= powerCount ) return false;
+		counts[i*powerCount + j] = c;
+	}
+
+	if ( !is.eof() ) return false;
+
+	_psdCount = psdCount;
+	_minPower = minPower;
+	_powerStep = powerStep;
+	_powerCount = powerCount;
+	_periodStep = periodStep;
+	_periods.swap(periods);
+	_counts.swap(counts);
+	return true;
+}
+
+
+IMPLEMENT_SC_CLASS_DERIVED(QcProcessorPpsd, QcProcessor, "QcProcessorPpsd");
+
+
+QcProcessorPpsd::QcProcessorPpsd()
+: QcProcessor()
+, _windowLength(3600), _segmentLength(900)
+, _gain(0), _differentiations(0)
+, _minPeriod(0), _maxPeriod(0), _correctionDf(0) {
+	setWindow(_windowLength, _segmentLength);
+}
+
+
+bool QcProcessorPpsd::setWindow(double windowLength, double segmentLength,
+                                double overlap) {
+	IO::Spectralizer::Options opts;
+	opts.windowLength = windowLength;
+	opts.windowOverlap = 0.5;
+	opts.welchLength = segmentLength;
+	opts.welchOverlap = overlap;
+	// Full Hann window for each segment
+	opts.taperWidth = 0.5;
+
+	if ( windowLength <= 0 || segmentLength <= 0
+	  || !_spectralizer.setOptions(opts) )
+		return false;
+
+	_windowLength = windowLength;
+	_segmentLength = segmentLength;
+	return true;
+}
+
+
+void QcProcessorPpsd::setResponse(Response *response, double gain,
+                                  const std::string &gainUnit) {
+	_response = response;
+	_transferFunction = _response ? _response->getTransferFunction() : nullptr;
+	_gain = gain;
+	_correction.clear();
+
+	// The number of differentiations to convert to acceleration
+	std::string unit = gainUnit;
+	std::transform(unit.begin(), unit.end(), unit.begin(), ::toupper);
+	if ( unit == "M" )
+		_differentiations = 2;
+	else if ( unit == "M/S" )
+		_differentiations = 1;
+	else
+		_differentiations = 0;
+}
+
+
+void QcProcessorPpsd::setPeriodRange(double minPeriod, double maxPeriod) {
+	_minPeriod = minPeriod;
+	_maxPeriod = maxPeriod;
+	_histogram.setPeriods(0, 0);
+}
+
+
+QcProcessorPpsd::Psd QcProcessorPpsd::getPsd() const {
+	try {
+		return boost::any_cast<Psd>(_qcp->parameter);
+	}
+	catch ( const boost::bad_any_cast & ) {
+		throw Core::ValueException("no data");
+	}
+}
+
+
+bool QcProcessorPpsd::setState(const Record *record, const DoubleArray &) {
+	bool completed = false;
+
+	_spectralizer.push(record);
+	while ( IO::Spectrum *spectrum = _spectralizer.pop() ) {
+		IO::SpectrumPtr ref = spectrum;
+		if ( addSpectrum(*spectrum) )
+			completed = true;
+	}
+
+	return completed;
+}
+
+
+bool QcProcessorPpsd::addSpectrum(const IO::Spectrum &spectrum) {
+	if ( !spectrum.isValid() || !spectrum.isPowerSpectralDensity() )
+		return false;
+
+	// Derive the frequency sampling from the segment length as the
+	// Spectralizer does
+	double fs = spectrum.maximumFrequency()*2;
+	size_t samples = size_t(fs*_windowLength);
+	size_t segment = size_t(fs*_segmentLength + 0.5);
+	if ( !segment || segment >= samples ) segment = samples;
+
+	double df = fs / Math::Filtering::next_power_of_2(segment);
+	const ComplexDoubleArray *density = spectrum.data();
+	size_t bins = density->size();
+
+	if ( _histogram.periods().empty() ) {
+		_histogram.setPeriods(_minPeriod > 0 ? _minPeriod : 2 / fs,
+		                      _maxPeriod > 0 ? _maxPeriod : segment / fs * 0.1);
+		if ( _histogram.periods().empty() ) return false;
+	}
+
+	if ( _correction.size() != bins || _correctionDf != df ) {
+		std::vector<double> frequencies(bins);
+		std::vector<Math::Complex> response;
+
+		for ( size_t i = 0; i < bins; ++i )
+			frequencies[i] = i*df;
+
+		if ( _transferFunction )
+			_transferFunction->evaluate(response, frequencies);
+
+		_correction.resize(bins);
+		_correctionDf = df;
+
+		for ( size_t i = 0; i < bins; ++i ) {
+			double c = _gain > 0 ? 1.0 / (_gain*_gain) : 1.0;
+
+			if ( _transferFunction ) {
+				double h = norm(response[i]);
+				c = h > 0 ? c / h : 0;
+			}
+
+			double w2 = 4*M_PI*M_PI*frequencies[i]*frequencies[i];
+			for ( int k = 0; k < _differentiations; ++k )
+				c *= w2;
+
+			_correction[i] = c;
+		}
+	}
+
+	Psd psd;
+	psd.startTime = spectrum.startTime();
+	psd.endTime = spectrum.endTime();
+	psd.power.resize(_histogram.periods().size(), NaN);
+
+	// Average the density over one octave around each period
+	for ( size_t p = 0; p < psd.power.size(); ++p ) {
+		double fc = 1.0 / _histogram.periods()[p];
+		size_t from = std::max(size_t(ceil(fc*M_SQRT1_2 / df)), size_t(1));
+		size_t to = std::min(size_t(floor(fc*M_SQRT2 / df)), bins-1);
+		if ( from > to ) continue;
+
+		double sum = 0;
+		for ( size_t i = from; i <= to; ++i )
+			sum += (*density)[i].real() * _correction[i];
+
+		sum /= to-from+1;
+		if ( sum > 0 )
+			psd.power[p] = 10*log10(sum);
+	}
+
+	_histogram.add(psd.power);
+	_qcp->parameter = psd;
+	return true;
+}
+
+
+}
+}
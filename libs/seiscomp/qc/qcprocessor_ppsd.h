@@ -0,0 +1,202 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_PROCESSING_QCPROCESSORPPSD_H
+#define SEISCOMP_PROCESSING_QCPROCESSORPPSD_H
+
+
+#include <seiscomp/qc/qcprocessor.h>
+#include <seiscomp/io/recordfilter/spectralizer.h>
+#include <seiscomp/math/restitution/transferfunction.h>
+#include <seiscomp/processing/response.h>
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Processing {
+
+
+/**
+ * @brief The PpsdHistogram class counts power spectral densities per
+ *        period and power bin.
+ *
+ * The periods are spaced logarithmically, the powers are given in dB.
+ * Histograms with the same bins can be merged which allows to accumulate
+ * them over any time span.
+ */
+class SC_SYSTEM_CLIENT_API PpsdHistogram {
+	public:
+		//! Creates an empty histogram without periods
+		PpsdHistogram(double minPower = -200, double maxPower = -50,
+		              double powerStep = 1);
+
+	public:
+		/**
+		 * @brief Sets up the period bins and clears the histogram.
+		 * @param minPeriod The center of the first period bin in seconds
+		 * @param maxPeriod The maximum center period in seconds
+		 * @param step The distance of subsequent periods in octaves
+		 */
+		void setPeriods(double minPeriod, double maxPeriod, double step = 0.125);
+
+		void clear();
+
+		bool empty() const { return _psdCount == 0; }
+
+		const std::vector<double> &periods() const { return _periods; }
+		double periodStep() const { return _periodStep; }
+
+		size_t powerCount() const { return _powerCount; }
+		double minPower() const { return _minPower; }
+		double powerStep() const { return _powerStep; }
+		//! Returns the lower bound of a power bin in dB
+		double power(size_t index) const { return _minPower + index*_powerStep; }
+
+		//! Returns the number of PSDs added
+		size_t psdCount() const { return _psdCount; }
+
+		//! Returns the count of a period and power bin
+		uint32_t count(size_t period, size_t power) const {
+			return _counts[period*_powerCount + power];
+		}
+
+		/**
+		 * @brief Adds a PSD. Powers below or above the range are counted
+		 *        in the first or last bin.
+		 * @param power The power in dB for each period. NaN values are
+		 *              not counted.
+		 */
+		bool add(const std::vector<double> &power);
+
+		//! Adds the counts of another histogram with the same bins
+		bool merge(const PpsdHistogram &other);
+
+		/**
+		 * @brief Returns the power of a percentile for each period
+		 * @param percentile The percentile in [0,100]
+		 * @return The lower bound of the power bin in dB or NaN if a
+		 *         period has no counts
+		 */
+		std::vector<double> percentile(double percentile) const;
+
+		//! Writes the histogram as text. Only non-zero counts are written.
+		bool write(std::ostream &os) const;
+		//! Reads a histogram written with write
+		bool read(std::istream &is);
+
+	private:
+		std::vector<double>   _periods;
+		double                _periodStep{0};
+		double                _minPower;
+		double                _powerStep;
+		size_t                _powerCount;
+		size_t                _psdCount{0};
+		std::vector<uint32_t> _counts;
+};
+
+
+DEFINE_SMARTPOINTER(QcProcessorPpsd);
+
+/**
+ * @brief The QcProcessorPpsd class computes power spectral densities of
+ *        a stream and accumulates them in a PpsdHistogram.
+ *
+ * Each PSD is computed with Welch's method by the IO::Spectralizer, by
+ * default over one hour with 50% overlap of subsequent hours and segments
+ * of 15 minutes with 75% overlap. If a response is set, the PSDs are
+ * corrected for the response and converted to acceleration. The densities
+ * are averaged over one octave around the center of each period bin.
+ *
+ * The result of a record is valid if a PSD has been completed.
+ */
+class SC_SYSTEM_CLIENT_API QcProcessorPpsd : public QcProcessor {
+	DECLARE_SC_CLASS(QcProcessorPpsd);
+
+	public:
+		//! A PSD in dB for each period of the histogram
+		struct Psd {
+			Core::Time          startTime;
+			Core::Time          endTime;
+			std::vector<double> power;
+		};
+
+	public:
+		QcProcessorPpsd();
+
+	public:
+		/**
+		 * @brief Sets the window and segment lengths. Must be called
+		 *        before the first record is fed.
+		 * @param windowLength The time window of a PSD in seconds
+		 * @param segmentLength The length of the averaged segments
+		 * @param overlap The overlap of subsequent segments
+		 */
+		bool setWindow(double windowLength, double segmentLength,
+		               double overlap = 0.75);
+
+		/**
+		 * @brief Sets the response used to correct the PSDs.
+		 * @param response The response, nullptr to apply the gain only
+		 * @param gain The gain in counts per gain unit
+		 * @param gainUnit The unit of the gain, M, M/S or M/S**2
+		 */
+		void setResponse(Response *response, double gain,
+		                 const std::string &gainUnit);
+
+		//! Sets the period range of the histogram. The default range
+		//! reaches from the Nyquist period to a tenth of the segment
+		//! length.
+		void setPeriodRange(double minPeriod, double maxPeriod);
+
+		PpsdHistogram &histogram() { return _histogram; }
+		const PpsdHistogram &histogram() const { return _histogram; }
+
+		//! Returns the PSD completed with the last record
+		Psd getPsd() const;
+
+		bool setState(const Record *record, const DoubleArray &data) override;
+
+	private:
+		bool addSpectrum(const IO::Spectrum &spectrum);
+
+	private:
+		double                                       _windowLength;
+		double                                       _segmentLength;
+		IO::Spectralizer                             _spectralizer;
+		ResponsePtr                                  _response;
+		Math::Restitution::FFT::TransferFunctionPtr  _transferFunction;
+		double                                       _gain;
+		int                                          _differentiations;
+		double                                       _minPeriod;
+		double                                       _maxPeriod;
+		//! The squared magnitude of the response per spectrum sample
+		std::vector<double>                          _correction;
+		double                                       _correctionDf;
+		PpsdHistogram                                _histogram;
+};
+
+
+}
+}
+
+#endif
@@ -21,6 +21,10 @@
 #include "locsat.h"
 #include "locsat_internal.h"
 
+#include <seiscomp/seismology/ttt/locsat.h>
+
+#include <mutex>
+
 
 using namespace Seiscomp::Seismology;
 
@@ -29,6 +33,15 @@ namespace Seiscomp {
 namespace Internal {
 
 
+namespace {
+
+// The station list and the inversion of LOCSAT use global state, locations
+// are computed one at a time. The travel time tables are shared.
+std::mutex locatorMutex;
+
+}
+
+
 LocSAT::LocSAT() {
 	_origerr = (Origerr*)malloc(sizeof(Origerr));
 	_origin = (Origin*)malloc(sizeof(Origin));
@@ -101,9 +114,25 @@ Loc* LocSAT::doLocation() {
 	if( (_num_sta > 9999) || (_num_obs > 9999) )
 		throw LocatorException("error: Too many picks/stations [9999] - Please raise limits within pre-f2c locsat code!");
 
-	int ierr = locate_event(nullptr, _sites, _num_sta, _arrival, _assoc,
-	                        _origin, _origerr, _locator_params,
-	                        _locator_errors, _num_obs);
+	int ierr;
+
+	if ( _locator_params->cor_level > 0 ) {
+		// Station corrections are only supported with the global tables
+		std::lock_guard<std::mutex> lock(locatorMutex);
+		ierr = locate_event(nullptr, _sites, _num_sta, _arrival, _assoc,
+		                    _origin, _origerr, _locator_params,
+		                    _locator_errors, _num_obs);
+	}
+	else {
+		TTT::LocsatTablesPtr tables = TTT::LocsatTables::Get(_locator_params->prefix, &ierr);
+		if ( tables ) {
+			std::lock_guard<std::mutex> lock(locatorMutex);
+			ierr = locate_event_tables(tables->handle(), nullptr, _sites,
+			                           _num_sta, _arrival, _assoc, _origin,
+			                           _origerr, _locator_params,
+			                           _locator_errors, _num_obs);
+		}
+	}
 
 	//std::cerr << "ierr = locate_event: " <<  ierr << std::endl;
 
@@ -27,6 +27,8 @@
 #include <string.h>
 #include <iostream>
 
+#include <tttables.h>
+
 
 namespace Seiscomp{
 namespace Internal{
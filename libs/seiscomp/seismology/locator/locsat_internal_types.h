@@ -140,6 +140,17 @@ extern "C" {
 	                 Locator_params* _locator_params,
 	                 Locator_errors* _locator_errors,
 	                 int _num_obs);
+	int locate_event_tables(const ::TTTables *tables,
+	                        char* _newnet,
+	                        Site* _sites,
+	                        int _num_sta,
+	                        Arrival* _arrival,
+	                        Assoc* _assoc,
+	                        Origin* _origin,
+	                        Origerr* _origerr,
+	                        Locator_params* _locator_params,
+	                        Locator_errors* _locator_errors,
+	                        int _num_obs);
 }
 
 struct Loc {
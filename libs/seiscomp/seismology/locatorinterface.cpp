@@ -21,8 +21,11 @@
 #include <seiscomp/seismology/locatorinterface.h>
 #include <seiscomp/datamodel/utils.h>
 #include <seiscomp/datamodel/inventory.h>
+#include <seiscomp/datamodel/notifier.h>
 #include <seiscomp/core/interfacefactory.ipp>
 
+#include <map>
+
 
 #define SEISCOMP_COMPONENT Locator
 
@@ -31,6 +34,50 @@ IMPLEMENT_INTERFACE_FACTORY(Seiscomp::Seismology::LocatorInterface, SC_SYSTEM_CO
 
 using namespace Seiscomp::DataModel;
 
+
+namespace {
+
+
+// Returns the sensor locations resolved once by a LocatorSession
+class SensorLocationCache : public Seiscomp::Seismology::SensorLocationDelegate {
+	public:
+		struct Entry {
+			PickPtr           pick;
+			SensorLocationPtr location;
+		};
+
+	public:
+		SensorLocation *getSensorLocation(Pick *pick) const override {
+			auto it = entries.find(pick->publicID());
+			if ( it == entries.end() ) return nullptr;
+			return it->second.location.get();
+		}
+
+	public:
+		std::map<std::string, Entry> entries;
+};
+
+
+// The working origin of a session shares the publicID with the source
+// origin and must not create notifiers when it is modified
+class NotifierBlocker {
+	public:
+		NotifierBlocker() : _wasEnabled(Notifier::IsEnabled()) {
+			Notifier::Disable();
+		}
+
+		~NotifierBlocker() {
+			Notifier::SetEnabled(_wasEnabled);
+		}
+
+	private:
+		bool _wasEnabled;
+};
+
+
+}
+
+
 namespace Seiscomp {
 namespace Seismology {
 
@@ -65,6 +112,11 @@ void LocatorInterface::setSensorLocationDelegate(SensorLocationDelegate *delegat
 }
 
 
+SensorLocationDelegate *LocatorInterface::sensorLocationDelegate() const {
+	return _sensorLocationDelegate.get();
+}
+
+
 LocatorInterface::IDList LocatorInterface::parameters() const {
 	return IDList();
 }
@@ -197,5 +249,135 @@ void flagsToArrival(DataModel::Arrival *arrival, int flags) {
 }
 
 
+LocatorSession::LocatorSession(LocatorInterface *locator,
+                               const DataModel::Origin *origin)
+: _locator(locator), _cache(new SensorLocationCache) {
+	NotifierBlocker blocker;
+
+	_origin = Origin::Cast(origin->clone());
+	for ( size_t i = 0; i < origin->arrivalCount(); ++i )
+		addArrival(origin->arrival(i));
+}
+
+
+LocatorSession::~LocatorSession() {}
+
+
+LocatorInterface *LocatorSession::locator() const {
+	return _locator.get();
+}
+
+
+const DataModel::Origin *LocatorSession::origin() const {
+	return _origin.get();
+}
+
+
+size_t LocatorSession::arrivalCount() const {
+	return _origin->arrivalCount();
+}
+
+
+DataModel::Arrival *LocatorSession::arrival(size_t index) const {
+	return _origin->arrival(index);
+}
+
+
+bool LocatorSession::addArrival(const DataModel::Arrival *arrival) {
+	if ( _origin->arrival(arrival->index()) != nullptr )
+		return false;
+
+	NotifierBlocker blocker;
+
+	ArrivalPtr copy = Arrival::Cast(arrival->clone());
+	if ( !_origin->add(copy.get()) )
+		return false;
+
+	resolve(copy.get());
+	return true;
+}
+
+
+bool LocatorSession::removeArrival(size_t index) {
+	if ( index >= _origin->arrivalCount() )
+		return false;
+
+	NotifierBlocker blocker;
+
+	static_cast<SensorLocationCache*>(_cache.get())->entries.erase(
+		_origin->arrival(index)->pickID()
+	);
+
+	return _origin->removeArrival(index);
+}
+
+
+bool LocatorSession::setArrivalFlags(size_t index, int flags) {
+	if ( index >= _origin->arrivalCount() )
+		return false;
+
+	NotifierBlocker blocker;
+
+	Arrival *arrival = _origin->arrival(index);
+	flagsToArrival(arrival, flags);
+
+	if ( flags == LocatorInterface::F_NONE )
+		arrival->setWeight(0.0);
+	else {
+		try {
+			if ( arrival->weight() == 0 )
+				arrival->setWeight(1.0);
+		}
+		catch ( ... ) {}
+	}
+
+	return true;
+}
+
+
+DataModel::Origin *LocatorSession::relocate() {
+	SensorLocationDelegatePtr previous = _locator->sensorLocationDelegate();
+	Origin *result;
+
+	_locator->setSensorLocationDelegate(_cache.get());
+
+	try {
+		result = _locator->relocate(_origin.get());
+	}
+	catch ( ... ) {
+		_locator->setSensorLocationDelegate(previous.get());
+		throw;
+	}
+
+	_locator->setSensorLocationDelegate(previous.get());
+
+	if ( result == nullptr )
+		return nullptr;
+
+	// Start the next relocation from this solution
+	NotifierBlocker blocker;
+
+	_origin->setTime(result->time());
+	_origin->setLatitude(result->latitude());
+	_origin->setLongitude(result->longitude());
+	try { _origin->setDepth(result->depth()); }
+	catch ( ... ) { _origin->setDepth(Core::None); }
+
+	return result;
+}
+
+
+void LocatorSession::resolve(const DataModel::Arrival *arrival) {
+	auto &entries = static_cast<SensorLocationCache*>(_cache.get())->entries;
+	if ( entries.find(arrival->pickID()) != entries.end() )
+		return;
+
+	SensorLocationCache::Entry &entry = entries[arrival->pickID()];
+	entry.pick = _locator->getPick(const_cast<Arrival*>(arrival));
+	if ( entry.pick )
+		entry.location = _locator->getSensorLocation(entry.pick.get());
+}
+
+
 } // of namespace Seismology
 } // of namespace Seiscomp
@@ -37,11 +37,14 @@
 #include <seiscomp/core.h>
 
 
-#define SC3_LOCATOR_INTERFACE_VERSION 2
+#define SC3_LOCATOR_INTERFACE_VERSION 3
 
 /******************************************************************************
  API Changelog
  ******************************************************************************
+ 3
+   - Added LocatorInterface::sensorLocationDelegate()
+   - Added LocatorSession
  2
    - First defined version
    - Replaced WeightedPick with PickItem which allows not to only use a binary
@@ -135,6 +138,9 @@ class SC_SYSTEM_CORE_API LocatorInterface : public Core::BaseObject {
 		//! default query will be used instead.
 		void setSensorLocationDelegate(SensorLocationDelegate *delegate);
 
+		//! Returns the currently set sensor location delegate
+		SensorLocationDelegate *sensorLocationDelegate() const;
+
 		//! Initialize the configuration
 		virtual bool init(const Config::Config &config) = 0;
 
@@ -252,6 +258,82 @@ int arrivalToFlags(const DataModel::Arrival *arrival);
 void flagsToArrival(DataModel::Arrival *arrival, int flags);
 
 
+DEFINE_SMARTPOINTER(LocatorSession);
+
+/**
+ * @brief A session for repeated relocations of an origin with a changing
+ *        set of arrivals.
+ *
+ * The session keeps a working copy of the origin and the picks and sensor
+ * locations of all arrivals which are resolved only once when an arrival
+ * is added. Arrivals can be added, removed and their usage flags can be
+ * changed between relocations. Each relocation starts from the hypocenter
+ * of the previous solution.
+ *
+ * The locator is not modified permanently. Its profile and parameters can
+ * still be changed between relocations.
+ */
+class SC_SYSTEM_CORE_API LocatorSession : public Core::BaseObject {
+	public:
+		/**
+		 * @brief Creates a session for an origin.
+		 * @param locator The locator used for all relocations
+		 * @param origin The initial origin including its arrivals
+		 */
+		LocatorSession(LocatorInterface *locator,
+		               const DataModel::Origin *origin);
+		~LocatorSession() override;
+
+
+	public:
+		LocatorInterface *locator() const;
+
+		//! Returns the working origin which is passed to the locator. Its
+		//! hypocenter is updated with each successful relocation.
+		const DataModel::Origin *origin() const;
+
+		size_t arrivalCount() const;
+		DataModel::Arrival *arrival(size_t index) const;
+
+		/**
+		 * @brief Adds a copy of an arrival to the session and resolves its
+		 *        pick and sensor location.
+		 * @param arrival The arrival to be added
+		 * @return false if an arrival with the same pick is already part
+		 *         of the session
+		 */
+		bool addArrival(const DataModel::Arrival *arrival);
+		bool removeArrival(size_t index);
+
+		/**
+		 * @brief Changes the usage of an arrival.
+		 * @param index The arrival index
+		 * @param flags The LocatorInterface::Flags to be set. If no flag is
+		 *              set the arrival weight is set to 0, otherwise a zero
+		 *              weight is reset to 1.
+		 * @return false if the index is out of range
+		 */
+		bool setArrivalFlags(size_t index, int flags);
+
+		/**
+		 * @brief Relocates the working origin starting from the previous
+		 *        solution. Exceptions of the locator are passed through.
+		 * @return The new origin or nullptr if the relocation failed
+		 */
+		DataModel::Origin *relocate();
+
+
+	private:
+		void resolve(const DataModel::Arrival *arrival);
+
+
+	private:
+		LocatorInterfacePtr       _locator;
+		DataModel::OriginPtr      _origin;
+		SensorLocationDelegatePtr _cache;
+};
+
+
 DEFINE_INTERFACE_FACTORY(LocatorInterface);
 
 
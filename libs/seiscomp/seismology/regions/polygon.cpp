@@ -153,6 +153,7 @@ bool PolyRegions::readFepBoundaries(const std::string& filename) {
 
 void PolyRegions::addRegion(GeoFeature *r) {
 	_regions.push_back(r);
+	_index.addItem(r);
 }
 
 
@@ -187,13 +188,8 @@ void PolyRegions::info(){
 
 GeoFeature *PolyRegions::findRegion(double lat, double lon) const {
 	auto gc = GeoCoordinate(lat, lon).normalize();
-	for ( size_t i = 0; i < regionCount(); ++i ) {
-		if ( region(i)->contains(gc) ) {
-			return region(i);
-		}
-	}
-
-	return nullptr;
+	// The index only holds pointers to the regions owned by this instance
+	return const_cast<GeoFeature*>(_index.findFirst(gc));
 }
 
 
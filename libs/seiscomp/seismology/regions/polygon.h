@@ -24,6 +24,7 @@
 
 #include <seiscomp/core.h>
 #include <seiscomp/geo/feature.h>
+#include <seiscomp/geo/index/featureindex.h>
 #include <vector>
 
 
@@ -57,6 +58,7 @@ class SC_SYSTEM_CORE_API PolyRegions {
 
 	private:
 		std::vector<GeoFeature*> _regions;
+		GeoFeatureIndex          _index;
 		std::string _dataDir;
 };
 
@@ -23,6 +23,11 @@
 #include <seiscomp/math/geo.h>
 #include <seiscomp/core/interfacefactory.ipp>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+
 
 IMPLEMENT_INTERFACE_FACTORY(Seiscomp::TravelTimeTableInterface, SC_SYSTEM_CORE_API);
 
@@ -36,6 +41,16 @@ int elpcor_(const char *phid, real *del, real *z__, real *azi, real *ecolat, rea
 }
 
 
+namespace {
+
+
+// elpcor_ keeps its intermediate results in static variables
+std::mutex elpcorMutex;
+
+
+}
+
+
 namespace Seiscomp {
 
 
@@ -46,6 +61,8 @@ bool ellipcorr(const std::string &phase, double lat1, double lon1, double lat2,
 	Seiscomp::Math::Geo::delazi(lat1, lon1, lat2, lon2, &delta, &azi1, &azi2);
 	real staazi=azi1, stadel=delta, zfoc = depth, colat = 90. - lat1, ecorr=0;
 
+	std::lock_guard<std::mutex> lock(elpcorMutex);
+
 	if (phase=="P" || phase=="Pn" || phase=="Pg" || phase=="Pb" || phase=="Pdif" || phase=="Pdiff")
 		elpcor_("P       ", &stadel, &zfoc, &staazi, &colat, &ecorr, 8);
 	else if (phase=="PcP")
@@ -280,6 +297,28 @@ double TravelTimeTableInterface::computeTime(const char *phase,
 }
 
 
+void TravelTimeTableInterface::computeTimes(const std::vector<std::string> &phases,
+                                            double lat1, double lon1, double dep1,
+                                            size_t count,
+                                            const double *lat2, const double *lon2,
+                                            const double *elev2, double *times,
+                                            int ellc) {
+	const size_t nphases = phases.size();
+
+	for ( size_t i = 0; i < count; ++i, times += nphases ) {
+		std::unique_ptr<TravelTimeList> ttlist(
+			compute(lat1, lon1, dep1, lat2[i], lon2[i],
+			        elev2 ? elev2[i] : 0., ellc)
+		);
+
+		for ( size_t j = 0; j < nphases; ++j ) {
+			const TravelTime *tt = ttlist ? getPhase(ttlist.get(), phases[j]) : nullptr;
+			times[j] = tt ? tt->time : std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+}
+
+
 TravelTimeTableInterfacePtr TravelTimeTable::_interface;
 
 
@@ -335,4 +374,22 @@ TravelTimeTable::computeFirst(double lat1, double lon1, double dep1,
 }
 
 
+void
+TravelTimeTable::computeTimes(const std::vector<std::string> &phases,
+                              double lat1, double lon1, double dep1,
+                              size_t count,
+                              const double *lat2, const double *lon2,
+                              const double *elev2, double *times,
+                              int ellc) {
+	if ( _interface ) {
+		_interface->computeTimes(phases, lat1, lon1, dep1, count,
+		                         lat2, lon2, elev2, times, ellc);
+		return;
+	}
+
+	std::fill(times, times + count * phases.size(),
+	          std::numeric_limits<double>::quiet_NaN());
+}
+
+
 }
@@ -30,6 +30,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -202,6 +203,38 @@ class SC_SYSTEM_CORE_API TravelTimeTableInterface : public Core::BaseObject {
 		            double lat1, double lon1, double dep1,
 		            double lat2, double lon2, double elev2=0.,
 		            int ellc = 1);
+
+		/**
+		 * Computes the travel times of a set of phases from one source to
+		 * multiple receivers. The result for each receiver and phase is the
+		 * same as returned by computeTime but implementations can share the
+		 * source dependent setup between receivers. The default
+		 * implementation computes the travel time list once per receiver
+		 * and searches for all requested phases.
+		 *
+		 * @param phases The phase codes to compute
+		 * @param lat1 Latitude of source
+		 * @param lon1 Longitude of source
+		 * @param dep1 The source depth in km
+		 * @param count The number of receivers
+		 * @param lat2 Array of receiver latitudes with count elements
+		 * @param lon2 Array of receiver longitudes with count elements
+		 * @param elev2 Array of receiver elevations in m with count
+		 *              elements or nullptr if all elevations are 0
+		 * @param times The output array which must hold
+		 *              count * phases.size() elements. The travel time of
+		 *              phase j at receiver i is written to
+		 *              times[i*phases.size()+j]. Phases which are not
+		 *              available are set to NaN.
+		 * @param ellc Apply ellipticity correction (1 = on, 0 = off)
+		 */
+		virtual void
+		computeTimes(const std::vector<std::string> &phases,
+		             double lat1, double lon1, double dep1,
+		             size_t count,
+		             const double *lat2, const double *lon2,
+		             const double *elev2, double *times,
+		             int ellc = 1);
 };
 
 
@@ -234,6 +267,14 @@ class SC_SYSTEM_CORE_API TravelTimeTable : public TravelTimeTableInterface {
 		             double lat2, double lon2, double elev2 = 0.,
 		             int ellc = 1);
 
+		void
+		computeTimes(const std::vector<std::string> &phases,
+		             double lat1, double lon1, double dep1,
+		             size_t count,
+		             const double *lat2, const double *lon2,
+		             const double *elev2, double *times,
+		             int ellc = 1);
+
 	private:
 		static TravelTimeTableInterfacePtr _interface;
 };
@@ -0,0 +1,916 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT TTT
+#include <seiscomp/seismology/ttt.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/system.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/math/geo.h>
+#include <seiscomp/system/environment.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+const char GridMagic[8] = {'S', 'C', 'T', 'T', 'G', 'R', 'D', '1'};
+const uint32_t GridVersion = 1;
+const size_t PhaseNameLength = 16;
+
+
+/**
+ * File layout of a precomputed grid. All sections follow the header in
+ * the order given by their offsets and are 8 byte aligned. The key is the
+ * textual description of the build parameters and is used to detect stale
+ * files.
+ */
+struct GridHeader {
+	char     magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t gridCount;
+	uint32_t nameCount;
+	uint32_t distanceCount;
+	uint32_t depthCount;
+	uint64_t keyOffset;
+	uint64_t keyLength;
+	uint64_t phasesOffset;
+	uint64_t namesOffset;
+	uint64_t distancesOffset;
+	uint64_t depthsOffset;
+	uint64_t nodesOffset;
+	uint64_t size;
+};
+
+
+/**
+ * A single grid node. An invalid node (no arrival) has a NaN time. The
+ * name refers to the phase name table since e.g. "P" might be Pg, Pn or
+ * Pdiff depending on distance and depth.
+ */
+struct GridNode {
+	float    time;
+	float    dtdd;
+	float    dtdh;
+	float    dddp;
+	float    takeoff;
+	uint16_t name;
+	uint16_t reserved;
+};
+
+
+uint64_t align8(uint64_t offset) {
+	return (offset + 7) & ~uint64_t(7);
+}
+
+
+/**
+ * Parses an axis definition. The list alternates node values and step
+ * sizes, e.g. "0,0.1,2,0.5,10" creates nodes from 0 to 2 in steps of 0.1
+ * followed by nodes up to 10 in steps of 0.5.
+ */
+bool parseAxis(vector<double> &axis, const vector<string> &def) {
+	axis.clear();
+
+	if ( def.empty() || (def.size() % 2) == 0 ) {
+		return false;
+	}
+
+	vector<double> values;
+	for ( const auto &item : def ) {
+		double v;
+		if ( !Core::fromString(v, item) ) {
+			return false;
+		}
+		values.push_back(v);
+	}
+
+	axis.push_back(values[0]);
+
+	for ( size_t i = 1; i < values.size(); i += 2 ) {
+		double step = values[i];
+		double end = values[i+1];
+		double start = axis.back();
+
+		if ( step <= 0 || end <= start ) {
+			return false;
+		}
+
+		size_t n = static_cast<size_t>(ceil((end - start) / step - 1E-6));
+		for ( size_t k = 1; k < n; ++k ) {
+			axis.push_back(start + k * step);
+		}
+		axis.push_back(end);
+	}
+
+	return axis.size() >= 2;
+}
+
+
+/**
+ * Grid
+ *
+ * A class which precomputes travel times of another travel time interface
+ * on a dense grid of epicentral distance and source depth and interpolates
+ * them. That is meant for applications which request millions of travel
+ * times such as grid search locators. The grid is written to disk once and
+ * memory mapped afterwards.
+ */
+class Grid : public TravelTimeTableInterface {
+	public:
+		Grid() = default;
+		~Grid() override;
+
+		Grid(const Grid &other) = delete;
+		Grid &operator=(const Grid &other) = delete;
+
+	public:
+		bool setModel(const std::string &model) override;
+		const std::string &model() const override;
+
+		TravelTimeList *
+		compute(double lat1, double lon1, double dep1,
+		        double lat2, double lon2, double alt2 = 0.,
+		        int ellc = 1) override;
+
+		TravelTime
+		compute(const char *phase,
+		        double lat1, double lon1, double dep1,
+		        double lat2, double lon2, double alt2 = 0.,
+		        int ellc = 1) override;
+
+		TravelTime
+		computeFirst(double lat1, double lon1, double dep1,
+		             double lat2, double lon2, double alt2 = 0.,
+		             int ellc = 1) override;
+
+		double
+		computeTime(const char *phase,
+		            double lat1, double lon1, double dep1,
+		            double lat2, double lon2, double elev2=0.,
+		            int ellc = 1) override;
+
+		void
+		computeTimes(const std::vector<std::string> &phases,
+		             double lat1, double lon1, double dep1,
+		             size_t count,
+		             const double *lat2, const double *lon2,
+		             const double *elev2, double *times,
+		             int ellc = 1) override;
+
+	private:
+		struct Sample {
+			double time;
+			double dtdd;
+			double dtdh;
+			double dddp;
+			double takeoff;
+			int    name;
+		};
+
+		void release();
+		bool build(std::vector<char> &blob);
+		bool attach(const char *data, size_t size);
+		bool load(const std::string &path);
+		bool store(const std::string &path, const std::vector<char> &blob);
+
+		int gridIndex(const char *phase) const;
+		bool interpolate(int grid, double delta, double depth,
+		                 Sample &sample, bool timeOnly) const;
+		TravelTime travelTime(const Sample &sample,
+		                      double lat1, double lon1, double dep1,
+		                      double lat2, double lon2, int ellc) const;
+
+	private:
+		std::string                 _model;
+		std::string                 _sourceInterface;
+		std::string                 _sourceModel;
+		std::vector<std::string>    _phases;
+		std::vector<double>         _distanceAxis;
+		std::vector<double>         _depthAxis;
+		std::string                 _key;
+
+		// Backing storage, either memory mapped or a private copy
+		void                       *_map{nullptr};
+		size_t                      _mapSize{0};
+		std::vector<char>           _buffer;
+
+		std::map<std::string, int>  _gridIndex;
+		const char                 *_names{nullptr};
+		const double               *_distances{nullptr};
+		const double               *_depths{nullptr};
+		const GridNode             *_nodes{nullptr};
+		size_t                      _nd{0};
+		size_t                      _nz{0};
+};
+
+
+Grid::~Grid() {
+	release();
+}
+
+
+void Grid::release() {
+#ifndef WIN32
+	if ( _map ) {
+		munmap(_map, _mapSize);
+	}
+#endif
+	_map = nullptr;
+	_mapSize = 0;
+	_buffer.clear();
+	_gridIndex.clear();
+	_names = nullptr;
+	_distances = nullptr;
+	_depths = nullptr;
+	_nodes = nullptr;
+	_nd = _nz = 0;
+}
+
+
+bool Grid::setModel(const string &model) {
+	release();
+	_model.clear();
+
+	Config::Config cfg;
+	if ( !Environment::Instance()->initConfig(&cfg, "") ) {
+		return false;
+	}
+
+	string base = "ttt.grid." + model + ".";
+
+	_sourceInterface = "libtau";
+	_sourceModel = model;
+	_phases = {
+		"P", "pP", "sP", "PcP", "PP", "PKP", "PKiKP", "pPKP",
+		"S", "sS", "ScS", "SS", "SKS", "Pg", "Pn", "Sg", "Sn"
+	};
+
+	vector<string> distances = { "0", "0.02", "2", "0.1", "20", "0.5", "180" };
+	vector<string> depths = { "0", "1", "40", "2.5", "100", "10", "800" };
+	string path;
+
+	try { _sourceInterface = cfg.getString(base + "interface"); } catch ( ... ) {}
+	try { _sourceModel = cfg.getString(base + "model"); } catch ( ... ) {}
+	try { _phases = cfg.getStrings(base + "phases"); } catch ( ... ) {}
+	try { distances = cfg.getStrings(base + "distances"); } catch ( ... ) {}
+	try { depths = cfg.getStrings(base + "depths"); } catch ( ... ) {}
+	try { path = Environment::Instance()->absolutePath(cfg.getString(base + "file")); } catch ( ... ) {}
+
+	if ( _sourceInterface == "grid" ) {
+		SEISCOMP_ERROR("ttt.grid.%s: the source interface must not be 'grid'",
+		               model.c_str());
+		return false;
+	}
+
+	if ( !parseAxis(_distanceAxis, distances) ) {
+		SEISCOMP_ERROR("%sdistances: invalid axis definition", base.c_str());
+		return false;
+	}
+
+	if ( !parseAxis(_depthAxis, depths) ) {
+		SEISCOMP_ERROR("%sdepths: invalid axis definition", base.c_str());
+		return false;
+	}
+
+	if ( _phases.size() >= 65535 ) {
+		SEISCOMP_ERROR("%sphases: too many phases", base.c_str());
+		return false;
+	}
+
+	for ( const auto &phase : _phases ) {
+		if ( phase.empty() || phase.size() >= PhaseNameLength ) {
+			SEISCOMP_ERROR("%sphases: invalid phase '%s'", base.c_str(), phase.c_str());
+			return false;
+		}
+	}
+
+	_key = _sourceInterface + "/" + _sourceModel + "/" +
+	       Core::toString(_phases) + "/" +
+	       Core::toString(distances) + "/" + Core::toString(depths);
+
+	if ( path.empty() ) {
+		path = Environment::Instance()->installDir() + "/var/cache/ttt/grid/" +
+		       model + ".bin";
+	}
+
+	if ( !load(path) ) {
+		vector<char> blob;
+
+		SEISCOMP_INFO("Building travel time grid %s from %s/%s, this may take a while",
+		              model.c_str(), _sourceInterface.c_str(), _sourceModel.c_str());
+
+		if ( !build(blob) ) {
+			return false;
+		}
+
+		if ( !store(path, blob) || !load(path) ) {
+			SEISCOMP_WARNING("Unable to cache travel time grid in %s, keeping it in memory",
+			                 path.c_str());
+			_buffer.swap(blob);
+			if ( !attach(_buffer.data(), _buffer.size()) ) {
+				release();
+				return false;
+			}
+		}
+	}
+
+	_model = model;
+	return true;
+}
+
+
+const string &Grid::model() const {
+	return _model;
+}
+
+
+bool Grid::build(vector<char> &blob) {
+	TravelTimeTableInterfacePtr source = TravelTimeTableInterface::Create(_sourceInterface.c_str());
+	if ( !source ) {
+		SEISCOMP_ERROR("Travel time interface '%s' is not available",
+		               _sourceInterface.c_str());
+		return false;
+	}
+
+	if ( !source->setModel(_sourceModel) ) {
+		SEISCOMP_ERROR("Failed to set model '%s' on travel time interface '%s'",
+		               _sourceModel.c_str(), _sourceInterface.c_str());
+		return false;
+	}
+
+	size_t nd = _distanceAxis.size();
+	size_t nz = _depthAxis.size();
+	// Grid 0 holds the first arrival, the others the configured phases
+	size_t gridCount = _phases.size() + 1;
+	size_t gridSize = nd * nz;
+
+	vector<GridNode> nodes(gridCount * gridSize);
+	vector<string> names;
+	map<string, uint16_t> nameIndex;
+
+	auto intern = [&](const string &name) -> uint16_t {
+		auto it = nameIndex.find(name);
+		if ( it != nameIndex.end() ) {
+			return it->second;
+		}
+		uint16_t idx = static_cast<uint16_t>(names.size());
+		names.push_back(name.substr(0, PhaseNameLength-1));
+		nameIndex[name] = idx;
+		return idx;
+	};
+
+	auto set = [&](GridNode &node, const TravelTime *tt) {
+		if ( !tt ) {
+			node.time = numeric_limits<float>::quiet_NaN();
+			node.dtdd = node.dtdh = node.dddp = node.takeoff = 0;
+			node.name = 0;
+		}
+		else {
+			node.time = static_cast<float>(tt->time);
+			node.dtdd = static_cast<float>(tt->dtdd);
+			node.dtdh = static_cast<float>(tt->dtdh);
+			node.dddp = static_cast<float>(tt->dddp);
+			node.takeoff = static_cast<float>(tt->takeoff);
+			node.name = intern(tt->phase);
+		}
+		node.reserved = 0;
+	};
+
+	for ( size_t iz = 0; iz < nz; ++iz ) {
+		for ( size_t id = 0; id < nd; ++id ) {
+			size_t offset = iz * nd + id;
+			TravelTimeList *ttlist = nullptr;
+
+			try {
+				ttlist = source->compute(0, 0, _depthAxis[iz],
+				                         0, _distanceAxis[id], 0, 0);
+			}
+			catch ( ... ) {}
+
+			if ( ttlist ) {
+				ttlist->delta = _distanceAxis[id];
+				ttlist->depth = _depthAxis[iz];
+			}
+
+			set(nodes[offset], ttlist && !ttlist->empty() ? &ttlist->front() : nullptr);
+			for ( size_t p = 0; p < _phases.size(); ++p ) {
+				set(nodes[(p+1) * gridSize + offset],
+				    ttlist ? getPhase(ttlist, _phases[p]) : nullptr);
+			}
+
+			delete ttlist;
+
+			if ( names.size() >= 65535 ) {
+				SEISCOMP_ERROR("Too many distinct phase names");
+				return false;
+			}
+		}
+	}
+
+	GridHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, GridMagic, sizeof(GridMagic));
+	header.version = GridVersion;
+	header.headerSize = sizeof(GridHeader);
+	header.gridCount = static_cast<uint32_t>(gridCount);
+	header.nameCount = static_cast<uint32_t>(names.size());
+	header.distanceCount = static_cast<uint32_t>(nd);
+	header.depthCount = static_cast<uint32_t>(nz);
+	header.keyOffset = align8(sizeof(GridHeader));
+	header.keyLength = _key.size();
+	header.phasesOffset = align8(header.keyOffset + header.keyLength);
+	header.namesOffset = align8(header.phasesOffset + gridCount * PhaseNameLength);
+	header.distancesOffset = align8(header.namesOffset + names.size() * PhaseNameLength);
+	header.depthsOffset = align8(header.distancesOffset + nd * sizeof(double));
+	header.nodesOffset = align8(header.depthsOffset + nz * sizeof(double));
+	header.size = header.nodesOffset + nodes.size() * sizeof(GridNode);
+
+	blob.assign(header.size, 0);
+	memcpy(blob.data(), &header, sizeof(header));
+	memcpy(blob.data() + header.keyOffset, _key.data(), _key.size());
+	// The phase code of the first arrival grid is left empty
+	for ( size_t p = 0; p < _phases.size(); ++p ) {
+		strncpy(blob.data() + header.phasesOffset + (p+1) * PhaseNameLength,
+		        _phases[p].c_str(), PhaseNameLength-1);
+	}
+	for ( size_t n = 0; n < names.size(); ++n ) {
+		strncpy(blob.data() + header.namesOffset + n * PhaseNameLength,
+		        names[n].c_str(), PhaseNameLength-1);
+	}
+	memcpy(blob.data() + header.distancesOffset, _distanceAxis.data(), nd * sizeof(double));
+	memcpy(blob.data() + header.depthsOffset, _depthAxis.data(), nz * sizeof(double));
+	memcpy(blob.data() + header.nodesOffset, nodes.data(), nodes.size() * sizeof(GridNode));
+
+	return true;
+}
+
+
+bool Grid::attach(const char *data, size_t size) {
+	if ( size < sizeof(GridHeader) ) {
+		return false;
+	}
+
+	const GridHeader *header = reinterpret_cast<const GridHeader*>(data);
+	if ( memcmp(header->magic, GridMagic, sizeof(GridMagic))
+	  || header->version != GridVersion
+	  || header->headerSize != sizeof(GridHeader)
+	  || header->size != size
+	  || header->keyOffset + header->keyLength > size
+	  || header->nodesOffset + uint64_t(header->gridCount) * header->distanceCount
+	                           * header->depthCount * sizeof(GridNode) > size ) {
+		return false;
+	}
+
+	if ( string(data + header->keyOffset, header->keyLength) != _key ) {
+		SEISCOMP_DEBUG("Travel time grid parameters changed");
+		return false;
+	}
+
+	_names = data + header->namesOffset;
+	_distances = reinterpret_cast<const double*>(data + header->distancesOffset);
+	_depths = reinterpret_cast<const double*>(data + header->depthsOffset);
+	_nodes = reinterpret_cast<const GridNode*>(data + header->nodesOffset);
+	_nd = header->distanceCount;
+	_nz = header->depthCount;
+
+	_gridIndex.clear();
+	for ( uint32_t i = 1; i < header->gridCount; ++i ) {
+		const char *code = data + header->phasesOffset + i * PhaseNameLength;
+		_gridIndex[string(code, strnlen(code, PhaseNameLength))] = static_cast<int>(i);
+	}
+
+	return true;
+}
+
+
+bool Grid::load(const string &path) {
+#ifndef WIN32
+	int fd = open(path.c_str(), O_RDONLY);
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	struct stat st;
+	if ( fstat(fd, &st) || st.st_size < static_cast<off_t>(sizeof(GridHeader)) ) {
+		::close(fd);
+		return false;
+	}
+
+	void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if ( map == MAP_FAILED ) {
+		return false;
+	}
+
+	_map = map;
+	_mapSize = st.st_size;
+
+	if ( !attach(static_cast<const char*>(_map), _mapSize) ) {
+		release();
+		return false;
+	}
+
+	SEISCOMP_DEBUG("Mapped travel time grid %s", path.c_str());
+	return true;
+#else
+	ifstream ifs(path.c_str(), ios::binary);
+	if ( !ifs.is_open() ) {
+		return false;
+	}
+
+	vector<char> blob((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+	_buffer.swap(blob);
+	if ( !attach(_buffer.data(), _buffer.size()) ) {
+		release();
+		return false;
+	}
+
+	return true;
+#endif
+}
+
+
+bool Grid::store(const string &path, const vector<char> &blob) {
+	try {
+		SC_FS_DECLARE_PATH(filePath, path)
+		if ( SC_FS_HAS_PARENT_PATH(filePath) ) {
+			boost::filesystem::create_directories(SC_FS_PARENT_PATH(filePath));
+		}
+	}
+	catch ( ... ) {
+		return false;
+	}
+
+	// Write to a temporary file first to never expose incomplete grids
+	// to concurrent readers
+	string tmpPath = path + ".part";
+	{
+		ofstream ofs(tmpPath.c_str(), ios::binary | ios::trunc);
+		if ( !ofs.is_open() ) {
+			return false;
+		}
+
+		ofs.write(blob.data(), blob.size());
+		if ( !ofs.good() ) {
+			ofs.close();
+			::remove(tmpPath.c_str());
+			return false;
+		}
+	}
+
+	if ( ::rename(tmpPath.c_str(), path.c_str()) != 0 ) {
+		::remove(tmpPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+int Grid::gridIndex(const char *phase) const {
+	auto it = _gridIndex.find(phase);
+	if ( it == _gridIndex.end() ) {
+		return -1;
+	}
+	return it->second;
+}
+
+
+/**
+ * Interpolates a grid at the given distance and depth. The travel time
+ * is interpolated bicubically with Hermite polynomials using the stored
+ * slownesses dt/dd and dt/dh if all four cell corners report the same
+ * phase, all other values bilinearly. Cells which span a branch change
+ * are handled separately.
+ */
+bool Grid::interpolate(int grid, double delta, double depth,
+                       Sample &sample, bool timeOnly) const {
+	if ( delta < _distances[0] || delta > _distances[_nd-1] ) {
+		return false;
+	}
+
+	// Sources above the first depth node are clamped as libtau does
+	if ( depth < _depths[0] ) {
+		depth = _depths[0];
+	}
+	else if ( depth > _depths[_nz-1] ) {
+		return false;
+	}
+
+	size_t id = upper_bound(_distances, _distances + _nd, delta) - _distances;
+	size_t iz = upper_bound(_depths, _depths + _nz, depth) - _depths;
+	id = id > 0 ? min(id - 1, _nd - 2) : 0;
+	iz = iz > 0 ? min(iz - 1, _nz - 2) : 0;
+
+	const GridNode *base = _nodes + grid * _nd * _nz;
+	const GridNode &n00 = base[iz * _nd + id];
+	const GridNode &n10 = base[iz * _nd + id + 1];
+	const GridNode &n01 = base[(iz+1) * _nd + id];
+	const GridNode &n11 = base[(iz+1) * _nd + id + 1];
+
+	if ( std::isnan(n00.time) || std::isnan(n10.time)
+	  || std::isnan(n01.time) || std::isnan(n11.time) ) {
+		return false;
+	}
+
+	double hd = _distances[id+1] - _distances[id];
+	double hz = _depths[iz+1] - _depths[iz];
+	double u = (delta - _distances[id]) / hd;
+	double v = (depth - _depths[iz]) / hz;
+
+	auto lerp = [](double a, double b, double t) {
+		return a + (b - a) * t;
+	};
+
+	// The phase name is taken from the lower distance node of the nearest
+	// depth row. Branch selections such as "P" switching from Pdiff to PKP
+	// at 120 degrees apply from a node onwards, and physical branches such
+	// as Pg and Pn cross with equal times.
+	const GridNode &nearest = v < 0.5 ? (u < 1 ? n00 : n10) : (u < 1 ? n01 : n11);
+	sample.name = nearest.name;
+
+	if ( n00.name == n10.name && n00.name == n01.name && n00.name == n11.name ) {
+		// Cubic Hermite basis functions
+		auto hermite = [](double p0, double m0, double p1, double m1, double t) {
+			double t2 = t * t;
+			double t3 = t2 * t;
+			return (2*t3 - 3*t2 + 1) * p0 + (t3 - 2*t2 + t) * m0 +
+			       (-2*t3 + 3*t2) * p1 + (t3 - t2) * m1;
+		};
+
+		double t0 = hermite(n00.time, n00.dtdd * hd, n10.time, n10.dtdd * hd, u);
+		double t1 = hermite(n01.time, n01.dtdd * hd, n11.time, n11.dtdd * hd, u);
+		double m0 = lerp(n00.dtdh, n10.dtdh, u) * hz;
+		double m1 = lerp(n01.dtdh, n11.dtdh, u) * hz;
+		sample.time = hermite(t0, m0, t1, m1, v);
+
+		if ( !timeOnly ) {
+			auto bilerp = [&](float GridNode::*field) {
+				return lerp(lerp(n00.*field, n10.*field, u),
+				            lerp(n01.*field, n11.*field, u), v);
+			};
+
+			sample.dtdd = bilerp(&GridNode::dtdd);
+			sample.dtdh = bilerp(&GridNode::dtdh);
+			sample.dddp = bilerp(&GridNode::dddp);
+			sample.takeoff = bilerp(&GridNode::takeoff);
+		}
+	}
+	else {
+		// The cell spans a branch change. Mixing the branches would yield
+		// times which belong to none of them, so only the corners of the
+		// nearest branch are used and extrapolated linearly with their
+		// slownesses.
+		const GridNode *corners[4] = { &n00, &n10, &n01, &n11 };
+		const double weights[4] = {
+			(1-u) * (1-v), u * (1-v), (1-u) * v, u * v
+		};
+		const double dd[2] = { delta - _distances[id], delta - _distances[id+1] };
+		const double dz[2] = { depth - _depths[iz], depth - _depths[iz+1] };
+		double wsum = 0;
+
+		sample.time = sample.dtdd = sample.dtdh = sample.dddp = sample.takeoff = 0;
+
+		for ( int i = 0; i < 4; ++i ) {
+			const GridNode &c = *corners[i];
+			if ( c.name != nearest.name ) {
+				continue;
+			}
+
+			double w = weights[i];
+			sample.time += w * (c.time + c.dtdd * dd[i % 2] + c.dtdh * dz[i / 2]);
+			sample.dtdd += w * c.dtdd;
+			sample.dtdh += w * c.dtdh;
+			sample.dddp += w * c.dddp;
+			sample.takeoff += w * c.takeoff;
+			wsum += w;
+		}
+
+		sample.time /= wsum;
+		sample.dtdd /= wsum;
+		sample.dtdh /= wsum;
+		sample.dddp /= wsum;
+		sample.takeoff /= wsum;
+	}
+
+	return true;
+}
+
+
+TravelTime Grid::travelTime(const Sample &sample,
+                            double lat1, double lon1, double dep1,
+                            double lat2, double lon2, int ellc) const {
+	const char *name = _names + sample.name * PhaseNameLength;
+	TravelTime tt(string(name, strnlen(name, PhaseNameLength)),
+	              sample.time, sample.dtdd, sample.dtdh, sample.dddp,
+	              sample.takeoff);
+
+	if ( ellc ) {
+		double ecorr = 0.;
+		if ( ellipcorr(tt.phase, lat1, lon1, lat2, lon2, dep1, ecorr) ) {
+			tt.time += ecorr;
+		}
+	}
+
+	return tt;
+}
+
+
+TravelTimeList *
+Grid::compute(double lat1, double lon1, double dep1,
+              double lat2, double lon2, double alt2, int ellc) {
+	if ( !_nodes ) {
+		throw NoPhaseError();
+	}
+
+	double delta = Math::Geo::delta(lat1, lon1, lat2, lon2);
+
+	TravelTimeList *ttlist = new TravelTimeList;
+	ttlist->delta = delta;
+	ttlist->depth = dep1;
+
+	for ( const auto &item : _gridIndex ) {
+		Sample sample;
+		if ( !interpolate(item.second, delta, dep1, sample, false) ) {
+			continue;
+		}
+
+		TravelTime tt = travelTime(sample, lat1, lon1, dep1, lat2, lon2, ellc);
+
+		// Generic codes such as "P" resolve to the same branch as
+		// explicit codes such as "Pn"
+		bool exists = false;
+		for ( const auto &other : *ttlist ) {
+			if ( other.phase == tt.phase ) {
+				exists = true;
+				break;
+			}
+		}
+
+		if ( !exists ) {
+			ttlist->push_back(tt);
+		}
+	}
+
+	ttlist->sortByTime();
+	return ttlist;
+}
+
+
+TravelTime
+Grid::compute(const char *phase,
+              double lat1, double lon1, double dep1,
+              double lat2, double lon2, double alt2, int ellc) {
+	int grid = _nodes ? gridIndex(phase) : -1;
+	if ( grid < 0 ) {
+		throw NoPhaseError();
+	}
+
+	Sample sample;
+	double delta = Math::Geo::delta(lat1, lon1, lat2, lon2);
+	if ( !interpolate(grid, delta, dep1, sample, false) ) {
+		throw NoPhaseError();
+	}
+
+	return travelTime(sample, lat1, lon1, dep1, lat2, lon2, ellc);
+}
+
+
+TravelTime
+Grid::computeFirst(double lat1, double lon1, double dep1,
+                   double lat2, double lon2, double alt2, int ellc) {
+	if ( !_nodes ) {
+		throw NoPhaseError();
+	}
+
+	Sample sample;
+	double delta = Math::Geo::delta(lat1, lon1, lat2, lon2);
+	if ( !interpolate(0, delta, dep1, sample, false) ) {
+		throw NoPhaseError();
+	}
+
+	return travelTime(sample, lat1, lon1, dep1, lat2, lon2, ellc);
+}
+
+
+double
+Grid::computeTime(const char *phase,
+                  double lat1, double lon1, double dep1,
+                  double lat2, double lon2, double alt2,
+                  int ellc) {
+	int grid = _nodes ? gridIndex(phase) : -1;
+	if ( grid < 0 ) {
+		throw NoPhaseError();
+	}
+
+	Sample sample;
+	double delta = Math::Geo::delta(lat1, lon1, lat2, lon2);
+	if ( !interpolate(grid, delta, dep1, sample, true) ) {
+		throw NoPhaseError();
+	}
+
+	double time = sample.time;
+
+	if ( ellc ) {
+		const char *name = _names + sample.name * PhaseNameLength;
+		double ecorr = 0.;
+		if ( ellipcorr(string(name, strnlen(name, PhaseNameLength)),
+		               lat1, lon1, lat2, lon2, dep1, ecorr) ) {
+			time += ecorr;
+		}
+	}
+
+	return time;
+}
+
+
+void
+Grid::computeTimes(const std::vector<std::string> &phases,
+                   double lat1, double lon1, double dep1,
+                   size_t count,
+                   const double *lat2, const double *lon2,
+                   const double *elev2, double *times,
+                   int ellc) {
+	const size_t nphases = phases.size();
+
+	// Resolve the grids once for all receivers
+	vector<int> grids(nphases, -1);
+	if ( _nodes ) {
+		for ( size_t j = 0; j < nphases; ++j ) {
+			grids[j] = gridIndex(phases[j].c_str());
+		}
+	}
+
+	for ( size_t i = 0; i < count; ++i, times += nphases ) {
+		double delta = Math::Geo::delta(lat1, lon1, lat2[i], lon2[i]);
+
+		for ( size_t j = 0; j < nphases; ++j ) {
+			Sample sample;
+			if ( grids[j] < 0 || !interpolate(grids[j], delta, dep1, sample, true) ) {
+				times[j] = numeric_limits<double>::quiet_NaN();
+				continue;
+			}
+
+			times[j] = sample.time;
+
+			if ( ellc ) {
+				const char *name = _names + sample.name * PhaseNameLength;
+				double ecorr = 0.;
+				if ( ellipcorr(string(name, strnlen(name, PhaseNameLength)),
+				               lat1, lon1, lat2[i], lon2[i], dep1, ecorr) ) {
+					times[j] += ecorr;
+				}
+			}
+		}
+	}
+}
+
+
+REGISTER_TRAVELTIMETABLE(Grid, "grid");
+
+
+}
@@ -27,7 +27,9 @@
 
 
 #include <string>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <vector>
 
 
@@ -84,6 +86,14 @@ class Homogeneous : public TravelTimeTableInterface {
 		            double lat2, double lon2, double elev2=0.,
 		            int ellc = 1) override;
 
+		void
+		computeTimes(const std::vector<std::string> &phases,
+		             double lat1, double lon1, double dep1,
+		             size_t count,
+		             const double *lat2, const double *lon2,
+		             const double *elev2, double *times,
+		             int ellc = 1) override;
+
 		bool isInside(double lat, double lon, double dep);
 
 	private:
@@ -254,6 +264,47 @@ Homogeneous::computeTime(const char *phase,
 }
 
 
+void
+Homogeneous::computeTimes(const std::vector<std::string> &phases,
+                          double lat1, double lon1, double dep1,
+                          size_t count,
+                          const double *lat2, const double *lon2,
+                          const double *elev2, double *times,
+                          int ellc) {
+	const size_t nphases = phases.size();
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+
+	if ( !isInside(lat1, lon1, dep1) ) {
+		std::fill(times, times + count * nphases, nan);
+		return;
+	}
+
+	// The velocity of each phase, 0 if not supported
+	vector<double> velocities(nphases, 0.);
+	for ( size_t j = 0; j < nphases; ++j ) {
+		const string &phase = phases[j];
+		if ( phase.empty() ) continue;
+		if ( phase[0] == 'P' || phase[0] == 'p' ) {
+			velocities[j] = _pVel;
+		}
+		else if ( phase[0] == 'S' || phase[0] == 's' ) {
+			velocities[j] = _sVel;
+		}
+	}
+
+	for ( size_t i = 0; i < count; ++i, times += nphases ) {
+		// straight ray path since we are in a homogeneous media
+		double Hdist = computeDistance(lat1, lon1, lat2[i], lon2[i]);
+		double Vdist = dep1 + (elev2 ? elev2[i] : 0.)/1000.;
+		double distance = sqrt(Hdist*Hdist + Vdist*Vdist); // [km]
+
+		for ( size_t j = 0; j < nphases; ++j ) {
+			times[j] = velocities[j] > 0 ? distance / velocities[j] : nan; // [sec]
+		}
+	}
+}
+
+
 TravelTime
 Homogeneous::computeFirst(double lat1, double lon1, double dep1,
                           double lat2, double lon2, double alt2, int ellc) {
@@ -22,6 +22,9 @@
 #include <math.h>
 #include <string.h>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 
 #include <seiscomp/system/environment.h>
@@ -48,6 +51,52 @@ double takeoff_angle(double p, double zs, double vzs) {
 }
 
 
+std::mutex tablesMutex;
+std::map<std::string, std::weak_ptr<const libtau>> tablesCache;
+
+
+/**
+ * Returns the tables for the given path, loading them if no other instance
+ * is using them yet. The returned handle must not be modified, instances
+ * work on copies created with tabcopy.
+ */
+std::shared_ptr<const libtau> loadTables(const std::string &tablePath) {
+	std::lock_guard<std::mutex> lock(tablesMutex);
+
+	auto it = tablesCache.find(tablePath);
+	if ( it != tablesCache.end() ) {
+		auto tables = it->second.lock();
+		if ( tables ) {
+			return tables;
+		}
+	}
+
+	libtau *handle = new libtau;
+
+	// Fill the handle structure with zeros
+	memset(handle, 0, sizeof(libtau));
+	int err = tabin(handle, tablePath.c_str());
+	if ( err ) {
+		tabout(handle);
+		delete handle;
+		std::ostringstream errmsg;
+		errmsg  << tablePath << ".hed and " << tablePath << ".tbl";
+		throw Seiscomp::FileNotFoundError(errmsg.str());
+	}
+
+	brnset(handle, "all");
+
+	std::shared_ptr<const libtau> tables(handle, [](const libtau *h) {
+		libtau *handle = const_cast<libtau*>(h);
+		tabout(handle);
+		delete handle;
+	});
+
+	tablesCache[tablePath] = tables;
+	return tables;
+}
+
+
 }
 
 
@@ -62,9 +111,7 @@ namespace Seiscomp {
 namespace TTT {
 
 
-LibTau::LibTau() : _initialized(false) {
-	_depth = -1;
-}
+LibTau::LibTau() {}
 
 
 LibTau::LibTau(const LibTau &other) {
@@ -73,9 +120,22 @@ LibTau::LibTau(const LibTau &other) {
 
 
 LibTau &LibTau::operator=(const LibTau &other) {
-	_handle = other._handle;
+	if ( this == &other ) return *this;
+
+	if ( _initialized ) {
+		tabout(&_handle);
+		_initialized = false;
+	}
+
+	_model = other._model;
+	_tables = other._tables;
 	_depth = -1;
-	_initialized = false;
+
+	if ( _tables ) {
+		tabcopy(&_handle, _tables.get());
+		_initialized = true;
+	}
+
 	return *this;
 }
 
@@ -101,6 +161,7 @@ void LibTau::initPath(const std::string &model) {
 	if ( _model != model ) {
 		if ( _initialized ) {
 			tabout(&_handle);
+			_tables.reset();
 			_depth = -1;
 			_initialized = false;
 		}
@@ -111,18 +172,11 @@ void LibTau::initPath(const std::string &model) {
 		std::string tablePath = Environment::Instance()->shareDir() +
 		                        "/ttt/" + model;
 
-		// Fill the handle structure with zeros
-		memset(&_handle, 0, sizeof(_handle));
-		int err = tabin(&_handle, tablePath.c_str());
-		if ( err ) {
-			std::ostringstream errmsg;
-			errmsg  << tablePath << ".hed and " << tablePath << ".tbl";
-			throw FileNotFoundError(errmsg.str());
-		}
+		_tables = loadTables(tablePath);
+		tabcopy(&_handle, _tables.get());
 
 		_depth = -1;
 		_initialized = true;
-		brnset(&_handle, "all");
 	}
 
 	_model = model;
@@ -161,7 +215,7 @@ TravelTimeList *LibTau::compute(double delta, double depth) {
 		phase[i] = &ph[10*i];
 
 	trtm(&_handle, delta, &n, time, p, dtdd, dtdh, dddp, phase);
-	bool has_vel = emdlv(6371-depth, &vp, &vs) == 0;
+	bool has_vel = emdlvh(&_handle, 6371-depth, &vp, &vs) == 0;
 
 	for(int i=0; i<n; i++) {
 		float takeoff;
@@ -225,7 +279,7 @@ TravelTime LibTau::computeFirst(double delta, double depth) {
 		phase[i] = &ph[10*i];
 
 	trtm(&_handle, delta, &n, time, p, dtdd, dtdh, dddp, phase);
-	emdlv(6371-depth, &vp, &vs);
+	emdlvh(&_handle, 6371-depth, &vp, &vs);
 
 	if ( n ) {
 		float v = (phase[0][0]=='s' || phase[0][0]=='S') ? vs : vp;
@@ -259,6 +313,61 @@ TravelTime LibTau::computeFirst(double lat1, double lon1, double dep1,
 }
 
 
+void LibTau::computeTimes(const std::vector<std::string> &phases,
+                          double lat1, double lon1, double dep1,
+                          size_t count,
+                          const double *lat2, const double *lon2,
+                          const double *elev2, double *times,
+                          int ellc) {
+	if ( !_initialized ) setModel("iasp91");
+
+	// The depth dependent tables are shared by all receivers
+	setDepth(dep1);
+
+	const size_t nphases = phases.size();
+	int n;
+	char ph[1000], *phase[100];
+	float time[100], p[100], dtdd[100], dtdh[100], dddp[100];
+	TravelTimeList ttlist;
+	ttlist.depth = dep1;
+
+	for ( int k = 0; k < 100; ++k )
+		phase[k] = &ph[10*k];
+
+	for ( size_t i = 0; i < count; ++i, times += nphases ) {
+		double lat = lat2[i], lon = lon2[i];
+		double delta, azi1, azi2;
+
+		distaz2_(&lat1, &lon1, &lat, &lon, &delta, &azi1, &azi2);
+		trtm(&_handle, delta, &n, time, p, dtdd, dtdh, dddp, phase);
+
+		// Only the times are requested, the takeoff angles are not
+		// computed
+		ttlist.clear();
+		ttlist.delta = delta;
+		for ( int k = 0; k < n; ++k )
+			ttlist.push_back(TravelTime(phase[k], time[k], dtdd[k], dtdh[k], dddp[k], 0));
+		ttlist.sortByTime();
+
+		for ( size_t j = 0; j < nphases; ++j ) {
+			const TravelTime *tt = getPhase(&ttlist, phases[j]);
+			if ( !tt ) {
+				times[j] = std::numeric_limits<double>::quiet_NaN();
+				continue;
+			}
+
+			times[j] = tt->time;
+
+			if ( ellc ) {
+				double ecorr = 0.;
+				if ( ellipcorr(tt->phase, lat1, lon1, lat, lon, dep1, ecorr) )
+					times[j] += ecorr;
+			}
+		}
+	}
+}
+
+
 REGISTER_TRAVELTIMETABLE(LibTau, "libtau");
 
 
@@ -23,6 +23,7 @@
 #define SEISCOMP_TTT_LIBTAU_H
 
 
+#include <memory>
 #include <string>
 #include <seiscomp/seismology/ttt.h>
 
@@ -41,6 +42,12 @@ namespace TTT {
  * TTTLibTau
  *
  * A class to compute seismic travel times for 1D models like "iasp91".
+ *
+ * The tables of a model are loaded once per process and shared read-only
+ * by all instances using that model. Each instance only holds the state
+ * depending on the source depth, hence creating or copying instances is
+ * cheap. An instance must not be used by multiple threads at the same
+ * time, but each thread can use its own instance.
  */
 class SC_SYSTEM_CORE_API LibTau : public TravelTimeTableInterface {
 	public:
@@ -104,6 +111,20 @@ class SC_SYSTEM_CORE_API LibTau : public TravelTimeTableInterface {
 		                        double lat2, double lon2, double alt2 = 0.,
 		                        int ellc = 1) override;
 
+		/**
+		 * Computes the travel times of a set of phases for multiple
+		 * receivers. The source depth is set up only once for all
+		 * receivers.
+		 *
+		 * XXX Altitude correction is not implemented, elev2 is ignored.
+		 */
+		void computeTimes(const std::vector<std::string> &phases,
+		                  double lat1, double lon1, double dep1,
+		                  size_t count,
+		                  const double *lat2, const double *lon2,
+		                  const double *elev2, double *times,
+		                  int ellc = 1) override;
+
 
 	private:
 		TravelTimeList *compute(double delta, double depth);
@@ -117,12 +138,14 @@ class SC_SYSTEM_CORE_API LibTau : public TravelTimeTableInterface {
 
 		void initPath(const std::string &model);
 
+		//! The per instance state initialized from the shared tables
 		libtau _handle;
+		std::shared_ptr<const libtau> _tables;
 
-		double _depth;
+		double _depth{-1};
 		std::string _model;
 
-		bool _initialized;
+		bool _initialized{false};
 };
 
 
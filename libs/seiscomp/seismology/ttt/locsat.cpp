@@ -19,7 +19,11 @@
 
 
 #include <math.h>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 #include <string.h>
 
@@ -27,11 +31,17 @@
 #include <seiscomp/math/geo.h>
 #include <seiscomp/seismology/ttt/locsat.h>
 
+#include <tttables.h>
+
 
 #define EXTRAPOLATE 0
 
 namespace {
 
+// The tables read so far by prefix. They are kept until the process exits.
+std::mutex tablesMutex;
+std::map<std::string, Seiscomp::TTT::LocsatTablesPtr> tablesCache;
+
 // Compute the "takeoff angle" of a wave at the source.
 // dtdd  [s/rad]
 // dtdh  [s/km]
@@ -71,12 +81,6 @@ extern "C" {
 
 void distaz2_(double *lat1, double *lon1, double *lat2, double *lon2,
               double *delta, double *azi1, double *azi2);
-int setup_tttables_dir(const char *new_dir);
-double compute_ttime(double distance, double depth, const char *phase,
-                     int extrapolate, double *rdtdd,  double *rdtdh,
-                     int *errorflag);
-int num_phases();
-char **phase_types();
 
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -84,6 +88,91 @@ char **phase_types();
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LocsatTables::LocsatTables(const std::string &prefix, ::tttables *tables)
+: _prefix(prefix), _tables(tables) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LocsatTables::~LocsatTables() {
+	free_tttables(_tables);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LocsatTablesPtr LocsatTables::Get(const std::string &prefix, int *error) {
+	std::lock_guard<std::mutex> lock(tablesMutex);
+
+	auto it = tablesCache.find(prefix);
+	if ( it != tablesCache.end() ) {
+		if ( error ) *error = 0;
+		return it->second;
+	}
+
+	// Reading takes place with the lock held, concurrent requests for the
+	// same prefix must not read the tables twice
+	int err = 0;
+	::tttables *tables = read_tttables(prefix.c_str(), 0, &err);
+	if ( error ) *error = err;
+	if ( !tables ) {
+		return nullptr;
+	}
+
+	LocsatTablesPtr result(new LocsatTables(prefix, tables));
+	tablesCache[prefix] = result;
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int LocsatTables::phaseCount() const {
+	return tttables_num_phases(_tables);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *LocsatTables::phase(int index) const {
+	return tttables_phase_type(_tables, index);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int LocsatTables::findPhase(const char *phase) const {
+	int index = tttables_find_phase(_tables, phase);
+	return index < 0 ? -1 : index;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double LocsatTables::computeTime(int index, double delta, double depth,
+                                 double *dtdd, double *dtdh,
+                                 int *errorflag) const {
+	return tttables_compute_ttime(_tables, delta, depth, index, EXTRAPOLATE,
+	                              dtdd, dtdh, errorflag);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Locsat::Locsat() : _Pindex(-1) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -102,8 +191,9 @@ Locsat::Locsat(const Locsat &other) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Locsat &Locsat::operator=(const Locsat &other) {
+	_model = other._model;
+	_tables = other._tables;
 	_Pindex = other._Pindex;
-	_tablePrefix = other._tablePrefix;
 	return *this;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -125,17 +215,20 @@ bool Locsat::setModel(const std::string &model) {
 	}
 
 	_model = model;
+	_tables = nullptr;
+	_Pindex = -1;
 
 	if ( _model.empty() ) {
-		_tablePrefix.clear();
 		return true;
 	}
 
-	std::string tablePrefix = Environment::Instance()->shareDir() + "/locsat/tables/" + model;
-	if ( _tablePrefix == tablePrefix ) return true;
+	_tables = LocsatTables::Get(Environment::Instance()->shareDir() + "/locsat/tables/" + model);
+	if ( !_tables ) {
+		return false;
+	}
 
-	_tablePrefix = tablePrefix;
-	return initTables();
+	_Pindex = _tables->findPhase("P");
+	return _Pindex != -1;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -151,36 +244,9 @@ const std::string &Locsat::model() const {
 
 
 
-// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool Locsat::initTables() {
-	if ( _tablePrefix.empty()
-	  || (setup_tttables_dir(_tablePrefix.c_str()) != 0) )
-		return false;
-
-	int nphases = num_phases();
-	char **phases = phase_types();
-
-	_Pindex = -1;
-	if ( phases != nullptr ) {
-		for ( int i = 0; i < nphases; ++i ) {
-			if ( !strcmp(phases[i], "P") ) {
-				_Pindex = i;
-				break;
-			}
-		}
-	}
-
-	return _Pindex != -1;
-}
-// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
-
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 TravelTimeList *Locsat::compute(double delta, double depth) {
-	int nphases = num_phases();
-	char **phases = phase_types();
+	int nphases = _tables->phaseCount();
 
 	TravelTimeList *ttlist = new TravelTimeList;
 	ttlist->delta = delta;
@@ -189,11 +255,11 @@ TravelTimeList *Locsat::compute(double delta, double depth) {
 	//bool has_vel = get_vel(depth, &vp, &vs);
 
 	for ( int i = 0; i < nphases; ++i ) {
-		char *phase = phases[i];
+		const char *phase = _tables->phase(i);
 		int errorflag = 0;
 		double dtdd, dtdh;
-		double ttime = compute_ttime(delta, depth, phase, EXTRAPOLATE,
-		                             &dtdd, &dtdh, &errorflag);
+		double ttime = _tables->computeTime(i, delta, depth,
+		                                    &dtdd, &dtdh, &errorflag);
 		if (errorflag != 0)
 			continue;
 		// This comparison is there to also skip NaN values
@@ -214,10 +280,12 @@ TravelTimeList *Locsat::compute(double delta, double depth) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 TravelTime Locsat::compute(const char *phase, double delta, double depth) {
+	int index = _tables->findPhase(phase);
+	if ( index < 0 ) throw NoPhaseError();
 	int errorflag=0;
 	double dtdd, dtdh;
-	double ttime = compute_ttime(delta, depth, phase, EXTRAPOLATE,
-	                             &dtdd, &dtdh, &errorflag);
+	double ttime = _tables->computeTime(index, delta, depth,
+	                                    &dtdd, &dtdh, &errorflag);
 	if ( errorflag!=0 ) throw NoPhaseError();
 	if ( !(ttime > 0) ) throw NoPhaseError();
  	double takeoff = takeoff_angle(dtdd, dtdh, depth);
@@ -231,10 +299,12 @@ TravelTime Locsat::compute(const char *phase, double delta, double depth) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 double
 Locsat::computeTime(const char *phase, double delta, double depth) {
+	int index = _tables->findPhase(phase);
+	if ( index < 0 ) throw NoPhaseError();
 	int errorflag=0;
 	double dtdd, dtdh;
-	double ttime = compute_ttime(delta, depth, phase, EXTRAPOLATE,
-	                             &dtdd, &dtdh, &errorflag);
+	double ttime = _tables->computeTime(index, delta, depth,
+	                                    &dtdd, &dtdh, &errorflag);
 	if ( errorflag!=0 ) throw NoPhaseError();
 	if ( !(ttime > 0) ) throw NoPhaseError();
 	return ttime;
@@ -248,7 +318,7 @@ Locsat::computeTime(const char *phase, double delta, double depth) {
 TravelTimeList *Locsat::compute(double lat1, double lon1, double dep1,
                                 double lat2, double lon2, double alt2,
                                 int ellc) {
-	if ( !initTables() ) return nullptr;
+	if ( !_tables ) return nullptr;
 
 	double delta, azi1, azi2;
 
@@ -280,7 +350,7 @@ TravelTime Locsat::compute(const char *phase,
                            double lat1, double lon1, double dep1,
                            double lat2, double lon2, double alt2,
                            int ellc) {
-	if ( !initTables() ) throw NoPhaseError();
+	if ( !_tables || (_Pindex < 0) ) throw NoPhaseError();
 
 	double delta, azi1, azi2;
 	distaz2_(&lat1, &lon1, &lat2, &lon2, &delta, &azi1, &azi2);
@@ -306,7 +376,7 @@ double Locsat::computeTime(const char *phase,
                            double lat2, double lon2, double alt2,
                            int ellc) {
 
-	if ( !initTables() ) throw NoPhaseError();
+	if ( !_tables || (_Pindex < 0) ) throw NoPhaseError();
 
 	double delta, azi1, azi2;
 	distaz2_(&lat1, &lon1, &lat2, &lon2, &delta, &azi1, &azi2);
@@ -325,14 +395,66 @@ double Locsat::computeTime(const char *phase,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Locsat::computeTimes(const std::vector<std::string> &phases,
+                          double lat1, double lon1, double dep1,
+                          size_t count,
+                          const double *lat2, const double *lon2,
+                          const double *elev2, double *times,
+                          int ellc) {
+	const size_t nphases = phases.size();
+
+	if ( !_tables || (_Pindex < 0) ) {
+		std::fill(times, times + count * nphases,
+		          std::numeric_limits<double>::quiet_NaN());
+		return;
+	}
+
+	// Resolve the phase names only once
+	std::vector<int> indexes(nphases);
+	for ( size_t j = 0; j < nphases; ++j )
+		indexes[j] = _tables->findPhase(phases[j].c_str());
+
+	for ( size_t i = 0; i < count; ++i, times += nphases ) {
+		double lat = lat2[i], lon = lon2[i];
+		double delta, azi1, azi2;
+		distaz2_(&lat1, &lon1, &lat, &lon, &delta, &azi1, &azi2);
+
+		for ( size_t j = 0; j < nphases; ++j ) {
+			int errorflag = 0;
+			double dtdd, dtdh;
+			double ttime = indexes[j] < 0 ? -1.0 :
+				_tables->computeTime(indexes[j], delta, dep1,
+				                     &dtdd, &dtdh, &errorflag);
+
+			// This comparison is there to also skip NaN values
+			if ( errorflag != 0 || !(ttime > 0) ) {
+				times[j] = std::numeric_limits<double>::quiet_NaN();
+				continue;
+			}
+
+			if ( ellc ) {
+				double ecorr = 0.;
+				if ( ellipcorr(phases[j], lat1, lon1, lat, lon, dep1, ecorr) )
+					ttime += ecorr;
+			}
+
+			times[j] = ttime;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 TravelTime Locsat::computeFirst(double delta, double depth) {
-	char **phases = phase_types();
-	char *phase = phases[_Pindex];
+	const char *phase = _tables->phase(_Pindex);
 	int errorflag=0;
 	double dtdd, dtdh;
-	double ttime = compute_ttime(delta, depth, phase, EXTRAPOLATE,
-	                             &dtdd, &dtdh, &errorflag);
+	double ttime = _tables->computeTime(_Pindex, delta, depth,
+	                                    &dtdd, &dtdh, &errorflag);
 	if ( errorflag!=0 ) throw NoPhaseError();
 	if ( !(ttime > 0) ) throw NoPhaseError();
 	double takeoff = takeoff_angle(dtdd, dtdh, depth);
@@ -347,7 +469,7 @@ TravelTime Locsat::computeFirst(double delta, double depth) {
 TravelTime Locsat::computeFirst(double lat1, double lon1, double dep1,
                                 double lat2, double lon2, double alt2,
                                 int ellc) {
-	if ( !initTables() ) throw NoPhaseError();
+	if ( !_tables || (_Pindex < 0) ) throw NoPhaseError();
 
 	double delta, azi1, azi2;
 	distaz2_(&lat1, &lon1, &lat2, &lon2, &delta, &azi1, &azi2);
@@ -23,15 +23,85 @@
 #define SEISCOMP_TTT_LOCSAT_H
 
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <seiscomp/seismology/ttt.h>
 
 
+struct tttables;
+
+
 namespace Seiscomp {
 namespace TTT {
 
 
+/**
+ * @brief The LocsatTables class holds the LOCSAT travel time tables of
+ *        one table prefix, e.g. "@DATADIR@/locsat/tables/iasp91".
+ *
+ * Tables are read once per prefix and kept for the lifetime of the
+ * process. They are never modified afterwards and can be used from
+ * multiple threads concurrently.
+ */
+class SC_SYSTEM_CORE_API LocsatTables {
+	public:
+		~LocsatTables();
+
+		LocsatTables(const LocsatTables &) = delete;
+		LocsatTables &operator=(const LocsatTables &) = delete;
+
+
+	public:
+		/**
+		 * @brief Returns the tables of a prefix and reads them on the
+		 *        first request.
+		 * @param prefix The path and model name of the table files
+		 * @param error Optional LOCSAT error code if reading failed
+		 * @return The tables or nullptr
+		 */
+		static std::shared_ptr<const LocsatTables> Get(const std::string &prefix,
+		                                               int *error = nullptr);
+
+		const std::string &prefix() const { return _prefix; }
+
+		int phaseCount() const;
+		const char *phase(int index) const;
+
+		//! Returns the index of a phase or -1 if the phase is not available
+		int findPhase(const char *phase) const;
+
+		/**
+		 * @brief Interpolates the travel time of a phase.
+		 * @param index The phase index as returned by findPhase
+		 * @param delta The distance in degrees
+		 * @param depth The source depth in km
+		 * @param dtdd The horizontal slowness in s/deg, may be nullptr
+		 * @param dtdh The vertical slowness in s/km, may be nullptr
+		 * @param errorflag Set to non-zero if the value was extrapolated
+		 *                  or falls into a hole of the table
+		 * @return The travel time in s or a negative value if the phase
+		 *         is not available
+		 */
+		double computeTime(int index, double delta, double depth,
+		                   double *dtdd, double *dtdh, int *errorflag) const;
+
+		//! Returns the LOCSAT table set
+		const ::tttables *handle() const { return _tables; }
+
+
+	private:
+		LocsatTables(const std::string &prefix, ::tttables *tables);
+
+
+	private:
+		std::string  _prefix;
+		::tttables  *_tables;
+};
+
+typedef std::shared_ptr<const LocsatTables> LocsatTablesPtr;
+
+
 /**
  * TTTLibTau
  *
@@ -124,6 +194,20 @@ class SC_SYSTEM_CORE_API Locsat : public TravelTimeTableInterface {
 		                   double lat2, double lon2, double elev2=0.,
 		                   int ellc = 1) override;
 
+		/**
+		 * Computes the travel times of a set of phases for multiple
+		 * receivers. The tables are selected only once for all receivers.
+		 *
+		 * Note that altitude correction is currently not implemented! The
+		 * elevations are ignored.
+		 */
+		void computeTimes(const std::vector<std::string> &phases,
+		                  double lat1, double lon1, double dep1,
+		                  size_t count,
+		                  const double *lat2, const double *lon2,
+		                  const double *elev2, double *times,
+		                  int ellc = 1) override;
+
 
 	private:
 		TravelTimeList *compute(double delta, double depth);
@@ -131,13 +215,11 @@ class SC_SYSTEM_CORE_API Locsat : public TravelTimeTableInterface {
 		TravelTime computeFirst(double delta, double depth);
 		double computeTime(const char *phase, double delta, double depth);
 
-		bool initTables();
-
 
 	private:
-		std::string _model;
-		std::string _tablePrefix;
-		int         _Pindex;
+		std::string     _model;
+		LocsatTablesPtr _tables;
+		int             _Pindex;
 };
 
 
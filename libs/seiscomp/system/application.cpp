@@ -27,6 +27,10 @@
 
 #include <seiscomp/datamodel/version.h>
 
+#include <seiscomp/logging/async.h>
+#ifndef WIN32
+#include <seiscomp/logging/binary.h>
+#endif
 #include <seiscomp/logging/fd.h>
 #include <seiscomp/logging/filerotator.h>
 #ifndef WIN32
@@ -39,6 +43,7 @@
 
 #include <seiscomp/system/application.h>
 #include <seiscomp/system/pluginregistry.h>
+#include <seiscomp/system/threads.h>
 #include <seiscomp/system/hostinfo.h>
 
 #include <sstream>
@@ -207,6 +212,7 @@ void signalHandler(int signal) {
 			//SEISCOMP_ERROR("ABORT");
 			//SEISCOMP_ERROR("BACKTRACE:");
 			//crashHandler();
+			Logging::AsyncOutput::FlushAll();
 			exit(-1);
 
 		case SIGSEGV:
@@ -216,6 +222,7 @@ void signalHandler(int signal) {
 				//SEISCOMP_ERROR("BACKTRACE:");
 				crashHandler();
 			}
+			Logging::AsyncOutput::FlushAll();
 			exit(-1);
 
 		default:
@@ -362,6 +369,7 @@ Application::BaseSettings::BaseSettings()
 void Application::BaseSettings::accept(SettingsLinker &linker) {
 	linker
 	& cfg(crashHandler, "scripts.crashHandler")
+	& cfg(lazyPlugins, "core.lazyPlugins")
 	& cfg(logging, "logging")
 	& cliAsPath(
 		alternativeConfigFile,
@@ -818,6 +826,11 @@ void Application::closeLogging() {
 		delete _logger;
 		_logger = nullptr;
 	}
+
+	if ( _binaryLogger ) {
+		delete _binaryLogger;
+		_binaryLogger = nullptr;
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1123,6 +1136,13 @@ int Application::exec() {
 bool Application::initPlugins() {
 	PluginRegistry::Instance()->addPackagePath(name());
 
+	// Options which report about all plugins need them loaded
+	PluginRegistry::Instance()->setLazyLoadingEnabled(
+		_baseSettings.lazyPlugins
+		&& !commandline().hasOption("print-config-vars")
+		&& !commandline().hasOption("validate-schema-params")
+	);
+
 	if ( !_baseSettings.plugins.empty() ) {
 		vector<string> tokens;
 		Core::split(tokens, _baseSettings.plugins.c_str(), ",");
@@ -1168,6 +1188,57 @@ bool Application::initPlugins() {
 	else
 		SEISCOMP_INFO("No plugins loaded");
 
+	if ( PluginRegistry::Instance()->deferredPluginCount() ) {
+		SEISCOMP_INFO("Loading of %d plugins deferred until first use",
+		              PluginRegistry::Instance()->deferredPluginCount());
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::initThreads() {
+	vector<string> names;
+	try { names = configGetStrings("threads"); }
+	catch ( ... ) {}
+
+	clearThreadPlacements();
+
+	for ( const string &name : names ) {
+		ThreadPlacement placement;
+
+		try {
+			for ( const string &item : configGetStrings("threads." + name + ".cpus") ) {
+				vector<int> cpus;
+				if ( !parseCPUList(cpus, item) ) {
+					SEISCOMP_ERROR("threads.%s.cpus: invalid CPU list: %s",
+					               name.c_str(), item.c_str());
+					return false;
+				}
+				placement.cpus.insert(placement.cpus.end(), cpus.begin(), cpus.end());
+			}
+		}
+		catch ( ... ) {}
+
+		try { placement.node = configGetInt("threads." + name + ".node"); }
+		catch ( ... ) {}
+
+		if ( placement.empty() ) {
+			SEISCOMP_WARNING("threads.%s: neither cpus nor node configured",
+			                 name.c_str());
+			continue;
+		}
+
+		setThreadPlacement(name, placement);
+	}
+
+	// The main thread keeps the process name
+	applyThreadPlacement("main");
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1280,6 +1351,11 @@ bool Application::init() {
 			return false;
 	}
 
+	if ( !initThreads() ) {
+		exit(1);
+		return false;
+	}
+
 	showMessage("Loading plugins");
 	if ( !initPlugins() ) {
 		if ( !handleInitializationError(PLUGINS) )
@@ -1572,6 +1648,13 @@ bool Application::initLogging() {
 			_logger->setUTCEnabled(_baseSettings.logging.UTC);
 			_logger->logComponent(_baseSettings.logging.component < 0 ? !_baseSettings.logging.toStdout : _baseSettings.logging.component);
 			_logger->logContext(_baseSettings.logging.context);
+
+			if ( _baseSettings.logging.async.enable ) {
+				_logger = new Logging::AsyncOutput(
+					_logger, std::max(_baseSettings.logging.async.capacity, 1)
+				);
+			}
+
 			if ( !_baseSettings.logging.components.empty() ) {
 				for ( ComponentList::iterator it = _baseSettings.logging.components.begin();
 				      it != _baseSettings.logging.components.end(); ++it ) {
@@ -1608,6 +1691,33 @@ bool Application::initLogging() {
 			return false;
 	}
 
+#ifndef WIN32
+	if ( _baseSettings.logging.binary.enable ) {
+		string logFile = Environment::Instance()->logDir() + "/" + _name + ".blog";
+		Logging::BinaryOutput *logger = new Logging::BinaryOutput;
+
+		if ( logger->open(logFile.c_str(), size_t(_baseSettings.logging.binary.size) * 1024 * 1024) ) {
+			_binaryLogger = logger;
+			_binaryLogger->subscribe(Logging::getGlobalChannel("notice"));
+			switch ( _baseSettings.logging.binary.level ) {
+				default:
+				case 4:
+					_binaryLogger->subscribe(Logging::getGlobalChannel("debug"));
+				case 3:
+					_binaryLogger->subscribe(Logging::getGlobalChannel("info"));
+				case 2:
+					_binaryLogger->subscribe(Logging::getGlobalChannel("warning"));
+				case 1:
+					_binaryLogger->subscribe(Logging::getGlobalChannel("error"));
+			}
+		}
+		else {
+			cerr << "failed to open binary logfile: " << logFile << endl;
+			delete logger;
+		}
+	}
+#endif
+
 	if ( !_baseSettings.logging.toStdout ) {
 		const char *appVersion = version();
 		SEISCOMP_NOTICE("Starting %s %s", name().c_str(), appVersion?appVersion:"");
@@ -397,6 +397,9 @@ class SC_SYSTEM_CORE_API Application : public Core::InterruptibleObject {
 		//! Loads plugins
 		virtual bool initPlugins();
 
+		//! Reads the thread placements and places the main thread
+		virtual bool initThreads();
+
 		/**
 		 * Prints the version information to stdout
 		 */
@@ -1188,6 +1191,7 @@ class SC_SYSTEM_CORE_API Application : public Core::InterruptibleObject {
 		std::shared_ptr<CommandLine>   _commandline;
 
 		Logging::Output               *_logger;
+		Logging::Output               *_binaryLogger{nullptr};
 
 		// Initialization configuration
 		Config::Config                 _configuration;
@@ -1208,6 +1212,7 @@ class SC_SYSTEM_CORE_API Application : public Core::InterruptibleObject {
 			std::string crashHandler;
 			std::string lockfile;
 			std::string plugins;
+			bool        lazyPlugins{false};
 			std::string certificateStoreDirectory;
 
 			struct Logging {
@@ -1247,6 +1252,28 @@ class SC_SYSTEM_CORE_API Application : public Core::InterruptibleObject {
 					}
 				} file;
 
+				struct Async {
+					bool enable{false};
+					int capacity{4096};
+
+					void accept(SettingsLinker &linker) {
+						linker
+						& cfg(capacity, "capacity");
+					}
+				} async;
+
+				struct Binary {
+					bool enable{false};
+					unsigned int level{4};
+					unsigned int size{64}; /* MiB */
+
+					void accept(SettingsLinker &linker) {
+						linker
+						& cfg(level, "level")
+						& cfg(size, "size");
+					}
+				} binary;
+
 				void accept(SettingsLinker &linker) {
 					linker
 					& cfg(verbosity, "level")
@@ -1257,6 +1284,10 @@ class SC_SYSTEM_CORE_API Application : public Core::InterruptibleObject {
 					& cfg(toStdout, "stderr")
 					& cfg(UTC, "utc")
 					& cfg(file, "file")
+					& cfg(async.enable, "async")
+					& cfg(async, "async")
+					& cfg(binary.enable, "binary")
+					& cfg(binary, "binary")
 
 					& cli(
 						quiet,
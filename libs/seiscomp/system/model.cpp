@@ -35,9 +35,12 @@
 #include <sys/types.h>
 #include <errno.h>
 
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <fstream>
 #include <set>
+#include <thread>
 
 
 using namespace std;
@@ -636,6 +639,34 @@ void injectExtensions(Container *container, SchemaPluginParameters *pluginParams
 }
 
 
+bool fileStamp(const string &fn, time_t &lastModified, size_t &size) {
+	struct stat fstat;
+	if ( stat(fn.c_str(), &fstat) < 0 )
+		return false;
+
+	lastModified = fstat.st_mtime;
+	size = static_cast<size_t>(fstat.st_size);
+	return true;
+}
+
+
+template <typename T>
+struct RecordingLogger : Config::Logger {
+	RecordingLogger(std::vector<T> &entries) : entries(entries) {}
+
+	void log(Config::LogLevel level, const char *filename, int line, const char *msg) override {
+		entries.push_back({level, filename ? filename : "", line, msg ? msg : ""});
+	}
+
+	std::vector<T> &entries;
+};
+
+
+// Binding files are small but a large network has thousands of them,
+// don't spawn threads for a handful of files.
+const size_t MinBindingsPerThread = 32;
+
+
 }
 
 
@@ -1507,7 +1538,26 @@ bool Module::loadBinding(ModuleBinding &binding,
 
 	Model::SymbolFileMap &symbols = *usedSymbols;
 
-	if ( !filename.empty() ) {
+	const Model::ParsedBinding *parsed = nullptr;
+	if ( !filename.empty() && model )
+		parsed = model->cachedBinding(filename);
+
+	if ( parsed ) {
+		// The file has been parsed already, replay what the parser has
+		// reported and take the symbols from the cache.
+		if ( delegate ) {
+			delegate->aboutToRead(filename.c_str());
+			for ( const auto &entry : parsed->log )
+				delegate->log(entry.level, entry.filename.c_str(),
+				              entry.line, entry.message.c_str());
+			delegate->finishedReading(filename.c_str());
+		}
+
+		symbols.clear();
+		for ( const auto &symbol : parsed->symbols )
+			symbols[symbol.name] = new SymbolMapItem(symbol);
+	}
+	else if ( !filename.empty() ) {
 		Config::Config *cfg = new Config::Config;
 
 		if ( Util::fileExists(filename) ) {
@@ -2180,6 +2230,26 @@ bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
 		}
 	}
 
+	// Parse all profiles upfront
+	vector<string> bindingFiles;
+	for ( size_t i = 0; i < modules.size(); ++i ) {
+		Module *mod = modules[i].get();
+		if ( !mod->supportsBindings() ) continue;
+
+		try {
+			for ( it = fs::directory_iterator(SC_FS_PATH(mod->keyDirectory));
+			      it != fsDirEnd; ++it ) {
+				if ( fs::is_directory(*it) ) continue;
+				if ( SC_FS_IT_LEAF(it).compare(0, 8, "profile_") != 0 )
+					continue;
+				bindingFiles.push_back(SC_FS_IT_STR(it));
+			}
+		}
+		catch ( ... ) {}
+	}
+
+	parseBindings(bindingFiles);
+
 	// Update each module parameter with configuration symbols
 	for ( size_t i = 0; i < modules.size(); ++i ) {
 		Module *mod = modules[i].get();
@@ -2228,7 +2298,7 @@ bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
 		}
 
 		// Read available profiles
-		mod->loadProfiles(stationConfigDir(true, mod->definition->name), delegate);
+		mod->loadProfiles(mod->keyDirectory, delegate);
 
 		// Check for case sensitivity conflicts
 		for ( size_t p = 0; p < mod->unknowns.size(); ++ p ) {
@@ -2253,6 +2323,9 @@ bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
 		SEISCOMP_DEBUG("%s not available", keyDir.c_str());
 	}
 
+	vector<pair<StationID, StationPtr>> stationList;
+	bindingFiles.clear();
+
 	for ( ; it != fsDirEnd; ++it ) {
 		if ( fs::is_directory(*it) ) continue;
 		string filename = SC_FS_IT_LEAF(it);
@@ -2289,6 +2362,23 @@ bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
 			                               "set empty" << endl;
 
 		stations[id] = station;
+		stationList.emplace_back(id, station);
+
+		// Collect the station bindings to be parsed in parallel
+		for ( size_t i = 0; i < station->config.size(); ++i ) {
+			if ( !station->config[i].profile.empty() ) continue;
+			Module *mod = module(station->config[i].moduleName);
+			if ( mod == nullptr || !mod->bindingTemplate ) continue;
+			bindingFiles.push_back(mod->keyDirectory + "/station_" +
+			                       id.networkCode + "_" + id.stationCode);
+		}
+	}
+
+	parseBindings(bindingFiles);
+
+	for ( const auto &item : stationList ) {
+		const StationID &id = item.first;
+		Station *station = item.second.get();
 
 		for ( size_t i = 0; i < station->config.size(); ++i ) {
 			Module *mod = module(station->config[i].moduleName);
@@ -2732,5 +2822,95 @@ void Model::accept(ModelVisitor *visitor) const {
 }
 
 
+void Model::clearBindingCache() {
+	lock_guard<mutex> l(_bindingCacheMutex);
+	_bindingCache.clear();
+}
+
+
+void Model::parseBindings(const std::vector<std::string> &filenames) {
+	vector<string> pending;
+
+	{
+		lock_guard<mutex> l(_bindingCacheMutex);
+		for ( const auto &filename : filenames ) {
+			time_t lastModified;
+			size_t size;
+			if ( !fileStamp(filename, lastModified, size) ) continue;
+
+			auto it = _bindingCache.find(filename);
+			if ( it != _bindingCache.end()
+			  && it->second.lastModified == lastModified
+			  && it->second.size == size )
+				continue;
+
+			pending.push_back(filename);
+		}
+	}
+
+	if ( pending.empty() ) return;
+
+	size_t threadCount = max(1u, thread::hardware_concurrency());
+	threadCount = min(threadCount, (pending.size() + MinBindingsPerThread - 1) / MinBindingsPerThread);
+
+	SEISCOMP_DEBUG("parsing %d binding files with %d threads",
+	               (int)pending.size(), (int)threadCount);
+
+	atomic<size_t> next{0};
+
+	auto worker = [this, &pending, &next]() {
+		size_t i;
+		while ( (i = next++) < pending.size() ) {
+			const string &filename = pending[i];
+			ParsedBinding parsed;
+
+			if ( !fileStamp(filename, parsed.lastModified, parsed.size) )
+				continue;
+
+			Config::Config cfg;
+			RecordingLogger<LogEntry> logger(parsed.log);
+			cfg.setLogger(&logger);
+
+			// Files with errors are read again with the delegate which
+			// might want to handle the error
+			if ( !cfg.readConfig(filename, Environment::CS_CONFIG_APP) )
+				continue;
+
+			SymbolTable *symtab = cfg.symbolTable();
+			if ( symtab == nullptr ) continue;
+
+			for ( SymbolTable::iterator it = symtab->begin(); it != symtab->end(); ++it )
+				parsed.symbols.push_back(**it);
+
+			lock_guard<mutex> l(_bindingCacheMutex);
+			_bindingCache[filename] = std::move(parsed);
+		}
+	};
+
+	vector<thread> workers;
+	for ( size_t i = 1; i < threadCount; ++i )
+		workers.emplace_back(worker);
+	worker();
+	for ( auto &t : workers )
+		t.join();
+}
+
+
+const Model::ParsedBinding *Model::cachedBinding(const std::string &filename) const {
+	time_t lastModified;
+	size_t size;
+	if ( !fileStamp(filename, lastModified, size) ) return nullptr;
+
+	lock_guard<mutex> l(_bindingCacheMutex);
+	auto it = _bindingCache.find(filename);
+	if ( it == _bindingCache.end()
+	  || it->second.lastModified != lastModified
+	  || it->second.size != size )
+		return nullptr;
+
+	return &it->second;
+}
+
+
 }
 }
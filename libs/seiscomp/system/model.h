@@ -31,6 +31,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <set>
 
 
@@ -700,13 +701,43 @@ class SC_SYSTEM_CORE_API Model : public Core::BaseObject {
 		//! Accepts a model visitor and starts to traversing its nodes
 		void accept(ModelVisitor *) const;
 
+		//! Drops all cached binding files. Binding files are cached
+		//! with their modification time and size and are only parsed
+		//! again by readConfig if one of them changed.
+		void clearBindingCache();
+
 
 	// ------------------------------------------------------------------
 	//  Private interface
 	// ------------------------------------------------------------------
 	private:
+		struct LogEntry {
+			Config::LogLevel level;
+			std::string      filename;
+			int              line;
+			std::string      message;
+		};
+
+		struct ParsedBinding {
+			time_t                      lastModified;
+			size_t                      size;
+			std::vector<Config::Symbol> symbols;
+			std::vector<LogEntry>       log;
+		};
+
+		using BindingCache = std::map<std::string, ParsedBinding>;
+
 		Module *create(SchemaDefinitions *schema, SchemaModule *def);
 
+		//! Parses all binding files which are not yet cached or which
+		//! have changed on disk in parallel and updates the cache.
+		void parseBindings(const std::vector<std::string> &filenames);
+
+		//! Returns the cached binding file or nullptr if the file is not
+		//! cached or has changed on disk. The entry is valid until the
+		//! next call to parseBindings or clearBindingCache.
+		const ParsedBinding *cachedBinding(const std::string &filename) const;
+
 
 	// ------------------------------------------------------------------
 	//  Attributes
@@ -728,6 +759,13 @@ class SC_SYSTEM_CORE_API Model : public Core::BaseObject {
 		mutable SymbolMap       symbols;
 		ModMap                  modMap;
 		std::string             keyDirOverride;
+
+	private:
+		mutable std::mutex      _bindingCacheMutex;
+		BindingCache            _bindingCache;
+
+
+	friend class Module;
 };
 
 
@@ -27,6 +27,7 @@
 #include <seiscomp/utils/files.h>
 #include <seiscomp/core/strings.h>
 #include <seiscomp/core/version.h>
+#include <seiscomp/core/interfacefactory.h>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
@@ -146,6 +147,7 @@ PluginRegistry::PluginRegistry() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PluginRegistry::~PluginRegistry() {
+	if ( _lazy ) Core::Generic::setServiceResolver(nullptr);
 	freePlugins();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -209,8 +211,29 @@ void PluginRegistry::addPackagePath(const string &package) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PluginRegistry::setLazyLoadingEnabled(bool enable) {
+	_lazy = enable;
+	Core::Generic::setServiceResolver(_lazy ? &PluginRegistry::Resolve : nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PluginRegistry::isLazyLoadingEnabled() const {
+	return _lazy;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 int PluginRegistry::loadPlugins() {
+	std::lock_guard<std::recursive_mutex> lock(Core::Generic::serviceMutex());
+
 	for ( const auto &name : _pluginNames ) {
 		if ( name.empty() ) continue;
 		string filename = find(name);
@@ -219,21 +242,15 @@ int PluginRegistry::loadPlugins() {
 			return -1;
 		}
 
-		SEISCOMP_DEBUG("Trying to open plugin at %s", filename.c_str());
-		PluginEntry e = open(filename);
-		if ( e.plugin == nullptr ) {
-			if ( e.handle == nullptr ) {
-				SEISCOMP_ERROR("Unable to load plugin %s", name.c_str());
-				return -1;
-			}
-			else
-				SEISCOMP_WARNING("The plugin %s has been loaded already",
-				                 name.c_str());
+		if ( _lazy ) {
+			SEISCOMP_DEBUG("Deferred loading of plugin at %s", filename.c_str());
+			_deferred.emplace_back(name, filename);
 			continue;
 		}
 
-		SEISCOMP_INFO("Plugin %s registered", name.c_str());
-		_plugins.push_back(e);
+		if ( !load(name, filename) ) {
+			return -1;
+		}
 	}
 
 	return _plugins.size();
@@ -243,6 +260,113 @@ int PluginRegistry::loadPlugins() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int PluginRegistry::loadDeferredPlugins() {
+	std::lock_guard<std::recursive_mutex> lock(Core::Generic::serviceMutex());
+
+	DeferredList deferred;
+	deferred.swap(_deferred);
+
+	int result = 0;
+	for ( const auto &entry : deferred ) {
+		if ( !load(entry.first, entry.second) ) {
+			result = -1;
+		}
+	}
+
+	return result < 0 ? result : static_cast<int>(_plugins.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int PluginRegistry::deferredPluginCount() const {
+	std::lock_guard<std::recursive_mutex> lock(Core::Generic::serviceMutex());
+	return _deferred.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PluginRegistry::load(const string &name, const string &filename) {
+	SEISCOMP_DEBUG("Trying to open plugin at %s", filename.c_str());
+	PluginEntry e = open(filename);
+	if ( e.plugin == nullptr ) {
+		if ( e.handle == nullptr ) {
+			SEISCOMP_ERROR("Unable to load plugin %s", name.c_str());
+			return false;
+		}
+		else
+			SEISCOMP_WARNING("The plugin %s has been loaded already",
+			                 name.c_str());
+		return true;
+	}
+
+	SEISCOMP_INFO("Plugin %s registered", name.c_str());
+	_plugins.push_back(e);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PluginRegistry::resolve(const char *serviceName) {
+	// Called with the service mutex held. Plugins loaded here may look up
+	// services themselves while being initialized which must not load
+	// further plugins.
+	if ( _resolving || _deferred.empty() ) return false;
+
+	_resolving = true;
+	size_t loaded = _plugins.size();
+
+	if ( serviceName != nullptr ) {
+		// Plugins are usually named after the service they provide,
+		// e.g. dbmysql provides the database interface "mysql"
+		for ( auto it = _deferred.begin(); it != _deferred.end(); ) {
+			if ( it->first.find(serviceName) != string::npos ) {
+				SEISCOMP_DEBUG("Loading plugin %s on request of service %s",
+				               it->first.c_str(), serviceName);
+				string name = it->first, filename = it->second;
+				it = _deferred.erase(it);
+				load(name, filename);
+			}
+			else
+				++it;
+		}
+	}
+
+	// Fall back to all remaining plugins if the name did not match
+	if ( serviceName == nullptr || _plugins.size() == loaded ) {
+		if ( serviceName != nullptr ) {
+			SEISCOMP_DEBUG("Loading all deferred plugins on request of "
+			               "service %s", serviceName);
+		}
+		loadDeferredPlugins();
+	}
+
+	_resolving = false;
+	return _plugins.size() > loaded;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PluginRegistry::Resolve(const char *serviceName) {
+	return _instance ? _instance->resolve(serviceName) : false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 int PluginRegistry::loadConfiguredPlugins(const Config::Config *config) {
 	try { _pluginNames = config->getStrings("core.plugins"); }
@@ -290,6 +414,10 @@ string PluginRegistry::find(const string &name) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void PluginRegistry::freePlugins() {
+	std::lock_guard<std::recursive_mutex> lock(Core::Generic::serviceMutex());
+
+	_deferred.clear();
+
 	for ( auto &p : _plugins ) {
 		SEISCOMP_DEBUG("Unload plugin '%s'", p.plugin->description().description.c_str());
 
@@ -92,6 +92,17 @@ class SC_SYSTEM_CORE_API PluginRegistry {
 		//! shareDir + "/plugins/" + package
 		void addPackagePath(const std::string &package);
 
+		/**
+		 * Enables lazy loading. If enabled, loadPlugins only locates the
+		 * plugin files. A plugin is opened when an interface factory is
+		 * asked for a service which is not registered yet. Plugins whose
+		 * name contains the service name are tried first, then all
+		 * remaining plugins are loaded. Plugins which do more than
+		 * registering factories when loaded must not be loaded lazily.
+		 */
+		void setLazyLoadingEnabled(bool enable);
+		bool isLazyLoadingEnabled() const;
+
 		/**
 		 * Loads all plugins in the defined search paths
 		 * added with addPluginName
@@ -110,6 +121,15 @@ class SC_SYSTEM_CORE_API PluginRegistry {
 		 */
 		int loadConfiguredPlugins(const Config::Config *config);
 
+		/**
+		 * Loads all plugins whose loading has been deferred.
+		 * @return The number of loaded plugins or -1 in case of an error
+		 */
+		int loadDeferredPlugins();
+
+		//! Returns the number of plugins not yet loaded
+		int deferredPluginCount() const;
+
 
 		//! Unloads all plugins
 		void freePlugins();
@@ -130,6 +150,10 @@ class SC_SYSTEM_CORE_API PluginRegistry {
 		std::string find(const std::string &name) const;
 		PluginEntry open(const std::string &file) const;
 		bool findLibrary(void *handle) const;
+		bool load(const std::string &name, const std::string &file);
+		bool resolve(const char *serviceName);
+
+		static bool Resolve(const char *serviceName);
 
 
 	// ----------------------------------------------------------------------
@@ -139,12 +163,16 @@ class SC_SYSTEM_CORE_API PluginRegistry {
 		using PluginList = std::list<PluginEntry>;
 		using PathList = std::vector<std::string>;
 		using NameList = std::vector<std::string>;
+		using DeferredList = std::vector<std::pair<std::string, std::string>>;
 
 		static PluginRegistry *_instance;
 
 		PluginList             _plugins;
 		PathList               _paths;
 		NameList               _pluginNames;
+		DeferredList           _deferred;
+		bool                   _lazy{false};
+		bool                   _resolving{false};
 };
 
 
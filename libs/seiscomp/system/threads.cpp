@@ -0,0 +1,241 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT Threads
+
+#include <seiscomp/system/threads.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/logging/log.h>
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace System {
+
+
+namespace {
+
+
+// Memory policy of set_mempolicy(2), defined here to not depend on libnuma
+const int MemoryPolicyPreferred = 1;
+
+
+struct Placements {
+	std::mutex                   mutex;
+	map<string, ThreadPlacement> entries;
+};
+
+
+Placements &placements() {
+	static Placements *instance = new Placements;
+	return *instance;
+}
+
+
+bool parseNumber(int &value, string str) {
+	Core::trim(str);
+	return !str.empty() && Core::fromString(value, str) && value >= 0;
+}
+
+
+bool apply(const ThreadPlacement &placement) {
+#ifdef __linux__
+	vector<int> cpus = placement.cpus;
+	if ( cpus.empty() && placement.node >= 0 ) {
+		cpus = cpusOfNode(placement.node);
+		if ( cpus.empty() ) {
+			SEISCOMP_WARNING("No CPUs found for NUMA node %d", placement.node);
+		}
+	}
+
+	bool result = true;
+
+	if ( !cpus.empty() ) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for ( int cpu : cpus ) {
+			if ( cpu < CPU_SETSIZE ) CPU_SET(cpu, &set);
+		}
+
+		int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+		if ( err ) {
+			SEISCOMP_WARNING("Failed to set the CPU affinity: %s", strerror(err));
+			result = false;
+		}
+	}
+
+#ifdef SYS_set_mempolicy
+	if ( placement.node >= 0 ) {
+		const size_t bits = sizeof(unsigned long) * 8;
+		vector<unsigned long> mask(placement.node / bits + 1, 0);
+		mask[placement.node / bits] |= 1UL << (placement.node % bits);
+
+		if ( syscall(SYS_set_mempolicy, MemoryPolicyPreferred, mask.data(),
+		             mask.size() * bits + 1) != 0 ) {
+			SEISCOMP_WARNING("Failed to prefer memory of NUMA node %d: %s",
+			                 placement.node, strerror(errno));
+			result = false;
+		}
+	}
+#endif
+
+	return result;
+#else
+	return true;
+#endif
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool parseCPUList(vector<int> &cpus, const string &list) {
+	vector<string> ranges;
+	Core::split(ranges, list, ",");
+
+	cpus.clear();
+
+	for ( string &range : ranges ) {
+		if ( Core::trim(range).empty() ) continue;
+
+		size_t pos = range.find('-');
+		int first, last;
+
+		if ( pos == string::npos ) {
+			if ( !parseNumber(first, range) ) return false;
+			last = first;
+		}
+		else if ( !parseNumber(first, range.substr(0, pos))
+		       || !parseNumber(last, range.substr(pos+1))
+		       || last < first ) {
+			return false;
+		}
+
+		for ( int cpu = first; cpu <= last; ++cpu ) {
+			cpus.push_back(cpu);
+		}
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+vector<int> cpusOfNode(int node) {
+	vector<int> cpus;
+	if ( node < 0 ) return cpus;
+
+	ifstream ifs("/sys/devices/system/node/node" + Core::toString(node) + "/cpulist");
+	string list;
+	if ( !getline(ifs, list) || !parseCPUList(cpus, list) ) {
+		cpus.clear();
+	}
+
+	return cpus;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void setThreadPlacement(const string &name, const ThreadPlacement &placement) {
+	Placements &p = placements();
+	lock_guard<std::mutex> lock(p.mutex);
+	if ( placement.empty() )
+		p.entries.erase(name);
+	else
+		p.entries[name] = placement;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void clearThreadPlacements() {
+	Placements &p = placements();
+	lock_guard<std::mutex> lock(p.mutex);
+	p.entries.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool applyThreadPlacement(const string &name) {
+	ThreadPlacement placement;
+
+	{
+		Placements &p = placements();
+		lock_guard<std::mutex> lock(p.mutex);
+		auto it = p.entries.find(name);
+		if ( it == p.entries.end() ) return true;
+		placement = it->second;
+	}
+
+	SEISCOMP_DEBUG("Placing thread %s: %d CPUs, node %d", name.c_str(),
+	               static_cast<int>(placement.cpus.size()), placement.node);
+	return apply(placement);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool initThread(const string &name) {
+#ifdef __linux__
+	// The kernel limits names to 16 bytes including the terminating zero
+	pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#endif
+	return applyThreadPlacement(name);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_SYSTEM_THREADS_H
+#define SEISCOMP_SYSTEM_THREADS_H
+
+
+#include <seiscomp/core.h>
+
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace System {
+
+
+/**
+ * @brief Where a thread runs and where its memory is allocated.
+ *
+ * Placements are registered per thread name with setThreadPlacement and
+ * applied to all threads started with startThread under that name. On
+ * hosts with several NUMA nodes a thread placed on a node allocates its
+ * memory, e.g. the buffers and pools it creates, from that node.
+ * Placement is only supported on Linux and ignored elsewhere.
+ */
+struct SC_SYSTEM_CORE_API ThreadPlacement {
+	//! The CPUs the thread may run on. If empty and a node is set,
+	//! the CPUs of that node are used.
+	std::vector<int> cpus;
+	//! The NUMA node memory is preferably allocated from, -1 for none
+	int              node{-1};
+
+	bool empty() const { return cpus.empty() && node < 0; }
+};
+
+
+/**
+ * @brief Parses a CPU list as used by the kernel, e.g. "0-3,8,10-11".
+ * @return False if the list is malformed
+ */
+SC_SYSTEM_CORE_API bool parseCPUList(std::vector<int> &cpus, const std::string &list);
+
+//! Returns the CPUs of a NUMA node or an empty list if unknown
+SC_SYSTEM_CORE_API std::vector<int> cpusOfNode(int node);
+
+//! Registers the placement of all threads started with the given name
+SC_SYSTEM_CORE_API void setThreadPlacement(const std::string &name,
+                                           const ThreadPlacement &placement);
+
+//! Removes all registered placements
+SC_SYSTEM_CORE_API void clearThreadPlacements();
+
+/**
+ * @brief Applies the placement registered for name to the calling thread.
+ * @return False if a registered placement could not be applied
+ */
+SC_SYSTEM_CORE_API bool applyThreadPlacement(const std::string &name);
+
+/**
+ * @brief Names the calling thread and applies the placement registered
+ *        for the name. The name shows up in e.g. top and gdb, only the
+ *        first 15 characters are used.
+ * @return False if a registered placement could not be applied
+ */
+SC_SYSTEM_CORE_API bool initThread(const std::string &name);
+
+/**
+ * @brief Starts a thread which calls initThread with the given name before
+ *        running func.
+ */
+template <typename Function>
+std::thread startThread(const std::string &name, Function &&func) {
+	return std::thread([name](typename std::decay<Function>::type f) {
+		initThread(name);
+		f();
+	}, std::forward<Function>(func));
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,106 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/core/baseobject.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <memory>
+#include <string>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+class TestShape : public Core::BaseObject {
+	DECLARE_SC_CLASS(TestShape);
+};
+
+class TestCircle : public TestShape {
+	DECLARE_SC_CLASS(TestCircle);
+};
+
+// A plugin which replaces the implementation of TestCircle
+class TestCirclePlugin : public TestCircle {
+	DECLARE_SC_CLASS(TestCirclePlugin);
+};
+
+
+IMPLEMENT_SC_CLASS(TestShape, "TestShape");
+IMPLEMENT_SC_CLASS_DERIVED(TestCircle, TestShape, "TestCircle");
+
+IMPLEMENT_RTTI(TestCirclePlugin, "TestCircle", TestCircle)
+IMPLEMENT_RTTI_METHODS(TestCirclePlugin)
+
+typedef Core::Generic::ClassFactory<Core::BaseObject, TestCirclePlugin> PluginFactory;
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_core_classfactory)
+
+
+BOOST_AUTO_TEST_CASE(Lookup) {
+	// Static class names and names read from an archive which are not
+	// the registered strings
+	string name = "TestCircle";
+	BOOST_REQUIRE(Core::ClassFactory::FindByClassName(TestCircle::ClassName()) != nullptr);
+	BOOST_CHECK_EQUAL(Core::ClassFactory::FindByClassName(name.c_str()),
+	                  Core::ClassFactory::FindByClassName(TestCircle::ClassName()));
+	BOOST_CHECK(Core::ClassFactory::FindByClassName("TestSquare") == nullptr);
+	BOOST_CHECK(Core::ClassFactory::FindByClassName(nullptr) == nullptr);
+
+	Core::BaseObjectPtr obj = Core::ClassFactory::Create(name);
+	BOOST_REQUIRE(obj);
+	BOOST_CHECK(TestCircle::Cast(obj) != nullptr);
+	BOOST_CHECK_EQUAL(Core::ClassFactory::ClassName(obj.get()), "TestCircle");
+	BOOST_CHECK_EQUAL(Core::ClassFactory::ClassName(&TestShape::TypeInfo()), "TestShape");
+
+	BOOST_CHECK(Core::ClassFactory::IsTypeOf(TestShape::ClassName(), name.c_str()));
+	BOOST_CHECK(Core::ClassFactory::IsTypeOf("TestCircle", TestCircle::ClassName()));
+	BOOST_CHECK(!Core::ClassFactory::IsTypeOf(TestCircle::ClassName(), "TestShape"));
+	BOOST_CHECK(!Core::ClassFactory::IsTypeOf("TestShape", "TestSquare"));
+}
+
+
+BOOST_AUTO_TEST_CASE(Reregister) {
+	size_t count = Core::ClassFactory::NumberOfRegisteredClasses();
+
+	{
+		PluginFactory plugin("TestCircle", true);
+		BOOST_CHECK_EQUAL(Core::ClassFactory::NumberOfRegisteredClasses(), count);
+
+		// Both the static name of the replaced class and any other copy
+		// resolve to the plugin
+		Core::BaseObjectPtr obj = Core::ClassFactory::Create(TestCircle::ClassName());
+		BOOST_CHECK(TestCirclePlugin::Cast(obj) != nullptr);
+		obj = Core::ClassFactory::Create(string("TestCircle"));
+		BOOST_CHECK(TestCirclePlugin::Cast(obj) != nullptr);
+	}
+
+	// Unloading the plugin removes the class
+	BOOST_CHECK_EQUAL(Core::ClassFactory::NumberOfRegisteredClasses(), count - 1);
+	BOOST_CHECK(Core::ClassFactory::FindByClassName(TestCircle::ClassName()) == nullptr);
+	BOOST_CHECK(Core::ClassFactory::FindByClassName("TestCircle") == nullptr);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -615,6 +615,46 @@ BOOST_AUTO_TEST_CASE(dayOfYear) {
 
 
 
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(isoFormats) {
+	// The ISO formats are handled without strftime and strptime. Compare
+	// them with equivalent formats which are not.
+	for ( long secs = -2000000000L; secs < 4000000000L; secs += 86399L * 37 + 1234 ) {
+		sc::Time time(secs, (secs / 7) % 1000000 * (secs % 3 ? 1 : 0));
+		if ( time.microseconds() < 0 ) time.setUSecs(-time.microseconds());
+
+		BOOST_CHECK_EQUAL(time.toString("%FT%T"), time.toString("%Y-%m-%dT%H:%M:%S"));
+		BOOST_CHECK_EQUAL(time.toString("%F %TZ"), time.toString("%Y-%m-%d %H:%M:%SZ"));
+		BOOST_CHECK_EQUAL(time.toString("%FT%T.%fZ"), time.toString("%Y-%m-%dT%H:%M:%S.%fZ"));
+		BOOST_CHECK_EQUAL(time.toString("%FT%T.%3f"), time.toString("%Y-%m-%dT%H:%M:%S.%3f"));
+
+		sc::Time parsed;
+		BOOST_CHECK(parsed.fromString(time.iso()));
+		BOOST_CHECK(parsed == time);
+		BOOST_CHECK(parsed.fromString(time.toString("%F %T.%f").c_str(), "%F %T.%f"));
+		BOOST_CHECK(parsed == time);
+		BOOST_CHECK(parsed.fromString(time.toString("%Y-%m-%dT%H:%M:%S").c_str(), "%FT%T"));
+		BOOST_CHECK_EQUAL(parsed.seconds(), time.seconds());
+	}
+
+	BOOST_CHECK_EQUAL(sc::Time(0, 0).toString("%FT%T.%fZ"), "1970-01-01T00:00:00.0000Z");
+	BOOST_CHECK_EQUAL(sc::Time(0, 120000).toString("%FT%T.%fZ"), "1970-01-01T00:00:00.12Z");
+	BOOST_CHECK_EQUAL(sc::Time(-1, 0).toString("%FT%T.%2f"), "1969-12-31T23:59:59.00");
+
+	// Days beyond the end of a month are carried over as timegm does
+	sc::Time time;
+	BOOST_CHECK(time.fromString("2021-02-30T00:00:00Z"));
+	BOOST_CHECK_EQUAL(time.toString("%F"), "2021-03-02");
+	BOOST_CHECK(time.fromString("2024-04-10T12:00:00.1234567Z"));
+	BOOST_CHECK_EQUAL(time.microseconds(), 123456);
+	BOOST_CHECK(!time.fromString("2024-13-10T12:00:00Z"));
+	BOOST_CHECK(!time.fromString("2024-04-10T12:00:00Z", "%FT%T.%fZ"));
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 BOOST_AUTO_TEST_CASE(toString) {
 	// Buffer overflow test
@@ -25,6 +25,7 @@
 #include <seiscomp/geo/coordinate.h>
 #include <seiscomp/geo/boundingbox.h>
 #include <seiscomp/geo/feature.h>
+#include <seiscomp/geo/index/featureindex.h>
 #include <seiscomp/geo/index/quadtree.h>
 
 
@@ -352,5 +353,57 @@ BOOST_AUTO_TEST_CASE(quadtree) {
 
 
 
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(featureIndex) {
+	GeoFeature f1(string("f1"), nullptr, 1);
+	GeoFeature f2(string("f2"), nullptr, 1);
+	GeoFeature f3(string("f3"), nullptr, 1);
+
+	f1.addVertex(GeoCoordinate(0,0));
+	f1.addVertex(GeoCoordinate(0,10));
+	f1.addVertex(GeoCoordinate(10,10));
+	f1.addVertex(GeoCoordinate(10,0));
+	f1.setClosedPolygon(true);
+	f1.updateBoundingBox();
+
+	f2.addVertex(GeoCoordinate(1,1));
+	f2.addVertex(GeoCoordinate(2,1));
+	f2.addVertex(GeoCoordinate(2,2));
+	f2.addVertex(GeoCoordinate(1,2));
+	f2.setClosedPolygon(true);
+	f2.updateBoundingBox();
+
+	// Crosses the dateline
+	f3.addVertex(GeoCoordinate(-10,170));
+	f3.addVertex(GeoCoordinate(-10,-170));
+	f3.addVertex(GeoCoordinate(10,-170));
+	f3.addVertex(GeoCoordinate(10,170));
+	f3.setClosedPolygon(true);
+	f3.updateBoundingBox();
+
+	GeoFeatureIndex index;
+	index.addItem(&f2);
+	index.addItem(&f1);
+	index.addItem(&f3);
+	index.addItem(&f1);
+	BOOST_CHECK_EQUAL(index.size(), 3);
+
+	// The order of addition defines the precedence
+	BOOST_CHECK_EQUAL(index.findFirst(GeoCoordinate(1.5,1.5)), &f2);
+	BOOST_CHECK_EQUAL(index.findFirst(GeoCoordinate(5,5)), &f1);
+	BOOST_CHECK_EQUAL(index.findFirst(GeoCoordinate(0,180)), &f3);
+	BOOST_CHECK_EQUAL(index.findFirst(GeoCoordinate(0,-175)), &f3);
+	BOOST_CHECK(index.findFirst(GeoCoordinate(20,20)) == nullptr);
+
+	index.clear();
+	index.addItem(&f1);
+	index.addItem(&f2);
+	BOOST_CHECK_EQUAL(index.findFirst(GeoCoordinate(1.5,1.5)), &f1);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 BOOST_AUTO_TEST_SUITE_END()
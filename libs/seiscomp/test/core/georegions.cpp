@@ -22,6 +22,8 @@
 #define SEISCOMP_TEST_MODULE SeisComP
 
 
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <map>
@@ -37,6 +39,7 @@
 #include <seiscomp/seismology/regions.h>
 #include <seiscomp/seismology/regions/polygon.h>
 
+#include <boost/filesystem.hpp>
 #include <boost/system/error_code.hpp>
 
 using namespace std;
@@ -242,6 +245,67 @@ BOOST_AUTO_TEST_CASE(fepRegions) {
 
 
 
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(fepEdgeIndex) {
+	PolyRegions regions;
+	regions.read("./data/fep");
+	BOOST_REQUIRE_GT(regions.regionCount(), 0);
+
+	// A ring around the pole and a ring crossing the dateline
+	GeoFeature pole("pole", nullptr, 1);
+	GeoFeature dateline("dateline", nullptr, 1);
+	for ( int i = 0; i < 400; ++i ) {
+		double a = 2 * M_PI * i / 400;
+		pole.addVertex(70 + 10 * sin(7 * a), -180 + 360.0 * i / 400);
+		dateline.addVertex(10 * sin(a), 180 + 15 * cos(a));
+	}
+	pole.setClosedPolygon(true);
+	dateline.setClosedPolygon(true);
+
+	vector<const GeoFeature*> features;
+	for ( size_t i = 0; i < regions.regionCount(); ++i )
+		features.push_back(regions.region(i));
+	features.push_back(&pole);
+	features.push_back(&dateline);
+
+	// The indexed test must return the same result as testing all edges
+	auto containsLinear = [](const GeoFeature *f, const GeoCoordinate &v) {
+		const vector<size_t> &subFeatures = f->subFeatures();
+		size_t startIdx = 0, endIdx;
+		bool isInside = false;
+		for ( size_t i = 0; i <= subFeatures.size(); ++i, startIdx = endIdx ) {
+			endIdx = i == subFeatures.size() ? f->vertices().size() : subFeatures[i];
+			if ( Geo::contains(v, &f->vertices()[startIdx], endIdx - startIdx) )
+				isInside = !isInside;
+		}
+		return isInside;
+	};
+
+	srand(5);
+	size_t mismatches = 0;
+	for ( int k = 0; k < 2000; ++k ) {
+		GeoCoordinate v(-90 + 180.0 * rand() / RAND_MAX,
+		                -540 + 1080.0 * rand() / RAND_MAX);
+
+		// Longitudes of vertices are the critical ones
+		if ( k % 3 == 0 ) {
+			const GeoFeature *f = features[rand() % features.size()];
+			v.lon = f->vertices()[rand() % f->vertices().size()].lon;
+		}
+
+		for ( auto f : features ) {
+			if ( f->contains(v) != containsLinear(f, v) )
+				++mismatches;
+		}
+	}
+
+	BOOST_CHECK_EQUAL(mismatches, 0);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 BOOST_AUTO_TEST_CASE(bnaRegions) {
 	GeoFeatureSet features;
@@ -303,6 +367,49 @@ BOOST_AUTO_TEST_CASE(bnaRegions) {
 
 
 
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(featureSetCache) {
+	string cachePath = (boost::filesystem::temp_directory_path() /
+	                    boost::filesystem::unique_path("geo-%%%%-%%%%.bin")).string();
+
+	GeoFeatureSet expected;
+	size_t fileCount = expected.readDir("./data/bna");
+	BOOST_REQUIRE_GT(fileCount, 0);
+
+	// The first call creates the cache, the second one reads it
+	for ( int i = 0; i < 2; ++i ) {
+		GeoFeatureSet features;
+		BOOST_CHECK_EQUAL(features.readDirCached("./data/bna", cachePath), fileCount);
+		BOOST_CHECK(boost::filesystem::exists(cachePath));
+
+		BOOST_REQUIRE_EQUAL(features.categories().size(), expected.categories().size());
+		for ( size_t c = 0; c < expected.categories().size(); ++c ) {
+			BOOST_CHECK_EQUAL(features.categories()[c]->name, expected.categories()[c]->name);
+			BOOST_CHECK_EQUAL(features.categories()[c]->dataDir, expected.categories()[c]->dataDir);
+		}
+
+		BOOST_REQUIRE_EQUAL(features.features().size(), expected.features().size());
+		for ( size_t f = 0; f < expected.features().size(); ++f ) {
+			const GeoFeature *a = features.features()[f];
+			const GeoFeature *b = expected.features()[f];
+			BOOST_CHECK_EQUAL(a->name(), b->name());
+			BOOST_CHECK_EQUAL(a->rank(), b->rank());
+			BOOST_CHECK(a->attributes() == b->attributes());
+			BOOST_CHECK_EQUAL(a->closedPolygon(), b->closedPolygon());
+			BOOST_CHECK(a->subFeatures() == b->subFeatures());
+			BOOST_CHECK(a->vertices() == b->vertices());
+			BOOST_CHECK(a->bbox() == b->bbox());
+			BOOST_CHECK_EQUAL(a->category()->id, b->category()->id);
+		}
+	}
+
+	boost::filesystem::remove(cachePath);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 BOOST_AUTO_TEST_CASE(geojsonRegions) {
 	GeoFeatureSet features;
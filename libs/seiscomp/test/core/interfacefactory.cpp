@@ -0,0 +1,123 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/core/interfacefactory.h>
+#include <seiscomp/core/interfacefactory.ipp>
+#include <seiscomp/unittest/unittests.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+struct Service {
+	virtual ~Service() {}
+};
+
+struct ServiceA : Service {};
+struct ServiceB : Service {};
+
+DEFINE_INTERFACE_FACTORY(Service);
+
+typedef Core::Generic::InterfaceFactory<Service, ServiceA> ServiceAFactory;
+typedef Core::Generic::InterfaceFactory<Service, ServiceB> ServiceBFactory;
+
+// Simulates a plugin which registers its factory when loaded
+unique_ptr<ServiceBFactory> plugin;
+vector<string> requests;
+
+
+bool resolver(const char *serviceName) {
+	requests.push_back(serviceName ? serviceName : "*");
+	if ( plugin ) return false;
+	plugin.reset(new ServiceBFactory("b"));
+	return true;
+}
+
+
+// Removes the resolver and the plugin after each test case
+struct Resolver {
+	Resolver() {
+		requests.clear();
+		Core::Generic::setServiceResolver(resolver);
+	}
+
+	~Resolver() {
+		Core::Generic::setServiceResolver(nullptr);
+		plugin.reset();
+	}
+};
+
+
+ServiceAFactory builtin("a");
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_core_interfacefactory)
+
+
+BOOST_AUTO_TEST_CASE(WithoutResolver) {
+	BOOST_CHECK(ServiceFactory::Find("a") != nullptr);
+	BOOST_CHECK(ServiceFactory::Find("b") == nullptr);
+	BOOST_CHECK_EQUAL(ServiceFactory::ServiceCount(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(ResolveOnDemand) {
+	Resolver r;
+
+	// Registered services do not trigger the resolver
+	unique_ptr<Service> a(ServiceFactory::Create("a"));
+	BOOST_CHECK(a != nullptr);
+	BOOST_CHECK(requests.empty());
+
+	unique_ptr<Service> b(ServiceFactory::Create("b"));
+	BOOST_CHECK(dynamic_cast<ServiceB*>(b.get()) != nullptr);
+	BOOST_REQUIRE_EQUAL(requests.size(), 1);
+	BOOST_CHECK_EQUAL(requests[0], "b");
+
+	// Unknown services are still unknown
+	BOOST_CHECK(ServiceFactory::Find("c") == nullptr);
+	BOOST_CHECK_EQUAL(requests.size(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(ResolveAllForListing) {
+	Resolver r;
+
+	unique_ptr<ServiceFactory::ServiceNames> names(ServiceFactory::Services());
+	BOOST_REQUIRE(names != nullptr);
+	BOOST_CHECK_EQUAL(names->size(), 2);
+	BOOST_REQUIRE(!requests.empty());
+	BOOST_CHECK_EQUAL(requests[0], "*");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/core/metrics.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <thread>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp::Core;
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_core_metrics)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Registry) {
+	Metrics::Counter &counter = Metrics::counter("test.counter");
+	BOOST_CHECK_EQUAL(&counter, &Metrics::counter("test.counter"));
+
+	vector<thread> threads;
+	for ( int i = 0; i < 4; ++i ) {
+		threads.emplace_back([&counter]() {
+			for ( int j = 0; j < 10000; ++j ) {
+				++counter;
+			}
+		});
+	}
+
+	for ( auto &t : threads ) {
+		t.join();
+	}
+
+	BOOST_CHECK_EQUAL(counter.value(), 40000);
+
+	Metrics::gauge("test.gauge").set(7);
+	Metrics::timer("test.timer").record(0.5);
+	Metrics::timer("test.timer").record(0.25);
+
+	auto samples = Metrics::snapshot(true);
+	BOOST_REQUIRE_EQUAL(samples.size(), 3);
+	BOOST_CHECK_EQUAL(samples[0].type, Metrics::Sample::CounterType);
+	BOOST_CHECK_EQUAL(samples[1].name, "test.gauge");
+	BOOST_CHECK_EQUAL(samples[1].value, 7);
+	BOOST_CHECK_EQUAL(samples[2].value, 2);
+	BOOST_CHECK_CLOSE(samples[2].total, 0.75, 1E-6);
+	BOOST_CHECK_CLOSE(samples[2].maximum, 0.5, 1E-6);
+
+	// The maximum has been reset by the snapshot
+	BOOST_CHECK_EQUAL(Metrics::timer("test.timer").maximum(), 0.0);
+	{
+		Metrics::ScopedTimer scope(Metrics::timer("test.timer"));
+	}
+	BOOST_CHECK_EQUAL(Metrics::timer("test.timer").count(), 3);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,97 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/recordpool.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/unittest/unittests.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_core_recordpool)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(RecycleRecords) {
+	RecordPool::setCapacity(4);
+
+	RecordPtr rec = new GenericRecord;
+	const void *address = rec.get();
+	rec = nullptr;
+
+	// The released memory is handed out again
+	rec = new GenericRecord;
+	BOOST_CHECK_EQUAL(rec.get(), address);
+	rec = nullptr;
+
+	RecordPool::setCapacity(0);
+	BOOST_CHECK_EQUAL(RecordPool::capacity(), 0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(RecycleArrays) {
+	RecordPool::setCapacity(4);
+
+	ArrayPtr array = RecordPool::createArray(Array::FLOAT);
+	BOOST_REQUIRE(array);
+	BOOST_CHECK_EQUAL(array->dataType(), Array::FLOAT);
+	array->resize(100);
+	Array *address = array.get();
+
+	// Arrays referenced elsewhere are not recycled
+	ArrayPtr ref = array;
+	RecordPool::recycle(array);
+	BOOST_CHECK(!array);
+	BOOST_CHECK_EQUAL(ref->size(), 100);
+
+	RecordPool::recycle(ref);
+	array = RecordPool::createArray(Array::FLOAT);
+	BOOST_CHECK_EQUAL(array.get(), address);
+	BOOST_CHECK_EQUAL(array->size(), 0);
+
+	// Disabled pool
+	RecordPool::recycle(array);
+	RecordPool::setCapacity(0);
+	array = RecordPool::createArray(Array::FLOAT);
+	BOOST_CHECK(array);
+	BOOST_CHECK_EQUAL(array->size(), 0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
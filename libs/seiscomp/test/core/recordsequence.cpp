@@ -0,0 +1,275 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/packedrecord.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/unittest/unittests.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+GenericRecord *makeRecord(const Core::Time &start, int n, double fs, double first) {
+	DoubleArrayPtr data = new DoubleArray(n);
+	for ( int i = 0; i < n; ++i )
+		(*data)[i] = first + i;
+
+	GenericRecord *rec = new GenericRecord("XX", "TEST", "", "HHZ", start, fs);
+	rec->setData(data.get());
+	return rec;
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_core_recordsequence)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ArrayViewSlice) {
+	DoubleArrayPtr data = new DoubleArray(10);
+	for ( int i = 0; i < 10; ++i )
+		(*data)[i] = i;
+
+	DoubleArrayView view(data.get(), 2, 8);
+	BOOST_CHECK_EQUAL(view.size(), 6);
+	BOOST_CHECK_EQUAL(view.offset(), 2);
+	BOOST_CHECK_EQUAL(view.data(), data->typedData() + 2);
+
+	DoubleArrayView sub = view.slice(4, 100);
+	BOOST_CHECK_EQUAL(sub.size(), 2);
+	BOOST_CHECK_EQUAL(sub.front(), 6);
+	BOOST_CHECK_EQUAL(sub.back(), 7);
+
+	// The view does not take a reference to the array
+	BOOST_CHECK_EQUAL(sub.array(), data.get());
+	BOOST_CHECK_EQUAL(data->referenceCount(), 1);
+
+	// Views over arrays which are not managed by a smart pointer
+	DoubleArray member(*data);
+	{
+		DoubleArrayView local(&member, 2, 8);
+		BOOST_CHECK_EQUAL(local.size(), 6);
+	}
+	BOOST_CHECK_EQUAL(member.referenceCount(), 0);
+
+	DoubleArrayPtr slice = static_cast<DoubleArray*>(data->slice(2, 8));
+	BOOST_CHECK_EQUAL(view.median(), slice->median());
+	BOOST_CHECK_CLOSE(view.rms(1.5), slice->rms(1.5), 1E-12);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ContiguousView) {
+	Core::Time start(1000, 0);
+	RingBuffer seq(0);
+
+	seq.feed(makeRecord(start, 100, 10, 0));
+	seq.feed(makeRecord(start + Core::TimeSpan(10.0), 100, 10, 100));
+
+	// The sequence consists of more than one record
+	BOOST_CHECK(seq.contiguousView<double>().empty());
+
+	// The window spans two records
+	Core::TimeWindow tw(start + Core::TimeSpan(9.0), start + Core::TimeSpan(11.0));
+	BOOST_CHECK(seq.contiguousView<double>(&tw).empty());
+
+	// The data type does not match
+	tw = Core::TimeWindow(start + Core::TimeSpan(12.0), start + Core::TimeSpan(14.0));
+	BOOST_CHECK(seq.contiguousView<float>(&tw).empty());
+
+	Core::Time viewStart;
+	DoubleArrayView view = seq.contiguousView<double>(&tw, &viewStart);
+	BOOST_REQUIRE_EQUAL(view.size(), 20);
+	BOOST_CHECK_EQUAL(view.front(), 120);
+	BOOST_CHECK_EQUAL(view.back(), 139);
+	BOOST_CHECK(viewStart == tw.startTime());
+	BOOST_CHECK_EQUAL(view.data(),
+	                  DoubleArray::ConstCast(seq.back()->data())->typedData() + 20);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ChunkedRingBuffer) {
+	Core::Time start(1000, 0);
+	Seiscomp::ChunkedRingBuffer seq(Core::TimeSpan(60.0), 250);
+
+	// Continuous records are merged into chunks of at most 250 samples
+	for ( int i = 0; i < 4; ++i ) {
+		RecordPtr rec = makeRecord(start + Core::TimeSpan(10.0 * i), 100, 10, 100 * i);
+		BOOST_CHECK(seq.feed(rec.get()));
+	}
+
+	BOOST_REQUIRE_EQUAL(seq.size(), 2);
+	BOOST_CHECK_EQUAL(seq.front()->sampleCount(), 200);
+	BOOST_CHECK_EQUAL(seq.back()->sampleCount(), 200);
+	BOOST_CHECK(seq.timeWindow().endTime() == start + Core::TimeSpan(40.0));
+
+	// The window spans two input records but only one chunk
+	Core::TimeWindow tw(start + Core::TimeSpan(29.0), start + Core::TimeSpan(31.0));
+	DoubleArrayView view = seq.contiguousView<double>(&tw);
+	BOOST_REQUIRE_EQUAL(view.size(), 20);
+	BOOST_CHECK_EQUAL(view.front(), 290);
+	BOOST_CHECK_EQUAL(view.back(), 309);
+
+	BOOST_CHECK(seq.lowerBound(start + Core::TimeSpan(25.0)) == seq.begin() + 1);
+	BOOST_CHECK(seq.lowerBound(start + Core::TimeSpan(50.0)) == seq.end());
+
+	// A chunk which is referenced outside the buffer is not extended
+	RecordCPtr last = seq.back();
+	RecordPtr rec = makeRecord(start + Core::TimeSpan(40.0), 10, 10, 400);
+	BOOST_CHECK(seq.feed(rec.get()));
+	BOOST_CHECK_EQUAL(seq.size(), 3);
+	BOOST_CHECK_EQUAL(last->sampleCount(), 200);
+
+	// Duplicates are rejected
+	BOOST_CHECK(!seq.feed(rec.get()));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(PackedRecords) {
+	Core::Time start(1000, 0);
+	RingBuffer seq(0);
+	seq.setPackRecords(true);
+
+	seq.feed(makeRecord(start, 1000, 10, -500));
+	seq.feed(makeRecord(start + Core::TimeSpan(100.0), 1000, 10, 500));
+
+	BOOST_REQUIRE_EQUAL(seq.size(), 2);
+	const PackedRecord *packed = PackedRecord::ConstCast(seq.front().get());
+	BOOST_REQUIRE(packed != nullptr);
+	BOOST_CHECK(packed->isPacked());
+	BOOST_CHECK(packed->byteSize() < 1000 * sizeof(double));
+	BOOST_CHECK_EQUAL(packed->sampleCount(), 1000);
+
+	// Random access decoding across block boundaries
+	vector<double> samples(300);
+	BOOST_REQUIRE(packed->decode(100, 400, samples.data()));
+	for ( int i = 0; i < 300; ++i )
+		BOOST_CHECK_EQUAL(samples[i], -400 + i);
+
+	BOOST_CHECK(!packed->decode(900, 1001, samples.data()));
+
+	// Decoding on demand keeps the data type of the input record
+	const DoubleArray *data = DoubleArray::ConstCast(packed->data());
+	BOOST_REQUIRE(data != nullptr);
+	BOOST_CHECK_EQUAL((*data)[999], 499);
+
+	// Contiguous records are decoded without touching the stored samples
+	GenericRecordPtr merged = seq.contiguousRecord<double>();
+	BOOST_REQUIRE(merged);
+	data = DoubleArray::ConstCast(merged->data());
+	BOOST_REQUIRE_EQUAL(data->size(), 2000);
+	BOOST_CHECK_EQUAL((*data)[1000], 500);
+
+	// Samples with fractions are not packed
+	RecordPtr rec = makeRecord(start, 10, 10, 0.5);
+	RecordPtr copy = PackedRecord::Create(rec.get());
+	BOOST_CHECK(!copy);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ClipMasks) {
+	Core::Time start(1000, 0);
+	RingBuffer seq(0);
+
+	GenericRecordPtr first = makeRecord(start, 100, 10, 0);
+	GenericRecordPtr second = makeRecord(start + Core::TimeSpan(10.0), 100, 10, 100);
+	GenericRecordPtr third = makeRecord(start + Core::TimeSpan(20.0), 100, 10, 200);
+
+	BitSetPtr mask = new BitSet(100);
+	mask->set(5); mask->set(6); mask->set(99);
+	second->setClipMask(mask.get());
+	third->setClipMask(mask.get());
+
+	seq.feed(first.get());
+	seq.feed(second.get());
+
+	// The clip mask of the third record is stored as runs
+	seq.setPackRecords(true);
+	seq.feed(third.get());
+
+	const PackedRecord *packed = PackedRecord::ConstCast(seq.back().get());
+	BOOST_REQUIRE(packed != nullptr);
+	BOOST_CHECK_EQUAL(packed->clipRuns().runs().size(), 2);
+	BOOST_CHECK_EQUAL(packed->clipRuns().numberOfBitsSet(), 3);
+	BOOST_REQUIRE(packed->clipMask() != nullptr);
+	BOOST_CHECK(packed->clipMask()->impl() == mask->impl());
+
+	GenericRecordPtr merged = seq.contiguousRecord<double>();
+	BOOST_REQUIRE(merged);
+	BOOST_REQUIRE(merged->clipMask() != nullptr);
+	BOOST_CHECK_EQUAL(merged->clipMask()->size(), 300);
+	BOOST_CHECK_EQUAL(merged->clipMask()->numberOfBitsSet(), 6);
+	BOOST_CHECK(merged->clipMask()->test(105));
+	BOOST_CHECK(merged->clipMask()->test(206));
+	BOOST_CHECK(merged->clipMask()->test(299));
+	BOOST_CHECK(!merged->clipMask()->test(5));
+
+	// Without clipped samples no mask is created
+	Core::TimeWindow tw(start, start + Core::TimeSpan(5.0));
+	merged = seq.contiguousRecord<double>(&tw);
+	BOOST_REQUIRE(merged);
+	BOOST_CHECK(merged->clipMask() == nullptr);
+
+	// Word level merge of a range
+	BitSet target(10);
+	target.set(0);
+	target.orRange(8, *mask, 4, 4);
+	BOOST_CHECK_EQUAL(target.size(), 12);
+	BOOST_CHECK_EQUAL(target.numberOfBitsSet(), 3);
+	BOOST_CHECK(target.test(9) && target.test(10));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,391 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/math/filter.h>
+#include <seiscomp/math/mean.h>
+#include <seiscomp/math/orderstatistics.h>
+#include <seiscomp/math/filter/median.h>
+#include <seiscomp/math/filter/minmax.h>
+
+
+using namespace std;
+using namespace Seiscomp::Math;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+vector<double> createData(size_t n, unsigned int seed = 42) {
+	mt19937 gen(seed);
+	normal_distribution<double> dist(10.0, 3.0);
+	vector<double> data(n);
+	for ( auto &v : data ) {
+		// Quantize to provoke duplicate values
+		v = round(dist(gen) * 100) / 100;
+	}
+	return data;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! The former implementation based on a full sort
+double sortedMedian(vector<double> v) {
+	sort(v.begin(), v.end());
+	size_t mid = v.size() / 2;
+	return (v.size() % 2) ? v[mid] : (v[mid-1] + v[mid]) / 2;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! The former implementation based on a full sort
+double sortedFractile(vector<double> v, double x) {
+	sort(v.begin(), v.end());
+	double i = double(v.size()-1)*x;
+	double diff = double(int(i))-i;
+	if ( diff == 0 )
+		return v[int(i)];
+	return (v[int(i)]-v[int(i)+1])*diff + v[int(i)];
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Brute force running window filter where the window is initialized with
+//! the first sample
+template <typename F>
+vector<double> runningWindow(const vector<double> &data, size_t length, F f) {
+	vector<double> result(data.size());
+	for ( size_t i = 0; i < data.size(); ++i ) {
+		vector<double> window;
+		for ( size_t j = 0; j < length; ++j )
+			window.push_back(i + j + 1 >= length ? data[i + j + 1 - length] : data[0]);
+		result[i] = f(window);
+	}
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Applies a filter in chunks of varying size
+vector<double> applyFilter(Filtering::InPlaceFilter<double> &filter,
+                           const vector<double> &data) {
+	vector<double> result(data);
+	size_t offset = 0, chunk = 1;
+	while ( offset < result.size() ) {
+		size_t n = min(chunk, result.size() - offset);
+		filter.apply(n, &result[offset]);
+		offset += n;
+		chunk = chunk * 2 + 1;
+	}
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename F>
+long long measure(int loops, F f) {
+	auto start = chrono::steady_clock::now();
+	for ( int i = 0; i < loops; ++i )
+		f();
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_core_statistics)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MEAN_RMS) {
+	for ( size_t n : { 1, 2, 3, 4, 5, 7, 8, 100, 1001 } ) {
+		vector<double> data = createData(n);
+		double sum = 0, sum2 = 0;
+		for ( auto v : data ) {
+			sum += v;
+			sum2 += v * v;
+		}
+
+		BOOST_CHECK_CLOSE(Statistics::mean(data), sum / n, 1E-10);
+		BOOST_CHECK_CLOSE(Statistics::rms(data), sqrt(sum2 / n), 1E-10);
+
+		double m = Statistics::mean(data);
+		double dev = 0;
+		for ( auto v : data )
+			dev += (v - m) * (v - m);
+		BOOST_CHECK_CLOSE(Statistics::rms(data, m) + 1, sqrt(dev / n) + 1, 1E-10);
+
+		double fmin, fmax;
+		::minmax(data, 0, (int)n, &fmin, &fmax);
+		BOOST_CHECK_EQUAL(fmin, *min_element(data.begin(), data.end()));
+		BOOST_CHECK_EQUAL(fmax, *max_element(data.begin(), data.end()));
+	}
+
+	BOOST_CHECK_THROW(Statistics::rms(0, nullptr), std::out_of_range);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MEDIAN_FRACTILE) {
+	for ( size_t n : { 1, 2, 3, 4, 5, 10, 11, 100, 1001 } ) {
+		vector<double> data = createData(n, n);
+		BOOST_CHECK_EQUAL(Statistics::median(data), sortedMedian(data));
+
+		for ( double x : { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0 } )
+			BOOST_CHECK_EQUAL(Statistics::fractile(data, x), sortedFractile(data, x));
+	}
+
+	BOOST_CHECK_THROW(Statistics::median(0, nullptr), std::out_of_range);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(RUNNING_FILTERS) {
+	vector<double> data = createData(2000);
+
+	// Monotonic sections are the worst case for a rescanning min/max
+	for ( size_t i = 500; i < 1000; ++i )
+		data[i] = i * 0.01;
+
+	for ( int length : { 1, 2, 3, 9, 10, 11, 50 } ) {
+		auto minimum = runningWindow(data, length, [](const vector<double> &w) {
+			return *min_element(w.begin(), w.end());
+		});
+		auto maximum = runningWindow(data, length, [](const vector<double> &w) {
+			return *max_element(w.begin(), w.end());
+		});
+		auto median = runningWindow(data, length, sortedMedian);
+
+		Filtering::Min<double> minFilter(length, 1.0);
+		Filtering::Max<double> maxFilter(length, 1.0);
+		Filtering::Median<double> medianFilter(length, 1.0);
+
+		BOOST_CHECK(applyFilter(minFilter, data) == minimum);
+		BOOST_CHECK(applyFilter(maxFilter, data) == maximum);
+		BOOST_CHECK(applyFilter(medianFilter, data) == median);
+
+		// The filter state must be reset completely
+		minFilter.reset();
+		medianFilter.reset();
+		BOOST_CHECK(applyFilter(minFilter, data) == minimum);
+		BOOST_CHECK(applyFilter(medianFilter, data) == median);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ORDER_STATISTICS) {
+	Statistics::OrderStatistics stats;
+	map<Statistics::OrderStatistics::Handle, double> values;
+	vector<double> pool = createData(2000, 7);
+	mt19937 gen(11);
+
+	BOOST_CHECK(stats.empty());
+	BOOST_CHECK_THROW(stats.median(), std::out_of_range);
+
+	for ( size_t step = 0; step < pool.size(); ++step ) {
+		size_t op = gen() % 4;
+		if ( op < 2 || values.size() < 3 ) {
+			auto handle = stats.insert(pool[step]);
+			BOOST_CHECK(!values.count(handle));
+			values[handle] = pool[step];
+		}
+		else {
+			auto it = values.begin();
+			advance(it, gen() % values.size());
+			if ( op == 2 ) {
+				BOOST_CHECK(stats.remove(it->first));
+				BOOST_CHECK(!stats.remove(it->first));
+				values.erase(it);
+			}
+			else {
+				BOOST_CHECK(stats.update(it->first, pool[step]));
+				it->second = pool[step];
+			}
+		}
+
+		vector<double> data;
+		for ( const auto &item : values )
+			data.push_back(item.second);
+
+		BOOST_REQUIRE_EQUAL(stats.size(), data.size());
+
+		double value, stdev, expectedValue, expectedStdev;
+		vector<double> weights;
+
+		BOOST_CHECK_EQUAL(stats.median(), Statistics::median(data));
+
+		BOOST_CHECK(stats.mean(value, stdev));
+		Statistics::computeMean(data, expectedValue, expectedStdev);
+		BOOST_CHECK_CLOSE(value, expectedValue, 1E-9);
+		BOOST_CHECK_CLOSE(stdev + 1, expectedStdev + 1, 1E-9);
+
+		for ( double percent : { 0.0, 25.0, 50.0 } ) {
+			BOOST_CHECK(stats.trimmedMean(percent, value, stdev));
+			Statistics::computeTrimmedMean(data, percent, expectedValue, expectedStdev, &weights);
+			BOOST_CHECK_CLOSE(value, expectedValue, 1E-9);
+			BOOST_CHECK_CLOSE(stdev + 1, expectedStdev + 1, 1E-9);
+
+			// Equal values may swap their weights, compare the sums
+			map<double, double> expectedWeights, actualWeights;
+			size_t i = 0;
+			for ( const auto &item : values ) {
+				expectedWeights[item.second] += weights[i++];
+				actualWeights[item.second] += stats.trimmedMeanWeight(item.first, percent);
+			}
+
+			for ( const auto &item : expectedWeights )
+				BOOST_CHECK_CLOSE(actualWeights[item.first] + 1, item.second + 1, 1E-9);
+		}
+
+		BOOST_CHECK(stats.medianTrimmedMean(0.5, value, stdev));
+		Statistics::computeMedianTrimmedMean(data, 0.5, expectedValue, expectedStdev, &weights);
+		// No value is close enough if the two middle values are far apart
+		if ( std::isnan(expectedValue) )
+			BOOST_CHECK(std::isnan(value));
+		else {
+			BOOST_CHECK_CLOSE(value, expectedValue, 1E-9);
+			BOOST_CHECK_CLOSE(stdev + 1, expectedStdev + 1, 1E-9);
+		}
+
+		size_t i = 0;
+		for ( const auto &item : values ) {
+			BOOST_CHECK_EQUAL(stats.medianTrimmedMeanWeight(item.first, 0.5), weights[i++]);
+			BOOST_CHECK_EQUAL(stats.at(stats.rank(item.first)), item.second);
+		}
+	}
+
+	stats.clear();
+	double value, stdev;
+	BOOST_CHECK(stats.empty());
+	BOOST_CHECK(!stats.mean(value, stdev));
+	BOOST_CHECK_THROW(stats.value(0), std::out_of_range);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(STATISTICS_BENCHMARK) {
+	const int loops = 200;
+	vector<double> data = createData(20000);
+	volatile double sink = 0;
+
+	auto scalarMean = measure(loops, [&]() {
+		double m = 0;
+		for ( auto v : data ) m += v;
+		sink = m / data.size();
+	});
+	auto kernelMean = measure(loops, [&]() { sink = Statistics::mean(data); });
+
+	auto scalarRms = measure(loops, [&]() {
+		double s = 0;
+		for ( auto v : data ) s += v * v;
+		sink = sqrt(s / data.size());
+	});
+	auto kernelRms = measure(loops, [&]() { sink = Statistics::rms(data); });
+
+	auto sortMedian = measure(loops, [&]() { sink = sortedMedian(data); });
+	auto selectMedian = measure(loops, [&]() { sink = Statistics::median(data); });
+
+	BOOST_TEST_MESSAGE(data.size() << " samples x " << loops
+	                   << ": mean scalar " << scalarMean << " us, kernel " << kernelMean
+	                   << " us; rms scalar " << scalarRms << " us, kernel " << kernelRms
+	                   << " us; median sort " << sortMedian << " us, select " << selectMedian
+	                   << " us");
+
+	vector<double> trace = createData(100000);
+	vector<double> decreasing(trace.size());
+	for ( size_t i = 0; i < decreasing.size(); ++i )
+		decreasing[i] = -double(i);
+
+	for ( int length : { 10, 100, 1000 } ) {
+		Filtering::Median<double> medianFilter(length, 1.0);
+		Filtering::Max<double> maxFilter(length, 1.0);
+
+		auto median = measure(1, [&]() { applyFilter(medianFilter, trace); });
+		auto maximum = measure(1, [&]() { applyFilter(maxFilter, trace); });
+		maxFilter.reset();
+		auto worstMaximum = measure(1, [&]() { applyFilter(maxFilter, decreasing); });
+
+		BOOST_TEST_MESSAGE(trace.size() << " samples, window " << length
+		                   << ": running median " << median << " us, max "
+		                   << maximum << " us, max of decreasing samples "
+		                   << worstMaximum << " us");
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
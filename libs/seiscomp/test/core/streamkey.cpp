@@ -0,0 +1,81 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/streamkey.h>
+#include <seiscomp/unittest/unittests.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_core_streamkey)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Intern) {
+	BOOST_CHECK(!StreamKey().isValid());
+	BOOST_CHECK(!StreamKey::Find("XX", "TEST1", "", "HHZ").isValid());
+
+	StreamKey key = StreamKey::Intern("XX", "TEST1", "", "HHZ");
+	BOOST_CHECK(key.isValid());
+	BOOST_CHECK(key == StreamKey::Intern("XX", "TEST1", "", "HHZ"));
+	BOOST_CHECK(key == StreamKey::Find("XX", "TEST1", "", "HHZ"));
+	BOOST_CHECK_EQUAL(key.toString(), "XX.TEST1..HHZ");
+	BOOST_CHECK_EQUAL(key.stationCode(), "TEST1");
+
+	// Codes must not be mixed up by concatenation
+	BOOST_CHECK(key != StreamKey::Intern("XXT", "EST1", "", "HHZ"));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(RecordKey) {
+	GenericRecord rec("XX", "TEST2", "00", "BHZ", Core::Time(0, 0), 20);
+	StreamKey key = rec.streamKey();
+	BOOST_CHECK_EQUAL(key.toString(), rec.streamID());
+
+	// Changing a code invalidates the cached key
+	rec.setChannelCode("BHN");
+	BOOST_CHECK(rec.streamKey() != key);
+	BOOST_CHECK_EQUAL(rec.streamKey().toString(), "XX.TEST2.00.BHN");
+
+	GenericRecord copy(rec);
+	BOOST_CHECK(copy.streamKey() == rec.streamKey());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -421,6 +421,60 @@ BOOST_AUTO_TEST_CASE(split1) {
 	}
 }
 
+BOOST_AUTO_TEST_CASE(tokens) {
+	// The tokens must match split for all compression modes
+	const char *sources[] = {
+		"", ",", ",,", "a", "a,b", "a,,b", ",a", "a,", ",,a,,b,,", "a b\tc"
+	};
+
+	for ( const char *source : sources ) {
+		for ( bool compressOn : { true, false } ) {
+			vector<string> expected, result;
+			split(expected, source, ", \t", compressOn);
+			for ( string_view tok : Tokens(source, ", \t", compressOn) )
+				result.emplace_back(tok);
+			BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+			                              expected.begin(), expected.end());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(fromCharsConversions) {
+	int i = 0;
+	BOOST_CHECK(fromChars(i, string_view("1234,", 4)));
+	BOOST_CHECK_EQUAL(i, 1234);
+	BOOST_CHECK(fromChars(i, "-12"));
+	BOOST_CHECK_EQUAL(i, -12);
+	BOOST_CHECK(!fromChars(i, ""));
+	BOOST_CHECK(!fromChars(i, " 12"));
+	BOOST_CHECK(!fromChars(i, "12a"));
+	BOOST_CHECK(!fromChars(i, "99999999999"));
+	BOOST_CHECK_EQUAL(i, -12);
+
+	unsigned int u;
+	BOOST_CHECK(fromChars(u, "1A2f", 16));
+	BOOST_CHECK_EQUAL(u, 0x1a2fu);
+	BOOST_CHECK(!fromChars(u, "-1"));
+
+	int8_t c;
+	BOOST_CHECK(!fromChars(c, "128"));
+	BOOST_CHECK(fromChars(c, "-128"));
+	BOOST_CHECK_EQUAL(int(c), -128);
+
+	double d;
+	BOOST_CHECK(fromChars(d, "1.5e-3"));
+	BOOST_CHECK_EQUAL(d, 1.5e-3);
+	BOOST_CHECK(fromChars(d, string_view("-2.25 ", 5)));
+	BOOST_CHECK_EQUAL(d, -2.25);
+	BOOST_CHECK(!fromChars(d, "1.5x"));
+	BOOST_CHECK(!fromChars(d, ""));
+
+	float f;
+	BOOST_CHECK(fromChars(f, "0.1"));
+	BOOST_CHECK_EQUAL(f, 0.1f);
+	BOOST_CHECK(!fromChars(f, "1e300"));
+}
+
 BOOST_AUTO_TEST_CASE(splitExtNoUnescape) {
 	typedef vector<TestCase> TestData;
 
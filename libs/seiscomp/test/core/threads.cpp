@@ -0,0 +1,88 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/system/threads.h>
+#include <seiscomp/unittest/unittests.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_system_threads)
+
+
+BOOST_AUTO_TEST_CASE(ParseCPUList) {
+	vector<int> cpus;
+
+	BOOST_REQUIRE(System::parseCPUList(cpus, "0-3, 8,10-11"));
+	BOOST_CHECK_EQUAL(cpus.size(), 7);
+	BOOST_CHECK_EQUAL(cpus[0], 0);
+	BOOST_CHECK_EQUAL(cpus[3], 3);
+	BOOST_CHECK_EQUAL(cpus[4], 8);
+	BOOST_CHECK_EQUAL(cpus[6], 11);
+
+	BOOST_REQUIRE(System::parseCPUList(cpus, ""));
+	BOOST_CHECK(cpus.empty());
+
+	BOOST_CHECK(!System::parseCPUList(cpus, "3-1"));
+	BOOST_CHECK(!System::parseCPUList(cpus, "a"));
+	BOOST_CHECK(!System::parseCPUList(cpus, "-1"));
+}
+
+
+BOOST_AUTO_TEST_CASE(StartThread) {
+	System::ThreadPlacement placement;
+	placement.cpus.push_back(0);
+	System::setThreadPlacement("test-worker", placement);
+
+	string name;
+	int cpuCount = -1;
+
+	thread t = System::startThread("test-worker", [&]() {
+#ifdef __linux__
+		char buf[16];
+		pthread_getname_np(pthread_self(), buf, sizeof(buf));
+		name = buf;
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+		cpuCount = CPU_COUNT(&set);
+#endif
+	});
+	t.join();
+
+	System::clearThreadPlacements();
+
+#ifdef __linux__
+	BOOST_CHECK_EQUAL(name, "test-worker");
+	BOOST_CHECK_EQUAL(cpuCount, 1);
+#endif
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
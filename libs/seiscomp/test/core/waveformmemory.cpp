@@ -0,0 +1,219 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/core/waveformmemory.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <boost/filesystem.hpp>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+GenericRecord *makeRecord(const Core::Time &start, int n, double fs, double first) {
+	DoubleArrayPtr data = new DoubleArray(n);
+	for ( int i = 0; i < n; ++i )
+		(*data)[i] = first + i;
+
+	GenericRecord *rec = new GenericRecord("XX", "TEST", "", "HHZ", start, fs);
+	rec->setData(data.get());
+	return rec;
+}
+
+
+void feed(RecordSequence &seq, const Core::Time &start, int records) {
+	for ( int i = 0; i < records; ++i ) {
+		RecordPtr rec = makeRecord(start + Core::TimeSpan(i * 10, 0), 1000, 100, i * 1000);
+		seq.feed(rec.get());
+	}
+}
+
+
+// Resets the budget after each test case
+struct Budget {
+	Budget(size_t bytes, const string &spillDirectory = string()) {
+		WaveformMemory::Instance().setBudget(bytes);
+		WaveformMemory::Instance().setSpillDirectory(spillDirectory);
+	}
+
+	~Budget() {
+		WaveformMemory::Instance().setBudget(0);
+		WaveformMemory::Instance().setSpillDirectory(string());
+	}
+};
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_core_waveformmemory)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Accounting) {
+	size_t before = WaveformMemory::Instance().statistics().bytes;
+	Core::Time start(1000, 0);
+
+	{
+		RingBuffer seq(5);
+		feed(seq, start, 10);
+
+		size_t perRecord = WaveformMemory::MemoryUsage(seq.front().get());
+		BOOST_CHECK_GE(perRecord, 8000u);
+		BOOST_CHECK_EQUAL(seq.memoryUsage(), 5 * perRecord);
+		BOOST_CHECK_EQUAL(WaveformMemory::Instance().statistics().bytes, before + 5 * perRecord);
+
+		RecordSequence *cp = seq.copy();
+		BOOST_CHECK_EQUAL(cp->memoryUsage(), seq.memoryUsage());
+		delete cp;
+
+		seq.reset();
+		BOOST_CHECK_EQUAL(seq.memoryUsage(), 0u);
+		BOOST_CHECK_EQUAL(WaveformMemory::Instance().statistics().bytes, before);
+
+		feed(seq, start, 2);
+	}
+
+	BOOST_CHECK_EQUAL(WaveformMemory::Instance().statistics().bytes, before);
+
+	ChunkedRingBuffer chunked(Core::TimeSpan(100, 0), 4096);
+	feed(chunked, start, 20);
+	size_t bytes = 0;
+	for ( const RecordCPtr &rec : chunked )
+		bytes += WaveformMemory::MemoryUsage(rec.get());
+	BOOST_CHECK_EQUAL(chunked.memoryUsage(), bytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(EvictLeastRecentlyUsed) {
+	Core::Time start(1000, 0);
+	size_t base = WaveformMemory::Instance().statistics().bytes;
+
+	TimeWindowBuffer a(Core::TimeWindow(start, start + Core::TimeSpan(1000, 0)));
+	TimeWindowBuffer b(a.timeWindowToStore());
+	TimeWindowBuffer pinned(a.timeWindowToStore());
+	a.setEvictable(true);
+	b.setEvictable(true);
+
+	feed(a, start, 10);
+	feed(b, start, 10);
+	feed(pinned, start, 10);
+
+	// Use a after b
+	BOOST_CHECK(a.restore());
+
+	Budget budget(base + a.memoryUsage() + b.memoryUsage() + pinned.memoryUsage());
+
+	TimeWindowBuffer c(a.timeWindowToStore());
+	c.setEvictable(true);
+	feed(c, start, 1);
+
+	BOOST_CHECK(b.isEvicted());
+	BOOST_CHECK(b.empty());
+	BOOST_CHECK_EQUAL(b.memoryUsage(), 0u);
+	BOOST_CHECK(!a.isEvicted());
+	BOOST_CHECK(!pinned.isEvicted());
+	BOOST_CHECK_EQUAL(c.size(), 1u);
+
+	// Without a spill directory the records are lost
+	BOOST_CHECK(!b.restore());
+	BOOST_CHECK(!b.isEvicted());
+	BOOST_CHECK(b.empty());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(SpillAndRestore) {
+	Core::Time start(1000, 0);
+	size_t base = WaveformMemory::Instance().statistics().bytes;
+
+	boost::filesystem::path dir = boost::filesystem::temp_directory_path()
+	                            / boost::filesystem::unique_path();
+
+	RingBuffer a(Core::TimeSpan(1000, 0));
+	RingBuffer b(Core::TimeSpan(1000, 0));
+	a.setEvictable(true);
+	feed(a, start, 10);
+
+	WaveformMemory::Statistics stats = WaveformMemory::Instance().statistics();
+
+	{
+		Budget budget(base + a.memoryUsage() + 1, dir.string());
+
+		// Exceeds the budget and evicts a
+		feed(b, start, 1);
+		BOOST_REQUIRE(a.isEvicted());
+		BOOST_CHECK(a.empty());
+
+		// Records fed after the eviction are merged
+		RecordPtr rec = makeRecord(start + Core::TimeSpan(100, 0), 1000, 100, 10000);
+		a.feed(rec.get());
+		BOOST_CHECK_EQUAL(a.size(), 1u);
+	}
+
+	BOOST_CHECK(a.restore());
+	BOOST_CHECK(!a.isEvicted());
+	BOOST_REQUIRE_EQUAL(a.size(), 11u);
+
+	double expected = 0;
+	for ( const RecordCPtr &rec : a ) {
+		const DoubleArray *data = DoubleArray::ConstCast(rec->data());
+		BOOST_REQUIRE(data);
+		BOOST_CHECK_EQUAL((*data)[0], expected);
+		BOOST_CHECK_EQUAL(rec->samplingFrequency(), 100);
+		expected += 1000;
+	}
+
+	WaveformMemory::Statistics now = WaveformMemory::Instance().statistics();
+	BOOST_CHECK_EQUAL(now.spills, stats.spills + 1);
+	BOOST_CHECK_EQUAL(now.restores, stats.restores + 1);
+	BOOST_CHECK(boost::filesystem::is_empty(dir));
+
+	boost::filesystem::remove_all(dir);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -169,6 +169,39 @@ BOOST_AUTO_TEST_CASE(TIMESPAN) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(PREFETCH) {
+	PublicObject::SetRegistrationEnabled(true);
+
+	PublicObjectRingBuffer buffer(nullptr, 10);
+	PickPtr pick1 = Pick::Create();
+	PickPtr pick2 = Pick::Create();
+	AmplitudePtr amp = Amplitude::Create();
+
+	// Registered objects of the requested type are fed, nothing is read
+	// without database
+	vector<string> ids = {
+		pick1->publicID(), pick2->publicID(), pick1->publicID(),
+		amp->publicID(), "Pick/unknown"
+	};
+	BOOST_CHECK_EQUAL(buffer.prefetch<Pick>(ids), 0);
+	BOOST_CHECK_EQUAL(buffer.size(), 2);
+	BOOST_CHECK(buffer.contains(pick1.get()));
+	BOOST_CHECK(buffer.contains(pick2.get()));
+	BOOST_CHECK(!buffer.contains(amp->publicID()));
+	BOOST_CHECK(!buffer.contains("Pick/unknown"));
+
+	// Released objects are still found through the cache
+	string publicID = pick1->publicID();
+	pick1 = nullptr;
+	BOOST_CHECK(buffer.get<Pick>(publicID));
+	BOOST_CHECK(buffer.cached());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_SUITE_END()
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
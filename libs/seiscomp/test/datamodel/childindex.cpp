@@ -0,0 +1,123 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/datamodel/eventparameters.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_childindex)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Arrivals) {
+	OriginPtr origin = Origin::Create();
+	const int count = 100;
+
+	// Crosses the size at which the index is built
+	for ( int i = 0; i < count; ++i ) {
+		ArrivalPtr arrival = new Arrival;
+		arrival->setPickID("Pick/" + Core::toString(i));
+		BOOST_CHECK(origin->add(arrival.get()));
+		BOOST_CHECK_EQUAL(origin->arrival(arrival->index()), arrival.get());
+	}
+
+	ArrivalPtr duplicate = new Arrival;
+	duplicate->setPickID("Pick/50");
+	BOOST_CHECK(!origin->add(duplicate.get()));
+	BOOST_CHECK_EQUAL(origin->arrivalCount(), size_t(count));
+
+	for ( int i = 0; i < count; ++i ) {
+		Arrival *arrival = origin->arrival(ArrivalIndex("Pick/" + Core::toString(i)));
+		BOOST_REQUIRE(arrival != nullptr);
+		BOOST_CHECK_EQUAL(arrival->pickID(), "Pick/" + Core::toString(i));
+	}
+
+	BOOST_CHECK(origin->arrival(ArrivalIndex("Pick/100")) == nullptr);
+
+	BOOST_CHECK(origin->removeArrival(ArrivalIndex("Pick/50")));
+	BOOST_CHECK(origin->arrival(ArrivalIndex("Pick/50")) == nullptr);
+	BOOST_CHECK(origin->removeArrival(size_t(0)));
+	BOOST_CHECK(origin->arrival(ArrivalIndex("Pick/0")) == nullptr);
+	BOOST_CHECK_EQUAL(origin->arrivalCount(), size_t(count - 2));
+
+	// The removed index can be added again
+	BOOST_CHECK(origin->add(duplicate.get()));
+	BOOST_CHECK_EQUAL(origin->arrival(ArrivalIndex("Pick/50")), duplicate.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Picks) {
+	// Without registration the same publicID can be added twice
+	PublicObject::SetRegistrationEnabled(false);
+
+	EventParametersPtr ep = new EventParameters;
+	PickPtr first = new Pick("Pick/dup");
+
+	for ( int i = 0; i < 50; ++i )
+		BOOST_CHECK(ep->add(new Pick("Pick/" + Core::toString(i))));
+
+	PickPtr second = new Pick("Pick/dup");
+	BOOST_CHECK(ep->add(first.get()));
+	BOOST_CHECK(ep->add(second.get()));
+
+	PublicObject::SetRegistrationEnabled(true);
+
+	BOOST_CHECK_EQUAL(ep->findPick("Pick/10"), ep->pick(10));
+	BOOST_CHECK_EQUAL(ep->findPick("Pick/dup"), first.get());
+	BOOST_CHECK(ep->findPick("Pick/unknown") == nullptr);
+
+	// The second pick with the same publicID takes over
+	BOOST_CHECK(ep->remove(first.get()));
+	BOOST_CHECK_EQUAL(ep->findPick("Pick/dup"), second.get());
+	BOOST_CHECK(ep->remove(second.get()));
+	BOOST_CHECK(ep->findPick("Pick/dup") == nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,168 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/datamodel/diff.h>
+#include <seiscomp/datamodel/eventparameters.h>
+#include <seiscomp/datamodel/origin.h>
+
+#include <algorithm>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OriginPtr createOrigin(const string &publicID, int arrivals, bool reverse) {
+	OriginPtr origin = new Origin(publicID);
+	vector<int> order;
+	for ( int i = 0; i < arrivals; ++i ) order.push_back(i);
+	if ( reverse ) std::reverse(order.begin(), order.end());
+
+	for ( int i : order ) {
+		ArrivalPtr arrival = new Arrival;
+		arrival->setPickID(publicID + "/Pick/" + Core::toString(i));
+		arrival->setPhase(Phase("P"));
+		arrival->setWeight(1.0);
+		origin->add(arrival.get());
+	}
+
+	return origin;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string describe(const Diff2::Notifiers &notifiers) {
+	string desc;
+	for ( auto &n : notifiers ) {
+		desc += n->operation().toString();
+		desc += " " + n->parentID() + " " + n->object()->className() + "\n";
+	}
+	return desc;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_diff)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MatchByIndex) {
+	PublicObject::SetRegistrationEnabled(false);
+
+	// The arrivals are matched by their pickID regardless of their order
+	OriginPtr o1 = createOrigin("Origin/1", 500, false);
+	OriginPtr o2 = createOrigin("Origin/1", 500, true);
+
+	Diff2 diff;
+	Diff2::Notifiers notifiers;
+	diff.diff(o1.get(), o2.get(), "", notifiers);
+	BOOST_CHECK(notifiers.empty());
+
+	o2->arrival(ArrivalIndex("Origin/1/Pick/10"))->setWeight(0.5);
+	o2->removeArrival(ArrivalIndex("Origin/1/Pick/20"));
+	ArrivalPtr arrival = new Arrival;
+	arrival->setPickID("Origin/1/Pick/500");
+	o2->add(arrival.get());
+
+	diff.diff(o1.get(), o2.get(), "", notifiers);
+	BOOST_CHECK_EQUAL(describe(notifiers),
+	                  "update Origin/1 Arrival\n"
+	                  "remove Origin/1 Arrival\n"
+	                  "add Origin/1 Arrival\n");
+
+	PublicObject::SetRegistrationEnabled(true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Parallel) {
+	PublicObject::SetRegistrationEnabled(false);
+
+	EventParametersPtr ep1 = new EventParameters;
+	EventParametersPtr ep2 = new EventParameters;
+
+	for ( int i = 0; i < 20; ++i ) {
+		string publicID = "Origin/" + Core::toString(i);
+		OriginPtr o1 = createOrigin(publicID, 50, false);
+		OriginPtr o2 = createOrigin(publicID, 50 + i % 3, i % 2);
+		if ( i % 4 == 0 ) o2->setMethodID("changed");
+		if ( i != 5 ) ep1->add(o1.get());
+		if ( i != 7 ) ep2->add(o2.get());
+	}
+
+	Diff2 sequential;
+	Diff2::Notifiers expected;
+	Diff2::LogNodePtr expectedLog = new Diff2::LogNode("", Diff2::LogNode::ALL);
+	sequential.diff(ep1.get(), ep2.get(), "", expected, expectedLog.get());
+	BOOST_CHECK(!expected.empty());
+
+	Diff2 parallel;
+	parallel.setThreads(4);
+	Diff2::Notifiers notifiers;
+	Diff2::LogNodePtr log = new Diff2::LogNode("", Diff2::LogNode::ALL);
+	parallel.diff(ep1.get(), ep2.get(), "", notifiers, log.get());
+
+	BOOST_CHECK_EQUAL(describe(notifiers), describe(expected));
+
+	ostringstream os1, os2;
+	expectedLog->write(os1);
+	log->write(os2);
+	BOOST_CHECK_EQUAL(os2.str(), os1.str());
+
+	PublicObject::SetRegistrationEnabled(true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,128 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/datamodel/eventparameters_package.h>
+#include <seiscomp/io/exporter.h>
+
+#include <sstream>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+EventParametersPtr createEventParameters(int events) {
+	EventParametersPtr ep = new EventParameters;
+
+	for ( int i = 0; i < events; ++i ) {
+		string id = Core::toString(i);
+		PickPtr pick = Pick::Create("Pick/" + id);
+		pick->setTime(TimeQuantity(Core::Time(1000.0 * i)));
+		ep->add(pick.get());
+
+		OriginPtr origin = Origin::Create("Origin/" + id);
+		origin->setTime(TimeQuantity(Core::Time(1000.0 * i)));
+		origin->setLatitude(RealQuantity(i * 0.1));
+		origin->setLongitude(RealQuantity(i * -0.1));
+		ArrivalPtr arrival = new Arrival;
+		arrival->setPickID(pick->publicID());
+		arrival->setPhase(Phase("P"));
+		origin->add(arrival.get());
+		MagnitudePtr mag = Magnitude::Create("Magnitude/" + id);
+		mag->setMagnitude(RealQuantity(3.5));
+		mag->setType("M");
+		origin->add(mag.get());
+		ep->add(origin.get());
+
+		EventPtr event = Event::Create("Event/" + id);
+		event->setPreferredOriginID(origin->publicID());
+		event->setPreferredMagnitudeID(mag->publicID());
+		event->add(new OriginReference(origin->publicID()));
+		ep->add(event.get());
+	}
+
+	return ep;
+}
+
+
+string write(const char *format, EventParameters *ep, int threads,
+             bool formatted) {
+	IO::ExporterPtr exp = IO::Exporter::Create(format);
+	BOOST_REQUIRE(exp);
+	exp->setFormattedOutput(formatted);
+	exp->setThreads(threads);
+
+	stringbuf buf;
+	BOOST_REQUIRE(exp->write(&buf, ep));
+	return buf.str();
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_exchange)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ParallelExport) {
+	// More events than dispatched at once to the threads
+	EventParametersPtr ep = createEventParameters(300);
+
+	for ( const char *format : { "qml1.2", "qml1.2rt" } ) {
+		for ( bool formatted : { false, true } ) {
+			string serial = write(format, ep.get(), 1, formatted);
+			BOOST_CHECK(serial.find("Event/299") != string::npos);
+			BOOST_CHECK_EQUAL(write(format, ep.get(), 4, formatted), serial);
+		}
+	}
+
+	// The missing origin ID of the magnitude has been set before exporting
+	BOOST_CHECK_EQUAL(ep->origin(0)->magnitude(0)->originID(), "Origin/0");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,197 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/datamodel/inventoryindex.h>
+#include <seiscomp/math/geo.h>
+
+#include <random>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+InventoryPtr createInventory(int count) {
+	mt19937 gen(7);
+	uniform_real_distribution<double> lat(-90, 90), lon(-180, 180);
+
+	InventoryPtr inv = new Inventory;
+	NetworkPtr net = Network::Create();
+	net->setCode("XX");
+	net->setStart(Core::Time(2000, 1, 1));
+	inv->add(net.get());
+
+	for ( int i = 0; i < count; ++i ) {
+		StationPtr sta = Station::Create();
+		sta->setCode("S" + Core::toString(i));
+		sta->setStart(Core::Time(2000, 1, 1));
+		net->add(sta.get());
+
+		SensorLocationPtr loc = SensorLocation::Create();
+		loc->setCode("");
+		loc->setStart(Core::Time(2000, 1, 1));
+		// Some sensor locations at the poles and the date line
+		if ( i % 50 == 0 ) {
+			loc->setLatitude(i % 100 ? 90 : -89.9);
+			loc->setLongitude(lon(gen));
+		}
+		else if ( i % 50 == 1 ) {
+			loc->setLatitude(lat(gen));
+			loc->setLongitude(i % 100 > 50 ? 180 : -179.99);
+		}
+		else {
+			loc->setLatitude(lat(gen));
+			loc->setLongitude(lon(gen));
+		}
+		sta->add(loc.get());
+	}
+
+	return inv;
+}
+
+
+// The reference result computed with the distances to all sensor locations
+vector<double> distances(const Inventory *inv, double lat, double lon) {
+	vector<double> result;
+	for ( size_t i = 0; i < inv->network(0)->stationCount(); ++i ) {
+		SensorLocation *loc = inv->network(0)->station(i)->sensorLocation(0);
+		double dist, az, baz;
+		Math::Geo::delazi(lat, lon, loc->latitude(), loc->longitude(), &dist, &az, &baz);
+		result.push_back(dist);
+	}
+	sort(result.begin(), result.end());
+	return result;
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_inventoryindex)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Distance) {
+	InventoryPtr inv = createInventory(2000);
+	InventoryIndex index(inv.get());
+	InventoryIndex::SensorLocationDistances result;
+	Core::Time time(2024, 1, 1);
+
+	double points[][2] = {
+		{ 0, 0 }, { 52.4, 13.1 }, { -33.9, 179.9 }, { 10, -180 },
+		{ 89.5, 45 }, { -90, 0 }, { 67.8, -150.2 }
+	};
+
+	for ( auto &point : points ) {
+		vector<double> expected = distances(inv.get(), point[0], point[1]);
+
+		for ( double radius : { 0.5, 3.0, 17.5, 60.0, 95.0, 180.0 } ) {
+			size_t count = upper_bound(expected.begin(), expected.end(), radius - 1E-6) - expected.begin();
+			size_t n = index.getSensorLocations(result, point[0], point[1], radius, time);
+			BOOST_CHECK_EQUAL(n, result.size());
+			// Allow for rounding differences of sensor locations at the radius
+			BOOST_CHECK(n >= count);
+			BOOST_CHECK(n <= size_t(upper_bound(expected.begin(), expected.end(), radius + 1E-6) - expected.begin()));
+
+			for ( size_t i = 0; i < result.size(); ++i ) {
+				BOOST_CHECK(result[i].distance <= radius);
+				BOOST_CHECK_CLOSE(result[i].distance + 1, expected[i] + 1, 1E-6);
+			}
+		}
+
+		for ( size_t count : { 1, 5, 100, 3000 } ) {
+			size_t n = index.getNearestSensorLocations(result, point[0], point[1], count, time);
+			BOOST_CHECK_EQUAL(n, min(count, expected.size()));
+			for ( size_t i = 0; i < result.size(); ++i )
+				BOOST_CHECK_CLOSE(result[i].distance + 1, expected[i] + 1, 1E-6);
+		}
+
+		size_t n = index.getNearestSensorLocations(result, point[0], point[1], 100, time, 10);
+		BOOST_CHECK_EQUAL(n, min(size_t(100), size_t(upper_bound(expected.begin(), expected.end(), 10.0) - expected.begin())));
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Update) {
+	InventoryPtr inv = createInventory(100);
+	InventoryIndex index(inv.get());
+	InventoryIndex::SensorLocationDistances result;
+	Core::Time time(2024, 1, 1);
+
+	BOOST_CHECK_EQUAL(index.getNearestSensorLocations(result, 52, 13, 1, time), size_t(1));
+	SensorLocation *nearest = result[0].sensorLocation;
+
+	// Moving a sensor location to the point makes it the nearest one
+	SensorLocation *loc = inv->network(0)->station(10)->sensorLocation(0);
+	BOOST_REQUIRE(loc != nearest);
+	loc->setLatitude(52);
+	loc->setLongitude(13);
+	loc->update();
+
+	BOOST_CHECK_EQUAL(index.getNearestSensorLocations(result, 52, 13, 1, time), size_t(1));
+	BOOST_CHECK(result[0].sensorLocation == loc);
+	BOOST_CHECK_SMALL(result[0].distance, 1E-9);
+
+	// Closed epochs are only returned without a valid time
+	loc->setEnd(Core::Time(2020, 1, 1));
+	loc->update();
+	BOOST_CHECK_EQUAL(index.getSensorLocations(result, 52, 13, 0.1, time), size_t(0));
+	BOOST_CHECK_EQUAL(index.getSensorLocations(result, 52, 13, 0.1, Core::Time(2010, 1, 1)), size_t(1));
+	BOOST_CHECK_EQUAL(index.getSensorLocations(result, 52, 13, 0.1, Core::Time()), size_t(1));
+
+	// Removed sensor locations are not returned
+	loc->station()->remove(loc);
+	BOOST_CHECK_EQUAL(index.getSensorLocations(result, 52, 13, 0.1, Core::Time()), size_t(0));
+	BOOST_CHECK_EQUAL(index.getNearestSensorLocations(result, 52, 13, 1, time), size_t(1));
+	BOOST_CHECK(result[0].sensorLocation == nearest);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
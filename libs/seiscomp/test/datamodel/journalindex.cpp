@@ -0,0 +1,152 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/datamodel/journalindex.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+JournalEntryPtr createEntry(const string &objectID, const string &action,
+                            const string &parameters, double created) {
+	JournalEntryPtr entry = new JournalEntry;
+	entry->setObjectID(objectID);
+	entry->setAction(action);
+	entry->setParameters(parameters);
+	entry->setSender("test");
+	entry->setCreated(Core::Time(created));
+	return entry;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_journalindex)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Entries) {
+	JournalIndex index;
+
+	BOOST_CHECK(index.add(createEntry("ev1", "EvType", "earthquake", 30).get()));
+	BOOST_CHECK(index.add(createEntry("ev1", "EvPrefMagType", "Mw", 10).get()));
+	BOOST_CHECK(index.add(createEntry("ev1", "EvType", "explosion", 20).get()));
+	BOOST_CHECK(index.add(createEntry("ev2", "EvType", "earthquake", 5).get()));
+
+	// Duplicates are ignored
+	BOOST_CHECK(!index.add(createEntry("ev1", "EvType", "explosion", 20).get()));
+
+	BOOST_CHECK_EQUAL(index.size(), 2);
+	BOOST_CHECK(index.contains("ev1"));
+	BOOST_CHECK(!index.contains("ev3"));
+
+	const JournalIndex::JournalEntries &entries = index.entries("ev1");
+	BOOST_REQUIRE_EQUAL(entries.size(), 3);
+	BOOST_CHECK_EQUAL(entries[0]->action(), "EvPrefMagType");
+	BOOST_CHECK_EQUAL(entries[1]->parameters(), "explosion");
+	BOOST_CHECK_EQUAL(entries[2]->parameters(), "earthquake");
+
+	JournalIndex::JournalEntries types = index.entries("ev1", "EvType");
+	BOOST_REQUIRE_EQUAL(types.size(), 2);
+	BOOST_CHECK_EQUAL(types[0]->parameters(), "explosion");
+
+	JournalEntry *latest = index.latest("ev1", "EvType");
+	BOOST_REQUIRE(latest != nullptr);
+	BOOST_CHECK_EQUAL(latest->parameters(), "earthquake");
+	BOOST_CHECK(index.latest("ev1", "EvName") == nullptr);
+
+	// Without database an unknown object has an empty journal
+	BOOST_CHECK(index.entries("ev3").empty());
+	BOOST_CHECK_EQUAL(index.size(), 3);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Notifiers) {
+	JournalIndex index;
+
+	JournalEntryPtr entry = createEntry("ev1", "EvType", "earthquake", 10);
+	NotifierPtr n = new Notifier("Journaling", OP_ADD, entry.get());
+	BOOST_CHECK(index.feed(n.get()));
+	BOOST_CHECK_EQUAL(index.entries("ev1").size(), 1);
+
+	// Updates of journal entries are not supported
+	n = new Notifier("Journaling", OP_UPDATE, entry.get());
+	BOOST_CHECK(!index.feed(n.get()));
+
+	// Removal by value
+	n = new Notifier("Journaling", OP_REMOVE,
+	                 createEntry("ev1", "EvType", "earthquake", 10).get());
+	BOOST_CHECK(index.feed(n.get()));
+	BOOST_CHECK(index.entries("ev1").empty());
+	BOOST_CHECK(!index.feed(n.get()));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Prune) {
+	JournalIndex index(nullptr, Core::TimeSpan(60, 0));
+
+	index.add(createEntry("ev1", "EvType", "earthquake", 10).get());
+	index.add(createEntry("ev2", "EvType", "earthquake", 10).get());
+
+	index.prune();
+	BOOST_CHECK_EQUAL(index.size(), 2);
+
+	index.prune(Core::Time::UTC() + Core::TimeSpan(120, 0));
+	BOOST_CHECK_EQUAL(index.size(), 0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,108 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/origin.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_notifier)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Coalescing) {
+	Notifier::Enable();
+	Notifier::Clear();
+
+	// Allow two instances with the same publicID
+	PublicObject::SetRegistrationEnabled(false);
+	OriginPtr first = Origin::Create("Origin/1");
+	OriginPtr second = Origin::Create("Origin/1");
+	OriginPtr third = Origin::Create("Origin/2");
+	PublicObject::SetRegistrationEnabled(true);
+
+	// Repeated updates are merged
+	BOOST_CHECK(Notifier::Create("EP", OP_UPDATE, first.get()) != nullptr);
+	BOOST_CHECK(Notifier::Create("EP", OP_UPDATE, first.get()) == nullptr);
+	BOOST_CHECK(Notifier::Create("EP", OP_UPDATE, second.get()) == nullptr);
+	BOOST_CHECK_EQUAL(Notifier::Size(), 1);
+
+	// Another parent is a different update
+	BOOST_CHECK(Notifier::Create("Other", OP_UPDATE, second.get()) != nullptr);
+	BOOST_CHECK_EQUAL(Notifier::Size(), 2);
+
+	NotifierMessagePtr msg = Notifier::GetMessage(false);
+	BOOST_REQUIRE(msg);
+	BOOST_REQUIRE_EQUAL(msg->size(), 1);
+	BOOST_CHECK_EQUAL((*msg->begin())->object(), second.get());
+	BOOST_CHECK_EQUAL((*msg->begin())->parentID(), "EP");
+	Notifier::Clear();
+
+	// A removal makes a pending update obsolete
+	BOOST_CHECK(Notifier::Create("EP", OP_UPDATE, first.get()) != nullptr);
+	BOOST_CHECK(Notifier::Create("EP", OP_REMOVE, first.get()) != nullptr);
+	msg = Notifier::GetMessage();
+	BOOST_REQUIRE(msg);
+	BOOST_REQUIRE_EQUAL(msg->size(), 1);
+	BOOST_CHECK_EQUAL((*msg->begin())->operation(), OP_REMOVE);
+
+	// Additions which are removed again cancel out
+	BOOST_CHECK(Notifier::Create("EP", OP_ADD, third.get()) != nullptr);
+	BOOST_CHECK(Notifier::Create("EP", OP_UPDATE, third.get()) == nullptr);
+	BOOST_CHECK(Notifier::Create("EP", OP_REMOVE, third.get()) == nullptr);
+	BOOST_CHECK_EQUAL(Notifier::Size(), 0);
+	BOOST_CHECK(!Notifier::GetMessage());
+
+	// Notifiers are held back during the coalescing window
+	Notifier::SetCoalescingWindow(3600);
+	BOOST_CHECK(Notifier::Create("EP", OP_UPDATE, third.get()) != nullptr);
+	BOOST_CHECK(!Notifier::IsDue());
+	BOOST_CHECK(!Notifier::GetMessage());
+	msg = Notifier::Flush();
+	BOOST_REQUIRE(msg);
+	BOOST_CHECK_EQUAL(msg->size(), 1);
+	BOOST_CHECK_EQUAL(Notifier::Size(), 0);
+	Notifier::SetCoalescingWindow(0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
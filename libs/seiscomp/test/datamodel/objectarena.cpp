@@ -0,0 +1,156 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/datamodel/eventparameters.h>
+#include <seiscomp/datamodel/objectarena.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/io/archive/binarchive.h>
+
+#include <thread>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+EventParametersPtr createEventParameters(int count) {
+	EventParametersPtr ep = new EventParameters;
+	for ( int i = 0; i < count; ++i ) {
+		PickPtr pick = Pick::Create("Pick/" + Core::toString(i));
+		pick->setTime(TimeQuantity(Core::Time(2024, 1, 1) + Core::TimeSpan(i)));
+		pick->setWaveformID(WaveformStreamID("XX", "TEST", "", "HHZ", ""));
+		ep->add(pick.get());
+	}
+	return ep;
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_objectarena)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Scope) {
+	BOOST_CHECK(ObjectArena::Current() == nullptr);
+
+	EventParametersPtr ep;
+	PickPtr pick;
+
+	{
+		ObjectArena::Scope outer(4096);
+		BOOST_CHECK(ObjectArena::Current() == outer.arena());
+
+		ep = createEventParameters(100);
+		BOOST_CHECK_EQUAL(outer.arena()->objectCount(), size_t(101));
+		BOOST_CHECK(outer.arena()->capacity() > 4096);
+
+		{
+			ObjectArena::Scope inner;
+			BOOST_CHECK(ObjectArena::Current() == inner.arena());
+			pick = Pick::Create("Pick/inner");
+			BOOST_CHECK_EQUAL(inner.arena()->objectCount(), size_t(1));
+		}
+
+		BOOST_CHECK(ObjectArena::Current() == outer.arena());
+		BOOST_CHECK_EQUAL(outer.arena()->objectCount(), size_t(101));
+
+		// Released objects are still accounted until the arena is
+		// released
+		ep->removePick(size_t(0));
+		BOOST_CHECK_EQUAL(outer.arena()->objectCount(), size_t(100));
+	}
+
+	BOOST_CHECK(ObjectArena::Current() == nullptr);
+
+	// The objects outlive the scope
+	BOOST_CHECK_EQUAL(ep->pickCount(), size_t(99));
+	BOOST_CHECK_EQUAL(ep->findPick("Pick/50"), ep->pick(49));
+	BOOST_CHECK_EQUAL(pick->publicID(), "Pick/inner");
+
+	// A child kept after the root has been released keeps the arena
+	PickPtr kept = ep->pick(10);
+	ep = nullptr;
+	BOOST_CHECK_EQUAL(kept->publicID(), "Pick/11");
+	BOOST_CHECK_EQUAL(kept->waveformID().stationCode(), "TEST");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Load) {
+	string blob;
+	{
+		EventParametersPtr ep = createEventParameters(1000);
+		IO::BinaryArchive ar;
+		ar.create(blob);
+		ar << ep;
+		ar.close();
+	}
+
+	EventParametersPtr ep;
+	{
+		ObjectArena::Scope arena;
+		IO::BinaryArchive ar;
+		BOOST_REQUIRE(ar.open(blob.data(), blob.size()));
+		ar >> ep;
+		BOOST_REQUIRE(ep);
+		BOOST_CHECK_EQUAL(arena.arena()->objectCount(), size_t(1001));
+	}
+
+	BOOST_REQUIRE_EQUAL(ep->pickCount(), size_t(1000));
+	BOOST_CHECK_EQUAL(ep->pick(999)->publicID(), "Pick/999");
+	BOOST_CHECK(PublicObject::Find("Pick/999") == ep->pick(999));
+
+	// The last objects are released in another thread
+	thread([&ep]() { ep = nullptr; }).join();
+	BOOST_CHECK(PublicObject::Find("Pick/999") == nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,113 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/datamodel/eventparameters.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/datamodel/snapshot.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_snapshot)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Sharing) {
+	EventParametersPtr ep = new EventParameters;
+	OriginPtr origin1 = Origin::Create("Origin/snapshot/1");
+	OriginPtr origin2 = Origin::Create("Origin/snapshot/2");
+	PickPtr pick = Pick::Create("Pick/snapshot/1");
+	ep->add(pick.get());
+	ep->add(origin1.get());
+	ep->add(origin2.get());
+
+	SnapshotWriterPtr writer = new SnapshotWriter(ep.get());
+	BOOST_CHECK(!writer->current());
+
+	SnapshotCPtr s1 = writer->publish();
+	BOOST_REQUIRE(s1);
+	BOOST_CHECK_EQUAL(writer->current(), s1);
+	BOOST_CHECK_EQUAL(s1->objectCount(), size_t(3));
+	BOOST_CHECK_EQUAL(s1->object(0)->className(), string("Pick"));
+
+	// The copies are neither the originals nor registered
+	const Origin *copy1 = s1->find<Origin>("Origin/snapshot/1");
+	BOOST_REQUIRE(copy1 != nullptr);
+	BOOST_CHECK(copy1 != origin1.get());
+	BOOST_CHECK_EQUAL(Origin::Find("Origin/snapshot/1"), origin1.get());
+
+	// Nothing changed, nothing to publish
+	BOOST_CHECK_EQUAL(writer->publish(), s1);
+
+	// Changing an origin copies only that origin
+	ArrivalPtr arrival = new Arrival;
+	arrival->setPickID(pick->publicID());
+	origin2->add(arrival.get());
+
+	SnapshotCPtr s2 = writer->publish();
+	BOOST_CHECK(s2 != s1);
+	BOOST_CHECK(s2->version() > s1->version());
+	BOOST_CHECK_EQUAL(s2->find<Origin>("Origin/snapshot/1"), copy1);
+	BOOST_CHECK_EQUAL(s2->find<Pick>("Pick/snapshot/1"), s1->find<Pick>("Pick/snapshot/1"));
+	BOOST_CHECK_EQUAL(s1->find<Origin>("Origin/snapshot/2")->arrivalCount(), size_t(0));
+	BOOST_CHECK_EQUAL(s2->find<Origin>("Origin/snapshot/2")->arrivalCount(), size_t(1));
+
+	// Updates are tracked through update()
+	origin1->setMethodID("changed");
+	origin1->update();
+	ep->remove(pick.get());
+
+	SnapshotCPtr s3 = writer->publish();
+	BOOST_CHECK_EQUAL(s3->objectCount(), size_t(2));
+	BOOST_CHECK(s3->find("Pick/snapshot/1") == nullptr);
+	BOOST_CHECK_EQUAL(s3->find<Origin>("Origin/snapshot/1")->methodID(), "changed");
+	BOOST_CHECK_EQUAL(s1->find<Origin>("Origin/snapshot/1")->methodID(), "");
+	BOOST_CHECK_EQUAL(s3->find<Origin>("Origin/snapshot/2"), s2->find<Origin>("Origin/snapshot/2"));
+
+	// Objects of other trees are ignored
+	OriginPtr other = Origin::Create();
+	other->add(new Arrival);
+	BOOST_CHECK_EQUAL(writer->publish(), s3);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
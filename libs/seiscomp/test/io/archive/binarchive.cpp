@@ -0,0 +1,254 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <chrono>
+#include <string>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/io/archive/binarchive.h>
+#include <seiscomp/datamodel/amplitude.h>
+#include <seiscomp/datamodel/arrival.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+namespace bio = boost::iostreams;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Creates a notifier message as sent by a picker and a locator
+NotifierMessagePtr createMessage() {
+	NotifierMessagePtr msg = new NotifierMessage;
+	Core::Time t(2024, 3, 1, 12, 0, 0, 123400);
+
+	CreationInfo ci;
+	ci.setAgencyID("GFZ");
+	ci.setAuthor("scautopick@host");
+	ci.setCreationTime(t);
+
+	PickPtr pick = Pick::Create("Pick/20240301120000.123456.GE.UGM..BHZ");
+	pick->setTime(TimeQuantity(t, 0.05));
+	pick->setWaveformID(WaveformStreamID("GE", "UGM", "", "BHZ", ""));
+	pick->setPhaseHint(Phase("P"));
+	pick->setEvaluationMode(EvaluationMode(AUTOMATIC));
+	pick->setCreationInfo(ci);
+	msg->attach(new Notifier("EventParameters", OP_ADD, pick.get()));
+
+	AmplitudePtr amp = Amplitude::Create("Amplitude/20240301120001.234567.GE.UGM..BHZ.mb");
+	amp->setType("mb");
+	amp->setAmplitude(RealQuantity(123.45));
+	amp->setPickID(pick->publicID());
+	amp->setWaveformID(pick->waveformID());
+	amp->setCreationInfo(ci);
+	msg->attach(new Notifier("EventParameters", OP_ADD, amp.get()));
+
+	OriginPtr org = Origin::Create("Origin/20240301120100.345678.123456");
+	org->setTime(TimeQuantity(t));
+	org->setLatitude(RealQuantity(-7.9));
+	org->setLongitude(RealQuantity(110.5));
+	org->setCreationInfo(ci);
+
+	for ( int i = 0; i < 20; ++i ) {
+		ArrivalPtr arr = new Arrival;
+		arr->setPickID(pick->publicID() + Core::toString(i));
+		arr->setPhase(Phase("P"));
+		arr->setDistance(i * 0.5);
+		arr->setAzimuth(i * 10.0);
+		arr->setTimeResidual(0.1);
+		arr->setWeight(1.0);
+		org->add(arr.get());
+	}
+
+	msg->attach(new Notifier("EventParameters", OP_ADD, org.get()));
+
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encodeStream(Core::Message *msg) {
+	string blob;
+	{
+		bio::stream_buffer<bio::back_insert_device<string> > buf(blob);
+		IO::VBinaryArchive ar(&buf, false);
+		ar << msg;
+	}
+	return blob;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encodeMemory(Core::Message *msg) {
+	string blob;
+	IO::VBinaryArchive ar;
+	ar.create(blob);
+	ar << msg;
+	ar.close();
+	return blob;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::Message *decodeStream(const string &blob) {
+	Core::Message *msg = nullptr;
+	bio::stream_buffer<bio::array_source> buf(blob.data(), blob.size());
+	IO::VBinaryArchive ar(&buf, true);
+	ar >> msg;
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::Message *decodeMemory(const string &blob) {
+	Core::Message *msg = nullptr;
+	IO::VBinaryArchive ar;
+	if ( ar.open(blob.data(), blob.size()) )
+		ar >> msg;
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_archive_binarchive)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MEMORY_ROUNDTRIP) {
+	NotifierMessagePtr msg = createMessage();
+
+	// Decoded objects are not registered to not clash with the originals
+	PublicObject::SetRegistrationEnabled(false);
+
+	string reference = encodeStream(msg.get());
+	string blob = encodeMemory(msg.get());
+	BOOST_CHECK(blob == reference);
+
+	Core::MessagePtr decoded = decodeMemory(blob);
+	BOOST_REQUIRE(decoded);
+	BOOST_CHECK_EQUAL(NotifierMessage::Cast(decoded)->size(), msg->size());
+	BOOST_CHECK(encodeMemory(decoded.get()) == reference);
+
+	Core::MessagePtr streamed = decodeStream(reference);
+	BOOST_REQUIRE(streamed);
+	BOOST_CHECK(encodeStream(streamed.get()) == reference);
+
+	// Truncated blobs must not read beyond the end
+	for ( size_t size = 0; size < blob.size(); size += 97 ) {
+		try {
+			Core::MessagePtr partial = decodeMemory(blob.substr(0, size));
+		}
+		catch ( std::exception & ) {}
+	}
+
+	PublicObject::SetRegistrationEnabled(true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MESSAGE_BENCHMARK) {
+	const int messages = 5000;
+	NotifierMessagePtr msg = createMessage();
+
+	PublicObject::SetRegistrationEnabled(false);
+
+	string blob = encodeMemory(msg.get());
+
+	auto start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(!encodeStream(msg.get()).empty());
+	auto streamEncode = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(!encodeMemory(msg.get()).empty());
+	auto memoryEncode = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(Core::MessagePtr(decodeStream(blob)));
+	auto streamDecode = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(Core::MessagePtr(decodeMemory(blob)));
+	auto memoryDecode = chrono::steady_clock::now() - start;
+
+	PublicObject::SetRegistrationEnabled(true);
+
+	BOOST_TEST_MESSAGE(messages << " messages of " << blob.size() << " bytes: encode stream "
+	                   << chrono::duration_cast<chrono::microseconds>(streamEncode).count()
+	                   << " us, memory "
+	                   << chrono::duration_cast<chrono::microseconds>(memoryEncode).count()
+	                   << " us; decode stream "
+	                   << chrono::duration_cast<chrono::microseconds>(streamDecode).count()
+	                   << " us, memory "
+	                   << chrono::duration_cast<chrono::microseconds>(memoryDecode).count()
+	                   << " us");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,336 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/io/archive/bsonarchive.h>
+#include <seiscomp/datamodel/amplitude.h>
+#include <seiscomp/datamodel/arrival.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+namespace bio = boost::iostreams;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Creates a notifier message as sent by a picker and a locator
+NotifierMessagePtr createMessage() {
+	NotifierMessagePtr msg = new NotifierMessage;
+	Core::Time t(2024, 3, 1, 12, 0, 0, 123400);
+
+	CreationInfo ci;
+	ci.setAgencyID("GFZ");
+	ci.setAuthor("scautopick@host");
+	ci.setCreationTime(t);
+
+	PickPtr pick = Pick::Create("Pick/20240301120000.123456.GE.UGM..BHZ");
+	pick->setTime(TimeQuantity(t, 0.05));
+	pick->setWaveformID(WaveformStreamID("GE", "UGM", "", "BHZ", ""));
+	pick->setPhaseHint(Phase("P"));
+	pick->setEvaluationMode(EvaluationMode(AUTOMATIC));
+	pick->setCreationInfo(ci);
+	msg->attach(new Notifier("EventParameters", OP_ADD, pick.get()));
+
+	AmplitudePtr amp = Amplitude::Create("Amplitude/20240301120001.234567.GE.UGM..BHZ.mb");
+	amp->setType("mb");
+	amp->setAmplitude(RealQuantity(123.45));
+	amp->setPickID(pick->publicID());
+	amp->setWaveformID(pick->waveformID());
+	amp->setCreationInfo(ci);
+	msg->attach(new Notifier("EventParameters", OP_ADD, amp.get()));
+
+	OriginPtr org = Origin::Create("Origin/20240301120100.345678.123456");
+	org->setTime(TimeQuantity(t));
+	org->setLatitude(RealQuantity(-7.9));
+	org->setLongitude(RealQuantity(110.5));
+	org->setCreationInfo(ci);
+
+	for ( int i = 0; i < 20; ++i ) {
+		ArrivalPtr arr = new Arrival;
+		arr->setPickID(pick->publicID() + Core::toString(i));
+		arr->setPhase(Phase("P"));
+		arr->setDistance(i * 0.5);
+		arr->setAzimuth(i * 10.0);
+		arr->setTimeResidual(0.1);
+		arr->setWeight(1.0);
+		org->add(arr.get());
+	}
+
+	msg->attach(new Notifier("EventParameters", OP_ADD, org.get()));
+
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct Mode {
+	bool json;
+	bool compression;
+	IO::BSONArchive::CompressionMethod method;
+};
+
+
+const vector<Mode> Modes = {
+	{ false, false, IO::BSONArchive::ZIP },
+	{ false, true, IO::BSONArchive::ZIP },
+	{ false, true, IO::BSONArchive::LZ4 },
+	{ true, false, IO::BSONArchive::ZIP },
+	{ true, true, IO::BSONArchive::LZ4 }
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void setup(IO::BSONArchive &ar, const Mode &mode) {
+	ar.setJSON(mode.json);
+	ar.setCompression(mode.compression);
+	ar.setCompressionMethod(mode.method);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encodeStream(Core::Message *msg, const Mode &mode = Modes[0]) {
+	string blob;
+	{
+		bio::stream_buffer<bio::back_insert_device<string> > buf(blob);
+		IO::BSONArchive ar;
+		setup(ar, mode);
+		ar.create(&buf);
+		ar << msg;
+	}
+	return blob;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encodeMemory(Core::Message *msg, const Mode &mode = Modes[0]) {
+	string blob;
+	IO::BSONArchive ar;
+	setup(ar, mode);
+	ar.create(blob);
+	ar << msg;
+	ar.close();
+	return blob;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::Message *decodeStream(const string &blob, const Mode &mode = Modes[0]) {
+	Core::Message *msg = nullptr;
+	bio::stream_buffer<bio::array_source> buf(blob.data(), blob.size());
+	IO::BSONArchive ar;
+	setup(ar, mode);
+	if ( ar.open(&buf) )
+		ar >> msg;
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::Message *decodeMemory(const string &blob, const Mode &mode = Modes[0]) {
+	Core::Message *msg = nullptr;
+	IO::BSONArchive ar;
+	setup(ar, mode);
+	if ( ar.open(blob.data(), blob.size()) )
+		ar >> msg;
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_archive_bsonarchive)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MEMORY_ROUNDTRIP) {
+	NotifierMessagePtr msg = createMessage();
+
+	// Decoded objects are not registered to not clash with the originals
+	PublicObject::SetRegistrationEnabled(false);
+
+	string reference = encodeStream(msg.get());
+	string blob = encodeMemory(msg.get());
+	BOOST_CHECK(blob == reference);
+
+	// The document is appended to existing content
+	string prefixed = "prefix";
+	{
+		IO::BSONArchive ar;
+		ar.create(prefixed);
+		Core::Message *tmp = msg.get();
+		ar << tmp;
+	}
+	BOOST_CHECK(prefixed == "prefix" + reference);
+
+	Core::MessagePtr decoded = decodeMemory(blob);
+	BOOST_REQUIRE(decoded);
+	BOOST_CHECK_EQUAL(NotifierMessage::Cast(decoded)->size(), msg->size());
+	BOOST_CHECK(encodeMemory(decoded.get()) == reference);
+
+	// Truncated blobs are rejected
+	for ( size_t size = 0; size < blob.size(); size += 97 ) {
+		Core::MessagePtr partial = decodeMemory(blob.substr(0, size));
+		BOOST_CHECK(!partial);
+	}
+
+	PublicObject::SetRegistrationEnabled(true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MODES) {
+	NotifierMessagePtr msg = createMessage();
+
+	PublicObject::SetRegistrationEnabled(false);
+
+	string reference = encodeStream(msg.get());
+
+	for ( const Mode &mode : Modes ) {
+		BOOST_TEST_MESSAGE("json " << mode.json << ", compression " << mode.compression
+		                   << ", method " << mode.method);
+
+		// Streams and memory buffers are interchangeable
+		string stream = encodeStream(msg.get(), mode);
+		string memory = encodeMemory(msg.get(), mode);
+
+		Core::MessagePtr decoded = decodeMemory(stream, mode);
+		BOOST_REQUIRE(decoded);
+		BOOST_CHECK(encodeStream(decoded.get()) == reference);
+
+		decoded = decodeStream(memory, mode);
+		BOOST_REQUIRE(decoded);
+		BOOST_CHECK(encodeStream(decoded.get()) == reference);
+
+		decoded = decodeMemory(memory, mode);
+		BOOST_REQUIRE(decoded);
+		BOOST_CHECK(encodeStream(decoded.get()) == reference);
+	}
+
+	// Truncated compressed data are rejected
+	string lz4 = encodeMemory(msg.get(), Modes[2]);
+	BOOST_CHECK(!Core::MessagePtr(decodeMemory(lz4.substr(0, lz4.size() / 2), Modes[2])));
+
+	PublicObject::SetRegistrationEnabled(true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MESSAGE_BENCHMARK) {
+	const int messages = 5000;
+	NotifierMessagePtr msg = createMessage();
+
+	PublicObject::SetRegistrationEnabled(false);
+
+	string blob = encodeMemory(msg.get());
+
+	auto start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(!encodeStream(msg.get()).empty());
+	auto streamEncode = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(!encodeMemory(msg.get()).empty());
+	auto memoryEncode = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(Core::MessagePtr(decodeStream(blob)));
+	auto streamDecode = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for ( int i = 0; i < messages; ++i )
+		BOOST_REQUIRE(Core::MessagePtr(decodeMemory(blob)));
+	auto memoryDecode = chrono::steady_clock::now() - start;
+
+	PublicObject::SetRegistrationEnabled(true);
+
+	BOOST_TEST_MESSAGE(messages << " messages of " << blob.size() << " bytes: encode stream "
+	                   << chrono::duration_cast<chrono::microseconds>(streamEncode).count()
+	                   << " us, memory "
+	                   << chrono::duration_cast<chrono::microseconds>(memoryEncode).count()
+	                   << " us; decode stream "
+	                   << chrono::duration_cast<chrono::microseconds>(streamDecode).count()
+	                   << " us, memory "
+	                   << chrono::duration_cast<chrono::microseconds>(memoryDecode).count()
+	                   << " us");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,259 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <algorithm>
+#include <string>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/io/archive/jsonarchive.h>
+#include <seiscomp/datamodel/arrival.h>
+#include <seiscomp/datamodel/eventparameters.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+namespace bio = boost::iostreams;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Hands out a string in small chunks and does not support seeking as
+//! decompressing stream buffers
+class PipeBuffer : public std::streambuf {
+	public:
+		PipeBuffer(const string &data) : _data(data) {
+			setg(nullptr, nullptr, nullptr);
+		}
+
+	protected:
+		int_type underflow() override {
+			char *data = const_cast<char*>(_data.data());
+			size_t pos = egptr() ? egptr() - data : 0;
+			if ( pos >= _data.size() )
+				return traits_type::eof();
+
+			setg(data + pos, data + pos, data + min(_data.size(), pos + 7));
+			return traits_type::to_int_type(*gptr());
+		}
+
+	private:
+		const string &_data;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+EventParametersPtr createEventParameters() {
+	EventParametersPtr ep = new EventParameters;
+	Core::Time t(2024, 3, 1, 12, 0, 0, 123400);
+
+	for ( int i = 0; i < 50; ++i ) {
+		PickPtr pick = Pick::Create("Pick/" + Core::toString(i));
+		pick->setTime(TimeQuantity(t + Core::TimeSpan(i * 0.25), 0.05));
+		pick->setWaveformID(WaveformStreamID("GE", "UGM", "", "BHZ", ""));
+		pick->setPhaseHint(Phase("P"));
+		pick->setMethodID("control\x01 \"quoted\" \\ tab\t");
+		ep->add(pick.get());
+	}
+
+	for ( int i = 0; i < 5; ++i ) {
+		OriginPtr org = Origin::Create("Origin/" + Core::toString(i));
+		org->setTime(TimeQuantity(t));
+		org->setLatitude(RealQuantity(-7.9 + i / 3.0));
+		org->setLongitude(RealQuantity(110.5 + 0.1 * i));
+
+		for ( int j = 0; j < 10; ++j ) {
+			ArrivalPtr arr = new Arrival;
+			arr->setPickID("Pick/" + Core::toString(i * 10 + j));
+			arr->setPhase(Phase("P"));
+			arr->setDistance(j / 7.0);
+			arr->setTimeResidual(-0.01 * j);
+			arr->setWeight(1.0);
+			org->add(arr.get());
+		}
+
+		ep->add(org.get());
+	}
+
+	return ep;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+string encode(Core::BaseObject *obj, bool formatted = false) {
+	string blob;
+	{
+		bio::stream_buffer<bio::back_insert_device<string> > buf(blob);
+		IO::JSONArchive ar;
+		ar.setFormattedOutput(formatted);
+		ar.create(&buf);
+		ar << obj;
+	}
+	return blob;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+boost::intrusive_ptr<T> decode(std::streambuf *buf) {
+	boost::intrusive_ptr<T> obj;
+	IO::JSONArchive ar;
+	if ( ar.open(buf) )
+		ar >> obj;
+	return obj;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_archive_jsonarchive)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ROUNDTRIP) {
+	EventParametersPtr ep = createEventParameters();
+
+	// Decoded objects are not registered to not clash with the originals
+	PublicObject::SetRegistrationEnabled(false);
+
+	for ( bool formatted : { false, true } ) {
+		string blob = encode(ep.get(), formatted);
+
+		// Seekable stream buffer
+		bio::stream_buffer<bio::array_source> buf(blob.data(), blob.size());
+		EventParametersPtr decoded = decode<EventParameters>(&buf);
+		BOOST_REQUIRE(decoded);
+		BOOST_CHECK_EQUAL(decoded->pickCount(), ep->pickCount());
+		BOOST_CHECK_EQUAL(decoded->pick(0)->methodID(), ep->pick(0)->methodID());
+		BOOST_CHECK(encode(decoded.get(), formatted) == blob);
+
+		// Stream buffer without seeking
+		PipeBuffer pipe(blob);
+		decoded = decode<EventParameters>(&pipe);
+		BOOST_REQUIRE(decoded);
+		BOOST_CHECK(encode(decoded.get(), formatted) == blob);
+
+		IO::JSONArchive ar;
+		BOOST_REQUIRE(ar.from(blob.c_str()));
+		decoded = nullptr;
+		ar >> decoded;
+		BOOST_REQUIRE(decoded);
+		BOOST_CHECK(encode(decoded.get(), formatted) == blob);
+	}
+
+	// Notifiers wrap their objects with the class name
+	NotifierMessagePtr msg = new NotifierMessage;
+	msg->attach(new Notifier("EventParameters", OP_ADD, ep->pick(0)));
+	msg->attach(new Notifier("EventParameters", OP_UPDATE, ep->origin(0)));
+	string blob = encode(msg.get());
+
+	PipeBuffer pipe(blob);
+	Core::MessagePtr decoded = decode<Core::Message>(&pipe);
+	BOOST_REQUIRE(NotifierMessage::Cast(decoded));
+	BOOST_CHECK_EQUAL(NotifierMessage::Cast(decoded)->size(), 2);
+	BOOST_CHECK(encode(decoded.get()) == blob);
+
+	PublicObject::SetRegistrationEnabled(true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MEMBER_ORDER) {
+	PublicObject::SetRegistrationEnabled(false);
+
+	// Members are looked up in any order, also behind others which are
+	// skipped
+	string blob =
+		"{\"EventParameters\":{"
+			"\"unknown\":[{\"a\":\"]}\\\"[\"},[[]]],"
+			"\"origin\":[{\"publicID\":\"Origin/1\","
+			             "\"time\":{\"value\":\"2024-03-01T12:00:00Z\"},"
+			             "\"latitude\":{\"value\":1.5},"
+			             "\"longitude\":{\"value\":2.5}}],"
+			"\"pick\":[{\"publicID\":\"Pick/1\","
+			           "\"time\":{\"value\":\"2024-03-01T12:00:00Z\"},"
+			           "\"waveformID\":{\"networkCode\":\"GE\",\"stationCode\":\"UGM\"}}]"
+		"},\"version\":\"0.12\"}";
+
+	for ( int seekable = 0; seekable < 2; ++seekable ) {
+		bio::stream_buffer<bio::array_source> buf(blob.data(), blob.size());
+		PipeBuffer pipe(blob);
+		EventParametersPtr ep = decode<EventParameters>(seekable ? static_cast<std::streambuf*>(&buf) : &pipe);
+		BOOST_REQUIRE(ep);
+		BOOST_REQUIRE_EQUAL(ep->pickCount(), 1);
+		BOOST_REQUIRE_EQUAL(ep->originCount(), 1);
+		BOOST_CHECK_EQUAL(ep->pick(0)->publicID(), "Pick/1");
+		BOOST_CHECK_EQUAL(ep->origin(0)->latitude().value(), 1.5);
+	}
+
+	// Errors behind the first objects fail the whole archive
+	blob = encode(createEventParameters().get());
+	for ( size_t size : { blob.size() / 2, blob.size() - 3 } ) {
+		string truncated = blob.substr(0, size);
+		bio::stream_buffer<bio::array_source> buf(truncated.data(), truncated.size());
+		BOOST_CHECK(!decode<EventParameters>(&buf));
+	}
+
+	PublicObject::SetRegistrationEnabled(true);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
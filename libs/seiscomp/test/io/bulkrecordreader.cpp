@@ -0,0 +1,158 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/io/bulkrecordreader.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+
+
+namespace {
+
+
+/**
+ * Returns records of ten samples at 1 Hz of the given stations. The
+ * samples are the seconds since epoch.
+ */
+class FakeStream : public IO::RecordStream {
+	public:
+		FakeStream(vector<pair<string, double>> records)
+		: _records(records) {}
+
+	public:
+		bool setSource(const string &) override { return true; }
+		bool addStream(const string &, const string &,
+		               const string &, const string &) override { return true; }
+		bool addStream(const string &, const string &,
+		               const string &, const string &,
+		               const Time &, const Time &) override { return true; }
+		bool setStartTime(const Time &) override { return true; }
+		bool setEndTime(const Time &) override { return true; }
+		void close() override {}
+
+		Record *next() override {
+			if ( _index >= _records.size() ) return nullptr;
+
+			const auto &item = _records[_index++];
+			GenericRecord *rec = new GenericRecord("XX", item.first, "", "HHZ",
+			                                       Time(item.second), 1.0);
+			IntArray *data = new IntArray(10);
+			for ( int i = 0; i < 10; ++i )
+				(*data)[i] = static_cast<int>(item.second) + i;
+			rec->setData(data);
+			return rec;
+		}
+
+	private:
+		vector<pair<string, double>> _records;
+		size_t                       _index{0};
+};
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_io_bulkrecordreader)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MERGE) {
+	FakeStream rs({{"A", 0}, {"B", 0}, {"A", 10}, {"A", 30}, {"B", 10}});
+
+	IO::BulkRecordReader reader;
+	BOOST_CHECK_EQUAL(reader.read(&rs), 5);
+
+	auto ids = reader.streamIDs();
+	BOOST_REQUIRE_EQUAL(ids.size(), 2);
+	BOOST_CHECK_EQUAL(ids[0], "XX.A..HHZ");
+	BOOST_CHECK_EQUAL(ids[1], "XX.B..HHZ");
+	BOOST_CHECK_EQUAL(reader.recordCount("XX.A..HHZ"), 3);
+	BOOST_CHECK_EQUAL(reader.recordCount("XX.C..HHZ"), 0);
+	BOOST_CHECK(!reader.contiguousRecord("XX.C..HHZ"));
+
+	// The gap between 20 and 30 is interpolated
+	GenericRecordPtr rec = reader.contiguousRecord("XX.A..HHZ", Array::DOUBLE, true);
+	BOOST_REQUIRE(rec);
+	BOOST_CHECK(rec->startTime() == Time(0.0));
+	BOOST_REQUIRE_EQUAL(rec->sampleCount(), 40);
+
+	const DoubleArray *data = DoubleArray::ConstCast(rec->data());
+	BOOST_REQUIRE(data);
+	for ( int i = 0; i < 40; ++i )
+		BOOST_CHECK_CLOSE((*data)[i], double(i), 1E-9);
+
+	BOOST_CHECK(!reader.contiguousRecord("XX.A..HHZ", Array::CHAR));
+
+	GenericRecordPtr irec = reader.contiguousRecord("XX.B..HHZ", Array::INT);
+	BOOST_REQUIRE(irec);
+	BOOST_CHECK(IntArray::ConstCast(irec->data()));
+	BOOST_CHECK_EQUAL(irec->sampleCount(), 20);
+
+	reader.clear();
+	BOOST_CHECK(reader.streamIDs().empty());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(HEADERS) {
+	FakeStream rs({{"A", 0}, {"A", 10}, {"A", 20}, {"A", 30}});
+
+	// Only records overlapping the time window are kept
+	IO::BulkRecordReader reader;
+	BOOST_CHECK_EQUAL(reader.read(&rs, TimeWindow(Time(12.0), Time(25.0))), 2);
+
+	DoubleArrayPtr hdr = reader.headers("XX.A..HHZ");
+	BOOST_REQUIRE(hdr);
+	BOOST_REQUIRE_EQUAL(hdr->size(), 2 * IO::BulkRecordReader::HC_QUANTITY);
+
+	const double *row = hdr->typedData();
+	BOOST_CHECK_EQUAL(row[IO::BulkRecordReader::HC_START_TIME], 10.0);
+	BOOST_CHECK_EQUAL(row[IO::BulkRecordReader::HC_END_TIME], 20.0);
+	BOOST_CHECK_EQUAL(row[IO::BulkRecordReader::HC_SAMPLING_FREQUENCY], 1.0);
+	BOOST_CHECK_EQUAL(row[IO::BulkRecordReader::HC_SAMPLE_COUNT], 10.0);
+
+	row += IO::BulkRecordReader::HC_QUANTITY;
+	BOOST_CHECK_EQUAL(row[IO::BulkRecordReader::HC_START_TIME], 20.0);
+
+	BOOST_CHECK(!reader.headers("XX.B..HHZ"));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,218 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/greensfunction.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/io/gfarchive.h>
+
+#include <list>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::IO;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Creates Green's functions with 100 samples per request and counts
+//! how many it has created
+class CountingArchive : public GFArchive {
+	public:
+		bool setSource(string) override { return true; }
+		void close() override {}
+
+		bool setTimeSpan(const Core::TimeSpan &) override { return true; }
+
+		bool addRequest(const string &id, const string &model,
+		                const GFSource &source,
+		                const GFReceiver &receiver) override {
+			_requests.push_back({id, model, source.depth, receiver.lat});
+			return true;
+		}
+
+		bool addRequest(const string &id, const string &model,
+		                const GFSource &source, const GFReceiver &receiver,
+		                const Core::TimeSpan &) override {
+			return addRequest(id, model, source, receiver);
+		}
+
+		Core::GreensFunction *get() override {
+			if ( _requests.empty() )
+				return nullptr;
+
+			Request req = _requests.front();
+			_requests.pop_front();
+
+			Core::GreensFunction *gf = cached(req.model, req.depth, req.distance, Core::TimeSpan());
+			if ( gf ) {
+				gf->setId(req.id);
+				return gf;
+			}
+
+			++created;
+			gf = new Core::GreensFunction(req.model, req.distance, req.depth, 1, 0);
+			gf->setId(req.id);
+			FloatArrayPtr data = new FloatArray(100);
+			data->fill(static_cast<float>(req.distance));
+			gf->setData(Core::ZSS, data.get());
+
+			cache(req.model, req.depth, req.distance, Core::TimeSpan(), gf);
+			return gf;
+		}
+
+		OPT(double) getTravelTime(const string &, const string &,
+		                          const GFSource &, const GFReceiver &) override {
+			return Core::None;
+		}
+
+		Core::GreensFunctionPtr request(const string &id, double depth, double distance) {
+			addRequest(id, "model", GFSource(0, 0, depth), GFReceiver(distance, 0));
+			return get();
+		}
+
+	public:
+		int created{0};
+
+	private:
+		struct Request {
+			string id;
+			string model;
+			double depth;
+			double distance;
+		};
+
+		list<Request> _requests;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_gfarchive_cache)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(disabled) {
+	CountingArchive archive;
+	archive.request("a", 10, 100);
+	archive.request("b", 10, 100);
+	BOOST_CHECK_EQUAL(archive.created, 2);
+	BOOST_CHECK_EQUAL(archive.cacheSize(), 0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(hits) {
+	CountingArchive archive;
+	archive.setCacheLimit(1024 * 1024);
+
+	Core::GreensFunctionPtr gf1 = archive.request("a", 10, 100);
+	Core::GreensFunctionPtr gf2 = archive.request("b", 10, 100);
+	BOOST_CHECK_EQUAL(archive.created, 1);
+	BOOST_CHECK(archive.cacheSize() > 0);
+
+	// The cached function is returned as an independent copy with the
+	// id of the request
+	BOOST_CHECK(gf1 != gf2);
+	BOOST_CHECK_EQUAL(gf2->id(), "b");
+	BOOST_CHECK_EQUAL(gf2->distance(), 100);
+	BOOST_CHECK(gf1->data(Core::ZSS) != gf2->data(Core::ZSS));
+	BOOST_CHECK_EQUAL(gf2->data(Core::ZSS)->size(), 100);
+
+	static_cast<FloatArray*>(gf2->data(Core::ZSS))->fill(0);
+	Core::GreensFunctionPtr gf3 = archive.request("c", 10, 100);
+	BOOST_CHECK_EQUAL(static_cast<FloatArray*>(gf3->data(Core::ZSS))->get(0), 100);
+
+	archive.request("d", 20, 100);
+	BOOST_CHECK_EQUAL(archive.created, 2);
+
+	archive.clearCache();
+	BOOST_CHECK_EQUAL(archive.cacheSize(), 0);
+	archive.request("e", 10, 100);
+	BOOST_CHECK_EQUAL(archive.created, 3);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(leastRecentlyUsed) {
+	CountingArchive archive;
+	archive.request("probe", 0, 0);
+	// Measure a single entry and allow two of them
+	archive.setCacheLimit(1024 * 1024);
+	archive.request("probe", 0, 0);
+	size_t entrySize = archive.cacheSize();
+	archive.clearCache();
+	archive.setCacheLimit(2 * entrySize);
+	archive.created = 0;
+
+	archive.request("a", 10, 1);
+	archive.request("b", 10, 2);
+	// Touch the first one which makes the second one the oldest
+	archive.request("a", 10, 1);
+	archive.request("c", 10, 3);
+	BOOST_CHECK_EQUAL(archive.created, 3);
+	BOOST_CHECK_EQUAL(archive.cacheSize(), 2 * entrySize);
+
+	archive.request("a", 10, 1);
+	archive.request("c", 10, 3);
+	BOOST_CHECK_EQUAL(archive.created, 3);
+
+	archive.request("b", 10, 2);
+	BOOST_CHECK_EQUAL(archive.created, 4);
+
+	// Shrinking the limit drops the oldest entries
+	archive.setCacheLimit(entrySize);
+	BOOST_CHECK_EQUAL(archive.cacheSize(), entrySize);
+	archive.request("b", 10, 2);
+	BOOST_CHECK_EQUAL(archive.created, 4);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,211 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/greensfunction.h>
+#include <seiscomp/io/gfarchive.h>
+
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <list>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::IO;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Resolves requests with a delay which depends on the distance, fails
+//! requests with negative distances and tracks how many requests are
+//! resolved at the same time
+class SlowArchive : public GFArchive {
+	public:
+		~SlowArchive() { close(); }
+
+		bool setSource(string) override { return true; }
+		void close() override { cancelFetches(); }
+
+		bool setTimeSpan(const Core::TimeSpan &) override { return true; }
+
+		bool addRequest(const string &id, const string &model,
+		                const GFSource &source,
+		                const GFReceiver &receiver) override {
+			_requests.push_back({id, model, receiver.lat});
+			return true;
+		}
+
+		bool addRequest(const string &id, const string &model,
+		                const GFSource &source, const GFReceiver &receiver,
+		                const Core::TimeSpan &) override {
+			return addRequest(id, model, source, receiver);
+		}
+
+		Core::GreensFunction *get() override {
+			if ( threads() > 1 ) {
+				vector<Fetch> fetches;
+				for ( const Request &req : _requests )
+					fetches.push_back([this, req]() { return fetch(req); });
+				_requests.clear();
+				return fetchConcurrently(fetches);
+			}
+
+			while ( !_requests.empty() ) {
+				Request req = _requests.front();
+				_requests.pop_front();
+				Core::GreensFunction *gf = fetch(req);
+				if ( gf ) return gf;
+			}
+
+			return nullptr;
+		}
+
+		OPT(double) getTravelTime(const string &, const string &,
+		                          const GFSource &, const GFReceiver &) override {
+			return Core::None;
+		}
+
+	public:
+		atomic<int> active{0};
+		atomic<int> maxActive{0};
+
+	private:
+		struct Request {
+			string id;
+			string model;
+			double distance;
+		};
+
+		Core::GreensFunction *fetch(const Request &req) {
+			int n = ++active;
+			int m = maxActive;
+			while ( n > m && !maxActive.compare_exchange_weak(m, n) );
+
+			this_thread::sleep_for(chrono::milliseconds(static_cast<int>(fabs(req.distance))));
+			--active;
+
+			if ( req.distance < 0 )
+				return nullptr;
+
+			Core::GreensFunction *gf = new Core::GreensFunction(req.model, req.distance, 0, 1, 0);
+			gf->setId(req.id);
+			return gf;
+		}
+
+		list<Request> _requests;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_gfarchive_concurrent)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(allRequests) {
+	SlowArchive archive;
+	archive.setThreads(4);
+
+	set<string> expected;
+	// The first request takes much longer than the others
+	archive.addRequest("slow", "model", GFSource(), GFReceiver(100, 0));
+	expected.insert("slow");
+
+	for ( int i = 0; i < 20; ++i ) {
+		string id = to_string(i);
+		// Every fifth request fails
+		double distance = i % 5 == 4 ? -1 : 2;
+		archive.addRequest(id, "model", GFSource(), GFReceiver(distance, 0));
+		if ( distance >= 0 ) expected.insert(id);
+	}
+
+	set<string> ids;
+	vector<string> order;
+	Core::GreensFunctionPtr gf;
+	while ( (gf = archive.get()) ) {
+		BOOST_CHECK(ids.insert(gf->id()).second);
+		order.push_back(gf->id());
+	}
+
+	BOOST_CHECK(ids == expected);
+	BOOST_CHECK(archive.maxActive > 1);
+	BOOST_CHECK(archive.maxActive <= 4);
+	// The results are returned in the order of completion
+	BOOST_CHECK_EQUAL(order.back(), "slow");
+
+	// Requests added after all have been fetched start a new batch
+	archive.addRequest("again", "model", GFSource(), GFReceiver(1, 0));
+	gf = archive.get();
+	BOOST_REQUIRE(gf);
+	BOOST_CHECK_EQUAL(gf->id(), "again");
+	BOOST_CHECK(!archive.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(cancel) {
+	SlowArchive archive;
+	archive.setThreads(2);
+
+	for ( int i = 0; i < 10; ++i )
+		archive.addRequest(to_string(i), "model", GFSource(), GFReceiver(10, 0));
+
+	Core::GreensFunctionPtr gf = archive.get();
+	BOOST_CHECK(gf);
+
+	// Pending fetches are dropped, running ones are waited for
+	archive.close();
+	BOOST_CHECK_EQUAL(archive.active, 0);
+	BOOST_CHECK(!archive.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,183 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <map>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/io/recordfilter/async.h>
+#include <seiscomp/io/recordfilter/pipe.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::IO;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Holds back the last record fed and returns it with the next call to
+//! feed or flush
+class DelayFilter : public RecordFilterInterface {
+	public:
+		Record *feed(const Record *rec) override {
+			if ( !rec ) return nullptr;
+			Record *last = _last.release();
+			_last.reset(new GenericRecord(*static_cast<const GenericRecord*>(rec)));
+			return last;
+		}
+
+		Record *flush() override {
+			return _last.release();
+		}
+
+		void reset() override {
+			_last.reset();
+		}
+
+		RecordFilterInterface *clone() const override {
+			return new DelayFilter;
+		}
+
+	private:
+		unique_ptr<Record> _last;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Feeds records of several streams and checks that all records are
+//! returned in order per stream
+void checkOrder(RecordFilterInterface &filter, int streams, int count) {
+	Time startTime(2024,1,1,0,0,0,0);
+	map<string, vector<Time>> received;
+	size_t total = 0;
+
+	auto collect = [&](Record *rec) {
+		received[rec->streamID()].push_back(rec->startTime());
+		++total;
+		delete rec;
+	};
+
+	for ( int i = 0; i < count; ++i ) {
+		for ( int s = 0; s < streams; ++s ) {
+			GenericRecordPtr rec = new GenericRecord("XX", "S" + toString(s), "", "HHZ",
+			                                         startTime + TimeSpan(i), 1.0);
+			Record *out = filter.feed(rec.get());
+			while ( out ) {
+				collect(out);
+				out = filter.feed(nullptr);
+			}
+		}
+	}
+
+	Record *out;
+	while ( (out = filter.flush()) )
+		collect(out);
+
+	BOOST_CHECK_EQUAL(total, size_t(streams * count));
+	BOOST_CHECK_EQUAL(received.size(), size_t(streams));
+
+	for ( auto &item : received ) {
+		BOOST_REQUIRE_EQUAL(item.second.size(), size_t(count));
+		for ( int i = 0; i < count; ++i )
+			BOOST_CHECK_EQUAL(item.second[i].iso(), (startTime + TimeSpan(i)).iso());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordfilter_async)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Workers) {
+	AsyncFilter filter(new DelayFilter, 3, 4);
+	checkOrder(filter, 7, 200);
+
+	// The filter must be usable again after a flush
+	checkOrder(filter, 2, 10);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Stages) {
+	PipeFilter pipe(new AsyncFilter(new DelayFilter, 2, 8),
+	                new AsyncFilter(new DelayFilter, 2, 8));
+	checkOrder(pipe, 5, 100);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Reset) {
+	AsyncFilter filter(new DelayFilter, 2);
+	GenericRecordPtr rec = new GenericRecord("XX", "TEST", "", "HHZ",
+	                                         Time(2024,1,1,0,0,0,0), 1.0);
+	delete filter.feed(rec.get());
+	filter.reset();
+
+	Record *out;
+	size_t count = 0;
+	while ( (out = filter.flush()) ) {
+		++count;
+		delete out;
+	}
+
+	BOOST_CHECK_EQUAL(count, size_t(0));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,178 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/io/recordfilter/resample.h>
+#include <seiscomp/io/recordfilter/resampledesigns.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::IO;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Feeds a constant signal in records of 100 samples and returns all output
+//! samples
+vector<double> resampleConstant(double fromRate, double toRate, int count) {
+	RecordResampler<double> resampler(toRate);
+	vector<double> output;
+	Time startTime(2024,1,1,0,0,0,0);
+
+	for ( int i = 0; i < count; i += 100 ) {
+		GenericRecord rec("XX", "TEST", "", "HHZ",
+		                  startTime + TimeSpan(i / fromRate), fromRate);
+		rec.setData(new DoubleArray(100));
+		static_cast<DoubleArray*>(rec.data())->fill(1.0);
+
+		RecordPtr out = resampler.feed(&rec);
+		if ( !out ) continue;
+
+		BOOST_CHECK_CLOSE(out->samplingFrequency(), toRate, 1E-9);
+		const DoubleArray *data = static_cast<const DoubleArray*>(out->data());
+		output.insert(output.end(), data->typedData(), data->typedData() + data->size());
+	}
+
+	return output;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordfilter_resample)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(InnerProduct) {
+	vector<float> x = { 1, 2, 3, 4, 5, 6, 7 };
+	vector<double> c = { 0.5, -1, 2, 0.25, 1, -2, 3 };
+
+	double expected = 0;
+	for ( size_t i = 0; i < x.size(); ++i )
+		expected += x[i] * c[i];
+
+	for ( size_t n = 0; n <= x.size(); ++n ) {
+		double partial = 0;
+		for ( size_t i = 0; i < n; ++i )
+			partial += x[i] * c[i];
+		BOOST_CHECK_CLOSE(innerProduct(x.data(), c.data(), n), partial, 1E-12);
+	}
+
+	BOOST_CHECK_CLOSE(innerProduct(x.data(), c.data(), x.size()), expected, 1E-12);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(RingBuffer) {
+	// Ring of length 3 stored twice
+	vector<int> buffer(6, 0);
+	size_t front = 0;
+	vector<int> data = { 1, 2, 3, 4, 5 };
+
+	pushRing(buffer.data(), 3, front, data.data(), data.size());
+	BOOST_CHECK_EQUAL(front, 2);
+
+	// The window starting at front holds the last samples in order
+	BOOST_CHECK_EQUAL(buffer[front], 3);
+	BOOST_CHECK_EQUAL(buffer[front+1], 4);
+	BOOST_CHECK_EQUAL(buffer[front+2], 5);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(SharedDesigns) {
+	auto lowpass = ResampleDesigns::Lowpass(5, 0.7, 0.9, 10);
+	BOOST_REQUIRE(lowpass);
+	BOOST_CHECK_EQUAL(lowpass->size(), 5*10*2+1);
+	BOOST_CHECK(ResampleDesigns::Lowpass(5, 0.7, 0.9, 10) == lowpass);
+	BOOST_CHECK(ResampleDesigns::Lowpass(5, 0.6, 0.9, 10) != lowpass);
+
+	auto lanczos = ResampleDesigns::Lanczos(4, 3);
+	BOOST_REQUIRE(lanczos);
+	BOOST_CHECK_EQUAL(lanczos->size(), 4*7);
+	BOOST_CHECK(ResampleDesigns::Lanczos(4, 3) == lanczos);
+
+	// Phase 0 interpolates at the kernel center
+	for ( int i = 0; i < 7; ++i )
+		BOOST_CHECK_SMALL((*lanczos)[i] - (i == 3 ? 1.0 : 0.0), 1E-12);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ResampleConstant) {
+	// Downsampling
+	vector<double> down = resampleConstant(100, 20, 6000);
+	BOOST_REQUIRE(down.size() > 1000);
+	for ( double v : down )
+		BOOST_CHECK_SMALL(v - 1.0, 1E-2);
+
+	// Upsampling
+	vector<double> up = resampleConstant(20, 100, 2000);
+	BOOST_REQUIRE(up.size() > 9000);
+	for ( double v : up )
+		BOOST_CHECK_SMALL(v - 1.0, 5E-2);
+
+	// Rational ratio with up- and downsampling
+	vector<double> rational = resampleConstant(40, 100, 4000);
+	BOOST_REQUIRE(rational.size() > 9000);
+	for ( double v : rational )
+		BOOST_CHECK_SMALL(v - 1.0, 5E-2);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,146 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/io/recordfilter/spectralizer.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::IO;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Feeds a sine of 200s with the given amplitude and returns all spectra
+vector<SpectrumPtr> spectralize(Spectralizer &spec, double amplitude) {
+	const double fs = 20, f0 = 2.5;
+	Time startTime(2024,1,1,0,0,0,0);
+	vector<SpectrumPtr> spectra;
+
+	for ( int i = 0; i < 4000; i += 100 ) {
+		GenericRecord rec("XX", "TEST", "", "HHZ",
+		                  startTime + TimeSpan(i / fs), fs);
+		DoubleArrayPtr data = new DoubleArray(100);
+		for ( int j = 0; j < 100; ++j )
+			(*data)[j] = amplitude * sin(2*M_PI*f0*(i+j)/fs);
+		rec.setData(data.get());
+
+		spec.push(&rec);
+		while ( Spectrum *s = spec.pop() )
+			spectra.push_back(s);
+	}
+
+	return spectra;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordfilter_spectralizer)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Spectra) {
+	Spectralizer spec;
+	Spectralizer::Options opts;
+	opts.windowLength = 51.2;
+	BOOST_REQUIRE(spec.setOptions(opts));
+
+	auto spectra = spectralize(spec, 1.0);
+	BOOST_REQUIRE(!spectra.empty());
+	for ( auto &s : spectra ) {
+		BOOST_CHECK(!s->isPowerSpectralDensity());
+		// 1024 samples, the Nyquist bin depends on the fft implementation
+		BOOST_CHECK(s->data()->size() == 512 || s->data()->size() == 513);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(Welch) {
+	Spectralizer spec;
+	Spectralizer::Options opts;
+	opts.windowLength = 51.2;
+	opts.welchLength = 12.8;
+	opts.welchOverlap = 0.5;
+	opts.taperWidth = 0.5;
+	BOOST_REQUIRE(spec.setOptions(opts));
+
+	const double amplitude = 3.0;
+	auto spectra = spectralize(spec, amplitude);
+	BOOST_REQUIRE(!spectra.empty());
+
+	for ( auto &s : spectra ) {
+		BOOST_REQUIRE(s->isPowerSpectralDensity());
+		const ComplexDoubleArray *psd = s->data();
+		BOOST_REQUIRE(psd->size() == 128 || psd->size() == 129);
+
+		// The integrated density equals the variance of the sine and the
+		// peak is located at 2.5 Hz
+		double df = s->maximumFrequency() / 128, power = 0;
+		int peak = 0;
+		for ( int i = 0; i < psd->size(); ++i ) {
+			BOOST_CHECK_EQUAL((*psd)[i].imag(), 0.0);
+			power += (*psd)[i].real() * df;
+			if ( (*psd)[i].real() > (*psd)[peak].real() ) peak = i;
+		}
+
+		BOOST_CHECK_CLOSE(power, amplitude*amplitude*0.5, 5);
+		BOOST_CHECK_EQUAL(peak, 32);
+	}
+
+	opts.welchOverlap = 1;
+	BOOST_CHECK(!spec.setOptions(opts));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,199 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/io/records/steim.h>
+
+#include <libmseed.h>
+
+
+using namespace std;
+using namespace Seiscomp::IO;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+//! Creates random samples whose differences fit into the given bits
+vector<int32_t> createSamples(int count, int bits, unsigned int seed) {
+	vector<int32_t> samples(count);
+	int32_t amplitude = (1 << (bits - 1)) - 1;
+
+	srand(seed);
+
+	for ( int i = 0; i < count; ++i )
+		samples[i] = rand() % (amplitude + 1) - amplitude / 2;
+
+	return samples;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void checkRoundTrip(int steim, int count, int bits) {
+	vector<int32_t> samples = createSamples(count, bits, count + bits);
+	vector<char> frames(Steim::FrameSize * 64);
+	int packed;
+
+	int nframes = steim == 1 ?
+		Steim::encode1(samples.data(), count, samples[0], frames.data(), 64, &packed)
+		:
+		Steim::encode2(samples.data(), count, samples[0], frames.data(), 64, &packed);
+
+	BOOST_REQUIRE(nframes > 0);
+	BOOST_REQUIRE(packed > 0);
+	BOOST_CHECK(packed <= count);
+
+	vector<int32_t> decoded(packed);
+	int32_t last;
+
+	int n = steim == 1 ?
+		Steim::decode1(frames.data(), nframes, true, decoded.data(), packed, &last)
+		:
+		Steim::decode2(frames.data(), nframes, true, decoded.data(), packed, &last);
+
+	BOOST_REQUIRE_EQUAL(n, packed);
+	BOOST_CHECK_EQUAL(last, samples[packed-1]);
+	BOOST_CHECK_EQUAL_COLLECTIONS(decoded.begin(), decoded.end(),
+	                              samples.begin(), samples.begin() + packed);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_records_steim)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(STEIM1_ROUNDTRIP) {
+	for ( int bits : { 4, 8, 12, 16, 24, 31 } ) {
+		for ( int count : { 1, 2, 3, 7, 100, 2000 } )
+			checkRoundTrip(1, count, bits);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(STEIM2_ROUNDTRIP) {
+	for ( int bits : { 4, 5, 6, 8, 10, 15, 24, 30 } ) {
+		for ( int count : { 1, 2, 3, 7, 100, 2000 } )
+			checkRoundTrip(2, count, bits);
+	}
+
+	// Differences with more than 30 bits cannot be encoded
+	int32_t samples[] = { 0, 1 << 30 };
+	char frames[Steim::FrameSize];
+	int packed;
+	BOOST_CHECK_EQUAL(Steim::encode2(samples, 2, 0, frames, 1, &packed), -1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(LIBMSEED_BENCHMARK) {
+	// 4096 byte records
+	const int nframes = 63;
+	const int records = 2000;
+	const int swapflag = ms_bigendianhost() ? 0 : 1;
+
+	for ( int steim = 1; steim <= 2; ++steim ) {
+		vector<int32_t> samples = createSamples(nframes * 105, 10, steim);
+		vector<char> frames(Steim::FrameSize * nframes);
+		int packed;
+
+		int used = steim == 1 ?
+			Steim::encode1(samples.data(), samples.size(), samples[0], frames.data(), nframes, &packed)
+			:
+			Steim::encode2(samples.data(), samples.size(), samples[0], frames.data(), nframes, &packed);
+		BOOST_REQUIRE(used > 0);
+
+		vector<int32_t> native(packed), reference(packed);
+		int32_t *input = reinterpret_cast<int32_t*>(frames.data());
+		int inputLength = used * Steim::FrameSize;
+		int outputLength = packed * sizeof(int32_t);
+
+		auto start = chrono::steady_clock::now();
+		for ( int i = 0; i < records; ++i ) {
+			int n = steim == 1 ?
+				msr_decode_steim1(input, inputLength, packed, reference.data(),
+				                  outputLength, nullptr, swapflag)
+				:
+				msr_decode_steim2(input, inputLength, packed, reference.data(),
+				                  outputLength, nullptr, swapflag);
+			BOOST_REQUIRE_EQUAL(n, packed);
+		}
+		auto libmseedTime = chrono::steady_clock::now() - start;
+
+		start = chrono::steady_clock::now();
+		for ( int i = 0; i < records; ++i ) {
+			int n = steim == 1 ?
+				Steim::decode1(frames.data(), used, true, native.data(), packed)
+				:
+				Steim::decode2(frames.data(), used, true, native.data(), packed);
+			BOOST_REQUIRE_EQUAL(n, packed);
+		}
+		auto nativeTime = chrono::steady_clock::now() - start;
+
+		BOOST_CHECK_EQUAL_COLLECTIONS(native.begin(), native.end(),
+		                              reference.begin(), reference.end());
+
+		BOOST_TEST_MESSAGE("Steim" << steim << ": decoded " << records << " x "
+		                   << packed << " samples, libmseed "
+		                   << chrono::duration_cast<chrono::microseconds>(libmseedTime).count()
+		                   << " us, native "
+		                   << chrono::duration_cast<chrono::microseconds>(nativeTime).count()
+		                   << " us");
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
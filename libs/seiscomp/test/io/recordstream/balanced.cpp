@@ -0,0 +1,200 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestBalanced
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/metrics.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/io/recordstream.h>
+
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <set>
+#include <thread>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+
+
+namespace {
+
+
+/**
+ * Simulates an archive with records of ten minutes of all requested
+ * streams. Like an archive it returns all records which overlap the
+ * requested time windows. The source is the delay per record in
+ * milliseconds.
+ */
+class FakeArchive : public IO::RecordStream {
+	public:
+		bool setSource(const string &source) override {
+			_delay = chrono::milliseconds(atoi(source.c_str()));
+			return true;
+		}
+
+		bool addStream(const string &, const string &,
+		               const string &, const string &) override {
+			return true;
+		}
+
+		bool addStream(const string &net, const string &sta,
+		               const string &loc, const string &cha,
+		               const Time &stime, const Time &etime) override {
+			double start = floor(double(stime) / RecordLength) * RecordLength;
+			for ( double t = start; t < double(etime); t += RecordLength ) {
+				GenericRecord *rec = new GenericRecord(net, sta, loc, cha, Time(t),
+				                                       1.0 / RecordLength);
+				rec->setData(new DoubleArray(1));
+				_records.push_back(rec);
+			}
+			return true;
+		}
+
+		bool setStartTime(const Time &) override { return true; }
+		bool setEndTime(const Time &) override { return true; }
+		void close() override { _closed = true; }
+
+		Record *next() override {
+			if ( _closed || _index >= _records.size() )
+				return nullptr;
+
+			this_thread::sleep_for(_delay);
+			return _records[_index++];
+		}
+
+		static constexpr double RecordLength = 600;
+
+	private:
+		vector<Record*>      _records;
+		size_t               _index{0};
+		chrono::milliseconds _delay;
+		atomic<bool>         _closed{false};
+};
+
+
+REGISTER_RECORDSTREAM(FakeArchive, "fakearchive");
+
+
+vector<RecordPtr> readAll(IO::RecordStream &rs) {
+	vector<RecordPtr> records;
+	RecordPtr rec;
+	while ( (rec = rs.next()) )
+		records.push_back(rec);
+	return records;
+}
+
+
+}
+
+
+struct GlobalFixture {
+	GlobalFixture() {
+		Logging::enableConsoleLogging(Logging::getAll());
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_balanced)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(SPLIT_WINDOWS) {
+	// Ten days which do not start at a record boundary. The request is
+	// split into windows of a day and each record overlapping two windows
+	// must be delivered once.
+	Time startTime(2020,1,1,0,5,0,0);
+	Time endTime(2020,1,11,0,0,0,0);
+
+	IO::RecordStreamPtr rs = IO::RecordStream::Create("balanced");
+	BOOST_REQUIRE(rs);
+	BOOST_REQUIRE(rs->setSource("fakearchive/0;fakearchive/0;fakearchive/0"));
+	BOOST_REQUIRE(rs->setTimeWindow(TimeWindow(startTime, endTime)));
+	BOOST_REQUIRE(rs->addStream("XX", "A", "", "HHZ"));
+	BOOST_REQUIRE(rs->addStream("XX", "B", "", "HHZ"));
+	BOOST_REQUIRE(rs->addStream("XX", "C", "", "HHZ",
+	                            Time(2020,1,5,0,0,0,0), Time(2020,1,6,0,0,0,0)));
+
+	set<string> keys;
+	auto records = readAll(*rs);
+	for ( const auto &rec : records )
+		BOOST_CHECK(keys.insert(rec->streamID() + " " + rec->startTime().iso()).second);
+
+	// The first record starts before the request and the last one of the
+	// ten days is missing
+	BOOST_CHECK_EQUAL(records.size(), 1440 + 1440 + 144);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(THROUGHPUT) {
+	// The second source is ten times slower and must take less work
+	auto &slow = Metrics::counter("recordstream.balanced.1.records");
+	int64_t before = slow.value();
+
+	IO::RecordStreamPtr rs = IO::RecordStream::Create("balanced");
+	BOOST_REQUIRE(rs);
+	BOOST_REQUIRE(rs->setSource("fakearchive/0;fakearchive/1"));
+	BOOST_REQUIRE(rs->setTimeWindow(TimeWindow(Time(2020,1,1,0,0,0,0),
+	                                           Time(2020,1,21,0,0,0,0))));
+	for ( int i = 0; i < 5; ++i )
+		BOOST_REQUIRE(rs->addStream("XX", "S" + to_string(i), "", "HHZ"));
+
+	size_t count = readAll(*rs).size();
+	BOOST_CHECK_EQUAL(count, 5 * 2880);
+	BOOST_CHECK_LT(slow.value() - before, int64_t(count / 3));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(REAL_TIME) {
+	// Without an end time the streams are assigned statically and the
+	// proxies get the stream without a time window
+	IO::RecordStreamPtr rs = IO::RecordStream::Create("balanced");
+	BOOST_REQUIRE(rs);
+	BOOST_REQUIRE(rs->setSource("fakearchive/0;fakearchive/0"));
+	BOOST_REQUIRE(rs->setStartTime(Time(2020,1,1,0,0,0,0)));
+	BOOST_REQUIRE(rs->addStream("XX", "A", "", "HHZ"));
+	BOOST_CHECK(readAll(*rs).empty());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
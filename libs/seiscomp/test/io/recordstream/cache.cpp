@@ -0,0 +1,158 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestCache
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <boost/filesystem.hpp>
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/io/recordstream/cache.h>
+#include <seiscomp/io/recordstream/sdsarchive.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace fs = boost::filesystem;
+
+
+namespace {
+
+
+vector<RecordPtr> readAll(IO::RecordStream &rs) {
+	vector<RecordPtr> records;
+	RecordPtr rec;
+	while ( (rec = rs.next()) )
+		records.push_back(rec);
+	return records;
+}
+
+
+vector<RecordPtr> readCache(const string &source, const Time &startTime,
+                            const Time &endTime) {
+	Cache cache;
+	BOOST_REQUIRE(cache.setSource(source));
+	cache.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+	return readAll(cache);
+}
+
+
+vector<RecordPtr> readArchive(const Time &startTime, const Time &endTime) {
+	SDSArchive sds("archive");
+	sds.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+	return readAll(sds);
+}
+
+
+size_t countChunks(const fs::path &dir) {
+	size_t count = 0;
+	for ( fs::recursive_directory_iterator it(dir), end; it != end; ++it ) {
+		if ( fs::is_regular_file(it->path()) && it->path().extension() == ".mseed" )
+			++count;
+	}
+	return count;
+}
+
+
+void checkEqual(const vector<RecordPtr> &records, const vector<RecordPtr> &reference) {
+	BOOST_REQUIRE_EQUAL(records.size(), reference.size());
+	for ( size_t i = 0; i < records.size(); ++i ) {
+		BOOST_CHECK_EQUAL(records[i]->startTime().iso(), reference[i]->startTime().iso());
+		BOOST_CHECK_EQUAL(records[i]->sampleCount(), reference[i]->sampleCount());
+	}
+}
+
+
+}
+
+
+struct GlobalFixture {
+	GlobalFixture() {
+		Logging::enableConsoleLogging(Logging::getAll());
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_cache)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(FETCH_GAPS) {
+	fs::path dir = fs::temp_directory_path() / fs::unique_path();
+	string params = "??dir=" + dir.string();
+
+	Time startTime(2018,06,30,16,19,0,0);
+	Time endTime(2018,06,30,16,20,0,0);
+
+	// First request fetches the window from the archive
+	auto records = readCache("sdsarchive/archive" + params, startTime, endTime);
+	BOOST_REQUIRE(!records.empty());
+	checkEqual(records, readArchive(startTime, endTime));
+	BOOST_CHECK_EQUAL(countChunks(dir), 1);
+
+	// Second request is served from the cache only
+	checkEqual(readCache("sdsarchive/missing-archive" + params, startTime, endTime), records);
+	BOOST_CHECK_EQUAL(countChunks(dir), 1);
+
+	// A larger window fetches the gaps in front and after the cached window
+	Time wideStartTime(2018,06,30,16,18,30,0);
+	Time wideEndTime(2018,06,30,16,21,0,0);
+	checkEqual(readCache("sdsarchive/archive" + params, wideStartTime, wideEndTime),
+	           readArchive(wideStartTime, wideEndTime));
+	BOOST_CHECK_EQUAL(countChunks(dir), 3);
+
+	fs::remove_all(dir);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(PASS_THROUGH) {
+	fs::path dir = fs::temp_directory_path() / fs::unique_path();
+
+	// Windows without end time are not cached
+	Cache cache;
+	BOOST_REQUIRE(cache.setSource("sdsarchive/archive??dir=" + dir.string()));
+	cache.addStream("FR", "SALF", "00", "HHN");
+	cache.setStartTime(Time(2018,06,30,16,19,0,0));
+
+	BOOST_CHECK(!readAll(cache).empty());
+	BOOST_CHECK(!fs::exists(dir));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
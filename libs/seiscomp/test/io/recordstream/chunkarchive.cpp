@@ -0,0 +1,143 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestChunkArchive
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <boost/filesystem.hpp>
+
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/io/recordstream/chunkarchive.h>
+#include <seiscomp/io/recordstream/sdsarchive.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace fs = boost::filesystem;
+
+
+namespace {
+
+
+RecordPtr readContiguous(IO::RecordStream &rs) {
+	RingBuffer buffer(0);
+	RecordPtr rec;
+	while ( (rec = rs.next()) )
+		buffer.push_back(rec);
+	return buffer.contiguousRecord<int>();
+}
+
+
+}
+
+
+struct GlobalFixture {
+	GlobalFixture() {
+		Logging::enableConsoleLogging(Logging::getAll());
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_chunkarchive)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(WRITE_READ_FR_SALF) {
+	fs::path dir = fs::temp_directory_path() / fs::unique_path();
+
+	Time startTime(2018,06,30,16,18,38,943300);
+	Time endTime(2018,06,30,16,21,58,943300);
+
+	SDSArchive sds("archive");
+	sds.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+
+	RecordPtr reference;
+	{
+		RingBuffer buffer(0);
+		ChunkArchiveWriter writer(dir.string(), 1000);
+		RecordPtr rec;
+		while ( (rec = sds.next()) ) {
+			BOOST_REQUIRE(writer.write(rec.get()));
+			buffer.push_back(rec);
+		}
+		BOOST_REQUIRE(writer.flush());
+		reference = buffer.contiguousRecord<int>();
+	}
+
+	BOOST_REQUIRE(reference);
+
+	// The complete time span returns all samples
+	{
+		ChunkArchive archive;
+		BOOST_REQUIRE(archive.setSource(dir.string()));
+		archive.addStream("FR", "SALF", "00", "HHN",
+		                  reference->startTime(), reference->endTime());
+		RecordPtr crec = readContiguous(archive);
+		BOOST_REQUIRE(crec);
+		BOOST_CHECK_EQUAL(crec->startTime().iso(), reference->startTime().iso());
+		BOOST_REQUIRE_EQUAL(crec->sampleCount(), reference->sampleCount());
+
+		const IntArray *samples = static_cast<const IntArray*>(crec->data());
+		const IntArray *expected = static_cast<const IntArray*>(reference->data());
+		BOOST_CHECK(equal(samples->typedData(), samples->typedData() + samples->size(),
+		                  expected->typedData()));
+	}
+
+	// A time window is cut to the samples within the window
+	{
+		ChunkArchive archive;
+		BOOST_REQUIRE(archive.setSource(dir.string()));
+		archive.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+		RecordPtr crec = readContiguous(archive);
+		BOOST_REQUIRE(crec);
+		BOOST_CHECK(crec->startTime() >= startTime);
+		BOOST_CHECK(crec->startTime() - startTime < TimeSpan(1.0 / crec->samplingFrequency()));
+		BOOST_CHECK(crec->endTime() - endTime <= TimeSpan(1.0 / crec->samplingFrequency()));
+
+		size_t offset = static_cast<size_t>((double)(crec->startTime() - reference->startTime()) * crec->samplingFrequency() + 0.5);
+		const IntArray *samples = static_cast<const IntArray*>(crec->data());
+		const IntArray *expected = static_cast<const IntArray*>(reference->data());
+		BOOST_REQUIRE(offset + samples->size() <= static_cast<size_t>(expected->size()));
+		BOOST_CHECK(equal(samples->typedData(), samples->typedData() + samples->size(),
+		                  expected->typedData() + offset));
+	}
+
+	fs::remove_all(dir);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
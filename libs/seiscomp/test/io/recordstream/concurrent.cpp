@@ -0,0 +1,242 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestConcurrent
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/io/recordstream/concurrent.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace {
+
+
+/**
+ * Returns one-sample records of station sta which start at the given
+ * times, optionally delayed.
+ */
+class FakeStream : public IO::RecordStream {
+	public:
+		FakeStream(const string &sta, vector<double> times,
+		           chrono::milliseconds delay = chrono::milliseconds(0),
+		           chrono::milliseconds finishDelay = chrono::milliseconds(0))
+		: _sta(sta), _times(times), _delay(delay), _finishDelay(finishDelay) {}
+
+	public:
+		bool setSource(const string &) override { return true; }
+		bool addStream(const string &, const string &,
+		               const string &, const string &) override { return true; }
+		bool addStream(const string &, const string &,
+		               const string &, const string &,
+		               const Time &, const Time &) override { return true; }
+		bool setStartTime(const Time &) override { return true; }
+		bool setEndTime(const Time &) override { return true; }
+		void close() override { _closed = true; }
+
+		Record *next() override {
+			if ( _closed ) return nullptr;
+
+			if ( _index >= _times.size() ) {
+				this_thread::sleep_for(_finishDelay);
+				return nullptr;
+			}
+
+			this_thread::sleep_for(_delay);
+
+			GenericRecord *rec = new GenericRecord("XX", _sta, "", "HHZ",
+			                                       Time(_times[_index++]), 1.0);
+			rec->setData(new DoubleArray(1));
+			return rec;
+		}
+
+	private:
+		string               _sta;
+		vector<double>       _times;
+		size_t               _index{0};
+		chrono::milliseconds _delay;
+		chrono::milliseconds _finishDelay;
+		atomic<bool>         _closed{false};
+};
+
+
+/**
+ * Routes station A to the first and all other stations to the second
+ * proxy stream.
+ */
+class TestConcurrent : public Concurrent {
+	public:
+		TestConcurrent(IO::RecordStream *a, IO::RecordStream *b) {
+			_rsarray.push_back(make_pair(a, false));
+			_rsarray.push_back(make_pair(b, false));
+			addStream("XX", "A", "", "HHZ");
+			addStream("XX", "B", "", "HHZ");
+		}
+
+		bool setSource(const string &source) override {
+			string tmp = source;
+			return extractMergeOption(tmp);
+		}
+
+	protected:
+		int getRS(const string &, const string &sta,
+		          const string &, const string &) override {
+			return sta == "A" ? 0 : 1;
+		}
+};
+
+
+vector<double> range(double start, double step, size_t count) {
+	vector<double> values;
+	for ( size_t i = 0; i < count; ++i )
+		values.push_back(start + step * i);
+	return values;
+}
+
+
+vector<RecordPtr> readAll(IO::RecordStream &rs) {
+	vector<RecordPtr> records;
+	RecordPtr rec;
+	while ( (rec = rs.next()) )
+		records.push_back(rec);
+	return records;
+}
+
+
+bool isSorted(const vector<RecordPtr> &records) {
+	for ( size_t i = 1; i < records.size(); ++i ) {
+		if ( records[i]->endTime() < records[i-1]->endTime() )
+			return false;
+	}
+
+	return true;
+}
+
+
+}
+
+
+struct GlobalFixture {
+	GlobalFixture() {
+		Logging::enableConsoleLogging(Logging::getAll());
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_concurrent)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ARRIVAL_ORDER) {
+	TestConcurrent rs(new FakeStream("A", range(0, 2, 20)),
+	                  new FakeStream("B", range(1, 2, 20), chrono::milliseconds(2)));
+
+	BOOST_CHECK(rs.mergeLateness() == TimeSpan(0,0));
+	BOOST_CHECK_EQUAL(readAll(rs).size(), 40);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MERGE) {
+	// B is much slower than A, the merge waits for it
+	TestConcurrent rs(new FakeStream("A", range(0, 2, 20)),
+	                  new FakeStream("B", range(1, 2, 20), chrono::milliseconds(2)));
+
+	BOOST_REQUIRE(rs.setMergeLateness(TimeSpan(1000.0)));
+
+	auto records = readAll(rs);
+	BOOST_CHECK_EQUAL(records.size(), 40);
+	BOOST_CHECK(isSorted(records));
+	BOOST_CHECK(!rs.setMergeLateness(TimeSpan(10.0)));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(STALLED_STREAM) {
+	// B does not deliver anything for a while, A is only held back by the
+	// lateness
+	TestConcurrent rs(new FakeStream("A", range(0, 1, 100)),
+	                  new FakeStream("B", {}, chrono::milliseconds(0),
+	                                 chrono::milliseconds(500)));
+
+	BOOST_REQUIRE(rs.setMergeLateness(TimeSpan(10.0)));
+
+	auto start = chrono::steady_clock::now();
+	RecordPtr first = rs.next();
+	auto elapsed = chrono::steady_clock::now() - start;
+
+	BOOST_REQUIRE(first);
+	BOOST_CHECK(first->startTime() == Time(0.0));
+	BOOST_CHECK(elapsed < chrono::milliseconds(400));
+
+	auto records = readAll(rs);
+	BOOST_CHECK_EQUAL(records.size(), 99);
+	BOOST_CHECK(isSorted(records));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MERGE_OPTION) {
+	TestConcurrent rs(new FakeStream("A", {}), new FakeStream("B", {}));
+
+	BOOST_CHECK(rs.setSource("slink/a:18000;slink/b:18000??merge=2.5"));
+	BOOST_CHECK(rs.mergeLateness() == TimeSpan(2.5));
+
+	// Options of parenthesized proxy streams are not taken
+	BOOST_CHECK(rs.setSource("slink/a:18000;combined/(slink/b;sds/c??merge=5)"));
+	BOOST_CHECK(rs.mergeLateness() == TimeSpan(0,0));
+
+	BOOST_CHECK(!rs.setSource("slink/a:18000??merge=-1"));
+	BOOST_CHECK(!rs.setSource("slink/a:18000??merge=x"));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
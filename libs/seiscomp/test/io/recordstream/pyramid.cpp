@@ -0,0 +1,209 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestPyramid
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/io/recordstream/pyramid.h>
+#include <seiscomp/io/recordstream/sdsarchive.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace fs = boost::filesystem;
+
+
+namespace {
+
+
+vector<RecordPtr> readAll(IO::RecordStream &rs) {
+	vector<RecordPtr> records;
+	RecordPtr rec;
+	while ( (rec = rs.next()) )
+		records.push_back(rec);
+	return records;
+}
+
+
+size_t sampleCount(const vector<RecordPtr> &records) {
+	size_t count = 0;
+	for ( const RecordPtr &rec : records )
+		count += static_cast<size_t>(rec->sampleCount());
+	return count;
+}
+
+
+}
+
+
+struct GlobalFixture {
+	GlobalFixture() {
+		Logging::enableConsoleLogging(Logging::getAll());
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_pyramid)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(WRITE_READ_LEVELS) {
+	fs::path dir = fs::temp_directory_path() / fs::unique_path();
+
+	Time startTime(2018,06,30,16,18,0,0);
+	Time endTime(2018,06,30,16,22,0,0);
+
+	SDSArchive sds("archive");
+	sds.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+
+	RingBuffer buffer(0);
+	{
+		DecimationPyramid pyramid(dir.string(), { 10, 60 });
+		RecordPtr rec;
+		while ( (rec = sds.next()) ) {
+			BOOST_REQUIRE(pyramid.write(rec.get()));
+			buffer.push_back(rec);
+		}
+		BOOST_REQUIRE(pyramid.flush());
+	}
+
+	RecordPtr reference = buffer.contiguousRecord<double>();
+	BOOST_REQUIRE(reference);
+
+	vector<int> levels = DecimationPyramid::Levels(dir.string());
+	BOOST_REQUIRE_EQUAL(levels.size(), 2);
+	BOOST_CHECK_EQUAL(levels[0], 10);
+	BOOST_CHECK_EQUAL(levels[1], 60);
+
+	// 0.05 sps is provided by the 10s level only
+	{
+		Pyramid pyramid;
+		BOOST_REQUIRE(pyramid.setSource(dir.string() + "?rate=0.05&stat=minmax"));
+		BOOST_CHECK_EQUAL(pyramid.level(), 10);
+		pyramid.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+		vector<RecordPtr> records = readAll(pyramid);
+		BOOST_REQUIRE(!records.empty());
+		BOOST_CHECK_EQUAL(records.front()->samplingFrequency(), 0.2);
+
+		// Check the first complete bin against the samples
+		const DoubleArray *samples = static_cast<const DoubleArray*>(reference->data());
+		Time binStart = records.front()->startTime();
+		size_t index = 0;
+		if ( binStart < reference->startTime() ) {
+			binStart += TimeSpan(10, 0);
+			index = 2;
+		}
+
+		size_t first = static_cast<size_t>(ceil((double)(binStart - reference->startTime()) * reference->samplingFrequency()));
+		size_t last = static_cast<size_t>(ceil((double)(binStart + TimeSpan(10, 0) - reference->startTime()) * reference->samplingFrequency()));
+		BOOST_REQUIRE(last <= static_cast<size_t>(samples->size()));
+
+		const DoubleArray *bins = static_cast<const DoubleArray*>(records.front()->data());
+		BOOST_REQUIRE(index + 1 < static_cast<size_t>(bins->size()));
+		BOOST_CHECK_EQUAL((*bins)[index], *min_element(samples->typedData() + first, samples->typedData() + last));
+		BOOST_CHECK_EQUAL((*bins)[index+1], *max_element(samples->typedData() + first, samples->typedData() + last));
+	}
+
+	// Lower rates read the coarsest level
+	{
+		Pyramid pyramid;
+		BOOST_REQUIRE(pyramid.setSource(dir.string() + "?rate=0.001&stat=mean"));
+		BOOST_CHECK_EQUAL(pyramid.level(), 60);
+		pyramid.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+		vector<RecordPtr> records = readAll(pyramid);
+		BOOST_REQUIRE(!records.empty());
+		BOOST_CHECK(sampleCount(records) <= 5);
+	}
+
+	// Samples which have been added already are ignored
+	{
+		DecimationPyramid pyramid(dir.string(), { 10 });
+		BOOST_REQUIRE(pyramid.write(reference.get()));
+		BOOST_REQUIRE(pyramid.flush());
+
+		Pyramid stream;
+		BOOST_REQUIRE(stream.setSource(dir.string() + "?rate=0.1&stat=mean"));
+		stream.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+		vector<RecordPtr> records = readAll(stream);
+		BOOST_REQUIRE(!records.empty());
+
+		const DoubleArray *bins = static_cast<const DoubleArray*>(records.back()->data());
+		const DoubleArray *samples = static_cast<const DoubleArray*>(reference->data());
+		BOOST_CHECK((*bins)[bins->size()-1] >= *min_element(samples->typedData(), samples->typedData() + samples->size()));
+		BOOST_CHECK((*bins)[bins->size()-1] <= *max_element(samples->typedData(), samples->typedData() + samples->size()));
+	}
+
+	fs::remove_all(dir);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(UPDATE_FROM_ARCHIVE) {
+	fs::path dir = fs::temp_directory_path() / fs::unique_path();
+
+	for ( fs::recursive_directory_iterator it("archive"), end; it != end; ++it ) {
+		fs::path target = dir / fs::relative(it->path(), "archive");
+		if ( fs::is_directory(it->path()) )
+			fs::create_directories(target);
+		else
+			fs::copy_file(it->path(), target);
+	}
+
+	DecimationPyramid pyramid(dir.string());
+	BOOST_CHECK_EQUAL(pyramid.update(), 1);
+	BOOST_CHECK_EQUAL(pyramid.update(), 0);
+
+	Pyramid stream;
+	BOOST_REQUIRE(stream.setSource(dir.string() + "?rate=0.01"));
+	BOOST_CHECK_EQUAL(stream.level(), 60);
+	stream.addStream("FR", "SALF", "00", "HHN",
+	                 Time(2018,06,30,0,0,0,0), Time(2018,07,01,0,0,0,0));
+	BOOST_CHECK(!readAll(stream).empty());
+
+	fs::remove_all(dir);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,208 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestReplay
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/io/recordstream/file.h>
+#include <seiscomp/io/recordstream/replay.h>
+
+#include <chrono>
+#include <set>
+#include <thread>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace {
+
+
+const char *Files =
+	"archive-day1/BHZ/2019/GE/MORC/BHZ.D/GE.MORC..BHZ.D.2019.121,"
+	"archive-day1/BHN/2019/GE/MORC/BHN.D/GE.MORC..BHN.D.2019.121,"
+	"archive-day1/BHE/2019/GE/MORC/BHE.D/GE.MORC..BHE.D.2019.121";
+
+
+size_t countRecords(const string &fname) {
+	File file;
+	BOOST_REQUIRE(file.setSource(fname));
+	size_t count = 0;
+	RecordPtr rec;
+	while ( (rec = file.next()) )
+		++count;
+	return count;
+}
+
+
+}
+
+
+struct GlobalFixture {
+	GlobalFixture() {
+		Logging::enableConsoleLogging(Logging::getAll());
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_replay)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MERGE_IN_TIME_ORDER) {
+	vector<string> fnames;
+	Core::split(fnames, Files, ",");
+
+	size_t expected = 0;
+	for ( const string &fname : fnames )
+		expected += countRecords(fname);
+
+	Replay replay;
+	BOOST_REQUIRE(replay.setSource(Files));
+
+	vector<RecordPtr> records;
+	RecordPtr rec;
+	while ( (rec = replay.next()) )
+		records.push_back(rec);
+
+	BOOST_CHECK_EQUAL(records.size(), expected);
+
+	set<string> streams;
+	for ( size_t i = 0; i < records.size(); ++i ) {
+		streams.insert(records[i]->streamID());
+		if ( i > 0 ) {
+			BOOST_CHECK(records[i-1]->endTime() <= records[i]->endTime());
+		}
+	}
+
+	BOOST_CHECK_EQUAL(streams.size(), 3);
+
+	// A second replay yields the same sequence
+	BOOST_REQUIRE(replay.setSource(Files));
+	for ( const RecordPtr &ref : records ) {
+		rec = replay.next();
+		BOOST_REQUIRE(rec);
+		BOOST_CHECK_EQUAL(rec->streamID(), ref->streamID());
+		BOOST_CHECK_EQUAL(rec->startTime().iso(), ref->startTime().iso());
+	}
+
+	BOOST_CHECK(!replay.next());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(FILTER) {
+	Replay replay;
+	BOOST_REQUIRE(replay.setSource(Files));
+	replay.addStream("GE", "MORC", "", "BH?");
+	replay.addStream("GE", "MORC", "", "BHZ");
+
+	size_t all = 0;
+	RecordPtr rec;
+	while ( (rec = replay.next()) )
+		++all;
+
+	BOOST_REQUIRE(replay.setSource(Files));
+	replay.addStream("GE", "MORC", "", "BHZ");
+
+	size_t z = 0;
+	while ( (rec = replay.next()) ) {
+		BOOST_CHECK_EQUAL(rec->channelCode(), "BHZ");
+		++z;
+	}
+
+	BOOST_CHECK(z > 0);
+	BOOST_CHECK(z < all);
+
+	// Drop the last BHZ record which starts at 23:59:56
+	Time startTime(2019,5,1,23,59,0);
+	Time endTime(2019,5,1,23,59,50);
+
+	BOOST_REQUIRE(replay.setSource(Files));
+	replay.addStream("GE", "MORC", "", "BHZ", startTime, endTime);
+
+	size_t windowed = 0;
+	while ( (rec = replay.next()) ) {
+		BOOST_CHECK(rec->endTime() >= startTime);
+		BOOST_CHECK(rec->startTime() < endTime);
+		++windowed;
+	}
+
+	BOOST_CHECK(windowed > 0);
+	BOOST_CHECK(windowed < z);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(PACING) {
+	Replay replay;
+	BOOST_CHECK(!replay.setSource(string(Files) + "?speed=0"));
+	BOOST_CHECK(!replay.setSource(string(Files) + "?unknown"));
+
+	// A hundredth of real time: the records are at least seconds apart,
+	// so the second record is due minutes after the first one
+	BOOST_REQUIRE(replay.setSource(string(Files) + "?speed=0.01"));
+	BOOST_CHECK_EQUAL(replay.speed(), 0.01);
+
+	RecordPtr first = replay.next();
+	BOOST_REQUIRE(first);
+
+	thread closer([&replay]() {
+		this_thread::sleep_for(chrono::milliseconds(200));
+		replay.close();
+	});
+
+	auto start = chrono::steady_clock::now();
+	RecordPtr rec;
+	while ( (rec = replay.next()) ) {
+		// Records which end together with the first one are not delayed
+		BOOST_REQUIRE(rec->endTime() == first->endTime());
+	}
+	auto elapsed = chrono::steady_clock::now() - start;
+	closer.join();
+
+	BOOST_CHECK(elapsed >= chrono::milliseconds(150));
+	BOOST_CHECK(elapsed < chrono::seconds(5));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,8 +24,13 @@
 
 #include <seiscomp/unittest/unittests.h>
 
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
 #include <seiscomp/core/recordsequence.h>
 #include <seiscomp/logging/log.h>
+#include <seiscomp/datamodel/dataextent.h>
 #include <seiscomp/io/recordstream/sdsarchive.h>
 
 
@@ -36,6 +41,9 @@ using namespace Seiscomp::IO;
 using namespace Seiscomp::RecordStream;
 
 
+namespace fs = boost::filesystem;
+
+
 struct GlobalFixture {
 	GlobalFixture() {
 		Logging::enableConsoleLogging(Logging::getAll());
@@ -74,6 +82,118 @@ BOOST_AUTO_TEST_CASE(READ_FR_SALF) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(READ_FR_SALF_MMAP_INDEX) {
+	Time startTime(2018,06,30,16,18,38,943300);
+	Time endTime(2018,06,30,16,21,58,943300);
+
+	// Work on a copy to not write the index into the source tree
+	fs::path tmpArchive = fs::temp_directory_path() / fs::unique_path();
+	fs::path dir = tmpArchive / "2018/FR/SALF/HHN.D";
+	fs::create_directories(dir);
+	fs::copy_file("archive/2018/FR/SALF/HHN.D/FR.SALF.00.HHN.D.2018.181",
+	              dir / "FR.SALF.00.HHN.D.2018.181");
+
+	vector<string> sources = {
+		"archive",
+		"archive?mmap",
+		"archive?readahead=2",
+		tmpArchive.string() + "?index",
+		// Second pass reuses the index written by the first one
+		tmpArchive.string() + "?mmap&index",
+		tmpArchive.string() + "?index&readahead=2"
+	};
+
+	vector<RecordPtr> reference;
+	fs::path idxFile = dir / ".FR.SALF.00.HHN.D.2018.181.idx";
+
+	for ( const string &source : sources ) {
+		if ( source == sources.back() ) {
+			// A truncated index must be rebuilt and not be trusted
+			BOOST_REQUIRE(fs::exists(idxFile));
+			fs::resize_file(idxFile, fs::file_size(idxFile) - 8);
+		}
+
+		SDSArchive sds;
+		BOOST_REQUIRE(sds.setSource(source));
+		sds.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+
+		vector<RecordPtr> records;
+		RecordPtr rec;
+		while ( (rec = sds.next()) )
+			records.push_back(rec);
+
+		if ( reference.empty() ) {
+			BOOST_REQUIRE(!records.empty());
+			reference = records;
+			continue;
+		}
+
+		BOOST_REQUIRE_EQUAL(records.size(), reference.size());
+		for ( size_t i = 0; i < records.size(); ++i ) {
+			BOOST_CHECK_EQUAL(records[i]->startTime().iso(), reference[i]->startTime().iso());
+			BOOST_CHECK_EQUAL(records[i]->sampleCount(), reference[i]->sampleCount());
+		}
+	}
+
+	BOOST_CHECK(fs::exists(idxFile));
+
+	// No temporary index files must be left behind
+	size_t files = 0;
+	for ( fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it )
+		++files;
+	BOOST_CHECK_EQUAL(files, 2);
+
+	fs::remove_all(tmpArchive);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(READ_FR_SALF_SEGMENTS) {
+	Time startTime(2018,06,30,16,18,38,943300);
+	Time endTime(2018,06,30,16,21,58,943300);
+
+	// The raw records as read record by record
+	string reference;
+	{
+		SDSArchive sds("archive");
+		sds.setDataHint(Record::SAVE_RAW);
+		sds.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+
+		RecordPtr rec;
+		while ( (rec = sds.next()) ) {
+			const Array *raw = rec->raw();
+			BOOST_REQUIRE(raw);
+			reference.append(static_cast<const char*>(raw->data()),
+			                 raw->size() * raw->elementSize());
+		}
+	}
+
+	BOOST_REQUIRE(!reference.empty());
+
+	SDSArchive sds("archive");
+	sds.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+
+	string passthrough;
+	SDSArchive::FileSegment segment;
+	while ( sds.nextSegment(segment) ) {
+		ifstream ifs(segment.path.c_str(), ios::binary);
+		ifs.seekg(segment.offset);
+		string block(segment.length, '\0');
+		BOOST_REQUIRE(ifs.read(&block[0], block.size()));
+		passthrough += block;
+	}
+
+	BOOST_CHECK(passthrough == reference);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_CASE(READ_FR_SALF_MULTIPLE) {
 	SDSArchive sds(
@@ -123,6 +243,43 @@ BOOST_AUTO_TEST_CASE(READ_FR_SALF_MULTIPLE) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(READ_FR_SALF_MULTIPLE_READAHEAD) {
+	Time startTime(2019,5,1,23,59,10,0);
+	Time endTime(2019,5,2,0,0,50,0);
+
+	vector<string> channels;
+
+	for ( const char *options : { "", "?readahead=3" } ) {
+		SDSArchive sds;
+		BOOST_REQUIRE(sds.setSource(
+			string("archive-day2/BHE,archive-day1/BHE,archive-day1/BHN,"
+			       "archive-day2/BHN,archive-day1/BHZ,archive-day2/BHZ") + options
+		));
+
+		sds.addStream("GE", "MORC", "", "BHE", startTime, endTime);
+		sds.addStream("GE", "MORC", "", "BHN", startTime, endTime);
+		sds.addStream("GE", "MORC", "", "BHZ", startTime, endTime);
+
+		vector<string> records;
+		RecordPtr rec;
+		while ( (rec = sds.next()) )
+			records.push_back(rec->streamID() + " " + rec->startTime().iso());
+
+		// The order of the records must not be changed by the prefetching
+		if ( channels.empty() )
+			channels = records;
+		else
+			BOOST_CHECK(records == channels);
+	}
+
+	BOOST_CHECK(!channels.empty());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_CASE(READ_FR_SALF_INCOMPLETE) {
 	SDSArchive sds("incomplete-archive");
@@ -250,5 +407,67 @@ BOOST_AUTO_TEST_CASE(READ_GAPPY_ARCHIVE_EMPTY3) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(READ_GAPPY_ARCHIVE_AVAILABILITY) {
+	// Work on a copy to not write the index into the source tree
+	fs::path tmpArchive = fs::temp_directory_path() / fs::unique_path();
+	fs::path dir = tmpArchive / "2020/II/AAK/BHZ.D";
+	fs::create_directories(dir);
+	fs::copy_file("gappy-archive/2020/II/AAK/BHZ.D/II.AAK.10.BHZ.D.2020.122",
+	              dir / "II.AAK.10.BHZ.D.2020.122");
+
+	SDSAvailability availability(tmpArchive.string());
+	BOOST_CHECK_EQUAL(availability.update(), 1);
+	BOOST_CHECK_EQUAL(availability.update(), 0);
+	BOOST_REQUIRE(availability.save());
+
+	SDSAvailability loaded(tmpArchive.string());
+	BOOST_REQUIRE(loaded.load());
+	BOOST_REQUIRE_EQUAL(loaded.files().size(), 1);
+
+	const SDSAvailability::DayFile &file = loaded.files().begin()->second;
+	BOOST_CHECK_EQUAL(file.scanned, file.size);
+
+	// The gap is between 01:20:00 and 03:00:00
+	BOOST_CHECK(!file.overlaps(Time(2020,5,1,2,0,0,0), Time(2020,5,1,2,30,0,0)));
+	BOOST_CHECK(file.overlaps(Time(2020,5,1,2,0,0,0), Time(2020,5,1,3,20,0,0)));
+
+	DataModel::DataAvailabilityPtr extents = loaded.dataAvailability();
+	BOOST_REQUIRE_EQUAL(extents->dataExtentCount(), 1);
+	DataModel::DataExtent *extent = extents->dataExtent(0);
+	BOOST_CHECK_EQUAL(extent->waveformID().stationCode(), "AAK");
+	BOOST_CHECK(extent->dataSegmentCount() >= 2);
+
+	// Records are returned as without the index
+	for ( int pass = 0; pass < 2; ++pass ) {
+		SDSArchive sds;
+		BOOST_REQUIRE(sds.setSource(tmpArchive.string() + (pass ? "?availability" : "")));
+		sds.addStream("II", "AAK", "10", "BHZ",
+		              Time(2020,5,1,2,0,0,0), Time(2020,5,1,2,30,0,0));
+		RecordPtr rec = sds.next();
+		BOOST_CHECK(!rec);
+	}
+
+	size_t count[2] = {0, 0};
+	for ( int pass = 0; pass < 2; ++pass ) {
+		SDSArchive sds;
+		BOOST_REQUIRE(sds.setSource(tmpArchive.string() + (pass ? "?availability" : "")));
+		sds.addStream("II", "AAK", "10", "BHZ",
+		              Time(2020,5,1,2,0,0,0), Time(2020,5,1,3,20,0,0));
+		RecordPtr rec;
+		while ( (rec = sds.next()) )
+			++count[pass];
+	}
+
+	BOOST_CHECK(count[0] > 0);
+	BOOST_CHECK_EQUAL(count[0], count[1]);
+
+	fs::remove_all(tmpArchive);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_SUITE_END()
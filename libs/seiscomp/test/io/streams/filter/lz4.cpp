@@ -177,5 +177,59 @@ BOOST_AUTO_TEST_CASE(WRITEREAD2) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(WRITEREAD_DICTIONARY) {
+	ext::boost::iostreams::lz4_dictionary dict("NotifierMessageEventParametersPick", 1);
+	ext::boost::iostreams::lz4_dictionary other("ABCDEFGHIJKLMNOPQRSTUVWXYZ", 2);
+	string data = "NotifierMessage:EventParameters:Pick";
+	string plain, store;
+
+	{
+		stream_buffer<back_insert_device<string> > buf(plain);
+		filtering_ostreambuf filtered_buf;
+		filtered_buf.push(ext::boost::iostreams::lz4_compressor());
+		filtered_buf.push(buf);
+		filtered_buf.sputn(data.c_str(), data.size());
+	}
+
+	{
+		stream_buffer<back_insert_device<string> > buf(store);
+		filtering_ostreambuf filtered_buf;
+		filtered_buf.push(ext::boost::iostreams::lz4_compressor(128, &dict));
+		filtered_buf.push(buf);
+		filtered_buf.sputn(data.c_str(), data.size());
+	}
+
+	SEISCOMP_DEBUG("%d -> %d, with dictionary %d", int(data.size()),
+	               int(plain.size()), int(store.size()));
+	BOOST_CHECK(store.size() < plain.size());
+
+	char sink[1024];
+
+	{
+		stream_buffer<array_source> buf(store.c_str(), store.size());
+		filtering_istreambuf filtered_buf;
+		filtered_buf.push(ext::boost::iostreams::lz4_decompressor(128, &dict));
+		filtered_buf.push(buf);
+
+		BOOST_REQUIRE_EQUAL(filtered_buf.sgetn(sink, data.size()), data.size());
+		BOOST_CHECK_EQUAL(string(sink, data.size()), data);
+	}
+
+	{
+		// Frames compressed with another dictionary must be rejected
+		stream_buffer<array_source> buf(store.c_str(), store.size());
+		filtering_istreambuf filtered_buf;
+		filtered_buf.push(ext::boost::iostreams::lz4_decompressor(128, &other));
+		filtered_buf.push(buf);
+
+		BOOST_CHECK_EQUAL(filtered_buf.sgetn(sink, data.size()), 0);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_SUITE_END()
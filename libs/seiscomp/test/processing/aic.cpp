@@ -0,0 +1,124 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/math/aic.h>
+
+
+using namespace Seiscomp;
+
+
+namespace {
+
+
+std::vector<double> trace(int n, int onset, double noise, double signal,
+                          unsigned int seed) {
+	std::mt19937 gen(seed);
+	std::normal_distribution<double> dist;
+	std::vector<double> data(n);
+	for ( int i = 0; i < n; ++i )
+		data[i] = dist(gen) * (i < onset ? noise : signal);
+	return data;
+}
+
+
+// The direct computation of the AIC for comparison
+int bruteForceAIC(const std::vector<double> &data, int margin) {
+	int n = data.size(), kmin = -1;
+	double minaic = 0;
+	for ( int k = margin; k < n-margin; ++k ) {
+		double sum1 = 0, sum2 = 0;
+		for ( int i = 0; i < k; ++i ) sum1 += data[i]*data[i];
+		for ( int i = k; i < n; ++i ) sum2 += data[i]*data[i];
+		double aic = k*log10(sum1/(k-1)) + (n-k-1)*log10(sum2/(n-k-1));
+		if ( kmin < 0 || aic < minaic ) {
+			minaic = aic;
+			kmin = k;
+		}
+	}
+	return kmin;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_aic)
+
+
+BOOST_AUTO_TEST_CASE(onset) {
+	for ( unsigned int seed = 1; seed <= 5; ++seed ) {
+		std::vector<double> data = trace(1000, 400, 1.0, 10.0, seed);
+		int kmin = Math::maedaAIC(data.size(), data.data());
+		BOOST_CHECK_EQUAL(kmin, bruteForceAIC(data, 10));
+		BOOST_CHECK(std::abs(kmin - 400) <= 2);
+		BOOST_CHECK(Math::maedaAICSNR(data.size(), data.data(), kmin) > 10);
+	}
+
+	// The output trace holds the AIC with its minimum at the onset
+	std::vector<double> data = trace(500, 200, 1.0, 10.0, 7);
+	std::vector<double> aic(data.size());
+	int kmin = Math::maedaAIC(data.size(), data.data(), 10, aic.data());
+	for ( size_t i = 0; i < aic.size(); ++i )
+		BOOST_CHECK(aic[i] >= aic[kmin]);
+}
+
+
+BOOST_AUTO_TEST_CASE(dynamicRange) {
+	// A large signal followed by quiet samples must not produce negative
+	// trailing variances
+	std::vector<double> data = trace(1000, 300, 1E-3, 1E6, 3);
+	for ( int i = 700; i < 1000; ++i ) data[i] *= 1E-9;
+	BOOST_CHECK_EQUAL(Math::maedaAIC(data.size(), data.data()),
+	                  bruteForceAIC(data, 10));
+}
+
+
+BOOST_AUTO_TEST_CASE(channels) {
+	std::vector<double> z = trace(800, 300, 1.0, 8.0, 11);
+	std::vector<double> n = trace(800, 300, 1.0, 5.0, 12);
+	std::vector<double> e = trace(800, 300, 1.0, 5.0, 13);
+
+	std::vector<double> l2(z.size());
+	for ( size_t i = 0; i < l2.size(); ++i )
+		l2[i] = sqrt(z[i]*z[i] + n[i]*n[i] + e[i]*e[i]);
+
+	const double *channels[3] = { z.data(), n.data(), e.data() };
+	BOOST_CHECK_EQUAL(Math::maedaAIC(z.size(), 3, channels),
+	                  Math::maedaAIC(l2.size(), l2.data()));
+}
+
+
+BOOST_AUTO_TEST_CASE(tooShort) {
+	std::vector<double> data = trace(20, 10, 1.0, 10.0, 1);
+	BOOST_CHECK_EQUAL(Math::maedaAIC(data.size(), data.data()), -1);
+	BOOST_CHECK_EQUAL(Math::maedaAIC(0, data.data()), -1);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -29,6 +29,8 @@
 
 #include <seiscomp/core/strings.h>
 #include <seiscomp/processing/amplitudes/MLv.h>
+#include <seiscomp/processing/magnitudes/MLv.h>
+#include <seiscomp/processing/prototypes.h>
 
 
 using namespace Seiscomp;
@@ -127,4 +129,49 @@ BOOST_AUTO_TEST_CASE(signalTime) {
 }
 
 
+BOOST_AUTO_TEST_CASE(prototypes) {
+	AmplitudeProcessor_MLv proc;
+	proc.setTrigger(Time(2023, 9, 14, 0, 0, 0));
+	proc.setNoiseStart(-20);
+	proc.setSignalEnd(60);
+
+	AmplitudeProcessorPrototypes amplitudes;
+	BOOST_REQUIRE(amplitudes.add(&proc, "GE", "MORC", "", "BHZ"));
+	BOOST_CHECK_EQUAL(amplitudes.size(), 1);
+	BOOST_CHECK(!amplitudes.create("MLv", "GE", "MORC", "", "BHN"));
+	BOOST_CHECK(!amplitudes.create("mb", "GE", "MORC", "", "BHZ"));
+
+	AmplitudeProcessorPtr clone = amplitudes.create("MLv", "GE", "MORC", "", "BHZ");
+	BOOST_REQUIRE(clone);
+	BOOST_CHECK_EQUAL(clone->type(), "MLv");
+	BOOST_CHECK_EQUAL(double(clone->config().noiseBegin), -20);
+	BOOST_CHECK_EQUAL(double(clone->config().signalEnd), 60);
+
+	// The trigger is not part of the prototype
+	BOOST_CHECK(!clone->trigger());
+	BOOST_CHECK_NO_THROW(clone->setTrigger(Time(2023, 9, 14, 1, 0, 0)));
+	clone->computeTimeWindow();
+	BOOST_CHECK_EQUAL(clone->status(), WaveformProcessor::WaitingForData);
+
+	// Each clone is independent
+	AmplitudeProcessorPtr other = amplitudes.create("MLv", "GE", "MORC", "", "BHZ");
+	BOOST_REQUIRE(other);
+	BOOST_CHECK(other != clone);
+	BOOST_CHECK(!other->trigger());
+
+	MagnitudeProcessor_MLv mag;
+	MagnitudeProcessorPrototypes magnitudes;
+	BOOST_REQUIRE(magnitudes.add(&mag, "GE", "MORC", "", "BHZ"));
+	BOOST_REQUIRE(magnitudes.add(&mag, "GE", "APE", "", "BHZ"));
+	MagnitudeProcessorPtr magClone = magnitudes.create("MLv", "GE", "MORC", "", "BHZ");
+	BOOST_REQUIRE(magClone);
+	BOOST_CHECK_EQUAL(magClone->type(), "MLv");
+
+	magnitudes.remove("GE", "MORC");
+	BOOST_CHECK(!magnitudes.create("MLv", "GE", "MORC", "", "BHZ"));
+	BOOST_CHECK(magnitudes.create("MLv", "GE", "APE", "", "BHZ"));
+	BOOST_CHECK_EQUAL(magnitudes.size(), 1);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
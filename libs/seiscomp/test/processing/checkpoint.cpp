@@ -0,0 +1,219 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/io/archive/binarchive.h>
+#include <seiscomp/math/filter.h>
+#include <seiscomp/processing/detector.h>
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::Processing;
+
+
+namespace {
+
+
+typedef Math::Filtering::InPlaceFilter<double> Filter;
+
+
+const double SamplingFrequency = 20.0;
+const int RecordLength = 100;
+
+
+// Noise with impulsive events every 100 seconds starting at 250 seconds
+std::vector<double> synthetic(size_t n) {
+	std::mt19937 gen(11);
+	std::normal_distribution<double> dist;
+	std::vector<double> data(n);
+	for ( auto &v : data ) v = dist(gen) + 100;
+
+	for ( size_t onset = 250 * SamplingFrequency; onset + 200 < n;
+	      onset += 100 * SamplingFrequency ) {
+		for ( size_t j = 0; j < 200; ++j )
+			data[onset+j] += 20 * exp(-(double)j / 40.0) * sin(j * 0.4);
+	}
+
+	return data;
+}
+
+
+std::string save(Core::BaseObject &obj) {
+	std::string state;
+	IO::BinaryArchive ar;
+	ar.create(state);
+	obj.serialize(ar);
+	ar.close();
+	return state;
+}
+
+
+bool restore(Core::BaseObject &obj, const std::string &state) {
+	IO::BinaryArchive ar;
+	if ( !ar.open(state.data(), state.size()) ) return false;
+	obj.serialize(ar);
+	return ar.success();
+}
+
+
+SimpleDetectorPtr createDetector(std::vector<Core::Time> &picks) {
+	SimpleDetectorPtr detector = new SimpleDetector(3, 1.5, 60);
+	detector->setFilter(Filter::Create("RMHP(10)>>ITAPER(30)>>BW(4,0.7,2)>>STALTA(2,80)"));
+	detector->setPublishFunction([&picks](const Detector*, const Record*, const Core::Time &t) {
+		picks.push_back(t);
+	});
+	return detector;
+}
+
+
+void feed(WaveformProcessor *proc, const std::vector<double> &data,
+          size_t from, size_t to, const Core::Time &startTime) {
+	for ( size_t i = from; i < to; i += RecordLength ) {
+		size_t n = std::min(to - i, size_t(RecordLength));
+		GenericRecordPtr rec = new GenericRecord("XX", "TEST", "", "HHZ",
+		                                         startTime + Core::TimeSpan(i / SamplingFrequency),
+		                                         SamplingFrequency);
+		rec->setData(new DoubleArray(n, data.data() + i));
+		proc->feed(rec.get());
+	}
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_checkpoint)
+
+
+BOOST_AUTO_TEST_CASE(filters) {
+	std::vector<double> data = synthetic(4000);
+
+	for ( const char *name : { "RMHP(10)>>ITAPER(30)>>BW(4,0.7,2)>>STALTA(2,80)",
+	                           "BW_HP(3,1)>>INT(0)>>DIFF",
+	                           "STALTA2(1,20,3,1)" } ) {
+		BOOST_TEST_MESSAGE(name);
+		std::unique_ptr<Filter> filter(Filter::Create(name));
+		BOOST_REQUIRE(filter);
+		BOOST_CHECK(filter->hasSerializableState());
+		filter->setSamplingFrequency(SamplingFrequency);
+
+		std::vector<double> expected(data);
+		filter->apply(1500, expected.data());
+		std::string state = save(*filter);
+		filter->apply(expected.size() - 1500, expected.data() + 1500);
+
+		std::unique_ptr<Filter> restored(Filter::Create(name));
+		restored->setSamplingFrequency(SamplingFrequency);
+		BOOST_REQUIRE(restore(*restored, state));
+
+		std::vector<double> continued(data.begin() + 1500, data.end());
+		restored->apply(continued.size(), continued.data());
+
+		for ( size_t i = 0; i < continued.size(); ++i )
+			BOOST_REQUIRE_EQUAL(continued[i], expected[1500+i]);
+	}
+
+	// A filter without a serializable state
+	std::unique_ptr<Filter> filter(Filter::Create("BW(4,0.7,2)>>AVG(1)"));
+	BOOST_REQUIRE(filter);
+	BOOST_CHECK(!filter->hasSerializableState());
+
+	// A different design cannot take the state
+	std::unique_ptr<Filter> bw3(Filter::Create("BW(3,0.7,2)"));
+	std::unique_ptr<Filter> bw4(Filter::Create("BW(4,0.7,2)"));
+	bw3->setSamplingFrequency(SamplingFrequency);
+	bw4->setSamplingFrequency(SamplingFrequency);
+	BOOST_CHECK(!restore(*bw4, save(*bw3)));
+}
+
+
+BOOST_AUTO_TEST_CASE(detector) {
+	std::vector<double> data = synthetic(20000);
+	Core::Time startTime(2024, 1, 1, 0, 0, 0);
+	size_t split = 11000;
+
+	std::vector<Core::Time> expected, first, second;
+
+	SimpleDetectorPtr uninterrupted = createDetector(expected);
+	feed(uninterrupted.get(), data, 0, data.size(), startTime);
+	BOOST_REQUIRE(expected.size() > 5);
+
+	SimpleDetectorPtr before = createDetector(first);
+	BOOST_CHECK(before->hasSerializableState());
+	feed(before.get(), data, 0, split, startTime);
+	std::string state = save(*before);
+
+	SimpleDetectorPtr after = createDetector(second);
+	BOOST_REQUIRE(restore(*after, state));
+	BOOST_CHECK(after->dataTimeWindow() == before->dataTimeWindow());
+	BOOST_REQUIRE(after->lastRecord());
+	BOOST_CHECK_EQUAL(after->lastRecord()->streamID(), "XX.TEST..HHZ");
+
+	// Records which have already been processed are skipped
+	feed(after.get(), data, split - RecordLength, split, startTime);
+	BOOST_CHECK(after->dataTimeWindow() == before->dataTimeWindow());
+
+	feed(after.get(), data, split, data.size(), startTime);
+
+	first.insert(first.end(), second.begin(), second.end());
+	BOOST_REQUIRE_EQUAL(first.size(), expected.size());
+	for ( size_t i = 0; i < first.size(); ++i )
+		BOOST_CHECK(first[i] == expected[i]);
+
+	// A state without data
+	std::vector<Core::Time> picks;
+	SimpleDetectorPtr empty = createDetector(picks);
+	SimpleDetectorPtr restored = createDetector(picks);
+	BOOST_REQUIRE(restore(*restored, save(*empty)));
+	BOOST_CHECK(!restored->lastRecord());
+}
+
+
+BOOST_AUTO_TEST_CASE(discontinuity) {
+	std::vector<double> data = synthetic(20000);
+	Core::Time startTime(2024, 1, 1, 0, 0, 0);
+	size_t split = 11000;
+
+	std::vector<Core::Time> picks;
+	SimpleDetectorPtr before = createDetector(picks);
+	feed(before.get(), data, 0, split, startTime);
+
+	SimpleDetectorPtr after = createDetector(picks);
+	BOOST_REQUIRE(restore(*after, save(*before)));
+
+	// The data continue after a gap: the processor starts again
+	size_t resume = split + 10 * RecordLength;
+	feed(after.get(), data, resume, resume + RecordLength, startTime);
+	BOOST_CHECK(after->dataTimeWindow().startTime() ==
+	            startTime + Core::TimeSpan(resume / SamplingFrequency));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
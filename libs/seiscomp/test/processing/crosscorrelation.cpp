@@ -0,0 +1,150 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/processing/crosscorrelation.h>
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::Processing;
+
+
+namespace {
+
+
+const double SamplingFrequency = 100.0;
+
+
+// A window of 2 s with its reference after 1 s and a wavelet at the
+// reference plus the given delay
+CrossCorrelator::Window window(const std::string &eventID,
+                               const std::string &streamID,
+                               double delay, std::mt19937 &gen) {
+	std::normal_distribution<double> dist;
+
+	CrossCorrelator::Window w;
+	w.eventID = eventID;
+	w.streamID = streamID;
+	w.phase = "P";
+	w.startTime = Core::Time(2020, 1, 1, 0, 0, 0) + Core::TimeSpan(gen() % 3600);
+	w.reference = w.startTime + Core::TimeSpan(1.0);
+	w.samplingFrequency = SamplingFrequency;
+	w.data.resize(200);
+
+	for ( int i = 0; i < w.data.size(); ++i ) {
+		double t = i / SamplingFrequency - 1.0 - delay;
+		w.data[i] = 10 + exp(-(t/0.1)*(t/0.1)) * sin(2 * M_PI * 5 * t) + dist(gen) * 0.01;
+	}
+
+	return w;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_crosscorrelation)
+
+
+BOOST_AUTO_TEST_CASE(delays) {
+	std::mt19937 gen(11);
+	std::vector<double> delays = { 0.0, 0.0337, -0.0512, 0.1234 };
+
+	CrossCorrelator correlator;
+	correlator.setMaximumDelay(0.2);
+	for ( size_t i = 0; i < delays.size(); ++i )
+		BOOST_CHECK_EQUAL(correlator.add(window("E" + std::to_string(i), "XX.A..HHZ", delays[i], gen)), int(i));
+
+	// Windows of the same event and of a single event of a stream are
+	// not correlated
+	correlator.add(window("E0", "XX.A..HHZ", 0.05, gen));
+	correlator.add(window("E0", "XX.B..HHZ", 0.0, gen));
+	BOOST_CHECK_EQUAL(correlator.add(CrossCorrelator::Window()), -1);
+
+	correlator.compute();
+
+	const std::vector<CrossCorrelator::Result> &results = correlator.results();
+	BOOST_REQUIRE_EQUAL(results.size(), 9);
+
+	for ( const CrossCorrelator::Result &r : results ) {
+		const CrossCorrelator::Window &w1 = correlator.window(r.first);
+		const CrossCorrelator::Window &w2 = correlator.window(r.second);
+		BOOST_CHECK(r.first < r.second);
+		BOOST_CHECK(w1.eventID != w2.eventID);
+		BOOST_CHECK(r.coefficient > 0.99);
+
+		double d1 = r.first < delays.size() ? delays[r.first] : 0.05;
+		double d2 = r.second < delays.size() ? delays[r.second] : 0.05;
+		BOOST_CHECK_SMALL(r.delay - (d2 - d1), 0.001);
+	}
+
+	// The delay of E3 relative to E2 exceeds the maximum
+	correlator.setMaximumDelay(0.15);
+	correlator.compute();
+	BOOST_CHECK_EQUAL(correlator.results().size(), 8);
+}
+
+
+BOOST_AUTO_TEST_CASE(threads) {
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<double> dist(-0.3, 0.3);
+
+	CrossCorrelator correlator;
+	for ( int i = 0; i < 40; ++i ) {
+		correlator.add(window("E" + std::to_string(i), "XX.A..HHZ", dist(gen), gen));
+		correlator.add(window("E" + std::to_string(i), "XX.B..HHZ", dist(gen), gen));
+	}
+
+	correlator.setThreads(1);
+	correlator.compute();
+	std::vector<CrossCorrelator::Result> single = correlator.results();
+	BOOST_CHECK(!single.empty());
+
+	correlator.setThreads(4);
+	correlator.compute();
+	const std::vector<CrossCorrelator::Result> &multi = correlator.results();
+	BOOST_REQUIRE_EQUAL(multi.size(), single.size());
+	for ( size_t i = 0; i < single.size(); ++i ) {
+		BOOST_CHECK_EQUAL(multi[i].first, single[i].first);
+		BOOST_CHECK_EQUAL(multi[i].second, single[i].second);
+		BOOST_CHECK_EQUAL(multi[i].delay, single[i].delay);
+	}
+
+	// Only pairs accepted by the filter are correlated
+	correlator.setPairFilter([](const CrossCorrelator::Window &w1,
+	                            const CrossCorrelator::Window &w2) {
+		return w1.streamID == "XX.B..HHZ";
+	});
+	correlator.compute();
+	BOOST_CHECK(!correlator.results().empty());
+	for ( const CrossCorrelator::Result &r : correlator.results() )
+		BOOST_CHECK_EQUAL(correlator.window(r.second).streamID, "XX.B..HHZ");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/processing/gapinterpolator.h>
+
+
+using namespace Seiscomp::Processing;
+
+
+namespace {
+
+
+std::vector<double> interpolate(GapInterpolator &gi, size_t n,
+                                double last, double next,
+                                size_t *blocks = nullptr) {
+	std::vector<double> result;
+	gi.interpolate(n, last, next, [&](size_t count, double *samples) {
+		BOOST_CHECK(count <= GapInterpolator::BlockSize);
+		result.insert(result.end(), samples, samples + count);
+		if ( blocks ) ++*blocks;
+	});
+	return result;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_gapinterpolator)
+
+
+BOOST_AUTO_TEST_CASE(linear) {
+	GapInterpolator gi;
+	size_t blocks = 0;
+
+	auto samples = interpolate(gi, 3, 0, 4);
+	BOOST_REQUIRE_EQUAL(samples.size(), 3);
+	BOOST_CHECK_CLOSE(samples[0], 1, 1e-9);
+	BOOST_CHECK_CLOSE(samples[1], 2, 1e-9);
+	BOOST_CHECK_CLOSE(samples[2], 3, 1e-9);
+
+	size_t n = GapInterpolator::BlockSize * 2 + 7;
+	samples = interpolate(gi, n, -1, 1, &blocks);
+	BOOST_REQUIRE_EQUAL(samples.size(), n);
+	BOOST_CHECK_EQUAL(blocks, 3);
+	for ( size_t i = 0; i < n; ++i )
+		BOOST_CHECK_CLOSE(samples[i] + 2, -1 + 2.0 * (i + 1) / (n + 1) + 2, 1e-9);
+
+	BOOST_CHECK(interpolate(gi, 0, 0, 1).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(hold) {
+	GapInterpolator gi(GapInterpolator::Hold);
+
+	auto samples = interpolate(gi, 600, 3.5, -2);
+	BOOST_REQUIRE_EQUAL(samples.size(), 600);
+	for ( auto v : samples )
+		BOOST_CHECK_EQUAL(v, 3.5);
+}
+
+
+BOOST_AUTO_TEST_CASE(mirror) {
+	GapInterpolator gi(GapInterpolator::Mirror);
+
+	// Without history it behaves like Linear
+	auto samples = interpolate(gi, 3, 0, 4);
+	BOOST_REQUIRE_EQUAL(samples.size(), 3);
+	BOOST_CHECK_CLOSE(samples[1], 2, 1e-9);
+
+	gi.setHistoryLength(4);
+	BOOST_CHECK(gi.needsHistory());
+
+	// Only the last four samples are kept: 2, 3, 4, 5
+	std::vector<double> history = { 9, 9, 9, 2, 3, 4 };
+	gi.feed(history.size(), history.data());
+	double last = 5;
+	gi.feed(1, &last);
+
+	// The mirrored sequence continues with 4, 3, 2, 3, 4, 5, 4, ...
+	// The sample after the gap equals the mirrored value, no trend
+	samples = interpolate(gi, 6, last, 4);
+	std::vector<double> expected = { 4, 3, 2, 3, 4, 5 };
+	BOOST_REQUIRE_EQUAL(samples.size(), expected.size());
+	for ( size_t i = 0; i < expected.size(); ++i )
+		BOOST_CHECK_CLOSE(samples[i], expected[i], 1e-9);
+
+	// The history is cleared after a gap
+	samples = interpolate(gi, 1, 0, 2);
+	BOOST_CHECK_CLOSE(samples[0], 1, 1e-9);
+
+	// A trend joins the mirrored samples to the next sample
+	gi.feed(history.size(), history.data());
+	gi.feed(1, &last);
+	samples = interpolate(gi, 6, last, 11);
+	for ( size_t i = 0; i < expected.size(); ++i )
+		BOOST_CHECK_CLOSE(samples[i], expected[i] + 7.0 * (i + 1) / 7, 1e-9);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/processing/magnitudes/utils.h>
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::Processing;
+
+
+namespace {
+
+
+// The linear search TableXY::at used before the lookup grid was added
+bool reference(const LogA0 &table, double x, double &y) {
+	const auto &items = table.items;
+	if ( items.size() >= 2 ) {
+		for ( size_t i = 1; i < items.size(); ++i ) {
+			if ( items[i - 1].first <= x && x <= items[i].first ) {
+				double q = (x - items[i - 1].first) / (items[i].first - items[i - 1].first);
+				y = q * (items[i].second - items[i - 1].second) + items[i - 1].second;
+				return true;
+			}
+		}
+	}
+	else if ( items.size() == 1 ) {
+		if ( items[0].first == x ) {
+			y = items[0].second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void compare(const LogA0 &table, double x) {
+	double expected;
+	if ( reference(table, x, expected) ) {
+		// Duplicate x values at the table start interpolate to NaN
+		if ( std::isnan(expected) ) {
+			BOOST_CHECK(std::isnan(table.at(x)));
+		}
+		else {
+			BOOST_CHECK_EQUAL(table.at(x), expected);
+		}
+	}
+	else {
+		BOOST_CHECK_THROW(table.at(x), std::out_of_range);
+	}
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_magnitudes)
+
+
+BOOST_AUTO_TEST_CASE(tableLookup) {
+	const char *definitions[] = {
+		"0:-1.3,60:-2.8,100:-3.0,400:-4.5,1000:-5.85",
+		"0 -1.3;60 -2.8;100 -3.0;400 -4.5;1000 -5.85",
+		"-10:1,-10:2,0:3,0:4,0.001:5,5:6,5:7,5:8,1e4:9",
+		"3:1.5",
+		"2:1,2:3"
+	};
+
+	for ( auto def : definitions ) {
+		LogA0 table;
+		BOOST_REQUIRE(table.set(def));
+
+		for ( const auto &item : table.items ) {
+			compare(table, item.first);
+			compare(table, std::nextafter(item.first, -1e10));
+			compare(table, std::nextafter(item.first, 1e10));
+		}
+
+		for ( int i = -1000; i <= 11000; ++i ) {
+			compare(table, i * 1.01);
+		}
+
+		compare(table, std::nan(""));
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(tableBatchLookup) {
+	LogA0 table;
+	BOOST_REQUIRE(table.set("0:-1.3,60:-2.8,100:-3.0,400:-4.5,1000:-5.85"));
+
+	std::vector<double> x = { -1, 0, 30, 99.5, 1000, 1000.5 };
+	std::vector<double> y(x.size());
+
+	BOOST_CHECK_EQUAL(table.at(x.data(), y.data(), x.size()), 4);
+	BOOST_CHECK(std::isnan(y[0]));
+	BOOST_CHECK(std::isnan(y[5]));
+	for ( size_t i = 1; i < 5; ++i ) {
+		BOOST_CHECK_EQUAL(y[i], table.at(x[i]));
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(tableStaleIndex) {
+	LogA0 table;
+	BOOST_REQUIRE(table.set("0:0,10:1,20:2,30:3,40:4,50:5"));
+
+	// Items changed without update() must still be evaluated correctly
+	table.items.resize(3);
+	BOOST_CHECK_CLOSE(table.at(15), 1.5, 1e-9);
+	BOOST_CHECK_THROW(table.at(25), std::out_of_range);
+
+	table.update();
+	BOOST_CHECK_CLOSE(table.at(15), 1.5, 1e-9);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/record.h>
+#include <seiscomp/processing/operator/l2norm.h>
+#include <seiscomp/processing/operator/transformation.h>
+
+
+using namespace Seiscomp;
+
+
+namespace {
+
+
+std::vector<double> trace(int n, unsigned int seed) {
+	std::mt19937 gen(seed);
+	std::normal_distribution<double> dist;
+	std::vector<double> data(n);
+	for ( int i = 0; i < n; ++i )
+		data[i] = dist(gen);
+	return data;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_operators)
+
+
+BOOST_AUTO_TEST_CASE(transformation) {
+	Math::Matrix3<double> m;
+	m.setRow(0, Math::Vector3<double>(0.2, -0.7, 0.1));
+	m.setRow(1, Math::Vector3<double>(0.9, 0.3, -0.4));
+	m.setRow(2, Math::Vector3<double>(-0.5, 0.6, 0.8));
+
+	std::vector<double> z = trace(1001, 1), n = trace(1001, 2), e = trace(1001, 3);
+	std::vector<double> x = z, y = n, w = e;
+	double *data[3] = { x.data(), y.data(), w.data() };
+
+	Processing::Operator::Transformation<double,3> op(m);
+	op(nullptr, data, x.size(), Core::Time(), 1.0);
+
+	// The operator must not advance the component pointers
+	BOOST_CHECK(data[0] == x.data());
+
+	for ( size_t i = 0; i < x.size(); ++i ) {
+		Math::Vector3<double> v = m*Math::Vector3<double>(z[i], n[i], e[i]);
+		BOOST_CHECK_CLOSE(x[i], v.x, 1E-10);
+		BOOST_CHECK_CLOSE(y[i], v.y, 1E-10);
+		BOOST_CHECK_CLOSE(w[i], v.z, 1E-10);
+	}
+
+	x = n; y = e;
+	double *data2[2] = { x.data(), y.data() };
+	Processing::Operator::Transformation<double,2> op2(m);
+	op2(nullptr, data2, x.size(), Core::Time(), 1.0);
+
+	for ( size_t i = 0; i < x.size(); ++i ) {
+		Math::Vector3<double> v = m*Math::Vector3<double>(n[i], e[i], 0);
+		BOOST_CHECK_CLOSE(x[i], v.x, 1E-10);
+		BOOST_CHECK_CLOSE(y[i], v.y, 1E-10);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(l2norm) {
+	std::vector<double> z = trace(513, 4), n = trace(513, 5), e = trace(513, 6);
+
+	std::vector<double> x = n;
+	double *data2[2] = { x.data(), e.data() };
+	Processing::Operator::L2Norm<double,2>()(nullptr, data2, x.size(), Core::Time(), 1.0);
+	for ( size_t i = 0; i < x.size(); ++i )
+		BOOST_CHECK_CLOSE(x[i], sqrt(n[i]*n[i] + e[i]*e[i]), 1E-10);
+
+	x = z;
+	double *data3[3] = { x.data(), n.data(), e.data() };
+	Processing::Operator::L2Norm<double,3>()(nullptr, data3, x.size(), Core::Time(), 1.0);
+	for ( size_t i = 0; i < x.size(); ++i )
+		BOOST_CHECK_CLOSE(x[i], sqrt(z[i]*z[i] + n[i]*n[i] + e[i]*e[i]), 1E-10);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
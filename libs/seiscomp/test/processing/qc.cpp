@@ -0,0 +1,177 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/qc/qcprocessor_combined.h>
+#include <seiscomp/qc/qcprocessor_gap.h>
+#include <seiscomp/qc/qcprocessor_mean.h>
+#include <seiscomp/qc/qcprocessor_overlap.h>
+#include <seiscomp/qc/qcprocessor_ppsd.h>
+#include <seiscomp/qc/qcprocessor_rms.h>
+#include <seiscomp/qc/qcprocessor_spike.h>
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::Processing;
+
+
+namespace {
+
+
+RecordPtr createRecord(const Time &start, size_t n, double offset, int spikeAt = -1) {
+	GenericRecordPtr rec = new GenericRecord("XX", "TEST", "", "HHZ", start, 20.0);
+	DoubleArrayPtr data = new DoubleArray(n);
+	for ( size_t i = 0; i < n; ++i )
+		(*data)[i] = offset + 100.0 * sin(i * 0.3);
+	if ( spikeAt >= 0 )
+		(*data)[spikeAt] = 1e6;
+	rec->setData(data.get());
+	return rec;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_qc)
+
+
+BOOST_AUTO_TEST_CASE(combined) {
+	std::vector<RecordPtr> records;
+	Time t(2024, 3, 1, 12, 0, 0);
+
+	records.push_back(createRecord(t, 200, 10.0));
+	records.push_back(createRecord(records.back()->endTime(), 200, -5.0, 77));
+	// Gap of 30 seconds
+	records.push_back(createRecord(records.back()->endTime() + TimeSpan(30, 0), 200, 3.0));
+	// Overlap of 2 seconds
+	records.push_back(createRecord(records.back()->endTime() - TimeSpan(2, 0), 200, 2.0));
+	records.push_back(createRecord(records.back()->endTime(), 203, 1.0));
+
+	QcProcessorCombinedPtr combined = new QcProcessorCombined;
+	QcProcessorMeanPtr mean = new QcProcessorMean;
+	QcProcessorRmsPtr rms = new QcProcessorRms;
+	QcProcessorGapPtr gap = new QcProcessorGap;
+	QcProcessorOverlapPtr overlap = new QcProcessorOverlap;
+	QcProcessorSpikePtr spike = new QcProcessorSpike;
+
+	size_t spikes = 0;
+
+	for ( const auto &rec : records ) {
+		combined->feed(rec.get());
+		mean->feed(rec.get());
+		rms->feed(rec.get());
+		gap->feed(rec.get());
+		overlap->feed(rec.get());
+		spike->feed(rec.get());
+
+		BOOST_CHECK_CLOSE(combined->getMean(), mean->getMean(), 1e-9);
+		BOOST_CHECK_CLOSE(combined->getRms(), rms->getRms(), 1e-9);
+
+		BOOST_CHECK_EQUAL(combined->getState(QcProcessorCombined::Gap) != nullptr, gap->isValid());
+		if ( gap->isValid() )
+			BOOST_CHECK_CLOSE(combined->getGap(), gap->getGap(), 1e-9);
+
+		BOOST_CHECK_EQUAL(combined->getState(QcProcessorCombined::Overlap) != nullptr, overlap->isValid());
+		if ( overlap->isValid() )
+			BOOST_CHECK_CLOSE(combined->getOverlap(), overlap->getOverlap(), 1e-9);
+
+		BOOST_CHECK_EQUAL(combined->getState(QcProcessorCombined::Spike) != nullptr, spike->isValid());
+		if ( spike->isValid() ) {
+			BOOST_CHECK(combined->getSpikes() == spike->getSpikes());
+			++spikes;
+		}
+	}
+
+	BOOST_CHECK_EQUAL(spikes, 1);
+
+	combined->setEnabled(QcProcessorCombined::Mean, false);
+	combined->feed(createRecord(records.back()->endTime(), 200, 1.0).get());
+	BOOST_CHECK(combined->getState(QcProcessorCombined::Mean) == nullptr);
+	BOOST_CHECK_THROW(combined->getMean(), Core::ValueException);
+	BOOST_CHECK(combined->getState(QcProcessorCombined::Rms) != nullptr);
+}
+
+
+BOOST_AUTO_TEST_CASE(ppsd) {
+	QcProcessorPpsdPtr ppsd = new QcProcessorPpsd;
+	BOOST_REQUIRE(ppsd->setWindow(200, 51.2));
+	ppsd->setResponse(nullptr, 2.0, "");
+
+	Time t(2024, 3, 1, 12, 0, 0);
+	size_t psds = 0;
+
+	// 1000 seconds of a 1 Hz sine
+	for ( size_t offset = 0; offset < 20000; offset += 400 ) {
+		GenericRecordPtr rec = new GenericRecord("XX", "TEST", "", "HHZ", t + TimeSpan(offset / 20.0), 20.0);
+		DoubleArrayPtr data = new DoubleArray(400);
+		for ( size_t i = 0; i < 400; ++i )
+			(*data)[i] = 1000.0 * sin(2 * M_PI * (offset + i) / 20.0);
+		rec->setData(data.get());
+
+		ppsd->feed(rec.get());
+		if ( ppsd->isValid() ) {
+			auto psd = ppsd->getPsd();
+			BOOST_CHECK_EQUAL(psd.power.size(), ppsd->histogram().periods().size());
+			++psds;
+		}
+	}
+
+	const PpsdHistogram &histogram = ppsd->histogram();
+	BOOST_CHECK(psds > 0);
+	BOOST_CHECK_EQUAL(histogram.psdCount(), psds);
+	BOOST_REQUIRE(!histogram.periods().empty());
+	BOOST_CHECK_CLOSE(histogram.periods().front(), 0.1, 1e-6);
+
+	// The median peaks around 1 second
+	auto median = histogram.percentile(50);
+	size_t peak = 0;
+	for ( size_t i = 1; i < median.size(); ++i ) {
+		if ( median[i] > median[peak] ) peak = i;
+	}
+	BOOST_CHECK(histogram.periods()[peak] > 0.7);
+	BOOST_CHECK(histogram.periods()[peak] < 1.42);
+
+	// Export and import
+	std::stringstream ss;
+	BOOST_REQUIRE(histogram.write(ss));
+	PpsdHistogram copy;
+	BOOST_REQUIRE(copy.read(ss));
+	BOOST_CHECK_EQUAL(copy.psdCount(), histogram.psdCount());
+	BOOST_REQUIRE(copy.merge(histogram));
+	BOOST_CHECK_EQUAL(copy.psdCount(), histogram.psdCount() * 2);
+	for ( size_t i = 0; i < histogram.periods().size(); ++i ) {
+		for ( size_t j = 0; j < histogram.powerCount(); ++j )
+			BOOST_CHECK_EQUAL(copy.count(i, j), histogram.count(i, j) * 2);
+	}
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
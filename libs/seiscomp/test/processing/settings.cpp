@@ -0,0 +1,83 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <string>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/processing/processor.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_settings)
+
+
+BOOST_AUTO_TEST_CASE(compiled) {
+	Util::KeyValues keys;
+	keys.setString("filter", "BW(3,1,10)");
+	keys.setInt("order", 4);
+	keys.setDouble("period", 0.5);
+	keys.setBool("enable", true);
+
+	Processing::StationSettingsPtr compiled =
+		new Processing::StationSettings("scamp", "GE", "MORC", nullptr, &keys);
+	BOOST_CHECK_EQUAL(compiled->size(), 4);
+
+	string module("scamp"), net("GE"), sta("MORC"), loc(""), cha("BH");
+	Processing::Settings plain(module, net, sta, loc, cha, nullptr, &keys);
+	Processing::Settings fast(module, net, sta, loc, cha, nullptr, &keys, compiled.get());
+
+	// Both settings must yield the same values for all types
+	for ( const char *name : { "filter", "order", "period", "enable", "unset" } ) {
+		string s1, s2;
+		int i1 = -1, i2 = -1;
+		double d1 = -1, d2 = -1;
+		bool b1 = false, b2 = false;
+
+		BOOST_CHECK_EQUAL(plain.getValue(s1, name), fast.getValue(s2, name));
+		BOOST_CHECK_EQUAL(s1, s2);
+		BOOST_CHECK_EQUAL(plain.getValue(i1, name), fast.getValue(i2, name));
+		BOOST_CHECK_EQUAL(i1, i2);
+		BOOST_CHECK_EQUAL(plain.getValue(d1, name), fast.getValue(d2, name));
+		BOOST_CHECK_EQUAL(d1, d2);
+		BOOST_CHECK_EQUAL(plain.getValue(b1, name), fast.getValue(b2, name));
+		BOOST_CHECK_EQUAL(b1, b2);
+	}
+
+	BOOST_CHECK_EQUAL(fast.getString("filter"), "BW(3,1,10)");
+	BOOST_CHECK_EQUAL(fast.getInt("order"), 4);
+	BOOST_CHECK_EQUAL(fast.getDouble("period"), 0.5);
+	BOOST_CHECK(fast.getBool("enable"));
+
+	int value;
+	BOOST_CHECK(!fast.getValue(value, "filter"));
+	BOOST_CHECK_THROW(fast.getInt("unset"), Config::Exception);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/client/inventory.h>
+#include <seiscomp/processing/stream.h>
+
+
+using namespace Seiscomp;
+
+
+namespace {
+
+
+DataModel::InventoryPtr createInventory(const std::string &prefix) {
+	DataModel::InventoryPtr inv = new DataModel::Inventory;
+
+	DataModel::ResponsePAZPtr paz = DataModel::ResponsePAZ::Create(prefix + "PAZ");
+	paz->setType("A");
+	paz->setNormalizationFactor(1.0);
+	paz->setNormalizationFrequency(1.0);
+	paz->setGainFrequency(1.0);
+	inv->add(paz.get());
+
+	DataModel::SensorPtr sensor = DataModel::Sensor::Create(prefix + "Sensor");
+	sensor->setUnit("M/S");
+	sensor->setResponse(paz->publicID());
+	inv->add(sensor.get());
+
+	DataModel::NetworkPtr net = DataModel::Network::Create();
+	net->setCode("XX");
+	net->setStart(Core::Time(2000,1,1));
+	inv->add(net.get());
+
+	DataModel::StationPtr sta = DataModel::Station::Create();
+	sta->setCode("TEST");
+	sta->setStart(Core::Time(2000,1,1));
+	net->add(sta.get());
+
+	DataModel::SensorLocationPtr loc = DataModel::SensorLocation::Create();
+	loc->setCode("");
+	loc->setStart(Core::Time(2000,1,1));
+	sta->add(loc.get());
+
+	DataModel::StreamPtr cha = DataModel::Stream::Create();
+	cha->setCode("HHZ");
+	cha->setStart(Core::Time(2000,1,1));
+	cha->setGain(1000.0);
+	cha->setGainFrequency(1.0);
+	cha->setGainUnit("m/s");
+	cha->setSensor(sensor->publicID());
+	loc->add(cha.get());
+
+	return inv;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_streamcache)
+
+
+BOOST_AUTO_TEST_CASE(cache) {
+	DataModel::InventoryPtr inv = createInventory("A/");
+	Client::Inventory::Instance()->setInventory(inv.get());
+
+	Core::Time time(2024,1,1);
+	DataModel::Stream *cha = Client::Inventory::Instance()->getStream("XX", "TEST", "", "HHZ", time);
+	BOOST_REQUIRE(cha);
+
+	Processing::Stream first, second;
+	first.init("XX", "TEST", "", "HHZ", time);
+	second.init("XX", "TEST", "", "HHZ", time);
+
+	BOOST_CHECK_EQUAL(first.gain, 1000.0);
+	BOOST_CHECK_EQUAL(first.gainUnit, "M/S");
+	BOOST_CHECK_EQUAL(first.code(), "HHZ");
+	BOOST_REQUIRE(first.sensor());
+	BOOST_CHECK(first.sensor()->response());
+	// The second stream shares the resolved sensor
+	BOOST_CHECK_EQUAL(first.sensor(), second.sensor());
+	BOOST_CHECK_EQUAL(second.gain, 1000.0);
+
+	// Updates invalidate the cache
+	cha->setGain(2000.0);
+	cha->update();
+
+	Processing::Stream third;
+	third.init(cha);
+	BOOST_CHECK_EQUAL(third.gain, 2000.0);
+	BOOST_REQUIRE(third.sensor());
+	BOOST_CHECK(third.sensor() != first.sensor());
+
+	Processing::Stream fourth;
+	fourth.init(cha);
+	BOOST_CHECK_EQUAL(fourth.sensor(), third.sensor());
+
+	Processing::Stream::ClearCache();
+	Processing::Stream fifth;
+	fifth.init(cha);
+	BOOST_CHECK(fifth.sensor() != third.sensor());
+
+	// Streams of other inventories are not cached
+	DataModel::InventoryPtr other = createInventory("B/");
+	DataModel::Stream *otherCha = other->network(0)->station(0)->sensorLocation(0)->stream(0);
+	Processing::Stream sixth, seventh;
+	sixth.init(otherCha);
+	seventh.init(otherCha);
+	BOOST_REQUIRE(sixth.sensor());
+	BOOST_CHECK(sixth.sensor() != seventh.sensor());
+
+	// Replacing the inventory drops the cache
+	Client::Inventory::Instance()->setInventory(other.get());
+	inv = nullptr;
+	Processing::Stream eighth, ninth;
+	eighth.init(otherCha);
+	ninth.init(otherCha);
+	BOOST_CHECK_EQUAL(eighth.sensor(), ninth.sensor());
+	BOOST_CHECK(eighth.sensor() != sixth.sensor());
+
+	Client::Inventory::Instance()->setInventory(nullptr);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(responseCache) {
+	DataModel::InventoryPtr inv = createInventory("C/");
+	Client::Inventory::Instance()->setInventory(inv.get());
+
+	Core::Time time(2024,1,1);
+	DataModel::Stream *cha = Client::Inventory::Instance()->getStream("XX", "TEST", "", "HHZ", time);
+	BOOST_REQUIRE(cha);
+
+	auto deconvolve = [cha]() {
+		Processing::Stream stream;
+		stream.init(cha);
+		BOOST_REQUIRE(stream.sensor() && stream.sensor()->response());
+
+		DoubleArray data(128);
+		for ( int i = 0; i < data.size(); ++i )
+			data[i] = sin(i * 0.3);
+		BOOST_REQUIRE(stream.sensor()->response()->deconvolveFFT(data, 20.0, 0, 0, 0, 0));
+		return data.rms(0);
+	};
+
+	double rms = deconvolve();
+	BOOST_CHECK_CLOSE(deconvolve(), rms, 1E-9);
+
+	// Updating the response in place must not use the cached coefficients
+	DataModel::ResponsePAZ *paz = DataModel::ResponsePAZ::Find("C/PAZ");
+	BOOST_REQUIRE(paz);
+	paz->setNormalizationFactor(2.0);
+	paz->update();
+
+	BOOST_CHECK_CLOSE(deconvolve(), rms * 0.5, 1E-2);
+
+	Client::Inventory::Instance()->setInventory(nullptr);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
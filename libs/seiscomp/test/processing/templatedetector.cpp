@@ -0,0 +1,199 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/processing/templatedetector.h>
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::Processing;
+
+
+namespace {
+
+
+const double SamplingFrequency = 100.0;
+
+
+// A tapered chirp
+std::vector<double> chirp(int n, double f0, double f1) {
+	std::vector<double> data(n);
+	for ( int i = 0; i < n; ++i ) {
+		double t = i / SamplingFrequency;
+		double f = f0 + (f1 - f0) * i / (2.0 * n);
+		data[i] = sin(2 * M_PI * f * t) * sin(M_PI * i / (n - 1));
+	}
+	return data;
+}
+
+
+void feed(TemplateDetector &detector, const std::vector<double> &data,
+          const Core::Time &startTime, int recordLength) {
+	for ( size_t i = 0; i < data.size(); i += recordLength ) {
+		size_t n = std::min(data.size() - i, size_t(recordLength));
+		GenericRecordPtr rec = new GenericRecord("XX", "TEST", "", "HHZ",
+		                                         startTime + Core::TimeSpan(i / SamplingFrequency),
+		                                         SamplingFrequency);
+		rec->setData(new DoubleArray(n, data.data() + i));
+		detector.feed(rec.get());
+	}
+}
+
+
+// The direct computation of the correlation coefficient for comparison
+double correlation(const std::vector<double> &data, size_t offset,
+                   const std::vector<double> &tpl) {
+	size_t m = tpl.size();
+	double mx = 0, mt = 0;
+	for ( size_t j = 0; j < m; ++j ) {
+		mx += data[offset+j];
+		mt += tpl[j];
+	}
+	mx /= m;
+	mt /= m;
+
+	double sxt = 0, sxx = 0, stt = 0;
+	for ( size_t j = 0; j < m; ++j ) {
+		double x = data[offset+j] - mx, t = tpl[j] - mt;
+		sxt += x * t;
+		sxx += x * x;
+		stt += t * t;
+	}
+
+	return sxt / sqrt(sxx * stt);
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_templatedetector)
+
+
+BOOST_AUTO_TEST_CASE(detections) {
+	std::vector<double> tpl1 = chirp(150, 2, 10);
+	std::vector<double> tpl2 = chirp(80, 15, 5);
+	std::vector<double> tpl3 = chirp(200, 20, 30);
+
+	// Noise with the first template embedded three times, one of them
+	// across the block boundaries, and the second one once
+	std::mt19937 gen(7);
+	std::normal_distribution<double> dist;
+	std::vector<double> data(6000);
+	for ( auto &v : data ) v = dist(gen) * 0.1 + 5;
+
+	std::vector<std::pair<size_t, int>> events = {
+		{500, 1}, {1000, 2}, {1950, 1}, {4321, 1}
+	};
+
+	for ( const auto &ev : events ) {
+		const std::vector<double> &tpl = ev.second == 1 ? tpl1 : tpl2;
+		for ( size_t j = 0; j < tpl.size(); ++j )
+			data[ev.first+j] += 3 * tpl[j];
+	}
+
+	TemplateDetector detector;
+	detector.setThreshold(0.8);
+	detector.setBlockSize(256);
+	BOOST_CHECK(detector.addTemplate("T1", DoubleArray(tpl1.size(), tpl1.data())));
+	BOOST_CHECK(detector.addTemplate("T2", DoubleArray(tpl2.size(), tpl2.data()),
+	                                 Core::TimeSpan(0.5)));
+	BOOST_CHECK(detector.addTemplate("T3", DoubleArray(tpl3.size(), tpl3.data())));
+	BOOST_CHECK(!detector.addTemplate("C", DoubleArray(10, std::vector<double>(10, 1.0).data())));
+	BOOST_CHECK_EQUAL(detector.templateCount(), 3);
+
+	std::vector<TemplateDetector::Detection> detections;
+	size_t picks = 0;
+	detector.setDetectionFunction([&](const TemplateDetector *, const Record *,
+	                                  const TemplateDetector::Detection &d) {
+		detections.push_back(d);
+	});
+	detector.setPublishFunction([&](const Detector *, const Record *, const Core::Time &) {
+		++picks;
+	});
+
+	Core::Time startTime(2020, 1, 1, 0, 0, 0);
+	feed(detector, data, startTime, 128);
+
+	BOOST_REQUIRE_EQUAL(detections.size(), events.size());
+	BOOST_CHECK_EQUAL(picks, events.size());
+
+	for ( size_t i = 0; i < events.size(); ++i ) {
+		const auto &d = detections[i];
+		const auto &ev = events[i];
+		const std::vector<double> &tpl = ev.second == 1 ? tpl1 : tpl2;
+		Core::Time expected = startTime + Core::TimeSpan(ev.first / SamplingFrequency);
+		if ( ev.second == 2 ) expected += Core::TimeSpan(0.5);
+
+		BOOST_CHECK_EQUAL(d.templateID, ev.second == 1 ? "T1" : "T2");
+		BOOST_CHECK_EQUAL(d.time.iso(), expected.iso());
+		BOOST_CHECK_CLOSE(d.coefficient, correlation(data, ev.first, tpl), 1e-6);
+		BOOST_CHECK(d.coefficient > 0.95);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(gaps) {
+	std::vector<double> tpl = chirp(100, 3, 8);
+	std::vector<double> data(2000, 0.0);
+	std::mt19937 gen(3);
+	std::normal_distribution<double> dist;
+	for ( auto &v : data ) v = dist(gen) * 0.1;
+	for ( size_t j = 0; j < tpl.size(); ++j )
+		data[1500+j] += tpl[j];
+
+	TemplateDetector detector;
+	detector.addTemplate("T", DoubleArray(tpl.size(), tpl.data()));
+
+	std::vector<Core::Time> times;
+	detector.setDetectionFunction([&](const TemplateDetector *, const Record *,
+	                                  const TemplateDetector::Detection &d) {
+		times.push_back(d.time);
+	});
+
+	// Two sequences separated by a gap which is not handled
+	Core::Time startTime(2020, 1, 1, 0, 0, 0);
+	std::vector<double> first(data.begin(), data.begin() + 1000);
+	std::vector<double> second(data.begin() + 1000, data.end());
+	feed(detector, first, startTime, 100);
+	feed(detector, second, startTime + Core::TimeSpan(60.0), 100);
+
+	// The detection is reported after the block has been filled, the
+	// samples of the first sequence are dropped with the gap
+	std::vector<double> flush(3000, 0.0);
+	for ( auto &v : flush ) v = dist(gen) * 0.1;
+	feed(detector, flush, startTime + Core::TimeSpan(60.0 + second.size() / SamplingFrequency), 100);
+
+	BOOST_REQUIRE_EQUAL(times.size(), 1);
+	BOOST_CHECK_EQUAL(times[0].iso(),
+	                  (startTime + Core::TimeSpan(60.0 + 500 / SamplingFrequency)).iso());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
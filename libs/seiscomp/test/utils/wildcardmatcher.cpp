@@ -0,0 +1,141 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/utils/stringfirewall.h>
+#include <seiscomp/utils/wildcardmatcher.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+string randomString(mt19937 &gen, const char *alphabet, size_t maxLength) {
+	size_t n = strlen(alphabet);
+	string s(gen() % (maxLength + 1), ' ');
+	for ( char &c : s )
+		c = alphabet[gen() % n];
+	return s;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_utils_wildcardmatcher)
+
+
+BOOST_AUTO_TEST_CASE(streamIDs) {
+	Util::WildcardMatcher matcher;
+	BOOST_CHECK_EQUAL(matcher.match("GE.APE..BHZ"), -1);
+
+	BOOST_CHECK_EQUAL(matcher.add("GE.*.*.BH?"), 0);
+	BOOST_CHECK_EQUAL(matcher.add("GE.APE.*.*"), 1);
+	BOOST_CHECK_EQUAL(matcher.add("*"), 2);
+	BOOST_CHECK_EQUAL(matcher.size(), 3);
+
+	// The first matching pattern is returned
+	BOOST_CHECK_EQUAL(matcher.match("GE.APE..BHZ"), 0);
+	BOOST_CHECK_EQUAL(matcher.match("GE.APE..HHZ"), 1);
+	BOOST_CHECK_EQUAL(matcher.match("GE.APE..BHZ1"), 1);
+	BOOST_CHECK_EQUAL(matcher.match("GE.MORC.00.BHN"), 0);
+	BOOST_CHECK_EQUAL(matcher.match("II.BFO.00.BHZ"), 2);
+	BOOST_CHECK_EQUAL(matcher.match(""), 2);
+
+	matcher.clear();
+	matcher.add("II.???.00.*");
+	BOOST_CHECK(matcher.matches("II.BFO.00.BHZ"));
+	BOOST_CHECK(!matcher.matches("II.BFOX.00.BHZ"));
+	BOOST_CHECK(!matcher.matches("II.BF.00.BHZ"));
+	BOOST_CHECK(!matcher.matches("GE.APE..BHZ"));
+}
+
+
+BOOST_AUTO_TEST_CASE(wildcmp) {
+	mt19937 gen(7);
+
+	// Random patterns and strings over a small alphabet must give the
+	// same result as Core::wildcmp. A small state limit exercises the
+	// rebuild of the automaton.
+	for ( size_t maxStates : { 16, 4096 } ) {
+		for ( int round = 0; round < 50; ++round ) {
+			Util::WildcardMatcher matcher(maxStates);
+			vector<string> patterns;
+			for ( int i = 0; i < 20; ++i ) {
+				patterns.push_back(randomString(gen, "ab.*?", 8));
+				matcher.add(patterns.back());
+			}
+
+			for ( int i = 0; i < 200; ++i ) {
+				string s = randomString(gen, "abc.", 10);
+				int expected = -1;
+				for ( size_t j = 0; j < patterns.size(); ++j ) {
+					if ( Core::wildcmp(patterns[j], s) ) {
+						expected = static_cast<int>(j);
+						break;
+					}
+				}
+
+				BOOST_CHECK_EQUAL(matcher.match(s), expected);
+			}
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(firewall) {
+	Util::WildcardStringFirewall fw;
+	BOOST_CHECK(fw.isAllowed("GE.APE..BHZ"));
+
+	fw.allow.insert("GE.*");
+	fw.allow.insert("II.BFO.*");
+	fw.deny.insert("*.HH?");
+	fw.clearCache();
+
+	BOOST_CHECK(fw.isAllowed("GE.APE..BHZ"));
+	BOOST_CHECK(fw.isDenied("GE.APE..HHZ"));
+	BOOST_CHECK(fw.isAllowed("II.BFO.00.BHZ"));
+	BOOST_CHECK(fw.isDenied("II.ANMO.00.BHZ"));
+
+	// Changed rules take effect after clearing the cache
+	fw.deny.insert("GE.APE.*");
+	fw.clearCache();
+	BOOST_CHECK(fw.isDenied("GE.APE..BHZ"));
+
+	fw.setCachingEnabled(false);
+	BOOST_CHECK(fw.isAllowed("GE.MORC..BHZ"));
+	BOOST_CHECK(fw.isDenied("GE.MORC..HHZ"));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
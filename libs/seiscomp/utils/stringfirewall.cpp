@@ -20,8 +20,6 @@
 
 #include "stringfirewall.h"
 
-#include <seiscomp/core/strings.h>
-
 
 using namespace std;
 
@@ -30,26 +28,6 @@ namespace Seiscomp {
 namespace Util {
 
 
-namespace {
-
-
-bool passes(const StringFirewall::StringSet &ids, const std::string &id) {
-	StringFirewall::StringSet::iterator it;
-	for ( it = ids.begin(); it != ids.end(); ++it ) {
-		if ( Core::wildcmp(*it, id) )
-			return true;
-	}
-
-	return false;
-}
-
-
-}
-// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
-
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool StringFirewall::isAllowed(const std::string &s) const {
 	return (allow.empty()?true:allow.find(s) != allow.end())
@@ -71,7 +49,7 @@ bool StringFirewall::isDenied(const std::string &s) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 WildcardStringFirewall::WildcardStringFirewall()
-: _enableCaching(true) {}
+: _compiled(false), _enableCaching(true) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -80,6 +58,7 @@ WildcardStringFirewall::WildcardStringFirewall()
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void WildcardStringFirewall::clearCache() const {
 	_cache.clear();
+	_compiled = false;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -107,8 +86,11 @@ bool WildcardStringFirewall::isAllowed(const std::string &s) const {
 
 		// Not yet cached, evaluate the string
 		if ( it == _cache.end() ) {
-			bool check = (allow.empty()?true:passes(allow, s))
-			          && (deny.empty()?true:!passes(deny, s));
+			bool check = evaluate(s);
+			// Start over instead of growing without bounds if queries
+			// do not repeat
+			if ( _cache.size() >= MaxCacheSize )
+				_cache.clear();
 			_cache[s] = check;
 			return check;
 		}
@@ -116,10 +98,30 @@ bool WildcardStringFirewall::isAllowed(const std::string &s) const {
 		// Return cached result
 		return it->second;
 	}
-	else {
-		return (allow.empty()?true:passes(allow, s))
-		    && (deny.empty()?true:!passes(deny, s));
+	else
+		return evaluate(s);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool WildcardStringFirewall::evaluate(const std::string &s) const {
+	if ( !_compiled ) {
+		_allow.clear();
+		for ( const std::string &rule : allow )
+			_allow.add(rule);
+
+		_deny.clear();
+		for ( const std::string &rule : deny )
+			_deny.add(rule);
+
+		_compiled = true;
 	}
+
+	return (allow.empty()?true:_allow.matches(s))
+	    && (deny.empty()?true:!_deny.matches(s));
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -23,10 +23,12 @@
 
 
 #include <seiscomp/core/baseobject.h>
+#include <seiscomp/utils/wildcardmatcher.h>
 
 #include <string>
 #include <set>
 #include <map>
+#include <unordered_map>
 
 
 namespace Seiscomp {
@@ -88,15 +90,21 @@ class SC_SYSTEM_CORE_API StringFirewall : public Core::BaseObject {
  * @brief The WildcardStringFirewall class extends the StringFirewall by
  *        allowing wildcard ('*' or '?') matches for strings.
  *
- * Each call to either isAllowed or isDenied is cached by default to reduce
- * evaluation time for repeating queries. If queries do not repeat or are
- * more or less random then caching should be disabled.
+ * The rules are compiled into a WildcardMatcher on first use, hence
+ * evaluation time does not depend on the number of rules. Each call to
+ * either isAllowed or isDenied is additionally cached by default to reduce
+ * evaluation time for repeating queries. The cache holds at most
+ * MaxCacheSize entries. If queries do not repeat or are more or less
+ * random then caching should be disabled.
  */
 class SC_SYSTEM_CORE_API WildcardStringFirewall : public StringFirewall {
 	// ----------------------------------------------------------------------
 	//  X'truction
 	// ----------------------------------------------------------------------
 	public:
+		//! The maximum number of cached queries
+		static const size_t MaxCacheSize = 16384;
+
 		//! C'tor
 		WildcardStringFirewall();
 
@@ -106,8 +114,8 @@ class SC_SYSTEM_CORE_API WildcardStringFirewall : public StringFirewall {
 	// ----------------------------------------------------------------------
 	public:
 		/**
-		 * Clears the internal evaluation cache. This should be called when
-		 * either #allow or #deny have changed.
+		 * Clears the internal evaluation cache and the compiled rules. This
+		 * must be called when either #allow or #deny have changed.
 		 */
 		void clearCache() const;
 
@@ -129,9 +137,15 @@ class SC_SYSTEM_CORE_API WildcardStringFirewall : public StringFirewall {
 	//  Private members and typedefs
 	// ----------------------------------------------------------------------
 	private:
-		typedef std::map<std::string, bool> StringPassMap;
-		mutable StringPassMap _cache;
-		bool                  _enableCaching;
+		bool evaluate(const std::string &s) const;
+
+	private:
+		typedef std::unordered_map<std::string, bool> StringPassMap;
+		mutable StringPassMap   _cache;
+		mutable WildcardMatcher _allow;
+		mutable WildcardMatcher _deny;
+		mutable bool            _compiled;
+		bool                    _enableCaching;
 };
 
 
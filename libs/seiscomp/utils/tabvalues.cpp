@@ -26,6 +26,8 @@
 
 #include <cfloat>
 #include <fstream>
+#include <iterator>
+#include <string_view>
 
 
 using namespace std;
@@ -325,20 +327,42 @@ bool TabValues::read(const std::string &filename) {
 	if ( !ifs.is_open() )
 		return false;
 
-	string line;
+	// The tables are parsed from memory without a copy per value
+	string content((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+	string_view data(content);
 
-	while ( getline(ifs, line) ) {
+	auto skipLine = [&data]() {
+		size_t pos = data.find('\n');
+		data.remove_prefix(pos == string_view::npos ? data.size() : pos+1);
+	};
+
+	auto next = [&data](auto &value) {
+		size_t pos = data.find_first_not_of(Core::WHITESPACE);
+		if ( pos == string_view::npos ) {
+			data = string_view();
+			return false;
+		}
+		data.remove_prefix(pos);
+		pos = data.find_first_of(Core::WHITESPACE);
+		string_view tok = data.substr(0, pos);
+		data.remove_prefix(tok.size());
+		if ( tok[0] == '+' ) tok.remove_prefix(1);
+		return Core::fromChars(value, tok);
+	};
+
+	if ( !data.empty() ) {
+		string line(data.substr(0, data.find('\n')));
 		size_t hashPos = line.find('#');
 		if ( hashPos != string::npos )
 			line.erase(line.begin() + int(hashPos), line.end());
 		Core::trim(line);
 		header = line;
-		break;
+		skipLine();
 	}
 
 	size_t numberOfYSamples = 0, numberOfXSamples = 0;
-	ifs >> numberOfYSamples;
-	getline(ifs, line);
+	if ( !next(numberOfYSamples) ) numberOfYSamples = 0;
+	skipLine();
 
 	if ( numberOfYSamples == 0 || numberOfYSamples > 10000 ) {
 		SEISCOMP_ERROR("%s: invalid number of depth samples: %d",
@@ -346,12 +370,14 @@ bool TabValues::read(const std::string &filename) {
 		return false;
 	}
 
+	bool good = true;
+
 	y.resize(size_t(numberOfYSamples));
-	for ( size_t i = 0; i < y.size(); ++i )
-		ifs >> y[i];
+	for ( size_t i = 0; good && i < y.size(); ++i )
+		good = next(y[i]);
 
-	ifs >> numberOfXSamples;
-	getline(ifs, line);
+	if ( !good || !next(numberOfXSamples) ) numberOfXSamples = 0;
+	skipLine();
 
 	if ( numberOfXSamples == 0 || numberOfXSamples > 10000 ) {
 		SEISCOMP_ERROR("%s: invalid number of distance samples: %d",
@@ -360,21 +386,32 @@ bool TabValues::read(const std::string &filename) {
 	}
 
 	x.resize(size_t(numberOfXSamples));
-	for ( size_t i = 0; i < x.size(); ++i )
-		ifs >> x[i];
+	for ( size_t i = 0; good && i < x.size(); ++i )
+		good = next(x[i]);
 
 	values.resize(size_t(numberOfYSamples));
 
 	for ( size_t i = 0; i < size_t(numberOfYSamples); ++i ) {
-		if ( !ifs.good() ) break;
+		if ( !good ) break;
 
-		while ( ifs.get() != '#' );
-		while ( ifs.get() != '\n' );
+		// Skip the comment line preceding the samples of a depth
+		size_t hashPos = data.find('#');
+		if ( hashPos == string_view::npos ) {
+			good = false;
+			break;
+		}
+		data.remove_prefix(hashPos);
+		skipLine();
 
 		values[i].resize(size_t(numberOfXSamples));
 
-		for ( size_t j = 0; j < size_t(numberOfXSamples); ++j )
-			ifs >> values[i][j];
+		for ( size_t j = 0; good && j < size_t(numberOfXSamples); ++j )
+			good = next(values[i][j]);
+	}
+
+	if ( !good ) {
+		SEISCOMP_ERROR("%s: invalid or missing samples", filename.c_str());
+		return false;
 	}
 
 	bool inUndefinedRange = false;
@@ -390,7 +427,7 @@ bool TabValues::read(const std::string &filename) {
 		}
 	}
 
-	return ifs.good();
+	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
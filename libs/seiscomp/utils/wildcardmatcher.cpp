@@ -0,0 +1,279 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/utils/wildcardmatcher.h>
+
+#include <algorithm>
+
+
+namespace Seiscomp {
+namespace Util {
+
+
+namespace {
+
+
+// The state without positions which never matches
+const int DeadState = 0;
+const int StartState = 1;
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+WildcardMatcher::WildcardMatcher(size_t maxStates)
+: _maxStates(std::max(maxStates, size_t(16)))
+, _compiled(false)
+, _symbolCount(1)
+, _mark(0) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t WildcardMatcher::add(const std::string &pattern) {
+	_patterns.push_back(pattern);
+	_compiled = false;
+	return _patterns.size() - 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardMatcher::clear() {
+	_patterns.clear();
+	_compiled = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int WildcardMatcher::match(const char *str, size_t len) const {
+	if ( _patterns.empty() ) {
+		return -1;
+	}
+
+	if ( !_compiled ) {
+		compile();
+	}
+
+	int current = StartState;
+	for ( size_t i = 0; i < len; ++i ) {
+		uint16_t symbol = _symbols[static_cast<unsigned char>(str[i])];
+		int target = _transitions[current * _symbolCount + symbol];
+		current = target >= 0 ? target : next(current, symbol);
+		if ( current == DeadState ) {
+			return -1;
+		}
+	}
+
+	return _states[current].match;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardMatcher::compile() const {
+	_tokens.clear();
+	_owners.clear();
+
+	// Characters which are not used literally in any pattern share
+	// symbol 0
+	std::fill(_symbols, _symbols + 256, 0);
+	_symbolCount = 1;
+
+	for ( size_t i = 0; i < _patterns.size(); ++i ) {
+		const std::string &pattern = _patterns[i];
+		for ( size_t j = 0; j < pattern.size(); ++j ) {
+			unsigned char c = static_cast<unsigned char>(pattern[j]);
+			if ( c == '*' ) {
+				// Consecutive stars are equivalent to a single one
+				if ( j > 0 && pattern[j-1] == '*' ) {
+					continue;
+				}
+
+				_tokens.push_back(Star);
+			}
+			else if ( c == '?' ) {
+				_tokens.push_back(Any);
+			}
+			else {
+				if ( !_symbols[c] ) {
+					_symbols[c] = _symbolCount++;
+				}
+
+				_tokens.push_back(_symbols[c]);
+			}
+
+			_owners.push_back(static_cast<int>(i));
+		}
+
+		_tokens.push_back(End);
+		_owners.push_back(static_cast<int>(i));
+	}
+
+	_marks.assign(_tokens.size(), 0);
+	_mark = 0;
+	_compiled = true;
+
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardMatcher::reset() const {
+	_states.clear();
+	_transitions.clear();
+	_stateIndex.clear();
+
+	Positions positions;
+	state(positions);
+
+	// The start state holds the first position of each pattern
+	nextMark();
+	bool first = true;
+	for ( uint32_t i = 0; i < _tokens.size(); ++i ) {
+		if ( first ) {
+			include(positions, i);
+		}
+
+		first = _tokens[i] == End;
+	}
+
+	state(positions);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int WildcardMatcher::state(Positions &positions) const {
+	std::sort(positions.begin(), positions.end());
+
+	auto it = _stateIndex.find(positions);
+	if ( it != _stateIndex.end() ) {
+		return it->second;
+	}
+
+	int id = static_cast<int>(_states.size());
+
+	// Positions are ordered by pattern, the first final position belongs
+	// to the first matching pattern
+	int match = -1;
+	for ( uint32_t position : positions ) {
+		if ( _tokens[position] == End ) {
+			match = _owners[position];
+			break;
+		}
+	}
+
+	_states.push_back({positions, match});
+	_transitions.resize(_transitions.size() + _symbolCount, id == DeadState ? DeadState : -1);
+	_stateIndex.emplace(positions, id);
+
+	return id;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int WildcardMatcher::next(int current, uint16_t symbol) const {
+	Positions positions;
+
+	nextMark();
+	for ( uint32_t position : _states[current].positions ) {
+		uint16_t token = _tokens[position];
+		if ( token == Star ) {
+			include(positions, position);
+		}
+		else if ( token == Any || token == symbol ) {
+			include(positions, position + 1);
+		}
+	}
+
+	std::sort(positions.begin(), positions.end());
+	auto it = _stateIndex.find(positions);
+	if ( it == _stateIndex.end() && _states.size() >= _maxStates ) {
+		// Start over with an empty automaton, the transitions of the
+		// discarded states are not recorded
+		reset();
+		return state(positions);
+	}
+
+	int target = it != _stateIndex.end() ? it->second : state(positions);
+	_transitions[current * _symbolCount + symbol] = target;
+	return target;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardMatcher::include(Positions &positions, uint32_t position) const {
+	if ( _marks[position] == _mark ) {
+		return;
+	}
+
+	_marks[position] = _mark;
+	positions.push_back(position);
+
+	// A star also matches an empty sequence
+	if ( _tokens[position] == Star ) {
+		include(positions, position + 1);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardMatcher::nextMark() const {
+	if ( ++_mark == 0 ) {
+		std::fill(_marks.begin(), _marks.end(), 0);
+		_mark = 1;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_UTILS_WILDCARDMATCHER_H
+#define SEISCOMP_UTILS_WILDCARDMATCHER_H
+
+
+#include <seiscomp/core.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Util {
+
+
+/**
+ * @brief The WildcardMatcher class matches strings against a list of
+ *        patterns with the wildcards '*' and '?' at once.
+ *
+ * The patterns are compiled into a single automaton which is built lazily
+ * while strings are matched. Matching a string takes time proportional to
+ * its length regardless of the number of patterns, which makes the class
+ * suitable to filter stream IDs (NET.STA.LOC.CHA) of each record against
+ * a large number of rules. The semantics are the same as Core::wildcmp.
+ *
+ * The number of cached automaton states is bounded. If the bound is
+ * reached the automaton is discarded and built again.
+ *
+ * The class is not thread-safe, not even for concurrent calls of the const
+ * methods.
+ */
+class SC_SYSTEM_CORE_API WildcardMatcher {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		//! C'tor
+		explicit WildcardMatcher(size_t maxStates = 4096);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Adds a pattern.
+		 * @param pattern The pattern which may contain '*' and '?'
+		 * @return The index of the pattern
+		 */
+		size_t add(const std::string &pattern);
+
+		//! Removes all patterns
+		void clear();
+
+		bool empty() const;
+		size_t size() const;
+		const std::string &pattern(size_t index) const;
+
+		/**
+		 * @brief Returns the first pattern in the order of addition which
+		 *        matches a string.
+		 * @param str The input string
+		 * @return The index of the pattern or -1 if no pattern matches
+		 */
+		int match(const std::string &str) const;
+		int match(const char *str, size_t len) const;
+
+		//! Returns whether any pattern matches a string
+		bool matches(const std::string &str) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods and members
+	// ----------------------------------------------------------------------
+	private:
+		using Positions = std::vector<uint32_t>;
+
+		struct State {
+			Positions positions;
+			//! The first matching pattern
+			int       match;
+		};
+
+		void compile() const;
+		void reset() const;
+		int state(Positions &positions) const;
+		int next(int state, uint16_t symbol) const;
+		void include(Positions &positions, uint32_t position) const;
+		void nextMark() const;
+
+		//! Position types besides a literal symbol
+		enum {
+			Any = 0xfffd,
+			Star = 0xfffe,
+			End = 0xffff
+		};
+
+		std::vector<std::string>      _patterns;
+		size_t                        _maxStates;
+
+		// The nondeterministic automaton: one position per pattern
+		// character plus a final position per pattern
+		mutable bool                  _compiled;
+		mutable std::vector<uint16_t> _tokens;
+		mutable std::vector<int>      _owners;
+		mutable uint16_t              _symbols[256];
+		mutable uint16_t              _symbolCount;
+
+		// The lazily built deterministic automaton
+		mutable std::vector<State>    _states;
+		mutable std::vector<int>      _transitions;
+		mutable std::map<Positions, int> _stateIndex;
+		mutable std::vector<uint32_t> _marks;
+		mutable uint32_t              _mark;
+};
+
+
+inline bool WildcardMatcher::empty() const {
+	return _patterns.empty();
+}
+
+inline size_t WildcardMatcher::size() const {
+	return _patterns.size();
+}
+
+inline const std::string &WildcardMatcher::pattern(size_t index) const {
+	return _patterns[index];
+}
+
+inline int WildcardMatcher::match(const std::string &str) const {
+	return match(str.c_str(), str.size());
+}
+
+inline bool WildcardMatcher::matches(const std::string &str) const {
+	return match(str) >= 0;
+}
+
+
+}
+}
+
+
+#endif
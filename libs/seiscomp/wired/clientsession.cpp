@@ -22,8 +22,10 @@
 #include <seiscomp/logging/log.h>
 #include <seiscomp/core/baseobject.h>
 #include <seiscomp/wired/clientsession.h>
+#include <seiscomp/wired/buffers/file.h>
 #include <seiscomp/wired/reactor.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <iostream>
 
@@ -83,6 +85,51 @@ void ClientSession::setMIMEUnfoldingEnabled(bool f) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ClientSession::pauseInbox() {
+	_flags |= InboxPaused;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ClientSession::resumeInbox() {
+	if ( !(_flags & InboxPaused) ) return;
+
+	_flags &= ~InboxPaused;
+
+	if ( _heldInbox.empty() ) return;
+
+	// handleReceive may pause the inbox again and hold back the remaining
+	// data, so the held data must be moved out first
+	std::vector<char> held;
+	held.swap(_heldInbox);
+	handleReceive(&held[0], held.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ClientSession::holdInbox(const char *data, size_t len) {
+	if ( _heldInbox.size() + len > MaxHeldBytes ) {
+		SEISCOMP_WARNING("Too many bytes received while inbox is paused, "
+		                 "closing session");
+		_heldInbox.clear();
+		invalidate();
+		return;
+	}
+
+	_heldInbox.insert(_heldInbox.end(), data, data + len);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void ClientSession::flushOutbox() {
 	if ( _outbox.empty() ) {
@@ -130,92 +177,101 @@ void ClientSession::flush() {
 	}
 
 	while ( _currentBuffer ) {
-		size_t remaining = _currentBuffer->header.size() - _currentBufferHeaderOffset;
-		ssize_t written;
-
-		if ( remaining > 0 ) {
-			written = _device->write(
-				&_currentBuffer->header[_currentBufferHeaderOffset],
-				static_cast<size_t>(remaining)
-			);
+		if ( (_currentBufferHeaderOffset < _currentBuffer->header.size())
+		  || (_currentBufferDataOffset < _currentBuffer->data.size()) ) {
+			// Collect the remaining part of the current buffer and all
+			// subsequent buffers which are completely loaded and write
+			// them with one call.
+			struct iovec iov[MaxIOVecs];
+			int iovcnt = 0;
+			bool gatherNext = isComplete(_currentBuffer.get());
+
+			addIOVecs(iov, iovcnt, _currentBuffer.get(),
+			          _currentBufferHeaderOffset, _currentBufferDataOffset);
+
+			for ( auto it = _bufferQueue.begin();
+			      gatherNext && (it != _bufferQueue.end()) && (iovcnt + 2 <= MaxIOVecs);
+			      ++it ) {
+				addIOVecs(iov, iovcnt, it->get(), 0, 0);
+				// The first chunk of a buffer which is not yet completely
+				// loaded can still be sent but nothing behind it.
+				gatherNext = isComplete(it->get());
+			}
+
+			ssize_t written = _device->writev(iov, iovcnt);
+
 			// Error on socket?
 			if ( written < 0 ) {
 				if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) ) {
 					// Close the session
 					_currentBuffer = nullptr;
 					close();
-					break;
 				}
+				break;
 			}
+
 			// No non-blocking writing possible?
-			else if ( written == 0 ) {
-			}
-			else {
-				_currentBufferHeaderOffset += static_cast<size_t>(written);
-				if ( static_cast<size_t>(written) <= _bufferBytesPending )
-					_bufferBytesPending -= static_cast<size_t>(written);
-				else
-					_bufferBytesPending = 0;
-				//SEISCOMP_DEBUG("Bytes pending: %d, written: %d", (int)_bytesPending, written);
-			}
-		}
+			if ( written == 0 )
+				break;
 
-		// header not yet completely sent
-		if ( _currentBufferHeaderOffset < _currentBuffer->header.size() ) return;
+			if ( static_cast<size_t>(written) <= _bufferBytesPending )
+				_bufferBytesPending -= static_cast<size_t>(written);
+			else
+				_bufferBytesPending = 0;
+			//SEISCOMP_DEBUG("Bytes pending: %d, written: %d", (int)_bytesPending, written);
 
-		remaining = _currentBuffer->data.size() - _currentBufferDataOffset;
-		if ( remaining > 0 ) {
-			written = _device->write(&_currentBuffer->data[_currentBufferDataOffset],
-			                         remaining);
+			consume(static_cast<size_t>(written));
 
-			// Error on socket?
-			if ( written < 0 ) {
-				if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) ) {
-					_currentBuffer = nullptr;
-					// Close the session
-					close();
-					break;
-				}
-			}
-			// No non-blocking writing possible?
-			else if ( written == 0 ) {
-			}
-			else {
-				_bytesSent += static_cast<size_t>(written);
-				_currentBufferDataOffset += static_cast<size_t>(written);
-				if ( static_cast<size_t>(written) <= _bufferBytesPending )
-					_bufferBytesPending -= static_cast<size_t>(written);
-				else
-					_bufferBytesPending = 0;
-				//SEISCOMP_DEBUG("Bytes pending: %d, written: %d", (int)_bytesPending, written);
-			}
+			// Not all data has been written
+			if ( !_currentBuffer
+			  || (_currentBufferHeaderOffset < _currentBuffer->header.size())
+			  || (_currentBufferDataOffset < _currentBuffer->data.size()) )
+				break;
 		}
 
-		// Finished current?
-		if ( _currentBufferDataOffset == _currentBuffer->data.size() ) {
-			_currentBufferHeaderOffset = 0;
-			_currentBufferDataOffset = 0;
+		// The current chunk has been sent completely. Files are continued
+		// from the kernel without copying them through user space if
+		// possible.
+		FileBuffer *file = dynamic_cast<FileBuffer*>(_currentBuffer.get());
+		if ( file && file->fp ) {
+			off_t offset = ftello(file->fp);
+			if ( (offset >= 0) && (offset < file->fplen) ) {
+				ssize_t written = _device->sendfile(
+					fileno(file->fp), &offset,
+					static_cast<size_t>(file->fplen - offset)
+				);
+
+				if ( written < 0 ) {
+					if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+						break;
+
+					if ( (errno != ENOSYS) && (errno != EINVAL) ) {
+						// Close the session
+						_currentBuffer = nullptr;
+						close();
+						break;
+					}
+
+					// Not supported by the device, continue reading the
+					// file into the buffer
+				}
+				else {
+					fseeko(file->fp, offset, SEEK_SET);
 
-			if ( !_currentBuffer->updateBuffer() ) {
-				bufferSent(_currentBuffer.get());
-				_currentBuffer = nullptr;
-				_currentBufferHeaderOffset = 0;
+					_bytesSent += static_cast<Device::count_t>(written);
+					if ( static_cast<size_t>(written) <= _bufferBytesPending )
+						_bufferBytesPending -= static_cast<size_t>(written);
+					else
+						_bufferBytesPending = 0;
 
-				if ( !_bufferQueue.empty() ) {
-					_currentBuffer = _bufferQueue.front();
-					_bufferQueue.pop_front();
+					// Wait for the next write event
+					if ( offset < file->fplen )
+						break;
 				}
 			}
-			else {
-				_bufferBytesPending += _currentBuffer->header.size();
-				size_t buf_length = _currentBuffer->length();
-				if ( buf_length == string::npos )
-					_bufferBytesPending += _currentBuffer->data.size();
-			}
 		}
-		else
-			// No all data has been written
-			break;
+
+		finishCurrentBuffer();
 
 		if ( !_currentBuffer ) {
 			//_socket->flush();
@@ -231,6 +287,86 @@ void ClientSession::flush() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ClientSession::isComplete(const Buffer *buf) {
+	// Buffers which are transferred in chunks either report an unknown
+	// length or a length larger than the current chunk.
+	return buf->length() == buf->data.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ClientSession::addIOVecs(struct iovec *iov, int &iovcnt, Buffer *buf,
+                              size_t headerOffset, size_t dataOffset) {
+	if ( headerOffset < buf->header.size() ) {
+		iov[iovcnt].iov_base = &buf->header[headerOffset];
+		iov[iovcnt].iov_len = buf->header.size() - headerOffset;
+		++iovcnt;
+	}
+
+	if ( dataOffset < buf->data.size() ) {
+		iov[iovcnt].iov_base = &buf->data[dataOffset];
+		iov[iovcnt].iov_len = buf->data.size() - dataOffset;
+		++iovcnt;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ClientSession::consume(size_t bytes) {
+	while ( _currentBuffer ) {
+		size_t headerBytes = min(bytes, _currentBuffer->header.size() - _currentBufferHeaderOffset);
+		_currentBufferHeaderOffset += headerBytes;
+		bytes -= headerBytes;
+
+		size_t dataBytes = min(bytes, _currentBuffer->data.size() - _currentBufferDataOffset);
+		_currentBufferDataOffset += dataBytes;
+		_bytesSent += static_cast<Device::count_t>(dataBytes);
+		bytes -= dataBytes;
+
+		// Stop at the last buffer touched by the write
+		if ( !bytes ) break;
+
+		finishCurrentBuffer();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ClientSession::finishCurrentBuffer() {
+	_currentBufferHeaderOffset = 0;
+	_currentBufferDataOffset = 0;
+
+	if ( !_currentBuffer->updateBuffer() ) {
+		bufferSent(_currentBuffer.get());
+		_currentBuffer = nullptr;
+
+		if ( !_bufferQueue.empty() ) {
+			_currentBuffer = _bufferQueue.front();
+			_bufferQueue.pop_front();
+		}
+	}
+	else {
+		_bufferBytesPending += _currentBuffer->header.size();
+		size_t buf_length = _currentBuffer->length();
+		if ( buf_length == string::npos )
+			_bufferBytesPending += _currentBuffer->data.size();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t ClientSession::inAvail() const {
 	return _outbox.size() + _bufferBytesPending;
@@ -339,6 +475,11 @@ void ClientSession::finishReading() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void ClientSession::handleReceive(const char *buf, size_t len) {
+	if ( _flags & InboxPaused ) {
+		holdInbox(buf, len);
+		return;
+	}
+
 	if ( _postDataSize > 0 ) {
 		if ( len > 0 ) {
 			size_t read = std::min(_postDataSize, len);
@@ -346,6 +487,11 @@ void ClientSession::handleReceive(const char *buf, size_t len) {
 			_postDataSize -= read;
 			buf += read;
 			len -= read;
+
+			if ( _flags & InboxPaused ) {
+				holdInbox(buf, len);
+				return;
+			}
 		}
 	}
 
@@ -373,12 +519,23 @@ void ClientSession::handleReceive(const char *buf, size_t len) {
 			_inboxPos = 0;
 			_inbox[0] = '\0';
 
+			if ( _flags & InboxPaused ) {
+				holdInbox(buf + 1, len - 1);
+				return;
+			}
+
 			if ( _postDataSize > 0 ) {
 				++buf; --len;
 				if ( len > 0 ) {
 					size_t read = std::min(_postDataSize, len);
 					handlePostData(buf, read);
 					_postDataSize -= read;
+
+					if ( _flags & InboxPaused ) {
+						holdInbox(buf + read, len - read);
+						return;
+					}
+
 					// buf and len are increased again in the for loop so
 					// decrease them here again to move the read pointer to
 					// the correct position in the next loop
@@ -78,6 +78,18 @@ class SC_SYSTEM_CORE_API ClientSession : public Session {
 
 		void setMIMEUnfoldingEnabled(bool);
 
+		//! Stops passing received data to handleInbox and handlePostData.
+		//! Data received in the meantime is held back, e.g. a pipelined
+		//! request which must not be processed before the response to the
+		//! current one has been sent.
+		void pauseInbox();
+
+		//! Passes the held back data to handleReceive and continues
+		//! reading.
+		void resumeInbox();
+
+		bool isInboxPaused() const;
+
 		//! Returns the available bytes to send.
 		virtual size_t inAvail() const;
 
@@ -107,13 +119,36 @@ class SC_SYSTEM_CORE_API ClientSession : public Session {
 	private:
 		void flushOutbox();
 
+		//! Returns whether the buffer content is completely loaded and
+		//! can be batched with subsequent buffers
+		static bool isComplete(const Buffer *buf);
+
+		//! Adds the unsent parts of a buffer to an iovec array
+		static void addIOVecs(struct iovec *iov, int &iovcnt, Buffer *buf,
+		                      size_t headerOffset, size_t dataOffset);
+
+		//! Holds back received data while the inbox is paused
+		void holdInbox(const char *data, size_t len);
+
+		//! Advances the buffer offsets by the number of bytes written
+		void consume(size_t bytes);
+
+		//! Loads the next chunk of the current buffer or activates the
+		//! next queued buffer
+		void finishCurrentBuffer();
+
 
 	protected:
+		//! The maximum number of buffer pieces written with one call
+		static const int MaxIOVecs = 64;
+		//! The maximum number of bytes held back while the inbox is paused
+		static const size_t MaxHeldBytes = 1024*1024;
+
 		enum Flags {
 			NoFlags       = 0x0000,
 			MIMEUnfolding = 0x0001,
 			KeepReading   = 0x0002,
-			//Future1     = 0x0004,
+			InboxPaused   = 0x0004,
 			//Future2     = 0x0008,
 			//Future3     = 0x0010,
 			//Future4     = 0x0020,
@@ -125,6 +160,7 @@ class SC_SYSTEM_CORE_API ClientSession : public Session {
 		std::vector<char> _inbox;
 		size_t            _inboxPos;
 		std::vector<char> _outbox;
+		std::vector<char> _heldInbox;
 		uint16_t          _flags;
 		size_t            _postDataSize;
 		Device::count_t   _bytesSent;
@@ -147,6 +183,10 @@ inline void ClientSession::invalidate() {
 	_flags |= Erroneous;
 }
 
+inline bool ClientSession::isInboxPaused() const {
+	return _flags & InboxPaused;
+}
+
 inline bool ClientSession::erroneous() const {
 	return _flags & Erroneous;
 }
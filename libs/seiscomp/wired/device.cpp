@@ -41,9 +41,22 @@
 #include <linux/version.h>
 #endif
 
+#if defined(SEISCOMP_WIRED_IOURING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#endif
+
 #include <iostream>
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <climits>
 #include <cstring>
 
 
@@ -72,12 +85,28 @@ bool lessThan(const struct timeval *tv1, const struct timeval *tv2) {
 }
 */
 
-// Returns milliseconds
-int tv_sub_ms(const struct timeval *tv1, const struct timeval *tv2) {
-	int64_t msdiff = static_cast<int64_t>((tv1->tv_sec - tv2->tv_sec) * 1000);
-	int64_t udiff = static_cast<int64_t>((tv1->tv_usec - tv2->tv_usec) / 1000);
-	if ( udiff < 0 ) msdiff -= udiff;
-	return static_cast<int>(msdiff);
+// Returns the monotonic time in milliseconds
+int64_t monotonicMs() {
+	return chrono::duration_cast<chrono::milliseconds>(
+		chrono::steady_clock::now().time_since_epoch()
+	).count();
+}
+
+// Returns the distance of the first set bit of a non-zero mask starting
+// at offset and wrapping around
+int firstSlot(uint64_t mask, int offset) {
+	if ( offset )
+		mask = (mask >> offset) | (mask << (64 - offset));
+#if defined(__GNUC__)
+	return __builtin_ctzll(mask);
+#else
+	int n = 0;
+	while ( !(mask & 1) ) {
+		mask >>= 1;
+		++n;
+	}
+	return n;
+#endif
 }
 
 /*
@@ -87,6 +116,196 @@ int tv_to_ms(const struct timeval *tv) {
 */
 
 
+#ifdef SEISCOMP_WIRED_IOURING
+/**
+ * @brief Minimal io_uring interface which is used to poll devices for
+ *        readiness. All changes of the requested events are queued as
+ *        submission entries and passed to the kernel together with the
+ *        wait for completions, that is with one system call.
+ */
+class IOURing {
+	public:
+		IOURing() = default;
+		~IOURing() { close(); }
+
+	public:
+		bool open(unsigned int entries) {
+			struct io_uring_params params;
+			memset(&params, 0, sizeof(params));
+
+			_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+			if ( _fd < 0 ) return false;
+
+			// Timeouts are passed to io_uring_enter directly
+			if ( !(params.features & IORING_FEAT_EXT_ARG) ) {
+				close();
+				errno = ENOSYS;
+				return false;
+			}
+
+			_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+			if ( params.features & IORING_FEAT_SINGLE_MMAP ) {
+				_sqRingSize = _cqRingSize = max(_sqRingSize, _cqRingSize);
+			}
+
+			_sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE,
+			               MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+			if ( _sqRing == MAP_FAILED ) {
+				close();
+				return false;
+			}
+
+			if ( params.features & IORING_FEAT_SINGLE_MMAP )
+				_cqRing = _sqRing;
+			else {
+				_cqRing = mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE,
+				               MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+				if ( _cqRing == MAP_FAILED ) {
+					close();
+					return false;
+				}
+			}
+
+			_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+			void *sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE,
+			                  MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+			if ( sqes == MAP_FAILED ) {
+				close();
+				return false;
+			}
+
+			_sqes = static_cast<struct io_uring_sqe*>(sqes);
+
+			char *sq = static_cast<char*>(_sqRing);
+			_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+			_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+			_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+			_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+			_sqEntries = params.sq_entries;
+			_sqLocalTail = *_sqTail;
+
+			char *cq = static_cast<char*>(_cqRing);
+			_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+			_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+			_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+			_cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+			return true;
+		}
+
+		void close() {
+			if ( _sqes ) {
+				munmap(_sqes, _sqesSize);
+				_sqes = nullptr;
+			}
+
+			if ( _cqRing && (_cqRing != MAP_FAILED) && (_cqRing != _sqRing) )
+				munmap(_cqRing, _cqRingSize);
+			_cqRing = nullptr;
+
+			if ( _sqRing && (_sqRing != MAP_FAILED) )
+				munmap(_sqRing, _sqRingSize);
+			_sqRing = nullptr;
+
+			if ( _fd >= 0 ) {
+				::close(_fd);
+				_fd = -1;
+			}
+		}
+
+		//! Returns a cleared submission entry or nullptr if the submission
+		//! queue is full.
+		struct io_uring_sqe *sqe() {
+			unsigned head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+			if ( _sqLocalTail - head >= _sqEntries ) return nullptr;
+
+			unsigned idx = _sqLocalTail & _sqMask;
+			struct io_uring_sqe *entry = &_sqes[idx];
+			memset(entry, 0, sizeof(*entry));
+			_sqArray[idx] = idx;
+			++_sqLocalTail;
+			return entry;
+		}
+
+		//! Makes all queued submission entries visible to the kernel
+		void publish() {
+			__atomic_store_n(_sqTail, _sqLocalTail, __ATOMIC_RELEASE);
+		}
+
+		//! Returns the number of published but not yet consumed entries
+		unsigned pending() const {
+			return __atomic_load_n(_sqTail, __ATOMIC_ACQUIRE) -
+			       __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+		}
+
+		/**
+		 * @brief Submits all published entries and optionally waits for
+		 *        completions.
+		 * @param minComplete The number of completions to wait for
+		 * @param timeout The timeout in milliseconds, negative to wait
+		 *                infinitely
+		 * @return The result of io_uring_enter
+		 */
+		int enter(unsigned minComplete, int timeout) {
+			unsigned flags = 0;
+			struct io_uring_getevents_arg arg;
+			struct __kernel_timespec ts;
+
+			memset(&arg, 0, sizeof(arg));
+
+			if ( minComplete ) {
+				flags |= IORING_ENTER_GETEVENTS;
+				if ( timeout >= 0 ) {
+					ts.tv_sec = timeout / 1000;
+					ts.tv_nsec = (timeout % 1000) * 1000000L;
+					arg.ts = reinterpret_cast<uint64_t>(&ts);
+				}
+			}
+
+			flags |= IORING_ENTER_EXT_ARG;
+
+			return static_cast<int>(
+				syscall(__NR_io_uring_enter, _fd, pending(), minComplete,
+				        flags, &arg, sizeof(arg))
+			);
+		}
+
+		//! Returns the next completion entry or nullptr.
+		struct io_uring_cqe *peek() {
+			unsigned head = *_cqHead;
+			if ( head == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE) )
+				return nullptr;
+			return &_cqes[head & _cqMask];
+		}
+
+		//! Marks the entry returned by peek as consumed.
+		void seen() {
+			__atomic_store_n(_cqHead, *_cqHead + 1, __ATOMIC_RELEASE);
+		}
+
+	private:
+		int                  _fd{-1};
+		void                *_sqRing{nullptr};
+		size_t               _sqRingSize{0};
+		void                *_cqRing{nullptr};
+		size_t               _cqRingSize{0};
+		struct io_uring_sqe *_sqes{nullptr};
+		size_t               _sqesSize{0};
+		unsigned            *_sqHead{nullptr};
+		unsigned            *_sqTail{nullptr};
+		unsigned            *_sqArray{nullptr};
+		unsigned             _sqMask{0};
+		unsigned             _sqEntries{0};
+		unsigned             _sqLocalTail{0};
+		unsigned            *_cqHead{nullptr};
+		unsigned            *_cqTail{nullptr};
+		unsigned             _cqMask{0};
+		struct io_uring_cqe *_cqes{nullptr};
+};
+#endif
+
 
 }
 
@@ -114,7 +333,9 @@ Device::Device() : _fd(-1) {
 #endif
 	_group = nullptr;
 	_qPrev = _qNext = nullptr;
+	_qSlot = nullptr;
 	_timeout = -1;
+	_deadline = 0;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -128,7 +349,9 @@ Device::Device(int fd) : _fd(fd) {
 #if defined(SEISCOMP_WIRED_EPOLL) || defined(SEISCOMP_WIRED_KQUEUE)
 	_group = nullptr;
 	_qPrev = _qNext = nullptr;
+	_qSlot = nullptr;
 	_timeout = -1;
+	_deadline = 0;
 #endif
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -195,6 +418,41 @@ bool Device::setTimeout(int milliseconds) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ssize_t Device::writev(const struct iovec *iov, int iovcnt) {
+	ssize_t total = 0;
+
+	for ( int i = 0; i < iovcnt; ++i ) {
+		if ( !iov[i].iov_len ) continue;
+
+		ssize_t written = write(static_cast<const char*>(iov[i].iov_base),
+		                        iov[i].iov_len);
+		if ( written <= 0 )
+			return total > 0 ? total : written;
+
+		total += written;
+
+		if ( static_cast<size_t>(written) < iov[i].iov_len )
+			break;
+	}
+
+	return total;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ssize_t Device::sendfile(int, off_t *, size_t) {
+	errno = ENOSYS;
+	return -1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Device::Status Device::setNonBlocking(bool nb) {
 	if ( !isValid() )
@@ -241,18 +499,255 @@ int Device::fd() const {
 
 
 
+#ifdef SEISCOMP_WIRED_IOURING
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * @brief Polls the devices of a group with io_uring. Each device has at
+ *        most one pending poll request. Completed requests are rearmed
+ *        with the next wait, which results in level triggered
+ *        semantics. Modifications from other threads than the one which
+ *        waits are submitted immediately, similar to epoll_ctl.
+ */
+struct DeviceGroup::URingPoller {
+	struct PollState {
+		int      fd{-1};
+		bool     isDevice{false};
+		bool     dirty{false};
+		uint64_t token{0};
+		uint32_t armed{0};
+	};
+
+	typedef unordered_map<void*, PollState> States;
+	typedef unordered_map<uint64_t, void*> Tokens;
+
+	bool open() {
+		return _ring.open(256);
+	}
+
+	void add(void *key, int fd, bool isDevice) {
+		unique_lock<mutex> l(_mutex);
+		PollState &state = _states[key];
+		state.fd = fd;
+		state.isDevice = isDevice;
+		markDirty(key, state);
+		commit(l);
+	}
+
+	void update(void *key) {
+		unique_lock<mutex> l(_mutex);
+		auto it = _states.find(key);
+		if ( it == _states.end() ) return;
+		markDirty(key, it->second);
+		commit(l);
+	}
+
+	void remove(void *key) {
+		unique_lock<mutex> l(_mutex);
+		auto it = _states.find(key);
+		if ( it == _states.end() ) return;
+		disarm(it->second);
+		_states.erase(it);
+		_ring.publish();
+		commit(l);
+	}
+
+	int wait(struct epoll_event *events, int maxEvents, int timeout) {
+		unsigned minComplete = 1;
+
+		{
+			lock_guard<mutex> l(_mutex);
+			_owner = this_thread::get_id();
+			flush();
+			// Do not block if completions are still queued
+			if ( _ring.peek() ) minComplete = 0;
+		}
+
+		int ret = _ring.enter(minComplete, timeout);
+		if ( (ret < 0) && (errno != ETIME) && (errno != EINTR) )
+			return -1;
+
+		int err = ret < 0 ? errno : 0;
+		int count = 0;
+
+		lock_guard<mutex> l(_mutex);
+		struct io_uring_cqe *cqe;
+		while ( (count < maxEvents) && (cqe = _ring.peek()) ) {
+			uint64_t token = cqe->user_data;
+			int res = cqe->res;
+			_ring.seen();
+
+			auto it = _tokens.find(token);
+			// Removal requests and stale requests of removed devices
+			if ( it == _tokens.end() ) continue;
+
+			void *key = it->second;
+			_tokens.erase(it);
+
+			auto sit = _states.find(key);
+			if ( sit == _states.end() ) continue;
+
+			// The poll request is finished, rearm it with the next wait
+			sit->second.token = 0;
+			sit->second.armed = 0;
+			markDirty(key, sit->second);
+
+			if ( res == -ECANCELED ) continue;
+
+			events[count].events = res < 0 ? EPOLLERR : static_cast<uint32_t>(res);
+			events[count].data.ptr = key;
+			++count;
+		}
+
+		if ( !count && (err == EINTR) ) {
+			errno = EINTR;
+			return -1;
+		}
+
+		return count;
+	}
+
+	private:
+		void markDirty(void *key, PollState &state) {
+			if ( state.dirty ) return;
+			state.dirty = true;
+			_dirty.push_back(key);
+		}
+
+		//! Submits pending changes immediately if not called from the
+		//! waiting thread. Must be called with the lock held.
+		void commit(unique_lock<mutex> &l) {
+			if ( _owner == thread::id() || _owner == this_thread::get_id() )
+				return;
+			flush();
+			l.unlock();
+			_ring.enter(0, -1);
+		}
+
+		struct io_uring_sqe *sqe() {
+			struct io_uring_sqe *entry = _ring.sqe();
+			if ( !entry ) {
+				// Submission queue is full, submit what we have
+				_ring.publish();
+				_ring.enter(0, -1);
+				entry = _ring.sqe();
+			}
+			return entry;
+		}
+
+		void disarm(PollState &state) {
+			if ( !state.token ) return;
+
+			struct io_uring_sqe *entry = sqe();
+			if ( entry ) {
+				entry->opcode = IORING_OP_POLL_REMOVE;
+				entry->fd = -1;
+				entry->addr = state.token;
+				entry->user_data = 0;
+			}
+
+			_tokens.erase(state.token);
+			state.token = 0;
+			state.armed = 0;
+		}
+
+		void flush() {
+			for ( void *key : _dirty ) {
+				auto it = _states.find(key);
+				if ( it == _states.end() ) continue;
+
+				PollState &state = it->second;
+				if ( !state.dirty ) continue;
+				state.dirty = false;
+
+				uint32_t mask = POLLIN;
+
+				if ( state.isDevice ) {
+					Device *dev = static_cast<Device*>(key);
+					if ( !dev->isValid() || (dev->selectMode() & Device::Closed) )
+						mask = 0;
+					else {
+						mask = POLLPRI | POLLRDHUP;
+						if ( dev->selectMode() & Device::Read ) mask |= POLLIN;
+						if ( dev->selectMode() & Device::Write ) mask |= POLLOUT;
+					}
+				}
+
+				if ( state.token && (state.armed == mask) ) continue;
+
+				disarm(state);
+
+				if ( !mask || (state.fd < 0) ) continue;
+
+				struct io_uring_sqe *entry = sqe();
+				if ( !entry ) {
+					SEISCOMP_ERROR("[reactor] io_uring submission queue overflow");
+					continue;
+				}
+
+				entry->opcode = IORING_OP_POLL_ADD;
+				entry->fd = state.fd;
+				entry->poll32_events = mask;
+				entry->user_data = ++_nextToken;
+
+				state.token = _nextToken;
+				state.armed = mask;
+				_tokens[state.token] = key;
+			}
+
+			_dirty.clear();
+			_ring.publish();
+		}
+
+	private:
+		IOURing        _ring;
+		mutex          _mutex;
+		thread::id     _owner;
+		States         _states;
+		Tokens         _tokens;
+		vector<void*>  _dirty;
+		uint64_t       _nextToken{0};
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+#endif
+
+
+
+
+namespace {
+
+
+DeviceGroup::Backend defaultDeviceGroupBackend = DeviceGroup::NativeBackend;
+
+
+}
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DeviceGroup::DeviceGroup() {
 	_interrupt_read_fd = _interrupt_write_fd = -1;
 	_timerFd = -1;
 	_timerSingleShot = false;
-	_queue = nullptr;
+	memset(_wheel, 0, sizeof(_wheel));
+	memset(_wheelMask, 0, sizeof(_wheelMask));
+	_wheelTime = monotonicMs();
+	_wheelCount = 0;
+	_expired = nullptr;
 	_isInSelect = false;
 	_triggerMode = LevelTriggered;
+	_backend = defaultDeviceGroupBackend;
 #ifdef SEISCOMP_WIRED_EPOLL
 	_epoll_fd = -1;
 	_defaultOps = EPOLLPRI | EPOLLRDHUP;
 #endif
+#ifdef SEISCOMP_WIRED_IOURING
+	_uring = nullptr;
+#endif
 #ifdef SEISCOMP_WIRED_KQUEUE
 	_kqueue_fd = -1;
 	_defaultOps = 0;
@@ -270,6 +765,12 @@ DeviceGroup::DeviceGroup() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 DeviceGroup::~DeviceGroup() {
+#ifdef SEISCOMP_WIRED_IOURING
+	if ( _uring ) {
+		delete _uring;
+		_uring = nullptr;
+	}
+#endif
 #ifdef SEISCOMP_WIRED_EPOLL
 	if ( _epoll_fd > 0 ) {
 		::close(_epoll_fd);
@@ -337,6 +838,59 @@ DeviceGroup::TriggerMode DeviceGroup::triggerMode() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DeviceGroup::setBackend(Backend backend) {
+#ifndef SEISCOMP_WIRED_IOURING
+	if ( backend == IOURingBackend ) return false;
+#endif
+	if ( isValid() ) {
+		SEISCOMP_ERROR("[reactor] cannot change backend after setup");
+		return false;
+	}
+
+	_backend = backend;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DeviceGroup::Backend DeviceGroup::backend() const {
+#ifdef SEISCOMP_WIRED_IOURING
+	// Report the backend which is actually used after setup
+	if ( isValid() ) return _uring ? IOURingBackend : NativeBackend;
+#endif
+	return _backend;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool DeviceGroup::setDefaultBackend(Backend backend) {
+#ifndef SEISCOMP_WIRED_IOURING
+	if ( backend == IOURingBackend ) return false;
+#endif
+	defaultDeviceGroupBackend = backend;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+DeviceGroup::Backend DeviceGroup::defaultBackend() {
+	return defaultDeviceGroupBackend;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool DeviceGroup::isValid() const {
 #ifdef SEISCOMP_WIRED_EPOLL
@@ -368,6 +922,17 @@ bool DeviceGroup::setup() {
 			SEISCOMP_ERROR("epoll_create: %d: %s", errno, strerror(errno));
 			return false;
 		}
+	#ifdef SEISCOMP_WIRED_IOURING
+		if ( _backend == IOURingBackend ) {
+			_uring = new URingPoller;
+			if ( !_uring->open() ) {
+				SEISCOMP_WARNING("[reactor] io_uring not available, fall back to epoll: %d: %s",
+				                 errno, strerror(errno));
+				delete _uring;
+				_uring = nullptr;
+			}
+		}
+	#endif
 #endif
 #ifdef SEISCOMP_WIRED_KQUEUE
 	if ( _kqueue_fd > 0 ) {
@@ -402,6 +967,11 @@ bool DeviceGroup::setup() {
 			return false;
 		}
 #endif
+#ifdef SEISCOMP_WIRED_IOURING
+		if ( _uring )
+			_uring->add(nullptr, _interrupt_read_fd, false);
+		else {
+#endif
 #ifdef SEISCOMP_WIRED_EPOLL
 
 		struct epoll_event ev;
@@ -412,6 +982,9 @@ bool DeviceGroup::setup() {
 			return false;
 		}
 #endif
+#ifdef SEISCOMP_WIRED_IOURING
+		}
+#endif
 #ifdef SEISCOMP_WIRED_KQUEUE
 
 		struct kevent ev;
@@ -444,6 +1017,12 @@ bool DeviceGroup::append(Device *dev) {
 
 	if ( dev->_timeout >= 0 ) applyTimeout(dev);
 
+	#ifdef SEISCOMP_WIRED_IOURING
+	// The poll request is armed with the following state update
+	if ( _uring )
+		_uring->add(dev, dev->fd(), true);
+	else {
+	#endif
 	struct epoll_event ev;
 	ev.events = _defaultOps;
 	ev.data.ptr = dev;
@@ -453,6 +1032,9 @@ bool DeviceGroup::append(Device *dev) {
 		SEISCOMP_ERROR("epoll_add2(%d, %d): %d: %s", _epoll_fd, dev->fd(), errno, strerror(errno));
 		return false;
 	}
+	#ifdef SEISCOMP_WIRED_IOURING
+	}
+	#endif
 
 	//SEISCOMP_DEBUG("Adding device to group");
 	++_count;
@@ -525,6 +1107,11 @@ bool DeviceGroup::remove(Device *s) {
 
 	s->_group = nullptr;
 
+#ifdef SEISCOMP_WIRED_IOURING
+	if ( _uring )
+		_uring->remove(s);
+	else
+#endif
 #ifdef SEISCOMP_WIRED_EPOLL
 	if ( _epoll_fd > 0 && s->isValid() ) {
 		// Create a dummy event pointer for kernel version < 2.6.9
@@ -559,8 +1146,7 @@ bool DeviceGroup::remove(Device *s) {
 #endif
 	// Remove from queue
 	//cout << "Remove device " << s << " completely" << endl;
-	if ( _nextQueue == s ) _nextQueue = _nextQueue->_qNext;
-	if ( s->_qPrev || s->_qNext || s == _queue )
+	if ( s->_qSlot )
 		removeFromQueue(s);
 
 	return true;
@@ -575,6 +1161,12 @@ void DeviceGroup::clear() {
 #if defined(SEISCOMP_WIRED_EPOLL) || defined(SEISCOMP_WIRED_KQUEUE)
 	_count = 0;
 	_selectIndex = _selectSize = 0;
+	#ifdef SEISCOMP_WIRED_IOURING
+	if ( _uring ) {
+		delete _uring;
+		_uring = nullptr;
+	}
+	#endif
 	#ifdef SEISCOMP_WIRED_EPOLL
 	if ( _epoll_fd > 0 ) {
 		::close(_epoll_fd);
@@ -626,6 +1218,11 @@ bool DeviceGroup::setTimer(uint32_t seconds, uint32_t milliseconds, TimeoutFunc
 			return false;
 		}
 
+	#ifdef SEISCOMP_WIRED_IOURING
+		if ( _uring )
+			_uring->add(&_timerFd, _timerFd, false);
+		else {
+	#endif
 		// Add timer to epoll
 		struct epoll_event ev;
 		ev.events = _defaultOps | EPOLLIN;
@@ -638,6 +1235,9 @@ bool DeviceGroup::setTimer(uint32_t seconds, uint32_t milliseconds, TimeoutFunc
 			_timerFd = -1;
 			return false;
 		}
+	#ifdef SEISCOMP_WIRED_IOURING
+		}
+	#endif
 	}
 
 	if ( _timerFd > 0 ) {
@@ -722,11 +1322,21 @@ bool DeviceGroup::clearTimer() {
 		}
 #endif
 
+#ifdef SEISCOMP_WIRED_IOURING
+		if ( _uring )
+			_uring->remove(&_timerFd);
+		else {
+#endif
 #ifdef SEISCOMP_WIRED_EPOLL
 		struct epoll_event ev;
 		if ( epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, _timerFd, &ev) == -1 )
 			SEISCOMP_WARNING("epoll_del(%d): %d: %s",
 			                 _timerFd, errno, strerror(errno));
+#endif
+#ifdef SEISCOMP_WIRED_IOURING
+		}
+#endif
+#ifdef SEISCOMP_WIRED_EPOLL
 		::close(_timerFd);
 #endif
 #ifdef SEISCOMP_WIRED_KQUEUE
@@ -804,12 +1414,13 @@ Device *DeviceGroup::wait() {
 	struct timespec *ts_timeout_used = nullptr;
 #endif
 	int timeout = -1;
-	struct timeval tv_start;
 
 	// Compute current timeout
-	if ( _queue ) {
-		gettimeofday(&tv_start, nullptr);
-		timeout = _queue->_ticker;
+	int64_t nextEvent = nextWheelEvent();
+	if ( nextEvent >= 0 ) {
+		timeout = static_cast<int>(
+			min(max(nextEvent - monotonicMs(), int64_t(0)), int64_t(INT_MAX))
+		);
 #ifdef SEISCOMP_WIRED_KQUEUE
 		// Convert scalar milliseconds to timespec structure
 		ts_timeout.tv_sec = timeout / 1000;
@@ -819,7 +1430,12 @@ Device *DeviceGroup::wait() {
 		//SEISCOMP_DEBUG("[reactor] set wait timeout: %d ms", timeout);
 	}
 
-#ifdef SEISCOMP_WIRED_EPOLL
+#ifdef SEISCOMP_WIRED_IOURING
+	int nfds = _uring ?
+		_uring->wait(_epoll_events, SEISCOMP_WIRED_EPOLL_EVENT_BUFFER, timeout)
+		:
+		epoll_wait(_epoll_fd, _epoll_events, SEISCOMP_WIRED_EPOLL_EVENT_BUFFER, timeout);
+#elif defined(SEISCOMP_WIRED_EPOLL)
 	int nfds = epoll_wait(_epoll_fd, _epoll_events, SEISCOMP_WIRED_EPOLL_EVENT_BUFFER, timeout);
 #endif
 #ifdef SEISCOMP_WIRED_KQUEUE
@@ -831,20 +1447,9 @@ Device *DeviceGroup::wait() {
 		//SEISCOMP_ERROR("[reactor] wait: %d: %s", errno, strerror(errno));
 		return nullptr;
 	}
-	// timeout?
-	else if ( nfds == 0 && timeout >= 0 ) {
-		_lastCallDuration = timeout;
-		//SEISCOMP_DEBUG("[reactor] timeout expired");
-	}
-	else if ( _queue ) {
-		struct timeval tv_end;
-		gettimeofday(&tv_end, nullptr);
-		int ms = tv_sub_ms(&tv_end, &tv_start);
-		_lastCallDuration = ms;
-		//SEISCOMP_DEBUG("[reactor] last call took %d ms", _lastCallDuration);
-	}
 
-	_nextQueue = _queue;
+	if ( _wheelCount )
+		advanceWheel(monotonicMs());
 
 #if defined(SEISCOMP_WIRED_EPOLL) || defined(SEISCOMP_WIRED_KQUEUE)
 	_selectIndex = 0;
@@ -854,10 +1459,10 @@ Device *DeviceGroup::wait() {
 
 	/*
 	{
-		Device *it = _queue;
-		if ( it ) cout << "device event queue:" << endl;
+		Device *it = _expired;
+		if ( it ) cout << "expired devices:" << endl;
 		while ( it ) {
-			cout << " " << it << "  " << it->_ticker << "  " << it->_qPrev << "  " << it->_qNext << endl;
+			cout << " " << it << "  " << it->_deadline << "  " << it->_qPrev << "  " << it->_qNext << endl;
 			if ( it == it->_qNext ) {
 				cout << " !this == next" << endl;
 				break;
@@ -876,41 +1481,34 @@ Device *DeviceGroup::wait() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Device *DeviceGroup::next() {
-	// First check the queued devices for timeouts
-	while ( _nextQueue ) {
-		_nextQueue->_ticker -= _lastCallDuration;
-		//SEISCOMP_DEBUG("[reactor] remaining ticker: %d ms", _nextQueue->_ticker);
-		if ( _nextQueue->_ticker <= 0 ) {
-			SEISCOMP_DEBUG("[reactor] device %p timed out", static_cast<void*>(_nextQueue));
-			Device *dev = _nextQueue;
-			_nextQueue = _nextQueue->_qNext;
-
-			bool hasTrigger = false;
-			removeFromQueue(dev);
+	// First return the devices which have timed out
+	while ( _expired ) {
+		Device *dev = _expired;
+		SEISCOMP_DEBUG("[reactor] device %p timed out", static_cast<void*>(dev));
+
+		bool hasTrigger = false;
+		removeFromQueue(dev);
 
-			for ( size_t i = 0; i < _selectSize; ++ i ) {
+		for ( size_t i = _selectIndex; i < _selectSize; ++ i ) {
 #ifdef SEISCOMP_WIRED_EPOLL
-				if ( _epoll_events[_selectIndex].data.ptr == dev ) {
+			if ( _epoll_events[i].data.ptr == dev ) {
 #endif
 #ifdef SEISCOMP_WIRED_KQUEUE
-				if ( _kqueue_events[_selectIndex].udata == dev ) {
+			if ( _kqueue_events[i].udata == dev ) {
 #endif
-					hasTrigger = true;
-					break;
-				}
+				hasTrigger = true;
+				break;
 			}
+		}
 
-			// Only return this device if it is not part of the
-			// event list. Otherwise the iteration below will return it.
-			if ( !hasTrigger ) {
-				_readyForRead = false;
-				_readyForWrite = false;
-				_timedOut = true;
-				return dev;
-			}
+		// Only return this device if it is not part of the
+		// event list. Otherwise the iteration below will return it.
+		if ( !hasTrigger ) {
+			_readyForRead = false;
+			_readyForWrite = false;
+			_timedOut = true;
+			return dev;
 		}
-		else
-			_nextQueue = _nextQueue->_qNext;
 	}
 
 	_timedOut = false;
@@ -1020,12 +1618,21 @@ void DeviceGroup::removeFromQueue(Device *d) {
 	if ( d->_qPrev )
 		d->_qPrev->_qNext = d->_qNext;
 	else
-		_queue = d->_qNext;
+		*d->_qSlot = d->_qNext;
 
 	if ( d->_qNext )
 		d->_qNext->_qPrev = d->_qPrev;
 
+	if ( d->_qSlot != &_expired ) {
+		--_wheelCount;
+		if ( !*d->_qSlot ) {
+			size_t index = static_cast<size_t>(d->_qSlot - &_wheel[0][0]);
+			_wheelMask[index / WheelSlots] &= ~(uint64_t(1) << (index % WheelSlots));
+		}
+	}
+
 	d->_qPrev = d->_qNext = nullptr;
+	d->_qSlot = nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1033,100 +1640,115 @@ void DeviceGroup::removeFromQueue(Device *d) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void DeviceGroup::applyTimeout(Device *d) {
-	// Reset ticker
-	d->_ticker = d->_timeout;
-	//SEISCOMP_DEBUG("[reactor] set timeout to %dms for fd %d", d->_timeout, d->_fd);
+void DeviceGroup::linkToQueue(Device *d, Device **head) {
+	d->_qPrev = nullptr;
+	d->_qNext = *head;
+	if ( d->_qNext )
+		d->_qNext->_qPrev = d;
+	*head = d;
+	d->_qSlot = head;
+
+	if ( head != &_expired ) {
+		++_wheelCount;
+		size_t index = static_cast<size_t>(head - &_wheel[0][0]);
+		_wheelMask[index / WheelSlots] |= uint64_t(1) << (index % WheelSlots);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-	//cout << "Find new position for " << d << "  " << d->_ticker << "  " << d->_qPrev << "  " << d->_qNext << endl;
 
-	// Device already queued?
-	if ( _queue && (d->_qNext || d->_qPrev || _queue == d) ) {
-		//cout << " - already queued" << endl;
 
-		if ( d->_timeout >= 0 ) {
-			// Update timeout and find the new position for d
-			// Move d towards the front
-			if ( d->_qPrev && (d->_qPrev->_ticker > d->_ticker) ) {
-				//cout << " - move to front" << endl;
 
-				Device *pos = d->_qPrev;
-				while ( pos->_qPrev && (pos->_qPrev->_ticker > d->_ticker) )
-					pos = pos->_qPrev;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DeviceGroup::insertIntoWheel(Device *d) {
+	int64_t deadline = max(d->_deadline, _wheelTime);
+	int64_t delta = deadline - _wheelTime;
+
+	int level = 0;
+	while ( level < WheelLevels - 1 && delta >= (int64_t(1) << (WheelBits * (level + 1))) )
+		++level;
+
+	// Timeouts beyond the range of the wheel are put into the last slot
+	// of the highest level and sorted in again when it is reached
+	int64_t range = int64_t(1) << (WheelBits * WheelLevels);
+	if ( delta >= range )
+		deadline = _wheelTime + range - 1;
+
+	int slot = static_cast<int>((deadline >> (WheelBits * level)) & (WheelSlots - 1));
+	linkToQueue(d, &_wheel[level][slot]);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-				// Insert item before pos
-				// First: remove it from its current position
-				removeFromQueue(d);
 
-				// Insert it into the new position
-				d->_qPrev = pos->_qPrev;
-				d->_qNext = pos;
-				if ( d->_qPrev )
-					d->_qPrev->_qNext = d;
-				else
-					_queue = d;
 
-				pos->_qPrev = d;
-			}
-			// Move d towards the back
-			else if ( d->_qNext && (d->_ticker > d->_qNext->_ticker) ) {
-				//cout << " - move to back" << endl;
 
-				Device *pos = d->_qNext;
-				while ( pos->_qNext && (d->_ticker > pos->_qNext->_ticker) )
-					pos = pos->_qNext;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int64_t DeviceGroup::nextWheelEvent() const {
+	if ( !_wheelCount )
+		return -1;
 
-				// Insert item after pos
-				// First: remove it from its current position
-				removeFromQueue(d);
+	int64_t next = -1;
 
-				// Insert it into the new position
-				d->_qPrev = pos;
-				d->_qNext = pos->_qNext;
-				if ( d->_qNext )
-					d->_qNext->_qPrev = d;
-				pos->_qNext = d;
-			}
-		}
-		else {
-			// Remove d from queue
-			removeFromQueue(d);
-		}
+	// The slots of the first level hold the devices of the next 64 ms
+	// starting with the slot of the current time
+	if ( _wheelMask[0] ) {
+		int offset = static_cast<int>(_wheelTime & (WheelSlots - 1));
+		next = _wheelTime + firstSlot(_wheelMask[0], offset);
 	}
-	else if ( d->_timeout >= 0 ) {
-		//cout << " - add to queue" << endl;
 
-		// Add it to the queue and find the correct position
-		if ( !_queue ) {
-			_queue = d;
-			d->_qPrev = d->_qNext = nullptr;
-		}
-		else {
-			Device *pos = _queue;
-			Device *last = nullptr;
-
-			while ( pos ) {
-				if ( pos->_ticker > d->_ticker ) {
-					// Found position
-					d->_qNext = pos;
-					d->_qPrev = pos->_qPrev;
-					pos->_qPrev = d;
-					if ( d->_qPrev ) d->_qPrev->_qNext = d;
-					// Update head
-					if ( pos == _queue ) _queue = d;
-					// Done
-					return;
-				}
+	// The slots of the higher levels are sorted in when the time reaches
+	// their start which can be before the next device of the first level
+	// times out
+	for ( int level = 1; level < WheelLevels; ++level ) {
+		if ( !_wheelMask[level] ) continue;
+
+		int shift = WheelBits * level;
+		int64_t start = ((_wheelTime >> shift) + 1) << shift;
+		int offset = static_cast<int>((start >> shift) & (WheelSlots - 1));
+		int64_t t = start + (int64_t(firstSlot(_wheelMask[level], offset)) << shift);
+		if ( next < 0 || t < next ) next = t;
+	}
+
+	return next;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 
-				last = pos;
-				pos = pos->_qNext;
-			}
 
-			// Push it to the back of the queue
-			if ( last ) {
-				d->_qNext = last->_qNext;
-				d->_qPrev = last;
-				last->_qNext = d;
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DeviceGroup::advanceWheel(int64_t now) {
+	while ( _wheelTime <= now ) {
+		// Expire the devices of the current slot
+		Device **head = &_wheel[0][_wheelTime & (WheelSlots - 1)];
+		while ( *head ) {
+			Device *d = *head;
+			removeFromQueue(d);
+			linkToQueue(d, &_expired);
+		}
+
+		// Skip the time without any pending events
+		int64_t next = nextWheelEvent();
+		if ( next < 0 || next > now ) {
+			_wheelTime = now + 1;
+			if ( next != _wheelTime ) break;
+		}
+		else
+			_wheelTime = next;
+
+		// Sort in the devices of the higher levels whose slots start now,
+		// from the highest level down
+		int level = 1;
+		while ( level < WheelLevels && !(_wheelTime & ((int64_t(1) << (WheelBits * level)) - 1)) )
+			++level;
+
+		for ( --level; level > 0; --level ) {
+			int shift = WheelBits * level;
+			head = &_wheel[level][(_wheelTime >> shift) & (WheelSlots - 1)];
+			while ( *head ) {
+				Device *d = *head;
+				removeFromQueue(d);
+				insertIntoWheel(d);
 			}
 		}
 	}
@@ -1136,6 +1758,29 @@ void DeviceGroup::applyTimeout(Device *d) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void DeviceGroup::applyTimeout(Device *d) {
+	if ( d->_qSlot )
+		removeFromQueue(d);
+
+	if ( d->_timeout < 0 )
+		return;
+
+	int64_t now = monotonicMs();
+
+	// Nothing needs to be processed in an empty wheel, let it catch up
+	if ( !_wheelCount && _wheelTime < now )
+		_wheelTime = now;
+
+	d->_deadline = now + d->_timeout;
+	//SEISCOMP_DEBUG("[reactor] set timeout to %dms for fd %d", d->_timeout, d->_fd);
+	insertIntoWheel(d);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void DeviceGroup::updateState(Device *dev) {
 #ifdef SEISCOMP_WIRED_EPOLL
@@ -1208,6 +1853,11 @@ void DeviceGroup::updateState(Device *dev) {
 	}
 
 	if ( sm & Device::Closed ) {
+#ifdef SEISCOMP_WIRED_IOURING
+		if ( _uring )
+			_uring->update(dev);
+		else
+#endif
 #ifdef SEISCOMP_WIRED_EPOLL
 		if ( epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, dev->fd(), &ev) == -1 )
 			SEISCOMP_ERROR("epoll_del(%d): %d: %s", dev->fd(), errno, strerror(errno));
@@ -1229,10 +1879,13 @@ void DeviceGroup::updateState(Device *dev) {
 			SEISCOMP_ERROR("kqueue del(%d): %d: %s", dev->fd(), errno, strerror(errno));
 #endif
 		// Remove device from queue
-		if ( _nextQueue == dev ) _nextQueue = _nextQueue->_qNext;
-		if ( dev->_qPrev || dev->_qNext || dev == _queue )
+		if ( dev->_qSlot )
 			removeFromQueue(dev);
 	}
+#ifdef SEISCOMP_WIRED_IOURING
+	else if ( _uring )
+		_uring->update(dev);
+#endif
 #ifdef SEISCOMP_WIRED_EPOLL
 	else if ( epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, dev->fd(), &ev) == -1 )
 		SEISCOMP_ERROR("epoll_mod(%d): %d: %s", dev->fd(), errno, strerror(errno));
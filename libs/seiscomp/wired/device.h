@@ -32,6 +32,10 @@
 	#error "Require either epoll or kqueue support"
 #endif
 
+#if defined(SEISCOMP_WIRED_EPOLL) && defined(SC_HAS_IOURING)
+	#define SEISCOMP_WIRED_IOURING
+#endif
+
 #ifdef SEISCOMP_WIRED_EPOLL
   #ifndef WIN32
     #include <sys/epoll.h>
@@ -44,6 +48,16 @@
 
 #include <seiscomp/core/baseobject.h>
 
+#include <sys/types.h>
+#ifndef WIN32
+  #include <sys/uio.h>
+#else
+struct iovec {
+	void   *iov_base;
+	size_t  iov_len;
+};
+#endif
+
 #include <list>
 #include <stdint.h>
 #include <functional>
@@ -149,6 +163,35 @@ class SC_SYSTEM_CORE_API Device : public Core::BaseObject {
 		virtual ssize_t write(const char *data, size_t len) = 0;
 		virtual ssize_t read(char *data, size_t len) = 0;
 
+		/**
+		 * @brief Writes a sequence of buffers with as few calls as possible
+		 *        (scatter-gather).
+		 *
+		 * The default implementation calls write for each buffer and stops
+		 * if a buffer could not be written completely. Devices which
+		 * support vectored I/O should reimplement this method.
+		 * @param iov The buffers to be written
+		 * @param iovcnt The number of buffers
+		 * @return The number of bytes written or the result of the first
+		 *         failed write
+		 */
+		virtual ssize_t writev(const struct iovec *iov, int iovcnt);
+
+		/**
+		 * @brief Writes data from a file descriptor without copying it
+		 *        through user space.
+		 *
+		 * The default implementation does not support that and sets errno
+		 * to ENOSYS.
+		 * @param fd The file descriptor to read from
+		 * @param offset The file offset to start reading from. It is
+		 *               updated to the offset following the last byte
+		 *               written.
+		 * @param count The maximum number of bytes to be written
+		 * @return The number of bytes written or -1 on error
+		 */
+		virtual ssize_t sendfile(int fd, off_t *offset, size_t count);
+
 		/**
 		 * @brief Returns the current file descriptor and sets the internal
 		 *        file descriptor to invalid
@@ -178,10 +221,12 @@ class SC_SYSTEM_CORE_API Device : public Core::BaseObject {
 		DeviceGroup   *_group;  //<! The group the device is part of
 		Device        *_qPrev;  //<! The prev pointer used by intrusive list
 		Device        *_qNext;  //<! The next pointer used by intrusive list
+		Device       **_qSlot;  //<! The head of the list the device is part of
 		// Store timeout in milliseconds.
 		// A negative value means no timeout.
 		int            _timeout;
-		int            _ticker;
+		// The monotonic time in milliseconds when the timeout expires
+		int64_t        _deadline;
 
 	friend class DeviceGroup;
 };
@@ -202,6 +247,19 @@ class SC_SYSTEM_CORE_API DeviceGroup : public Core::BaseObject {
 			LevelTriggered
 		};
 
+		/**
+		 * @brief The Backend enum defines the mechanism used to wait for
+		 *        device events. NativeBackend is either epoll or kqueue.
+		 *        IOURingBackend polls the devices via io_uring and submits
+		 *        all changes of the requested events together with the
+		 *        wait with one system call. It is only available on Linux
+		 *        and falls back to epoll if io_uring cannot be initialized.
+		 */
+		enum Backend {
+			NativeBackend,
+			IOURingBackend
+		};
+
 		typedef std::function<void ()> TimeoutFunc;
 
 
@@ -266,6 +324,20 @@ class SC_SYSTEM_CORE_API DeviceGroup : public Core::BaseObject {
 		bool setTriggerMode(TriggerMode);
 		TriggerMode triggerMode() const;
 
+		//! Sets the backend of this group. This must be called before the
+		//! group is set up and returns false if the backend is not
+		//! supported by this build.
+		bool setBackend(Backend);
+
+		//! Returns the backend in use. Before setup this is the requested
+		//! backend.
+		Backend backend() const;
+
+		//! Sets the backend of all groups created afterwards. The default
+		//! is NativeBackend.
+		static bool setDefaultBackend(Backend);
+		static Backend defaultBackend();
+
 
 	// ----------------------------------------------------------------------
 	//  Private interface
@@ -274,6 +346,15 @@ class SC_SYSTEM_CORE_API DeviceGroup : public Core::BaseObject {
 		void applyTimeout(Device *d);
 		void removeFromQueue(Device *d);
 
+		void linkToQueue(Device *d, Device **head);
+		void insertIntoWheel(Device *d);
+		//! Returns the next time the wheel must be advanced to or -1 if
+		//! no timeout is pending
+		int64_t nextWheelEvent() const;
+		//! Moves all devices which have timed out until now to the
+		//! expired list
+		void advanceWheel(int64_t now);
+
 		void updateState(Device *);
 
 
@@ -282,6 +363,7 @@ class SC_SYSTEM_CORE_API DeviceGroup : public Core::BaseObject {
 	// ----------------------------------------------------------------------
 	private:
 		TriggerMode          _triggerMode;
+		Backend              _backend;
 		bool                 _readyForRead;
 		bool                 _readyForWrite;
 		bool                 _timedOut;
@@ -313,9 +395,28 @@ class SC_SYSTEM_CORE_API DeviceGroup : public Core::BaseObject {
 		size_t               _selectIndex;
 		size_t               _selectSize;
 #endif
-		int                  _lastCallDuration;
-		Device              *_queue;
-		Device              *_nextQueue;
+#ifdef SEISCOMP_WIRED_IOURING
+		struct URingPoller;
+		URingPoller         *_uring;
+#endif
+
+		// The device timeouts are kept in a hierarchical timer wheel with
+		// a resolution of one millisecond. Each level has 64 slots and
+		// covers 64 times the range of the level below. Devices of a
+		// higher level are moved down when their slot is reached. Arming
+		// and cancelling a timeout is O(1).
+		static const int     WheelLevels = 5;
+		static const int     WheelBits = 6;
+		static const int     WheelSlots = 1 << WheelBits;
+
+		Device              *_wheel[WheelLevels][WheelSlots];
+		//! The non-empty slots per level
+		uint64_t             _wheelMask[WheelLevels];
+		//! The time of the wheel which has not yet been processed
+		int64_t              _wheelTime;
+		size_t               _wheelCount;
+		//! The devices which have timed out and are not yet returned
+		Device              *_expired;
 
 	friend class Device;
 };
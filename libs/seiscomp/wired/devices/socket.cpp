@@ -27,6 +27,7 @@
 #include <arpa/inet.h>
 #ifndef WIN32
 #include <sys/socket.h>
+#include <sys/un.h>
 #ifdef BSD
 #include <netinet/in.h>
 #include <netinet/ip.h>
@@ -34,6 +35,9 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <netinet/tcp.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 #else
 #include <io.h>
 #include <winsock2.h>
@@ -744,6 +748,63 @@ Socket::Status Socket::connectV6(const std::string &hostname, port_t port) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Socket::Status Socket::connectLocal(const std::string &path) {
+#ifndef WIN32
+	if ( _fd != -1 ) {
+		SEISCOMP_WARNING("closing stale socket");
+		this->close();
+	}
+
+	struct sockaddr_un addr;
+
+	if ( path.empty() || path.size() >= sizeof(addr.sun_path) )
+		return InvalidAddress;
+
+	setMode(Idle);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, path.data(), path.size());
+
+	if ( (_fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ) {
+		SEISCOMP_DEBUG("Socket::connectLocal(%s): %s",
+		               path.c_str(), strerror(errno));
+		return AllocationError;
+	}
+
+	setNonBlocking(_flags & NonBlocking ? true : false);
+
+	if ( _timeOutSecs >= 0 ) {
+		if ( applySocketTimeout(_timeOutSecs, _timeOutUsecs) != Success ) {
+			this->close();
+			return Error;
+		}
+	}
+
+	if ( ::connect(_fd, reinterpret_cast<const struct sockaddr *>(&addr), sizeof(addr)) == -1 ) {
+		if ( errno != EINPROGRESS ) {
+			SEISCOMP_DEBUG("Socket::connectLocal(%s): %s",
+			               path.c_str(), strerror(errno));
+			this->close();
+			return errno == ETIMEDOUT?Timeout:ConnectError;
+		}
+	}
+
+	_hostname = "localhost";
+	_addr.set(127, 0, 0, 1);
+	_port = 0;
+
+	return Success;
+#else
+	return NotSupported;
+#endif
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Socket::Status Socket::bind(IPAddress ip, port_t port) {
 	struct sockaddr_in addr;
@@ -862,6 +923,48 @@ Socket::Status Socket::bindV6(IPAddress ip, port_t port) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Socket::Status Socket::bindLocal(const std::string &path) {
+#ifndef WIN32
+	struct sockaddr_un addr;
+
+	if ( path.empty() || path.size() >= sizeof(addr.sun_path) )
+		return InvalidAddress;
+
+	_port = 0;
+	_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	// AllocationError
+	if ( _fd == -1 ) return AllocationError;
+
+	setNonBlocking(_flags & NonBlocking ? true : false);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, path.data(), path.size());
+
+	// Remove a stale socket file of a previous instance
+	unlink(path.c_str());
+
+	// BindError
+	if ( ::bind(_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1 ) {
+		SEISCOMP_DEBUG("Bind: %s", strerror(errno));
+		close();
+		return BindError;
+	}
+
+	_hostname = path;
+
+	return Success;
+#else
+	return NotSupported;
+#endif
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Socket::Status Socket::listen(int backlog) {
 	if ( !isValid() ) return InvalidSocket;
@@ -881,10 +984,10 @@ Socket::Status Socket::listen(int backlog) {
 Socket *Socket::accept() {
 	if ( !isValid() ) return nullptr;
 
-	struct sockaddr_in addr;
-	socklen_t addr_len = sizeof(addr);
+	struct sockaddr_storage storage;
+	socklen_t addr_len = sizeof(storage);
 
-	int client_fd = ::accept(_fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len);
+	int client_fd = ::accept(_fd, reinterpret_cast<struct sockaddr*>(&storage), &addr_len);
 	// AcceptError
 	if( client_fd < 0 ) {
 		if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) ) {
@@ -897,9 +1000,20 @@ Socket *Socket::accept() {
 	Socket *sock = new Socket;
 	sock->_fd = client_fd;
 
+#ifndef WIN32
+	if ( storage.ss_family == AF_UNIX ) {
+		// Clients of local sockets are reported as loopback connections
+		sock->_addr.set(127, 0, 0, 1);
+		sock->_port = 0;
+		return sock;
+	}
+#endif
+
+	const struct sockaddr_in &addr = reinterpret_cast<const struct sockaddr_in&>(storage);
+
 	char buf[512];
 	if ( (_flags & ResolveName) &&
-	     getnameinfo(reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr), buf, 512, nullptr, 0, 0) == 0 )
+	     getnameinfo(reinterpret_cast<struct sockaddr*>(&storage), sizeof(addr), buf, 512, nullptr, 0, 0) == 0 )
 		sock->_hostname = buf;
 
 	sock->_addr.set(ntohl(addr.sin_addr.s_addr));
@@ -970,6 +1084,48 @@ ssize_t Socket::write(const char *data, size_t len) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ssize_t Socket::writev(const struct iovec *iov, int iovcnt) {
+#ifndef WIN32
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = const_cast<struct iovec*>(iov);
+	msg.msg_iovlen = iovcnt;
+#if !defined(MACOSX)
+	ssize_t sent = ::sendmsg(_fd, &msg, MSG_NOSIGNAL);
+#else
+	ssize_t sent = ::sendmsg(_fd, &msg, 0);
+#endif
+	if ( sent > 0 ) {
+		_bytesSent += static_cast<count_t>(sent);
+	}
+	return sent;
+#else
+	return Device::writev(iov, iovcnt);
+#endif
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ssize_t Socket::sendfile(int fd, off_t *offset, size_t count) {
+#ifdef __linux__
+	ssize_t sent = ::sendfile(_fd, fd, offset, count);
+	if ( sent > 0 ) {
+		_bytesSent += static_cast<count_t>(sent);
+	}
+	return sent;
+#else
+	return Device::sendfile(fd, offset, count);
+#endif
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 ssize_t Socket::read(char *data, size_t len) {
 	ssize_t recvd = ::recv(_fd, data, len, 0);
@@ -1322,6 +1478,24 @@ ssize_t SSLSocket::write(const char *data, size_t len) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ssize_t SSLSocket::writev(const struct iovec *iov, int iovcnt) {
+	return Device::writev(iov, iovcnt);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ssize_t SSLSocket::sendfile(int fd, off_t *offset, size_t count) {
+	return Device::sendfile(fd, offset, count);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 ssize_t SSLSocket::read(char *data, size_t len) {
 	if ( _flags & InAccept ) {
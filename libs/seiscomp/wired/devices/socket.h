@@ -173,6 +173,8 @@ class SC_SYSTEM_CORE_API Socket : public Device {
 
 		ssize_t write(const char *data, size_t len) override;
 		ssize_t read(char *data, size_t len) override;
+		ssize_t writev(const struct iovec *iov, int iovcnt) override;
+		ssize_t sendfile(int fd, off_t *offset, size_t count) override;
 
 		//! Sets the socket timeout. This utilizes setsockopt which does not
 		//! work in non blocking sockets.
@@ -201,9 +203,24 @@ class SC_SYSTEM_CORE_API Socket : public Device {
 		 */
 		virtual Status connectV6(const std::string &hostname, port_t port);
 
+		/**
+		 * @brief Connects to a local (unix domain) socket.
+		 * @param path The path of the socket file
+		 * @return The status of the connect operation
+		 */
+		Status connectLocal(const std::string &path);
+
 		virtual Status bind(IPAddress ip, port_t port);
 		virtual Status bindV6(IPAddress ip, port_t port);
 
+		/**
+		 * @brief Binds to a local (unix domain) socket. An existing socket
+		 *        file is removed before.
+		 * @param path The path of the socket file
+		 * @return The status of the bind operation
+		 */
+		Status bindLocal(const std::string &path);
+
 		Status listen(int backlog = 10);
 		virtual Socket *accept();
 
@@ -274,6 +291,11 @@ class SSLSocket : public Socket {
 
 		ssize_t write(const char *data, size_t len) override;
 		ssize_t read(char *data, size_t len) override;
+		//! SSL does not support vectored writes, each buffer is
+		//! written separately.
+		ssize_t writev(const struct iovec *iov, int iovcnt) override;
+		//! The data must be encrypted, sendfile is not supported.
+		ssize_t sendfile(int fd, off_t *offset, size_t count) override;
 
 		Status connect(const std::string &hostname, port_t port) override;
 		Status connectV6(const std::string &hostname, port_t port) override;
@@ -29,6 +29,36 @@ using namespace std;
 
 namespace Seiscomp {
 namespace Wired {
+namespace {
+
+
+const int AddressBits = Socket::IPAddress::DWORDS * 32;
+
+
+inline int bit(const Socket::IPAddress &addr, int index) {
+	return (addr.dwords[index >> 5] >> (31 - (index & 31))) & 0x01;
+}
+
+
+/**
+ * Returns the number of leading bits set in a mask or -1 if the mask
+ * is not a prefix, e.g. 255.0.255.0.
+ */
+int prefixLength(const Socket::IPAddress &mask) {
+	int bits = 0;
+	while ( bits < AddressBits && bit(mask, bits) )
+		++bits;
+
+	for ( int i = bits; i < AddressBits; ++i ) {
+		if ( bit(mask, i) )
+			return -1;
+	}
+
+	return bits;
+}
+
+
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -153,6 +183,7 @@ bool IPACL::add(const string &ipstr) {
 		return false;
 
 	_masks.push_back(mask);
+	index(mask);
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -163,22 +194,47 @@ bool IPACL::add(const string &ipstr) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool IPACL::check(const Socket::IPAddress &addr) const {
 	if ( _masks.empty() ) return true;
+	return matches(addr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool IPACL::not_check(const Socket::IPAddress &addr) const {
+	if ( _masks.empty() ) return true;
+	return !matches(addr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-	const_iterator p;
-	for ( p = _masks.begin(); p != _masks.end(); ++p ) {
-		bool match = true;
-		for ( int i = 0; i < Socket::IPAddress::DWORDS; ++i ) {
-			if ( (addr.dwords[i] ^ p->addr.dwords[i]) & p->mask.dwords[i] ) {
-				match = false;
-				break;
-			}
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void IPACL::index(const IPMask &mask) {
+	int bits = prefixLength(mask.mask);
+	if ( bits < 0 ) {
+		_irregularMasks.push_back(mask);
+		return;
+	}
+
+	uint32_t node = 0;
+	for ( int i = 0; i < bits; ++i ) {
+		// A shorter prefix covers this one already
+		if ( _trie[node].terminal )
+			return;
+
+		int b = bit(mask.addr, i);
+		if ( !_trie[node].children[b] ) {
+			_trie[node].children[b] = static_cast<uint32_t>(_trie.size());
+			_trie.emplace_back();
 		}
 
-		if ( match )
-			return true;
+		node = _trie[node].children[b];
 	}
 
-	return false;
+	_trie[node].terminal = true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -186,25 +242,47 @@ bool IPACL::check(const Socket::IPAddress &addr) const {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool IPACL::not_check(const Socket::IPAddress &addr) const {
-	if ( _masks.empty() ) return true;
+void IPACL::reindex() {
+	_trie = Trie(1);
+	_irregularMasks.clear();
+
+	for ( const IPMask &mask : _masks )
+		index(mask);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 
-	const_iterator p;
-	for ( p = _masks.begin(); p != _masks.end(); ++p ) {
-		bool match = true;
 
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool IPACL::matches(const Socket::IPAddress &addr) const {
+	uint32_t node = 0;
+	for ( int i = 0; ; ++i ) {
+		if ( _trie[node].terminal )
+			return true;
+
+		if ( i >= AddressBits )
+			break;
+
+		node = _trie[node].children[bit(addr, i)];
+		if ( !node )
+			break;
+	}
+
+	for ( const IPMask &mask : _irregularMasks ) {
+		bool match = true;
 		for ( int i = 0; i < Socket::IPAddress::DWORDS; ++i ) {
-			if ( (addr.dwords[i] ^ p->addr.dwords[i]) & p->mask.dwords[i] ) {
+			if ( (addr.dwords[i] ^ mask.addr.dwords[i]) & mask.mask.dwords[i] ) {
 				match = false;
 				break;
 			}
 		}
 
 		if ( match )
-			return false;
+			return true;
 	}
 
-	return true;
+	return false;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -214,6 +292,7 @@ bool IPACL::not_check(const Socket::IPAddress &addr) const {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void IPACL::clear() {
 	_masks.clear();
+	reindex();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -259,8 +338,10 @@ IPACL &IPACL::operator+=(const IPACL &other) {
 			}
 		}
 
-		if ( !found )
+		if ( !found ) {
 			_masks.push_back(*it);
+			index(*it);
+		}
 	}
 
 	return *this;
@@ -283,6 +364,7 @@ IPACL &IPACL::operator-=(const IPACL &other) {
 		}
 	}
 
+	reindex();
 	return *this;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -64,6 +64,12 @@ bool fromString(IPMask &mask, const std::string &str);
  *
  * This class holds a list of IP address/mask pairs and checks if an IP matches
  * or not. It does not define whether it is a whitelist or blacklist.
+ *
+ * Masks which are prefixes, e.g. "192.168.0.0/24", are additionally stored
+ * in a binary trie which is updated whenever the list changes. A check
+ * therefore costs at most one step per address bit regardless of the
+ * number of entries. Masks with gaps, e.g. "10.0.0.1/255.0.255.0", are
+ * tested one after another.
  */
 class SC_SYSTEM_CORE_API IPACL {
 	public:
@@ -129,11 +135,38 @@ class SC_SYSTEM_CORE_API IPACL {
 		 */
 		bool operator==(const IPACL &other) const;
 
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		//! Adds a mask to the lookup structures
+		void index(const IPMask &mask);
+
+		//! Rebuilds the lookup structures from _masks
+		void reindex();
+
+		//! Returns whether an address matches any mask
+		bool matches(const Socket::IPAddress &ip) const;
+
+
 	// ----------------------------------------------------------------------
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
+		struct TrieNode {
+			// Index of the child node for bit 0 and 1, 0 if there is none
+			uint32_t children[2]{0, 0};
+			// Whether a prefix ends at this node
+			bool     terminal{false};
+		};
+
+		using Trie = std::vector<TrieNode>;
+
 		IPMasks _masks;
+		// The first node is the root
+		Trie    _trie = Trie(1);
+		// Masks which are not prefixes
+		IPMasks _irregularMasks;
 };
 
 
@@ -25,6 +25,7 @@
 
 #include <cstdio>
 #include <iostream>
+#include <limits>
 #include <string.h>
 
 #include <seiscomp/wired/protocols/http.h>
@@ -71,6 +72,36 @@ void padzero2(string &out, int value) {
 	out += '0' + value % 10;
 }
 
+
+void appendNumber(string &out, size_t value) {
+	char tmp[24];
+	int len = snprintf(tmp, sizeof(tmp), "%zu", value);
+	out.append(tmp, static_cast<size_t>(len));
+}
+
+
+// Parses a decimal header value in place without copying it
+bool parseNumber(const char *data, size_t len, size_t &value) {
+	trim(data, len);
+	if ( len == 0 ) return false;
+
+	value = 0;
+	for ( size_t i = 0; i < len; ++i ) {
+		if ( data[i] < '0' || data[i] > '9' ) return false;
+		size_t digit = static_cast<size_t>(data[i] - '0');
+		if ( value > (std::numeric_limits<size_t>::max() - digit) / 10 )
+			return false;
+		value = value * 10 + digit;
+	}
+
+	return true;
+}
+
+
+// The initial capacity of response header buffers which fits typical
+// headers without reallocation
+const size_t HeaderReserve = 512;
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -186,10 +217,12 @@ std::string HttpSession::EmptyString;
 
 HttpSession::HttpSession(Device *dev, const char *protocol, const char *server)
 : ClientSession(dev, 500), _protocol(protocol), _server(server),
-  _requestStarted(false), _upgradedToWebsocket(false), _websocketFrame(nullptr) {
+  _requestStarted(false), _upgradedToWebsocket(false),
+  _websocketDeflateEnabled(false), _websocketFrame(nullptr) {
 	// Typically a HTTP connection needs to read the request
 	if ( dev != nullptr ) dev->setMode(Socket::Read);
 	_request.state = HttpRequest::ENABLED;
+	_header.reserve(HeaderReserve);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -361,24 +394,24 @@ void HttpSession::sendResponse(HttpStatus status) {
 	_request.status = status;
 
 	// Send response
-	send("HTTP/1.1 ");
-	send(status.toString());
+	_header = "HTTP/1.1 ";
+	_header += status.toString();
 	if ( _server ) {
-		send("\r\nServer: ");
-		send(_server);
+		_header += "\r\nServer: ";
+		_header += _server;
 	}
 
 	if ( _request.keepAlive ) {
-		send("\r\nKeep-Alive: timeout=15");
-		send("\r\nConnection: Keep-Alive");
+		_header += "\r\nKeep-Alive: timeout=15";
+		_header += "\r\nConnection: Keep-Alive";
 	}
 
 	if ( !_request.origin.empty() )
-		send("\r\nAccess-Control-Allow-Origin: *");
+		_header += "\r\nAccess-Control-Allow-Origin: *";
 
-	send("\r\nContent-Length: 0");
-	send("\r\n\r\n", 4);
+	_header += "\r\nContent-Length: 0\r\n\r\n";
 
+	send(_header.data(), _header.size());
 	flush();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -396,42 +429,41 @@ void HttpSession::sendResponse(const char *content, size_t len,
 	// Save status in request
 	_request.status = status;
 
-	send("HTTP/1.1 ", 9);
-	send(status.toString());
-	send("\r\n", 2);
+	_header = "HTTP/1.1 ";
+	_header += status.toString();
+	_header += "\r\n";
 
 	if ( _server ) {
-		send("Server: ");
-		send(_server);
-		send("\r\n", 2);
+		_header += "Server: ";
+		_header += _server;
+		_header += "\r\n";
 	}
 
 	if ( !_request.origin.empty() )
-		send("Access-Control-Allow-Origin: *\r\n");
+		_header += "Access-Control-Allow-Origin: *\r\n";
 
 	if ( cookie ) {
-		send("Set-Cookie: ");
-		send(cookie);
-		send("; Path=/\r\n");
+		_header += "Set-Cookie: ";
+		_header += cookie;
+		_header += "; Path=/\r\n";
 	}
 
 	if ( _request.keepAlive ) {
-		send("Keep-Alive: timeout=15\r\n");
-		send("Connection: Keep-Alive\r\n");
+		_header += "Keep-Alive: timeout=15\r\n";
+		_header += "Connection: Keep-Alive\r\n";
 	}
 
 	if ( contentType ) {
-		send("Content-Type: ");
-		send(contentType);
-		send("\r\n", 2);
+		_header += "Content-Type: ";
+		_header += contentType;
+		_header += "\r\n";
 	}
 
-	send("Content-Length: ");
-	const string length = Seiscomp::Core::toString(len);
-	send(length.c_str(), length.size());
-
-	send("\r\n\r\n", 4);
+	_header += "Content-Length: ";
+	appendNumber(_header, len);
+	_header += "\r\n\r\n";
 
+	send(_header.data(), _header.size());
 	send(content, len);
 
 	if ( empty ) flush();
@@ -469,7 +501,9 @@ void HttpSession::sendResponse(Buffer* buf, HttpStatus status,
 	// Save status in request
 	_request.status = status;
 
-	buf->header ="HTTP/1.1 ";
+	buf->header.clear();
+	buf->header.reserve(HeaderReserve);
+	buf->header += "HTTP/1.1 ";
 	buf->header += status.toString();
 	buf->header += "\r\n";
 
@@ -511,7 +545,7 @@ void HttpSession::sendResponse(Buffer* buf, HttpStatus status,
 		buf->header += " ";
 		buf->header += Months[t.tm_mon];
 		buf->header += " ";
-		buf->header += Seiscomp::Core::toString(t.tm_year+1900);
+		appendNumber(buf->header, static_cast<size_t>(t.tm_year+1900));
 		buf->header += " ";
 		padzero2(buf->header, t.tm_hour);
 		buf->header += ":";
@@ -540,9 +574,8 @@ void HttpSession::sendResponse(Buffer* buf, HttpStatus status,
 	}
 
 	if ( buf->length() != string::npos ) {
-		buf->header +=
-			"Content-Length: ";
-		buf->header += Seiscomp::Core::toString(buf->length());
+		buf->header += "Content-Length: ";
+		appendNumber(buf->header, buf->length());
 	}
 	else
 		buf->header += "Transfer-Encoding: chunked";
@@ -572,6 +605,7 @@ bool HttpSession::reset() {
 	_dataStarted = false;
 	_dataSize = 0;
 	_upgradedToWebsocket = false;
+	_websocketDeflate = nullptr;
 
 	if ( _websocketFrame ) _websocketFrame->reset();
 
@@ -611,13 +645,25 @@ void HttpSession::handleReceive(const char *data, size_t len) {
 			data += read; len -= static_cast<size_t>(read);
 
 			if ( _websocketFrame->isFinished() ) {
+				if ( _websocketFrame->compressed && !inflateWebsocketFrame() ) {
+					SEISCOMP_ERROR("[websocket] invalid compressed frame, closing connection");
+					close();
+					return;
+				}
+
 				handleWebsocketFrame(*_websocketFrame);
 				_websocketFrame->reset();
 			}
 		}
 	}
-	else
+	else {
 		ClientSession::handleReceive(data, len);
+
+		// Data received together with the upgrade request already
+		// belongs to the websocket protocol
+		if ( _upgradedToWebsocket && isInboxPaused() )
+			resumeInbox();
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -697,6 +743,7 @@ void HttpSession::handleInbox(const char *src_data, size_t src_len) {
 		_request.data.clear();
 		_request.secWebsocketProtocol.clear();
 		_request.secWebsocketKey.clear();
+		_request.secWebsocketExtensions.clear();
 		_request.secWebsocketVersion = -1;
 		_request.ifModifiedSince = HttpRequest::Time();
 		_request.tx = 0;
@@ -739,8 +786,7 @@ void HttpSession::handleInbox(const char *src_data, size_t src_len) {
 					SEISCOMP_DEBUG("[%p] %s %s",
 					               static_cast<void*>(this),
 					               _request.type.toString(), _request.path.c_str());
-					handleRequest(_request);
-					_requestStarted = false;
+					dispatchRequest();
 					break;
 				case HttpRequest::POST:
 				case HttpRequest::PUT:
@@ -772,11 +818,9 @@ void HttpSession::handleInbox(const char *src_data, size_t src_len) {
 			data = tokenize(src_data, ":", data_len, len);
 			if ( len == 14 && strncasecmp("Content-Length", data, len) == 0 ) {
 				data = tokenize(src_data, ":", data_len, len);
-				string tmp;
-				tmp.assign(data, len);
-				if ( !Seiscomp::Core::fromString(_dataSize, tmp) ) {
-					SEISCOMP_ERROR("HTTP: invalid Content-Length value: %s",
-					               tmp.c_str());
+				if ( !data || !parseNumber(data, len, _dataSize) ) {
+					SEISCOMP_ERROR("HTTP: invalid Content-Length value: %.*s",
+					               data ? int(len) : 0, data ? data : "");
 					close();
 					return;
 				}
@@ -910,12 +954,21 @@ void HttpSession::handleInbox(const char *src_data, size_t src_len) {
 				trimFront(data,len);
 				_request.secWebsocketKey.assign(data, len);
 			}
-			else if ( len == 21 && strncasecmp("Sec-WebSocket-Version", data, len) == 0 ) {
+			else if ( len == 24 && strncasecmp("Sec-WebSocket-Extensions", data, len) == 0 ) {
 				data = src_data+1;
 				len = data_len-1;
-				string tmp;
-				tmp.assign(data, len);
-				if ( !Seiscomp::Core::fromString(_request.secWebsocketVersion, tmp) )
+				trimFront(data,len);
+				// Offers can be spread over several header lines
+				if ( !_request.secWebsocketExtensions.empty() )
+					_request.secWebsocketExtensions += ", ";
+				_request.secWebsocketExtensions.append(data, len);
+			}
+			else if ( len == 21 && strncasecmp("Sec-WebSocket-Version", data, len) == 0 ) {
+				size_t version;
+				if ( parseNumber(src_data+1, data_len-1, version)
+				  && version <= static_cast<size_t>(std::numeric_limits<int>::max()) )
+					_request.secWebsocketVersion = static_cast<int>(version);
+				else
 					_request.secWebsocketVersion = -1;
 			}
 			else {
@@ -948,9 +1001,8 @@ void HttpSession::handlePostData(const char *data, size_t len) {
 	_dataSize -= bytes;
 
 	if ( _dataSize == 0 ) {
-		_requestStarted = false;
 		_dataStarted = false;
-		handleRequest(_request);
+		dispatchRequest();
 		_request.data.clear();
 		_dataSize = 0;
 	}
@@ -991,12 +1043,16 @@ void HttpSession::outboxFlushed() {
 			_device->setMode(Device::Read);
 			_requestStarted = false;
 			SEISCOMP_DEBUG("[http] keeping session for 15 secs");
+			// Continue with pipelined requests
+			resumeInbox();
 		}
 		else {
 			SEISCOMP_DEBUG("[http] close session");
 			close();
 		}
 	}
+	else if ( !isRequestPending() )
+		resumeInbox();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -1010,6 +1066,35 @@ void HttpSession::requestFinished() {}
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool HttpSession::isRequestPending() const {
+	return (_request.state == HttpRequest::RUNNING)
+	    || (_request.state == HttpRequest::QRUNNING)
+	    || (inAvail() > 0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void HttpSession::dispatchRequest() {
+	_requestStarted = false;
+
+	// Requests pipelined by the client are held back until the response
+	// to this request has been sent. If the response is sent immediately
+	// outboxFlushed resumes the inbox already while handling the request.
+	pauseInbox();
+	handleRequest(_request);
+
+	if ( !_upgradedToWebsocket && !isRequestPending() )
+		resumeInbox();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void HttpSession::handleHeader(const char *, size_t, const char *, size_t) {
 	// Do nothing, all standard headers are already handled in handleInbox
@@ -1055,6 +1140,7 @@ bool HttpSession::handleRequest(HttpRequest &req) {
 
 	if ( !res ) {
 		SEISCOMP_ERROR("[http] error in request handler: returning 500");
+		req.state = HttpRequest::FINISHED;
 		sendStatus(HTTP_500);
 	}
 
@@ -1066,7 +1152,8 @@ bool HttpSession::handleRequest(HttpRequest &req) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool HttpSession::handleGETRequest(HttpRequest &) {
+bool HttpSession::handleGETRequest(HttpRequest &req) {
+	req.state = HttpRequest::FINISHED;
 	sendStatus(HTTP_405);
 	return true;
 }
@@ -1076,7 +1163,8 @@ bool HttpSession::handleGETRequest(HttpRequest &) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool HttpSession::handlePOSTRequest(HttpRequest &) {
+bool HttpSession::handlePOSTRequest(HttpRequest &req) {
+	req.state = HttpRequest::FINISHED;
 	sendStatus(HTTP_405);
 	return true;
 }
@@ -1110,7 +1198,8 @@ bool HttpSession::handleOPTIONSRequest(HttpRequest &req) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool HttpSession::handleHEADRequest(HttpRequest &) {
+bool HttpSession::handleHEADRequest(HttpRequest &req) {
+	req.state = HttpRequest::FINISHED;
 	sendStatus(HTTP_405);
 	return true;
 }
@@ -1120,7 +1209,8 @@ bool HttpSession::handleHEADRequest(HttpRequest &) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool HttpSession::handlePUTRequest(HttpRequest &) {
+bool HttpSession::handlePUTRequest(HttpRequest &req) {
+	req.state = HttpRequest::FINISHED;
 	sendStatus(HTTP_405);
 	return true;
 }
@@ -1130,7 +1220,8 @@ bool HttpSession::handlePUTRequest(HttpRequest &) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool HttpSession::handleDELETERequest(HttpRequest &) {
+bool HttpSession::handleDELETERequest(HttpRequest &req) {
+	req.state = HttpRequest::FINISHED;
 	sendStatus(HTTP_405);
 	return true;
 }
@@ -1140,7 +1231,8 @@ bool HttpSession::handleDELETERequest(HttpRequest &) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool HttpSession::handleTRACERequest(HttpRequest &) {
+bool HttpSession::handleTRACERequest(HttpRequest &req) {
+	req.state = HttpRequest::FINISHED;
 	sendStatus(HTTP_405);
 	return true;
 }
@@ -1175,7 +1267,9 @@ void HttpSession::upgradeToWebsocket(HttpRequest &req, const char *protocol,
 	key.clear();
 	Seiscomp::Util::encodeBase64(key, sha1, SHA_DIGEST_LENGTH);
 	send(key.data(), key.size());
-	send("\r\n\r\n");
+	send("\r\n");
+	negotiateWebsocketExtensions();
+	send("\r\n");
 	flush();
 
 	_upgradedToWebsocket = true;
@@ -1205,16 +1299,89 @@ void HttpSession::sendWebsocketResponse(const char *data, int len,
                                         Websocket::Status statusCode,
                                         bool close) {
 	BufferPtr resp = new Buffer;
-	if ( data != nullptr )
+	bool compressed = false;
+
+	if ( _websocketDeflate && (statusCode == Websocket::NoStatus)
+	  && ((type == Websocket::Frame::TextFrame) || (type == Websocket::Frame::BinaryFrame))
+	  && (data != nullptr)
+	  && (static_cast<size_t>(len) >= Websocket::PerMessageDeflate::MinMessageSize) ) {
+		compressed = Websocket::PerMessageDeflate::compress(
+			resp->data, data, static_cast<size_t>(len),
+			_websocketDeflate->serverMaxWindowBits()
+		);
+	}
+
+	if ( !compressed && data != nullptr )
 		resp->data.assign(data, data+len);
-	Websocket::Frame::finalizeBuffer(resp.get(), type, statusCode);
+
+	Websocket::Frame::finalizeBuffer(resp.get(), type, statusCode, compressed);
 	send(resp.get());
 	if ( (statusCode != Websocket::NoStatus) || close )
 		invalidate();
 }
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void HttpSession::setWebsocketDeflateEnabled(bool enable) {
+	_websocketDeflateEnabled = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Websocket::PerMessageDeflate *HttpSession::websocketDeflate() const {
+	return _websocketDeflate.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void HttpSession::negotiateWebsocketExtensions() {
+	_websocketDeflate = nullptr;
+
+	if ( !_websocketDeflateEnabled || _request.secWebsocketExtensions.empty() )
+		return;
+
+	Websocket::PerMessageDeflatePtr deflate = new Websocket::PerMessageDeflate;
+	if ( !deflate->negotiate(_request.secWebsocketExtensions) )
+		return;
+
+	_websocketDeflate = deflate;
+	send("Sec-WebSocket-Extensions: ");
+	send(_websocketDeflate->response().c_str());
+	send("\r\n");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool HttpSession::inflateWebsocketFrame() {
+	Websocket::Frame &frame = *_websocketFrame;
+
+	// Only whole messages are decompressed, fragmented messages are not
+	// supported
+	if ( !_websocketDeflate || !frame.finalFragment )
+		return false;
+
+	string payload;
+	if ( !_websocketDeflate->decompress(payload, frame.data.data(), frame.data.size(),
+	                                    frame.maxPayloadSize()) )
+		return false;
+
+	frame.data.swap(payload);
+	frame.payloadLength = frame.data.size();
+	frame.compressed = false;
+	return true;
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -1227,35 +1394,31 @@ void HttpSession::sendStatus(HttpStatus status, const string &content,
 	_request.status = status;
 
 	// Send response
-	send("HTTP/1.1 ");
-	send(status.toString());
+	_header = "HTTP/1.1 ";
+	_header += status.toString();
 	if ( _server ) {
-		send("\r\nServer: ");
-		send(_server);
+		_header += "\r\nServer: ";
+		_header += _server;
 	}
 
-	if ( !content.empty() ) {
-		send("\r\nContent-Length: ");
-		const string length = Seiscomp::Core::toString(content.size());
-		send(length.c_str(), length.size());
-	}
-	else
-		send("\r\nContent-Length: 0");
+	_header += "\r\nContent-Length: ";
+	appendNumber(_header, content.size());
 
 	if ( contentType != nullptr ) {
-		send("\r\nContent-Type: ");
-		send(contentType);
+		_header += "\r\nContent-Type: ";
+		_header += contentType;
 	}
 
 	if ( !_request.origin.empty() )
-		send("\r\nAccess-Control-Allow-Origin: *");
+		_header += "\r\nAccess-Control-Allow-Origin: *";
 
 	if ( _request.keepAlive && _request.addKeepAliveHeader ) {
-		send("\r\nKeep-Alive: timeout=15");
-		send("\r\nConnection: Keep-Alive");
+		_header += "\r\nKeep-Alive: timeout=15";
+		_header += "\r\nConnection: Keep-Alive";
 	}
 
-	send("\r\n\r\n", 4);
+	_header += "\r\n\r\n";
+	send(_header.data(), _header.size());
 
 	if ( content.size() )
 		send(content.data(), content.size());
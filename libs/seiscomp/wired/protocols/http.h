@@ -184,6 +184,7 @@ struct HttpRequest {
 	std::string data;
 	std::string secWebsocketProtocol;
 	std::string secWebsocketKey;
+	std::string secWebsocketExtensions;
 	int         secWebsocketVersion;
 	Time        ifModifiedSince;
 	bool        keepAlive;
@@ -393,6 +394,14 @@ class SC_SYSTEM_CORE_API HttpSession : public ClientSession {
 		                               Websocket::NoStatus,
 		                           bool close = false);
 
+		//! Enables the permessage-deflate websocket extension if it is
+		//! offered by the client. It is disabled by default.
+		void setWebsocketDeflateEnabled(bool enable);
+
+		//! Returns the negotiated permessage-deflate extension of an
+		//! upgraded connection or nullptr.
+		Websocket::PerMessageDeflate *websocketDeflate() const;
+
 		static std::string urlencode(const std::string &s);
 		static std::string urlencode(const char *s, int len);
 
@@ -413,6 +422,24 @@ class SC_SYSTEM_CORE_API HttpSession : public ClientSession {
 		virtual bool validatePostDataSize(size_t postDataSize);
 		virtual void requestFinished();
 
+		//! Negotiates the extensions offered with the websocket upgrade
+		//! request and sends the Sec-WebSocket-Extensions header line if
+		//! one has been accepted. This must be called while the upgrade
+		//! response header is sent.
+		void negotiateWebsocketExtensions();
+
+		//! Returns whether the current request is still running or its
+		//! response has not yet been sent completely
+		bool isRequestPending() const;
+
+
+	private:
+		//! Passes the completely read request to handleRequest
+		void dispatchRequest();
+
+		//! Decompresses the current websocket frame
+		bool inflateWebsocketFrame();
+
 
 	protected:
 		//! const char reference that needs to be managed by the application
@@ -423,9 +450,13 @@ class SC_SYSTEM_CORE_API HttpSession : public ClientSession {
 		bool                _dataStarted;
 		bool                _acceptGzip;
 		bool                _upgradedToWebsocket;
+		bool                _websocketDeflateEnabled;
 		Websocket::FramePtr _websocketFrame;
+		Websocket::PerMessageDeflatePtr _websocketDeflate;
 
 		HttpRequest         _request;
+		//! The reused buffer response headers are composed in
+		std::string         _header;
 };
 
 
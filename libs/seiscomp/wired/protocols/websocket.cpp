@@ -21,9 +21,11 @@
 #define SEISCOMP_COMPONENT Wired
 
 #include <seiscomp/core/endianess.h>
+#include <seiscomp/core/strings.h>
 #include <seiscomp/logging/log.h>
 #include <iostream>
 #include <string.h>
+#include <zlib.h>
 
 #include "websocket.h"
 
@@ -31,6 +33,55 @@
 namespace Seiscomp {
 namespace Wired {
 namespace Websocket {
+
+
+namespace {
+
+
+// The empty stored block which ends a message flushed with Z_SYNC_FLUSH.
+// It is removed from compressed messages and appended to received ones.
+const char DeflateTail[4] = { '\x00', '\x00', '\xff', '\xff' };
+
+
+// Copies masked payload and unmasks it in the same pass. The offset is the
+// position of the first byte in the payload and selects the mask byte.
+void unmaskCopy(uint8_t *dst, const char *src, size_t len, uint32_t mask,
+                uint64_t offset) {
+	const uint8_t *mb = reinterpret_cast<const uint8_t*>(&mask);
+	uint8_t key[8];
+	for ( size_t i = 0; i < 8; ++i )
+		key[i] = mb[(offset + i) & 3];
+
+	uint64_t key64;
+	memcpy(&key64, key, 8);
+
+	// Word-wise, unaligned loads and stores are expressed with memcpy
+	// which the compiler turns into plain moves and vectorizes
+	size_t words = len >> 3;
+	for ( size_t i = 0; i < words; ++i, src += 8, dst += 8 ) {
+		uint64_t w;
+		memcpy(&w, src, 8);
+		w ^= key64;
+		memcpy(dst, &w, 8);
+	}
+
+	len &= 7;
+	for ( size_t i = 0; i < len; ++i )
+		dst[i] = static_cast<uint8_t>(src[i]) ^ key[i];
+}
+
+
+bool parseWindowBits(std::string value, int &bits) {
+	// Values may be quoted
+	if ( value.size() >= 2 && value.front() == '"' && value.back() == '"' )
+		value = value.substr(1, value.size() - 2);
+
+	// zlib does not support a raw deflate window of 8 bits
+	return Core::fromString(bits, value) && bits >= 9 && bits <= 15;
+}
+
+
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -46,10 +97,12 @@ Frame::Frame() : _maxPayloadSize(0) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-inline bool Frame::next(size_t nBytes, void *dst, ItemCallback cb) {
+inline bool Frame::next(size_t nBytes, void *dst, ItemCallback cb,
+                        bool payload) {
 	_bytesToRead = nBytes;
 	_buffer = reinterpret_cast<uint8_t*>(dst);
 	_func = cb;
+	_unmask = payload && isMasked;
 	//SEISCOMP_DEBUG("next %d", nBytes);
 	return true;
 }
@@ -64,6 +117,8 @@ void Frame::reset() {
 	data = std::string();
 	status = NoStatus;
 	payloadLength = 0;
+	isMasked = false;
+	_payloadRead = 0;
 	next(1, &_control, &Frame::readControl);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -87,7 +142,12 @@ ssize_t Frame::feed(const char *data, size_t len) {
 	//SEISCOMP_DEBUG("handle %d", len);
 	while ( (len > 0) && (_bytesToRead > 0) ) {
 		size_t toCopy = std::min(_bytesToRead, len);
-		memcpy(_buffer, data, toCopy);
+		if ( _unmask ) {
+			unmaskCopy(_buffer, data, toCopy, mask, _payloadRead);
+			_payloadRead += toCopy;
+		}
+		else
+			memcpy(_buffer, data, toCopy);
 		data += toCopy;
 		_buffer += toCopy;
 		len -= toCopy;
@@ -138,6 +198,7 @@ bool Frame::readControl() {
 	}
 
 	finalFragment = _control & 0x80;
+	compressed = _control & 0x40;
 
 	return next(1, &payloadLength, &Frame::readPayload1);
 }
@@ -207,20 +268,7 @@ bool Frame::readMask() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Frame::dataComplete() {
-	if ( isMasked ) {
-		// Unmask data
-		size_t l = data.size() >> 2;
-		uint32_t *b = reinterpret_cast<uint32_t*>(const_cast<char*>(data.data()));
-		for ( size_t i = 0; i < l; ++i, ++b )
-			*b ^= mask;
-
-		l = data.size() & 0x03;
-		uint8_t *bb = reinterpret_cast<uint8_t*>(b);
-		uint8_t *mb = reinterpret_cast<uint8_t*>(&mask);
-		for ( size_t i = 0; i < l; ++i )
-			bb[i] ^= mb[i];
-	}
-
+	// The payload has been unmasked while reading
 	_isFinished = true;
 	return true;
 }
@@ -241,7 +289,7 @@ bool Frame::readStatus() {
 		}
 
 		data.resize(payloadLength);
-		return next(payloadLength, const_cast<char*>(data.data()), &Frame::dataComplete);
+		return next(payloadLength, const_cast<char*>(data.data()), &Frame::dataComplete, true);
 	}
 	else
 		_isFinished = true;
@@ -259,7 +307,7 @@ bool Frame::readData() {
 		// this is optional
 		if ( payloadLength >= 2 ) {
 			payloadLength -= 2;
-			return next(2, &status, &Frame::readStatus);
+			return next(2, &status, &Frame::readStatus, true);
 		}
 	}
 
@@ -271,7 +319,7 @@ bool Frame::readData() {
 		}
 
 		data.resize(payloadLength);
-		return next(payloadLength, const_cast<char*>(data.data()), &Frame::dataComplete);
+		return next(payloadLength, const_cast<char*>(data.data()), &Frame::dataComplete, true);
 	}
 	else
 		_isFinished = true;
@@ -283,8 +331,10 @@ bool Frame::readData() {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-void Frame::finalizeBuffer(Buffer *buf, Type type, Status statusCode) {
+void Frame::finalizeBuffer(Buffer *buf, Type type, Status statusCode,
+                           bool compressed) {
 	uint8_t control = 0x80 | type;
+	if ( compressed ) control |= 0x40;
 	uint8_t plc;
 	uint64_t pl = buf->data.size();
 	size_t headerOffset = 0;
@@ -326,6 +376,224 @@ void Frame::finalizeBuffer(Buffer *buf, Type type, Status statusCode) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PerMessageDeflate::PerMessageDeflate()
+: _serverMaxWindowBits(15)
+, _clientMaxWindowBits(15)
+, _clientNoContextTakeover(false)
+, _inflater(nullptr) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PerMessageDeflate::~PerMessageDeflate() {
+	if ( _inflater ) {
+		inflateEnd(_inflater);
+		delete _inflater;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PerMessageDeflate::negotiate(const std::string &offers) {
+	std::vector<std::string> extensions;
+	Core::split(extensions, offers, ",");
+
+	for ( std::string &extension : extensions ) {
+		std::vector<std::string> params;
+		Core::split(params, extension, ";");
+		if ( params.empty() || Core::trim(params[0]) != "permessage-deflate" )
+			continue;
+
+		int serverBits = 15;
+		int clientBits = 15;
+		bool clientNoContextTakeover = false;
+		bool valid = true;
+
+		for ( size_t i = 1; valid && i < params.size(); ++i ) {
+			std::string name, value;
+			size_t p = params[i].find('=');
+			if ( p != std::string::npos ) {
+				name = params[i].substr(0, p);
+				value = params[i].substr(p + 1);
+				Core::trim(value);
+			}
+			else
+				name = params[i];
+
+			Core::trim(name);
+
+			if ( name == "server_no_context_takeover" )
+				// Always applied
+				continue;
+			else if ( name == "client_no_context_takeover" )
+				clientNoContextTakeover = true;
+			else if ( name == "server_max_window_bits" )
+				valid = parseWindowBits(value, serverBits);
+			else if ( name == "client_max_window_bits" ) {
+				// The value is optional, the client announces that it
+				// supports the parameter in the response which is never
+				// sent
+				if ( !value.empty() )
+					valid = parseWindowBits(value, clientBits);
+			}
+			else
+				valid = false;
+		}
+
+		if ( !valid ) continue;
+
+		_serverMaxWindowBits = serverBits;
+		_clientMaxWindowBits = clientBits;
+		_clientNoContextTakeover = clientNoContextTakeover;
+		return true;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string PerMessageDeflate::response() const {
+	std::string header = "permessage-deflate; server_no_context_takeover";
+
+	if ( _clientNoContextTakeover )
+		header += "; client_no_context_takeover";
+
+	// Only lower than the default if requested by the client
+	if ( _serverMaxWindowBits < 15 ) {
+		header += "; server_max_window_bits=";
+		header += Core::toString(_serverMaxWindowBits);
+	}
+
+	return header;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PerMessageDeflate::compress(std::string &out, const char *data, size_t len,
+                                 int windowBits) {
+	z_stream strm;
+	memset(&strm, 0, sizeof(strm));
+
+	if ( deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -windowBits,
+	                  8, Z_DEFAULT_STRATEGY) != Z_OK )
+		return false;
+
+	// The bound covers Z_FINISH, the sync flush needs a few bytes more
+	out.resize(deflateBound(&strm, static_cast<uLong>(len)) + 16);
+
+	strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	strm.avail_in = static_cast<uInt>(len);
+
+	size_t produced = 0;
+	int ret;
+
+	do {
+		if ( produced == out.size() )
+			out.resize(out.size() * 2);
+
+		strm.next_out = reinterpret_cast<Bytef*>(&out[produced]);
+		strm.avail_out = static_cast<uInt>(out.size() - produced);
+		ret = deflate(&strm, Z_SYNC_FLUSH);
+		produced = out.size() - strm.avail_out;
+	}
+	while ( ret == Z_OK && strm.avail_out == 0 );
+
+	deflateEnd(&strm);
+
+	if ( ret != Z_OK && ret != Z_BUF_ERROR ) {
+		out.clear();
+		return false;
+	}
+
+	if ( produced >= 4 && !memcmp(&out[produced - 4], DeflateTail, 4) )
+		produced -= 4;
+
+	out.resize(produced);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PerMessageDeflate::decompress(std::string &out, const char *data, size_t len,
+                                   size_t maxSize) {
+	if ( !_inflater ) {
+		_inflater = new z_stream;
+		memset(_inflater, 0, sizeof(z_stream));
+		// The maximum window also inflates data of all smaller windows
+		if ( inflateInit2(_inflater, -15) != Z_OK ) {
+			delete _inflater;
+			_inflater = nullptr;
+			return false;
+		}
+	}
+	else if ( _clientNoContextTakeover )
+		inflateReset(_inflater);
+
+	out.clear();
+
+	const char *input[2] = { data, DeflateTail };
+	size_t inputLength[2] = { len, sizeof(DeflateTail) };
+	char chunk[16384];
+
+	for ( int i = 0; i < 2; ++i ) {
+		_inflater->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input[i]));
+		_inflater->avail_in = static_cast<uInt>(inputLength[i]);
+
+		int ret;
+
+		do {
+			_inflater->next_out = reinterpret_cast<Bytef*>(chunk);
+			_inflater->avail_out = sizeof(chunk);
+
+			ret = inflate(_inflater, Z_SYNC_FLUSH);
+			if ( ret != Z_OK && ret != Z_BUF_ERROR && ret != Z_STREAM_END ) {
+				SEISCOMP_ERROR("[websocket] inflate error: %d", ret);
+				inflateReset(_inflater);
+				return false;
+			}
+
+			out.append(chunk, sizeof(chunk) - _inflater->avail_out);
+			if ( maxSize && out.size() > maxSize ) {
+				SEISCOMP_ERROR("[websocket] inflated payload limit exceeded "
+				               "%zu > %zu", out.size(), maxSize);
+				inflateReset(_inflater);
+				return false;
+			}
+
+			if ( ret == Z_STREAM_END ) {
+				// The final block has been sent, the next message starts
+				// a new stream
+				inflateReset(_inflater);
+				return true;
+			}
+		}
+		while ( ret != Z_BUF_ERROR
+		     && (_inflater->avail_out == 0 || _inflater->avail_in > 0) );
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
@@ -28,6 +28,9 @@
 #include <seiscomp/wired/buffer.h>
 
 
+struct z_stream_s;
+
+
 namespace Seiscomp {
 namespace Wired {
 namespace Websocket {
@@ -101,17 +104,25 @@ class Frame : public Seiscomp::Core::BaseObject {
 		void setMaxPayloadSize(uint64_t size);
 
 		//! Returns the number of bytes read from the input buffer
-		//! If an protocol error occured, -1 is returned.
+		//! If an protocol error occured, -1 is returned. Masked payload
+		//! is unmasked while it is copied from the input buffer.
 		ssize_t feed(const char *data, size_t len);
 
 		bool isFinished() { return _isFinished; }
 
-		static void finalizeBuffer(Buffer *buf, Type type, Status statusCode = NoStatus);
+		uint64_t maxPayloadSize() const { return _maxPayloadSize; }
+
+		//! Writes the frame header of the buffer data. If compressed is
+		//! set then the data must be compressed with PerMessageDeflate
+		//! and the RSV1 bit is set.
+		static void finalizeBuffer(Buffer *buf, Type type, Status statusCode = NoStatus,
+		                           bool compressed = false);
 
 
 	private:
 		typedef bool (Frame::*ItemCallback)();
-		bool next(size_t nBytes, void *dst, ItemCallback cb);
+		bool next(size_t nBytes, void *dst, ItemCallback cb,
+		          bool payload = false);
 
 		bool readControl();
 		bool readPayload1();
@@ -128,6 +139,9 @@ class Frame : public Seiscomp::Core::BaseObject {
 		size_t        _bytesToRead;
 		uint8_t      *_buffer;
 		ItemCallback  _func;
+		bool          _unmask;
+		// The number of payload bytes read so far, selects the mask byte
+		uint64_t      _payloadRead;
 		bool          _isFinished;
 		uint8_t       _control;
 		uint64_t      _maxPayloadSize;
@@ -137,12 +151,73 @@ class Frame : public Seiscomp::Core::BaseObject {
 		uint16_t      status;
 		bool          isMasked;
 		bool          finalFragment;
+		//! Whether RSV1 is set which marks a compressed message if
+		//! permessage-deflate has been negotiated
+		bool          compressed;
 		uint64_t      payloadLength;
 		uint32_t      mask;
 		std::string   data;
 };
 
 
+DEFINE_SMARTPOINTER(PerMessageDeflate);
+
+/**
+ * @brief The PerMessageDeflate class implements the permessage-deflate
+ *        extension according to RFC 7692 on the server side.
+ *
+ * The server always responds with server_no_context_takeover. Each
+ * outgoing message is thus compressed independently and the result only
+ * depends on the message and the negotiated server window size. A
+ * message which is sent to many clients can be compressed once per
+ * distinct window size and the result can be shared among all clients.
+ * Incoming messages are decompressed with a context per session which
+ * is kept between messages unless client_no_context_takeover has been
+ * negotiated.
+ */
+class PerMessageDeflate : public Seiscomp::Core::BaseObject {
+	public:
+		PerMessageDeflate();
+		~PerMessageDeflate() override;
+
+
+	public:
+		//! Accepts the first supported permessage-deflate offer of a
+		//! Sec-WebSocket-Extensions header value and returns whether an
+		//! offer has been accepted.
+		bool negotiate(const std::string &offers);
+
+		//! Returns the value of the Sec-WebSocket-Extensions response
+		//! header for the accepted offer.
+		std::string response() const;
+
+		//! Messages smaller than this are not worth to be compressed
+		static const size_t MinMessageSize = 128;
+
+		int serverMaxWindowBits() const { return _serverMaxWindowBits; }
+		int clientMaxWindowBits() const { return _clientMaxWindowBits; }
+		bool clientNoContextTakeover() const { return _clientNoContextTakeover; }
+
+		//! Compresses a message payload without context takeover and
+		//! removes the trailing empty block as required by RFC 7692.
+		static bool compress(std::string &out, const char *data, size_t len,
+		                     int windowBits);
+
+		//! Decompresses a message payload. Returns false if the data is
+		//! invalid or if the decompressed size exceeds maxSize. A maxSize
+		//! of 0 does not limit the size.
+		bool decompress(std::string &out, const char *data, size_t len,
+		                size_t maxSize = 0);
+
+
+	private:
+		int          _serverMaxWindowBits;
+		int          _clientMaxWindowBits;
+		bool         _clientNoContextTakeover;
+		z_stream_s  *_inflater;
+};
+
+
 }
 }
 }
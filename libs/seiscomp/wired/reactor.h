@@ -54,6 +54,7 @@ class SC_SYSTEM_CORE_API Reactor : public Seiscomp::Core::BaseObject {
 	// ----------------------------------------------------------------------
 	public:
 		typedef DeviceGroup::TriggerMode TriggerMode;
+		typedef DeviceGroup::Backend Backend;
 
 
 	// ----------------------------------------------------------------------
@@ -136,6 +137,11 @@ class SC_SYSTEM_CORE_API Reactor : public Seiscomp::Core::BaseObject {
 		bool setTriggerMode(TriggerMode);
 		TriggerMode triggerMode() const;
 
+		//! Selects the polling backend, must be called before the first
+		//! device is added.
+		bool setBackend(Backend);
+		Backend backend() const;
+
 		const SessionList &sessions() const;
 
 		const DeviceGroup *devices() const;
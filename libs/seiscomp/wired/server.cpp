@@ -26,6 +26,7 @@
 #include <openssl/err.h>
 
 #include <csignal>
+#include <functional>
 #include <string.h>
 
 
@@ -50,6 +51,8 @@ Server::Server() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Server::~Server() {
+	stopWorkers();
+
 	// Free up allocated memory
 	EVP_cleanup();
 }
@@ -76,6 +79,24 @@ void Server::setPrivateKey(const string &key) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Server::setWorkerCount(size_t count) {
+	_workerCount = count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t Server::workerCount() const {
+	return _workerCount;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Server::init() {
 	if ( _endpoints.empty() ) {
@@ -93,6 +114,25 @@ bool Server::init() {
 		}
 	}
 
+	for ( size_t i = _workers.size(); i < _workerCount; ++i ) {
+		Worker worker;
+		worker.reactor = createWorker();
+		worker.reactor->setTriggerMode(triggerMode());
+		if ( !worker.reactor->setup() ) {
+			SEISCOMP_ERROR("Unable to setup worker reactor #%zu", i);
+			return false;
+		}
+
+		worker.thread = new thread(bind(&Reactor::run, worker.reactor.get()));
+
+		lock_guard<mutex> l(_mutex);
+		_workers.push_back(worker);
+	}
+
+	if ( !_workers.empty() )
+		SEISCOMP_INFO("[server] serving sessions with %zu workers",
+		              _workers.size());
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -100,6 +140,17 @@ bool Server::init() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Server::run() {
+	bool ret = Reactor::run();
+	stopWorkers();
+	return ret;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Server::shutdown() {
 	Reactor::shutdown();
@@ -113,6 +164,10 @@ void Server::shutdown() {
 	      it != _endpoints.end(); ++it ) {
 		if ( (*it)->device() ) (*it)->device()->close();
 	}
+
+	for ( Worker &worker : _workers )
+		worker.reactor->shutdown();
+
 	_devices.interrupt();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -122,6 +177,7 @@ void Server::shutdown() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Server::clear() {
+	stopWorkers();
 	Reactor::clear();
 	_endpoints.clear();
 }
@@ -139,6 +195,23 @@ bool Server::addSession(Session *session) {
 		return false;
 	}
 
+	if ( !_workers.empty() ) {
+		// Pass the session to the least busy worker
+		Worker *target = &_workers[0];
+		size_t targetCount = target->reactor->count();
+		for ( size_t i = 1; i < _workers.size(); ++i ) {
+			size_t count = _workers[i].reactor->count();
+			if ( count < targetCount ) {
+				target = &_workers[i];
+				targetCount = count;
+			}
+		}
+
+		target->reactor->addSessionDeferred(session);
+		target->reactor->interrupt();
+		return true;
+	}
+
 	//cout << session->_parent << endl;
 	if ( session->_parent != nullptr ) {
 		SEISCOMP_WARNING("[server] session is already part of a server");
@@ -248,6 +321,43 @@ bool Server::addEndpoint(Socket::IPAddress ip, Socket::port_t port, Endpoint *en
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Server::addLocalEndpoint(const std::string &path, Endpoint *endpoint) {
+	if ( endpoint == nullptr ) return false;
+	if ( endpoint->_parent != nullptr ) {
+		SEISCOMP_WARNING("Acceptor is already part of a server");
+		return false;
+	}
+
+	Socket *socket = Socket::Cast(endpoint->device());
+	if ( socket == nullptr ) {
+		SEISCOMP_ERROR("Endpoint does not have a socket attached to it");
+		return false;
+	}
+
+	socket->setNonBlocking(true);
+
+	Socket::Status r = socket->bindLocal(path);
+	if ( r != Socket::Success ) {
+		SEISCOMP_ERROR("Unable to bind to %s: %d, %d", path.c_str(),
+		               static_cast<int>(r), errno);
+		return false;
+	}
+
+	socket->setMode(Socket::Read);
+
+	if ( !_devices.append(socket) ) return false;
+
+	endpoint->_parent = this;
+	_endpoints.push_back(endpoint);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Server::addEndpointV6(Socket::IPAddress ip, Socket::port_t port,
                            bool useSSL, Endpoint *endpoint) {
@@ -378,6 +488,37 @@ void Server::endpointRemoved(Endpoint *) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Reactor *Server::createWorker() {
+	return new Reactor;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Server::stopWorkers() {
+	Workers workers;
+
+	{
+		lock_guard<mutex> l(_mutex);
+		workers.swap(_workers);
+	}
+
+	for ( Worker &worker : workers ) {
+		worker.reactor->shutdown();
+		if ( worker.thread ) {
+			worker.thread->join();
+			delete worker.thread;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 } // namespace TCP
 } // namespace Gempa
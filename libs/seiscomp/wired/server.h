@@ -25,6 +25,9 @@
 #include <seiscomp/wired/reactor.h>
 #include <seiscomp/wired/endpoint.h>
 
+#include <thread>
+#include <vector>
+
 
 namespace Seiscomp {
 namespace Wired {
@@ -51,10 +54,28 @@ class SC_SYSTEM_CORE_API Server : public Reactor {
 		void setCertificate(const std::string&);
 		void setPrivateKey(const std::string&);
 
+		/**
+		 * @brief Sets the number of worker reactors which serve the
+		 *        accepted sessions, each in its own thread. The server
+		 *        itself then only accepts new connections and passes
+		 *        them to the worker with the least number of sessions.
+		 *        This must be called before init. The default is 0 which
+		 *        serves all sessions in the thread of the server.
+		 *        Sessions must not share unprotected state if workers are
+		 *        used.
+		 * @param count The number of worker reactors
+		 */
+		void setWorkerCount(size_t count);
+		size_t workerCount() const;
+
 		//! Initializes the server and starts listening
 		//! on all defined ports
 		virtual bool init();
 
+		//! Runs the server and stops all workers once the run loop
+		//! terminated.
+		bool run() override;
+
 		//! Shutdown the server causing the run loop to terminate.
 		virtual void shutdown() override;
 
@@ -101,6 +122,16 @@ class SC_SYSTEM_CORE_API Server : public Reactor {
 		bool addEndpointV6(Socket::IPAddress ip, Socket::port_t port,
 		                   bool useSSL, Endpoint *endpoint);
 
+		/**
+		 * @brief Adds an endpoint session which accepts connections on a
+		 *        local (unix domain) socket. As with addEndpoint, the
+		 *        endpoint must have a socket attached to it.
+		 * @param path The path of the socket file
+		 * @param endpoint The endpoint instance
+		 * @return Status flag
+		 */
+		bool addLocalEndpoint(const std::string &path, Endpoint *endpoint);
+
 		bool removeEndpoint(Endpoint *endpoint);
 
 		bool clearEndpoints();
@@ -114,14 +145,34 @@ class SC_SYSTEM_CORE_API Server : public Reactor {
 	protected:
 		virtual void endpointRemoved(Endpoint *endpoint);
 
+		//! Creates a worker reactor. The default implementation creates
+		//! a plain Reactor instance.
+		virtual Reactor *createWorker();
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		void stopWorkers();
+
 
 	// ----------------------------------------------------------------------
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
+		struct Worker {
+			ReactorPtr   reactor;
+			std::thread *thread{nullptr};
+		};
+
+		typedef std::vector<Worker> Workers;
+
 		std::string  _certificate;
 		std::string  _privateKey;
 		SessionList  _endpoints;
+		size_t       _workerCount{0};
+		Workers      _workers;
 };
 
 
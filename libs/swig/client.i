@@ -76,6 +76,8 @@
 
 %}
 
+%include "gil.i"
+
 %feature("director") Seiscomp::Client::Application;
 %feature("director") Seiscomp::Client::StreamApplication;
 
@@ -164,45 +166,17 @@
 }
 
 // Allow GIL release for the following function(s)
-%exception Seiscomp::Client::Connection::fetchInbox {
-  Py_BEGIN_ALLOW_THREADS
-  try {
-    $action
-  }
-  catch ( const Swig::DirectorException &e ) {
-    SWIG_fail;
-  }
-  catch ( const Seiscomp::Core::ValueException &e ) {
-    SWIG_exception(SWIG_ValueError, e.what());
-  }
-  catch ( const std::exception &e ) {
-    SWIG_exception(SWIG_RuntimeError, e.what());
-  }
-  catch ( ... ) {
-    SWIG_exception(SWIG_UnknownError, "C++ anonymous exception");
-  }
-  Py_END_ALLOW_THREADS
-}
-
-%exception Seiscomp::Client::Connection::recv {
-  Py_BEGIN_ALLOW_THREADS
-  try {
-    $action
-  }
-  catch ( const Swig::DirectorException &e ) {
-    SWIG_fail;
-  }
-  catch ( const Seiscomp::Core::ValueException &e ) {
-    SWIG_exception(SWIG_ValueError, e.what());
-  }
-  catch ( const std::exception &e ) {
-    SWIG_exception(SWIG_RuntimeError, e.what());
-  }
-  catch ( ... ) {
-    SWIG_exception(SWIG_UnknownError, "C++ anonymous exception");
-  }
-  Py_END_ALLOW_THREADS
-}
+releaseGIL(Seiscomp::Client::Connection::connect);
+releaseGIL(Seiscomp::Client::Connection::reconnect);
+releaseGIL(Seiscomp::Client::Connection::disconnect);
+releaseGIL(Seiscomp::Client::Connection::close);
+releaseGIL(Seiscomp::Client::Connection::subscribe);
+releaseGIL(Seiscomp::Client::Connection::unsubscribe);
+releaseGIL(Seiscomp::Client::Connection::fetchInbox);
+releaseGIL(Seiscomp::Client::Connection::syncOutbox);
+releaseGIL(Seiscomp::Client::Connection::recv);
+releaseGIL(Seiscomp::Client::Connection::send);
+releaseGIL(Seiscomp::Client::Connection::sendMessage);
 
 
 
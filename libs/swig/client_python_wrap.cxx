@@ -3995,6 +3995,20 @@ namespace swig {
 #include "seiscomp/math/restitution/transferfunction.h"
 
 
+namespace {
+
+class GILRelease {
+	public:
+		GILRelease() : _state(PyEval_SaveThread()) {}
+		~GILRelease() { PyEval_RestoreThread(_state); }
+
+	private:
+		PyThreadState *_state;
+};
+
+}
+
+
 
 #include <typeinfo>
 #include <stdexcept>
@@ -13441,6 +13455,7 @@ SWIGINTERN PyObject *_wrap_Connection_connect__SWIG_0(PyObject *SWIGUNUSEDPARM(s
   arg4 = static_cast< unsigned int >(val4);
   {
     try {
+      GILRelease release;
       result = (arg1)->connect((std::string const &)*arg2,(std::string const &)*arg3,arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -13511,6 +13526,7 @@ SWIGINTERN PyObject *_wrap_Connection_connect__SWIG_1(PyObject *SWIGUNUSEDPARM(s
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->connect((std::string const &)*arg2,(std::string const &)*arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -13615,6 +13631,7 @@ SWIGINTERN PyObject *_wrap_Connection_disconnect(PyObject *SWIGUNUSEDPARM(self),
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
     try {
+      GILRelease release;
       result = (arg1)->disconnect();
     }
     catch ( const Swig::DirectorException &e ) {
@@ -13696,6 +13713,7 @@ SWIGINTERN PyObject *_wrap_Connection_reconnect(PyObject *SWIGUNUSEDPARM(self),
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
     try {
+      GILRelease release;
       result = (arg1)->reconnect();
     }
     catch ( const Swig::DirectorException &e ) {
@@ -13738,6 +13756,7 @@ SWIGINTERN PyObject *_wrap_Connection_close(PyObject *SWIGUNUSEDPARM(self), PyOb
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
     try {
+      GILRelease release;
       result = (arg1)->close();
     }
     catch ( const Swig::DirectorException &e ) {
@@ -13836,6 +13855,7 @@ SWIGINTERN PyObject *_wrap_Connection_subscribe__SWIG_0(PyObject *SWIGUNUSEDPARM
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (arg1)->subscribe((char const *)arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -13891,6 +13911,7 @@ SWIGINTERN PyObject *_wrap_Connection_subscribe__SWIG_1(PyObject *SWIGUNUSEDPARM
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->subscribe((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -13986,6 +14007,7 @@ SWIGINTERN PyObject *_wrap_Connection_unsubscribe__SWIG_0(PyObject *SWIGUNUSEDPA
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (arg1)->unsubscribe((char const *)arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14041,6 +14063,7 @@ SWIGINTERN PyObject *_wrap_Connection_unsubscribe__SWIG_1(PyObject *SWIGUNUSEDPA
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->unsubscribe((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14128,8 +14151,8 @@ SWIGINTERN PyObject *_wrap_Connection_fetchInbox(PyObject *SWIGUNUSEDPARM(self),
   }
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
-    Py_BEGIN_ALLOW_THREADS
     try {
+      GILRelease release;
       result = (arg1)->fetchInbox();
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14144,7 +14167,6 @@ SWIGINTERN PyObject *_wrap_Connection_fetchInbox(PyObject *SWIGUNUSEDPARM(self),
     catch ( ... ) {
       SWIG_exception(SWIG_UnknownError, "C++ anonymous exception");
     }
-    Py_END_ALLOW_THREADS
   }
   {
     Seiscomp::Client::Result tmp = result;
@@ -14173,6 +14195,7 @@ SWIGINTERN PyObject *_wrap_Connection_syncOutbox(PyObject *SWIGUNUSEDPARM(self),
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
     try {
+      GILRelease release;
       result = (arg1)->syncOutbox();
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14222,8 +14245,8 @@ SWIGINTERN PyObject *_wrap_Connection_recv__SWIG_0(PyObject *SWIGUNUSEDPARM(self
   }
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
-    Py_BEGIN_ALLOW_THREADS
     try {
+      GILRelease release;
       result = (Seiscomp::Core::Message *)(arg1)->recv(arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14238,7 +14261,6 @@ SWIGINTERN PyObject *_wrap_Connection_recv__SWIG_0(PyObject *SWIGUNUSEDPARM(self
     catch ( ... ) {
       SWIG_exception(SWIG_UnknownError, "C++ anonymous exception");
     }
-    Py_END_ALLOW_THREADS
   }
   resultobj = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_Seiscomp__Core__Message, SWIG_POINTER_OWN |  0 );
   {
@@ -14296,8 +14318,8 @@ SWIGINTERN PyObject *_wrap_Connection_recv__SWIG_1(PyObject *SWIGUNUSEDPARM(self
   }
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
-    Py_BEGIN_ALLOW_THREADS
     try {
+      GILRelease release;
       result = (Seiscomp::Core::Message *)(arg1)->recv(arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14312,7 +14334,6 @@ SWIGINTERN PyObject *_wrap_Connection_recv__SWIG_1(PyObject *SWIGUNUSEDPARM(self
     catch ( ... ) {
       SWIG_exception(SWIG_UnknownError, "C++ anonymous exception");
     }
-    Py_END_ALLOW_THREADS
   }
   resultobj = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_Seiscomp__Core__Message, SWIG_POINTER_OWN |  0 );
   {
@@ -14352,8 +14373,8 @@ SWIGINTERN PyObject *_wrap_Connection_recv__SWIG_2(PyObject *SWIGUNUSEDPARM(self
   }
   arg1 = reinterpret_cast< Seiscomp::Client::Connection * >(argp1);
   {
-    Py_BEGIN_ALLOW_THREADS
     try {
+      GILRelease release;
       result = (Seiscomp::Core::Message *)(arg1)->recv();
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14368,7 +14389,6 @@ SWIGINTERN PyObject *_wrap_Connection_recv__SWIG_2(PyObject *SWIGUNUSEDPARM(self
     catch ( ... ) {
       SWIG_exception(SWIG_UnknownError, "C++ anonymous exception");
     }
-    Py_END_ALLOW_THREADS
   }
   resultobj = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_Seiscomp__Core__Message, SWIG_POINTER_OWN |  0 );
   if (result) result->incrementReferenceCount();
@@ -14447,6 +14467,7 @@ SWIGINTERN PyObject *_wrap_Connection_sendMessage__SWIG_0(PyObject *SWIGUNUSEDPA
   arg2 = reinterpret_cast< Seiscomp::Core::Message * >(argp2);
   {
     try {
+      GILRelease release;
       result = (arg1)->sendMessage((Seiscomp::Core::Message const *)arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14508,6 +14529,7 @@ SWIGINTERN PyObject *_wrap_Connection_sendMessage__SWIG_1(PyObject *SWIGUNUSEDPA
   arg3 = reinterpret_cast< Seiscomp::Core::Message * >(argp3);
   {
     try {
+      GILRelease release;
       result = (arg1)->sendMessage((std::string const &)*arg2,(Seiscomp::Core::Message const *)arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14608,6 +14630,7 @@ SWIGINTERN PyObject *_wrap_Connection_send__SWIG_0(PyObject *SWIGUNUSEDPARM(self
   arg2 = reinterpret_cast< Seiscomp::Core::Message * >(argp2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->send((Seiscomp::Core::Message const *)arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -14666,6 +14689,7 @@ SWIGINTERN PyObject *_wrap_Connection_send__SWIG_1(PyObject *SWIGUNUSEDPARM(self
   arg3 = reinterpret_cast< Seiscomp::Core::Message * >(argp3);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->send((std::string const &)*arg2,(Seiscomp::Core::Message const *)arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -2967,6 +2967,14 @@ namespace swig {
 #include "seiscomp/core/version.h"
 #ifdef HAVE_NUMPY
 #include <numpy/ndarrayobject.h>
+
+// Releases the reference to an array held by a NumPy array which
+// shares its data.
+static void releaseArrayCapsule(PyObject *capsule) {
+	Seiscomp::Array *array = static_cast<Seiscomp::Array*>(
+		PyCapsule_GetPointer(capsule, "Seiscomp::Array"));
+	if ( array ) array->decrementReferenceCount();
+}
 #endif
 
 
@@ -3752,7 +3760,28 @@ SWIGINTERN PyObject *Seiscomp_Array_numpy(Seiscomp::Array *self){
 				SWIG_exception(SWIG_TypeError, "unsupported array type");
 				goto fail;
 		}
-		return PyArray_SimpleNewFromData(1, &n, type, (char*)self->data());
+		{
+			PyObject *arr = PyArray_SimpleNewFromData(1, &n, type, (char*)self->data());
+			if ( arr == NULL ) goto fail;
+
+			// The NumPy array shares the data with self. Keep self alive
+			// as long as the NumPy array exists.
+			PyObject *base = PyCapsule_New(self, "Seiscomp::Array", releaseArrayCapsule);
+			if ( base == NULL ) {
+				Py_DECREF(arr);
+				goto fail;
+			}
+
+			self->incrementReferenceCount();
+			// PyArray_SetBaseObject steals the reference to base even
+			// if it fails
+			if ( PyArray_SetBaseObject((PyArrayObject*)arr, base) < 0 ) {
+				Py_DECREF(arr);
+				goto fail;
+			}
+
+			return arr;
+		}
 #else
 		SWIG_exception(SWIG_SystemError, "missing support for NumPy");
 #endif
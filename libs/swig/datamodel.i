@@ -67,6 +67,53 @@
 %newobject Seiscomp::DataModel::DatabaseReader::loadArclinkLog;
 %newobject Seiscomp::DataModel::DatabaseReader::loadDataAvailability;
 
+%include "gil.i"
+
+// Allow GIL release for database access. Loading object trees with
+// DatabaseReader is excluded because attaching objects to a parent creates
+// notifiers in the global pool.
+releaseGIL(Seiscomp::DataModel::DatabaseArchive::open);
+releaseGIL(Seiscomp::DataModel::DatabaseArchive::getObject);
+releaseGIL(Seiscomp::DataModel::DatabaseIterator::get);
+releaseGIL(Seiscomp::DataModel::DatabaseIterator::step);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getAmplitude);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getAmplitudes);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getAmplitudesForOrigin);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getAmplitudesForPick);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getArclinkRequest);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getArclinkRequestByRequestID);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getArclinkRequestByStreamCode);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getArclinkRequestByTime);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getArclinkRequestByUserID);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getArclinkRequestRestricted);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getArrivalsForAmplitude);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getConfigModule);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEquivalentPick);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEvent);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEventByPreferredMagnitudeID);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEventByPublicID);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEventForFocalMechanism);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEventPickIDs);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEventPickIDsByWeight);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEventPicks);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEventPicksByWeight);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getEvents);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getFocalMechanismsDescending);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getJournal);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getJournalAction);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getOriginByMagnitude);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getOrigins);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getOriginsDescending);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getOriginsForAmplitude);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getOutage);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getPicks);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getPreferredMagnitudes);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getPreferredOrigins);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getQCLog);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getStation);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getWaveformQuality);
+releaseGIL(Seiscomp::DataModel::DatabaseQuery::getWaveformQualityDescending);
+
 %include "datamodelbase.i"
 %include "seiscomp/datamodel/types.h"
 
@@ -3910,6 +3910,20 @@ namespace swig {
 #include "seiscomp/datamodel/version.h"
 
 
+namespace {
+
+class GILRelease {
+	public:
+		GILRelease() : _state(PyEval_SaveThread()) {}
+		~GILRelease() { PyEval_RestoreThread(_state); }
+
+	private:
+		PyThreadState *_state;
+};
+
+}
+
+
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/core/record.h>
 #include <seiscomp/core/greensfunction.h>
@@ -11096,6 +11110,7 @@ SWIGINTERN PyObject *_wrap_DatabaseIterator_get(PyObject *SWIGUNUSEDPARM(self),
   arg1 = reinterpret_cast< Seiscomp::DataModel::DatabaseIterator * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Object *)((Seiscomp::DataModel::DatabaseIterator const *)arg1)->get();
     }
     catch ( const Swig::DirectorException &e ) {
@@ -11533,6 +11548,7 @@ SWIGINTERN PyObject *_wrap_DatabaseIterator_step(PyObject *SWIGUNUSEDPARM(self),
   arg1 = reinterpret_cast< Seiscomp::DataModel::DatabaseIterator * >(argp1);
   {
     try {
+      GILRelease release;
       Seiscomp_DataModel_DatabaseIterator_step(arg1);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -12081,6 +12097,7 @@ SWIGINTERN PyObject *_wrap_DatabaseArchive_open(PyObject *SWIGUNUSEDPARM(self),
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->open((char const *)arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -12390,6 +12407,7 @@ SWIGINTERN PyObject *_wrap_DatabaseArchive_getObject(PyObject *SWIGUNUSEDPARM(se
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::PublicObject *)(arg1)->getObject((Seiscomp::Core::RTTI const &)*arg2,(std::string const &)*arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243126,6 +243144,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getStation(PyObject *SWIGUNUSEDPARM(sel
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Station *)(arg1)->getStation((std::string const &)*arg2,(std::string const &)*arg3,arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243181,6 +243200,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEvent(PyObject *SWIGUNUSEDPARM(self)
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Event *)(arg1)->getEvent((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243234,6 +243254,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEventByPreferredMagnitudeID(PyObject
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Event *)(arg1)->getEventByPreferredMagnitudeID((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243287,6 +243308,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEventForFocalMechanism(PyObject *SWI
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Event *)(arg1)->getEventForFocalMechanism((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243340,6 +243362,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEventByPublicID(PyObject *SWIGUNUSED
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Event *)(arg1)->getEventByPublicID((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243406,6 +243429,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getAmplitude(PyObject *SWIGUNUSEDPARM(s
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Amplitude *)(arg1)->getAmplitude((std::string const &)*arg2,(std::string const &)*arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243480,6 +243504,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getAmplitudes(PyObject *SWIGUNUSEDPARM(
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getAmplitudes(arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243531,6 +243556,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getAmplitudesForPick(PyObject *SWIGUNUS
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getAmplitudesForPick((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243584,6 +243610,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getAmplitudesForOrigin(PyObject *SWIGUN
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getAmplitudesForOrigin((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243637,6 +243664,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getOriginsForAmplitude(PyObject *SWIGUN
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getOriginsForAmplitude((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243690,6 +243718,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getOriginByMagnitude(PyObject *SWIGUNUS
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::DataModel::Origin *)(arg1)->getOriginByMagnitude((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243743,6 +243772,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getArrivalsForAmplitude(PyObject *SWIGU
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getArrivalsForAmplitude((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243795,6 +243825,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getPicks__SWIG_0(PyObject *SWIGUNUSEDPA
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getPicks((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243866,6 +243897,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getPicks__SWIG_1(PyObject *SWIGUNUSEDPA
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getPicks(arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -243946,6 +243978,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getPicks__SWIG_2(PyObject *SWIGUNUSEDPA
   arg4 = reinterpret_cast< Seiscomp::DataModel::WaveformStreamID * >(argp4);
   {
     try {
+      GILRelease release;
       result = (arg1)->getPicks(arg2,arg3,(Seiscomp::DataModel::WaveformStreamID const &)*arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244066,6 +244099,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getWaveformQuality__SWIG_0(PyObject *SW
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getWaveformQuality((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244161,6 +244195,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getWaveformQuality__SWIG_1(PyObject *SW
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getWaveformQuality((Seiscomp::DataModel::WaveformStreamID const &)*arg2,(std::string const &)*arg3,arg4,arg5);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244232,6 +244267,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getWaveformQuality__SWIG_2(PyObject *SW
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getWaveformQuality(arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244338,6 +244374,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getWaveformQuality__SWIG_3(PyObject *SW
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getWaveformQuality((Seiscomp::DataModel::WaveformStreamID const &)*arg2,(std::string const &)*arg3,(std::string const &)*arg4,arg5,arg6);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244521,6 +244558,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getWaveformQualityDescending(PyObject *
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getWaveformQualityDescending((Seiscomp::DataModel::WaveformStreamID const &)*arg2,(std::string const &)*arg3,(std::string const &)*arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244606,6 +244644,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getOutage(PyObject *SWIGUNUSEDPARM(self
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getOutage((Seiscomp::DataModel::WaveformStreamID const &)*arg2,arg3,arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244687,6 +244726,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getQCLog(PyObject *SWIGUNUSEDPARM(self)
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getQCLog((Seiscomp::DataModel::WaveformStreamID const &)*arg2,arg3,arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244770,6 +244810,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getPreferredOrigins(PyObject *SWIGUNUSE
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getPreferredOrigins(arg2,arg3,(std::string const &)*arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244855,6 +244896,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getPreferredMagnitudes(PyObject *SWIGUN
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getPreferredMagnitudes(arg2,arg3,(std::string const &)*arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244927,6 +244969,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEvents(PyObject *SWIGUNUSEDPARM(self
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getEvents(arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -244978,6 +245021,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getOrigins(PyObject *SWIGUNUSEDPARM(sel
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getOrigins((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245031,6 +245075,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getOriginsDescending(PyObject *SWIGUNUS
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getOriginsDescending((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245084,6 +245129,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getFocalMechanismsDescending(PyObject *
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getFocalMechanismsDescending((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245137,6 +245183,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEventPickIDs(PyObject *SWIGUNUSEDPAR
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getEventPickIDs((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245198,6 +245245,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEventPickIDsByWeight(PyObject *SWIGU
   arg3 = static_cast< double >(val3);
   {
     try {
+      GILRelease release;
       result = (arg1)->getEventPickIDsByWeight((std::string const &)*arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245251,6 +245299,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEventPicks(PyObject *SWIGUNUSEDPARM(
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getEventPicks((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245312,6 +245361,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEventPicksByWeight(PyObject *SWIGUNU
   arg3 = static_cast< double >(val3);
   {
     try {
+      GILRelease release;
       result = (arg1)->getEventPicksByWeight((std::string const &)*arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245373,6 +245423,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getConfigModule(PyObject *SWIGUNUSEDPAR
   arg3 = static_cast< bool >(val3);
   {
     try {
+      GILRelease release;
       result = (arg1)->getConfigModule((std::string const &)*arg2,arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245497,6 +245548,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getEquivalentPick(PyObject *SWIGUNUSEDP
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getEquivalentPick((std::string const &)*arg2,(std::string const &)*arg3,(std::string const &)*arg4,(std::string const &)*arg5,arg6,arg7);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245556,6 +245608,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getJournal(PyObject *SWIGUNUSEDPARM(sel
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getJournal((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245622,6 +245675,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getJournalAction(PyObject *SWIGUNUSEDPA
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getJournalAction((std::string const &)*arg2,(std::string const &)*arg3);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245761,6 +245815,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getArclinkRequestByStreamCode(PyObject
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getArclinkRequestByStreamCode(arg2,arg3,(std::string const &)*arg4,(std::string const &)*arg5,(std::string const &)*arg6,(std::string const &)*arg7,(std::string const &)*arg8);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245822,6 +245877,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getArclinkRequestByRequestID(PyObject *
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getArclinkRequestByRequestID((std::string const &)*arg2);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -245920,6 +245976,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getArclinkRequestByUserID(PyObject *SWI
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getArclinkRequestByUserID((std::string const &)*arg2,arg3,arg4,(std::string const &)*arg5);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -246007,6 +246064,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getArclinkRequestByTime(PyObject *SWIGU
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getArclinkRequestByTime(arg2,arg3,(std::string const &)*arg4);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -246170,6 +246228,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getArclinkRequest(PyObject *SWIGUNUSEDP
   }
   {
     try {
+      GILRelease release;
       result = (arg1)->getArclinkRequest((std::string const &)*arg2,arg3,arg4,(std::string const &)*arg5,(std::string const &)*arg6,(std::string const &)*arg7,(std::string const &)*arg8,(std::string const &)*arg9,(std::string const &)*arg10);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -246353,6 +246412,7 @@ SWIGINTERN PyObject *_wrap_DatabaseQuery_getArclinkRequestRestricted(PyObject *S
   arg11 = static_cast< bool >(val11);
   {
     try {
+      GILRelease release;
       result = (arg1)->getArclinkRequestRestricted((std::string const &)*arg2,arg3,arg4,(std::string const &)*arg5,(std::string const &)*arg6,(std::string const &)*arg7,(std::string const &)*arg8,(std::string const &)*arg9,(std::string const &)*arg10,arg11);
     }
     catch ( const Swig::DirectorException &e ) {
@@ -0,0 +1,64 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+/* Releases the global interpreter lock while a wrapped method is running.
+ * This is meant for calls which block on I/O or take long to compute. Such
+ * methods must neither touch Python objects nor call director methods.
+ */
+
+%{
+namespace {
+
+class GILRelease {
+	public:
+		GILRelease() : _state(PyEval_SaveThread()) {}
+		~GILRelease() { PyEval_RestoreThread(_state); }
+
+	private:
+		PyThreadState *_state;
+};
+
+}
+%}
+
+
+/* The GIL is acquired again before an exception is converted */
+%define releaseGIL(_method)
+
+%exception _method {
+  try {
+    GILRelease release;
+    $action
+  }
+  catch ( const Swig::DirectorException &e ) {
+    SWIG_fail;
+  }
+  catch ( const Seiscomp::Core::ValueException &e ) {
+    SWIG_exception(SWIG_ValueError, e.what());
+  }
+  catch ( const std::exception &e ) {
+    SWIG_exception(SWIG_RuntimeError, e.what());
+  }
+  catch ( ... ) {
+    SWIG_exception(SWIG_UnknownError, "C++ anonymous exception");
+  }
+}
+
+%enddef
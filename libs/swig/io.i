@@ -38,6 +38,7 @@
 #include <seiscomp/math/filter/taper.h>
 #include <seiscomp/math/filter/seismometers.h>
 #include <seiscomp/math/restitution/transferfunction.h>
+#include <seiscomp/io/bulkrecordreader.h>
 #include <seiscomp/io/database.h>
 #include <seiscomp/io/recordinput.h>
 #include <seiscomp/io/recordstream.h>
@@ -72,6 +73,9 @@
 %newobject Seiscomp::IO::Importer::read;
 %newobject Seiscomp::IO::GFArchive::get;
 %newobject Seiscomp::IO::Exporter::Create;
+%newobject Seiscomp::IO::BulkRecordReader::contiguousRecord;
+%newobject Seiscomp::IO::BulkRecordReader::headers;
+%ignore Seiscomp::IO::BulkRecordReader::sequence;
 
 %include std_ios.i
 %include std_char_traits.i
@@ -96,6 +100,52 @@
   }
 }
 
+%include "gil.i"
+
+// Allow GIL release for blocking I/O, decoding and filtering
+releaseGIL(Seiscomp::IO::RecordStream::Open);
+releaseGIL(Seiscomp::IO::RecordStream::setSource);
+releaseGIL(Seiscomp::IO::RecordStream::next);
+releaseGIL(Seiscomp::RecordStream::File::setSource);
+releaseGIL(Seiscomp::RecordStream::File::next);
+releaseGIL(Seiscomp::RecordStream::SLConnection::setSource);
+releaseGIL(Seiscomp::RecordStream::SLConnection::next);
+releaseGIL(Seiscomp::RecordStream::Arclink::ArclinkConnection::setSource);
+releaseGIL(Seiscomp::RecordStream::Arclink::ArclinkConnection::next);
+releaseGIL(Seiscomp::RecordStream::CombinedConnection::setSource);
+releaseGIL(Seiscomp::RecordStream::CombinedConnection::next);
+releaseGIL(Seiscomp::IO::RecordInput::next);
+releaseGIL(Seiscomp::IO::BulkRecordReader::read);
+releaseGIL(Seiscomp::IO::BulkRecordReader::contiguousRecord);
+releaseGIL(Seiscomp::IO::MSeedRecord::read);
+releaseGIL(Seiscomp::IO::DatabaseInterface::Open);
+releaseGIL(Seiscomp::IO::DatabaseInterface::connect);
+releaseGIL(Seiscomp::IO::DatabaseInterface::execute);
+releaseGIL(Seiscomp::IO::DatabaseInterface::beginQuery);
+releaseGIL(Seiscomp::IO::DatabaseInterface::fetchRow);
+releaseGIL(Seiscomp::IO::XMLArchive::open);
+releaseGIL(Seiscomp::IO::XMLArchive::create);
+releaseGIL(Seiscomp::IO::XMLArchive::close);
+releaseGIL(Seiscomp::IO::BinaryArchive::open);
+releaseGIL(Seiscomp::IO::BinaryArchive::create);
+releaseGIL(Seiscomp::IO::BinaryArchive::close);
+releaseGIL(Seiscomp::IO::VBinaryArchive::open);
+releaseGIL(Seiscomp::IO::VBinaryArchive::create);
+releaseGIL(Seiscomp::IO::VBinaryArchive::close);
+releaseGIL(Seiscomp::IO::Importer::read);
+releaseGIL(Seiscomp::IO::RecordFilterInterface::feed);
+releaseGIL(Seiscomp::IO::RecordFilterInterface::flush);
+releaseGIL(Seiscomp::IO::PipeFilter::feed);
+releaseGIL(Seiscomp::IO::PipeFilter::flush);
+releaseGIL(Seiscomp::IO::Cropper::feed);
+releaseGIL(Seiscomp::IO::Cropper::flush);
+releaseGIL(Seiscomp::IO::RecordDemuxFilter::feed);
+releaseGIL(Seiscomp::IO::RecordDemuxFilter::flush);
+releaseGIL(Seiscomp::IO::RecordIIRFilter::feed);
+releaseGIL(Seiscomp::IO::RecordIIRFilter::flush);
+releaseGIL(Seiscomp::IO::RecordResamplerBase::flush);
+releaseGIL(Seiscomp::IO::RecordResampler::feed);
+
 %typemap(in) (const char *data, int size) {
     $1 = PyBytes_AsString($input);
     $2 = PyBytes_Size($input);
@@ -111,6 +161,7 @@
 %include "seiscomp/io/gfarchive.h"
 %include "seiscomp/io/recordstream.h"
 %include "seiscomp/io/recordinput.h"
+%include "seiscomp/io/bulkrecordreader.h"
 %include "seiscomp/io/recordfilter.h"
 %include "seiscomp/io/recordfilter/pipe.h"
 %include "seiscomp/io/recordfilter/crop.h"
@@ -153,6 +204,44 @@
 };
 
 
+%extend Seiscomp::IO::BulkRecordReader {
+	%pythoncode %{
+		def numpy(self, streamID, dataType=None, interpolate=False):
+		    """
+		    Returns the merged samples of a stream as tuple of the time of
+		    the first sample and a NumPy array. The NumPy array shares the
+		    samples with the merged record and keeps it alive. Returns
+		    None if nothing has been read for the stream.
+		    """
+		    if dataType is None:
+		        dataType = seiscomp.core.Array.DOUBLE
+		    rec = self.contiguousRecord(streamID, dataType, interpolate)
+		    if rec is None:
+		        return None
+		    return rec.startTime(), rec.data().numpy()
+
+		def headersNumpy(self, streamID):
+		    """
+		    Returns the headers of all records of a stream as NumPy
+		    structured array with the fields startTime, endTime,
+		    samplingFrequency, sampleCount and timingQuality. Times are
+		    seconds since epoch. Returns None if nothing has been read for
+		    the stream.
+		    """
+		    import numpy
+		    hdr = self.headers(streamID)
+		    if hdr is None:
+		        return None
+		    dtype = numpy.dtype([
+		        ("startTime", "f8"), ("endTime", "f8"),
+		        ("samplingFrequency", "f8"), ("sampleCount", "f8"),
+		        ("timingQuality", "f8")
+		    ])
+		    return hdr.numpy().view(dtype)
+	%}
+};
+
+
 %template(RecordIIRFilterF) Seiscomp::IO::RecordIIRFilter<float>;
 %template(RecordIIRFilterD) Seiscomp::IO::RecordIIRFilter<double>;
 
@@ -161,3 +250,4 @@
 %template(RecordResamplerI) Seiscomp::IO::RecordResampler<int>;
 
 %template(ExportObjectList) std::vector<Seiscomp::Core::BaseObject*>;
+%template(StreamIDList) std::vector<std::string>;
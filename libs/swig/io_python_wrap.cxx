@@ -3518,6 +3518,20 @@ namespace swig {
 #include <seiscomp/io/recordstream/combined.h>
 
 
+namespace {
+
+class GILRelease {
+	public:
+		GILRelease() : _state(PyEval_SaveThread()) {}
+		~GILRelease() { PyEval_RestoreThread(_state); }
+
+	private:
+		PyThreadState *_state;
+};
+
+}
+
+
 #include <typeinfo>
 #include <stdexcept>
 
@@ -8963,6 +8977,7 @@ SWIGINTERN PyObject *_wrap_DatabaseInterface_Open(PyObject *SWIGUNUSEDPARM(self)
   arg1 = reinterpret_cast< char * >(buf1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::IO::DatabaseInterface *)Seiscomp::IO::DatabaseInterface::Open((char const *)arg1);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -9010,6 +9025,7 @@ SWIGINTERN PyObject *_wrap_DatabaseInterface_connect(PyObject *SWIGUNUSEDPARM(se
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->connect((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -9232,6 +9248,7 @@ SWIGINTERN PyObject *_wrap_DatabaseInterface_execute(PyObject *SWIGUNUSEDPARM(se
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->execute((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -9278,6 +9295,7 @@ SWIGINTERN PyObject *_wrap_DatabaseInterface_beginQuery(PyObject *SWIGUNUSEDPARM
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->beginQuery((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -9469,6 +9487,7 @@ SWIGINTERN PyObject *_wrap_DatabaseInterface_fetchRow(PyObject *SWIGUNUSEDPARM(s
   arg1 = reinterpret_cast< Seiscomp::IO::DatabaseInterface * >(argp1);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->fetchRow();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -12153,6 +12172,7 @@ SWIGINTERN PyObject *_wrap_RecordStream_setSource(PyObject *SWIGUNUSEDPARM(self)
   }
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->setSource((std::string const &)*arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -12823,6 +12843,7 @@ SWIGINTERN PyObject *_wrap_RecordStream_next(PyObject *SWIGUNUSEDPARM(self), PyO
   arg1 = reinterpret_cast< Seiscomp::IO::RecordStream * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->next();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -12901,6 +12922,7 @@ SWIGINTERN PyObject *_wrap_RecordStream_Open(PyObject *SWIGUNUSEDPARM(self), PyO
   arg1 = reinterpret_cast< char * >(buf1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::IO::RecordStream *)Seiscomp::IO::RecordStream::Open((char const *)arg1);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -13557,6 +13579,7 @@ SWIGINTERN PyObject *_wrap_RecordInput_next(PyObject *SWIGUNUSEDPARM(self), PyOb
   arg1 = reinterpret_cast< Seiscomp::IO::RecordInput * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->next();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -13682,6 +13705,7 @@ SWIGINTERN PyObject *_wrap_RecordFilterInterface_feed(PyObject *SWIGUNUSEDPARM(s
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -13719,6 +13743,7 @@ SWIGINTERN PyObject *_wrap_RecordFilterInterface_flush(PyObject *SWIGUNUSEDPARM(
   arg1 = reinterpret_cast< Seiscomp::IO::RecordFilterInterface * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->flush();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -13992,6 +14017,7 @@ SWIGINTERN PyObject *_wrap_PipeFilter_feed(PyObject *SWIGUNUSEDPARM(self), PyObj
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -14029,6 +14055,7 @@ SWIGINTERN PyObject *_wrap_PipeFilter_flush(PyObject *SWIGUNUSEDPARM(self), PyOb
   arg1 = reinterpret_cast< Seiscomp::IO::PipeFilter * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->flush();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -14355,6 +14382,7 @@ SWIGINTERN PyObject *_wrap_Cropper_feed(PyObject *SWIGUNUSEDPARM(self), PyObject
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -14392,6 +14420,7 @@ SWIGINTERN PyObject *_wrap_Cropper_flush(PyObject *SWIGUNUSEDPARM(self), PyObjec
   arg1 = reinterpret_cast< Seiscomp::IO::Cropper * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->flush();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -14715,6 +14744,7 @@ SWIGINTERN PyObject *_wrap_RecordDemuxFilter_feed(PyObject *SWIGUNUSEDPARM(self)
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -14752,6 +14782,7 @@ SWIGINTERN PyObject *_wrap_RecordDemuxFilter_flush(PyObject *SWIGUNUSEDPARM(self
   arg1 = reinterpret_cast< Seiscomp::IO::RecordDemuxFilter * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->flush();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -14872,6 +14903,7 @@ SWIGINTERN PyObject *_wrap_RecordResamplerBase_flush(PyObject *SWIGUNUSEDPARM(se
   arg1 = reinterpret_cast< Seiscomp::IO::RecordResamplerBase * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->flush();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -15663,6 +15695,7 @@ SWIGINTERN PyObject *_wrap_Importer_read__SWIG_0(PyObject *SWIGUNUSEDPARM(self),
   arg2 = reinterpret_cast< std::streambuf * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Core::BaseObject *)(arg1)->read(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -15708,6 +15741,7 @@ SWIGINTERN PyObject *_wrap_Importer_read__SWIG_1(PyObject *SWIGUNUSEDPARM(self),
   }
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Core::BaseObject *)(arg1)->read(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17213,6 +17247,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_open__SWIG_0(PyObject *SWIGUNUSEDPARM(self
   arg2 = reinterpret_cast< std::streambuf * >(argp2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->open(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17256,6 +17291,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_open__SWIG_1(PyObject *SWIGUNUSEDPARM(self
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->open((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17361,6 +17397,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_create__SWIG_0(PyObject *SWIGUNUSEDPARM(se
   arg4 = static_cast< bool >(val4);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create(arg2,arg3,arg4);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17411,6 +17448,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_create__SWIG_1(PyObject *SWIGUNUSEDPARM(se
   arg3 = static_cast< bool >(val3);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create(arg2,arg3);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17453,6 +17491,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_create__SWIG_2(PyObject *SWIGUNUSEDPARM(se
   arg2 = reinterpret_cast< std::streambuf * >(argp2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17512,6 +17551,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_create__SWIG_3(PyObject *SWIGUNUSEDPARM(se
   arg4 = static_cast< bool >(val4);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create((char const *)arg2,arg3,arg4);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17565,6 +17605,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_create__SWIG_4(PyObject *SWIGUNUSEDPARM(se
   arg3 = static_cast< bool >(val3);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create((char const *)arg2,arg3);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17610,6 +17651,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_create__SWIG_5(PyObject *SWIGUNUSEDPARM(se
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -17786,6 +17828,7 @@ SWIGINTERN PyObject *_wrap_XMLArchive_close(PyObject *SWIGUNUSEDPARM(self), PyOb
   arg1 = reinterpret_cast< Seiscomp::IO::XMLArchive * >(argp1);
   {
     try {
+      GILRelease release;
       (arg1)->close();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -20830,6 +20873,7 @@ SWIGINTERN PyObject *_wrap_BinaryArchive_open__SWIG_0(PyObject *SWIGUNUSEDPARM(s
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->open((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -20874,6 +20918,7 @@ SWIGINTERN PyObject *_wrap_BinaryArchive_open__SWIG_1(PyObject *SWIGUNUSEDPARM(s
   arg2 = reinterpret_cast< std::streambuf * >(argp2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->open(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -20962,6 +21007,7 @@ SWIGINTERN PyObject *_wrap_BinaryArchive_create__SWIG_0(PyObject *SWIGUNUSEDPARM
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -21006,6 +21052,7 @@ SWIGINTERN PyObject *_wrap_BinaryArchive_create__SWIG_1(PyObject *SWIGUNUSEDPARM
   arg2 = reinterpret_cast< std::streambuf * >(argp2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -21086,6 +21133,7 @@ SWIGINTERN PyObject *_wrap_BinaryArchive_close(PyObject *SWIGUNUSEDPARM(self), P
   arg1 = reinterpret_cast< Seiscomp::IO::BinaryArchive * >(argp1);
   {
     try {
+      GILRelease release;
       (arg1)->close();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -23943,6 +23991,7 @@ SWIGINTERN PyObject *_wrap_VBinaryArchive_open__SWIG_0(PyObject *SWIGUNUSEDPARM(
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->open((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -23987,6 +24036,7 @@ SWIGINTERN PyObject *_wrap_VBinaryArchive_open__SWIG_1(PyObject *SWIGUNUSEDPARM(
   arg2 = reinterpret_cast< std::streambuf * >(argp2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->open(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -24075,6 +24125,7 @@ SWIGINTERN PyObject *_wrap_VBinaryArchive_create__SWIG_0(PyObject *SWIGUNUSEDPAR
   arg2 = reinterpret_cast< char * >(buf2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create((char const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -24119,6 +24170,7 @@ SWIGINTERN PyObject *_wrap_VBinaryArchive_create__SWIG_1(PyObject *SWIGUNUSEDPAR
   arg2 = reinterpret_cast< std::streambuf * >(argp2);
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->create(arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -24199,6 +24251,7 @@ SWIGINTERN PyObject *_wrap_VBinaryArchive_close(PyObject *SWIGUNUSEDPARM(self),
   arg1 = reinterpret_cast< Seiscomp::IO::VBinaryArchive * >(argp1);
   {
     try {
+      GILRelease release;
       (arg1)->close();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -26380,6 +26433,7 @@ SWIGINTERN PyObject *_wrap_MSeedRecord_read(PyObject *SWIGUNUSEDPARM(self), PyOb
   arg2 = reinterpret_cast< std::istream * >(argp2);
   {
     try {
+      GILRelease release;
       (arg1)->read(*arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -26659,6 +26713,7 @@ SWIGINTERN PyObject *_wrap_FileRecordStream_setSource(PyObject *SWIGUNUSEDPARM(s
   }
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->setSource((std::string const &)*arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -27156,6 +27211,7 @@ SWIGINTERN PyObject *_wrap_FileRecordStream_next(PyObject *SWIGUNUSEDPARM(self),
   arg1 = reinterpret_cast< Seiscomp::RecordStream::File * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->next();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -29005,6 +29061,7 @@ SWIGINTERN PyObject *_wrap_SLConnection_setSource(PyObject *SWIGUNUSEDPARM(self)
   }
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->setSource((std::string const &)*arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -29499,6 +29556,7 @@ SWIGINTERN PyObject *_wrap_SLConnection_next(PyObject *SWIGUNUSEDPARM(self), PyO
   arg1 = reinterpret_cast< Seiscomp::RecordStream::SLConnection * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->next();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -30437,6 +30495,7 @@ SWIGINTERN PyObject *_wrap_ArclinkConnection_setSource(PyObject *SWIGUNUSEDPARM(
   }
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->setSource((std::string const &)*arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -30986,6 +31045,7 @@ SWIGINTERN PyObject *_wrap_ArclinkConnection_next(PyObject *SWIGUNUSEDPARM(self)
   arg1 = reinterpret_cast< Seiscomp::RecordStream::Arclink::_private::ArclinkConnection * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->next();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -31292,6 +31352,7 @@ SWIGINTERN PyObject *_wrap_CombinedConnection_setSource(PyObject *SWIGUNUSEDPARM
   }
   {
     try {
+      GILRelease release;
       result = (bool)(arg1)->setSource((std::string const &)*arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -31786,6 +31847,7 @@ SWIGINTERN PyObject *_wrap_CombinedConnection_next(PyObject *SWIGUNUSEDPARM(self
   arg1 = reinterpret_cast< Seiscomp::RecordStream::CombinedConnection * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->next();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -32227,6 +32289,7 @@ SWIGINTERN PyObject *_wrap_RecordIIRFilterF_feed(PyObject *SWIGUNUSEDPARM(self),
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -32264,6 +32327,7 @@ SWIGINTERN PyObject *_wrap_RecordIIRFilterF_flush(PyObject *SWIGUNUSEDPARM(self)
   arg1 = reinterpret_cast< Seiscomp::IO::RecordIIRFilter< float > * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->flush();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -32777,6 +32841,7 @@ SWIGINTERN PyObject *_wrap_RecordIIRFilterD_feed(PyObject *SWIGUNUSEDPARM(self),
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -32814,6 +32879,7 @@ SWIGINTERN PyObject *_wrap_RecordIIRFilterD_flush(PyObject *SWIGUNUSEDPARM(self)
   arg1 = reinterpret_cast< Seiscomp::IO::RecordIIRFilter< double > * >(argp1);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->flush();
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -33362,6 +33428,7 @@ SWIGINTERN PyObject *_wrap_RecordResamplerF_feed(PyObject *SWIGUNUSEDPARM(self),
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -33910,6 +33977,7 @@ SWIGINTERN PyObject *_wrap_RecordResamplerD_feed(PyObject *SWIGUNUSEDPARM(self),
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -34458,6 +34526,7 @@ SWIGINTERN PyObject *_wrap_RecordResamplerI_feed(PyObject *SWIGUNUSEDPARM(self),
   arg2 = reinterpret_cast< Seiscomp::Record * >(argp2);
   {
     try {
+      GILRelease release;
       result = (Seiscomp::Record *)(arg1)->feed((Seiscomp::Record const *)arg2);
     }
     catch ( const Seiscomp::Core::ValueException &e) {
@@ -25,18 +25,16 @@
 #include "mysqldatabaseinterface.h"
 #include <seiscomp/logging/log.h>
 #include <seiscomp/core/plugin.h>
+#include <seiscomp/core/strings.h>
 #include <seiscomp/core/system.h>
 #include <string.h>
+#include <algorithm>
 #if defined(WIN32)
 #include <errmsg.h>
 #else
 #include <mysql/errmsg.h>
 #endif
 
-#if LIBMYSQL_VERSION_ID >= 80000
-typedef bool my_bool;
-#endif
-
 
 namespace Seiscomp {
 namespace Database {
@@ -62,6 +60,16 @@ MySQLDatabase::~MySQLDatabase() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MySQLDatabase::Statement::~Statement() {
+	if ( meta ) mysql_free_result(meta);
+	if ( handle ) mysql_stmt_close(handle);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool MySQLDatabase::handleURIParameter(const std::string &name,
                                        const std::string &value) {
@@ -72,6 +80,12 @@ bool MySQLDatabase::handleURIParameter(const std::string &name,
 			_debug = true;
 		}
 	}
+	else if ( name == "fetch_size" ) {
+		if ( !Core::fromString(_fetchSize, value) ) {
+			SEISCOMP_ERROR("fetch_size: invalid number: %s", value.c_str());
+			return false;
+		}
+	}
 
 	return true;
 }
@@ -143,6 +157,7 @@ void MySQLDatabase::disconnect() {
 			mysql_free_result(_result);
 			_result = nullptr;
 		}
+		dropStatements();
 		mysql_close(_handle);
 		_handle = nullptr;
 	}
@@ -187,6 +202,9 @@ bool MySQLDatabase::ping() const {
 		return false;
 	}
 
+	// Server side prepared statements are gone
+	_reconnected = true;
+
 	return mysql_ping(_handle) == 0;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -226,6 +244,8 @@ bool MySQLDatabase::query(const char *c, const char *comp) {
 	// No connection yet established or disconnect has been called
 	if ( !_handle || !c ) return false;
 
+	_lastStatement = nullptr;
+
 	unsigned int err;
 	const char *err_msg;
 	bool firstTry = true;
@@ -277,6 +297,224 @@ bool MySQLDatabase::query(const char *c, const char *comp) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MySQLDatabase::dropStatements() {
+	endQuery();
+	_lastStatement = nullptr;
+	_statements.clear();
+	_reconnected = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MySQLDatabase::Statement *
+MySQLDatabase::statement(const char *command, unsigned int &err,
+                         std::string &errMsg) {
+	if ( _reconnected ) dropStatements();
+
+	auto it = _statements.find(command);
+	if ( it != _statements.end() ) return it->second.get();
+
+	std::unique_ptr<Statement> stmt(new Statement);
+	stmt->handle = mysql_stmt_init(_handle);
+	if ( !stmt->handle ) {
+		err = mysql_errno(_handle);
+		errMsg = mysql_error(_handle);
+		return nullptr;
+	}
+
+	if ( mysql_stmt_prepare(stmt->handle, command, strlen(command)) ) {
+		err = mysql_stmt_errno(stmt->handle);
+		errMsg = mysql_stmt_error(stmt->handle);
+		return nullptr;
+	}
+
+	// Let mysql_stmt_store_result compute the maximum field lengths to
+	// size the result buffers
+	my_bool updateMaxLength = 1;
+	mysql_stmt_attr_set(stmt->handle, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+	Statement *s = stmt.get();
+	_statements[command] = std::move(stmt);
+	return s;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MySQLDatabase::Statement *
+MySQLDatabase::executePrepared(const char *command, const Parameters &params,
+                               const char *comp, bool cursor) {
+	// No connection yet established or disconnect has been called
+	if ( !_handle || !command ) return nullptr;
+
+	_lastStatement = nullptr;
+
+	unsigned int err = 0;
+	std::string errMsg;
+	bool firstTry = true;
+
+	do {
+		if ( _debug )
+			SEISCOMP_DEBUG("[mysql-%s] %s", comp, command);
+
+		err = 0;
+		Statement *stmt = statement(command, err, errMsg);
+		if ( stmt ) {
+			if ( mysql_stmt_param_count(stmt->handle) != params.size() ) {
+				SEISCOMP_ERROR("%s(\"%s\"): expected %lu parameters, got %d",
+				               comp, command,
+				               static_cast<unsigned long>(mysql_stmt_param_count(stmt->handle)),
+				               static_cast<int>(params.size()));
+				return nullptr;
+			}
+
+			std::vector<MYSQL_BIND> binds(params.size());
+			memset(binds.data(), 0, binds.size() * sizeof(MYSQL_BIND));
+
+			for ( size_t i = 0; i < params.size(); ++i ) {
+				const Parameter &param = params[i];
+				switch ( param.type ) {
+					case Parameter::Integer:
+						binds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+						binds[i].buffer = const_cast<int64_t*>(&param.integer);
+						break;
+					case Parameter::Float:
+						binds[i].buffer_type = MYSQL_TYPE_DOUBLE;
+						binds[i].buffer = const_cast<double*>(&param.number);
+						break;
+					case Parameter::Text:
+						binds[i].buffer_type = MYSQL_TYPE_STRING;
+						binds[i].buffer = const_cast<char*>(param.text.data());
+						binds[i].buffer_length = param.text.size();
+						break;
+					default:
+						binds[i].buffer_type = MYSQL_TYPE_NULL;
+						break;
+				}
+			}
+
+			// The rows of a cursor are kept by the server and fetched in
+			// blocks of fetch size rows
+			unsigned long cursorType = cursor && _fetchSize > 0 ?
+				CURSOR_TYPE_READ_ONLY : CURSOR_TYPE_NO_CURSOR;
+			mysql_stmt_attr_set(stmt->handle, STMT_ATTR_CURSOR_TYPE, &cursorType);
+			if ( cursorType != CURSOR_TYPE_NO_CURSOR )
+				mysql_stmt_attr_set(stmt->handle, STMT_ATTR_PREFETCH_ROWS, &_fetchSize);
+
+			if ( (binds.empty() || !mysql_stmt_bind_param(stmt->handle, binds.data()))
+			  && !mysql_stmt_execute(stmt->handle) ) {
+				if ( _debug )
+					SEISCOMP_DEBUG("[mysql-%s] OK", comp);
+				_lastStatement = stmt;
+				return stmt;
+			}
+
+			err = mysql_stmt_errno(stmt->handle);
+			errMsg = mysql_stmt_error(stmt->handle);
+		}
+
+		// Client connection error?
+		if ( err >= CR_UNKNOWN_ERROR && firstTry ) {
+			firstTry = false;
+			dropStatements();
+			if ( ping() ) continue;
+		}
+
+		break;
+	}
+	while ( true );
+
+	SEISCOMP_ERROR("%s(\"%s\") = %d (%s)", comp, command, err,
+	               errMsg.empty() ? "unknown" : errMsg.c_str());
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MySQLDatabase::execute(const char* command, const Parameters &params) {
+	Statement *stmt = executePrepared(command, params, "execute");
+	if ( !stmt ) return false;
+
+	mysql_stmt_free_result(stmt->handle);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MySQLDatabase::beginQuery(const char* q, const Parameters &params) {
+	if ( _result || _activeStatement ) {
+		SEISCOMP_ERROR("beginQuery: nested queries are not supported");
+		return false;
+	}
+
+	Statement *stmt = executePrepared(q, params, "query", true);
+	if ( !stmt ) return false;
+
+	stmt->meta = mysql_stmt_result_metadata(stmt->handle);
+	if ( !stmt->meta ) {
+		mysql_stmt_free_result(stmt->handle);
+		return false;
+	}
+
+	// A cursor keeps the result on the server. The maximum field lengths
+	// are unknown then and truncated columns are fetched again in
+	// fetchRow.
+	if ( !_fetchSize && mysql_stmt_store_result(stmt->handle) ) {
+		SEISCOMP_ERROR("query(\"%s\") = %d (%s)", q,
+		               mysql_stmt_errno(stmt->handle), mysql_stmt_error(stmt->handle));
+		mysql_free_result(stmt->meta);
+		stmt->meta = nullptr;
+		return false;
+	}
+
+	// All columns are transferred as strings to keep getRowField
+	// compatible with the text protocol
+	_fieldCount = static_cast<int>(mysql_num_fields(stmt->meta));
+	MYSQL_FIELD *fields = mysql_fetch_fields(stmt->meta);
+
+	stmt->results.resize(_fieldCount);
+	stmt->buffers.resize(_fieldCount);
+	stmt->lengths.assign(_fieldCount, 0);
+	stmt->nulls.reset(new my_bool[_fieldCount]());
+	memset(stmt->results.data(), 0, stmt->results.size() * sizeof(MYSQL_BIND));
+
+	for ( int i = 0; i < _fieldCount; ++i ) {
+		stmt->buffers[i].resize(std::max<unsigned long>(fields[i].max_length, 31) + 1);
+		stmt->results[i].buffer_type = MYSQL_TYPE_STRING;
+		stmt->results[i].buffer = stmt->buffers[i].data();
+		stmt->results[i].buffer_length = stmt->buffers[i].size();
+		stmt->results[i].length = &stmt->lengths[i];
+		stmt->results[i].is_null = &stmt->nulls[i];
+	}
+
+	_activeStatement = stmt;
+
+	if ( _fieldCount > 0 && mysql_stmt_bind_result(stmt->handle, stmt->results.data()) ) {
+		SEISCOMP_ERROR("query(\"%s\") = %d (%s)", q,
+		               mysql_stmt_errno(stmt->handle), mysql_stmt_error(stmt->handle));
+		endQuery();
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool MySQLDatabase::execute(const char* command) {
 	return query(command, "execute");
@@ -316,6 +554,15 @@ bool MySQLDatabase::beginQuery(const char* q) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void MySQLDatabase::endQuery() {
+	if ( _activeStatement ) {
+		mysql_stmt_free_result(_activeStatement->handle);
+		if ( _activeStatement->meta ) {
+			mysql_free_result(_activeStatement->meta);
+			_activeStatement->meta = nullptr;
+		}
+		_activeStatement = nullptr;
+	}
+
 	if ( _result ) {
 		mysql_free_result(_result);
 		_result = nullptr;
@@ -329,7 +576,8 @@ void MySQLDatabase::endQuery() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 IO::DatabaseInterface::OID MySQLDatabase::lastInsertId(const char*) {
-	my_ulonglong id = mysql_insert_id(_handle);
+	my_ulonglong id = _lastStatement ?
+		mysql_stmt_insert_id(_lastStatement->handle) : mysql_insert_id(_handle);
 	return id == 0 ? IO::DatabaseInterface::INVALID_OID : id;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -339,7 +587,8 @@ IO::DatabaseInterface::OID MySQLDatabase::lastInsertId(const char*) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 uint64_t MySQLDatabase::numberOfAffectedRows() {
-	my_ulonglong r = mysql_affected_rows(_handle);
+	my_ulonglong r = _lastStatement ?
+		mysql_stmt_affected_rows(_lastStatement->handle) : mysql_affected_rows(_handle);
 	if ( r != (my_ulonglong)~0 )
 		return r;
 
@@ -352,6 +601,33 @@ uint64_t MySQLDatabase::numberOfAffectedRows() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool MySQLDatabase::fetchRow() {
+	if ( _activeStatement ) {
+		Statement *stmt = _activeStatement;
+		int rc = mysql_stmt_fetch(stmt->handle);
+		if ( rc != 0 && rc != MYSQL_DATA_TRUNCATED ) return false;
+
+		bool rebind = false;
+		for ( int i = 0; i < _fieldCount; ++i ) {
+			if ( stmt->nulls[i] ) continue;
+
+			// Fetch truncated columns again with a sufficient buffer
+			if ( stmt->lengths[i] >= stmt->buffers[i].size() ) {
+				stmt->buffers[i].resize(stmt->lengths[i] + 1);
+				stmt->results[i].buffer = stmt->buffers[i].data();
+				stmt->results[i].buffer_length = stmt->buffers[i].size();
+				mysql_stmt_fetch_column(stmt->handle, &stmt->results[i], i, 0);
+				rebind = true;
+			}
+
+			stmt->buffers[i][stmt->lengths[i]] = '\0';
+		}
+
+		if ( rebind )
+			mysql_stmt_bind_result(stmt->handle, stmt->results.data());
+
+		return true;
+	}
+
 	_row = mysql_fetch_row(_result);
 	_lengths = mysql_fetch_lengths(_result);
 	return _row != nullptr;
@@ -363,9 +639,10 @@ bool MySQLDatabase::fetchRow() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 int MySQLDatabase::findColumn(const char* name) {
+	MYSQL_RES *result = _activeStatement ? _activeStatement->meta : _result;
 	MYSQL_FIELD* field;
 	for ( int i = 0; i < _fieldCount; ++i ) {
-		field = mysql_fetch_field_direct(_result, i);
+		field = mysql_fetch_field_direct(result, i);
 		if ( !strcmp(field->name, name) )
 			return i;
 	}
@@ -388,7 +665,8 @@ int MySQLDatabase::getRowFieldCount() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 const char *MySQLDatabase::getRowFieldName(int index) {
-	MYSQL_FIELD* field = mysql_fetch_field_direct(_result, index);
+	MYSQL_RES *result = _activeStatement ? _activeStatement->meta : _result;
+	MYSQL_FIELD* field = mysql_fetch_field_direct(result, index);
 	return field ? field->name : nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -398,6 +676,10 @@ const char *MySQLDatabase::getRowFieldName(int index) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 const void* MySQLDatabase::getRowField(int index) {
+	if ( _activeStatement )
+		return _activeStatement->nulls[index] ?
+			nullptr : _activeStatement->buffers[index].data();
+
 	return _row[index];
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -407,6 +689,9 @@ const void* MySQLDatabase::getRowField(int index) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t MySQLDatabase::getRowFieldSize(int index) {
+	if ( _activeStatement )
+		return _activeStatement->lengths[index];
+
 	return _lengths[index];
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -32,6 +32,15 @@
 #include <mysql/mysql.h>
 #endif
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if LIBMYSQL_VERSION_ID >= 80000
+typedef bool my_bool;
+#endif
+
 
 namespace Seiscomp {
 namespace Database {
@@ -62,7 +71,9 @@ class MySQLDatabase : public Seiscomp::IO::DatabaseInterface {
 		void rollback() override;
 
 		bool execute(const char* command) override;
+		bool execute(const char* command, const Parameters &params) override;
 		bool beginQuery(const char* query) override;
+		bool beginQuery(const char* query, const Parameters &params) override;
 		void endQuery() override;
 
 		OID lastInsertId(const char*) override;
@@ -91,18 +102,54 @@ class MySQLDatabase : public Seiscomp::IO::DatabaseInterface {
 	//  Implementation
 	// ------------------------------------------------------------------
 	private:
+		struct Statement {
+			~Statement();
+
+			MYSQL_STMT                    *handle{nullptr};
+			MYSQL_RES                     *meta{nullptr};
+			std::vector<MYSQL_BIND>        results;
+			std::vector<std::vector<char>> buffers;
+			std::vector<unsigned long>     lengths;
+			// Not a vector: my_bool is bool with MySQL 8 and
+			// std::vector<bool> has no addressable elements
+			std::unique_ptr<my_bool[]>     nulls;
+		};
+
+		typedef std::map<std::string, std::unique_ptr<Statement>> Statements;
+
 		bool ping() const;
 		bool query(const char *c, const char *comp);
 
+		//! Returns the prepared statement for a command and prepares it
+		//! if required
+		Statement *statement(const char *command, unsigned int &err,
+		                     std::string &errMsg);
+		//! Binds the parameters and executes the prepared statement of
+		//! a command. The execution is retried once after a client
+		//! connection error. If cursor is set, a read only server side
+		//! cursor is opened if a fetch size is configured.
+		Statement *executePrepared(const char *command, const Parameters &params,
+		                           const char *comp, bool cursor = false);
+		void dropStatements();
+
 
 	private:
 		MYSQL                 *_handle{nullptr};
 		MYSQL_RES*             _result{nullptr};
 		MYSQL_ROW              _row{nullptr};
 		bool                   _debug{false};
+		//! The number of rows fetched at once from a server side cursor
+		//! of a prepared statement, 0 to transfer the complete result
+		unsigned long          _fetchSize{0};
 		//std::string _lastQuery;
 		mutable int            _fieldCount{0};
 		mutable unsigned long *_lengths{nullptr};
+		//! Prepared statements are bound to a connection and dropped
+		//! after a reconnect
+		Statements             _statements;
+		Statement             *_activeStatement{nullptr};
+		Statement             *_lastStatement{nullptr};
+		mutable bool           _reconnected{false};
 };
 
 
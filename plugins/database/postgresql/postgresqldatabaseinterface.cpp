@@ -24,10 +24,12 @@
 #define SEISCOMP_COMPONENT POSTGRESQL
 #include <seiscomp/logging/log.h>
 #include <seiscomp/core/plugin.h>
+#include <seiscomp/core/strings.h>
 #include "postgresqldatabaseinterface.h"
 
 #include <stdlib.h>
 #include <iostream>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -59,6 +61,8 @@ PostgreSQLDatabase::PostgreSQLDatabase()
 : _handle(NULL)
 , _result(NULL)
 , _debug(false)
+, _fetchSize(0)
+, _streaming(false)
 , _unescapeBuffer(NULL)
 , _unescapeBufferSize(0)
 {}
@@ -85,6 +89,12 @@ bool PostgreSQLDatabase::handleURIParameter(const std::string &name,
 		if ( value != "0" && value != "false" )
 			_debug = true;
 	}
+	else if ( name == "fetch_size" ) {
+		if ( !Core::fromString(_fetchSize, value) || _fetchSize < 0 ) {
+			SEISCOMP_ERROR("fetch_size: invalid number: %s", value.c_str());
+			return false;
+		}
+	}
 
 	return true;
 }
@@ -143,6 +153,8 @@ bool PostgreSQLDatabase::connect(const char *con) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void PostgreSQLDatabase::disconnect() {
+	if ( _streaming ) drainResults();
+
 	if ( _result ) {
 		PQclear(_result);
 		_result = NULL;
@@ -150,6 +162,7 @@ void PostgreSQLDatabase::disconnect() {
 
 	PQfinish(_handle);
 	_handle = NULL;
+	_statements.clear();
 
 	XFREE(_unescapeBuffer);
 }
@@ -166,6 +179,7 @@ bool PostgreSQLDatabase::isConnected() const {
 
 	SEISCOMP_ERROR("connection bad (%d) -> reconnect", static_cast<int>(stat));
 	PQreset(_handle);
+	_statements.clear();
 	return PQstatus(_handle) == CONNECTION_OK;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -231,6 +245,269 @@ bool PostgreSQLDatabase::execute(const char* command) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *PostgreSQLDatabase::prepare(const char *command) {
+	Statements::iterator it = _statements.find(command);
+	if ( it == _statements.end() ) {
+		// PostgreSQL uses numbered placeholders
+		std::string statement;
+		int index = 0;
+		bool quoted = false;
+
+		for ( const char *c = command; *c; ++c ) {
+			if ( *c == '\'' )
+				quoted = !quoted;
+			else if ( *c == '?' && !quoted ) {
+				statement += '$';
+				statement += Core::toString(++index);
+				continue;
+			}
+
+			statement += *c;
+		}
+
+		std::string name = "sc_stmt_" + Core::toString(_statements.size());
+
+		if ( _debug )
+			SEISCOMP_DEBUG("[postgresql-prepare] %s: %s", name.c_str(), statement.c_str());
+
+		PGresult *result = PQprepare(_handle, name.c_str(), statement.c_str(),
+		                             index, NULL);
+		if ( result == NULL || PQresultStatus(result) != PGRES_COMMAND_OK ) {
+			SEISCOMP_ERROR("PREPARE failed");
+			SEISCOMP_ERROR("  %s", statement.c_str());
+			SEISCOMP_ERROR("  %s", PQerrorMessage(_handle));
+			if ( result ) PQclear(result);
+			return NULL;
+		}
+
+		PQclear(result);
+		it = _statements.insert(Statements::value_type(command, name)).first;
+	}
+
+	return it->second.c_str();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+namespace {
+
+
+// Parameters are transferred in text format and converted by the
+// server according to the inferred parameter types
+void textValues(const IO::DatabaseInterface::Parameters &params,
+                std::vector<std::string> &numbers,
+                std::vector<const char*> &values) {
+	numbers.resize(params.size());
+	values.resize(params.size());
+
+	for ( size_t i = 0; i < params.size(); ++i ) {
+		const IO::DatabaseInterface::Parameter &param = params[i];
+		switch ( param.type ) {
+			case IO::DatabaseInterface::Parameter::Integer:
+				numbers[i] = Core::toString(param.integer);
+				values[i] = numbers[i].c_str();
+				break;
+			case IO::DatabaseInterface::Parameter::Float:
+				numbers[i] = Core::toString(param.number);
+				values[i] = numbers[i].c_str();
+				break;
+			case IO::DatabaseInterface::Parameter::Text:
+				values[i] = param.text.c_str();
+				break;
+			default:
+				values[i] = NULL;
+				break;
+		}
+	}
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PGresult *PostgreSQLDatabase::executePrepared(const char *command,
+                                              const Parameters &params) {
+	const char *name = prepare(command);
+	if ( name == NULL ) return NULL;
+
+	std::vector<std::string> numbers;
+	std::vector<const char*> values;
+	textValues(params, numbers, values);
+
+	if ( _debug )
+		SEISCOMP_DEBUG("[postgresql-execute] %s: %s", name, command);
+
+	PGresult *result = PQexecPrepared(_handle, name,
+	                                  static_cast<int>(values.size()),
+	                                  values.empty() ? NULL : &values[0],
+	                                  NULL, NULL, 0);
+	if ( result == NULL ) {
+		SEISCOMP_ERROR("execute(\"%s\"): %s", command, PQerrorMessage(_handle));
+		return NULL;
+	}
+
+	ExecStatusType stat = PQresultStatus(result);
+	if ( stat != PGRES_TUPLES_OK && stat != PGRES_COMMAND_OK ) {
+		SEISCOMP_ERROR("QUERY/COMMAND failed");
+		SEISCOMP_ERROR("  %s", command);
+		SEISCOMP_ERROR("  %s", PQerrorMessage(_handle));
+		PQclear(result);
+		return NULL;
+	}
+
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PostgreSQLDatabase::beginStreaming(const char *command) {
+#ifdef LIBPQ_HAS_CHUNK_MODE
+	int mode = _fetchSize > 1 ?
+		PQsetChunkedRowsMode(_handle, _fetchSize) : PQsetSingleRowMode(_handle);
+#else
+	int mode = PQsetSingleRowMode(_handle);
+#endif
+	if ( !mode )
+		SEISCOMP_WARNING("query(\"%s\"): failed to enable row streaming", command);
+
+	_streaming = true;
+
+	return fetchResult(command);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PostgreSQLDatabase::fetchResult(const char *command) {
+	PGresult *result = PQgetResult(_handle);
+	if ( result == NULL ) {
+		_streaming = false;
+		return false;
+	}
+
+	if ( _result ) PQclear(_result);
+	_result = result;
+	_row = -1;
+	_nRows = PQntuples(_result);
+	_fieldCount = PQnfields(_result);
+
+	switch ( PQresultStatus(_result) ) {
+		case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+		case PGRES_TUPLES_CHUNK:
+#endif
+			return true;
+		case PGRES_TUPLES_OK:
+		case PGRES_COMMAND_OK:
+			// The last part does not hold rows but keeps the result
+			// description
+			drainResults();
+			return true;
+		default:
+			SEISCOMP_ERROR("QUERY/COMMAND failed");
+			if ( command ) SEISCOMP_ERROR("  %s", command);
+			SEISCOMP_ERROR("  %s", PQerrorMessage(_handle));
+			drainResults();
+			return false;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PostgreSQLDatabase::drainResults() {
+	if ( !_streaming ) return;
+
+	// The connection accepts new queries not before the complete result
+	// has been read
+	PGresult *result;
+	while ( (result = PQgetResult(_handle)) != NULL )
+		PQclear(result);
+
+	_streaming = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PostgreSQLDatabase::execute(const char* command, const Parameters &params) {
+	if ( !isConnected() || command == NULL ) return false;
+
+	PGresult *result = executePrepared(command, params);
+	if ( result == NULL ) return false;
+
+	PQclear(result);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PostgreSQLDatabase::beginQuery(const char* query, const Parameters &params) {
+	if ( !isConnected() || query == NULL ) return false;
+	if ( _result ) {
+		SEISCOMP_ERROR("beginQuery: nested queries are not supported");
+		return false;
+	}
+
+	endQuery();
+
+	if ( _fetchSize > 0 ) {
+		const char *name = prepare(query);
+		if ( name == NULL ) return false;
+
+		std::vector<std::string> numbers;
+		std::vector<const char*> values;
+		textValues(params, numbers, values);
+
+		if ( _debug )
+			SEISCOMP_DEBUG("[postgresql-query] %s: %s", name, query);
+
+		if ( !PQsendQueryPrepared(_handle, name, static_cast<int>(values.size()),
+		                          values.empty() ? NULL : &values[0],
+		                          NULL, NULL, 0) ) {
+			SEISCOMP_ERROR("query(\"%s\"): %s", query, PQerrorMessage(_handle));
+			return false;
+		}
+
+		if ( !beginStreaming(query) ) {
+			endQuery();
+			return false;
+		}
+
+		return true;
+	}
+
+	_result = executePrepared(query, params);
+	if ( _result == NULL ) return false;
+
+	_nRows = PQntuples(_result);
+	_fieldCount = PQnfields(_result);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool PostgreSQLDatabase::beginQuery(const char* query) {
 	if ( !isConnected() || query == NULL ) return false;
@@ -245,6 +522,20 @@ bool PostgreSQLDatabase::beginQuery(const char* query) {
 	if ( _debug )
 		SEISCOMP_DEBUG("[postgresql-query] %s", query);
 
+	if ( _fetchSize > 0 ) {
+		if ( !PQsendQuery(_handle, query) ) {
+			SEISCOMP_ERROR("query(\"%s\"): %s", query, PQerrorMessage(_handle));
+			return false;
+		}
+
+		if ( !beginStreaming(query) ) {
+			endQuery();
+			return false;
+		}
+
+		return true;
+	}
+
 	_result = PQexec(_handle, query);
 	if ( _result == NULL ) {
 		SEISCOMP_ERROR("query(\"%s\"): %s", query, PQerrorMessage(_handle));
@@ -273,6 +564,8 @@ bool PostgreSQLDatabase::beginQuery(const char* query) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void PostgreSQLDatabase::endQuery() {
+	drainResults();
+
 	_row = -1;
 	_nRows = -1;
 	if ( _result ) {
@@ -327,6 +620,13 @@ bool PostgreSQLDatabase::fetchRow() {
 
 	if ( _row < _nRows ) return true;
 
+	// Fetch the next part of a streamed result
+	while ( _streaming ) {
+		if ( !fetchResult(NULL) ) break;
+		_row = 0;
+		if ( _row < _nRows ) return true;
+	}
+
 	_row = _nRows;
 	return false;
 }
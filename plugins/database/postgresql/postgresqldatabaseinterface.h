@@ -27,6 +27,9 @@
 #include <seiscomp/io/database.h>
 #include <libpq-fe.h>
 
+#include <map>
+#include <string>
+
 
 namespace Seiscomp {
 namespace Database {
@@ -57,7 +60,9 @@ class PostgreSQLDatabase : public Seiscomp::IO::DatabaseInterface {
 		virtual void rollback() override;
 
 		virtual bool execute(const char* command) override;
+		virtual bool execute(const char* command, const Parameters &params) override;
 		virtual bool beginQuery(const char* query) override;
+		virtual bool beginQuery(const char* query, const Parameters &params) override;
 		virtual void endQuery() override;
 
 		virtual bool fetchRow() override;
@@ -86,14 +91,46 @@ class PostgreSQLDatabase : public Seiscomp::IO::DatabaseInterface {
 	//  Implementation
 	// ------------------------------------------------------------------
 	private:
+		//! Returns the name of the prepared statement for a command and
+		//! prepares it if required. Returns NULL on error.
+		const char *prepare(const char *command);
+
+		//! Executes the prepared statement for a command and prepares it
+		//! if required. Returns the result or NULL.
+		PGresult *executePrepared(const char *command, const Parameters &params);
+
+		//! Enables single row mode or chunks of the fetch size for a
+		//! sent query and fetches the first part of its result
+		bool beginStreaming(const char *command);
+
+		//! Fetches the next part of a streamed result into _result.
+		//! Returns false on errors or if the result is complete.
+		bool fetchResult(const char *command);
+
+		//! Reads and discards the remaining parts of a streamed result
+		void drainResults();
+
+
+	private:
+		//! Maps command texts to names of prepared statements
+		typedef std::map<std::string, std::string> Statements;
+
 		PGconn   *_handle;
 		PGresult *_result;
 		bool      _debug;
+		//! The number of rows fetched at once, 0 to transfer the complete
+		//! result
+		int       _fetchSize;
+		//! Whether the parts of a streamed result are pending
+		bool      _streaming;
 		int       _row;
 		int       _nRows;
 		int       _fieldCount;
 		void     *_unescapeBuffer;
 		size_t    _unescapeBufferSize;
+		//! Prepared statements are bound to a connection and are dropped
+		//! when the connection is reset
+		mutable Statements _statements;
 };
 
 
@@ -0,0 +1,566 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT REPLICA
+#include "replicadatabaseinterface.h"
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/plugin.h>
+#include <seiscomp/core/strings.h>
+
+#include <stdlib.h>
+#include <strings.h>
+
+
+namespace Seiscomp {
+namespace Database {
+
+
+IMPLEMENT_SC_CLASS_DERIVED(ReplicaDatabase,
+                           Seiscomp::IO::DatabaseInterface,
+                           "replica_database_interface");
+
+REGISTER_DB_INTERFACE(ReplicaDatabase, "replica");
+ADD_SC_PLUGIN(
+	"Database driver which sends queries to read replicas",
+	"gempa GmbH <seiscomp-dev@gempa.de>",
+	1, 0, 0
+)
+
+
+namespace {
+
+
+std::string serviceOf(const std::string &uri) {
+	size_t pos = uri.find("://");
+	return pos != std::string::npos ? uri.substr(0, pos) : "mysql";
+}
+
+
+// Only plain queries are sent to replicas
+bool isReadOnly(const char *query) {
+	while ( *query == ' ' || *query == '\t' || *query == '\n' || *query == '(' )
+		++query;
+
+	return !strncasecmp(query, "select", 6) || !strncasecmp(query, "with", 4);
+}
+
+
+// Returns the replication delay query of a driver or nullptr if it is
+// not supported
+const char *lagQuery(const std::string &service) {
+	if ( service == "mysql" )
+		return "show slave status";
+	if ( service == "postgresql" )
+		return "select case when not pg_is_in_recovery() or "
+		       "pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() then 0 "
+		       "else extract(epoch from now() - pg_last_xact_replay_timestamp()) "
+		       "end as lag";
+	return nullptr;
+}
+
+
+}
+
+
+ReplicaDatabase::~ReplicaDatabase() {
+	disconnect();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::handleURIParameter(const std::string &name,
+                                         const std::string &value) {
+	double *option = nullptr;
+
+	if ( name == "sticky" )
+		option = &_sticky;
+	else if ( name == "max_lag" )
+		option = &_maxLag;
+	else if ( name == "check_interval" )
+		option = &_checkInterval;
+	else if ( name == "retry" )
+		option = &_retry;
+	else
+		return true;
+
+	if ( !Core::fromString(*option, value) || *option < 0 ) {
+		SEISCOMP_ERROR("%s: invalid number: %s", name.c_str(), value.c_str());
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::connect(const char *con) {
+	if ( isConnected() ) return false;
+
+	_replicas.clear();
+	std::string primary;
+
+	std::vector<std::string> parts;
+	Core::split(parts, con, "|");
+
+	for ( const auto &part : parts ) {
+		if ( part.empty() ) continue;
+
+		if ( part.find("://") == std::string::npos ) {
+			std::vector<std::string> params;
+			Core::split(params, part.c_str(), "&");
+			for ( const auto &param : params ) {
+				size_t pos = param.find('=');
+				if ( !handleURIParameter(param.substr(0, pos),
+				                         pos != std::string::npos ? param.substr(pos+1) : "") )
+					return false;
+			}
+		}
+		else if ( primary.empty() )
+			primary = part;
+		else {
+			_replicas.push_back(Replica());
+			_replicas.back().uri = part;
+			_replicas.back().service = serviceOf(part);
+		}
+	}
+
+	if ( primary.empty() ) {
+		SEISCOMP_ERROR("No primary database given");
+		return false;
+	}
+
+	_primary = IO::DatabaseInterface::Open(primary.c_str());
+	if ( !_primary ) return false;
+
+	_columnPrefix = _primary->columnPrefix();
+
+	// Spread the clients over the replicas
+	if ( !_replicas.empty() )
+		_current = static_cast<size_t>(rand()) % _replicas.size();
+
+	return open();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::open() {
+	if ( !_primary ) return false;
+
+	SEISCOMP_DEBUG("Using %d read replica(s)", static_cast<int>(_replicas.size()));
+
+	// Replicas are connected on first use
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ReplicaDatabase::disconnect() {
+	_active = nullptr;
+	_transaction = false;
+
+	for ( auto &replica : _replicas )
+		replica.db = nullptr;
+
+	_primary = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::isConnected() const {
+	return _primary && _primary->isConnected();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ReplicaDatabase::suspend(Replica &replica) {
+	SEISCOMP_WARNING("Replica %s failed, using it again in %.0fs",
+	                 replica.uri.substr(0, replica.uri.find('@')+1).c_str(),
+	                 _retry);
+	replica.db = nullptr;
+	replica.suspendedUntil = Core::Time::UTC() + Core::TimeSpan(_retry);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::lagging(Replica &replica) {
+	if ( _maxLag <= 0 ) return false;
+
+	Core::Time now = Core::Time::UTC();
+	if ( (double)(now - replica.lastCheck) < _checkInterval )
+		return replica.lagging;
+
+	replica.lastCheck = now;
+
+	const char *q = lagQuery(replica.service);
+	if ( !q ) return replica.lagging = false;
+
+	double lag = -1;
+	if ( replica.db->beginQuery(q) ) {
+		if ( replica.db->fetchRow() ) {
+			int col = replica.db->findColumn("Seconds_Behind_Master");
+			if ( col < 0 ) col = replica.db->findColumn("lag");
+			// A NULL value means that the replication is not running
+			if ( col >= 0 && replica.db->getRowField(col) )
+				lag = atof(replica.db->getRowFieldString(col).c_str());
+		}
+		else
+			// The server is not a replica
+			lag = 0;
+
+		replica.db->endQuery();
+	}
+
+	replica.lagging = lag < 0 || lag > _maxLag;
+	if ( replica.lagging )
+		SEISCOMP_WARNING("Replica %s lags behind: %.0fs",
+		                 replica.uri.substr(0, replica.uri.find('@')+1).c_str(),
+		                 lag);
+
+	return replica.lagging;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::usable(Replica &replica) {
+	if ( !replica.db ) {
+		if ( Core::Time::UTC() < replica.suspendedUntil ) return false;
+
+		replica.db = IO::DatabaseInterface::Open(replica.uri.c_str());
+		if ( !replica.db ) {
+			suspend(replica);
+			return false;
+		}
+
+		replica.lastCheck = Core::Time();
+	}
+	else if ( !replica.db->isConnected() ) {
+		suspend(replica);
+		return false;
+	}
+
+	return !lagging(replica);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+IO::DatabaseInterface *ReplicaDatabase::reader(const char *query) {
+	if ( _transaction || _replicas.empty() || !query || !isReadOnly(query) )
+		return _primary.get();
+
+	// Read the own writes from the primary
+	if ( (double)(Core::Time::UTC() - _lastWrite) < _sticky )
+		return _primary.get();
+
+	// Fail over to the next replica and finally to the primary
+	for ( size_t i = 0; i < _replicas.size(); ++i ) {
+		Replica &replica = _replicas[_current];
+		if ( usable(replica) ) return replica.db.get();
+		_current = (_current + 1) % _replicas.size();
+	}
+
+	return _primary.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ReplicaDatabase::wrote() {
+	_lastWrite = Core::Time::UTC();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ReplicaDatabase::start() {
+	if ( !_primary ) return;
+	_primary->start();
+	_transaction = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ReplicaDatabase::commit() {
+	if ( !_primary ) return;
+	_primary->commit();
+	_transaction = false;
+	wrote();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ReplicaDatabase::rollback() {
+	if ( !_primary ) return;
+	_primary->rollback();
+	_transaction = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::execute(const char* command) {
+	if ( !_primary ) return false;
+	wrote();
+	return _primary->execute(command);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::execute(const char* command, const Parameters &params) {
+	if ( !_primary ) return false;
+	wrote();
+	return _primary->execute(command, params);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename... Args>
+bool ReplicaDatabase::query(const char *query, const Args &...args) {
+	if ( !_primary ) return false;
+
+	endQuery();
+
+	IO::DatabaseInterface *db = reader(query);
+	if ( db->beginQuery(query, args...) ) {
+		_active = db;
+		return true;
+	}
+
+	if ( db == _primary.get() ) return false;
+
+	// Repeat a failed query of a lost replica on the primary
+	if ( !db->isConnected() ) {
+		suspend(_replicas[_current]);
+		if ( _primary->beginQuery(query, args...) ) {
+			_active = _primary.get();
+			return true;
+		}
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::beginQuery(const char* q) {
+	return query(q);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::beginQuery(const char* q, const Parameters &params) {
+	return query(q, params);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ReplicaDatabase::endQuery() {
+	if ( _active ) {
+		_active->endQuery();
+		_active = nullptr;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *ReplicaDatabase::defaultValue() const {
+	return _primary ? _primary->defaultValue() : DatabaseInterface::defaultValue();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+IO::DatabaseInterface::OID ReplicaDatabase::lastInsertId(const char* table) {
+	return _primary ? _primary->lastInsertId(table) : INVALID_OID;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t ReplicaDatabase::numberOfAffectedRows() {
+	return _primary ? _primary->numberOfAffectedRows() : (uint64_t)~0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::fetchRow() {
+	return _active && _active->fetchRow();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int ReplicaDatabase::findColumn(const char* name) {
+	return _active ? _active->findColumn(name) : -1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int ReplicaDatabase::getRowFieldCount() const {
+	return _active ? _active->getRowFieldCount() : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *ReplicaDatabase::getRowFieldName(int index) {
+	return _active ? _active->getRowFieldName(index) : nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const void *ReplicaDatabase::getRowField(int index) {
+	return _active ? _active->getRowField(index) : nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::getRowFieldValue(int index, int64_t &value) {
+	return _active && _active->getRowFieldValue(index, value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::getRowFieldValue(int index, double &value) {
+	return _active && _active->getRowFieldValue(index, value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t ReplicaDatabase::getRowFieldSize(int index) {
+	return _active ? _active->getRowFieldSize(index) : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string ReplicaDatabase::timeToString(const Seiscomp::Core::Time &t) {
+	return _primary ? _primary->timeToString(t) : DatabaseInterface::timeToString(t);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Seiscomp::Core::Time ReplicaDatabase::stringToTime(const char *str) {
+	return _primary ? _primary->stringToTime(str) : DatabaseInterface::stringToTime(str);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ReplicaDatabase::escape(std::string &out, const std::string &in) const {
+	return _primary ? _primary->escape(out, in) : DatabaseInterface::escape(out, in);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
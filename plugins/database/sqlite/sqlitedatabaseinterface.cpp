@@ -146,6 +146,45 @@ bool SQLiteDatabase::handleURIParameter(const std::string &name,
 			return false;
 		}
 	}
+	else if ( name == "bulk" ) {
+		_bulk = value.empty() || value == "1" || value == "true";
+	}
+	else if ( name == "journal" ) {
+		static const vector<string> modes = {
+			"delete", "truncate", "persist", "memory", "wal", "off"
+		};
+		string mode = value;
+		transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+		if ( find(modes.begin(), modes.end(), mode) == modes.end() ) {
+			SEISCOMP_ERROR("Invalid journal mode: %s", value.c_str());
+			return false;
+		}
+		_journalMode = mode;
+	}
+	else if ( name == "synchronous" ) {
+		static const vector<string> modes = {
+			"off", "normal", "full", "extra"
+		};
+		string mode = value;
+		transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+		if ( find(modes.begin(), modes.end(), mode) == modes.end() ) {
+			SEISCOMP_ERROR("Invalid synchronous mode: %s", value.c_str());
+			return false;
+		}
+		_synchronous = mode;
+	}
+	else if ( name == "cache" ) {
+		if ( !Core::fromString(_cacheSize, value) || _cacheSize <= 0 ) {
+			SEISCOMP_ERROR("Invalid cache size in kB: %s", value.c_str());
+			return false;
+		}
+	}
+	else if ( name == "batch" ) {
+		if ( !Core::fromString(_batch, value) || _batch < 0 ) {
+			SEISCOMP_ERROR("Invalid batch size: %s", value.c_str());
+			return false;
+		}
+	}
 
 	return true;
 }
@@ -188,6 +227,45 @@ bool SQLiteDatabase::open() {
 #endif
 	}
 
+	// The bulk mode trades durability for write throughput, e.g. for
+	// offline processing. Parameters given explicitly take precedence.
+	string journalMode = _journalMode;
+	string synchronous = _synchronous;
+	int cacheSize = _cacheSize;
+	int batch = _batch;
+
+	if ( _bulk ) {
+		if ( journalMode.empty() ) journalMode = "wal";
+		if ( synchronous.empty() ) synchronous = "normal";
+		if ( !cacheSize ) cacheSize = 65536;
+		if ( batch < 0 ) batch = 1000;
+	}
+
+	if ( !journalMode.empty() ) {
+		exec(("pragma journal_mode=" + journalMode).c_str());
+	}
+
+	if ( !synchronous.empty() ) {
+		exec(("pragma synchronous=" + synchronous).c_str());
+	}
+
+	if ( cacheSize ) {
+		// A negative value is the cache size in kB instead of pages
+		exec(("pragma cache_size=-" + Core::toString(cacheSize)).c_str());
+	}
+
+	_batchSize = batch > 0 ? static_cast<size_t>(batch) : 0;
+	_batchCount = 0;
+	_batchOpen = false;
+	_savepoints = 0;
+
+	if ( _bulk || _batchSize ) {
+		SEISCOMP_DEBUG("Journal mode: %s, synchronous: %s, cache: %d kB, batch: %d",
+		               journalMode.empty() ? "default" : journalMode.c_str(),
+		               synchronous.empty() ? "default" : synchronous.c_str(),
+		               cacheSize, static_cast<int>(_batchSize));
+	}
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -227,6 +305,14 @@ bool SQLiteDatabase::connect(const char *con) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SQLiteDatabase::disconnect() {
+	endQuery();
+	flushBatch();
+
+	for ( auto &item : _statements ) {
+		sqlite3_finalize(item.second);
+	}
+	_statements.clear();
+
 	if ( _handle ) {
 		sqlite3_close(_handle);
 		_handle = nullptr;
@@ -248,7 +334,15 @@ bool SQLiteDatabase::isConnected() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SQLiteDatabase::start() {
-	execute("begin transaction");
+	if ( _batchSize ) {
+		beginBatch();
+		if ( exec("savepoint batch") ) {
+			++_savepoints;
+		}
+		return;
+	}
+
+	exec("begin transaction");
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -257,7 +351,14 @@ void SQLiteDatabase::start() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SQLiteDatabase::commit() {
-	execute("commit transaction");
+	if ( _savepoints ) {
+		exec("release savepoint batch");
+		--_savepoints;
+		endBatch();
+		return;
+	}
+
+	exec("commit transaction");
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -266,7 +367,16 @@ void SQLiteDatabase::commit() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SQLiteDatabase::rollback() {
-	execute("rollback transaction");
+	if ( _savepoints ) {
+		// Only the changes since the savepoint are reverted, the batch
+		// transaction is kept
+		exec("rollback transaction to savepoint batch");
+		exec("release savepoint batch");
+		--_savepoints;
+		return;
+	}
+
+	exec("rollback transaction");
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -279,6 +389,22 @@ bool SQLiteDatabase::execute(const char* command) {
 		return false;
 	}
 
+	beginBatch();
+	bool result = exec(command);
+	endBatch();
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SQLiteDatabase::exec(const char *command) {
+	if ( !isConnected() ) {
+		return false;
+	}
+
 	char* errmsg = nullptr;
 	int result = sqlite3_exec(_handle, command, nullptr, nullptr, &errmsg);
 	if ( errmsg ) {
@@ -293,6 +419,186 @@ bool SQLiteDatabase::execute(const char* command) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+sqlite3_stmt *SQLiteDatabase::prepare(const char *command, const Parameters &params) {
+	sqlite3_stmt *stmt = nullptr;
+
+	auto it = _statements.find(command);
+	if ( it != _statements.end() ) {
+		stmt = it->second;
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+	}
+	else {
+		int res = sqlite3_prepare_v2(_handle, command, -1, &stmt, nullptr);
+		if ( res != SQLITE_OK || !stmt ) {
+			SEISCOMP_ERROR("sqlite3 prepare: %s: %s", sqlite3_errmsg(_handle), command);
+			return nullptr;
+		}
+
+		_statements[command] = stmt;
+	}
+
+	if ( sqlite3_bind_parameter_count(stmt) != static_cast<int>(params.size()) ) {
+		SEISCOMP_ERROR("sqlite3 prepare: %d parameters expected but %d given: %s",
+		               sqlite3_bind_parameter_count(stmt),
+		               static_cast<int>(params.size()), command);
+		return nullptr;
+	}
+
+	for ( size_t i = 0; i < params.size(); ++i ) {
+		const Parameter &param = params[i];
+		int index = static_cast<int>(i) + 1;
+		int res;
+
+		switch ( param.type ) {
+			case Parameter::Integer:
+				res = sqlite3_bind_int64(stmt, index, param.integer);
+				break;
+			case Parameter::Float:
+				res = sqlite3_bind_double(stmt, index, param.number);
+				break;
+			case Parameter::Text:
+				res = sqlite3_bind_text(stmt, index, param.text.data(),
+				                        static_cast<int>(param.text.size()),
+				                        SQLITE_TRANSIENT);
+				break;
+			default:
+				res = sqlite3_bind_null(stmt, index);
+				break;
+		}
+
+		if ( res != SQLITE_OK ) {
+			SEISCOMP_ERROR("sqlite3 bind: %s: %s", sqlite3_errmsg(_handle), command);
+			return nullptr;
+		}
+	}
+
+	return stmt;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SQLiteDatabase::execute(const char* command, const Parameters &params) {
+	if ( !isConnected() || !command ) {
+		return false;
+	}
+
+	sqlite3_stmt *stmt = prepare(command, params);
+	if ( !stmt ) {
+		return false;
+	}
+
+	beginBatch();
+
+	// Skip rows returned by the statement
+	int res;
+	do {
+		res = sqlite3_step(stmt);
+	}
+	while ( res == SQLITE_ROW );
+
+	if ( res != SQLITE_DONE ) {
+		SEISCOMP_ERROR("sqlite3 execute: %s", sqlite3_errmsg(_handle));
+	}
+
+	sqlite3_reset(stmt);
+
+	endBatch();
+
+	return res == SQLITE_DONE;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SQLiteDatabase::beginBatch() {
+	if ( !_batchSize || _batchOpen ) {
+		return;
+	}
+
+	if ( !sqlite3_get_autocommit(_handle) ) {
+		// A transaction has been started explicitly with a command
+		return;
+	}
+
+	_batchOpen = exec("begin transaction");
+	_batchCount = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SQLiteDatabase::endBatch() {
+	if ( !_batchOpen || _savepoints ) {
+		return;
+	}
+
+	if ( ++_batchCount >= _batchSize ) {
+		flushBatch();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SQLiteDatabase::flushBatch() {
+	if ( !_batchOpen || _savepoints ) {
+		return;
+	}
+
+	if ( sqlite3_get_autocommit(_handle) ) {
+		// The transaction has been ended by a command
+		_batchOpen = false;
+		return;
+	}
+
+	// Keep the transaction open and retry with the next write if it
+	// cannot be committed, e.g. because of a running query
+	if ( exec("commit transaction") ) {
+		_batchOpen = false;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SQLiteDatabase::beginQuery(const char* query, const Parameters &params) {
+	if ( !isConnected() || !query ) {
+		return false;
+	}
+
+	if ( _stmt ) {
+		SEISCOMP_ERROR("beginQuery: nested queries are not supported");
+		return false;
+	}
+
+	_stmt = prepare(query, params);
+	if ( !_stmt ) {
+		return false;
+	}
+
+	_stmtPrepared = true;
+	_columnCount = sqlite3_column_count(_stmt);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool SQLiteDatabase::beginQuery(const char* query) {
 	if ( !isConnected() || !query ) {
@@ -322,8 +628,15 @@ bool SQLiteDatabase::beginQuery(const char* query) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SQLiteDatabase::endQuery() {
 	if ( _stmt ) {
-		sqlite3_finalize(_stmt);
+		// Prepared statements are kept for reuse
+		if ( _stmtPrepared ) {
+			sqlite3_reset(_stmt);
+		}
+		else {
+			sqlite3_finalize(_stmt);
+		}
 		_stmt = nullptr;
+		_stmtPrepared = false;
 		_columnCount = 0;
 	}
 }
@@ -420,6 +733,41 @@ size_t SQLiteDatabase::getRowFieldSize(int index) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SQLiteDatabase::getRowFieldValue(int index, int64_t &value) {
+	switch ( sqlite3_column_type(_stmt, index) ) {
+		case SQLITE_INTEGER:
+			value = sqlite3_column_int64(_stmt, index);
+			return true;
+		case SQLITE_NULL:
+			return false;
+		default:
+			return DatabaseInterface::getRowFieldValue(index, value);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SQLiteDatabase::getRowFieldValue(int index, double &value) {
+	switch ( sqlite3_column_type(_stmt, index) ) {
+		case SQLITE_INTEGER:
+		case SQLITE_FLOAT:
+			value = sqlite3_column_double(_stmt, index);
+			return true;
+		case SQLITE_NULL:
+			return false;
+		default:
+			return DatabaseInterface::getRowFieldValue(index, value);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool SQLiteDatabase::escape(string &out, const string &in) const {
 	out.resize(in.size()*2+1);
@@ -27,6 +27,9 @@
 #include <seiscomp/io/database.h>
 #include <sqlite3.h>
 
+#include <map>
+#include <string>
+
 
 namespace Seiscomp {
 namespace Database {
@@ -57,7 +60,9 @@ class SQLiteDatabase : public Seiscomp::IO::DatabaseInterface {
 		void rollback() override;
 
 		bool execute(const char* command) override;
+		bool execute(const char* command, const Parameters &params) override;
 		bool beginQuery(const char* query) override;
+		bool beginQuery(const char* query, const Parameters &params) override;
 		void endQuery() override;
 
 		const char *defaultValue() const override;
@@ -70,6 +75,8 @@ class SQLiteDatabase : public Seiscomp::IO::DatabaseInterface {
 		const char *getRowFieldName(int index) override;
 		const void *getRowField(int index) override;
 		size_t getRowFieldSize(int index) override;
+		bool getRowFieldValue(int index, int64_t &value) override;
+		bool getRowFieldValue(int index, double &value) override;
 		bool escape(std::string &out, const std::string &in) const override;
 
 
@@ -88,9 +95,44 @@ class SQLiteDatabase : public Seiscomp::IO::DatabaseInterface {
 	//  Implementation
 	// ------------------------------------------------------------------
 	private:
+		//! Returns the cached prepared statement for a command with all
+		//! parameters bound
+		sqlite3_stmt *prepare(const char *command, const Parameters &params);
+
+		//! Executes a command without batching
+		bool exec(const char *command);
+
+		//! Opens the batch transaction if batching is enabled and no
+		//! transaction has been started
+		void beginBatch();
+		//! Counts a write and commits the batch transaction if it is full
+		void endBatch();
+		//! Commits the batch transaction if open
+		void flushBatch();
+
+
+	private:
+		typedef std::map<std::string, sqlite3_stmt*> Statements;
+
 		sqlite3      *_handle{nullptr};
 		sqlite3_stmt *_stmt{nullptr};
+		bool          _stmtPrepared{false};
 		int           _columnCount{0};
+		Statements    _statements;
+
+		// URI parameters of the bulk mode
+		bool          _bulk{false};
+		std::string   _journalMode;
+		std::string   _synchronous;
+		int           _cacheSize{0};
+		int           _batch{-1};
+
+		// Writes are collected in one transaction of up to _batchSize
+		// statements, explicit transactions are mapped to savepoints
+		size_t        _batchSize{0};
+		size_t        _batchCount{0};
+		bool          _batchOpen{false};
+		int           _savepoints{0};
 };
 
 
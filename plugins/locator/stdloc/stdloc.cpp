@@ -35,9 +35,14 @@
 #include <seiscomp/seismology/ttt.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <numeric>
 #include <array>
+#include <thread>
 #include <tuple>
 #include <set>
 
@@ -235,6 +240,65 @@ bool invertMatrix4x4(const std::array<std::array<double,4>,4> &in,
 	return true;
 }
 
+
+/**
+ * Calls func for all indexes in [0,count) using the given number of
+ * threads, the calling thread included. The thread index passed to func
+ * is in [0,threads). The first exception thrown by func stops processing
+ * and is rethrown once all threads have finished.
+ */
+void parallelFor(size_t count, int threads,
+                 const function<void(size_t index, int thread)> &func) {
+	if ( threads <= 1 || count <= 1 ) {
+		for ( size_t i = 0; i < count; ++i ) {
+			func(i, 0);
+		}
+		return;
+	}
+
+	threads = static_cast<int>(min(static_cast<size_t>(threads), count));
+
+	atomic<size_t> next(0);
+	atomic<bool> failed(false);
+	exception_ptr error;
+	mutex errorMutex;
+
+	auto work = [&](int thread) {
+		while ( !failed ) {
+			size_t index = next++;
+			if ( index >= count ) {
+				break;
+			}
+
+			try {
+				func(index, thread);
+			}
+			catch ( ... ) {
+				lock_guard<mutex> lock(errorMutex);
+				if ( !error ) {
+					error = current_exception();
+				}
+				failed = true;
+			}
+		}
+	};
+
+	vector<thread> workers;
+	for ( int t = 1; t < threads; ++t ) {
+		workers.emplace_back(work, t);
+	}
+
+	work(0);
+
+	for ( auto &worker : workers ) {
+		worker.join();
+	}
+
+	if ( error ) {
+		rethrow_exception(error);
+	}
+}
+
 } // namespace
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -279,8 +343,10 @@ const IDList StdLoc::_allowedParameters = {
     "GridSearch.cellSize",
     "GridSearch.misfitType",
     "GridSearch.travelTimeError",
+    "GridSearch.threads",
     "OctTree.maxIterations",
     "OctTree.minCellSize",
+    "OctTree.threads",
     "LeastSquares.iterations",
     "LeastSquares.dampingFactor",
     "LeastSquares.solverType",
@@ -321,8 +387,10 @@ bool StdLoc::init(const Config::Config &config) {
 	defaultProf.gridSearch.cellZExtent = 5.0;
 	defaultProf.gridSearch.misfitType = "L1";
 	defaultProf.gridSearch.travelTimeError = 0.25;
+	defaultProf.gridSearch.threads = 1;
 	defaultProf.octTree.maxIterations = 50000;
 	defaultProf.octTree.minCellSize = 0.1;
+	defaultProf.octTree.threads = 1;
 	defaultProf.leastSquares.iterations = 20;
 	defaultProf.leastSquares.dampingFactor = 0;
 	defaultProf.leastSquares.solverType = "LSMR";
@@ -491,6 +559,12 @@ bool StdLoc::init(const Config::Config &config) {
 		}
 		catch ( ... ) {}
 
+		try {
+			prof.gridSearch.threads =
+			    config.getInt(prefix + "GridSearch.threads");
+		}
+		catch ( ... ) {}
+
 		try {
 			prof.octTree.maxIterations =
 			    config.getInt(prefix + "OctTree.maxIterations");
@@ -503,6 +577,11 @@ bool StdLoc::init(const Config::Config &config) {
 		}
 		catch ( ... ) {}
 
+		try {
+			prof.octTree.threads = config.getInt(prefix + "OctTree.threads");
+		}
+		catch ( ... ) {}
+
 		try {
 			prof.leastSquares.iterations =
 			    config.getInt(prefix + "LeastSquares.iterations");
@@ -655,12 +734,18 @@ string StdLoc::parameter(const string &name) const {
 	else if ( name == "GridSearch.travelTimeError" ) {
 		return Core::toString(_currentProfile.gridSearch.travelTimeError);
 	}
+	else if ( name == "GridSearch.threads" ) {
+		return Core::toString(_currentProfile.gridSearch.threads);
+	}
 	else if ( name == "OctTree.maxIterations" ) {
 		return Core::toString(_currentProfile.octTree.maxIterations);
 	}
 	else if ( name == "OctTree.minCellSize" ) {
 		return Core::toString(_currentProfile.octTree.minCellSize);
 	}
+	else if ( name == "OctTree.threads" ) {
+		return Core::toString(_currentProfile.octTree.threads);
+	}
 
 	return "";
 }
@@ -838,6 +923,14 @@ bool StdLoc::setParameter(const string &name, const string &value) {
 		}
 		_currentProfile.gridSearch.travelTimeError = tmp;
 	}
+	else if ( name == "GridSearch.threads" ) {
+		int tmp;
+		if ( !Core::fromString(tmp, value) ) {
+			return false;
+		}
+		_currentProfile.gridSearch.threads = tmp;
+		return true;
+	}
 	else if ( name == "OctTree.maxIterations" ) {
 		int tmp;
 		if ( !Core::fromString(tmp, value) ) {
@@ -852,6 +945,14 @@ bool StdLoc::setParameter(const string &name, const string &value) {
 		}
 		_currentProfile.octTree.minCellSize = tmp;
 	}
+	else if ( name == "OctTree.threads" ) {
+		int tmp;
+		if ( !Core::fromString(tmp, value) ) {
+			return false;
+		}
+		_currentProfile.octTree.threads = tmp;
+		return true;
+	}
 
 	return false;
 }
@@ -872,6 +973,7 @@ bool StdLoc::loadTTT() {
 
 	_tttType = "";
 	_tttModel = "";
+	_tttClones.clear();
 
 	_ttt = TravelTimeTableInterface::Create(_currentProfile.tttType.c_str());
 	if ( !_ttt ) {
@@ -896,6 +998,47 @@ bool StdLoc::loadTTT() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int StdLoc::prepareThreads(int threads) {
+	if ( threads <= 0 ) {
+		threads = max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	}
+
+	if ( !_ttt ) {
+		return 1;
+	}
+
+	// Travel time tables keep state between calls (e.g. the source depth
+	// in LibTau), hence each thread gets its own instance
+	while ( static_cast<int>(_tttClones.size()) < threads - 1 ) {
+		TravelTimeTableInterfacePtr clone =
+		    TravelTimeTableInterface::Create(_tttType.c_str());
+		if ( !clone || !clone->setModel(_tttModel) ) {
+			SEISCOMP_WARNING("Failed to create an additional %s instance, "
+			                 "using %zu threads",
+			                 _tttType.c_str(), _tttClones.size() + 1);
+			break;
+		}
+
+		_tttClones.push_back(clone);
+	}
+
+	return min(threads, static_cast<int>(_tttClones.size()) + 1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+TravelTimeTableInterface *StdLoc::ttt(int thread) const {
+	return thread == 0 ? _ttt.get() : _tttClones[thread-1].get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 std::string StdLoc::lastMessage(MessageType type) const {
 	if ( type == Warning )
@@ -955,7 +1098,8 @@ Origin *StdLoc::locate(PickList &pickList) {
 			locateLeastSquares(pickList, weights, sensorLat, sensorLon,
 			                   sensorElev, originLat, originLon, originDepth,
 			                   originTime, originLat, originLon, originDepth,
-			                   originTime, travelTimes, covm, computeCovMtrx);
+			                   originTime, travelTimes, covm, computeCovMtrx,
+			                   _ttt.get());
 		}
 	}
 
@@ -1014,14 +1158,15 @@ Origin *StdLoc::locate(PickList &pickList, double initLat, double initLon,
 			locateLeastSquares(pickList, weights, sensorLat, sensorLon,
 			                   sensorElev, originLat, originLon, originDepth,
 			                   originTime, originLat, originLon, originDepth,
-			                   originTime, travelTimes, covm, computeCovMtrx);
+			                   originTime, travelTimes, covm, computeCovMtrx,
+			                   _ttt.get());
 		}
 	}
 	else if ( _currentProfile.method == Profile::Method::LeastSquares ) {
 		locateLeastSquares(pickList, weights, sensorLat, sensorLon, sensorElev,
 		                   initLat, initLon, initDepth, initTime, originLat,
 		                   originLon, originDepth, originTime, travelTimes,
-		                   covm, computeCovMtrx);
+		                   covm, computeCovMtrx, _ttt.get());
 	}
 
 	return createOrigin(pickList, weights, sensorLat, sensorLon, sensorElev,
@@ -1261,7 +1406,8 @@ bool StdLoc::computeOriginTime(const PickList &pickList,
                                const vector<double> &sensorLon,
                                const vector<double> &sensorElev, double lat,
                                double lon, double depth, Core::Time &originTime,
-                               vector<double> &travelTimes) const {
+                               vector<double> &travelTimes,
+                               TravelTimeTableInterface *ttt) const {
 
 	if ( weights.size() != pickList.size() ||
 	     sensorLat.size() != pickList.size() ||
@@ -1297,8 +1443,8 @@ bool StdLoc::computeOriginTime(const PickList &pickList,
 					phaseName = "S";
 				}
 			}
-			ttime = _ttt->computeTime(phaseName, lat, lon, depth, sensorLat[i],
-			                          sensorLon[i], sensorElev[i]);
+			ttime = ttt->computeTime(phaseName, lat, lon, depth, sensorLat[i],
+			                         sensorLon[i], sensorElev[i]);
 		}
 		catch ( exception &e ) {
 			SEISCOMP_WARNING("Travel Time Table error for %s@%s.%s.%s and lat "
@@ -1355,15 +1501,18 @@ void StdLoc::locateOctTree(const PickList &pickList,
                            double &newLat,double &newLon, double &newDepth,
                            Core::Time &newTime, vector<double> &travelTimes,
                            CovMtrx &covm, bool computeCovMtrx) {
-	SEISCOMP_DEBUG("Start OctTree Search: maxIterations %d minCellSize %g [km]",
-	               _currentProfile.octTree.maxIterations,
-	               _currentProfile.octTree.minCellSize);
-
 	if ( !_ttt ) {
 		throw LocatorException(
 		    "Travel time table has not been loaded, check logs");
 	}
 
+	int threads = prepareThreads(_currentProfile.octTree.threads);
+
+	SEISCOMP_DEBUG("Start OctTree Search: maxIterations %d minCellSize %g [km] "
+	               "threads %d",
+	               _currentProfile.octTree.maxIterations,
+	               _currentProfile.octTree.minCellSize, threads);
+
 	if ( pickList.empty() ) {
 		throw LocatorException("Empty observation set");
 	}
@@ -1437,7 +1586,8 @@ void StdLoc::locateOctTree(const PickList &pickList,
 	}
 
 	multimap<double, Cell> priorityList;
-	vector<double> cellTravelTimes(pickList.size());
+	vector<vector<double>> cellTravelTimes(threads);
+	vector<Cell> cellsToProcess;
 	set<tuple<float, float, float>> processedCells;
 	Cell bestCell;
 	bestCell.valid = false;
@@ -1450,6 +1600,8 @@ void StdLoc::locateOctTree(const PickList &pickList,
 		// before fetching the next cell with the highest priority make
 		// sure to have processed all the cells in the unknownPriorityList
 		// and put them in the priority list, ordered by their priority
+		cellsToProcess.clear();
+
 		for ( Cell &cell : unknownPriorityList ) {
 
 			//
@@ -1476,31 +1628,49 @@ void StdLoc::locateOctTree(const PickList &pickList,
 			computeCoordinates(distance, azimuth, gridOriginLat, gridOriginLon,
 			                   cell.org.lat, cell.org.lon);
 
+			cellsToProcess.push_back(cell);
+		}
+
+		// The cells are independent of each other and are evaluated
+		// concurrently. They are added to the priority list afterwards
+		// in their original order to not depend on the number of threads.
+		parallelFor(cellsToProcess.size(), threads,
+		            [&](size_t index, int thread) {
+			Cell &cell = cellsToProcess[index];
+
 			// Compute origin time
 			bool ok = computeOriginTime(pickList, weights, sensorLat, sensorLon,
 			                            sensorElev, cell.org.lat, cell.org.lon,
 			                            cell.org.depth, cell.org.time,
-			                            cellTravelTimes);
+			                            cellTravelTimes[thread], ttt(thread));
 
 			if ( !ok ) {
-				continue;
+				return;
 			}
 
 			// Compute the prob density (log) and from there the cell
 			// probability considering its volume
-			computeProbDensity(pickList, weights, cellTravelTimes,
+			computeProbDensity(pickList, weights, cellTravelTimes[thread],
 			                   cell.org.time, cell.org.probDensity,
 			                   cell.org.rms);
 
+			cell.valid = true;
+		});
+
+		for ( Cell &cell : cellsToProcess ) {
+			if ( !cell.valid ) {
+				continue;
+			}
+
 			// add cell to the priority list
 			double volume = cell.size.x * cell.size.y * cell.size.z;
 			double logProb = std::log(volume) + cell.org.probDensity;
 
 			if ( !isfinite(logProb) ) {
+				cell.valid = false;
 				continue;
 			}
 
-			cell.valid = true;
 			priorityList.emplace(logProb, cell);
 		}
 		// all done
@@ -1620,7 +1790,8 @@ void StdLoc::locateOctTree(const PickList &pickList,
 	//
 	Core::Time dummy;
 	if ( !computeOriginTime(pickList, weights, sensorLat, sensorLon, sensorElev,
-	                        newLat, newLon, newDepth, dummy, travelTimes) ) {
+	                        newLat, newLon, newDepth, dummy, travelTimes,
+	                        _ttt.get()) ) {
 		throw LocatorException("Couldn't find a solution");
 	}
 
@@ -1653,13 +1824,15 @@ void StdLoc::locateGridSearch(const PickList &pickList,
                               Core::Time &newTime, vector<double> &travelTimes,
                               CovMtrx &covm, bool computeCovMtrx,
                               bool enablePerCellLeastSquares) {
-	SEISCOMP_DEBUG("Start Grid Search");
-
 	if ( !_ttt ) {
 		throw LocatorException(
 		    "Travel time table has not been loaded, check logs");
 	}
 
+	int threads = prepareThreads(_currentProfile.gridSearch.threads);
+
+	SEISCOMP_DEBUG("Start Grid Search: threads %d", threads);
+
 	if ( pickList.empty() ) {
 		throw LocatorException("Empty observation set");
 	}
@@ -1740,28 +1913,40 @@ void StdLoc::locateGridSearch(const PickList &pickList,
 		}
 	}
 
-	vector<double> cellTravelTimes(pickList.size());
-	struct {
+	struct Best {
+			size_t index;
 			Cell cell;
 			vector<double> travelTimes;
 			CovMtrx covm;
-	} best;
-	best.cell.valid = false;
+	};
+
+	// Each thread keeps track of its best cell which are merged afterwards
+	vector<Best> threadBest(threads);
+	vector<vector<double>> threadTravelTimes(threads);
+	for ( Best &b : threadBest ) {
+		b.cell.valid = false;
+	}
 
 	//
 	// Process each cell now
 	//
-	for ( Cell &cell : cells ) {
+	parallelFor(cells.size(), threads, [&](size_t index, int thread) {
+		Cell &cell = cells[index];
+		vector<double> &cellTravelTimes = threadTravelTimes[thread];
+		Best &best = threadBest[thread];
+		CovMtrx cellCovm;
+		cellCovm.valid = false;
 
 		//
 		// Compute origin time
 		//
 		bool ok = computeOriginTime(
 		    pickList, weights, sensorLat, sensorLon, sensorElev, cell.org.lat,
-		    cell.org.lon, cell.org.depth, cell.org.time, cellTravelTimes);
+		    cell.org.lon, cell.org.depth, cell.org.time, cellTravelTimes,
+		    ttt(thread));
 
 		if ( !ok ) {
-			continue;
+			return;
 		}
 
 		//
@@ -1774,13 +1959,14 @@ void StdLoc::locateGridSearch(const PickList &pickList,
 				                   sensorElev, cell.org.lat, cell.org.lon,
 				                   cell.org.depth, cell.org.time, cell.org.lat,
 				                   cell.org.lon, cell.org.depth, cell.org.time,
-				                   cellTravelTimes, covm, computeCovMtrx);
+				                   cellTravelTimes, cellCovm, computeCovMtrx,
+				                   ttt(thread));
 			}
 			catch ( exception &e ) {
 				SEISCOMP_DEBUG(
 				    "Could not get a Least Square solution (%s): skip cell",
 				    e.what());
-				continue;
+				return;
 			}
 		}
 
@@ -1797,9 +1983,27 @@ void StdLoc::locateGridSearch(const PickList &pickList,
 		//
 		if ( !best.cell.valid ||
 		     best.cell.org.probDensity < cell.org.probDensity ) {
+			best.index = index;
 			best.cell = cell;
 			best.travelTimes = cellTravelTimes;
-			best.covm = covm;
+			best.covm = cellCovm;
+		}
+	});
+
+	// Merge the results of all threads. On equal probability densities
+	// the first cell wins as with sequential processing.
+	Best best;
+	best.cell.valid = false;
+	for ( Best &b : threadBest ) {
+		if ( !b.cell.valid ) {
+			continue;
+		}
+
+		if ( !best.cell.valid ||
+		     best.cell.org.probDensity < b.cell.org.probDensity ||
+		     (best.cell.org.probDensity == b.cell.org.probDensity &&
+		      b.index < best.index) ) {
+			best = std::move(b);
 		}
 	}
 
@@ -1851,7 +2055,7 @@ void StdLoc::locateLeastSquares(
     const vector<double> &sensorElev, double initLat, double initLon,
     double initDepth, Core::Time initTime, double &newLat, double &newLon,
     double &newDepth, Core::Time &newTime, vector<double> &travelTimes,
-    CovMtrx &covm, bool computeCovMtrx) const {
+    CovMtrx &covm, bool computeCovMtrx, TravelTimeTableInterface *ttt) const {
 
 	SEISCOMP_DEBUG("Start Least Square with initial lat %g lon %g depth %g "
 	               "time %s. Num iterations %d",
@@ -1950,8 +2154,8 @@ void StdLoc::locateLeastSquares(
 					}
 				}
 
-				tt = _ttt->compute(phaseName, newLat, newLon, newDepth,
-				                   sensorLat[i], sensorLon[i], sensorElev[i]);
+				tt = ttt->compute(phaseName, newLat, newLon, newDepth,
+				                  sensorLat[i], sensorLon[i], sensorElev[i]);
 			}
 			catch ( exception &e ) {
 				SEISCOMP_WARNING(
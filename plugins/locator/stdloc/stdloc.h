@@ -107,6 +107,13 @@ class StdLoc : public Seiscomp::Seismology::LocatorInterface {
 
 		bool loadTTT();
 
+		//! Creates travel time table instances for up to the given number
+		//! of threads and returns the number of threads to use
+		int prepareThreads(int threads);
+
+		//! Returns the travel time table to be used by a thread
+		Seiscomp::TravelTimeTableInterface *ttt(int thread) const;
+
 		void computeAdditionlPickInfo(const PickList &pickList,
 		                              std::vector<double> &weights,
 		                              std::vector<double> &sensorLat,
@@ -126,7 +133,8 @@ class StdLoc : public Seiscomp::Seismology::LocatorInterface {
 		                       const std::vector<double> &sensorElev,
 		                       double lat, double lon, double depth,
 		                       Seiscomp::Core::Time &originTime,
-		                       std::vector<double> &travelTimes) const;
+		                       std::vector<double> &travelTimes,
+		                       Seiscomp::TravelTimeTableInterface *ttt) const;
  
 		void locateOctTree(const PickList &pickList,
 		                   const std::vector<double> &weights,
@@ -159,7 +167,8 @@ class StdLoc : public Seiscomp::Seismology::LocatorInterface {
 		                        double &newLat, double &newLon, double &newDepth,
 		                        Seiscomp::Core::Time &newTime,
 		                        std::vector<double> &travelTimes, CovMtrx &covm,
-		                        bool computeCovMtrx) const;
+		                        bool computeCovMtrx,
+		                        Seiscomp::TravelTimeTableInterface *ttt) const;
 
 		void computeCovarianceMatrix(const std::vector<Cell> &cells,
 		                             const Cell &bestCell,
@@ -210,11 +219,13 @@ class StdLoc : public Seiscomp::Seismology::LocatorInterface {
 				double cellZExtent; // km
 				std::string misfitType;
 				double travelTimeError;
+				int threads;
 			} gridSearch;
 
 			struct {
 				int maxIterations;
 				double minCellSize;
+				int threads;
 			} octTree;
 
 			struct {
@@ -228,6 +239,8 @@ class StdLoc : public Seiscomp::Seismology::LocatorInterface {
 		std::map<std::string, Profile> _profiles;
 
 		Seiscomp::TravelTimeTableInterfacePtr _ttt;
+		// Additional instances of _ttt for threads other than the first
+		std::vector<Seiscomp::TravelTimeTableInterfacePtr> _tttClones;
 		std::string _tttType;  // currently loaded _ttt
 		std::string _tttModel; // currently loaded _ttt
 